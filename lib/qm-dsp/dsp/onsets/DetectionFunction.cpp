@@ -74,6 +74,16 @@ void DetectionFunction::initialise( DFConfig Config )
     m_windowed = new double[ m_dataLength ];
 }
 
+void DetectionFunction::reset()
+{
+    memset(m_magHistory,0, m_halfLength*sizeof(double));
+    memset(m_phaseHistory,0, m_halfLength*sizeof(double));
+    memset(m_phaseHistoryOld,0, m_halfLength*sizeof(double));
+    memset(m_magPeaks,0, m_halfLength*sizeof(double));
+
+    m_phaseVoc->reset();
+}
+
 void DetectionFunction::deInitialise()
 {
     delete [] m_magHistory ;
@@ -56,6 +56,13 @@ public:
      */
     double processFrequencyDomain(const double* reals, const double* imags);
 
+    /**
+     * Forget the previously processed frames, keeping the allocated
+     * buffers and FFT plans for processing another signal with the
+     * same configuration.
+     */
+    void reset();
+
 private:
     void whiten();
     double runDF();
@@ -20,6 +20,34 @@ declare interface ScriptConnection {
     trigger(): void;
 }
 
+/** ControlJSProxy */
+
+declare interface Control {
+    /** Group of the control e.g. "[Channel1]" */
+    readonly group: string;
+
+    /** Name of the control e.g. "play_indicator" */
+    readonly name: string;
+
+    /**
+     * Value of the control within the range according Mixxx Controls manual page:
+     * https://manual.mixxx.org/latest/chapters/appendix/mixxx_controls.html
+     *
+     * Assigning a value respects soft takeover like {@link engine.setValue}
+     */
+    value: number;
+
+    /**
+     * Value of the control normalized to a range of 0..1
+     *
+     * Assigning a parameter respects soft takeover like {@link engine.setParameter}
+     */
+    parameter: number;
+
+    /** Resets the control to its default value */
+    reset(): void;
+}
+
 
 /** ControllerScriptInterfaceLegacy */
 
@@ -101,6 +129,17 @@ declare namespace engine {
      */
     function getDefaultParameter(group: string, name: string): number;
 
+    /**
+     * Returns a handle of a control for repeated access, which is faster than
+     * looking up the control by group and name with {@link getValue} and
+     * {@link setValue} every time. The same handle is returned for each control.
+     *
+     * @param group Group of the control e.g. "[Channel1]"
+     * @param name Name of the control e.g. "play_indicator"
+     * @returns Returns the control handle on success, otherwise 'undefined'
+     */
+    function getControl(group: string, name: string): Control | undefined;
+
     type CoCallback = (value: number, group: string, name: string) => void
 
     /**
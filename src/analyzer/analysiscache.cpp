@@ -0,0 +1,197 @@
+#include "analyzer/analysiscache.h"
+
+#include <QCryptographicHash>
+
+#include "analyzer/analyzersilence.h"
+#include "analyzer/analyzertrack.h"
+#include "track/beats.h"
+#include "track/keyfactory.h"
+#include "track/track.h"
+#include "util/logger.h"
+#include "util/math.h"
+#include "util/samplebuffer.h"
+
+namespace {
+
+mixxx::Logger kLogger("AnalysisCache");
+
+const ConfigKey kEnabledConfigKey =
+        ConfigKey(QStringLiteral("[Library]"), QStringLiteral("ReuseAnalysisOfDuplicates"));
+
+// A few short excerpts spread over the track are sufficient to tell
+// different audio apart, while decoding them takes only milliseconds.
+constexpr int kFingerprintExcerptCount = 8;
+constexpr SINT kFingerprintFramesPerExcerpt = 4096;
+
+void addFingerprintValue(QCryptographicHash* pHash, qint64 value) {
+    pHash->addData(QByteArray::number(value));
+    pHash->addData(QByteArrayLiteral(";"));
+}
+
+} // anonymous namespace
+
+// static
+bool AnalysisCache::isEnabled(const UserSettingsPointer& pConfig) {
+    return pConfig->getValue(kEnabledConfigKey, true);
+}
+
+AnalysisCache::AnalysisCache(
+        const UserSettingsPointer& pConfig,
+        const QSqlDatabase& dbConnection)
+        : m_pConfig(pConfig),
+          m_analysisDao(pConfig) {
+    m_analysisCacheDao.initialize(dbConnection);
+    m_analysisDao.initialize(dbConnection);
+}
+
+// static
+QByteArray AnalysisCache::fingerprint(
+        const mixxx::AudioSourcePointer& pAudioSource) {
+    const mixxx::IndexRange frameRange = pAudioSource->frameIndexRange();
+    if (frameRange.empty()) {
+        return QByteArray();
+    }
+    const auto signalInfo = pAudioSource->getSignalInfo();
+    const SINT channelCount = signalInfo.getChannelCount();
+    mixxx::SampleBuffer sampleBuffer(kFingerprintFramesPerExcerpt * channelCount);
+
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    addFingerprintValue(&hash, signalInfo.getSampleRate());
+    addFingerprintValue(&hash, channelCount);
+    addFingerprintValue(&hash, frameRange.length());
+    SINT readFrames = 0;
+    for (int i = 0; i < kFingerprintExcerptCount; ++i) {
+        const SINT firstFrame = frameRange.length() * i / kFingerprintExcerptCount;
+        const auto excerptRange = mixxx::IndexRange::forward(
+                frameRange.start() + firstFrame,
+                math_min(kFingerprintFramesPerExcerpt,
+                        frameRange.length() - firstFrame));
+        const auto readableSampleFrames = pAudioSource->readSampleFrames(
+                mixxx::WritableSampleFrames(
+                        excerptRange,
+                        mixxx::SampleBuffer::WritableSlice(sampleBuffer)));
+        addFingerprintValue(&hash, readableSampleFrames.frameIndexRange().start());
+        hash.addData(QByteArray::fromRawData(
+                reinterpret_cast<const char*>(readableSampleFrames.readableData()),
+                static_cast<int>(readableSampleFrames.readableLength() * sizeof(CSAMPLE))));
+        readFrames += readableSampleFrames.frameIndexRange().length();
+    }
+    if (readFrames <= 0) {
+        return QByteArray();
+    }
+    return hash.result();
+}
+
+bool AnalysisCache::restore(const AnalyzerTrack& track, const QByteArray& fingerprint) {
+    const auto entry = m_analysisCacheDao.getEntry(fingerprint);
+    if (!entry) {
+        return false;
+    }
+    const TrackPointer& pTrack = track.getTrack();
+    bool restored = false;
+
+    if (!pTrack->getBeats() && !entry->beats.isEmpty()) {
+        const auto pBeats = mixxx::Beats::fromByteArray(
+                mixxx::audio::SampleRate(entry->sampleRate),
+                entry->beatsVersion,
+                entry->beatsSubVersion,
+                entry->beats);
+        if (pBeats && pTrack->trySetBeats(pBeats)) {
+            restored = true;
+        }
+    }
+
+    if (pTrack->getKeys().getGlobalKey() == mixxx::track::io::key::INVALID &&
+            !entry->keys.isEmpty()) {
+        QByteArray keysSerialized = entry->keys;
+        const Keys keys = KeyFactory::loadKeysFromByteArray(
+                entry->keysVersion,
+                entry->keysSubVersion,
+                &keysSerialized);
+        if (keys.getGlobalKey() != mixxx::track::io::key::INVALID) {
+            pTrack->setKeys(keys);
+            restored = true;
+        }
+    }
+
+    if (!pTrack->getReplayGain().hasRatio() && entry->replayGain.hasRatio()) {
+        pTrack->setReplayGain(entry->replayGain);
+        restored = true;
+    }
+
+    // Same results as from AnalyzerSilence, which respects the main cue
+    // and the intro/outro cues that have been set by the user
+    if (!pTrack->findCueByType(mixxx::CueType::N60dBSound) &&
+            entry->soundStart >= 0 && entry->soundEnd > entry->soundStart) {
+        const auto firstSoundPosition = mixxx::audio::FramePos(entry->soundStart);
+        const auto lastSoundPosition = mixxx::audio::FramePos(entry->soundEnd);
+        pTrack->createAndAddCue(
+                mixxx::CueType::N60dBSound,
+                Cue::kNoHotCue,
+                firstSoundPosition,
+                lastSoundPosition);
+        AnalyzerSilence::setupMainAndIntroCue(
+                pTrack.get(), firstSoundPosition, m_pConfig.data());
+        AnalyzerSilence::setupOutroCue(pTrack.get(), lastSoundPosition);
+        restored = true;
+    }
+
+    // The stored waveforms are loaded by AnalyzerWaveform
+    if (entry->trackId.isValid() && entry->trackId != pTrack->getId() &&
+            m_analysisDao.getAnalysesForTrack(pTrack->getId()).isEmpty()) {
+        const auto analyses = m_analysisDao.getAnalysesForTrack(entry->trackId);
+        for (auto analysis : analyses) {
+            analysis.analysisId = -1;
+            analysis.trackId = pTrack->getId();
+            if (m_analysisDao.saveAnalysis(&analysis)) {
+                restored = true;
+            }
+        }
+    }
+
+    if (restored) {
+        kLogger.info()
+                << "Restored analysis results of track"
+                << entry->trackId
+                << "for track"
+                << pTrack->getId();
+    }
+    return restored;
+}
+
+void AnalysisCache::store(const AnalyzerTrack& track, const QByteArray& fingerprint) {
+    if (fingerprint.isEmpty()) {
+        return;
+    }
+    const TrackPointer& pTrack = track.getTrack();
+    AnalysisCacheDao::Entry entry;
+    entry.trackId = pTrack->getId();
+    entry.sampleRate = pTrack->getSampleRate();
+
+    const auto pBeats = pTrack->getBeats();
+    if (pBeats) {
+        entry.sampleRate = pBeats->getSampleRate();
+        entry.beatsVersion = pBeats->getVersion();
+        entry.beatsSubVersion = pBeats->getSubVersion();
+        entry.beats = pBeats->toByteArray();
+    }
+
+    const Keys keys = pTrack->getKeys();
+    if (keys.getGlobalKey() != mixxx::track::io::key::INVALID) {
+        entry.keysVersion = keys.getVersion();
+        entry.keysSubVersion = keys.getSubVersion();
+        entry.keys = keys.toByteArray();
+    }
+
+    entry.replayGain = pTrack->getReplayGain();
+
+    const CuePointer pN60dBSound = pTrack->findCueByType(mixxx::CueType::N60dBSound);
+    if (pN60dBSound &&
+            pN60dBSound->getPosition().isValid() &&
+            pN60dBSound->getEndPosition().isValid()) {
+        entry.soundStart = pN60dBSound->getPosition().value();
+        entry.soundEnd = pN60dBSound->getEndPosition().value();
+    }
+
+    m_analysisCacheDao.saveEntry(fingerprint, entry);
+}
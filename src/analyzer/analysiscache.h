@@ -0,0 +1,47 @@
+#pragma once
+
+#include <QByteArray>
+
+#include "library/dao/analysiscachedao.h"
+#include "library/dao/analysisdao.h"
+#include "preferences/usersettings.h"
+#include "sources/audiosource.h"
+
+class AnalyzerTrack;
+
+/// Reuses the analysis results of tracks with identical audio content,
+/// e.g. copies of a file on different drives or with different tags.
+///
+/// The content is identified by a fingerprint over a few short excerpts
+/// of the decoded audio. Before the analysis of a track the beats, key,
+/// replay gain, silence cues and waveforms of a previously analyzed track
+/// with the same fingerprint are restored, so that the analyzers skip
+/// them. After the analysis the results are stored for the next
+/// duplicate.
+///
+/// Each analyzer thread has its own instance.
+class AnalysisCache {
+  public:
+    static bool isEnabled(const UserSettingsPointer& pConfig);
+
+    AnalysisCache(
+            const UserSettingsPointer& pConfig,
+            const QSqlDatabase& dbConnection);
+
+    /// Computes the fingerprint of the decoded audio. Returns an empty
+    /// fingerprint if the audio could not be decoded.
+    static QByteArray fingerprint(
+            const mixxx::AudioSourcePointer& pAudioSource);
+
+    /// Restores the results that are missing in the track. Returns true
+    /// if any results have been restored.
+    bool restore(const AnalyzerTrack& track, const QByteArray& fingerprint);
+
+    /// Stores the current results of the track.
+    void store(const AnalyzerTrack& track, const QByteArray& fingerprint);
+
+  private:
+    const UserSettingsPointer m_pConfig;
+    AnalysisCacheDao m_analysisCacheDao;
+    AnalysisDao m_analysisDao;
+};
@@ -99,8 +99,11 @@ bool AnalyzerBeats::initialize(const AnalyzerTrack& track,
     // if we can load a stored track don't reanalyze it
     bool bShouldAnalyze = shouldAnalyze(track.getTrack());
 
-    DEBUG_ASSERT(!m_pPlugin);
-    if (bShouldAnalyze) {
+    if (m_pPlugin && m_pPlugin->info().id() != m_pluginId) {
+        m_pPlugin.reset();
+    }
+    // The plugin is reused for analyzing the next tracks
+    if (bShouldAnalyze && !m_pPlugin) {
         if (m_pluginId == mixxx::AnalyzerQueenMaryBeats::pluginInfo().id()) {
             m_pPlugin = std::make_unique<mixxx::AnalyzerQueenMaryBeats>();
         } else if (m_pluginId == mixxx::AnalyzerSoundTouchBeats::pluginInfo().id()) {
@@ -110,7 +113,8 @@ bool AnalyzerBeats::initialize(const AnalyzerTrack& track,
             // that the PlugInId is valid
             DEBUG_ASSERT(false);
         }
-
+    }
+    if (bShouldAnalyze) {
         if (m_pPlugin) {
             if (m_pPlugin->initialize(m_sampleRate)) {
                 qDebug() << "Beat calculation started with plugin" << m_pluginId;
@@ -208,7 +212,8 @@ bool AnalyzerBeats::processSamples(const CSAMPLE* pIn, SINT count) {
 }
 
 void AnalyzerBeats::cleanup() {
-    m_pPlugin.reset();
+    // The plugin releases the memory that is only needed for a single
+    // track when finalizing
 }
 
 void AnalyzerBeats::storeResults(TrackPointer pTrack) {
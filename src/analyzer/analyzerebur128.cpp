@@ -2,6 +2,7 @@
 
 #include <QtDebug>
 
+#include "analyzer/analyzersignallevels.h"
 #include "analyzer/analyzertrack.h"
 #include "analyzer/constants.h"
 #include "track/track.h"
@@ -12,9 +13,12 @@ namespace {
 constexpr double kReplayGain2ReferenceLUFS = -18;
 } // anonymous namespace
 
-AnalyzerEbur128::AnalyzerEbur128(UserSettingsPointer pConfig)
+AnalyzerEbur128::AnalyzerEbur128(UserSettingsPointer pConfig,
+        std::shared_ptr<AnalyzerSignalLevels> pSignalLevels)
         : m_rgSettings(pConfig),
-          m_pState(nullptr) {
+          m_pState(nullptr),
+          m_pSignalLevels(std::move(pSignalLevels)),
+          m_collectSignalLevels(false) {
 }
 
 AnalyzerEbur128::~AnalyzerEbur128() {
@@ -34,7 +38,11 @@ bool AnalyzerEbur128::initialize(
             mixxx::kAnalysisChannels,
             sampleRate,
             EBUR128_MODE_I);
-    return m_pState != nullptr;
+    if (!m_pState) {
+        return false;
+    }
+    m_collectSignalLevels = m_pSignalLevels && m_pSignalLevels->tryStartCollecting();
+    return true;
 }
 
 void AnalyzerEbur128::cleanup() {
@@ -50,6 +58,9 @@ bool AnalyzerEbur128::processSamples(const CSAMPLE* pIn, SINT count) {
         return false;
     }
     ScopedTimer t("AnalyzerEbur128::processSamples()");
+    if (m_collectSignalLevels) {
+        m_pSignalLevels->process(pIn, count);
+    }
     size_t frames = count / mixxx::kAnalysisChannels;
     int e = ebur128_add_frames_float(m_pState, pIn, frames);
     VERIFY_OR_DEBUG_ASSERT(e == EBUR128_SUCCESS) {
@@ -78,6 +89,9 @@ void AnalyzerEbur128::storeResults(TrackPointer pTrack) {
     const double fReplayGain2 = kReplayGain2ReferenceLUFS - averageLufs;
     mixxx::ReplayGain replayGain(pTrack->getReplayGain());
     replayGain.setRatio(db2ratio(fReplayGain2));
+    if (m_pSignalLevels && m_pSignalLevels->isCollecting()) {
+        replayGain.setPeak(m_pSignalLevels->peak());
+    }
     pTrack->setReplayGain(replayGain);
     qDebug() << "ReplayGain 2.0 (libebur128) result is" << fReplayGain2
              << "dB for" << pTrack->getFileInfo();
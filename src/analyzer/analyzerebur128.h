@@ -2,12 +2,18 @@
 
 #include <ebur128.h>
 
+#include <memory>
+
 #include "analyzer/analyzer.h"
 #include "preferences/replaygainsettings.h"
 
+class AnalyzerSignalLevels;
+
 class AnalyzerEbur128 : public Analyzer {
   public:
-    AnalyzerEbur128(UserSettingsPointer pConfig);
+    /// Stores the peak of the shared signal levels, if available.
+    AnalyzerEbur128(UserSettingsPointer pConfig,
+            std::shared_ptr<AnalyzerSignalLevels> pSignalLevels = nullptr);
     ~AnalyzerEbur128() override;
 
     static bool isEnabled(const ReplayGainSettings& rgSettings) {
@@ -24,4 +30,6 @@ class AnalyzerEbur128 : public Analyzer {
   private:
     ReplayGainSettings m_rgSettings;
     ebur128_state* m_pState;
+    const std::shared_ptr<AnalyzerSignalLevels> m_pSignalLevels;
+    bool m_collectSignalLevels;
 };
@@ -4,6 +4,7 @@
 
 #include <QtDebug>
 
+#include "analyzer/analyzersignallevels.h"
 #include "analyzer/analyzertrack.h"
 #include "analyzer/constants.h"
 #include "track/track.h"
@@ -11,8 +12,11 @@
 #include "util/sample.h"
 #include "util/timer.h"
 
-AnalyzerGain::AnalyzerGain(UserSettingsPointer pConfig)
-        : m_rgSettings(pConfig) {
+AnalyzerGain::AnalyzerGain(UserSettingsPointer pConfig,
+        std::shared_ptr<AnalyzerSignalLevels> pSignalLevels)
+        : m_rgSettings(pConfig),
+          m_pSignalLevels(std::move(pSignalLevels)),
+          m_collectSignalLevels(false) {
     m_pReplayGain = new ReplayGain();
 }
 
@@ -28,9 +32,13 @@ bool AnalyzerGain::initialize(const AnalyzerTrack& track,
         return false;
     }
 
-    return m_pReplayGain->initialise(
-            sampleRate,
-            mixxx::kAnalysisChannels);
+    if (!m_pReplayGain->initialise(
+                sampleRate,
+                mixxx::kAnalysisChannels)) {
+        return false;
+    }
+    m_collectSignalLevels = m_pSignalLevels && m_pSignalLevels->tryStartCollecting();
+    return true;
 }
 
 void AnalyzerGain::cleanup() {
@@ -39,17 +47,20 @@ void AnalyzerGain::cleanup() {
 bool AnalyzerGain::processSamples(const CSAMPLE* pIn, SINT count) {
     ScopedTimer t("AnalyzerGain::process()");
 
+    if (m_collectSignalLevels) {
+        m_pSignalLevels->process(pIn, count);
+    }
+
     SINT numFrames = count / mixxx::kAnalysisChannels;
     if (numFrames > static_cast<SINT>(m_pLeftTempBuffer.size())) {
         m_pLeftTempBuffer.resize(numFrames);
         m_pRightTempBuffer.resize(numFrames);
     }
-    SampleUtil::deinterleaveBuffer(m_pLeftTempBuffer.data(),
+    SampleUtil::deinterleaveBufferWithGain(m_pLeftTempBuffer.data(),
             m_pRightTempBuffer.data(),
             pIn,
+            32767,
             numFrames);
-    SampleUtil::applyGain(m_pLeftTempBuffer.data(), 32767, numFrames);
-    SampleUtil::applyGain(m_pRightTempBuffer.data(), 32767, numFrames);
     return m_pReplayGain->process(m_pLeftTempBuffer.data(), m_pRightTempBuffer.data(), numFrames);
 }
 
@@ -68,6 +79,9 @@ void AnalyzerGain::storeResults(TrackPointer pTrack) {
 
     mixxx::ReplayGain replayGain(pTrack->getReplayGain());
     replayGain.setRatio(db2ratio(fReplayGainOutput));
+    if (m_pSignalLevels && m_pSignalLevels->isCollecting()) {
+        replayGain.setPeak(m_pSignalLevels->peak());
+    }
     pTrack->setReplayGain(replayGain);
     qDebug() << "ReplayGain 1.0 result is" << fReplayGainOutput << "dB for"
              << pTrack->getLocation();
@@ -7,16 +7,20 @@
 
 #pragma once
 
+#include <memory>
 #include <vector>
 
 #include "analyzer/analyzer.h"
 #include "preferences/replaygainsettings.h"
 
+class AnalyzerSignalLevels;
 class ReplayGain;
 
 class AnalyzerGain : public Analyzer {
   public:
-    AnalyzerGain(UserSettingsPointer pConfig);
+    /// Stores the peak of the shared signal levels, if available.
+    AnalyzerGain(UserSettingsPointer pConfig,
+            std::shared_ptr<AnalyzerSignalLevels> pSignalLevels = nullptr);
     ~AnalyzerGain() override;
 
     static bool isEnabled(const ReplayGainSettings& rgSettings) {
@@ -35,4 +39,6 @@ class AnalyzerGain : public Analyzer {
     std::vector<CSAMPLE> m_pLeftTempBuffer;
     std::vector<CSAMPLE> m_pRightTempBuffer;
     ReplayGain* m_pReplayGain;
+    const std::shared_ptr<AnalyzerSignalLevels> m_pSignalLevels;
+    bool m_collectSignalLevels;
 };
@@ -0,0 +1,94 @@
+#include "analyzer/analyzerpipeline.h"
+
+#include "util/assert.h"
+
+class AnalyzerPipeline::Lane : public QThread {
+  public:
+    Lane(AnalyzerWithState* pAnalyzer, QSemaphore* pDoneSemaphore, int laneIndex)
+            : m_pAnalyzer(pAnalyzer),
+              m_pDoneSemaphore(pDoneSemaphore),
+              m_pSamples(nullptr),
+              m_sampleCount(0),
+              m_quit(false) {
+        setObjectName(QStringLiteral("AnalyzerPipeline %1").arg(laneIndex));
+    }
+
+    AnalyzerWithState* analyzer() const {
+        return m_pAnalyzer;
+    }
+
+    void processChunk(const CSAMPLE* pSamples, SINT sampleCount) {
+        m_pSamples = pSamples;
+        m_sampleCount = sampleCount;
+        // Releasing the semaphore publishes the chunk to the lane
+        m_startSemaphore.release();
+    }
+
+    void stop() {
+        m_quit = true;
+        m_startSemaphore.release();
+    }
+
+  protected:
+    void run() override {
+        while (true) {
+            m_startSemaphore.acquire();
+            if (m_quit) {
+                break;
+            }
+            m_pAnalyzer->processSamples(m_pSamples, static_cast<int>(m_sampleCount));
+            m_pDoneSemaphore->release();
+        }
+    }
+
+  private:
+    AnalyzerWithState* const m_pAnalyzer;
+    QSemaphore* const m_pDoneSemaphore;
+    QSemaphore m_startSemaphore;
+
+    // Only written by the owner while the lane is waiting
+    const CSAMPLE* m_pSamples;
+    SINT m_sampleCount;
+    bool m_quit;
+};
+
+AnalyzerPipeline::AnalyzerPipeline(
+        std::vector<AnalyzerWithState>* pAnalyzers,
+        QThread::Priority priority)
+        : m_pendingLaneCount(0) {
+    m_lanes.reserve(pAnalyzers->size());
+    for (auto&& analyzer : *pAnalyzers) {
+        m_lanes.push_back(std::make_unique<Lane>(
+                &analyzer, &m_doneSemaphore, static_cast<int>(m_lanes.size())));
+        m_lanes.back()->start(priority);
+    }
+}
+
+AnalyzerPipeline::~AnalyzerPipeline() {
+    waitForChunk();
+    for (const auto& pLane : m_lanes) {
+        pLane->stop();
+    }
+    for (const auto& pLane : m_lanes) {
+        pLane->wait();
+    }
+}
+
+void AnalyzerPipeline::processChunk(const CSAMPLE* pSamples, SINT sampleCount) {
+    DEBUG_ASSERT(m_pendingLaneCount == 0);
+    for (const auto& pLane : m_lanes) {
+        // The active state of an analyzer can only change while
+        // processing a chunk
+        if (pLane->analyzer()->isActive()) {
+            pLane->processChunk(pSamples, sampleCount);
+            ++m_pendingLaneCount;
+        }
+    }
+}
+
+void AnalyzerPipeline::waitForChunk() {
+    if (m_pendingLaneCount > 0) {
+        m_doneSemaphore.acquire(m_pendingLaneCount);
+        m_pendingLaneCount = 0;
+    }
+}
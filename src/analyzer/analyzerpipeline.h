@@ -0,0 +1,44 @@
+#pragma once
+
+#include <QSemaphore>
+#include <QThread>
+#include <memory>
+#include <vector>
+
+#include "analyzer/analyzer.h"
+#include "util/types.h"
+
+// Fans out the decoded chunks of a track to the analyzers of an
+// AnalyzerThread, each on a separate thread.
+//
+// The analyzers process the chunks in order, because the next chunk is only
+// started after all analyzers have finished the previous one. The caller is
+// free to decode the next chunk into another buffer in the meantime. This
+// way the slowest analyzer, usually the beat detection, and not the sum of
+// all analyzers and the decoding determines the duration of the analysis.
+//
+// Initializing and finishing the analyzers is still up to the caller and
+// must only be done while no chunk is pending.
+class AnalyzerPipeline final {
+  public:
+    // The analyzers must outlive the pipeline
+    AnalyzerPipeline(
+            std::vector<AnalyzerWithState>* pAnalyzers,
+            QThread::Priority priority);
+    ~AnalyzerPipeline();
+
+    // Starts processing the chunk with all active analyzers. The samples must
+    // remain valid and unmodified until waitForChunk() has returned.
+    void processChunk(const CSAMPLE* pSamples, SINT sampleCount);
+
+    // Blocks until all analyzers have processed the pending chunk. Returns
+    // immediately if no chunk is pending.
+    void waitForChunk();
+
+  private:
+    class Lane;
+
+    std::vector<std::unique_ptr<Lane>> m_lanes;
+    QSemaphore m_doneSemaphore;
+    int m_pendingLaneCount;
+};
@@ -6,8 +6,11 @@
 /// A track to be scheduled for analysis with additional options.
 class AnalyzerScheduledTrack {
   public:
+    using Priority = AnalyzerPriority;
+
     AnalyzerScheduledTrack(TrackId trackId,
-            AnalyzerTrack::Options options = AnalyzerTrack::Options());
+            AnalyzerTrack::Options options = AnalyzerTrack::Options(),
+            Priority priority = Priority::Batch);
 
     /// Fetches the id of the track to be analyzed.
     const TrackId& getTrackId() const;
@@ -15,11 +18,16 @@ class AnalyzerScheduledTrack {
     /// Fetches the additional options.
     const AnalyzerTrack::Options& getOptions() const;
 
+    /// Fetches the priority class.
+    Priority getPriority() const;
+
   private:
     /// The id of the track to be analyzed.
     TrackId m_trackId;
     /// The additional options.
     AnalyzerTrack::Options m_options;
+    /// The priority class.
+    Priority m_priority;
 };
 
 Q_DECLARE_TYPEINFO(AnalyzerScheduledTrack, Q_MOVABLE_TYPE);
@@ -0,0 +1,53 @@
+#include "analyzer/analyzersignallevels.h"
+
+#include "analyzer/analyzersilence.h"
+#include "analyzer/constants.h"
+#include "util/assert.h"
+#include "util/sample.h"
+#include "util/span.h"
+
+AnalyzerSignalLevels::AnalyzerSignalLevels() {
+    reset();
+}
+
+void AnalyzerSignalLevels::reset() {
+    m_collecting = false;
+    m_framesProcessed = 0;
+    m_firstSoundFrame = -1;
+    m_lastSoundFrameEnd = -1;
+    m_peak = 0;
+}
+
+bool AnalyzerSignalLevels::tryStartCollecting() {
+    if (m_collecting) {
+        return false;
+    }
+    m_collecting = true;
+    return true;
+}
+
+void AnalyzerSignalLevels::process(const CSAMPLE* pIn, SINT count) {
+    processBlock(pIn, count, SampleUtil::maxAbsAmplitude(pIn, count));
+}
+
+void AnalyzerSignalLevels::processBlock(const CSAMPLE* pIn, SINT count, CSAMPLE maxAbs) {
+    DEBUG_ASSERT(m_collecting);
+    if (maxAbs > m_peak) {
+        m_peak = maxAbs;
+    }
+    // Only blocks with sound need to be searched sample by sample, and
+    // the searches stop at the first sound from either end
+    if (maxAbs >= AnalyzerSilence::kSilenceThreshold) {
+        const auto samples = mixxx::spanutil::spanFromPtrLen(pIn, count);
+        if (m_firstSoundFrame < 0) {
+            m_firstSoundFrame = m_framesProcessed +
+                    AnalyzerSilence::findFirstSoundInChunk(samples) /
+                            mixxx::kAnalysisChannels;
+        }
+        m_lastSoundFrameEnd = m_framesProcessed +
+                AnalyzerSilence::findLastSoundInChunk(samples) /
+                        mixxx::kAnalysisChannels +
+                1;
+    }
+    m_framesProcessed += count / mixxx::kAnalysisChannels;
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "util/types.h"
+
+/// The amplitude levels of a track that are needed by multiple analyzers:
+/// the range between the first and the last sound above -60 dB and the
+/// sample peak.
+///
+/// Collecting them requires the maximum amplitude of each block of
+/// samples, which AnalyzerWaveform already computes for every stride.
+/// The analyzers share a single instance per track, so that the samples
+/// are scanned only once: the first analyzer that analyzes a track
+/// collects the levels and the others adopt them when storing their
+/// results.
+class AnalyzerSignalLevels {
+  public:
+    AnalyzerSignalLevels();
+
+    /// Prepares the collection of the levels of the next track.
+    void reset();
+
+    /// Returns true if the caller shall collect the levels of the current
+    /// track, or false if they are collected by another analyzer.
+    bool tryStartCollecting();
+
+    /// Returns true if the levels of the current track are collected.
+    bool isCollecting() const {
+        return m_collecting;
+    }
+
+    /// Collects the levels of consecutive interleaved stereo samples.
+    void process(const CSAMPLE* pIn, SINT count);
+
+    /// Same as process() with the maximum absolute amplitude of the
+    /// samples that has been computed by the caller.
+    void processBlock(const CSAMPLE* pIn, SINT count, CSAMPLE maxAbs);
+
+    SINT framesProcessed() const {
+        return m_framesProcessed;
+    }
+
+    /// The first frame with sound, or -1 if there is no sound.
+    SINT firstSoundFrame() const {
+        return m_firstSoundFrame;
+    }
+
+    /// The frame after the last frame with sound, or -1 if there is no
+    /// sound.
+    SINT lastSoundFrameEnd() const {
+        return m_lastSoundFrameEnd;
+    }
+
+    CSAMPLE peak() const {
+        return m_peak;
+    }
+
+  private:
+    bool m_collecting;
+    SINT m_framesProcessed;
+    SINT m_firstSoundFrame;
+    SINT m_lastSoundFrameEnd;
+    CSAMPLE m_peak;
+};
@@ -1,17 +1,12 @@
 #include "analyzer/analyzersilence.h"
 
+#include "analyzer/analyzersignallevels.h"
 #include "analyzer/analyzertrack.h"
 #include "analyzer/constants.h"
 #include "track/track.h"
 
 namespace {
 
-// This threshold must not be changed, because this value is also used to
-// verify that the track samples have not changed since the last analysis
-constexpr CSAMPLE kSilenceThreshold = 0.001f; // -60 dB
-// TODO: Change the above line to:
-//constexpr CSAMPLE kSilenceThreshold = db2ratio(-60.0f);
-
 bool shouldAnalyze(TrackPointer pTrack) {
     CuePointer pIntroCue = pTrack->findCueByType(mixxx::CueType::Intro);
     CuePointer pOutroCue = pTrack->findCueByType(mixxx::CueType::Outro);
@@ -26,19 +21,24 @@ bool shouldAnalyze(TrackPointer pTrack) {
 template<typename Iterator>
 Iterator first_sound(Iterator begin, Iterator end) {
     return std::find_if(begin, end, [](const auto elem) {
-        return fabs(elem) >= kSilenceThreshold;
+        return fabs(elem) >= AnalyzerSilence::kSilenceThreshold;
     });
 }
 
 } // anonymous namespace
 
-AnalyzerSilence::AnalyzerSilence(UserSettingsPointer pConfig)
+AnalyzerSilence::AnalyzerSilence(UserSettingsPointer pConfig,
+        std::shared_ptr<AnalyzerSignalLevels> pSignalLevels)
         : m_pConfig(pConfig),
-          m_framesProcessed(0),
-          m_signalStart(-1),
-          m_signalEnd(-1) {
+          m_pSignalLevels(pSignalLevels
+                          ? pSignalLevels
+                          : std::make_shared<AnalyzerSignalLevels>()),
+          m_ownsSignalLevels(!pSignalLevels),
+          m_collectSignalLevels(false) {
 }
 
+AnalyzerSilence::~AnalyzerSilence() = default;
+
 bool AnalyzerSilence::initialize(const AnalyzerTrack& track,
         mixxx::audio::SampleRate sampleRate,
         SINT frameLength) {
@@ -49,10 +49,10 @@ bool AnalyzerSilence::initialize(const AnalyzerTrack& track,
         return false;
     }
 
-    m_framesProcessed = 0;
-    m_signalStart = -1;
-    m_signalEnd = -1;
-
+    if (m_ownsSignalLevels) {
+        m_pSignalLevels->reset();
+    }
+    m_collectSignalLevels = m_pSignalLevels->tryStartCollecting();
     return true;
 }
 
@@ -84,21 +84,9 @@ bool AnalyzerSilence::verifyFirstSound(
 }
 
 bool AnalyzerSilence::processSamples(const CSAMPLE* pIn, SINT count) {
-    std::span<const CSAMPLE> samples = mixxx::spanutil::spanFromPtrLen(pIn, count);
-    if (m_signalStart < 0) {
-        const SINT firstSoundSample = findFirstSoundInChunk(samples);
-        if (firstSoundSample < count) {
-            m_signalStart = m_framesProcessed + firstSoundSample / mixxx::kAnalysisChannels;
-        }
-    }
-    if (m_signalStart >= 0) {
-        const SINT lastSoundSample = findLastSoundInChunk(samples);
-        if (lastSoundSample < count - 1) { // not only sound or silence
-            m_signalEnd = m_framesProcessed + lastSoundSample / mixxx::kAnalysisChannels + 1;
-        }
+    if (m_collectSignalLevels) {
+        m_pSignalLevels->process(pIn, count);
     }
-
-    m_framesProcessed += count / mixxx::kAnalysisChannels;
     return true;
 }
 
@@ -106,15 +94,13 @@ void AnalyzerSilence::cleanup() {
 }
 
 void AnalyzerSilence::storeResults(TrackPointer pTrack) {
-    if (m_signalStart < 0) {
-        m_signalStart = 0;
-    }
-    if (m_signalEnd < 0) {
-        m_signalEnd = m_framesProcessed;
-    }
-
-    const auto firstSoundPosition = mixxx::audio::FramePos(m_signalStart);
-    const auto lastSoundPosition = mixxx::audio::FramePos(m_signalEnd);
+    const SINT firstSoundFrame = m_pSignalLevels->firstSoundFrame();
+    const SINT lastSoundFrameEnd = m_pSignalLevels->lastSoundFrameEnd();
+    const auto firstSoundPosition =
+            mixxx::audio::FramePos(firstSoundFrame >= 0 ? firstSoundFrame : 0);
+    const auto lastSoundPosition = mixxx::audio::FramePos(lastSoundFrameEnd >= 0
+                    ? lastSoundFrameEnd
+                    : m_pSignalLevels->framesProcessed());
 
     CuePointer pN60dBSound = pTrack->findCueByType(mixxx::CueType::N60dBSound);
     if (pN60dBSound == nullptr) {
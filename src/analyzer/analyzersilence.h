@@ -1,9 +1,12 @@
 #pragma once
 
+#include <memory>
+
 #include "analyzer/analyzer.h"
 #include "preferences/usersettings.h"
 #include "util/span.h"
 
+class AnalyzerSignalLevels;
 class AnalyzerTrack;
 class Track;
 
@@ -16,10 +19,21 @@ class SampleRate;
 } // namespace audio
 } // namespace mixxx
 
+/// Sets the N60dBSound, main, intro and outro cues from the range of
+/// sound in the track. The range is adopted from the shared signal levels
+/// if another analyzer collects them, i.e. AnalyzerWaveform which must
+/// be initialized before.
 class AnalyzerSilence : public Analyzer {
   public:
-    explicit AnalyzerSilence(UserSettingsPointer pConfig);
-    ~AnalyzerSilence() override = default;
+    // This threshold must not be changed, because this value is also used to
+    // verify that the track samples have not changed since the last analysis
+    static constexpr CSAMPLE kSilenceThreshold = 0.001f; // -60 dB
+    // TODO: Change the above line to:
+    //static constexpr CSAMPLE kSilenceThreshold = db2ratio(-60.0f);
+
+    explicit AnalyzerSilence(UserSettingsPointer pConfig,
+            std::shared_ptr<AnalyzerSignalLevels> pSignalLevels = nullptr);
+    ~AnalyzerSilence() override;
 
     bool initialize(const AnalyzerTrack& track,
             mixxx::audio::SampleRate sampleRate,
@@ -50,7 +64,9 @@ class AnalyzerSilence : public Analyzer {
 
   private:
     UserSettingsPointer m_pConfig;
-    SINT m_framesProcessed;
-    SINT m_signalStart;
-    SINT m_signalEnd;
+    const std::shared_ptr<AnalyzerSignalLevels> m_pSignalLevels;
+    // The levels are reset by the owner for each track
+    const bool m_ownsSignalLevels;
+    // Only collect the levels if no other analyzer does
+    bool m_collectSignalLevels;
 };
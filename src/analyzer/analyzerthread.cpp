@@ -1,21 +1,30 @@
 #include "analyzer/analyzerthread.h"
 
+#include <array>
+#include <atomic>
 #include <mutex>
 
+#include "analyzer/analysiscache.h"
 #include "analyzer/analyzerbeats.h"
 #include "analyzer/analyzerebur128.h"
 #include "analyzer/analyzergain.h"
+#include "analyzer/analyzerpipeline.h"
 #include "analyzer/analyzerkey.h"
+#include "analyzer/analyzersignallevels.h"
 #include "analyzer/analyzersilence.h"
 #include "analyzer/analyzerwaveform.h"
 #include "analyzer/constants.h"
+#include "engine/cachingreader/cachingreaderpcmcache.h"
+#include "library/coverartthumbnailcache.h"
 #include "library/dao/analysisdao.h"
 #include "moc_analyzerthread.cpp"
 #include "sources/audiosourcestereoproxy.h"
 #include "sources/soundsourceproxy.h"
 #include "track/track.h"
+#include "util/cpuaffinity.h"
 #include "util/db/dbconnectionpooled.h"
 #include "util/db/dbconnectionpooler.h"
+#include "util/denormalsarezero.h"
 #include "util/logger.h"
 
 namespace {
@@ -40,6 +49,33 @@ void deleteAnalyzerThread(AnalyzerThread* plainPtr) {
     }
 }
 
+// The number of AnalyzerThreads in state Busy
+std::atomic<int> s_busyThreadCount(0);
+
+// The number of tracks that are currently analyzed, indexed by
+// AnalyzerPriority
+std::array<std::atomic<int>, kAnalyzerPriorityCount> s_busyTrackCounts{};
+
+// Preempted threads poll for the end of the preemption. The delay of the
+// resumption is negligible compared to the analysis of a track.
+constexpr unsigned long kPreemptedPollIntervalMillis = 20;
+
+// Counts the analysis of the current track for preempting the analysis of
+// tracks with a lower priority in other threads
+class ScopedBusyTrack {
+  public:
+    explicit ScopedBusyTrack(AnalyzerPriority priority)
+            : m_count(s_busyTrackCounts[static_cast<int>(priority)]) {
+        m_count.fetch_add(1, std::memory_order_relaxed);
+    }
+    ~ScopedBusyTrack() {
+        m_count.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+  private:
+    std::atomic<int>& m_count;
+};
+
 std::once_flag registerMetaTypesOnceFlag;
 
 void registerMetaTypesOnce() {
@@ -83,17 +119,60 @@ AnalyzerThread::AnalyzerThread(
           m_modeFlags(modeFlags),
           m_nextTrack(2), // minimum capacity
           m_sampleBuffer(mixxx::kAnalysisSamplesPerChunk),
+          m_pipelineSampleBuffer(modeFlags & AnalyzerModeFlags::Pipelined
+                          ? mixxx::kAnalysisSamplesPerChunk
+                          : 0),
           m_emittedState(AnalyzerThreadState::Void) {
     std::call_once(registerMetaTypesOnceFlag, registerMetaTypesOnce);
 }
 
+AnalyzerThread::~AnalyzerThread() = default;
+
+// static
+int AnalyzerThread::busyThreadCount() {
+    return s_busyThreadCount.load(std::memory_order_relaxed);
+}
+
+// static
+bool AnalyzerThread::isPreempted(AnalyzerPriority priority) {
+    for (int higher = static_cast<int>(priority) + 1;
+            higher < kAnalyzerPriorityCount;
+            ++higher) {
+        if (s_busyTrackCounts[higher].load(std::memory_order_relaxed) > 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void AnalyzerThread::sleepWhilePreempted() {
+    DEBUG_ASSERT(m_currentTrack.has_value());
+    const AnalyzerPriority priority = m_currentTrack->getPriority();
+    if (!isPreempted(priority)) {
+        return;
+    }
+    kLogger.debug()
+            << "Pausing the analysis of track"
+            << m_currentTrack->getTrack()->getId();
+    while (isPreempted(priority) && !isStopping()) {
+        QThread::msleep(kPreemptedPollIntervalMillis);
+    }
+}
+
 void AnalyzerThread::doRun() {
+    mixxx::CpuAffinity::applyToCurrentThread(mixxx::CpuAffinity::ThreadRole::Background);
+    mixxx::enableDenormalsAreZero();
     std::unique_ptr<AnalysisDao> pAnalysisDao;
     // The thread-local database connection  must not be closed
     // before returning from this function.
     mixxx::DbConnectionPooler dbConnectionPooler;
 
-    if (m_modeFlags & AnalyzerModeFlags::WithWaveform) {
+    // Collected only once per track by the first analyzer, preferably
+    // by AnalyzerWaveform which is added first
+    const auto pSignalLevels = std::make_shared<AnalyzerSignalLevels>();
+
+    const bool withAnalysisCache = AnalysisCache::isEnabled(m_pConfig);
+    if ((m_modeFlags & AnalyzerModeFlags::WithWaveform) || withAnalysisCache) {
         dbConnectionPooler = mixxx::DbConnectionPooler(m_dbConnectionPool); // move assignment
         if (!dbConnectionPooler.isPooling()) {
             kLogger.warning()
@@ -101,28 +180,50 @@ void AnalyzerThread::doRun() {
             return;
         }
         QSqlDatabase dbConnection = mixxx::DbConnectionPooled(m_dbConnectionPool);
-        m_analyzers.push_back(AnalyzerWithState(std::make_unique<AnalyzerWaveform>(m_pConfig, dbConnection)));
+        if (m_modeFlags & AnalyzerModeFlags::WithWaveform) {
+            m_analyzers.push_back(AnalyzerWithState(
+                    std::make_unique<AnalyzerWaveform>(
+                            m_pConfig, dbConnection, pSignalLevels)));
+        }
+        if (withAnalysisCache) {
+            m_pAnalysisCache = std::make_unique<AnalysisCache>(m_pConfig, dbConnection);
+        }
     }
     if (AnalyzerGain::isEnabled(ReplayGainSettings(m_pConfig))) {
-        m_analyzers.push_back(AnalyzerWithState(std::make_unique<AnalyzerGain>(m_pConfig)));
+        m_analyzers.push_back(AnalyzerWithState(
+                std::make_unique<AnalyzerGain>(m_pConfig, pSignalLevels)));
     }
     if (AnalyzerEbur128::isEnabled(ReplayGainSettings(m_pConfig))) {
-        m_analyzers.push_back(AnalyzerWithState(std::make_unique<AnalyzerEbur128>(m_pConfig)));
+        m_analyzers.push_back(AnalyzerWithState(
+                std::make_unique<AnalyzerEbur128>(m_pConfig, pSignalLevels)));
     }
     // BPM detection might be disabled in the config, but can be overridden
     // and enabled by explicitly setting the mode flag.
     const bool enforceBpmDetection = (m_modeFlags & AnalyzerModeFlags::WithBeats) != 0;
     m_analyzers.push_back(AnalyzerWithState(std::make_unique<AnalyzerBeats>(m_pConfig, enforceBpmDetection)));
     m_analyzers.push_back(AnalyzerWithState(std::make_unique<AnalyzerKey>(m_pConfig)));
-    m_analyzers.push_back(AnalyzerWithState(std::make_unique<AnalyzerSilence>(m_pConfig)));
+    m_analyzers.push_back(AnalyzerWithState(
+            std::make_unique<AnalyzerSilence>(m_pConfig, pSignalLevels)));
     DEBUG_ASSERT(!m_analyzers.empty());
     kLogger.debug() << "Activated" << m_analyzers.size() << "analyzers";
 
+    if ((m_modeFlags & AnalyzerModeFlags::Pipelined) && m_analyzers.size() > 1) {
+        m_pPipeline = std::make_unique<AnalyzerPipeline>(
+                &m_analyzers, QThread::currentThread()->priority());
+    }
+
+    m_pPcmCache = CachingReaderPcmCache::fromConfig(m_pConfig);
+
     m_lastBusyProgressEmittedTimer.start();
 
     mixxx::AudioSource::OpenParams openParams;
     openParams.setChannelCount(mixxx::kAnalysisChannels);
 
+    // Store the cover thumbnails for the library table while the file
+    // is still in the disk cache to avoid extracting them from all files
+    // while scrolling through the library later.
+    const auto thumbnailCache = CoverArtThumbnailCache::fromConfig(m_pConfig);
+
     while (awaitWorkItemsFetched()) {
         DEBUG_ASSERT(m_currentTrack.has_value());
         kLogger.debug() << "Analyzing" << m_currentTrack->getTrack()->getLocation();
@@ -138,6 +239,19 @@ void AnalyzerThread::doRun() {
             continue;
         }
 
+        // Pause the analysis of other tracks with a lower priority until
+        // this track is done
+        const ScopedBusyTrack busyTrack(m_currentTrack->getPriority());
+
+        // Reuse the results of a track with the same audio, the analyzers
+        // then skip them
+        QByteArray fingerprint;
+        if (m_pAnalysisCache) {
+            fingerprint = AnalysisCache::fingerprint(audioSource);
+            m_pAnalysisCache->restore(*m_currentTrack, fingerprint);
+        }
+
+        pSignalLevels->reset();
         bool processTrack = false;
         for (auto&& analyzer : m_analyzers) {
             // Make sure not to short-circuit initialize(...)
@@ -150,8 +264,26 @@ void AnalyzerThread::doRun() {
         }
 
         if (processTrack) {
+            // Only share the decoded samples of tracks that are or have
+            // been loaded into a deck. Otherwise the batch analysis would
+            // evict all their cache files.
+            if (m_pPcmCache) {
+                m_pPcmCache->open(
+                        m_currentTrack->getTrack()->getFileInfo(),
+                        audioSource->getSignalInfo(),
+                        audioSource->frameIndexRange(),
+                        false);
+            }
             const auto analysisResult = analyzeAudioSource(audioSource);
+            if (m_pPcmCache) {
+                m_pPcmCache->close();
+            }
             DEBUG_ASSERT(analysisResult != AnalysisResult::Pending);
+            if (m_pPipeline) {
+                // The analyzers must not be finished or cancelled while
+                // they are still busy with the last chunk
+                m_pPipeline->waitForChunk();
+            }
             if (analysisResult == AnalysisResult::Finished) {
                 // The analysis has been finished, and is either complete without
                 // any errors or partial if it has been aborted due to a corrupt
@@ -164,6 +296,10 @@ void AnalyzerThread::doRun() {
                 for (auto&& analyzer : m_analyzers) {
                     analyzer.finish(*m_currentTrack);
                 }
+                if (m_pAnalysisCache) {
+                    m_pAnalysisCache->store(*m_currentTrack, fingerprint);
+                }
+                thumbnailCache.prewarm(m_currentTrack->getTrack());
                 emitDoneProgress(kAnalyzerProgressDone);
             } else {
                 for (auto&& analyzer : m_analyzers) {
@@ -173,13 +309,20 @@ void AnalyzerThread::doRun() {
             }
         } else {
             kLogger.debug() << "Skipping track analysis because no analyzer initialized.";
+            if (m_pAnalysisCache) {
+                m_pAnalysisCache->store(*m_currentTrack, fingerprint);
+            }
+            thumbnailCache.prewarm(m_currentTrack->getTrack());
             emitDoneProgress(kAnalyzerProgressDone);
         }
     }
     DEBUG_ASSERT(!m_currentTrack);
     DEBUG_ASSERT(isStopping());
 
+    m_pPipeline.reset();
     m_analyzers.clear();
+    m_pAnalysisCache.reset();
+    m_pPcmCache.reset();
 
     kLogger.debug() << "Exiting worker thread";
     emitProgress(AnalyzerThreadState::Exit);
@@ -233,6 +376,7 @@ AnalyzerThread::AnalysisResult AnalyzerThread::analyzeAudioSource(
     mixxx::IndexRange remainingFrameRange = audioSource->frameIndexRange();
     while (!remainingFrameRange.empty()) {
         sleepWhileSuspended();
+        sleepWhilePreempted();
         if (isStopping()) {
             return AnalysisResult::Cancelled;
         }
@@ -245,12 +389,27 @@ AnalyzerThread::AnalysisResult AnalyzerThread::analyzeAudioSource(
                         math_min(mixxx::kAnalysisFramesPerChunk, remainingFrameRange.length()));
         DEBUG_ASSERT(!chunkFrameRange.empty());
 
-        // Request the next chunk of audio data
-        const auto readableSampleFrames =
-                audioSourceProxy.readSampleFrames(
-                        mixxx::WritableSampleFrames(
-                                chunkFrameRange,
-                                mixxx::SampleBuffer::WritableSlice(m_sampleBuffer)));
+        // Request the next chunk of audio data, from a deck that has
+        // already decoded it if possible
+        mixxx::ReadableSampleFrames readableSampleFrames;
+        if (m_pPcmCache && m_pPcmCache->readFrames(chunkFrameRange, m_sampleBuffer.data())) {
+            readableSampleFrames = mixxx::ReadableSampleFrames(
+                    chunkFrameRange,
+                    mixxx::SampleBuffer::ReadableSlice(
+                            m_sampleBuffer.data(),
+                            chunkFrameRange.length() * mixxx::kAnalysisChannels));
+        } else {
+            readableSampleFrames =
+                    audioSourceProxy.readSampleFrames(
+                            mixxx::WritableSampleFrames(
+                                    chunkFrameRange,
+                                    mixxx::SampleBuffer::WritableSlice(m_sampleBuffer)));
+            if (m_pPcmCache) {
+                m_pPcmCache->writeFrames(
+                        readableSampleFrames.frameIndexRange(),
+                        readableSampleFrames.readableData());
+            }
+        }
         // The returned range fits into the requested range
         DEBUG_ASSERT(readableSampleFrames.frameIndexRange().isSubrangeOf(chunkFrameRange));
 
@@ -294,7 +453,17 @@ AnalyzerThread::AnalysisResult AnalyzerThread::analyzeAudioSource(
         }
 
         // 2nd: step: Analyze chunk of decoded audio data
-        if (!readableSampleFrames.frameIndexRange().empty()) {
+        if (m_pPipeline) {
+            // The previous chunk has been analyzed while decoding this one
+            m_pPipeline->waitForChunk();
+            if (!readableSampleFrames.frameIndexRange().empty()) {
+                m_pPipeline->processChunk(
+                        readableSampleFrames.readableData(),
+                        readableSampleFrames.readableLength());
+                // Decode the next chunk into the other buffer
+                m_sampleBuffer.swap(m_pipelineSampleBuffer);
+            }
+        } else if (!readableSampleFrames.frameIndexRange().empty()) {
             for (auto&& analyzer : m_analyzers) {
                 analyzer.processSamples(
                         readableSampleFrames.readableData(),
@@ -363,6 +532,13 @@ void AnalyzerThread::emitProgress(AnalyzerThreadState state, TrackId trackId, An
     DEBUG_ASSERT(!m_currentTrack.has_value() || (state == AnalyzerThreadState::Busy));
     DEBUG_ASSERT(!m_currentTrack.has_value() || (m_currentTrack->getTrack()->getId() == trackId));
     DEBUG_ASSERT(trackId.isValid() || (trackProgress == kAnalyzerProgressUnknown));
+    if (state != m_emittedState) {
+        if (state == AnalyzerThreadState::Busy) {
+            s_busyThreadCount.fetch_add(1, std::memory_order_relaxed);
+        } else if (m_emittedState == AnalyzerThreadState::Busy) {
+            s_busyThreadCount.fetch_sub(1, std::memory_order_relaxed);
+        }
+    }
     m_emittedState = state;
     emit progress(m_id, m_emittedState, trackId, trackProgress);
 }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <memory>
 #include <optional>
 #include <vector>
 
@@ -17,11 +18,18 @@
 #include "util/samplebuffer.h"
 #include "util/workerthread.h"
 
+class AnalysisCache;
+class AnalyzerPipeline;
+class CachingReaderPcmCache;
+
 enum AnalyzerModeFlags {
     None = 0x00,
     WithBeats = 0x01,
     WithWaveform = 0x02,
     LowPriority = 0x04,
+    // Process the decoded chunks with the analyzers in parallel, see
+    // AnalyzerPipeline
+    Pipelined = 0x08,
     All = WithBeats | WithWaveform,
 };
 
@@ -66,12 +74,20 @@ class AnalyzerThread : public WorkerThread {
             mixxx::DbConnectionPoolPtr dbConnectionPool,
             UserSettingsPointer pConfig,
             AnalyzerModeFlags modeFlags);
-    ~AnalyzerThread() override = default;
+    ~AnalyzerThread() override;
 
     int id() const {
         return m_id;
     }
 
+    // The number of analyzer threads that are currently analyzing a
+    // track. Real-time safe.
+    static int busyThreadCount();
+
+    // Whether a track of a higher priority class than the given one is
+    // currently analyzed by any analyzer thread.
+    static bool isPreempted(AnalyzerPriority priority);
+
     // Submits the next track to the worker thread without
     // blocking. This is only allowed after a progress() signal
     // with state Idle has been received to avoid overwriting
@@ -118,8 +134,21 @@ class AnalyzerThread : public WorkerThread {
 
     std::vector<AnalyzerWithState> m_analyzers;
 
+    // Only used if the reuse of the results of duplicates is enabled
+    std::unique_ptr<AnalysisCache> m_pAnalysisCache;
+
+    // Only used if the cache of decoded samples is enabled. Shares the
+    // decoded samples with the decks that have loaded the same track.
+    std::unique_ptr<CachingReaderPcmCache> m_pPcmCache;
+
     mixxx::SampleBuffer m_sampleBuffer;
 
+    // Only used with AnalyzerModeFlags::Pipelined. The chunk in
+    // m_pipelineSampleBuffer is analyzed while the next chunk is decoded
+    // into m_sampleBuffer.
+    std::unique_ptr<AnalyzerPipeline> m_pPipeline;
+    mixxx::SampleBuffer m_pipelineSampleBuffer;
+
     std::optional<AnalyzerTrack> m_currentTrack;
 
     AnalyzerThreadState m_emittedState;
@@ -137,6 +166,11 @@ class AnalyzerThread : public WorkerThread {
     // Blocks the worker thread until a next track becomes available
     TrackPointer receiveNextTrack();
 
+    // Pauses the analysis of the current track while tracks of a higher
+    // priority class are analyzed by other threads, e.g. a batch analysis
+    // while a track has just been loaded into a deck.
+    void sleepWhilePreempted();
+
     // Conditionally emit a progress() signal while busy (frequency is limited)
     void emitBusyProgress(AnalyzerProgress busyProgress);
 
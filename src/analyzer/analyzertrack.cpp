@@ -2,8 +2,10 @@
 
 #include "util/assert.h"
 
-AnalyzerTrack::AnalyzerTrack(TrackPointer track, Options options)
-        : m_track(track), m_options(options) {
+AnalyzerTrack::AnalyzerTrack(TrackPointer track,
+        Options options,
+        AnalyzerPriority priority)
+        : m_track(track), m_options(options), m_priority(priority) {
     DEBUG_ASSERT(track);
 }
 
@@ -14,3 +16,7 @@ const TrackPointer& AnalyzerTrack::getTrack() const {
 const AnalyzerTrack::Options& AnalyzerTrack::getOptions() const {
     return m_options;
 }
+
+AnalyzerPriority AnalyzerTrack::getPriority() const {
+    return m_priority;
+}
@@ -4,15 +4,38 @@
 
 #include "track/track_decl.h"
 
+/// The priority classes of the analysis in ascending order. Queued tracks
+/// of a higher class are analyzed first, and analyzer threads that are
+/// busy with a track of a lower class pause at the next chunk until all
+/// tracks of the higher classes are done.
+enum class AnalyzerPriority {
+    /// Batch analysis of the library
+    Batch,
+    /// Tracks loaded into a preview deck
+    Preview,
+    /// The next tracks of Auto DJ
+    AutoDJ,
+    /// Tracks loaded into a deck or sampler
+    Deck,
+};
+
+constexpr int kAnalyzerPriorityCount = static_cast<int>(AnalyzerPriority::Deck) + 1;
+
 /// A scheduled not-null track with additional options for analysis.
 class AnalyzerTrack {
   public:
     struct Options {
         /// If set, overrides whether the analysis should assume constant BPM.
         std::optional<bool> useFixedTempo;
+        /// If set, a coarse waveform is generated first from a few short
+        /// excerpts of the track, e.g. for tracks that have just been
+        /// loaded into a deck.
+        bool withWaveformPreview = false;
     };
 
-    explicit AnalyzerTrack(TrackPointer track, Options options = Options());
+    explicit AnalyzerTrack(TrackPointer track,
+            Options options = Options(),
+            AnalyzerPriority priority = AnalyzerPriority::Batch);
 
     /// Fetches the (not-null) track to be analyzed.
     const TrackPointer& getTrack() const;
@@ -20,9 +43,14 @@ class AnalyzerTrack {
     /// Fetches the additional options.
     const Options& getOptions() const;
 
+    /// Fetches the priority class.
+    AnalyzerPriority getPriority() const;
+
   private:
     /// The (not-null) track to be analyzed.
     TrackPointer m_track;
     /// The additional options.
     Options m_options;
+    /// The priority class.
+    AnalyzerPriority m_priority;
 };
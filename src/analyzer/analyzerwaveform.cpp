@@ -1,29 +1,87 @@
 #include "analyzer/analyzerwaveform.h"
 
+#include "analyzer/analyzersignallevels.h"
 #include "analyzer/analyzertrack.h"
-#include "engine/filters/enginefilterbessel4.h"
+#include "analyzer/constants.h"
+#include "sources/audiosourcestereoproxy.h"
+#include "sources/soundsourceproxy.h"
 #include "track/track.h"
 #include "util/logger.h"
+#include "util/math.h"
+#include "util/sample.h"
 #include "waveform/waveformfactory.h"
 
 namespace {
 
 mixxx::Logger kLogger("AnalyzerWaveform");
 
+//TODO (vrince) Do we want to expose this as settings or whatever ?
+constexpr int kMainWaveformSampleRate = 441;
+// two visual sample per pixel in full width overview in full hd
+constexpr int kSummaryWaveformSamples = 2 * 1920;
+
+// The preview is made of the maxima of short excerpts at regular
+// intervals, i.e. about one for every 8 pixels of the overview
+constexpr int kPreviewExcerptCount = kSummaryWaveformSamples / 8;
+constexpr SINT kPreviewFramesPerExcerpt = 256;
+// Don't delay the regular analysis for files that are slow to seek
+const mixxx::Duration kPreviewTimeout = mixxx::Duration::fromMillis(300);
+
+// Distinguishes the preview from a partially analyzed waveform
+const QString kPreviewDescription = QStringLiteral("preview");
+
+bool isPreview(const ConstWaveformPointer& pWaveform) {
+    return pWaveform && pWaveform->getDescription() == kPreviewDescription;
+}
+
+// Fills the visual samples of a preview that cover the given frames
+void fillPreview(Waveform* pWaveform,
+        const WaveformData* pData,
+        SINT firstFrame,
+        SINT endFrame) {
+    const double ratio = pWaveform->getAudioVisualRatio();
+    const int dataSize = pWaveform->getDataSize();
+    const int firstIndex = math_min(
+            static_cast<int>(firstFrame / ratio) * ChannelCount, dataSize);
+    const int endIndex = math_min(
+            static_cast<int>(endFrame / ratio) * ChannelCount, dataSize);
+    WaveformData* pDest = pWaveform->data();
+    for (int i = firstIndex; i < endIndex; i += ChannelCount) {
+        for (int c = 0; c < ChannelCount; ++c) {
+            pDest[i + c] = pData[c];
+        }
+    }
+}
+
+// Returns the first position after the given position that completes a
+// stride of the given length, i.e. where fmod(position, length) < 1.
+int nextStrideEnd(int position, double length) {
+    int end = static_cast<int>(std::ceil((std::floor(position / length) + 1) * length));
+    end = math_max(end, position + 1);
+    // Compensate any rounding errors of the estimate above
+    while (end - 1 > position && std::fmod(end - 1, length) < 1) {
+        --end;
+    }
+    while (std::fmod(end, length) >= 1) {
+        ++end;
+    }
+    return end;
+}
+
 } // namespace
 
 AnalyzerWaveform::AnalyzerWaveform(
         UserSettingsPointer pConfig,
-        const QSqlDatabase& dbConnection)
+        const QSqlDatabase& dbConnection,
+        std::shared_ptr<AnalyzerSignalLevels> pSignalLevels)
         : m_analysisDao(pConfig),
           m_waveformData(nullptr),
           m_waveformSummaryData(nullptr),
           m_stride(0, 0),
           m_currentStride(0),
-          m_currentSummaryStride(0) {
-    m_filter[0] = nullptr;
-    m_filter[1] = nullptr;
-    m_filter[2] = nullptr;
+          m_currentSummaryStride(0),
+          m_pSignalLevels(std::move(pSignalLevels)),
+          m_collectSignalLevels(false) {
     m_analysisDao.initialize(dbConnection);
 }
 
@@ -51,21 +109,19 @@ bool AnalyzerWaveform::initialize(const AnalyzerTrack& track,
     destroyFilters();
     createFilters(sampleRate);
 
-    //TODO (vrince) Do we want to expose this as settings or whatever ?
-    constexpr int mainWaveformSampleRate = 441;
-    // two visual sample per pixel in full width overview in full hd
-    constexpr int summaryWaveformSamples = 2 * 1920;
-
     m_waveform = WaveformPointer(new Waveform(
-            sampleRate, frameLength, mainWaveformSampleRate, -1));
+            sampleRate, frameLength, kMainWaveformSampleRate, -1));
     m_waveformSummary = WaveformPointer(new Waveform(
-            sampleRate, frameLength, mainWaveformSampleRate, summaryWaveformSamples));
-
-    // Now, that the Waveform memory is initialized, we can set set them to
-    // the TIO. Be aware that other threads of Mixxx can touch them from
-    // now.
-    track.getTrack()->setWaveform(m_waveform);
-    track.getTrack()->setWaveformSummary(m_waveformSummary);
+            sampleRate, frameLength, kMainWaveformSampleRate, kSummaryWaveformSamples));
+
+    if (!track.getOptions().withWaveformPreview ||
+            !generatePreview(track.getTrack(), sampleRate, frameLength)) {
+        // Now, that the Waveform memory is initialized, we can set set them to
+        // the TIO. Be aware that other threads of Mixxx can touch them from
+        // now. Otherwise the preview is replaced in storeResults().
+        track.getTrack()->setWaveform(m_waveform);
+        track.getTrack()->setWaveformSummary(m_waveformSummary);
+    }
 
     m_waveformData = m_waveform->data();
     m_waveformSummaryData = m_waveformSummary->data();
@@ -76,6 +132,8 @@ bool AnalyzerWaveform::initialize(const AnalyzerTrack& track,
     m_currentStride = 0;
     m_currentSummaryStride = 0;
 
+    m_collectSignalLevels = m_pSignalLevels && m_pSignalLevels->tryStartCollecting();
+
     //debug
     //m_waveform->dump();
     //m_waveformSummary->dump();
@@ -94,8 +152,10 @@ bool AnalyzerWaveform::shouldAnalyze(TrackPointer tio) const {
     ConstWaveformPointer pLoadedTrackWaveformSummary;
 
     TrackId trackId = tio->getId();
-    bool missingWaveform = pTrackWaveform.isNull();
-    bool missingWavesummary = pTrackWaveformSummary.isNull();
+    // The preview of a cancelled analysis must be replaced
+    bool missingWaveform = pTrackWaveform.isNull() || isPreview(pTrackWaveform);
+    bool missingWavesummary = pTrackWaveformSummary.isNull() ||
+            isPreview(pTrackWaveformSummary);
 
     if (trackId.isValid() && (missingWaveform || missingWavesummary)) {
         QList<AnalysisDao::AnalysisInfo> analyses =
@@ -145,26 +205,101 @@ bool AnalyzerWaveform::shouldAnalyze(TrackPointer tio) const {
     return true;
 }
 
-void AnalyzerWaveform::createFilters(mixxx::audio::SampleRate sampleRate) {
-    // m_filter[Low] = new EngineFilterButterworth8(FILTER_LOWPASS, sampleRate, 200);
-    // m_filter[Mid] = new EngineFilterButterworth8(FILTER_BANDPASS, sampleRate, 200, 2000);
-    // m_filter[High] = new EngineFilterButterworth8(FILTER_HIGHPASS, sampleRate, 2000);
-    m_filter[Low] = new EngineFilterBessel4Low(sampleRate, 600);
-    m_filter[Mid] = new EngineFilterBessel4Band(sampleRate, 600, 4000);
-    m_filter[High] = new EngineFilterBessel4High(sampleRate, 4000);
-    // settle filters for silence in preroll to avoids ramping (Issue #7776)
-    for (int i = 0; i < FilterCount; ++i) {
-        m_filter[i]->assumeSettled();
+bool AnalyzerWaveform::generatePreview(const TrackPointer& pTrack,
+        mixxx::audio::SampleRate sampleRate,
+        SINT frameLength) {
+    PerformanceTimer timer;
+    timer.start();
+
+    mixxx::AudioSource::OpenParams openParams;
+    openParams.setChannelCount(mixxx::kAnalysisChannels);
+    const mixxx::AudioSourcePointer pAudioSource =
+            SoundSourceProxy(pTrack).openAudioSource(openParams);
+    if (!pAudioSource) {
+        return false;
     }
+    mixxx::AudioSourceStereoProxy audioSourceProxy(
+            pAudioSource,
+            kPreviewFramesPerExcerpt);
+    mixxx::SampleBuffer sampleBuffer(kPreviewFramesPerExcerpt * mixxx::kAnalysisChannels);
+    std::vector<CSAMPLE> bandBuffers[FilterCount];
+    for (auto& buffer : bandBuffers) {
+        buffer.resize(sampleBuffer.size());
+    }
+    WaveformBandFilters filters(sampleRate);
+
+    auto pPreview = WaveformPointer(new Waveform(
+            sampleRate, frameLength, kMainWaveformSampleRate, -1));
+    auto pPreviewSummary = WaveformPointer(new Waveform(
+            sampleRate, frameLength, kMainWaveformSampleRate, kSummaryWaveformSamples));
+
+    const mixxx::IndexRange frameRange = pAudioSource->frameIndexRange();
+    for (int i = 0; i < kPreviewExcerptCount; ++i) {
+        if (timer.elapsed() > kPreviewTimeout) {
+            kLogger.info() << "Waveform preview for track" << pTrack->getId()
+                           << "aborted after" << timer.elapsed().debugMillisWithUnit();
+            return false;
+        }
+        const SINT firstFrame = frameRange.length() * i / kPreviewExcerptCount;
+        const SINT endFrame = frameRange.length() * (i + 1) / kPreviewExcerptCount;
+        const auto excerptRange = mixxx::IndexRange::forward(
+                frameRange.start() + firstFrame,
+                math_min(kPreviewFramesPerExcerpt, endFrame - firstFrame));
+        if (excerptRange.empty()) {
+            continue;
+        }
+        const auto readableSampleFrames = audioSourceProxy.readSampleFrames(
+                mixxx::WritableSampleFrames(
+                        excerptRange,
+                        mixxx::SampleBuffer::WritableSlice(sampleBuffer)));
+        const CSAMPLE* pSamples = readableSampleFrames.readableData();
+        const SINT numSamples = readableSampleFrames.readableLength();
+
+        // Each excerpt starts from silence
+        filters.reset();
+        filters.process(pSamples,
+                bandBuffers[Low].data(),
+                bandBuffers[Mid].data(),
+                bandBuffers[High].data(),
+                numSamples);
+        WaveformStride stride(1, 1);
+        SampleUtil::maxAbsPerChannel(&stride.m_overallData[Left],
+                &stride.m_overallData[Right],
+                pSamples,
+                numSamples);
+        for (int f = 0; f < FilterCount; ++f) {
+            SampleUtil::maxAbsPerChannel(&stride.m_filteredData[Left][f],
+                    &stride.m_filteredData[Right][f],
+                    bandBuffers[f].data(),
+                    numSamples);
+        }
+        WaveformData data[ChannelCount];
+        stride.store(data);
+
+        fillPreview(pPreview.data(), data, firstFrame, endFrame);
+        fillPreview(pPreviewSummary.data(), data, firstFrame, endFrame);
+    }
+
+    for (Waveform* pWaveform : {pPreview.data(), pPreviewSummary.data()}) {
+        pWaveform->setDescription(kPreviewDescription);
+        pWaveform->updateMipmaps(0, pWaveform->getDataSize());
+        pWaveform->setCompletion(pWaveform->getDataSize());
+    }
+    pTrack->setWaveform(pPreview);
+    pTrack->setWaveformSummary(pPreviewSummary);
+
+    kLogger.debug() << "Waveform preview for track" << pTrack->getId() << "done"
+                    << timer.elapsed().debugMillisWithUnit();
+    return true;
+}
+
+void AnalyzerWaveform::createFilters(mixxx::audio::SampleRate sampleRate) {
+    // The filters are settled for silence in preroll to avoids ramping (Issue #7776)
+    m_pFilters = std::make_unique<WaveformBandFilters>(sampleRate);
 }
 
 void AnalyzerWaveform::destroyFilters() {
-    for (int i = 0; i < FilterCount; ++i) {
-        if (m_filter[i]) {
-            delete m_filter[i];
-            m_filter[i] = nullptr;
-        }
-    }
+    m_pFilters.reset();
 }
 
 bool AnalyzerWaveform::processSamples(const CSAMPLE* buffer, SINT count) {
@@ -182,44 +317,56 @@ bool AnalyzerWaveform::processSamples(const CSAMPLE* buffer, SINT count) {
         m_buffers[High].resize(count);
     }
 
-    m_filter[Low]->process(buffer, &m_buffers[Low][0], count);
-    m_filter[Mid]->process(buffer, &m_buffers[Mid][0], count);
-    m_filter[High]->process(buffer, &m_buffers[High][0], count);
+    m_pFilters->process(buffer,
+            m_buffers[Low].data(),
+            m_buffers[Mid].data(),
+            m_buffers[High].data(),
+            count);
 
     m_waveform->setSaveState(Waveform::SaveState::NotSaved);
     m_waveformSummary->setSaveState(Waveform::SaveState::NotSaved);
 
-    for (SINT i = 0; i < count; i += 2) {
-        // Take max value, not average of data
-        CSAMPLE cover[2] = {fabs(buffer[i]), fabs(buffer[i + 1])};
-        CSAMPLE clow[2] = {fabs(m_buffers[Low][i]), fabs(m_buffers[Low][i + 1])};
-        CSAMPLE cmid[2] = {fabs(m_buffers[Mid][i]), fabs(m_buffers[Mid][i + 1])};
-        CSAMPLE chigh[2] = {fabs(m_buffers[High][i]), fabs(m_buffers[High][i + 1])};
-
-        // This is for if you want to experiment with averaging instead of
-        // maxing.
-        // m_stride.m_overallData[Right] += buffer[i]*buffer[i];
-        // m_stride.m_overallData[Left] += buffer[i + 1]*buffer[i + 1];
-        // m_stride.m_filteredData[Right][Low] += m_buffers[Low][i]*m_buffers[Low][i];
-        // m_stride.m_filteredData[Left][Low] += m_buffers[Low][i + 1]*m_buffers[Low][i + 1];
-        // m_stride.m_filteredData[Right][Mid] += m_buffers[Mid][i]*m_buffers[Mid][i];
-        // m_stride.m_filteredData[Left][Mid] += m_buffers[Mid][i + 1]*m_buffers[Mid][i + 1];
-        // m_stride.m_filteredData[Right][High] += m_buffers[High][i]*m_buffers[High][i];
-        // m_stride.m_filteredData[Left][High] += m_buffers[High][i + 1]*m_buffers[High][i + 1];
-
-        // Record the max across this stride.
-        storeIfGreater(&m_stride.m_overallData[Left], cover[Left]);
-        storeIfGreater(&m_stride.m_overallData[Right], cover[Right]);
-        storeIfGreater(&m_stride.m_filteredData[Left][Low], clow[Left]);
-        storeIfGreater(&m_stride.m_filteredData[Right][Low], clow[Right]);
-        storeIfGreater(&m_stride.m_filteredData[Left][Mid], cmid[Left]);
-        storeIfGreater(&m_stride.m_filteredData[Right][Mid], cmid[Right]);
-        storeIfGreater(&m_stride.m_filteredData[Left][High], chigh[Left]);
-        storeIfGreater(&m_stride.m_filteredData[Right][High], chigh[Right]);
-
-        m_stride.m_position++;
-
-        if (fmod(m_stride.m_position, m_stride.m_length) < 1) {
+    const int firstStride = m_currentStride;
+    const int firstSummaryStride = m_currentSummaryStride;
+    const SINT frameCount = count / 2;
+    SINT frame = 0;
+    while (frame < frameCount) {
+        // Process the frames up to the end of the current stride or
+        // summary stride at once instead of checking each frame
+        const int strideEnd = nextStrideEnd(m_stride.m_position, m_stride.m_length);
+        const int summaryStrideEnd = nextStrideEnd(
+                m_stride.m_position, m_stride.m_averageLength);
+        const int blockEnd = static_cast<int>(math_min(
+                static_cast<SINT>(math_min(strideEnd, summaryStrideEnd)),
+                m_stride.m_position + (frameCount - frame)));
+        const SINT blockSamples = (blockEnd - m_stride.m_position) * 2;
+
+        // Record the max across this stride. Take max value, not average
+        // of data.
+        const SINT offset = frame * 2;
+        CSAMPLE maxAbs[ChannelCount];
+        SampleUtil::maxAbsPerChannel(&maxAbs[Left], &maxAbs[Right], buffer + offset, blockSamples);
+        storeIfGreater(&m_stride.m_overallData[Left], maxAbs[Left]);
+        storeIfGreater(&m_stride.m_overallData[Right], maxAbs[Right]);
+        if (m_collectSignalLevels) {
+            // Reuses the maxima instead of scanning the samples again
+            m_pSignalLevels->processBlock(buffer + offset,
+                    blockSamples,
+                    math_max(maxAbs[Left], maxAbs[Right]));
+        }
+        for (int f = 0; f < FilterCount; ++f) {
+            SampleUtil::maxAbsPerChannel(&maxAbs[Left],
+                    &maxAbs[Right],
+                    m_buffers[f].data() + offset,
+                    blockSamples);
+            storeIfGreater(&m_stride.m_filteredData[Left][f], maxAbs[Left]);
+            storeIfGreater(&m_stride.m_filteredData[Right][f], maxAbs[Right]);
+        }
+
+        frame += blockSamples / 2;
+        m_stride.m_position = blockEnd;
+
+        if (blockEnd == strideEnd) {
             VERIFY_OR_DEBUG_ASSERT(m_currentStride + ChannelCount <= m_waveform->getDataSize()) {
                 qWarning() << "AnalyzerWaveform::process - currentStride > waveform size";
                 return false;
@@ -229,7 +376,7 @@ bool AnalyzerWaveform::processSamples(const CSAMPLE* buffer, SINT count) {
             m_waveform->setCompletion(m_currentStride);
         }
 
-        if (fmod(m_stride.m_position, m_stride.m_averageLength) < 1) {
+        if (blockEnd == summaryStrideEnd) {
             VERIFY_OR_DEBUG_ASSERT(m_currentSummaryStride + ChannelCount <= m_waveformSummary->getDataSize()) {
                 qWarning() << "AnalyzerWaveform::process - current summary stride > waveform summary size";
                 return false;
@@ -251,6 +398,9 @@ bool AnalyzerWaveform::processSamples(const CSAMPLE* buffer, SINT count) {
         }
     }
 
+    m_waveform->updateMipmaps(firstStride, m_currentStride);
+    m_waveformSummary->updateMipmaps(firstSummaryStride, m_currentSummaryStride);
+
     //kLogger.debug() << "process - m_waveform->getCompletion()" << m_waveform->getCompletion() << "off" << m_waveform->getDataSize();
     //kLogger.debug() << "process - m_waveformSummary->getCompletion()" << m_waveformSummary->getCompletion() << "off" << m_waveformSummary->getDataSize();
     return true;
@@ -2,8 +2,10 @@
 
 #include <cmath>
 #include <limits>
+#include <memory>
 
 #include "analyzer/analyzer.h"
+#include "analyzer/waveformbandfilters.h"
 #include "library/dao/analysisdao.h"
 #include "util/performancetimer.h"
 #include "waveform/waveform.h"
@@ -14,7 +16,7 @@
 class QImage;
 #endif
 
-class EngineFilterIIRBase;
+class AnalyzerSignalLevels;
 class QSqlDatabase;
 
 inline CSAMPLE scaleSignal(CSAMPLE invalue, FilterIndex index = FilterCount) {
@@ -147,9 +149,12 @@ struct WaveformStride {
 
 class AnalyzerWaveform : public Analyzer {
   public:
+    /// Collects the shared signal levels in the same pass if they are
+    /// not collected by another analyzer.
     AnalyzerWaveform(
             UserSettingsPointer pConfig,
-            const QSqlDatabase& dbConnection);
+            const QSqlDatabase& dbConnection,
+            std::shared_ptr<AnalyzerSignalLevels> pSignalLevels = nullptr);
     ~AnalyzerWaveform() override;
 
     bool initialize(const AnalyzerTrack& track,
@@ -162,6 +167,13 @@ class AnalyzerWaveform : public Analyzer {
   private:
     bool shouldAnalyze(TrackPointer tio) const;
 
+    // Assigns a coarse waveform and summary to the track that are generated
+    // from a few short excerpts of the audio data. Returns false if the
+    // preview could not be generated in time.
+    bool generatePreview(const TrackPointer& pTrack,
+            mixxx::audio::SampleRate sampleRate,
+            SINT frameLength);
+
     void storeCurrentStridePower();
     void resetCurrentStride();
 
@@ -181,7 +193,10 @@ class AnalyzerWaveform : public Analyzer {
     int m_currentStride;
     int m_currentSummaryStride;
 
-    EngineFilterIIRBase* m_filter[FilterCount];
+    const std::shared_ptr<AnalyzerSignalLevels> m_pSignalLevels;
+    bool m_collectSignalLevels;
+
+    std::unique_ptr<WaveformBandFilters> m_pFilters;
     std::vector<float> m_buffers[FilterCount];
 
     PerformanceTimer m_timer;
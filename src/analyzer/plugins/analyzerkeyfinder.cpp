@@ -81,24 +81,30 @@ AnalyzerPluginInfo AnalyzerKeyFinder::pluginInfo() {
 
 bool AnalyzerKeyFinder::initialize(mixxx::audio::SampleRate sampleRate) {
     m_audioData.setFrameRate(sampleRate);
-    m_audioData.setChannels(kAnalysisChannels);
+    // KeyFinder analyzes a mono signal. Downmixing while copying halves the
+    // data that is copied for each chunk and skips the generic reduction to
+    // mono with its bounds checked accessors.
+    m_audioData.setChannels(1);
     return true;
 }
 
 bool AnalyzerKeyFinder::processSamples(const CSAMPLE* pIn, SINT iLen) {
     DEBUG_ASSERT(iLen % kAnalysisChannels == 0);
-    if (m_audioData.getSampleCount() == 0) {
-        m_audioData.addToSampleCount(iLen);
-    }
-
+    static_assert(kAnalysisChannels == 2);
     const SINT numInputFrames = iLen / kAnalysisChannels;
+    if (static_cast<SINT>(m_audioData.getFrameCount()) != numInputFrames) {
+        // The last chunk is usually shorter, the samples of the previous
+        // chunk must not be analyzed again
+        m_audioData.discardFramesFromFront(m_audioData.getFrameCount());
+        m_audioData.addToFrameCount(static_cast<unsigned int>(numInputFrames));
+    }
     m_currentFrame += numInputFrames;
 
+    m_audioData.resetIterators();
     for (SINT frame = 0; frame < numInputFrames; frame++) {
-        for (SINT channel = 0; channel < kAnalysisChannels; channel++) {
-            m_audioData.setSampleByFrame(
-                    frame, channel, pIn[frame * kAnalysisChannels + channel]);
-        }
+        m_audioData.setSampleAtWriteIterator(
+                (pIn[frame * 2] + pIn[frame * 2 + 1]) * 0.5);
+        m_audioData.advanceWriteIterator();
     }
     m_keyFinder.progressiveChromagram(m_audioData, m_workspace);
     return true;
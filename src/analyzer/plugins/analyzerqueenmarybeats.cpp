@@ -22,6 +22,19 @@ constexpr float kStepSecs = 0.01161f;
 // results in 43 Hz @ 44.1 kHz / 47 Hz @ 48 kHz / 47 Hz @ 96 kHz
 constexpr int kMaximumBinSizeHz = 50; // Hz
 
+// The buffers of the detection results are retained for the next track
+// up to the size needed for 20 minutes, i.e. ~100k results or ~800 kB
+// per buffer. Longer tracks allocate their buffers temporarily.
+constexpr int kMaxRetainedSeconds = 20 * 60;
+
+void releaseIfOversized(std::vector<double>* pBuffer, std::size_t maxRetainedSize) {
+    if (pBuffer->capacity() > maxRetainedSize) {
+        std::vector<double>().swap(*pBuffer);
+    } else {
+        pBuffer->clear();
+    }
+}
+
 DFConfig makeDetectionFunctionConfig(int stepSizeFrames, int windowSize) {
     // These are the defaults for the VAMP beat tracker plugin we used in Mixxx
     // 2.0.
@@ -48,16 +61,23 @@ AnalyzerQueenMaryBeats::~AnalyzerQueenMaryBeats() {
 
 bool AnalyzerQueenMaryBeats::initialize(mixxx::audio::SampleRate sampleRate) {
     m_detectionResults.clear();
-    m_sampleRate = sampleRate;
-    m_stepSizeFrames = static_cast<int>(m_sampleRate * kStepSecs);
-    m_windowSize = MathUtilities::nextPowerOfTwo(m_sampleRate / kMaximumBinSizeHz);
-    m_pDetectionFunction = std::make_unique<DetectionFunction>(
-            makeDetectionFunctionConfig(m_stepSizeFrames, m_windowSize));
+    m_resultBeats.clear();
+    if (m_pDetectionFunction && m_sampleRate == sampleRate) {
+        // Creating the FFT plans is expensive compared to analyzing a
+        // short track, so they are reused
+        m_pDetectionFunction->reset();
+    } else {
+        m_sampleRate = sampleRate;
+        m_stepSizeFrames = static_cast<int>(m_sampleRate * kStepSecs);
+        m_windowSize = MathUtilities::nextPowerOfTwo(m_sampleRate / kMaximumBinSizeHz);
+        m_pDetectionFunction = std::make_unique<DetectionFunction>(
+                makeDetectionFunctionConfig(m_stepSizeFrames, m_windowSize));
+        m_detectionResults.reserve(kMaxRetainedSeconds * m_sampleRate / m_stepSizeFrames);
+    }
     qDebug() << "input sample rate is " << m_sampleRate << ", step size is " << m_stepSizeFrames;
 
     m_helper.initialize(
             m_windowSize, m_stepSizeFrames, [this](double* pWindow, size_t) {
-                // TODO(rryan) reserve?
                 m_detectionResults.push_back(
                         m_pDetectionFunction->processTimeDomain(pWindow));
                 return true;
@@ -75,6 +95,9 @@ bool AnalyzerQueenMaryBeats::processSamples(const CSAMPLE* pIn, SINT iLen) {
 }
 
 bool AnalyzerQueenMaryBeats::finalize() {
+    if (!m_pDetectionFunction) {
+        return false;
+    }
     m_helper.finalize();
 
     int nonZeroCount = static_cast<int>(m_detectionResults.size());
@@ -82,25 +105,22 @@ bool AnalyzerQueenMaryBeats::finalize() {
         --nonZeroCount;
     }
 
-    std::vector<double> df;
-    std::vector<double> beatPeriod;
     std::vector<double> tempi;
-    const auto required_size = std::max(0, nonZeroCount - 2);
-    df.reserve(required_size);
-    beatPeriod.reserve(required_size);
-
-    // skip first 2 results as it might have detect noise as onset
-    // that's how vamp does and seems works best this way
-    for (int i = 2; i < nonZeroCount; ++i) {
-        df.push_back(m_detectionResults.at(i));
-        beatPeriod.push_back(0.0);
+    m_df.clear();
+    m_beatPeriod.clear();
+    if (nonZeroCount > 2) {
+        // skip first 2 results as it might have detect noise as onset
+        // that's how vamp does and seems works best this way
+        m_df.assign(m_detectionResults.begin() + 2,
+                m_detectionResults.begin() + nonZeroCount);
+        m_beatPeriod.assign(m_df.size(), 0.0);
     }
 
     TempoTrackV2 tt(m_sampleRate, m_stepSizeFrames);
-    tt.calculateBeatPeriod(df, beatPeriod, tempi);
+    tt.calculateBeatPeriod(m_df, m_beatPeriod, tempi);
 
     std::vector<double> beats;
-    tt.calculateBeats(df, beatPeriod, beats);
+    tt.calculateBeats(m_df, m_beatPeriod, beats);
 
     m_resultBeats.reserve(static_cast<int>(beats.size()));
     for (size_t i = 0; i < beats.size(); ++i) {
@@ -111,7 +131,10 @@ bool AnalyzerQueenMaryBeats::finalize() {
         m_resultBeats.push_back(result);
     }
 
-    m_pDetectionFunction.reset();
+    const std::size_t maxRetainedSize = kMaxRetainedSeconds * m_sampleRate / m_stepSizeFrames;
+    releaseIfOversized(&m_detectionResults, maxRetainedSize);
+    releaseIfOversized(&m_df, maxRetainedSize);
+    releaseIfOversized(&m_beatPeriod, maxRetainedSize);
     return true;
 }
 
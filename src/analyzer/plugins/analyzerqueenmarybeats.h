@@ -12,6 +12,10 @@ class DetectionFunction;
 
 namespace mixxx {
 
+/// Instances are meant to be reused for analyzing multiple tracks. The
+/// detection function with its FFT plans and the result buffers are
+/// kept between tracks, but the buffers only up to the size that is
+/// needed for a track of regular length.
 class AnalyzerQueenMaryBeats : public AnalyzerBeatsPlugin {
   public:
     static AnalyzerPluginInfo pluginInfo() {
@@ -50,6 +54,8 @@ class AnalyzerQueenMaryBeats : public AnalyzerBeatsPlugin {
     int m_windowSize;
     int m_stepSizeFrames;
     std::vector<double> m_detectionResults;
+    std::vector<double> m_df;
+    std::vector<double> m_beatPeriod;
     QVector<mixxx::audio::FramePos> m_resultBeats;
 };
 
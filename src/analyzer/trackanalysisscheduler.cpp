@@ -5,6 +5,9 @@
 #include "moc_trackanalysisscheduler.cpp"
 #include "track/trackid.h"
 #include "util/logger.h"
+#include "util/math.h"
+#include "util/physicalmemory.h"
+#include "util/powerprofile.h"
 
 namespace {
 
@@ -15,6 +18,18 @@ constexpr QThread::Priority kWorkerThreadPriority = QThread::LowPriority;
 // Maximum frequency of progress updates
 constexpr std::chrono::milliseconds kProgressInhibitDuration(100);
 
+// A pipelined analyzer thread keeps multiple cores busy with a single
+// track, namely the decoding and the slowest analyzer.
+constexpr int kCoresPerPipelinedWorkerThread = 2;
+
+// Rough upper bound of the memory that is occupied by an analyzer thread,
+// dominated by the beat and key detection of long tracks.
+constexpr qint64 kMemoryPerWorkerThreadBytes = 256 * 1024 * 1024;
+
+// The number of worker threads that keep analyzing while the power profile
+// saves energy
+constexpr int kPowerSavingWorkerThreadCount = 1;
+
 void deleteTrackAnalysisScheduler(TrackAnalysisScheduler* plainPtr) {
     if (plainPtr) {
         // Trigger stop
@@ -46,6 +61,21 @@ TrackAnalysisScheduler::Pointer TrackAnalysisScheduler::createInstance(
             deleteTrackAnalysisScheduler);
 }
 
+//static
+int TrackAnalysisScheduler::defaultWorkerThreadCount(bool pipelined) {
+    const int numCores = math_max(1, QThread::idealThreadCount());
+    int numThreads = pipelined
+            ? math_max(1, numCores / kCoresPerPipelinedWorkerThread)
+            : numCores;
+    const qint64 availableMemoryBytes = mixxx::availablePhysicalMemoryBytes();
+    if (availableMemoryBytes > 0) {
+        const qint64 maxThreads = math_max<qint64>(1,
+                availableMemoryBytes / kMemoryPerWorkerThreadBytes);
+        numThreads = static_cast<int>(math_min<qint64>(numThreads, maxThreads));
+    }
+    return numThreads;
+}
+
 TrackAnalysisScheduler::TrackAnalysisScheduler(
         std::unique_ptr<const TrackAnalysisSchedulerEnvironment> pEnvironment,
         int numWorkerThreads,
@@ -53,6 +83,11 @@ TrackAnalysisScheduler::TrackAnalysisScheduler(
         const UserSettingsPointer& pConfig,
         AnalyzerModeFlags modeFlags)
         : m_pEnvironment(std::move(pEnvironment)),
+          m_pPowerSaving(make_parented<ControlProxy>(
+                  mixxx::PowerProfile::kPowerSavingConfigKey,
+                  this,
+                  ControlFlag::NoAssertIfMissing)),
+          m_activeWorkerCount(numWorkerThreads),
           m_currentTrackProgress(kAnalyzerProgressUnknown),
           m_currentTrackNumber(0),
           m_dequeuedTracksCount(0),
@@ -83,6 +118,8 @@ TrackAnalysisScheduler::TrackAnalysisScheduler(
                 this,
                 &TrackAnalysisScheduler::onWorkerThreadProgress);
     }
+    m_pPowerSaving->connectValueChanged(this, &TrackAnalysisScheduler::slotPowerSavingChanged);
+    slotPowerSavingChanged(m_pPowerSaving->get());
     // 2nd pass: Start worker threads in a suspended state
     for (const auto& worker: m_workers) {
         worker.thread()->suspend();
@@ -170,7 +207,7 @@ void TrackAnalysisScheduler::emitProgressOrFinished() {
         }
     }
     const int totalTracksCount =
-            m_dequeuedTracksCount + static_cast<int>(m_queuedTracks.size());
+            m_dequeuedTracksCount + queuedTracksCount();
     DEBUG_ASSERT(m_currentTrackNumber <= m_dequeuedTracksCount);
     DEBUG_ASSERT(m_dequeuedTracksCount <= totalTracksCount);
     emit progress(
@@ -201,7 +238,9 @@ void TrackAnalysisScheduler::onWorkerThreadProgress(
         DEBUG_ASSERT(!trackId.isValid());
         DEBUG_ASSERT(analyzerProgress == kAnalyzerProgressUnknown);
         worker.onAnalyzerProgress(analyzerProgress);
-        submitNextTrack(&worker);
+        if (isWorkerActive(threadId)) {
+            submitNextTrack(&worker);
+        }
         break;
     case AnalyzerThreadState::Busy:
         DEBUG_ASSERT(trackId.isValid());
@@ -243,7 +282,7 @@ bool TrackAnalysisScheduler::scheduleTrack(AnalyzerScheduledTrack track) {
                 << track.getTrackId();
         return false;
     }
-    m_queuedTracks.push_back(track);
+    m_queuedTracks[static_cast<int>(track.getPriority())].push_back(track);
     // Don't wake up the suspended thread now to avoid race conditions
     // if multiple threads are added in a row by calling this function
     // multiple times. The caller is responsible to finish the scheduling
@@ -275,21 +314,48 @@ void TrackAnalysisScheduler::resume() {
     }
 }
 
+void TrackAnalysisScheduler::slotPowerSavingChanged(double value) {
+    const int numWorkerThreads = static_cast<int>(m_workers.size());
+    const int activeWorkerCount = value > 0
+            ? math_min(numWorkerThreads, kPowerSavingWorkerThreadCount)
+            : numWorkerThreads;
+    if (activeWorkerCount == m_activeWorkerCount) {
+        return;
+    }
+    kLogger.info()
+            << "Analyzing with"
+            << activeWorkerCount
+            << "of"
+            << numWorkerThreads
+            << "worker threads";
+    const int previousActiveWorkerCount = m_activeWorkerCount;
+    m_activeWorkerCount = activeWorkerCount;
+    // Tracks that are already analyzed by the now inactive workers are
+    // finished. Idle workers that become active need a new track.
+    for (int threadId = previousActiveWorkerCount; threadId < m_activeWorkerCount; ++threadId) {
+        auto& worker = m_workers[threadId];
+        if (worker) {
+            submitNextTrack(&worker);
+        }
+    }
+}
+
 bool TrackAnalysisScheduler::submitNextTrack(Worker* worker) {
     DEBUG_ASSERT(worker);
-    while (!m_queuedTracks.empty()) {
-        AnalyzerScheduledTrack nextScheduledTrack = m_queuedTracks.front();
+    while (TrackQueue* pQueue = nextTrackQueue()) {
+        AnalyzerScheduledTrack nextScheduledTrack = pQueue->front();
         TrackId nextTrackId = nextScheduledTrack.getTrackId();
         DEBUG_ASSERT(nextTrackId.isValid());
         if (nextTrackId.isValid()) {
             TrackPointer nextTrackPtr =
                     m_pEnvironment->loadTrackById(nextTrackId);
             if (nextTrackPtr) {
-                AnalyzerTrack nextTrack(nextTrackPtr, nextScheduledTrack.getOptions());
+                AnalyzerTrack nextTrack(nextTrackPtr,
+                        nextScheduledTrack.getOptions(),
+                        nextScheduledTrack.getPriority());
                 if (m_pendingTrackIds.insert(nextTrackId).second) {
                     if (worker->submitNextTrack(std::move(nextTrack))) {
-                        m_queuedTracks.pop_front();
-                        ++m_dequeuedTracksCount;
+                        popNextQueuedTrack(pQueue);
                         return true;
                     } else {
                         // The worker may already have been assigned new tasks
@@ -319,12 +385,34 @@ bool TrackAnalysisScheduler::submitNextTrack(Worker* worker) {
                     << nextTrackId;
         }
         // Skip this track
-        m_queuedTracks.pop_front();
-        ++m_dequeuedTracksCount;
+        popNextQueuedTrack(pQueue);
     }
     return false;
 }
 
+TrackAnalysisScheduler::TrackQueue* TrackAnalysisScheduler::nextTrackQueue() {
+    for (auto queue = m_queuedTracks.rbegin(); queue != m_queuedTracks.rend(); ++queue) {
+        if (!queue->empty()) {
+            return &*queue;
+        }
+    }
+    return nullptr;
+}
+
+void TrackAnalysisScheduler::popNextQueuedTrack(TrackQueue* pQueue) {
+    DEBUG_ASSERT(pQueue && !pQueue->empty());
+    pQueue->pop_front();
+    ++m_dequeuedTracksCount;
+}
+
+int TrackAnalysisScheduler::queuedTracksCount() const {
+    int count = 0;
+    for (const auto& queue : m_queuedTracks) {
+        count += static_cast<int>(queue.size());
+    }
+    return count;
+}
+
 void TrackAnalysisScheduler::stop() {
     kLogger.debug() << "Stopping";
     for (auto& worker: m_workers) {
@@ -332,7 +420,9 @@ void TrackAnalysisScheduler::stop() {
     }
     // The worker threads are still running at this point
     // and m_workers must not be modified!
-    m_queuedTracks.clear();
+    for (auto& queue : m_queuedTracks) {
+        queue.clear();
+    }
     m_pendingTrackIds.clear();
     DEBUG_ASSERT((allTracksFinished()));
 }
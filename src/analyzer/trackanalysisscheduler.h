@@ -1,6 +1,7 @@
 #pragma once
 
 #include <QList>
+#include <array>
 #include <deque>
 #include <memory>
 #include <set>
@@ -8,7 +9,9 @@
 
 #include "analyzer/analyzerscheduledtrack.h"
 #include "analyzer/analyzerthread.h"
+#include "control/controlproxy.h"
 #include "util/db/dbconnectionpool.h"
+#include "util/parented_ptr.h"
 
 /// Callbacks for triggering side-effects in the outer context of
 /// TrackAnalysisScheduler.
@@ -40,6 +43,10 @@ class TrackAnalysisScheduler : public QObject {
             const UserSettingsPointer& pConfig,
             AnalyzerModeFlags modeFlags);
 
+    // Utilizes all available cores for batch analysis of tracks unless
+    // the available memory is insufficient
+    static int defaultWorkerThreadCount(bool pipelined);
+
     /*private*/ TrackAnalysisScheduler(
             std::unique_ptr<const TrackAnalysisSchedulerEnvironment> pEnvironment,
             int numWorkerThreads,
@@ -49,7 +56,8 @@ class TrackAnalysisScheduler : public QObject {
     ~TrackAnalysisScheduler() override;
 
     // Schedule single or multiple tracks. After all tracks have been scheduled
-    // the caller must invoke resume() once.
+    // the caller must invoke resume() once. Each priority class has its own
+    // queue and the tracks of a higher class are submitted first.
     bool scheduleTrack(AnalyzerScheduledTrack track);
     int scheduleTracks(const QList<AnalyzerScheduledTrack>& tracks);
 
@@ -72,6 +80,7 @@ class TrackAnalysisScheduler : public QObject {
 
   private slots:
     void onWorkerThreadProgress(int threadId, AnalyzerThreadState threadState, TrackId trackId, AnalyzerProgress analyzerProgress);
+    void slotPowerSavingChanged(double value);
 
   private:
     // Owns an analyzer thread and buffers the most recent progress update
@@ -139,11 +148,22 @@ class TrackAnalysisScheduler : public QObject {
         AnalyzerProgress m_analyzerProgress;
     };
 
+    typedef std::deque<AnalyzerScheduledTrack> TrackQueue;
+
     bool submitNextTrack(Worker* worker);
+    // Idle workers beyond the active worker count don't receive new
+    // tracks, e.g. while running on battery
+    bool isWorkerActive(int threadId) const {
+        return threadId < m_activeWorkerCount;
+    }
+    // The queue of the highest priority class with tracks or nullptr
+    TrackQueue* nextTrackQueue();
+    void popNextQueuedTrack(TrackQueue* pQueue);
+    int queuedTracksCount() const;
     void emitProgressOrFinished();
 
     bool allTracksFinished() const {
-        return m_queuedTracks.empty() &&
+        return queuedTracksCount() == 0 &&
                 m_pendingTrackIds.empty();
     }
 
@@ -151,7 +171,11 @@ class TrackAnalysisScheduler : public QObject {
 
     std::vector<Worker> m_workers;
 
-    std::deque<AnalyzerScheduledTrack> m_queuedTracks;
+    parented_ptr<ControlProxy> m_pPowerSaving;
+    int m_activeWorkerCount;
+
+    // Indexed by AnalyzerPriority
+    std::array<TrackQueue, kAnalyzerPriorityCount> m_queuedTracks;
 
     // Tracks that have already been submitted to workers
     // and not yet reported back as finished.
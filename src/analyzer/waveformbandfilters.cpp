@@ -0,0 +1,131 @@
+#include "analyzer/waveformbandfilters.h"
+
+#include "engine/filters/enginefilterbessel4.h"
+
+namespace {
+
+// The left and the right channel of the low pass, then of the high pass
+constexpr int kLowLeft = 0;
+constexpr int kLowRight = 1;
+constexpr int kHighLeft = 2;
+constexpr int kHighRight = 3;
+
+// The signs of the feed forward part of each section, see the
+// specializations of EngineFilterIIR::processSample()
+constexpr double kLowPassSign = 1.0;
+constexpr double kHighPassSign = -1.0;
+constexpr double kBandPassSigns[] = {-1.0, -1.0, 1.0, 1.0};
+
+} // anonymous namespace
+
+WaveformBandFilters::WaveformBandFilters(mixxx::audio::SampleRate sampleRate) {
+    // The coefficients are designed by the same filters that are applied
+    // sample by sample otherwise. The gain is the first coefficient,
+    // followed by two coefficients for each section.
+    const EngineFilterBessel4Low low(sampleRate, kLowMidCornerHz);
+    const EngineFilterBessel4Band mid(sampleRate, kLowMidCornerHz, kMidHighCornerHz);
+    const EngineFilterBessel4High high(sampleRate, kMidHighCornerHz);
+    const double* const pLowCoef = low.coefficients();
+    const double* const pMidCoef = mid.coefficients();
+    const double* const pHighCoef = high.coefficients();
+
+    m_lowHighGain[kLowLeft] = pLowCoef[0];
+    m_lowHighGain[kLowRight] = pLowCoef[0];
+    m_lowHighGain[kHighLeft] = pHighCoef[0];
+    m_lowHighGain[kHighRight] = pHighCoef[0];
+    for (int i = 0; i < kLowHighSections; ++i) {
+        auto& section = m_lowHighSections[i];
+        for (const int lane : {kLowLeft, kLowRight}) {
+            section.coef1[lane] = pLowCoef[1 + i * 2];
+            section.coef2[lane] = pLowCoef[2 + i * 2];
+            section.sign[lane] = kLowPassSign;
+        }
+        for (const int lane : {kHighLeft, kHighRight}) {
+            section.coef1[lane] = pHighCoef[1 + i * 2];
+            section.coef2[lane] = pHighCoef[2 + i * 2];
+            section.sign[lane] = kHighPassSign;
+        }
+    }
+
+    for (int lane = 0; lane < kMidLanes; ++lane) {
+        m_midGain[lane] = pMidCoef[0];
+    }
+    for (int i = 0; i < kMidSections; ++i) {
+        auto& section = m_midSections[i];
+        for (int lane = 0; lane < kMidLanes; ++lane) {
+            section.coef1[lane] = pMidCoef[1 + i * 2];
+            section.coef2[lane] = pMidCoef[2 + i * 2];
+            section.sign[lane] = kBandPassSigns[i];
+        }
+    }
+
+    reset();
+}
+
+void WaveformBandFilters::reset() {
+    for (auto& section : m_lowHighSections) {
+        for (int lane = 0; lane < kLowHighLanes; ++lane) {
+            section.state1[lane] = 0.0;
+            section.state2[lane] = 0.0;
+        }
+    }
+    for (auto& section : m_midSections) {
+        for (int lane = 0; lane < kMidLanes; ++lane) {
+            section.state1[lane] = 0.0;
+            section.state2[lane] = 0.0;
+        }
+    }
+}
+
+// static
+template<int kLanes>
+inline void WaveformBandFilters::processSection(
+        Section<kLanes>* pSection, double* pValues) {
+    // Same order of operations as EngineFilterIIR::processSample()
+    // to get the same results
+    for (int lane = 0; lane < kLanes; ++lane) {
+        const double older = pSection->state1[lane];
+        const double old = pSection->state2[lane];
+        double iir = pValues[lane];
+        iir -= pSection->coef1[lane] * older;
+        iir -= pSection->coef2[lane] * old;
+        double fir = older;
+        fir += pSection->sign[lane] * (old + old);
+        fir += iir;
+        pSection->state1[lane] = old;
+        pSection->state2[lane] = iir;
+        pValues[lane] = fir;
+    }
+}
+
+void WaveformBandFilters::process(const CSAMPLE* pIn,
+        CSAMPLE* pLow,
+        CSAMPLE* pMid,
+        CSAMPLE* pHigh,
+        SINT numSamples) {
+    for (SINT i = 0; i < numSamples; i += 2) {
+        const double left = pIn[i];
+        const double right = pIn[i + 1];
+
+        double lowHigh[kLowHighLanes];
+        lowHigh[kLowLeft] = left * m_lowHighGain[kLowLeft];
+        lowHigh[kLowRight] = right * m_lowHighGain[kLowRight];
+        lowHigh[kHighLeft] = left * m_lowHighGain[kHighLeft];
+        lowHigh[kHighRight] = right * m_lowHighGain[kHighRight];
+        for (auto& section : m_lowHighSections) {
+            processSection(&section, lowHigh);
+        }
+
+        double mid[kMidLanes] = {left * m_midGain[0], right * m_midGain[1]};
+        for (auto& section : m_midSections) {
+            processSection(&section, mid);
+        }
+
+        pLow[i] = static_cast<CSAMPLE>(lowHigh[kLowLeft]);
+        pLow[i + 1] = static_cast<CSAMPLE>(lowHigh[kLowRight]);
+        pMid[i] = static_cast<CSAMPLE>(mid[0]);
+        pMid[i + 1] = static_cast<CSAMPLE>(mid[1]);
+        pHigh[i] = static_cast<CSAMPLE>(lowHigh[kHighLeft]);
+        pHigh[i + 1] = static_cast<CSAMPLE>(lowHigh[kHighRight]);
+    }
+}
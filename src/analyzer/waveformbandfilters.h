@@ -0,0 +1,61 @@
+#pragma once
+
+#include "audio/types.h"
+#include "util/types.h"
+
+/// The low, mid, and high band filters of the waveform analysis for
+/// interleaved stereo samples.
+///
+/// Produces exactly the same output as processing the samples with an
+/// EngineFilterBessel4Low, EngineFilterBessel4Band, and
+/// EngineFilterBessel4High one after another. But instead of running each
+/// filter sample by sample for each channel, the second order sections of
+/// all bands and channels that are independent of each other are computed
+/// side by side. The low and the high pass have the same structure and are
+/// processed in four lanes, one for each channel of both bands. The two
+/// channels of the band pass with twice as many sections make up two more
+/// lanes. The lanes are plain arrays that map directly to SIMD registers
+/// when the loops are vectorized by the compiler.
+class WaveformBandFilters {
+  public:
+    static constexpr double kLowMidCornerHz = 600;
+    static constexpr double kMidHighCornerHz = 4000;
+
+    explicit WaveformBandFilters(mixxx::audio::SampleRate sampleRate);
+
+    /// The filters start settled for silence
+    void reset();
+
+    void process(const CSAMPLE* pIn,
+            CSAMPLE* pLow,
+            CSAMPLE* pMid,
+            CSAMPLE* pHigh,
+            SINT numSamples);
+
+  private:
+    // Left and right channel of the low pass and the high pass
+    static constexpr int kLowHighLanes = 4;
+    static constexpr int kLowHighSections = 2;
+    // Left and right channel of the band pass
+    static constexpr int kMidLanes = 2;
+    static constexpr int kMidSections = 4;
+
+    template<int kLanes>
+    struct Section {
+        double coef1[kLanes];
+        double coef2[kLanes];
+        // +1 for the low pass and -1 for the high pass sections
+        double sign[kLanes];
+        // The previous two outputs of the recursive part, older first
+        double state1[kLanes];
+        double state2[kLanes];
+    };
+
+    template<int kLanes>
+    static void processSection(Section<kLanes>* pSection, double* pValues);
+
+    double m_lowHighGain[kLowHighLanes];
+    Section<kLowHighLanes> m_lowHighSections[kLowHighSections];
+    double m_midGain[kMidLanes];
+    Section<kMidLanes> m_midSections[kMidSections];
+};
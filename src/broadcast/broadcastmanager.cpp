@@ -7,6 +7,8 @@
 #undef WIN32
 #endif
 
+#include <algorithm>
+
 #include "broadcast/broadcastmanager.h"
 #include "broadcast/defs_broadcast.h"
 #include "control/controlpushbutton.h"
@@ -18,13 +20,15 @@
 
 namespace {
 const mixxx::Logger kLogger("BroadcastManager");
+constexpr int kSendQueueFillUpdateIntervalMillis = 250;
 } // namespace
 
 BroadcastManager::BroadcastManager(SettingsManager* pSettingsManager,
                                    SoundManager* pSoundManager)
         : m_pConfig(pSettingsManager->settings()),
           m_pBroadcastSettings(pSettingsManager->broadcastSettings()),
-          m_pNetworkStream(pSoundManager->getNetworkStream()) {
+          m_pNetworkStream(pSoundManager->getNetworkStream()),
+          m_pEncoderPool(std::make_shared<SharedEncoderPool>()) {
     const bool persist = true;
     m_pBroadcastEnabled = new ControlPushButton(
             ConfigKey(BROADCAST_PREF_KEY,"enabled"), persist);
@@ -38,6 +42,14 @@ BroadcastManager::BroadcastManager(SettingsManager* pSettingsManager,
     m_pStatusCO->setReadOnly();
     m_pStatusCO->forceSet(STATUSCO_UNCONNECTED);
 
+    m_pSendQueueFillCO = new ControlObject(ConfigKey(BROADCAST_PREF_KEY, "send_queue_fill"));
+    m_pSendQueueFillCO->setReadOnly();
+    m_sendQueueFillTimer.setInterval(kSendQueueFillUpdateIntervalMillis);
+    connect(&m_sendQueueFillTimer,
+            &QTimer::timeout,
+            this,
+            &BroadcastManager::slotUpdateSendQueueFill);
+
     // Initialize libshout
     shout_init();
 
@@ -68,6 +80,8 @@ BroadcastManager::~BroadcastManager() {
     // Disable broadcast so when Mixxx starts again it will not connect.
     m_pBroadcastEnabled->set(0);
 
+    m_sendQueueFillTimer.stop();
+    delete m_pSendQueueFillCO;
     delete m_pStatusCO;
     delete m_pBroadcastEnabled;
 
@@ -114,9 +128,12 @@ void BroadcastManager::slotControlEnabled(double v) {
         }
 
         slotProfilesChanged();
+        m_sendQueueFillTimer.start();
     } else {
         m_pBroadcastEnabled->set(false);
         m_pStatusCO->forceSet(STATUSCO_UNCONNECTED);
+        m_sendQueueFillTimer.stop();
+        m_pSendQueueFillCO->forceSet(0.0);
         QList<BroadcastProfilePtr> profiles = m_pBroadcastSettings->profiles();
         for(BroadcastProfilePtr profile : profiles) {
            if (profile->connectionStatus() == BroadcastProfile::STATUS_FAILURE) {
@@ -160,7 +177,7 @@ bool BroadcastManager::addConnection(BroadcastProfilePtr profile) {
         return false;
     }
 
-    ShoutConnectionPtr connection(new ShoutConnection(profile, m_pConfig));
+    ShoutConnectionPtr connection(new ShoutConnection(profile, m_pConfig, m_pEncoderPool));
     m_pNetworkStream->addOutputWorker(connection);
 
     connect(profile.data(),
@@ -260,3 +277,15 @@ void BroadcastManager::slotConnectionStatusChanged(int newState) {
         m_pStatusCO->forceSet(STATUSCO_UNCONNECTED);
     }
 }
+
+void BroadcastManager::slotUpdateSendQueueFill() {
+    double fill = 0.0;
+    const QVector<NetworkOutputStreamWorkerPtr> workers = m_pNetworkStream->outputWorkers();
+    for (const NetworkOutputStreamWorkerPtr& pWorker : workers) {
+        ShoutConnectionPtr connection = qSharedPointerCast<ShoutConnection>(pWorker);
+        if (connection) {
+            fill = std::max(fill, connection->sendQueueFill());
+        }
+    }
+    m_pSendQueueFillCO->forceSet(fill);
+}
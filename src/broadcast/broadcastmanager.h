@@ -1,6 +1,7 @@
 #pragma once
 
 #include <QObject>
+#include <QTimer>
 
 #include "engine/sidechain/shoutconnection.h"
 #include "preferences/broadcastsettings.h"
@@ -43,6 +44,7 @@ class BroadcastManager : public QObject {
     void slotProfileRemoved(BroadcastProfilePtr profile);
     void slotProfilesChanged();
     void slotConnectionStatusChanged(int newState);
+    void slotUpdateSendQueueFill();
 
   private:
     bool addConnection(BroadcastProfilePtr profile);
@@ -52,7 +54,11 @@ class BroadcastManager : public QObject {
     UserSettingsPointer m_pConfig;
     BroadcastSettingsPointer m_pBroadcastSettings;
     QSharedPointer<EngineNetworkStream> m_pNetworkStream;
+    SharedEncoderPoolPointer m_pEncoderPool;
 
     ControlPushButton* m_pBroadcastEnabled;
     ControlObject* m_pStatusCO;
+    // Fill level of the fullest send queue of all connections
+    ControlObject* m_pSendQueueFillCO;
+    QTimer m_sendQueueFillTimer;
 };
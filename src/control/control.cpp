@@ -1,6 +1,8 @@
 #include "control/control.h"
 
+#include "control/controlchangedispatcher.h"
 #include "control/controlobject.h"
+#include "control/controlvalueblock.h"
 #include "moc_control.cpp"
 #include "util/stat.h"
 
@@ -38,7 +40,10 @@ ControlDoublePrivate::ControlDoublePrivate()
                   Stat::SAMPLE_VARIANCE | Stat::MIN | Stat::MAX),
           // default CO is read only
           m_confirmRequired(true),
-          m_kbdRepeatable(false) {
+          m_kbdRepeatable(false),
+          m_pValue(&m_value),
+          m_coalescedSubscriberCount(0),
+          m_coalescedChangePending(false) {
     m_value.setValue(0.0);
 }
 
@@ -58,7 +63,16 @@ ControlDoublePrivate::ControlDoublePrivate(
           m_trackFlags(Stat::COUNT | Stat::SUM | Stat::AVERAGE |
                   Stat::SAMPLE_VARIANCE | Stat::MIN | Stat::MAX),
           m_confirmRequired(false),
-          m_kbdRepeatable(false) {
+          m_kbdRepeatable(false),
+          m_pValueBlock(ControlValueBlock::get(key.group)),
+          m_pValue(m_pValueBlock ? m_pValueBlock->allocate() : nullptr),
+          m_coalescedSubscriberCount(0),
+          m_coalescedChangePending(false) {
+    if (!m_pValue) {
+        // No block for the group or it is full
+        m_pValueBlock.reset();
+        m_pValue = &m_value;
+    }
     initialize(defaultValue);
 }
 
@@ -73,16 +87,16 @@ void ControlDoublePrivate::initialize(double defaultValue) {
         }
     }
     m_defaultValue.setValue(defaultValue);
-    m_value.setValue(value);
+    m_pValue->setValue(value);
 
-    //qDebug() << "Creating:" << m_trackKey << "at" << &m_value << sizeof(m_value);
+    //qDebug() << "Creating:" << m_trackKey << "at" << m_pValue << sizeof(*m_pValue);
 
     if (m_bTrack) {
         // TODO(rryan): Make configurable.
         m_trackKey = "control " + m_key.group + "," + m_key.item;
         Stat::track(m_trackKey, static_cast<Stat::StatType>(m_trackType),
                     static_cast<Stat::ComputeFlags>(m_trackFlags),
-                    m_value.getValue());
+                    get());
     }
 }
 
@@ -92,12 +106,18 @@ ControlDoublePrivate::~ControlDoublePrivate() {
     s_qCOHash.remove(m_key);
     s_qCOHashMutex.unlock();
 
+    const double value = get();
+    if (m_pValueBlock) {
+        m_pValueBlock->release(m_pValue);
+        m_pValue = &m_value;
+    }
+
     if (m_bPersistInConfiguration) {
         UserSettingsPointer pConfig = s_pUserConfig;
         VERIFY_OR_DEBUG_ASSERT(pConfig) {
             return;
         }
-        pConfig->set(m_key, QString::number(get()));
+        pConfig->set(m_key, QString::number(value));
     }
 }
 
@@ -294,8 +314,11 @@ void ControlDoublePrivate::setInner(double value, QObject* pSender) {
     if (m_bIgnoreNops && get() == value) {
         return;
     }
-    m_value.setValue(value);
+    m_pValue->setValue(value);
     emit valueChanged(value, pSender);
+    if (m_coalescedSubscriberCount.load(std::memory_order_relaxed) > 0) {
+        ControlChangeDispatcher::notify(this, value, pSender);
+    }
 
     if (m_bTrack) {
         Stat::track(m_trackKey, static_cast<Stat::StatType>(m_trackType),
@@ -5,6 +5,8 @@
 #include <QObject>
 #include <QSharedPointer>
 #include <QString>
+#include <atomic>
+#include <memory>
 
 #include "control/controlbehavior.h"
 #include "control/controlvalue.h"
@@ -12,6 +14,7 @@
 #include "util/mutex.h"
 
 class ControlObject;
+class ControlValueBlock;
 
 enum class ControlFlag {
     None = 0,
@@ -95,7 +98,7 @@ class ControlDoublePrivate : public QObject {
     void setAndConfirm(double value, QObject* pSender);
     // Gets the control value.
     double get() const {
-        return m_value.getValue();
+        return m_pValue->getValue();
     }
     // Resets the control value to its default.
     void reset();
@@ -120,6 +123,10 @@ class ControlDoublePrivate : public QObject {
         return m_bIgnoreNops;
     }
 
+    bool isPersistent() const {
+        return m_bPersistInConfiguration;
+    }
+
     void setDefaultValue(double dValue) {
         m_defaultValue.setValue(dValue);
     }
@@ -161,6 +168,10 @@ class ControlDoublePrivate : public QObject {
     // pointer to the setter of the value (potentially NULL).
     void valueChanged(double value, QObject* pSender);
     void valueChangeRequest(double value);
+    // Emitted in the main thread for subscribers of the
+    // ControlChangeDispatcher. Changes from other threads are coalesced
+    // and pSender is NULL for them.
+    void valueChangedCoalesced(double value, QObject* pSender);
 
   protected:
     ControlDoublePrivate();
@@ -209,12 +220,23 @@ class ControlDoublePrivate : public QObject {
     // If true, this control will be issued repeatedly if the keyboard key is held.
     bool m_kbdRepeatable;
 
-    // The control value.
+    // The control value, unless it is stored in the ControlValueBlock of
+    // the group.
     ControlValueAtomic<double> m_value;
+    std::shared_ptr<ControlValueBlock> m_pValueBlock;
+    // Points to m_value or into m_pValueBlock
+    ControlValueAtomic<double>* m_pValue;
     // The default control value.
     ControlValueAtomic<double> m_defaultValue;
 
     QSharedPointer<ControlNumericBehavior> m_pBehavior;
+
+    friend class ControlChangeDispatcher;
+    // The number of ControlProxy objects that receive coalesced notifications
+    std::atomic<int> m_coalescedSubscriberCount;
+    // Set when the value has been changed by another thread than the main
+    // thread since the last coalesced notification.
+    std::atomic<bool> m_coalescedChangePending;
 };
 
 /// The constant ControlDoublePrivate version is used as dummy for default
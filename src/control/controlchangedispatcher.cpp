@@ -0,0 +1,108 @@
+#include "control/controlchangedispatcher.h"
+
+#include <QCoreApplication>
+#include <QThread>
+
+#include "control/control.h"
+#include "moc_controlchangedispatcher.cpp"
+#include "util/assert.h"
+
+namespace {
+
+// Roughly once per frame of a 60 Hz display
+constexpr int kDispatchIntervalMillis = 16;
+
+std::atomic<ControlChangeDispatcher*> s_pInstance = nullptr;
+
+} // namespace
+
+ControlChangeDispatcher::ControlChangeDispatcher(QObject* pParent)
+        : QObject(pParent),
+          m_pThread(QThread::currentThread()),
+          m_changePending(false) {
+    m_timer.setInterval(kDispatchIntervalMillis);
+    connect(&m_timer,
+            &QTimer::timeout,
+            this,
+            &ControlChangeDispatcher::slotDispatch);
+}
+
+ControlChangeDispatcher::~ControlChangeDispatcher() {
+    s_pInstance.store(nullptr, std::memory_order_release);
+}
+
+//static
+ControlChangeDispatcher* ControlChangeDispatcher::instance() {
+    ControlChangeDispatcher* pInstance = s_pInstance.load(std::memory_order_acquire);
+    if (!pInstance) {
+        DEBUG_ASSERT(!QCoreApplication::instance() ||
+                QThread::currentThread() == QCoreApplication::instance()->thread());
+        // Deleted together with the application
+        pInstance = new ControlChangeDispatcher(QCoreApplication::instance());
+        s_pInstance.store(pInstance, std::memory_order_release);
+    }
+    return pInstance;
+}
+
+void ControlChangeDispatcher::subscribe(
+        const QSharedPointer<ControlDoublePrivate>& pControl) {
+    DEBUG_ASSERT(QThread::currentThread() == m_pThread);
+    if (pControl->m_coalescedSubscriberCount.fetch_add(1) == 0) {
+        // The address might still be occupied by an expired control
+        m_controls.insert(pControl.data(), pControl);
+    }
+    if (!m_timer.isActive()) {
+        m_timer.start();
+    }
+}
+
+void ControlChangeDispatcher::unsubscribe(
+        const QSharedPointer<ControlDoublePrivate>& pControl) {
+    DEBUG_ASSERT(QThread::currentThread() == m_pThread);
+    const int subscriberCount = pControl->m_coalescedSubscriberCount.fetch_sub(1);
+    DEBUG_ASSERT(subscriberCount > 0);
+    if (subscriberCount == 1) {
+        m_controls.remove(pControl.data());
+        if (m_controls.isEmpty()) {
+            m_timer.stop();
+        }
+    }
+}
+
+//static
+void ControlChangeDispatcher::notify(
+        ControlDoublePrivate* pControl, double value, QObject* pSender) {
+    ControlChangeDispatcher* pInstance = s_pInstance.load(std::memory_order_acquire);
+    if (!pInstance) {
+        return;
+    }
+    if (QThread::currentThread() == pInstance->m_pThread) {
+        emit pControl->valueChangedCoalesced(value, pSender);
+        return;
+    }
+    pControl->m_coalescedChangePending.store(true, std::memory_order_release);
+    pInstance->m_changePending.store(true, std::memory_order_release);
+}
+
+void ControlChangeDispatcher::slotDispatch() {
+    if (!m_changePending.exchange(false, std::memory_order_acq_rel)) {
+        return;
+    }
+    // Collect all changed controls before notifying the subscribers,
+    // which might subscribe or unsubscribe while being notified.
+    QList<QSharedPointer<ControlDoublePrivate>> changedControls;
+    for (auto it = m_controls.begin(); it != m_controls.end();) {
+        QSharedPointer<ControlDoublePrivate> pControl = it.value().toStrongRef();
+        if (!pControl) {
+            it = m_controls.erase(it);
+            continue;
+        }
+        if (pControl->m_coalescedChangePending.exchange(false, std::memory_order_acq_rel)) {
+            changedControls.append(std::move(pControl));
+        }
+        ++it;
+    }
+    for (const auto& pControl : std::as_const(changedControls)) {
+        emit pControl->valueChangedCoalesced(pControl->get(), nullptr);
+    }
+}
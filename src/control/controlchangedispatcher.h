@@ -0,0 +1,49 @@
+#pragma once
+
+#include <QHash>
+#include <QObject>
+#include <QSharedPointer>
+#include <QTimer>
+#include <QWeakPointer>
+#include <atomic>
+
+class ControlDoublePrivate;
+
+/// Coalesces the change notifications of controls for subscribers in the
+/// main thread.
+///
+/// Changing a control from another thread, e.g. VU meters or beat_active
+/// from the engine, would otherwise post a queued event for every change
+/// and every connected ControlProxy. Instead, these changes only set an
+/// atomic flag in the control. All flagged controls are collected once
+/// per dispatch interval and each subscriber receives a single
+/// notification with the latest value.
+///
+/// Changes in the main thread are still delivered immediately.
+class ControlChangeDispatcher : public QObject {
+    Q_OBJECT
+  public:
+    /// Creates the instance on first use, which must happen in
+    /// the main thread.
+    static ControlChangeDispatcher* instance();
+
+    /// Main thread only
+    void subscribe(const QSharedPointer<ControlDoublePrivate>& pControl);
+    void unsubscribe(const QSharedPointer<ControlDoublePrivate>& pControl);
+
+    /// Invoked by ControlDoublePrivate after each change if
+    /// there are subscribers. Thread-safe and non-blocking.
+    static void notify(ControlDoublePrivate* pControl, double value, QObject* pSender);
+
+  private slots:
+    void slotDispatch();
+
+  private:
+    explicit ControlChangeDispatcher(QObject* pParent);
+    ~ControlChangeDispatcher() override;
+
+    QThread* const m_pThread;
+    std::atomic<bool> m_changePending;
+    QTimer m_timer;
+    QHash<ControlDoublePrivate*, QWeakPointer<ControlDoublePrivate>> m_controls;
+};
@@ -15,6 +15,11 @@ class ControlObjectScript : public ControlProxy {
             const RuntimeLoggingCategory& logger,
             QObject* pParent = nullptr);
 
+    /// Returns nullptr if the control has already been deleted
+    ControlObject* getControlObject() const {
+        return m_pControl->getCreatorCO();
+    }
+
     bool addScriptConnection(const ScriptConnection& conn);
 
     bool removeScriptConnection(const ScriptConnection& conn);
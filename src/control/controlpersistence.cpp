@@ -0,0 +1,170 @@
+#include "control/controlpersistence.h"
+
+#include <QFile>
+#include <QSaveFile>
+#include <QTextStream>
+
+#include "control/control.h"
+#include "moc_controlpersistence.cpp"
+#include "util/backgroundtask.h"
+#include "util/logger.h"
+
+namespace {
+
+const mixxx::Logger kLogger("ControlPersistence");
+
+QByteArray formatLogLine(const ConfigKey& key, const QString& value) {
+    return (key.group + QChar(',') + key.item + QChar(' ') + value + QChar('\n')).toUtf8();
+}
+
+void appendToLog(const QString& logFilePath, const QByteArray& lines) {
+    QFile file(logFilePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        kLogger.warning() << "Failed to open" << logFilePath << file.errorString();
+        return;
+    }
+    if (file.write(lines) != lines.size()) {
+        kLogger.warning() << "Failed to append to" << logFilePath << file.errorString();
+    }
+}
+
+void rewriteLog(const QString& logFilePath, const QByteArray& lines) {
+    // Replaces the log atomically, a crash never leaves a truncated log
+    QSaveFile file(logFilePath);
+    if (!file.open(QIODevice::WriteOnly) ||
+            file.write(lines) != lines.size() ||
+            !file.commit()) {
+        kLogger.warning() << "Failed to compact" << logFilePath << file.errorString();
+    }
+}
+
+} // anonymous namespace
+
+ControlPersistence::ControlPersistence(UserSettingsPointer pConfig, QString logFilePath)
+        : m_pConfig(std::move(pConfig)),
+          m_logFilePath(std::move(logFilePath)),
+          m_logSize(0) {
+    replayLog();
+    m_timer.setInterval(kPersistIntervalMillis);
+    connect(&m_timer, &QTimer::timeout, this, &ControlPersistence::slotTimeout);
+    m_timer.start();
+}
+
+ControlPersistence::~ControlPersistence() {
+    m_timer.stop();
+    waitForPendingWrite();
+}
+
+void ControlPersistence::replayLog() {
+    QFile file(m_logFilePath);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        return;
+    }
+    // The log is only left over if Mixxx has not been shut down properly,
+    // then its values are newer than those in the config.
+    int count = 0;
+    QTextStream stream(&file);
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+    stream.setCodec("UTF-8");
+#endif
+    while (!stream.atEnd()) {
+        const QString line = stream.readLine();
+        const int separator = line.lastIndexOf(QChar(' '));
+        if (separator <= 0) {
+            // An incomplete last line after a crash
+            continue;
+        }
+        const ConfigKey key = ConfigKey::parseCommaSeparated(line.left(separator));
+        if (!key.isValid()) {
+            continue;
+        }
+        const QString value = line.mid(separator + 1);
+        m_pConfig->set(key, ConfigValue(value));
+        m_loggedValues.insert(key, value);
+        ++count;
+    }
+    m_logSize = file.size();
+    kLogger.info() << "Restored" << count << "control values from" << m_logFilePath;
+}
+
+void ControlPersistence::slotTimeout() {
+    persistChanges();
+}
+
+void ControlPersistence::persistChanges() {
+    if (m_pendingWrite.isRunning()) {
+        // The changes are picked up on the next invocation
+        return;
+    }
+    QByteArray lines;
+    const auto controls = ControlDoublePrivate::getAllInstances();
+    for (const auto& pControl : controls) {
+        if (!pControl->isPersistent()) {
+            continue;
+        }
+        const ConfigKey& key = pControl->getKey();
+        const QString value = QString::number(pControl->get());
+        auto it = m_persistedValues.find(key);
+        if (it == m_persistedValues.end()) {
+            // The control has been created since the last invocation and
+            // has loaded its value from the config.
+            it = m_persistedValues.insert(key, m_pConfig->getValueString(key));
+        }
+        if (it.value() == value) {
+            continue;
+        }
+        it.value() = value;
+        m_loggedValues.insert(key, value);
+        lines += formatLogLine(key, value);
+    }
+    if (lines.isEmpty()) {
+        return;
+    }
+
+    if (m_logSize + lines.size() <= kMaxLogSize) {
+        m_logSize += lines.size();
+        m_pendingWrite = mixxx::backgroundtask::run(
+                mixxx::BackgroundTaskPriority::Batch,
+                [logFilePath = m_logFilePath, lines] {
+                    appendToLog(logFilePath, lines);
+                });
+        return;
+    }
+
+    // Compact the log to the latest value of each control
+    QByteArray allLines;
+    for (auto it = m_loggedValues.constBegin(); it != m_loggedValues.constEnd(); ++it) {
+        allLines += formatLogLine(it.key(), it.value());
+    }
+    m_logSize = allLines.size();
+    m_pendingWrite = mixxx::backgroundtask::run(
+            mixxx::BackgroundTaskPriority::Batch,
+            [logFilePath = m_logFilePath, allLines] {
+                rewriteLog(logFilePath, allLines);
+            });
+}
+
+void ControlPersistence::waitForPendingWrite() {
+    m_pendingWrite.waitForFinished();
+}
+
+void ControlPersistence::storeInConfig() {
+    const auto controls = ControlDoublePrivate::getAllInstances();
+    for (const auto& pControl : controls) {
+        if (pControl->isPersistent()) {
+            m_pConfig->set(pControl->getKey(), QString::number(pControl->get()));
+        }
+    }
+}
+
+void ControlPersistence::discardLog() {
+    waitForPendingWrite();
+    // All values are in the config now. Values of controls that are
+    // deleted later are written to the config by the controls.
+    m_persistedValues.clear();
+    m_loggedValues.clear();
+    m_logSize = 0;
+    if (QFile::exists(m_logFilePath) && !QFile::remove(m_logFilePath)) {
+        kLogger.warning() << "Failed to remove" << m_logFilePath;
+    }
+}
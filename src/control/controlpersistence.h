@@ -0,0 +1,63 @@
+#pragma once
+
+#include <QFuture>
+#include <QHash>
+#include <QObject>
+#include <QString>
+#include <QTimer>
+
+#include "preferences/usersettings.h"
+
+/// Persists the values of persistent controls while Mixxx is running.
+///
+/// Persistent controls only write their value to the user config when
+/// they are deleted, and the config is only saved at shutdown. Values
+/// that have been changed since the start would be lost by a crash, and
+/// saving the whole config more often would block the main thread on
+/// slow storage like SD cards.
+///
+/// Instead, the changed values are collected periodically and appended
+/// to a small log file by a background task. When the log grows too
+/// large it is compacted to the latest value of each control. On the
+/// next start the log is replayed into the config before any control is
+/// created, and it is discarded whenever the config has been saved.
+class ControlPersistence : public QObject {
+    Q_OBJECT
+  public:
+    static constexpr int kPersistIntervalMillis = 2000;
+    static constexpr qint64 kMaxLogSize = 64 * 1024;
+
+    /// Replays an existing log into the config.
+    ControlPersistence(UserSettingsPointer pConfig, QString logFilePath);
+    ~ControlPersistence() override;
+
+    /// Writes the current values of all persistent controls into the
+    /// config, e.g. right before saving it.
+    void storeInConfig();
+    /// Removes the log once the config has been saved with all values.
+    void discardLog();
+
+    /// Starts writing the values that have changed since the last
+    /// invocation. Does nothing while the previous write is in progress.
+    void persistChanges();
+    /// Blocks until the pending write has finished
+    void waitForPendingWrite();
+
+  private slots:
+    void slotTimeout();
+
+  private:
+    void replayLog();
+
+    const UserSettingsPointer m_pConfig;
+    const QString m_logFilePath;
+    QTimer m_timer;
+
+    /// The latest value of each control that is either stored in the
+    /// config or has been appended to the log.
+    QHash<ConfigKey, QString> m_persistedValues;
+    /// The latest value of each control in the log, for compacting it
+    QHash<ConfigKey, QString> m_loggedValues;
+    qint64 m_logSize;
+    QFuture<void> m_pendingWrite;
+};
@@ -1,6 +1,7 @@
 #include "control/controlproxy.h"
 
 #include "control/control.h"
+#include "control/controlchangedispatcher.h"
 #include "moc_controlproxy.cpp"
 
 ControlProxy::ControlProxy(const QString& g, const QString& i, QObject* pParent, ControlFlags flags)
@@ -8,7 +9,8 @@ ControlProxy::ControlProxy(const QString& g, const QString& i, QObject* pParent,
 }
 
 ControlProxy::ControlProxy(const ConfigKey& key, QObject* pParent, ControlFlags flags)
-        : QObject(pParent) {
+        : QObject(pParent),
+          m_coalescedSubscription(false) {
     m_pControl = ControlDoublePrivate::getControl(key, flags);
     if (!m_pControl) {
         DEBUG_ASSERT(flags & ControlFlag::AllowMissingOrInvalid);
@@ -19,6 +21,22 @@ ControlProxy::ControlProxy(const ConfigKey& key, QObject* pParent, ControlFlags
 
 ControlProxy::~ControlProxy() {
     //qDebug() << "ControlProxy::~ControlProxy()";
+    if (m_coalescedSubscription) {
+        ControlChangeDispatcher::instance()->unsubscribe(m_pControl);
+    }
+}
+
+void ControlProxy::subscribeCoalesced() {
+    if (m_coalescedSubscription) {
+        return;
+    }
+    m_coalescedSubscription = true;
+    connect(m_pControl.data(),
+            &ControlDoublePrivate::valueChangedCoalesced,
+            this,
+            &ControlProxy::slotValueChangedDirect,
+            Qt::DirectConnection);
+    ControlChangeDispatcher::instance()->subscribe(m_pControl);
 }
 
 const ConfigKey& ControlProxy::getKey() const {
@@ -100,6 +100,23 @@ class ControlProxy : public QObject {
         return true;
     }
 
+    /// Like connectValueChanged(), but changes from other threads than the
+    /// main thread are coalesced by the ControlChangeDispatcher and only the
+    /// latest value is delivered once per dispatch interval. Only for
+    /// proxies that live in the main thread, e.g. skin widgets that display
+    /// the value. Must not be combined with connectValueChanged().
+    template<typename Receiver, typename Slot>
+    bool connectValueChangedCoalesced(Receiver receiver, Slot func) {
+        if (!valid()) {
+            return false;
+        }
+        if (!connect(this, &ControlProxy::valueChanged, receiver, func, Qt::DirectConnection)) {
+            return false;
+        }
+        subscribeCoalesced();
+        return true;
+    }
+
     /// Called from update();
     virtual void emitValueChanged() {
         emit valueChanged(get());
@@ -186,4 +203,9 @@ class ControlProxy : public QObject {
   protected:
     /// Pointer to connected control.
     QSharedPointer<ControlDoublePrivate> m_pControl;
+
+  private:
+    void subscribeCoalesced();
+
+    bool m_coalescedSubscription;
 };
@@ -2,6 +2,7 @@
 
 #include <QAtomicInt>
 #include <QObject>
+#include <atomic>
 #include <limits>
 
 #include "util/assert.h"
@@ -165,3 +166,52 @@ class ControlValueAtomic : public ControlValueAtomicBase<T, cRingSize, sizeof(T)
   public:
     ControlValueAtomic() = default;
 };
+
+// A triple buffer for passing snapshots of a value of type T from exactly one
+// writer thread to exactly one reader thread, e.g. from the engine to the VSync
+// thread. Unlike ControlValueAtomic both getValue() and setValue() are
+// wait-free without any retries and the reader always gets the most recent
+// value that has been completely written.
+//
+// The writer fills its back buffer and then exchanges it with the middle
+// buffer, marking the middle buffer as fresh. The reader only exchanges its
+// front buffer with the middle buffer if it is fresh. Multiple readers need
+// to use separate instances.
+template<typename T>
+class ControlValueTripleBuffer {
+  public:
+    ControlValueTripleBuffer()
+            : m_middle(1),
+              m_front(0),
+              m_back(2) {
+    }
+
+    // Must only be called by the reader thread
+    T getValue() const {
+        if (m_middle.load(std::memory_order_relaxed) & kFresh) {
+            const int middle = m_middle.exchange(m_front, std::memory_order_acq_rel);
+            m_front = middle & kIndexMask;
+        }
+        return m_buffers[m_front];
+    }
+
+    // Must only be called by the writer thread
+    void setValue(const T& value) {
+        m_buffers[m_back] = value;
+        const int middle = m_middle.exchange(m_back | kFresh, std::memory_order_acq_rel);
+        m_back = middle & kIndexMask;
+    }
+
+  private:
+    static constexpr int kIndexMask = 0x3;
+    static constexpr int kFresh = 0x4;
+
+    T m_buffers[3];
+    // The index of the middle buffer and if it contains a value
+    // that has not been read yet
+    mutable std::atomic<int> m_middle;
+    // Only accessed by the reader
+    mutable int m_front;
+    // Only accessed by the writer
+    int m_back;
+};
@@ -0,0 +1,76 @@
+#include "control/controlvalueblock.h"
+
+#include <QHash>
+
+#include "util/assert.h"
+
+namespace {
+
+/// Mutex guarding access to s_blocks.
+MMutex s_blocksMutex;
+
+/// The blocks of all groups that have one.
+QHash<QString, std::weak_ptr<ControlValueBlock>> s_blocks
+        GUARDED_BY(s_blocksMutex);
+
+} // namespace
+
+ControlValueBlock::ControlValueBlock(const QString& group)
+        : m_group(group) {
+    m_freeIndices.reserve(kCapacity);
+    for (int i = kCapacity - 1; i >= 0; --i) {
+        m_values[i].setValue(0.0);
+        m_freeIndices.push_back(i);
+    }
+}
+
+ControlValueBlock::~ControlValueBlock() {
+    DEBUG_ASSERT(allocatedCount() == 0);
+    MMutexLocker locker(&s_blocksMutex);
+    const auto it = s_blocks.find(m_group);
+    // Another block may have been created for the group in the meantime
+    if (it != s_blocks.end() && it.value().expired()) {
+        s_blocks.erase(it);
+    }
+}
+
+// static
+std::shared_ptr<ControlValueBlock> ControlValueBlock::create(const QString& group) {
+    auto pBlock = std::make_shared<ControlValueBlock>(group);
+    MMutexLocker locker(&s_blocksMutex);
+    // Controls that outlive a previous block of the group keep it alive,
+    // but new controls use the new one.
+    s_blocks.insert(group, pBlock);
+    return pBlock;
+}
+
+// static
+std::shared_ptr<ControlValueBlock> ControlValueBlock::get(const QString& group) {
+    MMutexLocker locker(&s_blocksMutex);
+    return s_blocks.value(group).lock();
+}
+
+ControlValueAtomic<double>* ControlValueBlock::allocate() {
+    MMutexLocker locker(&m_mutex);
+    if (m_freeIndices.empty()) {
+        return nullptr;
+    }
+    const int index = m_freeIndices.back();
+    m_freeIndices.pop_back();
+    return &m_values[index];
+}
+
+void ControlValueBlock::release(ControlValueAtomic<double>* pValue) {
+    const auto index = pValue - m_values.data();
+    VERIFY_OR_DEBUG_ASSERT(index >= 0 && index < kCapacity) {
+        return;
+    }
+    pValue->setValue(0.0);
+    MMutexLocker locker(&m_mutex);
+    m_freeIndices.push_back(static_cast<int>(index));
+}
+
+int ControlValueBlock::allocatedCount() const {
+    MMutexLocker locker(&m_mutex);
+    return kCapacity - static_cast<int>(m_freeIndices.size());
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <QString>
+#include <array>
+#include <memory>
+#include <vector>
+
+#include "control/controlvalue.h"
+#include "util/mutex.h"
+
+/// Stores the values of the controls of one group next to each other, so
+/// the engine touches a few cache lines instead of one scattered heap
+/// allocation per control when it reads them in every callback.
+///
+/// While the block of a group exists, controls that are created for this
+/// group keep their value in the block until it is full. Engine channels
+/// create their block before any of their controls, so the values are
+/// packed in the order the engine creates them.
+class ControlValueBlock final {
+  public:
+    static constexpr int kCapacity = 512;
+
+    explicit ControlValueBlock(const QString& group);
+    ~ControlValueBlock();
+
+    /// Creates the block for the group, which is used by new controls of
+    /// the group until it is destroyed.
+    static std::shared_ptr<ControlValueBlock> create(const QString& group);
+    /// Returns the block of the group or nullptr if none exists.
+    static std::shared_ptr<ControlValueBlock> get(const QString& group);
+
+    const QString& group() const {
+        return m_group;
+    }
+
+    /// Returns an unused value or nullptr if the block is full. Thread-safe,
+    /// blocking.
+    ControlValueAtomic<double>* allocate();
+    /// Returns a value obtained from allocate() to the block. Thread-safe,
+    /// blocking.
+    void release(ControlValueAtomic<double>* pValue);
+
+    int allocatedCount() const;
+
+  private:
+    ControlValueBlock(ControlValueBlock&&) = delete;
+    ControlValueBlock(const ControlValueBlock&) = delete;
+    ControlValueBlock& operator=(ControlValueBlock&&) = delete;
+    ControlValueBlock& operator=(const ControlValueBlock&) = delete;
+
+    // Start on a cache line of its own
+    alignas(64) std::array<ControlValueAtomic<double>, kCapacity> m_values;
+
+    const QString m_group;
+
+    mutable MMutex m_mutex;
+    // Indices of the unused values, the next one to allocate at the back
+    std::vector<int> m_freeIndices GUARDED_BY(m_mutex);
+};
@@ -2,6 +2,9 @@
 
 #include <libusb.h>
 
+#include <algorithm>
+#include <cstring>
+
 #include "controllers/bulk/bulksupported.h"
 #include "controllers/defs_controllers.h"
 #include "moc_bulkcontroller.cpp"
@@ -92,6 +95,10 @@ BulkController::~BulkController() {
     }
 }
 
+ControllerJSProxy* BulkController::jsProxy() {
+    return new BulkControllerJSProxy(this);
+}
+
 QString BulkController::mappingExtension() {
     return BULK_MAPPING_EXTENSION;
 }
@@ -245,3 +252,41 @@ void BulkController::sendBytes(const QByteArray& data) {
                              << "serial #" << m_sUID;
     }
 }
+
+QList<int> BulkControllerJSProxy::changedRows(
+        int screenId, const QByteArray& frame, int bytesPerRow) {
+    if (bytesPerRow <= 0) {
+        qCWarning(m_pBulkController->m_logOutput)
+                << "Invalid number of bytes per row:" << bytesPerRow;
+        return {};
+    }
+    const int numRows = (frame.size() + bytesPerRow - 1) / bytesPerRow;
+    QByteArray& previousFrame = m_previousFrames[screenId];
+    if (previousFrame.size() != frame.size()) {
+        previousFrame = frame;
+        return numRows > 0 ? QList<int>{0, numRows} : QList<int>{};
+    }
+
+    // memcmp is vectorized by the C library
+    const auto rowChanged = [&](int row) {
+        const int offset = row * bytesPerRow;
+        const int size = std::min(bytesPerRow, frame.size() - offset);
+        return std::memcmp(frame.constData() + offset,
+                       previousFrame.constData() + offset,
+                       size) != 0;
+    };
+    int firstRow = 0;
+    while (firstRow < numRows && !rowChanged(firstRow)) {
+        ++firstRow;
+    }
+    if (firstRow == numRows) {
+        return {};
+    }
+    int endRow = numRows;
+    while (!rowChanged(endRow - 1)) {
+        --endRow;
+    }
+    // Reuses the allocated memory, because the size is unchanged
+    std::memcpy(previousFrame.data(), frame.constData(), frame.size());
+    return {firstRow, endRow};
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <QAtomicInt>
+#include <QHash>
 #include <QThread>
 
 #include "controllers/controller.h"
@@ -39,6 +40,8 @@ class BulkController : public Controller {
             struct libusb_device_descriptor* desc);
     ~BulkController() override;
 
+    ControllerJSProxy* jsProxy() override;
+
     QString mappingExtension() override;
 
     virtual std::shared_ptr<LegacyControllerMapping> cloneMapping() override;
@@ -82,4 +85,40 @@ class BulkController : public Controller {
     QString m_sUID;
     BulkReader* m_pReader;
     std::shared_ptr<LegacyHidControllerMapping> m_pMapping;
+
+    friend class BulkControllerJSProxy;
+};
+
+class BulkControllerJSProxy : public ControllerJSProxy {
+    Q_OBJECT
+  public:
+    BulkControllerJSProxy(BulkController* m_pController)
+            : ControllerJSProxy(m_pController),
+              m_pBulkController(m_pController) {
+    }
+
+    /// @brief Sends data to the bulk OUT endpoint of the device
+    /// @param data Data to send as byte array (Javascript type Uint8Array),
+    ///  which is passed without converting each byte like send() does,
+    ///  e.g. for the frames of controller screens
+    Q_INVOKABLE void sendBytes(const QByteArray& data) {
+        m_pBulkController->sendBytes(data);
+    }
+
+    /// @brief Compares a frame of a controller screen with the previous
+    ///  frame of the same screen, so that only the changed rows need to be
+    ///  encoded and sent
+    /// @param screenId Any number that identifies the screen
+    /// @param frame The frame as byte array (Javascript type Uint8Array)
+    ///  in any pixel format with rows of bytesPerRow bytes
+    /// @param bytesPerRow The size of a row in bytes
+    /// @return The first changed row and the row after the last changed row,
+    ///  or an empty list if the frame is unchanged. All rows have changed
+    ///  if the size of the frame differs from the previous one.
+    Q_INVOKABLE QList<int> changedRows(
+            int screenId, const QByteArray& frame, int bytesPerRow);
+
+  private:
+    BulkController* m_pBulkController;
+    QHash<int, QByteArray> m_previousFrames;
 };
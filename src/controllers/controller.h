@@ -169,6 +169,7 @@ class Controller : public QObject {
     friend class ControllerManager;
     // For testing
     friend class LegacyControllerMappingValidationTest;
+    friend class ControllerBenchmark;
 };
 
 // An object of this class gets exposed to the JS engine, so the methods of this class
@@ -25,18 +25,47 @@
 #include "controllers/bulk/bulkenumerator.h"
 #endif
 
+#ifdef __LINUX__
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#endif
+
 // http://developer.qt.nokia.com/wiki/Threads_Events_QObjects
 
-// Poll every 1ms (where possible) for good controller response
-#ifdef __LINUX__
-// Many Linux distros ship with the system tick set to 250Hz so 1ms timer
-// reportedly causes CPU hosage. See Bug #990992 rryan 6/2012
-const mixxx::Duration ControllerManager::kPollInterval = mixxx::Duration::fromMillis(5);
-#else
+// Poll every 1ms for good controller response. The polling period adds to
+// the latency of every message from controllers without an I/O thread of
+// their own, e.g. PortMidi, which has no blocking or notifying input API.
+// Linux used 5ms in the past, because 1ms timers reportedly caused a high
+// CPU load with a system tick of 250Hz (Bug #990992). Current tickless
+// kernels use high resolution timers and an idle poll takes a few µs.
 const mixxx::Duration ControllerManager::kPollInterval = mixxx::Duration::fromMillis(1);
-#endif
 
 namespace {
+
+#ifdef __LINUX__
+// The nice value of the controller thread. The threads that are started
+// from it, e.g. the HID I/O threads, inherit it.
+constexpr int kControllerThreadNiceValue = -10;
+#endif
+
+/// QThread::HighPriority has no effect on Linux, because the priority of the
+/// default scheduling policy is fixed. Lower the nice value of the current
+/// thread instead, so that a busy GUI thread does not delay the controllers.
+/// This needs the permission to raise the priority, e.g. by RLIMIT_NICE.
+void raiseControllerThreadPriority() {
+#ifdef __LINUX__
+    const auto tid = static_cast<id_t>(syscall(SYS_gettid));
+    if (setpriority(PRIO_PROCESS, tid, kControllerThreadNiceValue) != 0) {
+        qDebug() << "Failed to set the nice value of the controller thread to"
+                 << kControllerThreadNiceValue << ":" << std::strerror(errno);
+    }
+#endif
+}
+
 /// Strip slashes and spaces from device name, so that it can be used as config
 /// key or a filename.
 QString sanitizeDeviceName(QString name) {
@@ -101,6 +130,9 @@ ControllerManager::ControllerManager(UserSettingsPointer pConfig)
     }
 
     m_pollTimer.setInterval(kPollInterval.toIntegerMillis());
+    // A coarse timer may be aligned with other timers, which shows up as
+    // jitter of the incoming messages, e.g. of MIDI jog wheels
+    m_pollTimer.setTimerType(Qt::PreciseTimer);
     connect(&m_pollTimer, &QTimer::timeout, this, &ControllerManager::pollDevices);
 
     m_pThread = new QThread;
@@ -139,12 +171,19 @@ ControllerLearningEventFilter* ControllerManager::getControllerLearningEventFilt
 void ControllerManager::slotInitialize() {
     qDebug() << "ControllerManager:slotInitialize";
 
+    // Runs on m_pThread
+    raiseControllerThreadPriority();
+
     // Initialize mapping info parsers. This object is only for use in the main
     // thread. Do not touch it from within ControllerManager.
+    // Only mappings that changed since the last run are parsed, the other
+    // headers are read from the catalogs.
     m_pMainThreadUserMappingEnumerator = QSharedPointer<MappingInfoEnumerator>(
-            new MappingInfoEnumerator(userMappingsPath(m_pConfig)));
+            new MappingInfoEnumerator(userMappingsPath(m_pConfig),
+                    mappingCatalogPath(m_pConfig, QStringLiteral("user"))));
     m_pMainThreadSystemMappingEnumerator = QSharedPointer<MappingInfoEnumerator>(
-            new MappingInfoEnumerator(resourceMappingsPath(m_pConfig)));
+            new MappingInfoEnumerator(resourceMappingsPath(m_pConfig),
+                    mappingCatalogPath(m_pConfig, QStringLiteral("system"))));
 
     // Instantiate all enumerators. Enumerators can take a long time to
     // construct since they interact with host MIDI APIs.
@@ -116,3 +116,49 @@ ProductInfo MappingInfo::parseHIDProduct(const QDomElement& element) const {
     product.interface_number = element.attribute("interface_number");
     return product;
 }
+
+QDataStream& operator<<(QDataStream& out, const ProductInfo& product) {
+    return out << product.protocol
+               << product.vendor_id
+               << product.product_id
+               << product.in_epaddr
+               << product.out_epaddr
+               << product.usage_page
+               << product.usage
+               << product.interface_number;
+}
+
+QDataStream& operator>>(QDataStream& in, ProductInfo& product) {
+    return in >> product.protocol >>
+            product.vendor_id >>
+            product.product_id >>
+            product.in_epaddr >>
+            product.out_epaddr >>
+            product.usage_page >>
+            product.usage >>
+            product.interface_number;
+}
+
+QDataStream& operator<<(QDataStream& out, const MappingInfo& info) {
+    return out << info.m_valid
+               << info.m_path
+               << info.m_dirPath
+               << info.m_name
+               << info.m_author
+               << info.m_description
+               << info.m_forumlink
+               << info.m_wikilink
+               << info.m_products;
+}
+
+QDataStream& operator>>(QDataStream& in, MappingInfo& info) {
+    return in >> info.m_valid >>
+            info.m_path >>
+            info.m_dirPath >>
+            info.m_name >>
+            info.m_author >>
+            info.m_description >>
+            info.m_forumlink >>
+            info.m_wikilink >>
+            info.m_products;
+}
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <QDataStream>
 #include <QDomElement>
 #include <QList>
 #include <QMap>
@@ -24,6 +25,9 @@ struct ProductInfo {
     QString interface_number;
 };
 
+QDataStream& operator<<(QDataStream& out, const ProductInfo& product);
+QDataStream& operator>>(QDataStream& in, ProductInfo& product);
+
 /// Base class handling enumeration and parsing of mapping info headers
 ///
 /// This class handles enumeration and parsing of controller XML description file
@@ -64,6 +68,11 @@ class MappingInfo {
         return m_products;
     }
 
+    /// Serializes the parsed header for the mapping catalog, see
+    /// MappingInfoEnumerator
+    friend QDataStream& operator<<(QDataStream& out, const MappingInfo& info);
+    friend QDataStream& operator>>(QDataStream& in, MappingInfo& info);
+
   private:
     ProductInfo parseBulkProduct(const QDomElement& element) const;
     ProductInfo parseHIDProduct(const QDomElement& element) const;
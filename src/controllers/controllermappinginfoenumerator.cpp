@@ -1,10 +1,18 @@
 #include "controllers/controllermappinginfoenumerator.h"
 
+#include <QDataStream>
 #include <QDirIterator>
+#include <QFile>
+#include <QSaveFile>
 
 #include "controllers/defs_controllers.h"
 
 namespace {
+
+// Must be incremented whenever the serialized MappingInfo changes
+constexpr qint32 kCatalogVersion = 1;
+constexpr QDataStream::Version kCatalogStreamVersion = QDataStream::Qt_5_12;
+
 bool mappingInfoNameComparator(const MappingInfo& a, const MappingInfo& b) {
     if (a.getDirPath() == b.getDirPath()) {
         // FIXME: Mixxx copies every loaded mapping into the user mapping folder
@@ -23,16 +31,22 @@ bool mappingInfoNameComparator(const MappingInfo& a, const MappingInfo& b) {
 }
 } // namespace
 
-MappingInfoEnumerator::MappingInfoEnumerator(const QString& searchPath)
-        : MappingInfoEnumerator(QList<QString>{searchPath}) {
+MappingInfoEnumerator::MappingInfoEnumerator(const QString& searchPath,
+        const QString& catalogFilePath)
+        : MappingInfoEnumerator(QList<QString>{searchPath}, catalogFilePath) {
 }
 
-MappingInfoEnumerator::MappingInfoEnumerator(const QStringList& searchPaths)
-        : m_controllerDirPaths(searchPaths) {
-    loadSupportedMappings();
+MappingInfoEnumerator::MappingInfoEnumerator(const QStringList& searchPaths,
+        const QString& catalogFilePath)
+        : m_controllerDirPaths(searchPaths),
+          m_catalogFilePath(catalogFilePath),
+          m_loaded(false) {
 }
 
 QList<MappingInfo> MappingInfoEnumerator::getMappingsByExtension(const QString& extension) {
+    if (!m_loaded) {
+        loadSupportedMappings();
+    }
     if (extension == MIDI_MAPPING_EXTENSION) {
         return m_midiMappings;
     } else if (extension == HID_MAPPING_EXTENSION) {
@@ -49,22 +63,40 @@ void MappingInfoEnumerator::loadSupportedMappings() {
     m_midiMappings.clear();
     m_hidMappings.clear();
     m_bulkMappings.clear();
+    m_loaded = true;
 
+    const Catalog catalog = readCatalog();
+    Catalog updatedCatalog;
+    int parsedCount = 0;
     for (const QString& dirPath : std::as_const(m_controllerDirPaths)) {
         QDirIterator it(dirPath);
         while (it.hasNext()) {
             it.next();
             const QString path = it.filePath();
 
+            QList<MappingInfo>* pMappings = nullptr;
             if (path.endsWith(MIDI_MAPPING_EXTENSION, Qt::CaseInsensitive)) {
-                m_midiMappings.append(MappingInfo(path));
+                pMappings = &m_midiMappings;
             } else if (path.endsWith(HID_MAPPING_EXTENSION, Qt::CaseInsensitive)) {
-                m_hidMappings.append(MappingInfo(path));
+                pMappings = &m_hidMappings;
             } else if (path.endsWith(BULK_MAPPING_EXTENSION, Qt::CaseInsensitive)) {
-                m_bulkMappings.append(MappingInfo(path));
+                pMappings = &m_bulkMappings;
+            } else {
+                continue;
+            }
+            bool parsed = false;
+            pMappings->append(mappingInfo(path, catalog, &updatedCatalog, &parsed));
+            if (parsed) {
+                ++parsedCount;
             }
         }
     }
+    // Also drops the entries of deleted mappings
+    if (parsedCount > 0 || updatedCatalog.size() != catalog.size()) {
+        writeCatalog(updatedCatalog);
+    }
+    qDebug() << "Parsed" << parsedCount << "of" << updatedCatalog.size()
+             << "controller mappings";
 
     std::sort(m_midiMappings.begin(), m_midiMappings.end(), mappingInfoNameComparator);
     std::sort(m_hidMappings.begin(), m_hidMappings.end(), mappingInfoNameComparator);
@@ -77,3 +109,77 @@ void MappingInfoEnumerator::loadSupportedMappings() {
     qDebug() << "Extension" << BULK_MAPPING_EXTENSION << "total"
              << m_bulkMappings.length() << "mappings";
 }
+
+MappingInfo MappingInfoEnumerator::mappingInfo(const QString& path,
+        const Catalog& catalog,
+        Catalog* pUpdatedCatalog,
+        bool* pParsed) const {
+    const QFileInfo fileInfo(path);
+    const QString absolutePath = fileInfo.absoluteFilePath();
+    CatalogEntry entry;
+    entry.lastModified = fileInfo.lastModified();
+    entry.size = fileInfo.size();
+    const auto it = catalog.constFind(absolutePath);
+    if (it != catalog.constEnd() &&
+            it->lastModified == entry.lastModified &&
+            it->size == entry.size) {
+        entry.info = it->info;
+        *pParsed = false;
+    } else {
+        entry.info = MappingInfo(absolutePath);
+        *pParsed = true;
+    }
+    pUpdatedCatalog->insert(absolutePath, entry);
+    return entry.info;
+}
+
+MappingInfoEnumerator::Catalog MappingInfoEnumerator::readCatalog() const {
+    Catalog catalog;
+    if (m_catalogFilePath.isEmpty()) {
+        return catalog;
+    }
+    QFile file(m_catalogFilePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return catalog;
+    }
+    QDataStream in(&file);
+    in.setVersion(kCatalogStreamVersion);
+    qint32 version = 0;
+    qint32 count = 0;
+    in >> version >> count;
+    if (version != kCatalogVersion) {
+        qDebug() << "Ignoring outdated controller mapping catalog" << m_catalogFilePath;
+        return catalog;
+    }
+    for (qint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+        QString path;
+        CatalogEntry entry;
+        in >> path >> entry.lastModified >> entry.size >> entry.info;
+        catalog.insert(path, entry);
+    }
+    if (in.status() != QDataStream::Ok) {
+        qWarning() << "Failed to read controller mapping catalog" << m_catalogFilePath;
+        return Catalog();
+    }
+    return catalog;
+}
+
+void MappingInfoEnumerator::writeCatalog(const Catalog& catalog) const {
+    if (m_catalogFilePath.isEmpty()) {
+        return;
+    }
+    QSaveFile file(m_catalogFilePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Failed to write controller mapping catalog" << m_catalogFilePath;
+        return;
+    }
+    QDataStream out(&file);
+    out.setVersion(kCatalogStreamVersion);
+    out << kCatalogVersion << static_cast<qint32>(catalog.size());
+    for (auto it = catalog.constBegin(); it != catalog.constEnd(); ++it) {
+        out << it.key() << it->lastModified << it->size << it->info;
+    }
+    if (!file.commit()) {
+        qWarning() << "Failed to write controller mapping catalog" << m_catalogFilePath;
+    }
+}
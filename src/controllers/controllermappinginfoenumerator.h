@@ -1,5 +1,7 @@
 #pragma once
 
+#include <QDateTime>
+#include <QHash>
 #include <QList>
 #include <QString>
 #include <QStringList>
@@ -7,20 +9,45 @@
 #include "controllers/controllermappinginfo.h"
 
 /// Enumerate list of available controller mapping mappings
+///
+/// The parsed headers can be stored in a catalog file. Only mappings that
+/// have been added or modified since the catalog was written are parsed
+/// again, all other headers are read from the catalog.
 class MappingInfoEnumerator {
   public:
-    MappingInfoEnumerator(const QString& searchPath);
-    MappingInfoEnumerator(const QStringList& searchPaths);
+    MappingInfoEnumerator(const QString& searchPath,
+            const QString& catalogFilePath = QString());
+    MappingInfoEnumerator(const QStringList& searchPaths,
+            const QString& catalogFilePath = QString());
 
-    // Return cached list of mappings for this extension
+    // Return cached list of mappings for this extension. The mappings are
+    // parsed on the first call, they are only needed in the preferences.
     QList<MappingInfo> getMappingsByExtension(const QString& extension);
     void loadSupportedMappings();
 
   private:
+    struct CatalogEntry {
+        QDateTime lastModified;
+        qint64 size;
+        MappingInfo info;
+    };
+    typedef QHash<QString, CatalogEntry> Catalog;
+
+    Catalog readCatalog() const;
+    void writeCatalog(const Catalog& catalog) const;
+    // Returns the header from the catalog if the file is unmodified
+    MappingInfo mappingInfo(const QString& path,
+            const Catalog& catalog,
+            Catalog* pUpdatedCatalog,
+            bool* pParsed) const;
+
     // List of paths for controller mappings
     QList<QString> m_controllerDirPaths;
+    // Empty if the catalog is disabled
+    const QString m_catalogFilePath;
 
     QList<MappingInfo> m_hidMappings;
     QList<MappingInfo> m_midiMappings;
     QList<MappingInfo> m_bulkMappings;
+    bool m_loaded;
 };
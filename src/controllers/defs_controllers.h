@@ -22,6 +22,12 @@ inline QString userMappingsPath(UserSettingsPointer pConfig) {
     return dir.absolutePath().append("/");
 }
 
+// The parsed headers of the mappings in one of the mapping directories
+inline QString mappingCatalogPath(UserSettingsPointer pConfig, const QString& name) {
+    return QDir(pConfig->getSettingsPath())
+            .filePath(QStringLiteral("controllermappings_%1.cache").arg(name));
+}
+
 #define HID_MAPPING_EXTENSION ".hid.xml"
 #define MIDI_MAPPING_EXTENSION ".midi.xml"
 #define BULK_MAPPING_EXTENSION ".bulk.xml"
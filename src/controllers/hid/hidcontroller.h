@@ -97,6 +97,9 @@ class HidControllerJSProxy : public ControllerJSProxy {
     ///      in these each field represents the state of a control (e.g. an LED).
     ///    - This mode works best in overload situations, where more reports
     ///      are to be sent, than can be processed.
+    ///    - Reports of this mode take at most half of the time of the IO thread,
+    ///      more frequent updates are merged. This leaves time for reading
+    ///      the InputReports and sending the reports of the other mode.
     ///  - True:
     ///    - The report will not be skipped under any circumstances,
     ///      except FIFO memory overflow.
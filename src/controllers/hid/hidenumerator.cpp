@@ -2,6 +2,8 @@
 
 #include <hidapi.h>
 
+#include <QtConcurrentRun>
+
 #include "controllers/hid/hidcontroller.h"
 #include "controllers/hid/hiddenylist.h"
 #include "controllers/hid/hiddevice.h"
@@ -77,19 +79,11 @@ bool recognizeDevice(const hid_device_info& device_info) {
     return true;
 }
 
-} // namespace
-
-HidEnumerator::~HidEnumerator() {
-    qDebug() << "Deleting HID devices...";
-    while (m_devices.size() > 0) {
-        delete m_devices.takeLast();
-    }
-    hid_exit();
-}
-
-QList<Controller*> HidEnumerator::queryDevices() {
+/// Returns the recognized devices. Runs on a worker thread.
+std::vector<mixxx::hid::DeviceInfo> enumerateDevices() {
     qInfo() << "Scanning USB HID devices";
 
+    std::vector<mixxx::hid::DeviceInfo> devices;
     QStringList enumeratedDevices;
     hid_device_info* device_info_list = hid_enumerate(0x0, 0x0);
     for (const auto* device_info = device_info_list;
@@ -120,10 +114,43 @@ QList<Controller*> HidEnumerator::queryDevices() {
             continue;
         }
 
+        devices.push_back(std::move(deviceInfo));
+    }
+    hid_free_enumeration(device_info_list);
+
+    return devices;
+}
+
+} // namespace
+
+HidEnumerator::HidEnumerator()
+        : m_enumeration(QtConcurrent::run(enumerateDevices)),
+          m_enumerationPending(true) {
+}
+
+HidEnumerator::~HidEnumerator() {
+    // hid_exit() must not be called while the enumeration is running
+    m_enumeration.waitForFinished();
+    qDebug() << "Deleting HID devices...";
+    while (m_devices.size() > 0) {
+        delete m_devices.takeLast();
+    }
+    hid_exit();
+}
+
+QList<Controller*> HidEnumerator::queryDevices() {
+    std::vector<mixxx::hid::DeviceInfo> devices;
+    if (m_enumerationPending) {
+        // Only blocks if the enumeration has not finished in the meantime
+        devices = m_enumeration.result();
+        m_enumerationPending = false;
+    } else {
+        devices = enumerateDevices();
+    }
+    for (auto& deviceInfo : devices) {
         HidController* newDevice = new HidController(std::move(deviceInfo));
         m_devices.push_back(newDevice);
     }
-    hid_free_enumeration(device_info_list);
 
     return m_devices;
 }
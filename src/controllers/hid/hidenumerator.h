@@ -1,17 +1,27 @@
 #pragma once
 
+#include <QFuture>
+#include <vector>
+
 #include "controllers/controllerenumerator.h"
+#include "controllers/hid/hiddevice.h"
 
 /// This class handles discovery and enumeration of DJ controllers that use the
 /// USB-HID protocol.
 class HidEnumerator : public ControllerEnumerator {
     Q_OBJECT
   public:
-    HidEnumerator() = default;
+    /// Starts enumerating the devices on a worker thread, because
+    /// hid_enumerate blocks for seconds with some USB hubs. The result
+    /// is awaited by queryDevices().
+    HidEnumerator();
     ~HidEnumerator() override;
 
     QList<Controller*> queryDevices() override;
 
   private:
+    QFuture<std::vector<mixxx::hid::DeviceInfo>> m_enumeration;
+    // Until the result of the initial enumeration has been taken
+    bool m_enumerationPending;
     QList<Controller*> m_devices;
 };
@@ -21,6 +21,15 @@ constexpr size_t kMaxHidErrorMessageSize = 512;
 // the fastest possible rate of HID devices with USB HighSpeed or USB SuperSpeed interface is 8kHz
 constexpr int kSleepTimeWhenIdleMicros = 250;
 
+// After sending a report from the skipping cache, no other cached report is
+// sent for the time that the hid_write took, multiplied by this factor.
+// This limits the cached reports to half of the time of the run loop,
+// independent of the speed of the device. The remaining time is left for
+// polling InputReports and for the reports of the non-skipping FIFO, which
+// are not limited. Scripts that update the cached reports more frequently,
+// e.g. for displays, have their updates merged in the meantime.
+constexpr int kCachedOutputReportPauseFactor = 1;
+
 QString loggingCategoryPrefix(const QString& deviceName) {
     return QStringLiteral("controller.") +
             RuntimeLoggingCategory::removeInvalidCharsFromCategory(deviceName.toLower());
@@ -224,7 +233,10 @@ bool HidIoThread::sendNextCachedOutputReport() {
     }
 
     // 2.) If non non-skipping reports were in the FIFO, send the skipable reports
-    // from the m_outputReports cache
+    // from the m_outputReports cache, unless their time budget is used up
+    if (mixxx::Time::elapsed() < m_nextCachedOutputReportTime) {
+        return false;
+    }
 
     // m_outputReports.size() doesn't need mutex protection, because the value of i is not used.
     // i is just a counter to prevent infinite loop execution.
@@ -246,8 +258,12 @@ bool HidIoThread::sendNextCachedOutputReport() {
         // by std::map<Key,T,Compare,Allocator>::operator[]
         // The standard says that "No iterators or references are invalidated." using this operator.
         // Therefore m_outputReportIterator doesn't require Mutex protection.
+        const auto startOfSend = mixxx::Time::elapsed();
         if (m_outputReportIterator->second->sendCachedData(
                     &m_hidDeviceAndPollMutex, m_pHidDevice, m_logOutput)) {
+            const auto endOfSend = mixxx::Time::elapsed();
+            m_nextCachedOutputReportTime = endOfSend +
+                    (endOfSend - startOfSend) * kCachedOutputReportPauseFactor;
             // Return after each time consuming sendCachedData
             return true;
         }
@@ -91,6 +91,9 @@ class HidIoThread : public QThread {
     /// No other modifications to the map are done, until destruction of this class.
     OutputReportMap m_outputReports;
     OutputReportMap::iterator m_outputReportIterator;
+    /// No report from the skipping cache is sent before this time,
+    /// only accessed by the run loop
+    mixxx::Duration m_nextCachedOutputReportTime;
 
     HidIoGlobalOutputReportFifo m_globalOutputReportFifo;
 
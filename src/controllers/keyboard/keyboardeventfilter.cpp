@@ -40,31 +40,36 @@ bool KeyboardEventFilter::eventFilter(QObject*, QEvent* e) {
             return true;
         }
 
-        QKeySequence ks = getKeySeq(ke);
-        if (!ks.isEmpty()) {
-            ConfigValueKbd ksv(ks);
+        const int keyCombination = getKeyCombination(ke);
+        if (keyCombination != 0) {
+            if (CmdlineArgs::Instance().getDeveloper()) {
+                qDebug() << "keyboard press: " << QKeySequence(keyCombination).toString();
+            }
+            auto it = m_keyCombinationToControls.find(keyCombination);
+            if (it == m_keyCombinationToControls.end()) {
+                return false;
+            }
             // Check if a shortcut is defined
             bool result = false;
-            // using const_iterator here is faster than QMultiHash::values()
-            for (auto it = m_keySequenceToControlHash.constFind(ksv);
-                 it != m_keySequenceToControlHash.constEnd() && it.key() == ksv; ++it) {
-                const ConfigKey& configKey = it.value();
-                if (configKey.group != "[KeyboardShortcuts]") {
-                    ControlObject* control = ControlObject::getControl(configKey);
-                    if (control) {
-                        //qDebug() << configKey << "MidiOpCode::NoteOn" << 1;
-                        // Add key to active key list
-                        m_qActiveKeyList.append(KeyDownInformation(
-                            keyId, ke->modifiers(), control));
-                        // Since setting the value might cause us to go down
-                        // a route that would eventually clear the active
-                        // key list, do that last.
-                        control->setValueFromMidi(MidiOpCode::NoteOn, 1);
-                        result = true;
-                    } else {
-                        qDebug() << "Warning: Keyboard key is configured for nonexistent control:"
-                                 << configKey.group << configKey.item;
-                    }
+            for (MappedControl& mappedControl : it.value()) {
+                if (!mappedControl.pControl) {
+                    mappedControl.pControl = ControlObject::getControl(
+                            mappedControl.key, ControlFlag::AllowMissingOrInvalid);
+                }
+                ControlObject* control = mappedControl.pControl;
+                if (control) {
+                    //qDebug() << mappedControl.key << "MidiOpCode::NoteOn" << 1;
+                    // Add key to active key list
+                    m_qActiveKeyList.append(KeyDownInformation(
+                        keyId, ke->modifiers(), control));
+                    // Since setting the value might cause us to go down
+                    // a route that would eventually clear the active
+                    // key list, do that last.
+                    control->setValueFromMidi(MidiOpCode::NoteOn, 1);
+                    result = true;
+                } else {
+                    qDebug() << "Warning: Keyboard key is configured for nonexistent control:"
+                             << mappedControl.key.group << mappedControl.key.item;
                 }
             }
             return result;
@@ -118,41 +123,18 @@ bool KeyboardEventFilter::eventFilter(QObject*, QEvent* e) {
     return false;
 }
 
-QKeySequence KeyboardEventFilter::getKeySeq(QKeyEvent* e) {
-    QString modseq;
-    QKeySequence k;
-
-    // TODO(XXX) check if we may simply return QKeySequence(e->modifiers()+e->key())
-
-    if (e->modifiers() & Qt::ShiftModifier) {
-        modseq += "Shift+";
-    }
-
-    if (e->modifiers() & Qt::ControlModifier) {
-        modseq += "Ctrl+";
-    }
-
-    if (e->modifiers() & Qt::AltModifier) {
-        modseq += "Alt+";
-    }
-
-    if (e->modifiers() & Qt::MetaModifier) {
-        modseq += "Meta+";
-    }
-
-    if (e->key() >= 0x01000020 && e->key() <= 0x01000023) {
+// static
+int KeyboardEventFilter::getKeyCombination(QKeyEvent* e) {
+    const int key = e->key();
+    if (key == 0 || key == Qt::Key_unknown ||
+            (key >= Qt::Key_Shift && key <= Qt::Key_Alt)) {
         // Do not act on Modifier only
         // avoid returning "khmer vowel sign ie (U+17C0)"
-        return k;
-    }
-
-    QString keyseq = QKeySequence(e->key()).toString();
-    k = QKeySequence(modseq + keyseq);
-
-    if (CmdlineArgs::Instance().getDeveloper()) {
-        qDebug() << "keyboard press: " << k.toString();
+        return 0;
     }
-    return k;
+    const int modifiers = static_cast<int>(e->modifiers() &
+            (Qt::ShiftModifier | Qt::ControlModifier | Qt::AltModifier | Qt::MetaModifier));
+    return modifiers | key;
 }
 
 void KeyboardEventFilter::setKeyboardConfig(ConfigObject<ConfigValueKbd>* pKbdConfigObject) {
@@ -160,7 +142,28 @@ void KeyboardEventFilter::setKeyboardConfig(ConfigObject<ConfigValueKbd>* pKbdCo
     // invert the mapping to create an injection from key sequence to
     // ConfigKey. This allows a key sequence to trigger multiple controls in
     // Mixxx.
-    m_keySequenceToControlHash = pKbdConfigObject->transpose();
+    m_keyCombinationToControls.clear();
+    const QMultiHash<ConfigValueKbd, ConfigKey> keySequenceToControlHash =
+            pKbdConfigObject->transpose();
+    for (auto it = keySequenceToControlHash.constBegin();
+            it != keySequenceToControlHash.constEnd();
+            ++it) {
+        if (it.value().group == QStringLiteral("[KeyboardShortcuts]")) {
+            // Menu shortcuts are handled by the QActions
+            continue;
+        }
+        const QKeySequence keySequence(it.key().value);
+        if (keySequence.isEmpty()) {
+            continue;
+        }
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+        const int keyCombination = keySequence[0].toCombined();
+#else
+        const int keyCombination = keySequence[0];
+#endif
+        m_keyCombinationToControls[keyCombination].append(
+                MappedControl{it.value(), nullptr});
+    }
     m_pKbdConfigObject = pKbdConfigObject;
 }
 
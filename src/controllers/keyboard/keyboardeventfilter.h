@@ -1,7 +1,9 @@
 #pragma once
 
-#include <QMultiHash>
+#include <QHash>
 #include <QObject>
+#include <QPointer>
+#include <QVarLengthArray>
 
 #include "control/controlobject.h"
 #include "preferences/configobject.h"
@@ -38,8 +40,18 @@ class KeyboardEventFilter : public QObject {
         ControlObject* pControl;
     };
 
-    // Returns a valid QString with modifier keys from a QKeyEvent
-    QKeySequence getKeySeq(QKeyEvent *e);
+    // A control that is mapped to a key combination. The control is looked
+    // up on the first key press, because the keyboard config is loaded
+    // before the controls are created.
+    struct MappedControl {
+        ConfigKey key;
+        QPointer<ControlObject> pControl;
+    };
+    typedef QVarLengthArray<MappedControl, 1> MappedControls;
+
+    // Returns the key with the Shift, Ctrl, Alt and Meta modifiers like the
+    // first element of a QKeySequence, or 0 for modifier-only key presses
+    static int getKeyCombination(QKeyEvent* e);
 
     // Run through list of active keys to see if the pressed key is already active
     // and is not a control that repeats when held.
@@ -56,6 +68,7 @@ class KeyboardEventFilter : public QObject {
     QList<KeyDownInformation> m_qActiveKeyList;
     // Pointer to keyboard config object
     ConfigObject<ConfigValueKbd> *m_pKbdConfigObject;
-    // Multi-hash of key sequence to
-    QMultiHash<ConfigValueKbd, ConfigKey> m_keySequenceToControlHash;
+    // The controls of each key combination, compiled from the keyboard config
+    // so that a key press costs a single lookup
+    QHash<int, MappedControls> m_keyCombinationToControls;
 };
@@ -13,9 +13,24 @@
 #include "moc_midicontroller.cpp"
 #include "util/math.h"
 
+namespace {
+
+/// Coalesces the output of high-frequency controls like VU meters and
+/// beat indicators, which would otherwise flood slow MIDI links
+constexpr int kOutputTickMillis = 5;
+
+} // namespace
+
 MidiController::MidiController(const QString& deviceName)
-        : Controller(deviceName) {
+        : Controller(deviceName),
+          m_outputTimer(this) {
     setDeviceCategory(tr("MIDI Controller"));
+    m_outputTimer.setSingleShot(true);
+    m_outputTimer.setInterval(kOutputTickMillis);
+    connect(&m_outputTimer,
+            &QTimer::timeout,
+            this,
+            &MidiController::flushPendingOutputs);
 }
 
 MidiController::~MidiController() {
@@ -34,6 +49,11 @@ QString MidiController::mappingExtension() {
 
 void MidiController::setMapping(std::shared_ptr<LegacyControllerMapping> pMapping) {
     m_pMapping = downcastAndTakeOwnership<LegacyMidiControllerMapping>(std::move(pMapping));
+    if (m_pMapping) {
+        m_inputMappingTable.compile(m_pMapping->getInputMappings());
+    } else {
+        m_inputMappingTable.clear();
+    }
 }
 
 std::shared_ptr<LegacyControllerMapping> MidiController::cloneMapping() {
@@ -162,7 +182,25 @@ void MidiController::updateAllOutputs() {
     }
 }
 
+void MidiController::scheduleOutput(MidiOutputHandler* pOutput) {
+    m_pendingOutputs.append(pOutput);
+    if (!m_outputTimer.isActive()) {
+        m_outputTimer.start();
+    }
+}
+
+void MidiController::flushPendingOutputs() {
+    // Outputs that change while sending are scheduled for the next tick
+    const QList<MidiOutputHandler*> pendingOutputs = std::move(m_pendingOutputs);
+    m_pendingOutputs.clear();
+    for (MidiOutputHandler* pOutput : pendingOutputs) {
+        pOutput->sendPendingOutput();
+    }
+}
+
 void MidiController::destroyOutputHandlers() {
+    m_outputTimer.stop();
+    m_pendingOutputs.clear();
     while (m_outputs.size() > 0) {
         delete m_outputs.takeLast();
     }
@@ -210,6 +248,7 @@ void MidiController::commitTemporaryInputMappings() {
         m_pMapping->addInputMapping(it.key(), it.value());
     }
     m_temporaryInputMappings.clear();
+    m_inputMappingTable.compile(m_pMapping->getInputMappings());
 }
 
 void MidiController::receivedShortMessage(unsigned char status,
@@ -247,19 +286,28 @@ void MidiController::receivedShortMessage(unsigned char status,
         auto it = m_temporaryInputMappings.constFind(mappingKey.key);
         if (it != m_temporaryInputMappings.constEnd()) {
             for (; it != m_temporaryInputMappings.constEnd() && it.key() == mappingKey.key; ++it) {
-                processInputMapping(it.value(), status, control, value, timestamp);
+                const MidiInputMapping& mapping = it.value();
+                ControlObject* pCO = mapping.options.testFlag(MidiOption::Script)
+                        ? nullptr
+                        : ControlObject::getControl(mapping.control);
+                processInputMapping(mapping, pCO, status, control, value, timestamp);
             }
             return;
         }
     }
 
-    auto it = m_pMapping->getInputMappings().constFind(mappingKey.key);
-    for (; it != m_pMapping->getInputMappings().constEnd() && it.key() == mappingKey.key; ++it) {
-        processInputMapping(it.value(), status, control, value, timestamp);
+    for (auto& entry : m_inputMappingTable.find(status, control)) {
+        processInputMapping(entry.mapping,
+                MidiInputMappingTable::control(&entry),
+                status,
+                control,
+                value,
+                timestamp);
     }
 }
 
 void MidiController::processInputMapping(const MidiInputMapping& mapping,
+                                         ControlObject* pCO,
                                          unsigned char status,
                                          unsigned char control,
                                          unsigned char value,
@@ -290,7 +338,6 @@ void MidiController::processInputMapping(const MidiInputMapping& mapping,
     }
 
     // Only pass values on to valid ControlObjects.
-    ControlObject* pCO = ControlObject::getControl(mapping.control);
     if (pCO == nullptr) {
         return;
     }
@@ -384,8 +431,7 @@ void MidiController::processInputMapping(const MidiInputMapping& mapping,
 
     if (mapping.options.testFlag(MidiOption::SoftTakeover)) {
         // This is the only place to enable it if it isn't already.
-        m_st.enable(pCO);
-        if (m_st.ignore(pCO, pCO->getParameterForMidi(newValue))) {
+        if (m_st.enableAndIgnore(pCO, pCO->getParameterForMidi(newValue))) {
             return;
         }
     }
@@ -516,9 +562,8 @@ void MidiController::receive(const QByteArray& data, mixxx::Duration timestamp)
         }
     }
 
-    auto it = m_pMapping->getInputMappings().constFind(mappingKey.key);
-    for (; it != m_pMapping->getInputMappings().constEnd() && it.key() == mappingKey.key; ++it) {
-        processInputMapping(it.value(), data, timestamp);
+    for (const auto& entry : m_inputMappingTable.find(mappingKey.status, mappingKey.control)) {
+        processInputMapping(entry.mapping, data, timestamp);
     }
 }
 
@@ -1,7 +1,10 @@
 #pragma once
 
+#include <QTimer>
+
 #include "controllers/controller.h"
 #include "controllers/midi/legacymidicontrollermappingfilehandler.h"
+#include "controllers/midi/midiinputmappingtable.h"
 #include "controllers/midi/midimessage.h"
 #include "controllers/softtakeover.h"
 
@@ -63,6 +66,7 @@ class MidiController : public Controller {
 
   private slots:
     bool applyMapping() override;
+    void flushPendingOutputs();
 
     void learnTemporaryInputMappings(const MidiInputMappings& mappings);
     void clearTemporaryInputMappings();
@@ -71,6 +75,7 @@ class MidiController : public Controller {
   private:
     void processInputMapping(
             const MidiInputMapping& mapping,
+            ControlObject* pCO,
             unsigned char status,
             unsigned char control,
             unsigned char value,
@@ -84,14 +89,22 @@ class MidiController : public Controller {
     void createOutputHandlers();
     void updateAllOutputs();
     void destroyOutputHandlers();
+    /// Sends the output of the handler with the next output tick
+    void scheduleOutput(MidiOutputHandler* pOutput);
 
     QHash<uint16_t, MidiInputMapping> m_temporaryInputMappings;
     QList<MidiOutputHandler*> m_outputs;
+    /// The outputs with changed values in the order of their first change
+    /// since the last output tick
+    QList<MidiOutputHandler*> m_pendingOutputs;
+    QTimer m_outputTimer;
     std::shared_ptr<LegacyMidiControllerMapping> m_pMapping;
+    /// Compiled from the input mappings of m_pMapping
+    MidiInputMappingTable m_inputMappingTable;
     SoftTakeoverCtrl m_st;
     QList<QPair<MidiInputMapping, unsigned char>> m_fourteen_bit_queued_mappings;
 
-    // So it can access sendShortMsg()
+    // So it can access sendShortMsg() and scheduleOutput()
     friend class MidiOutputHandler;
     friend class MidiControllerTest;
     friend class MidiControllerJSProxy;
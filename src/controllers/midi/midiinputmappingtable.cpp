@@ -0,0 +1,55 @@
+#include "controllers/midi/midiinputmappingtable.h"
+
+#include <utility>
+
+#include "control/control.h"
+
+MidiInputMappingTable::MidiInputMappingTable() {
+    m_blockByStatus.fill(kNoBlock);
+}
+
+void MidiInputMappingTable::clear() {
+    m_blockByStatus.fill(kNoBlock);
+    m_ranges.clear();
+    m_entries.clear();
+}
+
+void MidiInputMappingTable::compile(const QMultiHash<uint16_t, MidiInputMapping>& mappings) {
+    clear();
+
+    const QList<uint16_t> keys = mappings.uniqueKeys();
+    m_entries.reserve(mappings.size());
+    for (const uint16_t key : std::as_const(keys)) {
+        MidiKey midiKey;
+        midiKey.key = key;
+        int& block = m_blockByStatus[midiKey.status];
+        if (block == kNoBlock) {
+            block = static_cast<int>(m_ranges.size() / kControlCount);
+            m_ranges.resize(m_ranges.size() + kControlCount, Range{0, 0});
+        }
+
+        Range& range = m_ranges[block * kControlCount + midiKey.control];
+        range.begin = m_entries.size();
+        for (auto it = mappings.constFind(key); it != mappings.constEnd() && it.key() == key;
+                ++it) {
+            m_entries.push_back(Entry{it.value(), {}});
+        }
+        range.end = m_entries.size();
+    }
+}
+
+// static
+ControlObject* MidiInputMappingTable::control(Entry* pEntry) {
+    if (pEntry->mapping.options.testFlag(MidiOption::Script)) {
+        return nullptr;
+    }
+    QSharedPointer<ControlDoublePrivate> pControl = pEntry->pControl.toStrongRef();
+    if (!pControl) {
+        pControl = ControlDoublePrivate::getControl(pEntry->mapping.control);
+        if (!pControl) {
+            return nullptr;
+        }
+        pEntry->pControl = pControl;
+    }
+    return pControl->getCreatorCO();
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <QMultiHash>
+#include <QWeakPointer>
+#include <array>
+#include <vector>
+
+#include "controllers/midi/midimessage.h"
+#include "util/span.h"
+
+class ControlDoublePrivate;
+class ControlObject;
+
+/// MIDI input mapping dispatch table
+///
+/// The input mappings of a LegacyMidiControllerMapping compiled into a flat
+/// two-level table that is indexed by status byte and control number. Finding
+/// the mappings of an incoming message takes two array lookups instead of a
+/// hash lookup, and the control of a mapping is only looked up in the global
+/// control registry when it is used for the first time.
+///
+/// The table is not thread safe and must only be used from the controller
+/// thread, like the mapping it is compiled from.
+class MidiInputMappingTable {
+  public:
+    struct Entry {
+        MidiInputMapping mapping;
+        /// Resolved on first use, because controls can be created after the
+        /// mapping has been applied. The weak pointer does not keep deleted
+        /// controls alive.
+        QWeakPointer<ControlDoublePrivate> pControl;
+    };
+
+    MidiInputMappingTable();
+
+    /// Replaces the content of the table. Mappings with the same key keep the
+    /// order in which the QMultiHash iterates over them.
+    void compile(const QMultiHash<uint16_t, MidiInputMapping>& mappings);
+    void clear();
+
+    std::span<Entry> find(unsigned char status, unsigned char control) {
+        const int block = m_blockByStatus[status];
+        if (block == kNoBlock) {
+            return {};
+        }
+        const Range& range = m_ranges[block * kControlCount + control];
+        return std::span<Entry>(m_entries.data() + range.begin, range.end - range.begin);
+    }
+
+    /// Returns the ControlObject of a mapping that is not a script binding or
+    /// nullptr if the control does not exist.
+    static ControlObject* control(Entry* pEntry);
+
+  private:
+    static constexpr int kNoBlock = -1;
+    static constexpr int kControlCount = 256;
+
+    struct Range {
+        std::size_t begin;
+        std::size_t end;
+    };
+
+    /// Index of the block of kControlCount ranges for each status byte
+    std::array<int, 256> m_blockByStatus;
+    std::vector<Range> m_ranges;
+    std::vector<Entry> m_entries;
+};
@@ -12,6 +12,7 @@ MidiOutputHandler::MidiOutputHandler(MidiController* controller,
           m_mapping(mapping),
           m_cos(mapping.controlKey, this, ControlFlag::NoAssertIfMissing),
           m_lastVal(-1), // arbitrary invalid MIDI value
+          m_pending(false),
           m_logger(logger) {
     m_cos.connectValueChanged(this, &MidiOutputHandler::controlChanged);
 }
@@ -27,12 +28,27 @@ bool MidiOutputHandler::validate() {
 }
 
 void MidiOutputHandler::update() {
-    controlChanged(m_cos.get());
+    sendOutput();
 }
 
 void MidiOutputHandler::controlChanged(double value) {
+    Q_UNUSED(value);
+    // Only the latest value is sent, intermediate values are skipped
+    if (m_pending) {
+        return;
+    }
+    m_pending = true;
+    m_pController->scheduleOutput(this);
+}
+
+void MidiOutputHandler::sendPendingOutput() {
+    m_pending = false;
+    sendOutput();
+}
+
+void MidiOutputHandler::sendOutput() {
     // Don't update with out of date messages.
-    value = m_cos.get();
+    const double value = m_cos.get();
 
     unsigned char byte3 = m_mapping.output.off;
     if (value >= m_mapping.output.min && value <= m_mapping.output.max) {
@@ -9,7 +9,8 @@ class MidiController;
 /// Static MIDI output mapping handler
 ///
 /// This class listens to a control object and sends a midi message based on
-/// the  value.
+/// the  value. Changes are not sent immediately but coalesced by the
+/// controller, which sends the latest value once per output tick.
 class MidiOutputHandler : public QObject {
     Q_OBJECT
   public:
@@ -19,15 +20,21 @@ class MidiOutputHandler : public QObject {
     virtual ~MidiOutputHandler();
 
     bool validate();
+    /// Sends the current value immediately
     void update();
+    /// Sends the current value after it has been scheduled
+    void sendPendingOutput();
 
   public slots:
     void controlChanged(double value);
 
   private:
+    void sendOutput();
+
     MidiController* m_pController;
     const MidiOutputMapping m_mapping;
     ControlProxy m_cos;
     int m_lastVal;
+    bool m_pending;
     const RuntimeLoggingCategory m_logger;
 };
@@ -0,0 +1,47 @@
+#include "controllers/scripting/legacy/controljsproxy.h"
+
+#include "controllers/scripting/legacy/controllerscriptinterfacelegacy.h"
+#include "moc_controljsproxy.cpp"
+
+ControlJSProxy::ControlJSProxy(
+        ControllerScriptInterfaceLegacy* pScriptInterface,
+        ControlObjectScript* pControl)
+        : m_key(pControl->getKey()),
+          m_pScriptInterface(pScriptInterface),
+          m_pControl(pControl) {
+}
+
+double ControlJSProxy::readValue() const {
+    if (!m_pControl) {
+        return 0.0;
+    }
+    return m_pControl->get();
+}
+
+void ControlJSProxy::writeValue(double value) {
+    if (!m_pControl) {
+        return;
+    }
+    m_pScriptInterface->setControlValue(m_pControl, value);
+}
+
+double ControlJSProxy::readParameter() const {
+    if (!m_pControl) {
+        return 0.0;
+    }
+    return m_pControl->getParameter();
+}
+
+void ControlJSProxy::writeParameter(double parameter) {
+    if (!m_pControl) {
+        return;
+    }
+    m_pScriptInterface->setControlParameter(m_pControl, parameter);
+}
+
+void ControlJSProxy::reset() {
+    if (!m_pControl) {
+        return;
+    }
+    m_pControl->reset();
+}
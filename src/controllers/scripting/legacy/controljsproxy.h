@@ -0,0 +1,44 @@
+#pragma once
+
+#include <QObject>
+#include <QPointer>
+
+#include "control/controlobjectscript.h"
+
+class ControllerScriptInterfaceLegacy;
+
+/// ControlJSProxy provides scripts with a handle to a control that has
+/// been resolved once by engine.getControl(). Reading and writing its
+/// properties accesses the control directly and avoids looking it up
+/// by group and name again, e.g. for mappings that update many controls
+/// on every incoming HID report.
+class ControlJSProxy : public QObject {
+    Q_OBJECT
+    Q_PROPERTY(QString group READ readGroup CONSTANT)
+    Q_PROPERTY(QString name READ readName CONSTANT)
+    Q_PROPERTY(double value READ readValue WRITE writeValue)
+    Q_PROPERTY(double parameter READ readParameter WRITE writeParameter)
+  public:
+    ControlJSProxy(ControllerScriptInterfaceLegacy* pScriptInterface,
+            ControlObjectScript* pControl);
+
+    QString readGroup() const {
+        return m_key.group;
+    }
+    QString readName() const {
+        return m_key.item;
+    }
+
+    double readValue() const;
+    void writeValue(double value);
+    double readParameter() const;
+    void writeParameter(double parameter);
+
+    Q_INVOKABLE void reset();
+
+  private:
+    ConfigKey m_key;
+    ControllerScriptInterfaceLegacy* const m_pScriptInterface;
+    // The control is owned by the script interface
+    const QPointer<ControlObjectScript> m_pControl;
+};
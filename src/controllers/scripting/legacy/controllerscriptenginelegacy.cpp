@@ -1,5 +1,8 @@
 #include "controllers/scripting/legacy/controllerscriptenginelegacy.h"
 
+#include <QDateTime>
+#include <QHash>
+
 #include "control/controlobject.h"
 #include "controllers/controller.h"
 #include "controllers/scripting/colormapperjsproxy.h"
@@ -7,6 +10,42 @@
 #include "errordialoghandler.h"
 #include "mixer/playermanager.h"
 #include "moc_controllerscriptenginelegacy.cpp"
+#include "util/compatibility/qmutex.h"
+
+namespace {
+
+/// The code of a script file as of the given size and modification time
+struct CachedScriptFile {
+    qint64 size;
+    QDateTime lastModified;
+    QString code;
+};
+
+// The script files are shared by the engines of all controllers, e.g. the
+// common-controller-scripts.js and the component libraries, and they are
+// evaluated again on every reload. The engines may live in different threads.
+QMutex s_scriptFileCacheMutex;
+QHash<QString, CachedScriptFile> s_scriptFileCache;
+
+bool lookupCachedScriptFile(const QFileInfo& scriptFile, QString* pCode) {
+    const auto locker = lockMutex(&s_scriptFileCacheMutex);
+    const auto it = s_scriptFileCache.constFind(scriptFile.absoluteFilePath());
+    if (it == s_scriptFileCache.constEnd() ||
+            it->size != scriptFile.size() ||
+            it->lastModified != scriptFile.lastModified()) {
+        return false;
+    }
+    *pCode = it->code;
+    return true;
+}
+
+void insertCachedScriptFile(const QFileInfo& scriptFile, const QString& code) {
+    const auto locker = lockMutex(&s_scriptFileCacheMutex);
+    s_scriptFileCache.insert(scriptFile.absoluteFilePath(),
+            CachedScriptFile{scriptFile.size(), scriptFile.lastModified(), code});
+}
+
+} // anonymous namespace
 
 ControllerScriptEngineLegacy::ControllerScriptEngineLegacy(
         Controller* controller, const RuntimeLoggingCategory& logger)
@@ -220,8 +259,17 @@ bool ControllerScriptEngineLegacy::evaluateScriptFile(const QFileInfo& scriptFil
     qCDebug(m_logger) << "Loading"
                       << scriptFile.absoluteFilePath();
 
-    // Read in the script file
+    // Read in the script file unless it is unchanged since it has been read
+    // by any engine. The file info is refreshed, because the file may have
+    // been modified since the info has been created.
+    QFileInfo currentScriptFile = scriptFile;
+    currentScriptFile.refresh();
     QString filename = scriptFile.absoluteFilePath();
+    QString scriptCode;
+    if (lookupCachedScriptFile(currentScriptFile, &scriptCode)) {
+        return evaluateScriptCode(scriptCode, filename);
+    }
+
     QFile input(filename);
     if (!input.open(QIODevice::ReadOnly)) {
         qCWarning(m_logger) << QString(
@@ -253,9 +301,15 @@ bool ControllerScriptEngineLegacy::evaluateScriptFile(const QFileInfo& scriptFil
         return false;
     }
 
-    QString scriptCode = QString(input.readAll()) + QStringLiteral("\n");
+    scriptCode = QString(input.readAll()) + QStringLiteral("\n");
     input.close();
+    insertCachedScriptFile(currentScriptFile, scriptCode);
+
+    return evaluateScriptCode(scriptCode, filename);
+}
 
+bool ControllerScriptEngineLegacy::evaluateScriptCode(
+        const QString& scriptCode, const QString& filename) {
     QJSValue scriptFunction = m_pJSEngine->evaluate(scriptCode, filename);
     if (scriptFunction.isError()) {
         showScriptExceptionDialog(scriptFunction, true);
@@ -31,6 +31,7 @@ class ControllerScriptEngineLegacy : public ControllerScriptEngineBase {
 
   private:
     bool evaluateScriptFile(const QFileInfo& scriptFile);
+    bool evaluateScriptCode(const QString& scriptCode, const QString& filename);
     void shutdown() override;
 
     QJSValue wrapArrayBufferCallback(const QJSValue& callback);
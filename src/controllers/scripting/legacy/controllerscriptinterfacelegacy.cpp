@@ -2,6 +2,7 @@
 
 #include "control/controlobject.h"
 #include "control/controlobjectscript.h"
+#include "controllers/scripting/legacy/controljsproxy.h"
 #include "controllers/scripting/legacy/controllerscriptenginelegacy.h"
 #include "controllers/scripting/legacy/scriptconnectionjsproxy.h"
 #include "mixer/playermanager.h"
@@ -130,13 +131,26 @@ void ControllerScriptInterfaceLegacy::setValue(
     ControlObjectScript* coScript = getControlObjectScript(group, name);
 
     if (coScript != nullptr) {
-        ControlObject* pControl = ControlObject::getControl(
-                coScript->getKey(), ControlFlag::AllowMissingOrInvalid);
-        if (pControl &&
-                !m_st.ignore(
-                        pControl, coScript->getParameterForValue(newValue))) {
-            coScript->set(newValue);
-        }
+        setControlValue(coScript, newValue);
+    }
+}
+
+void ControllerScriptInterfaceLegacy::setControlValue(
+        ControlObjectScript* pControl, double newValue) {
+    if (util_isnan(newValue)) {
+        m_pScriptEngineLegacy->logOrThrowError(QStringLiteral(
+                "Script tried setting (%1, %2) to NotANumber (NaN)")
+                                                       .arg(pControl->getKey().group,
+                                                               pControl->getKey().item));
+        return;
+    }
+    // The proxy already refers to the control, i.e. there is no need to
+    // look it up by its key again
+    ControlObject* pControlObject = pControl->getControlObject();
+    if (pControlObject &&
+            !m_st.ignore(
+                    pControlObject, pControl->getParameterForValue(newValue))) {
+        pControl->set(newValue);
     }
 }
 
@@ -163,11 +177,22 @@ void ControllerScriptInterfaceLegacy::setParameter(
     ControlObjectScript* coScript = getControlObjectScript(group, name);
 
     if (coScript != nullptr) {
-        ControlObject* pControl = ControlObject::getControl(
-                coScript->getKey(), ControlFlag::AllowMissingOrInvalid);
-        if (pControl && !m_st.ignore(pControl, newParameter)) {
-            coScript->setParameter(newParameter);
-        }
+        setControlParameter(coScript, newParameter);
+    }
+}
+
+void ControllerScriptInterfaceLegacy::setControlParameter(
+        ControlObjectScript* pControl, double newParameter) {
+    if (util_isnan(newParameter)) {
+        m_pScriptEngineLegacy->logOrThrowError(QStringLiteral(
+                "Script tried setting (%1, %2) to NotANumber (NaN)")
+                                                       .arg(pControl->getKey().group,
+                                                               pControl->getKey().item));
+        return;
+    }
+    ControlObject* pControlObject = pControl->getControlObject();
+    if (pControlObject && !m_st.ignore(pControlObject, newParameter)) {
+        pControl->setParameter(newParameter);
     }
 }
 
@@ -199,6 +224,31 @@ void ControllerScriptInterfaceLegacy::reset(const QString& group, const QString&
     }
 }
 
+QJSValue ControllerScriptInterfaceLegacy::getControl(
+        const QString& group, const QString& name) {
+    const ConfigKey key(group, name);
+    const auto it = m_controlHandles.constFind(key);
+    if (it != m_controlHandles.constEnd()) {
+        return it.value();
+    }
+
+    auto pJsEngine = m_pScriptEngineLegacy->jsEngine();
+    VERIFY_OR_DEBUG_ASSERT(pJsEngine) {
+        return QJSValue();
+    }
+    ControlObjectScript* coScript = getControlObjectScript(group, name);
+    if (coScript == nullptr) {
+        m_pScriptEngineLegacy->logOrThrowError(
+                QStringLiteral("Unknown control (%1, %2)")
+                        .arg(group, name));
+        return QJSValue();
+    }
+    const QJSValue handle = pJsEngine->newQObject(
+            new ControlJSProxy(this, coScript));
+    m_controlHandles.insert(key, handle);
+    return handle;
+}
+
 double ControllerScriptInterfaceLegacy::getDefaultValue(const QString& group, const QString& name) {
     ControlObjectScript* coScript = getControlObjectScript(group, name);
 
@@ -29,6 +29,10 @@ class ControllerScriptInterfaceLegacy : public QObject {
     Q_INVOKABLE double getParameterForValue(
             const QString& group, const QString& name, double value);
     Q_INVOKABLE void reset(const QString& group, const QString& name);
+    /// Returns a handle for accessing the value and parameter of a control
+    /// repeatedly without looking it up by group and name each time. The
+    /// same handle is returned for each control.
+    Q_INVOKABLE QJSValue getControl(const QString& group, const QString& name);
     Q_INVOKABLE double getDefaultValue(const QString& group, const QString& name);
     Q_INVOKABLE double getDefaultParameter(const QString& group, const QString& name);
     Q_INVOKABLE QJSValue makeConnection(const QString& group,
@@ -69,6 +73,11 @@ class ControllerScriptInterfaceLegacy : public QObject {
             const double rate = -10.0);
     Q_INVOKABLE void softStart(const int deck, bool activate, double factor = 1.0);
 
+    /// Set the value or parameter of a control with soft takeover,
+    /// e.g. through a handle returned by getControl()
+    void setControlValue(ControlObjectScript* pControl, double newValue);
+    void setControlParameter(ControlObjectScript* pControl, double newParameter);
+
     bool removeScriptConnection(const ScriptConnection& conn);
     /// Execute a ScriptConnection's JS callback
     void triggerScriptConnection(const ScriptConnection& conn);
@@ -83,6 +92,7 @@ class ControllerScriptInterfaceLegacy : public QObject {
             bool skipSuperseded = false);
     QHash<ConfigKey, ControlObjectScript*> m_controlCache;
     ControlObjectScript* getControlObjectScript(const QString& group, const QString& name);
+    QHash<ConfigKey, QJSValue> m_controlHandles;
 
     SoftTakeoverCtrl m_st;
 
@@ -16,14 +16,12 @@ SoftTakeoverCtrl::SoftTakeoverCtrl() {
 }
 
 SoftTakeoverCtrl::~SoftTakeoverCtrl() {
-    QHashIterator<ControlObject*, SoftTakeover*> i(m_softTakeoverHash);
-    while (i.hasNext()) {
-        i.next();
-        delete i.value();
-    }
 }
 
 void SoftTakeoverCtrl::enable(ControlObject* control) {
+    if (m_softTakeoverHash.contains(control)) {
+        return;
+    }
     ControlPotmeter* cpo = qobject_cast<ControlPotmeter*>(control);
     if (cpo == nullptr) {
         // softtakecover works only for continuous ControlPotmeter based COs
@@ -31,31 +29,40 @@ void SoftTakeoverCtrl::enable(ControlObject* control) {
     }
 
     // Initialize times
-    if (!m_softTakeoverHash.contains(control)) {
-        m_softTakeoverHash.insert(control, new SoftTakeover());
-    }
+    m_softTakeoverHash.insert(control, SoftTakeover());
 }
 
 void SoftTakeoverCtrl::disable(ControlObject* control) {
     if (control == nullptr) {
         return;
     }
-    SoftTakeover* pSt = m_softTakeoverHash.take(control);
-    if (pSt) {
-        delete pSt;
-    }
+    m_softTakeoverHash.remove(control);
 }
 
 bool SoftTakeoverCtrl::ignore(ControlObject* control, double newParameter) {
     if (control == nullptr) {
         return false;
     }
-    bool ignore = false;
-    SoftTakeover* pSt = m_softTakeoverHash.value(control);
-    if (pSt) {
-        ignore = pSt->ignore(control, newParameter);
+    auto it = m_softTakeoverHash.find(control);
+    if (it == m_softTakeoverHash.end()) {
+        return false;
     }
-    return ignore;
+    return it->ignore(control, newParameter);
+}
+
+bool SoftTakeoverCtrl::enableAndIgnore(ControlObject* control, double newParameter) {
+    if (control == nullptr) {
+        return false;
+    }
+    auto it = m_softTakeoverHash.find(control);
+    if (it == m_softTakeoverHash.end()) {
+        if (qobject_cast<ControlPotmeter*>(control) == nullptr) {
+            // softtakecover works only for continuous ControlPotmeter based COs
+            return false;
+        }
+        it = m_softTakeoverHash.insert(control, SoftTakeover());
+    }
+    return it->ignore(control, newParameter);
 }
 
 void SoftTakeoverCtrl::ignoreNext(ControlObject* control) {
@@ -63,12 +70,12 @@ void SoftTakeoverCtrl::ignoreNext(ControlObject* control) {
         return;
     }
 
-    SoftTakeover* pSt = m_softTakeoverHash.value(control);
-    if (pSt == nullptr) {
+    auto it = m_softTakeoverHash.find(control);
+    if (it == m_softTakeoverHash.end()) {
         return;
     }
 
-    pSt->ignoreNext();
+    it->ignoreNext();
 }
 
 SoftTakeover::SoftTakeover()
@@ -48,9 +48,14 @@ class SoftTakeoverCtrl {
     void disable(ControlObject* control);
     // Check to see if the new value for the Control should be ignored
     bool ignore(ControlObject* control, double newMidiParameter);
+    // Same as enable() followed by ignore() with a single lookup of the
+    // Control, for mappings that receive every value with soft-takeover
+    bool enableAndIgnore(ControlObject* control, double newParameter);
     // Ignore the next supplied parameter
     void ignoreNext(ControlObject* control);
 
   private:
-    QHash<ControlObject*, SoftTakeover*> m_softTakeoverHash;
+    // The state is stored by value, so that looking up a Control doesn't
+    // need to follow another pointer for every received value
+    QHash<ControlObject*, SoftTakeover> m_softTakeoverHash;
 };
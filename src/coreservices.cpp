@@ -12,8 +12,10 @@
 #include "controllers/controllermanager.h"
 #include "controllers/keyboard/keyboardeventfilter.h"
 #include "database/mixxxdb.h"
+#include "database/walcheckpointscheduler.h"
 #include "effects/effectsmanager.h"
 #include "engine/enginemixer.h"
+#include "engine/sidechain/enginesidechain.h"
 #include "library/coverartcache.h"
 #include "library/library.h"
 #include "library/library_prefs.h"
@@ -22,17 +24,26 @@
 #include "mixer/playerinfo.h"
 #include "mixer/playermanager.h"
 #include "moc_coreservices.cpp"
+#include "network/metricsserver.h"
 #include "preferences/settingsmanager.h"
 #ifdef __MODPLUG__
 #include "preferences/dialog/dlgprefmodplug.h"
 #endif
 #include "skin/skincontrols.h"
+#ifdef __OPUS__
+#include "soundio/networkmonitormanager.h"
+#endif
 #include "soundio/soundmanager.h"
+#include "sources/seekindexcache.h"
 #include "sources/soundsourceproxy.h"
+#include "util/cpuaffinity.h"
 #include "util/db/dbconnectionpooled.h"
 #include "util/font.h"
+#include "util/lockedmemory.h"
 #include "util/logger.h"
+#include "util/powerprofile.h"
 #include "util/screensavermanager.h"
+#include "util/startupprofiler.h"
 #include "util/statsmanager.h"
 #include "util/time.h"
 #include "util/translations.h"
@@ -96,6 +107,15 @@ Bool __xErrorHandler(Display* display, XErrorEvent* event, xError* error) {
 
 #endif
 
+bool isAnyDeckPlaying() {
+    for (unsigned int i = 0; i < PlayerManager::numDecks(); ++i) {
+        if (ControlObject::toBool(ConfigKey(PlayerManager::groupForDeck(i), "play"))) {
+            return true;
+        }
+    }
+    return false;
+}
+
 inline QLocale inputLocale() {
     // Use the default config for local keyboard
     QInputMethod* pInputMethod = QGuiApplication::inputMethod();
@@ -117,8 +137,8 @@ CoreServices::CoreServices(const CmdlineArgs& args, QApplication* pApp)
     // called after the GUI is initialized
     initializeSettings();
     initializeLogging();
-    // Only record stats in developer mode.
-    if (m_cmdlineArgs.getDeveloper()) {
+    // Only record stats in developer mode or when profiling the startup.
+    if (m_cmdlineArgs.getDeveloper() || m_cmdlineArgs.getStartupProfile()) {
         StatsManager::createInstance();
     }
     mixxx::Translations::initializeTranslations(
@@ -136,7 +156,7 @@ CoreServices::~CoreServices() {
     CLEAR_AND_CHECK_DELETED(m_pKbdConfig);
     CLEAR_AND_CHECK_DELETED(m_pKbdConfigEmpty);
 
-    if (m_cmdlineArgs.getDeveloper()) {
+    if (m_cmdlineArgs.getDeveloper() || m_cmdlineArgs.getStartupProfile()) {
         StatsManager::destroy();
     }
 
@@ -212,6 +232,10 @@ void CoreServices::initialize(QApplication* pApp) {
     }
 
     ScopedTimer t("CoreServices::initialize");
+    StartupProfiler::beginPhase(QStringLiteral("sound sources"));
+
+    // Runs in the background until the SoundManager is created below
+    SoundManager::startProbingDevices();
 
     VERIFY_OR_DEBUG_ASSERT(SoundSourceProxy::registerProviders()) {
         qCritical() << "Failed to register any SoundSource providers";
@@ -234,13 +258,23 @@ void CoreServices::initialize(QApplication* pApp) {
     UserSettingsPointer pConfig = m_pSettingsManager->settings();
 
     Sandbox::setPermissionsFilePath(QDir(pConfig->getSettingsPath()).filePath("sandbox.cfg"));
+    mixxx::SeekIndexCache::setDirectory(
+            QDir(pConfig->getSettingsPath()).filePath("seekindex"));
+    // Before the engine and the background threads are started
+    mixxx::CpuAffinity::configure(pConfig->getValueString(
+            ConfigKey(QStringLiteral("[App]"), QStringLiteral("engine_cpu_cores"))));
+    mixxx::LockedMemory::setEnabled(pConfig->getValue(
+            ConfigKey(QStringLiteral("[App]"), QStringLiteral("lock_engine_memory")),
+            false));
 
     QString resourcePath = pConfig->getResourcePath();
 
+    StartupProfiler::beginPhase(QStringLiteral("fonts"));
     emit initializationProgressUpdate(0, tr("fonts"));
 
     FontUtils::initializeFonts(resourcePath); // takes a long time
 
+    StartupProfiler::beginPhase(QStringLiteral("database"));
     emit initializationProgressUpdate(10, tr("database"));
     m_pDbConnectionPool = MixxxDb(pConfig).connectionPool();
     if (!m_pDbConnectionPool) {
@@ -256,6 +290,7 @@ void CoreServices::initialize(QApplication* pApp) {
 
     auto pChannelHandleFactory = std::make_shared<ChannelHandleFactory>();
 
+    StartupProfiler::beginPhase(QStringLiteral("effects"));
     emit initializationProgressUpdate(20, tr("effects"));
     m_pEffectsManager = std::make_shared<EffectsManager>(pConfig, pChannelHandleFactory);
 
@@ -266,6 +301,7 @@ void CoreServices::initialize(QApplication* pApp) {
             pChannelHandleFactory,
             true);
 
+    StartupProfiler::beginPhase(QStringLiteral("audio interface"));
     emit initializationProgressUpdate(30, tr("audio interface"));
     // Although m_pSoundManager is created here, m_pSoundManager->setupDevices()
     // needs to be called after m_pPlayerManager registers sound IO for each EngineChannel.
@@ -280,12 +316,18 @@ void CoreServices::initialize(QApplication* pApp) {
             m_pSoundManager.get());
 #endif
 
+#ifdef __OPUS__
+    m_pNetworkMonitorManager = std::make_shared<NetworkMonitorManager>(
+            pConfig, m_pSoundManager.get());
+#endif
+
 #ifdef __VINYLCONTROL__
     m_pVCManager = std::make_shared<VinylControlManager>(this, pConfig, m_pSoundManager.get());
 #else
     m_pVCManager = nullptr;
 #endif
 
+    StartupProfiler::beginPhase(QStringLiteral("decks"));
     emit initializationProgressUpdate(40, tr("decks"));
     // Create the player manager. (long)
     m_pPlayerManager = std::make_shared<PlayerManager>(
@@ -312,6 +354,7 @@ void CoreServices::initialize(QApplication* pApp) {
 
     m_pPlayerManager->addPreviewDeck();
 
+    StartupProfiler::beginPhase(QStringLiteral("effect chains"));
     m_pEffectsManager->setup();
 
 #ifdef __VINYLCONTROL__
@@ -332,13 +375,23 @@ void CoreServices::initialize(QApplication* pApp) {
             m_pScreensaverManager.get(),
             &ScreensaverManager::slotCurrentPlayingDeckChanged);
 
+    // Scale down the background load while running on battery, must be
+    // created before the components that listen to it
+    m_pPowerProfile = std::make_unique<PowerProfile>(pConfig);
+
+    StartupProfiler::beginPhase(QStringLiteral("library"));
     emit initializationProgressUpdate(50, tr("library"));
-    CoverArtCache::createInstance();
+    CoverArtCache::createInstance()->setThumbnailCache(
+            CoverArtThumbnailCache::fromConfig(pConfig));
 
     m_pTrackCollectionManager = std::make_shared<TrackCollectionManager>(
             this,
             pConfig,
             m_pDbConnectionPool);
+    // Write file tags on a worker thread instead of while saving tracks
+    m_pTrackCollectionManager->enableMetadataWriteBack(
+            QDir(pConfig->getSettingsPath()).filePath("metadatawriteback.journal"),
+            isAnyDeckPlaying);
 
     m_pLibrary = std::make_shared<Library>(
             this,
@@ -354,6 +407,13 @@ void CoreServices::initialize(QApplication* pApp) {
     // the uninitialized singleton instance!
     m_pPlayerManager->bindToLibrary(m_pLibrary.get());
 
+    if (MixxxDb::storageProfile(pConfig) == MixxxDb::StorageProfile::Concurrent) {
+        // Avoid disk I/O for checkpoints during a performance
+        m_pWalCheckpointScheduler = std::make_unique<WalCheckpointScheduler>(
+                m_pDbConnectionPool,
+                isAnyDeckPlaying);
+    }
+
     bool hasChanged_MusicDir = false;
 
     if (m_pTrackCollectionManager->internalCollection()->loadRootDirs().isEmpty()) {
@@ -375,6 +435,7 @@ void CoreServices::initialize(QApplication* pApp) {
         }
     }
 
+    StartupProfiler::beginPhase(QStringLiteral("controllers"));
     emit initializationProgressUpdate(60, tr("controllers"));
     // Initialize controller sub-system,
     // but do not set up controllers until the end of the application startup
@@ -426,6 +487,7 @@ void CoreServices::initialize(QApplication* pApp) {
         m_pTrackCollectionManager->startLibraryScan();
     }
 
+    StartupProfiler::beginPhase(QStringLiteral("samplers"));
     // This has to be done before m_pSoundManager->setupDevices()
     // https://github.com/mixxxdj/mixxx/issues/9188
     m_pPlayerManager->loadSamplers();
@@ -436,6 +498,9 @@ void CoreServices::initialize(QApplication* pApp) {
     // them on startup.
     m_pSkinControls = std::make_unique<SkinControls>();
 
+    // All decks and samplers have allocated their caches
+    mixxx::LockedMemory::logStatistics();
+
     // Load tracks in args.qlMusicFiles (command line arguments) into player
     // 1 and 2:
     const QList<QString>& musicFiles = m_cmdlineArgs.getMusicFiles();
@@ -444,6 +509,13 @@ void CoreServices::initialize(QApplication* pApp) {
             m_pPlayerManager->slotLoadToDeck(musicFiles.at(i), i + 1);
         }
     }
+    // Resume the decks after a crash, unless the tracks to load have been
+    // passed on the command line
+    m_pPlayerManager->startDeckSnapshots(musicFiles.isEmpty());
+
+    if (network::MetricsServer::isEnabled(pConfig)) {
+        initializeMetrics();
+    }
 
     m_isInitialized = true;
 }
@@ -529,6 +601,131 @@ bool CoreServices::initializeDatabase() {
     return MixxxDb::initDatabaseSchema(dbConnection);
 }
 
+void CoreServices::initializeMetrics() {
+    using network::MetricsServer;
+    m_pMetricsServer = std::make_unique<MetricsServer>();
+
+    SoundManager* pSoundManager = m_pSoundManager.get();
+    m_pMetricsServer->addMetric(QStringLiteral("mixxx_audio_callback_seconds"),
+            MetricsServer::Type::Gauge,
+            QStringLiteral("Quantiles of the time spent in the audio callback"),
+            [pSoundManager]() {
+                QVector<MetricsServer::Sample> samples;
+                const auto& timings = pSoundManager->getCallbackTimings();
+                for (const auto& timing : timings) {
+                    const QString device =
+                            MetricsServer::label(QStringLiteral("device"), timing.displayName);
+                    for (const double quantile : {0.5, 0.9, 0.99}) {
+                        samples.append(MetricsServer::Sample{
+                                device + QChar(',') +
+                                        MetricsServer::label(QStringLiteral("quantile"),
+                                                QString::number(quantile)),
+                                timing.stats.processing().quantile(quantile) *
+                                        timing.stats.bufferSeconds()});
+                    }
+                }
+                return samples;
+            });
+    m_pMetricsServer->addControlMetric(QStringLiteral("mixxx_audio_latency_usage_ratio"),
+            MetricsServer::Type::Gauge,
+            QStringLiteral("Share of the audio buffer time spent in the callback"),
+            ConfigKey(QStringLiteral("[App]"), QStringLiteral("audio_latency_usage")));
+    m_pMetricsServer->addControlMetric(QStringLiteral("mixxx_audio_xruns"),
+            MetricsServer::Type::Counter,
+            QStringLiteral("Audio buffer underflows and overflows"),
+            ConfigKey(QStringLiteral("[App]"), QStringLiteral("audio_latency_overload_count")));
+
+    // The controls of decks that are added later are picked up when scraped
+    QStringList readerGroups;
+    for (int i = 0; i < 4; ++i) {
+        readerGroups.append(PlayerManager::groupForDeck(i));
+    }
+    readerGroups.append(PlayerManager::groupForPreviewDeck(0));
+    const auto readerCacheSampler = [readerGroups](const QString& item) {
+        return [readerGroups, item]() {
+            QVector<MetricsServer::Sample> samples;
+            for (const auto& group : readerGroups) {
+                const auto value = MetricsServer::controlValue(ConfigKey(group, item));
+                if (value) {
+                    samples.append(MetricsServer::Sample{
+                            MetricsServer::label(QStringLiteral("group"), group),
+                            *value});
+                }
+            }
+            return samples;
+        };
+    };
+    m_pMetricsServer->addMetric(QStringLiteral("mixxx_reader_cache_hits"),
+            MetricsServer::Type::Counter,
+            QStringLiteral("Chunks read from the cache of the deck"),
+            readerCacheSampler(QStringLiteral("cache_hit_count")));
+    m_pMetricsServer->addMetric(QStringLiteral("mixxx_reader_cache_misses"),
+            MetricsServer::Type::Counter,
+            QStringLiteral("Chunks that were not cached when the engine needed them"),
+            readerCacheSampler(QStringLiteral("cache_miss_count")));
+    m_pMetricsServer->addMetric(QStringLiteral("mixxx_reader_cache_evictions"),
+            MetricsServer::Type::Counter,
+            QStringLiteral("Chunks evicted from the cache of the deck"),
+            readerCacheSampler(QStringLiteral("cache_eviction_count")));
+
+    Library* pLibrary = m_pLibrary.get();
+    m_pMetricsServer->addMetric(QStringLiteral("mixxx_analysis_queue_tracks"),
+            MetricsServer::Type::Gauge,
+            QStringLiteral("Tracks waiting for the batch analysis"),
+            [pLibrary]() {
+                return QVector<MetricsServer::Sample>{
+                        {QString(), static_cast<double>(pLibrary->analysisQueueSize())}};
+            });
+
+    EngineSideChain* pSideChain = m_pEngine->getSideChain();
+    if (pSideChain) {
+        m_pMetricsServer->addMetric(QStringLiteral("mixxx_sidechain_fifo_fill_ratio"),
+                MetricsServer::Type::Gauge,
+                QStringLiteral("Fill level of the fullest recording and broadcasting FIFO"),
+                [pSideChain]() {
+                    return QVector<MetricsServer::Sample>{
+                            {QString(), pSideChain->fifoFillRatio()}};
+                });
+    }
+
+#ifdef __BROADCAST__
+    BroadcastSettingsPointer pBroadcastSettings = m_pSettingsManager->broadcastSettings();
+    m_pMetricsServer->addMetric(QStringLiteral("mixxx_broadcast_connection_status"),
+            MetricsServer::Type::Gauge,
+            QStringLiteral("Status of the enabled broadcast connections: 0 unconnected, "
+                           "1 connecting, 2 connected, 3 failure"),
+            [pBroadcastSettings]() {
+                QVector<MetricsServer::Sample> samples;
+                const auto profiles = pBroadcastSettings->profiles();
+                for (const auto& pProfile : profiles) {
+                    if (!pProfile->getEnabled()) {
+                        continue;
+                    }
+                    samples.append(MetricsServer::Sample{
+                            MetricsServer::label(QStringLiteral("connection"),
+                                    pProfile->getProfileName()),
+                            static_cast<double>(pProfile->connectionStatus())});
+                }
+                return samples;
+            });
+#endif
+
+    m_pMetricsServer->addControlMetric(QStringLiteral("mixxx_gui_frame_rate"),
+            MetricsServer::Type::Gauge,
+            QStringLiteral("Frames per second drawn by the waveforms"),
+            ConfigKey(QStringLiteral("[App]"), QStringLiteral("waveform_frame_rate")));
+    m_pMetricsServer->addControlMetric(QStringLiteral("mixxx_gui_dropped_frames"),
+            MetricsServer::Type::Counter,
+            QStringLiteral("Frames that missed the vertical sync"),
+            ConfigKey(QStringLiteral("[App]"), QStringLiteral("waveform_dropped_frames")));
+    m_pMetricsServer->addControlMetric(QStringLiteral("mixxx_gui_render_load_ratio"),
+            MetricsServer::Type::Gauge,
+            QStringLiteral("Share of the time spent drawing the waveforms"),
+            ConfigKey(QStringLiteral("[App]"), QStringLiteral("waveform_render_load")));
+
+    m_pMetricsServer->listen(m_pSettingsManager->settings());
+}
+
 void CoreServices::finalize() {
     VERIFY_OR_DEBUG_ASSERT(m_isInitialized) {
         qDebug() << "Skipping CoreServices finalization because it was never initialized.";
@@ -538,6 +735,10 @@ void CoreServices::finalize() {
     Timer t("CoreServices::~CoreServices");
     t.start();
 
+    // The metrics are sampled from all other services
+    m_pMetricsServer.reset();
+    m_pWalCheckpointScheduler.reset();
+
     // Stop all pending library operations
     qDebug() << t.elapsed(false).debugMillisWithUnit() << "stopping pending Library tasks";
     m_pTrackCollectionManager->stopLibraryScan();
@@ -586,6 +787,12 @@ void CoreServices::finalize() {
     CLEAR_AND_CHECK_DELETED(m_pBroadcastManager);
 #endif
 
+#ifdef __OPUS__
+    // NetworkMonitorManager depends on config, engine
+    qDebug() << t.elapsed(false).debugMillisWithUnit() << "deleting NetworkMonitorManager";
+    CLEAR_AND_CHECK_DELETED(m_pNetworkMonitorManager);
+#endif
+
     // EngineMixer depends on Config and m_pEffectsManager.
     qDebug() << t.elapsed(false).debugMillisWithUnit() << "deleting EngineMixer";
     CLEAR_AND_CHECK_DELETED(m_pEngine);
@@ -614,6 +821,8 @@ void CoreServices::finalize() {
 
     m_pSkinControls.reset();
 
+    m_pPowerProfile.reset();
+
     m_pControlIndicatorTimer.reset();
 
     t.elapsed(true);
@@ -16,19 +16,28 @@ class RecordingManager;
 #ifdef __BROADCAST__
 class BroadcastManager;
 #endif
+#ifdef __OPUS__
+class NetworkMonitorManager;
+#endif
 class ControllerManager;
 class VinylControlManager;
 class TrackCollectionManager;
 class Library;
 class SkinControls;
 class ControlPushButton;
+class WalCheckpointScheduler;
 
 namespace mixxx {
 
 class ControlIndicatorTimer;
 class DbConnectionPool;
+class PowerProfile;
 class ScreensaverManager;
 
+namespace network {
+class MetricsServer;
+} // namespace network
+
 class CoreServices : public QObject {
     Q_OBJECT
 
@@ -113,6 +122,7 @@ class CoreServices : public QObject {
     void initializeSettings();
     void initializeScreensaverManager();
     void initializeLogging();
+    void initializeMetrics();
 
     /// Tear down CoreServices that were previously initialized by `initialize()`.
     void finalize();
@@ -126,6 +136,9 @@ class CoreServices : public QObject {
     std::shared_ptr<RecordingManager> m_pRecordingManager;
 #ifdef __BROADCAST__
     std::shared_ptr<BroadcastManager> m_pBroadcastManager;
+#endif
+#ifdef __OPUS__
+    std::shared_ptr<NetworkMonitorManager> m_pNetworkMonitorManager;
 #endif
     std::shared_ptr<ControllerManager> m_pControllerManager;
 
@@ -134,12 +147,15 @@ class CoreServices : public QObject {
     std::shared_ptr<DbConnectionPool> m_pDbConnectionPool;
     std::shared_ptr<TrackCollectionManager> m_pTrackCollectionManager;
     std::shared_ptr<Library> m_pLibrary;
+    std::unique_ptr<WalCheckpointScheduler> m_pWalCheckpointScheduler;
 
     std::shared_ptr<KeyboardEventFilter> m_pKeyboardEventFilter;
     std::shared_ptr<ConfigObject<ConfigValueKbd>> m_pKbdConfig;
     std::shared_ptr<ConfigObject<ConfigValueKbd>> m_pKbdConfigEmpty;
 
     std::shared_ptr<mixxx::ScreensaverManager> m_pScreensaverManager;
+    std::unique_ptr<mixxx::PowerProfile> m_pPowerProfile;
+    std::unique_ptr<network::MetricsServer> m_pMetricsServer;
 
     std::unique_ptr<SkinControls> m_pSkinControls;
     std::unique_ptr<ControlPushButton> m_pTouchShift;
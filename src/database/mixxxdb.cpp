@@ -3,6 +3,7 @@
 #include <QDir>
 
 #include "database/schemamanager.h"
+#include "library/library_prefs.h"
 #include "moc_mixxxdb.cpp"
 #include "util/assert.h"
 #include "util/logger.h"
@@ -12,7 +13,7 @@
 const QString MixxxDb::kDefaultSchemaFile(":/schema.xml");
 
 //static
-const int MixxxDb::kRequiredSchemaVersion = 39;
+const int MixxxDb::kRequiredSchemaVersion = 44;
 
 namespace {
 
@@ -30,6 +31,27 @@ const QString kUserName = QStringLiteral("mixxx");
 
 const QString kPassword = QStringLiteral("mixxx");
 
+// The journal mode is stored in the database file and must be reset
+// explicitly when switching back from the write-ahead log
+const QStringList kCompatiblePragmas = {
+        QStringLiteral("journal_mode=DELETE"),
+};
+
+const QStringList kConcurrentPragmas = {
+        QStringLiteral("journal_mode=WAL"),
+        // Only the last transactions might be lost on power failure,
+        // but the database can't get corrupted in WAL mode
+        QStringLiteral("synchronous=NORMAL"),
+        // 256 MiB
+        QStringLiteral("mmap_size=268435456"),
+        // 32 MiB (negative values are in KiB)
+        QStringLiteral("cache_size=-32768"),
+        // Checkpoints are usually done by WalCheckpointScheduler. SQLite
+        // only checkpoints automatically when the log has grown beyond
+        // this number of pages (~40 MiB) in the meantime.
+        QStringLiteral("wal_autocheckpoint=10000"),
+};
+
 // The connection parameters for the main Mixxx DB
 mixxx::DbConnection::Params dbConnectionParams(
         const UserSettingsPointer& pConfig,
@@ -58,6 +80,16 @@ mixxx::DbConnection::Params dbConnectionParams(
     }
     params.userName = kUserName;
     params.password = kPassword;
+    if (!inMemoryConnection) {
+        switch (MixxxDb::storageProfile(pConfig)) {
+        case MixxxDb::StorageProfile::Compatible:
+            params.pragmas = kCompatiblePragmas;
+            break;
+        case MixxxDb::StorageProfile::Concurrent:
+            params.pragmas = kConcurrentPragmas;
+            break;
+        }
+    }
     return params;
 }
 
@@ -69,6 +101,23 @@ MixxxDb::MixxxDb(
     : m_pDbConnectionPool(std::make_shared<mixxx::DbConnectionPool>(dbConnectionParams(pConfig, inMemoryConnection), "MIXXX")) {
 }
 
+//static
+MixxxDb::StorageProfile MixxxDb::storageProfile(const UserSettingsPointer& pConfig) {
+    const int value = pConfig->getValue(
+            mixxx::library::prefs::kDatabaseStorageProfileConfigKey,
+            static_cast<int>(kStorageProfileDefault));
+    switch (value) {
+    case static_cast<int>(StorageProfile::Compatible):
+        return StorageProfile::Compatible;
+    case static_cast<int>(StorageProfile::Concurrent):
+        return StorageProfile::Concurrent;
+    }
+    kLogger.warning()
+            << "Invalid database storage profile"
+            << value;
+    return kStorageProfileDefault;
+}
+
 bool MixxxDb::initDatabaseSchema(
         const QSqlDatabase& database,
         int schemaVersion,
@@ -13,6 +13,20 @@ class MixxxDb : public QObject {
 
     static const int kRequiredSchemaVersion;
 
+    /// Tuning of the SQLite database that is applied to all connections
+    enum class StorageProfile {
+        /// The SQLite defaults with a rollback journal
+        Compatible = 0,
+        /// A write-ahead log (WAL) that allows reading while another
+        /// connection is writing, e.g. browsing the library during a
+        /// library scan. Requires a local file system.
+        Concurrent = 1,
+    };
+    static constexpr StorageProfile kStorageProfileDefault = StorageProfile::Compatible;
+
+    /// Changes only take effect after restarting
+    static StorageProfile storageProfile(const UserSettingsPointer& pConfig);
+
     static bool initDatabaseSchema(
             const QSqlDatabase& database,
             int schemaVersion = kRequiredSchemaVersion,
@@ -22,6 +22,32 @@ const QString SETTINGS_VERSION_KEY = QStringLiteral("mixxx.schema.version");
 const QString SETTINGS_LASTUSED_VERSION_KEY = QStringLiteral("mixxx.schema.last_used_version");
 const QString SETTINGS_MINCOMPATIBLE_KEY = QStringLiteral("mixxx.schema.min_compatible_version");
 
+// Splits the SQL of a schema migration into statements. The semicolons
+// within the body of a trigger don't terminate the statement.
+QStringList splitSqlStatements(const QString& sql) {
+    QStringList statements;
+    QString statement;
+    const QStringList fragments = sql.split(QChar(';'));
+    for (const auto& fragment : fragments) {
+        if (statement.isEmpty()) {
+            statement = fragment.trimmed();
+        } else {
+            statement += QChar(';') + fragment;
+        }
+        if (statement.startsWith(QStringLiteral("CREATE TRIGGER"), Qt::CaseInsensitive) &&
+                !fragment.trimmed().endsWith(QStringLiteral("END"), Qt::CaseInsensitive)) {
+            continue;
+        }
+        statements.append(statement.trimmed());
+        statement.clear();
+    }
+    if (!statement.isEmpty()) {
+        // Unterminated trigger body
+        statements.append(statement.trimmed());
+    }
+    return statements;
+}
+
 std::optional<int> readSchemaVersion(
         const SettingsDAO& settings,
         const QString& key) {
@@ -223,8 +249,8 @@ SchemaManager::Result SchemaManager::upgradeToSchemaVersion(
         SqlTransaction transaction(m_settingsDao.database());
 
         // TODO(XXX) We can't have semicolons in schema.xml for anything other
-        // than statement separators.
-        QStringList sqlStatements = sql.split(";");
+        // than statement separators or within the body of a trigger.
+        const QStringList sqlStatements = splitSqlStatements(sql);
 
         QStringListIterator it(sqlStatements);
 
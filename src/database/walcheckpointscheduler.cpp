@@ -0,0 +1,78 @@
+#include "database/walcheckpointscheduler.h"
+
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QtConcurrent>
+
+#include "moc_walcheckpointscheduler.cpp"
+#include "util/assert.h"
+#include "util/db/dbconnectionpooled.h"
+#include "util/db/dbconnectionpooler.h"
+#include "util/logger.h"
+
+namespace {
+
+const mixxx::Logger kLogger("WalCheckpointScheduler");
+
+constexpr int kCheckpointIntervalMillis = 60 * 1000;
+
+void checkpoint(const mixxx::DbConnectionPoolPtr& pDbConnectionPool) {
+    const mixxx::DbConnectionPooler dbConnectionPooler(pDbConnectionPool);
+    const QSqlDatabase database = mixxx::DbConnectionPooled(pDbConnectionPool);
+    QSqlQuery query(database);
+    // A passive checkpoint neither waits for readers nor for writers
+    // and leaves the remaining frames for the next checkpoint
+    if (!query.exec(QStringLiteral("PRAGMA wal_checkpoint(PASSIVE)"))) {
+        kLogger.warning()
+                << "Failed to checkpoint the write-ahead log"
+                << query.lastError();
+        return;
+    }
+    if (kLogger.debugEnabled() && query.next()) {
+        kLogger.debug()
+                << "Checkpointed"
+                << query.value(2).toInt()
+                << "of"
+                << query.value(1).toInt()
+                << "frames";
+    }
+}
+
+} // anonymous namespace
+
+WalCheckpointScheduler::WalCheckpointScheduler(
+        mixxx::DbConnectionPoolPtr pDbConnectionPool,
+        std::function<bool()> isBusy,
+        QObject* parent)
+        : QObject(parent),
+          m_pDbConnectionPool(std::move(pDbConnectionPool)),
+          m_isBusy(std::move(isBusy)) {
+    DEBUG_ASSERT(m_pDbConnectionPool);
+    connect(&m_timer,
+            &QTimer::timeout,
+            this,
+            &WalCheckpointScheduler::slotCheckpoint);
+    m_timer.start(kCheckpointIntervalMillis);
+}
+
+WalCheckpointScheduler::~WalCheckpointScheduler() {
+    m_timer.stop();
+    // The pending checkpoint might still access the connection pool
+    m_checkpoint.waitForFinished();
+}
+
+void WalCheckpointScheduler::slotCheckpoint() {
+    if (m_checkpoint.isRunning()) {
+        return;
+    }
+    if (m_isBusy && m_isBusy()) {
+        if (kLogger.debugEnabled()) {
+            kLogger.debug() << "Deferring checkpoint while busy";
+        }
+        return;
+    }
+    m_checkpoint = QtConcurrent::run(
+            [pDbConnectionPool = m_pDbConnectionPool] {
+                checkpoint(pDbConnectionPool);
+            });
+}
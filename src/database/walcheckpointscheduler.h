@@ -0,0 +1,35 @@
+#pragma once
+
+#include <QFuture>
+#include <QObject>
+#include <QTimer>
+#include <functional>
+
+#include "util/db/dbconnectionpool.h"
+
+/// Periodically transfers the contents of the write-ahead log into the
+/// database file on a worker thread.
+///
+/// Checkpoints cause a burst of disk I/O and are deferred while the
+/// predicate reports that Mixxx is busy, e.g. while decks are playing.
+/// Otherwise SQLite would checkpoint automatically when committing an
+/// arbitrary write transaction, including those on the GUI thread.
+class WalCheckpointScheduler : public QObject {
+    Q_OBJECT
+  public:
+    WalCheckpointScheduler(
+            mixxx::DbConnectionPoolPtr pDbConnectionPool,
+            std::function<bool()> isBusy,
+            QObject* parent = nullptr);
+    ~WalCheckpointScheduler() override;
+
+  private slots:
+    void slotCheckpoint();
+
+  private:
+    const mixxx::DbConnectionPoolPtr m_pDbConnectionPool;
+    const std::function<bool()> m_isBusy;
+
+    QTimer m_timer;
+    QFuture<void> m_checkpoint;
+};
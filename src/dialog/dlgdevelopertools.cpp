@@ -1,17 +1,25 @@
 #include "dialog/dlgdevelopertools.h"
 
+#include <QCheckBox>
 #include <QDateTime>
 #include <QDir>
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QPushButton>
+#include <QVBoxLayout>
 
 #include "control/control.h"
 #include "moc_dlgdevelopertools.cpp"
+#include "soundio/xrunlog.h"
 #include "util/logging.h"
 #include "util/statsmanager.h"
+#include "widget/wengineprofilertimeline.h"
 
 DlgDeveloperTools::DlgDeveloperTools(QWidget* pParent,
                                      UserSettingsPointer pConfig)
         : QDialog(pParent),
-          m_pConfig(pConfig) {
+          m_pConfig(pConfig),
+          m_pXrunLogLabel(nullptr) {
     setupUi(this);
 
     controlsTable->setModel(&m_controlProxyModel);
@@ -60,6 +68,8 @@ DlgDeveloperTools::DlgDeveloperTools(QWidget* pParent,
 
     m_logCursor = logTextView->textCursor();
 
+    setupEngineProfilerTab();
+
     // Update at 2FPS.
     startTimer(500);
 
@@ -102,6 +112,48 @@ void DlgDeveloperTools::timerEvent(QTimerEvent* pEvent) {
     }
 }
 
+void DlgDeveloperTools::setupEngineProfilerTab() {
+    QWidget* pTab = new QWidget(toolTabWidget);
+    auto* pTimeline = new WEngineProfilerTimeline(pTab);
+    auto* pPauseCheckBox = new QCheckBox(tr("Pause"), pTab);
+    auto* pOverloadLabel = new QLabel(tr("No overload since opening the timeline."), pTab);
+    pOverloadLabel->setTextInteractionFlags(Qt::TextSelectableByMouse);
+    pOverloadLabel->setWordWrap(true);
+    connect(pPauseCheckBox,
+            &QCheckBox::toggled,
+            pTimeline,
+            &WEngineProfilerTimeline::setPaused);
+    connect(pTimeline,
+            &WEngineProfilerTimeline::overloadDetected,
+            pOverloadLabel,
+            &QLabel::setText);
+
+    auto* pXrunLogButton = new QPushButton(tr("Export Xrun Log"), pTab);
+    pXrunLogButton->setToolTip(
+            tr("Export the engine state at each xrun of the audio device "
+               "into a CSV file in the settings directory."));
+    connect(pXrunLogButton,
+            &QPushButton::clicked,
+            this,
+            &DlgDeveloperTools::slotXrunLogExport);
+    m_pXrunLogLabel = new QLabel(pTab);
+    m_pXrunLogLabel->setTextInteractionFlags(Qt::TextSelectableByMouse);
+
+    auto* pControlsLayout = new QHBoxLayout();
+    pControlsLayout->addWidget(pPauseCheckBox);
+    pControlsLayout->addWidget(pOverloadLabel, 1);
+    pControlsLayout->addWidget(m_pXrunLogLabel);
+    pControlsLayout->addWidget(pXrunLogButton);
+    auto* pLayout = new QVBoxLayout(pTab);
+    pLayout->addLayout(pControlsLayout);
+    pLayout->addWidget(pTimeline, 1);
+    pLayout->addWidget(new QLabel(
+            tr("Use the mouse wheel to change the number of visible callbacks."),
+            pTab));
+
+    toolTabWidget->addTab(pTab, tr("Engine Timeline"));
+}
+
 void DlgDeveloperTools::slotControlSearch(const QString& search) {
     m_controlProxyModel.setFilterFixedString(search);
 }
@@ -133,6 +185,18 @@ void DlgDeveloperTools::slotControlDump() {
     }
 }
 
+void DlgDeveloperTools::slotXrunLogExport() {
+    QString timestamp = QDateTime::currentDateTime()
+            .toString("yyyy-MM-dd_hh'h'mm'm'ss's'");
+    QString exportFileName = m_pConfig->getSettingsPath() +
+            "/xrun_log_" + timestamp + ".csv";
+    if (XrunLog::exportCsv(m_pConfig->getSettingsPath(), exportFileName)) {
+        m_pXrunLogLabel->setText(QDir::toNativeSeparators(exportFileName));
+    } else {
+        m_pXrunLogLabel->setText(tr("Export failed"));
+    }
+}
+
 void DlgDeveloperTools::slotLogSearch() {
     QString textToFind = logSearch->text();
     m_logCursor = logTextView->document()->find(textToFind, m_logCursor);
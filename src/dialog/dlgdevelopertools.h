@@ -9,6 +9,8 @@
 #include "preferences/usersettings.h"
 #include "util/statmodel.h"
 
+class QLabel;
+
 class DlgDeveloperTools : public QDialog, public Ui::DlgDeveloperTools {
     Q_OBJECT
   public:
@@ -21,8 +23,11 @@ class DlgDeveloperTools : public QDialog, public Ui::DlgDeveloperTools {
     void slotControlSearch(const QString& search);
     void slotLogSearch();
     void slotControlDump();
+    void slotXrunLogExport();
 
   private:
+    void setupEngineProfilerTab();
+
     UserSettingsPointer m_pConfig;
     ControlSortFilterModel m_controlProxyModel;
 
@@ -31,4 +36,6 @@ class DlgDeveloperTools : public QDialog, public Ui::DlgDeveloperTools {
 
     QFile m_logFile;
     QTextCursor m_logCursor;
+
+    QLabel* m_pXrunLogLabel;
 };
@@ -1,5 +1,6 @@
 #include "effects/backends/builtin/bitcrushereffect.h"
 
+#include "effects/backends/builtin/oversampling_util.h"
 #include "effects/backends/effectmanifest.h"
 #include "engine/effects/engineeffectparameter.h"
 #include "util/sample.h"
@@ -49,6 +50,8 @@ EffectManifestPointer BitCrusherEffect::getManifest() {
     frequency->setNeutralPointOnScale(1.0);
     frequency->setRange(0.02, 1.0, 1.0);
 
+    OversamplingUtil::createOversamplingParameter(pManifest.data());
+
     return pManifest;
 }
 
@@ -56,6 +59,7 @@ void BitCrusherEffect::loadEngineEffectParameters(
         const QMap<QString, EngineEffectParameterPointer>& parameters) {
     m_pBitDepthParameter = parameters.value("bit_depth");
     m_pDownsampleParameter = parameters.value("downsample");
+    m_pOversamplingParameter = parameters.value("oversampling");
 }
 
 void BitCrusherEffect::processChannel(
@@ -71,6 +75,41 @@ void BitCrusherEffect::processChannel(
     const auto downsample = static_cast<CSAMPLE>(
             m_pDownsampleParameter ? m_pDownsampleParameter->value() : 0.0);
 
+    const int factor = OversamplingUtil::factor(m_pOversamplingParameter);
+    pState->oversampler.setFactor(factor);
+    m_groupDelayFrames = pState->oversampler.latencyFrames();
+
+    if (factor == 1) {
+        processSamples(pState,
+                pInput,
+                pOutput,
+                engineParameters.samplesPerBuffer(),
+                downsample);
+        return;
+    }
+
+    // The steps of the held and quantized samples are filtered by
+    // downsampling, so that their harmonics above the Nyquist frequency of
+    // the engine do not alias. The held samples keep their duration at the
+    // higher sample rate.
+    pState->oversampler.upsample(pInput,
+            pState->oversampledInput.data(),
+            engineParameters.framesPerBuffer());
+    processSamples(pState,
+            pState->oversampledInput.data(),
+            pState->oversampledOutput.data(),
+            engineParameters.samplesPerBuffer() * factor,
+            downsample / factor);
+    pState->oversampler.downsample(pState->oversampledOutput.data(),
+            pOutput,
+            engineParameters.framesPerBuffer());
+}
+
+void BitCrusherEffect::processSamples(BitCrusherGroupState* pState,
+        const CSAMPLE* pInput,
+        CSAMPLE* pOutput,
+        SINT numSamples,
+        CSAMPLE downsample) {
     auto bit_depth = static_cast<CSAMPLE>(
             m_pBitDepthParameter ? m_pBitDepthParameter->value() : 16);
 
@@ -80,9 +119,7 @@ void BitCrusherEffect::processChannel(
     // rarely used, to achieve equal loudness and maximum dynamic
     const CSAMPLE gainCorrection = (17 - bit_depth) / 8;
 
-    for (SINT i = 0;
-            i < engineParameters.samplesPerBuffer();
-            i += engineParameters.channelCount()) {
+    for (SINT i = 0; i < numSamples; i += mixxx::kEngineChannelCount) {
         pState->accumulator += downsample;
 
         if (pState->accumulator >= 1.0) {
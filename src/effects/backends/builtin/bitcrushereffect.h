@@ -4,6 +4,8 @@
 
 #include "effects/backends/effectprocessor.h"
 #include "util/class.h"
+#include "util/oversampler.h"
+#include "util/samplebuffer.h"
 #include "util/types.h"
 
 struct BitCrusherGroupState : public EffectState {
@@ -12,7 +14,12 @@ struct BitCrusherGroupState : public EffectState {
             : EffectState(engineParameters),
               hold_l(0),
               hold_r(0),
-              accumulator(1) {
+              accumulator(1),
+              oversampler(engineParameters.framesPerBuffer()),
+              oversampledInput(engineParameters.samplesPerBuffer() *
+                      mixxx::Oversampler::kMaxFactor),
+              oversampledOutput(engineParameters.samplesPerBuffer() *
+                      mixxx::Oversampler::kMaxFactor) {
     }
     ~BitCrusherGroupState() override = default;
 
@@ -20,11 +27,17 @@ struct BitCrusherGroupState : public EffectState {
     CSAMPLE hold_r;
     // Accumulated fractions of a samplerate period.
     CSAMPLE accumulator;
+
+    mixxx::Oversampler oversampler;
+    mixxx::SampleBuffer oversampledInput;
+    mixxx::SampleBuffer oversampledOutput;
 };
 
 class BitCrusherEffect : public EffectProcessorImpl<BitCrusherGroupState> {
   public:
-    BitCrusherEffect() = default;
+    BitCrusherEffect()
+            : m_groupDelayFrames(0) {
+    }
     ~BitCrusherEffect() override = default;
 
     static QString getId();
@@ -41,13 +54,28 @@ class BitCrusherEffect : public EffectProcessorImpl<BitCrusherGroupState> {
             const EffectEnableState enableState,
             const GroupFeatureState& groupFeatureState) override;
 
+    /// The latency of the oversampling
+    SINT getGroupDelayFrames() override {
+        return m_groupDelayFrames;
+    }
+
   private:
+    /// Downsamples by holding samples for 1 / downsample frames
+    void processSamples(BitCrusherGroupState* pState,
+            const CSAMPLE* pInput,
+            CSAMPLE* pOutput,
+            SINT numSamples,
+            CSAMPLE downsample);
+
     QString debugString() const {
         return getId();
     }
 
     EngineEffectParameterPointer m_pBitDepthParameter;
     EngineEffectParameterPointer m_pDownsampleParameter;
+    EngineEffectParameterPointer m_pOversamplingParameter;
+
+    SINT m_groupDelayFrames;
 
     DISALLOW_COPY_AND_ASSIGN(BitCrusherEffect);
 };
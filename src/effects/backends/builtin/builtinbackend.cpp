@@ -6,6 +6,7 @@
 #include "effects/backends/builtin/bessel8lvmixeqeffect.h"
 #include "effects/backends/builtin/biquadfullkilleqeffect.h"
 #include "effects/backends/builtin/bitcrushereffect.h"
+#include "effects/backends/builtin/convolutionreverbeffect.h"
 #include "effects/backends/builtin/filtereffect.h"
 #include "effects/backends/builtin/flangereffect.h"
 #include "effects/backends/builtin/graphiceqeffect.h"
@@ -53,6 +54,7 @@ BuiltInBackend::BuiltInBackend() {
 #ifndef __MACAPPSTORE__
     registerEffect<ReverbEffect>();
 #endif
+    registerEffect<ConvolutionReverbEffect>();
     registerEffect<PhaserEffect>();
     registerEffect<MetronomeEffect>();
     registerEffect<TremoloEffect>();
@@ -0,0 +1,317 @@
+#include "effects/backends/builtin/convolutionreverbeffect.h"
+
+#include <QtConcurrentRun>
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "effects/backends/effectmanifest.h"
+#include "engine/effects/engineeffectparameter.h"
+#include "util/sample.h"
+
+namespace {
+
+// About 1.4 s at 48 kHz. Longer reverberations are faded out, which
+// limits the memory of the frequency-domain delay lines of every state.
+constexpr SINT kMaxImpulseResponseFrames = 65536;
+
+// The parameters are polled, because they are updated without notifying
+// anyone.
+constexpr int kPollIntervalMillis = 100;
+
+// The reverberation time (RT60), i.e. the time in seconds until the
+// reverberation has decayed by 60 dB.
+double reverberationTime(double roomSize) {
+    return 0.3 + 2.7 * roomSize * roomSize;
+}
+
+/// Synthesizes the impulse response of a room from a few early
+/// reflections and exponentially decaying noise. Damping attenuates the
+/// high frequencies of the noise more and more while it decays.
+std::vector<CSAMPLE> synthesizeImpulseResponse(
+        double roomSize,
+        double damping,
+        double sampleRate,
+        unsigned int seed) {
+    const double decayFrames = reverberationTime(roomSize) * sampleRate;
+    const SINT length = std::min(
+            static_cast<SINT>(std::ceil(decayFrames)), kMaxImpulseResponseFrames);
+    std::vector<CSAMPLE> impulseResponse(length);
+
+    std::minstd_rand generator(seed);
+    std::uniform_real_distribution<double> noise(-1.0, 1.0);
+
+    const auto preDelay = static_cast<SINT>((0.005 + 0.02 * roomSize) * sampleRate);
+    // In seconds for the smallest room
+    constexpr double kReflectionDelays[] = {0.0, 0.0043, 0.0071, 0.0113, 0.0157, 0.0219};
+    double reflectionGain = 1.0;
+    for (const double delay : kReflectionDelays) {
+        const SINT frame = preDelay +
+                static_cast<SINT>(delay * (1.0 + 3.0 * roomSize) * sampleRate);
+        if (frame < length) {
+            impulseResponse[frame] += static_cast<CSAMPLE>(
+                    reflectionGain * (noise(generator) < 0 ? -1.0 : 1.0));
+        }
+        reflectionGain *= 0.7;
+    }
+
+    // -60 dB after the reverberation time
+    const double decayPerFrame = std::pow(0.001, 1.0 / decayFrames);
+    const SINT fadeOutFrames = std::max(length / 8, static_cast<SINT>(1));
+    double gain = 0.25;
+    double lowpassed = 0.0;
+    for (SINT frame = preDelay; frame < length; ++frame) {
+        const double coefficient = 0.95 * damping *
+                std::min((frame - preDelay) / decayFrames, 1.0);
+        lowpassed += (1.0 - coefficient) * (noise(generator) - lowpassed);
+        double value = lowpassed * gain;
+        if (frame >= length - fadeOutFrames) {
+            value *= static_cast<double>(length - frame) / fadeOutFrames;
+        }
+        impulseResponse[frame] += static_cast<CSAMPLE>(value);
+        gain *= decayPerFrame;
+    }
+
+    // Normalize the energy, so that the size of the room does not affect
+    // the loudness of the reverberation
+    double energy = 0.0;
+    for (const CSAMPLE sample : impulseResponse) {
+        energy += static_cast<double>(sample) * sample;
+    }
+    if (energy > 0.0) {
+        const auto scale = static_cast<CSAMPLE>(0.5 / std::sqrt(energy));
+        for (CSAMPLE& sample : impulseResponse) {
+            sample *= scale;
+        }
+    }
+    return impulseResponse;
+}
+
+ConvolutionReverbKernels* createKernels(
+        double roomSize, double damping, double sampleRate) {
+    // Different noise for both channels results in a wide stereo image
+    const std::vector<CSAMPLE> left =
+            synthesizeImpulseResponse(roomSize, damping, sampleRate, 1);
+    const std::vector<CSAMPLE> right =
+            synthesizeImpulseResponse(roomSize, damping, sampleRate, 2);
+    DEBUG_ASSERT(left.size() == right.size());
+    return new ConvolutionReverbKernels(
+            left.data(), right.data(), static_cast<SINT>(left.size()));
+}
+
+} // anonymous namespace
+
+ConvolutionReverbKernelLoader::ConvolutionReverbKernelLoader()
+        : m_sampleRate(mixxx::audio::SampleRate().value()),
+          m_roomSize(0.0),
+          m_damping(0.0),
+          m_kernelSampleRate(mixxx::audio::SampleRate().value()),
+          m_pPendingKernels(nullptr),
+          m_pRetiredKernels(nullptr),
+          m_pKernels(nullptr),
+          m_generation(0) {
+    m_timer.setInterval(kPollIntervalMillis);
+    QObject::connect(&m_timer, &QTimer::timeout, &m_timer, [this] {
+        poll();
+    });
+}
+
+ConvolutionReverbKernelLoader::~ConvolutionReverbKernelLoader() {
+    m_timer.stop();
+    // The worker thread might still be creating kernels
+    m_future.waitForFinished();
+    delete m_pPendingKernels.exchange(nullptr);
+    delete m_pRetiredKernels.exchange(nullptr);
+    delete m_pKernels;
+}
+
+void ConvolutionReverbKernelLoader::setParameters(
+        EngineEffectParameterPointer pRoomSizeParameter,
+        EngineEffectParameterPointer pDampingParameter) {
+    m_pRoomSizeParameter = std::move(pRoomSizeParameter);
+    m_pDampingParameter = std::move(pDampingParameter);
+    m_timer.start();
+}
+
+void ConvolutionReverbKernelLoader::poll() {
+    delete m_pRetiredKernels.exchange(nullptr);
+    if (m_future.isRunning()) {
+        return;
+    }
+    const auto sampleRate = m_sampleRate.load(std::memory_order_relaxed);
+    if (!mixxx::audio::SampleRate(sampleRate).isValid() ||
+            !m_pRoomSizeParameter || !m_pDampingParameter) {
+        // Not processed yet
+        return;
+    }
+    const double roomSize = m_pRoomSizeParameter->value();
+    const double damping = m_pDampingParameter->value();
+    if (sampleRate == m_kernelSampleRate &&
+            roomSize == m_roomSize &&
+            damping == m_damping) {
+        return;
+    }
+    m_kernelSampleRate = sampleRate;
+    m_roomSize = roomSize;
+    m_damping = damping;
+    m_future = QtConcurrent::run([this, roomSize, damping, sampleRate] {
+        // Kernels that have not been taken by the engine are outdated
+        delete m_pPendingKernels.exchange(
+                createKernels(roomSize, damping, sampleRate));
+    });
+}
+
+const ConvolutionReverbKernels* ConvolutionReverbKernelLoader::takeKernels() {
+    // The previous kernels must have been deleted before they can be
+    // replaced again
+    if (!m_pRetiredKernels.load()) {
+        ConvolutionReverbKernels* pKernels = m_pPendingKernels.exchange(nullptr);
+        if (pKernels) {
+            m_pRetiredKernels.store(m_pKernels);
+            m_pKernels = pKernels;
+            ++m_generation;
+        }
+    }
+    return m_pKernels;
+}
+
+ConvolutionReverbGroupState::ConvolutionReverbGroupState(
+        const mixxx::EngineParameters& engineParameters)
+        : EffectState(engineParameters),
+          leftConvolver(kMaxImpulseResponseFrames),
+          rightConvolver(kMaxImpulseResponseFrames),
+          send(engineParameters.samplesPerBuffer()),
+          leftInput(engineParameters.framesPerBuffer()),
+          rightInput(engineParameters.framesPerBuffer()),
+          leftOutput(engineParameters.framesPerBuffer()),
+          rightOutput(engineParameters.framesPerBuffer()),
+          sendPrevious(0),
+          kernelGeneration(0) {
+}
+
+// static
+QString ConvolutionReverbEffect::getId() {
+    return "org.mixxx.effects.convolutionreverb";
+}
+
+// static
+EffectManifestPointer ConvolutionReverbEffect::getManifest() {
+    EffectManifestPointer pManifest(new EffectManifest());
+    pManifest->setAddDryToWet(true);
+    pManifest->setEffectRampsFromDry(true);
+
+    pManifest->setId(getId());
+    pManifest->setName(QObject::tr("Convolution Reverb"));
+    pManifest->setShortName(QObject::tr("Conv Reverb"));
+    pManifest->setAuthor("The Mixxx Team");
+    pManifest->setVersion("1.0");
+    pManifest->setDescription(QObject::tr(
+            "Emulates the sound of a room by convolving the signal with "
+            "its impulse response"));
+
+    EffectManifestParameterPointer roomSize = pManifest->addParameter();
+    roomSize->setId("room_size");
+    roomSize->setName(QObject::tr("Room Size"));
+    roomSize->setShortName(QObject::tr("Room"));
+    roomSize->setDescription(QObject::tr(
+            "Larger rooms cause longer reverberations and later reflections."));
+    roomSize->setValueScaler(EffectManifestParameter::ValueScaler::Linear);
+    roomSize->setUnitsHint(EffectManifestParameter::UnitsHint::Unknown);
+    roomSize->setRange(0, 0.5, 1);
+
+    EffectManifestParameterPointer damping = pManifest->addParameter();
+    damping->setId("damping");
+    damping->setName(QObject::tr("Damping"));
+    damping->setShortName(QObject::tr("Damping"));
+    damping->setDescription(
+            QObject::tr("Higher damping values cause high frequencies to decay "
+                        "more quickly than low frequencies."));
+    damping->setValueScaler(EffectManifestParameter::ValueScaler::Linear);
+    damping->setUnitsHint(EffectManifestParameter::UnitsHint::Unknown);
+    damping->setRange(0, 0.5, 1);
+
+    EffectManifestParameterPointer send = pManifest->addParameter();
+    send->setId("send_amount");
+    send->setName(QObject::tr("Send"));
+    send->setShortName(QObject::tr("Send"));
+    send->setDescription(QObject::tr(
+            "How much of the signal to send in to the effect"));
+    send->setValueScaler(EffectManifestParameter::ValueScaler::Linear);
+    send->setUnitsHint(EffectManifestParameter::UnitsHint::Unknown);
+    send->setDefaultLinkType(EffectManifestParameter::LinkType::Linked);
+    send->setDefaultLinkInversion(EffectManifestParameter::LinkInversion::NotInverted);
+    send->setRange(0, 0, 1);
+
+    return pManifest;
+}
+
+void ConvolutionReverbEffect::loadEngineEffectParameters(
+        const QMap<QString, EngineEffectParameterPointer>& parameters) {
+    m_pRoomSizeParameter = parameters.value("room_size");
+    m_pDampingParameter = parameters.value("damping");
+    m_pSendParameter = parameters.value("send_amount");
+    m_kernelLoader.setParameters(m_pRoomSizeParameter, m_pDampingParameter);
+}
+
+void ConvolutionReverbEffect::processChannel(
+        ConvolutionReverbGroupState* pState,
+        const CSAMPLE* pInput,
+        CSAMPLE* pOutput,
+        const mixxx::EngineParameters& engineParameters,
+        const EffectEnableState enableState,
+        const GroupFeatureState& groupFeatures) {
+    Q_UNUSED(groupFeatures);
+
+    const SINT numFrames = engineParameters.framesPerBuffer();
+    const SINT numSamples = engineParameters.samplesPerBuffer();
+    VERIFY_OR_DEBUG_ASSERT(pState->send.size() >= numSamples) {
+        // Only the dry signal
+        SampleUtil::clear(pOutput, numSamples);
+        return;
+    }
+
+    m_kernelLoader.setSampleRate(engineParameters.sampleRate());
+    const ConvolutionReverbKernels* pKernels = m_kernelLoader.takeKernels();
+    if (pState->kernelGeneration != m_kernelLoader.generation()) {
+        pState->leftConvolver.setKernel(pKernels ? &pKernels->left : nullptr);
+        pState->rightConvolver.setKernel(pKernels ? &pKernels->right : nullptr);
+        pState->kernelGeneration = m_kernelLoader.generation();
+    }
+
+    // Don't replay the reverberation from the last time the effect was
+    // enabled
+    if (enableState == EffectEnableState::Enabling) {
+        pState->leftConvolver.reset();
+        pState->rightConvolver.reset();
+    }
+
+    const auto sendCurrent = static_cast<CSAMPLE_GAIN>(m_pSendParameter->value());
+    SampleUtil::copyWithRampingGain(pState->send.data(),
+            pInput,
+            pState->sendPrevious,
+            sendCurrent,
+            numSamples);
+    SampleUtil::deinterleaveBuffer(pState->leftInput.data(),
+            pState->rightInput.data(),
+            pState->send.data(),
+            numFrames);
+    pState->leftConvolver.process(
+            pState->leftInput.data(), pState->leftOutput.data(), numFrames);
+    pState->rightConvolver.process(
+            pState->rightInput.data(), pState->rightOutput.data(), numFrames);
+    SampleUtil::interleaveBuffer(pOutput,
+            pState->leftOutput.data(),
+            pState->rightOutput.data(),
+            numFrames);
+
+    // The ramping of the send parameter handles ramping when enabling, so
+    // this effect must handle ramping to dry when disabling itself (instead
+    // of being handled by EngineEffect::process).
+    if (enableState == EffectEnableState::Disabling) {
+        SampleUtil::applyRampingGain(pOutput, 1.0, 0.0, numSamples);
+        pState->sendPrevious = 0;
+    } else {
+        pState->sendPrevious = sendCurrent;
+    }
+}
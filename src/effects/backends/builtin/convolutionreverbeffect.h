@@ -0,0 +1,129 @@
+#pragma once
+
+#include <QFuture>
+#include <QMap>
+#include <QTimer>
+#include <atomic>
+
+#include "effects/backends/effectprocessor.h"
+#include "util/class.h"
+#include "util/partitionedconvolver.h"
+#include "util/samplebuffer.h"
+#include "util/types.h"
+
+/// The impulse responses for both channels of ConvolutionReverbEffect
+struct ConvolutionReverbKernels {
+    ConvolutionReverbKernels(
+            const CSAMPLE* pLeft, const CSAMPLE* pRight, SINT length)
+            : left(pLeft, length),
+              right(pRight, length) {
+    }
+
+    const mixxx::ConvolutionKernel left;
+    const mixxx::ConvolutionKernel right;
+};
+
+/// Creates the kernels of ConvolutionReverbEffect in a worker thread
+/// whenever the parameters that shape the room have changed and hands
+/// them over to the engine without locking.
+///
+/// Must be created and destroyed in the main thread, only takeKernels()
+/// and setSampleRate() are invoked from the engine thread.
+class ConvolutionReverbKernelLoader {
+  public:
+    ConvolutionReverbKernelLoader();
+    ~ConvolutionReverbKernelLoader();
+
+    void setParameters(
+            EngineEffectParameterPointer pRoomSizeParameter,
+            EngineEffectParameterPointer pDampingParameter);
+
+    void setSampleRate(mixxx::audio::SampleRate sampleRate) {
+        m_sampleRate.store(sampleRate.value(), std::memory_order_relaxed);
+    }
+
+    /// Returns the kernels that have been created most recently. The
+    /// previous kernels are deleted in the main thread after they have
+    /// been replaced.
+    const ConvolutionReverbKernels* takeKernels();
+
+    /// Incremented whenever takeKernels() returns different kernels
+    int generation() const {
+        return m_generation;
+    }
+
+  private:
+    void poll();
+
+    EngineEffectParameterPointer m_pRoomSizeParameter;
+    EngineEffectParameterPointer m_pDampingParameter;
+    std::atomic<mixxx::audio::SampleRate::value_t> m_sampleRate;
+
+    QTimer m_timer;
+    QFuture<void> m_future;
+    double m_roomSize;
+    double m_damping;
+    mixxx::audio::SampleRate::value_t m_kernelSampleRate;
+
+    // Created by the worker thread, taken by the engine thread
+    std::atomic<ConvolutionReverbKernels*> m_pPendingKernels;
+    // Replaced by the engine thread, deleted by the main thread
+    std::atomic<ConvolutionReverbKernels*> m_pRetiredKernels;
+    // Only accessed by the engine thread
+    ConvolutionReverbKernels* m_pKernels;
+    int m_generation;
+
+    DISALLOW_COPY_AND_ASSIGN(ConvolutionReverbKernelLoader);
+};
+
+class ConvolutionReverbGroupState : public EffectState {
+  public:
+    ConvolutionReverbGroupState(const mixxx::EngineParameters& engineParameters);
+    ~ConvolutionReverbGroupState() override = default;
+
+    mixxx::PartitionedConvolver leftConvolver;
+    mixxx::PartitionedConvolver rightConvolver;
+    mixxx::SampleBuffer send;
+    mixxx::SampleBuffer leftInput;
+    mixxx::SampleBuffer rightInput;
+    mixxx::SampleBuffer leftOutput;
+    mixxx::SampleBuffer rightOutput;
+    CSAMPLE_GAIN sendPrevious;
+    int kernelGeneration;
+};
+
+/// A reverb that convolves the signal with the synthesized impulse
+/// response of a room. The output is delayed by
+/// PartitionedConvolver::kHeadBlockSize frames, which is not compensated
+/// and sounds like a short pre-delay.
+class ConvolutionReverbEffect : public EffectProcessorImpl<ConvolutionReverbGroupState> {
+  public:
+    ConvolutionReverbEffect() = default;
+
+    static QString getId();
+    static EffectManifestPointer getManifest();
+
+    void loadEngineEffectParameters(
+            const QMap<QString, EngineEffectParameterPointer>& parameters) override;
+
+    void processChannel(
+            ConvolutionReverbGroupState* pState,
+            const CSAMPLE* pInput,
+            CSAMPLE* pOutput,
+            const mixxx::EngineParameters& engineParameters,
+            const EffectEnableState enableState,
+            const GroupFeatureState& groupFeatures) override;
+
+  private:
+    QString debugString() const {
+        return getId();
+    }
+
+    EngineEffectParameterPointer m_pRoomSizeParameter;
+    EngineEffectParameterPointer m_pDampingParameter;
+    EngineEffectParameterPointer m_pSendParameter;
+
+    ConvolutionReverbKernelLoader m_kernelLoader;
+
+    DISALLOW_COPY_AND_ASSIGN(ConvolutionReverbEffect);
+};
@@ -1,5 +1,6 @@
 #include "effects/backends/builtin/distortioneffect.h"
 
+#include "effects/backends/builtin/oversampling_util.h"
 #include "effects/backends/effectmanifest.h"
 #include "engine/effects/engineeffectparameter.h"
 
@@ -51,6 +52,8 @@ EffectManifestPointer DistortionEffect::getManifest() {
     drive->setNeutralPointOnScale(0);
     drive->setRange(0, 0, 1);
 
+    OversamplingUtil::createOversamplingParameter(pManifest.data());
+
     return pManifest;
 }
 
@@ -61,8 +64,14 @@ DistortionGroupState::DistortionGroupState(
           m_crossfadeParameter(0),
           m_samplerate(engineParameters.sampleRate()),
           m_previousMakeUpGain(1),
-          m_previousNormalizationGain(1) {
+          m_previousNormalizationGain(1),
+          m_oversampler(engineParameters.framesPerBuffer()),
+          m_oversampledInput(engineParameters.samplesPerBuffer() *
+                  mixxx::Oversampler::kMaxFactor),
+          m_oversampledOutput(engineParameters.samplesPerBuffer() *
+                  mixxx::Oversampler::kMaxFactor) {
 }
+
 struct DistortionEffect::SoftClippingParameters {
     static constexpr const CSAMPLE normalizationLevel = 0.2f;
     static constexpr const CSAMPLE crossfadeEndParam = 0.2f;
@@ -87,6 +96,7 @@ void DistortionEffect::loadEngineEffectParameters(
         const QMap<QString, EngineEffectParameterPointer>& parameters) {
     m_pMode = parameters.value("mode");
     m_pDrive = parameters.value("drive");
+    m_pOversampling = parameters.value("oversampling");
 }
 
 void DistortionEffect::processChannel(
@@ -99,9 +109,35 @@ void DistortionEffect::processChannel(
     Q_UNUSED(groupFeatures);
     Q_UNUSED(enableState);
 
-    // TODO: anti-aliasing
+    const int factor = OversamplingUtil::factor(m_pOversampling);
+    pState->m_oversampler.setFactor(factor);
+    m_groupDelayFrames = pState->m_oversampler.latencyFrames();
+
+    if (factor == 1) {
+        processSamples(pState, pInput, pOutput, engineParameters.samplesPerBuffer());
+        return;
+    }
 
-    SINT numSamples = engineParameters.samplesPerBuffer();
+    // The harmonics of the waveshaper above the Nyquist frequency of the
+    // engine are removed by downsampling instead of aliasing. The dry
+    // signal is mixed in at the higher sample rate so that it passes the
+    // same filters.
+    pState->m_oversampler.upsample(pInput,
+            pState->m_oversampledInput.data(),
+            engineParameters.framesPerBuffer());
+    processSamples(pState,
+            pState->m_oversampledInput.data(),
+            pState->m_oversampledOutput.data(),
+            engineParameters.samplesPerBuffer() * factor);
+    pState->m_oversampler.downsample(pState->m_oversampledOutput.data(),
+            pOutput,
+            engineParameters.framesPerBuffer());
+}
+
+void DistortionEffect::processSamples(DistortionGroupState* pState,
+        const CSAMPLE* pInput,
+        CSAMPLE* pOutput,
+        SINT numSamples) {
     CSAMPLE driveParam = static_cast<CSAMPLE>(m_pDrive->value());
 
     if (driveParam < 0.01) {
@@ -112,12 +148,12 @@ void DistortionEffect::processChannel(
     switch (m_pMode->toInt()) {
     case SoftClipping:
         processDistortion<SoftClippingParameters>(
-                driveParam, pState, pOutput, pInput, engineParameters);
+                driveParam, pState, pOutput, pInput, numSamples);
         break;
 
     case HardClipping:
         processDistortion<HardClippingParameters>(
-                driveParam, pState, pOutput, pInput, engineParameters);
+                driveParam, pState, pOutput, pInput, numSamples);
         break;
 
     default:
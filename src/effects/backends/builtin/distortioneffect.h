@@ -2,7 +2,9 @@
 
 #include "effects/backends/effectprocessor.h"
 #include "util/class.h"
+#include "util/oversampler.h"
 #include "util/sample.h"
+#include "util/samplebuffer.h"
 #include "util/types.h"
 
 class DistortionGroupState : public EffectState {
@@ -16,11 +18,17 @@ class DistortionGroupState : public EffectState {
 
     CSAMPLE m_previousMakeUpGain;
     CSAMPLE m_previousNormalizationGain;
+
+    mixxx::Oversampler m_oversampler;
+    mixxx::SampleBuffer m_oversampledInput;
+    mixxx::SampleBuffer m_oversampledOutput;
 };
 
 class DistortionEffect : public EffectProcessorImpl<DistortionGroupState> {
   public:
-    DistortionEffect() = default;
+    DistortionEffect()
+            : m_groupDelayFrames(0) {
+    }
     ~DistortionEffect() override = default;
 
     static QString getId();
@@ -37,6 +45,11 @@ class DistortionEffect : public EffectProcessorImpl<DistortionGroupState> {
             const EffectEnableState enableState,
             const GroupFeatureState& groupFeatures) override;
 
+    /// The latency of the oversampling
+    SINT getGroupDelayFrames() override {
+        return m_groupDelayFrames;
+    }
+
   private:
     enum Mode {
         SoftClipping = 0,
@@ -46,14 +59,17 @@ class DistortionEffect : public EffectProcessorImpl<DistortionGroupState> {
     struct SoftClippingParameters;
     struct HardClippingParameters;
 
+    void processSamples(DistortionGroupState* pState,
+            const CSAMPLE* pInput,
+            CSAMPLE* pOutput,
+            SINT numSamples);
+
     template<typename ModeParams>
     void processDistortion(CSAMPLE driveParam,
             DistortionGroupState* pState,
             CSAMPLE* pOutput,
             const CSAMPLE* pInput,
-            const mixxx::EngineParameters& engineParameters) {
-        SINT numSamples = engineParameters.samplesPerBuffer();
-
+            SINT numSamples) {
         // Normalize input
         pState->m_previousNormalizationGain =
                 SampleUtil::copyWithRampingNormalization(pOutput,
@@ -68,12 +84,8 @@ class DistortionEffect : public EffectProcessorImpl<DistortionGroupState> {
                 pOutput, pInput, pState->m_driveGain, driveGain, numSamples);
 
         // Waveshape
-        for (SINT i = 0;
-                i < engineParameters.samplesPerBuffer();
-                i += engineParameters.channelCount()) {
-            for (int channel = 0; channel < engineParameters.channelCount(); ++channel) {
-                pOutput[i + channel] = ModeParams::process(pOutput[i + channel]);
-            }
+        for (SINT i = 0; i < numSamples; ++i) {
+            pOutput[i] = ModeParams::process(pOutput[i]);
         }
 
         // Volume compensation
@@ -86,7 +98,7 @@ class DistortionEffect : public EffectProcessorImpl<DistortionGroupState> {
         SampleUtil::applyRampingGain(pOutput,
                 pState->m_previousMakeUpGain,
                 gain,
-                engineParameters.samplesPerBuffer());
+                numSamples);
 
         pState->m_previousMakeUpGain = gain;
 
@@ -112,6 +124,9 @@ class DistortionEffect : public EffectProcessorImpl<DistortionGroupState> {
 
     EngineEffectParameterPointer m_pMode;
     EngineEffectParameterPointer m_pDrive;
+    EngineEffectParameterPointer m_pOversampling;
+
+    SINT m_groupDelayFrames;
 
     DISALLOW_COPY_AND_ASSIGN(DistortionEffect);
 };
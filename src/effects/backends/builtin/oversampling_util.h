@@ -0,0 +1,45 @@
+#pragma once
+
+#include <QObject>
+
+#include "effects/backends/effectmanifest.h"
+#include "engine/effects/engineeffectparameter.h"
+#include "util/math.h"
+
+/// Shared parameter of the effects that process the signal with a
+/// mixxx::Oversampler to reduce aliasing.
+class OversamplingUtil {
+  public:
+    enum Quality {
+        Off = 0,
+        TwoTimes = 1,
+        FourTimes = 2,
+    };
+
+    static void createOversamplingParameter(EffectManifest* pManifest) {
+        EffectManifestParameterPointer oversampling = pManifest->addParameter();
+        oversampling->setId("oversampling");
+        oversampling->setName(QObject::tr("Oversampling"));
+        oversampling->setShortName(QObject::tr("Oversampling"));
+        oversampling->setDescription(QObject::tr(
+                "Processes the signal at a multiple of the sample rate.\n"
+                "Higher factors reduce the aliasing of the added harmonics "
+                "at the cost of more CPU load and latency."));
+        oversampling->setValueScaler(EffectManifestParameter::ValueScaler::Toggle);
+        oversampling->setUnitsHint(EffectManifestParameter::UnitsHint::Unknown);
+        oversampling->setRange(Quality::Off, Quality::Off, Quality::FourTimes);
+        oversampling->appendStep(qMakePair(QObject::tr("Off"), Quality::Off));
+        oversampling->appendStep(qMakePair(QObject::tr("2x"), Quality::TwoTimes));
+        oversampling->appendStep(qMakePair(QObject::tr("4x"), Quality::FourTimes));
+    }
+
+    /// Returns the oversampling factor for the value of the parameter
+    static int factor(const EngineEffectParameterPointer& pOversampling) {
+        if (!pOversampling) {
+            return 1;
+        }
+        return 1 << math_clamp(pOversampling->toInt(),
+                       static_cast<int>(Quality::Off),
+                       static_cast<int>(Quality::FourTimes));
+    }
+};
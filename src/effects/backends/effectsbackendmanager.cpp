@@ -4,18 +4,37 @@
 #include "effects/backends/builtin/builtinbackend.h"
 #include "effects/backends/effectprocessor.h"
 #ifdef __LILV__
+#include <QDir>
+
 #include "effects/backends/lv2/lv2backend.h"
 #endif
 #include "effects/presets/effectpreset.h"
 
-EffectsBackendManager::EffectsBackendManager() {
+#ifdef __LILV__
+namespace {
+
+// Opt-in: Isolate the engine from slow LV2 plugins at the cost of one buffer
+// of latency, which is compensated for the dry signal.
+const ConfigKey kLV2WorkerThreadConfigKey(
+        QStringLiteral("[Effects]"), QStringLiteral("LV2WorkerThread"));
+
+const QString kLV2CacheFileName = QStringLiteral("lv2plugins.cache");
+
+} // anonymous namespace
+#endif
+
+EffectsBackendManager::EffectsBackendManager(UserSettingsPointer pConfig) {
     m_pNumEffectsAvailable = std::make_unique<ControlObject>(
             ConfigKey("[Master]", "num_effectsavailable"));
     m_pNumEffectsAvailable->setReadOnly();
 
     addBackend(EffectsBackendPointer(new BuiltInBackend()));
 #ifdef __LILV__
-    addBackend(EffectsBackendPointer(new LV2Backend()));
+    addBackend(EffectsBackendPointer(new LV2Backend(
+            pConfig->getValue(kLV2WorkerThreadConfigKey, false),
+            QDir(pConfig->getSettingsPath()).filePath(kLV2CacheFileName))));
+#else
+    Q_UNUSED(pConfig);
 #endif
 }
 
@@ -2,22 +2,213 @@
 
 #include <lv2/units/units.h>
 
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QSaveFile>
+#include <QUrl>
+
 #include "effects/backends/lv2/lv2effectprocessor.h"
 #include "effects/backends/lv2/lv2manifest.h"
+#include "util/logger.h"
 
-LV2Backend::LV2Backend() {
-    m_pWorld = lilv_world_new();
-    initializeProperties();
-    lilv_world_load_all(m_pWorld);
+namespace {
+
+const mixxx::Logger kLogger("LV2Backend");
+
+// Must be incremented whenever the serialized LV2Manifest changes
+constexpr qint32 kCacheVersion = 1;
+constexpr QDataStream::Version kCacheStreamVersion = QDataStream::Qt_5_12;
+
+/// The directories that lilv searches for bundles if LV2_PATH is not set.
+/// The directories of all discovered bundles are added to these, so a
+/// different default of the installed lilv version is covered as well.
+QStringList defaultSearchPaths() {
+    const QByteArray lv2Path = qgetenv("LV2_PATH");
+    if (!lv2Path.isEmpty()) {
+        return QString::fromLocal8Bit(lv2Path).split(QDir::listSeparator(),
+#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
+                Qt::SkipEmptyParts);
+#else
+                QString::SkipEmptyParts);
+#endif
+    }
+    const QString home = QDir::homePath();
+#if defined(__WINDOWS__)
+    return {
+            QDir::fromNativeSeparators(qEnvironmentVariable("APPDATA")) +
+                    QStringLiteral("/LV2"),
+            QDir::fromNativeSeparators(qEnvironmentVariable("COMMONPROGRAMFILES")) +
+                    QStringLiteral("/LV2"),
+    };
+#elif defined(__APPLE__)
+    return {
+            home + QStringLiteral("/Library/Audio/Plug-Ins/LV2"),
+            home + QStringLiteral("/.lv2"),
+            QStringLiteral("/usr/local/lib/lv2"),
+            QStringLiteral("/usr/lib/lv2"),
+            QStringLiteral("/Library/Audio/Plug-Ins/LV2"),
+    };
+#else
+    return {
+            home + QStringLiteral("/.lv2"),
+            QStringLiteral("/usr/local/lib/lv2"),
+            QStringLiteral("/usr/local/lib64/lv2"),
+            QStringLiteral("/usr/lib/lv2"),
+            QStringLiteral("/usr/lib64/lv2"),
+    };
+#endif
+}
+
+QMap<QString, qint64> scanBundles(const QStringList& searchPaths) {
+    QMap<QString, qint64> bundles;
+    for (const QString& searchPath : searchPaths) {
+        const QFileInfoList bundleInfos =
+                QDir(searchPath).entryInfoList(QDir::Dirs | QDir::NoDotAndDotDot);
+        for (const QFileInfo& bundleInfo : bundleInfos) {
+            qint64 lastModified = bundleInfo.lastModified().toMSecsSinceEpoch();
+            // Files that are modified in place do not touch the directory
+            const QFileInfoList fileInfos =
+                    QDir(bundleInfo.filePath()).entryInfoList(QDir::Files);
+            for (const QFileInfo& fileInfo : fileInfos) {
+                lastModified = std::max(lastModified,
+                        fileInfo.lastModified().toMSecsSinceEpoch());
+            }
+            bundles.insert(bundleInfo.absoluteFilePath(), lastModified);
+        }
+    }
+    return bundles;
+}
+
+QStringList mergeSearchPaths(QStringList searchPaths, const QStringList& otherSearchPaths) {
+    searchPaths.append(otherSearchPaths);
+    for (QString& searchPath : searchPaths) {
+        searchPath = QDir::cleanPath(searchPath);
+    }
+    searchPaths.sort();
+    searchPaths.removeDuplicates();
+    return searchPaths;
+}
+
+} // anonymous namespace
+
+LV2Backend::LV2Backend(bool runOnWorkerThread, const QString& cacheFilePath)
+        : m_runOnWorkerThread(runOnWorkerThread),
+          m_cacheFilePath(cacheFilePath),
+          m_pWorld(nullptr) {
+    const QStringList searchPaths = defaultSearchPaths();
+    if (readCache(searchPaths)) {
+        return;
+    }
+    loadWorld();
     enumeratePlugins();
+    writeCache(searchPaths);
 }
 
 LV2Backend::~LV2Backend() {
+    m_registeredEffects.clear();
+    if (!m_pWorld) {
+        return;
+    }
     for (LilvNode* node : std::as_const(m_properties)) {
         lilv_node_free(node);
     }
     lilv_world_free(m_pWorld);
-    m_registeredEffects.clear();
+}
+
+void LV2Backend::loadWorld() const {
+    if (m_pWorld) {
+        return;
+    }
+    m_pWorld = lilv_world_new();
+    initializeProperties();
+    lilv_world_load_all(m_pWorld);
+
+    // Bind the manifests that have been read from the cache
+    const LilvPlugins* plugs = lilv_world_get_all_plugins(m_pWorld);
+    for (const auto& lv2Manifest : std::as_const(m_registeredEffects)) {
+        LilvNode* uri = lilv_new_uri(m_pWorld, lv2Manifest->id().toUtf8().constData());
+        const LilvPlugin* plug = lilv_plugins_get_by_uri(plugs, uri);
+        lilv_node_free(uri);
+        if (!plug) {
+            kLogger.warning() << "Plugin" << lv2Manifest->id()
+                              << "has been removed since the start";
+            continue;
+        }
+        lv2Manifest->bindPlugin(plug);
+    }
+}
+
+bool LV2Backend::readCache(const QStringList& defaultSearchPaths) {
+    if (m_cacheFilePath.isEmpty()) {
+        return false;
+    }
+    QFile file(m_cacheFilePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    QDataStream in(&file);
+    in.setVersion(kCacheStreamVersion);
+    qint32 version = 0;
+    QStringList searchPaths;
+    BundleTimestamps bundles;
+    in >> version;
+    if (version != kCacheVersion) {
+        return false;
+    }
+    in >> searchPaths >> bundles;
+    if (in.status() != QDataStream::Ok ||
+            scanBundles(mergeSearchPaths(searchPaths, defaultSearchPaths)) != bundles) {
+        kLogger.info() << "The installed plugins have changed";
+        return false;
+    }
+    qint32 count = 0;
+    in >> count;
+    QHash<QString, LV2EffectManifestPointer> registeredEffects;
+    for (qint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+        auto lv2Manifest = LV2EffectManifestPointer::create();
+        in >> *lv2Manifest;
+        lv2Manifest->setBackendType(getType());
+        registeredEffects.insert(lv2Manifest->id(), lv2Manifest);
+    }
+    if (in.status() != QDataStream::Ok) {
+        kLogger.warning() << "Failed to read the plugin cache" << m_cacheFilePath;
+        return false;
+    }
+    m_registeredEffects = registeredEffects;
+    return true;
+}
+
+void LV2Backend::writeCache(const QStringList& defaultSearchPaths) const {
+    if (m_cacheFilePath.isEmpty()) {
+        return;
+    }
+    QStringList bundleSearchPaths;
+    const LilvPlugins* plugs = lilv_world_get_all_plugins(m_pWorld);
+    LILV_FOREACH(plugins, i, plugs) {
+        const LilvNode* bundleUri = lilv_plugin_get_bundle_uri(lilv_plugins_get(plugs, i));
+        const QString bundlePath = QUrl(lilv_node_as_uri(bundleUri)).toLocalFile();
+        bundleSearchPaths.append(QFileInfo(QDir::cleanPath(bundlePath)).path());
+    }
+    const QStringList searchPaths = mergeSearchPaths(bundleSearchPaths, defaultSearchPaths);
+
+    QSaveFile file(m_cacheFilePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        kLogger.warning() << "Failed to write the plugin cache" << m_cacheFilePath;
+        return;
+    }
+    QDataStream out(&file);
+    out.setVersion(kCacheStreamVersion);
+    out << kCacheVersion
+        << searchPaths
+        << scanBundles(searchPaths)
+        << static_cast<qint32>(m_registeredEffects.size());
+    for (const auto& lv2Manifest : std::as_const(m_registeredEffects)) {
+        out << *lv2Manifest;
+    }
+    if (!file.commit()) {
+        kLogger.warning() << "Failed to write the plugin cache" << m_cacheFilePath;
+    }
 }
 
 void LV2Backend::enumeratePlugins() {
@@ -33,7 +224,7 @@ void LV2Backend::enumeratePlugins() {
     }
 }
 
-void LV2Backend::initializeProperties() {
+void LV2Backend::initializeProperties() const {
     m_properties["audio_port"] = lilv_new_uri(m_pWorld, LV2_CORE__AudioPort);
     m_properties["input_port"] = lilv_new_uri(m_pWorld, LV2_CORE__InputPort);
     m_properties["output_port"] = lilv_new_uri(m_pWorld, LV2_CORE__OutputPort);
@@ -92,7 +283,8 @@ std::unique_ptr<EffectProcessor> LV2Backend::createProcessor(
     VERIFY_OR_DEBUG_ASSERT(pLV2Manifest) {
         return nullptr;
     }
-    return std::make_unique<LV2EffectProcessor>(pLV2Manifest);
+    loadWorld();
+    return std::make_unique<LV2EffectProcessor>(pLV2Manifest, m_runOnWorkerThread);
 }
 
 LV2EffectManifestPointer LV2Backend::getLV2Manifest(const QString& effectId) const {
@@ -2,6 +2,8 @@
 
 #include <lilv/lilv.h>
 
+#include <QMap>
+
 #include "effects/backends/effectsbackend.h"
 #include "effects/backends/lv2/lv2manifest.h"
 #include "effects/defs.h"
@@ -9,7 +11,14 @@
 /// Refer to EffectsBackend for documentation
 class LV2Backend : public EffectsBackend {
   public:
-    LV2Backend();
+    /// With runOnWorkerThread every plugin instance runs on its own thread
+    /// one buffer behind the engine, see LV2EffectWorker.
+    ///
+    /// The manifests are stored in cacheFilePath. While the installed bundles
+    /// are unchanged the manifests are read from the cache and the lilv world
+    /// is only loaded when the first LV2 effect is instantiated.
+    explicit LV2Backend(bool runOnWorkerThread = false,
+            const QString& cacheFilePath = QString());
     virtual ~LV2Backend();
 
     EffectBackendType getType() const {
@@ -26,10 +35,20 @@ class LV2Backend : public EffectsBackend {
     bool canInstantiateEffect(const QString& effectId) const;
 
   private:
+    // Modification time of every bundle by path
+    typedef QMap<QString, qint64> BundleTimestamps;
+
+    void loadWorld() const;
     void enumeratePlugins();
-    void initializeProperties();
-    LilvWorld* m_pWorld;
-    QHash<QString, LilvNode*> m_properties;
+    void initializeProperties() const;
+    bool readCache(const QStringList& defaultSearchPaths);
+    void writeCache(const QStringList& defaultSearchPaths) const;
+
+    const bool m_runOnWorkerThread;
+    const QString m_cacheFilePath;
+    // Loaded on demand
+    mutable LilvWorld* m_pWorld;
+    mutable QHash<QString, LilvNode*> m_properties;
     QHash<QString, LV2EffectManifestPointer> m_registeredEffects;
 
     QString debugString() const {
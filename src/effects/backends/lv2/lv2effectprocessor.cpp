@@ -2,13 +2,98 @@
 
 #include "engine/effects/engineeffectparameter.h"
 #include "util/defs.h"
+#include "util/denormalsarezero.h"
+#include "util/math.h"
+#include "util/sample.h"
 
-LV2EffectProcessor::LV2EffectProcessor(LV2EffectManifestPointer pManifest)
+namespace {
+
+int latencyPortIndex(const LilvPlugin* pPlugin) {
+    if (!lilv_plugin_has_latency(pPlugin)) {
+        return -1;
+    }
+    return static_cast<int>(lilv_plugin_get_latency_port_index(pPlugin));
+}
+
+SINT latencyFrames(float latency) {
+    // Plugins report their latency after they have been run
+    return static_cast<SINT>(math_max(latency, 0.0f));
+}
+
+} // anonymous namespace
+
+LV2EffectWorker::LV2EffectWorker(LilvInstance* pInstance, int numParameters)
+        : m_pInstance(pInstance),
+          m_inputL(MAX_BUFFER_LEN),
+          m_inputR(MAX_BUFFER_LEN),
+          m_outputL(MAX_BUFFER_LEN),
+          m_outputR(MAX_BUFFER_LEN),
+          m_parameters(numParameters),
+          m_latency(0),
+          m_frames(0),
+          m_activate(false),
+          m_deactivate(false),
+          m_active(false),
+          m_busy(false),
+          m_quit(false) {
+    setObjectName(QStringLiteral("LV2EffectWorker"));
+}
+
+LV2EffectWorker::~LV2EffectWorker() {
+    m_quit.store(true);
+    m_semaRun.release();
+    wait();
+}
+
+void LV2EffectWorker::process(SINT framesPerBuffer, bool activate, bool deactivate) {
+    DEBUG_ASSERT(!isBusy());
+    m_frames = framesPerBuffer;
+    m_activate = activate;
+    m_deactivate = deactivate;
+    m_busy.store(true, std::memory_order_release);
+    m_semaRun.release();
+}
+
+void LV2EffectWorker::run() {
+    mixxx::enableDenormalsAreZero();
+    while (true) {
+        m_semaRun.acquire();
+        if (m_quit.load()) {
+            break;
+        }
+        if (m_activate && !m_active) {
+            lilv_instance_activate(m_pInstance);
+            m_active = true;
+        }
+        lilv_instance_run(m_pInstance, static_cast<uint32_t>(m_frames));
+        if (m_deactivate && m_active) {
+            lilv_instance_deactivate(m_pInstance);
+            m_active = false;
+        }
+        m_busy.store(false, std::memory_order_release);
+    }
+}
+
+void LV2EffectGroupState::startWorker(int numParameters) {
+    VERIFY_OR_DEBUG_ASSERT(m_pInstance && !m_pWorker) {
+        return;
+    }
+    previousInput.assign(MAX_BUFFER_LEN, 0);
+    m_pWorker = std::make_unique<LV2EffectWorker>(m_pInstance, numParameters);
+    m_pWorker->start(QThread::TimeCriticalPriority);
+}
+
+LV2EffectProcessor::LV2EffectProcessor(LV2EffectManifestPointer pManifest,
+        bool runOnWorkerThread)
         : m_pManifest(pManifest),
           m_LV2parameters(nullptr),
+          m_latency(0),
           m_pPlugin(pManifest->getPlugin()),
           m_audioPortIndices(pManifest->getAudioPortIndices()),
-          m_controlPortIndices(pManifest->getControlPortIndices()) {
+          m_controlPortIndices(pManifest->getControlPortIndices()),
+          m_latencyPortIndex(latencyPortIndex(m_pPlugin)),
+          m_runOnWorkerThread(runOnWorkerThread),
+          m_groupDelayFrames(0) {
     m_inputL = new float[MAX_BUFFER_LEN];
     m_inputR = new float[MAX_BUFFER_LEN];
     m_outputL = new float[MAX_BUFFER_LEN];
@@ -48,6 +133,11 @@ void LV2EffectProcessor::processChannel(
         const GroupFeatureState& groupFeatures) {
     Q_UNUSED(groupFeatures);
 
+    if (channelState->worker()) {
+        processChannelOnWorker(channelState, pInput, pOutput, engineParameters, enableState);
+        return;
+    }
+
     for (int i = 0; i < m_engineEffectParameters.size(); i++) {
         m_LV2parameters[i] = static_cast<float>(m_engineEffectParameters[i]->value());
     }
@@ -76,6 +166,62 @@ void LV2EffectProcessor::processChannel(
     if (enableState == EffectEnableState::Disabling) {
         lilv_instance_deactivate(instance);
     }
+
+    m_groupDelayFrames = latencyFrames(m_latency);
+}
+
+void LV2EffectProcessor::processChannelOnWorker(
+        LV2EffectGroupState* channelState,
+        const CSAMPLE* pInput,
+        CSAMPLE* pOutput,
+        const mixxx::EngineParameters& engineParameters,
+        const EffectEnableState enableState) {
+    LV2EffectWorker* pWorker = channelState->worker();
+    const SINT framesPerBuffer = engineParameters.framesPerBuffer();
+    const SINT numSamples = engineParameters.samplesPerBuffer();
+
+    if (enableState == EffectEnableState::Enabling) {
+        channelState->activatePending = true;
+        channelState->deactivatePending = false;
+    } else if (enableState == EffectEnableState::Disabling) {
+        channelState->deactivatePending = true;
+    }
+
+    if (pWorker->isBusy()) {
+        // The plugin has not finished the previous buffer in time. Pass
+        // the previous input through to keep the latency and skip the
+        // current buffer.
+        SampleUtil::copy(pOutput, channelState->previousInput.data(), numSamples);
+    } else {
+        // The output of the previous buffer, which might have been shorter
+        const SINT outputFrames = math_min(pWorker->outputFrames(), framesPerBuffer);
+        const float* pOutputL = pWorker->outputL();
+        const float* pOutputR = pWorker->outputR();
+        for (SINT i = 0; i < outputFrames; ++i) {
+            pOutput[i * 2] = pOutputL[i];
+            pOutput[i * 2 + 1] = pOutputR[i];
+        }
+        SampleUtil::clear(pOutput + outputFrames * 2, numSamples - outputFrames * 2);
+        m_groupDelayFrames = framesPerBuffer + latencyFrames(*pWorker->latency());
+
+        float* pParameters = pWorker->parameters();
+        for (int i = 0; i < m_engineEffectParameters.size(); i++) {
+            pParameters[i] = static_cast<float>(m_engineEffectParameters[i]->value());
+        }
+        float* pInputL = pWorker->inputL();
+        float* pInputR = pWorker->inputR();
+        for (SINT i = 0; i < framesPerBuffer; ++i) {
+            pInputL[i] = pInput[i * 2];
+            pInputR[i] = pInput[i * 2 + 1];
+        }
+        pWorker->process(framesPerBuffer,
+                channelState->activatePending,
+                channelState->deactivatePending);
+        channelState->activatePending = false;
+        channelState->deactivatePending = false;
+    }
+
+    SampleUtil::copy(channelState->previousInput.data(), pInput, numSamples);
 }
 
 LV2EffectGroupState* LV2EffectProcessor::createSpecificState(
@@ -91,19 +237,42 @@ LV2EffectGroupState* LV2EffectProcessor::createSpecificState(
     }
 
     if (pInstance) {
+        float* pParameters = m_LV2parameters;
+        float* pInputL = m_inputL;
+        float* pInputR = m_inputR;
+        float* pOutputL = m_outputL;
+        float* pOutputR = m_outputR;
+        float* pLatency = &m_latency;
+        if (m_runOnWorkerThread) {
+            // Every instance needs its own ports, because the instances of
+            // all states run concurrently
+            pState->startWorker(m_engineEffectParameters.size());
+            LV2EffectWorker* pWorker = pState->worker();
+            pParameters = pWorker->parameters();
+            pInputL = pWorker->inputL();
+            pInputR = pWorker->inputR();
+            pOutputL = pWorker->outputL();
+            pOutputR = pWorker->outputR();
+            pLatency = pWorker->latency();
+        }
+
         for (int i = 0; i < m_engineEffectParameters.size(); i++) {
-            m_LV2parameters[i] = static_cast<float>(m_engineEffectParameters[i]->value());
+            pParameters[i] = static_cast<float>(m_engineEffectParameters[i]->value());
             lilv_instance_connect_port(pInstance,
                     m_controlPortIndices[i],
-                    &m_LV2parameters[i]);
+                    &pParameters[i]);
         }
 
         // We assume the audio ports are in the following order:
         // input_left, input_right, output_left, output_right
-        lilv_instance_connect_port(pInstance, m_audioPortIndices[0], m_inputL);
-        lilv_instance_connect_port(pInstance, m_audioPortIndices[1], m_inputR);
-        lilv_instance_connect_port(pInstance, m_audioPortIndices[2], m_outputL);
-        lilv_instance_connect_port(pInstance, m_audioPortIndices[3], m_outputR);
+        lilv_instance_connect_port(pInstance, m_audioPortIndices[0], pInputL);
+        lilv_instance_connect_port(pInstance, m_audioPortIndices[1], pInputR);
+        lilv_instance_connect_port(pInstance, m_audioPortIndices[2], pOutputL);
+        lilv_instance_connect_port(pInstance, m_audioPortIndices[3], pOutputR);
+
+        if (m_latencyPortIndex >= 0) {
+            lilv_instance_connect_port(pInstance, m_latencyPortIndex, pLatency);
+        }
     }
     return pState;
 };
@@ -2,20 +2,95 @@
 
 #include <lilv/lilv.h>
 
+#include <QSemaphore>
+#include <QThread>
+#include <atomic>
+#include <memory>
+#include <vector>
+
 #include "effects/backends/effectprocessor.h"
 #include "effects/backends/lv2/lv2manifest.h"
 #include "effects/defs.h"
 #include "engine/engine.h"
 
+/// Runs an LV2 plugin instance on a dedicated thread, one buffer behind the
+/// audio callback. The callback hands over a buffer with process() and
+/// collects the output one callback later, so that a slow plugin can not
+/// make the callback miss its deadline.
+class LV2EffectWorker final : public QThread {
+  public:
+    LV2EffectWorker(LilvInstance* pInstance, int numParameters);
+    ~LV2EffectWorker() override;
+
+    float* inputL() {
+        return m_inputL.data();
+    }
+    float* inputR() {
+        return m_inputR.data();
+    }
+    float* outputL() {
+        return m_outputL.data();
+    }
+    float* outputR() {
+        return m_outputR.data();
+    }
+    float* parameters() {
+        return m_parameters.data();
+    }
+    float* latency() {
+        return &m_latency;
+    }
+
+    /// The callback must not touch the buffers while busy
+    bool isBusy() const {
+        return m_busy.load(std::memory_order_acquire);
+    }
+
+    /// The number of frames in the output buffers
+    SINT outputFrames() const {
+        return m_frames;
+    }
+
+    /// Starts processing the input buffers. Activating and deactivating
+    /// the instance is done on the worker thread, because it must not
+    /// happen concurrently with running it.
+    void process(SINT framesPerBuffer, bool activate, bool deactivate);
+
+  protected:
+    void run() override;
+
+  private:
+    LilvInstance* const m_pInstance;
+    std::vector<float> m_inputL;
+    std::vector<float> m_inputR;
+    std::vector<float> m_outputL;
+    std::vector<float> m_outputR;
+    std::vector<float> m_parameters;
+    float m_latency;
+
+    SINT m_frames;
+    bool m_activate;
+    bool m_deactivate;
+    bool m_active;
+
+    QSemaphore m_semaRun;
+    std::atomic<bool> m_busy;
+    std::atomic<bool> m_quit;
+};
+
 // Refer to EffectProcessor for documentation
 class LV2EffectGroupState final : public EffectState {
   public:
     LV2EffectGroupState(const mixxx::EngineParameters& engineParameters)
             : EffectState(engineParameters),
+              activatePending(false),
+              deactivatePending(false),
               m_pInstance(nullptr) {
     }
 
     ~LV2EffectGroupState() override {
+        // The worker must not run the instance anymore
+        m_pWorker.reset();
         if (m_pInstance) {
             lilv_instance_deactivate(m_pInstance);
             lilv_instance_free(m_pInstance);
@@ -31,13 +106,28 @@ class LV2EffectGroupState final : public EffectState {
         return m_pInstance;
     }
 
+    /// nullptr unless the plugin runs on a worker thread
+    LV2EffectWorker* worker() const {
+        return m_pWorker.get();
+    }
+
+    void startWorker(int numParameters);
+
+    // Deferred while the worker is busy
+    bool activatePending;
+    bool deactivatePending;
+    // The interleaved input of the previous buffer that is passed through
+    // if the worker has not finished in time
+    std::vector<CSAMPLE> previousInput;
+
   private:
     LilvInstance* m_pInstance;
+    std::unique_ptr<LV2EffectWorker> m_pWorker;
 };
 
 class LV2EffectProcessor final : public EffectProcessorImpl<LV2EffectGroupState> {
   public:
-    LV2EffectProcessor(LV2EffectManifestPointer pManifest);
+    LV2EffectProcessor(LV2EffectManifestPointer pManifest, bool runOnWorkerThread);
     ~LV2EffectProcessor() override;
 
     void loadEngineEffectParameters(
@@ -51,10 +141,23 @@ class LV2EffectProcessor final : public EffectProcessorImpl<LV2EffectGroupState>
             const EffectEnableState enableState,
             const GroupFeatureState& groupFeatures) override;
 
+    /// The latency that is reported by the plugin plus one buffer if the
+    /// plugin runs on a worker thread
+    SINT getGroupDelayFrames() override {
+        return m_groupDelayFrames;
+    }
+
   private:
     LV2EffectGroupState* createSpecificState(
             const mixxx::EngineParameters& engineParameters) override;
 
+    void processChannelOnWorker(
+            LV2EffectGroupState* channelState,
+            const CSAMPLE* pInput,
+            CSAMPLE* pOutput,
+            const mixxx::EngineParameters& engineParameters,
+            const EffectEnableState enableState);
+
     LV2EffectManifestPointer m_pManifest;
     QList<EngineEffectParameterPointer> m_engineEffectParameters;
     float* m_inputL;
@@ -62,7 +165,12 @@ class LV2EffectProcessor final : public EffectProcessorImpl<LV2EffectGroupState>
     float* m_outputL;
     float* m_outputR;
     float* m_LV2parameters;
+    float m_latency;
     const LilvPlugin* m_pPlugin;
     const QList<int> m_audioPortIndices;
     const QList<int> m_controlPortIndices;
+    // -1 if the plugin does not report its latency
+    const int m_latencyPortIndex;
+    const bool m_runOnWorkerThread;
+    SINT m_groupDelayFrames;
 };
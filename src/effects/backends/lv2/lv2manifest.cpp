@@ -7,6 +7,12 @@ namespace {
 constexpr bool lv2ParamDebug = true;
 } // namespace
 
+LV2Manifest::LV2Manifest()
+        : EffectManifest(),
+          m_pLV2plugin(nullptr),
+          m_status(AVAILABLE) {
+}
+
 LV2Manifest::LV2Manifest(LilvWorld* world,
         const LilvPlugin* plug,
         QHash<QString, LilvNode*>& properties)
@@ -200,6 +206,10 @@ const LilvPlugin* LV2Manifest::getPlugin() {
     return m_pLV2plugin;
 }
 
+void LV2Manifest::bindPlugin(const LilvPlugin* plug) {
+    m_pLV2plugin = plug;
+}
+
 LV2Manifest::Status LV2Manifest::getStatus() {
     return m_status;
 }
@@ -224,3 +234,72 @@ void LV2Manifest::buildEnumerationOptions(const LilvPort* port,
         lilv_scale_points_free(options);
     }
 }
+
+QDataStream& operator<<(QDataStream& out, const LV2Manifest& manifest) {
+    out << manifest.id()
+        << manifest.name()
+        << manifest.shortName()
+        << manifest.author()
+        << manifest.version()
+        << manifest.description()
+        << static_cast<qint32>(manifest.parameters().size());
+    for (const auto& pParameter : manifest.parameters()) {
+        out << pParameter->id()
+            << pParameter->name()
+            << pParameter->shortName()
+            << pParameter->description()
+            << static_cast<qint32>(pParameter->unitsHint())
+            << static_cast<qint32>(pParameter->valueScaler())
+            << pParameter->getMinimum()
+            << pParameter->getDefault()
+            << pParameter->getMaximum()
+            << pParameter->getSteps();
+    }
+    out << manifest.audioPortIndices
+        << manifest.controlPortIndices
+        << static_cast<qint32>(manifest.m_status);
+    return out;
+}
+
+QDataStream& operator>>(QDataStream& in, LV2Manifest& manifest) {
+    QString id;
+    QString name;
+    QString shortName;
+    QString author;
+    QString version;
+    QString description;
+    qint32 parameterCount = 0;
+    in >> id >> name >> shortName >> author >> version >> description >> parameterCount;
+    manifest.setId(id);
+    manifest.setName(name);
+    manifest.setShortName(shortName);
+    manifest.setAuthor(author);
+    manifest.setVersion(version);
+    manifest.setDescription(description);
+    for (qint32 i = 0; i < parameterCount && in.status() == QDataStream::Ok; ++i) {
+        qint32 unitsHint = 0;
+        qint32 valueScaler = 0;
+        double minimum = 0;
+        double defaultValue = 0;
+        double maximum = 0;
+        QList<QPair<QString, double>> steps;
+        in >> id >> name >> shortName >> description >> unitsHint >> valueScaler >>
+                minimum >> defaultValue >> maximum >> steps;
+        EffectManifestParameterPointer pParameter = manifest.addParameter();
+        pParameter->setId(id);
+        pParameter->setName(name);
+        pParameter->setShortName(shortName);
+        pParameter->setDescription(description);
+        pParameter->setUnitsHint(static_cast<EffectManifestParameter::UnitsHint>(unitsHint));
+        pParameter->setValueScaler(
+                static_cast<EffectManifestParameter::ValueScaler>(valueScaler));
+        pParameter->setRange(minimum, defaultValue, maximum);
+        for (const auto& step : std::as_const(steps)) {
+            pParameter->appendStep(step);
+        }
+    }
+    qint32 status = LV2Manifest::AVAILABLE;
+    in >> manifest.audioPortIndices >> manifest.controlPortIndices >> status;
+    manifest.m_status = static_cast<LV2Manifest::Status>(status);
+    return in;
+}
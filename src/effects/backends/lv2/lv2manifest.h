@@ -2,6 +2,7 @@
 
 #include <lilv/lilv.h>
 
+#include <QDataStream>
 #include <QSharedPointer>
 #include <vector>
 
@@ -16,14 +17,22 @@ class LV2Manifest : public EffectManifest {
         HAS_REQUIRED_FEATURES
     };
 
+    /// Creates a manifest that is read from the plugin cache of LV2Backend.
+    /// The plugin is bound when the lilv world is loaded.
+    LV2Manifest();
     LV2Manifest(LilvWorld* world, const LilvPlugin* plug, QHash<QString, LilvNode*>& properties);
 
     QList<int> getAudioPortIndices();
     QList<int> getControlPortIndices();
+    /// nullptr until bindPlugin() has been called for a cached manifest
     const LilvPlugin* getPlugin();
+    void bindPlugin(const LilvPlugin* plug);
     bool isValid();
     Status getStatus();
 
+    friend QDataStream& operator<<(QDataStream& out, const LV2Manifest& manifest);
+    friend QDataStream& operator>>(QDataStream& in, LV2Manifest& manifest);
+
   private:
     void buildEnumerationOptions(const LilvPort* port,
             EffectManifestParameterPointer param);
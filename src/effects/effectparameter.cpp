@@ -2,16 +2,18 @@
 
 #include <QtDebug>
 
-#include "effects/effectsmessenger.h"
 #include "effects/presets/effectparameterpreset.h"
+#include "engine/effects/engineeffect.h"
+#include "engine/effects/engineeffectparameter.h"
 
 EffectParameter::EffectParameter(EngineEffect* pEngineEffect,
-        EffectsMessengerPointer pEffectsMessenger,
         EffectManifestParameterPointer pParameterManifest,
         const EffectParameterPreset& preset)
-        : m_pEngineEffect(pEngineEffect),
-          m_pMessenger(pEffectsMessenger),
+        : m_pEngineParameter(pEngineEffect
+                          ? pEngineEffect->getParameter(pParameterManifest->index())
+                          : EngineEffectParameterPointer()),
           m_pParameterManifest(pParameterManifest) {
+    DEBUG_ASSERT(!pEngineEffect || m_pEngineParameter);
     if (preset.isNull()) {
         setValue(pParameterManifest->getDefault());
     } else {
@@ -65,13 +67,11 @@ void EffectParameter::setValue(double value) {
 }
 
 void EffectParameter::updateEngineState() {
-    if (!m_pEngineEffect) {
+    if (!m_pEngineParameter) {
         return;
     }
-    EffectsRequest* pRequest = new EffectsRequest();
-    pRequest->type = EffectsRequest::SET_PARAMETER_PARAMETERS;
-    pRequest->pTargetEffect = m_pEngineEffect;
-    pRequest->SetParameterParameters.iParameter = m_pParameterManifest->index();
-    pRequest->value = m_value;
-    m_pMessenger->writeRequest(pRequest);
+    // The value is picked up by the engine with the next callback. Sending
+    // an EffectsRequest for every change would allocate a message each time
+    // a knob is turned.
+    m_pEngineParameter->setValue(m_value);
 }
@@ -21,7 +21,6 @@ class EffectParameterPreset;
 class EffectParameter {
   public:
     EffectParameter(EngineEffect* pEngineEffect,
-            EffectsMessengerPointer pEffectsMessenger,
             EffectManifestParameterPointer pParameterManifest,
             const EffectParameterPreset& preset);
     virtual ~EffectParameter();
@@ -56,8 +55,8 @@ class EffectParameter {
             const double& maximum);
     bool clampValue();
 
-    EngineEffect* m_pEngineEffect;
-    EffectsMessengerPointer m_pMessenger;
+    // Shared with the EngineEffect, which might be deleted first
+    EngineEffectParameterPointer m_pEngineParameter;
     EffectManifestParameterPointer m_pParameterManifest;
     double m_value;
     // Hidden parameters cannot be linked to the metaknob, but EffectParameter
@@ -139,7 +139,7 @@ EffectSlot::~EffectSlot() {
     unloadEffect();
 }
 
-void EffectSlot::addToEngine() {
+void EffectSlot::createEngineEffect() {
     VERIFY_OR_DEBUG_ASSERT(!isLoaded()) {
         return;
     }
@@ -154,6 +154,18 @@ void EffectSlot::addToEngine() {
             m_pChain->getActiveChannels(),
             m_pEffectsManager->registeredInputChannels(),
             m_pEffectsManager->registeredOutputChannels());
+}
+
+void EffectSlot::addToEngine() {
+    VERIFY_OR_DEBUG_ASSERT(m_pEngineEffect) {
+        return;
+    }
+
+    // The engine does not know the effect yet, so the initial state is set
+    // directly instead of sending a SET_EFFECT_PARAMETERS request after it.
+    // The parameter values have been stored in the EngineEffectParameters
+    // by the EffectParameters.
+    m_pEngineEffect->setEnabled(m_pControlEnabled->toBool());
 
     EffectsRequest* request = new EffectsRequest();
     request->type = EffectsRequest::ADD_EFFECT_TO_CHAIN;
@@ -291,7 +303,7 @@ void EffectSlot::loadEffectInner(const EffectManifestPointer pManifest,
     }
 
     m_pManifest = pManifest;
-    addToEngine();
+    createEngineEffect();
 
     // Create EffectParameters. Every parameter listed in the manifest must have
     // an EffectParameter created, regardless of whether it is loaded in a slot.
@@ -308,7 +320,6 @@ void EffectSlot::loadEffectInner(const EffectManifestPointer pManifest,
         }
         EffectParameterPointer pParameter(new EffectParameter(
                 m_pEngineEffect,
-                m_pMessenger,
                 pManifestParameter,
                 parameterPreset));
         m_allParameters[pManifestParameter->parameterType()].append(pParameter);
@@ -364,8 +375,8 @@ void EffectSlot::loadEffectInner(const EffectManifestPointer pManifest,
     // ControlObjects are 1-indexed
     m_pControlLoadedEffect->setAndConfirm(m_pVisibleEffects->indexOf(pManifest) + 1);
 
+    addToEngine();
     emit effectChanged();
-    updateEngineState();
 }
 
 void EffectSlot::unloadEffect() {
@@ -148,6 +148,8 @@ class EffectSlot : public QObject {
         return QString("EffectSlot(%1)").arg(m_group);
     }
 
+    void createEngineEffect();
+    /// Adds the EngineEffect with its initial state in a single request
     void addToEngine();
     void removeFromEngine();
 
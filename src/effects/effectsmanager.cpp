@@ -31,7 +31,7 @@ EffectsManager::EffectsManager(
           m_initializedFromEffectsXml(false) {
     qRegisterMetaType<EffectChainMixMode>("EffectChainMixMode");
 
-    m_pBackendManager = EffectsBackendManagerPointer(new EffectsBackendManager());
+    m_pBackendManager = EffectsBackendManagerPointer(new EffectsBackendManager(pConfig));
 
     auto [pRequestPipe, pResponsePipe] = TwoWayMessagePipe<EffectsRequest*,
             EffectsResponse>::makeTwoWayMessagePipe(kEffectMessagePipeFifoSize,
@@ -4,6 +4,7 @@
 #include <QFileDialog>
 #include <QInputDialog>
 #include <QMessageBox>
+#include <QtConcurrentRun>
 
 #include "effects/backends/builtin/biquadfullkilleqeffect.h"
 #include "effects/backends/builtin/filtereffect.h"
@@ -38,6 +39,21 @@ EffectChainPresetPointer loadPresetFromFile(const QString& filePath) {
     return pEffectChainPreset;
 }
 
+QList<EffectChainPresetPointer> loadPresetsFromDirectory(const QString& directoryPath) {
+    QList<EffectChainPresetPointer> presets;
+    QDir presetsDir(directoryPath);
+    presetsDir.setFilter(QDir::Files | QDir::Readable);
+    const QStringList fileList = presetsDir.entryList();
+    for (const auto& filePath : fileList) {
+        EffectChainPresetPointer pEffectChainPreset = loadPresetFromFile(
+                directoryPath + kFolderDelimiter + filePath);
+        if (pEffectChainPreset && !pEffectChainPreset->isEmpty()) {
+            presets.append(pEffectChainPreset);
+        }
+    }
+    return presets;
+}
+
 EffectChainPresetPointer createEmptyReadOnlyChainPreset() {
     EffectManifestPointer pEmptyManifest(new EffectManifest());
     pEmptyManifest->setName(kNoEffectString);
@@ -56,7 +72,12 @@ EffectChainPresetPointer createEmptyReadOnlyChainPreset() {
 EffectChainPresetManager::EffectChainPresetManager(UserSettingsPointer pConfig,
         EffectsBackendManagerPointer pBackendManager)
         : m_pConfig(pConfig),
-          m_pBackendManager(pBackendManager) {
+          m_pBackendManager(pBackendManager),
+          m_userPresetsPending(true) {
+    // Parsing the preset files takes a while with many user presets. They
+    // are not needed before the effects are set up after the decks.
+    m_userPresetsFuture = QtConcurrent::run(loadPresetsFromDirectory,
+            m_pConfig->getSettingsPath() + kEffectChainPresetDirectory);
 }
 
 int EffectChainPresetManager::presetIndex(const QString& presetName) const {
@@ -521,25 +542,29 @@ void EffectChainPresetManager::updatePreset(EffectChainPointer pChainSlot) {
 void EffectChainPresetManager::importUserPresets() {
     QString savedPresetsPath(
             m_pConfig->getSettingsPath() + kEffectChainPresetDirectory);
+    QList<EffectChainPresetPointer> presets;
+    bool presetsLoaded = false;
+    if (m_userPresetsPending) {
+        m_userPresetsPending = false;
+        presets = m_userPresetsFuture.result();
+        presetsLoaded = true;
+    }
     QDir savedPresetsDir(savedPresetsPath);
     if (!savedPresetsDir.exists()) {
         savedPresetsDir.mkpath(savedPresetsPath);
         return;
     }
-    savedPresetsDir.setFilter(QDir::Files | QDir::Readable);
-    const QStringList fileList = savedPresetsDir.entryList();
-    for (const auto& filePath : fileList) {
-        EffectChainPresetPointer pEffectChainPreset = loadPresetFromFile(
-                savedPresetsPath + kFolderDelimiter + filePath);
-        if (pEffectChainPreset && !pEffectChainPreset->isEmpty()) {
-            // Don't allow '---' because that's the name of the internal empty preset
-            if (pEffectChainPreset->name() == kNoEffectString) {
-                pEffectChainPreset->setName(pEffectChainPreset->name() +
-                        QLatin1String(" (") + tr("imported") + QLatin1String(")"));
-            }
-            m_effectChainPresets.insert(
-                    pEffectChainPreset->name(), pEffectChainPreset);
+    if (!presetsLoaded) {
+        presets = loadPresetsFromDirectory(savedPresetsPath);
+    }
+    for (const auto& pEffectChainPreset : std::as_const(presets)) {
+        // Don't allow '---' because that's the name of the internal empty preset
+        if (pEffectChainPreset->name() == kNoEffectString) {
+            pEffectChainPreset->setName(pEffectChainPreset->name() +
+                    QLatin1String(" (") + tr("imported") + QLatin1String(")"));
         }
+        m_effectChainPresets.insert(
+                pEffectChainPreset->name(), pEffectChainPreset);
     }
 }
 
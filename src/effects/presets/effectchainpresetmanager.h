@@ -1,5 +1,6 @@
 #pragma once
 
+#include <QFuture>
 #include <QHash>
 #include <QList>
 
@@ -103,6 +104,11 @@ class EffectChainPresetManager : public QObject {
 
     UserSettingsPointer m_pConfig;
     EffectsBackendManagerPointer m_pBackendManager;
+
+    // The user presets are parsed in the background from construction until
+    // they are imported for the first time
+    QFuture<QList<EffectChainPresetPointer>> m_userPresetsFuture;
+    bool m_userPresetsPending;
 };
 
 typedef QSharedPointer<EffectChainPresetManager> EffectChainPresetManagerPointer;
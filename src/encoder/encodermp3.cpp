@@ -8,6 +8,7 @@
 #include "audio/types.h"
 #include "encoder/encodercallback.h"
 #include "encoder/encodermp3settings.h"
+#include "util/sample.h"
 
 // Automatic thresholds for switching the encoder to mono
 // They have been chosen by testing and to keep the same number
@@ -153,10 +154,8 @@ void EncoderMp3::encodeBuffer(const CSAMPLE *samples, const int size) {
 
     // Deinterleave samples. We use normalized floats in the engine [-1.0, 1.0]
     // but LAME expects samples in the range [SHRT_MIN, SHRT_MAX].
-    for (int i = 0; i < size/2; ++i) {
-        m_bufferIn[0][i] = samples[i*2] * SHRT_MAX;
-        m_bufferIn[1][i] = samples[i*2+1] * SHRT_MAX;
-    }
+    SampleUtil::deinterleaveBufferWithGain(
+            m_bufferIn[0], m_bufferIn[1], samples, SHRT_MAX, size / 2);
 
     rc = lame_encode_buffer_float(m_lameFlags, m_bufferIn[0], m_bufferIn[1],
                                   size/2, m_bufferOut, m_bufferOutSize);
@@ -4,33 +4,6 @@
 
 #include "encoder/encoderflacsettings.h"
 
-namespace {
-constexpr SINT kEncBufferSize = 8192; // used inside libsndfile for flac
-constexpr CSAMPLE_GAIN kFloatToIntConversionFactor = INT_MIN * -1.0f;
-
-//static
-void convertFloat32ToIntFormat(int* pDest, const CSAMPLE* pSrc, SINT numSamples, int format) {
-    if (format & SF_FORMAT_PCM_16) {
-        // note: LOOP VECTORIZED"
-        for (SINT i = 0; i < numSamples; ++i) {
-            pDest[i] = static_cast<int>(math_clamp(pSrc[i] * kFloatToIntConversionFactor,
-                    static_cast<CSAMPLE>(static_cast<int>(INT_MIN & 0xFFFF0000)),
-                    static_cast<CSAMPLE>(static_cast<int>(INT_MAX & 0xFFFF0000))));
-        }
-    } else if (format & SF_FORMAT_PCM_24) {
-        // note: LOOP VECTORIZED"
-        for (SINT i = 0; i < numSamples; ++i) {
-            pDest[i] = static_cast<int>(math_clamp(pSrc[i] * kFloatToIntConversionFactor,
-                    static_cast<CSAMPLE>(static_cast<int>(INT_MIN & 0xFFFFFF00)),
-                    static_cast<CSAMPLE>(static_cast<int>(INT_MAX & 0xFFFFFF00))));
-        }
-    } else {
-        DEBUG_ASSERT(!"Not implemented");
-    }
-}
-
-} // namespace
-
 EncoderSndfileFlac::EncoderSndfileFlac(EncoderCallback* pCallback)
         : EncoderWave(pCallback),
           m_compression(0) {
@@ -59,21 +32,11 @@ void EncoderSndfileFlac::setEncoderSettings(const EncoderSettings& settings)
 }
 
 void EncoderSndfileFlac::encodeBuffer(const CSAMPLE* pBuffer, const int iBufferSize) {
-    if (m_pClampBuffer) {
-        SINT numSamplesLeft = iBufferSize;
-        while (numSamplesLeft > 0) {
-            const SINT numSamplesToWrite = math_min(numSamplesLeft, kEncBufferSize);
-            convertFloat32ToIntFormat(m_pClampBuffer.get(),
-                    pBuffer,
-                    numSamplesToWrite,
-                    m_sfInfo.format);
-            sf_write_int(m_pSndfile, m_pClampBuffer.get(), numSamplesToWrite);
-            pBuffer += numSamplesToWrite;
-            numSamplesLeft -= numSamplesToWrite;
-        }
-    } else {
-        sf_write_float(m_pSndfile, pBuffer, iBufferSize);
-    }
+    // The header of FLAC streams must not be rewritten while encoding.
+    // libsndfile does not clamp correctly in all versions, e.g. 1.0.28
+    // https://github.com/mixxxdj/mixxx/issues/10318, but the samples are
+    // converted and clamped by SampleUtil anyway.
+    writeSamples(pBuffer, iBufferSize);
 }
 
 void EncoderSndfileFlac::initStream() {
@@ -82,13 +45,4 @@ void EncoderSndfileFlac::initStream() {
     // Tell the compression setting to use.
     sf_command(m_pSndfile, SFC_SET_COMPRESSION_LEVEL, &m_compression, sizeof(double));
 #endif //SFC_SUPPORTS_SET_COMPRESSION_LEVEL
-
-    // Version 1.0.28 suffers broken clamping https://github.com/mixxxdj/mixxx/issues/10318
-    // We receive "libsndfile-1.0.28" on Ubuntu Focal 20.04 LTS/Grovy 20.10
-    // Older versions are not expected. All newer version have a working internal clamping
-    const char* sf_version = sf_version_string();
-    if (strstr(sf_version, "-1.0.28") != nullptr) {
-        m_pClampBuffer = std::make_unique<int[]>(kEncBufferSize);
-        sf_command(m_pSndfile, SFC_SET_CLIPPING, nullptr, SF_FALSE);
-    }
 }
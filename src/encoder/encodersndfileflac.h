@@ -25,5 +25,4 @@ class EncoderSndfileFlac : public EncoderWave {
     void initStream() override;
   private:
     double m_compression;
-    std::unique_ptr<int[]> m_pClampBuffer;
 };
@@ -6,6 +6,17 @@
 #include "encoder/encodercallback.h"
 #include "encoder/encoderwavesettings.h"
 #include "recording/defs_recording.h"
+#include "util/math.h"
+
+namespace {
+
+// A crash loses at most this much audio, it is still in the file but
+// not covered by the header.
+constexpr int kHeaderUpdateSeconds = 10;
+
+constexpr SINT kIntBufferSize = 8192;
+
+} // namespace
 
 // The virtual file context must return the length of the virtual file in bytes.
 static sf_count_t  sf_f_get_filelen (void *user_data)
@@ -25,14 +36,13 @@ static sf_count_t  sf_f_seek (sf_count_t offset, int whence, void *user_data)
     EncoderCallback* pCallback = static_cast<EncoderCallback*>(user_data);
     if (whence == SEEK_SET) {
         new_offset = offset;
-        pCallback->seek(static_cast<int>(new_offset));
     } else if (whence == SEEK_CUR) {
-        new_offset = pCallback->tell()+offset;
-        pCallback->seek(static_cast<int>(new_offset));
+        new_offset = pCallback->tell() + offset;
     } else {
-        new_offset =  pCallback->filelen()-offset;
-        pCallback->seek(static_cast<int>(new_offset));
+        // offset is relative to the end and usually negative
+        new_offset = pCallback->filelen() + offset;
     }
+    pCallback->seek(new_offset);
     return new_offset;
 }
 // The virtual file context must copy ("read") "count" bytes into the buffer
@@ -67,7 +77,10 @@ static sf_count_t  sf_f_tell (void *user_data)
 
 EncoderWave::EncoderWave(EncoderCallback* pCallback)
         : m_pCallback(pCallback),
-          m_pSndfile(nullptr) {
+          m_pSndfile(nullptr),
+          m_headerUpdateSamples(0),
+          m_samplesSinceHeaderUpdate(0),
+          m_intBits(0) {
     m_sfInfo.frames = 0;
     m_sfInfo.samplerate = 0;
     m_sfInfo.channels = 0;
@@ -138,7 +151,41 @@ void EncoderWave::flush() {
 
 
 void EncoderWave::encodeBuffer(const CSAMPLE *pBuffer, const int iBufferSize) {
-    sf_write_float(m_pSndfile, pBuffer, iBufferSize);
+    writeSamples(pBuffer, iBufferSize);
+    updateHeaderPeriodically(iBufferSize);
+}
+
+void EncoderWave::writeSamples(const CSAMPLE* pBuffer, int iBufferSize) {
+    if (!m_pIntBuffer) {
+        sf_write_float(m_pSndfile, pBuffer, iBufferSize);
+        return;
+    }
+    // The quantization noise of 24 bit is far below audibility
+    SampleUtil::TpdfDither* pDither = m_intBits <= 16 ? &m_dither : nullptr;
+    SINT numSamplesLeft = iBufferSize;
+    while (numSamplesLeft > 0) {
+        const SINT numSamplesToWrite = math_min(numSamplesLeft, kIntBufferSize);
+        SampleUtil::convertFloat32ToS32(m_pIntBuffer.get(),
+                pBuffer,
+                numSamplesToWrite,
+                m_intBits,
+                pDither);
+        sf_write_int(m_pSndfile, m_pIntBuffer.get(), numSamplesToWrite);
+        pBuffer += numSamplesToWrite;
+        numSamplesLeft -= numSamplesToWrite;
+    }
+}
+
+void EncoderWave::updateHeaderPeriodically(int iBufferSize) {
+    m_samplesSinceHeaderUpdate += iBufferSize;
+    if (m_headerUpdateSamples <= 0 ||
+            m_samplesSinceHeaderUpdate < m_headerUpdateSamples) {
+        return;
+    }
+    m_samplesSinceHeaderUpdate = 0;
+    // This seeks back to the header and to the end again, which is cheap
+    // compared to the audio written in the meantime.
+    sf_command(m_pSndfile, SFC_UPDATE_HEADER_NOW, nullptr, 0);
 }
 
 /* Originally called from enginebroadcast.cpp to update metadata information
@@ -203,6 +250,25 @@ int EncoderWave::initEncoder(mixxx::audio::SampleRate sampleRate, QString* pUser
     m_sfInfo.frames = 0;
     m_sfInfo.sections = 0;
     m_sfInfo.seekable = 0;
+    m_headerUpdateSamples = static_cast<SINT>(kHeaderUpdateSeconds) *
+            sampleRate.value() * m_sfInfo.channels;
+    m_samplesSinceHeaderUpdate = 0;
+    switch (m_sfInfo.format & SF_FORMAT_SUBMASK) {
+    case SF_FORMAT_PCM_16:
+        m_intBits = 16;
+        break;
+    case SF_FORMAT_PCM_24:
+        m_intBits = 24;
+        break;
+    default:
+        m_intBits = 0;
+        break;
+    }
+    if (m_intBits > 0) {
+        m_pIntBuffer = std::make_unique<int[]>(kIntBufferSize);
+    } else {
+        m_pIntBuffer.reset();
+    }
 
     // Opens a soundfile from a virtual file I/O context which is provided by the caller.
     // This is usually used to interface libsndfile to a stream or buffer based system.
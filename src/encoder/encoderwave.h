@@ -8,8 +8,11 @@
 #endif
 #include <sndfile.h>
 
+#include <memory>
+
 #include "encoder/encoder.h"
 #include "track/track_decl.h"
+#include "util/sample.h"
 #include "util/types.h"
 
 class EncoderCallback;
@@ -28,6 +31,12 @@ class EncoderWave : public Encoder {
 
   protected:
     virtual void initStream();
+    // Rewrites the header with the current length every few seconds, so the
+    // file stays readable if the recording is not stopped properly.
+    void updateHeaderPeriodically(int iBufferSize);
+    // Integer formats are converted by SampleUtil instead of libsndfile,
+    // 16 bit samples with dither.
+    void writeSamples(const CSAMPLE* pBuffer, int iBufferSize);
     TrackPointer m_pMetaData;
     EncoderCallback* m_pCallback;
     QString m_metaDataTitle;
@@ -36,6 +45,12 @@ class EncoderWave : public Encoder {
 
     SNDFILE* m_pSndfile;
     SF_INFO m_sfInfo;
+    SINT m_headerUpdateSamples;
+    SINT m_samplesSinceHeaderUpdate;
+    // Significant bits of integer formats, 0 for float
+    int m_intBits;
+    std::unique_ptr<int[]> m_pIntBuffer;
+    SampleUtil::TpdfDither m_dither;
 
     SF_VIRTUAL_IO m_virtualIo;
 };
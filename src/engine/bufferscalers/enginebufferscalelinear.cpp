@@ -13,6 +13,7 @@ EngineBufferScaleLinear::EngineBufferScaleLinear(ReadAheadManager *pReadAheadMan
       m_bufferInt(SampleUtil::alloc(kiLinearScaleReadAheadLength)),
       m_bufferIntSize(0),
       m_bClear(false),
+      m_bInterpolateHermite(false),
       m_dRate(1.0),
       m_dOldRate(1.0),
       m_dCurrentFrame(0.0),
@@ -33,6 +34,7 @@ void EngineBufferScaleLinear::setScaleParameters(double base_rate,
 
     m_dOldRate = m_dRate;
     m_dRate = base_rate * *pTempoRatio;
+    m_bInterpolateHermite = base_rate != 1.0 && fabs(*pTempoRatio) == 1.0;
 }
 
 void EngineBufferScaleLinear::clear() {
@@ -236,6 +238,47 @@ double EngineBufferScaleLinear::do_scale(CSAMPLE* buf, SINT buf_size) {
 
     // Hot frame loop
     while (i < buf_size) {
+        // Fast path: interpolate the following frames directly as long as
+        // both of their samples are in the buffer, i.e. without the bounds
+        // checks and buffer refills of the general case below.
+        const SINT fastPathStart = i;
+        SINT fastPathFloor = 0;
+        const bool interpolateHermite = m_bInterpolateHermite && rate_delta_abs == 0;
+        while (i < buf_size && m_dNextFrame >= 0) {
+            const SINT frameFloor = static_cast<SINT>(m_dNextFrame);
+            const SINT floorSample = getOutputSignal().frames2samples(frameFloor);
+            if (floorSample + 3 >= m_bufferIntSize) {
+                break;
+            }
+            m_dCurrentFrame = m_dNextFrame;
+            const CSAMPLE* pFloor = &m_bufferInt[floorSample];
+            const CSAMPLE frac = static_cast<CSAMPLE>(m_dCurrentFrame) - frameFloor;
+            if (interpolateHermite && floorSample >= 2 &&
+                    floorSample + 5 < m_bufferIntSize) {
+                buf[i] = hermite4(frac, pFloor[-2], pFloor[0], pFloor[2], pFloor[4]);
+                buf[i + 1] = hermite4(frac, pFloor[-1], pFloor[1], pFloor[3], pFloor[5]);
+            } else {
+                buf[i] = pFloor[0] + frac * (pFloor[2] - pFloor[0]);
+                buf[i + 1] = pFloor[1] + frac * (pFloor[3] - pFloor[1]);
+            }
+            m_dNextFrame = m_dCurrentFrame + rate_add;
+            rate_add += rate_delta_abs;
+            i += getOutputSignal().getChannelCount();
+            fastPathFloor = floorSample;
+        }
+        if (i > fastPathStart) {
+            // The general case below continues with these samples
+            floor_sample[0] = m_bufferInt[fastPathFloor];
+            floor_sample[1] = m_bufferInt[fastPathFloor + 1];
+            ceil_sample[0] = m_bufferInt[fastPathFloor + 2];
+            ceil_sample[1] = m_bufferInt[fastPathFloor + 3];
+            m_floorSampleOld[0] = floor_sample[0];
+            m_floorSampleOld[1] = floor_sample[1];
+            if (i >= buf_size) {
+                break;
+            }
+        }
+
         // shift indices
         m_dCurrentFrame = m_dNextFrame;
 
@@ -39,6 +39,11 @@ class EngineBufferScaleLinear : public EngineBufferScale  {
     CSAMPLE m_floorSampleOld[2];
 
     bool m_bClear;
+    // Set while only the sample rate of the track is converted, i.e. at a
+    // tempo ratio of 1. The frames are then interpolated with a 4-point
+    // Hermite curve for a better quality than the linear interpolation
+    // that is needed for scratching.
+    bool m_bInterpolateHermite;
     double m_dRate;
     double m_dOldRate;
 
@@ -1,11 +1,14 @@
 #include "engine/bufferscalers/enginebufferscalerubberband.h"
 
 #include <QtDebug>
+#include <thread>
 
+#include "engine/engineworker.h"
 #include "engine/readaheadmanager.h"
 #include "moc_enginebufferscalerubberband.cpp"
 #include "util/counter.h"
 #include "util/defs.h"
+#include "util/denormalsarezero.h"
 #include "util/math.h"
 #include "util/sample.h"
 
@@ -13,22 +16,113 @@ using RubberBand::RubberBandStretcher;
 
 #define RUBBERBANDV3 (RUBBERBAND_API_MAJOR_VERSION >= 2 && RUBBERBAND_API_MINOR_VERSION >= 7)
 
+namespace {
+
+// The number of callbacks with unchanged playback parameters before the
+// time stretching is handed over to the look-ahead worker. Entering the
+// look-ahead mode costs the processing of one additional callback buffer.
+constexpr int kStableCallbacksBeforeLookAhead = 16;
+
+// The number of callback buffers the worker stays ahead of the play head.
+// Note that the worker only runs after each callback.
+constexpr int kLookAheadCallbacks = 3;
+
+// The capacity of the look-ahead rings in samples
+constexpr int kLookAheadRingSize = MAX_BUFFER_LEN;
+
+} // anonymous namespace
+
+// Processes the time stretching ahead of the play head whenever it has
+// been scheduled by the callback thread.
+class EngineBufferScaleRubberBand::LookAheadWorker : public EngineWorker {
+  public:
+    explicit LookAheadWorker(EngineBufferScaleRubberBand* pScale)
+            : m_pScale(pScale),
+              m_stop(false) {
+    }
+
+    void quitWait() {
+        m_stop.store(true);
+        m_semaRun.release();
+        wait();
+    }
+
+  protected:
+    void run() override {
+        static auto lastId = QAtomicInt(0);
+        const auto id = lastId.fetchAndAddRelaxed(1) + 1;
+        QThread::currentThread()->setObjectName(
+                QStringLiteral("RubberBandLookAhead ") + QString::number(id));
+        mixxx::enableDenormalsAreZero();
+        while (!m_stop.load()) {
+            m_semaRun.acquire();
+            if (m_stop.load()) {
+                break;
+            }
+            m_pScale->processLookAhead();
+        }
+    }
+
+  private:
+    EngineBufferScaleRubberBand* const m_pScale;
+    std::atomic<bool> m_stop;
+};
+
 EngineBufferScaleRubberBand::EngineBufferScaleRubberBand(
         ReadAheadManager* pReadAheadManager)
         : m_pReadAheadManager(pReadAheadManager),
+          m_stretcherPrimed{false, false},
+          m_pRubberBand(nullptr),
           m_buffers{mixxx::SampleBuffer(MAX_BUFFER_LEN), mixxx::SampleBuffer(MAX_BUFFER_LEN)},
           m_bufferPtrs{m_buffers[0].data(), m_buffers[1].data()},
           m_interleavedReadBuffer(MAX_BUFFER_LEN),
           m_bBackwards(false),
-          m_useEngineFiner(false) {
+          m_useEngineFiner(false),
+          m_useEngineFinerRequested(false),
+          m_lookAheadActive(false),
+          m_lookAheadBusy(false),
+          m_lookAheadTargetSamples(0),
+          m_stableCallbacks(0),
+          m_lastLookAheadReadFailed(false) {
     // Initialize the internal buffers to prevent re-allocations
     // in the real-time thread.
     onSampleRateChanged();
 }
 
+EngineBufferScaleRubberBand::~EngineBufferScaleRubberBand() {
+    if (m_pLookAheadWorker) {
+        m_lookAheadActive.store(false);
+        m_pLookAheadWorker->quitWait();
+    }
+}
+
+void EngineBufferScaleRubberBand::enableLookAhead(
+        EngineWorkerScheduler* pWorkerScheduler) {
+    VERIFY_OR_DEBUG_ASSERT(!m_pLookAheadWorker) {
+        return;
+    }
+    m_pLookAheadInput = std::make_unique<FIFO<CSAMPLE>>(kLookAheadRingSize);
+    m_pLookAheadOutput = std::make_unique<FIFO<CSAMPLE>>(kLookAheadRingSize);
+    mixxx::SampleBuffer(MAX_BUFFER_LEN).swap(m_lookAheadBuffer);
+    m_pLookAheadWorker = std::make_unique<LookAheadWorker>(this);
+    m_pLookAheadWorker->setScheduler(pWorkerScheduler);
+    m_pLookAheadWorker->start(QThread::HighPriority);
+}
+
 void EngineBufferScaleRubberBand::setScaleParameters(double base_rate,
                                                      double* pTempoRatio,
                                                      double* pPitchRatio) {
+    applyRequestedEngine();
+    if (m_pLookAheadWorker) {
+        // The time stretcher must not be touched while the worker is using
+        // it. The frames that have already been stretched with the previous
+        // parameters are played first.
+        if (isLookAheadActive()) {
+            stopLookAhead(false);
+        }
+        m_stableCallbacks = 0;
+    }
+
     // Negative speed means we are going backwards. pitch does not affect
     // the playback direction.
     m_bBackwards = *pTempoRatio < 0;
@@ -54,6 +148,10 @@ void EngineBufferScaleRubberBand::setScaleParameters(double base_rate,
     double pitchScale = fabs(base_rate * *pPitchRatio);
 
     if (pitchScale > 0) {
+        if (pitchScale != m_pRubberBand->getPitchScale()) {
+            // The padding depends on the pitch scale
+            m_stretcherPrimed[activeStretcherIndex()] = false;
+        }
         //qDebug() << "EngineBufferScaleRubberBand setPitchScale" << *pitch << pitchScale;
         m_pRubberBand->setPitchScale(pitchScale);
     }
@@ -94,43 +192,68 @@ void EngineBufferScaleRubberBand::onSampleRateChanged() {
     // TODO: Resetting the sample rate will cause internal
     // memory allocations that may block the real-time thread.
     // When is this function actually invoked??
+    if (m_pLookAheadWorker) {
+        stopLookAhead(true);
+    }
+    m_pRubberBand = nullptr;
     if (!getOutputSignal().isValid()) {
-        m_pRubberBand.reset();
+        for (auto& pStretcher : m_stretchers) {
+            pStretcher.reset();
+        }
         return;
     }
-    RubberBandStretcher::Options rubberbandOptions =
-            RubberBandStretcher::OptionProcessRealTime;
+    for (int i = 0; i < static_cast<int>(m_stretchers.size()); ++i) {
+        const bool engineFiner = i == 1;
+        if (engineFiner && !isEngineFinerAvailable()) {
+            m_stretchers[i].reset();
+            continue;
+        }
+        RubberBandStretcher::Options rubberbandOptions =
+                RubberBandStretcher::OptionProcessRealTime;
 #if RUBBERBANDV3
-    if (m_useEngineFiner) {
-        rubberbandOptions |=
-                RubberBandStretcher::OptionEngineFiner |
-                // Process Channels Together. otherwise the result is not
-                // mono-compatible. See #11361
-                RubberBandStretcher::OptionChannelsTogether;
-    }
+        if (engineFiner) {
+            rubberbandOptions |=
+                    RubberBandStretcher::OptionEngineFiner |
+                    // Process Channels Together. otherwise the result is not
+                    // mono-compatible. See #11361
+                    RubberBandStretcher::OptionChannelsTogether;
+        }
 #endif
 
-    m_pRubberBand = std::make_unique<RubberBandStretcher>(
-            getOutputSignal().getSampleRate(),
-            getOutputSignal().getChannelCount(),
-            rubberbandOptions);
-    // Setting the time ratio to a very high value will cause RubberBand
-    // to preallocate buffers large enough to (almost certainly)
-    // avoid memory reallocations during playback.
-    m_pRubberBand->setTimeRatio(2.0);
-    m_pRubberBand->setTimeRatio(1.0);
+        m_stretchers[i] = std::make_unique<RubberBandStretcher>(
+                getOutputSignal().getSampleRate(),
+                getOutputSignal().getChannelCount(),
+                rubberbandOptions);
+        m_pRubberBand = m_stretchers[i].get();
+        // Setting the time ratio to a very high value will cause RubberBand
+        // to preallocate buffers large enough to (almost certainly)
+        // avoid memory reallocations during playback.
+        m_pRubberBand->setTimeRatio(2.0);
+        m_pRubberBand->setTimeRatio(1.0);
+        // Prime the instance here, so that engaging keylock doesn't need
+        // to process the padding in the callback
+        reset();
+    }
+    m_pRubberBand = m_stretchers[m_useEngineFiner ? 1 : 0].get();
+    // The active instance is still primed
+    m_remainingPaddingInOutput = static_cast<SINT>(getStartDelay());
 }
 
 void EngineBufferScaleRubberBand::clear() {
+    applyRequestedEngine();
     VERIFY_OR_DEBUG_ASSERT(m_pRubberBand) {
         return;
     }
-    reset();
+    if (m_pLookAheadWorker) {
+        stopLookAhead(true);
+    }
+    resetUnlessPrimed();
 }
 
 SINT EngineBufferScaleRubberBand::retrieveAndDeinterleave(
         CSAMPLE* pBuffer,
         SINT frames) {
+    m_stretcherPrimed[activeStretcherIndex()] = false;
     const SINT frames_available = m_pRubberBand->available();
     // NOTE: If we still need to throw away padding, then we can also
     //       immediately read those frames in addition to the frames we actually
@@ -165,6 +288,7 @@ void EngineBufferScaleRubberBand::deinterleaveAndProcess(
         const CSAMPLE* pBuffer,
         SINT frames) {
     DEBUG_ASSERT(frames <= static_cast<SINT>(m_buffers[0].size()));
+    m_stretcherPrimed[activeStretcherIndex()] = false;
 
     SampleUtil::deinterleaveBuffer(
             m_buffers[0].data(),
@@ -186,9 +310,57 @@ double EngineBufferScaleRubberBand::scaleBuffer(
         // unscaled input buffer!
         return 0.0;
     }
+    applyRequestedEngine();
+
+    const SINT frames = getOutputSignal().samples2frames(iOutputBufferSize);
+    if (!m_pLookAheadWorker) {
+        return processSynchronously(pOutputBuffer, frames);
+    }
+
+    if (isLookAheadActive()) {
+        if (m_pLookAheadOutput->readAvailable() >= iOutputBufferSize) {
+            m_pLookAheadOutput->read(pOutputBuffer, iOutputBufferSize);
+            fillLookAheadInput(frames);
+            m_pLookAheadWorker->workReady();
+            return m_effectiveRate * frames;
+        }
+        // The worker did not keep up, e.g. because the callback buffer
+        // size has been increased.
+        Counter counter("EngineBufferScaleRubberBand::lookAhead underflow");
+        counter.increment();
+        stopLookAhead(false);
+    }
+
+    // Play the frames that have been left over by the worker first
+    double readFramesProcessed = 0;
+    SINT remainingFrames = frames;
+    CSAMPLE* pOutput = pOutputBuffer;
+    const int pendingSamples = math_min(
+            m_pLookAheadOutput->readAvailable(),
+            static_cast<int>(iOutputBufferSize));
+    if (pendingSamples > 0) {
+        m_pLookAheadOutput->read(pOutput, pendingSamples);
+        const SINT pendingFrames = getOutputSignal().samples2frames(pendingSamples);
+        readFramesProcessed += m_effectiveRate * pendingFrames;
+        remainingFrames -= pendingFrames;
+        pOutput += pendingSamples;
+    }
+    if (remainingFrames > 0) {
+        readFramesProcessed += processSynchronously(pOutput, remainingFrames);
+    }
+
+    if (++m_stableCallbacks >= kStableCallbacksBeforeLookAhead &&
+            m_pLookAheadOutput->readAvailable() == 0) {
+        startLookAhead(frames);
+    }
+    return readFramesProcessed;
+}
 
+double EngineBufferScaleRubberBand::processSynchronously(
+        CSAMPLE* pOutputBuffer,
+        SINT frames) {
     double readFramesProcessed = 0;
-    SINT remaining_frames = getOutputSignal().samples2frames(iOutputBufferSize);
+    SINT remaining_frames = frames;
     CSAMPLE* read = pOutputBuffer;
     bool last_read_failed = false;
     while (remaining_frames > 0) {
@@ -210,10 +382,7 @@ double EngineBufferScaleRubberBand::scaleBuffer(
         if (remaining_frames > 0 && next_block_frames_required > 0) {
             // The requested setting becomes effective after all previous frames have been processed
             m_effectiveRate = m_dBaseRate * m_dTempoRatio;
-            const SINT available_samples = m_pReadAheadManager->getNextSamples(
-                    // The value doesn't matter here. All that matters is we
-                    // are going forward or backward.
-                    (m_bBackwards ? -1.0 : 1.0) * m_dBaseRate * m_dTempoRatio,
+            const SINT available_samples = readInput(
                     m_interleavedReadBuffer.data(),
                     getOutputSignal().frames2samples(next_block_frames_required));
             const SINT available_frames = getOutputSignal().samples2frames(available_samples);
@@ -254,6 +423,147 @@ double EngineBufferScaleRubberBand::scaleBuffer(
     return readFramesProcessed;
 }
 
+SINT EngineBufferScaleRubberBand::readInput(
+        CSAMPLE* pBuffer,
+        SINT samples) {
+    if (m_pLookAheadInput) {
+        const int readAheadSamples = m_pLookAheadInput->readAvailable();
+        if (readAheadSamples > 0) {
+            // These have already been read from the ReadAheadManager
+            return m_pLookAheadInput->read(pBuffer,
+                    math_min(readAheadSamples, static_cast<int>(samples)));
+        }
+    }
+    return m_pReadAheadManager->getNextSamples(
+            // The value doesn't matter here. All that matters is we
+            // are going forward or backward.
+            (m_bBackwards ? -1.0 : 1.0) * m_dBaseRate * m_dTempoRatio,
+            pBuffer,
+            samples);
+}
+
+void EngineBufferScaleRubberBand::startLookAhead(SINT prefillFrames) {
+    DEBUG_ASSERT(!isLookAheadActive());
+    DEBUG_ASSERT(m_pLookAheadOutput->readAvailable() == 0);
+    // The worker is only scheduled after this callback. Stretch the frames
+    // for the next callback now to bridge the gap.
+    CSAMPLE* pRegion1;
+    ring_buffer_size_t regionSize1;
+    CSAMPLE* pRegion2;
+    ring_buffer_size_t regionSize2;
+    const int prefillSamples = m_pLookAheadOutput->aquireWriteRegions(
+            getOutputSignal().frames2samples(prefillFrames),
+            &pRegion1,
+            &regionSize1,
+            &pRegion2,
+            &regionSize2);
+    processSynchronously(pRegion1, getOutputSignal().samples2frames(regionSize1));
+    if (regionSize2 > 0) {
+        processSynchronously(pRegion2, getOutputSignal().samples2frames(regionSize2));
+    }
+    m_pLookAheadOutput->releaseWriteRegions(prefillSamples);
+
+    m_lastLookAheadReadFailed = false;
+    m_lookAheadTargetSamples.store(
+            math_min(kLookAheadCallbacks * prefillSamples, kLookAheadRingSize / 2),
+            std::memory_order_relaxed);
+    fillLookAheadInput(prefillFrames);
+
+    m_lookAheadActive.store(true);
+    m_pLookAheadWorker->workReady();
+}
+
+void EngineBufferScaleRubberBand::stopLookAhead(bool discardPending) {
+    m_lookAheadActive.store(false);
+    // Wait until the worker has finished the block it is currently
+    // processing. The worker checks m_lookAheadActive before every block.
+    while (m_lookAheadBusy.load()) {
+        std::this_thread::yield();
+    }
+    m_stableCallbacks = 0;
+    if (discardPending) {
+        m_pLookAheadInput->flushReadData(m_pLookAheadInput->readAvailable());
+        m_pLookAheadOutput->flushReadData(m_pLookAheadOutput->readAvailable());
+    }
+}
+
+void EngineBufferScaleRubberBand::fillLookAheadInput(SINT outputFrames) {
+    const double rate = m_dBaseRate * m_dTempoRatio;
+    const int targetSamples = math_min(
+            static_cast<int>(getOutputSignal().frames2samples(static_cast<SINT>(
+                    std::ceil(outputFrames * rate * kLookAheadCallbacks)))),
+            kLookAheadRingSize / 2);
+    int missingSamples = targetSamples - m_pLookAheadInput->readAvailable();
+    while (missingSamples > 0) {
+        const int chunkSamples = math_min3(missingSamples,
+                m_pLookAheadInput->writeAvailable(),
+                static_cast<int>(m_interleavedReadBuffer.size()));
+        if (chunkSamples <= 0) {
+            return;
+        }
+        SINT readSamples = m_pReadAheadManager->getNextSamples(
+                (m_bBackwards ? -1.0 : 1.0) * rate,
+                m_interleavedReadBuffer.data(),
+                chunkSamples);
+        if (readSamples > 0) {
+            m_lastLookAheadReadFailed = false;
+        } else if (m_lastLookAheadReadFailed) {
+            // Same as in processSynchronously(): If we get 0 samples
+            // repeatedly, e.g. at EOF, pad with silence to get the last
+            // samples out of RubberBand.
+            SampleUtil::clear(m_interleavedReadBuffer.data(), chunkSamples);
+            readSamples = chunkSamples;
+        } else {
+            // We may get 0 samples once if we just hit a loop trigger.
+            // Try again in the next callback.
+            m_lastLookAheadReadFailed = true;
+            return;
+        }
+        m_pLookAheadInput->write(m_interleavedReadBuffer.data(), readSamples);
+        missingSamples -= readSamples;
+    }
+}
+
+void EngineBufferScaleRubberBand::processLookAhead() {
+    // m_lookAheadBusy must be set before m_lookAheadActive is checked and
+    // both use sequential consistency. Otherwise stopLookAhead() might miss
+    // that the worker is about to access the time stretcher.
+    m_lookAheadBusy.store(true);
+    if (m_lookAheadActive.load()) {
+        processLookAheadInput();
+    }
+    m_lookAheadBusy.store(false);
+}
+
+void EngineBufferScaleRubberBand::processLookAheadInput() {
+    const int targetSamples = m_lookAheadTargetSamples.load(std::memory_order_relaxed);
+    while (m_lookAheadActive.load() &&
+            m_pLookAheadOutput->readAvailable() < targetSamples) {
+        const SINT writableFrames = math_min(
+                getOutputSignal().samples2frames(m_pLookAheadOutput->writeAvailable()),
+                getOutputSignal().samples2frames(m_lookAheadBuffer.size()));
+        if (m_pRubberBand->available() > 0 && writableFrames > 0) {
+            const SINT receivedFrames = retrieveAndDeinterleave(
+                    m_lookAheadBuffer.data(), writableFrames);
+            m_pLookAheadOutput->write(m_lookAheadBuffer.data(),
+                    getOutputSignal().frames2samples(receivedFrames));
+            continue;
+        }
+
+        const SINT inputFrames = math_min3(
+                static_cast<SINT>(m_pRubberBand->getSamplesRequired()),
+                getOutputSignal().samples2frames(m_pLookAheadInput->readAvailable()),
+                getOutputSignal().samples2frames(m_lookAheadBuffer.size()));
+        if (inputFrames <= 0) {
+            // Wait for more input from the callback thread
+            return;
+        }
+        m_pLookAheadInput->read(m_lookAheadBuffer.data(),
+                getOutputSignal().frames2samples(inputFrames));
+        deinterleaveAndProcess(m_lookAheadBuffer.data(), inputFrames);
+    }
+}
+
 // static
 bool EngineBufferScaleRubberBand::isEngineFinerAvailable() {
     return RUBBERBANDV3;
@@ -261,8 +571,39 @@ bool EngineBufferScaleRubberBand::isEngineFinerAvailable() {
 
 void EngineBufferScaleRubberBand::useEngineFiner(bool enable) {
     if (isEngineFinerAvailable()) {
-        m_useEngineFiner = enable;
-        onSampleRateChanged();
+        m_useEngineFinerRequested.store(enable, std::memory_order_release);
+    }
+}
+
+void EngineBufferScaleRubberBand::applyRequestedEngine() {
+    const bool useEngineFiner = m_useEngineFinerRequested.load(std::memory_order_acquire);
+    if (useEngineFiner == m_useEngineFiner) {
+        return;
+    }
+    m_useEngineFiner = useEngineFiner;
+    if (!m_pRubberBand) {
+        // Selected when the instances are created
+        return;
+    }
+    if (m_pLookAheadWorker) {
+        stopLookAhead(true);
+    }
+    RubberBandStretcher* pPrevious = m_pRubberBand;
+    m_pRubberBand = m_stretchers[useEngineFiner ? 1 : 0].get();
+    VERIFY_OR_DEBUG_ASSERT(m_pRubberBand) {
+        m_pRubberBand = pPrevious;
+        return;
+    }
+    // Continue with the current playback parameters
+    if (pPrevious->getPitchScale() != m_pRubberBand->getPitchScale()) {
+        m_pRubberBand->setPitchScale(pPrevious->getPitchScale());
+        m_stretcherPrimed[activeStretcherIndex()] = false;
+    }
+    m_pRubberBand->setTimeRatio(pPrevious->getTimeRatio());
+    if (m_stretcherPrimed[activeStretcherIndex()]) {
+        m_remainingPaddingInOutput = static_cast<SINT>(getStartDelay());
+    } else {
+        reset();
     }
 }
 
@@ -329,4 +670,15 @@ void EngineBufferScaleRubberBand::reset() {
     // silence should be dropped from the result when the `retrieve()` in
     // `retrieveAndDeinterleave()` first starts producing audio.
     m_remainingPaddingInOutput = static_cast<SINT>(getStartDelay());
+    m_stretcherPrimed[activeStretcherIndex()] = true;
+}
+
+void EngineBufferScaleRubberBand::resetUnlessPrimed() {
+    if (m_stretcherPrimed[activeStretcherIndex()]) {
+        // The padding has been processed already and nothing has been
+        // retrieved since
+        m_remainingPaddingInOutput = static_cast<SINT>(getStartDelay());
+        return;
+    }
+    reset();
 }
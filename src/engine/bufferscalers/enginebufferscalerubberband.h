@@ -3,19 +3,31 @@
 #include <rubberband/RubberBandStretcher.h>
 
 #include <array>
+#include <atomic>
 
 #include "engine/bufferscalers/enginebufferscale.h"
+#include "util/fifo.h"
 #include "util/memory.h"
 #include "util/samplebuffer.h"
 
+class EngineWorkerScheduler;
 class ReadAheadManager;
 
 // Uses librubberband to scale audio.  This class is not thread safe.
+//
+// Optionally the time stretching can be done ahead of the play position by
+// a worker thread while the playback parameters are stable, see
+// enableLookAhead(). The callback thread then only reads the input from the
+// ReadAheadManager and fetches the stretched output from a bounded lock-free
+// ring buffer. Any change of the playback parameters falls back to the
+// synchronous processing in the callback until the parameters are stable
+// again.
 class EngineBufferScaleRubberBand final : public EngineBufferScale {
     Q_OBJECT
   public:
     explicit EngineBufferScaleRubberBand(
             ReadAheadManager* pReadAheadManager);
+    ~EngineBufferScaleRubberBand() override;
 
     EngineBufferScaleRubberBand(const EngineBufferScaleRubberBand&) = delete;
     EngineBufferScaleRubberBand& operator=(const EngineBufferScaleRubberBand&) = delete;
@@ -26,9 +38,14 @@ class EngineBufferScaleRubberBand final : public EngineBufferScale {
     // Let EngineBuffer know if engine v3 is available
     static bool isEngineFinerAvailable();
 
-    // Enable engine v3 if available
+    // Enable engine v3 if available. May be called from any thread, the
+    // engine is switched by the callback thread when it uses the scaler next.
     void useEngineFiner(bool enable);
 
+    // Starts the look-ahead worker thread. Must be called once before the
+    // engine is running.
+    void enableLookAhead(EngineWorkerScheduler* pWorkerScheduler);
+
     void setScaleParameters(double base_rate,
                             double* pTempoRatio,
                             double* pPitchRatio) override;
@@ -41,6 +58,8 @@ class EngineBufferScaleRubberBand final : public EngineBufferScale {
     void clear() override;
 
   private:
+    class LookAheadWorker;
+
     // Reset RubberBand library with new audio signal
     void onSampleRateChanged() override;
 
@@ -55,14 +74,53 @@ class EngineBufferScaleRubberBand final : public EngineBufferScale {
     /// through it. This should be used instead of calling
     /// `m_pRubberBand->reset()` directly.
     void reset();
+    /// Same as reset(), unless the instance has not been used since the
+    /// last reset() and is still primed with the padding.
+    void resetUnlessPrimed();
+    int activeStretcherIndex() const {
+        return m_pRubberBand == m_stretchers[1].get() ? 1 : 0;
+    }
+    /// Switches to the engine requested by useEngineFiner()
+    void applyRequestedEngine();
 
     void deinterleaveAndProcess(const CSAMPLE* pBuffer, SINT frames);
     SINT retrieveAndDeinterleave(CSAMPLE* pBuffer, SINT frames);
 
+    /// Produces the requested frames synchronously and returns the number
+    /// of input frames that have been consumed for them.
+    double processSynchronously(CSAMPLE* pOutputBuffer, SINT frames);
+
+    bool isLookAheadActive() const {
+        return m_lookAheadActive.load(std::memory_order_acquire);
+    }
+    /// Hands the time stretcher over to the worker thread after filling the
+    /// output ring with the given number of frames.
+    void startLookAhead(SINT prefillFrames);
+    /// Takes back the time stretcher from the worker thread. Unless
+    /// `discardPending` is set, the frames that are left in the rings are
+    /// consumed first by the synchronous processing.
+    void stopLookAhead(bool discardPending);
+    /// Reads the next input samples for the synchronous processing, either
+    /// from the input ring or from the ReadAheadManager.
+    SINT readInput(CSAMPLE* pBuffer, SINT samples);
+    /// Reads the input frames for the upcoming callbacks from the
+    /// ReadAheadManager into the input ring.
+    void fillLookAheadInput(SINT outputFrames);
+    /// Invoked on the worker thread.
+    void processLookAhead();
+    void processLookAheadInput();
+
     // The read-ahead manager that we use to fetch samples
     ReadAheadManager* m_pReadAheadManager;
 
-    std::unique_ptr<RubberBand::RubberBandStretcher> m_pRubberBand;
+    /// The instances of both engines, which are created together so that
+    /// switching between them doesn't allocate in the callback. The engine
+    /// v3 instance only exists if it is available.
+    std::array<std::unique_ptr<RubberBand::RubberBandStretcher>, 2> m_stretchers;
+    /// Whether an instance has been reset and padded and not been used since
+    std::array<bool, 2> m_stretcherPrimed;
+    /// The active instance in `m_stretchers`
+    RubberBand::RubberBandStretcher* m_pRubberBand;
 
     /// The audio buffers samples used to send audio to Rubber Band and to
     /// receive processed audio from Rubber Band. This is needed because Mixxx
@@ -84,4 +142,24 @@ class EngineBufferScaleRubberBand final : public EngineBufferScale {
     SINT m_remainingPaddingInOutput = 0;
 
     bool m_useEngineFiner;
+    std::atomic<bool> m_useEngineFinerRequested;
+
+    std::unique_ptr<LookAheadWorker> m_pLookAheadWorker;
+    /// Interleaved input frames that have been read ahead for the worker
+    std::unique_ptr<FIFO<CSAMPLE>> m_pLookAheadInput;
+    /// Interleaved stretched frames that have been produced by the worker
+    std::unique_ptr<FIFO<CSAMPLE>> m_pLookAheadOutput;
+    /// Used by the worker for moving the retrieved frames into the output ring.
+    mixxx::SampleBuffer m_lookAheadBuffer;
+    /// The time stretcher is owned by the worker while this is set.
+    std::atomic<bool> m_lookAheadActive;
+    /// Set by the worker while it accesses the time stretcher.
+    std::atomic<bool> m_lookAheadBusy;
+    /// The number of output samples the worker should keep in the output ring
+    std::atomic<int> m_lookAheadTargetSamples;
+    /// The number of callbacks since the playback parameters have changed
+    int m_stableCallbacks;
+    /// Whether the last read from the ReadAheadManager for the input ring
+    /// returned no samples
+    bool m_lastLookAheadReadFailed;
 };
@@ -1,7 +1,10 @@
 #include "engine/cachingreader/cachingreader.h"
 
 #include <QtDebug>
+#include <atomic>
 
+#include "engine/cachingreader/cachingreaderchunkpool.h"
+#include "mixer/playermanager.h"
 #include "moc_cachingreader.cpp"
 #include "util/assert.h"
 #include "util/compatibility/qatomic.h"
@@ -27,19 +30,126 @@ constexpr SINT kDefaultHintFrames = 1024;
 // Consequently the total memory required for all allocated chunks depends
 // on the number of decks. The amount of memory reserved for a single
 // CachingReader must be multiplied by the number of decks to calculate
-// the total amount!
+// the total amount! The memory is contributed to the CachingReaderChunkPool,
+// i.e. decks that play the same track share the decoded chunks instead of
+// decoding and storing them twice. The number of chunks can be configured separately
+// for decks, samplers and preview decks. An optional global memory budget
+// limits the total amount of memory for all readers.
 //
 // NOTE(uklotzde, 2019-09-05): Reduce this number to just few chunks
-// (kNumberOfCachedChunksInMemory = 1, 2, 3, ...) for testing purposes
+// (kMinNumberOfCachedChunksInMemory = 1, 2, 3, ... and a corresponding
+// value in the configuration) for testing purposes
 // to verify that the MRU/LRU cache works as expected. Even though
 // massive drop outs are expected to occur Mixxx should run reliably!
-constexpr SINT kNumberOfCachedChunksInMemory = 80;
+constexpr SINT kDefaultNumberOfCachedChunksInMemory = 80;
+
+// The lower bound, even if the memory budget is exhausted. The chunks
+// around the play position, the cue points, and the loop boundaries
+// need to fit into the cache at the same time.
+constexpr SINT kMinNumberOfCachedChunksInMemory = 16;
+
+constexpr SINT kChunkMemoryBytes =
+        CachingReaderChunk::kSamples * static_cast<SINT>(sizeof(CSAMPLE));
+
+const QString kConfigGroup = QStringLiteral("[CachingReader]");
+
+const ConfigKey kDeckChunkCountConfigKey =
+        ConfigKey(kConfigGroup, QStringLiteral("deck_chunk_count"));
+const ConfigKey kSamplerChunkCountConfigKey =
+        ConfigKey(kConfigGroup, QStringLiteral("sampler_chunk_count"));
+const ConfigKey kPreviewDeckChunkCountConfigKey =
+        ConfigKey(kConfigGroup, QStringLiteral("preview_deck_chunk_count"));
+// The global memory budget for all readers in MiB, 0 = unlimited
+const ConfigKey kMemoryBudgetConfigKey =
+        ConfigKey(kConfigGroup, QStringLiteral("memory_budget_mb"));
+
+// Samplers preload the whole track if it fits into their chunks
+const ConfigKey kSamplerPreloadConfigKey =
+        ConfigKey(kConfigGroup, QStringLiteral("sampler_preload"));
+
+// Tracks up to this duration are decoded into memory after loading
+const ConfigKey kResidentMaxSecondsConfigKey =
+        ConfigKey(kConfigGroup, QStringLiteral("resident_max_seconds"));
+constexpr int kDefaultResidentMaxSeconds = 60;
+
+// The number of chunks that are currently allocated by all readers.
+std::atomic<SINT> s_reservedChunkCount = 0;
+
+const ConfigKey& chunkCountConfigKeyForGroup(const QString& group) {
+    if (PlayerManager::isSamplerGroup(group)) {
+        return kSamplerChunkCountConfigKey;
+    }
+    if (PlayerManager::isPreviewDeckGroup(group)) {
+        return kPreviewDeckChunkCountConfigKey;
+    }
+    return kDeckChunkCountConfigKey;
+}
 
 } // anonymous namespace
 
+// static
+SINT CachingReader::reserveChunkCount(
+        const QString& group,
+        const UserSettingsPointer& pConfig) {
+    SINT chunkCount = kDefaultNumberOfCachedChunksInMemory;
+    SINT memoryBudgetMB = 0;
+    if (pConfig) {
+        chunkCount = pConfig->getValue(
+                chunkCountConfigKeyForGroup(group),
+                static_cast<int>(kDefaultNumberOfCachedChunksInMemory));
+        memoryBudgetMB = pConfig->getValue(kMemoryBudgetConfigKey, 0);
+    }
+    if (chunkCount < kMinNumberOfCachedChunksInMemory) {
+        kLogger.warning()
+                << "Increasing the number of cached chunks for"
+                << group
+                << "from"
+                << chunkCount
+                << "to the minimum of"
+                << kMinNumberOfCachedChunksInMemory;
+        chunkCount = kMinNumberOfCachedChunksInMemory;
+    }
+    if (memoryBudgetMB <= 0) {
+        s_reservedChunkCount.fetch_add(chunkCount);
+        return chunkCount;
+    }
+    const SINT budgetChunkCount = memoryBudgetMB * 1024 * 1024 / kChunkMemoryBytes;
+    SINT reservedChunkCount = s_reservedChunkCount.load();
+    SINT grantedChunkCount;
+    do {
+        grantedChunkCount = math_max(
+                math_min(chunkCount, budgetChunkCount - reservedChunkCount),
+                kMinNumberOfCachedChunksInMemory);
+    } while (!s_reservedChunkCount.compare_exchange_weak(
+            reservedChunkCount, reservedChunkCount + grantedChunkCount));
+    if (grantedChunkCount < chunkCount) {
+        kLogger.warning()
+                << "Memory budget of"
+                << memoryBudgetMB
+                << "MiB exhausted: Reducing the number of cached chunks for"
+                << group
+                << "from"
+                << chunkCount
+                << "to"
+                << grantedChunkCount;
+    }
+    return grantedChunkCount;
+}
+
+// static
+SINT CachingReader::totalChunkMemoryBytes() {
+    return s_reservedChunkCount.load() * kChunkMemoryBytes;
+}
+
 CachingReader::CachingReader(const QString& group,
         UserSettingsPointer config)
-        : m_pConfig(config),
+        : m_group(group),
+          m_pConfig(config),
+          m_chunkCount(reserveChunkCount(group, config)),
+          m_preloadEnabled(PlayerManager::isSamplerGroup(group) &&
+                  (!config || config->getValue(kSamplerPreloadConfigKey, true))),
+          m_preloadChunkIndex(0),
+          m_preloadEndChunkIndex(0),
           // Limit the number of in-flight requests to the worker. This should
           // prevent to overload the worker when it is not able to fetch those
           // requests from the FIFO timely. Otherwise outdated requests pile up
@@ -49,31 +159,59 @@ CachingReader::CachingReader(const QString& group,
           // buffer, where new requests replace old requests when full. Those
           // old requests need to be returned immediately to the CachingReader
           // that must take ownership and free them!!!
-          m_chunkReadRequestFIFO(kNumberOfCachedChunksInMemory / 4),
+          m_chunkReadRequestFIFO(static_cast<int>(m_chunkCount / 4)),
+          // Prefetch requests are only processed while no regular
+          // requests are pending. They share the same limit.
+          m_chunkPrefetchRequestFIFO(static_cast<int>(m_chunkCount / 4)),
           // The capacity of the back channel must be equal to the number of
           // allocated chunks, because the worker use writeBlocking(). Otherwise
           // the worker could get stuck in a hot loop!!!
-          m_readerStatusUpdateFIFO(kNumberOfCachedChunksInMemory),
+          m_readerStatusUpdateFIFO(static_cast<int>(m_chunkCount)),
           m_state(STATE_IDLE),
+          m_allocatedCachingReaderChunks(m_chunkCount),
           m_mruCachingReaderChunk(nullptr),
           m_lruCachingReaderChunk(nullptr),
-          m_sampleBuffer(CachingReaderChunk::kSamples * kNumberOfCachedChunksInMemory),
-          m_worker(group, &m_chunkReadRequestFIFO, &m_readerStatusUpdateFIFO) {
-    m_allocatedCachingReaderChunks.reserve(kNumberOfCachedChunksInMemory);
-    // Divide up the allocated raw memory buffer into total_chunks
-    // chunks. Initialize each chunk to hold nothing and add it to the free
-    // list.
-    for (SINT i = 0; i < kNumberOfCachedChunksInMemory; ++i) {
-        CachingReaderChunkForOwner* c =
-                new CachingReaderChunkForOwner(
-                        mixxx::SampleBuffer::WritableSlice(
-                                m_sampleBuffer,
-                                CachingReaderChunk::kSamples * i,
-                                CachingReaderChunk::kSamples));
+          m_pChunkPoolBlock(nullptr),
+          m_pResidentSamples(nullptr),
+          m_cacheHitCount(0),
+          m_cacheMissCount(0),
+          m_cacheEvictionCount(0),
+          m_cacheStatsDirty(false),
+          m_cacheChunkCountCO(ConfigKey(group, QStringLiteral("cache_chunk_count"))),
+          m_cacheHitCountCO(ConfigKey(group, QStringLiteral("cache_hit_count"))),
+          m_cacheMissCountCO(ConfigKey(group, QStringLiteral("cache_miss_count"))),
+          m_cacheEvictionCountCO(ConfigKey(group, QStringLiteral("cache_eviction_count"))),
+          m_cacheResidentCO(ConfigKey(group, QStringLiteral("cache_resident"))),
+          m_loadIntoRamCO(ConfigKey(group, QStringLiteral("load_into_ram")), true),
+          m_worker(group,
+                  &m_chunkReadRequestFIFO,
+                  &m_chunkPrefetchRequestFIFO,
+                  &m_readerStatusUpdateFIFO) {
+    m_chunks.reserve(m_chunkCount);
+    m_freeChunks.reserve(m_chunkCount);
+    // Initialize each chunk to hold nothing and add it to the free list.
+    // The worker attaches the sample memory from the pool when reading.
+    for (SINT i = 0; i < m_chunkCount; ++i) {
+        CachingReaderChunkForOwner* c = new CachingReaderChunkForOwner();
         m_chunks.push_back(c);
         m_freeChunks.push_back(c);
     }
 
+    m_cacheChunkCountCO.setReadOnly();
+    m_cacheChunkCountCO.forceSet(static_cast<double>(m_chunkCount));
+    m_cacheHitCountCO.setReadOnly();
+    m_cacheMissCountCO.setReadOnly();
+    m_cacheEvictionCountCO.setReadOnly();
+    m_cacheResidentCO.setReadOnly();
+    m_loadIntoRamCO.setButtonMode(ControlPushButton::TOGGLE);
+
+    m_worker.setResidentMaxSeconds(m_pConfig
+                    ? m_pConfig->getValue(kResidentMaxSecondsConfigKey,
+                              kDefaultResidentMaxSeconds)
+                    : kDefaultResidentMaxSeconds);
+
+    m_worker.setPcmCache(CachingReaderPcmCache::fromConfig(m_pConfig));
+
     // Forward signals from worker
     connect(&m_worker, &CachingReaderWorker::trackLoading,
             this, &CachingReader::trackLoading,
@@ -84,13 +222,46 @@ CachingReader::CachingReader(const QString& group,
     connect(&m_worker, &CachingReaderWorker::trackLoadFailed,
             this, &CachingReader::trackLoadFailed,
             Qt::DirectConnection);
+}
 
+void CachingReader::activate() {
+    DEBUG_ASSERT(!m_pChunkPoolBlock);
+    m_pChunkPoolBlock = CachingReaderChunkPool::instance().addBlock(m_chunkCount);
+    kLogger.info()
+            << "Allocated"
+            << m_chunkCount
+            << "chunks with"
+            << m_chunkCount * kChunkMemoryBytes / 1024
+            << "KiB for"
+            << m_group
+            << "- total memory of all readers:"
+            << totalChunkMemoryBytes() / 1024
+            << "KiB";
     m_worker.start(QThread::HighPriority);
 }
 
 CachingReader::~CachingReader() {
     m_worker.quitWait();
+    // The worker has stopped and no longer accesses the chunks
+    auto& chunkPool = CachingReaderChunkPool::instance();
+    for (auto* pChunk : m_chunks) {
+        chunkPool.release(pChunk);
+    }
+    if (m_pChunkPoolBlock) {
+        chunkPool.removeBlock(m_pChunkPoolBlock);
+    }
     qDeleteAll(m_chunks);
+    s_reservedChunkCount.fetch_sub(m_chunkCount);
+}
+
+void CachingReader::publishCacheStats() {
+    if (!m_cacheStatsDirty) {
+        return;
+    }
+    m_cacheHitCountCO.forceSet(static_cast<double>(m_cacheHitCount));
+    m_cacheMissCountCO.forceSet(static_cast<double>(m_cacheMissCount));
+    m_cacheEvictionCountCO.forceSet(static_cast<double>(m_cacheEvictionCount));
+    m_cacheStatsDirty = false;
 }
 
 void CachingReader::freeChunkFromList(CachingReaderChunkForOwner* pChunk) {
@@ -98,6 +269,8 @@ void CachingReader::freeChunkFromList(CachingReaderChunkForOwner* pChunk) {
             &m_mruCachingReaderChunk,
             &m_lruCachingReaderChunk);
     pChunk->free();
+    // Never exceeds the reserved capacity, i.e. no reallocation
+    DEBUG_ASSERT(m_freeChunks.size() < m_freeChunks.capacity());
     m_freeChunks.push_back(pChunk);
 }
 
@@ -136,12 +309,15 @@ CachingReaderChunkForOwner* CachingReader::allocateChunk(SINT chunkIndex) {
     if (m_freeChunks.empty()) {
         return nullptr;
     }
-    CachingReaderChunkForOwner* pChunk = m_freeChunks.front();
-    m_freeChunks.pop_front();
+    CachingReaderChunkForOwner* pChunk = m_freeChunks.back();
+    m_freeChunks.pop_back();
 
     pChunk->init(chunkIndex);
 
-    m_allocatedCachingReaderChunks.insert(chunkIndex, pChunk);
+    const bool inserted = m_allocatedCachingReaderChunks.insert(chunkIndex, pChunk);
+    Q_UNUSED(inserted); // only used in DEBUG_ASSERT
+    // The index has room for all chunks
+    DEBUG_ASSERT(inserted);
 
     return pChunk;
 }
@@ -151,6 +327,8 @@ CachingReaderChunkForOwner* CachingReader::allocateChunkExpireLRU(SINT chunkInde
     if (!pChunk) {
         if (m_lruCachingReaderChunk) {
             freeChunk(m_lruCachingReaderChunk);
+            ++m_cacheEvictionCount;
+            m_cacheStatsDirty = true;
             pChunk = allocateChunk(chunkIndex);
         } else {
             kLogger.warning() << "No cached LRU chunk available for freeing";
@@ -163,8 +341,8 @@ CachingReaderChunkForOwner* CachingReader::allocateChunkExpireLRU(SINT chunkInde
 }
 
 CachingReaderChunkForOwner* CachingReader::lookupChunk(SINT chunkIndex) {
-    // Defaults to nullptr if it's not in the hash.
-    auto* pChunk = m_allocatedCachingReaderChunks.value(chunkIndex, nullptr);
+    // Defaults to nullptr if it's not in the index.
+    auto* pChunk = m_allocatedCachingReaderChunks.value(chunkIndex);
     DEBUG_ASSERT(!pChunk || pChunk->getIndex() == chunkIndex);
     return pChunk;
 }
@@ -215,7 +393,10 @@ void CachingReader::newTrack(TrackPointer pTrack) {
         kLogger.warning()
                 << "Loading a new track while loading a track may lead to inconsistent states";
     }
-    m_worker.newTrack(std::move(pTrack));
+    if (pTrack && !m_pChunkPoolBlock) {
+        activate();
+    }
+    m_worker.newTrack(std::move(pTrack), m_loadIntoRamCO.toBool());
 }
 
 // Called from the engine thread
@@ -254,7 +435,18 @@ void CachingReader::process() {
             }
         } else {
             // State update (without a chunk)
-            if (update.status == TRACK_LOADED) {
+            if (update.status == TRACK_RESIDENT) {
+                // Ignore the samples of a previous track that arrive
+                // while the next track is loading
+                const CSAMPLE* pResidentSamples = update.takeResidentSamples();
+                if (m_state.loadAcquire() == STATE_TRACK_LOADED) {
+                    m_pResidentSamples = pResidentSamples;
+                    m_residentFrameIndexRange = update.readableFrameIndexRange();
+                    // Chunks are no longer needed
+                    m_preloadChunkIndex = m_preloadEndChunkIndex;
+                    m_cacheResidentCO.forceSet(1.0);
+                }
+            } else if (update.status == TRACK_LOADED) {
                 // We have a new Track ready to go.
                 // Assert that we either have had STATE_TRACK_LOADING before and all
                 // chunks in the m_readerStatusUpdateFIFO have been discarded.
@@ -271,9 +463,28 @@ void CachingReader::process() {
                 }
                 // Reset the readable frame index range
                 m_readableFrameIndexRange = update.readableFrameIndexRange();
+                m_pResidentSamples = nullptr;
+                m_residentFrameIndexRange = mixxx::IndexRange();
+                m_cacheResidentCO.forceSet(0.0);
+                m_preloadChunkIndex = 0;
+                m_preloadEndChunkIndex = 0;
+                if (m_preloadEnabled && !m_readableFrameIndexRange.empty()) {
+                    const SINT firstChunkIndex = CachingReaderChunk::indexForFrame(
+                            m_readableFrameIndexRange.start());
+                    const SINT lastChunkIndex = CachingReaderChunk::indexForFrame(
+                            m_readableFrameIndexRange.end() - 1);
+                    // Tracks that don't fit are read on demand as usual
+                    if (lastChunkIndex - firstChunkIndex < m_chunkCount) {
+                        m_preloadChunkIndex = firstChunkIndex;
+                        m_preloadEndChunkIndex = lastChunkIndex + 1;
+                    }
+                }
                 m_state.storeRelease(STATE_TRACK_LOADED);
             } else {
                 DEBUG_ASSERT(update.status == TRACK_UNLOADED);
+                m_pResidentSamples = nullptr;
+                m_residentFrameIndexRange = mixxx::IndexRange();
+                m_cacheResidentCO.forceSet(0.0);
                 // This message could be processed later when a new
                 // track is already loading! In this case the TRACK_LOADED will
                 // be the very next status update.
@@ -342,6 +553,10 @@ CachingReader::ReadResult CachingReader::read(SINT startSample, SINT numSamples,
     // the first chunk and to update m_readableFrameIndexRange
     process();
 
+    if (m_pResidentSamples) {
+        return readResident(sample, numSamples, reverse, buffer);
+    }
+
     auto remainingFrameIndexRange =
             mixxx::IndexRange::forward(
                     CachingReaderChunk::samples2frames(sample),
@@ -432,6 +647,8 @@ CachingReader::ReadResult CachingReader::read(SINT startSample, SINT numSamples,
                 mixxx::IndexRange bufferedFrameIndexRange;
                 const CachingReaderChunkForOwner* const pChunk = lookupChunkAndFreshen(chunkIndex);
                 if (pChunk && (pChunk->getState() == CachingReaderChunkForOwner::READY)) {
+                    ++m_cacheHitCount;
+                    m_cacheStatsDirty = true;
                     if (reverse) {
                         bufferedFrameIndexRange =
                                 pChunk->readBufferedSampleFramesReverse(
@@ -450,6 +667,8 @@ CachingReader::ReadResult CachingReader::read(SINT startSample, SINT numSamples,
                     DEBUG_ASSERT(!pChunk ||
                             (pChunk->getState() == CachingReaderChunkForOwner::READ_PENDING));
                     Counter("CachingReader::read(): Failed to read chunk on cache miss")++;
+                    ++m_cacheMissCount;
+                    m_cacheStatsDirty = true;
                     if (kLogger.traceEnabled()) {
                         kLogger.trace()
                                 << "Cache miss for chunk with index"
@@ -515,12 +734,60 @@ CachingReader::ReadResult CachingReader::read(SINT startSample, SINT numSamples,
     return result;
 }
 
+CachingReader::ReadResult CachingReader::readResident(
+        SINT startSample,
+        SINT numSamples,
+        bool reverse,
+        CSAMPLE* buffer) {
+    DEBUG_ASSERT(m_pResidentSamples);
+    ++m_cacheHitCount;
+    m_cacheStatsDirty = true;
+    const auto frameIndexRange = mixxx::IndexRange::forward(
+            CachingReaderChunk::samples2frames(startSample),
+            CachingReaderChunk::samples2frames(numSamples));
+    const auto residentFrameIndexRange =
+            intersect(frameIndexRange, m_residentFrameIndexRange);
+    auto result = ReadResult::AVAILABLE;
+    if (residentFrameIndexRange != frameIndexRange) {
+        // Silence before and after the track
+        SampleUtil::clear(buffer, numSamples);
+        result = ReadResult::PARTIALLY_AVAILABLE;
+    }
+    if (residentFrameIndexRange.empty()) {
+        return result;
+    }
+    const SINT dstSampleOffset = CachingReaderChunk::frames2samples(
+            residentFrameIndexRange.start() - frameIndexRange.start());
+    const SINT srcSampleOffset = CachingReaderChunk::frames2samples(
+            residentFrameIndexRange.start() - m_residentFrameIndexRange.start());
+    const SINT sampleCount =
+            CachingReaderChunk::frames2samples(residentFrameIndexRange.length());
+    if (reverse) {
+        SampleUtil::copyReverse(
+                buffer + numSamples - dstSampleOffset - sampleCount,
+                m_pResidentSamples + srcSampleOffset,
+                sampleCount);
+    } else {
+        SampleUtil::copy(
+                buffer + dstSampleOffset,
+                m_pResidentSamples + srcSampleOffset,
+                sampleCount);
+    }
+    return result;
+}
+
 void CachingReader::hintAndMaybeWake(const HintVector& hintList) {
     // If no file is loaded, skip.
     if (atomicLoadRelaxed(m_state) != STATE_TRACK_LOADED) {
         return;
     }
 
+    // All samples are already in memory
+    if (m_pResidentSamples) {
+        publishCacheStats();
+        return;
+    }
+
     // For every chunk that the hints indicated, check if it is in the cache. If
     // any are not, then wake.
     bool shouldWake = false;
@@ -579,7 +846,10 @@ void CachingReader::hintAndMaybeWake(const HintVector& hintList) {
                             << "Requesting read of chunk"
                             << request.chunk;
                 }
-                if (m_chunkReadRequestFIFO.write(&request, 1) != 1) {
+                auto* const pRequestFIFO = hint.isPrefetch()
+                        ? &m_chunkPrefetchRequestFIFO
+                        : &m_chunkReadRequestFIFO;
+                if (pRequestFIFO->write(&request, 1) != 1) {
                     kLogger.warning()
                             << "Failed to submit read request for chunk"
                             << chunkIndex;
@@ -595,8 +865,46 @@ void CachingReader::hintAndMaybeWake(const HintVector& hintList) {
         }
     }
 
+    // Preload the remaining chunks after the hinted chunks have been
+    // requested
+    if (submitPreloadRequests()) {
+        shouldWake = true;
+    }
+
     // If there are chunks to be read, wake up.
     if (shouldWake) {
         m_worker.workReady();
     }
+
+    publishCacheStats();
+}
+
+bool CachingReader::submitPreloadRequests() {
+    bool submitted = false;
+    while (m_preloadChunkIndex < m_preloadEndChunkIndex) {
+        const SINT chunkIndex = m_preloadChunkIndex;
+        if (!lookupChunk(chunkIndex)) {
+            // The whole track fits, i.e. no chunk needs to be evicted
+            auto* pChunk = allocateChunk(chunkIndex);
+            if (!pChunk) {
+                kLogger.warning()
+                        << "Failed to allocate chunk"
+                        << chunkIndex
+                        << "for preloading";
+                m_preloadChunkIndex = m_preloadEndChunkIndex;
+                break;
+            }
+            CachingReaderChunkReadRequest request;
+            request.giveToWorker(pChunk);
+            if (m_chunkPrefetchRequestFIFO.write(&request, 1) != 1) {
+                // Retry with the next callback
+                pChunk->takeFromWorker();
+                freeChunk(pChunk);
+                break;
+            }
+            submitted = true;
+        }
+        ++m_preloadChunkIndex;
+    }
+    return submitted;
 }
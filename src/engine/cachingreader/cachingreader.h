@@ -1,12 +1,15 @@
 #pragma once
 
 #include <QAtomicInt>
-#include <QHash>
 #include <QList>
 #include <QVarLengthArray>
 #include <QVector>
-#include <list>
+#include <vector>
 
+#include "control/controlobject.h"
+#include "control/controlpushbutton.h"
+#include "engine/cachingreader/cachingreaderchunkindex.h"
+#include "engine/cachingreader/cachingreaderchunkpool.h"
 #include "engine/cachingreader/cachingreaderworker.h"
 #include "preferences/usersettings.h"
 #include "track/track_decl.h"
@@ -28,7 +31,8 @@ typedef struct Hint {
         FirstSound,
         IntroStart,
         IntroEnd,
-        OutroStart
+        OutroStart,
+        BeatJump, // prio 20
     };
 
     // The frame to ensure is present in memory.
@@ -43,6 +47,23 @@ typedef struct Hint {
     // for the default frame count in forward direction
     static constexpr SINT kFrameCountForward = 0;
     static constexpr SINT kFrameCountBackward = -1;
+
+    // Hints for positions that are needed very soon are read immediately.
+    // All other hints refer to positions that the user might jump to,
+    // e.g. cue points or beatjump targets. They are prefetched by the
+    // worker with a lower priority, i.e. only when no immediate reads
+    // are pending.
+    bool isPrefetch() const {
+        switch (type) {
+        case Type::SlipPosition:
+        case Type::CurrentPosition:
+        case Type::LoopStartEnabled:
+        case Type::LoopEndEnabled:
+            return false;
+        default:
+            return true;
+        }
+    }
 } Hint;
 
 // Note that we use a QVarLengthArray here instead of a QVector. Since this list
@@ -76,6 +97,28 @@ typedef QVarLengthArray<Hint, 512> HintVector;
 // least-recently-used list. When a chunk needs to be allocated and there are no
 // free chunks then the least recently used chunk is free'd (see
 // allocateChunkExpireLRU).
+//
+// All bookkeeping structures (the chunk index, the free list and the
+// intrusive MRU/LRU list) are preallocated when the reader is constructed.
+// Looking up, allocating, freshening and evicting chunks never allocates
+// memory and is safe to use from the engine callback.
+//
+// Samplers preload the whole track after loading if it fits into their
+// chunks. The chunks are decoded by the worker thread of each sampler,
+// i.e. all samplers of a sampler bank are decoded in parallel. Since no
+// other chunks are needed the track stays resident and playback never
+// suffers a cache miss.
+//
+// Short tracks, and tracks that have been loaded while the load_into_ram
+// control of the group was enabled, are decoded into one contiguous
+// buffer by the worker while it is idle. Once the whole track is resident
+// reads are served directly from that buffer without any chunk lookups
+// or read requests.
+//
+// The number of chunks is configurable per player type (deck, sampler,
+// preview deck). All readers share a common memory budget. The effective
+// number of chunks and the cache statistics (hits, misses, evictions) are
+// published as read-only controls of the corresponding group.
 class CachingReader : public QObject {
     Q_OBJECT
 
@@ -117,6 +160,21 @@ class CachingReader : public QObject {
         m_worker.setScheduler(pScheduler);
     }
 
+    // The number of chunks that have been allocated for this reader.
+    SINT chunkCount() const {
+        return m_chunkCount;
+    }
+
+    // The number of chunks that were not available when read. Must only
+    // be called from the engine thread.
+    SINT cacheMissCount() const {
+        return m_cacheMissCount;
+    }
+
+    // The total amount of memory that is occupied by the chunks of
+    // all readers, in bytes.
+    static SINT totalChunkMemoryBytes();
+
   signals:
     // Emitted once a new track is loaded and ready to be read from.
     void trackLoading();
@@ -124,11 +182,49 @@ class CachingReader : public QObject {
     void trackLoadFailed(TrackPointer pTrack, const QString& reason);
 
   private:
+    // Determines the number of chunks for the given player group and
+    // reserves them from the global memory budget.
+    static SINT reserveChunkCount(
+            const QString& group,
+            const UserSettingsPointer& pConfig);
+
+    // Contributes the sample memory of the chunks to the pool and starts
+    // the worker. Readers of players that never load a track, e.g. most
+    // samplers of a large sampler bank, stay dormant without any sample
+    // memory or worker thread.
+    void activate();
+
+    // Updates the controls with the cache statistics. Must only be called
+    // from the engine callback.
+    void publishCacheStats();
+
+    ReadResult readResident(
+            SINT startSample,
+            SINT numSamples,
+            bool reverse,
+            CSAMPLE* buffer);
+
+    // Submits read requests for the chunks of the track that have not
+    // been preloaded yet. Returns true if the worker needs to be woken.
+    // Must only be called from the engine callback.
+    bool submitPreloadRequests();
+
+    const QString m_group;
     const UserSettingsPointer m_pConfig;
 
+    const SINT m_chunkCount;
+
+    const bool m_preloadEnabled;
+    // The range of chunks that still need to be preloaded, only
+    // accessed by the engine thread.
+    SINT m_preloadChunkIndex;
+    SINT m_preloadEndChunkIndex;
+
     // Thread-safe FIFOs for communication between the engine callback and
     // reader thread.
     FIFO<CachingReaderChunkReadRequest> m_chunkReadRequestFIFO;
+    // Low priority requests for chunks that might be needed later
+    FIFO<CachingReaderChunkReadRequest> m_chunkPrefetchRequestFIFO;
     FIFO<ReaderStatusUpdate> m_readerStatusUpdateFIFO;
 
     // Looks for the provided chunk number in the index of in-memory chunks and
@@ -167,23 +263,44 @@ class CachingReader : public QObject {
     // Keeps track of all CachingReaderChunks we've allocated.
     QVector<CachingReaderChunkForOwner*> m_chunks;
 
-    // List of free chunks. Linked list so that we have constant time insertions
-    // and deletions. Iteration is not necessary.
-    std::list<CachingReaderChunkForOwner*> m_freeChunks;
+    // Stack of free chunks with a fixed capacity that is reserved upfront
+    // for all chunks. Constant time insertions and deletions without any
+    // memory allocations. Iteration is not necessary.
+    std::vector<CachingReaderChunkForOwner*> m_freeChunks;
 
     // Keeps track of what CachingReaderChunks we've allocated and indexes them based on what
     // chunk number they are allocated to.
-    QHash<int, CachingReaderChunkForOwner*> m_allocatedCachingReaderChunks;
+    CachingReaderChunkIndex m_allocatedCachingReaderChunks;
 
     // The linked list of recently-used chunks.
     CachingReaderChunkForOwner* m_mruCachingReaderChunk;
     CachingReaderChunkForOwner* m_lruCachingReaderChunk;
 
-    // The raw memory buffer which is divided up into chunks.
-    mixxx::SampleBuffer m_sampleBuffer;
+    // The sample memory for the chunks that has been contributed to the
+    // shared pool, nullptr until the first track is loaded. Only accessed
+    // from the UI thread.
+    CachingReaderChunkPool::Block* m_pChunkPoolBlock;
 
     // The readable frame index range as reported by the worker.
     mixxx::IndexRange m_readableFrameIndexRange;
 
+    // The samples of the whole track if it has been decoded into memory,
+    // owned by the worker. Only accessed by the engine thread.
+    const CSAMPLE* m_pResidentSamples;
+    mixxx::IndexRange m_residentFrameIndexRange;
+
+    // Cache statistics, only accessed by the engine thread.
+    SINT m_cacheHitCount;
+    SINT m_cacheMissCount;
+    SINT m_cacheEvictionCount;
+    bool m_cacheStatsDirty;
+
+    ControlObject m_cacheChunkCountCO;
+    ControlObject m_cacheHitCountCO;
+    ControlObject m_cacheMissCountCO;
+    ControlObject m_cacheEvictionCountCO;
+    ControlObject m_cacheResidentCO;
+    ControlPushButton m_loadIntoRamCO;
+
     CachingReaderWorker m_worker;
 };
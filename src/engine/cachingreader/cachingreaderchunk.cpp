@@ -29,11 +29,43 @@ const SINT CachingReaderChunk::kFrames = 8192; // ~ 170 ms at 48 kHz
 const SINT CachingReaderChunk::kSamples =
         CachingReaderChunk::frames2samples(CachingReaderChunk::kFrames);
 
-CachingReaderChunk::CachingReaderChunk(
-        mixxx::SampleBuffer::WritableSlice sampleBuffer)
+CachingReaderChunk::CachingReaderChunk()
         : m_index(kInvalidChunkIndex),
-          m_sampleBuffer(std::move(sampleBuffer)) {
-    DEBUG_ASSERT(m_sampleBuffer.length() == kSamples);
+          m_pBuffer(nullptr),
+          m_pSamples(nullptr) {
+}
+
+CachingReaderChunk::~CachingReaderChunk() {
+    // Must have been released to the pool
+    DEBUG_ASSERT(!m_pBuffer);
+}
+
+void CachingReaderChunk::attachBuffer(
+        CachingReaderChunkBuffer* pBuffer,
+        CSAMPLE* pSamples) {
+    DEBUG_ASSERT(!m_pBuffer);
+    DEBUG_ASSERT(pSamples);
+    m_pBuffer = pBuffer;
+    m_pSamples = pSamples;
+    m_bufferedSampleFrames = mixxx::ReadableSampleFrames();
+}
+
+void CachingReaderChunk::detachBuffer() {
+    m_pBuffer = nullptr;
+    m_pSamples = nullptr;
+    m_bufferedSampleFrames = mixxx::ReadableSampleFrames();
+}
+
+mixxx::IndexRange CachingReaderChunk::bufferSharedSampleFrames(
+        const mixxx::IndexRange& frameIndexRange) {
+    DEBUG_ASSERT(m_index != kInvalidChunkIndex);
+    DEBUG_ASSERT(m_pSamples);
+    m_bufferedSampleFrames = mixxx::ReadableSampleFrames(
+            frameIndexRange,
+            mixxx::SampleBuffer::ReadableSlice(
+                    m_pSamples,
+                    frames2samples(frameIndexRange.length())));
+    return m_bufferedSampleFrames.frameIndexRange();
 }
 
 void CachingReaderChunk::init(SINT index) {
@@ -61,6 +93,7 @@ mixxx::IndexRange CachingReaderChunk::bufferSampleFrames(
         const mixxx::AudioSourcePointer& pAudioSource,
         mixxx::SampleBuffer::WritableSlice tempOutputBuffer) {
     DEBUG_ASSERT(m_index != kInvalidChunkIndex);
+    DEBUG_ASSERT(m_pSamples);
     const auto sourceFrameIndexRange = frameIndexRange(pAudioSource);
     mixxx::AudioSourceStereoProxy audioSourceProxy(
             pAudioSource,
@@ -72,12 +105,34 @@ mixxx::IndexRange CachingReaderChunk::bufferSampleFrames(
             audioSourceProxy.readSampleFrames(
                     mixxx::WritableSampleFrames(
                             sourceFrameIndexRange,
-                            mixxx::SampleBuffer::WritableSlice(m_sampleBuffer)));
+                            mixxx::SampleBuffer::WritableSlice(m_pSamples, kSamples)));
     DEBUG_ASSERT(m_bufferedSampleFrames.frameIndexRange().empty() ||
             m_bufferedSampleFrames.frameIndexRange().isSubrangeOf(sourceFrameIndexRange));
     return m_bufferedSampleFrames.frameIndexRange();
 }
 
+mixxx::IndexRange CachingReaderChunk::bufferSampleFramesFromMemory(
+        const CSAMPLE* pChunkSamples,
+        const mixxx::IndexRange& frameIndexRange) {
+    DEBUG_ASSERT(m_index != kInvalidChunkIndex);
+    DEBUG_ASSERT(pChunkSamples);
+    DEBUG_ASSERT(m_pSamples);
+    DEBUG_ASSERT(frameIndexRange.orientation() != mixxx::IndexRange::Orientation::Backward);
+    DEBUG_ASSERT(frameIndexRange.length() <= kFrames);
+    // The first frame of the chunk is located at the start of the range
+    const SINT sampleCount = frames2samples(frameIndexRange.length());
+    SampleUtil::copy(
+            m_pSamples,
+            pChunkSamples,
+            sampleCount);
+    m_bufferedSampleFrames = mixxx::ReadableSampleFrames(
+            frameIndexRange,
+            mixxx::SampleBuffer::ReadableSlice(
+                    m_pSamples,
+                    sampleCount));
+    return m_bufferedSampleFrames.frameIndexRange();
+}
+
 mixxx::IndexRange CachingReaderChunk::readBufferedSampleFrames(
         CSAMPLE* sampleBuffer,
         const mixxx::IndexRange& frameIndexRange) const {
@@ -118,10 +173,8 @@ mixxx::IndexRange CachingReaderChunk::readBufferedSampleFramesReverse(
     return copyableFrameIndexRange;
 }
 
-CachingReaderChunkForOwner::CachingReaderChunkForOwner(
-        mixxx::SampleBuffer::WritableSlice sampleBuffer)
-        : CachingReaderChunk(std::move(sampleBuffer)),
-          m_state(FREE),
+CachingReaderChunkForOwner::CachingReaderChunkForOwner()
+        : m_state(FREE),
           m_pPrev(nullptr),
           m_pNext(nullptr) {
 }
@@ -178,6 +231,9 @@ void CachingReaderChunkForOwner::insertIntoListBefore(
         DEBUG_ASSERT(*ppHead);
         DEBUG_ASSERT(*ppTail);
         m_pPrev = pBefore->m_pPrev;
+        if (m_pPrev) {
+            m_pPrev->m_pNext = this;
+        }
         pBefore->m_pPrev = this;
         m_pNext = pBefore;
         if (*ppHead == pBefore) {
@@ -2,6 +2,8 @@
 
 #include "sources/audiosource.h"
 
+struct CachingReaderChunkBuffer;
+
 // A Chunk is a memory-resident section of audio that has been cached.
 // Each chunk holds a fixed number kFrames of frames with samples for
 // kChannels.
@@ -13,6 +15,10 @@
 //
 // This is the common (abstract) base class for both the cache (as the owner)
 // and the worker.
+//
+// The samples are stored in a buffer of the CachingReaderChunkPool that
+// the worker attaches before filling the chunk. The buffer might be shared
+// with the chunks of other readers.
 class CachingReaderChunk {
 public:
     static const mixxx::audio::ChannelCount kChannels;
@@ -53,12 +59,24 @@ public:
     mixxx::IndexRange frameIndexRange(
             const mixxx::AudioSourcePointer& pAudioSource) const;
 
+    mixxx::IndexRange bufferedFrameIndexRange() const {
+        return m_bufferedSampleFrames.frameIndexRange();
+    }
+
     // Read sample frames from the audio source and return the
     // range of frames that have been read.
     mixxx::IndexRange bufferSampleFrames(
             const mixxx::AudioSourcePointer& pAudioSource,
             mixxx::SampleBuffer::WritableSlice tempOutputBuffer);
 
+    // Copy sample frames that have been decoded before and return the
+    // range of frames that have been copied. The samples are expected
+    // in the same layout as a chunk, i.e. starting at the first frame
+    // of the chunk.
+    mixxx::IndexRange bufferSampleFramesFromMemory(
+            const CSAMPLE* pChunkSamples,
+            const mixxx::IndexRange& frameIndexRange);
+
     mixxx::IndexRange readBufferedSampleFrames(
             CSAMPLE* sampleBuffer,
             const mixxx::IndexRange& frameIndexRange) const;
@@ -67,22 +85,32 @@ public:
             const mixxx::IndexRange& frameIndexRange) const;
 
 protected:
-    explicit CachingReaderChunk(
-            mixxx::SampleBuffer::WritableSlice sampleBuffer);
-    virtual ~CachingReaderChunk() = default;
+    CachingReaderChunk();
+    virtual ~CachingReaderChunk();
 
+    // Keeps the attached buffer, which is only released by the worker
     void init(SINT index);
 
 private:
+    friend class CachingReaderChunkPool;
+
     SINT frameIndexOffset() const {
         return m_index * kFrames;
     }
 
+    void attachBuffer(CachingReaderChunkBuffer* pBuffer, CSAMPLE* pSamples);
+    void detachBuffer();
+    // Refers to the samples of the attached buffer that have already
+    // been decoded.
+    mixxx::IndexRange bufferSharedSampleFrames(
+            const mixxx::IndexRange& frameIndexRange);
+
     SINT m_index;
 
     // The worker thread will fill the sample buffer and
     // set the corresponding frame index range.
-    mixxx::SampleBuffer::WritableSlice m_sampleBuffer;
+    CachingReaderChunkBuffer* m_pBuffer;
+    CSAMPLE* m_pSamples;
     mixxx::ReadableSampleFrames m_bufferedSampleFrames;
 };
 
@@ -91,8 +119,7 @@ private:
 // the worker thread is in control.
 class CachingReaderChunkForOwner: public CachingReaderChunk {
 public:
-    explicit CachingReaderChunkForOwner(
-            mixxx::SampleBuffer::WritableSlice sampleBuffer);
+    CachingReaderChunkForOwner();
     ~CachingReaderChunkForOwner() override = default;
 
     void init(SINT index);
@@ -0,0 +1,106 @@
+#include "engine/cachingreader/cachingreaderchunkindex.h"
+
+#include <cstdint>
+
+#include "util/assert.h"
+#include "util/math.h"
+
+namespace {
+
+// Keep the load factor at or below 1/2 to guarantee short probe
+// sequences.
+constexpr SINT kSlotsPerEntry = 2;
+
+// Chunk indices of a track are consecutive integers. Fibonacci hashing
+// distributes those sequences evenly across the table instead of
+// occupying a single contiguous block of slots.
+constexpr std::uint32_t kFibonacciMultiplier = 2654435769u;
+
+SINT slotCountForMaxSize(SINT maxSize) {
+    DEBUG_ASSERT(maxSize > 0);
+    return static_cast<SINT>(roundUpToPowerOf2(
+            static_cast<unsigned int>(maxSize * kSlotsPerEntry)));
+}
+
+} // anonymous namespace
+
+CachingReaderChunkIndex::CachingReaderChunkIndex(SINT maxSize)
+        : m_maxSize(maxSize),
+          m_slots(slotCountForMaxSize(maxSize), Slot{0, nullptr}),
+          m_slotMask(static_cast<SINT>(m_slots.size()) - 1),
+          m_size(0) {
+    // The slot count must be a power of 2 for masking
+    DEBUG_ASSERT((static_cast<SINT>(m_slots.size()) & m_slotMask) == 0);
+}
+
+SINT CachingReaderChunkIndex::homeSlot(SINT chunkIndex) const {
+    const auto hash = static_cast<std::uint32_t>(chunkIndex) * kFibonacciMultiplier;
+    // Use the high-order bits, they are mixed best
+    return static_cast<SINT>(hash >> 16) & m_slotMask;
+}
+
+SINT CachingReaderChunkIndex::findSlot(SINT chunkIndex) const {
+    SINT slot = homeSlot(chunkIndex);
+    // Terminates, because the table is never full
+    while (!m_slots[slot].isEmpty() &&
+            m_slots[slot].chunkIndex != chunkIndex) {
+        slot = nextSlot(slot);
+    }
+    return slot;
+}
+
+CachingReaderChunkForOwner* CachingReaderChunkIndex::value(SINT chunkIndex) const {
+    return m_slots[findSlot(chunkIndex)].pChunk;
+}
+
+bool CachingReaderChunkIndex::insert(
+        SINT chunkIndex, CachingReaderChunkForOwner* pChunk) {
+    DEBUG_ASSERT(pChunk);
+    Slot& slot = m_slots[findSlot(chunkIndex)];
+    if (slot.isEmpty()) {
+        VERIFY_OR_DEBUG_ASSERT(m_size < m_maxSize) {
+            return false;
+        }
+        slot.chunkIndex = chunkIndex;
+        ++m_size;
+    }
+    slot.pChunk = pChunk;
+    return true;
+}
+
+int CachingReaderChunkIndex::remove(SINT chunkIndex) {
+    SINT hole = findSlot(chunkIndex);
+    if (m_slots[hole].isEmpty()) {
+        return 0;
+    }
+    m_slots[hole].pChunk = nullptr;
+    DEBUG_ASSERT(m_size > 0);
+    --m_size;
+    // Backward shift deletion: Move subsequent entries of the probe
+    // sequence into the hole unless they are already located between
+    // their home slot and the hole.
+    SINT slot = nextSlot(hole);
+    while (!m_slots[slot].isEmpty()) {
+        const SINT home = homeSlot(m_slots[slot].chunkIndex);
+        // Cyclic distances from the home slot
+        const SINT distToSlot = (slot - home) & m_slotMask;
+        const SINT distToHole = (hole - home) & m_slotMask;
+        if (distToHole < distToSlot) {
+            m_slots[hole] = m_slots[slot];
+            m_slots[slot].pChunk = nullptr;
+            hole = slot;
+        }
+        slot = nextSlot(slot);
+    }
+    return 1;
+}
+
+void CachingReaderChunkIndex::clear() {
+    if (m_size == 0) {
+        return;
+    }
+    for (auto& slot : m_slots) {
+        slot.pChunk = nullptr;
+    }
+    m_size = 0;
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <vector>
+
+#include "util/types.h"
+
+class CachingReaderChunkForOwner;
+
+// A fixed-capacity hash table that maps chunk indices to the chunks
+// that are currently allocated by a CachingReader.
+//
+// All memory is allocated once in the constructor. Neither lookups,
+// insertions nor removals allocate or rehash, which makes this index
+// safe to use from the real-time engine thread. It uses open
+// addressing with linear probing and backward shift deletion, i.e.
+// no tombstones accumulate over time and the probe sequences stay
+// short even after a long session with many seeks.
+//
+// The table is sized to keep the load factor at or below 50% when
+// holding the maximum number of entries.
+//
+// The class is not thread-safe and must only be accessed by the owner
+// of the chunks, i.e. the engine thread.
+class CachingReaderChunkIndex final {
+  public:
+    explicit CachingReaderChunkIndex(SINT maxSize);
+
+    SINT maxSize() const {
+        return m_maxSize;
+    }
+    SINT size() const {
+        return m_size;
+    }
+    bool isEmpty() const {
+        return m_size == 0;
+    }
+
+    // Returns nullptr if no chunk has been inserted for chunkIndex.
+    CachingReaderChunkForOwner* value(SINT chunkIndex) const;
+
+    // Inserts or replaces the chunk for chunkIndex. Returns false
+    // if the maximum size would be exceeded.
+    bool insert(SINT chunkIndex, CachingReaderChunkForOwner* pChunk);
+
+    // Returns the number of removed entries, i.e. either 0 or 1.
+    int remove(SINT chunkIndex);
+
+    void clear();
+
+  private:
+    struct Slot {
+        SINT chunkIndex;
+        CachingReaderChunkForOwner* pChunk;
+
+        bool isEmpty() const {
+            return pChunk == nullptr;
+        }
+    };
+
+    SINT homeSlot(SINT chunkIndex) const;
+    SINT nextSlot(SINT slot) const {
+        return (slot + 1) & m_slotMask;
+    }
+    // Returns either the slot that contains chunkIndex or the
+    // empty slot that terminates the probe sequence.
+    SINT findSlot(SINT chunkIndex) const;
+
+    const SINT m_maxSize;
+    std::vector<Slot> m_slots;
+    const SINT m_slotMask;
+    SINT m_size;
+};
@@ -0,0 +1,259 @@
+#include "engine/cachingreader/cachingreaderchunkpool.h"
+
+#include <algorithm>
+
+#include "engine/cachingreader/cachingreaderchunk.h"
+#include "util/assert.h"
+#include "util/compatibility/qmutex.h"
+#include "util/logger.h"
+#include "util/sample.h"
+#include "util/samplebuffer.h"
+
+namespace {
+
+mixxx::Logger kLogger("CachingReaderChunkPool");
+
+} // anonymous namespace
+
+struct CachingReaderChunkBuffer {
+    CSAMPLE* pSamples;
+    CachingReaderChunkPool::Block* pBlock;
+    // The number of chunks that refer to the buffer
+    int refCount;
+    // Only set while published
+    bool published;
+    QString trackKey;
+    SINT chunkIndex;
+    mixxx::IndexRange frameIndexRange;
+};
+
+struct CachingReaderChunkPool::Block {
+    mixxx::SampleBuffer sampleBuffer;
+    std::vector<CachingReaderChunkBuffer> buffers;
+    // The number of buffers with a reference
+    SINT referencedCount = 0;
+    bool removed = false;
+};
+
+// static
+CachingReaderChunkPool& CachingReaderChunkPool::instance() {
+    static CachingReaderChunkPool s_instance;
+    return s_instance;
+}
+
+CachingReaderChunkPool::CachingReaderChunkPool() = default;
+
+CachingReaderChunkPool::~CachingReaderChunkPool() {
+    // All readers must have been destroyed before
+    DEBUG_ASSERT(m_blocks.empty());
+}
+
+CachingReaderChunkPool::Block* CachingReaderChunkPool::addBlock(SINT chunkCount) {
+    auto pBlock = std::make_unique<Block>();
+    pBlock->sampleBuffer = mixxx::SampleBuffer::allocateLocked(
+            CachingReaderChunk::kSamples * chunkCount);
+    pBlock->buffers.resize(chunkCount);
+    for (SINT i = 0; i < chunkCount; ++i) {
+        auto& buffer = pBlock->buffers[i];
+        buffer.pSamples = pBlock->sampleBuffer.data(CachingReaderChunk::kSamples * i);
+        buffer.pBlock = pBlock.get();
+        buffer.refCount = 0;
+        buffer.published = false;
+        buffer.chunkIndex = 0;
+    }
+    const auto locker = lockMutex(&m_mutex);
+    for (auto& buffer : pBlock->buffers) {
+        m_unreferencedBuffers.append(&buffer);
+    }
+    m_blocks.push_back(std::move(pBlock));
+    return m_blocks.back().get();
+}
+
+void CachingReaderChunkPool::removeBlock(Block* pBlock) {
+    DEBUG_ASSERT(pBlock);
+    const auto locker = lockMutex(&m_mutex);
+    DEBUG_ASSERT(!pBlock->removed);
+    pBlock->removed = true;
+    // Only the buffers that are still shared with other readers remain
+    for (auto& buffer : pBlock->buffers) {
+        if (buffer.refCount == 0) {
+            unpublishLocked(&buffer);
+            m_unreferencedBuffers.removeOne(&buffer);
+        }
+    }
+    if (pBlock->referencedCount == 0) {
+        freeBlockLocked(pBlock);
+    }
+}
+
+void CachingReaderChunkPool::freeBlockLocked(Block* pBlock) {
+    DEBUG_ASSERT(pBlock->removed);
+    DEBUG_ASSERT(pBlock->referencedCount == 0);
+    const auto it = std::find_if(m_blocks.begin(),
+            m_blocks.end(),
+            [pBlock](const auto& pOther) { return pOther.get() == pBlock; });
+    VERIFY_OR_DEBUG_ASSERT(it != m_blocks.end()) {
+        return;
+    }
+    m_blocks.erase(it);
+}
+
+void CachingReaderChunkPool::unpublishLocked(CachingReaderChunkBuffer* pBuffer) {
+    if (!pBuffer->published) {
+        return;
+    }
+    m_publishedBuffers.remove(ChunkKey{pBuffer->trackKey, pBuffer->chunkIndex});
+    pBuffer->published = false;
+    pBuffer->trackKey.clear();
+}
+
+void CachingReaderChunkPool::releaseLocked(CachingReaderChunk* pChunk) {
+    CachingReaderChunkBuffer* pBuffer = pChunk->m_pBuffer;
+    if (!pBuffer) {
+        return;
+    }
+    pChunk->detachBuffer();
+    DEBUG_ASSERT(pBuffer->refCount > 0);
+    if (--pBuffer->refCount > 0) {
+        return;
+    }
+    Block* pBlock = pBuffer->pBlock;
+    --pBlock->referencedCount;
+    if (!pBlock->removed) {
+        // Keep the samples until the buffer is reused
+        m_unreferencedBuffers.append(pBuffer);
+        return;
+    }
+    unpublishLocked(pBuffer);
+    if (pBlock->referencedCount == 0) {
+        freeBlockLocked(pBlock);
+    }
+}
+
+void CachingReaderChunkPool::attachLocked(
+        CachingReaderChunk* pChunk,
+        CachingReaderChunkBuffer* pBuffer) {
+    DEBUG_ASSERT(!pChunk->m_pBuffer);
+    if (pBuffer->refCount++ == 0) {
+        ++pBuffer->pBlock->referencedCount;
+    }
+    pChunk->attachBuffer(pBuffer, pBuffer->pSamples);
+}
+
+void CachingReaderChunkPool::release(CachingReaderChunk* pChunk) {
+    DEBUG_ASSERT(pChunk);
+    const auto locker = lockMutex(&m_mutex);
+    releaseLocked(pChunk);
+}
+
+mixxx::IndexRange CachingReaderChunkPool::attachShared(
+        CachingReaderChunk* pChunk,
+        const QString& trackKey,
+        mixxx::IndexRange chunkFrameIndexRange) {
+    DEBUG_ASSERT(pChunk);
+    if (trackKey.isEmpty()) {
+        return mixxx::IndexRange();
+    }
+    const auto locker = lockMutex(&m_mutex);
+    CachingReaderChunkBuffer* pBuffer =
+            m_publishedBuffers.value(ChunkKey{trackKey, pChunk->getIndex()});
+    if (!pBuffer || pBuffer->frameIndexRange != chunkFrameIndexRange) {
+        return mixxx::IndexRange();
+    }
+    if (pBuffer != pChunk->m_pBuffer) {
+        if (pBuffer->refCount == 0) {
+            m_unreferencedBuffers.removeOne(pBuffer);
+        }
+        releaseLocked(pChunk);
+        attachLocked(pChunk, pBuffer);
+    }
+    return pChunk->bufferSharedSampleFrames(pBuffer->frameIndexRange);
+}
+
+bool CachingReaderChunkPool::attachExclusive(CachingReaderChunk* pChunk) {
+    DEBUG_ASSERT(pChunk);
+    const auto locker = lockMutex(&m_mutex);
+    CachingReaderChunkBuffer* pBuffer = pChunk->m_pBuffer;
+    if (pBuffer && pBuffer->refCount == 1 && !pBuffer->published) {
+        // Already exclusive
+        return true;
+    }
+    releaseLocked(pChunk);
+    VERIFY_OR_DEBUG_ASSERT(!m_unreferencedBuffers.isEmpty()) {
+        kLogger.warning()
+                << "No unreferenced buffer available";
+        return false;
+    }
+    pBuffer = m_unreferencedBuffers.takeFirst();
+    DEBUG_ASSERT(pBuffer->refCount == 0);
+    // Evict the previous samples
+    unpublishLocked(pBuffer);
+    pBuffer->frameIndexRange = mixxx::IndexRange();
+    attachLocked(pChunk, pBuffer);
+    return true;
+}
+
+void CachingReaderChunkPool::publish(
+        const CachingReaderChunk& chunk,
+        const QString& trackKey) {
+    CachingReaderChunkBuffer* pBuffer = chunk.m_pBuffer;
+    VERIFY_OR_DEBUG_ASSERT(pBuffer) {
+        return;
+    }
+    if (trackKey.isEmpty()) {
+        return;
+    }
+    const auto locker = lockMutex(&m_mutex);
+    DEBUG_ASSERT(pBuffer->refCount == 1);
+    DEBUG_ASSERT(!pBuffer->published);
+    const ChunkKey key{trackKey, chunk.getIndex()};
+    if (m_publishedBuffers.contains(key)) {
+        // Another reader has decoded the same chunk concurrently
+        return;
+    }
+    pBuffer->published = true;
+    pBuffer->trackKey = trackKey;
+    pBuffer->chunkIndex = chunk.getIndex();
+    pBuffer->frameIndexRange = chunk.bufferedFrameIndexRange();
+    m_publishedBuffers.insert(key, pBuffer);
+}
+
+bool CachingReaderChunkPool::readShared(
+        const QString& trackKey,
+        SINT chunkIndex,
+        mixxx::IndexRange chunkFrameIndexRange,
+        CSAMPLE* pSamples) const {
+    if (trackKey.isEmpty()) {
+        return false;
+    }
+    const auto locker = lockMutex(&m_mutex);
+    const CachingReaderChunkBuffer* pBuffer =
+            m_publishedBuffers.value(ChunkKey{trackKey, chunkIndex});
+    if (!pBuffer || pBuffer->frameIndexRange != chunkFrameIndexRange) {
+        return false;
+    }
+    // Published samples are not modified until the buffer is reused,
+    // which requires the lock
+    SampleUtil::copy(pSamples,
+            pBuffer->pSamples,
+            CachingReaderChunk::frames2samples(chunkFrameIndexRange.length()));
+    return true;
+}
+
+SINT CachingReaderChunkPool::sharedBufferCount() const {
+    const auto locker = lockMutex(&m_mutex);
+    SINT count = 0;
+    for (const auto& pBlock : m_blocks) {
+        for (const auto& buffer : pBlock->buffers) {
+            if (buffer.refCount > 1) {
+                ++count;
+            }
+        }
+    }
+    return count;
+}
+
+SINT CachingReaderChunkPool::blockCount() const {
+    const auto locker = lockMutex(&m_mutex);
+    return static_cast<SINT>(m_blocks.size());
+}
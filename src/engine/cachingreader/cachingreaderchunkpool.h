@@ -0,0 +1,106 @@
+#pragma once
+
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QString>
+#include <memory>
+#include <vector>
+
+#include "util/compatibility/qhash.h"
+#include "util/indexrange.h"
+#include "util/types.h"
+
+class CachingReaderChunk;
+struct CachingReaderChunkBuffer;
+
+// The sample memory of the chunks of all CachingReaders in the process.
+//
+// Each CachingReader contributes the memory for its own number of chunks,
+// but the chunks are not tied to that memory. Once a chunk of a track has
+// been decoded completely, its buffer is shared read-only with all other
+// chunks that request the same chunk of the same track, e.g. after cloning
+// a deck or loading the track into a sampler. Buffers are reference
+// counted. Each reader still manages its own chunks and LRU list, only the
+// samples are shared. A buffer that is no longer referenced keeps its
+// samples until it is reused, the least recently released buffer first.
+//
+// Because every chunk references at most one buffer there is always an
+// unreferenced buffer available for decoding a chunk.
+//
+// Buffers are only attached and released by the CachingReaderWorkers
+// while they own a chunk, or by the CachingReader after its worker has
+// stopped. The engine thread only reads the samples, so it never needs
+// to lock the pool or free any memory.
+class CachingReaderChunkPool final {
+  public:
+    struct Block;
+
+    // The pool that is shared by all readers
+    static CachingReaderChunkPool& instance();
+
+    CachingReaderChunkPool();
+    ~CachingReaderChunkPool();
+
+    // Adds the memory for the given number of chunks
+    Block* addBlock(SINT chunkCount);
+    // The memory is freed when no chunk refers to it anymore
+    void removeBlock(Block* pBlock);
+
+    // Attaches the shared samples of the chunk if they have already been
+    // decoded for the track. Returns the frame index range of the samples
+    // or an empty range if not available.
+    mixxx::IndexRange attachShared(
+            CachingReaderChunk* pChunk,
+            const QString& trackKey,
+            mixxx::IndexRange chunkFrameIndexRange);
+    // Attaches an unreferenced buffer for decoding the chunk into it.
+    // Returns false if no buffer is available.
+    bool attachExclusive(CachingReaderChunk* pChunk);
+    // Shares the exclusive buffer of a chunk that has been buffered
+    // completely. The samples must not be modified afterwards.
+    void publish(
+            const CachingReaderChunk& chunk,
+            const QString& trackKey);
+    void release(CachingReaderChunk* pChunk);
+
+    // Copies the shared samples of a chunk if available
+    bool readShared(
+            const QString& trackKey,
+            SINT chunkIndex,
+            mixxx::IndexRange chunkFrameIndexRange,
+            CSAMPLE* pSamples) const;
+
+    // The number of buffers that are referenced by more than one chunk
+    SINT sharedBufferCount() const;
+    SINT blockCount() const;
+
+  private:
+    struct ChunkKey {
+        QString trackKey;
+        SINT chunkIndex;
+
+        bool operator==(const ChunkKey& other) const {
+            return chunkIndex == other.chunkIndex && trackKey == other.trackKey;
+        }
+
+        friend qhash_seed_t qHash(
+                const ChunkKey& key,
+                qhash_seed_t seed = 0) {
+            return qHash(key.trackKey, seed) ^ qHash(key.chunkIndex, seed);
+        }
+    };
+
+    void releaseLocked(CachingReaderChunk* pChunk);
+    void attachLocked(CachingReaderChunk* pChunk, CachingReaderChunkBuffer* pBuffer);
+    void unpublishLocked(CachingReaderChunkBuffer* pBuffer);
+    void freeBlockLocked(Block* pBlock);
+
+    mutable QMutex m_mutex;
+    std::vector<std::unique_ptr<Block>> m_blocks;
+    // The published buffers, including those that are not referenced
+    QHash<ChunkKey, CachingReaderChunkBuffer*> m_publishedBuffers;
+    // The unreferenced buffers of all blocks that have not been removed,
+    // least recently released first
+    QList<CachingReaderChunkBuffer*> m_unreferencedBuffers;
+};
@@ -0,0 +1,441 @@
+#include "engine/cachingreader/cachingreaderpcmcache.h"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QFileInfo>
+#include <QHash>
+#include <cstring>
+
+#include "engine/cachingreader/cachingreaderchunk.h"
+#include "util/compatibility/qmutex.h"
+#include "util/fileinfo.h"
+#include "util/logger.h"
+#include "util/math.h"
+#include "util/sample.h"
+
+namespace {
+
+const mixxx::Logger kLogger("CachingReaderPcmCache");
+
+const QString kConfigGroup = QStringLiteral("[CachingReader]");
+
+// The on-disk cache of decoded samples is disabled by default
+const ConfigKey kEnabledConfigKey =
+        ConfigKey(kConfigGroup, QStringLiteral("pcm_cache_enabled"));
+// The maximum size of all cache files in MiB
+const ConfigKey kSizeConfigKey =
+        ConfigKey(kConfigGroup, QStringLiteral("pcm_cache_size_mb"));
+constexpr int kDefaultSizeMB = 4096;
+const QString kDirName = QStringLiteral("pcmcache");
+
+const QString kFileSuffix = QStringLiteral(".pcm");
+
+constexpr char kMagic[8] = {'M', 'X', 'X', 'P', 'C', 'M', '\0', '\0'};
+constexpr quint32 kVersion = 1;
+
+// Align the sample data for SIMD-friendly memcpy
+constexpr qint64 kSampleDataAlignment = 64;
+
+constexpr quint8 kChunkFlagValid = 0x01;
+// The chunk is currently written by one of the instances
+constexpr quint8 kChunkFlagWriting = 0x02;
+
+// Guards the creation, initialization and eviction of cache files
+// that might be opened by multiple instances at the same time.
+QMutex s_openFilesMutex;
+// The number of instances that have opened each file
+QHash<QString, int> s_openFileCounts;
+
+qint64 alignUp(qint64 value, qint64 alignment) {
+    return ((value + alignment - 1) / alignment) * alignment;
+}
+
+} // anonymous namespace
+
+// Fixed-size file header, followed by one flag byte per chunk and the
+// (aligned) sample data of all chunks.
+struct CachingReaderPcmCache::Header {
+    char magic[8];
+    quint32 version;
+    quint32 chunkFrames;
+    quint32 chunkChannels;
+    quint32 sourceChannels;
+    quint32 sourceSampleRate;
+    quint32 chunkCount;
+    qint64 frameIndexMin;
+    qint64 frameIndexMax;
+    qint64 sampleDataOffset;
+};
+
+CachingReaderPcmCache::CachingReaderPcmCache(
+        const QString& cacheDirPath,
+        qint64 maxTotalSizeBytes)
+        : m_cacheDir(cacheDirPath),
+          m_maxTotalSizeBytes(maxTotalSizeBytes),
+          m_pFileData(nullptr),
+          m_pHeader(nullptr),
+          m_pChunkFlags(nullptr),
+          m_pendingChunkIndex(-1),
+          m_pendingChunkFrameEnd(0) {
+}
+
+CachingReaderPcmCache::~CachingReaderPcmCache() {
+    close();
+}
+
+// static
+std::unique_ptr<CachingReaderPcmCache> CachingReaderPcmCache::fromConfig(
+        const UserSettingsPointer& pConfig) {
+    if (!pConfig || !pConfig->getValue(kEnabledConfigKey, false)) {
+        return nullptr;
+    }
+    const qint64 maxTotalSizeBytes =
+            static_cast<qint64>(pConfig->getValue(kSizeConfigKey, kDefaultSizeMB)) *
+            1024 * 1024;
+    return std::make_unique<CachingReaderPcmCache>(
+            QDir(pConfig->getSettingsPath()).filePath(kDirName),
+            maxTotalSizeBytes);
+}
+
+bool CachingReaderPcmCache::open(
+        const mixxx::FileInfo& fileInfo,
+        const mixxx::audio::SignalInfo& signalInfo,
+        mixxx::IndexRange frameIndexRange,
+        bool createIfMissing) {
+    close();
+    if (frameIndexRange.empty() || !signalInfo.isValid()) {
+        return false;
+    }
+    if (!m_cacheDir.exists() && !QDir().mkpath(m_cacheDir.absolutePath())) {
+        kLogger.warning()
+                << "Failed to create cache directory"
+                << m_cacheDir.absolutePath();
+        return false;
+    }
+
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(fileInfo.canonicalLocation().toUtf8());
+    hash.addData(QByteArray::number(fileInfo.sizeInBytes()));
+    hash.addData(QByteArray::number(fileInfo.lastModified().toMSecsSinceEpoch()));
+    const QString fileName = QString::fromLatin1(hash.result().toHex()) + kFileSuffix;
+
+    const SINT chunkCount =
+            CachingReaderChunk::indexForFrame(frameIndexRange.length() - 1) + 1;
+    const qint64 sampleDataOffset = alignUp(
+            static_cast<qint64>(sizeof(Header)) + chunkCount,
+            kSampleDataAlignment);
+    const qint64 fileSize = sampleDataOffset +
+            static_cast<qint64>(chunkCount) * CachingReaderChunk::kSamples *
+                    static_cast<qint64>(sizeof(CSAMPLE));
+
+    const auto locker = lockMutex(&s_openFilesMutex);
+    m_file.setFileName(m_cacheDir.filePath(fileName));
+    const bool shared = s_openFileCounts.value(m_file.fileName()) > 0;
+    const bool exists = m_file.exists();
+    if (!exists && !createIfMissing) {
+        return false;
+    }
+    if (!exists) {
+        evictLeastRecentlyUsedFiles(fileSize);
+    }
+    if (!m_file.open(QIODevice::ReadWrite)) {
+        kLogger.warning()
+                << "Failed to open cache file"
+                << m_file.fileName();
+        return false;
+    }
+    bool initHeader = !exists || m_file.size() != fileSize;
+    if (initHeader && shared) {
+        // Must not be modified while it is mapped by another instance
+        kLogger.warning()
+                << "Cache file"
+                << m_file.fileName()
+                << "is in use with different stream properties";
+        m_file.close();
+        return false;
+    }
+    if (initHeader && !m_file.resize(fileSize)) {
+        kLogger.warning()
+                << "Failed to resize cache file"
+                << m_file.fileName();
+        m_file.close();
+        m_file.remove();
+        return false;
+    }
+    m_pFileData = m_file.map(0, fileSize);
+    if (!m_pFileData) {
+        kLogger.warning()
+                << "Failed to map cache file"
+                << m_file.fileName();
+        m_file.close();
+        return false;
+    }
+    m_pHeader = reinterpret_cast<Header*>(m_pFileData);
+    m_pChunkFlags = m_pFileData + sizeof(Header);
+
+    if (!initHeader) {
+        // Verify that the stream properties are still the same
+        initHeader =
+                std::memcmp(m_pHeader->magic, kMagic, sizeof(kMagic)) != 0 ||
+                m_pHeader->version != kVersion ||
+                static_cast<SINT>(m_pHeader->chunkFrames) != CachingReaderChunk::kFrames ||
+                m_pHeader->chunkChannels != CachingReaderChunk::kChannels ||
+                m_pHeader->sourceChannels != signalInfo.getChannelCount() ||
+                m_pHeader->sourceSampleRate != signalInfo.getSampleRate() ||
+                static_cast<SINT>(m_pHeader->chunkCount) != chunkCount ||
+                m_pHeader->frameIndexMin != frameIndexRange.start() ||
+                m_pHeader->frameIndexMax != frameIndexRange.end() ||
+                m_pHeader->sampleDataOffset != sampleDataOffset;
+        if (initHeader && shared) {
+            kLogger.warning()
+                    << "Cache file"
+                    << m_file.fileName()
+                    << "is in use with different stream properties";
+            m_file.unmap(m_pFileData);
+            m_pFileData = nullptr;
+            m_pHeader = nullptr;
+            m_pChunkFlags = nullptr;
+            m_file.close();
+            return false;
+        }
+        if (initHeader) {
+            kLogger.info()
+                    << "Discarding outdated cache file"
+                    << m_file.fileName();
+        }
+    }
+    if (initHeader) {
+        std::memcpy(m_pHeader->magic, kMagic, sizeof(kMagic));
+        m_pHeader->version = kVersion;
+        m_pHeader->chunkFrames = static_cast<quint32>(CachingReaderChunk::kFrames);
+        m_pHeader->chunkChannels = CachingReaderChunk::kChannels;
+        m_pHeader->sourceChannels = signalInfo.getChannelCount();
+        m_pHeader->sourceSampleRate = signalInfo.getSampleRate();
+        m_pHeader->chunkCount = static_cast<quint32>(chunkCount);
+        m_pHeader->frameIndexMin = frameIndexRange.start();
+        m_pHeader->frameIndexMax = frameIndexRange.end();
+        m_pHeader->sampleDataOffset = sampleDataOffset;
+        std::memset(m_pChunkFlags, 0, chunkCount);
+    } else if (!shared) {
+        // Chunks that have not been written completely before the
+        // previous instance was closed, e.g. after a crash
+        for (SINT chunkIndex = 0; chunkIndex < chunkCount; ++chunkIndex) {
+            m_pChunkFlags[chunkIndex] &= kChunkFlagValid;
+        }
+    }
+    m_frameIndexRange = frameIndexRange;
+    s_openFileCounts[m_file.fileName()] += 1;
+
+    // Touch the file to keep it from being evicted
+    m_file.setFileTime(QDateTime::currentDateTimeUtc(), QFileDevice::FileModificationTime);
+    return true;
+}
+
+void CachingReaderPcmCache::close() {
+    if (!m_pFileData) {
+        DEBUG_ASSERT(!m_file.isOpen());
+        return;
+    }
+    releasePendingChunk();
+    const auto locker = lockMutex(&s_openFilesMutex);
+    if (--s_openFileCounts[m_file.fileName()] <= 0) {
+        s_openFileCounts.remove(m_file.fileName());
+    }
+    m_file.unmap(m_pFileData);
+    m_pFileData = nullptr;
+    m_pHeader = nullptr;
+    m_pChunkFlags = nullptr;
+    m_frameIndexRange = mixxx::IndexRange();
+    if (m_file.isOpen()) {
+        m_file.close();
+    }
+}
+
+std::atomic_ref<quint8> CachingReaderPcmCache::chunkFlags(SINT chunkIndex) const {
+    DEBUG_ASSERT(isOpen());
+    DEBUG_ASSERT(chunkIndex >= 0);
+    DEBUG_ASSERT(chunkIndex < static_cast<SINT>(m_pHeader->chunkCount));
+    return std::atomic_ref<quint8>(m_pChunkFlags[chunkIndex]);
+}
+
+bool CachingReaderPcmCache::isChunkValid(SINT chunkIndex) const {
+    // Synchronizes with the release store after writing the samples
+    return chunkFlags(chunkIndex).load(std::memory_order_acquire) & kChunkFlagValid;
+}
+
+bool CachingReaderPcmCache::tryClaimChunk(SINT chunkIndex) {
+    quint8 expected = 0;
+    return chunkFlags(chunkIndex).compare_exchange_strong(
+            expected, kChunkFlagWriting, std::memory_order_acquire);
+}
+
+void CachingReaderPcmCache::releasePendingChunk() {
+    if (m_pendingChunkIndex < 0) {
+        return;
+    }
+    // Incomplete, another instance may write it
+    chunkFlags(m_pendingChunkIndex).store(0, std::memory_order_release);
+    m_pendingChunkIndex = -1;
+}
+
+mixxx::IndexRange CachingReaderPcmCache::chunkFrameIndexRange(SINT chunkIndex) const {
+    return intersect(
+            mixxx::IndexRange::forward(
+                    chunkIndex * CachingReaderChunk::kFrames,
+                    CachingReaderChunk::kFrames),
+            m_frameIndexRange);
+}
+
+CSAMPLE* CachingReaderPcmCache::chunkSamples(SINT chunkIndex) const {
+    DEBUG_ASSERT(isOpen());
+    return reinterpret_cast<CSAMPLE*>(m_pFileData + m_pHeader->sampleDataOffset) +
+            chunkIndex * CachingReaderChunk::kSamples;
+}
+
+mixxx::IndexRange CachingReaderPcmCache::readChunk(
+        CachingReaderChunk* pChunk,
+        mixxx::IndexRange chunkFrameIndexRange) {
+    DEBUG_ASSERT(pChunk);
+    const SINT chunkIndex = pChunk->getIndex();
+    if (!isOpen() ||
+            chunkIndex < 0 ||
+            chunkIndex >= static_cast<SINT>(m_pHeader->chunkCount) ||
+            !chunkFrameIndexRange.isSubrangeOf(m_frameIndexRange) ||
+            !isChunkValid(chunkIndex)) {
+        return mixxx::IndexRange();
+    }
+    return pChunk->bufferSampleFramesFromMemory(
+            chunkSamples(chunkIndex),
+            chunkFrameIndexRange);
+}
+
+void CachingReaderPcmCache::writeChunk(
+        const CachingReaderChunk& chunk,
+        mixxx::IndexRange chunkFrameIndexRange) {
+    const SINT chunkIndex = chunk.getIndex();
+    if (!isOpen() ||
+            chunkIndex < 0 ||
+            chunkIndex == m_pendingChunkIndex ||
+            !chunkFrameIndexRange.isSubrangeOf(m_frameIndexRange) ||
+            !tryClaimChunk(chunkIndex)) {
+        // Already valid or currently written by another instance
+        return;
+    }
+    const auto copiedFrameIndexRange =
+            chunk.readBufferedSampleFrames(
+                    chunkSamples(chunkIndex),
+                    chunkFrameIndexRange);
+    // Only complete chunks are cached
+    chunkFlags(chunkIndex).store(
+            copiedFrameIndexRange == chunkFrameIndexRange ? kChunkFlagValid : 0,
+            std::memory_order_release);
+}
+
+bool CachingReaderPcmCache::readFrames(
+        mixxx::IndexRange frameIndexRange,
+        CSAMPLE* pSamples) const {
+    DEBUG_ASSERT(pSamples);
+    if (!isOpen() ||
+            frameIndexRange.empty() ||
+            frameIndexRange.orientation() == mixxx::IndexRange::Orientation::Backward ||
+            !frameIndexRange.isSubrangeOf(m_frameIndexRange)) {
+        return false;
+    }
+    const SINT firstChunkIndex = CachingReaderChunk::indexForFrame(frameIndexRange.start());
+    const SINT lastChunkIndex = CachingReaderChunk::indexForFrame(frameIndexRange.end() - 1);
+    if (lastChunkIndex >= static_cast<SINT>(m_pHeader->chunkCount)) {
+        return false;
+    }
+    for (SINT chunkIndex = firstChunkIndex; chunkIndex <= lastChunkIndex; ++chunkIndex) {
+        if (!isChunkValid(chunkIndex)) {
+            return false;
+        }
+    }
+    // Valid chunks are never modified while the file is open
+    for (SINT chunkIndex = firstChunkIndex; chunkIndex <= lastChunkIndex; ++chunkIndex) {
+        const auto chunkRange = chunkFrameIndexRange(chunkIndex);
+        const auto copyRange = intersect(chunkRange, frameIndexRange);
+        SampleUtil::copy(
+                pSamples +
+                        CachingReaderChunk::frames2samples(
+                                copyRange.start() - frameIndexRange.start()),
+                chunkSamples(chunkIndex) +
+                        CachingReaderChunk::frames2samples(
+                                copyRange.start() - chunkRange.start()),
+                CachingReaderChunk::frames2samples(copyRange.length()));
+    }
+    return true;
+}
+
+void CachingReaderPcmCache::writeFrames(
+        mixxx::IndexRange frameIndexRange,
+        const CSAMPLE* pSamples) {
+    DEBUG_ASSERT(pSamples || frameIndexRange.empty());
+    if (!isOpen() ||
+            frameIndexRange.empty() ||
+            frameIndexRange.orientation() == mixxx::IndexRange::Orientation::Backward ||
+            !frameIndexRange.isSubrangeOf(m_frameIndexRange)) {
+        releasePendingChunk();
+        return;
+    }
+    const SINT firstChunkIndex = CachingReaderChunk::indexForFrame(frameIndexRange.start());
+    const SINT lastChunkIndex = math_min(
+            CachingReaderChunk::indexForFrame(frameIndexRange.end() - 1),
+            static_cast<SINT>(m_pHeader->chunkCount) - 1);
+    for (SINT chunkIndex = firstChunkIndex; chunkIndex <= lastChunkIndex; ++chunkIndex) {
+        const auto chunkRange = chunkFrameIndexRange(chunkIndex);
+        const auto copyRange = intersect(chunkRange, frameIndexRange);
+        if (chunkIndex != m_pendingChunkIndex) {
+            releasePendingChunk();
+            // Only chunks that are written from their first frame on
+            // can be completed
+            if (copyRange.start() != chunkRange.start() ||
+                    !tryClaimChunk(chunkIndex)) {
+                continue;
+            }
+            m_pendingChunkIndex = chunkIndex;
+            m_pendingChunkFrameEnd = chunkRange.start();
+        }
+        if (copyRange.start() != m_pendingChunkFrameEnd) {
+            // Not consecutive
+            releasePendingChunk();
+            continue;
+        }
+        SampleUtil::copy(
+                chunkSamples(chunkIndex) +
+                        CachingReaderChunk::frames2samples(
+                                copyRange.start() - chunkRange.start()),
+                pSamples +
+                        CachingReaderChunk::frames2samples(
+                                copyRange.start() - frameIndexRange.start()),
+                CachingReaderChunk::frames2samples(copyRange.length()));
+        m_pendingChunkFrameEnd = copyRange.end();
+        if (m_pendingChunkFrameEnd == chunkRange.end()) {
+            chunkFlags(chunkIndex).store(kChunkFlagValid, std::memory_order_release);
+            m_pendingChunkIndex = -1;
+        }
+    }
+}
+
+void CachingReaderPcmCache::evictLeastRecentlyUsedFiles(qint64 reservedBytes) {
+    if (m_maxTotalSizeBytes <= 0) {
+        return;
+    }
+    // Sorted by modification time, most recently used first
+    const QFileInfoList fileInfos = m_cacheDir.entryInfoList(
+            QStringList{QStringLiteral("*") + kFileSuffix},
+            QDir::Files,
+            QDir::Time);
+    qint64 totalSizeBytes = reservedBytes;
+    for (const auto& fileInfo : fileInfos) {
+        totalSizeBytes += fileInfo.size();
+        if (totalSizeBytes > m_maxTotalSizeBytes &&
+                !s_openFileCounts.contains(fileInfo.filePath())) {
+            kLogger.debug()
+                    << "Evicting cache file"
+                    << fileInfo.filePath();
+            QFile::remove(fileInfo.filePath());
+            totalSizeBytes -= fileInfo.size();
+        }
+    }
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <QDir>
+#include <QFile>
+#include <QString>
+#include <atomic>
+#include <memory>
+
+#include "audio/signalinfo.h"
+#include "preferences/usersettings.h"
+#include "util/indexrange.h"
+#include "util/types.h"
+
+namespace mixxx {
+class FileInfo;
+} // namespace mixxx
+
+class CachingReaderChunk;
+
+// An optional on-disk cache with the decoded sample data of tracks.
+//
+// Each track gets its own sidecar file that is memory-mapped while the
+// track is loaded. The file contains the decoded, interleaved stereo
+// samples of all chunks in the same layout as the CachingReaderChunks.
+// A header stores the properties of the audio stream and a flag for
+// each chunk that has already been decoded completely. Subsequent loads
+// of the same track serve those chunks with a plain memcpy instead of
+// invoking the decoder.
+//
+// Sidecar files are keyed by a hash over the canonical location, the
+// size, and the modification time of the track file. A sidecar is
+// discarded if the decoder reports different stream properties than
+// stored in its header. The total size of all sidecar files is limited,
+// least recently used files are deleted first.
+//
+// The CachingReaderWorkers of the decks and the AnalyzerThreads each use
+// their own instance. Instances that open the same track concurrently
+// share the mapped file, so each chunk is only decoded once while a track
+// is loaded and analyzed at the same time. A chunk is claimed by a single
+// writer and becomes visible to all readers after it has been written
+// completely. Each instance must only be used by a single thread.
+class CachingReaderPcmCache final {
+  public:
+    CachingReaderPcmCache(
+            const QString& cacheDirPath,
+            qint64 maxTotalSizeBytes);
+    ~CachingReaderPcmCache();
+
+    // Returns nullptr if the cache is disabled in the configuration.
+    static std::unique_ptr<CachingReaderPcmCache> fromConfig(
+            const UserSettingsPointer& pConfig);
+
+    bool isOpen() const {
+        return m_pHeader != nullptr;
+    }
+
+    // Opens or creates the sidecar file for a track with the given
+    // stream properties. Without createIfMissing only a sidecar file
+    // that already exists is opened.
+    bool open(
+            const mixxx::FileInfo& fileInfo,
+            const mixxx::audio::SignalInfo& signalInfo,
+            mixxx::IndexRange frameIndexRange,
+            bool createIfMissing = true);
+    void close();
+
+    // Fills the chunk from the cache. Returns an empty range on
+    // a cache miss.
+    mixxx::IndexRange readChunk(
+            CachingReaderChunk* pChunk,
+            mixxx::IndexRange chunkFrameIndexRange);
+
+    // Stores the decoded samples of a chunk in the cache.
+    void writeChunk(
+            const CachingReaderChunk& chunk,
+            mixxx::IndexRange chunkFrameIndexRange);
+
+    // Copies the interleaved stereo samples of arbitrary frames from the
+    // cache. Returns false on a cache miss, i.e. if any of the chunks
+    // has not been decoded completely.
+    bool readFrames(
+            mixxx::IndexRange frameIndexRange,
+            CSAMPLE* pSamples) const;
+
+    // Stores the interleaved stereo samples of arbitrary frames, e.g.
+    // while decoding the whole track sequentially. A chunk is stored if
+    // all of its frames are written by consecutive invocations.
+    void writeFrames(
+            mixxx::IndexRange frameIndexRange,
+            const CSAMPLE* pSamples);
+
+  private:
+    struct Header;
+
+    std::atomic_ref<quint8> chunkFlags(SINT chunkIndex) const;
+    bool isChunkValid(SINT chunkIndex) const;
+    bool tryClaimChunk(SINT chunkIndex);
+    void releasePendingChunk();
+    mixxx::IndexRange chunkFrameIndexRange(SINT chunkIndex) const;
+    CSAMPLE* chunkSamples(SINT chunkIndex) const;
+    void evictLeastRecentlyUsedFiles(qint64 reservedBytes);
+
+    const QDir m_cacheDir;
+    const qint64 m_maxTotalSizeBytes;
+
+    QFile m_file;
+    uchar* m_pFileData;
+    Header* m_pHeader;
+    quint8* m_pChunkFlags;
+    mixxx::IndexRange m_frameIndexRange;
+
+    // The chunk that is claimed by writeFrames() and the end of the
+    // frames that have been written so far
+    SINT m_pendingChunkIndex;
+    SINT m_pendingChunkFrameEnd;
+};
@@ -4,10 +4,13 @@
 #include <QtDebug>
 
 #include "analyzer/analyzersilence.h"
+#include "engine/cachingreader/cachingreaderchunkpool.h"
 #include "moc_cachingreaderworker.cpp"
+#include "sources/audiosourcestereoproxy.h"
 #include "sources/soundsourceproxy.h"
 #include "track/track.h"
 #include "util/compatibility/qmutex.h"
+#include "util/cpuaffinity.h"
 #include "util/event.h"
 #include "util/fifo.h"
 #include "util/logger.h"
@@ -20,16 +23,36 @@ mixxx::Logger kLogger("CachingReaderWorker");
 // we need the last silence frame and the first sound frame
 constexpr SINT kNumSoundFrameToVerify = 2;
 
+// Upper limit for tracks that are explicitly loaded into memory.
+// 20 minutes of stereo samples at 48 kHz occupy about 440 MB.
+constexpr int kMaxLoadIntoRamSeconds = 20 * 60;
+
+// Identifies the decoded samples in the CachingReaderChunkPool. A modified
+// file is decoded again.
+QString chunkPoolTrackKey(const mixxx::FileInfo& fileInfo) {
+    return fileInfo.canonicalLocation() +
+            QChar('|') +
+            QString::number(fileInfo.sizeInBytes()) +
+            QChar('|') +
+            QString::number(fileInfo.lastModified().toMSecsSinceEpoch());
+}
+
 } // anonymous namespace
 
 CachingReaderWorker::CachingReaderWorker(
         const QString& group,
         FIFO<CachingReaderChunkReadRequest>* pChunkReadRequestFIFO,
+        FIFO<CachingReaderChunkReadRequest>* pChunkPrefetchRequestFIFO,
         FIFO<ReaderStatusUpdate>* pReaderStatusFIFO)
         : m_group(group),
           m_tag(QString("CachingReaderWorker %1").arg(m_group)),
           m_pChunkReadRequestFIFO(pChunkReadRequestFIFO),
-          m_pReaderStatusFIFO(pReaderStatusFIFO) {
+          m_pChunkPrefetchRequestFIFO(pChunkPrefetchRequestFIFO),
+          m_pReaderStatusFIFO(pReaderStatusFIFO),
+          m_newTrackLoadIntoRam(false),
+          m_residentMaxSeconds(0),
+          m_residentDecodedEnd(0),
+          m_residentDecoding(false) {
 }
 
 ReaderStatusUpdate CachingReaderWorker::processReadRequest(
@@ -49,6 +72,49 @@ ReaderStatusUpdate CachingReaderWorker::processReadRequest(
         return result;
     }
 
+    // Refer to the samples if the chunk has already been decoded by any
+    // reader, e.g. for another deck that has loaded the same track
+    CachingReaderChunkPool& chunkPool = CachingReaderChunkPool::instance();
+    if (chunkPool.attachShared(pChunk, m_chunkPoolTrackKey, chunkFrameIndexRange) ==
+            chunkFrameIndexRange) {
+        verifyFirstSound(pChunk);
+        ReaderStatusUpdate result;
+        result.init(CHUNK_READ_SUCCESS, pChunk, m_pAudioSource->frameIndexRange());
+        return result;
+    }
+    if (!chunkPool.attachExclusive(pChunk)) {
+        ReaderStatusUpdate result;
+        result.init(CHUNK_READ_INVALID, pChunk, m_pAudioSource->frameIndexRange());
+        return result;
+    }
+
+    // Serve the chunk from the decoded samples of the whole track
+    if (chunkFrameIndexRange.start() >= m_residentFrameIndexRange.start() &&
+            chunkFrameIndexRange.end() <= m_residentDecodedEnd) {
+        pChunk->bufferSampleFramesFromMemory(
+                m_residentBuffer.data() +
+                        CachingReaderChunk::frames2samples(
+                                chunkFrameIndexRange.start() -
+                                m_residentFrameIndexRange.start()),
+                chunkFrameIndexRange);
+        chunkPool.publish(*pChunk, m_chunkPoolTrackKey);
+        verifyFirstSound(pChunk);
+        ReaderStatusUpdate result;
+        result.init(CHUNK_READ_SUCCESS, pChunk, m_pAudioSource->frameIndexRange());
+        return result;
+    }
+
+    // Serve the chunk from the cache of decoded samples if available
+    if (m_pPcmCache &&
+            m_pPcmCache->readChunk(pChunk, chunkFrameIndexRange) ==
+                    chunkFrameIndexRange) {
+        chunkPool.publish(*pChunk, m_chunkPoolTrackKey);
+        verifyFirstSound(pChunk);
+        ReaderStatusUpdate result;
+        result.init(CHUNK_READ_SUCCESS, pChunk, m_pAudioSource->frameIndexRange());
+        return result;
+    }
+
     // Try to read the data required for the chunk from the audio source
     const mixxx::IndexRange bufferedFrameIndexRange = pChunk->bufferSampleFrames(
             m_pAudioSource,
@@ -70,6 +136,11 @@ ReaderStatusUpdate CachingReaderWorker::processReadRequest(
         if (bufferedFrameIndexRange.empty()) {
             status = CHUNK_READ_INVALID; // overwrite EOF (see above)
         }
+    } else if (status == CHUNK_READ_SUCCESS) {
+        chunkPool.publish(*pChunk, m_chunkPoolTrackKey);
+        if (m_pPcmCache) {
+            m_pPcmCache->writeChunk(*pChunk, bufferedFrameIndexRange);
+        }
     }
 
     // This call here assumes that the caching reader will read the first sound cue at
@@ -89,11 +160,23 @@ ReaderStatusUpdate CachingReaderWorker::processReadRequest(
     return result;
 }
 
+void CachingReaderWorker::setPcmCache(
+        std::unique_ptr<CachingReaderPcmCache> pPcmCache) {
+    DEBUG_ASSERT(!isRunning());
+    m_pPcmCache = std::move(pPcmCache);
+}
+
+void CachingReaderWorker::setResidentMaxSeconds(int seconds) {
+    DEBUG_ASSERT(!isRunning());
+    m_residentMaxSeconds = seconds;
+}
+
 // WARNING: Always called from a different thread (GUI)
-void CachingReaderWorker::newTrack(TrackPointer pTrack) {
+void CachingReaderWorker::newTrack(TrackPointer pTrack, bool loadIntoRam) {
     {
         const auto locker = lockMutex(&m_newTrackMutex);
         m_pNewTrack = pTrack;
+        m_newTrackLoadIntoRam = loadIntoRam;
         m_newTrackAvailable.storeRelease(1);
     }
     workReady();
@@ -105,6 +188,7 @@ void CachingReaderWorker::run() {
     const auto id = lastId.fetchAndAddRelaxed(1) + 1;
     QThread::currentThread()->setObjectName(
             QStringLiteral("CachingReaderWorker ") + QString::number(id));
+    mixxx::CpuAffinity::applyToCurrentThread(mixxx::CpuAffinity::ThreadRole::Background);
 
     Event::start(m_tag);
     while (!m_stop.loadAcquire()) {
@@ -112,23 +196,31 @@ void CachingReaderWorker::run() {
         CachingReaderChunkReadRequest request;
         if (m_newTrackAvailable.loadAcquire()) {
             TrackPointer pLoadTrack;
+            bool loadIntoRam;
             { // locking scope
                 const auto locker = lockMutex(&m_newTrackMutex);
                 pLoadTrack = m_pNewTrack;
+                loadIntoRam = m_newTrackLoadIntoRam;
                 m_pNewTrack.reset();
                 m_newTrackAvailable.storeRelease(0);
             } // implicitly unlocks the mutex
             if (pLoadTrack) {
                 // in this case the engine is still running with the old track
-                loadTrack(pLoadTrack);
+                loadTrack(pLoadTrack, loadIntoRam);
             } else {
                 // here, the engine is already stopped
                 unloadTrack();
             }
-        } else if (m_pChunkReadRequestFIFO->read(&request, 1) == 1) {
+        } else if (m_pChunkReadRequestFIFO->read(&request, 1) == 1 ||
+                // Prefetch a single chunk at a time and then check
+                // again for high priority read requests
+                m_pChunkPrefetchRequestFIFO->read(&request, 1) == 1) {
             // Read the requested chunk and send the result
             const ReaderStatusUpdate update = processReadRequest(request);
             m_pReaderStatusFIFO->writeBlocking(&update, 1);
+        } else if (m_residentDecoding) {
+            // Continue decoding the whole track while no chunks are requested
+            decodeNextResidentSlice();
         } else {
             Event::end(m_tag);
             m_semaRun.acquire();
@@ -139,7 +231,8 @@ void CachingReaderWorker::run() {
 
 void CachingReaderWorker::discardAllPendingRequests() {
     CachingReaderChunkReadRequest request;
-    while (m_pChunkReadRequestFIFO->read(&request, 1) == 1) {
+    while (m_pChunkReadRequestFIFO->read(&request, 1) == 1 ||
+            m_pChunkPrefetchRequestFIFO->read(&request, 1) == 1) {
         const auto update = ReaderStatusUpdate::readDiscarded(request.chunk);
         m_pReaderStatusFIFO->writeBlocking(&update, 1);
     }
@@ -148,6 +241,14 @@ void CachingReaderWorker::discardAllPendingRequests() {
 void CachingReaderWorker::closeAudioSource() {
     discardAllPendingRequests();
 
+    if (m_pPcmCache) {
+        m_pPcmCache->close();
+    }
+
+    releaseResidentBuffer();
+
+    m_chunkPoolTrackKey.clear();
+
     if (m_pAudioSource) {
         // Closes open file handles of the old track.
         m_pAudioSource->close();
@@ -157,6 +258,7 @@ void CachingReaderWorker::closeAudioSource() {
     // This function has to be called with the engine stopped only
     // to avoid collecting new requests for the old track
     DEBUG_ASSERT(!m_pChunkReadRequestFIFO->readAvailable());
+    DEBUG_ASSERT(!m_pChunkPrefetchRequestFIFO->readAvailable());
 }
 
 void CachingReaderWorker::unloadTrack() {
@@ -166,7 +268,7 @@ void CachingReaderWorker::unloadTrack() {
     m_pReaderStatusFIFO->writeBlocking(&update, 1);
 }
 
-void CachingReaderWorker::loadTrack(const TrackPointer& pTrack) {
+void CachingReaderWorker::loadTrack(const TrackPointer& pTrack, bool loadIntoRam) {
     // This emit is directly connected and returns synchronized
     // after the engine has been stopped.
     emit trackLoading();
@@ -219,10 +321,26 @@ void CachingReaderWorker::loadTrack(const TrackPointer& pTrack) {
         return;
     }
 
-    // Adjust the internal buffer
+    if (m_pPcmCache &&
+            !m_pPcmCache->open(
+                    pTrack->getFileInfo(),
+                    m_pAudioSource->getSignalInfo(),
+                    m_pAudioSource->frameIndexRange())) {
+        kLogger.info()
+                << m_group
+                << "Decoded samples will not be cached for"
+                << pTrack->getFileInfo();
+    }
+
+    m_chunkPoolTrackKey = chunkPoolTrackKey(pTrack->getFileInfo());
+
+    // Adjust the internal buffer. Mono and stereo sources are decoded
+    // directly into the chunks.
     const SINT tempReadBufferSize =
-            m_pAudioSource->getSignalInfo().frames2samples(
-                    CachingReaderChunk::kFrames);
+            m_pAudioSource->getSignalInfo().getChannelCount() > CachingReaderChunk::kChannels
+            ? m_pAudioSource->getSignalInfo().frames2samples(
+                      CachingReaderChunk::kFrames)
+            : 0;
     if (m_tempReadBuffer.size() != tempReadBufferSize) {
         mixxx::SampleBuffer(tempReadBufferSize).swap(m_tempReadBuffer);
     }
@@ -248,6 +366,9 @@ void CachingReaderWorker::loadTrack(const TrackPointer& pTrack) {
     // The engine must not request any chunks before receiving the
     // trackLoaded() signal
     DEBUG_ASSERT(!m_pChunkReadRequestFIFO->readAvailable());
+    DEBUG_ASSERT(!m_pChunkPrefetchRequestFIFO->readAvailable());
+
+    startResidentDecoding(loadIntoRam);
 
     emit trackLoaded(
             pTrack,
@@ -255,6 +376,93 @@ void CachingReaderWorker::loadTrack(const TrackPointer& pTrack) {
             sampleCount);
 }
 
+void CachingReaderWorker::startResidentDecoding(bool loadIntoRam) {
+    DEBUG_ASSERT(m_pAudioSource);
+    const auto& signalInfo = m_pAudioSource->getSignalInfo();
+    const int maxSeconds = loadIntoRam ? kMaxLoadIntoRamSeconds : m_residentMaxSeconds;
+    if (m_pAudioSource->frameLength() >
+            static_cast<SINT>(maxSeconds) * signalInfo.getSampleRate()) {
+        return;
+    }
+    // Reading from the track is suspended while loading, i.e. the buffer
+    // of the previous track can safely be replaced
+    mixxx::SampleBuffer(CachingReaderChunk::frames2samples(
+                                m_pAudioSource->frameLength()))
+            .swap(m_residentBuffer);
+    m_residentFrameIndexRange = m_pAudioSource->frameIndexRange();
+    m_residentDecodedEnd = m_residentFrameIndexRange.start();
+    m_residentDecoding = true;
+}
+
+void CachingReaderWorker::decodeNextResidentSlice() {
+    DEBUG_ASSERT(m_residentDecoding);
+    const auto sliceFrameIndexRange = intersect(
+            mixxx::IndexRange::forward(
+                    m_residentDecodedEnd, CachingReaderChunk::kFrames),
+            m_residentFrameIndexRange);
+    DEBUG_ASSERT(!sliceFrameIndexRange.empty());
+    CSAMPLE* const pSliceSamples = m_residentBuffer.data(
+            CachingReaderChunk::frames2samples(
+                    sliceFrameIndexRange.start() -
+                    m_residentFrameIndexRange.start()));
+    // The slices are aligned with the chunks
+    if (CachingReaderChunkPool::instance().readShared(
+                m_chunkPoolTrackKey,
+                CachingReaderChunk::indexForFrame(
+                        sliceFrameIndexRange.start() -
+                        m_pAudioSource->frameIndexMin()),
+                sliceFrameIndexRange,
+                pSliceSamples)) {
+        m_residentDecodedEnd = sliceFrameIndexRange.end();
+        finishResidentSlice();
+        return;
+    }
+    mixxx::AudioSourceStereoProxy audioSourceProxy(
+            m_pAudioSource,
+            mixxx::SampleBuffer::WritableSlice(m_tempReadBuffer));
+    const auto readableSampleFrames = audioSourceProxy.readSampleFrames(
+            mixxx::WritableSampleFrames(
+                    sliceFrameIndexRange,
+                    mixxx::SampleBuffer::WritableSlice(
+                            pSliceSamples,
+                            CachingReaderChunk::frames2samples(
+                                    sliceFrameIndexRange.length()))));
+    if (readableSampleFrames.frameIndexRange() != sliceFrameIndexRange) {
+        // Fall back to reading chunks on demand
+        kLogger.warning()
+                << m_group
+                << "Failed to decode the whole track into memory:"
+                << "expected =" << sliceFrameIndexRange
+                << ", actual =" << readableSampleFrames.frameIndexRange();
+        releaseResidentBuffer();
+        return;
+    }
+    m_residentDecodedEnd = sliceFrameIndexRange.end();
+    finishResidentSlice();
+}
+
+void CachingReaderWorker::finishResidentSlice() {
+    if (m_residentDecodedEnd < m_residentFrameIndexRange.end()) {
+        return;
+    }
+    m_residentDecoding = false;
+    kLogger.debug()
+            << m_group
+            << "Decoded the whole track into memory:"
+            << m_residentFrameIndexRange;
+    const auto update = ReaderStatusUpdate::trackResident(
+            m_residentBuffer.data(),
+            m_residentFrameIndexRange);
+    m_pReaderStatusFIFO->writeBlocking(&update, 1);
+}
+
+void CachingReaderWorker::releaseResidentBuffer() {
+    m_residentDecoding = false;
+    m_residentFrameIndexRange = mixxx::IndexRange();
+    m_residentDecodedEnd = 0;
+    mixxx::SampleBuffer().swap(m_residentBuffer);
+}
+
 void CachingReaderWorker::quitWait() {
     m_stop = 1;
     m_semaRun.release();
@@ -2,9 +2,11 @@
 
 #include <QMutex>
 #include <QString>
+#include <memory>
 
 #include "audio/frame.h"
 #include "engine/cachingreader/cachingreaderchunk.h"
+#include "engine/cachingreader/cachingreaderpcmcache.h"
 #include "engine/engineworker.h"
 #include "sources/audiosource.h"
 #include "track/track_decl.h"
@@ -26,6 +28,8 @@ typedef struct CachingReaderChunkReadRequest {
 enum ReaderStatus {
     TRACK_LOADED,
     TRACK_UNLOADED,
+    TRACK_RESIDENT, // the whole track has been decoded into memory
+
     CHUNK_READ_SUCCESS,
     CHUNK_READ_EOF,
     CHUNK_READ_INVALID,
@@ -36,6 +40,7 @@ enum ReaderStatus {
 typedef struct ReaderStatusUpdate {
   private:
     CachingReaderChunk* chunk;
+    const CSAMPLE* residentSamples;
     SINT readableFrameIndexRangeStart;
     SINT readableFrameIndexRangeEnd;
 
@@ -48,6 +53,7 @@ typedef struct ReaderStatusUpdate {
             const mixxx::IndexRange& readableFrameIndexRangeArg) {
         status = statusArg;
         chunk = chunkArg;
+        residentSamples = nullptr;
         readableFrameIndexRangeStart = readableFrameIndexRangeArg.start();
         readableFrameIndexRangeEnd = readableFrameIndexRangeArg.end();
     }
@@ -67,6 +73,18 @@ typedef struct ReaderStatusUpdate {
         return update;
     }
 
+    // The samples remain owned by the worker and stay valid until the
+    // next track is loaded or the track is unloaded
+    static ReaderStatusUpdate trackResident(
+            const CSAMPLE* pSamples,
+            const mixxx::IndexRange& frameIndexRange) {
+        DEBUG_ASSERT(pSamples);
+        ReaderStatusUpdate update;
+        update.init(TRACK_RESIDENT, nullptr, frameIndexRange);
+        update.residentSamples = pSamples;
+        return update;
+    }
+
     static ReaderStatusUpdate trackUnloaded() {
         ReaderStatusUpdate update;
         update.init(TRACK_UNLOADED, nullptr, mixxx::IndexRange());
@@ -84,6 +102,12 @@ typedef struct ReaderStatusUpdate {
         return pChunk;
     }
 
+    const CSAMPLE* takeResidentSamples() {
+        const CSAMPLE* pSamples = residentSamples;
+        residentSamples = nullptr;
+        return pSamples;
+    }
+
     mixxx::IndexRange readableFrameIndexRange() const {
         return mixxx::IndexRange::between(
                 readableFrameIndexRangeStart,
@@ -98,11 +122,23 @@ class CachingReaderWorker : public EngineWorker {
     // Construct a CachingReader with the given group.
     CachingReaderWorker(const QString& group,
             FIFO<CachingReaderChunkReadRequest>* pChunkReadRequestFIFO,
+            FIFO<CachingReaderChunkReadRequest>* pChunkPrefetchRequestFIFO,
             FIFO<ReaderStatusUpdate>* pReaderStatusFIFO);
     ~CachingReaderWorker() override = default;
 
+    // Sets the optional on-disk cache of decoded samples. Must be called
+    // before the worker thread is started.
+    void setPcmCache(std::unique_ptr<CachingReaderPcmCache> pPcmCache);
+
+    // Tracks up to this duration are decoded into memory after loading
+    // while the worker is idle. Must be called before the worker thread
+    // is started.
+    void setResidentMaxSeconds(int seconds);
+
     // Request to load a new track. wake() must be called afterwards.
-    void newTrack(TrackPointer pTrack);
+    // If loadIntoRam is set the track is decoded into memory regardless
+    // of its duration, up to an upper limit.
+    void newTrack(TrackPointer pTrack, bool loadIntoRam = false);
 
     // Run upkeep operations like loading tracks and reading from file. Run by a
     // thread pool via the EngineWorkerScheduler.
@@ -123,6 +159,9 @@ class CachingReaderWorker : public EngineWorker {
     // Thread-safe FIFOs for communication between the engine callback and
     // reader thread.
     FIFO<CachingReaderChunkReadRequest>* m_pChunkReadRequestFIFO;
+    // Low priority requests that are only processed while
+    // m_pChunkReadRequestFIFO is empty.
+    FIFO<CachingReaderChunkReadRequest>* m_pChunkPrefetchRequestFIFO;
     FIFO<ReaderStatusUpdate>* m_pReaderStatusFIFO;
 
     // Queue of Tracks to load, and the corresponding lock. Must acquire the
@@ -130,6 +169,7 @@ class CachingReaderWorker : public EngineWorker {
     QMutex m_newTrackMutex;
     QAtomicInt m_newTrackAvailable;
     TrackPointer m_pNewTrack;
+    bool m_newTrackLoadIntoRam;
 
     void discardAllPendingRequests();
 
@@ -142,7 +182,14 @@ class CachingReaderWorker : public EngineWorker {
     void unloadTrack();
 
     /// Internal method to load a track. Emits trackLoaded when finished.
-    void loadTrack(const TrackPointer& pTrack);
+    void loadTrack(const TrackPointer& pTrack, bool loadIntoRam);
+
+    void startResidentDecoding(bool loadIntoRam);
+    /// Decodes the next slice of the resident buffer and reports the
+    /// buffer to the reader after the last slice.
+    void decodeNextResidentSlice();
+    void finishResidentSlice();
+    void releaseResidentBuffer();
 
     ReaderStatusUpdate processReadRequest(
             const CachingReaderChunkReadRequest& request);
@@ -152,11 +199,26 @@ class CachingReaderWorker : public EngineWorker {
     // The current audio source of the track loaded
     mixxx::AudioSourcePointer m_pAudioSource;
 
+    // Optional cache of decoded samples for the current audio source
+    std::unique_ptr<CachingReaderPcmCache> m_pPcmCache;
+
+    // Identifies the track in the CachingReaderChunkPool
+    QString m_chunkPoolTrackKey;
+
     mixxx::audio::FramePos m_firstSoundFrameToVerify;
 
     // Temporary buffer for reading samples from all channels
     // before conversion to a stereo signal.
     mixxx::SampleBuffer m_tempReadBuffer;
 
+    int m_residentMaxSeconds;
+    // The decoded stereo samples of the whole track. Only reallocated
+    // while the engine does not read from the track.
+    mixxx::SampleBuffer m_residentBuffer;
+    mixxx::IndexRange m_residentFrameIndexRange;
+    // The end of the frames that have been decoded so far
+    SINT m_residentDecodedEnd;
+    bool m_residentDecoding;
+
     QAtomicInt m_stop;
 };
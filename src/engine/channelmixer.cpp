@@ -25,19 +25,13 @@ void ChannelMixer::applyEffectsAndMixChannels(const EngineMixer::GainCalculator&
     SampleUtil::clear(pOutput, iBufferSize);
     ScopedTimer t("EngineMixer::applyEffectsAndMixChannels");
     for (auto* pChannelInfo : activeChannels) {
-        EngineMixer::GainCache& gainCache = (*channelGainCache)[pChannelInfo->m_index];
-        CSAMPLE_GAIN oldGain = gainCache.m_gain;
+        CSAMPLE_GAIN oldGain;
         CSAMPLE_GAIN newGain;
-        bool fadeout = gainCache.m_fadeout ||
-                (pChannelInfo->m_pChannel &&
-                        !pChannelInfo->m_pChannel->isActive());
-        if (fadeout) {
-            newGain = 0;
-            gainCache.m_fadeout = false;
-        } else {
-            newGain = gainCalculator.getGain(pChannelInfo);
-        }
-        gainCache.m_gain = newGain;
+        const bool fadeout = updateGain(gainCalculator,
+                pChannelInfo,
+                channelGainCache,
+                &oldGain,
+                &newGain);
         pEngineEffectsManager->processPostFaderAndMix(pChannelInfo->m_handle,
                 outputHandle,
                 pChannelInfo->m_pBuffer,
@@ -67,32 +61,50 @@ void ChannelMixer::applyEffectsInPlaceAndMixChannels(
     // 2. Pass each channel's calculated gain and input buffer to pEngineEffectsManager, which then:
     //    A) Applies the calculated gain to the channel buffer, modifying the original input buffer
     //    B) Applies effects to the buffer, modifying the original input buffer
-    // 4. Mix the channel buffers together to make pOutput, overwriting the pOutput buffer from the last engine callback
+    // 3. Mix the channel buffers together to make pOutput, overwriting the pOutput buffer from the last engine callback.
+    //    Without any enabled effect chain the gain is applied while mixing in a single pass.
     ScopedTimer t("EngineMixer::applyEffectsInPlaceAndMixChannels");
     SampleUtil::clear(pOutput, iBufferSize);
     for (auto* pChannelInfo : activeChannels) {
-        EngineMixer::GainCache& gainCache = (*channelGainCache)[pChannelInfo->m_index];
-        CSAMPLE_GAIN oldGain = gainCache.m_gain;
+        CSAMPLE_GAIN oldGain;
         CSAMPLE_GAIN newGain;
-        bool fadeout = gainCache.m_fadeout ||
-                (pChannelInfo->m_pChannel &&
-                        !pChannelInfo->m_pChannel->isActive());
-        if (fadeout) {
-            newGain = 0;
-            gainCache.m_fadeout = false;
-        } else {
-            newGain = gainCalculator.getGain(pChannelInfo);
-        }
-        gainCache.m_gain = newGain;
-        pEngineEffectsManager->processPostFaderInPlace(pChannelInfo->m_handle,
+        const bool fadeout = updateGain(gainCalculator,
+                pChannelInfo,
+                channelGainCache,
+                &oldGain,
+                &newGain);
+        pEngineEffectsManager->processPostFaderInPlaceAndMix(pChannelInfo->m_handle,
                 outputHandle,
                 pChannelInfo->m_pBuffer,
+                pOutput,
                 iBufferSize,
                 iSampleRate,
                 pChannelInfo->m_features,
                 oldGain,
                 newGain,
                 fadeout);
-        SampleUtil::add(pOutput, pChannelInfo->m_pBuffer, iBufferSize);
     }
 }
+
+// static
+bool ChannelMixer::updateGain(
+        const EngineMixer::GainCalculator& gainCalculator,
+        EngineMixer::ChannelInfo* pChannelInfo,
+        QVarLengthArray<EngineMixer::GainCache, kPreallocatedChannels>*
+                channelGainCache,
+        CSAMPLE_GAIN* pOldGain,
+        CSAMPLE_GAIN* pNewGain) {
+    EngineMixer::GainCache& gainCache = (*channelGainCache)[pChannelInfo->m_index];
+    *pOldGain = gainCache.m_gain;
+    const bool fadeout = gainCache.m_fadeout ||
+            (pChannelInfo->m_pChannel &&
+                    !pChannelInfo->m_pChannel->isActive());
+    if (fadeout) {
+        *pNewGain = 0;
+        gainCache.m_fadeout = false;
+    } else {
+        *pNewGain = gainCalculator.getGain(pChannelInfo);
+    }
+    gainCache.m_gain = *pNewGain;
+    return fadeout;
+}
@@ -33,4 +33,15 @@ class ChannelMixer {
             unsigned int iBufferSize,
             unsigned int iSampleRate,
             EngineEffectsManager* pEngineEffectsManager);
+
+    // Calculates the gain of the channel for this callback and stores it
+    // in the gain cache. The old gain is the one of the previous callback.
+    // Returns true if the channel fades out.
+    static bool updateGain(
+            const EngineMixer::GainCalculator& gainCalculator,
+            EngineMixer::ChannelInfo* pChannelInfo,
+            QVarLengthArray<EngineMixer::GainCache, kPreallocatedChannels>*
+                    channelGainCache,
+            CSAMPLE_GAIN* pOldGain,
+            CSAMPLE_GAIN* pNewGain);
 };
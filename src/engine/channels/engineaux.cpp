@@ -65,12 +65,11 @@ void EngineAux::onInputUnconfigured(const AudioInput& input) {
 void EngineAux::receiveBuffer(
         const AudioInput& input, const CSAMPLE* pBuffer, unsigned int nFrames) {
     Q_UNUSED(input);
-    Q_UNUSED(nFrames);
-    m_sampleBuffer = pBuffer;
+    setInputBuffer(pBuffer, nFrames);
 }
 
 void EngineAux::process(CSAMPLE* pOut, const int iBufferSize) {
-    const CSAMPLE* sampleBuffer = m_sampleBuffer; // save pointer on stack
+    const CSAMPLE* sampleBuffer = takeInputSamples(iBufferSize);
     CSAMPLE_GAIN pregain = static_cast<CSAMPLE_GAIN>(m_pPregain->get());
     if (sampleBuffer) {
         SampleUtil::copyWithGain(pOut, sampleBuffer, pregain, iBufferSize);
@@ -81,7 +80,6 @@ void EngineAux::process(CSAMPLE* pOut, const int iBufferSize) {
                     // TODO(jholthuis): Use mixxx::audio::SampleRate instead
                     static_cast<unsigned int>(m_sampleRate.get()));
         }
-        m_sampleBuffer = nullptr;
     } else {
         SampleUtil::clear(pOut, iBufferSize);
     }
@@ -2,7 +2,9 @@
 
 #include "control/controlobject.h"
 #include "control/controlpushbutton.h"
+#include "control/controlvalueblock.h"
 #include "effects/effectsmanager.h"
+#include "engine/engine.h"
 #include "moc_enginechannel.cpp"
 
 EngineChannel::EngineChannel(const ChannelHandleAndGroup& handleGroup,
@@ -11,10 +13,12 @@ EngineChannel::EngineChannel(const ChannelHandleAndGroup& handleGroup,
         bool isTalkoverChannel,
         bool isPrimaryDeck)
         : m_group(handleGroup),
+          m_pControlValueBlock(ControlValueBlock::create(handleGroup.name())),
           m_pEffectsManager(pEffectsManager),
           m_vuMeter(getGroup()),
           m_sampleRate(QStringLiteral("[App]"), QStringLiteral("samplerate")),
           m_sampleBuffer(nullptr),
+          m_sampleBufferRemaining(0),
           m_bIsPrimaryDeck(isPrimaryDeck),
           m_active(false),
           m_bIsTalkoverChannel(isTalkoverChannel),
@@ -80,6 +84,28 @@ bool EngineChannel::isTalkoverEnabled() const {
     return m_pTalkover->toBool();
 }
 
+void EngineChannel::setInputBuffer(const CSAMPLE* pBuffer, unsigned int nFrames) {
+    m_sampleBufferRemaining = pBuffer
+            ? static_cast<int>(nFrames * mixxx::kEngineChannelCount)
+            : 0;
+    m_sampleBuffer = pBuffer;
+}
+
+const CSAMPLE* EngineChannel::takeInputSamples(int iBufferSize) {
+    const CSAMPLE* pBuffer = m_sampleBuffer;
+    if (!pBuffer) {
+        return nullptr;
+    }
+    if (iBufferSize < m_sampleBufferRemaining) {
+        m_sampleBuffer = pBuffer + iBufferSize;
+        m_sampleBufferRemaining -= iBufferSize;
+    } else {
+        m_sampleBuffer = nullptr;
+        m_sampleBufferRemaining = 0;
+    }
+    return pBuffer;
+}
+
 void EngineChannel::slotOrientationLeft(double v) {
     if (v > 0) {
         m_pOrientation->set(LEFT);
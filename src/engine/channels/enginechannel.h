@@ -1,10 +1,13 @@
 #pragma once
 
+#include <memory>
+
 #include "control/pollingcontrolproxy.h"
 #include "engine/channelhandle.h"
 #include "engine/engineobject.h"
 #include "engine/enginevumeter.h"
 
+class ControlValueBlock;
 class EffectsManager;
 class EngineBuffer;
 class ControlPushButton;
@@ -77,11 +80,24 @@ class EngineChannel : public EngineObject {
 
   protected:
     const ChannelHandleAndGroup m_group;
+    // Stores the values of all controls of the channel group that are
+    // created after it, i.e. those of the channel and its engine buffer.
+    const std::shared_ptr<ControlValueBlock> m_pControlValueBlock;
     EffectsManager* m_pEffectsManager;
 
     EngineVuMeter m_vuMeter;
     PollingControlProxy m_sampleRate;
+
+    // Stores the input buffer received from the sound card for the current
+    // callback.
+    void setInputBuffer(const CSAMPLE* pBuffer, unsigned int nFrames);
+    // Returns the next iBufferSize samples of the input buffer, or nullptr if
+    // there is no input left. When EngineMixer splits the callback into
+    // sub-blocks, each of them takes its own part of the input buffer.
+    const CSAMPLE* takeInputSamples(int iBufferSize);
+
     const CSAMPLE* volatile m_sampleBuffer;
+    int m_sampleBufferRemaining;
 
     // If set to true, this engine channel represents one of the primary playback decks.
     // It is used to check for valid bpm targets by the sync code.
@@ -46,11 +46,12 @@ EngineDeck::~EngineDeck() {
 
 void EngineDeck::process(CSAMPLE* pOut, const int iBufferSize) {
     // Feed the incoming audio through if passthrough is active
-    const CSAMPLE* sampleBuffer = m_sampleBuffer; // save pointer on stack
-    if (isPassthroughActive() && sampleBuffer) {
+    const CSAMPLE* sampleBuffer = m_bPassthroughIsActive
+            ? takeInputSamples(iBufferSize)
+            : nullptr;
+    if (sampleBuffer) {
         SampleUtil::copy(pOut, sampleBuffer, iBufferSize);
         m_bPassthroughWasActive = true;
-        m_sampleBuffer = nullptr;
         m_pPregain->setSpeedAndScratching(1, false);
     } else {
         // If passthrough is no longer enabled, zero out the buffer
@@ -124,13 +125,12 @@ EngineChannel::ActiveState EngineDeck::updateActiveState() {
 void EngineDeck::receiveBuffer(
         const AudioInput& input, const CSAMPLE* pBuffer, unsigned int nFrames) {
     Q_UNUSED(input);
-    Q_UNUSED(nFrames);
     // Skip receiving audio input if passthrough is not active
     if (!m_bPassthroughIsActive) {
-        m_sampleBuffer = nullptr;
+        setInputBuffer(nullptr, 0);
         return;
     } else {
-        m_sampleBuffer = pBuffer;
+        setInputBuffer(pBuffer, nFrames);
     }
 }
 
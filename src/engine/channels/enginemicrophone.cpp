@@ -63,14 +63,13 @@ void EngineMicrophone::onInputUnconfigured(const AudioInput& input) {
 void EngineMicrophone::receiveBuffer(
         const AudioInput& input, const CSAMPLE* pBuffer, unsigned int nFrames) {
     Q_UNUSED(input);
-    Q_UNUSED(nFrames);
-    m_sampleBuffer = pBuffer;
+    setInputBuffer(pBuffer, nFrames);
 }
 
 void EngineMicrophone::process(CSAMPLE* pOut, const int iBufferSize) {
     // If configured read into the output buffer.
     // Otherwise, skip the appropriate number of samples to throw them away.
-    const CSAMPLE* sampleBuffer = m_sampleBuffer; // save pointer on stack
+    const CSAMPLE* sampleBuffer = takeInputSamples(iBufferSize);
     CSAMPLE_GAIN pregain = static_cast<CSAMPLE_GAIN>(m_pPregain->get());
     if (sampleBuffer) {
         SampleUtil::copyWithGain(pOut, sampleBuffer, pregain, iBufferSize);
@@ -84,7 +83,6 @@ void EngineMicrophone::process(CSAMPLE* pOut, const int iBufferSize) {
     } else {
         SampleUtil::clear(pOut, iBufferSize);
     }
-    m_sampleBuffer = nullptr;
 
     // Update VU meter
     m_vuMeter.process(pOut, iBufferSize);
@@ -17,6 +17,10 @@
 namespace {
 constexpr mixxx::audio::FrameDiff_t kMinimumAudibleLoopSizeFrames = 150;
 
+// The number of consecutive beatjumps in each direction that are
+// prefetched by the reader.
+constexpr int kNumBeatJumpHints = 2;
+
 // returns true if a is valid and is fairly close to target (within +/- 1 frame).
 bool positionNear(mixxx::audio::FramePos a, mixxx::audio::FramePos target) {
     return a.isValid() && a > target - 1 && a < target + 1;
@@ -574,6 +578,33 @@ void LoopingControl::hintReader(gsl::not_null<HintVector*> pHintList) {
             pHintList->append(loop_hint);
         }
     }
+
+    // Prefetch the targets of the next beatjumps in both directions.
+    // Inside an active loop a beatjump moves the loop instead of
+    // seeking, which is already covered by the loop hints.
+    const mixxx::BeatsPointer pBeats = m_pBeats;
+    const auto currentPosition = m_currentPosition.getValue();
+    const double beatJumpSize = m_pCOBeatJumpSize->get();
+    if (!pBeats || !currentPosition.isValid() || beatJumpSize <= 0 ||
+            (m_bLoopingEnabled &&
+                    loopInfo.startPosition <= currentPosition &&
+                    loopInfo.endPosition >= currentPosition)) {
+        return;
+    }
+    Hint beatjump_hint;
+    beatjump_hint.type = Hint::Type::BeatJump;
+    beatjump_hint.frameCount = Hint::kFrameCountForward;
+    for (int i = 1; i <= kNumBeatJumpHints; ++i) {
+        for (const double beats : {i * beatJumpSize, -i * beatJumpSize}) {
+            const auto targetPosition =
+                    pBeats->findNBeatsFromPosition(currentPosition, beats);
+            if (targetPosition.isValid()) {
+                beatjump_hint.frame = static_cast<SINT>(
+                        targetPosition.toLowerFrameBoundary().value());
+                pHintList->append(beatjump_hint);
+            }
+        }
+    }
 }
 
 mixxx::audio::FramePos LoopingControl::getSyncPositionInsideLoop(
@@ -38,7 +38,7 @@ class LoopingControl : public EngineControl {
             mixxx::audio::FramePos* pTargetPosition);
 
     // hintReader will add to hintList hints both the loop in and loop out
-    // sample, if set.
+    // sample, if set, and the targets of the next beatjumps.
     void hintReader(gsl::not_null<HintVector*> pHintList) override;
     mixxx::audio::FramePos getSyncPositionInsideLoop(
             mixxx::audio::FramePos requestedPlayPosition,
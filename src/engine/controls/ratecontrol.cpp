@@ -1,6 +1,7 @@
 #include "engine/controls/ratecontrol.h"
 
 #include <QtDebug>
+#include <cmath>
 
 #include "control/controlobject.h"
 #include "control/controlpotmeter.h"
@@ -17,6 +18,14 @@
 namespace {
 constexpr int kRateSensitivityMin = 100;
 constexpr int kRateSensitivityMax = 2500;
+
+// The values of scratch2 are summed up as fixed point numbers in the upper
+// and counted in the lower bits of a single integer, so that the engine
+// takes both atomically.
+constexpr qint64 kScratch2CountLimit = qint64{1} << 16;
+constexpr double kScratch2FixedPointScale = 1 << 20;
+// Prevents that the sum overflows
+constexpr double kScratch2MaxValue = 1000.0;
 } // namespace
 
 // Static default values for rate buttons (percents)
@@ -148,7 +157,18 @@ RateControl::RateControl(const QString& group,
     // Scratch controller, this is an accumulator which is useful for
     // controllers that return individual +1 or -1s, these get added up and
     // cleared when we read
-    m_pScratch2 = new ControlObject(ConfigKey(group, "scratch2"));
+    m_pScratch2 = new ControlObject(ConfigKey(group, "scratch2"),
+            false); // Every value is part of the average
+    // The scratch functions of the controller scripts update the rate
+    // every millisecond, which is much more often than the engine
+    // callbacks. The engine plays the average of these values, so that
+    // the position follows the movement of the jog wheel instead of the
+    // rate that happened to be set last.
+    connect(m_pScratch2,
+            &ControlObject::valueChanged,
+            this,
+            &RateControl::slotScratch2Changed,
+            Qt::DirectConnection);
 
     // Scratch enable toggle
     m_pScratch2Enable = new ControlPushButton(ConfigKey(group, "scratch2_enable"));
@@ -391,6 +411,38 @@ SyncMode RateControl::getSyncMode() const {
     return syncModeFromDouble(m_pSyncMode->get());
 }
 
+void RateControl::slotScratch2Changed(double v) {
+    // Called from the thread that sets the value, usually the controller thread
+    if (util_isnan(v)) {
+        return;
+    }
+    const qint64 increment = std::llround(math_clamp(v, -kScratch2MaxValue, kScratch2MaxValue) *
+                                     kScratch2FixedPointScale) *
+                    kScratch2CountLimit +
+            1;
+    qint64 accumulator = m_scratch2Accumulator.load(std::memory_order_relaxed);
+    qint64 newAccumulator;
+    do {
+        if ((accumulator & (kScratch2CountLimit - 1)) == kScratch2CountLimit - 1) {
+            // Not taken for a long time, e.g. without a loaded track
+            newAccumulator = increment;
+        } else {
+            newAccumulator = accumulator + increment;
+        }
+    } while (!m_scratch2Accumulator.compare_exchange_weak(
+            accumulator, newAccumulator, std::memory_order_relaxed));
+}
+
+double RateControl::takeScratch2Average() {
+    const qint64 accumulator = m_scratch2Accumulator.exchange(0, std::memory_order_relaxed);
+    const qint64 count = accumulator & (kScratch2CountLimit - 1);
+    if (count == 0) {
+        return m_pScratch2->get();
+    }
+    const qint64 sum = (accumulator - count) / kScratch2CountLimit;
+    return static_cast<double>(sum) / kScratch2FixedPointScale / count;
+}
+
 double RateControl::calculateSpeed(double baserate, double speed, bool paused,
                                    int iSamplesPerBuffer,
                                    bool* pReportScratching,
@@ -425,7 +477,7 @@ double RateControl::calculateSpeed(double baserate, double speed, bool paused,
             }
             rate = speed;
         } else {
-            double scratchFactor = m_pScratch2->get();
+            double scratchFactor = takeScratch2Average();
             // Don't trust values from m_pScratch2
             if (util_isnan(scratchFactor)) {
                 scratchFactor = 0.0;
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <QObject>
+#include <atomic>
 
 #include "preferences/usersettings.h"
 #include "engine/controls/enginecontrol.h"
@@ -83,11 +84,15 @@ public slots:
   void slotControlRatePermUpSmall(double);
   void slotControlFastForward(double);
   void slotControlFastBack(double);
+  void slotScratch2Changed(double);
 
 private:
   void processTempRate(const int bufferSamples);
   double getJogFactor() const;
   double getWheelFactor() const;
+  // The average of the values of scratch2 that have been set since the last
+  // call, or the current value if it has not been set
+  double takeScratch2Average();
   SyncMode getSyncMode() const;
 
   // Set rate change of the temporary pitch rate
@@ -129,6 +134,9 @@ private:
 
   ControlTTRotary* m_pWheel;
   ControlObject* m_pScratch2;
+  // The sum and the number of the values of scratch2 that have been set
+  // since the last callback, see slotScratch2Changed()
+  std::atomic<qint64> m_scratch2Accumulator{0};
   PositionScratchController* m_pScratchController;
 
   ControlPushButton* m_pScratch2Enable;
@@ -68,9 +68,26 @@ void EngineEffect::initalizeInputChannel(ChannelHandle inputChannel) {
     m_pProcessor->initializeInputChannel(inputChannel, engineParameters);
 }
 
+void EngineEffect::setEnabled(bool enabled) {
+    for (auto& outputMap : m_effectEnableStateForChannelMatrix) {
+        for (auto& enableState : outputMap) {
+            if (enableState != EffectEnableState::Disabled && !enabled) {
+                enableState = EffectEnableState::Disabling;
+                // If an input is not routed to the chain, and the effect gets
+                // a message to disable, then the effect gets the message to enable,
+                // process() will not have executed, so the enableState will still be
+                // DISABLING instead of DISABLED.
+            } else if ((enableState == EffectEnableState::Disabled ||
+                               enableState == EffectEnableState::Disabling) &&
+                    enabled) {
+                enableState = EffectEnableState::Enabling;
+            }
+        }
+    }
+}
+
 bool EngineEffect::processEffectsRequest(EffectsRequest& message,
                                          EffectsResponsePipe* pResponsePipe) {
-    EngineEffectParameterPointer pParameter;
     EffectsResponse response(message);
 
     switch (message.type) {
@@ -80,45 +97,12 @@ bool EngineEffect::processEffectsRequest(EffectsRequest& message,
                      << "enabled" << message.SetEffectParameters.enabled;
         }
 
-        for (auto& outputMap : m_effectEnableStateForChannelMatrix) {
-            for (auto& enableState : outputMap) {
-                if (enableState != EffectEnableState::Disabled &&
-                        !message.SetEffectParameters.enabled) {
-                    enableState = EffectEnableState::Disabling;
-                    // If an input is not routed to the chain, and the effect gets
-                    // a message to disable, then the effect gets the message to enable,
-                    // process() will not have executed, so the enableState will still be
-                    // DISABLING instead of DISABLED.
-                } else if ((enableState == EffectEnableState::Disabled ||
-                                   enableState ==
-                                           EffectEnableState::Disabling) &&
-                        message.SetEffectParameters.enabled) {
-                    enableState = EffectEnableState::Enabling;
-                }
-            }
-        }
+        setEnabled(message.SetEffectParameters.enabled);
 
         response.success = true;
         pResponsePipe->writeMessage(response);
         return true;
         break;
-    case EffectsRequest::SET_PARAMETER_PARAMETERS:
-        if (kEffectDebugOutput) {
-            qDebug() << debugString() << "SET_PARAMETER_PARAMETERS"
-                     << "parameter" << message.SetParameterParameters.iParameter
-                     << "value" << message.value;
-        }
-        pParameter = m_parameters.value(
-                message.SetParameterParameters.iParameter, EngineEffectParameterPointer());
-        if (pParameter) {
-            pParameter->setValue(message.value);
-            response.success = true;
-        } else {
-            response.success = false;
-            response.status = EffectsResponse::NO_SUCH_PARAMETER;
-        }
-        pResponsePipe->writeMessage(response);
-        return true;
     default:
         break;
     }
@@ -30,6 +30,10 @@ class EngineEffect final : public EffectsRequestHandler {
     /// Called from the main thread to make sure that the channel already has states
     void initalizeInputChannel(ChannelHandle inputChannel);
 
+    /// Called in main thread by EffectSlot with the initial state before the
+    /// effect is added to the engine, afterwards by processEffectsRequest
+    void setEnabled(bool enabled);
+
     /// Called in audio thread
     bool processEffectsRequest(
             EffectsRequest& message,
@@ -53,6 +57,12 @@ class EngineEffect final : public EffectsRequestHandler {
         return m_pManifest->name();
     }
 
+    /// Called in main thread by EffectSlot. The parameters are created
+    /// by the constructor and are not modified afterwards.
+    EngineEffectParameterPointer getParameter(int index) const {
+        return m_parameters.value(index);
+    }
+
     SINT getGroupDelayFrames() {
         return m_pProcessor->getGroupDelayFrames();
     }
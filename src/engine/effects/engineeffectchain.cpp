@@ -1,9 +1,20 @@
 #include "engine/effects/engineeffectchain.h"
 
 #include "engine/effects/engineeffect.h"
+#include "engine/engine.h"
+#include "engine/enginescratchbuffers.h"
 #include "util/defs.h"
 #include "util/sample.h"
 
+namespace {
+
+// Effects are not processed when both the input and their output have been
+// silent for this long. It must exceed the longest delay of any effect, so
+// that silent output implies that no tail is pending anymore.
+constexpr double kSilenceBeforeBypassSeconds = 10.0;
+
+} // anonymous namespace
+
 EngineEffectChain::EngineEffectChain(const QString& group,
         const QSet<ChannelHandleAndGroup>& registeredInputChannels,
         const QSet<ChannelHandleAndGroup>& registeredOutputChannels)
@@ -11,8 +22,7 @@ EngineEffectChain::EngineEffectChain(const QString& group,
           m_enableState(EffectEnableState::Enabled),
           m_mixMode(EffectChainMixMode::DrySlashWet),
           m_dMix(0),
-          m_buffer1(MAX_BUFFER_LEN),
-          m_buffer2(MAX_BUFFER_LEN) {
+          m_profilerStage(EngineProfiler::instance().registerStage(debugString())) {
     // Try to prevent memory allocation.
     m_effects.reserve(256);
 
@@ -178,7 +188,9 @@ bool EngineEffectChain::process(const ChannelHandle& inputHandle,
         const unsigned int numSamples,
         const unsigned int sampleRate,
         const GroupFeatureState& groupFeatures,
-        bool fadeout) {
+        bool fadeout,
+        EngineScratchBuffers* pScratchBuffers) {
+    ScopedEngineProfile profile(m_profilerStage);
     // Compute the effective enable state from the channel input routing switch and
     // the chain's enable state. When either of these are turned on/off, send the
     // effects the intermediate enabling/disabling signal.
@@ -209,12 +221,53 @@ bool EngineEffectChain::process(const ChannelHandle& inputHandle,
     CSAMPLE currentMixKnob = m_dMix;
     CSAMPLE lastCallbackMixKnob = channelStatus.oldMixKnob;
 
+    // Bypass the effects while their output has no effect on the mix. This
+    // is only done in the enabled state, any pending transition is processed.
+    bool bypassEffects = false;
+    bool bypassDelay = false;
+    bool inputSilent = false;
+    if (effectiveChainEnableState == EffectEnableState::Enabled) {
+        if (currentMixKnob == CSAMPLE_ZERO) {
+            if (lastCallbackMixKnob == CSAMPLE_ZERO) {
+                // The mix knob is fully dry, so the output is the (delayed)
+                // input in both mix modes
+                bypassEffects = true;
+            } else {
+                // Fade out the effects along with the mix knob
+                effectiveChainEnableState = EffectEnableState::Disabling;
+            }
+        } else if (lastCallbackMixKnob == CSAMPLE_ZERO) {
+            // The effects have been bypassed or faded out in the
+            // previous callback and need to start from scratch
+            effectiveChainEnableState = EffectEnableState::Enabling;
+        }
+        if (!bypassEffects) {
+            inputSilent = SampleUtil::maxAbsAmplitude(pIn, numSamples) == CSAMPLE_ZERO;
+            if (inputSilent &&
+                    channelStatus.silentFrames >=
+                            kSilenceBeforeBypassSeconds * sampleRate) {
+                // Silence in, silence out. The delay buffer only contains
+                // silence, too.
+                bypassEffects = true;
+                bypassDelay = true;
+            }
+        }
+    }
+
     bool processingOccured = false;
-    if (effectiveChainEnableState != EffectEnableState::Disabled) {
+    if (bypassEffects) {
+        if (!bypassDelay) {
+            m_effectsDelay.process(pIn, numSamples);
+        }
+    } else if (effectiveChainEnableState != EffectEnableState::Disabled) {
         // Ramping code inside the effects need to access the original samples
         // after writing to the output buffer. This requires not to use the same buffer
         // for in and output: Also, ChannelMixer::applyEffectsAndMixChannels
         // requires that the input buffer does not get modified.
+        CSAMPLE* const pBuffer1 = pScratchBuffers->buffer(
+                EngineScratchBuffers::Role::EffectChainIntermediate1);
+        CSAMPLE* const pBuffer2 = pScratchBuffers->buffer(
+                EngineScratchBuffers::Role::EffectChainIntermediate2);
         CSAMPLE* pIntermediateInput = pIn;
         CSAMPLE* pIntermediateOutput;
         SINT effectChainGroupDelayFrames = 0;
@@ -223,10 +276,10 @@ bool EngineEffectChain::process(const ChannelHandle& inputHandle,
         for (EngineEffect* pEffect : std::as_const(m_effects)) {
             if (pEffect != nullptr) {
                 // Select an unused intermediate buffer for the next output
-                if (pIntermediateInput == m_buffer1.data()) {
-                    pIntermediateOutput = m_buffer2.data();
+                if (pIntermediateInput == pBuffer1) {
+                    pIntermediateOutput = pBuffer2;
                 } else {
-                    pIntermediateOutput = m_buffer1.data();
+                    pIntermediateOutput = pBuffer1;
                 }
 
                 if (pEffect->process(inputHandle,
@@ -301,6 +354,18 @@ bool EngineEffectChain::process(const ChannelHandle& inputHandle,
         }
     }
 
+    if (!inputSilent) {
+        channelStatus.silentFrames = 0;
+    } else if (!bypassEffects) {
+        // Without processing the output is the silent input
+        if (!processingOccured ||
+                SampleUtil::maxAbsAmplitude(pOut, numSamples) == CSAMPLE_ZERO) {
+            channelStatus.silentFrames += numSamples / mixxx::kEngineChannelCount;
+        } else {
+            channelStatus.silentFrames = 0;
+        }
+    }
+
     channelStatus.oldMixKnob = currentMixKnob;
 
     // If the EffectProcessors have been sent a signal for the intermediate
@@ -318,11 +383,39 @@ bool EngineEffectChain::process(const ChannelHandle& inputHandle,
         channelStatus.enableState = EffectEnableState::Enabling;
     }
 
+    return processingOccured;
+}
+
+void EngineEffectChain::onCallbackStart() {
+    // The chain state is advanced once per callback and not in process(),
+    // so that every channel that is processed with the chain receives the
+    // intermediate state, not only the first one.
     if (m_enableState == EffectEnableState::Disabling) {
         m_enableState = EffectEnableState::Disabled;
     } else if (m_enableState == EffectEnableState::Enabling) {
         m_enableState = EffectEnableState::Enabled;
     }
+}
 
-    return processingOccured;
+bool EngineEffectChain::hasChannelStatus(const ChannelHandle& inputHandle,
+        const ChannelHandle& outputHandle) const {
+    if (!inputHandle.valid() || !outputHandle.valid() ||
+            static_cast<int>(inputHandle) >= m_chainStatusForChannelMatrix.size()) {
+        return false;
+    }
+    return static_cast<int>(outputHandle) <
+            m_chainStatusForChannelMatrix.at(inputHandle).size();
+}
+
+bool EngineEffectChain::isProcessingChannel(const ChannelHandle& inputHandle,
+        const ChannelHandle& outputHandle) const {
+    VERIFY_OR_DEBUG_ASSERT(hasChannelStatus(inputHandle, outputHandle)) {
+        return true;
+    }
+    if (m_enableState == EffectEnableState::Disabled) {
+        return false;
+    }
+    const ChannelStatus& channelStatus =
+            m_chainStatusForChannelMatrix.at(inputHandle).at(outputHandle);
+    return channelStatus.enableState != EffectEnableState::Disabled;
 }
@@ -6,11 +6,12 @@
 #include "engine/channelhandle.h"
 #include "engine/effects/engineeffectsdelay.h"
 #include "engine/effects/message.h"
+#include "engine/engineprofiler.h"
 #include "util/class.h"
-#include "util/samplebuffer.h"
 #include "util/types.h"
 
 class EngineEffect;
+class EngineScratchBuffers;
 
 /// EngineEffectChain is the audio thread counterpart of EffectChain.
 /// The lifetime of EngineEffectChain corresponds to the lifetime of
@@ -42,16 +43,44 @@ class EngineEffectChain final : public EffectsRequestHandler {
             const unsigned int numSamples,
             const unsigned int sampleRate,
             const GroupFeatureState& groupFeatures,
-            bool fadeout);
+            bool fadeout,
+            EngineScratchBuffers* pScratchBuffers);
+
+    /// called from audio thread
+    bool isEnabled() const {
+        return m_enableState != EffectEnableState::Disabled;
+    }
+
+    /// Advances the intermediate enabling/disabling state of the chain
+    /// after every channel has been processed with it for one callback.
+    /// called from audio thread before the effects requests are processed
+    void onCallbackStart();
+
+    /// Whether process() finds the status of the channel combination
+    /// without inserting it into the status matrix.
+    /// called from audio thread
+    bool hasChannelStatus(const ChannelHandle& inputHandle,
+            const ChannelHandle& outputHandle) const;
+
+    /// Whether process() runs the effects for the channel combination, which
+    /// modifies the state of the effects and buffers that are shared among
+    /// all channels. Otherwise process() only updates the status of the
+    /// channel combination. Requires hasChannelStatus().
+    /// called from audio thread
+    bool isProcessingChannel(const ChannelHandle& inputHandle,
+            const ChannelHandle& outputHandle) const;
 
   private:
     struct ChannelStatus {
         ChannelStatus()
                 : oldMixKnob(0),
-                  enableState(EffectEnableState::Disabled) {
+                  enableState(EffectEnableState::Disabled),
+                  silentFrames(0) {
         }
         CSAMPLE oldMixKnob;
         EffectEnableState enableState;
+        // The number of consecutive frames with silent input and output
+        SINT silentFrames;
     };
 
     QString debugString() const {
@@ -69,10 +98,9 @@ class EngineEffectChain final : public EffectsRequestHandler {
     EffectChainMixMode::Type m_mixMode;
     CSAMPLE m_dMix;
     QList<EngineEffect*> m_effects;
-    mixxx::SampleBuffer m_buffer1;
-    mixxx::SampleBuffer m_buffer2;
     ChannelHandleMap<ChannelHandleMap<ChannelStatus>> m_chainStatusForChannelMatrix;
     EngineEffectsDelay m_effectsDelay;
+    const EngineProfiler::StageId m_profilerStage;
 
     DISALLOW_COPY_AND_ASSIGN(EngineEffectChain);
 };
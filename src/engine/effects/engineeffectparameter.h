@@ -2,15 +2,19 @@
 
 #include <QString>
 #include <QVariant>
+#include <atomic>
 
 #include "effects/backends/effectmanifestparameter.h"
 #include "util/class.h"
 
+/// The engine side of an EffectParameter. The value is written by the
+/// EffectParameter in the main thread and read by the EffectProcessor in
+/// every callback of the audio thread, without sending any EffectsRequest.
 class EngineEffectParameter {
   public:
     EngineEffectParameter(EffectManifestParameterPointer pParameterManifest)
-            : m_pParameterManifest(pParameterManifest) {
-        m_value = m_pParameterManifest->getDefault();
+            : m_pParameterManifest(pParameterManifest),
+              m_value(pParameterManifest->getDefault()) {
     }
     virtual ~EngineEffectParameter() {
     }
@@ -19,9 +23,11 @@ class EngineEffectParameter {
         return m_pParameterManifest->id();
     }
 
+    /// Called in audio thread
     inline double value() const {
-        return m_value;
+        return m_value.load(std::memory_order_relaxed);
     }
+    /// Called in main thread by EffectParameter
     inline void setValue(const double value) {
         // Values should be clamped by EffectParameter before sending to the engine.
         VERIFY_OR_DEBUG_ASSERT(
@@ -29,18 +35,19 @@ class EngineEffectParameter {
                 value <= m_pParameterManifest->getMaximum()) {
             return;
         }
-        m_value = value;
+        m_value.store(value, std::memory_order_relaxed);
     }
     inline int toInt() const {
-        return static_cast<int>(m_value);
+        return static_cast<int>(value());
     }
     inline bool toBool() const {
-        return m_value > 0.0;
+        return value() > 0.0;
     }
 
   private:
     EffectManifestParameterPointer m_pParameterManifest;
-    double m_value;
+    // Each value is independent of the others, so no ordering is required.
+    std::atomic<double> m_value;
 
     DISALLOW_COPY_AND_ASSIGN(EngineEffectParameter);
 };
@@ -1,7 +1,7 @@
 #include "engine/effects/engineeffectsdelay.h"
 
 #include "moc_engineeffectsdelay.cpp"
-#include "util/rampingvalue.h"
+#include "util/math.h"
 #include "util/sample.h"
 
 EngineEffectsDelay::EngineEffectsDelay()
@@ -19,66 +19,70 @@ EngineEffectsDelay::~EngineEffectsDelay() {
 void EngineEffectsDelay::process(CSAMPLE* pInOut,
         const int iBufferSize) {
     if (m_prevDelaySamples == 0 && m_currentDelaySamples == 0) {
-        for (int i = 0; i < iBufferSize; ++i) {
-            // Put samples into delay buffer.
-            m_pDelayBuffer[m_delayBufferWritePos] = pInOut[i];
-            m_delayBufferWritePos = (m_delayBufferWritePos + 1) % kDelayBufferSize;
-        }
-
+        // Put samples into delay buffer.
+        m_delayBufferWritePos = SampleUtil::copyToRingBuffer(m_pDelayBuffer,
+                kDelayBufferSize,
+                m_delayBufferWritePos,
+                pInOut,
+                iBufferSize);
         return;
     }
 
-    // The "+ kDelayBufferSize" addition ensures positive values for the modulo calculation.
-    // From a mathematical point of view, this addition can be removed. Anyway,
-    // from the cpp point of view, the modulo operator for negative values
-    // (for example, x % y, where x is a negative value) produces negative results
-    // (but in math the result value is positive).
-    int delaySourcePos =
-            (m_delayBufferWritePos + kDelayBufferSize - m_currentDelaySamples) %
-            kDelayBufferSize;
-
-    if (m_prevDelaySamples == m_currentDelaySamples) {
-        for (int i = 0; i < iBufferSize; ++i) {
-            // Put samples into delay buffer.
-            m_pDelayBuffer[m_delayBufferWritePos] = pInOut[i];
-            m_delayBufferWritePos = (m_delayBufferWritePos + 1) % kDelayBufferSize;
+    // The samples are processed in chunks that are short enough that
+    // writing a whole chunk into the delay buffer does not overwrite any
+    // sample that is read for the same chunk. This way the chunks are
+    // copied and crossfaded in contiguous segments instead of sample by
+    // sample.
+    const SINT maxChunkSize = kDelayBufferSize -
+            math_max(m_prevDelaySamples, m_currentDelaySamples);
+    const CSAMPLE_GAIN crossMixDelta = 1.0f / iBufferSize;
 
-            // Take a delayed sample from the delay buffer
-            // and copy it to the destination buffer.
-            pInOut[i] = m_pDelayBuffer[delaySourcePos];
-            delaySourcePos = (delaySourcePos + 1) % kDelayBufferSize;
-        }
+    for (SINT offset = 0; offset < iBufferSize;) {
+        const SINT chunkSize = math_min(iBufferSize - offset, maxChunkSize);
 
-    } else {
         // The "+ kDelayBufferSize" addition ensures positive values for the modulo calculation.
         // From a mathematical point of view, this addition can be removed. Anyway,
         // from the cpp point of view, the modulo operator for negative values
         // (for example, x % y, where x is a negative value) produces negative results
         // (but in math the result value is positive).
-        int oldDelaySourcePos =
+        const SINT delaySourcePos =
+                (m_delayBufferWritePos + kDelayBufferSize - m_currentDelaySamples) %
+                kDelayBufferSize;
+        const SINT oldDelaySourcePos =
                 (m_delayBufferWritePos + kDelayBufferSize - m_prevDelaySamples) %
                 kDelayBufferSize;
 
-        const RampingValue<CSAMPLE_GAIN> delayChangeRamped(0.0f, 1.0f, iBufferSize);
-
-        for (int i = 0; i < iBufferSize; ++i) {
-            // Put samples into delay buffer.
-            m_pDelayBuffer[m_delayBufferWritePos] = pInOut[i];
-            m_delayBufferWritePos = (m_delayBufferWritePos + 1) % kDelayBufferSize;
+        // Put samples into delay buffer.
+        m_delayBufferWritePos = SampleUtil::copyToRingBuffer(m_pDelayBuffer,
+                kDelayBufferSize,
+                m_delayBufferWritePos,
+                pInOut + offset,
+                chunkSize);
 
+        if (m_prevDelaySamples == m_currentDelaySamples) {
+            // Take delayed samples from the delay buffer
+            // and copy them to the destination buffer.
+            SampleUtil::copyFromRingBuffer(pInOut + offset,
+                    m_pDelayBuffer,
+                    kDelayBufferSize,
+                    delaySourcePos,
+                    chunkSize);
+        } else {
             // Take delayed samples from the delay buffer
             // and with the use of ramping (cross-fading),
-            // calculate the result sample value
-            // and put it into the dest buffer.
-            CSAMPLE_GAIN crossMix = delayChangeRamped.getNth(i);
-
-            pInOut[i] = m_pDelayBuffer[oldDelaySourcePos] * (1.0f - crossMix);
-            pInOut[i] += m_pDelayBuffer[delaySourcePos] * crossMix;
-
-            oldDelaySourcePos = (oldDelaySourcePos + 1) % kDelayBufferSize;
-            delaySourcePos = (delaySourcePos + 1) % kDelayBufferSize;
+            // calculate the result sample values
+            // and put them into the dest buffer.
+            SampleUtil::linearCrossfadeFromRingBuffer(pInOut + offset,
+                    m_pDelayBuffer,
+                    kDelayBufferSize,
+                    oldDelaySourcePos,
+                    delaySourcePos,
+                    crossMixDelta,
+                    offset,
+                    chunkSize);
         }
-
-        m_prevDelaySamples = m_currentDelaySamples;
+        offset += chunkSize;
     }
+
+    m_prevDelaySamples = m_currentDelaySamples;
 }
@@ -1,19 +1,50 @@
 #include "engine/effects/engineeffectsmanager.h"
 
+#include <algorithm>
+
 #include "engine/effects/engineeffect.h"
 #include "engine/effects/engineeffectchain.h"
 #include "util/defs.h"
 #include "util/sample.h"
 
 EngineEffectsManager::EngineEffectsManager(std::unique_ptr<EffectsResponsePipe> pResponsePipe)
-        : m_pResponsePipe(std::move(pResponsePipe)),
-          m_buffer1(MAX_BUFFER_LEN),
-          m_buffer2(MAX_BUFFER_LEN) {
+        : m_pResponsePipe(std::move(pResponsePipe)) {
     // Try to prevent memory allocation.
     m_effects.reserve(256);
 }
 
+namespace {
+
+// pParents is a forest of the channels in which every parent has a lower
+// index than its children
+int findRoot(int* pParents, int index) {
+    while (pParents[index] != index) {
+        // Path halving
+        pParents[index] = pParents[pParents[index]];
+        index = pParents[index];
+    }
+    return index;
+}
+
+bool anyChainEnabled(const QList<EngineEffectChain*>& chains) {
+    return std::any_of(chains.cbegin(),
+            chains.cend(),
+            [](const EngineEffectChain* pChain) {
+                return pChain && pChain->isEnabled();
+            });
+}
+
+} // anonymous namespace
+
 void EngineEffectsManager::onCallbackStart() {
+    for (const auto& chains : std::as_const(m_chainsByStage)) {
+        for (EngineEffectChain* pChain : chains) {
+            if (pChain) {
+                pChain->onCallbackStart();
+            }
+        }
+    }
+
     EffectsRequest* request = nullptr;
     while (m_pResponsePipe->readMessage(&request)) {
         EffectsResponse response(*request);
@@ -62,7 +93,6 @@ void EngineEffectsManager::onCallbackStart() {
             break;
         }
         case EffectsRequest::SET_EFFECT_PARAMETERS:
-        case EffectsRequest::SET_PARAMETER_PARAMETERS:
             VERIFY_OR_DEBUG_ASSERT(m_effects.contains(request->pTargetEffect)) {
                 response.success = false;
                 response.status = EffectsResponse::NO_SUCH_EFFECT;
@@ -132,6 +162,35 @@ void EngineEffectsManager::processPostFaderInPlace(
             fadeout);
 }
 
+void EngineEffectsManager::processPostFaderInPlaceAndMix(
+        const ChannelHandle& inputHandle,
+        const ChannelHandle& outputHandle,
+        CSAMPLE* pInOut,
+        CSAMPLE* pOut,
+        unsigned int numSamples,
+        unsigned int sampleRate,
+        const GroupFeatureState& groupFeatures,
+        CSAMPLE_GAIN oldGain,
+        CSAMPLE_GAIN newGain,
+        bool fadeout) {
+    if (!anyChainEnabled(m_chainsByStage.value(SignalProcessingStage::Postfader))) {
+        SampleUtil::applyRampingGainAndAdd(pInOut, pOut, oldGain, newGain, numSamples);
+        return;
+    }
+    processInner(SignalProcessingStage::Postfader,
+            inputHandle,
+            outputHandle,
+            pInOut,
+            pInOut,
+            numSamples,
+            sampleRate,
+            groupFeatures,
+            oldGain,
+            newGain,
+            fadeout);
+    SampleUtil::add(pOut, pInOut, numSamples);
+}
+
 void EngineEffectsManager::processPostFaderAndMix(
         const ChannelHandle& inputHandle,
         const ChannelHandle& outputHandle,
@@ -183,7 +242,8 @@ void EngineEffectsManager::processInner(
                             numSamples,
                             sampleRate,
                             groupFeatures,
-                            fadeout)) {
+                            fadeout,
+                            &m_scratchBuffers)) {
                 }
             }
         }
@@ -195,7 +255,17 @@ void EngineEffectsManager::processInner(
         // 3. Mix the temporary buffer into pOut
         //    ChannelMixer::applyEffectsAndMixChannels use
         //    this to mix channels into pOut regardless of whether any effects were processed.
-        CSAMPLE* pIntermediateInput = m_buffer1.data();
+        if (!anyChainEnabled(chains)) {
+            // Nothing to process, mix the input into pOut without copying it
+            SampleUtil::addWithRampingGain(pOut, pIn, oldGain, newGain, numSamples);
+            return;
+        }
+
+        CSAMPLE* const pBuffer1 = m_scratchBuffers.buffer(
+                EngineScratchBuffers::Role::EffectsManagerIntermediate1);
+        CSAMPLE* const pBuffer2 = m_scratchBuffers.buffer(
+                EngineScratchBuffers::Role::EffectsManagerIntermediate2);
+        CSAMPLE* pIntermediateInput = pBuffer1;
         if (oldGain == CSAMPLE_GAIN_ONE && newGain == CSAMPLE_GAIN_ONE) {
             // Avoid an unnecessary copy. EngineEffectChain::process does not modify the
             // input buffer when its input & output buffers are different, so this is okay.
@@ -208,10 +278,10 @@ void EngineEffectsManager::processInner(
         for (EngineEffectChain* pChain : chains) {
             if (pChain) {
                 // Select an unused intermediate buffer for the next output
-                if (pIntermediateInput == m_buffer1.data()) {
-                    pIntermediateOutput = m_buffer2.data();
+                if (pIntermediateInput == pBuffer1) {
+                    pIntermediateOutput = pBuffer2;
                 } else {
-                    pIntermediateOutput = m_buffer1.data();
+                    pIntermediateOutput = pBuffer1;
                 }
 
                 if (pChain->process(inputHandle,
@@ -221,7 +291,8 @@ void EngineEffectsManager::processInner(
                             numSamples,
                             sampleRate,
                             groupFeatures,
-                            fadeout)) {
+                            fadeout,
+                            &m_scratchBuffers)) {
                     // Output of this chain becomes the input of the next chain.
                     pIntermediateInput = pIntermediateOutput;
                 }
@@ -280,3 +351,73 @@ bool EngineEffectsManager::processEffectsRequest(EffectsRequest& message,
     pResponsePipe->writeMessage(response);
     return true;
 }
+
+int EngineEffectsManager::groupChannelsByPostFaderChains(
+        const ChannelHandle* pInputHandles,
+        int numInputs,
+        const ChannelHandle& outputHandle,
+        int* pGroups) const {
+    std::fill(pGroups, pGroups + numInputs, -1);
+    const auto it = m_chainsByStage.constFind(SignalProcessingStage::Postfader);
+    if (it == m_chainsByStage.constEnd()) {
+        return 0;
+    }
+
+    // Join the channels of each chain into one tree with the first channel
+    // as its root
+    for (const EngineEffectChain* pChain : it.value()) {
+        if (!pChain) {
+            continue;
+        }
+        int chainRoot = -1;
+        for (int i = 0; i < numInputs; ++i) {
+            if (!pChain->hasChannelStatus(pInputHandles[i], outputHandle)) {
+                // process() inserts the status into the status matrix of
+                // the chain, which is read for all channels
+                std::fill(pGroups, pGroups + numInputs, 0);
+                return numInputs > 0 ? 1 : 0;
+            }
+            if (!pChain->isProcessingChannel(pInputHandles[i], outputHandle)) {
+                continue;
+            }
+            if (pGroups[i] < 0) {
+                pGroups[i] = i;
+            }
+            const int channelRoot = findRoot(pGroups, i);
+            if (chainRoot < 0) {
+                chainRoot = channelRoot;
+            } else if (channelRoot != chainRoot) {
+                const int root = std::min(chainRoot, channelRoot);
+                pGroups[std::max(chainRoot, channelRoot)] = root;
+                chainRoot = root;
+            }
+        }
+    }
+
+    // Number the trees. The parent of each channel has been numbered
+    // already, because it has a lower index.
+    int numGroups = 0;
+    for (int i = 0; i < numInputs; ++i) {
+        if (pGroups[i] < 0) {
+            continue;
+        }
+        if (pGroups[i] == i) {
+            pGroups[i] = numGroups++;
+        } else {
+            pGroups[i] = pGroups[pGroups[i]];
+        }
+    }
+    return numGroups;
+}
+
+int EngineEffectsManager::enabledEffectChainCount() const {
+    int count = 0;
+    for (const auto& chains : std::as_const(m_chainsByStage)) {
+        for (const auto* pChain : chains) {
+            if (pChain->isEnabled()) {
+                ++count;
+            }
+        }
+    }
+    return count;
+}
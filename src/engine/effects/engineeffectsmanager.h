@@ -2,7 +2,7 @@
 
 #include "engine/channelhandle.h"
 #include "engine/effects/message.h"
-#include "util/samplebuffer.h"
+#include "engine/enginescratchbuffers.h"
 #include "util/types.h"
 
 class EngineEffectChain;
@@ -46,6 +46,21 @@ class EngineEffectsManager final : public EffectsRequestHandler {
             CSAMPLE_GAIN newGain = CSAMPLE_GAIN_ONE,
             bool fadeout = false);
 
+    /// Same as processPostFaderInPlace() followed by mixing the pInOut buffer
+    /// into the pOut buffer. Without any enabled chain the gain is applied
+    /// and the buffer is mixed in a single pass.
+    void processPostFaderInPlaceAndMix(
+            const ChannelHandle& inputHandle,
+            const ChannelHandle& outputHandle,
+            CSAMPLE* pInOut,
+            CSAMPLE* pOut,
+            unsigned int numSamples,
+            unsigned int sampleRate,
+            const GroupFeatureState& groupFeatures,
+            CSAMPLE_GAIN oldGain = CSAMPLE_GAIN_ONE,
+            CSAMPLE_GAIN newGain = CSAMPLE_GAIN_ONE,
+            bool fadeout = false);
+
     /// Process the postfader EngineEffectChains, leaving the pIn buffer unmodified
     /// and mixing the output into the pOut buffer. Using EngineEffectsManager's
     /// temporary buffers for this avoids the need for ChannelMixer to allocate a
@@ -63,10 +78,36 @@ class EngineEffectsManager final : public EffectsRequestHandler {
             CSAMPLE_GAIN newGain = CSAMPLE_GAIN_ONE,
             bool fadeout = false);
 
+    /// Assigns a group to each of the numInputs channels such that the
+    /// postfader EngineEffectChains do not share any state between channels
+    /// of different groups when they are processed for outputHandle. The
+    /// channels of different groups can be processed with
+    /// processPostFaderInPlace() concurrently, the channels of one group
+    /// must be processed in series. Writes the group of each channel to
+    /// pGroups, or -1 if no chain is processing the channel. The groups are
+    /// numbered in the order of their first channel. Returns the number of
+    /// groups. Called from audio thread.
+    int groupChannelsByPostFaderChains(
+            const ChannelHandle* pInputHandles,
+            int numInputs,
+            const ChannelHandle& outputHandle,
+            int* pGroups) const;
+
     bool processEffectsRequest(
             EffectsRequest& message,
             EffectsResponsePipe* pResponsePipe) override;
 
+    /// Allocates the temporary buffers for processing effects on numThreads
+    /// threads concurrently, see EngineScratchBuffers. Must not be called
+    /// while the engine is processing.
+    void reserveScratchBuffersForThreads(int numThreads) {
+        m_scratchBuffers.reserveThreads(numThreads);
+    }
+
+    /// The number of EngineEffectChains that are currently enabled,
+    /// called from audio thread
+    int enabledEffectChainCount() const;
+
   private:
     QString debugString() const {
         return QString("EngineEffectsManager");
@@ -98,6 +139,5 @@ class EngineEffectsManager final : public EffectsRequestHandler {
     QHash<SignalProcessingStage, QList<EngineEffectChain*>> m_chainsByStage;
     QList<EngineEffect*> m_effects;
 
-    mixxx::SampleBuffer m_buffer1;
-    mixxx::SampleBuffer m_buffer2;
+    EngineScratchBuffers m_scratchBuffers;
 };
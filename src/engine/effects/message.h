@@ -27,8 +27,8 @@ struct EffectsRequest {
         DISABLE_EFFECT_CHAIN_FOR_INPUT_CHANNEL,
 
         // Messages for EngineEffect
+        // Parameter values are not sent as messages, see EngineEffectParameter
         SET_EFFECT_PARAMETERS,
-        SET_PARAMETER_PARAMETERS,
 
         // Must come last.
         NUM_REQUEST_TYPES
@@ -38,8 +38,7 @@ struct EffectsRequest {
     // they initialize all the values of the struct corresponding to the type they select.
     EffectsRequest()
             : type(NUM_REQUEST_TYPES),
-              request_id(-1),
-              value(0.0) {
+              request_id(-1) {
         pTargetChain = nullptr;
         pTargetEffect = nullptr;
     }
@@ -93,13 +92,7 @@ struct EffectsRequest {
         struct {
             bool enabled;
         } SetEffectParameters;
-        struct {
-            int iParameter;
-        } SetParameterParameters;
     };
-
-    // Used by SET_EFFECT_PARAMETER.
-    double value;
 };
 
 struct EffectsResponse {
@@ -108,7 +101,6 @@ struct EffectsResponse {
         UNHANDLED_MESSAGE_TYPE,
         NO_SUCH_CHAIN,
         NO_SUCH_EFFECT,
-        NO_SUCH_PARAMETER,
         INVALID_REQUEST,
 
         // Must come last.
@@ -54,6 +54,10 @@ constexpr int kPlaypositionUpdateRate = 15; // updates per second
 
 const QString kAppGroup = QStringLiteral("[App]");
 
+// Opt-in: Run the Rubber Band time stretching on a worker thread ahead of
+// the play position while the playback parameters are stable.
+const ConfigKey kKeylockLookAheadConfigKey(kAppGroup, QStringLiteral("keylock_lookahead"));
+
 } // anonymous namespace
 
 EngineBuffer::EngineBuffer(const QString& group,
@@ -86,10 +90,13 @@ EngineBuffer::EngineBuffer(const QString& group,
           m_pRepeat(nullptr),
           m_startButton(nullptr),
           m_endButton(nullptr),
+          m_scalerProfilerStage(EngineProfiler::instance().registerStage(
+                  group + QStringLiteral(" scaler"))),
           m_bScalerOverride(false),
           m_iSeekPhaseQueued(0),
           m_iEnableSyncQueued(SYNC_REQUEST_NONE),
           m_iSyncModeQueued(static_cast<int>(SyncMode::Invalid)),
+          m_bProcessedInParallel(false),
           m_bPlayAfterLoading(false),
           m_pCrossfadeBuffer(SampleUtil::alloc(MAX_BUFFER_LEN)),
           m_bCrossfadeReady(false),
@@ -326,6 +333,11 @@ EngineBuffer::~EngineBuffer() {
 
 void EngineBuffer::bindWorkers(EngineWorkerScheduler* pWorkerScheduler) {
     m_pReader->setScheduler(pWorkerScheduler);
+#ifdef __RUBBERBAND__
+    if (m_pConfig->getValue(kKeylockLookAheadConfigKey, false)) {
+        m_pScaleRB->enableLookAhead(pWorkerScheduler);
+    }
+#endif
 }
 
 void EngineBuffer::enableIndependentPitchTempoScaling(bool bEnable,
@@ -849,7 +861,11 @@ void EngineBuffer::processTrackLocked(
     }
 
     // Sync requests can affect rate, so process those first.
-    processSyncRequests();
+    // Requests that have been queued while the channels are processed in
+    // parallel are handled in the next callback, see EngineMixer.
+    if (!m_bProcessedInParallel) {
+        processSyncRequests();
+    }
 
     // Note: play is also active during cue preview
     bool paused = !m_playButton->toBool();
@@ -1061,7 +1077,11 @@ void EngineBuffer::processTrackLocked(
     // If the buffer is not paused, then scale the audio.
     if (!bCurBufferPaused) {
         // Perform scaling of Reader buffer into buffer.
-        const double framesRead = m_pScale->scaleBuffer(pOutput, iBufferSize);
+        double framesRead;
+        {
+            ScopedEngineProfile profile(m_scalerProfilerStage);
+            framesRead = m_pScale->scaleBuffer(pOutput, iBufferSize);
+        }
 
         // TODO(XXX): The result framesRead might not be an integer value.
         // Converting to samples here does not make sense. All positional
@@ -1254,6 +1274,12 @@ void EngineBuffer::processSlip(int iBufferSize) {
     }
 }
 
+bool EngineBuffer::isSyncProcessingRequired() const {
+    return m_pSyncControl->isSynchronized() ||
+            m_iEnableSyncQueued.loadAcquire() != SYNC_REQUEST_NONE ||
+            m_iSyncModeQueued.loadAcquire() != static_cast<int>(SyncMode::Invalid);
+}
+
 void EngineBuffer::processSyncRequests() {
     SyncRequestQueued enable_request =
             static_cast<SyncRequestQueued>(
@@ -1568,6 +1594,27 @@ double EngineBuffer::getRateRatio() const {
     return 1.0;
 }
 
+bool EngineBuffer::isPlaying() const {
+    return m_playButton->toBool();
+}
+
+const char* EngineBuffer::currentScalerName() const {
+    if (m_pScale == m_pScaleLinear) {
+        return "Linear";
+    } else if (m_pScale == m_pScaleST) {
+        return "SoundTouch";
+#ifdef __RUBBERBAND__
+    } else if (m_pScale == m_pScaleRB) {
+        return "RubberBand";
+#endif
+    }
+    return "Custom";
+}
+
+SINT EngineBuffer::cacheMissCount() const {
+    return m_pReader->cacheMissCount();
+}
+
 void EngineBuffer::collectFeatures(GroupFeatureState* pGroupFeatures) const {
     if (m_pBpmControl != nullptr) {
         m_pBpmControl->collectFeatures(pGroupFeatures);
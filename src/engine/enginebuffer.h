@@ -10,6 +10,7 @@
 #include "control/controlvalue.h"
 #include "engine/cachingreader/cachingreader.h"
 #include "engine/engineobject.h"
+#include "engine/engineprofiler.h"
 #include "engine/slipmodestate.h"
 #include "engine/sync/syncable.h"
 #include "preferences/usersettings.h"
@@ -130,6 +131,15 @@ class EngineBuffer : public EngineObject {
     void requestEnableSync(bool enabled);
     void requestSyncMode(SyncMode mode);
 
+    // Returns true if the next call of process() might interact with
+    // EngineSync, i.e. if sync is enabled or a sync request is queued.
+    bool isSyncProcessingRequired() const;
+    // Sync requests are deferred while processed in parallel with other
+    // channels, because EngineSync is not thread-safe.
+    void setProcessedInParallel(bool processedInParallel) {
+        m_bProcessedInParallel = processedInParallel;
+    }
+
     // The process methods all run in the audio callback.
     void process(CSAMPLE* pOut, const int iBufferSize) override;
     void processSlip(int iBufferSize);
@@ -152,6 +162,13 @@ class EngineBuffer : public EngineObject {
 
     double getRateRatio() const;
 
+    // The following methods are real-time safe and intended for
+    // diagnostics from the callback thread.
+    bool isPlaying() const;
+    // The name of the scaler that is currently in use
+    const char* currentScalerName() const;
+    SINT cacheMissCount() const;
+
     void collectFeatures(GroupFeatureState* pGroupFeatures) const override;
 
     // For dependency injection of scalers.
@@ -413,6 +430,8 @@ class EngineBuffer : public EngineObject {
     // Object used to perform waveform scaling (sample rate conversion).  These
     // three pointers may be reassigned depending on configuration and tests.
     EngineBufferScale* m_pScale;
+    // EngineProfiler stage of m_pScale->scaleBuffer()
+    const EngineProfiler::StageId m_scalerProfilerStage;
     FRIEND_TEST(EngineBufferTest, SlowRubberBand);
     FRIEND_TEST(EngineBufferTest, ResetPitchAdjustUsesLinear);
     FRIEND_TEST(EngineBufferTest, VinylScalerRampZero);
@@ -440,6 +459,7 @@ class EngineBuffer : public EngineObject {
     QAtomicInt m_iSeekPhaseQueued;
     QAtomicInt m_iEnableSyncQueued;
     QAtomicInt m_iSyncModeQueued;
+    bool m_bProcessedInParallel;
     ControlValueAtomic<QueuedSeek> m_queuedSeek;
     bool m_previousBufferSeek = false;
 
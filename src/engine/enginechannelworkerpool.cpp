@@ -0,0 +1,212 @@
+#include "engine/enginechannelworkerpool.h"
+
+#include <QThread>
+#include <thread>
+
+#ifdef __LINUX__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "engine/enginescratchbuffers.h"
+#include "util/assert.h"
+#include "util/cpuaffinity.h"
+#include "util/denormalsarezero.h"
+#include "util/logger.h"
+#include "util/math.h"
+#include "util/realtimeallocationtracker.h"
+
+namespace {
+
+const mixxx::Logger kLogger("EngineChannelWorkerPool");
+
+// The number of busy-wait iterations in finish() before yielding
+constexpr int kSpinCountBeforeYield = 1000;
+
+constexpr quint64 kJobIndexMask = 0xffffffff;
+
+constexpr quint64 packJobs(int numJobs) {
+    return static_cast<quint64>(numJobs) << 32;
+}
+
+constexpr int numJobsOf(quint64 jobs) {
+    return static_cast<int>(jobs >> 32);
+}
+
+constexpr int jobIndexOf(quint64 jobs) {
+    return static_cast<int>(jobs & kJobIndexMask);
+}
+
+} // anonymous namespace
+
+class EngineChannelWorkerPool::Worker : public QThread {
+  public:
+    Worker(EngineChannelWorkerPool* pPool, int workerIndex, bool pin)
+            : m_pPool(pPool),
+              m_workerIndex(workerIndex),
+              m_pin(pin),
+              m_schedulingGeneration(0) {
+        setObjectName(QStringLiteral("EngineChannelWorker %1").arg(workerIndex));
+    }
+
+  protected:
+    void run() override {
+        mixxx::enableDenormalsAreZero();
+        // Slot 0 is used by the callback thread
+        EngineScratchBuffers::setThreadSlot(m_workerIndex + 1);
+        if (m_pin) {
+            pinToCore();
+        } else {
+            mixxx::CpuAffinity::applyToCurrentThread(
+                    mixxx::CpuAffinity::ThreadRole::Engine);
+        }
+        while (true) {
+            m_pPool->m_wakeSemaphore.acquire();
+            if (m_pPool->m_quit.load(std::memory_order_acquire)) {
+                break;
+            }
+            updateScheduling();
+            m_pPool->processJobs();
+        }
+    }
+
+  private:
+    void pinToCore() {
+#ifdef __LINUX__
+        int core;
+        const QList<int>& engineCores = mixxx::CpuAffinity::engineCores();
+        if (engineCores.size() == 1) {
+            core = engineCores.first();
+        } else if (!engineCores.isEmpty()) {
+            // Leave the first engine core for the callback thread
+            core = engineCores[1 + m_workerIndex % (engineCores.size() - 1)];
+        } else {
+            const int numCores = QThread::idealThreadCount();
+            if (numCores <= 1) {
+                return;
+            }
+            // Leave the first core for the callback thread and other threads
+            core = 1 + m_workerIndex % (numCores - 1);
+        }
+        cpu_set_t cpuSet;
+        CPU_ZERO(&cpuSet);
+        CPU_SET(core, &cpuSet);
+        if (pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet) != 0) {
+            kLogger.warning() << objectName() << "failed to pin to CPU core" << core;
+        }
+#endif
+    }
+
+    void updateScheduling() {
+#ifdef __LINUX__
+        const int generation = m_pPool->m_schedulingGeneration.load(
+                std::memory_order_acquire);
+        if (generation == m_schedulingGeneration) {
+            return;
+        }
+        m_schedulingGeneration = generation;
+        struct sched_param param = {};
+        param.sched_priority = m_pPool->m_schedulingPriority.load(
+                std::memory_order_relaxed);
+        const int policy = m_pPool->m_schedulingPolicy.load(
+                std::memory_order_relaxed);
+        if (pthread_setschedparam(pthread_self(), policy, &param) != 0) {
+            kLogger.warning() << objectName()
+                              << "failed to adopt the scheduling of the callback thread";
+        }
+#endif
+    }
+
+    EngineChannelWorkerPool* const m_pPool;
+    const int m_workerIndex;
+    const bool m_pin;
+    int m_schedulingGeneration;
+};
+
+EngineChannelWorkerPool::EngineChannelWorkerPool(
+        int numWorkers,
+        bool pinWorkers,
+        JobFunction jobFunction,
+        void* pContext)
+        : m_jobFunction(jobFunction),
+          m_pContext(pContext),
+          m_jobs(0),
+          m_pendingJobs(0),
+          m_schedulingPolicy(0),
+          m_schedulingPriority(0),
+          m_schedulingGeneration(0),
+          m_schedulingAdopted(false),
+          m_quit(false) {
+    DEBUG_ASSERT(m_jobFunction);
+    numWorkers = math_clamp(numWorkers, 1, kMaxWorkers);
+    kLogger.info() << "Starting" << numWorkers << "worker threads";
+    m_workers.reserve(numWorkers);
+    for (int i = 0; i < numWorkers; ++i) {
+        m_workers.push_back(std::make_unique<Worker>(this, i, pinWorkers));
+        m_workers.back()->start(QThread::TimeCriticalPriority);
+    }
+}
+
+EngineChannelWorkerPool::~EngineChannelWorkerPool() {
+    m_quit.store(true, std::memory_order_release);
+    m_wakeSemaphore.release(numWorkers());
+    for (const auto& pWorker : m_workers) {
+        pWorker->wait();
+    }
+}
+
+void EngineChannelWorkerPool::adoptSchedulingOfCurrentThread() {
+#ifdef __LINUX__
+    int policy;
+    struct sched_param param;
+    if (pthread_getschedparam(pthread_self(), &policy, &param) != 0) {
+        return;
+    }
+    m_schedulingPolicy.store(policy, std::memory_order_relaxed);
+    m_schedulingPriority.store(param.sched_priority, std::memory_order_relaxed);
+    m_schedulingGeneration.fetch_add(1, std::memory_order_release);
+#endif
+}
+
+void EngineChannelWorkerPool::start(int numJobs) {
+    DEBUG_ASSERT(numJobs >= 0);
+    DEBUG_ASSERT(m_pendingJobs.load(std::memory_order_relaxed) == 0);
+    if (!m_schedulingAdopted) {
+        // The callback thread is not known before the first callback
+        adoptSchedulingOfCurrentThread();
+        m_schedulingAdopted = true;
+    }
+    if (numJobs == 0) {
+        return;
+    }
+    m_pendingJobs.store(numJobs, std::memory_order_relaxed);
+    m_jobs.store(packJobs(numJobs), std::memory_order_release);
+    // The callback thread takes its share in finish()
+    m_wakeSemaphore.release(math_min(numJobs, numWorkers()));
+}
+
+void EngineChannelWorkerPool::finish() {
+    processJobs();
+    // Lock-free barrier: Wait until the workers have finished the jobs
+    // they have claimed.
+    int spinCount = 0;
+    while (m_pendingJobs.load(std::memory_order_acquire) > 0) {
+        if (++spinCount >= kSpinCountBeforeYield) {
+            std::this_thread::yield();
+            spinCount = 0;
+        }
+    }
+}
+
+void EngineChannelWorkerPool::processJobs() {
+    mixxx::RealtimeAllocationTracker::RealtimeSection realtimeSection;
+    while (true) {
+        const quint64 jobs = m_jobs.fetch_add(1, std::memory_order_acq_rel);
+        const int jobIndex = jobIndexOf(jobs);
+        if (jobIndex >= numJobsOf(jobs)) {
+            return;
+        }
+        m_jobFunction(m_pContext, jobIndex);
+        m_pendingJobs.fetch_sub(1, std::memory_order_release);
+    }
+}
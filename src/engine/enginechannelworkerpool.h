@@ -0,0 +1,71 @@
+#pragma once
+
+#include <QSemaphore>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+// A small pool of worker threads that help the audio callback thread to
+// process independent jobs, e.g. the EngineChannels, in parallel.
+//
+// The callback thread distributes a batch of jobs with start(), is free
+// to do other work, and then calls finish(). finish() processes the jobs
+// that have not been picked up by a worker yet on the callback thread and
+// spins until all jobs are done. Jobs are claimed from a single atomic
+// counter and the barrier is a lock-free countdown, so the callback thread
+// never blocks on a worker.
+//
+// The workers adopt the scheduling policy and priority of the callback
+// thread on Linux and use the time critical priority on other platforms.
+// On Linux they can also be pinned to distinct CPU cores.
+class EngineChannelWorkerPool final {
+  public:
+    // Processes the job with the given index. Invoked concurrently from
+    // multiple threads with different indices.
+    typedef void (*JobFunction)(void* pContext, int jobIndex);
+
+    // The maximum number of worker threads
+    static constexpr int kMaxWorkers = 16;
+
+    EngineChannelWorkerPool(
+            int numWorkers,
+            bool pinWorkers,
+            JobFunction jobFunction,
+            void* pContext);
+    ~EngineChannelWorkerPool();
+
+    int numWorkers() const {
+        return static_cast<int>(m_workers.size());
+    }
+
+    // Must only be called from the callback thread and must be
+    // followed by finish() before starting the next batch.
+    void start(int numJobs);
+    void finish();
+
+  private:
+    class Worker;
+
+    void processJobs();
+    void adoptSchedulingOfCurrentThread();
+
+    const JobFunction m_jobFunction;
+    void* const m_pContext;
+
+    // The number of jobs in the upper and the index of the next
+    // unclaimed job in the lower 32 bits. Both are updated atomically
+    // together to prevent that a late worker of the previous batch
+    // claims a job with a stale count.
+    std::atomic<quint64> m_jobs;
+    std::atomic<int> m_pendingJobs;
+
+    // Scheduling of the callback thread that the workers should adopt
+    std::atomic<int> m_schedulingPolicy;
+    std::atomic<int> m_schedulingPriority;
+    std::atomic<int> m_schedulingGeneration;
+    bool m_schedulingAdopted;
+
+    std::atomic<bool> m_quit;
+    QSemaphore m_wakeSemaphore;
+    std::vector<std::unique_ptr<Worker>> m_workers;
+};
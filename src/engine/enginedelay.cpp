@@ -5,6 +5,7 @@
 #include "engine/engine.h"
 #include "moc_enginedelay.cpp"
 #include "util/assert.h"
+#include "util/math.h"
 #include "util/sample.h"
 
 namespace {
@@ -16,7 +17,8 @@ const QString kAppGroup = QStringLiteral("[App]");
 
 EngineDelay::EngineDelay(const ConfigKey& delayControl, bool bPersist)
         : m_iDelayPos(0),
-          m_iDelay(0) {
+          m_iDelay(0),
+          m_additionalDelayFrames(0) {
     m_pDelayBuffer = SampleUtil::alloc(kiMaxDelay);
     SampleUtil::clear(m_pDelayBuffer, kiMaxDelay);
     m_pDelayPot = new ControlPotmeter(delayControl, 0, kdMaxDelayPot, false, true, false, bPersist);
@@ -37,7 +39,7 @@ void EngineDelay::slotDelayChanged() {
     double newDelay = m_pDelayPot->get();
     double sampleRate = m_pSampleRate->get();
 
-    m_iDelay = (int)(sampleRate * newDelay / 1000);
+    m_iDelay = (int)(sampleRate * newDelay / 1000) + m_additionalDelayFrames;
     m_iDelay *= 2;
     if (m_iDelay > (kiMaxDelay - 2)) {
         m_iDelay = (kiMaxDelay - 2);
@@ -50,29 +52,43 @@ void EngineDelay::slotDelayChanged() {
 
 
 void EngineDelay::process(CSAMPLE* pInOut, const int iBufferSize) {
-    if (m_iDelay > 0) {
-        // The "+ kiMaxDelay" addition ensures positive values for the modulo calculation.
-        // From a mathematical point of view, this addition can be removed. Anyway,
-        // from the cpp point of view, the modulo operator for negative values
-        // (for example, x % y, where x is a negative value) produces negative results
-        // (but in math the result value is positive).
-        int iDelaySourcePos = (m_iDelayPos + kiMaxDelay - m_iDelay) % kiMaxDelay;
+    const int iDelay = m_iDelay;
+    if (iDelay > 0) {
+        // Writing at most kiMaxDelay - iDelay samples at once never
+        // overwrites a sample that is read for the same chunk, so it can be
+        // written and read back in contiguous segments.
+        const int iMaxChunkSize = kiMaxDelay - iDelay;
+        for (int offset = 0; offset < iBufferSize;) {
+            const int iChunkSize = math_min(iBufferSize - offset, iMaxChunkSize);
 
-        VERIFY_OR_DEBUG_ASSERT(iDelaySourcePos >= 0) {
-            return;
-        }
-        VERIFY_OR_DEBUG_ASSERT(iDelaySourcePos <= kiMaxDelay) {
-            return;
-        }
+            // The "+ kiMaxDelay" addition ensures positive values for the modulo calculation.
+            // From a mathematical point of view, this addition can be removed. Anyway,
+            // from the cpp point of view, the modulo operator for negative values
+            // (for example, x % y, where x is a negative value) produces negative results
+            // (but in math the result value is positive).
+            const int iDelaySourcePos = (m_iDelayPos + kiMaxDelay - iDelay) % kiMaxDelay;
+
+            VERIFY_OR_DEBUG_ASSERT(iDelaySourcePos >= 0) {
+                return;
+            }
+            VERIFY_OR_DEBUG_ASSERT(iDelaySourcePos < kiMaxDelay) {
+                return;
+            }
 
-        for (int i = 0; i < iBufferSize; ++i) {
-            // put sample into delay buffer:
-            m_pDelayBuffer[m_iDelayPos] = pInOut[i];
-            m_iDelayPos = (m_iDelayPos + 1) % kiMaxDelay;
+            // put samples into delay buffer:
+            m_iDelayPos = SampleUtil::copyToRingBuffer(m_pDelayBuffer,
+                    kiMaxDelay,
+                    m_iDelayPos,
+                    pInOut + offset,
+                    iChunkSize);
 
-            // Take delayed sample from delay buffer and copy it to dest buffer:
-            pInOut[i] = m_pDelayBuffer[iDelaySourcePos];
-            iDelaySourcePos = (iDelaySourcePos + 1) % kiMaxDelay;
+            // Take delayed samples from delay buffer and copy them to dest buffer:
+            SampleUtil::copyFromRingBuffer(pInOut + offset,
+                    m_pDelayBuffer,
+                    kiMaxDelay,
+                    iDelaySourcePos,
+                    iChunkSize);
+            offset += iChunkSize;
         }
     }
 }
@@ -80,3 +96,11 @@ void EngineDelay::process(CSAMPLE* pInOut, const int iBufferSize) {
 void EngineDelay::setDelay(double newDelay) {
     m_pDelayPot->set(newDelay);
 }
+
+void EngineDelay::setAdditionalDelayFrames(int frames) {
+    if (frames == m_additionalDelayFrames) {
+        return;
+    }
+    m_additionalDelayFrames = frames;
+    slotDelayChanged();
+}
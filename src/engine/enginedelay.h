@@ -15,6 +15,9 @@ class EngineDelay : public EngineObject {
     void process(CSAMPLE* pInOut, const int iBufferSize);
 
     void setDelay(double newDelay);
+    /// Adds a fixed delay to the configured one, e.g. to compensate the
+    /// latency of other processing
+    void setAdditionalDelayFrames(int frames);
 
   public slots:
     void slotDelayChanged();
@@ -25,4 +28,5 @@ class EngineDelay : public EngineObject {
     CSAMPLE* m_pDelayBuffer;
     int m_iDelayPos;
     int m_iDelay;
+    int m_additionalDelayFrames;
 };
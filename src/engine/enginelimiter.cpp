@@ -0,0 +1,164 @@
+#include "engine/enginelimiter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "engine/engine.h"
+#include "moc_enginelimiter.cpp"
+#include "util/assert.h"
+#include "util/defs.h"
+#include "util/math.h"
+#include "util/sample.h"
+
+namespace {
+
+constexpr double kLookaheadSeconds = 0.0015;
+constexpr double kReleaseSeconds = 0.08;
+
+const SINT kMaxLookaheadFrames = static_cast<SINT>(
+        std::ceil(kLookaheadSeconds * mixxx::audio::SampleRate::kValueMax));
+// The peak detection needs one frame before and two frames after each
+// detected frame
+const SINT kMaxHistoryFrames = kMaxLookaheadFrames + 3;
+
+} // anonymous namespace
+
+EngineLimiter::EngineLimiter()
+        : m_ceiling(CSAMPLE_GAIN_ONE),
+          m_lookaheadFrames(1),
+          m_releaseCoefficient(0),
+          m_gainReduction(CSAMPLE_GAIN_ONE),
+          m_pDelayBuffer(SampleUtil::alloc(
+                  kMaxHistoryFrames * mixxx::kEngineChannelCount + MAX_BUFFER_LEN)),
+          m_pTargetGains(SampleUtil::alloc(MAX_BUFFER_LEN / mixxx::kEngineChannelCount)),
+          m_pGains(SampleUtil::alloc(MAX_BUFFER_LEN / mixxx::kEngineChannelCount)),
+          m_minFrames(kMaxLookaheadFrames + 2),
+          m_minGains(kMaxLookaheadFrames + 2),
+          m_minHead(0),
+          m_minCount(0),
+          m_frame(0),
+          m_releasedGain(CSAMPLE_GAIN_ONE),
+          m_averageGains(kMaxLookaheadFrames),
+          m_averagePos(0),
+          m_averageSum(0) {
+    setSampleRate(mixxx::audio::SampleRate(44100));
+}
+
+EngineLimiter::~EngineLimiter() {
+    SampleUtil::free(m_pDelayBuffer);
+    SampleUtil::free(m_pTargetGains);
+    SampleUtil::free(m_pGains);
+}
+
+void EngineLimiter::setSampleRate(mixxx::audio::SampleRate sampleRate) {
+    VERIFY_OR_DEBUG_ASSERT(sampleRate.isValid()) {
+        return;
+    }
+    if (sampleRate == m_sampleRate) {
+        return;
+    }
+    m_sampleRate = sampleRate;
+    m_lookaheadFrames = math_clamp(
+            static_cast<SINT>(std::round(kLookaheadSeconds * sampleRate.toDouble())),
+            SINT(1),
+            kMaxLookaheadFrames);
+    m_releaseCoefficient = static_cast<CSAMPLE_GAIN>(
+            std::exp(-1.0 / (kReleaseSeconds * sampleRate.toDouble())));
+    reset();
+}
+
+void EngineLimiter::reset() {
+    SampleUtil::clear(m_pDelayBuffer, kMaxHistoryFrames * mixxx::kEngineChannelCount);
+    m_minHead = 0;
+    m_minCount = 0;
+    m_frame = 0;
+    m_releasedGain = CSAMPLE_GAIN_ONE;
+    std::fill(m_averageGains.begin(), m_averageGains.end(), CSAMPLE_GAIN_ONE);
+    m_averagePos = 0;
+    m_averageSum = static_cast<double>(m_lookaheadFrames);
+    m_gainReduction = CSAMPLE_GAIN_ONE;
+}
+
+void EngineLimiter::pushTargetGain(SINT frame, CSAMPLE_GAIN gain) {
+    const SINT capacity = static_cast<SINT>(m_minGains.size());
+    // Larger gains before this one can never become the minimum again
+    while (m_minCount > 0) {
+        const SINT back = (m_minHead + m_minCount - 1) % capacity;
+        if (m_minGains[back] < gain) {
+            break;
+        }
+        --m_minCount;
+    }
+    const SINT pos = (m_minHead + m_minCount) % capacity;
+    m_minFrames[pos] = frame;
+    m_minGains[pos] = gain;
+    ++m_minCount;
+    // Drop the frames that are behind the lookahead
+    while (m_minFrames[m_minHead] < frame - m_lookaheadFrames) {
+        m_minHead = (m_minHead + 1) % capacity;
+        --m_minCount;
+    }
+}
+
+void EngineLimiter::process(CSAMPLE* pInOut, const int iBufferSize) {
+    VERIFY_OR_DEBUG_ASSERT(iBufferSize <= static_cast<int>(MAX_BUFFER_LEN)) {
+        return;
+    }
+    const int numFrames = iBufferSize / mixxx::kEngineChannelCount;
+    if (numFrames <= 0) {
+        return;
+    }
+    const SINT historyFrames = m_lookaheadFrames + 3;
+    SampleUtil::copy(m_pDelayBuffer + historyFrames * mixxx::kEngineChannelCount,
+            pInOut,
+            iBufferSize);
+
+    // The target gains from the second last frame of the history on. The
+    // peak between two frames is interpolated from the four frames around it.
+    const CSAMPLE* pDetect = m_pDelayBuffer + (historyFrames - 2) * mixxx::kEngineChannelCount;
+    const CSAMPLE_GAIN ceiling = m_ceiling;
+    // note: LOOP VECTORIZED only with "int i" (not SINT i)
+    for (int i = 0; i < numFrames; ++i) {
+        const CSAMPLE* pFrame = pDetect + i * 2;
+        const CSAMPLE midLeft = (9 * (pFrame[0] + pFrame[2]) - pFrame[-2] - pFrame[4]) / 16;
+        const CSAMPLE midRight = (9 * (pFrame[1] + pFrame[3]) - pFrame[-1] - pFrame[5]) / 16;
+        const CSAMPLE peak = math_max(
+                math_max(std::fabs(pFrame[0]), std::fabs(pFrame[1])),
+                math_max(std::fabs(midLeft), std::fabs(midRight)));
+        m_pTargetGains[i] = peak > ceiling ? ceiling / peak : CSAMPLE_GAIN_ONE;
+    }
+
+    // The gain envelope: The minimum of the target gains within the
+    // lookahead, released exponentially and averaged over the lookahead,
+    // reaches each target gain before the delayed peak is output.
+    CSAMPLE_GAIN gainReduction = CSAMPLE_GAIN_ONE;
+    for (int i = 0; i < numFrames; ++i) {
+        pushTargetGain(m_frame++, m_pTargetGains[i]);
+        m_releasedGain = math_min(m_minGains[m_minHead],
+                CSAMPLE_GAIN_ONE -
+                        (CSAMPLE_GAIN_ONE - m_releasedGain) * m_releaseCoefficient);
+        m_averageSum += m_releasedGain - m_averageGains[m_averagePos];
+        m_averageGains[m_averagePos] = m_releasedGain;
+        if (++m_averagePos == m_lookaheadFrames) {
+            m_averagePos = 0;
+        }
+        m_pGains[i] = static_cast<CSAMPLE_GAIN>(m_averageSum / m_lookaheadFrames);
+        gainReduction = math_min(gainReduction, m_pGains[i]);
+    }
+    m_gainReduction = gainReduction;
+
+    // Output the delayed frames, clamped to stay exactly below the ceiling
+    // despite rounding
+    const CSAMPLE* pDelayed = m_pDelayBuffer + mixxx::kEngineChannelCount;
+    // note: LOOP VECTORIZED only with "int i" (not SINT i)
+    for (int i = 0; i < numFrames; ++i) {
+        pInOut[i * 2] = math_clamp(pDelayed[i * 2] * m_pGains[i], -ceiling, ceiling);
+        pInOut[i * 2 + 1] = math_clamp(pDelayed[i * 2 + 1] * m_pGains[i], -ceiling, ceiling);
+    }
+
+    // Keep the history for the next block
+    std::memmove(m_pDelayBuffer,
+            m_pDelayBuffer + numFrames * mixxx::kEngineChannelCount,
+            historyFrames * mixxx::kEngineChannelCount * sizeof(CSAMPLE));
+}
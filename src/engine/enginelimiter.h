@@ -0,0 +1,74 @@
+#pragma once
+
+#include <vector>
+
+#include "audio/types.h"
+#include "engine/engineobject.h"
+
+/// A stereo lookahead brickwall limiter, which keeps the output below a
+/// ceiling without clipping.
+///
+/// The gain is reduced smoothly ahead of each peak, so the output is
+/// delayed by latencyFrames(). Besides the sample peaks, the inter-sample
+/// peaks between adjacent frames are estimated by interpolation to keep
+/// the true peak level of the analog output below the ceiling, too.
+///
+/// Peak detection and gain are applied to whole blocks, only the gain
+/// envelope is followed frame by frame.
+class EngineLimiter : public EngineObject {
+    Q_OBJECT
+  public:
+    EngineLimiter();
+    ~EngineLimiter() override;
+
+    /// Resets the limiter if the sample rate has changed
+    void setSampleRate(mixxx::audio::SampleRate sampleRate);
+    void setCeiling(CSAMPLE_GAIN ceiling) {
+        m_ceiling = ceiling;
+    }
+
+    /// The delay of the output, which depends on the sample rate
+    SINT latencyFrames() const {
+        return m_lookaheadFrames + 2;
+    }
+
+    /// The lowest gain that has been applied in the last block
+    CSAMPLE_GAIN gainReduction() const {
+        return m_gainReduction;
+    }
+
+    /// Clears the delayed samples and the gain envelope, e.g. before the
+    /// limiter is used again after being bypassed.
+    void reset();
+
+    void process(CSAMPLE* pInOut, const int iBufferSize) override;
+
+  private:
+    void pushTargetGain(SINT frame, CSAMPLE_GAIN gain);
+
+    mixxx::audio::SampleRate m_sampleRate;
+    CSAMPLE_GAIN m_ceiling;
+    SINT m_lookaheadFrames;
+    CSAMPLE_GAIN m_releaseCoefficient;
+    CSAMPLE_GAIN m_gainReduction;
+
+    // The delayed frames of the previous blocks followed by the current block
+    CSAMPLE* m_pDelayBuffer;
+    // The target gains and the output gains of the current block
+    CSAMPLE* m_pTargetGains;
+    CSAMPLE* m_pGains;
+
+    // The minimum of the target gains within the lookahead as a
+    // monotonic queue of frames and their gains in a ring buffer
+    std::vector<SINT> m_minFrames;
+    std::vector<CSAMPLE_GAIN> m_minGains;
+    SINT m_minHead;
+    SINT m_minCount;
+    SINT m_frame;
+
+    // The released gains, averaged over the lookahead
+    CSAMPLE_GAIN m_releasedGain;
+    std::vector<CSAMPLE_GAIN> m_averageGains;
+    SINT m_averagePos;
+    double m_averageSum;
+};
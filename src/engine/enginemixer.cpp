@@ -1,30 +1,50 @@
 #include "engine/enginemixer.h"
 
+#include <algorithm>
+
+#include "analyzer/analyzerthread.h"
 #include "control/controlaudiotaperpot.h"
 #include "control/controlpotmeter.h"
 #include "control/controlpushbutton.h"
 #include "effects/effectsmanager.h"
 #include "engine/channelmixer.h"
 #include "engine/channels/enginechannel.h"
+#include "engine/enginechannelworkerpool.h"
 #include "engine/effects/engineeffectsmanager.h"
+#include "engine/engine.h"
 #include "engine/enginebuffer.h"
 #include "engine/enginedelay.h"
+#include "engine/enginelimiter.h"
 #include "engine/enginetalkoverducking.h"
 #include "engine/enginevumeter.h"
 #include "engine/engineworkerscheduler.h"
 #include "engine/enginexfader.h"
+#include "engine/sidechain/enginemultitrackrecord.h"
 #include "engine/sidechain/enginesidechain.h"
 #include "engine/sync/enginesync.h"
 #include "mixer/playermanager.h"
 #include "moc_enginemixer.cpp"
 #include "preferences/usersettings.h"
+#include "soundio/xrunlog.h"
 #include "util/defs.h"
+#include "util/realtimeallocationtracker.h"
 #include "util/sample.h"
+#include "waveform/visualplayposition.h"
 
 namespace {
 const QString kAppGroup = QStringLiteral("[App]");
 const QString kLegacyGroup = QStringLiteral("[Master]");
 const QString kMainGroup = QStringLiteral("[Main]");
+
+// 0 disables the parallel processing of the channels
+const ConfigKey kChannelWorkerCountConfigKey =
+        ConfigKey(kAppGroup, QStringLiteral("channel_worker_count"));
+const ConfigKey kChannelWorkerAffinityConfigKey =
+        ConfigKey(kAppGroup, QStringLiteral("channel_worker_affinity"));
+
+// 0 processes the whole device buffer at once
+const ConfigKey kSubBlockFramesConfigKey =
+        ConfigKey(kAppGroup, QStringLiteral("engine_sub_block_frames"));
 } // namespace
 
 EngineMixer::EngineMixer(
@@ -48,7 +68,15 @@ EngineMixer::EngineMixer(
           m_busTalkoverHandle(registerChannelGroup("[BusTalkover]")),
           m_busCrossfaderLeftHandle(registerChannelGroup("[BusLeft]")),
           m_busCrossfaderCenterHandle(registerChannelGroup("[BusCenter]")),
-          m_busCrossfaderRightHandle(registerChannelGroup("[BusRight]")) {
+          m_busCrossfaderRightHandle(registerChannelGroup("[BusRight]")),
+          m_parallelBufferSize(0),
+          m_parallelJobs(ParallelJobs::Channels),
+          m_headphoneMixStage(EngineProfiler::instance().registerStage(
+                  QStringLiteral("Headphone mix"))),
+          m_mainMixStage(EngineProfiler::instance().registerStage(
+                  QStringLiteral("Main mix"))),
+          m_sidechainStage(EngineProfiler::instance().registerStage(
+                  QStringLiteral("Sidechain write"))) {
     pEffectsManager->registerInputChannel(m_mainHandle);
     pEffectsManager->registerInputChannel(m_headphoneHandle);
     pEffectsManager->registerOutputChannel(m_mainHandle);
@@ -63,6 +91,7 @@ EngineMixer::EngineMixer(
     m_bBusOutputConnected[EngineChannel::CENTER] = false;
     m_bBusOutputConnected[EngineChannel::RIGHT] = false;
     m_bExternalRecordBroadcastInputConnected = false;
+    m_bRecordBroadcastOutputConnected = false;
     m_pWorkerScheduler = new EngineWorkerScheduler(this);
     m_pWorkerScheduler->start(QThread::HighPriority);
 
@@ -123,6 +152,29 @@ EngineMixer::EngineMixer(
     m_pLatencyCompensationDelay =
             new EngineDelay(ConfigKey(group, "microphoneLatencyCompensation"));
 
+    // Lookahead limiter on the main and booth outputs
+    m_pMainLimiter = new EngineLimiter();
+    m_pBoothLimiter = new EngineLimiter();
+    m_pLimiterEnabled = new ControlPushButton(
+            ConfigKey(group, QStringLiteral("limiter_enabled")), true);
+    m_pLimiterEnabled->setButtonMode(ControlPushButton::TOGGLE);
+    m_pLimiterCeiling = new ControlPotmeter(
+            ConfigKey(group, QStringLiteral("limiter_ceiling_db")),
+            -12.0,
+            0.0,
+            false,
+            true,
+            false,
+            true,
+            -1.0);
+    m_pLimiterLatencyMs = new ControlObject(
+            ConfigKey(group, QStringLiteral("limiter_latency_ms")));
+    m_pLimiterLatencyMs->setReadOnly();
+    m_pLimiterGainReduction = new ControlObject(
+            ConfigKey(group, QStringLiteral("limiter_gain_reduction")));
+    m_pLimiterGainReduction->setReadOnly();
+    m_limiterActive = false;
+
     // Headphone volume
     m_pHeadGain = new ControlAudioTaperPot(ConfigKey(group, "headGain"), -14, 14, 0.5);
 
@@ -162,10 +214,27 @@ EngineMixer::EngineMixer(
         SampleUtil::clear(m_pOutputBusBuffers[o], MAX_BUFFER_LEN);
     }
 
+    // Controls, scratching and the inputs are applied once per sub-block
+    // instead of once per device buffer if enabled.
+    m_subBlockFrames = std::max(0, pConfig->getValue(kSubBlockFramesConfigKey, 0));
+    m_pSidechainStaging = nullptr;
+    if (m_subBlockFrames > 0) {
+        addSubBlockOutput(m_pMain);
+        addSubBlockOutput(m_pBooth);
+        addSubBlockOutput(m_pHead);
+        for (int o = EngineChannel::LEFT; o <= EngineChannel::RIGHT; ++o) {
+            addSubBlockOutput(m_pOutputBusBuffers[o]);
+        }
+        m_pSidechainStaging = addSubBlockOutput(m_pSidechainMix);
+    }
+
     // Starts a thread for recording and broadcast
     m_pEngineSideChain =
             bEnableSidechain ?
                     new EngineSideChain(pConfig, m_pSidechainMix) : nullptr;
+    // Records the decks to separate channels of a stems file
+    m_pMultitrackRecord =
+            bEnableSidechain ? new EngineMultitrackRecord() : nullptr;
 
     // X-Fader Setup
     m_pXFaderMode = new ControlPushButton(
@@ -203,11 +272,27 @@ EngineMixer::EngineMixer(
     m_pHeadphoneEnabled = new ControlObject(ConfigKey(group, "headEnabled"));
     m_pHeadphoneEnabled->setReadOnly();
 
+    const int channelWorkerCount = pConfig->getValue(kChannelWorkerCountConfigKey, 0);
+    if (channelWorkerCount > 0) {
+        m_pChannelWorkerPool = std::make_unique<EngineChannelWorkerPool>(
+                channelWorkerCount,
+                pConfig->getValue(kChannelWorkerAffinityConfigKey, true),
+                &EngineMixer::processParallelJob,
+                this);
+        if (m_pEngineEffectsManager) {
+            // The workers process effects concurrently to the callback thread
+            m_pEngineEffectsManager->reserveScratchBuffersForThreads(
+                    m_pChannelWorkerPool->numWorkers() + 1);
+        }
+    }
+
     // Note: the EQ Rack is set in EffectsManager::setupDefaults();
 }
 
 EngineMixer::~EngineMixer() {
     // qDebug() << "in ~EngineMixer()";
+    // Stop the workers before any channel is deleted
+    m_pChannelWorkerPool.reset();
     delete m_pKeylockEngine;
     delete m_pCrossfader;
     delete m_pBalance;
@@ -219,10 +304,17 @@ EngineMixer::~EngineMixer() {
     delete m_pTalkoverDucking;
     delete m_pVumeter;
     delete m_pEngineSideChain;
+    delete m_pMultitrackRecord;
     delete m_pMainDelay;
     delete m_pHeadDelay;
     delete m_pBoothDelay;
     delete m_pLatencyCompensationDelay;
+    delete m_pMainLimiter;
+    delete m_pBoothLimiter;
+    delete m_pLimiterEnabled;
+    delete m_pLimiterCeiling;
+    delete m_pLimiterLatencyMs;
+    delete m_pLimiterGainReduction;
 
     delete m_pXFaderReverse;
     delete m_pXFaderCalibration;
@@ -242,6 +334,9 @@ EngineMixer::~EngineMixer() {
     delete m_pMicMonitorMode;
     delete m_pHeadphoneEnabled;
 
+    for (const auto& output : std::as_const(m_subBlockOutputs)) {
+        SampleUtil::free(output.m_pStaging);
+    }
     SampleUtil::free(m_pHead);
     SampleUtil::free(m_pMain);
     SampleUtil::free(m_pBooth);
@@ -280,6 +375,191 @@ const CSAMPLE* EngineMixer::getSidechainBuffer() const {
     return m_pSidechainMix;
 }
 
+void EngineMixer::processChannel(ChannelInfo* pChannelInfo, int iBufferSize) {
+    ScopedEngineProfile profile(pChannelInfo->m_profilerStage);
+    EngineChannel* pChannel = pChannelInfo->m_pChannel;
+    pChannel->process(pChannelInfo->m_pBuffer, iBufferSize);
+
+    // Collect metadata for effects
+    if (m_pEngineEffectsManager) {
+        GroupFeatureState features;
+        pChannel->collectFeatures(&features);
+        pChannelInfo->m_features = features;
+    }
+}
+
+// static
+void EngineMixer::processParallelJob(void* pContext, int index) {
+    auto* pEngineMixer = static_cast<EngineMixer*>(pContext);
+    switch (pEngineMixer->m_parallelJobs) {
+    case ParallelJobs::Channels:
+        pEngineMixer->processChannel(
+                pEngineMixer->m_parallelChannels[index],
+                pEngineMixer->m_parallelBufferSize);
+        break;
+    case ParallelJobs::BusChannelEffects:
+        pEngineMixer->applyEffectsInPlaceToBusChannelGroup(index);
+        break;
+    }
+}
+
+void EngineMixer::processChannelsInParallel(
+        int activeChannelsStartIndex, int iBufferSize) {
+    m_serialChannels.clear();
+    m_parallelChannels.clear();
+    for (int i = activeChannelsStartIndex; i < m_activeChannels.size(); ++i) {
+        ChannelInfo* pChannelInfo = m_activeChannels[i];
+        EngineBuffer* pEngineBuffer = pChannelInfo->m_pChannel->getEngineBuffer();
+        // The sync lock channel at index 0 must be processed first
+        const bool serial = i == 0 ||
+                (pEngineBuffer && pEngineBuffer->isSyncProcessingRequired());
+        if (pEngineBuffer) {
+            pEngineBuffer->setProcessedInParallel(!serial);
+        }
+        if (serial) {
+            m_serialChannels.append(pChannelInfo);
+        } else {
+            m_parallelChannels.append(pChannelInfo);
+        }
+    }
+
+    // Not worth waking the workers for a single channel
+    if (m_serialChannels.size() + m_parallelChannels.size() < 2) {
+        for (ChannelInfo* pChannelInfo : std::as_const(m_serialChannels)) {
+            processChannel(pChannelInfo, iBufferSize);
+        }
+        for (ChannelInfo* pChannelInfo : std::as_const(m_parallelChannels)) {
+            processChannel(pChannelInfo, iBufferSize);
+        }
+        return;
+    }
+
+    m_parallelJobs = ParallelJobs::Channels;
+    m_parallelBufferSize = iBufferSize;
+    m_pChannelWorkerPool->start(m_parallelChannels.size());
+    for (ChannelInfo* pChannelInfo : std::as_const(m_serialChannels)) {
+        processChannel(pChannelInfo, iBufferSize);
+    }
+    // Barrier: All channels must be processed before mixing
+    m_pChannelWorkerPool->finish();
+}
+
+void EngineMixer::applyEffectsInPlaceAndMixBusChannels(int iBufferSize) {
+    if (m_pChannelWorkerPool && m_pEngineEffectsManager &&
+            applyEffectsInPlaceToBusChannelsInParallel(iBufferSize)) {
+        // Mix in the original order, so that the result does not depend
+        // on the order in which the groups have been processed
+        for (int o = EngineChannel::LEFT; o <= EngineChannel::RIGHT; o++) {
+            SampleUtil::clear(m_pOutputBusBuffers[o], iBufferSize);
+            for (const ChannelInfo* pChannelInfo : std::as_const(m_activeBusChannels[o])) {
+                SampleUtil::add(m_pOutputBusBuffers[o], pChannelInfo->m_pBuffer, iBufferSize);
+            }
+        }
+        return;
+    }
+
+    for (int o = EngineChannel::LEFT; o <= EngineChannel::RIGHT; o++) {
+        ChannelMixer::applyEffectsInPlaceAndMixChannels(m_mainGain,
+                m_activeBusChannels[o],
+                &m_channelMainGainCache, // no [o] because the old gain
+                                         // follows an orientation switch
+                m_pOutputBusBuffers[o],
+                m_mainHandle.handle(),
+                iBufferSize,
+                static_cast<int>(m_sampleRate.value()),
+                m_pEngineEffectsManager);
+    }
+}
+
+void EngineMixer::processMultitrackRecord(bool postFader, int iFrames) {
+    if (!m_pMultitrackRecord || !m_pMultitrackRecord->isRecording(postFader)) {
+        return;
+    }
+    m_pMultitrackRecord->beginBlock(iFrames);
+    if (postFader) {
+        // Only the channels of the buses have the gain and the postfader
+        // effects applied, all others are muted.
+        for (int o = EngineChannel::LEFT; o <= EngineChannel::RIGHT; o++) {
+            for (const ChannelInfo* pChannelInfo : std::as_const(m_activeBusChannels[o])) {
+                if (pChannelInfo->m_deckIndex >= 0) {
+                    m_pMultitrackRecord->addTrack(
+                            pChannelInfo->m_deckIndex, pChannelInfo->m_pBuffer);
+                }
+            }
+        }
+    } else {
+        for (const ChannelInfo* pChannelInfo : std::as_const(m_activeChannels)) {
+            // The first entry is null if there is no active sync leader
+            if (pChannelInfo && pChannelInfo->m_deckIndex >= 0) {
+                m_pMultitrackRecord->addTrack(
+                        pChannelInfo->m_deckIndex, pChannelInfo->m_pBuffer);
+            }
+        }
+    }
+    m_pMultitrackRecord->endBlock();
+}
+
+bool EngineMixer::applyEffectsInPlaceToBusChannelsInParallel(int iBufferSize) {
+    m_parallelBusChannels.clear();
+    m_parallelBusChannelHandles.clear();
+    for (int o = EngineChannel::LEFT; o <= EngineChannel::RIGHT; o++) {
+        for (ChannelInfo* pChannelInfo : std::as_const(m_activeBusChannels[o])) {
+            m_parallelBusChannels.append(ParallelBusChannel{pChannelInfo,
+                    CSAMPLE_GAIN_ZERO,
+                    CSAMPLE_GAIN_ZERO,
+                    false});
+            m_parallelBusChannelHandles.append(pChannelInfo->m_handle);
+        }
+    }
+    m_parallelBusChannelGroups.resize(m_parallelBusChannels.size());
+    const int numGroups = m_pEngineEffectsManager->groupChannelsByPostFaderChains(
+            m_parallelBusChannelHandles.constData(),
+            m_parallelBusChannelHandles.size(),
+            m_mainHandle.handle(),
+            m_parallelBusChannelGroups.data());
+    // Not worth waking the workers for a single group of effects
+    if (numGroups < 2) {
+        return false;
+    }
+
+    // The gain cache is shared by all channels
+    for (ParallelBusChannel& busChannel : m_parallelBusChannels) {
+        busChannel.m_fadeout = ChannelMixer::updateGain(m_mainGain,
+                busChannel.m_pChannelInfo,
+                &m_channelMainGainCache,
+                &busChannel.m_oldGain,
+                &busChannel.m_newGain);
+    }
+
+    m_parallelJobs = ParallelJobs::BusChannelEffects;
+    m_parallelBufferSize = iBufferSize;
+    m_pChannelWorkerPool->start(numGroups);
+    // The channels without any effects only need their gain applied
+    applyEffectsInPlaceToBusChannelGroup(-1);
+    // Barrier: All channels must be processed before mixing
+    m_pChannelWorkerPool->finish();
+    return true;
+}
+
+void EngineMixer::applyEffectsInPlaceToBusChannelGroup(int group) {
+    for (int i = 0; i < m_parallelBusChannels.size(); ++i) {
+        if (m_parallelBusChannelGroups[i] != group) {
+            continue;
+        }
+        const ParallelBusChannel& busChannel = m_parallelBusChannels[i];
+        ChannelInfo* pChannelInfo = busChannel.m_pChannelInfo;
+        m_pEngineEffectsManager->processPostFaderInPlace(pChannelInfo->m_handle,
+                m_mainHandle.handle(),
+                pChannelInfo->m_pBuffer,
+                m_parallelBufferSize,
+                static_cast<int>(m_sampleRate.value()),
+                pChannelInfo->m_features,
+                busChannel.m_oldGain,
+                busChannel.m_newGain,
+                busChannel.m_fadeout);
+    }
+}
+
 void EngineMixer::processChannels(int iBufferSize) {
     // Update internal sync lock rate.
     m_pEngineSync->onCallbackStart(m_sampleRate, iBufferSize);
@@ -369,17 +649,13 @@ void EngineMixer::processChannels(int iBufferSize) {
     }
 
     // Now that the list is built and ordered, do the processing.
-    for (int i = activeChannelsStartIndex;
-             i < m_activeChannels.size(); ++i) {
-        ChannelInfo* pChannelInfo = m_activeChannels[i];
-        EngineChannel* pChannel = pChannelInfo->m_pChannel;
-        pChannel->process(pChannelInfo->m_pBuffer, iBufferSize);
-
-        // Collect metadata for effects
-        if (m_pEngineEffectsManager) {
-            GroupFeatureState features;
-            pChannel->collectFeatures(&features);
-            pChannelInfo->m_features = features;
+    if (m_pChannelWorkerPool) {
+        processChannelsInParallel(activeChannelsStartIndex, iBufferSize);
+    } else {
+        for (int i = activeChannelsStartIndex;
+                i < m_activeChannels.size();
+                ++i) {
+            processChannel(m_activeChannels[i], iBufferSize);
         }
     }
 
@@ -415,12 +691,82 @@ void EngineMixer::process(const int iBufferSize) {
         haveSetName = true;
     }
     // Trace t("EngineMixer::process");
+    mixxx::RealtimeAllocationTracker::RealtimeSection realtimeSection;
+    EngineProfiler::instance().beginCallback();
+
+    m_sampleRate = mixxx::audio::SampleRate::fromDouble(m_pSampleRate->get());
+    // TODO: remove assumption of stereo buffer
+    constexpr unsigned int kChannels = 2;
+    const unsigned int iFrames = iBufferSize / kChannels;
+
+    const int subBlockSize = m_subBlockFrames * kChannels;
+    if (subBlockSize > 0 && iBufferSize > subBlockSize) {
+        processSubBlocks(iBufferSize, subBlockSize);
+    } else {
+        processBlock(iBufferSize);
+    }
+
+    // We're close to the end of the callback. Wake up the engine worker
+    // scheduler so that it runs the workers.
+    m_pWorkerScheduler->runWorkers();
+
+    const qint64 callbackBudgetNanos = m_sampleRate.isValid()
+            ? static_cast<qint64>(iFrames * 1e9 / m_sampleRate.value())
+            : 0;
+    EngineProfiler::instance().endCallback(callbackBudgetNanos);
+}
+
+void EngineMixer::processSubBlocks(int iBufferSize, int subBlockSize) {
+    // An external record/broadcast input has already been copied to
+    // m_pSidechainMix. Keep it aside so every sub-block gets its part.
+    const bool sidechainInput = m_pEngineSideChain && m_bExternalRecordBroadcastInputConnected;
+    if (sidechainInput) {
+        SampleUtil::copy(m_pSidechainStaging, m_pSidechainMix, iBufferSize);
+    }
+
+    for (int offset = 0; offset < iBufferSize; offset += subBlockSize) {
+        const int blockSize = std::min(subBlockSize, iBufferSize - offset);
+        if (sidechainInput) {
+            SampleUtil::copy(m_pSidechainMix, m_pSidechainStaging + offset, blockSize);
+        }
+        if (m_sampleRate.isValid()) {
+            VisualPlayPosition::setSubBlockOffsetSecs(
+                    offset / mixxx::kEngineChannelCount / m_sampleRate.toDouble());
+        }
+
+        processBlock(blockSize);
+
+        // The sub-block has been processed at the start of the mixing
+        // buffers. Collect it at its place in the callback buffer.
+        for (const auto& output : std::as_const(m_subBlockOutputs)) {
+            SampleUtil::copy(output.m_pStaging + offset, output.m_pBuffer, blockSize);
+        }
+    }
+    VisualPlayPosition::setSubBlockOffsetSecs(0);
+
+    // Publish the whole callback buffer to the sound devices
+    for (const auto& output : std::as_const(m_subBlockOutputs)) {
+        SampleUtil::copy(output.m_pBuffer, output.m_pStaging, iBufferSize);
+    }
+}
 
+CSAMPLE* EngineMixer::addSubBlockOutput(CSAMPLE* pBuffer) {
+    CSAMPLE* pStaging = SampleUtil::alloc(MAX_BUFFER_LEN);
+    SampleUtil::clear(pStaging, MAX_BUFFER_LEN);
+    m_subBlockOutputs.append(SubBlockOutput{pBuffer, pStaging});
+    return pStaging;
+}
+
+void EngineMixer::processBlock(const int iBufferSize) {
     bool mainEnabled = m_pMainEnabled->toBool();
     bool boothEnabled = m_pBoothEnabled->toBool();
     bool headphoneEnabled = m_pHeadphoneEnabled->toBool();
+    // The buses without a consumer are not mixed at all. Talkover is only
+    // audible if a microphone is configured.
+    const bool talkoverRequired = m_numMicsConfigured > 0;
+    const bool sidechainActive = m_pEngineSideChain && m_pEngineSideChain->isActive();
+    const bool sidechainMixRequired = isSidechainMixRequired(sidechainActive);
 
-    m_sampleRate = mixxx::audio::SampleRate::fromDouble(m_pSampleRate->get());
     // TODO: remove assumption of stereo buffer
     constexpr unsigned int kChannels = 2;
     const unsigned int iFrames = iBufferSize / kChannels;
@@ -431,6 +777,7 @@ void EngineMixer::process(const int iBufferSize) {
 
     // Prepare all channels for output
     processChannels(iBufferSize);
+    processMultitrackRecord(false, iFrames);
 
     // Compute headphone mix
     // Head phone left/right mix
@@ -448,6 +795,7 @@ void EngineMixer::process(const int iBufferSize) {
     m_headphoneGain.setGain(pflMixGainInHeadphones);
 
     if (headphoneEnabled) {
+        ScopedEngineProfile profile(m_headphoneMixStage);
         // Process effects and mix PFL channels together for the headphones.
         // Effects will be reprocessed post-fader for the crossfader buses
         // and main mix, so the channel input buffers cannot be modified here.
@@ -483,32 +831,34 @@ void EngineMixer::process(const int iBufferSize) {
         }
     }
 
-    // Mix all the talkover enabled channels together.
-    // Effects processing is done in place to avoid unnecessary buffer copying.
-    ChannelMixer::applyEffectsInPlaceAndMixChannels(
-            m_talkoverGain,
-            m_activeTalkoverChannels,
-            &m_channelTalkoverGainCache,
-            m_pTalkover,
-            m_mainHandle.handle(),
-            iBufferSize,
-            static_cast<int>(m_sampleRate.value()),
-            m_pEngineEffectsManager);
-
-    // Process effects on all microphones mixed together
     // We have no metadata for mixed effect buses, so use an empty GroupFeatureState.
     GroupFeatureState busFeatures;
-    if (m_pEngineEffectsManager) {
-        m_pEngineEffectsManager->processPostFaderInPlace(
-                m_busTalkoverHandle.handle(),
-                m_mainHandle.handle(),
+    if (talkoverRequired) {
+        // Mix all the talkover enabled channels together.
+        // Effects processing is done in place to avoid unnecessary buffer copying.
+        ChannelMixer::applyEffectsInPlaceAndMixChannels(
+                m_talkoverGain,
+                m_activeTalkoverChannels,
+                &m_channelTalkoverGainCache,
                 m_pTalkover,
+                m_mainHandle.handle(),
                 iBufferSize,
                 static_cast<int>(m_sampleRate.value()),
-                busFeatures,
-                CSAMPLE_GAIN_ONE,
-                CSAMPLE_GAIN_ONE,
-                false);
+                m_pEngineEffectsManager);
+
+        // Process effects on all microphones mixed together
+        if (m_pEngineEffectsManager) {
+            m_pEngineEffectsManager->processPostFaderInPlace(
+                    m_busTalkoverHandle.handle(),
+                    m_mainHandle.handle(),
+                    m_pTalkover,
+                    iBufferSize,
+                    static_cast<int>(m_sampleRate.value()),
+                    busFeatures,
+                    CSAMPLE_GAIN_ONE,
+                    CSAMPLE_GAIN_ONE,
+                    false);
+        }
     }
 
     switch (m_pTalkoverDucking->getMode()) {
@@ -516,7 +866,11 @@ void EngineMixer::process(const int iBufferSize) {
         m_pTalkoverDucking->setAboveThreshold(false);
         break;
     case EngineTalkoverDucking::AUTO:
-        m_pTalkoverDucking->processKey(m_pTalkover, iBufferSize);
+        if (talkoverRequired) {
+            m_pTalkoverDucking->processKey(m_pTalkover, iBufferSize);
+        } else {
+            m_pTalkoverDucking->setAboveThreshold(false);
+        }
         break;
     case EngineTalkoverDucking::MANUAL:
         m_pTalkoverDucking->setAboveThreshold(!m_activeTalkoverChannels.isEmpty());
@@ -544,17 +898,8 @@ void EngineMixer::process(const int iBufferSize) {
             crossfaderRightGain,
             m_pTalkoverDucking->getGain(iFrames));
 
-    for (int o = EngineChannel::LEFT; o <= EngineChannel::RIGHT; o++) {
-        ChannelMixer::applyEffectsInPlaceAndMixChannels(m_mainGain,
-                m_activeBusChannels[o],
-                &m_channelMainGainCache, // no [o] because the old gain
-                                         // follows an orientation switch
-                m_pOutputBusBuffers[o],
-                m_mainHandle.handle(),
-                iBufferSize,
-                static_cast<int>(m_sampleRate.value()),
-                m_pEngineEffectsManager);
-    }
+    applyEffectsInPlaceAndMixBusChannels(iBufferSize);
+    processMultitrackRecord(true, iFrames);
 
     // Process crossfader orientation bus channel effects
     if (m_pEngineEffectsManager) {
@@ -591,6 +936,7 @@ void EngineMixer::process(const int iBufferSize) {
     }
 
     if (mainEnabled) {
+        ScopedEngineProfile profile(m_mainMixStage);
         // Mix the crossfader orientation buffers together into the main mix
         SampleUtil::copy3WithGain(m_pMain,
                 m_pOutputBusBuffers[EngineChannel::LEFT],
@@ -643,7 +989,7 @@ void EngineMixer::process(const int iBufferSize) {
             m_mainGainOld = mainGain;
 
             // Record/broadcast signal is the same as the main output
-            if (sidechainMixRequired()) {
+            if (sidechainMixRequired) {
                 SampleUtil::copy(m_pSidechainMix, m_pMain, iBufferSize);
             }
         } else if (configuredMicMonitorMode == MicMonitorMode::MainAndBooth) {
@@ -686,7 +1032,7 @@ void EngineMixer::process(const int iBufferSize) {
             m_mainGainOld = mainGain;
 
             // Record/broadcast signal is the same as the main output
-            if (sidechainMixRequired()) {
+            if (sidechainMixRequired) {
                 SampleUtil::copy(m_pSidechainMix, m_pMain, iBufferSize);
             }
         } else if (configuredMicMonitorMode == MicMonitorMode::DirectMonitor) {
@@ -725,7 +1071,7 @@ void EngineMixer::process(const int iBufferSize) {
                     mainGain,
                     iBufferSize);
             m_mainGainOld = mainGain;
-            if (sidechainMixRequired()) {
+            if (sidechainMixRequired) {
                 SampleUtil::copy(m_pSidechainMix, m_pMain, iBufferSize);
 
                 if (m_numMicsConfigured > 0) {
@@ -760,7 +1106,8 @@ void EngineMixer::process(const int iBufferSize) {
         // Note: In case the broadcast/recording input is configured,
         // EngineSideChain::receiveBuffer has copied the input buffer to m_pSidechainMix
         // via before (called by SoundManager::pushInputBuffers())
-        if (m_pEngineSideChain) {
+        if (sidechainActive) {
+            ScopedEngineProfile profile(m_sidechainStage);
             m_pEngineSideChain->writeSamples(m_pSidechainMix, iFrames);
         }
 
@@ -811,6 +1158,8 @@ void EngineMixer::process(const int iBufferSize) {
         SampleUtil::mixStereoToMono(m_pMain, iBufferSize);
     }
 
+    processLimiters(mainEnabled, boothEnabled, iBufferSize);
+
     if (mainEnabled) {
         m_pMainDelay->process(m_pMain, iBufferSize);
     } else {
@@ -822,10 +1171,6 @@ void EngineMixer::process(const int iBufferSize) {
     if (boothEnabled) {
         m_pBoothDelay->process(m_pBooth, iBufferSize);
     }
-
-    // We're close to the end of the callback. Wake up the engine worker
-    // scheduler so that it runs the workers.
-    m_pWorkerScheduler->runWorkers();
 }
 
 void EngineMixer::applyMainEffects(int bufferSize) {
@@ -846,9 +1191,54 @@ void EngineMixer::applyMainEffects(int bufferSize) {
     }
 }
 
+void EngineMixer::processLimiters(bool mainEnabled, bool boothEnabled, int iBufferSize) {
+    const bool limiterEnabled = m_pLimiterEnabled->toBool() && m_sampleRate.isValid();
+    if (limiterEnabled && !m_limiterActive) {
+        // Don't output stale samples from the last time the limiter was enabled
+        m_pMainLimiter->reset();
+        m_pBoothLimiter->reset();
+    }
+    m_limiterActive = limiterEnabled;
+
+    // The main output is delayed by the limiter, so it has to be added to the
+    // compensation of the microphones in the record/broadcast mix.
+    int latencyFrames = 0;
+    if (limiterEnabled) {
+        m_pMainLimiter->setSampleRate(m_sampleRate);
+        m_pBoothLimiter->setSampleRate(m_sampleRate);
+        latencyFrames = static_cast<int>(m_pMainLimiter->latencyFrames());
+    }
+    m_pLatencyCompensationDelay->setAdditionalDelayFrames(latencyFrames);
+    const double latencyMs = limiterEnabled
+            ? latencyFrames * 1000.0 / m_sampleRate.toDouble()
+            : 0.0;
+    if (m_pLimiterLatencyMs->get() != latencyMs) {
+        m_pLimiterLatencyMs->forceSet(latencyMs);
+    }
+    if (!limiterEnabled) {
+        m_pLimiterGainReduction->forceSet(CSAMPLE_GAIN_ONE);
+        return;
+    }
+
+    const auto ceiling = static_cast<CSAMPLE_GAIN>(db2ratio(m_pLimiterCeiling->get()));
+    CSAMPLE_GAIN gainReduction = CSAMPLE_GAIN_ONE;
+    if (mainEnabled) {
+        m_pMainLimiter->setCeiling(ceiling);
+        m_pMainLimiter->process(m_pMain, iBufferSize);
+        gainReduction = m_pMainLimiter->gainReduction();
+    }
+    if (boothEnabled) {
+        m_pBoothLimiter->setCeiling(ceiling);
+        m_pBoothLimiter->process(m_pBooth, iBufferSize);
+        gainReduction = math_min(gainReduction, m_pBoothLimiter->gainReduction());
+    }
+    m_pLimiterGainReduction->forceSet(gainReduction);
+}
+
 void EngineMixer::processHeadphones(
         const CSAMPLE_GAIN mainMixGainInHeadphones,
         int iBufferSize) {
+    ScopedEngineProfile profile(m_headphoneMixStage);
     // Add main mix to headphones
     SampleUtil::addWithRampingGain(
             m_pHead,
@@ -886,6 +1276,12 @@ void EngineMixer::addChannel(EngineChannel* pChannel) {
     pChannelInfo->m_pChannel = pChannel;
     const QString& group = pChannel->getGroup();
     pChannelInfo->m_handle = m_pChannelHandleFactory->getOrCreateHandle(group);
+    pChannelInfo->m_groupUtf8 = group.toUtf8();
+    int deckNumber;
+    if (PlayerManager::isDeckGroup(group, &deckNumber)) {
+        pChannelInfo->m_deckIndex = deckNumber - 1;
+    }
+    pChannelInfo->m_profilerStage = EngineProfiler::instance().registerStage(group);
     pChannelInfo->m_pVolumeControl = new ControlAudioTaperPot(
             ConfigKey(group, "volume"), -20, 0, 1);
     pChannelInfo->m_pVolumeControl->setDefaultValue(1.0);
@@ -895,6 +1291,10 @@ void EngineMixer::addChannel(EngineChannel* pChannel) {
     pChannelInfo->m_pMuteControl->setButtonMode(ControlPushButton::POWERWINDOW);
     pChannelInfo->m_pBuffer = SampleUtil::alloc(MAX_BUFFER_LEN);
     SampleUtil::clear(pChannelInfo->m_pBuffer, MAX_BUFFER_LEN);
+    if (m_subBlockFrames > 0 && pChannelInfo->m_deckIndex >= 0) {
+        // Published as deck output
+        addSubBlockOutput(pChannelInfo->m_pBuffer);
+    }
     m_channels.append(pChannelInfo);
     constexpr GainCache gainCacheDefault = {0, false};
     m_channelHeadphoneGainCache.append(gainCacheDefault);
@@ -934,6 +1334,29 @@ CSAMPLE_GAIN EngineMixer::getMainGain(int channelIndex) const {
     return CSAMPLE_GAIN_ZERO;
 }
 
+void EngineMixer::collectXrunState(XrunSnapshot* pSnapshot) const {
+    for (const ChannelInfo* pChannelInfo : m_channels) {
+        if (pSnapshot->deckCount >= XrunSnapshot::kMaxDecks) {
+            break;
+        }
+        EngineChannel* pChannel = pChannelInfo->m_pChannel;
+        const EngineBuffer* pEngineBuffer = pChannel->getEngineBuffer();
+        if (!pEngineBuffer || !pChannel->isActive()) {
+            continue;
+        }
+        XrunSnapshot::Deck& deck = pSnapshot->decks[pSnapshot->deckCount++];
+        XrunSnapshot::copyName(deck.group, pChannelInfo->m_groupUtf8.constData());
+        XrunSnapshot::copyName(deck.scaler, pEngineBuffer->currentScalerName());
+        deck.playing = pEngineBuffer->isPlaying();
+        deck.cacheMissCount = static_cast<qint32>(pEngineBuffer->cacheMissCount());
+    }
+    if (m_pEngineEffectsManager) {
+        pSnapshot->enabledEffectChainCount =
+                m_pEngineEffectsManager->enabledEffectChainCount();
+    }
+    pSnapshot->busyAnalyzerCount = AnalyzerThread::busyThreadCount();
+}
+
 const CSAMPLE* EngineMixer::getDeckBuffer(unsigned int i) const {
     return getChannelBuffer(PlayerManager::groupForDeck(i));
 }
@@ -1001,7 +1424,8 @@ void EngineMixer::onOutputConnected(const AudioOutput& output) {
         // We don't track enabled decks.
         break;
     case AudioPathType::RecordBroadcast:
-        // We don't track enabled sidechain.
+        // The network device reads the sidechain mix directly
+        m_bRecordBroadcastOutputConnected = true;
         break;
     default:
         break;
@@ -1027,7 +1451,7 @@ void EngineMixer::onOutputDisconnected(const AudioOutput& output) {
         // We don't track enabled decks.
         break;
     case AudioPathType::RecordBroadcast:
-        // We don't track enabled sidechain.
+        m_bRecordBroadcastOutputConnected = false;
         break;
     default:
         break;
@@ -1085,6 +1509,7 @@ void EngineMixer::registerNonEngineChannelSoundIO(SoundManager* pSoundManager) {
     pSoundManager->registerOutput(AudioOutput(AudioPathType::RecordBroadcast, 0, 2), this);
 }
 
-bool EngineMixer::sidechainMixRequired() const {
-    return m_pEngineSideChain && !m_bExternalRecordBroadcastInputConnected;
+bool EngineMixer::isSidechainMixRequired(bool sidechainActive) const {
+    return m_pEngineSideChain && !m_bExternalRecordBroadcastInputConnected &&
+            (sidechainActive || m_bRecordBroadcastOutputConnected);
 }
@@ -3,6 +3,7 @@
 #include <QObject>
 #include <QVarLengthArray>
 #include <atomic>
+#include <memory>
 
 #include "audio/types.h"
 #include "control/controlobject.h"
@@ -11,6 +12,7 @@
 #include "engine/channels/enginechannel.h"
 #include "engine/effects/groupfeaturestate.h"
 #include "engine/engineobject.h"
+#include "engine/engineprofiler.h"
 #include "preferences/usersettings.h"
 #include "recording/recordingmanager.h"
 #include "soundio/soundmanager.h"
@@ -21,11 +23,15 @@ class EngineVuMeter;
 class ControlPotmeter;
 class ControlPushButton;
 class EngineSideChain;
+class EngineMultitrackRecord;
 class EffectsManager;
 class EngineEffectsManager;
 class EngineSync;
 class EngineTalkoverDucking;
 class EngineDelay;
+class EngineLimiter;
+class EngineChannelWorkerPool;
+struct XrunSnapshot;
 
 // The number of channels to pre-allocate in various structures in the
 // engine. Prevents memory allocation in EngineMixer::addChannel.
@@ -102,23 +108,39 @@ class EngineMixer : public QObject, public AudioSource {
         return m_pEngineSideChain;
     }
 
+    EngineMultitrackRecord* getMultitrackRecord() const {
+        return m_pMultitrackRecord;
+    }
+
     CSAMPLE_GAIN getMainGain(int channelIndex) const;
 
+    // Adds the state of the active decks, the effects and the analyzers to
+    // the snapshot of an xrun. Only called by SoundManager from the
+    // callback thread.
+    void collectXrunState(XrunSnapshot* pSnapshot) const;
+
     struct ChannelInfo {
         ChannelInfo(int index)
                 : m_pChannel(NULL),
                   m_pBuffer(NULL),
                   m_pVolumeControl(NULL),
                   m_pMuteControl(NULL),
-                  m_index(index) {
+                  m_index(index),
+                  m_deckIndex(-1),
+                  m_profilerStage(EngineProfiler::kCallbackStage) {
         }
         ChannelHandle m_handle;
+        // The group for real-time safe access from the callback thread
+        QByteArray m_groupUtf8;
         EngineChannel* m_pChannel;
         CSAMPLE* m_pBuffer;
         ControlObject* m_pVolumeControl;
         ControlPushButton* m_pMuteControl;
         GroupFeatureState m_features;
         int m_index;
+        // Zero based deck number, -1 for other channels
+        int m_deckIndex;
+        EngineProfiler::StageId m_profilerStage;
     };
 
     struct GainCache {
@@ -251,19 +273,53 @@ class EngineMixer : public QObject, public AudioSource {
     ControlObject* m_pBoothEnabled;
 
   private:
+    // Processes one block of the callback, the whole buffer or a sub-block.
+    void processBlock(const int iBufferSize);
+    // Processes the callback buffer in sub-blocks of subBlockSize samples,
+    // so controls are applied at a finer resolution than the device buffer.
+    void processSubBlocks(int iBufferSize, int subBlockSize);
+    // Adds a mixing buffer that is published to the sound devices and
+    // allocates its staging buffer for processSubBlocks().
+    CSAMPLE* addSubBlockOutput(CSAMPLE* pBuffer);
+
     // Processes active channels. The sync lock channel (if any) is processed
     // first and all others are processed after. Populates m_activeChannels,
     // m_activeBusChannels, m_activeHeadphoneChannels, and
     // m_activeTalkoverChannels with each channel that is active for the
     // respective output.
     void processChannels(int iBufferSize);
+    // Processes a single channel and collects its features for effects.
+    void processChannel(ChannelInfo* pChannelInfo, int iBufferSize);
+    // Spreads the active channels across the worker pool. The sync lock
+    // channel and all other channels that interact with EngineSync are
+    // processed on the callback thread in the original order, because
+    // EngineSync is not thread-safe.
+    void processChannelsInParallel(int activeChannelsStartIndex, int iBufferSize);
+    // Applies the gain and the postfader effects to the channels of the
+    // crossfader buses in place and mixes them into m_pOutputBusBuffers.
+    void applyEffectsInPlaceAndMixBusChannels(int iBufferSize);
+    // Passes the deck buffers to m_pMultitrackRecord if it records at this
+    // point of the signal chain.
+    void processMultitrackRecord(bool postFader, int iFrames);
+    // Spreads the channels of the crossfader buses across the worker pool,
+    // grouped such that channels with a shared EngineEffectChain are
+    // processed in series on the same thread. Returns false without
+    // processing any channel if there are not at least two groups.
+    bool applyEffectsInPlaceToBusChannelsInParallel(int iBufferSize);
+    // Processes the channels of m_parallelBusChannels in the given group
+    void applyEffectsInPlaceToBusChannelGroup(int group);
+    static void processParallelJob(void* pContext, int index);
 
     ChannelHandleFactoryPointer m_pChannelHandleFactory;
     void applyMainEffects(int bufferSize);
+    // Limits the main and booth outputs if enabled
+    void processLimiters(bool mainEnabled, bool boothEnabled, int iBufferSize);
     void processHeadphones(
             const CSAMPLE_GAIN mainMixGainInHeadphones,
             int iBufferSize);
-    bool sidechainMixRequired() const;
+    // The record/broadcast mix is required by an active sidechain worker or
+    // the network output, unless it is received from an external input.
+    bool isSidechainMixRequired(bool sidechainActive) const;
 
     EngineEffectsManager* m_pEngineEffectsManager;
 
@@ -282,6 +338,34 @@ class EngineMixer : public QObject, public AudioSource {
     QVarLengthArray<ChannelInfo*, kPreallocatedChannels> m_activeHeadphoneChannels;
     QVarLengthArray<ChannelInfo*, kPreallocatedChannels> m_activeTalkoverChannels;
 
+    // Opt-in parallel processing of the channels, nullptr if disabled.
+    std::unique_ptr<EngineChannelWorkerPool> m_pChannelWorkerPool;
+    QVarLengthArray<ChannelInfo*, kPreallocatedChannels> m_serialChannels;
+    QVarLengthArray<ChannelInfo*, kPreallocatedChannels> m_parallelChannels;
+    int m_parallelBufferSize;
+    // The channels of the crossfader buses with their gains for this
+    // callback and the group of their postfader effects
+    struct ParallelBusChannel {
+        ChannelInfo* m_pChannelInfo;
+        CSAMPLE_GAIN m_oldGain;
+        CSAMPLE_GAIN m_newGain;
+        bool m_fadeout;
+    };
+    QVarLengthArray<ParallelBusChannel, kPreallocatedChannels> m_parallelBusChannels;
+    QVarLengthArray<ChannelHandle, kPreallocatedChannels> m_parallelBusChannelHandles;
+    QVarLengthArray<int, kPreallocatedChannels> m_parallelBusChannelGroups;
+    // The kind of the jobs of the current batch of the worker pool
+    enum class ParallelJobs {
+        Channels,
+        BusChannelEffects,
+    };
+    ParallelJobs m_parallelJobs;
+
+    // Stages of the EngineProfiler
+    const EngineProfiler::StageId m_headphoneMixStage;
+    const EngineProfiler::StageId m_mainMixStage;
+    const EngineProfiler::StageId m_sidechainStage;
+
     mixxx::audio::SampleRate m_sampleRate;
 
     // Mixing buffers for each output.
@@ -292,6 +376,17 @@ class EngineMixer : public QObject, public AudioSource {
     CSAMPLE* m_pTalkoverHeadphones;
     CSAMPLE* m_pSidechainMix;
 
+    // Frames per engine sub-block, 0 processes the device buffer at once
+    int m_subBlockFrames;
+    // The published mixing buffers and where the sub-blocks of a callback
+    // are collected
+    struct SubBlockOutput {
+        CSAMPLE* m_pBuffer;
+        CSAMPLE* m_pStaging;
+    };
+    QVarLengthArray<SubBlockOutput, kPreallocatedChannels> m_subBlockOutputs;
+    CSAMPLE* m_pSidechainStaging;
+
     EngineWorkerScheduler* m_pWorkerScheduler;
     EngineSync* m_pEngineSync;
 
@@ -309,8 +404,17 @@ class EngineMixer : public QObject, public AudioSource {
     EngineDelay* m_pBoothDelay;
     EngineDelay* m_pLatencyCompensationDelay;
 
+    EngineLimiter* m_pMainLimiter;
+    EngineLimiter* m_pBoothLimiter;
+    ControlPushButton* m_pLimiterEnabled;
+    ControlPotmeter* m_pLimiterCeiling;
+    ControlObject* m_pLimiterLatencyMs;
+    ControlObject* m_pLimiterGainReduction;
+    bool m_limiterActive;
+
     EngineVuMeter* m_pVumeter;
     EngineSideChain* m_pEngineSideChain;
+    EngineMultitrackRecord* m_pMultitrackRecord;
 
     ControlPotmeter* m_pCrossfader;
     ControlPotmeter* m_pHeadMix;
@@ -346,4 +450,5 @@ class EngineMixer : public QObject, public AudioSource {
 
     volatile bool m_bBusOutputConnected[3];
     bool m_bExternalRecordBroadcastInputConnected;
+    bool m_bRecordBroadcastOutputConnected;
 };
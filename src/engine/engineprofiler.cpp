@@ -0,0 +1,171 @@
+#include "engine/engineprofiler.h"
+
+#include <limits>
+
+#include "util/assert.h"
+#include "util/compatibility/qmutex.h"
+#include "util/math.h"
+#include "util/time.h"
+
+namespace {
+
+static_assert((EngineProfiler::kRingSize & (EngineProfiler::kRingSize - 1)) == 0,
+        "The ring size must be a power of 2");
+constexpr quint64 kRingMask = EngineProfiler::kRingSize - 1;
+
+constexpr int kMaxThreadIndex = 255;
+constexpr int kMaxDepth = 255;
+
+std::atomic<int> s_nextThreadIndex(0);
+
+} // anonymous namespace
+
+EngineProfiler::EngineProfiler()
+        : m_enabled(false),
+          m_slots(std::make_unique<Slot[]>(kRingSize)),
+          m_writePosition(0),
+          m_readPosition(0),
+          m_droppedCount(0),
+          m_callback(0),
+          m_callbackStartNanos(0) {
+    for (int i = 0; i < kRingSize; ++i) {
+        m_slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    const StageId callbackStage = registerStage(QStringLiteral("Callback"));
+    DEBUG_ASSERT(callbackStage == kCallbackStage);
+    Q_UNUSED(callbackStage);
+}
+
+// static
+EngineProfiler& EngineProfiler::instance() {
+    static EngineProfiler s_instance;
+    return s_instance;
+}
+
+EngineProfiler::StageId EngineProfiler::registerStage(const QString& name) {
+    const auto locker = lockMutex(&m_stagesMutex);
+    const auto it = m_stageIds.constFind(name);
+    if (it != m_stageIds.constEnd()) {
+        return it.value();
+    }
+    VERIFY_OR_DEBUG_ASSERT(m_stageNames.size() <= std::numeric_limits<StageId>::max()) {
+        return kCallbackStage;
+    }
+    const auto stage = static_cast<StageId>(m_stageNames.size());
+    m_stageNames.append(name);
+    m_stageIds.insert(name, stage);
+    return stage;
+}
+
+QString EngineProfiler::stageName(StageId stage) const {
+    const auto locker = lockMutex(&m_stagesMutex);
+    return m_stageNames.value(stage);
+}
+
+void EngineProfiler::beginCallback() {
+    // Always keep track of the callbacks and the nesting, the profiler
+    // might be enabled in the middle of the callback.
+    m_callback.fetch_add(1, std::memory_order_relaxed);
+    m_callbackStartNanos = nowNanos();
+    ++currentDepth();
+}
+
+void EngineProfiler::endCallback(qint64 budgetNanos) {
+    --currentDepth();
+    if (!isEnabled()) {
+        return;
+    }
+    record(kCallbackStage,
+            m_callbackStartNanos,
+            nowNanos() - m_callbackStartNanos,
+            currentDepth(),
+            budgetNanos);
+}
+
+void EngineProfiler::record(StageId stage,
+        qint64 startNanos,
+        qint64 durationNanos,
+        int depth,
+        qint64 budgetNanos) {
+    quint64 position = m_writePosition.load(std::memory_order_relaxed);
+    Slot* pSlot;
+    while (true) {
+        pSlot = &m_slots[position & kRingMask];
+        const quint64 sequence = pSlot->sequence.load(std::memory_order_acquire);
+        const auto difference = static_cast<qint64>(sequence - position);
+        if (difference == 0) {
+            // The slot is free, try to claim it
+            if (m_writePosition.compare_exchange_weak(
+                        position, position + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (difference < 0) {
+            // The ring is full
+            m_droppedCount.fetch_add(1, std::memory_order_relaxed);
+            return;
+        } else {
+            // Another writer has claimed the slot
+            position = m_writePosition.load(std::memory_order_relaxed);
+        }
+    }
+    Record& record = pSlot->record;
+    record.callback = m_callback.load(std::memory_order_relaxed);
+    record.startNanos = startNanos;
+    record.durationNanos = durationNanos;
+    record.budgetNanos = budgetNanos;
+    record.stage = stage;
+    record.depth = static_cast<quint8>(math_clamp(depth, 0, kMaxDepth));
+    record.thread = static_cast<quint8>(currentThreadIndex());
+    pSlot->sequence.store(position + 1, std::memory_order_release);
+}
+
+int EngineProfiler::read(Record* pRecords, int maxCount) {
+    int count = 0;
+    while (count < maxCount) {
+        Slot& slot = m_slots[m_readPosition & kRingMask];
+        const quint64 sequence = slot.sequence.load(std::memory_order_acquire);
+        if (static_cast<qint64>(sequence - (m_readPosition + 1)) < 0) {
+            // The ring is empty or the next record is still being written
+            break;
+        }
+        pRecords[count++] = slot.record;
+        slot.sequence.store(m_readPosition + kRingSize, std::memory_order_release);
+        ++m_readPosition;
+    }
+    return count;
+}
+
+// static
+qint64 EngineProfiler::nowNanos() {
+    return mixxx::Time::elapsed().toIntegerNanos();
+}
+
+// static
+int EngineProfiler::currentThreadIndex() {
+    thread_local int t_threadIndex = -1;
+    if (t_threadIndex < 0) {
+        t_threadIndex = math_min(
+                s_nextThreadIndex.fetch_add(1, std::memory_order_relaxed),
+                kMaxThreadIndex);
+    }
+    return t_threadIndex;
+}
+
+// static
+int& EngineProfiler::currentDepth() {
+    thread_local int t_depth = 0;
+    return t_depth;
+}
+
+void ScopedEngineProfile::start() {
+    m_depth = EngineProfiler::currentDepth()++;
+    m_startNanos = EngineProfiler::nowNanos();
+}
+
+void ScopedEngineProfile::stop() {
+    --EngineProfiler::currentDepth();
+    m_pProfiler->record(m_stage,
+            m_startNanos,
+            EngineProfiler::nowNanos() - m_startNanos,
+            m_depth);
+}
@@ -0,0 +1,142 @@
+#pragma once
+
+#include <QHash>
+#include <QMutex>
+#include <QString>
+#include <QVector>
+#include <atomic>
+#include <memory>
+
+// Records the durations of the processing stages of each audio callback,
+// e.g. the channels, the effect chains and the mixes, for the live engine
+// timeline in the developer tools. In contrast to the aggregated stats of
+// the StatsManager this allows to find out which stage has caused a
+// particular overload of the callback.
+//
+// Recording is real-time safe: The stages are registered up front and the
+// records are written into a bounded lock-free ring that supports multiple
+// concurrent writers, e.g. the threads of the EngineChannelWorkerPool.
+// Records are dropped if the reader does not keep up. While the profiler is
+// disabled, a ScopedEngineProfile costs a single atomic load.
+class EngineProfiler final {
+  public:
+    typedef quint16 StageId;
+
+    // The stage that covers the whole callback
+    static constexpr StageId kCallbackStage = 0;
+    // The ring capacity in records, must be a power of 2
+    static constexpr int kRingSize = 16384;
+
+    struct Record {
+        // The sequence number of the callback
+        quint64 callback;
+        // Relative to the start of Mixxx, see mixxx::Time
+        qint64 startNanos;
+        qint64 durationNanos;
+        // The duration of the audio buffer, only set for kCallbackStage
+        qint64 budgetNanos;
+        StageId stage;
+        // The nesting level of the stage on its thread
+        quint8 depth;
+        // The index of the recording thread, in the order of first use
+        quint8 thread;
+    };
+
+    EngineProfiler();
+
+    static EngineProfiler& instance();
+
+    // Not real-time safe! Registering a name again returns the same id.
+    StageId registerStage(const QString& name);
+    QString stageName(StageId stage) const;
+
+    void setEnabled(bool enabled) {
+        m_enabled.store(enabled, std::memory_order_relaxed);
+    }
+    bool isEnabled() const {
+        return m_enabled.load(std::memory_order_relaxed);
+    }
+
+    // Called by the callback thread at the start and the end of each
+    // callback.
+    void beginCallback();
+    void endCallback(qint64 budgetNanos);
+
+    // Real-time safe, may be called concurrently from multiple threads.
+    void record(StageId stage,
+            qint64 startNanos,
+            qint64 durationNanos,
+            int depth,
+            qint64 budgetNanos = 0);
+
+    // Reads up to maxCount of the oldest records and returns the number
+    // of records that have been read. Must only be called from a single
+    // thread at a time.
+    int read(Record* pRecords, int maxCount);
+
+    // The number of records that have been dropped because the ring was full
+    quint64 droppedCount() const {
+        return m_droppedCount.load(std::memory_order_relaxed);
+    }
+
+  private:
+    friend class ScopedEngineProfile;
+
+    struct Slot {
+        std::atomic<quint64> sequence;
+        Record record;
+    };
+
+    static qint64 nowNanos();
+    static int currentThreadIndex();
+    static int& currentDepth();
+
+    std::atomic<bool> m_enabled;
+
+    // Bounded multiple producer ring, see
+    // https://www.1024cores.net/home/lock-free-algorithms/queues/bounded-mpmc-queue
+    std::unique_ptr<Slot[]> m_slots;
+    std::atomic<quint64> m_writePosition;
+    quint64 m_readPosition;
+    std::atomic<quint64> m_droppedCount;
+
+    std::atomic<quint64> m_callback;
+    qint64 m_callbackStartNanos;
+
+    mutable QMutex m_stagesMutex;
+    QVector<QString> m_stageNames;
+    QHash<QString, StageId> m_stageIds;
+};
+
+// Records the duration of the enclosing scope as the given stage.
+class ScopedEngineProfile final {
+  public:
+    explicit ScopedEngineProfile(EngineProfiler::StageId stage)
+            : m_pProfiler(&EngineProfiler::instance()),
+              m_stage(stage),
+              m_active(m_pProfiler->isEnabled()),
+              m_depth(0),
+              m_startNanos(0) {
+        if (m_active) {
+            start();
+        }
+    }
+    ~ScopedEngineProfile() {
+        if (m_active) {
+            stop();
+        }
+    }
+
+    ScopedEngineProfile(const ScopedEngineProfile&) = delete;
+    ScopedEngineProfile& operator=(const ScopedEngineProfile&) = delete;
+
+  private:
+    void start();
+    void stop();
+
+    EngineProfiler* const m_pProfiler;
+    const EngineProfiler::StageId m_stage;
+    const bool m_active;
+    int m_depth;
+    qint64 m_startNanos;
+};
@@ -0,0 +1,36 @@
+#include "engine/enginescratchbuffers.h"
+
+#include "util/assert.h"
+#include "util/defs.h"
+
+namespace {
+
+thread_local int s_threadSlot = 0;
+
+} // anonymous namespace
+
+EngineScratchBuffers::EngineScratchBuffers() {
+    reserveThreads(1);
+}
+
+void EngineScratchBuffers::reserveThreads(int numThreads) {
+    m_buffersPerThread.reserve(numThreads);
+    while (static_cast<int>(m_buffersPerThread.size()) < numThreads) {
+        m_buffersPerThread.emplace_back(kNumRoles * MAX_BUFFER_LEN);
+    }
+}
+
+CSAMPLE* EngineScratchBuffers::buffer(Role role) {
+    int slot = s_threadSlot;
+    VERIFY_OR_DEBUG_ASSERT(slot < static_cast<int>(m_buffersPerThread.size())) {
+        slot = 0;
+    }
+    return m_buffersPerThread[slot].data(
+            static_cast<int>(role) * MAX_BUFFER_LEN);
+}
+
+// static
+void EngineScratchBuffers::setThreadSlot(int slot) {
+    DEBUG_ASSERT(slot >= 0);
+    s_threadSlot = slot;
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <vector>
+
+#include "util/samplebuffer.h"
+#include "util/types.h"
+
+/// Preallocated temporary sample buffers for the engine callback.
+///
+/// Many engine objects need temporary buffers only while they are processed,
+/// e.g. the intermediate buffers between the effects of an EngineEffectChain.
+/// Instead of each object owning its own buffers, all objects that are
+/// processed on the same thread share a few buffers, one for each role that
+/// is live at the same time. The working set of the callback then no longer
+/// grows with the number of objects and stays in the CPU caches.
+///
+/// Each thread that processes audio has its own set of buffers, selected by
+/// the slot of the calling thread: The callback thread uses slot 0 and the
+/// workers of EngineChannelWorkerPool the following slots.
+class EngineScratchBuffers final {
+  public:
+    /// The buffers that might be in use at the same time on a thread
+    enum class Role {
+        EffectsManagerIntermediate1,
+        EffectsManagerIntermediate2,
+        EffectChainIntermediate1,
+        EffectChainIntermediate2,
+    };
+    static constexpr int kNumRoles = 4;
+
+    /// Allocates the buffers for the callback thread
+    EngineScratchBuffers();
+
+    /// Allocates the buffers for numThreads threads. Must not be called
+    /// while the engine is processing.
+    void reserveThreads(int numThreads);
+
+    /// Returns the buffer with MAX_BUFFER_LEN samples for the role on the
+    /// calling thread. Called from audio thread.
+    CSAMPLE* buffer(Role role);
+
+    /// Assigns the slot of the calling thread. Threads that never call this
+    /// use slot 0.
+    static void setThreadSlot(int slot);
+
+  private:
+    std::vector<mixxx::SampleBuffer> m_buffersPerThread;
+};
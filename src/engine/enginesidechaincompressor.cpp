@@ -1,6 +1,8 @@
 #include <QtDebug>
+#include <limits>
 
 #include "engine/enginesidechaincompressor.h"
+#include "util/math.h"
 
 EngineSideChainCompressor::EngineSideChainCompressor(const QString& group)
         : m_compressRatio(1.0),
@@ -43,14 +45,15 @@ void EngineSideChainCompressor::setAboveThreshold(bool value) {
 }
 
 void EngineSideChainCompressor::processKey(const CSAMPLE* pIn, const int iBufferSize) {
-    m_bAboveThreshold = false;
-    for (int i = 0; i + 1 < iBufferSize; i += 2) {
-        CSAMPLE val = (pIn[i] + pIn[i + 1]) / 2;
-        if (val > m_threshold) {
-            m_bAboveThreshold = true;
-            return;
-        }
+    // A reduction without an early exit, so the whole buffer is scanned
+    // with SIMD instructions
+    CSAMPLE maxVal = -std::numeric_limits<CSAMPLE>::infinity();
+    // note: LOOP VECTORIZED only with "int i" (not SINT i)
+    for (int i = 0; i < iBufferSize / 2; ++i) {
+        const CSAMPLE val = (pIn[i * 2] + pIn[i * 2 + 1]) / 2;
+        maxVal = math_max(maxVal, val);
     }
+    m_bAboveThreshold = maxVal > m_threshold;
 }
 
 double EngineSideChainCompressor::calculateCompressedGain(int frames) {
@@ -78,28 +78,37 @@ void EngineVuMeter::process(CSAMPLE* pIn, const int iBufferSize) {
         m_fRMSvolumeSumR = 0;
     }
 
+    // The peak indicators are only set when they change. Setting a control
+    // costs more than the comparison, and this runs for every channel in
+    // every callback, even for samplers that are not playing.
     if (clipped & SampleUtil::CLIPPING_LEFT) {
-        m_peakIndicatorLeft.set(1.0);
         m_peakDurationL = kPeakDuration * sampleRate / iBufferSize / 2000;
+        setPeakIndicator(&m_peakIndicatorLeft, &m_bPeakL, true);
     } else if (m_peakDurationL <= 0) {
-        m_peakIndicatorLeft.set(0.0);
+        setPeakIndicator(&m_peakIndicatorLeft, &m_bPeakL, false);
     } else {
         --m_peakDurationL;
     }
 
     if (clipped & SampleUtil::CLIPPING_RIGHT) {
-        m_peakIndicatorRight.set(1.0);
         m_peakDurationR = kPeakDuration * sampleRate / iBufferSize / 2000;
+        setPeakIndicator(&m_peakIndicatorRight, &m_bPeakR, true);
     } else if (m_peakDurationR <= 0) {
-        m_peakIndicatorRight.set(0.0);
+        setPeakIndicator(&m_peakIndicatorRight, &m_bPeakR, false);
     } else {
         --m_peakDurationR;
     }
 
-    m_peakIndicator.set(
-            (m_peakIndicatorRight.toBool() || m_peakIndicatorLeft.toBool())
-                    ? 1.0
-                    : 0.0);
+    bool peak = m_bPeakL || m_bPeakR;
+    setPeakIndicator(&m_peakIndicator, &m_bPeak, peak);
+}
+
+void EngineVuMeter::setPeakIndicator(ControlObject* pIndicator, bool* pState, bool peak) {
+    if (*pState == peak) {
+        return;
+    }
+    *pState = peak;
+    pIndicator->set(peak ? 1.0 : 0.0);
 }
 
 void EngineVuMeter::doSmooth(CSAMPLE &currentVolume, CSAMPLE newVolume)
@@ -132,4 +141,7 @@ void EngineVuMeter::reset() {
     m_fRMSvolumeSumR = 0;
     m_peakDurationL = 0;
     m_peakDurationR = 0;
+    m_bPeak = false;
+    m_bPeakL = false;
+    m_bPeakR = false;
 }
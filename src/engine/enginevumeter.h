@@ -15,6 +15,7 @@ class EngineVuMeter : public EngineObject {
 
   private:
     void doSmooth(CSAMPLE &currentVolume, CSAMPLE newVolume);
+    void setPeakIndicator(ControlObject* pIndicator, bool* pState, bool peak);
 
     ControlObject m_vuMeter;
     ControlObject m_vuMeterLeft;
@@ -30,6 +31,10 @@ class EngineVuMeter : public EngineObject {
     ControlObject m_peakIndicatorRight;
     int m_peakDurationL;
     int m_peakDurationR;
+    // Last values set to the peak indicators
+    bool m_bPeak;
+    bool m_bPeakL;
+    bool m_bPeakR;
 
     PollingControlProxy m_sampleRate;
 };
@@ -9,6 +9,14 @@
 #include "engine/engineobject.h"
 #include "util/sample.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || \
+        (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define IIR_STEREO_SSE2 1
+#include <emmintrin.h>
+#else
+#define IIR_STEREO_SSE2 0
+#endif
+
 // set to 1 to print some analysis data using qDebug()
 // It prints the resulting delay after 50 % of impulse have passed
 // and the gain and phase shift at some sample frequencies
@@ -26,6 +34,100 @@ enum IIRPass {
 };
 
 
+// The left and right sample of a stereo frame. Both channels are filtered
+// with the same coefficients, so EngineFilterIIR processes them together
+// in the two lanes of an SSE2 register if available. Each lane performs
+// the same operations as the scalar code would for a single channel.
+class IIRStereoValue {
+  public:
+    // Value-initialization sets both samples to 0
+    IIRStereoValue() = default;
+
+    IIRStereoValue& operator+=(IIRStereoValue other) {
+        return *this = *this + other;
+    }
+    IIRStereoValue& operator-=(IIRStereoValue other) {
+        return *this = *this - other;
+    }
+
+#if (IIR_STEREO_SSE2)
+    static IIRStereoValue load(const CSAMPLE* pFrame) {
+        return IIRStereoValue(_mm_cvtps_pd(_mm_castsi128_ps(
+                _mm_loadl_epi64(reinterpret_cast<const __m128i*>(pFrame)))));
+    }
+    void store(CSAMPLE* pFrame) const {
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(pFrame),
+                _mm_castps_si128(_mm_cvtpd_ps(m_value)));
+    }
+    // Rounds both samples to the precision of CSAMPLE
+    IIRStereoValue rounded() const {
+        return IIRStereoValue(_mm_cvtps_pd(_mm_cvtpd_ps(m_value)));
+    }
+
+    friend IIRStereoValue operator+(IIRStereoValue a, IIRStereoValue b) {
+        return IIRStereoValue(_mm_add_pd(a.m_value, b.m_value));
+    }
+    friend IIRStereoValue operator-(IIRStereoValue a, IIRStereoValue b) {
+        return IIRStereoValue(_mm_sub_pd(a.m_value, b.m_value));
+    }
+    friend IIRStereoValue operator-(IIRStereoValue a) {
+        // Flip the sign bit like a scalar negation, also for 0
+        return IIRStereoValue(_mm_xor_pd(a.m_value, _mm_set1_pd(-0.0)));
+    }
+    friend IIRStereoValue operator*(IIRStereoValue a, double b) {
+        return IIRStereoValue(_mm_mul_pd(a.m_value, _mm_set1_pd(b)));
+    }
+    friend IIRStereoValue operator*(double a, IIRStereoValue b) {
+        return IIRStereoValue(_mm_mul_pd(_mm_set1_pd(a), b.m_value));
+    }
+
+  private:
+    explicit IIRStereoValue(__m128d value)
+            : m_value(value) {
+    }
+
+    __m128d m_value;
+#else
+    static IIRStereoValue load(const CSAMPLE* pFrame) {
+        return IIRStereoValue(pFrame[0], pFrame[1]);
+    }
+    void store(CSAMPLE* pFrame) const {
+        pFrame[0] = static_cast<CSAMPLE>(m_left);
+        pFrame[1] = static_cast<CSAMPLE>(m_right);
+    }
+    // Rounds both samples to the precision of CSAMPLE
+    IIRStereoValue rounded() const {
+        return IIRStereoValue(static_cast<CSAMPLE>(m_left),
+                static_cast<CSAMPLE>(m_right));
+    }
+
+    friend IIRStereoValue operator+(IIRStereoValue a, IIRStereoValue b) {
+        return IIRStereoValue(a.m_left + b.m_left, a.m_right + b.m_right);
+    }
+    friend IIRStereoValue operator-(IIRStereoValue a, IIRStereoValue b) {
+        return IIRStereoValue(a.m_left - b.m_left, a.m_right - b.m_right);
+    }
+    friend IIRStereoValue operator-(IIRStereoValue a) {
+        return IIRStereoValue(-a.m_left, -a.m_right);
+    }
+    friend IIRStereoValue operator*(IIRStereoValue a, double b) {
+        return IIRStereoValue(a.m_left * b, a.m_right * b);
+    }
+    friend IIRStereoValue operator*(double a, IIRStereoValue b) {
+        return IIRStereoValue(a * b.m_left, a * b.m_right);
+    }
+
+  private:
+    IIRStereoValue(double left, double right)
+            : m_left(left),
+              m_right(right) {
+    }
+
+    double m_left;
+    double m_right;
+#endif
+};
+
 class EngineFilterIIRBase : public EngineObjectConstIn {
   public:
     virtual void assumeSettled() = 0;
@@ -83,11 +185,9 @@ class EngineFilterIIR : public EngineFilterIIRBase {
 
     void initBuffers() {
         // Copy the current buffers into the old buffers
-        memcpy(m_oldBuf1, m_buf1, sizeof(m_buf1));
-        memcpy(m_oldBuf2, m_buf2, sizeof(m_buf2));
+        memcpy(m_oldBuf, m_buf, sizeof(m_buf));
         // Set the current buffers to 0
-        memset(m_buf1, 0, sizeof(m_buf1));
-        memset(m_buf2, 0, sizeof(m_buf2));
+        memset(m_buf, 0, sizeof(m_buf));
         m_doRamping = true;
     }
 
@@ -230,12 +330,17 @@ class EngineFilterIIR : public EngineFilterIIRBase {
         m_doStart = false;
     }
 
+    // The gain followed by the SIZE coefficients of the current filter
+    const double* coefficients() const {
+        return m_coef;
+    }
+
     virtual void process(const CSAMPLE* pIn, CSAMPLE* pOutput,
                          const int iBufferSize) {
         if (!m_doRamping) {
             for (int i = 0; i < iBufferSize; i += 2) {
-                pOutput[i] = static_cast<CSAMPLE>(processSample(m_coef, m_buf1, pIn[i]));
-                pOutput[i + 1] = static_cast<CSAMPLE>(processSample(m_coef, m_buf2, pIn[i + 1]));
+                processSample(m_coef, m_buf, IIRStereoValue::load(&pIn[i]))
+                        .store(&pOutput[i]);
             }
         } else {
             double cross_mix = 0.0;
@@ -252,31 +357,24 @@ class EngineFilterIIR : public EngineFilterIIRBase {
                 // of the new filter but it turns out that this produces
                 // a gain drop due to the filter delay which is more
                 // conspicuous than the settling noise.
-                double old1;
-                double old2;
+                const IIRStereoValue input = IIRStereoValue::load(&pIn[i]);
+                IIRStereoValue oldValue;
                 if (!m_doStart) {
                     // Process old filter, but only if we do not do a fresh start
-                    old1 = static_cast<CSAMPLE>(processSample(m_oldCoef, m_oldBuf1, pIn[i]));
-                    old2 = static_cast<CSAMPLE>(processSample(m_oldCoef, m_oldBuf2, pIn[i + 1]));
+                    oldValue = processSample(m_oldCoef, m_oldBuf, input).rounded();
+                } else if (m_startFromDry) {
+                    oldValue = input;
                 } else {
-                    if (m_startFromDry) {
-                        old1 = pIn[i];
-                        old2 = pIn[i + 1];
-                    } else {
-                        old1 = 0;
-                        old2 = 0;
-                    }
+                    oldValue = IIRStereoValue();
                 }
-                double new1 = static_cast<CSAMPLE>(processSample(m_coef, m_buf1, pIn[i]));
-                double new2 = static_cast<CSAMPLE>(processSample(m_coef, m_buf2, pIn[i + 1]));
+                const IIRStereoValue newValue =
+                        processSample(m_coef, m_buf, input).rounded();
 
                 if (i < iBufferSize / 2) {
-                    pOutput[i] = static_cast<CSAMPLE>(old1);
-                    pOutput[i + 1] = static_cast<CSAMPLE>(old2);
+                    oldValue.store(&pOutput[i]);
                 } else {
-                    pOutput[i] = static_cast<CSAMPLE>(new1 * cross_mix + old1 * (1.0 - cross_mix));
-                    pOutput[i + 1] = static_cast<CSAMPLE>(
-                            new2 * cross_mix + old2 * (1.0 - cross_mix));
+                    (newValue * cross_mix + oldValue * (1.0 - cross_mix))
+                            .store(&pOutput[i]);
                     cross_mix += cross_inc;
                 }
             }
@@ -286,11 +384,13 @@ class EngineFilterIIR : public EngineFilterIIRBase {
     }
 
   protected:
-    inline double processSample(double* coef, double* buf, double val);
+    // Processes a single channel with T = double or both channels of a
+    // frame with T = IIRStereoValue
+    template<typename T>
+    inline T processSample(const double* coef, T* buf, T val);
     inline void pauseFilterInner() {
         // Set the current buffers to 0
-        memset(m_buf1, 0, sizeof(m_buf1));
-        memset(m_buf2, 0, sizeof(m_buf2));
+        memset(m_buf, 0, sizeof(m_buf));
         m_doRamping = true;
         m_doStart = true;
     }
@@ -299,15 +399,10 @@ class EngineFilterIIR : public EngineFilterIIRBase {
     // Old coefficients needed for ramping
     double m_oldCoef[SIZE + 1];
 
-    // Channel 1 state
-    double m_buf1[SIZE];
-    // Old channel 1 buffer needed for ramping
-    double m_oldBuf1[SIZE];
-
-    // Channel 2 state
-    double m_buf2[SIZE];
-    // Old channel 2 buffer needed for ramping
-    double m_oldBuf2[SIZE];
+    // State of both channels
+    IIRStereoValue m_buf[SIZE];
+    // Old state needed for ramping
+    IIRStereoValue m_oldBuf[SIZE];
 
     // Flag set to true if ramping needs to be done
     bool m_doRamping;
@@ -318,10 +413,10 @@ class EngineFilterIIR : public EngineFilterIIRBase {
 };
 
 template<>
-inline double EngineFilterIIR<2, IIR_LP>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-    double tmp, fir, iir;
+template<typename T>
+inline T EngineFilterIIR<2, IIR_LP>::processSample(
+        const double* coef, T* buf, T val) {
+    T tmp, fir, iir;
     tmp = buf[0]; buf[0] = buf[1];
     iir = val * coef[0];
     iir -= coef[1] * tmp; fir = tmp;
@@ -332,10 +427,10 @@ inline double EngineFilterIIR<2, IIR_LP>::processSample(double* coef,
 }
 
 template<>
-inline double EngineFilterIIR<2, IIR_BP>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-    double tmp, fir, iir;
+template<typename T>
+inline T EngineFilterIIR<2, IIR_BP>::processSample(
+        const double* coef, T* buf, T val) {
+    T tmp, fir, iir;
     tmp = buf[0]; buf[0] = buf[1];
     iir = val * coef[0];
     iir -= coef[1] * tmp; fir = -tmp;
@@ -346,10 +441,10 @@ inline double EngineFilterIIR<2, IIR_BP>::processSample(double* coef,
 }
 
 template<>
-inline double EngineFilterIIR<2, IIR_HP>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-    double tmp, fir, iir;
+template<typename T>
+inline T EngineFilterIIR<2, IIR_HP>::processSample(
+        const double* coef, T* buf, T val) {
+    T tmp, fir, iir;
     tmp = buf[0]; buf[0] = buf[1];
     iir = val * coef[0];
     iir -= coef[1] * tmp; fir = tmp;
@@ -360,10 +455,10 @@ inline double EngineFilterIIR<2, IIR_HP>::processSample(double* coef,
 }
 
 template<>
-inline double EngineFilterIIR<4, IIR_LP>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-    double tmp, fir, iir;
+template<typename T>
+inline T EngineFilterIIR<4, IIR_LP>::processSample(
+        const double* coef, T* buf, T val) {
+    T tmp, fir, iir;
     tmp = buf[0]; buf[0] = buf[1]; buf[1] = buf[2]; buf[2] = buf[3];
     iir = val * coef[0];
     iir -= coef[1] * tmp; fir = tmp;
@@ -379,10 +474,10 @@ inline double EngineFilterIIR<4, IIR_LP>::processSample(double* coef,
 }
 
 template<>
-inline double EngineFilterIIR<8, IIR_BP>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-    double tmp, fir, iir;
+template<typename T>
+inline T EngineFilterIIR<8, IIR_BP>::processSample(
+        const double* coef, T* buf, T val) {
+    T tmp, fir, iir;
     tmp = buf[0]; buf[0] = buf[1]; buf[1] = buf[2]; buf[2] = buf[3];
     buf[3] = buf[4]; buf[4] = buf[5]; buf[5] = buf[6]; buf[6] = buf[7];
     iir = val * coef[0];
@@ -409,10 +504,10 @@ inline double EngineFilterIIR<8, IIR_BP>::processSample(double* coef,
 }
 
 template<>
-inline double EngineFilterIIR<4, IIR_HP>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-    double tmp, fir, iir;
+template<typename T>
+inline T EngineFilterIIR<4, IIR_HP>::processSample(
+        const double* coef, T* buf, T val) {
+    T tmp, fir, iir;
     tmp = buf[0]; buf[0] = buf[1]; buf[1] = buf[2]; buf[2] = buf[3];
     iir= val * coef[0];
     iir -= coef[1] * tmp; fir = tmp;
@@ -428,10 +523,10 @@ inline double EngineFilterIIR<4, IIR_HP>::processSample(double* coef,
 }
 
 template<>
-inline double EngineFilterIIR<8, IIR_LP>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-    double tmp, fir, iir;
+template<typename T>
+inline T EngineFilterIIR<8, IIR_LP>::processSample(
+        const double* coef, T* buf, T val) {
+    T tmp, fir, iir;
     tmp = buf[0]; buf[0] = buf[1]; buf[1] = buf[2]; buf[2] = buf[3];
     buf[3] = buf[4]; buf[4] = buf[5]; buf[5] = buf[6]; buf[6] = buf[7];
     iir = val * coef[0];
@@ -458,10 +553,10 @@ inline double EngineFilterIIR<8, IIR_LP>::processSample(double* coef,
 }
 
 template<>
-inline double EngineFilterIIR<16, IIR_BP>::processSample(double* coef,
-                                                         double* buf,
-                                                         double val) {
-    double tmp, fir, iir;
+template<typename T>
+inline T EngineFilterIIR<16, IIR_BP>::processSample(
+        const double* coef, T* buf, T val) {
+    T tmp, fir, iir;
     tmp = buf[0]; buf[0] = buf[1]; buf[1] = buf[2]; buf[2] = buf[3];
     buf[3] = buf[4]; buf[4] = buf[5]; buf[5] = buf[6]; buf[6] = buf[7];
     buf[7] = buf[8]; buf[8] = buf[9]; buf[9] = buf[10]; buf[10] = buf[11];
@@ -510,10 +605,10 @@ inline double EngineFilterIIR<16, IIR_BP>::processSample(double* coef,
 }
 
 template<>
-inline double EngineFilterIIR<8, IIR_HP>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-    double tmp, fir, iir;
+template<typename T>
+inline T EngineFilterIIR<8, IIR_HP>::processSample(
+        const double* coef, T* buf, T val) {
+    T tmp, fir, iir;
     tmp = buf[0]; buf[0] = buf[1]; buf[1] = buf[2]; buf[2] = buf[3];
     buf[3] = buf[4]; buf[4] = buf[5]; buf[5] = buf[6]; buf[6] = buf[7];
     iir = val * coef[0];
@@ -541,10 +636,10 @@ inline double EngineFilterIIR<8, IIR_HP>::processSample(double* coef,
 
 // IIR_LP and IIR_HP use the same processSample routine
 template<>
-inline double EngineFilterIIR<5, IIR_BP>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-    double tmp, fir, iir;
+template<typename T>
+inline T EngineFilterIIR<5, IIR_BP>::processSample(
+        const double* coef, T* buf, T val) {
+    T tmp, fir, iir;
     tmp = buf[0]; buf[0] = buf[1];
     iir = val * coef[0];
     iir -= coef[1] * tmp; fir = coef[2] * tmp;
@@ -555,10 +650,10 @@ inline double EngineFilterIIR<5, IIR_BP>::processSample(double* coef,
 }
 
 template<>
-inline double EngineFilterIIR<4, IIR_LPMO>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-   double tmp, fir, iir;
+template<typename T>
+inline T EngineFilterIIR<4, IIR_LPMO>::processSample(
+        const double* coef, T* buf, T val) {
+   T tmp, fir, iir;
    tmp= buf[0]; buf[0] = buf[1]; buf[1] = buf[2]; buf[2] = buf[3];
    iir= val * coef[0];
    iir -= coef[1]*tmp; fir= tmp;
@@ -581,10 +676,10 @@ inline double EngineFilterIIR<4, IIR_LPMO>::processSample(double* coef,
 
 
 template<>
-inline double EngineFilterIIR<4, IIR_HPMO>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-   double tmp, fir, iir;
+template<typename T>
+inline T EngineFilterIIR<4, IIR_HPMO>::processSample(
+        const double* coef, T* buf, T val) {
+   T tmp, fir, iir;
    tmp= buf[0]; buf[0] = buf[1]; buf[1] = buf[2]; buf[2] = buf[3];
    iir= val * coef[0];
    iir -= coef[1]*tmp; fir= -tmp;
@@ -606,10 +701,10 @@ inline double EngineFilterIIR<4, IIR_HPMO>::processSample(double* coef,
 }
 
 template<>
-inline double EngineFilterIIR<2, IIR_LP2>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-    double tmp, fir, iir;
+template<typename T>
+inline T EngineFilterIIR<2, IIR_LP2>::processSample(
+        const double* coef, T* buf, T val) {
+    T tmp, fir, iir;
     tmp = buf[0];
     iir = val * coef[0];
     iir -= coef[1] * tmp; fir = tmp;
@@ -627,10 +722,10 @@ inline double EngineFilterIIR<2, IIR_LP2>::processSample(double* coef,
 
 
 template<>
-inline double EngineFilterIIR<2, IIR_HP2>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-    double tmp, fir, iir;
+template<typename T>
+inline T EngineFilterIIR<2, IIR_HP2>::processSample(
+        const double* coef, T* buf, T val) {
+    T tmp, fir, iir;
     tmp = buf[0];
     iir = val * -coef[0]; // swap gain to be in phase with LP2
     iir -= coef[1] * tmp; fir = -tmp;
@@ -6,12 +6,24 @@
 #include "util/defs.h"
 #include "util/sample.h"
 
+namespace {
+
+// The length of the crossfade at loop triggers, unless the loop is shorter
+// than twice as long. About 6 ms at 44.1 kHz.
+constexpr SINT kLoopCrossFadeSamples = 256 * mixxx::kEngineChannelCount;
+
+} // namespace
+
 ReadAheadManager::ReadAheadManager()
         : m_pLoopingControl(nullptr),
           m_pRateControl(nullptr),
           m_currentPosition(0),
           m_pReader(nullptr),
           m_pCrossFadeBuffer(SampleUtil::alloc(MAX_BUFFER_LEN)),
+          m_crossFadeSourcePosition(0),
+          m_crossFadeSamples(0),
+          m_crossFadeRemaining(0),
+          m_crossFadeReverse(false),
           m_cacheMissHappened(false) {
     // For testing only: ReadAheadManagerMock
 }
@@ -23,6 +35,10 @@ ReadAheadManager::ReadAheadManager(CachingReader* pReader,
           m_currentPosition(0),
           m_pReader(pReader),
           m_pCrossFadeBuffer(SampleUtil::alloc(MAX_BUFFER_LEN)),
+          m_crossFadeSourcePosition(0),
+          m_crossFadeSamples(0),
+          m_crossFadeRemaining(0),
+          m_crossFadeReverse(false),
           m_cacheMissHappened(false) {
     DEBUG_ASSERT(m_pLoopingControl != nullptr);
     DEBUG_ASSERT(m_pReader != nullptr);
@@ -103,6 +119,10 @@ SINT ReadAheadManager::getNextSamples(double dRate, CSAMPLE* pOutput,
         m_cacheMissHappened = false;
     }
 
+    if (m_crossFadeRemaining > 0) {
+        applyLoopCrossFade(in_reverse, pOutput, samples_from_reader);
+    }
+
     // Increment or decrement current read-ahead position
     // Mixing int and double here is desired, because the fractional frame should
     // be resist
@@ -138,51 +158,19 @@ SINT ReadAheadManager::getNextSamples(double dRate, CSAMPLE* pOutput,
             // Average preloop_samples = 2.2
         }
 
-        // start reading before the loop start point, to crossfade these samples
-        // with the samples we need to the loop end
-        int loop_read_position = SampleUtil::roundPlayPosToFrameStart(
-                m_currentPosition +
-                        (in_reverse ? preloop_samples : -preloop_samples),
-                mixxx::kEngineChannelCount);
-
-        int crossFadeStart = 0;
-        int crossFadeSamples = samples_from_reader;
-        if (loop_read_position < 0) {
-            // we start in the pre-role without suitable samples for crossfading
-            crossFadeStart = -loop_read_position;
-            crossFadeSamples -= crossFadeStart;
-        } else {
-            int trackSamples = static_cast<int>(m_pLoopingControl->getTrackSamples());
-            if (loop_read_position > trackSamples) {
-                // looping in reverse overlapping post-roll without samples
-                crossFadeStart = loop_read_position - trackSamples;
-                crossFadeSamples -= crossFadeStart;
-            }
-        }
-
-        if (crossFadeSamples > 0) {
-            const auto readResult = m_pReader->read(loop_read_position +
-                            (in_reverse ? crossFadeStart : -crossFadeStart),
-                    crossFadeSamples,
-                    in_reverse,
-                    m_pCrossFadeBuffer);
-            if (readResult == CachingReader::ReadResult::UNAVAILABLE) {
-                qDebug() << "ERROR: Couldn't get all needed samples for crossfade.";
-                // Cache miss - no samples written
-                SampleUtil::clear(m_pCrossFadeBuffer, samples_from_reader);
-                // Set the cache miss flag to decide when to apply ramping
-                // after the following read attempts.
-                m_cacheMissHappened = true;
-            }
-
-            // do crossfade from the current buffer into the new loop beginning
-            if (samples_from_reader != 0) { // avoid division by zero
-                SampleUtil::linearCrossfadeBuffersOut(
-                        pOutput + crossFadeStart,
-                        m_pCrossFadeBuffer,
-                        crossFadeSamples);
-            }
-        }
+        // Fade from the samples that would have followed the trigger into
+        // the samples at the target during the next reads. It must be done
+        // before reaching the trigger again, even for the shortest loops.
+        const SINT loopSamples = SampleUtil::roundPlayPosToFrameStart(
+                std::abs(loop_trigger - target), mixxx::kEngineChannelCount);
+        m_crossFadeSamples = math_min(kLoopCrossFadeSamples,
+                SampleUtil::roundPlayPosToFrameStart(
+                        loopSamples / 2, mixxx::kEngineChannelCount));
+        m_crossFadeRemaining = m_crossFadeSamples;
+        m_crossFadeReverse = in_reverse;
+        m_crossFadeSourcePosition = in_reverse
+                ? start_sample - samples_from_reader
+                : start_sample + samples_from_reader;
     }
 
     // qDebug() << "read" << m_currentPosition << samples_from_reader;
@@ -193,10 +181,42 @@ void ReadAheadManager::addRateControl(RateControl* pRateControl) {
     m_pRateControl = pRateControl;
 }
 
+void ReadAheadManager::applyLoopCrossFade(
+        bool in_reverse, CSAMPLE* pOutput, SINT numSamples) {
+    if (in_reverse != m_crossFadeReverse) {
+        // The samples after the trigger are behind us now
+        m_crossFadeRemaining = 0;
+        return;
+    }
+    const SINT crossFadeSamples = math_min(numSamples, m_crossFadeRemaining);
+    if (crossFadeSamples <= 0) {
+        return;
+    }
+    // Fetch the samples after the trigger in one read
+    const auto readResult = m_pReader->read(m_crossFadeSourcePosition,
+            crossFadeSamples,
+            in_reverse,
+            m_pCrossFadeBuffer);
+    if (readResult == CachingReader::ReadResult::UNAVAILABLE) {
+        // Fade in from silence instead
+        SampleUtil::clear(m_pCrossFadeBuffer, crossFadeSamples);
+    }
+    const SINT fadedSamples = m_crossFadeSamples - m_crossFadeRemaining;
+    SampleUtil::equalPowerCrossfadeBuffersIn(pOutput,
+            m_pCrossFadeBuffer,
+            crossFadeSamples,
+            static_cast<CSAMPLE_GAIN>(fadedSamples) / m_crossFadeSamples,
+            static_cast<CSAMPLE_GAIN>(fadedSamples + crossFadeSamples) /
+                    m_crossFadeSamples);
+    m_crossFadeRemaining -= crossFadeSamples;
+    m_crossFadeSourcePosition += in_reverse ? -crossFadeSamples : crossFadeSamples;
+}
+
 // Not thread-save, call from engine thread only
 void ReadAheadManager::notifySeek(double seekPosition) {
     m_currentPosition = seekPosition;
     m_cacheMissHappened = false;
+    m_crossFadeRemaining = 0;
     m_readAheadLog.clear();
 
     // TODO(XXX) notifySeek on the engine controls. EngineBuffer currently does
@@ -117,11 +117,22 @@ class ReadAheadManager {
     void addReadLogEntry(double virtualPlaypositionStart,
                          double virtualPlaypositionEndNonInclusive);
 
+    /// Continues the crossfade from the samples after the last loop trigger
+    /// into the samples that have been read after jumping to its target.
+    void applyLoopCrossFade(bool in_reverse, CSAMPLE* pOutput, SINT numSamples);
+
     LoopingControl* m_pLoopingControl;
     RateControl* m_pRateControl;
     std::list<ReadLogEntry> m_readAheadLog;
     double m_currentPosition;
     CachingReader* m_pReader;
     CSAMPLE* m_pCrossFadeBuffer;
+
+    // The pending crossfade after a loop trigger, which may span several reads
+    SINT m_crossFadeSourcePosition;
+    SINT m_crossFadeSamples;
+    SINT m_crossFadeRemaining;
+    bool m_crossFadeReverse;
+
     bool m_cacheMissHappened;
 };
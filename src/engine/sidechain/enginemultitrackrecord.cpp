@@ -0,0 +1,333 @@
+#include "engine/sidechain/enginemultitrackrecord.h"
+
+#include <QFileInfo>
+#include <QtEndian>
+#include <cstring>
+
+#include "mixer/playerinfo.h"
+#include "mixer/playermanager.h"
+#include "moc_enginemultitrackrecord.cpp"
+#include "track/track.h"
+#include "util/assert.h"
+#include "util/compatibility/qatomic.h"
+#include "util/counter.h"
+#include "util/logger.h"
+#include "util/math.h"
+#include "util/sample.h"
+
+namespace {
+
+const mixxx::Logger kLogger("EngineMultitrackRecord");
+
+// 8 stereo decks at 96 kHz for more than a second
+constexpr int kFifoSize = 1 << 21;
+
+// The samples are written in blocks of 1 MiB, so every write starts at a
+// multiple of the block size of the file system.
+constexpr int kWriteBlockSamples = 256 * 1024;
+
+// Offset of the audio data in the file, the header is padded up to it.
+constexpr qint64 kDataOffset = 4096;
+
+constexpr int kWriterTimeoutMillis = 100;
+
+constexpr int kChannelsPerTrack = 2;
+
+template<typename T>
+void appendBigEndian(QByteArray* pHeader, T value) {
+    const T bigEndian = qToBigEndian(value);
+    pHeader->append(reinterpret_cast<const char*>(&bigEndian), sizeof(T));
+}
+
+void appendChunkHeader(QByteArray* pHeader, const char* type, qint64 size) {
+    pHeader->append(type, 4);
+    appendBigEndian<qint64>(pHeader, size);
+}
+
+QString escapeCueString(QString string) {
+    return string.replace(QChar('"'), QStringLiteral("\\\""));
+}
+
+} // namespace
+
+EngineMultitrackRecord::EngineMultitrackRecord()
+        : m_bStopThread(false),
+          m_bArmed(false),
+          m_bPostFader(false),
+          m_numTracks(0),
+          m_framesRecorded(0),
+          m_sampleFifo(kFifoSize),
+          m_pBlock1(nullptr),
+          m_blockSize1(0),
+          m_pBlock2(nullptr),
+          m_blockSize2(0),
+          m_blockFrames(0),
+          m_pWriteBuffer(SampleUtil::alloc(kWriteBlockSamples)),
+          m_dataChunkSizeOffset(0),
+          m_bytesWritten(0),
+          m_cueTrackNumber(0) {
+    // Same priority as the sidechain, writing is semi-realtime as well
+    start(QThread::HighPriority);
+}
+
+EngineMultitrackRecord::~EngineMultitrackRecord() {
+    stopRecording();
+    m_bStopThread = true;
+    m_samplesAvailable.release();
+    wait();
+    SampleUtil::free(m_pWriteBuffer);
+}
+
+bool EngineMultitrackRecord::startRecording(const QString& fileName,
+        mixxx::audio::SampleRate sampleRate,
+        int numTracks,
+        bool postFader) {
+    VERIFY_OR_DEBUG_ASSERT(!m_bArmed.loadAcquire()) {
+        stopRecording();
+    }
+    VERIFY_OR_DEBUG_ASSERT(numTracks > 0 && numTracks <= kMaxTracks) {
+        numTracks = math_clamp(numTracks, 1, kMaxTracks);
+    }
+
+    QMutexLocker locker(&m_fileMutex);
+    // Samples of a block that was committed after the last stop
+    m_sampleFifo.flushReadData(m_sampleFifo.readAvailable());
+
+    m_numTracks = numTracks;
+    m_bPostFader = postFader;
+    m_sampleRate = sampleRate;
+    atomicStoreRelaxed(m_framesRecorded, quint64{0});
+    m_bytesWritten = 0;
+
+    m_file.setFileName(fileName);
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Unbuffered)) {
+        kLogger.warning() << "Could not open" << fileName << "for writing:"
+                          << m_file.errorString();
+        return false;
+    }
+    if (!writeHeader()) {
+        kLogger.warning() << "Could not write to" << fileName << ":"
+                          << m_file.errorString();
+        m_file.close();
+        return false;
+    }
+
+    m_cueFile.setFileName(cueFileName(fileName));
+    if (m_cueFile.open(QIODevice::WriteOnly)) {
+        m_cueFile.write(QStringLiteral("REM STEMS %1\n").arg(m_numTracks).toUtf8());
+        m_cueFile.write(QStringLiteral("FILE \"%1\" WAVE\n")
+                                .arg(escapeCueString(QFileInfo(fileName).fileName()))
+                                .toUtf8());
+    } else {
+        kLogger.warning() << "Could not write CUE file" << m_cueFile.fileName()
+                          << m_cueFile.errorString();
+    }
+    m_cueTracks = QVector<TrackPointer>(m_numTracks);
+    m_cueTrackNumber = 0;
+
+    kLogger.info() << "Recording" << m_numTracks
+                   << (m_bPostFader ? "post-fader" : "pre-fader")
+                   << "stems to" << fileName;
+    m_bArmed.storeRelease(true);
+    return true;
+}
+
+void EngineMultitrackRecord::stopRecording() {
+    m_bArmed.storeRelease(false);
+
+    QMutexLocker locker(&m_fileMutex);
+    if (!m_file.isOpen()) {
+        return;
+    }
+    writeSamples(true);
+    closeFiles();
+}
+
+void EngineMultitrackRecord::beginBlock(int iFrames) {
+    const int iSamples = iFrames * kChannelsPerTrack * m_numTracks;
+    if (m_sampleFifo.writeAvailable() < iSamples) {
+        // Drop whole blocks only, so the tracks stay interleaved correctly
+        Counter("EngineMultitrackRecord buffer overrun").increment();
+        m_blockFrames = 0;
+        return;
+    }
+    m_sampleFifo.aquireWriteRegions(iSamples,
+            &m_pBlock1,
+            &m_blockSize1,
+            &m_pBlock2,
+            &m_blockSize2);
+    SampleUtil::clear(m_pBlock1, m_blockSize1);
+    if (m_blockSize2 > 0) {
+        SampleUtil::clear(m_pBlock2, m_blockSize2);
+    }
+    m_blockFrames = iFrames;
+}
+
+void EngineMultitrackRecord::addTrack(int track, const CSAMPLE* pBuffer) {
+    if (m_blockFrames == 0 || track < 0 || track >= m_numTracks) {
+        return;
+    }
+    const int stride = kChannelsPerTrack * m_numTracks;
+    int sample = kChannelsPerTrack * track;
+    for (int frame = 0; frame < m_blockFrames; ++frame) {
+        // The sample index is even and so are the region sizes, so a frame
+        // never straddles the two regions.
+        CSAMPLE* pDest = sample < m_blockSize1
+                ? m_pBlock1 + sample
+                : m_pBlock2 + (sample - m_blockSize1);
+        pDest[0] = pBuffer[kChannelsPerTrack * frame];
+        pDest[1] = pBuffer[kChannelsPerTrack * frame + 1];
+        sample += stride;
+    }
+}
+
+void EngineMultitrackRecord::endBlock() {
+    if (m_blockFrames == 0) {
+        return;
+    }
+    m_sampleFifo.releaseWriteRegions(m_blockFrames * kChannelsPerTrack * m_numTracks);
+    m_framesRecorded.fetchAndAddRelease(m_blockFrames);
+    m_blockFrames = 0;
+    if (m_sampleFifo.readAvailable() >= kWriteBlockSamples) {
+        m_samplesAvailable.release();
+    }
+}
+
+// static
+QString EngineMultitrackRecord::cueFileName(const QString& fileName) {
+    return fileName + QStringLiteral(".cue");
+}
+
+void EngineMultitrackRecord::run() {
+    setObjectName(QStringLiteral("EngineMultitrackRecord"));
+    while (!atomicLoadRelaxed(m_bStopThread)) {
+        // The timeout polls the decks for track changes
+        m_samplesAvailable.tryAcquire(1, kWriterTimeoutMillis);
+        m_samplesAvailable.tryAcquire(m_samplesAvailable.available());
+
+        QMutexLocker locker(&m_fileMutex);
+        if (!m_file.isOpen()) {
+            continue;
+        }
+        writeSamples(false);
+        writeCueLines();
+    }
+}
+
+bool EngineMultitrackRecord::writeHeader() {
+    // Core Audio Format, all values are big-endian. Its 64 bit chunk sizes
+    // allow recordings of any length and a data chunk of unknown size is
+    // still readable if the recording is interrupted.
+    const int channels = kChannelsPerTrack * m_numTracks;
+    QByteArray header;
+    header.reserve(kDataOffset);
+    header.append("caff", 4);
+    appendBigEndian<quint16>(&header, 1); // version
+    appendBigEndian<quint16>(&header, 0); // flags
+
+    appendChunkHeader(&header, "desc", 32);
+    const double sampleRate = m_sampleRate.value();
+    quint64 sampleRateBits;
+    std::memcpy(&sampleRateBits, &sampleRate, sizeof(sampleRateBits));
+    appendBigEndian<quint64>(&header, sampleRateBits);
+    header.append("lpcm", 4);
+    constexpr quint32 kFormatIsFloat = 1;
+    constexpr quint32 kFormatIsLittleEndian = 2;
+    appendBigEndian<quint32>(&header, kFormatIsFloat | kFormatIsLittleEndian);
+    appendBigEndian<quint32>(&header, sizeof(CSAMPLE) * channels); // bytes per packet
+    appendBigEndian<quint32>(&header, 1);                          // frames per packet
+    appendBigEndian<quint32>(&header, channels);
+    appendBigEndian<quint32>(&header, sizeof(CSAMPLE) * 8); // bits per channel
+
+    // Pad the header, so the samples start at kDataOffset
+    constexpr qint64 kChunkHeaderSize = 12;
+    constexpr qint64 kEditCountSize = 4;
+    const qint64 freeSize = kDataOffset - header.size() -
+            2 * kChunkHeaderSize - kEditCountSize;
+    appendChunkHeader(&header, "free", freeSize);
+    header.append(static_cast<int>(freeSize), '\0');
+
+    // -1 marks the size as unknown until the recording is stopped
+    appendChunkHeader(&header, "data", -1);
+    m_dataChunkSizeOffset = header.size() - sizeof(qint64);
+    appendBigEndian<quint32>(&header, 0); // edit count
+    DEBUG_ASSERT(header.size() == kDataOffset);
+
+    return m_file.write(header) == header.size();
+}
+
+void EngineMultitrackRecord::writeSamples(bool flush) {
+    while (true) {
+        const int samples = math_min(m_sampleFifo.readAvailable(), kWriteBlockSamples);
+        if (samples == 0 || (!flush && samples < kWriteBlockSamples)) {
+            return;
+        }
+        m_sampleFifo.read(m_pWriteBuffer, samples);
+        const qint64 bytes = samples * static_cast<qint64>(sizeof(CSAMPLE));
+        const qint64 written = m_file.write(
+                reinterpret_cast<const char*>(m_pWriteBuffer), bytes);
+        if (written != bytes) {
+            Counter("EngineMultitrackRecord write error").increment();
+        }
+        if (written > 0) {
+            m_bytesWritten += written;
+        }
+    }
+}
+
+void EngineMultitrackRecord::writeCueLines() {
+    if (!m_cueFile.isOpen()) {
+        return;
+    }
+    const quint64 frames = atomicLoadAcquire(m_framesRecorded);
+    const quint64 seconds = frames / m_sampleRate.value();
+    // CDDA is specified as having 75 frames a second
+    const quint64 cueFrame = (frames % m_sampleRate.value()) * 75 / m_sampleRate.value();
+    bool written = false;
+    for (int track = 0; track < m_numTracks; ++track) {
+        TrackPointer pTrack = PlayerInfo::instance().getTrackInfo(
+                PlayerManager::groupForDeck(track));
+        if (!pTrack || pTrack == m_cueTracks[track]) {
+            continue;
+        }
+        m_cueTracks[track] = pTrack;
+        m_cueFile.write(QStringLiteral("  TRACK %1 AUDIO\n")
+                                .arg(++m_cueTrackNumber, 2, 10, QChar('0'))
+                                .toUtf8());
+        m_cueFile.write(QStringLiteral("    TITLE \"%1\"\n")
+                                .arg(escapeCueString(pTrack->getTitle()))
+                                .toUtf8());
+        m_cueFile.write(QStringLiteral("    PERFORMER \"%1\"\n")
+                                .arg(escapeCueString(pTrack->getArtist()))
+                                .toUtf8());
+        // The deck is recorded to the channels 2 * track + 1 and 2 * track + 2
+        m_cueFile.write(QStringLiteral("    REM DECK %1\n").arg(track + 1).toUtf8());
+        m_cueFile.write(QStringLiteral("    INDEX 01 %1:%2:%3\n")
+                                .arg(seconds / 60, 2, 10, QChar('0'))
+                                .arg(seconds % 60, 2, 10, QChar('0'))
+                                .arg(cueFrame, 2, 10, QChar('0'))
+                                .toUtf8());
+        written = true;
+    }
+    if (written) {
+        m_cueFile.flush();
+    }
+}
+
+void EngineMultitrackRecord::closeFiles() {
+    // The edit count is part of the data chunk
+    const qint64 dataChunkSize = 4 + m_bytesWritten;
+    if (m_file.seek(m_dataChunkSizeOffset)) {
+        const qint64 bigEndian = qToBigEndian(dataChunkSize);
+        m_file.write(reinterpret_cast<const char*>(&bigEndian), sizeof(bigEndian));
+    }
+    m_file.close();
+    if (m_cueFile.isOpen()) {
+        m_cueFile.close();
+    }
+    m_cueTracks.clear();
+    kLogger.info() << "Recorded"
+                   << m_bytesWritten / static_cast<qint64>(sizeof(CSAMPLE) *
+                                              kChannelsPerTrack * m_numTracks)
+                   << "frames of stems";
+}
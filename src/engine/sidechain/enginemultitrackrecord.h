@@ -0,0 +1,91 @@
+#pragma once
+
+#include <QFile>
+#include <QMutex>
+#include <QSemaphore>
+#include <QThread>
+#include <QVector>
+
+#include "audio/types.h"
+#include "track/track_decl.h"
+#include "util/fifo.h"
+#include "util/types.h"
+
+/// Records each deck to its own pair of channels of a multichannel CAF file.
+///
+/// The engine thread interleaves the deck buffers into a FIFO, either before
+/// or after the channel faders and effects. A writer thread moves the samples
+/// to the file in large blocks, so recording many decks at high sample rates
+/// costs the engine thread a single copy of each deck buffer. The data chunk
+/// of the file starts at a block boundary and its size is only written when
+/// the recording is stopped. Until then, it is marked as unknown, so a
+/// recording that was interrupted by a crash can still be read.
+///
+/// Track changes of the recorded decks are written to a CUE file next to the
+/// audio file.
+class EngineMultitrackRecord : public QThread {
+    Q_OBJECT
+  public:
+    static constexpr int kMaxTracks = 8;
+
+    EngineMultitrackRecord();
+    ~EngineMultitrackRecord() override;
+
+    /// Opens the files and starts recording the decks 1 to numTracks.
+    /// Called from the main thread.
+    bool startRecording(const QString& fileName,
+            mixxx::audio::SampleRate sampleRate,
+            int numTracks,
+            bool postFader);
+    /// Writes the remaining samples and closes the files. Called from the
+    /// main thread.
+    void stopRecording();
+
+    bool isRecording(bool postFader) const {
+        return m_bArmed.loadAcquire() && m_bPostFader == postFader;
+    }
+
+    // Wait-free, called from the engine thread for each callback while
+    // isRecording() returns true. Tracks that are not added are silent.
+    void beginBlock(int iFrames);
+    void addTrack(int track, const CSAMPLE* pBuffer);
+    void endBlock();
+
+    static QString cueFileName(const QString& fileName);
+
+  private:
+    void run() override;
+
+    // Called with m_fileMutex locked
+    bool writeHeader();
+    void writeSamples(bool flush);
+    void writeCueLines();
+    void closeFiles();
+
+    QAtomicInt m_bStopThread;
+    QAtomicInt m_bArmed;
+    bool m_bPostFader;
+    int m_numTracks;
+    QAtomicInteger<quint64> m_framesRecorded;
+    mixxx::audio::SampleRate m_sampleRate;
+
+    FIFO<CSAMPLE> m_sampleFifo;
+    QSemaphore m_samplesAvailable;
+
+    // Write regions of the current engine block
+    CSAMPLE* m_pBlock1;
+    ring_buffer_size_t m_blockSize1;
+    CSAMPLE* m_pBlock2;
+    ring_buffer_size_t m_blockSize2;
+    int m_blockFrames;
+
+    // Owned by the writer thread while recording
+    QMutex m_fileMutex;
+    QFile m_file;
+    QFile m_cueFile;
+    CSAMPLE* m_pWriteBuffer;
+    qint64 m_dataChunkSizeOffset;
+    qint64 m_bytesWritten;
+    QVector<TrackPointer> m_cueTracks;
+    int m_cueTrackNumber;
+};
@@ -78,6 +78,7 @@ void EngineNetworkStream::startStream(double sampleRate) {
     m_sampleRate = sampleRate;
     m_inputStreamStartTimeUs = getNetworkTimeUs();
     m_inputStreamFramesWritten = 0;
+    m_inputStreamFramesRead = 0;
 
     for (NetworkOutputStreamWorkerPtr worker : std::as_const(m_outputWorkers)) {
         if (worker.isNull()) {
@@ -113,12 +114,12 @@ void EngineNetworkStream::read(CSAMPLE* buffer, int frames) {
         buffer += copyCount;
     }
     if (readAvailable < readRequired) {
-        // Fill missing Samples with silence
+        // Fill missing Samples with silence. This is the normal case
+        // without a remote sender, so it is not logged.
         int silenceCount = readRequired - readAvailable;
-        kLogger.debug() << "write: flushed"
-                        << readRequired << "samples";
         SampleUtil::clear(buffer, silenceCount);
     }
+    m_inputStreamFramesRead += frames;
 }
 
 qint64 EngineNetworkStream::getInputStreamTimeFrames() {
@@ -1,5 +1,11 @@
 #include "engine/sidechain/enginerecord.h"
 
+#ifdef __WINDOWS__
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
 #include "control/controlproxy.h"
 #include "encoder/encoder.h"
 #include "mixer/playerinfo.h"
@@ -11,8 +17,13 @@
 
 constexpr int kMetaDataLifeTimeout = 16;
 
+// Writes to the disk are batched by the OS. Syncing more often protects
+// more against a power loss, but stalls this worker more often.
+constexpr quint64 kSyncIntervalSeconds = 60;
+
 EngineRecord::EngineRecord(UserSettingsPointer pConfig)
         : m_pConfig(pConfig),
+          m_bFileOpen(false),
           m_sampleRateControl(QStringLiteral("[App]"), QStringLiteral("samplerate")),
           m_frames(0),
           m_recordedDuration(0),
@@ -218,6 +229,9 @@ void EngineRecord::process(const CSAMPLE* pBuffer, const int iBufferSize) {
         // by RecordingManager to update the label besides start/stop button
         if (lastDuration != m_recordedDuration) {
             emit durationRecorded(m_recordedDuration);
+            if (m_recordedDuration % kSyncIntervalSeconds == 0) {
+                syncFile();
+            }
         }
     }
 }
@@ -274,27 +288,32 @@ void EngineRecord::write(const unsigned char *header, const unsigned char *body,
 
 }
 // Encoder calls this method to write compressed audio
-int EngineRecord::tell() {
+qint64 EngineRecord::tell() {
     if (!fileOpen()) {
         return -1;
     }
     return m_dataStream.device()->pos();
 }
 // Encoder calls this method to write compressed audio
-void EngineRecord::seek(int pos) {
+void EngineRecord::seek(qint64 pos) {
     if (!fileOpen()) {
         return;
     }
-    m_dataStream.device()->seek(static_cast<qint64>(pos));
+    m_dataStream.device()->seek(pos);
 }
 // These are not used for streaming, but the interface requires them
-int EngineRecord::filelen() {
+qint64 EngineRecord::filelen() {
     if (!fileOpen()) {
         return 0;
     }
     return m_dataStream.device()->size();
 }
 
+bool EngineRecord::isActive() const {
+    return m_pRecReady->get() != RECORD_OFF ||
+            m_bFileOpen.load(std::memory_order_relaxed);
+}
+
 bool EngineRecord::fileOpen() {
     return (m_file.handle() != -1);
 }
@@ -315,6 +334,7 @@ bool EngineRecord::openFile() {
     } else {
         return false;
     }
+    m_bFileOpen.store(fileOpen(), std::memory_order_relaxed);
 
     // Return whether the file is really open.
     return fileOpen();
@@ -373,6 +393,18 @@ void EngineRecord::closeFile() {
         }
         m_file.close();
     }
+    m_bFileOpen.store(false, std::memory_order_relaxed);
+}
+
+void EngineRecord::syncFile() {
+    // This runs in the thread of this worker, so a slow disk does not stall
+    // the engine or the other sidechain workers.
+    m_file.flush();
+#ifdef __WINDOWS__
+    _commit(m_file.handle());
+#else
+    fsync(m_file.handle());
+#endif
 }
 
 void EngineRecord::closeCueFile() {
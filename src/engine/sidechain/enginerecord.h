@@ -2,6 +2,7 @@
 
 #include <QDataStream>
 #include <QFile>
+#include <atomic>
 
 #include "audio/types.h"
 #include "control/pollingcontrolproxy.h"
@@ -21,15 +22,17 @@ class EngineRecord : public QObject, public EncoderCallback, public SideChainWor
 
     void process(const CSAMPLE* pBuffer, const int iBufferSize) override;
     void shutdown() override {}
+    // Active until the file has been closed after recording has stopped
+    bool isActive() const override;
 
     // writes compressed audio to file
     void write(const unsigned char *header, const unsigned char *body, int headerLen, int bodyLen) override;
     // gets stream position
-    int tell() override;
+    qint64 tell() override;
     // sets stream position
-    void seek(int pos) override;
+    void seek(qint64 pos) override;
     // gets stream length
-    int filelen()  override;
+    qint64 filelen() override;
 
     // creates or opens an audio file
     bool openFile();
@@ -59,6 +62,8 @@ class EngineRecord : public QObject, public EncoderCallback, public SideChainWor
     bool metaDataHasChanged();
 
     void writeCueLine();
+    // Flushes the recording to the disk, so it survives a power loss
+    void syncFile();
 
     UserSettingsPointer m_pConfig;
     EncoderPointer m_pEncoder;
@@ -69,6 +74,8 @@ class EngineRecord : public QObject, public EncoderCallback, public SideChainWor
     QString m_baAlbum;
 
     QFile m_file;
+    // Mirrors fileOpen() for the engine thread
+    std::atomic<bool> m_bFileOpen;
     QFile m_cueFile;
     QDataStream m_dataStream;
 
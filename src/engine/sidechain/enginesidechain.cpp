@@ -4,22 +4,90 @@
 // to increase the amount of time the CPU has to do whatever work needs to
 // be done, and that work is executed in a separate thread. (Threading
 // allows the next buffer to be filled while processing a buffer that's is
-// already full.)
+// already full.) The sidechain thread only distributes the samples to the
+// FIFOs of the workers, which run in threads of their own.
 
 #include "engine/sidechain/enginesidechain.h"
 
 #include <QtDebug>
+#include <algorithm>
 
 #include "engine/engine.h"
 #include "engine/sidechain/sidechainworker.h"
 #include "moc_enginesidechain.cpp"
+#include "util/compatibility/qatomic.h"
 #include "util/counter.h"
+#include "util/cpuaffinity.h"
+#include "util/denormalsarezero.h"
 #include "util/event.h"
 #include "util/sample.h"
 #include "util/trace.h"
 
 #define SIDECHAIN_BUFFER_SIZE 65536
 
+namespace {
+
+// Only reads the indices of the FIFO, which is safe from any thread
+double fillRatio(const FIFO<CSAMPLE>& fifo) {
+    const int readAvailable = fifo.readAvailable();
+    const int size = readAvailable + fifo.writeAvailable();
+    return size > 0 ? static_cast<double>(readAvailable) / size : 0.0;
+}
+
+// Each worker can fall behind by this many sidechain buffers, e.g. while a
+// recording waits for a slow disk.
+constexpr int kWorkerBufferCount = 4;
+
+} // namespace
+
+EngineSideChain::WorkerThread::WorkerThread(SideChainWorker* pWorker, int index)
+        : m_pWorker(pWorker),
+          m_overrunCounterKey(
+                  QStringLiteral("EngineSideChain::WorkerThread %1 buffer overrun")
+                          .arg(index)),
+          m_bStop(false),
+          m_sampleFifo(kWorkerBufferCount * SIDECHAIN_BUFFER_SIZE),
+          m_pWorkBuffer(SampleUtil::alloc(SIDECHAIN_BUFFER_SIZE)) {
+    setObjectName(QStringLiteral("EngineSideChain Worker %1").arg(index));
+    start(QThread::HighPriority);
+}
+
+EngineSideChain::WorkerThread::~WorkerThread() {
+    stop();
+    SampleUtil::free(m_pWorkBuffer);
+}
+
+void EngineSideChain::WorkerThread::writeSamples(const CSAMPLE* pBuffer, int iSamples) {
+    const int samples_written = m_sampleFifo.write(pBuffer, iSamples);
+    if (samples_written != iSamples) {
+        // Reported per worker, so it is visible which one did not keep up
+        Counter(m_overrunCounterKey).increment();
+    }
+    m_samplesAvailable.release();
+}
+
+void EngineSideChain::WorkerThread::stop() {
+    m_bStop = true;
+    m_samplesAvailable.release();
+    wait();
+}
+
+void EngineSideChain::WorkerThread::run() {
+    mixxx::enableDenormalsAreZero();
+    while (!atomicLoadRelaxed(m_bStop)) {
+        m_samplesAvailable.acquire();
+        // Process everything that has been written so far
+        m_samplesAvailable.tryAcquire(m_samplesAvailable.available());
+
+        int samples_read;
+        while ((samples_read = m_sampleFifo.read(m_pWorkBuffer,
+                        SIDECHAIN_BUFFER_SIZE))) {
+            Trace process("EngineSideChain::WorkerThread::process");
+            m_pWorker->process(m_pWorkBuffer, samples_read);
+        }
+    }
+}
+
 EngineSideChain::EngineSideChain(
         UserSettingsPointer pConfig,
         CSAMPLE* sidechainMix)
@@ -27,7 +95,9 @@ EngineSideChain::EngineSideChain(
           m_bStopThread(false),
           m_sampleFifo(SIDECHAIN_BUFFER_SIZE),
           m_pWorkBuffer(SampleUtil::alloc(SIDECHAIN_BUFFER_SIZE)),
-          m_pSidechainMix(sidechainMix) {
+          m_pSidechainMix(sidechainMix),
+          m_activeWorkers{},
+          m_activeWorkerCount(0) {
     // We use HighPriority to prevent starvation by lower-priority processes (Qt
     // main thread, analysis, etc.). This used to be LowPriority but that is not
     // a suitable choice since we do semi-realtime tasks
@@ -47,8 +117,11 @@ EngineSideChain::~EngineSideChain() {
     wait();
 
     MMutexLocker locker(&m_workerLock);
+    m_activeWorkerCount.store(0, std::memory_order_release);
     while (!m_workers.empty()) {
-        SideChainWorker* pWorker = m_workers.takeLast();
+        std::shared_ptr<WorkerThread> pWorkerThread = m_workers.takeLast();
+        pWorkerThread->stop();
+        SideChainWorker* pWorker = pWorkerThread->worker();
         pWorker->shutdown();
         delete pWorker;
     }
@@ -59,7 +132,34 @@ EngineSideChain::~EngineSideChain() {
 
 void EngineSideChain::addSideChainWorker(SideChainWorker* pWorker) {
     MMutexLocker locker(&m_workerLock);
-    m_workers.append(pWorker);
+    const int workerCount = m_activeWorkerCount.load(std::memory_order_relaxed);
+    VERIFY_OR_DEBUG_ASSERT(workerCount < kMaxWorkerCount) {
+        qWarning() << "EngineSideChain: Too many workers";
+        delete pWorker;
+        return;
+    }
+    m_workers.append(std::make_shared<WorkerThread>(pWorker, m_workers.size() + 1));
+    m_activeWorkers[workerCount] = pWorker;
+    m_activeWorkerCount.store(workerCount + 1, std::memory_order_release);
+}
+
+bool EngineSideChain::isActive() const {
+    const int workerCount = m_activeWorkerCount.load(std::memory_order_acquire);
+    for (int i = 0; i < workerCount; ++i) {
+        if (m_activeWorkers[i]->isActive()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+double EngineSideChain::fifoFillRatio() {
+    double ratio = fillRatio(m_sampleFifo);
+    MMutexLocker locker(&m_workerLock);
+    for (const auto& pWorkerThread : std::as_const(m_workers)) {
+        ratio = std::max(ratio, fillRatio(pWorkerThread->sampleFifo()));
+    }
+    return ratio;
 }
 
 void EngineSideChain::receiveBuffer(const AudioInput& input,
@@ -97,6 +197,8 @@ void EngineSideChain::run() {
     // factor this out somehow), -kousu 2/2009
     unsigned static id = 0;
     QThread::currentThread()->setObjectName(QString("EngineSideChain %1").arg(++id));
+    mixxx::CpuAffinity::applyToCurrentThread(mixxx::CpuAffinity::ThreadRole::Background);
+    mixxx::enableDenormalsAreZero();
     static const QString tag("EngineSideChain");
     Event::start(tag);
     while (!m_bStopThread) {
@@ -113,8 +215,8 @@ void EngineSideChain::run() {
                                                  SIDECHAIN_BUFFER_SIZE))) {
             Trace process("EngineSideChain::process");
             MMutexLocker locker(&m_workerLock);
-            foreach (SideChainWorker* pWorker, m_workers) {
-                pWorker->process(m_pWorkBuffer, samples_read);
+            for (const auto& pWorkerThread : std::as_const(m_workers)) {
+                pWorkerThread->writeSamples(m_pWorkBuffer, samples_read);
             }
         }
 
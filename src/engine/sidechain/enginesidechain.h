@@ -4,6 +4,10 @@
 #include <QMutex>
 #include <QWaitCondition>
 #include <QList>
+#include <QSemaphore>
+#include <array>
+#include <atomic>
+#include <memory>
 
 #include "preferences/usersettings.h"
 #include "soundio/soundmanagerutil.h"
@@ -30,12 +34,50 @@ class EngineSideChain : public QThread, public AudioDestination {
             const CSAMPLE* pBuffer,
             unsigned int iFrames) override;
 
-    // Thread-safe, blocking.
+    // Thread-safe, blocking. Each worker gets a FIFO and a thread of its
+    // own, so a slow worker does not delay the others.
     void addSideChainWorker(SideChainWorker* pWorker);
 
+    // Wait-free, called by the engine callback. Returns false if none of the
+    // workers needs any samples, e.g. while not recording.
+    bool isActive() const;
+
+    // Thread-safe, may block. Returns the fill level between 0 and 1 of the
+    // fullest FIFO, either the one of the sidechain or of a worker.
+    double fifoFillRatio();
+
     static constexpr int SIDECHAIN_BUFFER_SIZE = 65536;
+    static constexpr int kMaxWorkerCount = 8;
 
   private:
+    // Runs a single SideChainWorker
+    class WorkerThread : public QThread {
+      public:
+        WorkerThread(SideChainWorker* pWorker, int index);
+        ~WorkerThread() override;
+
+        // Wait-free, only called by the sidechain thread
+        void writeSamples(const CSAMPLE* pBuffer, int iSamples);
+        void stop();
+
+        SideChainWorker* worker() const {
+            return m_pWorker;
+        }
+        const FIFO<CSAMPLE>& sampleFifo() const {
+            return m_sampleFifo;
+        }
+
+      private:
+        void run() override;
+
+        SideChainWorker* const m_pWorker;
+        const QString m_overrunCounterKey;
+        QAtomicInt m_bStop;
+        FIFO<CSAMPLE> m_sampleFifo;
+        CSAMPLE* m_pWorkBuffer;
+        QSemaphore m_samplesAvailable;
+    };
+
     void run() override;
 
     UserSettingsPointer m_pConfig;
@@ -53,5 +95,9 @@ class EngineSideChain : public QThread, public AudioDestination {
 
     // Sidechain workers registered with EngineSideChain.
     MMutex m_workerLock;
-    QList<SideChainWorker*> m_workers GUARDED_BY(m_workerLock);
+    QList<std::shared_ptr<WorkerThread>> m_workers GUARDED_BY(m_workerLock);
+    // The workers for isActive() that can be accessed without locking.
+    // Workers are only added, the count is published after the pointer.
+    std::array<SideChainWorker*, kMaxWorkerCount> m_activeWorkers;
+    std::atomic<int> m_activeWorkerCount;
 };
@@ -10,5 +10,5 @@ class NetworkInputStreamWorker {
     NetworkInputStreamWorker();
     virtual ~NetworkInputStreamWorker() = default;
 
-    void setSourceFifo(FIFO<CSAMPLE>* pFifo);
+    virtual void setSourceFifo(FIFO<CSAMPLE>* pFifo);
 };
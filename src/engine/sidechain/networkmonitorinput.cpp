@@ -0,0 +1,171 @@
+#include "engine/sidechain/networkmonitorinput.h"
+
+#include <opus/opus.h>
+
+#include <QNetworkDatagram>
+#include <QUdpSocket>
+#include <algorithm>
+#include <vector>
+
+#include "audio/types.h"
+#include "engine/sidechain/networkmonitorjitterbuffer.h"
+#include "engine/sidechain/networkmonitorpacket.h"
+#include "moc_networkmonitorinput.cpp"
+#include "util/assert.h"
+#include "util/compatibility/qatomic.h"
+#include "util/logger.h"
+
+namespace {
+
+const mixxx::Logger kLogger("NetworkMonitorInput");
+
+constexpr int kFrameMillis =
+        NetworkMonitorPacket::kFrameFrames * 1000 / NetworkMonitorPacket::kSampleRate;
+constexpr int kFrameSamples =
+        NetworkMonitorPacket::kFrameFrames * NetworkMonitorPacket::kChannels;
+// The buffer grows if the sender's clock is faster than ours. Packets are
+// dropped when it exceeds the target by this amount.
+constexpr int kMaxExcessPackets = 4;
+constexpr int kPollMillis = 2;
+
+} // namespace
+
+NetworkMonitorInput::NetworkMonitorInput(quint16 port, int jitterBufferMillis)
+        : m_port(port),
+          m_jitterBufferMillis(jitterBufferMillis),
+          m_mainSamplerate(QStringLiteral("[App]"), QStringLiteral("samplerate")),
+          m_outputLatencyMs(QStringLiteral("[App]"), QStringLiteral("output_latency_ms")),
+          m_stopThread(false),
+          m_pSourceFifo(nullptr),
+          m_packetLossPermille(0),
+          m_bufferMicros(0) {
+}
+
+NetworkMonitorInput::~NetworkMonitorInput() {
+    shutdown();
+}
+
+void NetworkMonitorInput::setSourceFifo(FIFO<CSAMPLE>* pFifo) {
+    DEBUG_ASSERT(!isRunning());
+    m_pSourceFifo = pFifo;
+}
+
+void NetworkMonitorInput::shutdown() {
+    m_stopThread = true;
+    wait();
+}
+
+double NetworkMonitorInput::packetLossPercent() const {
+    return atomicLoadRelaxed(m_packetLossPermille) / 10.0;
+}
+
+double NetworkMonitorInput::bufferMillis() const {
+    return atomicLoadRelaxed(m_bufferMicros) / 1000.0;
+}
+
+void NetworkMonitorInput::updateStats(int bufferedFrames, quint64 played, quint64 lost) {
+    atomicStoreRelaxed(m_bufferMicros,
+            static_cast<int>(static_cast<qint64>(bufferedFrames) * 1000000 /
+                    NetworkMonitorPacket::kSampleRate));
+    if (played + lost > 0) {
+        atomicStoreRelaxed(m_packetLossPermille,
+                static_cast<int>(lost * 1000 / (played + lost)));
+    }
+}
+
+void NetworkMonitorInput::run() {
+    QThread::currentThread()->setObjectName(QStringLiteral("NetworkMonitorInput"));
+    kLogger.debug() << "run: Starting thread";
+
+    if (!m_pSourceFifo) {
+        kLogger.warning() << "run: The network sound device has no input. Aborting";
+        return;
+    }
+
+    const auto sampleRate = mixxx::audio::SampleRate::fromDouble(m_mainSamplerate.get());
+    if (sampleRate != mixxx::audio::SampleRate(NetworkMonitorPacket::kSampleRate)) {
+        kLogger.warning() << "run: Opus requires a sample rate of"
+                          << NetworkMonitorPacket::kSampleRate << "Hz, not" << sampleRate;
+        return;
+    }
+
+    int error = OPUS_OK;
+    OpusDecoder* pOpus = opus_decoder_create(NetworkMonitorPacket::kSampleRate,
+            NetworkMonitorPacket::kChannels,
+            &error);
+    if (error != OPUS_OK) {
+        kLogger.warning() << "opus_decoder_create failed:" << opus_strerror(error);
+        return;
+    }
+
+    QUdpSocket socket;
+    if (!socket.bind(QHostAddress::Any, m_port)) {
+        kLogger.warning() << "run: Can't listen on port" << m_port << ":"
+                          << socket.errorString();
+        opus_decoder_destroy(pOpus);
+        return;
+    }
+
+    const int targetPackets = std::max(1, m_jitterBufferMillis / kFrameMillis);
+    NetworkMonitorJitterBuffer jitterBuffer(
+            targetPackets, targetPackets + kMaxExcessPackets);
+    std::vector<CSAMPLE> frameBuffer(kFrameSamples);
+    QByteArray payload;
+
+    while (!atomicLoadRelaxed(m_stopThread)) {
+        socket.waitForReadyRead(kPollMillis);
+        while (socket.hasPendingDatagrams()) {
+            const QNetworkDatagram datagram = socket.receiveDatagram();
+            quint16 sequence;
+            if (NetworkMonitorPacket::decode(datagram.data(), &sequence, &payload)) {
+                jitterBuffer.push(sequence, payload);
+            }
+        }
+
+        // The engine reads a whole audio buffer per callback, so we keep one
+        // buffer and one packet decoded in advance.
+        const int minFifoSamples = kFrameSamples +
+                static_cast<int>(m_outputLatencyMs.get() *
+                        NetworkMonitorPacket::kSampleRate / 1000) *
+                        NetworkMonitorPacket::kChannels;
+        while (m_pSourceFifo->readAvailable() < minFifoSamples &&
+                m_pSourceFifo->writeAvailable() >= kFrameSamples) {
+            const auto status = jitterBuffer.pop(&payload);
+            if (status == NetworkMonitorJitterBuffer::Status::Buffering) {
+                break;
+            }
+            int frames;
+            if (status == NetworkMonitorJitterBuffer::Status::Packet) {
+                frames = opus_decode_float(pOpus,
+                        reinterpret_cast<const unsigned char*>(payload.constData()),
+                        payload.size(),
+                        frameBuffer.data(),
+                        NetworkMonitorPacket::kFrameFrames,
+                        0);
+            } else {
+                // Packet loss concealment
+                frames = opus_decode_float(pOpus,
+                        nullptr,
+                        0,
+                        frameBuffer.data(),
+                        NetworkMonitorPacket::kFrameFrames,
+                        0);
+            }
+            if (frames <= 0) {
+                kLogger.debug() << "opus_decode_float failed:" << opus_strerror(frames);
+                continue;
+            }
+            m_pSourceFifo->write(frameBuffer.data(),
+                    frames * NetworkMonitorPacket::kChannels);
+        }
+
+        updateStats(jitterBuffer.depth() * NetworkMonitorPacket::kFrameFrames +
+                        m_pSourceFifo->readAvailable() / NetworkMonitorPacket::kChannels,
+                jitterBuffer.playedPackets(),
+                jitterBuffer.lostPackets());
+    }
+
+    opus_decoder_destroy(pOpus);
+    updateStats(0, 0, 0);
+    kLogger.debug() << "run: Thread stopped";
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <QThread>
+
+#include "control/pollingcontrolproxy.h"
+#include "engine/sidechain/networkinputstreamworker.h"
+#include "util/fifo.h"
+
+/// Receives the Opus stream of a remote NetworkMonitorOutput and feeds it to
+/// the input of the network sound device, which can be routed to an
+/// auxiliary or microphone channel.
+///
+/// The datagrams pass a NetworkMonitorJitterBuffer, so packets that arrive
+/// late by up to the configured jitter buffer time are still played. Lost
+/// packets are concealed by the Opus decoder.
+class NetworkMonitorInput : public QThread, public NetworkInputStreamWorker {
+    Q_OBJECT
+  public:
+    NetworkMonitorInput(quint16 port, int jitterBufferMillis);
+    ~NetworkMonitorInput() override;
+
+    void setSourceFifo(FIFO<CSAMPLE>* pFifo) override;
+    void shutdown();
+
+    /// Percentage of the packets that were lost or arrived too late to be
+    /// played
+    double packetLossPercent() const;
+    /// Received audio that is waiting to be played, in milliseconds
+    double bufferMillis() const;
+
+  private:
+    void run() override;
+    void updateStats(int bufferedFrames, quint64 played, quint64 lost);
+
+    const quint16 m_port;
+    const int m_jitterBufferMillis;
+    PollingControlProxy m_mainSamplerate;
+    PollingControlProxy m_outputLatencyMs;
+
+    QAtomicInt m_stopThread;
+    FIFO<CSAMPLE>* m_pSourceFifo;
+
+    // Statistics written by our thread, in 1/1000
+    QAtomicInt m_packetLossPermille;
+    QAtomicInt m_bufferMicros;
+};
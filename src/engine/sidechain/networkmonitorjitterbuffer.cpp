@@ -0,0 +1,120 @@
+#include "engine/sidechain/networkmonitorjitterbuffer.h"
+
+#include "util/assert.h"
+
+NetworkMonitorJitterBuffer::NetworkMonitorJitterBuffer(
+        int targetPackets, int maxDepthPackets)
+        : m_targetPackets(targetPackets),
+          m_maxDepthPackets(maxDepthPackets),
+          // Leave room for bursts, before the latency is reduced by pop()
+          m_slots(maxDepthPackets * 2) {
+    DEBUG_ASSERT(targetPackets > 0);
+    DEBUG_ASSERT(maxDepthPackets > targetPackets);
+    reset();
+}
+
+void NetworkMonitorJitterBuffer::reset() {
+    for (Slot& slot : m_slots) {
+        slot.valid = false;
+        slot.payload.clear();
+    }
+    m_started = false;
+    m_playing = false;
+    m_nextSequence = 0;
+    m_newestSequence = 0;
+    m_receivedPackets = 0;
+    m_playedPackets = 0;
+    m_lostPackets = 0;
+    m_latePackets = 0;
+    m_droppedPackets = 0;
+    m_underruns = 0;
+}
+
+void NetworkMonitorJitterBuffer::restart(quint16 sequence) {
+    for (Slot& slot : m_slots) {
+        slot.valid = false;
+        slot.payload.clear();
+    }
+    m_started = true;
+    m_playing = false;
+    m_nextSequence = sequence;
+    m_newestSequence = sequence;
+}
+
+int NetworkMonitorJitterBuffer::depth() const {
+    if (!m_started) {
+        return 0;
+    }
+    return static_cast<qint16>(m_newestSequence - m_nextSequence) + 1;
+}
+
+void NetworkMonitorJitterBuffer::push(quint16 sequence, const QByteArray& payload) {
+    ++m_receivedPackets;
+    if (!m_started) {
+        restart(sequence);
+    }
+
+    const int slotCount = static_cast<int>(m_slots.size());
+    const int offset = static_cast<qint16>(sequence - m_nextSequence);
+    if (offset < 0 && offset > -slotCount) {
+        ++m_latePackets;
+        return;
+    }
+    if (offset < 0 || offset >= slotCount) {
+        // The sender has been restarted or the stream was interrupted for
+        // longer than we can buffer.
+        restart(sequence);
+    }
+
+    Slot& slot = m_slots[sequence % slotCount];
+    if (slot.valid && slot.sequence == sequence) {
+        // duplicate
+        return;
+    }
+    slot.valid = true;
+    slot.sequence = sequence;
+    slot.payload = payload;
+    if (static_cast<qint16>(sequence - m_newestSequence) > 0) {
+        m_newestSequence = sequence;
+    }
+}
+
+NetworkMonitorJitterBuffer::Status NetworkMonitorJitterBuffer::pop(QByteArray* pPayload) {
+    if (!m_started) {
+        return Status::Buffering;
+    }
+    if (!m_playing) {
+        if (depth() < m_targetPackets) {
+            return Status::Buffering;
+        }
+        m_playing = true;
+    }
+    if (depth() <= 0) {
+        ++m_underruns;
+        m_playing = false;
+        return Status::Buffering;
+    }
+
+    const int slotCount = static_cast<int>(m_slots.size());
+    if (depth() > m_maxDepthPackets) {
+        while (depth() > m_targetPackets) {
+            Slot& slot = m_slots[m_nextSequence % slotCount];
+            slot.valid = false;
+            slot.payload.clear();
+            ++m_nextSequence;
+            ++m_droppedPackets;
+        }
+    }
+
+    Slot& slot = m_slots[m_nextSequence % slotCount];
+    const quint16 sequence = m_nextSequence++;
+    if (!slot.valid || slot.sequence != sequence) {
+        ++m_lostPackets;
+        return Status::Lost;
+    }
+    slot.valid = false;
+    pPayload->swap(slot.payload);
+    slot.payload.clear();
+    ++m_playedPackets;
+    return Status::Packet;
+}
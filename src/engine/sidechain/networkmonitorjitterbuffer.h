@@ -0,0 +1,86 @@
+#pragma once
+
+#include <QByteArray>
+#include <QtGlobal>
+#include <vector>
+
+/// Reorders the packets of a network monitoring stream and releases them at
+/// the pace of the receiving engine.
+///
+/// Packets are addressed by their 16 bit sequence number, which wraps around.
+/// Playback starts once targetPackets are buffered. Missing packets are
+/// reported as lost, so the decoder can conceal them. If the sender's clock
+/// runs faster than the receiver's, the buffer grows until it exceeds
+/// maxDepthPackets and the oldest packets are dropped to get back to the
+/// target. If nothing is buffered at all, the buffer refills to the target
+/// before playback continues.
+class NetworkMonitorJitterBuffer {
+  public:
+    enum class Status {
+        Packet,
+        Lost,
+        Buffering,
+    };
+
+    NetworkMonitorJitterBuffer(int targetPackets, int maxDepthPackets);
+
+    void push(quint16 sequence, const QByteArray& payload);
+    Status pop(QByteArray* pPayload);
+    void reset();
+
+    /// Number of packets between the next one to play and the newest
+    /// received one, including missing packets.
+    int depth() const;
+    int targetPackets() const {
+        return m_targetPackets;
+    }
+
+    // Statistics since the last reset()
+    quint64 receivedPackets() const {
+        return m_receivedPackets;
+    }
+    quint64 playedPackets() const {
+        return m_playedPackets;
+    }
+    quint64 lostPackets() const {
+        return m_lostPackets;
+    }
+    /// Packets that arrived after their playback time
+    quint64 latePackets() const {
+        return m_latePackets;
+    }
+    /// Packets dropped to reduce the latency
+    quint64 droppedPackets() const {
+        return m_droppedPackets;
+    }
+    quint64 underruns() const {
+        return m_underruns;
+    }
+
+  private:
+    struct Slot {
+        bool valid = false;
+        quint16 sequence = 0;
+        QByteArray payload;
+    };
+
+    void restart(quint16 sequence);
+
+    const int m_targetPackets;
+    const int m_maxDepthPackets;
+    std::vector<Slot> m_slots;
+
+    bool m_started;
+    bool m_playing;
+    // The next packet to play
+    quint16 m_nextSequence;
+    // The newest packet that has been received
+    quint16 m_newestSequence;
+
+    quint64 m_receivedPackets;
+    quint64 m_playedPackets;
+    quint64 m_lostPackets;
+    quint64 m_latePackets;
+    quint64 m_droppedPackets;
+    quint64 m_underruns;
+};
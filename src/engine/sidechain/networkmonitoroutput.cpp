@@ -0,0 +1,175 @@
+#include "engine/sidechain/networkmonitoroutput.h"
+
+#include <opus/opus.h>
+
+#include <QUdpSocket>
+#include <algorithm>
+
+#include "audio/types.h"
+#include "engine/sidechain/networkmonitorpacket.h"
+#include "moc_networkmonitoroutput.cpp"
+#include "util/compatibility/qatomic.h"
+#include "util/logger.h"
+#include "util/sample.h"
+
+namespace {
+
+const mixxx::Logger kLogger("NetworkMonitorOutput");
+
+constexpr int kFrameSamples =
+        NetworkMonitorPacket::kFrameFrames * NetworkMonitorPacket::kChannels;
+
+} // namespace
+
+NetworkMonitorOutput::NetworkMonitorOutput(const QHostAddress& address,
+        quint16 port,
+        int bitrateKbps)
+        : m_address(address),
+          m_port(port),
+          m_bitrateKbps(bitrateKbps),
+          m_mainSamplerate(QStringLiteral("[App]"), QStringLiteral("samplerate")),
+          m_stopThread(false),
+          m_threadWaiting(false),
+          m_pOpus(nullptr),
+          m_frameBuffer(kFrameSamples),
+          m_frameBufferFill(0),
+          m_packetBuffer(NetworkMonitorPacket::kMaxPayloadSize),
+          m_sequence(0),
+          m_timestamp(0),
+          m_packetsSent(0) {
+}
+
+NetworkMonitorOutput::~NetworkMonitorOutput() {
+    shutdown();
+}
+
+void NetworkMonitorOutput::shutdown() {
+    m_stopThread = true;
+    m_readSema.release();
+    wait();
+}
+
+quint64 NetworkMonitorOutput::packetsSent() const {
+    return atomicLoadRelaxed(m_packetsSent);
+}
+
+void NetworkMonitorOutput::outputAvailable() {
+    m_readSema.release();
+}
+
+void NetworkMonitorOutput::setOutputFifo(QSharedPointer<FIFO<CSAMPLE>> pOutputFifo) {
+    m_pOutputFifo = pOutputFifo;
+}
+
+QSharedPointer<FIFO<CSAMPLE>> NetworkMonitorOutput::getOutputFifo() {
+    return m_pOutputFifo;
+}
+
+bool NetworkMonitorOutput::threadWaiting() {
+    return atomicLoadRelaxed(m_threadWaiting);
+}
+
+void NetworkMonitorOutput::process(const CSAMPLE* pBuffer, const int iBufferSize) {
+    int consumed = 0;
+    while (consumed < iBufferSize) {
+        const int count = std::min(iBufferSize - consumed,
+                kFrameSamples - m_frameBufferFill);
+        SampleUtil::copy(&m_frameBuffer[m_frameBufferFill], pBuffer + consumed, count);
+        m_frameBufferFill += count;
+        consumed += count;
+        if (m_frameBufferFill == kFrameSamples) {
+            sendFrame();
+            m_frameBufferFill = 0;
+        }
+    }
+}
+
+void NetworkMonitorOutput::sendFrame() {
+    const int payloadSize = opus_encode_float(m_pOpus,
+            m_frameBuffer.data(),
+            NetworkMonitorPacket::kFrameFrames,
+            m_packetBuffer.data(),
+            static_cast<opus_int32>(m_packetBuffer.size()));
+    if (payloadSize < 0) {
+        kLogger.warning() << "opus_encode_float failed:" << opus_strerror(payloadSize);
+        return;
+    }
+    const QByteArray datagram = NetworkMonitorPacket::encode(
+            m_sequence, m_timestamp, m_packetBuffer.data(), payloadSize);
+    ++m_sequence;
+    m_timestamp += NetworkMonitorPacket::kFrameFrames;
+    // A lost datagram is concealed by the receiver, so errors are only logged
+    if (m_pSocket->writeDatagram(datagram, m_address, m_port) < 0) {
+        kLogger.debug() << "writeDatagram failed:" << m_pSocket->errorString();
+        return;
+    }
+    m_packetsSent.fetchAndAddRelaxed(1);
+}
+
+void NetworkMonitorOutput::run() {
+    QThread::currentThread()->setObjectName(QStringLiteral("NetworkMonitorOutput"));
+    kLogger.debug() << "run: Starting thread";
+
+    VERIFY_OR_DEBUG_ASSERT(m_pOutputFifo) {
+        kLogger.warning() << "run: FIFO handle is not available. Aborting";
+        setState(NETWORKSTREAMWORKER_STATE_ERROR);
+        return;
+    }
+
+    const auto sampleRate = mixxx::audio::SampleRate::fromDouble(m_mainSamplerate.get());
+    if (sampleRate != mixxx::audio::SampleRate(NetworkMonitorPacket::kSampleRate)) {
+        kLogger.warning() << "run: Opus requires a sample rate of"
+                          << NetworkMonitorPacket::kSampleRate << "Hz, not" << sampleRate;
+        setState(NETWORKSTREAMWORKER_STATE_ERROR);
+        return;
+    }
+
+    int error = OPUS_OK;
+    // The restricted low delay mode has an algorithmic delay of 2.5 ms only
+    m_pOpus = opus_encoder_create(NetworkMonitorPacket::kSampleRate,
+            NetworkMonitorPacket::kChannels,
+            OPUS_APPLICATION_RESTRICTED_LOWDELAY,
+            &error);
+    if (error != OPUS_OK) {
+        kLogger.warning() << "opus_encoder_create failed:" << opus_strerror(error);
+        setState(NETWORKSTREAMWORKER_STATE_ERROR);
+        return;
+    }
+    opus_encoder_ctl(m_pOpus, OPUS_SET_BITRATE(m_bitrateKbps * 1000));
+    opus_encoder_ctl(m_pOpus, OPUS_SET_SIGNAL(OPUS_SIGNAL_MUSIC));
+
+    m_pSocket = std::make_unique<QUdpSocket>();
+    m_frameBufferFill = 0;
+    setState(NETWORKSTREAMWORKER_STATE_CONNECTED);
+    m_threadWaiting = true;
+
+    while (!atomicLoadRelaxed(m_stopThread)) {
+        if (!m_readSema.tryAcquire(1, 1000)) {
+            continue;
+        }
+
+        int readAvailable = m_pOutputFifo->readAvailable();
+        if (readAvailable) {
+            CSAMPLE* dataPtr1;
+            ring_buffer_size_t size1;
+            CSAMPLE* dataPtr2;
+            ring_buffer_size_t size2;
+
+            // We use size1 and size2, so we can ignore the return value
+            (void)m_pOutputFifo->aquireReadRegions(readAvailable, &dataPtr1, &size1,
+                    &dataPtr2, &size2);
+            process(dataPtr1, size1);
+            if (size2 > 0) {
+                process(dataPtr2, size2);
+            }
+            m_pOutputFifo->releaseReadRegions(readAvailable);
+        }
+    }
+
+    m_threadWaiting = false;
+    m_pSocket.reset();
+    opus_encoder_destroy(m_pOpus);
+    m_pOpus = nullptr;
+    setState(NETWORKSTREAMWORKER_STATE_DISCONNECTED);
+    kLogger.debug() << "run: Thread stopped";
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <QHostAddress>
+#include <QSemaphore>
+#include <QSharedPointer>
+#include <QThread>
+#include <memory>
+#include <vector>
+
+#include "control/pollingcontrolproxy.h"
+#include "engine/sidechain/networkoutputstreamworker.h"
+#include "util/fifo.h"
+
+class QUdpSocket;
+struct OpusEncoder;
+
+/// Sends the sidechain mix as a low latency Opus stream over UDP, so a remote
+/// partner can monitor it during back-to-back sessions.
+///
+/// Unlike a broadcast, every 10 ms frame is sent as soon as it is encoded
+/// without any buffering on this side. The receiver is expected to smooth the
+/// network jitter, see NetworkMonitorInput.
+class NetworkMonitorOutput
+        : public QThread, public NetworkOutputStreamWorker {
+    Q_OBJECT
+  public:
+    NetworkMonitorOutput(const QHostAddress& address,
+            quint16 port,
+            int bitrateKbps);
+    ~NetworkMonitorOutput() override;
+
+    // Called from our thread for each chunk of samples read from the output
+    // FIFO.
+    void process(const CSAMPLE* pBuffer, const int iBufferSize) override;
+    // Stops the thread
+    void shutdown() override;
+
+    void outputAvailable() override;
+    void setOutputFifo(QSharedPointer<FIFO<CSAMPLE>> pOutputFifo) override;
+    QSharedPointer<FIFO<CSAMPLE>> getOutputFifo() override;
+    bool threadWaiting() override;
+
+    quint64 packetsSent() const;
+
+  private:
+    void run() override;
+    void sendFrame();
+
+    const QHostAddress m_address;
+    const quint16 m_port;
+    const int m_bitrateKbps;
+    PollingControlProxy m_mainSamplerate;
+
+    QAtomicInt m_stopThread;
+    QAtomicInt m_threadWaiting;
+    QSemaphore m_readSema;
+    QSharedPointer<FIFO<CSAMPLE>> m_pOutputFifo;
+
+    // Owned by our thread while it is running
+    OpusEncoder* m_pOpus;
+    std::unique_ptr<QUdpSocket> m_pSocket;
+    std::vector<CSAMPLE> m_frameBuffer;
+    int m_frameBufferFill;
+    std::vector<unsigned char> m_packetBuffer;
+    quint16 m_sequence;
+    quint32 m_timestamp;
+
+    QAtomicInteger<quint64> m_packetsSent;
+};
+
+typedef QSharedPointer<NetworkMonitorOutput> NetworkMonitorOutputPtr;
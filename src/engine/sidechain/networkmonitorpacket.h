@@ -0,0 +1,55 @@
+#pragma once
+
+#include <QByteArray>
+#include <QtEndian>
+#include <cstring>
+
+/// The UDP datagrams of a network monitoring stream. Each one carries a
+/// single Opus packet of kFrameFrames stereo frames at 48 kHz behind a
+/// 12 byte header:
+///
+///   0  magic "MXM1"
+///   4  sequence number, big-endian, wraps around
+///   6  reserved, zero
+///   8  timestamp of the first frame, big-endian, wraps around
+class NetworkMonitorPacket {
+  public:
+    static constexpr int kSampleRate = 48000;
+    static constexpr int kChannels = 2;
+    // 10 ms, the shortest Opus frame that is still efficient for music
+    static constexpr int kFrameFrames = 480;
+    static constexpr int kHeaderSize = 12;
+    // Enough for 510 kbit/s, the maximum Opus bitrate
+    static constexpr int kMaxPayloadSize = 1275;
+    static constexpr quint32 kMagic = 0x4d584d31;
+
+    static QByteArray encode(quint16 sequence,
+            quint32 timestamp,
+            const unsigned char* pPayload,
+            int payloadSize) {
+        QByteArray datagram(kHeaderSize + payloadSize, '\0');
+        uchar* pData = reinterpret_cast<uchar*>(datagram.data());
+        qToBigEndian<quint32>(kMagic, pData);
+        qToBigEndian<quint16>(sequence, pData + 4);
+        qToBigEndian<quint32>(timestamp, pData + 8);
+        memcpy(pData + kHeaderSize, pPayload, payloadSize);
+        return datagram;
+    }
+
+    /// Returns false if the datagram is not part of a monitoring stream.
+    static bool decode(const QByteArray& datagram,
+            quint16* pSequence,
+            QByteArray* pPayload) {
+        if (datagram.size() <= kHeaderSize ||
+                datagram.size() > kHeaderSize + kMaxPayloadSize) {
+            return false;
+        }
+        const uchar* pData = reinterpret_cast<const uchar*>(datagram.constData());
+        if (qFromBigEndian<quint32>(pData) != kMagic) {
+            return false;
+        }
+        *pSequence = qFromBigEndian<quint16>(pData + 4);
+        *pPayload = datagram.mid(kHeaderSize);
+        return true;
+    }
+};
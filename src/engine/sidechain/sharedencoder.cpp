@@ -0,0 +1,229 @@
+#include "engine/sidechain/sharedencoder.h"
+
+#include <algorithm>
+
+#include "encoder/encoderbroadcastsettings.h"
+#include "engine/sidechain/sharedresampler.h"
+#include "recording/defs_recording.h"
+#include "util/assert.h"
+#include "util/logger.h"
+
+namespace {
+
+const mixxx::Logger kLogger("SharedEncoder");
+
+constexpr mixxx::audio::SampleRate kMaxStreamSampleRate = mixxx::audio::SampleRate(48000);
+
+} // namespace
+
+bool SharedEncoder::Output::waitForPending(int timeoutMillis) {
+    if (!m_appended.tryAcquire(1, timeoutMillis)) {
+        return false;
+    }
+    // All pending data is taken at once
+    m_appended.tryAcquire(m_appended.available());
+    return true;
+}
+
+QByteArray SharedEncoder::Output::takePending(bool* pOverflow) {
+    QMutexLocker locker(&m_mutex);
+    *pOverflow = m_overflow;
+    m_overflow = false;
+    QByteArray pending;
+    pending.swap(m_pending);
+    return pending;
+}
+
+int SharedEncoder::Output::pendingBytes() const {
+    QMutexLocker locker(&m_mutex);
+    return m_pending.size();
+}
+
+void SharedEncoder::Output::append(const unsigned char* data, int len) {
+    {
+        QMutexLocker locker(&m_mutex);
+        if (m_pending.size() + len > kMaxPendingBytes) {
+            // The network thread is stuck, keep the newest data only.
+            m_pending.clear();
+            m_overflow = true;
+        }
+        m_pending.append(reinterpret_cast<const char*>(data), len);
+    }
+    m_appended.release();
+}
+
+SharedEncoder::SharedEncoder() = default;
+
+SharedEncoder::~SharedEncoder() {
+    if (m_pResampler) {
+        // Afterwards the resampler does not call encodeResampled() anymore
+        m_pResampler->removeEncoder(this);
+    }
+    // Deleting the encoder may call write()
+    QMutexLocker locker(&m_mutex);
+    m_outputs.clear();
+    m_pEncoder.reset();
+}
+
+int SharedEncoder::initEncoder(BroadcastProfilePtr pProfile,
+        mixxx::audio::SampleRate sampleRate,
+        QString* pUserErrorMessage) {
+    QMutexLocker locker(&m_mutex);
+    EncoderSettingsPointer pBroadcastSettings =
+            std::make_shared<EncoderBroadcastSettings>(pProfile);
+    m_pEncoder = EncoderFactory::getFactory().createEncoder(pBroadcastSettings, this);
+    if (!m_pEncoder) {
+        return -1;
+    }
+    const int ret = m_pEncoder->initEncoder(sampleRate, pUserErrorMessage);
+    if (ret < 0) {
+        m_pEncoder.reset();
+    }
+    return ret;
+}
+
+void SharedEncoder::setResampler(std::shared_ptr<SharedResampler> pResampler) {
+    DEBUG_ASSERT(!m_pResampler);
+    DEBUG_ASSERT(outputCount() == 0);
+    m_pResampler = std::move(pResampler);
+    m_pResampler->addEncoder(this);
+}
+
+std::shared_ptr<SharedEncoder::Output> SharedEncoder::addOutput() {
+    auto pOutput = std::make_shared<Output>();
+    QMutexLocker locker(&m_mutex);
+    m_outputs.push_back(pOutput);
+    return pOutput;
+}
+
+void SharedEncoder::removeOutput(const std::shared_ptr<Output>& pOutput) {
+    QMutexLocker locker(&m_mutex);
+    // If the encoding output is removed, the next one takes over
+    m_outputs.erase(std::remove(m_outputs.begin(), m_outputs.end(), pOutput),
+            m_outputs.end());
+}
+
+void SharedEncoder::encodeBuffer(
+        const Output* pOutput, const CSAMPLE* pBuffer, int iBufferSize) {
+    QMutexLocker locker(&m_mutex);
+    if (!m_pEncoder || m_outputs.empty() || m_outputs.front().get() != pOutput) {
+        return;
+    }
+    if (m_pResampler) {
+        // The resampler calls encodeResampled() of all its encoders, which
+        // lock their mutex
+        locker.unlock();
+        m_pResampler->process(this, pBuffer, iBufferSize);
+        return;
+    }
+    m_pEncoder->encodeBuffer(pBuffer, iBufferSize);
+    // the encoded frames are received by the write() callback.
+}
+
+void SharedEncoder::encodeResampled(const CSAMPLE* pBuffer, int iBufferSize) {
+    QMutexLocker locker(&m_mutex);
+    if (!m_pEncoder) {
+        return;
+    }
+    m_pEncoder->encodeBuffer(pBuffer, iBufferSize);
+}
+
+int SharedEncoder::outputCount() const {
+    QMutexLocker locker(&m_mutex);
+    return static_cast<int>(m_outputs.size());
+}
+
+void SharedEncoder::write(const unsigned char* header,
+        const unsigned char* body,
+        int headerLen,
+        int bodyLen) {
+    for (const auto& pOutput : m_outputs) {
+        if (headerLen > 0) {
+            pOutput->append(header, headerLen);
+        }
+        if (bodyLen > 0) {
+            pOutput->append(body, bodyLen);
+        }
+    }
+}
+
+// These are not used for streaming, but the interface requires them
+qint64 SharedEncoder::tell() {
+    return -1;
+}
+
+// These are not used for streaming, but the interface requires them
+void SharedEncoder::seek(qint64 pos) {
+    Q_UNUSED(pos)
+}
+
+// These are not used for streaming, but the interface requires them
+qint64 SharedEncoder::filelen() {
+    return 0;
+}
+
+std::shared_ptr<SharedEncoder> SharedEncoderPool::acquire(BroadcastProfilePtr pProfile,
+        mixxx::audio::SampleRate sampleRate,
+        QString* pUserErrorMessage) {
+    const QString format = pProfile->getFormat();
+    const mixxx::audio::SampleRate encoderRate = encoderSampleRate(format, sampleRate);
+    const QString key = QStringLiteral("%1/%2/%3/%4")
+                                .arg(format,
+                                        QString::number(pProfile->getBitrate()),
+                                        QString::number(pProfile->getChannels()),
+                                        QString::number(encoderRate.value()));
+    const bool shareable = isShareable(format);
+
+    QMutexLocker locker(&m_mutex);
+    if (shareable) {
+        auto it = m_encoders.find(key);
+        if (it != m_encoders.end()) {
+            std::shared_ptr<SharedEncoder> pEncoder = it->second.lock();
+            if (pEncoder) {
+                kLogger.debug() << pProfile->getProfileName()
+                                << "shares the encoder" << key;
+                return pEncoder;
+            }
+            m_encoders.erase(it);
+        }
+    }
+
+    auto pEncoder = std::make_shared<SharedEncoder>();
+    if (pEncoder->initEncoder(pProfile, encoderRate, pUserErrorMessage) < 0) {
+        return nullptr;
+    }
+    if (encoderRate != sampleRate) {
+        const QString resamplerKey = QStringLiteral("%1/%2").arg(
+                QString::number(sampleRate.value()),
+                QString::number(encoderRate.value()));
+        std::shared_ptr<SharedResampler> pResampler = m_resamplers[resamplerKey].lock();
+        if (!pResampler) {
+            pResampler = std::make_shared<SharedResampler>(sampleRate, encoderRate);
+            m_resamplers[resamplerKey] = pResampler;
+        }
+        kLogger.debug() << pProfile->getProfileName()
+                        << "is resampled from" << sampleRate << "to" << encoderRate;
+        pEncoder->setResampler(std::move(pResampler));
+    }
+    if (shareable) {
+        m_encoders[key] = pEncoder;
+    }
+    return pEncoder;
+}
+
+// static
+bool SharedEncoderPool::isShareable(const QString& format) {
+    return format == ENCODING_MP3 ||
+            format == ENCODING_AAC ||
+            format == ENCODING_HEAAC ||
+            format == ENCODING_HEAACV2;
+}
+
+// static
+mixxx::audio::SampleRate SharedEncoderPool::encoderSampleRate(
+        const QString& format, mixxx::audio::SampleRate sampleRate) {
+    if (format == ENCODING_OPUS || sampleRate > kMaxStreamSampleRate) {
+        return kMaxStreamSampleRate;
+    }
+    return sampleRate;
+}
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <QByteArray>
+#include <QMutex>
+#include <QSemaphore>
+#include <QString>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "audio/types.h"
+#include "encoder/encoder.h"
+#include "encoder/encodercallback.h"
+#include "preferences/broadcastprofile.h"
+
+class SharedResampler;
+
+/// An encoder whose output is shared by all broadcast connections that
+/// stream the same format, bitrate, channels and sample rate.
+///
+/// Every connection thread pushes the sidechain audio it receives, but only
+/// the first attached output (the "encoding output") actually encodes it.
+/// The encoded data is appended to the bounded pending buffer of each
+/// attached output and sent by the network threads of the connections, so a
+/// slow server does not block the encoder or the other mounts.
+class SharedEncoder : public EncoderCallback {
+  public:
+    static constexpr int kMaxPendingBytes = 491520; // 10 s mp3 @ 192 kbit/s
+
+    class Output {
+      public:
+        /// Waits until encoded data has been appended or the timeout has
+        /// passed. Returns false on timeout.
+        bool waitForPending(int timeoutMillis);
+        /// Returns and clears the encoded data that has not been sent yet.
+        /// Sets *pOverflow if data had to be dropped, because the connection
+        /// did not keep up with the encoder.
+        QByteArray takePending(bool* pOverflow);
+        int pendingBytes() const;
+
+      private:
+        friend class SharedEncoder;
+
+        void append(const unsigned char* data, int len);
+
+        mutable QMutex m_mutex;
+        QSemaphore m_appended;
+        QByteArray m_pending;
+        bool m_overflow = false;
+    };
+
+    SharedEncoder();
+    ~SharedEncoder() override;
+
+    /// Creates the encoder for audio at the sample rate. Returns a negative
+    /// value on failure like Encoder::initEncoder().
+    int initEncoder(BroadcastProfilePtr pProfile,
+            mixxx::audio::SampleRate sampleRate,
+            QString* pUserErrorMessage);
+
+    /// Converts the audio that is passed to encodeBuffer() to the sample
+    /// rate of the encoder. Must be set before any output is added.
+    void setResampler(std::shared_ptr<SharedResampler> pResampler);
+
+    std::shared_ptr<Output> addOutput();
+    void removeOutput(const std::shared_ptr<Output>& pOutput);
+
+    /// Encodes the buffer if pOutput is the encoding output, otherwise the
+    /// samples have already been encoded from another connection's FIFO and
+    /// are dropped.
+    void encodeBuffer(const Output* pOutput, const CSAMPLE* pBuffer, int iBufferSize);
+    /// Encodes audio at the sample rate of the encoder, called by the
+    /// SharedResampler
+    void encodeResampled(const CSAMPLE* pBuffer, int iBufferSize);
+
+    int outputCount() const;
+
+    // EncoderCallback, called by m_pEncoder with m_mutex locked
+    void write(const unsigned char* header,
+            const unsigned char* body,
+            int headerLen,
+            int bodyLen) override;
+    qint64 tell() override;
+    void seek(qint64 pos) override;
+    qint64 filelen() override;
+
+  private:
+    mutable QMutex m_mutex;
+    EncoderPointer m_pEncoder;
+    std::shared_ptr<SharedResampler> m_pResampler;
+    std::vector<std::shared_ptr<Output>> m_outputs;
+};
+
+/// Hands out SharedEncoders to the broadcast connections. Only formats that
+/// can be joined at any frame are shared. Ogg streams (Vorbis, Opus) start
+/// with header pages that each server has to receive, so every connection
+/// gets an encoder of its own.
+///
+/// Encoders that need a different sample rate than the engine share a
+/// SharedResampler for each sample rate, even if they encode different
+/// formats.
+class SharedEncoderPool {
+  public:
+    std::shared_ptr<SharedEncoder> acquire(BroadcastProfilePtr pProfile,
+            mixxx::audio::SampleRate sampleRate,
+            QString* pUserErrorMessage);
+
+    static bool isShareable(const QString& format);
+
+    /// The sample rate at which the format is streamed, if the engine runs
+    /// at the given sample rate. Opus only supports 48 kHz and streams
+    /// above 48 kHz only waste bandwidth, some encoders do not even
+    /// support them.
+    static mixxx::audio::SampleRate encoderSampleRate(const QString& format,
+            mixxx::audio::SampleRate sampleRate);
+
+  private:
+    QMutex m_mutex;
+    std::map<QString, std::weak_ptr<SharedEncoder>> m_encoders;
+    std::map<QString, std::weak_ptr<SharedResampler>> m_resamplers;
+};
+
+typedef std::shared_ptr<SharedEncoderPool> SharedEncoderPoolPointer;
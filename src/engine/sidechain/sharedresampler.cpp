@@ -0,0 +1,41 @@
+#include "engine/sidechain/sharedresampler.h"
+
+#include <algorithm>
+
+#include "engine/engine.h"
+#include "engine/sidechain/sharedencoder.h"
+
+SharedResampler::SharedResampler(mixxx::audio::SampleRate inputSampleRate,
+        mixxx::audio::SampleRate outputSampleRate)
+        : m_resampler(inputSampleRate, outputSampleRate, mixxx::kEngineChannelCount) {
+}
+
+void SharedResampler::addEncoder(SharedEncoder* pEncoder) {
+    QMutexLocker locker(&m_mutex);
+    m_encoders.push_back(pEncoder);
+}
+
+void SharedResampler::removeEncoder(SharedEncoder* pEncoder) {
+    QMutexLocker locker(&m_mutex);
+    // If the driving encoder is removed, the next one takes over
+    m_encoders.erase(std::remove(m_encoders.begin(), m_encoders.end(), pEncoder),
+            m_encoders.end());
+}
+
+void SharedResampler::process(
+        const SharedEncoder* pEncoder, const CSAMPLE* pBuffer, int iBufferSize) {
+    QMutexLocker locker(&m_mutex);
+    if (m_encoders.empty() || m_encoders.front() != pEncoder) {
+        return;
+    }
+    const int inputFrames = iBufferSize / mixxx::kEngineChannelCount;
+    m_output.resize(m_resampler.maxOutputFrames(inputFrames) * mixxx::kEngineChannelCount);
+    const auto outputFrames = m_resampler.process(pBuffer, inputFrames, m_output.data());
+    if (outputFrames <= 0) {
+        return;
+    }
+    for (SharedEncoder* pTarget : m_encoders) {
+        pTarget->encodeResampled(m_output.data(),
+                static_cast<int>(outputFrames) * mixxx::kEngineChannelCount);
+    }
+}
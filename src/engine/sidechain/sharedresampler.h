@@ -0,0 +1,42 @@
+#pragma once
+
+#include <QMutex>
+#include <vector>
+
+#include "audio/types.h"
+#include "util/polyphaseresampler.h"
+
+class SharedEncoder;
+
+/// Converts the sidechain audio to the sample rate of one or more broadcast
+/// encoders, e.g. for Opus streams at 48 kHz while the engine runs at
+/// 44.1 kHz.
+///
+/// Every connection thread pushes the audio it receives through its
+/// encoder, but like in SharedEncoder only the first attached encoder
+/// drives the conversion. The converted audio is encoded by all attached
+/// encoders, so several mounts in different formats cost one conversion.
+class SharedResampler {
+  public:
+    SharedResampler(mixxx::audio::SampleRate inputSampleRate,
+            mixxx::audio::SampleRate outputSampleRate);
+
+    mixxx::audio::SampleRate outputSampleRate() const {
+        return m_resampler.outputSampleRate();
+    }
+
+    void addEncoder(SharedEncoder* pEncoder);
+    void removeEncoder(SharedEncoder* pEncoder);
+
+    /// Converts the buffer if pEncoder is the first attached encoder and
+    /// passes the result to all attached encoders. Otherwise the samples
+    /// have already been converted from another connection's FIFO and are
+    /// dropped.
+    void process(const SharedEncoder* pEncoder, const CSAMPLE* pBuffer, int iBufferSize);
+
+  private:
+    QMutex m_mutex;
+    mixxx::PolyphaseResampler m_resampler;
+    std::vector<CSAMPLE> m_output;
+    std::vector<SharedEncoder*> m_encoders;
+};
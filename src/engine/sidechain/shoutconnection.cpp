@@ -1,8 +1,10 @@
 #include "engine/sidechain/shoutconnection.h"
 
+#include <QMutexLocker>
 #include <QRegularExpression>
 #include <QTextCodec>
 #include <QUrl>
+#include <algorithm>
 
 // These includes are only required by ignoreSigpipe, which is unix-only
 #ifndef __WINDOWS__
@@ -20,11 +22,6 @@
 #endif
 
 #include "broadcast/defs_broadcast.h"
-#include "encoder/encoder.h"
-#include "encoder/encoderbroadcastsettings.h"
-#ifdef __OPUS__
-#include "encoder/encoderopus.h"
-#endif
 #include "errordialoghandler.h"
 #include "mixer/playerinfo.h"
 #include "moc_shoutconnection.cpp"
@@ -37,6 +34,10 @@
 namespace {
 
 constexpr int kConnectRetries = 30;
+// The reconnect period is doubled after each failed attempt up to this
+// limit, unless the configured period is already longer
+constexpr double kMaxReconnectPeriod = 60.0; // s
+constexpr int kMaxReconnectPeriodDoublings = 6;
 constexpr int kMaxNetworkCache = 491520; // 10 s mp3 @ 192 kbit/s
 // Shoutcast default receive buffer 1048576 and autodumpsourcetime 30 s
 // http://wiki.shoutcast.com/wiki/SHOUTcast_DNAS_Server_2
@@ -50,7 +51,8 @@ const mixxx::Logger kLogger("ShoutConnection");
 } // namespace
 
 ShoutConnection::ShoutConnection(BroadcastProfilePtr profile,
-        UserSettingsPointer pConfig)
+        UserSettingsPointer pConfig,
+        SharedEncoderPoolPointer pEncoderPool)
         : m_pTextCodec(nullptr),
           m_pMetaData(),
           m_pShout(nullptr),
@@ -60,7 +62,9 @@ ShoutConnection::ShoutConnection(BroadcastProfilePtr profile,
           m_iShoutFailures(0),
           m_pConfig(pConfig),
           m_pProfile(profile),
+          m_pEncoderPool(pEncoderPool),
           m_encoder(nullptr),
+          m_stopEncoderThread(false),
           m_mainSamplerate(QStringLiteral("[App]"), QStringLiteral("samplerate")),
           m_broadcastEnabled(BROADCAST_PREF_KEY, "enabled"),
           m_custom_metadata(false),
@@ -130,6 +134,8 @@ ShoutConnection::~ShoutConnection() {
        qWarning() << "ShoutOutput::~ShoutOutput(): Thread didn't die.\
        Ignored but file a bug report if problems rise!";
     }
+
+    releaseEncoder();
 }
 
 bool ShoutConnection::isConnected() {
@@ -190,10 +196,9 @@ void ShoutConnection::updateFromPreferences() {
 
     setState(NETWORKSTREAMWORKER_STATE_BUSY);
 
-    // Delete m_encoder if it has been initialized (with maybe) different bitrate.
-    // delete m_encoder calls write() check if it will be exit early
+    // Release m_encoder if it has been initialized (with maybe) different bitrate.
     DEBUG_ASSERT(m_iShoutStatus != SHOUTERR_CONNECTED);
-    m_encoder.reset();
+    releaseEncoder();
 
     m_format_is_mp3 = false;
     m_format_is_ov = false;
@@ -405,24 +410,8 @@ void ShoutConnection::updateFromPreferences() {
         return;
     }
 
-    if (m_format_is_ov && mainSamplerate == 96000) {
-        errorDialog(tr("Broadcasting at 96 kHz with Ogg Vorbis is not currently "
-                       "supported. Please try a different sample rate or switch "
-                       "to a different encoding."),
-                    tr("See https://github.com/mixxxdj/mixxx/issues/5701 for more "
-                       "information."));
-        return;
-    }
-
-#ifdef __OPUS__
-    if (m_format_is_opus && mainSamplerate != EncoderOpus::getMainSampleRate()) {
-        errorDialog(
-            EncoderOpus::getInvalidSamplerateMessage(),
-            tr("Unsupported sample rate")
-        );
-        return;
-    }
-#endif
+    // Streams at sample rates that the encoder does not support, like Opus
+    // at 44.1 kHz or Vorbis at 96 kHz, are resampled by the encoder pool.
 
     if (shout_set_audio_info(
             m_pShout, SHOUT_AI_BITRATE,
@@ -457,27 +446,19 @@ void ShoutConnection::updateFromPreferences() {
         return;
     }
 
-    // Initialize m_encoder
-    EncoderSettingsPointer pBroadcastSettings =
-            std::make_shared<EncoderBroadcastSettings>(m_pProfile);
-    m_encoder = EncoderFactory::getFactory().createEncoder(
-                    pBroadcastSettings, this);
-
+    // Initialize m_encoder, or join the encoder of another connection that
+    // streams the same format
     QString userErrorMsg;
-    int ret = -1;
-    if (m_encoder) {
-        ret = m_encoder->initEncoder(mainSamplerate, &userErrorMsg);
+    std::shared_ptr<SharedEncoder> pEncoder =
+            m_pEncoderPool->acquire(m_pProfile, mainSamplerate, &userErrorMsg);
+    {
+        QMutexLocker locker(&m_encoderMutex);
+        m_encoder = pEncoder;
     }
-
-    // TODO(XXX): Use mixxx::audio::SampleRate instead of int in initEncoder
-    if (ret < 0) {
-        // delete m_encoder calls write() make sure it will be exit early
-        DEBUG_ASSERT(m_iShoutStatus != SHOUTERR_CONNECTED);
-        m_encoder.reset();
-
+    if (!pEncoder) {
         setState(NETWORKSTREAMWORKER_STATE_ERROR);
 
-        m_lastErrorStr = pBroadcastSettings->getFormat() + QChar(' ') +
+        m_lastErrorStr = m_pProfile->getFormat() + QChar(' ') +
                 QObject::tr(" encoder failure") + QChar('\n');
         if (userErrorMsg.isEmpty()) {
             m_lastErrorStr.append(QObject::tr(
@@ -599,8 +580,11 @@ bool ShoutConnection::processConnect() {
 
             m_retryCount = 0;
 
-            if(m_pOutputFifo->readAvailable()) {
-            	m_pOutputFifo->flushReadData(m_pOutputFifo->readAvailable());
+            // Samples that were received while not connected have already
+            // been dropped by the encoder thread.
+            {
+                QMutexLocker locker(&m_encoderMutex);
+                m_pEncoderOutput = m_encoder->addOutput();
             }
             m_threadWaiting = true;
 
@@ -630,9 +614,8 @@ bool ShoutConnection::processConnect() {
 
     // no connection, clean up
     shout_close(m_pShout);
-    // delete m_encoder calls write() check if it will be exit early
     DEBUG_ASSERT(m_iShoutStatus != SHOUTERR_CONNECTED);
-    m_encoder.reset();
+    releaseEncoder();
     if (m_pProfile->getEnabled()) {
         setStatus(BroadcastProfile::STATUS_FAILURE);
     } else {
@@ -655,18 +638,40 @@ bool ShoutConnection::processDisconnect() {
         emit broadcastDisconnected();
         disconnected = true;
     }
-    // delete m_encoder calls write() check if it will be exit early
     DEBUG_ASSERT(m_iShoutStatus != SHOUTERR_CONNECTED);
-    m_encoder.reset();
+    releaseEncoder();
     return disconnected;
 }
 
+void ShoutConnection::releaseEncoder() {
+    QMutexLocker locker(&m_encoderMutex);
+    if (m_pEncoderOutput) {
+        DEBUG_ASSERT(m_encoder);
+        m_encoder->removeOutput(m_pEncoderOutput);
+        m_pEncoderOutput.reset();
+    }
+    m_encoder.reset();
+}
+
+std::shared_ptr<SharedEncoder::Output> ShoutConnection::encoderOutput() {
+    QMutexLocker locker(&m_encoderMutex);
+    return m_pEncoderOutput;
+}
+
+double ShoutConnection::sendQueueFill() {
+    const std::shared_ptr<SharedEncoder::Output> pEncoderOutput = encoderOutput();
+    if (!pEncoderOutput) {
+        return 0.0;
+    }
+    return static_cast<double>(pEncoderOutput->pendingBytes()) /
+            SharedEncoder::kMaxPendingBytes;
+}
+
 void ShoutConnection::write(const unsigned char* header, const unsigned char* body,
                             int headerLen, int bodyLen) {
     setFunctionCode(7);
 	if (!m_pShout || m_iShoutStatus != SHOUTERR_CONNECTED) {
-        // This happens when the decoder calls flush() and the connection is
-        // already down
+        // This happens when a previous write has lost the connection
         return;
     }
 
@@ -690,23 +695,6 @@ void ShoutConnection::write(const unsigned char* header, const unsigned char* bo
         }
     }
 }
-// These are not used for streaming, but the interface requires them
-int ShoutConnection::tell() {
-    if (!m_pShout) {
-        return -1;
-    }
-    return -1;
-}
-// These are not used for streaming, but the interface requires them
-void ShoutConnection::seek(int pos) {
-    Q_UNUSED(pos)
-    return;
-}
-// These are not used for streaming, but the interface requires them
-int ShoutConnection::filelen() {
-    return 0;
-}
-
 bool ShoutConnection::writeSingle(const unsigned char* data, size_t len) {
     setFunctionCode(8);
     int ret = shout_send_raw(m_pShout, data, len);
@@ -738,30 +726,43 @@ void ShoutConnection::process(const CSAMPLE* pBuffer, const int iBufferSize) {
         return;
     }
 
-    setState(NETWORKSTREAMWORKER_STATE_BUSY);
-
-    // If we aren't connected, bail.
-    if (m_iShoutStatus != SHOUTERR_CONNECTED) {
-        return;
-    }
-
-    // Save a copy of the smart pointer in a local variable
+    // Save a copy of the smart pointers in local variables
     // to prevent race conditions when resetting the member
-    // pointer while disconnecting in the worker thread!
-    const EncoderPointer pEncoder = m_encoder;
-
-    // If we are connected, encode the samples.
-    if (iBufferSize > 0 && pEncoder) {
+    // pointers while disconnecting in the network thread!
+    std::shared_ptr<SharedEncoder> pEncoder;
+    std::shared_ptr<SharedEncoder::Output> pEncoderOutput;
+    {
+        QMutexLocker locker(&m_encoderMutex);
+        pEncoder = m_encoder;
+        pEncoderOutput = m_pEncoderOutput;
+    }
+
+    // If we are connected, encode the samples. If the encoder is shared,
+    // only one of the connections encodes and all of them send the result.
+    if (iBufferSize > 0 && pEncoder && pEncoderOutput) {
         setFunctionCode(6);
-        pEncoder->encodeBuffer(pBuffer, iBufferSize);
-        // the encoded frames are received by the write() callback.
+        pEncoder->encodeBuffer(pEncoderOutput.get(), pBuffer, iBufferSize);
+        // the encoded frames are sent by sendPending() in the network thread
     }
+}
 
-    // Check if track metadata has changed and if so, update.
-    if (metaDataHasChanged()) {
-        updateMetaData();
+void ShoutConnection::sendPending(
+        const std::shared_ptr<SharedEncoder::Output>& pEncoderOutput) {
+    bool overflow = false;
+    const QByteArray encoded = pEncoderOutput->takePending(&overflow);
+    if (overflow) {
+        m_lastErrorStr = tr("Network cache overflow");
+        tryReconnect();
+        return;
+    }
+    if (!encoded.isEmpty()) {
+        setState(NETWORKSTREAMWORKER_STATE_BUSY);
+        write(nullptr,
+                reinterpret_cast<const unsigned char*>(encoded.constData()),
+                0,
+                encoded.size());
+        setState(NETWORKSTREAMWORKER_STATE_READY);
     }
-    setState(NETWORKSTREAMWORKER_STATE_READY);
 }
 
 bool ShoutConnection::metaDataHasChanged() {
@@ -943,7 +944,11 @@ bool ShoutConnection::waitForRetry() {
     if (m_retryCount == 1) {
         delay = m_reconnectFirstDelay;
     } else {
-        delay = m_reconnectPeriod;
+        // Back off exponentially, so a relay that is down for a longer time
+        // is not flooded with connection attempts
+        const int doublings = std::min(m_retryCount - 2, kMaxReconnectPeriodDoublings);
+        delay = std::min(m_reconnectPeriod * (1 << doublings),
+                std::max(m_reconnectPeriod, kMaxReconnectPeriod));
     }
 
     if (delay > 0) {
@@ -1013,7 +1018,10 @@ void ShoutConnection::run() {
         return;
     }
 
+    startEncoderThread();
+
     if (!processConnect()) {
+        stopEncoderThread();
         errorDialog(tr("Can't connect to streaming server"),
                 m_lastErrorStr + "\n\n" +
                         tr("Please check your connection to the Internet and "
@@ -1040,13 +1048,56 @@ void ShoutConnection::run() {
 
         setFunctionCode(1);
         incRunCount();
-        if(!m_readSema.tryAcquire(1, 1000)) {
+        const std::shared_ptr<SharedEncoder::Output> pEncoderOutput = encoderOutput();
+        VERIFY_OR_DEBUG_ASSERT(pEncoderOutput) {
+            setStatus(BroadcastProfile::STATUS_FAILURE);
+            continue;
+        }
+        if (!pEncoderOutput->waitForPending(1000)) {
+            continue;
+        }
+
+        setFunctionCode(3);
+        sendPending(pEncoderOutput);
+
+        // Check if track metadata has changed and if so, update.
+        if (m_iShoutStatus == SHOUTERR_CONNECTED && metaDataHasChanged()) {
+            updateMetaData();
+        }
+    }
+
+    stopEncoderThread();
+    kLogger.debug() << "run: Thread stopped";
+}
+
+void ShoutConnection::startEncoderThread() {
+    DEBUG_ASSERT(!m_pEncoderThread);
+    m_stopEncoderThread = false;
+    m_pEncoderThread.reset(QThread::create([this] { runEncoder(); }));
+    m_pEncoderThread->setObjectName(
+            QString("ShoutEncoder '%1'").arg(m_pProfile->getProfileName()));
+    m_pEncoderThread->start(QThread::HighPriority);
+}
+
+void ShoutConnection::stopEncoderThread() {
+    if (!m_pEncoderThread) {
+        return;
+    }
+    m_stopEncoderThread = true;
+    m_readSema.release();
+    m_pEncoderThread->wait();
+    m_pEncoderThread.reset();
+}
+
+void ShoutConnection::runEncoder() {
+    kLogger.debug() << "runEncoder: Starting thread";
+    while (!atomicLoadRelaxed(m_stopEncoderThread)) {
+        if (!m_readSema.tryAcquire(1, 1000)) {
             continue;
         }
 
         int readAvailable = m_pOutputFifo->readAvailable();
         if (readAvailable) {
-            setFunctionCode(3);
             CSAMPLE* dataPtr1;
             ring_buffer_size_t size1;
             CSAMPLE* dataPtr2;
@@ -1056,7 +1107,8 @@ void ShoutConnection::run() {
             (void)m_pOutputFifo->aquireReadRegions(readAvailable, &dataPtr1, &size1,
                     &dataPtr2, &size2);
 
-            // Push frames to the encoder.
+            // Push frames to the encoder. Without a connection they are
+            // dropped.
             process(dataPtr1, size1);
             if (size2 > 0) {
                 process(dataPtr2, size2);
@@ -1065,8 +1117,7 @@ void ShoutConnection::run() {
             m_pOutputFifo->releaseReadRegions(readAvailable);
         }
     }
-
-    kLogger.debug() << "run: Thread stopped";
+    kLogger.debug() << "runEncoder: Thread stopped";
 }
 
 #ifndef __WINDOWS__
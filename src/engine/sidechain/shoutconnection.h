@@ -8,10 +8,10 @@
 #include <QThread>
 #include <QVector>
 #include <QWaitCondition>
+#include <memory>
 
 #include "control/pollingcontrolproxy.h"
-#include "encoder/encoder.h"
-#include "encoder/encodercallback.h"
+#include "engine/sidechain/sharedencoder.h"
 #include "preferences/broadcastprofile.h"
 #include "preferences/usersettings.h"
 #include "track/track_decl.h"
@@ -25,30 +25,22 @@ typedef struct _util_dict shout_metadata_t;
 class QTextCodec;
 
 class ShoutConnection
-        : public QThread, public EncoderCallback, public NetworkOutputStreamWorker {
+        : public QThread, public NetworkOutputStreamWorker {
     Q_OBJECT
   public:
-    ShoutConnection(BroadcastProfilePtr profile, UserSettingsPointer pConfig);
+    ShoutConnection(BroadcastProfilePtr profile,
+            UserSettingsPointer pConfig,
+            SharedEncoderPoolPointer pEncoderPool);
     ~ShoutConnection() override;
 
-    // This is called by the Engine implementation for each sample. Encode and
-    // send the stream, as well as check for metadata changes.
+    // This is called from the encoder thread for each chunk of samples read
+    // from the output FIFO. Encodes the samples, which are sent to the server
+    // by the network thread.
     void process(const CSAMPLE* pBuffer, const int iBufferSize) override;
 
     void shutdown() override {
     }
 
-    // Called by the encoder in method 'encodebuffer()' to flush the stream to
-    // the server.
-    void write(const unsigned char* header, const unsigned char* body,
-               int headerLen, int bodyLen) override;
-    // gets stream position
-    int tell() override;
-    // sets stream position
-    void seek(int pos) override;
-    // gets stream length
-    int filelen() override;
-
     /** connects to server **/
     bool serverConnect();
     bool isConnected();
@@ -58,8 +50,15 @@ class ShoutConnection
     void setOutputFifo(QSharedPointer<FIFO<CSAMPLE>> pOutputFifo) override;
     QSharedPointer<FIFO<CSAMPLE>> getOutputFifo() override;
     bool threadWaiting() override;
+    // The network thread, which connects, sends the encoded stream and
+    // reconnects. Encoding happens on a separate encoder thread, so a stalled
+    // server can not overrun the output FIFO.
     void run() override;
 
+    /// Fill level of the encoded data queue between the encoder and the
+    /// network thread, 0.0 (empty) to 1.0 (overflowing)
+    double sendQueueFill();
+
     BroadcastProfilePtr profile() {
         return m_pProfile;
     }
@@ -78,6 +77,20 @@ class ShoutConnection
   private:
     bool processConnect();
     bool processDisconnect();
+    // Detaches from the shared encoder, which is deleted with the last
+    // connection using it.
+    void releaseEncoder();
+    std::shared_ptr<SharedEncoder::Output> encoderOutput();
+
+    void runEncoder();
+    void startEncoderThread();
+    void stopEncoderThread();
+    // Sends the data that has been encoded since the last call
+    void sendPending(const std::shared_ptr<SharedEncoder::Output>& pEncoderOutput);
+
+    // Flushes the encoded stream to the server.
+    void write(const unsigned char* header, const unsigned char* body,
+               int headerLen, int bodyLen);
 
     // Update the libshout struct with info from the current broadcast profile.
     void updateFromPreferences();
@@ -119,7 +132,15 @@ class ShoutConnection
     long m_iShoutFailures;
     UserSettingsPointer m_pConfig;
     BroadcastProfilePtr m_pProfile;
-    EncoderPointer m_encoder;
+    SharedEncoderPoolPointer m_pEncoderPool;
+    // Set by the network thread and used by the encoder thread
+    QMutex m_encoderMutex;
+    std::shared_ptr<SharedEncoder> m_encoder;
+    // Only set while connected, so the encoder is driven by connected
+    // streams only
+    std::shared_ptr<SharedEncoder::Output> m_pEncoderOutput;
+    std::unique_ptr<QThread> m_pEncoderThread;
+    QAtomicInt m_stopEncoderThread;
     PollingControlProxy m_mainSamplerate;
     PollingControlProxy m_broadcastEnabled;
     // static metadata according to prefereneces
@@ -8,4 +8,10 @@ class SideChainWorker {
     virtual ~SideChainWorker() = default;
     virtual void process(const CSAMPLE* pBuffer, const int iBufferSize) = 0;
     virtual void shutdown() = 0;
+    // Whether the worker currently needs samples. The engine skips the
+    // record/broadcast mix while no worker is active. Called by the engine
+    // callback, so it must be wait-free.
+    virtual bool isActive() const {
+        return true;
+    }
 };
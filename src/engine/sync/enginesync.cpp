@@ -141,7 +141,7 @@ void EngineSync::activateFollower(Syncable* pSyncable) {
         m_pLeaderSyncable = nullptr;
     }
 
-    pSyncable->setSyncMode(SyncMode::Follower);
+    changeSyncMode(pSyncable, SyncMode::Follower);
 }
 
 void EngineSync::activateLeader(Syncable* pSyncable, SyncMode leaderType) {
@@ -162,7 +162,7 @@ void EngineSync::activateLeader(Syncable* pSyncable, SyncMode leaderType) {
     if (m_pLeaderSyncable == pSyncable) {
         // Already leader, update the leader type.
         if (m_pLeaderSyncable->getSyncMode() != leaderType) {
-            m_pLeaderSyncable->setSyncMode(leaderType);
+            changeSyncMode(m_pLeaderSyncable, leaderType);
         }
         // nothing else to do
         return;
@@ -172,11 +172,11 @@ void EngineSync::activateLeader(Syncable* pSyncable, SyncMode leaderType) {
     Syncable* pOldChannelLeader = m_pLeaderSyncable;
     m_pLeaderSyncable = nullptr;
     if (pOldChannelLeader) {
-        pOldChannelLeader->setSyncMode(SyncMode::Follower);
+        changeSyncMode(pOldChannelLeader, SyncMode::Follower);
     }
 
     m_pLeaderSyncable = pSyncable;
-    pSyncable->setSyncMode(leaderType);
+    changeSyncMode(pSyncable, leaderType);
 
     if (m_pLeaderSyncable != m_pInternalClock) {
         // the internal clock gets activated and its values are overwritten with this
@@ -198,13 +198,13 @@ void EngineSync::deactivateSync(Syncable* pSyncable) {
     }
 
     // Notifications happen after-the-fact.
-    pSyncable->setSyncMode(SyncMode::None);
+    changeSyncMode(pSyncable, SyncMode::None);
 
     bool bSyncDeckExists = syncDeckExists();
     if (pSyncable != m_pInternalClock && !bSyncDeckExists) {
         // Deactivate the internal clock if there are no more sync decks left.
         m_pLeaderSyncable = nullptr;
-        m_pInternalClock->setSyncMode(SyncMode::None);
+        changeSyncMode(m_pInternalClock, SyncMode::None);
         return;
     }
 
@@ -583,6 +583,24 @@ void EngineSync::addSyncableDeck(Syncable* pSyncable) {
         return;
     }
     m_syncables.append(pSyncable);
+    // Prevent allocations when the synchronized Syncables are updated
+    // on the audio thread
+    m_synchronizedSyncables.reserve(m_syncables.size());
+    updateSynchronizedSyncables();
+}
+
+void EngineSync::changeSyncMode(Syncable* pSyncable, SyncMode mode) {
+    pSyncable->setSyncMode(mode);
+    updateSynchronizedSyncables();
+}
+
+void EngineSync::updateSynchronizedSyncables() {
+    m_synchronizedSyncables.clear();
+    for (Syncable* pSyncable : std::as_const(m_syncables)) {
+        if (pSyncable->isSynchronized()) {
+            m_synchronizedSyncables.push_back(pSyncable);
+        }
+    }
 }
 
 void EngineSync::onCallbackStart(mixxx::audio::SampleRate sampleRate, int bufferSize) {
@@ -607,8 +625,8 @@ Syncable* EngineSync::getSyncableForGroup(const QString& group) {
 }
 
 bool EngineSync::syncDeckExists() const {
-    for (const auto& pSyncable : std::as_const(m_syncables)) {
-        if (pSyncable->isSynchronized() && pSyncable->getBaseBpm().isValid()) {
+    for (Syncable* pSyncable : m_synchronizedSyncables) {
+        if (pSyncable->getBaseBpm().isValid()) {
             return true;
         }
     }
@@ -640,9 +658,8 @@ void EngineSync::updateLeaderBpm(Syncable* pSource, mixxx::Bpm bpm) {
     if (pSource != m_pInternalClock) {
         m_pInternalClock->updateLeaderBpm(bpm);
     }
-    foreach (Syncable* pSyncable, m_syncables) {
-        if (pSyncable == pSource ||
-                !pSyncable->isSynchronized()) {
+    for (Syncable* pSyncable : m_synchronizedSyncables) {
+        if (pSyncable == pSource) {
             continue;
         }
         pSyncable->updateLeaderBpm(bpm);
@@ -653,9 +670,8 @@ void EngineSync::updateLeaderInstantaneousBpm(Syncable* pSource, mixxx::Bpm bpm)
     if (pSource != m_pInternalClock) {
         m_pInternalClock->updateInstantaneousBpm(bpm);
     }
-    foreach (Syncable* pSyncable, m_syncables) {
-        if (pSyncable == pSource ||
-                !pSyncable->isSynchronized()) {
+    for (Syncable* pSyncable : m_synchronizedSyncables) {
+        if (pSyncable == pSource) {
             continue;
         }
         pSyncable->updateInstantaneousBpm(bpm);
@@ -671,9 +687,8 @@ void EngineSync::updateLeaderBeatDistance(Syncable* pSource, double beatDistance
     if (pSource != m_pInternalClock) {
         m_pInternalClock->updateLeaderBeatDistance(beatDistance);
     }
-    foreach (Syncable* pSyncable, m_syncables) {
-        if (pSyncable == pSource ||
-                !pSyncable->isSynchronized()) {
+    for (Syncable* pSyncable : m_synchronizedSyncables) {
+        if (pSyncable == pSource) {
             continue;
         }
         pSyncable->updateLeaderBeatDistance(beatDistance);
@@ -693,13 +708,10 @@ void EngineSync::reinitLeaderParams(Syncable* pSource) {
         // explicit Leader and we should not initialize the beat distance.  Take it from the
         // internal clock instead, because that will be up to date with the playing deck(s).
         bool playingSyncables = false;
-        for (Syncable* pSyncable : std::as_const(m_syncables)) {
+        for (Syncable* pSyncable : m_synchronizedSyncables) {
             if (pSyncable == pSource) {
                 continue;
             }
-            if (!pSyncable->isSynchronized()) {
-                continue;
-            }
             if (pSyncable->isPlaying()) {
                 playingSyncables = true;
                 break;
@@ -726,21 +738,14 @@ void EngineSync::reinitLeaderParams(Syncable* pSource) {
     if (pSource != m_pInternalClock) {
         m_pInternalClock->reinitLeaderParams(beatDistance, baseBpm, bpm);
     }
-    foreach (Syncable* pSyncable, m_syncables) {
-        if (!pSyncable->isSynchronized()) {
-            continue;
-        }
+    for (Syncable* pSyncable : m_synchronizedSyncables) {
         pSyncable->reinitLeaderParams(beatDistance, baseBpm, bpm);
     }
 }
 
 Syncable* EngineSync::getUniquePlayingSyncedDeck() const {
     Syncable* onlyPlaying = nullptr;
-    for (Syncable* pSyncable : m_syncables) {
-        if (!pSyncable->isSynchronized()) {
-            continue;
-        }
-
+    for (Syncable* pSyncable : m_synchronizedSyncables) {
         if (pSyncable->isPlaying()) {
             if (!onlyPlaying) {
                 onlyPlaying = pSyncable;
@@ -2,6 +2,8 @@
 
 #include <gtest/gtest_prod.h>
 
+#include <vector>
+
 #include "engine/sync/syncable.h"
 #include "preferences/usersettings.h"
 
@@ -100,6 +102,11 @@ class EngineSync : public SyncableListener {
     /// Unsets all sync state on a Syncable.
     void deactivateSync(Syncable* pSyncable);
 
+    /// Sets the sync mode of a Syncable and keeps track of the
+    /// synchronized Syncables.
+    void changeSyncMode(Syncable* pSyncable, SyncMode mode);
+    void updateSynchronizedSyncables();
+
     /// This utility method returns true if it finds a deck not in SyncMode::None.
     bool syncDeckExists() const;
 
@@ -167,4 +174,8 @@ class EngineSync : public SyncableListener {
     Syncable* m_pLeaderSyncable;
     /// The list of all Syncables registered via addSyncableDeck.
     QList<Syncable*> m_syncables;
+    /// The synchronized Syncables of m_syncables in the same order. The
+    /// leader updates on every callback only visit these instead of
+    /// querying the sync mode of every idle deck and sampler.
+    std::vector<Syncable*> m_synchronizedSyncables;
 };
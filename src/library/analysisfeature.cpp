@@ -2,6 +2,7 @@
 
 #include <QList>
 #include <QtDebug>
+#include <algorithm>
 
 #include "analyzer/analyzerscheduledtrack.h"
 #include "controllers/keyboard/keyboardeventfilter.h"
@@ -19,12 +20,11 @@ const mixxx::Logger kLogger("AnalysisFeature");
 
 const QString kViewName = QStringLiteral("Analysis");
 
-// Utilize all available cores for batch analysis of tracks
-const int kNumberOfAnalyzerThreads = math_max(1, QThread::idealThreadCount());
+const ConfigKey kAnalyzerPipelineConfigKey =
+        ConfigKey(QStringLiteral("[Library]"), QStringLiteral("AnalyzerPipeline"));
 
-inline
-int numberOfAnalyzerThreads() {
-    return kNumberOfAnalyzerThreads;
+bool isAnalyzerPipelineEnabled(const UserSettingsPointer& pConfig) {
+    return pConfig->getValue<bool>(kAnalyzerPipelineConfigKey, false);
 }
 
 inline
@@ -39,6 +39,9 @@ AnalyzerModeFlags getAnalyzerModeFlags(
     if (pConfig->getValue<bool>(ConfigKey("[Library]", "EnableWaveformGenerationWithAnalysis"), true)) {
         modeFlags |= AnalyzerModeFlags::WithWaveform;
     }
+    if (isAnalyzerPipelineEnabled(pConfig)) {
+        modeFlags |= AnalyzerModeFlags::Pipelined;
+    }
     return static_cast<AnalyzerModeFlags>(modeFlags);
 }
 
@@ -50,6 +53,7 @@ AnalysisFeature::AnalysisFeature(
         : LibraryFeature(pLibrary, pConfig, QStringLiteral("prepare")),
           m_baseTitle(tr("Analyze")),
           m_pTrackAnalysisScheduler(TrackAnalysisScheduler::NullPointer()),
+          m_queuedTrackCount(0),
           m_pSidebarModel(make_parented<TreeItemModel>(this)),
           m_pAnalysisView(nullptr),
           m_title(m_baseTitle) {
@@ -131,11 +135,13 @@ void AnalysisFeature::activate() {
 
 void AnalysisFeature::analyzeTracks(const QList<AnalyzerScheduledTrack>& tracks) {
     if (!m_pTrackAnalysisScheduler) {
-        const int numAnalyzerThreads = numberOfAnalyzerThreads();
+        const bool pipelined = isAnalyzerPipelineEnabled(m_pConfig);
+        const int numAnalyzerThreads =
+                TrackAnalysisScheduler::defaultWorkerThreadCount(pipelined);
         kLogger.info()
                 << "Starting analysis using"
                 << numAnalyzerThreads
-                << "analyzer threads";
+                << (pipelined ? "pipelined analyzer threads" : "analyzer threads");
         m_pTrackAnalysisScheduler = m_pLibrary->createTrackAnalysisScheduler(
                 numAnalyzerThreads,
                 getAnalyzerModeFlags(m_pConfig));
@@ -198,6 +204,7 @@ void AnalysisFeature::onTrackAnalysisSchedulerProgress(
     if (!m_pTrackAnalysisScheduler) {
         return; // inactive
     }
+    m_queuedTrackCount = std::max(totalTracksCount - currentTrackNumber, 0);
     if (totalTracksCount > 0) {
         setTitleProgress(currentTrackNumber, totalTracksCount);
     } else {
@@ -218,6 +225,7 @@ void AnalysisFeature::onTrackAnalysisSchedulerFinished() {
         // for creating the queue with its worker threads are acceptable.
         m_pTrackAnalysisScheduler.reset();
     }
+    m_queuedTrackCount = 0;
     resetTitle();
     emit analysisActive(false);
 }
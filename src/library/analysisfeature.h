@@ -32,6 +32,11 @@ class AnalysisFeature : public LibraryFeature {
     TreeItemModel* sidebarModel() const override;
     void refreshLibraryModels();
 
+    /// The number of tracks that wait for the batch analysis
+    int queuedTrackCount() const {
+        return m_queuedTrackCount;
+    }
+
   signals:
     void analysisActive(bool bActive);
 
@@ -60,6 +65,7 @@ class AnalysisFeature : public LibraryFeature {
     const QString m_baseTitle;
 
     TrackAnalysisScheduler::Pointer m_pTrackAnalysisScheduler;
+    int m_queuedTrackCount;
 
     parented_ptr<TreeItemModel> m_pSidebarModel;
     DlgAnalysis* m_pAnalysisView;
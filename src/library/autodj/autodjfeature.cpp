@@ -139,6 +139,11 @@ void AutoDJFeature::bindLibraryWidget(
             &AutoDJProcessor::randomTrackRequested,
             this,
             &AutoDJFeature::slotRandomQueue);
+    // The next tracks in the queue are analyzed ahead of their transitions
+    connect(m_pAutoDJProcessor,
+            &AutoDJProcessor::analyzeTracks,
+            m_pLibrary,
+            &Library::analyzeTracks);
     connect(m_pAutoDJView,
             &DlgAutoDJ::addRandomTrackButton,
             this,
@@ -14,13 +14,27 @@
 namespace {
 const char* kTransitionPreferenceName = "Transition";
 const char* kTransitionModePreferenceName = "TransitionMode";
+const char* kAnalysisLookaheadPreferenceName = "AnalysisLookahead";
 constexpr double kTransitionPreferenceDefault = 10.0;
+// The number of tracks at the top of the queue that are prepared
+constexpr int kAnalysisLookaheadPreferenceDefault = 3;
 constexpr double kKeepPosition = -1.0;
 
 // A track needs to be longer than two callbacks to not stop AutoDJ
 constexpr double kMinimumTrackDurationSec = 0.2;
 
 constexpr bool sDebug = false;
+
+// Analyzers that are disabled in the preferences do not provide their
+// results, such tracks are scheduled again which is cheap for the
+// analyzers that are done.
+bool isAnalyzedForAutoDJ(const Track& track) {
+    return track.getBeats() &&
+            track.getReplayGain().hasRatio() &&
+            track.findCueByType(mixxx::CueType::Intro) &&
+            track.findCueByType(mixxx::CueType::Outro);
+}
+
 } // anonymous namespace
 
 DeckAttributes::DeckAttributes(int index,
@@ -124,6 +138,14 @@ AutoDJProcessor::AutoDJProcessor(
                                                  "mixxx.db.model.autodj");
     m_pAutoDJTableModel->selectPlaylist(iAutoDJPlaylistId);
     m_pAutoDJTableModel->select();
+    connect(m_pAutoDJTableModel,
+            &QAbstractItemModel::modelReset,
+            this,
+            &AutoDJProcessor::prepareNextTracks);
+    connect(m_pAutoDJTableModel,
+            &QAbstractItemModel::rowsInserted,
+            this,
+            &AutoDJProcessor::prepareNextTracks);
 
     m_pShufflePlaylist = new ControlPushButton(
             ConfigKey("[AutoDJ]", "shuffle_playlist"));
@@ -568,6 +590,7 @@ AutoDJProcessor::AutoDJError AutoDJProcessor::toggleAutoDJ(bool enable) {
             }
         }
         emitAutoDJStateChanged(m_eState);
+        prepareNextTracks();
     } else { // Disable Auto DJ
         m_pEnabledAutoDJ->setAndConfirm(0.0);
         qDebug() << "Auto DJ disabled";
@@ -579,6 +602,7 @@ AutoDJProcessor::AutoDJError AutoDJProcessor::toggleAutoDJ(bool enable) {
         for (const auto& pDeck : std::as_const(m_decks)) {
             pDeck->disconnect(this);
         }
+        m_preparedTrackIds.clear();
         emitAutoDJStateChanged(m_eState);
     }
     return ADJ_OK;
@@ -963,6 +987,7 @@ bool AutoDJProcessor::removeTrackFromTopOfQueue(TrackPointer pTrack) {
     }
 
     maybeFillRandomTracks();
+    prepareNextTracks();
     return true;
 }
 
@@ -979,6 +1004,45 @@ void AutoDJProcessor::maybeFillRandomTracks() {
     }
 }
 
+void AutoDJProcessor::prepareNextTracks() {
+    if (m_eState == ADJ_DISABLED) {
+        return;
+    }
+    const int lookahead = m_pConfig->getValue(
+            ConfigKey(kConfigKey, kAnalysisLookaheadPreferenceName),
+            kAnalysisLookaheadPreferenceDefault);
+    const int rowCount = math_min(lookahead, m_pAutoDJTableModel->rowCount());
+
+    QSet<TrackId> nextTrackIds;
+    QList<AnalyzerScheduledTrack> tracks;
+    for (int row = 0; row < rowCount; ++row) {
+        const QModelIndex index = m_pAutoDJTableModel->index(row, 0);
+        const TrackId trackId = m_pAutoDJTableModel->getTrackId(index);
+        if (!trackId.isValid()) {
+            continue;
+        }
+        nextTrackIds.insert(trackId);
+        if (m_preparedTrackIds.contains(trackId)) {
+            continue;
+        }
+        const TrackPointer pTrack = m_pAutoDJTableModel->getTrack(index);
+        if (pTrack && isAnalyzedForAutoDJ(*pTrack)) {
+            continue;
+        }
+        tracks.append(AnalyzerScheduledTrack(trackId,
+                AnalyzerTrack::Options(),
+                AnalyzerScheduledTrack::Priority::AutoDJ));
+    }
+    // A track that leaves the lookahead, e.g. by shuffling, is prepared
+    // again when it comes back
+    m_preparedTrackIds = nextTrackIds;
+
+    if (!tracks.isEmpty()) {
+        qDebug() << "Auto DJ prepares the analysis of" << tracks.size() << "tracks";
+        emit analyzeTracks(tracks);
+    }
+}
+
 void AutoDJProcessor::playerPlayChanged(DeckAttributes* thisDeck, bool playing) {
     if constexpr (sDebug) {
         qDebug() << this << "playerPlayChanged" << thisDeck->group << playing;
@@ -1,8 +1,11 @@
 #pragma once
 
+#include <QList>
 #include <QObject>
+#include <QSet>
 #include <QString>
 
+#include "analyzer/analyzerscheduledtrack.h"
 #include "audio/frame.h"
 #include "control/controlproxy.h"
 #include "engine/channels/enginechannel.h"
@@ -206,6 +209,7 @@ class AutoDJProcessor : public QObject {
     void autoDJError(AutoDJProcessor::AutoDJError error);
     void transitionTimeChanged(int time);
     void randomTrackRequested(int tracksToAdd);
+    void analyzeTracks(const QList<AnalyzerScheduledTrack>& tracks);
 
   private slots:
     void crossfaderChanged(double value);
@@ -278,6 +282,12 @@ class AutoDJProcessor : public QObject {
     // present.
     bool removeTrackFromTopOfQueue(TrackPointer pTrack);
     void maybeFillRandomTracks();
+
+    // Schedules the analysis of the next tracks in the queue with a high
+    // priority, so that their beats, gain and intro/outro cues are known
+    // before they are loaded.
+    void prepareNextTracks();
+
     UserSettingsPointer m_pConfig;
     PlaylistTableModel* m_pAutoDJTableModel;
 
@@ -288,6 +298,9 @@ class AutoDJProcessor : public QObject {
 
     QList<DeckAttributes*> m_decks;
 
+    // The tracks within the lookahead that have been prepared
+    QSet<TrackId> m_preparedTrackIds;
+
     ControlProxy* m_pCOCrossfader;
     ControlProxy* m_pCOCrossfaderReverse;
 
@@ -1,5 +1,6 @@
 #include "library/basesqltablemodel.h"
 
+#include <QFutureWatcher>
 #include <QUrl>
 #include <QtDebug>
 #include <algorithm>
@@ -31,6 +32,10 @@ const bool sDebug = false;
 constexpr int kIdColumn = 0;
 constexpr int kMaxSortColumns = 3;
 
+// The number of ranges of removed and inserted rows above which all rows
+// are replaced at once instead
+constexpr int kMaxRowRangesToUpdate = 64;
+
 // Constant for getModelSetting(name)
 const QString COLUMNS_SORTING = QStringLiteral("ColumnsSorting");
 
@@ -45,10 +50,13 @@ BaseSqlTableModel::BaseSqlTableModel(
         : BaseTrackTableModel(parent, pTrackCollectionManager, settingsNamespace),
           m_pTrackCollectionManager(pTrackCollectionManager),
           m_database(pTrackCollectionManager->internalCollection()->database()),
-          m_bInitialized(false) {
+          m_bInitialized(false),
+          m_metadataColumnCount(0),
+          m_asyncSelectGeneration(0) {
 }
 
 BaseSqlTableModel::~BaseSqlTableModel() {
+    cancelAsyncSelect();
 }
 
 void BaseSqlTableModel::initHeaderProperties() {
@@ -158,20 +166,22 @@ void BaseSqlTableModel::initSortColumnMapping() {
 }
 
 void BaseSqlTableModel::clearRows() {
-    DEBUG_ASSERT(m_rowInfo.empty() == m_trackIdToRows.empty());
-    DEBUG_ASSERT(m_rowInfo.size() >= m_trackIdToRows.size());
-    if (!m_rowInfo.isEmpty()) {
-        beginRemoveRows(QModelIndex(), 0, m_rowInfo.size() - 1);
-        m_rowInfo.clear();
+    DEBUG_ASSERT(m_rowTrackIds.size() == m_trackIdToRows.size());
+    if (!m_rowTrackIds.isEmpty()) {
+        beginRemoveRows(QModelIndex(), 0, m_rowTrackIds.size() - 1);
+        m_rowTrackIds.clear();
+        m_rowMetadata.clear();
         m_trackIdToRows.clear();
         endRemoveRows();
     }
-    DEBUG_ASSERT(m_rowInfo.isEmpty());
+    DEBUG_ASSERT(m_rowTrackIds.isEmpty());
+    DEBUG_ASSERT(m_rowMetadata.isEmpty());
     DEBUG_ASSERT(m_trackIdToRows.isEmpty());
 }
 
 void BaseSqlTableModel::replaceRows(
-        QVector<RowInfo>&& rows,
+        QVector<TrackId>&& rowTrackIds,
+        QVector<QVariant>&& rowMetadata,
         TrackId2Rows&& trackIdToRows) {
     // NOTE(uklotzde): Use r-value references for parameters here, because
     // conceptually those parameters should replace the corresponding internal
@@ -180,18 +190,195 @@ void BaseSqlTableModel::replaceRows(
     // behind the scenes. Moving would be more efficient, although implicit
     // sharing meets all requirements. If Qt will ever add move support for
     // its container types in the future this code becomes even more efficient.
-    DEBUG_ASSERT(rows.empty() == trackIdToRows.empty());
-    DEBUG_ASSERT(rows.size() >= trackIdToRows.size());
-    if (rows.isEmpty()) {
+    DEBUG_ASSERT(rowTrackIds.size() == trackIdToRows.size());
+    DEBUG_ASSERT(rowMetadata.size() == rowTrackIds.size() * m_metadataColumnCount);
+    if (rowTrackIds.isEmpty()) {
         clearRows();
     } else {
-        beginInsertRows(QModelIndex(), 0, rows.size() - 1);
-        m_rowInfo = rows;
+        beginInsertRows(QModelIndex(), 0, rowTrackIds.size() - 1);
+        m_rowTrackIds = rowTrackIds;
+        m_rowMetadata = rowMetadata;
         m_trackIdToRows = trackIdToRows;
         endInsertRows();
     }
 }
 
+void BaseSqlTableModel::updateRows(
+        QVector<TrackId>&& rowTrackIds,
+        QVector<QVariant>&& rowMetadata,
+        TrackId2Rows&& trackIdToRows) {
+    DEBUG_ASSERT(rowTrackIds.size() == trackIdToRows.size());
+    DEBUG_ASSERT(rowMetadata.size() == rowTrackIds.size() * m_metadataColumnCount);
+    if (m_rowTrackIds.isEmpty() || rowTrackIds.isEmpty() ||
+            m_rowMetadata.size() != m_rowTrackIds.size() * m_metadataColumnCount) {
+        // Nothing to preserve or the columns have been replaced
+        clearRows();
+        replaceRows(
+                std::move(rowTrackIds),
+                std::move(rowMetadata),
+                std::move(trackIdToRows));
+        return;
+    }
+
+    // Rows are matched by their track id. Tracks that are contained
+    // multiple times, e.g. in history playlists, are matched in the
+    // order of their occurrence.
+    QHash<TrackId, int> newCounts;
+    newCounts.reserve(rowTrackIds.size());
+    for (const auto& trackId : std::as_const(rowTrackIds)) {
+        ++newCounts[trackId];
+    }
+    QHash<TrackId, int> keptCounts;
+    keptCounts.reserve(m_rowTrackIds.size());
+    QVector<bool> isKeptRow(m_rowTrackIds.size(), false);
+    int removedRanges = 0;
+    for (int row = 0; row < m_rowTrackIds.size(); ++row) {
+        int& keptCount = keptCounts[m_rowTrackIds[row]];
+        if (keptCount < newCounts.value(m_rowTrackIds[row])) {
+            ++keptCount;
+            isKeptRow[row] = true;
+        } else if (row == 0 || isKeptRow[row - 1]) {
+            ++removedRanges;
+        }
+    }
+    QHash<TrackId, int> occurrences;
+    occurrences.reserve(rowTrackIds.size());
+    QVector<bool> isInsertedRow(rowTrackIds.size(), false);
+    int insertedRanges = 0;
+    for (int row = 0; row < rowTrackIds.size(); ++row) {
+        if (occurrences[rowTrackIds[row]]++ >= keptCounts.value(rowTrackIds[row])) {
+            isInsertedRow[row] = true;
+            if (row == 0 || !isInsertedRow[row - 1]) {
+                ++insertedRanges;
+            }
+        }
+    }
+    if (removedRanges + insertedRanges > kMaxRowRangesToUpdate) {
+        // The results have little in common with the current rows, e.g.
+        // for a new search query, and many small ranges would stall the
+        // view more than replacing all rows.
+        clearRows();
+        replaceRows(
+                std::move(rowTrackIds),
+                std::move(rowMetadata),
+                std::move(trackIdToRows));
+        return;
+    }
+
+    // The multi-hash is only consistent with the rows again at the end
+    m_trackIdToRows.clear();
+
+    // Remove ranges of rows back to front, so the indices of the
+    // remaining ranges stay valid
+    for (int lastRow = m_rowTrackIds.size() - 1; lastRow >= 0; --lastRow) {
+        if (isKeptRow[lastRow]) {
+            continue;
+        }
+        int firstRow = lastRow;
+        while (firstRow > 0 && !isKeptRow[firstRow - 1]) {
+            --firstRow;
+        }
+        const int count = lastRow - firstRow + 1;
+        beginRemoveRows(QModelIndex(), firstRow, lastRow);
+        m_rowTrackIds.remove(firstRow, count);
+        m_rowMetadata.remove(firstRow * m_metadataColumnCount, count * m_metadataColumnCount);
+        endRemoveRows();
+        lastRow = firstRow;
+    }
+
+    // Move the remaining rows into the new order, if it has changed,
+    // e.g. after sorting by another column. The view keeps the
+    // selection when the persistent indices are moved with the rows.
+    QVector<TrackId> keptTrackIds;
+    keptTrackIds.reserve(m_rowTrackIds.size());
+    for (int row = 0; row < rowTrackIds.size(); ++row) {
+        if (!isInsertedRow[row]) {
+            keptTrackIds.push_back(rowTrackIds[row]);
+        }
+    }
+    DEBUG_ASSERT(keptTrackIds.size() == m_rowTrackIds.size());
+    if (keptTrackIds != m_rowTrackIds) {
+        QHash<TrackId, QVector<int>> keptRowsByTrackId;
+        keptRowsByTrackId.reserve(keptTrackIds.size());
+        for (int row = keptTrackIds.size() - 1; row >= 0; --row) {
+            keptRowsByTrackId[keptTrackIds[row]].push_back(row);
+        }
+        QVector<int> movedRows(m_rowTrackIds.size());
+        QVector<QVariant> movedMetadata(m_rowMetadata.size());
+        for (int row = 0; row < m_rowTrackIds.size(); ++row) {
+            QVector<int>& keptRows = keptRowsByTrackId[m_rowTrackIds[row]];
+            const int movedRow = keptRows.takeLast();
+            movedRows[row] = movedRow;
+            std::copy(m_rowMetadata.cbegin() + row * m_metadataColumnCount,
+                    m_rowMetadata.cbegin() + (row + 1) * m_metadataColumnCount,
+                    movedMetadata.begin() + movedRow * m_metadataColumnCount);
+        }
+        emit layoutAboutToBeChanged();
+        m_rowTrackIds = std::move(keptTrackIds);
+        m_rowMetadata = std::move(movedMetadata);
+        const QModelIndexList fromIndices = persistentIndexList();
+        QModelIndexList toIndices;
+        toIndices.reserve(fromIndices.size());
+        for (const auto& fromIndex : fromIndices) {
+            toIndices.append(index(movedRows[fromIndex.row()], fromIndex.column()));
+        }
+        changePersistentIndexList(fromIndices, toIndices);
+        emit layoutChanged();
+    }
+
+    // Insert ranges of rows front to back, so all preceding rows are
+    // already at their final position
+    for (int firstRow = 0; firstRow < rowTrackIds.size(); ++firstRow) {
+        if (!isInsertedRow[firstRow]) {
+            continue;
+        }
+        int lastRow = firstRow;
+        while (lastRow + 1 < rowTrackIds.size() && isInsertedRow[lastRow + 1]) {
+            ++lastRow;
+        }
+        const int count = lastRow - firstRow + 1;
+        beginInsertRows(QModelIndex(), firstRow, lastRow);
+        m_rowTrackIds.insert(firstRow, count, TrackId());
+        std::copy(rowTrackIds.cbegin() + firstRow,
+                rowTrackIds.cbegin() + lastRow + 1,
+                m_rowTrackIds.begin() + firstRow);
+        m_rowMetadata.insert(firstRow * m_metadataColumnCount,
+                count * m_metadataColumnCount,
+                QVariant());
+        std::copy(rowMetadata.cbegin() + firstRow * m_metadataColumnCount,
+                rowMetadata.cbegin() + (lastRow + 1) * m_metadataColumnCount,
+                m_rowMetadata.begin() + firstRow * m_metadataColumnCount);
+        endInsertRows();
+        firstRow = lastRow;
+    }
+    DEBUG_ASSERT(m_rowTrackIds == rowTrackIds);
+
+    // Finally update the stored column values of the rows that have been
+    // kept. The values from the track source are updated by tracksChanged().
+    int firstChangedRow = -1;
+    int lastChangedRow = -1;
+    for (int row = 0; row < m_rowTrackIds.size(); ++row) {
+        if (isInsertedRow[row]) {
+            continue;
+        }
+        const int offset = row * m_metadataColumnCount;
+        if (!std::equal(m_rowMetadata.cbegin() + offset,
+                    m_rowMetadata.cbegin() + offset + m_metadataColumnCount,
+                    rowMetadata.cbegin() + offset)) {
+            if (firstChangedRow < 0) {
+                firstChangedRow = row;
+            }
+            lastChangedRow = row;
+        }
+    }
+    m_rowMetadata = std::move(rowMetadata);
+    m_trackIdToRows = std::move(trackIdToRows);
+    if (firstChangedRow >= 0) {
+        emit dataChanged(index(firstChangedRow, 0),
+                index(lastChangedRow, columnCount() - 1));
+    }
+}
+
 void BaseSqlTableModel::select() {
     if (!m_bInitialized) {
         return;
@@ -211,9 +398,114 @@ void BaseSqlTableModel::select() {
         qDebug() << this << "select()";
     }
 
+    // The synchronous results supersede any pending asynchronous results
+    cancelAsyncSelect();
+
     PerformanceTimer time;
     time.start();
 
+    QueryResult result;
+    if (!queryRows(&result)) {
+        return;
+    }
+
+    if (m_trackSource) {
+        m_trackSource->filterAndSort(result.trackIds,
+                m_currentSearch,
+                m_currentSearchFilter,
+                m_trackSourceOrderBy,
+                m_sortColumns,
+                m_tableColumns.size() - 1, // exclude the 1st column with the id
+                &m_trackSortOrder);
+    }
+
+    replaceRowsSorted(std::move(result));
+
+    qDebug() << this << "select() returned" << m_rowTrackIds.size()
+             << "results in" << time.elapsed().debugMillisWithUnit();
+    emit selectFinished();
+}
+
+void BaseSqlTableModel::selectAsync() {
+    if (!m_bInitialized) {
+        return;
+    }
+    if (!m_trackSource || !m_trackSource->canFilterAndSortAsync()) {
+        select();
+        return;
+    }
+
+    if (sDebug) {
+        qDebug() << this << "selectAsync()";
+    }
+
+    // A new query aborts the pending query
+    cancelAsyncSelect();
+
+    QueryResult result;
+    if (!queryRows(&result)) {
+        return;
+    }
+    if (result.trackIds.isEmpty()) {
+        // Nothing to filter
+        replaceRowsSorted(std::move(result));
+        emit selectFinished();
+        return;
+    }
+
+    auto pCancelled = std::make_shared<std::atomic<bool>>(false);
+    m_pAsyncSelectCancelled = pCancelled;
+    const int generation = ++m_asyncSelectGeneration;
+
+    PerformanceTimer time;
+    time.start();
+
+    QFuture<QVector<TrackId>> future = m_trackSource->filterAndSortAsync(
+            result.trackIds,
+            m_currentSearch,
+            m_currentSearchFilter,
+            m_trackSourceOrderBy,
+            std::move(pCancelled));
+    auto* pWatcher = new QFutureWatcher<QVector<TrackId>>(this);
+    connect(pWatcher,
+            &QFutureWatcher<QVector<TrackId>>::finished,
+            this,
+            [this,
+                    pWatcher,
+                    generation,
+                    time,
+                    result = std::move(result)]() mutable {
+                pWatcher->deleteLater();
+                if (generation != m_asyncSelectGeneration) {
+                    // Superseded by a newer query
+                    return;
+                }
+                m_pAsyncSelectCancelled.reset();
+                m_trackSource->applyFilterAndSortResult(pWatcher->result(),
+                        result.trackIds,
+                        m_currentSearch,
+                        m_sortColumns,
+                        m_tableColumns.size() - 1, // exclude the 1st column with the id
+                        &m_trackSortOrder);
+                replaceRowsSorted(std::move(result));
+                qDebug() << this << "selectAsync() returned" << m_rowTrackIds.size()
+                         << "results in" << time.elapsed().debugMillisWithUnit();
+                emit selectFinished();
+            });
+    pWatcher->setFuture(future);
+}
+
+void BaseSqlTableModel::cancelAsyncSelect() {
+    if (!m_pAsyncSelectCancelled) {
+        return;
+    }
+    // Results that arrive later are ignored
+    ++m_asyncSelectGeneration;
+    m_pAsyncSelectCancelled->store(true);
+    m_pAsyncSelectCancelled.reset();
+}
+
+bool BaseSqlTableModel::queryRows(QueryResult* pResult) const {
     // Prepare query for id and all columns not in m_trackSource
     QString queryString = QString("SELECT %1 FROM %2 %3")
                                   .arg(m_tableColumns.join(","), m_tableName, m_tableOrderBy);
@@ -228,23 +520,16 @@ void BaseSqlTableModel::select() {
     query.setForwardOnly(true);
     if (!query.prepare(queryString)) {
         LOG_FAILED_QUERY(query);
-        return;
+        return false;
     }
     if (!query.exec()) {
         LOG_FAILED_QUERY(query);
-        return;
+        return false;
     }
 
-    // Remove all the rows from the table after(!) the query has been
-    // executed successfully. See issue #6782.
-    // TODO(rryan) we could edit the table in place instead of clearing it?
-    clearRows();
-
     // The size of the result set is not known in advance for a
     // forward-only query, so we cannot reserve memory for rows
     // in advance.
-    QVector<RowInfo> rowInfos;
-    QSet<TrackId> trackIds;
     int idColumn = -1;
     while (query.next()) {
         QSqlRecord sqlRecord = query.record();
@@ -261,36 +546,34 @@ void BaseSqlTableModel::select() {
             qCritical()
                     << "ID column not available in database query results:"
                     << m_idColumn;
-            return;
+            return false;
         }
 
         TrackId trackId(sqlRecord.value(idColumn));
-        trackIds.insert(trackId);
+        pResult->trackIds.insert(trackId);
 
         RowInfo rowInfo;
         rowInfo.trackId = trackId;
         // current position defines the ordering
-        rowInfo.order = rowInfos.size();
-        rowInfo.metadata.reserve(sqlRecord.count());
+        rowInfo.order = pResult->rowInfos.size();
+        rowInfo.metadataOffset = pResult->metadata.size();
         for (int i = 0; i < m_tableColumns.size(); ++i) {
-            rowInfo.metadata.push_back(sqlRecord.value(i));
+            if (m_metadataOffsetByColumn[i] >= 0) {
+                pResult->metadata.push_back(sqlRecord.value(i));
+            }
         }
-        rowInfos.push_back(rowInfo);
+        pResult->rowInfos.push_back(rowInfo);
     }
 
     if (sDebug) {
-        qDebug() << "Rows actually received:" << rowInfos.size();
+        qDebug() << "Rows actually received:" << pResult->rowInfos.size();
     }
+    return true;
+}
 
+void BaseSqlTableModel::replaceRowsSorted(QueryResult&& result) {
+    QVector<RowInfo>& rowInfos = result.rowInfos;
     if (m_trackSource) {
-        m_trackSource->filterAndSort(trackIds,
-                m_currentSearch,
-                m_currentSearchFilter,
-                m_trackSourceOrderBy,
-                m_sortColumns,
-                m_tableColumns.size() - 1, // exclude the 1st column with the id
-                &m_trackSortOrder);
-
         // Re-sort the track IDs since filterAndSort can change their order or mark
         // them for removal (by setting their row to -1).
         for (auto& rowInfo : rowInfos) {
@@ -311,34 +594,37 @@ void BaseSqlTableModel::select() {
     // should not disturb that if we are only removing tracks.
     std::stable_sort(rowInfos.begin(), rowInfos.end());
 
+    // Only the track ids and the stored column values are kept for
+    // each row. All other values are fetched from the track source
+    // on demand when the view requests them for visible rows.
+    QVector<TrackId> rowTrackIds;
+    rowTrackIds.reserve(rowInfos.size());
+    QVector<QVariant> rowMetadata;
+    rowMetadata.reserve(rowInfos.size() * m_metadataColumnCount);
     TrackId2Rows trackIdToRows;
     // We expect almost all rows to be valid and that only a few tracks
     // are contained multiple times in rowInfos (e.g. in history playlists)
     trackIdToRows.reserve(rowInfos.size());
-    for (int i = 0; i < rowInfos.size(); ++i) {
-        const RowInfo& rowInfo = rowInfos[i];
-
+    for (const auto& rowInfo : std::as_const(rowInfos)) {
         if (rowInfo.order == -1) {
-            // We've reached the end of valid rows. Resize rowInfo to cut off
-            // this and all further elements.
-            rowInfos.resize(i);
+            // We've reached the end of valid rows
             break;
         }
-        trackIdToRows[rowInfo.trackId].push_back(i);
+        trackIdToRows.insert(rowInfo.trackId, rowTrackIds.size());
+        rowTrackIds.push_back(rowInfo.trackId);
+        for (int i = 0; i < m_metadataColumnCount; ++i) {
+            rowMetadata.push_back(result.metadata[rowInfo.metadataOffset + i]);
+        }
     }
-    // The number of unique tracks cannot be greater than the
-    // number of total rows returned by the query
-    DEBUG_ASSERT(trackIdToRows.size() <= rowInfos.size());
+    // The query results are no longer needed
+    result = QueryResult();
 
-    // We're done! Issue the update signals and replace the main maps.
-    replaceRows(
-            std::move(rowInfos),
+    // Update the rows of the table after(!) the query has been
+    // executed successfully. See issue #6782.
+    updateRows(
+            std::move(rowTrackIds),
+            std::move(rowMetadata),
             std::move(trackIdToRows));
-    // Both rowInfo and trackIdToRows (might) have been moved and
-    // must not be used afterwards!
-
-    qDebug() << this << "select() returned" << m_rowInfo.size()
-             << "results in" << time.elapsed().debugMillisWithUnit();
 }
 
 void BaseSqlTableModel::setTable(QString tableName,
@@ -348,10 +634,22 @@ void BaseSqlTableModel::setTable(QString tableName,
     if (sDebug) {
         qDebug() << this << "setTable" << tableName << tableColumns << idColumn;
     }
+    cancelAsyncSelect();
     m_tableName = std::move(tableName);
     m_idColumn = std::move(idColumn);
     m_tableColumns = std::move(tableColumns);
 
+    // The id column is redundant and the preview column is computed
+    m_metadataOffsetByColumn.clear();
+    m_metadataColumnCount = 0;
+    for (int i = 0; i < m_tableColumns.size(); ++i) {
+        if (i == kIdColumn || m_tableColumns[i] == LIBRARYTABLE_PREVIEW) {
+            m_metadataOffsetByColumn.push_back(-1);
+        } else {
+            m_metadataOffsetByColumn.push_back(m_metadataColumnCount++);
+        }
+    }
+
     if (m_trackSource) {
         disconnect(m_trackSource.data(),
                 &BaseTrackCache::tracksChanged,
@@ -419,7 +717,8 @@ void BaseSqlTableModel::search(const QString& searchText, const QString& extraFi
         qDebug() << this << "search" << searchText;
     }
     setSearch(searchText, extraFilter);
-    select();
+    // Keep the UI responsive while typing
+    selectAsync();
 }
 
 void BaseSqlTableModel::setSort(int column, Qt::SortOrder order) {
@@ -568,7 +867,7 @@ void BaseSqlTableModel::sort(int column, Qt::SortOrder order) {
 }
 
 int BaseSqlTableModel::rowCount(const QModelIndex& parent) const {
-    int count = parent.isValid() ? 0 : m_rowInfo.size();
+    int count = parent.isValid() ? 0 : m_rowTrackIds.size();
     //qDebug() << "rowCount()" << parent << count;
     return count;
 }
@@ -632,7 +931,7 @@ QVariant BaseSqlTableModel::rawValue(
 
     const int row = index.row();
     DEBUG_ASSERT(row >= 0);
-    if (row >= m_rowInfo.size()) {
+    if (row >= m_rowTrackIds.size()) {
         return QVariant();
     }
 
@@ -640,8 +939,7 @@ QVariant BaseSqlTableModel::rawValue(
     DEBUG_ASSERT(column >= 0);
     // TODO(rryan) check range on column
 
-    const RowInfo& rowInfo = m_rowInfo[row];
-    const TrackId trackId = rowInfo.trackId;
+    const TrackId trackId = m_rowTrackIds[row];
 
     // If the row info has the row-specific column, return that.
     if (column < m_tableColumns.size()) {
@@ -651,13 +949,16 @@ QVariant BaseSqlTableModel::rawValue(
             return previewDeckTrackId() == trackId;
         }
 
-        const QVector<QVariant>& columns = rowInfo.metadata;
+        const int metadataOffset = m_metadataOffsetByColumn[column];
+        const QVariant value = metadataOffset >= 0
+                ? m_rowMetadata[row * m_metadataColumnCount + metadataOffset]
+                : trackId.toVariant();
         if (sDebug) {
             qDebug() << "Returning table-column value"
-                    << columns.at(column)
+                    << value
                     << "for column" << column;
         }
-        return columns[column];
+        return value;
     }
 
     // Otherwise, return the information from the track record cache for the
@@ -833,16 +1134,42 @@ void BaseSqlTableModel::tracksChanged(const QSet<TrackId>& trackIds) {
         qDebug() << this << "trackChanged" << trackIds.size();
     }
 
-    const int numColumns = columnCount();
+    // Signal a single update for the range of all affected rows instead
+    // of each row. The view only repaints the rows that are visible,
+    // while many signals would stall it when lots of tracks are updated
+    // at once, e.g. during a library scan.
+    int firstRow = -1;
+    int lastRow = -1;
     for (const auto& trackId : trackIds) {
-        const auto rows = getTrackRows(trackId);
-        for (int row : rows) {
-            //qDebug() << "Row in this result set was updated. Signalling update. track:" << trackId << "row:" << row;
-            QModelIndex topLeft = index(row, 0);
-            QModelIndex bottomRight = index(row, numColumns);
-            emit dataChanged(topLeft, bottomRight);
+        for (auto it = m_trackIdToRows.constFind(trackId);
+                it != m_trackIdToRows.constEnd() && it.key() == trackId;
+                ++it) {
+            const int row = it.value();
+            if (firstRow < 0 || row < firstRow) {
+                firstRow = row;
+            }
+            lastRow = std::max(lastRow, row);
         }
     }
+    if (firstRow < 0) {
+        return;
+    }
+    //qDebug() << "Rows in this result set were updated. Signalling update. rows:" << firstRow << lastRow;
+    QModelIndex topLeft = index(firstRow, 0);
+    QModelIndex bottomRight = index(lastRow, columnCount() - 1);
+    emit dataChanged(topLeft, bottomRight);
+}
+
+const QVector<int> BaseSqlTableModel::getTrackRows(TrackId trackId) const {
+    QVector<int> rows;
+    for (auto it = m_trackIdToRows.constFind(trackId);
+            it != m_trackIdToRows.constEnd() && it.key() == trackId;
+            ++it) {
+        rows.push_back(it.value());
+    }
+    // The most recently inserted rows come first
+    std::sort(rows.begin(), rows.end());
+    return rows;
 }
 
 void BaseSqlTableModel::hideTracks(const QModelIndexList& indices) {
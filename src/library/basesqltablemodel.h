@@ -2,6 +2,8 @@
 
 #include <QHash>
 #include <QtSql>
+#include <atomic>
+#include <memory>
 
 #include "library/basetrackcache.h"
 #include "library/dao/trackdao.h"
@@ -53,9 +55,7 @@ class BaseSqlTableModel : public BaseTrackTableModel {
 
     CoverInfo getCoverInfo(const QModelIndex& index) const override;
 
-    const QVector<int> getTrackRows(TrackId trackId) const override {
-        return m_trackIdToRows.value(trackId);
-    }
+    const QVector<int> getTrackRows(TrackId trackId) const override;
 
     void search(const QString& searchText, const QString& extraFilter = QString()) override;
     const QString currentSearch() const override;
@@ -66,6 +66,13 @@ class BaseSqlTableModel : public BaseTrackTableModel {
     void hideTracks(const QModelIndexList& indices) override;
 
     void select() override;
+    /// Like select(), but the tracks are filtered and sorted on a worker
+    /// thread if supported by the track source. A new query aborts the
+    /// pending query and the results are replaced all at once.
+    void selectAsync();
+    bool isSelectPending() const {
+        return m_pAsyncSelectCancelled != nullptr;
+    }
 
     ///////////////////////////////////////////////////////////////////////////
     // Inherited from BaseTrackTableModel
@@ -107,6 +114,11 @@ class BaseSqlTableModel : public BaseTrackTableModel {
     int m_columnIndexBySortColumnId[static_cast<int>(TrackModel::SortColumnId::IdMax)];
     QMap<int, TrackModel::SortColumnId> m_sortColumnIdByColumnIndex;
 
+  signals:
+    /// The rows have been replaced with the results of the current
+    /// search query.
+    void selectFinished();
+
   private slots:
     void tracksChanged(const QSet<TrackId>& trackIds);
 
@@ -122,7 +134,8 @@ class BaseSqlTableModel : public BaseTrackTableModel {
     struct RowInfo {
         TrackId trackId;
         int order;
-        QVector<QVariant> metadata;
+        // The index of the first stored column value in the query result
+        int metadataOffset;
 
         bool operator<(const RowInfo& other) const {
             // -1 is greater than anything
@@ -135,14 +148,42 @@ class BaseSqlTableModel : public BaseTrackTableModel {
         }
     };
 
-    typedef QHash<TrackId, QVector<int>> TrackId2Rows;
+    // Most tracks are contained only once
+    typedef QMultiHash<TrackId, int> TrackId2Rows;
+
+    /// The unfiltered rows of the table query
+    struct QueryResult {
+        QVector<RowInfo> rowInfos;
+        QVector<QVariant> metadata;
+        QSet<TrackId> trackIds;
+    };
+
+    bool queryRows(QueryResult* pResult) const;
+    void replaceRowsSorted(QueryResult&& result);
+    void cancelAsyncSelect();
 
     void clearRows();
     void replaceRows(
-            QVector<RowInfo>&& rows,
+            QVector<TrackId>&& rowTrackIds,
+            QVector<QVariant>&& rowMetadata,
+            TrackId2Rows&& trackIdToRows);
+    /// Updates the current rows to the new rows with fine-grained
+    /// signals for removed, moved, inserted and changed rows, so that
+    /// the view keeps its selection and scroll position
+    void updateRows(
+            QVector<TrackId>&& rowTrackIds,
+            QVector<QVariant>&& rowMetadata,
             TrackId2Rows&& trackIdToRows);
 
-    QVector<RowInfo> m_rowInfo;
+    // The sort order of the rows
+    QVector<TrackId> m_rowTrackIds;
+    // The values of the table columns that are stored for each row,
+    // i.e. m_metadataColumnCount values per row
+    QVector<QVariant> m_rowMetadata;
+    // Maps table columns onto the offsets of their stored values
+    // within a row or -1 if the values are not stored
+    QVector<int> m_metadataOffsetByColumn;
+    int m_metadataColumnCount;
 
     QString m_idColumn;
     QSharedPointer<BaseTrackCache> m_trackSource;
@@ -156,5 +197,8 @@ class BaseSqlTableModel : public BaseTrackTableModel {
     QVector<QHash<int, QVariant>> m_headerInfo;
     QString m_trackSourceOrderBy;
 
+    int m_asyncSelectGeneration;
+    std::shared_ptr<std::atomic<bool>> m_pAsyncSelectCancelled;
+
     DISALLOW_COPY_AND_ASSIGN(BaseSqlTableModel);
 };
@@ -1,5 +1,7 @@
 #include "library/basetrackcache.h"
 
+#include <QtConcurrent>
+
 #include "library/queryutil.h"
 #include "library/searchquery.h"
 #include "library/searchqueryparser.h"
@@ -8,6 +10,9 @@
 #include "track/globaltrackcache.h"
 #include "track/keyutils.h"
 #include "track/track.h"
+#include "util/db/dbconnection.h"
+#include "util/db/dbconnectionpooled.h"
+#include "util/db/dbconnectionpooler.h"
 #include "util/performancetimer.h"
 
 namespace {
@@ -26,12 +31,30 @@ BaseTrackCache::BaseTrackCache(TrackCollection* pTrackCollection,
           m_idColumn(std::move(idColumn)),
           m_columnCount(columns.size()),
           m_columnsJoined(columns.join(",")),
+          m_searchIndex(columns),
           m_columnCache(std::move(columns)),
           m_pQueryParser(std::make_unique<SearchQueryParser>(
                   pTrackCollection, std::move(searchColumns))),
+          m_parsedSearchQueryFullText(false),
           m_bIndexBuilt(false),
           m_bIsCaching(isCaching),
           m_database(pTrackCollection->database()) {
+    connect(pTrackCollection,
+            &TrackCollection::crateInserted,
+            this,
+            &BaseTrackCache::slotInvalidateParsedSearchQuery);
+    connect(pTrackCollection,
+            &TrackCollection::crateUpdated,
+            this,
+            &BaseTrackCache::slotInvalidateParsedSearchQuery);
+    connect(pTrackCollection,
+            &TrackCollection::crateDeleted,
+            this,
+            &BaseTrackCache::slotInvalidateParsedSearchQuery);
+    connect(pTrackCollection,
+            &TrackCollection::crateTracksChanged,
+            this,
+            &BaseTrackCache::slotInvalidateParsedSearchQuery);
 }
 
 BaseTrackCache::~BaseTrackCache() {
@@ -79,6 +102,7 @@ void BaseTrackCache::slotTracksRemoved(const QSet<TrackId>& trackIds) {
     }
     for (const auto& trackId : std::as_const(trackIds)) {
         m_trackInfo.remove(trackId);
+        m_searchIndex.removeTrack(trackId);
         m_dirtyTracks.remove(trackId);
     }
 }
@@ -209,6 +233,7 @@ bool BaseTrackCache::updateTrackInIndex(
         for (int i = 0; i < numColumns; ++i) {
             getTrackValueForColumn(pTrack, i, record[i]);
         }
+        m_searchIndex.updateTrack(trackId, record);
         if (m_bIsCaching) {
             replaceRecentTrack(std::move(trackId), pTrack);
         }
@@ -264,6 +289,7 @@ bool BaseTrackCache::updateIndexWithQuery(const QString& queryString) {
                 record[i] = query.value(i);
             }
         }
+        m_searchIndex.updateTrack(trackId, record);
     }
 
     qDebug() << this << "updateIndexWithQuery took" << timer.elapsed().debugMillisWithUnit();
@@ -286,6 +312,7 @@ void BaseTrackCache::buildIndex() {
     // clear the table, and keep track of what IDs we see, then delete the ones
     // we don't see.
     m_trackInfo.clear();
+    m_searchIndex.clear();
 
     if (!updateIndexWithQuery(queryString)) {
         qDebug() << "buildIndex failed!";
@@ -437,6 +464,13 @@ QVariant BaseTrackCache::data(TrackId trackId, int column) const {
     return result;
 }
 
+void BaseTrackCache::enableAsyncFilterAndSort(
+        mixxx::DbConnectionPoolPtr pDbConnectionPool,
+        QString tableQuery) {
+    m_pDbConnectionPool = std::move(pDbConnectionPool);
+    m_tableQuery = std::move(tableQuery);
+}
+
 void BaseTrackCache::filterAndSort(const QSet<TrackId>& trackIds,
                                    const QString& searchQuery,
                                    const QString& extraFilter,
@@ -449,75 +483,172 @@ void BaseTrackCache::filterAndSort(const QSet<TrackId>& trackIds,
         return;
     }
 
+    const QString queryString = filterAndSortQuery(
+            trackIds, searchQuery, extraFilter, orderByClause, m_tableName);
+    applyFilterAndSortResult(
+            queryTrackOrder(m_database, queryString, m_idColumn),
+            trackIds,
+            searchQuery,
+            sortColumns,
+            columnOffset,
+            trackToIndex);
+}
+
+QFuture<QVector<TrackId>> BaseTrackCache::filterAndSortAsync(
+        const QSet<TrackId>& trackIds,
+        const QString& searchQuery,
+        const QString& extraFilter,
+        const QString& orderByClause,
+        std::shared_ptr<const std::atomic<bool>> pCancelled) {
+    VERIFY_OR_DEBUG_ASSERT(canFilterAndSortAsync()) {
+        return QFuture<QVector<TrackId>>();
+    }
+    // The temporary view of the cache only exists for the connection
+    // of this thread
+    const QString queryString = filterAndSortQuery(trackIds,
+            searchQuery,
+            extraFilter,
+            orderByClause,
+            QStringLiteral("(%1) AS %2").arg(m_tableQuery, m_tableName));
+    return QtConcurrent::run(
+            [pDbConnectionPool = m_pDbConnectionPool,
+                    queryString,
+                    idColumn = m_idColumn,
+                    pCancelled = std::move(pCancelled)]() {
+                if (pCancelled->load()) {
+                    return QVector<TrackId>();
+                }
+                const mixxx::DbConnectionPooler dbConnectionPooler(pDbConnectionPool,
+                        mixxx::DbConnectionPool::AccessMode::ReadOnly);
+                const QSqlDatabase database = mixxx::DbConnectionPooled(pDbConnectionPool);
+                mixxx::DbConnection::setInterruptFlag(database, pCancelled.get());
+                QVector<TrackId> trackOrder = queryTrackOrder(
+                        database, queryString, idColumn, pCancelled.get());
+                mixxx::DbConnection::setInterruptFlag(database, nullptr);
+                return trackOrder;
+            });
+}
+
+const QueryNode& BaseTrackCache::parseSearchQuery(
+        const QString& searchQuery, QString* pSql) {
+    const bool fullText = SearchQueryParser::isFullTextSearchEnabled();
+    if (!m_pParsedSearchQuery ||
+            m_parsedSearchQueryString != searchQuery ||
+            m_parsedSearchQueryFullText != fullText) {
+        m_pParsedSearchQuery = m_pQueryParser->parseQuery(searchQuery, QString());
+        m_parsedSearchQuerySql = m_pParsedSearchQuery->toSql();
+        m_parsedSearchQueryString = searchQuery;
+        m_parsedSearchQueryFullText = fullText;
+    }
+    if (pSql) {
+        *pSql = m_parsedSearchQuerySql;
+    }
+    return *m_pParsedSearchQuery;
+}
+
+void BaseTrackCache::slotInvalidateParsedSearchQuery() {
+    m_pParsedSearchQuery.reset();
+}
+
+QString BaseTrackCache::filterAndSortQuery(const QSet<TrackId>& trackIds,
+        const QString& searchQuery,
+        const QString& extraFilter,
+        const QString& orderByClause,
+        const QString& fromClause) {
     if (!m_bIndexBuilt) {
         buildIndex();
     }
 
+    QString searchFilter;
+    const QueryNode& query = parseSearchQuery(searchQuery, &searchFilter);
+
+    // Evaluate the search query in memory if possible. Only the remaining
+    // tracks need to be filtered by the extra filter and sorted by the
+    // database.
     QStringList idStrings;
-    // TODO(rryan) consider making this the data passed in and a separate
-    // QVector for output
-    QSet<TrackId> dirtyTracks;
-    for (const auto& trackId: trackIds) {
-        idStrings << trackId.toString();
-        if (m_dirtyTracks.contains(trackId)) {
-            dirtyTracks.insert(trackId);
+    if (searchFilter.isEmpty() || !filterWithSearchIndex(query, trackIds, &idStrings)) {
+        idStrings.clear();
+        for (const auto& trackId : trackIds) {
+            idStrings << trackId.toString();
         }
+    } else {
+        searchFilter.clear();
     }
 
     QStringList queryFragments;
     if (!extraFilter.isNull() && extraFilter != "") {
         queryFragments << QString("(%1)").arg(extraFilter);
     }
-    if (idStrings.size() > 0) {
-        queryFragments << QString("%1 in (%2)")
-                .arg(m_idColumn, idStrings.join(","));
+    // An empty list of ids means that no track matches the search query
+    queryFragments << QString("%1 in (%2)")
+            .arg(m_idColumn, idStrings.join(","));
+    if (!searchFilter.isEmpty()) {
+        queryFragments << QString("(%1)").arg(searchFilter);
     }
 
-    const std::unique_ptr<QueryNode> pQuery =
-            m_pQueryParser->parseQuery(
-                    searchQuery,
-                    queryFragments.join(" AND "));
+    QString filter = queryFragments.join(" AND ");
+    filter.prepend("WHERE ");
 
-    QString filter = pQuery->toSql();
-    if (!filter.isEmpty()) {
-        filter.prepend("WHERE ");
-    }
-
-    QString queryString = QString("SELECT %1 FROM %2 %3 %4")
-            .arg(m_idColumn, m_tableName, filter, orderByClause);
+    return QString("SELECT %1 FROM %2 %3 %4")
+            .arg(m_idColumn, fromClause, filter, orderByClause);
+}
 
+//static
+QVector<TrackId> BaseTrackCache::queryTrackOrder(
+        const QSqlDatabase& database,
+        const QString& queryString,
+        const QString& idColumn,
+        const std::atomic<bool>* pCancelled) {
     if (sDebug) {
-        qDebug() << this << "select() executing:" << queryString;
+        qDebug() << "filterAndSort() executing:" << queryString;
     }
 
-    QSqlQuery query(m_database);
+    QSqlQuery query(database);
     // This causes a memory savings since QSqlCachedResult (what QtSQLite uses)
     // won't allocate a giant in-memory table that we won't use at all.
     query.setForwardOnly(true);
     query.prepare(queryString);
 
+    QVector<TrackId> trackOrder;
     if (!query.exec()) {
-        LOG_FAILED_QUERY(query);
+        // An interrupted query fails intentionally
+        if (!pCancelled || !pCancelled->load()) {
+            LOG_FAILED_QUERY(query);
+        }
+        return trackOrder;
     }
 
-    int idColumn = query.record().indexOf(m_idColumn);
-    int rows = query.size();
+    int idColumnIndex = query.record().indexOf(idColumn);
+    while (query.next()) {
+        trackOrder.append(TrackId(query.value(idColumnIndex)));
+    }
 
     if (sDebug) {
-        qDebug() << "Rows returned:" << rows;
+        qDebug() << "Rows returned:" << trackOrder.size();
     }
+    return trackOrder;
+}
 
-    m_trackOrder.resize(0); // keeps allocated memory
-    trackToIndex->clear();
-    if (rows > 0) {
-        trackToIndex->reserve(rows);
-        m_trackOrder.reserve(rows);
+void BaseTrackCache::applyFilterAndSortResult(QVector<TrackId> trackOrder,
+        const QSet<TrackId>& trackIds,
+        const QString& searchQuery,
+        const QList<SortColumn>& sortColumns,
+        const int columnOffset,
+        QHash<TrackId, int>* trackToIndex) {
+    // TODO(rryan) consider making this the data passed in and a separate
+    // QVector for output
+    QSet<TrackId> dirtyTracks;
+    for (const auto& trackId: trackIds) {
+        if (m_dirtyTracks.contains(trackId)) {
+            dirtyTracks.insert(trackId);
+        }
     }
 
-    while (query.next()) {
-        TrackId trackId(query.value(idColumn));
-        (*trackToIndex)[trackId] = m_trackOrder.size();
-        m_trackOrder.append(trackId);
+    m_trackOrder = std::move(trackOrder);
+    trackToIndex->clear();
+    trackToIndex->reserve(m_trackOrder.size());
+    for (int i = 0; i < m_trackOrder.size(); ++i) {
+        (*trackToIndex)[m_trackOrder[i]] = i;
     }
 
     // At this point, the original set of tracks have been divided into two
@@ -533,6 +664,8 @@ void BaseTrackCache::filterAndSort(const QSet<TrackId>& trackIds,
         return;
     }
 
+    const QueryNode& query = parseSearchQuery(searchQuery);
+
     for (TrackId trackId : std::as_const(dirtyTracks)) {
         // Only get the track if it is in the cache. Tracks that
         // are not cached in memory cannot be dirty.
@@ -545,7 +678,7 @@ void BaseTrackCache::filterAndSort(const QSet<TrackId>& trackIds,
         // The track should be in the result set if the search is empty or the
         // track matches the search.
         bool shouldBeInResultSet = searchQuery.isEmpty() ||
-                pQuery->match(pTrack);
+                query.match(pTrack);
 
         // If the track is in this result set.
         bool isInResultSet = trackToIndex->contains(trackId);
@@ -595,6 +728,46 @@ void BaseTrackCache::filterAndSort(const QSet<TrackId>& trackIds,
     }
 }
 
+bool BaseTrackCache::filterWithSearchIndex(const QueryNode& query,
+        const QSet<TrackId>& trackIds,
+        QStringList* pIdStrings) const {
+    PerformanceTimer timer;
+    timer.start();
+
+    // All tracks must be indexed, otherwise the database is the only
+    // reliable source
+    QVector<int> rows;
+    rows.reserve(trackIds.size());
+    for (const auto& trackId : trackIds) {
+        const int row = m_searchIndex.row(trackId);
+        if (row < 0) {
+            return false;
+        }
+        rows.append(row);
+    }
+
+    TrackSearchIndex::Matches matches;
+    if (!query.evaluate(m_searchIndex, &matches)) {
+        if (sDebug) {
+            qDebug() << this << "search query is not supported by index";
+        }
+        return false;
+    }
+
+    for (const int row : std::as_const(rows)) {
+        // Neither false nor null
+        if (matches[row] == TrackSearchIndex::Match::True) {
+            *pIdStrings << m_searchIndex.trackId(row).toString();
+        }
+    }
+
+    if (sDebug) {
+        qDebug() << this << "filterWithSearchIndex took"
+                 << timer.elapsed().debugMillisWithUnit();
+    }
+    return true;
+}
+
 int BaseTrackCache::findSortInsertionPoint(TrackPointer pTrack,
         const QList<SortColumn>& sortColumns,
         const int columnOffset,
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <QFuture>
 #include <QHash>
 #include <QList>
 #include <QObject>
@@ -8,14 +9,18 @@
 #include <QString>
 #include <QStringList>
 #include <QVector>
+#include <atomic>
 #include <memory>
 
 #include "library/columncache.h"
+#include "library/tracksearchindex.h"
 #include "track/track_decl.h"
 #include "track/trackid.h"
 #include "util/class.h"
+#include "util/db/dbconnectionpool.h"
 #include "util/string.h"
 
+class QueryNode;
 class SearchQueryParser;
 class TrackCollection;
 
@@ -71,6 +76,32 @@ class BaseTrackCache : public QObject {
                                const QList<SortColumn>& sortColumns,
                                const int columnOffset,
                                QHash<TrackId, int>* trackToIndex);
+
+    /// Allows filterAndSortAsync() to select the tracks with a separate
+    /// database connection. The temporary view of the cache is not visible
+    /// for other connections and the table query defines its contents.
+    void enableAsyncFilterAndSort(
+            mixxx::DbConnectionPoolPtr pDbConnectionPool,
+            QString tableQuery);
+    bool canFilterAndSortAsync() const {
+        return m_pDbConnectionPool != nullptr;
+    }
+    /// Like filterAndSort(), but the database query is executed on a
+    /// worker thread. It is aborted as soon as the flag is set. The
+    /// result must be passed to applyFilterAndSortResult().
+    QFuture<QVector<TrackId>> filterAndSortAsync(
+            const QSet<TrackId>& trackIds,
+            const QString& query,
+            const QString& extraFilter,
+            const QString& orderByClause,
+            std::shared_ptr<const std::atomic<bool>> pCancelled);
+    void applyFilterAndSortResult(QVector<TrackId> trackOrder,
+            const QSet<TrackId>& trackIds,
+            const QString& query,
+            const QList<SortColumn>& sortColumns,
+            const int columnOffset,
+            QHash<TrackId, int>* trackToIndex);
+
     virtual bool isCached(TrackId trackId) const;
     virtual void ensureCached(TrackId trackId);
     virtual void ensureCached(const QSet<TrackId>& trackIds);
@@ -86,6 +117,9 @@ class BaseTrackCache : public QObject {
     void slotTrackDirty(TrackId trackId);
     void slotTrackClean(TrackId trackId);
 
+  private slots:
+    void slotInvalidateParsedSearchQuery();
+
   private:
     const TrackPointer& getRecentTrack(TrackId trackId) const;
     void replaceRecentTrack(TrackPointer pTrack) const;
@@ -99,6 +133,25 @@ class BaseTrackCache : public QObject {
     void getTrackValueForColumn(TrackPointer pTrack, int column,
                                 QVariant& trackValue) const;
 
+    // Returns the parsed search query and its SQL. The result of the
+    // last invocation is reused if the query has not changed.
+    const QueryNode& parseSearchQuery(const QString& searchQuery,
+            QString* pSql = nullptr);
+    QString filterAndSortQuery(const QSet<TrackId>& trackIds,
+            const QString& searchQuery,
+            const QString& extraFilter,
+            const QString& orderByClause,
+            const QString& fromClause);
+    static QVector<TrackId> queryTrackOrder(
+            const QSqlDatabase& database,
+            const QString& queryString,
+            const QString& idColumn,
+            const std::atomic<bool>* pCancelled = nullptr);
+
+    // Returns false if the query could not be evaluated in memory
+    bool filterWithSearchIndex(const QueryNode& query,
+            const QSet<TrackId>& trackIds,
+            QStringList* pIdStrings) const;
     int findSortInsertionPoint(TrackPointer pTrack,
                                const QList<SortColumn>& sortColumns,
                                const int columnOffset,
@@ -120,10 +173,21 @@ class BaseTrackCache : public QObject {
     const int m_columnCount;
     const QString m_columnsJoined;
 
+    // Columnar copy of the searchable columns of m_trackInfo
+    TrackSearchIndex m_searchIndex;
+
     const ColumnCache m_columnCache;
 
     const std::unique_ptr<SearchQueryParser> m_pQueryParser;
 
+    // The models are refreshed with the same search query most of the
+    // time. Crate filters load the tracks of the crates once per parsed
+    // query, so the query is parsed again when crates are modified.
+    QString m_parsedSearchQueryString;
+    bool m_parsedSearchQueryFullText;
+    std::unique_ptr<QueryNode> m_pParsedSearchQuery;
+    QString m_parsedSearchQuerySql;
+
     const mixxx::StringCollator m_collator;
 
     // Temporary storage for filterAndSort()
@@ -147,5 +211,8 @@ class BaseTrackCache : public QObject {
     QHash<TrackId, QVector<QVariant>> m_trackInfo;
     QSqlDatabase m_database;
 
+    mixxx::DbConnectionPoolPtr m_pDbConnectionPool;
+    QString m_tableQuery;
+
     DISALLOW_COPY_AND_ASSIGN(BaseTrackCache);
 };
@@ -0,0 +1,240 @@
+#include "library/batchanalyzer.h"
+
+#include <QDirIterator>
+#include <QFileInfo>
+
+#include "analyzer/analyzerscheduledtrack.h"
+#include "library/dao/trackschema.h"
+#include "library/trackcollection.h"
+#include "library/trackcollectionmanager.h"
+#include "library/trackset/crate/crate.h"
+#include "moc_batchanalyzer.cpp"
+#include "sources/soundsourceproxy.h"
+#include "track/track.h"
+#include "util/db/fwdsqlquery.h"
+#include "util/fileinfo.h"
+#include "util/logger.h"
+
+namespace {
+
+const mixxx::Logger kLogger("BatchAnalyzer");
+
+// Report the progress of a single track only in coarse steps to
+// keep the output readable in log files of build servers
+constexpr int kProgressReportPercentStep = 25;
+
+class TrackAnalysisSchedulerEnvironmentImpl final : public TrackAnalysisSchedulerEnvironment {
+  public:
+    explicit TrackAnalysisSchedulerEnvironmentImpl(
+            const TrackCollectionManager* pTrackCollectionManager)
+            : m_pTrackCollectionManager(pTrackCollectionManager) {
+        DEBUG_ASSERT(m_pTrackCollectionManager);
+    }
+    ~TrackAnalysisSchedulerEnvironmentImpl() final = default;
+
+    TrackPointer loadTrackById(TrackId trackId) const final {
+        return m_pTrackCollectionManager->getTrackById(trackId);
+    }
+
+  private:
+    const TrackCollectionManager* const m_pTrackCollectionManager;
+};
+
+} // anonymous namespace
+
+BatchAnalyzer::BatchAnalyzer(
+        UserSettingsPointer pConfig,
+        mixxx::DbConnectionPoolPtr pDbConnectionPool,
+        TrackCollectionManager* pTrackCollectionManager,
+        QTextStream* pOutput,
+        QObject* pParent)
+        : QObject(pParent),
+          m_pConfig(std::move(pConfig)),
+          m_pDbConnectionPool(std::move(pDbConnectionPool)),
+          m_pTrackCollectionManager(pTrackCollectionManager),
+          m_pOutput(pOutput),
+          m_pTrackAnalysisScheduler(TrackAnalysisScheduler::NullPointer()),
+          m_lastReportedTrackNumber(0),
+          m_lastReportedPercent(0) {
+    DEBUG_ASSERT(m_pTrackCollectionManager);
+    DEBUG_ASSERT(m_pOutput);
+}
+
+BatchAnalyzer::~BatchAnalyzer() {
+    stop();
+}
+
+int BatchAnalyzer::addPath(const QString& path) {
+    const QFileInfo fileInfo(path);
+    if (!fileInfo.exists()) {
+        kLogger.warning() << "File or directory not found:" << path;
+        return 0;
+    }
+    QStringList filePaths;
+    if (fileInfo.isDir()) {
+        // Register the directory like the GUI does when adding a music
+        // directory. This fails silently if the directory or one of its
+        // parents is already a library directory.
+        m_pTrackCollectionManager->addDirectory(mixxx::FileInfo(fileInfo));
+        QDirIterator it(fileInfo.absoluteFilePath(),
+                SoundSourceProxy::getSupportedFileNamePatterns(),
+                QDir::Files | QDir::NoDotAndDotDot,
+                QDirIterator::Subdirectories);
+        while (it.hasNext()) {
+            filePaths.append(it.next());
+        }
+        // The iteration order depends on the file system
+        filePaths.sort();
+    } else if (SoundSourceProxy::isFileSupported(mixxx::FileInfo(fileInfo))) {
+        filePaths.append(fileInfo.absoluteFilePath());
+    } else {
+        kLogger.warning() << "Unsupported file type:" << path;
+        return 0;
+    }
+
+    QList<TrackId> trackIds;
+    for (const auto& filePath : std::as_const(filePaths)) {
+        const TrackPointer pTrack = m_pTrackCollectionManager->getOrAddTrack(
+                TrackRef::fromFilePath(filePath));
+        if (!pTrack) {
+            kLogger.warning() << "Failed to add track" << filePath;
+            continue;
+        }
+        trackIds.append(pTrack->getId());
+    }
+    return addTrackIds(trackIds);
+}
+
+int BatchAnalyzer::addCrate(const QString& crateName) {
+    const CrateStorage& crates =
+            m_pTrackCollectionManager->internalCollection()->crates();
+    Crate crate;
+    if (!crates.readCrateByName(crateName, &crate)) {
+        kLogger.warning() << "Crate not found:" << crateName;
+        return -1;
+    }
+    QList<TrackId> trackIds;
+    CrateTrackSelectResult crateTracks(crates.selectCrateTracksSorted(crate.getId()));
+    while (crateTracks.next()) {
+        trackIds.append(crateTracks.trackId());
+    }
+    return addTrackIds(trackIds);
+}
+
+int BatchAnalyzer::addAllLibraryTracks() {
+    FwdSqlQuery query(
+            m_pTrackCollectionManager->internalCollection()->database(),
+            QStringLiteral("SELECT %1 FROM %2 WHERE %3=0 ORDER BY %1")
+                    .arg(LIBRARYTABLE_ID,
+                            QStringLiteral(LIBRARY_TABLE),
+                            LIBRARYTABLE_MIXXXDELETED));
+    if (query.hasError() || !query.execPrepared()) {
+        kLogger.warning() << "Failed to query library tracks";
+        return 0;
+    }
+    QList<TrackId> trackIds;
+    while (query.next()) {
+        trackIds.append(TrackId(query.fieldValue(0)));
+    }
+    return addTrackIds(trackIds);
+}
+
+int BatchAnalyzer::addTrackIds(const QList<TrackId>& trackIds) {
+    int addedCount = 0;
+    for (const auto& trackId : trackIds) {
+        if (!trackId.isValid() || m_trackIdSet.contains(trackId)) {
+            continue;
+        }
+        m_trackIdSet.insert(trackId);
+        m_trackIds.append(trackId);
+        ++addedCount;
+    }
+    return addedCount;
+}
+
+bool BatchAnalyzer::start(int numWorkerThreads, AnalyzerModeFlags modeFlags) {
+    VERIFY_OR_DEBUG_ASSERT(!m_pTrackAnalysisScheduler) {
+        return false;
+    }
+    if (m_trackIds.isEmpty()) {
+        return false;
+    }
+    kLogger.info()
+            << "Analyzing"
+            << m_trackIds.size()
+            << "tracks using"
+            << numWorkerThreads
+            << "worker threads";
+    m_pTrackAnalysisScheduler = TrackAnalysisScheduler::createInstance(
+            std::make_unique<const TrackAnalysisSchedulerEnvironmentImpl>(
+                    m_pTrackCollectionManager),
+            numWorkerThreads,
+            m_pDbConnectionPool,
+            m_pConfig,
+            modeFlags);
+    connect(m_pTrackAnalysisScheduler.get(),
+            &TrackAnalysisScheduler::progress,
+            this,
+            &BatchAnalyzer::slotProgress);
+    connect(m_pTrackAnalysisScheduler.get(),
+            &TrackAnalysisScheduler::finished,
+            this,
+            &BatchAnalyzer::slotFinished);
+
+    m_lastReportedTrackNumber = 0;
+    m_lastReportedPercent = 0;
+    QList<AnalyzerScheduledTrack> tracks;
+    tracks.reserve(m_trackIds.size());
+    for (const auto& trackId : std::as_const(m_trackIds)) {
+        tracks.append(trackId);
+    }
+    if (m_pTrackAnalysisScheduler->scheduleTracks(tracks) <= 0) {
+        m_pTrackAnalysisScheduler.reset();
+        return false;
+    }
+    m_pTrackAnalysisScheduler->resume();
+    return true;
+}
+
+void BatchAnalyzer::stop() {
+    if (!m_pTrackAnalysisScheduler) {
+        return; // inactive
+    }
+    kLogger.info() << "Stopping analysis";
+    m_pTrackAnalysisScheduler.reset();
+}
+
+void BatchAnalyzer::slotProgress(
+        AnalyzerProgress currentTrackProgress,
+        int currentTrackNumber,
+        int totalTracksCount) {
+    // Ignore any delayed progress updates after the analysis
+    // has already been stopped.
+    if (!m_pTrackAnalysisScheduler || currentTrackNumber <= 0) {
+        return;
+    }
+    const int percent = currentTrackProgress >= kAnalyzerProgressNone
+            ? analyzerProgressPercent(currentTrackProgress)
+            : 0;
+    if (currentTrackNumber == m_lastReportedTrackNumber &&
+            percent < m_lastReportedPercent + kProgressReportPercentStep) {
+        return;
+    }
+    m_lastReportedTrackNumber = currentTrackNumber;
+    m_lastReportedPercent = percent;
+    *m_pOutput << '[' << currentTrackNumber << '/' << totalTracksCount << "] "
+               << percent << "%\n";
+    m_pOutput->flush();
+}
+
+void BatchAnalyzer::slotFinished() {
+    if (!m_pTrackAnalysisScheduler) {
+        return; // already inactive
+    }
+    *m_pOutput << "Analyzed " << m_trackIds.size() << " tracks\n";
+    m_pOutput->flush();
+    // Release the worker threads, the scheduler itself is deleted
+    // later by the event loop
+    m_pTrackAnalysisScheduler.reset();
+    emit finished();
+}
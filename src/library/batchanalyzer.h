@@ -0,0 +1,80 @@
+#pragma once
+
+#include <QList>
+#include <QObject>
+#include <QSet>
+#include <QString>
+#include <QTextStream>
+
+#include "analyzer/trackanalysisscheduler.h"
+#include "preferences/usersettings.h"
+#include "track/trackid.h"
+#include "util/db/dbconnectionpool.h"
+
+class TrackCollectionManager;
+
+/// Analyzes a batch of library tracks without any GUI, e.g. for
+/// pre-analyzing a collection on a build server. Used by
+/// the mixxx-analyze command line tool.
+///
+/// Tracks are collected from files and directories, that are added to
+/// the library if needed, from crates, or from the whole library. The
+/// results are stored in the database by the TrackAnalysisScheduler
+/// like during an analysis that has been started from the GUI. Progress
+/// is reported line by line on the provided text stream.
+class BatchAnalyzer : public QObject {
+    Q_OBJECT
+
+  public:
+    BatchAnalyzer(
+            UserSettingsPointer pConfig,
+            mixxx::DbConnectionPoolPtr pDbConnectionPool,
+            TrackCollectionManager* pTrackCollectionManager,
+            QTextStream* pOutput,
+            QObject* pParent = nullptr);
+    ~BatchAnalyzer() override;
+
+    /// Adds a single file or all supported files that are located
+    /// in a directory and its subdirectories. Returns the number of
+    /// tracks that have been added to the batch.
+    int addPath(const QString& path);
+    /// Returns -1 if the crate does not exist.
+    int addCrate(const QString& crateName);
+    int addAllLibraryTracks();
+
+    const QList<TrackId>& trackIds() const {
+        return m_trackIds;
+    }
+
+    /// Starts analyzing all tracks of the batch. The signal finished()
+    /// is emitted after all tracks have been analyzed. Returns false if
+    /// the batch is empty.
+    bool start(int numWorkerThreads, AnalyzerModeFlags modeFlags);
+
+    void stop();
+
+  signals:
+    void finished();
+
+  private slots:
+    void slotProgress(
+            AnalyzerProgress currentTrackProgress,
+            int currentTrackNumber,
+            int totalTracksCount);
+    void slotFinished();
+
+  private:
+    int addTrackIds(const QList<TrackId>& trackIds);
+
+    const UserSettingsPointer m_pConfig;
+    const mixxx::DbConnectionPoolPtr m_pDbConnectionPool;
+    TrackCollectionManager* const m_pTrackCollectionManager;
+    QTextStream* const m_pOutput;
+
+    QList<TrackId> m_trackIds;
+    QSet<TrackId> m_trackIdSet;
+
+    TrackAnalysisScheduler::Pointer m_pTrackAnalysisScheduler;
+    int m_lastReportedTrackNumber;
+    int m_lastReportedPercent;
+};
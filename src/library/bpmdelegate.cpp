@@ -82,7 +82,25 @@ void BPMDelegate::paintItem(QPainter* painter,const QStyleOptionViewItem &option
     initStyleOption(&opt, index);
 
     QStyle* style = m_pTableView->style();
-    if (style != nullptr) {
-        style->drawControl(QStyle::CE_ItemViewItem, &opt, painter, m_pCheckBox);
+    if (style == nullptr) {
+        return;
     }
+    // Drawing with the style sheet is expensive, but there are only a few
+    // distinct combinations of the BPM text, the lock and the cell state
+    paintCached(painter,
+            opt.rect,
+            QStringLiteral("bpm|%1|%2|%3|%4|%5")
+                    .arg(opt.text,
+                            QString::number(opt.checkState),
+                            QString::number(static_cast<int>(opt.state)),
+                            QString::number(static_cast<int>(opt.features)),
+                            opt.backgroundBrush.color().name(QColor::HexArgb)),
+            [this, &opt, style](QPainter* pPainter, const QRect& rect) {
+                QStyleOptionViewItem cellOption = opt;
+                cellOption.rect = rect;
+                style->drawControl(QStyle::CE_ItemViewItem,
+                        &cellOption,
+                        pPainter,
+                        m_pCheckBox);
+            });
 }
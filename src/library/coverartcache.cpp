@@ -2,11 +2,13 @@
 
 #include <QFutureWatcher>
 #include <QPixmapCache>
-#include <QtConcurrent>
+#include <QThread>
 #include <QtDebug>
+#include <algorithm>
 
 #include "moc_coverartcache.cpp"
 #include "track/track.h"
+#include "util/backgroundtask.h"
 #include "util/logger.h"
 #include "util/thread_affinity.h"
 
@@ -19,6 +21,15 @@ QString pixmapCacheKey(mixxx::cache_key_t hash, int width) {
             .arg(QString::number(hash), QString::number(width));
 }
 
+// Covers are loaded from the file system, i.e. more threads would
+// only compete for the same disk.
+const int kMaxLoadingCount = std::clamp(QThread::idealThreadCount() / 2, 1, 4);
+
+// Requests that have exceeded this limit are most likely for rows that
+// have already been scrolled out of view. Their requesters will request
+// them again when repainting.
+constexpr int kMaxPendingLoadCount = 100;
+
 // The transformation mode when scaling images
 const Qt::TransformationMode kTransformationMode = Qt::SmoothTransformation;
 
@@ -29,7 +40,8 @@ inline QImage resizeImageWidth(const QImage& image, int width) {
 
 } // anonymous namespace
 
-CoverArtCache::CoverArtCache() {
+CoverArtCache::CoverArtCache()
+        : m_loadingCount(0) {
 }
 
 //static
@@ -157,37 +169,91 @@ void CoverArtCache::tryLoadCover(
     // This fixes also https://github.com/mixxxdj/mixxx/issues/11131 on
     // Windows where simultaneous open the same file from two threads fails.
     bool requestPending = m_runningRequests.contains(requestedCacheKey);
-    m_runningRequests.insert(requestedCacheKey, {pRequester, desiredWidth});
+    const RequestData request{pRequester, desiredWidth};
+    // Repainting a row while its cover is still loading repeats the request
+    if (!m_runningRequests.contains(requestedCacheKey, request)) {
+        m_runningRequests.insert(requestedCacheKey, request);
+    }
     if (requestPending) {
+        // Move the repeated request to the front, e.g. for rows
+        // that are still visible.
+        const auto i = std::find_if(m_pendingLoads.begin(),
+                m_pendingLoads.end(),
+                [requestedCacheKey](const PendingLoad& pendingLoad) {
+                    return pendingLoad.cacheKey == requestedCacheKey;
+                });
+        if (i != m_pendingLoads.end() && i != m_pendingLoads.begin()) {
+            PendingLoad pendingLoad = std::move(*i);
+            m_pendingLoads.erase(i);
+            m_pendingLoads.prepend(std::move(pendingLoad));
+        }
         return;
     }
 
-    if (kLogger.traceEnabled()) {
-        kLogger.trace()
-                << "requestCover starting future for"
-                << coverInfo;
+    m_pendingLoads.prepend({requestedCacheKey, pTrack, coverInfo, desiredWidth});
+    evictStalePendingLoads();
+    startPendingLoads();
+}
+
+void CoverArtCache::evictStalePendingLoads() {
+    auto i = m_pendingLoads.end();
+    while (m_pendingLoads.size() > kMaxPendingLoadCount &&
+            i != m_pendingLoads.begin()) {
+        --i;
+        // Requests for the original size are not repeated by widgets
+        // and must never be dropped.
+        const auto requests = m_runningRequests.values(i->cacheKey);
+        const bool scaledOnly = std::all_of(requests.cbegin(),
+                requests.cend(),
+                [](const RequestData& request) {
+                    return request.desiredWidth > 0;
+                });
+        if (!scaledOnly) {
+            continue;
+        }
+        if (kLogger.traceEnabled()) {
+            kLogger.trace()
+                    << "Dropping stale request for"
+                    << i->coverInfo;
+        }
+        m_runningRequests.remove(i->cacheKey);
+        i = m_pendingLoads.erase(i);
     }
+}
 
-    // The watcher will be deleted in coverLoaded()
-    QFutureWatcher<FutureResult>* watcher = new QFutureWatcher<FutureResult>(this);
-    QFuture<FutureResult> future = QtConcurrent::run(
-            &CoverArtCache::loadCover,
-            pTrack,
-            coverInfo,
-            desiredWidth);
-    connect(watcher,
-            &QFutureWatcher<FutureResult>::finished,
-            this,
-            &CoverArtCache::coverLoaded);
-    watcher->setFuture(future);
-    return;
+void CoverArtCache::startPendingLoads() {
+    while (m_loadingCount < kMaxLoadingCount && !m_pendingLoads.isEmpty()) {
+        const PendingLoad pendingLoad = m_pendingLoads.takeFirst();
+        if (kLogger.traceEnabled()) {
+            kLogger.trace()
+                    << "requestCover starting future for"
+                    << pendingLoad.coverInfo;
+        }
+        ++m_loadingCount;
+        // The watcher will be deleted in coverLoaded()
+        QFutureWatcher<FutureResult>* watcher = new QFutureWatcher<FutureResult>(this);
+        QFuture<FutureResult> future = mixxx::backgroundtask::run(
+                mixxx::BackgroundTaskPriority::Interactive,
+                [pendingLoad, thumbnailCache = m_thumbnailCache] {
+                    return loadCover(pendingLoad.pTrack,
+                            pendingLoad.coverInfo,
+                            pendingLoad.desiredWidth,
+                            thumbnailCache);
+                });
+        connect(watcher,
+                &QFutureWatcher<FutureResult>::finished,
+                this,
+                &CoverArtCache::coverLoaded);
+        watcher->setFuture(future);
+    }
 }
 
 //static
 CoverArtCache::FutureResult CoverArtCache::loadCover(
         TrackPointer pTrack,
         CoverInfo coverInfo,
-        int desiredWidth) {
+        int desiredWidth,
+        CoverArtThumbnailCache thumbnailCache) {
     if (kLogger.traceEnabled()) {
         kLogger.trace()
                 << "loadCover"
@@ -200,6 +266,25 @@ CoverArtCache::FutureResult CoverArtCache::loadCover(
     auto res = FutureResult(
             coverInfo.cacheKey());
 
+    const int thumbnailWidth = CoverArtThumbnailCache::thumbnailWidth(desiredWidth);
+    if (thumbnailWidth > 0) {
+        QImage thumbnail = thumbnailCache.loadThumbnail(coverInfo, thumbnailWidth);
+        if (!thumbnail.isNull()) {
+            // Skip extracting the original image from the file
+            CoverInfo::LoadedImage loadedImage(CoverInfo::LoadedImage::Result::Ok);
+            loadedImage.location = thumbnailCache.thumbnailFilePath(
+                    coverInfo, thumbnailWidth);
+            loadedImage.image = thumbnailWidth == desiredWidth
+                    ? std::move(thumbnail)
+                    : resizeImageWidth(thumbnail, desiredWidth);
+            res.coverArt = CoverArt(
+                    std::move(coverInfo),
+                    std::move(loadedImage),
+                    desiredWidth);
+            return res;
+        }
+    }
+
     CoverInfo::LoadedImage loadedImage = coverInfo.loadImage(pTrack);
     if (!loadedImage.image.isNull()) {
         if (coverInfo.imageDigest().isEmpty()) {
@@ -220,7 +305,17 @@ CoverArtCache::FutureResult CoverArtCache::loadCover(
         if (desiredWidth > 0) {
             // Adjust the cover size according to the request
             // or downsize the image for efficiency.
-            loadedImage.image = resizeImageWidth(loadedImage.image, desiredWidth);
+            if (thumbnailWidth > 0) {
+                // Scale from the thumbnail like when loading it from the
+                // cache in the next session to get identical results.
+                const QImage thumbnail = thumbnailCache.storeThumbnail(
+                        coverInfo, thumbnailWidth, loadedImage.image);
+                loadedImage.image = thumbnailWidth == desiredWidth
+                        ? thumbnail
+                        : resizeImageWidth(thumbnail, desiredWidth);
+            } else {
+                loadedImage.image = resizeImageWidth(loadedImage.image, desiredWidth);
+            }
         }
     }
 
@@ -243,6 +338,8 @@ void CoverArtCache::coverLoaded() {
         res = pFutureWatcher->result();
         pFutureWatcher->deleteLater();
     }
+    DEBUG_ASSERT(m_loadingCount > 0);
+    --m_loadingCount;
 
     if (kLogger.traceEnabled()) {
         kLogger.trace() << "coverLoaded" << res.coverArt;
@@ -310,4 +407,5 @@ void CoverArtCache::coverLoaded() {
         }
         ++i;
     }
+    startPendingLoads();
 }
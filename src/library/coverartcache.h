@@ -7,6 +7,7 @@
 #include <QtDebug>
 
 #include "library/coverart.h"
+#include "library/coverartthumbnailcache.h"
 #include "track/track_decl.h"
 #include "util/singleton.h"
 
@@ -37,6 +38,12 @@ class CoverArtCache : public QObject, public Singleton<CoverArtCache> {
             const TrackPointer& pTrack,
             int desiredWidth);
 
+    /// Enables the persistent cache of scaled covers. Only invoked
+    /// once during startup before any covers are requested.
+    void setThumbnailCache(const CoverArtThumbnailCache& thumbnailCache) {
+        m_thumbnailCache = thumbnailCache;
+    }
+
     // Only public for testing
     struct FutureResult {
         FutureResult()
@@ -49,12 +56,14 @@ class CoverArtCache : public QObject, public Singleton<CoverArtCache> {
         mixxx::cache_key_t requestedCacheKey;
         CoverArt coverArt;
     };
-    // Load cover from path indicated in coverInfo. WARNING: This is run in a
-    // worker thread.
+    // Load cover from path indicated in coverInfo. Scaled covers are
+    // loaded from and stored in the thumbnail cache if enabled.
+    // WARNING: This is run in a worker thread.
     static FutureResult loadCover(
             TrackPointer pTrack,
             CoverInfo coverInfo,
-            int desiredWidth);
+            int desiredWidth,
+            CoverArtThumbnailCache thumbnailCache = CoverArtThumbnailCache());
 
   private slots:
     // Called when loadCover is complete in the main thread.
@@ -84,9 +93,31 @@ class CoverArtCache : public QObject, public Singleton<CoverArtCache> {
             const CoverInfo& info,
             int desiredWidth);
 
+    void startPendingLoads();
+    void evictStalePendingLoads();
+
     struct RequestData {
         const QObject* pRequester;
         int desiredWidth;
+
+        bool operator==(const RequestData& other) const {
+            return pRequester == other.pRequester &&
+                    desiredWidth == other.desiredWidth;
+        }
     };
+    // All requests for covers that are either pending or loading
     QMultiHash<mixxx::cache_key_t, RequestData> m_runningRequests;
+
+    struct PendingLoad {
+        mixxx::cache_key_t cacheKey;
+        TrackPointer pTrack;
+        CoverInfo coverInfo;
+        int desiredWidth;
+    };
+    // Covers that have been requested but not yet started loading,
+    // ordered by priority. The most recent request comes first.
+    QList<PendingLoad> m_pendingLoads;
+    int m_loadingCount;
+
+    CoverArtThumbnailCache m_thumbnailCache;
 };
@@ -0,0 +1,160 @@
+#include "library/coverartthumbnailcache.h"
+
+#include <QDir>
+#include <QFileInfo>
+#include <QSaveFile>
+
+#include "track/track.h"
+#include "util/logger.h"
+
+namespace {
+
+const mixxx::Logger kLogger("CoverArtThumbnailCache");
+
+const ConfigKey kEnabledConfigKey =
+        ConfigKey(QStringLiteral("[Library]"),
+                QStringLiteral("CoverArtThumbnailCache"));
+
+const QString kDirectoryName = QStringLiteral("coverart_thumbnails");
+
+// JPEG is much smaller than PNG and all that is needed for the small
+// thumbnails. Images with an alpha channel are not cached.
+const char* const kImageFormat = "JPG";
+const QString kFileSuffix = QStringLiteral(".jpg");
+constexpr int kImageQuality = 90;
+
+// Sorted in ascending order
+constexpr int kThumbnailWidths[] = {64, 128, 256, 512};
+
+// The cover column of the library table is usually smaller than this,
+// even on HiDPI screens
+constexpr int kMaxPrewarmWidth = 128;
+
+} // anonymous namespace
+
+CoverArtThumbnailCache::CoverArtThumbnailCache(const QString& directory)
+        : m_directory(directory) {
+}
+
+//static
+CoverArtThumbnailCache CoverArtThumbnailCache::fromConfig(
+        const UserSettingsPointer& pConfig) {
+    if (!pConfig->getValue(kEnabledConfigKey, true)) {
+        return CoverArtThumbnailCache();
+    }
+    return CoverArtThumbnailCache(
+            QDir(pConfig->getSettingsPath()).filePath(kDirectoryName));
+}
+
+//static
+int CoverArtThumbnailCache::thumbnailWidth(int desiredWidth) {
+    if (desiredWidth <= 0) {
+        // Original size
+        return 0;
+    }
+    for (const int width : kThumbnailWidths) {
+        if (width >= desiredWidth) {
+            return width;
+        }
+    }
+    return 0;
+}
+
+QString CoverArtThumbnailCache::thumbnailFilePath(
+        const CoverInfo& coverInfo,
+        int thumbnailWidth) const {
+    DEBUG_ASSERT(isEnabled());
+    const QString cacheKey = QStringLiteral("%1").arg(
+            coverInfo.cacheKey(), 16, 16, QChar('0'));
+    // Distribute the files among subdirectories to keep them small
+    return QStringLiteral("%1/%2/%3_%4%5")
+            .arg(m_directory,
+                    cacheKey.left(2),
+                    cacheKey,
+                    QString::number(thumbnailWidth),
+                    kFileSuffix);
+}
+
+QImage CoverArtThumbnailCache::loadThumbnail(
+        const CoverInfo& coverInfo,
+        int thumbnailWidth) const {
+    if (!isEnabled() || !isCacheable(coverInfo) || thumbnailWidth <= 0) {
+        return QImage();
+    }
+    const QString filePath = thumbnailFilePath(coverInfo, thumbnailWidth);
+    if (!QFileInfo::exists(filePath)) {
+        return QImage();
+    }
+    QImage image(filePath, kImageFormat);
+    if (image.width() != thumbnailWidth) {
+        kLogger.warning()
+                << "Ignoring invalid thumbnail"
+                << filePath;
+        return QImage();
+    }
+    return image;
+}
+
+QImage CoverArtThumbnailCache::storeThumbnail(
+        const CoverInfo& coverInfo,
+        int thumbnailWidth,
+        const QImage& image) const {
+    VERIFY_OR_DEBUG_ASSERT(thumbnailWidth > 0 && !image.isNull()) {
+        return image;
+    }
+    const QImage thumbnail = image.scaledToWidth(
+            thumbnailWidth, Qt::SmoothTransformation);
+    if (!isEnabled() || !isCacheable(coverInfo) || image.hasAlphaChannel()) {
+        return thumbnail;
+    }
+    const QString filePath = thumbnailFilePath(coverInfo, thumbnailWidth);
+    if (!QDir().mkpath(QFileInfo(filePath).absolutePath())) {
+        kLogger.warning()
+                << "Failed to create directory for"
+                << filePath;
+        return thumbnail;
+    }
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly) ||
+            !thumbnail.save(&file, kImageFormat, kImageQuality) ||
+            !file.commit()) {
+        kLogger.warning()
+                << "Failed to store thumbnail"
+                << filePath
+                << file.errorString();
+    }
+    return thumbnail;
+}
+
+bool CoverArtThumbnailCache::prewarm(const TrackPointer& pTrack) const {
+    VERIFY_OR_DEBUG_ASSERT(pTrack) {
+        return false;
+    }
+    if (!isEnabled()) {
+        return false;
+    }
+    const CoverInfo coverInfo = pTrack->getCoverInfoWithLocation();
+    if (!isCacheable(coverInfo)) {
+        return false;
+    }
+    QList<int> missingWidths;
+    for (const int width : kThumbnailWidths) {
+        if (width > kMaxPrewarmWidth) {
+            break;
+        }
+        if (!QFileInfo::exists(thumbnailFilePath(coverInfo, width))) {
+            missingWidths.append(width);
+        }
+    }
+    if (missingWidths.isEmpty()) {
+        return false;
+    }
+    const CoverInfo::LoadedImage loadedImage = coverInfo.loadImage(pTrack);
+    if (loadedImage.image.isNull()) {
+        return false;
+    }
+    for (const int width : std::as_const(missingWidths)) {
+        storeThumbnail(coverInfo, width, loadedImage.image);
+    }
+    return true;
+}
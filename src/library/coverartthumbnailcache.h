@@ -0,0 +1,69 @@
+#pragma once
+
+#include <QImage>
+#include <QString>
+
+#include "library/coverart.h"
+#include "preferences/usersettings.h"
+#include "track/track_decl.h"
+
+/// A persistent cache of downscaled cover art images on disk.
+///
+/// Thumbnails are stored in a few fixed widths and keyed by the
+/// cache key of the image digest in CoverInfo. Requests for other
+/// widths are served by scaling down the next larger thumbnail,
+/// which is much cheaper than extracting the embedded image from
+/// the track file again in every session.
+///
+/// All functions only access the file system and may be invoked
+/// from any thread. Concurrent writes of the same thumbnail are
+/// harmless, because files are replaced atomically.
+class CoverArtThumbnailCache {
+  public:
+    /// A disabled cache that neither loads nor stores any thumbnails.
+    CoverArtThumbnailCache() = default;
+    explicit CoverArtThumbnailCache(const QString& directory);
+
+    /// Returns a disabled cache if the thumbnail cache has been
+    /// disabled in the settings.
+    static CoverArtThumbnailCache fromConfig(const UserSettingsPointer& pConfig);
+
+    bool isEnabled() const {
+        return !m_directory.isEmpty();
+    }
+
+    /// Returns the width of the cached thumbnail that is used for
+    /// the desired width or 0 if images of this size are not cached.
+    static int thumbnailWidth(int desiredWidth);
+
+    /// Only covers with an image digest can be cached. Legacy hashes
+    /// are replaced after loading the original image.
+    static bool isCacheable(const CoverInfo& coverInfo) {
+        return coverInfo.hasImage() && !coverInfo.imageDigest().isEmpty();
+    }
+
+    QString thumbnailFilePath(
+            const CoverInfo& coverInfo,
+            int thumbnailWidth) const;
+
+    /// Returns a null image on a cache miss.
+    QImage loadThumbnail(
+            const CoverInfo& coverInfo,
+            int thumbnailWidth) const;
+
+    /// Scales the original image to the width of the thumbnail,
+    /// stores it, and returns the scaled image.
+    QImage storeThumbnail(
+            const CoverInfo& coverInfo,
+            int thumbnailWidth,
+            const QImage& image) const;
+
+    /// Stores the thumbnails that are used by the library table, if
+    /// not available yet. This extracts the cover image from the track
+    /// and is intended to be invoked from a worker thread after adding
+    /// or analyzing tracks. Returns true if any thumbnail was stored.
+    bool prewarm(const TrackPointer& pTrack) const;
+
+  private:
+    QString m_directory;
+};
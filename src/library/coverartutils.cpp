@@ -106,14 +106,23 @@ CoverInfoRelative CoverArtUtils::selectCoverArtForTrack(
         const mixxx::FileInfo& trackFile,
         const QString& albumName,
         const QList<QFileInfo>& covers) {
-    CoverInfoRelative coverInfoRelative;
-    DEBUG_ASSERT(coverInfoRelative.type == CoverInfo::NONE);
-    DEBUG_ASSERT(coverInfoRelative.imageDigest().isNull());
-    DEBUG_ASSERT(coverInfoRelative.coverLocation.isNull());
-    coverInfoRelative.source = CoverInfo::GUESSED;
-    if (covers.isEmpty()) {
+    const QFileInfo* pCoverFile = selectCoverFileForTrack(trackFile, albumName, covers);
+    if (!pCoverFile) {
+        CoverInfoRelative coverInfoRelative;
+        coverInfoRelative.source = CoverInfo::GUESSED;
         return coverInfoRelative;
     }
+    return loadCoverFile(*pCoverFile);
+}
+
+//static
+const QFileInfo* CoverArtUtils::selectCoverFileForTrack(
+        const mixxx::FileInfo& trackFile,
+        const QString& albumName,
+        const QList<QFileInfo>& covers) {
+    if (covers.isEmpty()) {
+        return nullptr;
+    }
 
     PreferredCoverType bestType = NONE;
     const QFileInfo* bestInfo = nullptr;
@@ -171,15 +180,23 @@ CoverInfoRelative CoverArtUtils::selectCoverArtForTrack(
         }
     }
 
-    if (bestInfo) {
-        const QImage image(bestInfo->filePath());
-        if (!image.isNull()) {
-            coverInfoRelative.type = CoverInfo::FILE;
-            coverInfoRelative.coverLocation = bestInfo->fileName();
-            coverInfoRelative.setImageDigest(image);
-        }
-    }
+    return bestInfo;
+}
 
+//static
+CoverInfoRelative CoverArtUtils::loadCoverFile(
+        const QFileInfo& coverFile) {
+    CoverInfoRelative coverInfoRelative;
+    DEBUG_ASSERT(coverInfoRelative.type == CoverInfo::NONE);
+    DEBUG_ASSERT(coverInfoRelative.imageDigest().isNull());
+    DEBUG_ASSERT(coverInfoRelative.coverLocation.isNull());
+    coverInfoRelative.source = CoverInfo::GUESSED;
+    const QImage image(coverFile.filePath());
+    if (!image.isNull()) {
+        coverInfoRelative.type = CoverInfo::FILE;
+        coverInfoRelative.coverLocation = coverFile.fileName();
+        coverInfoRelative.setImageDigest(image);
+    }
     return coverInfoRelative;
 }
 
@@ -197,16 +214,38 @@ CoverInfoRelative CoverInfoGuesser::guessCoverInfo(
     }
 
     const auto trackFolder = trackFile.locationPath();
-    if (trackFolder != m_cachedFolder) {
-        m_cachedFolder = trackFile.locationPath();
+    const auto folderLastModified = QFileInfo(trackFolder).lastModified();
+    if (trackFolder != m_cachedFolder ||
+            folderLastModified != m_cachedFolderLastModified) {
+        m_cachedFolder = trackFolder;
+        m_cachedFolderLastModified = folderLastModified;
         m_cachedPossibleCoversInFolder =
                 CoverArtUtils::findPossibleCoversInFolder(
                         m_cachedFolder);
+        m_cachedCoverFiles.clear();
     }
-    return CoverArtUtils::selectCoverArtForTrack(
+    const QFileInfo* pCoverFile = CoverArtUtils::selectCoverFileForTrack(
             trackFile,
             albumName,
             m_cachedPossibleCoversInFolder);
+    if (!pCoverFile) {
+        CoverInfoRelative coverInfo;
+        coverInfo.source = CoverInfo::GUESSED;
+        return coverInfo;
+    }
+
+    // Decoding and hashing the image again for every track of an
+    // album would be wasted, unless the image has been replaced.
+    const auto coverLastModified = QFileInfo(pCoverFile->filePath()).lastModified();
+    const auto cachedCoverFile = m_cachedCoverFiles.constFind(pCoverFile->fileName());
+    if (cachedCoverFile != m_cachedCoverFiles.constEnd() &&
+            cachedCoverFile->lastModified == coverLastModified) {
+        return cachedCoverFile->coverInfo;
+    }
+    const auto coverInfo = CoverArtUtils::loadCoverFile(*pCoverFile);
+    m_cachedCoverFiles.insert(pCoverFile->fileName(),
+            CachedCoverFile{coverLastModified, coverInfo});
+    return coverInfo;
 }
 
 CoverInfoRelative CoverInfoGuesser::guessCoverInfoForTrack(
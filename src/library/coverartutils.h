@@ -1,17 +1,18 @@
 #pragma once
 
+#include <QDateTime>
 #include <QFileInfo>
 #include <QFuture>
+#include <QHash>
 #include <QImage>
 #include <QList>
 #include <QSize>
 #include <QString>
 #include <QStringList>
 
+#include "library/coverart.h"
 #include "track/track_decl.h"
 
-class CoverInfoRelative;
-
 namespace mixxx {
 
 class FileInfo;
@@ -63,10 +64,23 @@ class CoverArtUtils {
             const mixxx::FileInfo& trackFile,
             const QString& albumName,
             const QList<QFileInfo>& covers);
+
+    // Selects an appropriate cover file from provided list of image files
+    // without loading it. Returns nullptr or a pointer into 'covers'.
+    static const QFileInfo* selectCoverFileForTrack(
+            const mixxx::FileInfo& trackFile,
+            const QString& albumName,
+            const QList<QFileInfo>& covers);
+
+    // Loads the selected cover file. The type is NONE if the image
+    // could not be loaded.
+    static CoverInfoRelative loadCoverFile(
+            const QFileInfo& coverFile);
 };
 
 // Stateful guessing of cover art by caching the possible
-// covers from the last visited folder.
+// covers from the last visited folder and the images that have
+// been loaded from it, e.g. while scanning the tracks of an album.
 class CoverInfoGuesser {
   public:
     // Guesses the cover art for the provided track.
@@ -86,8 +100,17 @@ class CoverInfoGuesser {
             const TrackPointerList& tracks);
 
   private:
+    struct CachedCoverFile {
+        QDateTime lastModified;
+        CoverInfoRelative coverInfo;
+    };
+
     QString m_cachedFolder;
+    // Adding or removing files modifies the folder
+    QDateTime m_cachedFolderLastModified;
     QList<QFileInfo> m_cachedPossibleCoversInFolder;
+    // By file name in the cached folder
+    QHash<QString, CachedCoverFile> m_cachedCoverFiles;
 };
 
 // Guesses the cover art for the provided tracks by searching the tracks'
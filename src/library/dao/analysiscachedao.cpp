@@ -0,0 +1,106 @@
+#include "library/dao/analysiscachedao.h"
+
+#include <QSqlQuery>
+#include <QSqlRecord>
+#include <QVariant>
+
+#include "library/queryutil.h"
+
+const QString AnalysisCacheDao::s_analysisCacheTableName = "analysis_cache";
+
+namespace {
+
+QVariant positionOrNull(double position) {
+    return position >= 0 ? QVariant(position) : QVariant();
+}
+
+double positionOrUnknown(const QVariant& value) {
+    return value.isNull() ? -1.0 : value.toDouble();
+}
+
+} // anonymous namespace
+
+std::optional<AnalysisCacheDao::Entry> AnalysisCacheDao::getEntry(
+        const QByteArray& fingerprint) const {
+    if (!m_database.isOpen() || fingerprint.isEmpty()) {
+        return std::nullopt;
+    }
+
+    QSqlQuery query(m_database);
+    query.prepare(QString(
+            "SELECT track_id, sample_rate, "
+            "beats_version, beats_sub_version, beats, "
+            "keys_version, keys_sub_version, keys, "
+            "replaygain, replaygain_peak, sound_start, sound_end "
+            "FROM %1 WHERE fingerprint=:fingerprint")
+                          .arg(s_analysisCacheTableName));
+    query.bindValue(":fingerprint", fingerprint);
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query);
+        return std::nullopt;
+    }
+    if (!query.next()) {
+        return std::nullopt;
+    }
+
+    const QSqlRecord record = query.record();
+    Entry entry;
+    entry.trackId = TrackId(query.value(record.indexOf("track_id")));
+    entry.sampleRate = query.value(record.indexOf("sample_rate")).toInt();
+    entry.beatsVersion = query.value(record.indexOf("beats_version")).toString();
+    entry.beatsSubVersion = query.value(record.indexOf("beats_sub_version")).toString();
+    entry.beats = query.value(record.indexOf("beats")).toByteArray();
+    entry.keysVersion = query.value(record.indexOf("keys_version")).toString();
+    entry.keysSubVersion = query.value(record.indexOf("keys_sub_version")).toString();
+    entry.keys = query.value(record.indexOf("keys")).toByteArray();
+    const QVariant replayGain = query.value(record.indexOf("replaygain"));
+    if (!replayGain.isNull()) {
+        entry.replayGain.setRatio(replayGain.toDouble());
+        entry.replayGain.setPeak(static_cast<CSAMPLE>(
+                query.value(record.indexOf("replaygain_peak")).toDouble()));
+    }
+    entry.soundStart = positionOrUnknown(query.value(record.indexOf("sound_start")));
+    entry.soundEnd = positionOrUnknown(query.value(record.indexOf("sound_end")));
+    return entry;
+}
+
+bool AnalysisCacheDao::saveEntry(const QByteArray& fingerprint, const Entry& entry) {
+    if (!m_database.isOpen() || fingerprint.isEmpty()) {
+        return false;
+    }
+
+    QSqlQuery query(m_database);
+    query.prepare(QString(
+            "INSERT OR REPLACE INTO %1 (fingerprint, track_id, sample_rate, "
+            "beats_version, beats_sub_version, beats, "
+            "keys_version, keys_sub_version, keys, "
+            "replaygain, replaygain_peak, sound_start, sound_end) "
+            "VALUES (:fingerprint, :track_id, :sample_rate, "
+            ":beats_version, :beats_sub_version, :beats, "
+            ":keys_version, :keys_sub_version, :keys, "
+            ":replaygain, :replaygain_peak, :sound_start, :sound_end)")
+                          .arg(s_analysisCacheTableName));
+    query.bindValue(":fingerprint", fingerprint);
+    query.bindValue(":track_id", entry.trackId.toVariant());
+    query.bindValue(":sample_rate", entry.sampleRate);
+    query.bindValue(":beats_version", entry.beatsVersion);
+    query.bindValue(":beats_sub_version", entry.beatsSubVersion);
+    query.bindValue(":beats", entry.beats);
+    query.bindValue(":keys_version", entry.keysVersion);
+    query.bindValue(":keys_sub_version", entry.keysSubVersion);
+    query.bindValue(":keys", entry.keys);
+    if (entry.replayGain.hasRatio()) {
+        query.bindValue(":replaygain", entry.replayGain.getRatio());
+        query.bindValue(":replaygain_peak", entry.replayGain.getPeak());
+    } else {
+        query.bindValue(":replaygain", QVariant());
+        query.bindValue(":replaygain_peak", QVariant());
+    }
+    query.bindValue(":sound_start", positionOrNull(entry.soundStart));
+    query.bindValue(":sound_end", positionOrNull(entry.soundEnd));
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query);
+        return false;
+    }
+    return true;
+}
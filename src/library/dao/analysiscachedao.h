@@ -0,0 +1,38 @@
+#pragma once
+
+#include <QByteArray>
+#include <QString>
+#include <optional>
+
+#include "library/dao/dao.h"
+#include "track/replaygain.h"
+#include "track/trackid.h"
+
+/// Stores the analysis results of tracks by a fingerprint of their
+/// decoded audio, for reusing them when the same audio is found in
+/// another file, e.g. a copy with different tags.
+class AnalysisCacheDao : public DAO {
+  public:
+    static const QString s_analysisCacheTableName;
+
+    struct Entry {
+        /// The track with the results, its waveforms are copied
+        TrackId trackId;
+        int sampleRate = 0;
+        QString beatsVersion;
+        QString beatsSubVersion;
+        QByteArray beats;
+        QString keysVersion;
+        QString keysSubVersion;
+        QByteArray keys;
+        mixxx::ReplayGain replayGain;
+        /// The first and last sound in frames, negative if unknown
+        double soundStart = -1.0;
+        double soundEnd = -1.0;
+    };
+
+    ~AnalysisCacheDao() override = default;
+
+    std::optional<Entry> getEntry(const QByteArray& fingerprint) const;
+    bool saveEntry(const QByteArray& fingerprint, const Entry& entry);
+};
@@ -1,5 +1,6 @@
 #include "library/dao/analysisdao.h"
 
+#include <QDirIterator>
 #include <QSqlQuery>
 #include <QtDebug>
 
@@ -16,8 +17,37 @@ const QString AnalysisDao::s_analysisTableName = "track_analysis";
 // CPU time so I think we should stick with the default. rryan 4/3/2012
 constexpr int kCompressionLevel = -1;
 
+namespace {
+
+int checksumOf(const QByteArray& data) {
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+    return qChecksum(data);
+#else
+    return qChecksum(data.constData(), data.length());
+#endif
+}
+
+/// Never compact the store without knowing which analyses are still
+/// needed, i.e. if the query fails
+bool loadAllAnalysisIds(const QSqlDatabase& database, QSet<int>* pAnalysisIds) {
+    QSqlQuery query(database);
+    query.prepare(QString("SELECT id FROM %1").arg(AnalysisDao::s_analysisTableName));
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query) << "couldn't get analyses";
+        return false;
+    }
+    while (query.next()) {
+        pAnalysisIds->insert(query.value(0).toInt());
+    }
+    return true;
+}
+
+} // anonymous namespace
+
 AnalysisDao::AnalysisDao(UserSettingsPointer pConfig)
-        : m_pConfig(pConfig) {
+        : m_pConfig(pConfig),
+          m_pStore(AnalysisStore::forDirectory(
+                  getAnalysisStoragePath().absoluteFilePath(QStringLiteral("store")))) {
     QDir storagePath = getAnalysisStoragePath();
     if (!QDir().mkpath(storagePath.absolutePath())) {
         qDebug() << "WARNING: Could not create analysis storage path. Mixxx will be unable to store analyses.";
@@ -54,6 +84,30 @@ QList<AnalysisDao::AnalysisInfo> AnalysisDao::getAnalysesForTrackByType(
     return loadAnalysesFromQuery(trackId, &query);
 }
 
+QList<int> AnalysisDao::getAnalysisIdsForTrackByType(
+        TrackId trackId, AnalysisType type) {
+    QList<int> analysisIds;
+    if (!m_database.isOpen() || !trackId.isValid()) {
+        return analysisIds;
+    }
+
+    QSqlQuery query(m_database);
+    query.prepare(QString(
+            "SELECT id FROM %1 "
+            "WHERE track_id=:trackId AND type=:type")
+                          .arg(s_analysisTableName));
+    query.bindValue(":trackId", trackId.toVariant());
+    query.bindValue(":type", type);
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query) << "couldn't get analysis ids for track" << trackId;
+        return analysisIds;
+    }
+    while (query.next()) {
+        analysisIds.append(query.value(0).toInt());
+    }
+    return analysisIds;
+}
+
 QList<AnalysisDao::AnalysisInfo> AnalysisDao::loadAnalysesFromQuery(TrackId trackId, QSqlQuery* query) {
     QList<AnalysisDao::AnalysisInfo> analyses;
     PerformanceTimer time;
@@ -72,7 +126,6 @@ QList<AnalysisDao::AnalysisInfo> AnalysisDao::loadAnalysesFromQuery(TrackId trac
     const int versionColumn = queryRecord.indexOf("version");
     const int dataChecksumColumn = queryRecord.indexOf("data_checksum");
 
-    QDir analysisPath(getAnalysisStoragePath());
     while (query->next()) {
         AnalysisDao::AnalysisInfo info;
         info.analysisId = query->value(idColumn).toInt();
@@ -81,23 +134,20 @@ QList<AnalysisDao::AnalysisInfo> AnalysisDao::loadAnalysesFromQuery(TrackId trac
         info.description = query->value(descriptionColumn).toString();
         info.version = query->value(versionColumn).toString();
         int checksum = query->value(dataChecksumColumn).toInt();
-        QString dataPath = analysisPath.absoluteFilePath(
-            QString::number(info.analysisId));
-        const QByteArray compressedData = loadDataFromFile(dataPath);
-#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
-        const int file_checksum = qChecksum(
-                compressedData);
-#else
-        const int file_checksum = qChecksum(
-                compressedData.constData(),
-                compressedData.length());
-#endif
-        if (checksum != file_checksum) {
-            qDebug() << "WARNING: Corrupt analysis loaded from" << dataPath
-                     << "length" << compressedData.length();
+        AnalysisStore::Format format = AnalysisStore::Format::Zlib;
+        QByteArray storedData = m_pStore->read(info.analysisId, &format);
+        if (storedData.isNull()) {
+            storedData = migrateDataFromFile(info.analysisId);
+        }
+        if (checksum != checksumOf(storedData)) {
+            qDebug() << "WARNING: Corrupt analysis" << info.analysisId
+                     << "length" << storedData.length();
             continue;
         }
-        info.data = qUncompress(compressedData);
+        // Raw data is used without copying it
+        info.data = format == AnalysisStore::Format::Zlib
+                ? qUncompress(storedData)
+                : storedData;
         bytes += info.data.length();
         analyses.append(info);
     }
@@ -119,15 +169,14 @@ bool AnalysisDao::saveAnalysis(AnalysisDao::AnalysisInfo* info) {
     PerformanceTimer time;
     time.start();
 
-    const QByteArray compressedData = qCompress(info->data, kCompressionLevel);
-#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
-    const int checksum = qChecksum(
-            compressedData);
-#else
-    const int checksum = qChecksum(
-            compressedData.constData(),
-            compressedData.length());
-#endif
+    // Waveforms in the raw layout are stored as is for mapping them
+    const auto format = Waveform::isRawByteArray(info->data)
+            ? AnalysisStore::Format::Raw
+            : AnalysisStore::Format::Zlib;
+    const QByteArray storedData = format == AnalysisStore::Format::Raw
+            ? info->data
+            : qCompress(info->data, kCompressionLevel);
+    const int checksum = checksumOf(storedData);
     QSqlQuery query(m_database);
     if (info->analysisId == -1) {
         query.prepare(QString(
@@ -169,16 +218,17 @@ bool AnalysisDao::saveAnalysis(AnalysisDao::AnalysisInfo* info) {
         }
     }
 
-    QString dataPath = getAnalysisStoragePath().absoluteFilePath(
-        QString::number(info->analysisId));
-    if (!saveDataToFile(dataPath, compressedData)) {
-        qDebug() << "WARNING: Couldn't save analysis data to file" << dataPath;
+    if (!m_pStore->write(info->analysisId, storedData, format)) {
+        qDebug() << "WARNING: Couldn't save analysis data" << info->analysisId;
         return false;
     }
+    // Replaces the file of a previous version
+    deleteFile(getAnalysisStoragePath().absoluteFilePath(
+            QString::number(info->analysisId)));
 
     qDebug() << "AnalysisDAO saved analysis" << info->analysisId
-             << QString("%1 (%2 compressed)").arg(QString::number(info->data.length()),
-                                                  QString::number(compressedData.length()))
+             << QString("%1 (%2 stored)").arg(QString::number(info->data.length()),
+                                                  QString::number(storedData.length()))
              << "bytes for track"
              << info->trackId << "in" << time.elapsed().debugMillisWithUnit();
     return true;
@@ -198,9 +248,7 @@ bool AnalysisDao::deleteAnalysis(const int analysisId) {
         return false;
     }
 
-    QString dataPath = getAnalysisStoragePath().absoluteFilePath(
-        QString::number(analysisId));
-    deleteFile(dataPath);
+    deleteData(analysisId);
     return true;
 }
 
@@ -216,11 +264,8 @@ void AnalysisDao::deleteAnalyses(const QList<TrackId>& trackIds) {
         LOG_FAILED_QUERY(query) << "couldn't delete analysis";
     }
     const int idColumn = query.record().indexOf("id");
-    QDir analysisPath(getAnalysisStoragePath());
     while (query.next()) {
-        int id = query.value(idColumn).toInt();
-        QString dataPath = analysisPath.absoluteFilePath(QString::number(id));
-        deleteFile(dataPath);
+        deleteData(query.value(idColumn).toInt());
     }
     query.prepare(QString("DELETE FROM track_analysis "
                           "WHERE track_id in (%1)").arg(idList.join(",")));
@@ -277,41 +322,24 @@ bool AnalysisDao::deleteFile(const QString& fileName) const {
     return file.remove();
 }
 
-bool AnalysisDao::saveDataToFile(const QString& fileName, const QByteArray& data) const {
-    QFile file(fileName);
-
-    // If the file exists, do the right thing. Write to a temp file, unlink the
-    // existing file, and then move the temp file to the real file's name.
-    if (file.exists()) {
-        QString tempFileName = fileName + ".tmp";
-        QFile tempFile(tempFileName);
-        if (!tempFile.open(QIODevice::WriteOnly)) {
-            return false;
-        }
-        int bytesWritten = tempFile.write(data);
-        if (bytesWritten == -1 || bytesWritten != data.length()) {
-            return false;
-        }
-        tempFile.close();
-        if (!file.remove()) {
-            return false;
-        }
-        if (!tempFile.rename(fileName)) {
-            return false;
-        }
-        return true;
+QByteArray AnalysisDao::migrateDataFromFile(int analysisId) const {
+    const QString dataPath = getAnalysisStoragePath().absoluteFilePath(
+            QString::number(analysisId));
+    const QByteArray compressedData = loadDataFromFile(dataPath);
+    if (compressedData.isNull()) {
+        return compressedData;
     }
-
-    // If the file doesn't exist, just create a new file and write the data.
-    if (!file.open(QIODevice::WriteOnly)) {
-        return false;
-    }
-    int bytesWritten = file.write(data);
-    if (bytesWritten == -1 || bytesWritten != data.length()) {
-        return false;
+    // The checksum in the database covers the compressed data
+    if (m_pStore->write(analysisId, compressedData, AnalysisStore::Format::Zlib)) {
+        deleteFile(dataPath);
     }
-    file.close();
-    return true;
+    return compressedData;
+}
+
+void AnalysisDao::deleteData(int analysisId) const {
+    m_pStore->remove(analysisId);
+    deleteFile(getAnalysisStoragePath().absoluteFilePath(
+            QString::number(analysisId)));
 }
 
 void AnalysisDao::saveTrackAnalyses(
@@ -339,7 +367,7 @@ void AnalysisDao::saveTrackAnalyses(
     analysis.type = AnalysisDao::TYPE_WAVEFORM;
     analysis.description = pWaveform->getDescription();
     analysis.version = pWaveform->getVersion();
-    analysis.data = pWaveform->toByteArray();
+    analysis.data = pWaveform->toRawByteArray();
     bool success = saveAnalysis(&analysis);
     if (success) {
         pWaveform->setSaveState(Waveform::SaveState::Saved);
@@ -354,7 +382,7 @@ void AnalysisDao::saveTrackAnalyses(
     analysis.type = AnalysisDao::TYPE_WAVESUMMARY;
     analysis.description = pWaveSummary->getDescription();
     analysis.version = pWaveSummary->getVersion();
-    analysis.data = pWaveSummary->toByteArray();
+    analysis.data = pWaveSummary->toRawByteArray();
 
     success = saveAnalysis(&analysis);
     if (success) {
@@ -382,8 +410,13 @@ size_t AnalysisDao::getDiskUsageInBytes(
     const int idColumn = query.record().indexOf("id");
     size_t total = 0;
     while (query.next()) {
-        total += QFileInfo(analysisPath.absoluteFilePath(
-                query.value(idColumn).toString())).size();
+        const qint64 storedSize = m_pStore->storedSize(query.value(idColumn).toInt());
+        if (storedSize >= 0) {
+            total += storedSize;
+        } else {
+            total += QFileInfo(analysisPath.absoluteFilePath(
+                    query.value(idColumn).toString())).size();
+        }
     }
     return total;
 }
@@ -391,8 +424,6 @@ size_t AnalysisDao::getDiskUsageInBytes(
 bool AnalysisDao::deleteAnalysesByType(
         const QSqlDatabase& database,
         AnalysisType type) const {
-    QDir analysisPath(getAnalysisStoragePath());
-
     QSqlQuery query(database);
     query.prepare(QString("SELECT id FROM %1 WHERE type=:type").arg(s_analysisTableName));
     query.bindValue(":type", type);
@@ -404,8 +435,7 @@ bool AnalysisDao::deleteAnalysesByType(
 
     const int idColumn = query.record().indexOf("id");
     while (query.next()) {
-        QString dataPath = analysisPath.absoluteFilePath(query.value(idColumn).toString());
-        deleteFile(dataPath);
+        deleteData(query.value(idColumn).toInt());
     }
     query.prepare(QString("DELETE FROM %1 WHERE type=:type").arg(s_analysisTableName));
     query.bindValue(":type", type);
@@ -413,5 +443,54 @@ bool AnalysisDao::deleteAnalysesByType(
         LOG_FAILED_QUERY(query) << "couldn't delete analysis";
     }
 
+    // Reclaim the space of the deleted analyses right away
+    compactStore(database);
     return true;
 }
+
+void AnalysisDao::compactStore(const QSqlDatabase& database) const {
+    QSet<int> liveAnalysisIds;
+    if (loadAllAnalysisIds(database, &liveAnalysisIds)) {
+        m_pStore->compact(liveAnalysisIds);
+    }
+}
+
+void AnalysisDao::collectGarbage(const QSqlDatabase& database) const {
+    PerformanceTimer time;
+    time.start();
+
+    QSet<int> liveAnalysisIds;
+    if (!loadAllAnalysisIds(database, &liveAnalysisIds)) {
+        return;
+    }
+
+    // Files of previous versions that are named after the analysis id
+    int migratedFiles = 0;
+    int deletedFiles = 0;
+    QDirIterator it(getAnalysisStoragePath().absolutePath(), QDir::Files);
+    while (it.hasNext()) {
+        const QString dataPath = it.next();
+        bool ok = false;
+        const int analysisId = it.fileName().toInt(&ok);
+        if (!ok) {
+            continue;
+        }
+        if (!liveAnalysisIds.contains(analysisId)) {
+            deleteFile(dataPath);
+            ++deletedFiles;
+        } else if (!m_pStore->contains(analysisId)) {
+            migrateDataFromFile(analysisId);
+            ++migratedFiles;
+        } else {
+            // Superseded by the data in the store
+            deleteFile(dataPath);
+            ++deletedFiles;
+        }
+    }
+
+    const qint64 reclaimedBytes = m_pStore->compact(liveAnalysisIds);
+    qDebug() << "AnalysisDAO migrated" << migratedFiles
+             << "and deleted" << deletedFiles << "files,"
+             << "reclaimed" << reclaimedBytes << "bytes in"
+             << time.elapsed().debugMillisWithUnit();
+}
@@ -1,8 +1,10 @@
 #pragma once
 
 #include <QDir>
+#include <memory>
 
 #include "preferences/usersettings.h"
+#include "library/dao/analysisstore.h"
 #include "library/dao/dao.h"
 #include "track/trackid.h"
 #include "waveform/waveform.h"
@@ -44,8 +46,14 @@ class AnalysisDao : public DAO {
     size_t getDiskUsageInBytes(
             const QSqlDatabase& database,
             AnalysisType type) const;
+    // Deletes the data of analyses that are no longer referenced by the
+    // database, migrates the remaining files of previous versions into
+    // the store and compacts it.
+    void collectGarbage(const QSqlDatabase& database) const;
 
     QList<AnalysisInfo> getAnalysesForTrackByType(TrackId trackId, AnalysisType type);
+    // Same order as getAnalysesForTrackByType(), without loading the data
+    QList<int> getAnalysisIdsForTrackByType(TrackId trackId, AnalysisType type);
     QList<AnalysisInfo> getAnalysesForTrack(TrackId trackId);
     bool saveAnalysis(AnalysisInfo* analysis);
     bool deleteAnalysis(const int analysisId);
@@ -60,9 +68,14 @@ class AnalysisDao : public DAO {
   private:
     QDir getAnalysisStoragePath() const;
     QByteArray loadDataFromFile(const QString& fileName) const;
-    bool saveDataToFile(const QString& fileName, const QByteArray& data) const;
     bool deleteFile(const QString& filename) const;
+    // Moves the compressed data of a previous version from its own file
+    // into the store
+    QByteArray migrateDataFromFile(int analysisId) const;
+    void deleteData(int analysisId) const;
+    void compactStore(const QSqlDatabase& database) const;
     QList<AnalysisInfo> loadAnalysesFromQuery(TrackId trackId, QSqlQuery* query);
 
     const UserSettingsPointer m_pConfig;
+    const std::shared_ptr<AnalysisStore> m_pStore;
 };
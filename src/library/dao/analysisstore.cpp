@@ -0,0 +1,472 @@
+#include "library/dao/analysisstore.h"
+
+#include <QDir>
+#include <QMap>
+#include <algorithm>
+#include <iterator>
+#include <utility>
+
+#include "util/assert.h"
+#include "util/compatibility/qmutex.h"
+#include "util/logger.h"
+
+namespace {
+
+const mixxx::Logger kLogger("AnalysisStore");
+
+constexpr quint32 kSegmentMagic = 0x5341584d; // "MXAS"
+constexpr quint32 kSegmentVersion = 1;
+constexpr quint32 kEntryMagic = 0x4e45584d; // "MXEN"
+
+const QString kSegmentFileSuffix = QStringLiteral(".seg");
+
+struct SegmentHeader {
+    quint32 magic;
+    quint32 version;
+    quint32 reserved[2];
+};
+static_assert(sizeof(SegmentHeader) == 16);
+
+struct EntryHeader {
+    quint32 magic;
+    qint32 analysisId;
+    quint32 format;
+    quint32 size;
+};
+static_assert(sizeof(EntryHeader) == 16);
+
+// The data of all entries is aligned for mapping it directly
+constexpr qint64 kEntryAlignment = 16;
+
+constexpr qint64 paddedSize(qint64 size) {
+    return (size + kEntryAlignment - 1) / kEntryAlignment * kEntryAlignment;
+}
+
+constexpr qint64 entryBytes(quint32 size) {
+    return static_cast<qint64>(sizeof(EntryHeader)) + paddedSize(size);
+}
+
+bool isValidFormat(quint32 format) {
+    return format <= static_cast<quint32>(AnalysisStore::Format::Zlib);
+}
+
+} // anonymous namespace
+
+// static
+std::shared_ptr<AnalysisStore> AnalysisStore::forDirectory(const QString& dirPath) {
+    static QMutex s_mutex;
+    static QHash<QString, std::shared_ptr<AnalysisStore>> s_stores;
+    const QString absolutePath = QDir(dirPath).absolutePath();
+    const auto locked = lockMutex(&s_mutex);
+    auto& pStore = s_stores[absolutePath];
+    if (!pStore) {
+        pStore = std::make_shared<AnalysisStore>(absolutePath);
+    }
+    return pStore;
+}
+
+AnalysisStore::AnalysisStore(QString dirPath, qint64 segmentSize)
+        : m_dirPath(std::move(dirPath)),
+          m_segmentSize(segmentSize) {
+    open();
+}
+
+AnalysisStore::~AnalysisStore() {
+    const auto locked = lockMutex(&m_mutex);
+    for (const auto& pSegment : m_segments) {
+        pSegment->file.close();
+    }
+    for (const auto& pSegment : m_retiredSegments) {
+        pSegment->file.close();
+        // Removing a mapped file fails on Windows
+        const QString filePath = segmentFilePath(pSegment->number);
+        if (QFile::exists(filePath) && !QFile::remove(filePath)) {
+            kLogger.warning()
+                    << "Failed to remove retired segment"
+                    << filePath;
+        }
+    }
+}
+
+QString AnalysisStore::segmentFilePath(int number) const {
+    return QDir(m_dirPath).filePath(
+            QStringLiteral("%1").arg(number, 8, 10, QChar('0')) +
+            kSegmentFileSuffix);
+}
+
+void AnalysisStore::open() {
+    QDir dir(m_dirPath);
+    if (!dir.mkpath(m_dirPath)) {
+        kLogger.warning()
+                << "Failed to create directory"
+                << m_dirPath;
+        return;
+    }
+    // Entries in later segments supersede those in earlier segments
+    QMap<int, QString> segmentFileNames;
+    const auto fileNames = dir.entryList(
+            QStringList{QStringLiteral("*") + kSegmentFileSuffix},
+            QDir::Files);
+    for (const auto& fileName : fileNames) {
+        bool ok = false;
+        const int number = fileName.chopped(kSegmentFileSuffix.size()).toInt(&ok);
+        if (ok && number > 0) {
+            segmentFileNames.insert(number, fileName);
+        }
+    }
+    for (auto it = segmentFileNames.constBegin(); it != segmentFileNames.constEnd(); ++it) {
+        const bool isLast = it == std::prev(segmentFileNames.constEnd());
+        auto pSegment = std::make_unique<Segment>();
+        pSegment->number = it.key();
+        pSegment->file.setFileName(dir.filePath(it.value()));
+        if (!pSegment->file.open(isLast ? QIODevice::ReadWrite : QIODevice::ReadOnly)) {
+            kLogger.warning()
+                    << "Failed to open segment"
+                    << pSegment->file.fileName()
+                    << pSegment->file.errorString();
+            continue;
+        }
+        if (!scanSegment(pSegment.get(), isLast)) {
+            continue;
+        }
+        m_segments.push_back(std::move(pSegment));
+        if (!isLast) {
+            sealSegment(m_segments.back().get());
+        }
+    }
+    kLogger.info()
+            << "Opened"
+            << m_locations.size()
+            << "analyses in"
+            << m_segments.size()
+            << "segment(s) with"
+            << garbageBytes()
+            << "of"
+            << totalBytes()
+            << "bytes garbage";
+}
+
+bool AnalysisStore::scanSegment(Segment* pSegment, bool truncateTornEntry) {
+    QFile& file = pSegment->file;
+    const qint64 fileSize = file.size();
+    SegmentHeader segmentHeader;
+    if (file.read(reinterpret_cast<char*>(&segmentHeader), sizeof(segmentHeader)) !=
+                    sizeof(segmentHeader) ||
+            segmentHeader.magic != kSegmentMagic ||
+            segmentHeader.version != kSegmentVersion) {
+        kLogger.warning()
+                << "Ignoring invalid segment"
+                << file.fileName();
+        return false;
+    }
+    qint64 offset = sizeof(SegmentHeader);
+    while (offset + static_cast<qint64>(sizeof(EntryHeader)) <= fileSize) {
+        EntryHeader entryHeader;
+        if (!file.seek(offset) ||
+                file.read(reinterpret_cast<char*>(&entryHeader), sizeof(entryHeader)) !=
+                        sizeof(entryHeader) ||
+                entryHeader.magic != kEntryMagic ||
+                !isValidFormat(entryHeader.format) ||
+                offset + entryBytes(entryHeader.size) > fileSize) {
+            break;
+        }
+        addRecord(pSegment,
+                EntryRecord{entryHeader.analysisId,
+                        static_cast<Format>(entryHeader.format),
+                        entryHeader.size,
+                        offset + static_cast<qint64>(sizeof(EntryHeader))});
+        offset += entryBytes(entryHeader.size);
+    }
+    pSegment->size = offset;
+    if (offset < fileSize) {
+        kLogger.warning()
+                << "Discarding"
+                << fileSize - offset
+                << "bytes of a torn entry at the end of"
+                << file.fileName();
+        if (truncateTornEntry && !file.resize(offset)) {
+            kLogger.warning()
+                    << "Failed to truncate segment"
+                    << file.fileName()
+                    << file.errorString();
+        }
+    }
+    return true;
+}
+
+void AnalysisStore::sealSegment(Segment* pSegment) {
+    DEBUG_ASSERT(!pSegment->pMapping);
+    pSegment->file.flush();
+    pSegment->pMapping = pSegment->file.map(0, pSegment->size);
+    if (!pSegment->pMapping) {
+        // The data is read from the file instead
+        kLogger.warning()
+                << "Failed to map segment"
+                << pSegment->file.fileName()
+                << pSegment->file.errorString();
+    }
+}
+
+void AnalysisStore::addRecord(Segment* pSegment, const EntryRecord& record) {
+    const auto it = m_locations.find(record.analysisId);
+    if (it != m_locations.end()) {
+        it.value().pSegment->garbageBytes += entryBytes(it.value().record.size);
+    }
+    if (record.format == Format::Tombstone) {
+        // The tombstone itself is only needed until the segments with
+        // the superseded entries have been compacted
+        pSegment->garbageBytes += entryBytes(record.size);
+        if (it != m_locations.end()) {
+            m_locations.erase(it);
+        }
+    } else if (it != m_locations.end()) {
+        it.value() = Location{pSegment, record};
+    } else {
+        m_locations.insert(record.analysisId, Location{pSegment, record});
+    }
+    pSegment->records.append(record);
+}
+
+AnalysisStore::Segment* AnalysisStore::activeSegment() {
+    if (!m_segments.empty() && m_segments.back()->size < m_segmentSize) {
+        return m_segments.back().get();
+    }
+    const int number = m_segments.empty() ? 1 : m_segments.back()->number + 1;
+    auto pSegment = std::make_unique<Segment>();
+    pSegment->number = number;
+    pSegment->file.setFileName(segmentFilePath(number));
+    const SegmentHeader segmentHeader{kSegmentMagic, kSegmentVersion, {0, 0}};
+    if (!pSegment->file.open(QIODevice::ReadWrite | QIODevice::Truncate) ||
+            pSegment->file.write(reinterpret_cast<const char*>(&segmentHeader),
+                    sizeof(segmentHeader)) != sizeof(segmentHeader)) {
+        kLogger.warning()
+                << "Failed to create segment"
+                << pSegment->file.fileName()
+                << pSegment->file.errorString();
+        return nullptr;
+    }
+    pSegment->size = sizeof(SegmentHeader);
+    if (!m_segments.empty()) {
+        sealSegment(m_segments.back().get());
+    }
+    m_segments.push_back(std::move(pSegment));
+    return m_segments.back().get();
+}
+
+bool AnalysisStore::appendEntry(int analysisId, const QByteArray& data, Format format) {
+    Segment* pSegment = activeSegment();
+    if (!pSegment) {
+        return false;
+    }
+    const EntryHeader entryHeader{kEntryMagic,
+            analysisId,
+            static_cast<quint32>(format),
+            static_cast<quint32>(data.size())};
+    const QByteArray padding(
+            static_cast<int>(paddedSize(data.size()) - data.size()), '\0');
+    QFile& file = pSegment->file;
+    if (!file.seek(pSegment->size) ||
+            file.write(reinterpret_cast<const char*>(&entryHeader),
+                    sizeof(entryHeader)) != sizeof(entryHeader) ||
+            file.write(data) != data.size() ||
+            file.write(padding) != padding.size() ||
+            !file.flush()) {
+        kLogger.warning()
+                << "Failed to write analysis"
+                << analysisId
+                << "into"
+                << file.fileName()
+                << file.errorString();
+        // Discard the incomplete entry
+        file.resize(pSegment->size);
+        return false;
+    }
+    const EntryRecord record{analysisId,
+            format,
+            entryHeader.size,
+            pSegment->size + static_cast<qint64>(sizeof(EntryHeader))};
+    pSegment->size += entryBytes(entryHeader.size);
+    addRecord(pSegment, record);
+    return true;
+}
+
+QByteArray AnalysisStore::readLocation(const Location& location) const {
+    Segment* pSegment = location.pSegment;
+    const EntryRecord& record = location.record;
+    if (pSegment->pMapping) {
+        return QByteArray::fromRawData(
+                reinterpret_cast<const char*>(pSegment->pMapping + record.offset),
+                static_cast<int>(record.size));
+    }
+    if (!pSegment->file.seek(record.offset)) {
+        return QByteArray();
+    }
+    QByteArray data = pSegment->file.read(record.size);
+    if (data.size() != static_cast<int>(record.size)) {
+        kLogger.warning()
+                << "Failed to read analysis"
+                << record.analysisId
+                << "from"
+                << pSegment->file.fileName();
+        return QByteArray();
+    }
+    return data;
+}
+
+bool AnalysisStore::contains(int analysisId) const {
+    const auto locked = lockMutex(&m_mutex);
+    return m_locations.contains(analysisId);
+}
+
+QByteArray AnalysisStore::read(int analysisId, Format* pFormat) const {
+    const auto locked = lockMutex(&m_mutex);
+    const auto it = m_locations.constFind(analysisId);
+    if (it == m_locations.constEnd()) {
+        return QByteArray();
+    }
+    if (pFormat) {
+        *pFormat = it.value().record.format;
+    }
+    return readLocation(it.value());
+}
+
+bool AnalysisStore::write(int analysisId, const QByteArray& data, Format format) {
+    VERIFY_OR_DEBUG_ASSERT(format != Format::Tombstone) {
+        return false;
+    }
+    const auto locked = lockMutex(&m_mutex);
+    return appendEntry(analysisId, data, format);
+}
+
+bool AnalysisStore::remove(int analysisId) {
+    const auto locked = lockMutex(&m_mutex);
+    if (!m_locations.contains(analysisId)) {
+        return true;
+    }
+    return appendEntry(analysisId, QByteArray(), Format::Tombstone);
+}
+
+qint64 AnalysisStore::storedSize(int analysisId) const {
+    const auto locked = lockMutex(&m_mutex);
+    const auto it = m_locations.constFind(analysisId);
+    if (it == m_locations.constEnd()) {
+        return -1;
+    }
+    return it.value().record.size;
+}
+
+QList<int> AnalysisStore::analysisIds() const {
+    const auto locked = lockMutex(&m_mutex);
+    return m_locations.keys();
+}
+
+qint64 AnalysisStore::totalBytesLocked() const {
+    qint64 total = 0;
+    for (const auto& pSegment : m_segments) {
+        total += pSegment->size;
+    }
+    return total;
+}
+
+qint64 AnalysisStore::totalBytes() const {
+    const auto locked = lockMutex(&m_mutex);
+    return totalBytesLocked();
+}
+
+qint64 AnalysisStore::garbageBytes() const {
+    const auto locked = lockMutex(&m_mutex);
+    qint64 garbage = 0;
+    for (const auto& pSegment : m_segments) {
+        garbage += pSegment->garbageBytes;
+    }
+    return garbage;
+}
+
+qint64 AnalysisStore::compact(const QSet<int>& liveAnalysisIds) {
+    const auto locked = lockMutex(&m_mutex);
+    const qint64 bytesBefore = totalBytesLocked();
+
+    const auto analysisIds = m_locations.keys();
+    for (const int analysisId : analysisIds) {
+        if (!liveAnalysisIds.contains(analysisId)) {
+            appendEntry(analysisId, QByteArray(), Format::Tombstone);
+        }
+    }
+
+    // The active segment is never rewritten
+    std::vector<Segment*> garbageSegments;
+    for (std::size_t i = 0; i + 1 < m_segments.size(); ++i) {
+        Segment* pSegment = m_segments[i].get();
+        if (pSegment->garbageBytes * 2 >
+                pSegment->size - static_cast<qint64>(sizeof(SegmentHeader))) {
+            garbageSegments.push_back(pSegment);
+        }
+    }
+    for (Segment* pSegment : garbageSegments) {
+        // Tombstones must be kept while earlier segments contain
+        // entries that they supersede
+        QSet<int> earlierAnalysisIds;
+        for (const auto& pEarlierSegment : m_segments) {
+            if (pEarlierSegment->number >= pSegment->number) {
+                break;
+            }
+            for (const auto& record : std::as_const(pEarlierSegment->records)) {
+                earlierAnalysisIds.insert(record.analysisId);
+            }
+        }
+        bool copied = true;
+        const auto records = pSegment->records;
+        for (const auto& record : records) {
+            if (record.format == Format::Tombstone) {
+                if (!m_locations.contains(record.analysisId) &&
+                        earlierAnalysisIds.remove(record.analysisId)) {
+                    copied = appendEntry(record.analysisId, QByteArray(), Format::Tombstone);
+                }
+            } else {
+                const auto it = m_locations.constFind(record.analysisId);
+                if (it != m_locations.constEnd() &&
+                        it.value().pSegment == pSegment &&
+                        it.value().record.offset == record.offset) {
+                    // The data refers to the mapping of the segment
+                    // and is copied into the active segment
+                    copied = appendEntry(record.analysisId,
+                            readLocation(it.value()),
+                            record.format);
+                }
+            }
+            if (!copied) {
+                break;
+            }
+        }
+        if (!copied) {
+            kLogger.warning()
+                    << "Aborted compaction of segment"
+                    << pSegment->file.fileName();
+            break;
+        }
+        retireSegment(pSegment);
+    }
+
+    const qint64 reclaimedBytes = std::max(bytesBefore - totalBytesLocked(), qint64{0});
+    kLogger.info()
+            << "Compacted"
+            << garbageSegments.size()
+            << "segment(s) and reclaimed"
+            << reclaimedBytes
+            << "bytes";
+    return reclaimedBytes;
+}
+
+void AnalysisStore::retireSegment(Segment* pSegment) {
+    const auto it = std::find_if(m_segments.begin(),
+            m_segments.end(),
+            [pSegment](const auto& pOther) { return pOther.get() == pSegment; });
+    VERIFY_OR_DEBUG_ASSERT(it != m_segments.end()) {
+        return;
+    }
+    // All entries have been superseded by the copies, removing the file
+    // while it is still mapped fails on Windows. The destructor retries.
+    QFile::remove(pSegment->file.fileName());
+    m_retiredSegments.push_back(std::move(*it));
+    m_segments.erase(it);
+}
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <QByteArray>
+#include <QFile>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QSet>
+#include <QString>
+#include <memory>
+#include <vector>
+
+/// Packs the data of all analyses into a few large segment files instead
+/// of a separate file per analysis.
+///
+/// A segment contains the entries of many analyses one after another,
+/// each with a small header that contains the analysis id and the size
+/// and format of the data. Replacing or removing an analysis appends a
+/// new entry or a tombstone, the superseded entry becomes garbage that is
+/// reclaimed by compact(). Only the last segment is written to. Once it
+/// exceeds the segment size it is sealed and memory mapped, the data of sealed
+/// segments is returned without copying it.
+///
+/// The index is rebuilt from the entry headers when opening the store.
+/// A torn entry at the end of the last segment after a crash is discarded.
+///
+/// All functions are thread-safe. The data is stored in the native byte
+/// order, the store is not meant to be shared between machines.
+class AnalysisStore final {
+  public:
+    enum class Format : quint32 {
+        Tombstone = 0,
+        Raw = 1,
+        Zlib = 2,
+    };
+
+    static constexpr qint64 kSegmentSize = 64 * 1024 * 1024;
+
+    /// The shared store of the directory. It is kept until exit, so the
+    /// mapped data returned by read() remains valid.
+    static std::shared_ptr<AnalysisStore> forDirectory(const QString& dirPath);
+
+    explicit AnalysisStore(QString dirPath, qint64 segmentSize = kSegmentSize);
+    ~AnalysisStore();
+
+    AnalysisStore(const AnalysisStore&) = delete;
+    AnalysisStore& operator=(const AnalysisStore&) = delete;
+
+    bool contains(int analysisId) const;
+    /// Returns a null array for unknown analyses. The data of sealed
+    /// segments refers to the memory mapping, which remains valid as
+    /// long as the store exists.
+    QByteArray read(int analysisId, Format* pFormat = nullptr) const;
+    bool write(int analysisId, const QByteArray& data, Format format);
+    /// Returns false if the tombstone could not be written
+    bool remove(int analysisId);
+
+    /// The size of the stored data or -1 for unknown analyses
+    qint64 storedSize(int analysisId) const;
+    QList<int> analysisIds() const;
+
+    /// The size of all segments and of their superseded entries
+    qint64 totalBytes() const;
+    qint64 garbageBytes() const;
+
+    /// Removes all analyses that are not contained in liveAnalysisIds and
+    /// rewrites the sealed segments that consist mostly of garbage.
+    /// Returns the number of bytes that have been reclaimed.
+    qint64 compact(const QSet<int>& liveAnalysisIds);
+
+  private:
+    struct EntryRecord {
+        int analysisId;
+        Format format;
+        quint32 size;
+        // The position of the data in the segment file
+        qint64 offset;
+    };
+    struct Segment {
+        int number = 0;
+        QFile file;
+        // Only mapped after the segment has been sealed
+        uchar* pMapping = nullptr;
+        qint64 size = 0;
+        qint64 garbageBytes = 0;
+        QList<EntryRecord> records;
+    };
+    struct Location {
+        Segment* pSegment;
+        EntryRecord record;
+    };
+
+    QString segmentFilePath(int number) const;
+    void open();
+    bool scanSegment(Segment* pSegment, bool truncateTornEntry);
+    void sealSegment(Segment* pSegment);
+    void addRecord(Segment* pSegment, const EntryRecord& record);
+    Segment* activeSegment();
+    bool appendEntry(int analysisId, const QByteArray& data, Format format);
+    QByteArray readLocation(const Location& location) const;
+    void retireSegment(Segment* pSegment);
+    qint64 totalBytesLocked() const;
+
+    const QString m_dirPath;
+    const qint64 m_segmentSize;
+
+    mutable QMutex m_mutex;
+    std::vector<std::unique_ptr<Segment>> m_segments;
+    // Retired segments are kept until the store is destroyed, because
+    // their mapping might still be referenced
+    std::vector<std::unique_ptr<Segment>> m_retiredSegments;
+    QHash<int, Location> m_locations;
+};
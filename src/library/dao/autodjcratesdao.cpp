@@ -138,6 +138,29 @@ void AutoDJCratesDAO::createAndConnectAutoDjCratesDatabase() {
         return;
     }
 
+    // Index the table in the order of the active-tracks view, so that
+    // counting the active tracks and picking one of them at a random
+    // offset only walks the index instead of sorting the whole table
+    // on every pick.
+    // CREATE INDEX temp_autodj_crates_timesplayed ON temp_autodj_crates (autodjrefs, timesplayed, lastplayed);
+    // CREATE INDEX temp_autodj_crates_lastplayed ON temp_autodj_crates (autodjrefs, lastplayed);
+    oQuery.prepare(QStringLiteral(
+            "CREATE INDEX " AUTODJCRATES_TABLE "_" AUTODJCRATESTABLE_TIMESPLAYED
+            " ON " AUTODJCRATES_TABLE " (" AUTODJCRATESTABLE_AUTODJREFS ", "
+            AUTODJCRATESTABLE_TIMESPLAYED ", " AUTODJCRATESTABLE_LASTPLAYED ")"));
+    if (!oQuery.exec()) {
+        LOG_FAILED_QUERY(oQuery);
+        return;
+    }
+    oQuery.prepare(QStringLiteral(
+            "CREATE INDEX " AUTODJCRATES_TABLE "_" AUTODJCRATESTABLE_LASTPLAYED
+            " ON " AUTODJCRATES_TABLE " (" AUTODJCRATESTABLE_AUTODJREFS ", "
+            AUTODJCRATESTABLE_LASTPLAYED ")"));
+    if (!oQuery.exec()) {
+        LOG_FAILED_QUERY(oQuery);
+        return;
+    }
+
     strQuery = QStringLiteral(
             "INSERT INTO " AUTODJCRATES_TABLE "(" AUTODJCRATESTABLE_TRACKID
             "," AUTODJCRATESTABLE_CRATEREFS "," AUTODJCRATESTABLE_TIMESPLAYED
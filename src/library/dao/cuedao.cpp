@@ -2,6 +2,8 @@
 
 #include <QVariant>
 #include <QtDebug>
+#include <algorithm>
+#include <optional>
 
 #include "engine/engine.h"
 #include "library/queryutil.h"
@@ -34,9 +36,8 @@ inline QString labelFromQVariant(const QVariant& value) {
     }
 }
 
-CuePointer cueFromRow(const QSqlRecord& row) {
+std::optional<CueRecord> cueRecordFromRow(const QSqlRecord& row) {
     const auto id = DbId(row.value(row.indexOf("id")));
-    TrackId trackId(row.value(row.indexOf("track_id")));
     auto type = static_cast<mixxx::CueType>(row.value(row.indexOf("type")).toInt());
     const auto position =
             mixxx::audio::FramePos::fromEngineSamplePosMaybeInvalid(
@@ -46,35 +47,58 @@ CuePointer cueFromRow(const QSqlRecord& row) {
     QString label = labelFromQVariant(row.value(row.indexOf("label")));
     mixxx::RgbColor::optional_t color = mixxx::RgbColor::fromQVariant(row.value(row.indexOf("color")));
     VERIFY_OR_DEBUG_ASSERT(color) {
-        return CuePointer();
+        return std::nullopt;
     }
     if (type == mixxx::CueType::Loop && lengthFrames == 0.0) {
         // These entries are likely added via issue #11283
         qWarning() << "Discard loop cue" << hotcue << "found in database with length of 0";
-        return CuePointer();
+        return std::nullopt;
     }
     if (type == mixxx::CueType::HotCue &&
             position == mixxx::audio::FramePos(0) &&
             *color == mixxx::RgbColor(0)) {
         // These entries are likely added via issue #11283
         qWarning() << "Discard black hot cue" << hotcue << "found in database at position 0";
-        return CuePointer();
+        return std::nullopt;
     }
-    CuePointer pCue(new Cue(id,
+    return CueRecord{id,
             type,
             position,
             lengthFrames,
             hotcue,
-            label,
-            *color));
-    return pCue;
+            std::move(label),
+            *color};
+}
+
+/// Only the last of multiple hot cues with the same number is kept
+void appendCueRecord(QList<CueRecord>* pCueRecords,
+        QMap<int, DbId>* pHotCueIdsByNumber,
+        CueRecord&& cueRecord) {
+    const int hotCueNumber = cueRecord.hotCue;
+    if (hotCueNumber != Cue::kNoHotCue) {
+        const DbId duplicateId = pHotCueIdsByNumber->take(hotCueNumber);
+        if (duplicateId.isValid()) {
+            kLogger.warning()
+                    << "Dropping hot cue"
+                    << duplicateId
+                    << "with duplicate number"
+                    << hotCueNumber;
+            pCueRecords->erase(std::remove_if(pCueRecords->begin(),
+                                       pCueRecords->end(),
+                                       [duplicateId](const CueRecord& other) {
+                                           return other.id == duplicateId;
+                                       }),
+                    pCueRecords->end());
+        }
+        pHotCueIdsByNumber->insert(hotCueNumber, cueRecord.id);
+    }
+    pCueRecords->push_back(std::move(cueRecord));
 }
 
 } // namespace
 
-QList<CuePointer> CueDAO::getCuesForTrack(TrackId trackId) const {
-    //qDebug() << "CueDAO::getCuesForTrack" << QThread::currentThread() << m_database.connectionName();
-    QList<CuePointer> cues;
+QList<CueRecord> CueDAO::getCueRecordsForTrack(TrackId trackId) const {
+    QList<CueRecord> cueRecords;
 
     FwdSqlQuery query(
             m_database,
@@ -88,30 +112,53 @@ QList<CuePointer> CueDAO::getCuesForTrack(TrackId trackId) const {
                 << "Failed to load cues of track"
                 << trackId;
         DEBUG_ASSERT(!"failed query");
-        return cues;
+        return cueRecords;
     }
-    QMap<int, CuePointer> hotCuesByNumber;
+    QMap<int, DbId> hotCueIdsByNumber;
     while (query.next()) {
-        CuePointer pCue = cueFromRow(query.record());
-        if (!pCue) {
+        auto cueRecord = cueRecordFromRow(query.record());
+        if (!cueRecord) {
             continue;
         }
-        int hotCueNumber = pCue->getHotCue();
-        if (hotCueNumber != Cue::kNoHotCue) {
-            const auto pDuplicateCue = hotCuesByNumber.take(hotCueNumber);
-            if (pDuplicateCue) {
-                kLogger.warning()
-                        << "Dropping hot cue"
-                        << pDuplicateCue->getId()
-                        << "with duplicate number"
-                        << hotCueNumber;
-                cues.removeOne(pDuplicateCue);
-            }
-            hotCuesByNumber.insert(hotCueNumber, pCue);
+        appendCueRecord(&cueRecords, &hotCueIdsByNumber, std::move(*cueRecord));
+    }
+    return cueRecords;
+}
+
+QHash<TrackId, QList<CueRecord>> CueDAO::getCueRecordsForTracks(
+        const QList<TrackId>& trackIds) const {
+    QHash<TrackId, QList<CueRecord>> cueRecordsByTrackId;
+    if (trackIds.isEmpty()) {
+        return cueRecordsByTrackId;
+    }
+
+    QStringList idList;
+    idList.reserve(trackIds.size());
+    for (const auto& trackId : trackIds) {
+        idList << trackId.toString();
+    }
+
+    QSqlQuery query(m_database);
+    query.prepare(QStringLiteral("SELECT * FROM " CUE_TABLE " WHERE track_id IN (%1)")
+                          .arg(idList.join(QChar(','))));
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query);
+        DEBUG_ASSERT(!"failed query");
+        return cueRecordsByTrackId;
+    }
+    const int trackIdColumn = query.record().indexOf("track_id");
+    QHash<TrackId, QMap<int, DbId>> hotCueIdsByTrackId;
+    while (query.next()) {
+        auto cueRecord = cueRecordFromRow(query.record());
+        if (!cueRecord) {
+            continue;
         }
-        cues.push_back(pCue);
+        const TrackId trackId(query.value(trackIdColumn));
+        appendCueRecord(&cueRecordsByTrackId[trackId],
+                &hotCueIdsByTrackId[trackId],
+                std::move(*cueRecord));
     }
-    return cues;
+    return cueRecordsByTrackId;
 }
 
 bool CueDAO::deleteCuesForTrack(TrackId trackId) const {
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <QHash>
+
 #include "library/dao/dao.h"
 #include "track/cue.h"
 #include "track/trackid.h"
@@ -12,7 +14,11 @@ class CueDAO : public DAO {
   public:
     ~CueDAO() override = default;
 
-    QList<CuePointer> getCuesForTrack(TrackId trackId) const;
+    QList<CueRecord> getCueRecordsForTrack(TrackId trackId) const;
+    /// Loads the cues of multiple tracks with a single query. Tracks
+    /// without cues are omitted.
+    QHash<TrackId, QList<CueRecord>> getCueRecordsForTracks(
+            const QList<TrackId>& trackIds) const;
 
     void saveTrackCues(TrackId trackId, const QList<CuePointer>& cueList) const;
     bool deleteCuesForTrack(TrackId trackId) const;
@@ -182,3 +182,46 @@ QStringList LibraryHashDAO::getDeletedDirectories() {
     }
     return result;
 }
+
+QHash<QString, LibraryHashDAO::DirectoryMTime> LibraryHashDAO::getDirectoryMTimes() {
+    QSqlQuery query(m_database);
+    query.prepare("SELECT directory_path, parent_path, mtime FROM library_directory_mtimes");
+    QHash<QString, DirectoryMTime> mtimes;
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query);
+    }
+    const int directoryPathColumn = query.record().indexOf("directory_path");
+    const int parentPathColumn = query.record().indexOf("parent_path");
+    const int mtimeColumn = query.record().indexOf("mtime");
+    while (query.next()) {
+        DirectoryMTime& mtime = mtimes[query.value(directoryPathColumn).toString()];
+        mtime.parentPath = query.value(parentPathColumn).toString();
+        mtime.mtimeMillis = query.value(mtimeColumn).toLongLong();
+    }
+    return mtimes;
+}
+
+void LibraryHashDAO::updateDirectoryMTimes(
+        const QHash<QString, DirectoryMTime>& updatedMTimes,
+        const QStringList& removedDirPaths) {
+    QSqlQuery query(m_database);
+    query.prepare("INSERT OR REPLACE INTO library_directory_mtimes "
+                  "(directory_path, parent_path, mtime) "
+                  "VALUES (:directory_path, :parent_path, :mtime)");
+    for (auto it = updatedMTimes.constBegin(); it != updatedMTimes.constEnd(); ++it) {
+        query.bindValue(":directory_path", it.key());
+        query.bindValue(":parent_path", it.value().parentPath);
+        query.bindValue(":mtime", it.value().mtimeMillis);
+        if (!query.exec()) {
+            LOG_FAILED_QUERY(query) << "Updating directory mtime failed.";
+        }
+    }
+    query.prepare("DELETE FROM library_directory_mtimes "
+                  "WHERE directory_path=:directory_path");
+    for (const auto& dirPath : removedDirPaths) {
+        query.bindValue(":directory_path", dirPath);
+        if (!query.exec()) {
+            LOG_FAILED_QUERY(query) << "Removing directory mtime failed.";
+        }
+    }
+}
@@ -11,6 +11,14 @@ class LibraryHashDAO : public DAO {
   public:
     ~LibraryHashDAO() override = default;
 
+    // The modification time of a directory when it has been listed
+    // completely by the last library scan.
+    struct DirectoryMTime {
+        QString parentPath;
+        // Milliseconds since epoch or 0 if unknown
+        qint64 mtimeMillis = 0;
+    };
+
     QHash<QString, mixxx::cache_key_t> getDirectoryHashes();
     mixxx::cache_key_t getDirectoryHash(const QString& dirPath);
     void saveDirectoryHash(const QString& dirPath, mixxx::cache_key_t hash);
@@ -23,4 +31,8 @@ class LibraryHashDAO : public DAO {
     void updateDirectoryStatuses(const QStringList& dirPaths,
                                  const bool deleted, const bool verified);
     QStringList getDeletedDirectories();
+
+    QHash<QString, DirectoryMTime> getDirectoryMTimes();
+    void updateDirectoryMTimes(const QHash<QString, DirectoryMTime>& updatedMTimes,
+            const QStringList& removedDirPaths);
 };
@@ -2,6 +2,8 @@
 
 #include <QRandomGenerator>
 #include <QtDebug>
+#include <algorithm>
+#include <limits>
 
 #include "library/autodj/autodjprocessor.h"
 #include "library/queryutil.h"
@@ -570,10 +572,11 @@ void PlaylistDAO::removeHiddenTracks(const int playlistId) {
         return;
     }
 
+    QList<int> positions;
     while (query.next()) {
-        int position = query.value(query.record().indexOf("position")).toInt();
-        removeTracksFromPlaylistInner(playlistId, position);
+        positions.append(query.value(query.record().indexOf("position")).toInt());
     }
+    removeTracksFromPlaylistInner(playlistId, positions);
 
     transaction.commit();
     emit tracksChanged(QSet<int>{playlistId});
@@ -581,18 +584,24 @@ void PlaylistDAO::removeHiddenTracks(const int playlistId) {
 
 void PlaylistDAO::removeTracksFromPlaylistById(int playlistId, TrackId trackId) {
     ScopedTransaction transaction(m_database);
-    removeTracksFromPlaylistByIdInner(playlistId, trackId);
+    removeTracksFromPlaylistByIdInner(playlistId, QList<TrackId>{trackId});
     transaction.commit();
     emit tracksChanged(QSet<int>{playlistId});
 }
 
-void PlaylistDAO::removeTracksFromPlaylistByIdInner(int playlistId, TrackId trackId) {
+void PlaylistDAO::removeTracksFromPlaylistByIdInner(
+        int playlistId, const QList<TrackId>& trackIds) {
+    QStringList idList;
+    idList.reserve(trackIds.size());
+    for (const auto& trackId : trackIds) {
+        idList << trackId.toString();
+    }
     QSqlQuery query(m_database);
     query.prepare(QStringLiteral(
             "SELECT position FROM PlaylistTracks "
-            "WHERE playlist_id=:id AND track_id=:track_id"));
+            "WHERE playlist_id=:id AND track_id IN (%1)")
+                          .arg(idList.join(QChar(','))));
     query.bindValue(":id", playlistId);
-    query.bindValue(":track_id", trackId.toVariant());
 
     query.setForwardOnly(true);
     if (!query.exec()) {
@@ -600,83 +609,108 @@ void PlaylistDAO::removeTracksFromPlaylistByIdInner(int playlistId, TrackId trac
         return;
     }
 
+    QList<int> positions;
     while (query.next()) {
-        int position = query.value(query.record().indexOf("position")).toInt();
-        removeTracksFromPlaylistInner(playlistId, position);
+        positions.append(query.value(query.record().indexOf("position")).toInt());
     }
+    removeTracksFromPlaylistInner(playlistId, positions);
 }
 
 void PlaylistDAO::removeTrackFromPlaylist(int playlistId, int position) {
     // qDebug() << "PlaylistDAO::removeTrackFromPlaylist"
     //          << QThread::currentThread() << m_database.connectionName();
     ScopedTransaction transaction(m_database);
-    removeTracksFromPlaylistInner(playlistId, position);
+    removeTracksFromPlaylistInner(playlistId, QList<int>{position});
     transaction.commit();
     emit tracksChanged(QSet<int>{playlistId});
 }
 
 void PlaylistDAO::removeTracksFromPlaylist(int playlistId, const QList<int>& positions) {
-    // get positions in reversed order
-    auto sortedPositons = positions;
-    std::sort(sortedPositons.begin(), sortedPositons.end(), std::greater<int>());
-
     //qDebug() << "PlaylistDAO::removeTrackFromPlaylist"
     //         << QThread::currentThread() << m_database.connectionName();
     ScopedTransaction transaction(m_database);
-    for (const auto position : std::as_const(sortedPositons)) {
-        removeTracksFromPlaylistInner(playlistId, position);
-    }
+    removeTracksFromPlaylistInner(playlistId, positions);
     transaction.commit();
     emit tracksChanged(QSet<int>{playlistId});
 }
 
-void PlaylistDAO::removeTracksFromPlaylistInner(int playlistId, int position) {
-    QSqlQuery query(m_database);
-    query.prepare(QStringLiteral(
-            "SELECT track_id FROM PlaylistTracks "
-            "WHERE playlist_id=:id AND position=:position"));
-    query.bindValue(":id", playlistId);
-    query.bindValue(":position", position);
-
-    if (!query.exec()) {
-        LOG_FAILED_QUERY(query);
+void PlaylistDAO::removeTracksFromPlaylistInner(
+        int playlistId, const QList<int>& positions) {
+    if (positions.isEmpty()) {
         return;
     }
-
-    if (!query.next()) {
-        qDebug() << "removeTrackFromPlaylist no track exists at position:"
-                 << position << "in playlist:" << playlistId;
-        return;
-    }
-    TrackId trackId(query.value(query.record().indexOf("track_id")));
-
-    // Delete the track from the playlist.
-    query.prepare(QStringLiteral(
+    // get positions in reversed order
+    auto sortedPositions = positions;
+    std::sort(sortedPositions.begin(), sortedPositions.end(), std::greater<int>());
+    sortedPositions.erase(
+            std::unique(sortedPositions.begin(), sortedPositions.end()),
+            sortedPositions.end());
+
+    QSqlQuery selectQuery(m_database);
+    selectQuery.prepare(QStringLiteral(
+            "SELECT track_id FROM PlaylistTracks "
+            "WHERE playlist_id=:id AND position=:position"));
+    selectQuery.bindValue(":id", playlistId);
+    QSqlQuery deleteQuery(m_database);
+    deleteQuery.prepare(QStringLiteral(
             "DELETE FROM PlaylistTracks "
             "WHERE playlist_id=:id AND position=:position"));
-    query.bindValue(":id", playlistId);
-    query.bindValue(":position", position);
+    deleteQuery.bindValue(":id", playlistId);
+
+    // The removed positions in descending order
+    QList<QPair<int, TrackId>> removedTracks;
+    removedTracks.reserve(sortedPositions.size());
+    for (const auto position : std::as_const(sortedPositions)) {
+        selectQuery.bindValue(":position", position);
+        if (!selectQuery.exec()) {
+            LOG_FAILED_QUERY(selectQuery);
+            continue;
+        }
+        if (!selectQuery.next()) {
+            qDebug() << "removeTrackFromPlaylist no track exists at position:"
+                     << position << "in playlist:" << playlistId;
+            continue;
+        }
+        TrackId trackId(selectQuery.value(selectQuery.record().indexOf("track_id")));
 
-    if (!query.exec()) {
-        LOG_FAILED_QUERY(query);
-        return;
+        // Delete the track from the playlist.
+        deleteQuery.bindValue(":position", position);
+        if (!deleteQuery.exec()) {
+            LOG_FAILED_QUERY(deleteQuery);
+            continue;
+        }
+        removedTracks.append(qMakePair(position, trackId));
+    }
+
+    // Close the gaps. Each range of remaining tracks between two removed
+    // positions is shifted only once by the number of removed tracks that
+    // precede it, instead of shifting all following tracks for each
+    // removed track.
+    QSqlQuery shiftQuery(m_database);
+    shiftQuery.prepare(QStringLiteral(
+            "UPDATE PlaylistTracks SET position=position-:offset "
+            "WHERE playlist_id=:id AND position>:begin AND position<:end"));
+    shiftQuery.bindValue(":id", playlistId);
+    int offset = 0;
+    for (int i = removedTracks.size() - 1; i >= 0; --i) {
+        shiftQuery.bindValue(":offset", ++offset);
+        shiftQuery.bindValue(":begin", removedTracks[i].first);
+        shiftQuery.bindValue(":end",
+                i > 0 ? removedTracks[i - 1].first
+                      : std::numeric_limits<int>::max());
+        if (!shiftQuery.exec()) {
+            LOG_FAILED_QUERY(shiftQuery);
+        }
     }
 
-    query.prepare(QStringLiteral(
-            "UPDATE PlaylistTracks SET position=position-1 "
-            "WHERE position>=:position AND playlist_id=:id"));
-    query.bindValue(":id", playlistId);
-    query.bindValue(":position", position);
-
-    if (!query.exec()) {
-        LOG_FAILED_QUERY(query);
+    QSet<TrackId> removedTrackIds;
+    for (const auto& [position, trackId] : std::as_const(removedTracks)) {
+        m_playlistsTrackIsIn.remove(trackId, playlistId);
+        emit trackRemoved(playlistId, trackId, position);
+        removedTrackIds.insert(trackId);
     }
-
-    m_playlistsTrackIsIn.remove(trackId, playlistId);
-
-    emit trackRemoved(playlistId, trackId, position);
-    if (getHiddenType(playlistId) == PLHT_SET_LOG) {
-        emit tracksRemovedFromPlayedHistory({trackId});
+    if (!removedTrackIds.isEmpty() && getHiddenType(playlistId) == PLHT_SET_LOG) {
+        emit tracksRemovedFromPlayedHistory(removedTrackIds);
     }
 }
 
@@ -742,50 +776,55 @@ int PlaylistDAO::insertTracksIntoPlaylist(const QList<TrackId>& trackIds,
         position = max_position;
     }
 
+    QList<TrackId> validTrackIds;
+    validTrackIds.reserve(trackIds.size());
+    for (const auto& trackId : trackIds) {
+        if (trackId.isValid()) {
+            validTrackIds.append(trackId);
+        }
+    }
+    if (validTrackIds.isEmpty()) {
+        return 0;
+    }
+
+    // Make room for all tracks at once by moving the following
+    // tracks up.
+    QSqlQuery query(m_database);
+    query.prepare(QStringLiteral(
+            "UPDATE PlaylistTracks SET position=position+:count "
+            "WHERE position>=:position AND "
+            "playlist_id=:id"));
+    query.bindValue(":id", playlistId);
+    query.bindValue(":position", position);
+    query.bindValue(":count", validTrackIds.size());
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query);
+        return 0;
+    }
+
     QSqlQuery insertQuery(m_database);
     insertQuery.prepare(QStringLiteral(
             "INSERT INTO PlaylistTracks (playlist_id, track_id, position)"
             "VALUES (:playlist_id, :track_id, :position)"));
-    QSqlQuery query(m_database);
+    insertQuery.bindValue(":playlist_id", playlistId);
     int insertPositon = position;
-    for (const auto& trackId : trackIds) {
-        if (!trackId.isValid()) {
-            continue;
-        }
-        // Move all tracks in playlist up by 1.
-        // TODO(XXX) We could do this in one query before the for loop.
-        query.prepare(QStringLiteral(
-                "UPDATE PlaylistTracks SET position=position+1 "
-                "WHERE position>=:position AND "
-                "playlist_id=:id"));
-        query.bindValue(":id", playlistId);
-        query.bindValue(":position", insertPositon);
-
-        if (!query.exec()) {
-            LOG_FAILED_QUERY(query);
-            continue;
-        }
-
+    for (const auto& trackId : std::as_const(validTrackIds)) {
         // Insert the track at the given position
-        insertQuery.bindValue(":playlist_id", playlistId);
         insertQuery.bindValue(":track_id", trackId.toVariant());
-        insertQuery.bindValue(":position", insertPositon);
+        insertQuery.bindValue(":position", insertPositon++);
         if (!insertQuery.exec()) {
             LOG_FAILED_QUERY(insertQuery);
-            continue;
+            // Don't leave a gap in the playlist
+            return 0;
         }
-
-        // Increment the insert position for the track.
-        ++insertPositon;
         ++tracksAdded;
     }
 
     transaction.commit();
 
     insertPositon = position;
-    for (const auto& trackId : trackIds) {
+    for (const auto& trackId : std::as_const(validTrackIds)) {
         m_playlistsTrackIsIn.insert(trackId, playlistId);
-        // TODO(XXX) The position is wrong if any track failed to insert.
         emit trackAdded(playlistId, trackId, insertPositon++);
     }
     emit tracksChanged(QSet<int>{playlistId});
@@ -941,21 +980,26 @@ void PlaylistDAO::removeTracksFromPlaylists(const QList<TrackId>& trackIds) {
     QMultiHash<TrackId, int> playlistsTrackIsInCopy = m_playlistsTrackIsIn;
     QSet<int> playlistIds;
 
-    ScopedTransaction transaction(m_database);
+    // Remove the tracks from each playlist at once
+    QHash<int, QList<TrackId>> trackIdsByPlaylistId;
     for (const auto& trackId : trackIds) {
-        for (auto it = playlistsTrackIsInCopy.constBegin();
-                it != playlistsTrackIsInCopy.constEnd();
-                ++it) {
-            if (it.key() == trackId) {
-                const auto playlistId = it.value();
-                // keep tracks in history playlists
-                if (getHiddenType(playlistId) == PlaylistDAO::PLHT_SET_LOG) {
-                    continue;
-                }
-                removeTracksFromPlaylistByIdInner(playlistId, trackId);
-                playlistIds.insert(playlistId);
-            }
+        const auto trackPlaylistIds = playlistsTrackIsInCopy.values(trackId);
+        for (const auto playlistId : trackPlaylistIds) {
+            trackIdsByPlaylistId[playlistId].append(trackId);
+        }
+    }
+
+    ScopedTransaction transaction(m_database);
+    for (auto it = trackIdsByPlaylistId.constBegin();
+            it != trackIdsByPlaylistId.constEnd();
+            ++it) {
+        const auto playlistId = it.key();
+        // keep tracks in history playlists
+        if (getHiddenType(playlistId) == PlaylistDAO::PLHT_SET_LOG) {
+            continue;
         }
+        removeTracksFromPlaylistByIdInner(playlistId, it.value());
+        playlistIds.insert(playlistId);
     }
     transaction.commit();
 
@@ -144,8 +144,8 @@ class PlaylistDAO : public QObject, public virtual DAO {
 
   private:
     bool removeTracksFromPlaylist(int playlistId, int startIndex);
-    void removeTracksFromPlaylistInner(int playlistId, int position);
-    void removeTracksFromPlaylistByIdInner(int playlistId, TrackId trackId);
+    void removeTracksFromPlaylistInner(int playlistId, const QList<int>& positions);
+    void removeTracksFromPlaylistByIdInner(int playlistId, const QList<TrackId>& trackIds);
     void searchForDuplicateTrack(const int fromPosition,
                                  const int toPosition,
                                  TrackId trackID,
@@ -3,7 +3,10 @@
 #include <QChar>
 #include <QDir>
 #include <QFileInfo>
+#include <QHash>
 #include <QtDebug>
+#include <cmath>
+#include <optional>
 
 #ifdef __SQLITE3__
 #include <sqlite3.h>
@@ -326,6 +329,21 @@ bool TrackDAO::saveTrack(Track* pTrack) const {
     return true;
 }
 
+void TrackDAO::saveTracksPrepare() {
+    VERIFY_OR_DEBUG_ASSERT(!m_pSaveTracksTransaction) {
+        return;
+    }
+    m_pSaveTracksTransaction = std::make_unique<SqlTransaction>(m_database);
+}
+
+void TrackDAO::saveTracksFinish() {
+    if (!m_pSaveTracksTransaction) {
+        return;
+    }
+    m_pSaveTracksTransaction->commit();
+    m_pSaveTracksTransaction.reset();
+}
+
 void TrackDAO::slotDatabaseTracksChanged(const QSet<TrackId>& changedTrackIds) {
     if (!changedTrackIds.isEmpty()) {
         emit tracksChanged(changedTrackIds);
@@ -814,7 +832,8 @@ TrackId TrackDAO::addTracksAddTrack(const TrackPointer& pTrack, bool unremove) {
 
 TrackPointer TrackDAO::addTracksAddFile(
         const mixxx::FileAccess& fileAccess,
-        bool unremove) {
+        bool unremove,
+        const SoundSourceProxy::PrefetchedTrackMetadata* pPrefetchedMetadata) {
     // Check that track is a supported extension.
     // TODO(uklotzde): The following check can be skipped if
     // the track is already in the library. A refactoring is
@@ -864,7 +883,8 @@ TrackPointer TrackDAO::addTracksAddFile(
     // from the file.
     SoundSourceProxy(pTrack).updateTrackFromSource(
             SoundSourceProxy::UpdateTrackFromSourceMode::Once,
-            SyncTrackMetadataParams::readFromUserSettings(*m_pConfig));
+            SyncTrackMetadataParams::readFromUserSettings(*m_pConfig),
+            pPrefetchedMetadata);
     if (!pTrack->checkSourceSynchronized()) {
         qWarning() << "TrackDAO::addTracksAddFile:"
                 << "Failed to parse track metadata from file"
@@ -1290,6 +1310,83 @@ struct ColumnPopulator {
     TrackPopulatorFn populator;
 };
 
+constexpr ColumnPopulator kTrackColumns[] = {
+        // Location must be first and is populated manually!
+        {"track_locations.location", nullptr},
+        {"artist", setTrackArtist},
+        {"title", setTrackTitle},
+        {"album", setTrackAlbum},
+        {"album_artist", setTrackAlbumArtist},
+        {"year", setTrackYear},
+        {"genre", setTrackGenre},
+        {"composer", setTrackComposer},
+        {"grouping", setTrackGrouping},
+        {"tracknumber", setTrackNumber},
+        {"tracktotal", setTrackTotal},
+        {"filetype", setTrackFiletype},
+        {"rating", setTrackRating},
+        {"color", setTrackColor},
+        {"comment", setTrackComment},
+        {"url", setTrackUrl},
+        {"cuepoint", setTrackCuePoint},
+        {"replaygain", setTrackReplayGainRatio},
+        {"replaygain_peak", setTrackReplayGainPeak},
+        {"timesplayed", setTrackTimesPlayed},
+        {"last_played_at", setTrackLastPlayedAt},
+        {"played", setTrackPlayed},
+        {"datetime_added", setTrackDateAdded},
+        {"header_parsed", setTrackHeaderParsed},
+        {"source_synchronized_ms", setTrackSourceSynchronizedAt},
+
+        // Audio properties are set together at once. Do not change the
+        // ordering of these columns or put other columns in between them!
+        {"channels", setTrackAudioProperties},
+        {"samplerate", nullptr},
+        {"bitrate", nullptr},
+        {"duration", nullptr},
+
+        // Beat detection columns are handled by setTrackBeats. Do not change
+        // the ordering of these columns or put other columns in between them!
+        {"bpm", setTrackBeats},
+        {"beats_version", nullptr},
+        {"beats_sub_version", nullptr},
+        {"beats", nullptr},
+        {"bpm_lock", nullptr},
+
+        // Key detection columns are handled by setTrackKey. Do not change the
+        // ordering of these columns or put other columns in between them!
+        {"key", setTrackKey},
+        {"keys_version", nullptr},
+        {"keys_sub_version", nullptr},
+        {"keys", nullptr},
+
+        // Cover art columns are handled by setTrackCoverInfo. Do not change the
+        // ordering of these columns or put other columns in between them!
+        {"coverart_source", setTrackCoverInfo},
+        {"coverart_type", nullptr},
+        {"coverart_location", nullptr},
+        {"coverart_color", nullptr},
+        {"coverart_digest", nullptr},
+        {"coverart_hash", nullptr},
+};
+constexpr int kTrackColumnsCount = static_cast<int>(std::size(kTrackColumns));
+
+QString trackColumnsString() {
+    QString columnsStr;
+    int columnsSize = 0;
+    for (int i = 0; i < kTrackColumnsCount; ++i) {
+        columnsSize += qstrlen(kTrackColumns[i].name) + 1;
+    }
+    columnsStr.reserve(columnsSize);
+    for (int i = 0; i < kTrackColumnsCount; ++i) {
+        if (i > 0) {
+            columnsStr.append(QChar(','));
+        }
+        columnsStr.append(kTrackColumns[i].name);
+    }
+    return columnsStr;
+}
+
 }  // namespace
 
 TrackPointer TrackDAO::getTrackById(TrackId trackId) const {
@@ -1303,67 +1400,6 @@ TrackPointer TrackDAO::getTrackById(TrackId trackId) const {
         return pTrack;
     }
 
-    constexpr ColumnPopulator columns[] = {
-            // Location must be first and is populated manually!
-            {"track_locations.location", nullptr},
-            {"artist", setTrackArtist},
-            {"title", setTrackTitle},
-            {"album", setTrackAlbum},
-            {"album_artist", setTrackAlbumArtist},
-            {"year", setTrackYear},
-            {"genre", setTrackGenre},
-            {"composer", setTrackComposer},
-            {"grouping", setTrackGrouping},
-            {"tracknumber", setTrackNumber},
-            {"tracktotal", setTrackTotal},
-            {"filetype", setTrackFiletype},
-            {"rating", setTrackRating},
-            {"color", setTrackColor},
-            {"comment", setTrackComment},
-            {"url", setTrackUrl},
-            {"cuepoint", setTrackCuePoint},
-            {"replaygain", setTrackReplayGainRatio},
-            {"replaygain_peak", setTrackReplayGainPeak},
-            {"timesplayed", setTrackTimesPlayed},
-            {"last_played_at", setTrackLastPlayedAt},
-            {"played", setTrackPlayed},
-            {"datetime_added", setTrackDateAdded},
-            {"header_parsed", setTrackHeaderParsed},
-            {"source_synchronized_ms", setTrackSourceSynchronizedAt},
-
-            // Audio properties are set together at once. Do not change the
-            // ordering of these columns or put other columns in between them!
-            {"channels", setTrackAudioProperties},
-            {"samplerate", nullptr},
-            {"bitrate", nullptr},
-            {"duration", nullptr},
-
-            // Beat detection columns are handled by setTrackBeats. Do not change
-            // the ordering of these columns or put other columns in between them!
-            {"bpm", setTrackBeats},
-            {"beats_version", nullptr},
-            {"beats_sub_version", nullptr},
-            {"beats", nullptr},
-            {"bpm_lock", nullptr},
-
-            // Key detection columns are handled by setTrackKey. Do not change the
-            // ordering of these columns or put other columns in between them!
-            {"key", setTrackKey},
-            {"keys_version", nullptr},
-            {"keys_sub_version", nullptr},
-            {"keys", nullptr},
-
-            // Cover art columns are handled by setTrackCoverInfo. Do not change the
-            // ordering of these columns or put other columns in between them!
-            {"coverart_source", setTrackCoverInfo},
-            {"coverart_type", nullptr},
-            {"coverart_location", nullptr},
-            {"coverart_color", nullptr},
-            {"coverart_digest", nullptr},
-            {"coverart_hash", nullptr},
-    };
-    constexpr int columnsCount = static_cast<int>(std::size(columns));
-
     // Accessing the database is a time consuming operation that should not
     // be executed with a lock on the GlobalTrackCache. The GlobalTrackCache
     // will be locked again after the query has been executed (see below)
@@ -1372,25 +1408,12 @@ TrackPointer TrackDAO::getTrackById(TrackId trackId) const {
 
     QSqlRecord queryRecord;
     {
-        QString columnsStr;
-        int columnsSize = 0;
-        for (int i = 0; i < columnsCount; ++i) {
-            columnsSize += qstrlen(columns[i].name) + 1;
-        }
-        columnsStr.reserve(columnsSize);
-        for (int i = 0; i < columnsCount; ++i) {
-            if (i > 0) {
-                columnsStr.append(QChar(','));
-            }
-            columnsStr.append(columns[i].name);
-        }
-
         QSqlQuery query(m_database);
         query.prepare(QString(
                 "SELECT %1 FROM Library "
                 "INNER JOIN track_locations ON library.location = track_locations.id "
                 "WHERE library.id = %2")
-                              .arg(columnsStr, trackId.toString()));
+                              .arg(trackColumnsString(), trackId.toString()));
         if (!query.exec()) {
             LOG_FAILED_QUERY(query)
                     << QString("getTrack(%1)").arg(trackId.toString());
@@ -1407,10 +1430,96 @@ TrackPointer TrackDAO::getTrackById(TrackId trackId) const {
         DEBUG_ASSERT(!query.next());
     }
 
+    return loadTrackFromRecord(trackId, queryRecord, 0, nullptr);
+}
+
+QList<TrackPointer> TrackDAO::getTracksByIds(
+        const QList<TrackId>& trackIds) const {
+    QHash<TrackId, TrackPointer> tracksById;
+    QList<TrackId> missingTrackIds;
+    {
+        // The GlobalTrackCache is only locked while looking up the tracks
+        GlobalTrackCacheLocker cacheLocker;
+        for (const auto& trackId : trackIds) {
+            if (!trackId.isValid() || tracksById.contains(trackId)) {
+                continue;
+            }
+            TrackPointer pTrack = cacheLocker.lookupTrackById(trackId);
+            if (pTrack) {
+                tracksById.insert(trackId, std::move(pTrack));
+            } else {
+                missingTrackIds.append(trackId);
+            }
+        }
+    }
+
+    if (!missingTrackIds.isEmpty()) {
+        ScopedTimer t("TrackDAO::getTracksByIds");
+
+        // All rows and all cues are loaded with one query each instead of
+        // two queries per track
+        QStringList idList;
+        idList.reserve(missingTrackIds.size());
+        for (const auto& trackId : std::as_const(missingTrackIds)) {
+            idList.append(trackId.toString());
+        }
+        QSqlQuery query(m_database);
+        query.prepare(QString(
+                "SELECT library.id,%1 FROM Library "
+                "INNER JOIN track_locations ON library.location = track_locations.id "
+                "WHERE library.id IN (%2)")
+                              .arg(trackColumnsString(), idList.join(QChar(','))));
+        if (!query.exec()) {
+            LOG_FAILED_QUERY(query)
+                    << "getTracksByIds()";
+            DEBUG_ASSERT(!"Failed query");
+        } else {
+            QList<QSqlRecord> queryRecords;
+            queryRecords.reserve(missingTrackIds.size());
+            while (query.next()) {
+                queryRecords.append(query.record());
+            }
+            const QHash<TrackId, QList<CueRecord>> cueRecordsByTrackId =
+                    m_cueDao.getCueRecordsForTracks(missingTrackIds);
+            const QList<CueRecord> noCueRecords;
+            for (const auto& queryRecord : std::as_const(queryRecords)) {
+                // The track id precedes the regular columns
+                const TrackId trackId(queryRecord.value(0));
+                const auto cueRecordsIter = cueRecordsByTrackId.constFind(trackId);
+                TrackPointer pTrack = loadTrackFromRecord(trackId,
+                        queryRecord,
+                        1,
+                        cueRecordsIter != cueRecordsByTrackId.constEnd()
+                                ? &cueRecordsIter.value()
+                                : &noCueRecords);
+                if (pTrack) {
+                    tracksById.insert(trackId, std::move(pTrack));
+                }
+            }
+        }
+    }
+
+    QList<TrackPointer> tracks;
+    tracks.reserve(tracksById.size());
+    for (const auto& trackId : trackIds) {
+        TrackPointer pTrack = tracksById.take(trackId);
+        if (pTrack) {
+            tracks.append(std::move(pTrack));
+        }
+    }
+    return tracks;
+}
+
+TrackPointer TrackDAO::loadTrackFromRecord(
+        TrackId trackId,
+        const QSqlRecord& queryRecord,
+        int firstColumn,
+        const QList<CueRecord>* pCueRecords) const {
+    TrackPointer pTrack;
     {
         // Location is the first column.
-        DEBUG_ASSERT(queryRecord.count() > 0);
-        const auto trackLocation = queryRecord.value(0).toString();
+        DEBUG_ASSERT(queryRecord.count() > firstColumn);
+        const auto trackLocation = queryRecord.value(firstColumn).toString();
         const auto fileInfo = mixxx::FileInfo(trackLocation);
         const auto fileAccess = mixxx::FileAccess(fileInfo);
         const auto cacheResolver = GlobalTrackCacheResolver(fileAccess, trackId);
@@ -1467,21 +1576,24 @@ TrackPointer TrackDAO::getTrackById(TrackId trackId) const {
 
     // For every column run its populator to fill the track in with the data.
     {
-        int recordCount = queryRecord.count();
-        if (recordCount != columnsCount) {
-            recordCount = math_min(recordCount, columnsCount);
+        int recordCount = queryRecord.count() - firstColumn;
+        if (recordCount != kTrackColumnsCount) {
+            recordCount = math_min(recordCount, kTrackColumnsCount);
             DEBUG_ASSERT(!"Failed query");
         }
         for (int i = 0; i < recordCount; ++i) {
-            TrackPopulatorFn populator = columns[i].populator;
+            TrackPopulatorFn populator = kTrackColumns[i].populator;
             if (populator) {
-                (*populator)(queryRecord, i, pTrack.get());
+                (*populator)(queryRecord, firstColumn + i, pTrack.get());
             }
         }
     }
 
-    // Populate track cues from the cues table.
-    pTrack->setCuePoints(m_cueDao.getCuesForTrack(trackId));
+    // Populate track cues from the cues table unless they have already
+    // been loaded together with other tracks. The Cue objects are only
+    // created when the cues are accessed.
+    pTrack->setCueRecordsFromTrackDAO(
+            pCueRecords ? *pCueRecords : m_cueDao.getCueRecordsForTrack(trackId));
     pTrack->markClean();
 
     // Synchronize the track's metadata with the corresponding source
@@ -1606,7 +1718,12 @@ bool TrackDAO::updateTrack(const Track& track) const {
              << trackId
              << track.getLocation();
 
-    SqlTransaction transaction(m_database);
+    // Multiple tracks might be saved within a single transaction,
+    // see saveTracksPrepare()
+    std::optional<SqlTransaction> transaction;
+    if (!m_pSaveTracksTransaction) {
+        transaction.emplace(m_database);
+    }
     // PerformanceTimer time;
     // time.start();
 
@@ -1686,9 +1803,14 @@ bool TrackDAO::updateTrack(const Track& track) const {
             trackId,
             track.getWaveform(),
             track.getWaveformSummary());
-    m_cueDao.saveTrackCues(
-            trackId, track.getCuePoints());
-    transaction.commit();
+    // Cues that have never been accessed are unmodified
+    if (!track.hasPendingCueRecordsFromTrackDAO()) {
+        m_cueDao.saveTrackCues(
+                trackId, track.getCuePoints());
+    }
+    if (transaction) {
+        transaction->commit();
+    }
 
     //qDebug() << "Update track in database took: " << time.elapsed().formatMillisWithUnit();
     //time.start();
@@ -1805,20 +1927,53 @@ bool TrackDAO::detectMovedTracks(
         return true;
     }
 
-    // Query possible successors
+    // Index the possible successors by filename. This replaces a query with
+    // all added tracks for each missing track, which took hours with many
+    // moved tracks.
     // NOTE: Successors are identified by filename and duration (in seconds).
     // Since duration is stored as double-precision floating-point and since it
     // is sometimes truncated to nearest integer, tolerance of 1 second is used.
-    QSqlQuery newTrackQuery(m_database);
-    newTrackQuery.prepare(QString(
-            "SELECT library.id as track_id, track_locations.id as location_id, "
-            "track_locations.location "
-            "FROM library INNER JOIN track_locations ON library.location=track_locations.id "
-            "WHERE track_locations.location IN (%1) AND "
-            "filename=:filename AND "
-            "ABS(duration - :duration) < 1 AND "
-            "fs_deleted=0").arg(
-                    SqlStringFormatter::formatList(m_database, addedTracks)));
+    struct Successor {
+        TrackId trackId;
+        DbId locationId;
+        QString location;
+        double duration;
+    };
+    QMultiHash<QString, Successor> successorsByFilename;
+    {
+        QSqlQuery newTrackQuery(m_database);
+        newTrackQuery.prepare(QString(
+                "SELECT library.id as track_id, track_locations.id as location_id, "
+                "track_locations.location, filename, duration "
+                "FROM library INNER JOIN track_locations "
+                "ON library.location=track_locations.id "
+                "WHERE track_locations.location IN (%1) AND "
+                "fs_deleted=0")
+                        .arg(SqlStringFormatter::formatList(m_database, addedTracks)));
+        if (!newTrackQuery.exec()) {
+            LOG_FAILED_QUERY(newTrackQuery);
+            DEBUG_ASSERT(!"Failed query");
+            return false;
+        }
+        const QSqlRecord newTrackQueryRecord = newTrackQuery.record();
+        const int trackIdColumn = newTrackQueryRecord.indexOf("track_id");
+        const int locationIdColumn = newTrackQueryRecord.indexOf("location_id");
+        const int locationColumn = newTrackQueryRecord.indexOf("location");
+        const int filenameColumn = newTrackQueryRecord.indexOf("filename");
+        const int durationColumn = newTrackQueryRecord.indexOf("duration");
+        while (newTrackQuery.next()) {
+            successorsByFilename.insert(
+                    newTrackQuery.value(filenameColumn).toString(),
+                    Successor{
+                            TrackId(newTrackQuery.value(trackIdColumn)),
+                            DbId(newTrackQuery.value(locationIdColumn)),
+                            newTrackQuery.value(locationColumn).toString(),
+                            newTrackQuery.value(durationColumn).toDouble()});
+        }
+    }
+    if (successorsByFilename.isEmpty()) {
+        return true;
+    }
 
     // Query tracks, where we need a successor for
     QSqlQuery oldTrackQuery(m_database);
@@ -1844,8 +1999,11 @@ bool TrackDAO::detectMovedTracks(
         if (*pCancel) {
             return false;
         }
-        QString oldTrackLocation = oldTrackQuery.value(oldLocationColumn).toString();
         QString filename = oldTrackQuery.value(filenameColumn).toString();
+        if (!successorsByFilename.contains(filename)) {
+            continue;
+        }
+        QString oldTrackLocation = oldTrackQuery.value(oldLocationColumn).toString();
         // rather use duration then filesize as an indicator of changes. The filesize
         // can change by adding more ID3v2 tags
         const int duration = oldTrackQuery.value(durationColumn).toInt();
@@ -1854,23 +2012,15 @@ bool TrackDAO::detectMovedTracks(
                 << "Looking for substitute of missing track location"
                 << oldTrackLocation;
 
-        newTrackQuery.bindValue(":filename", filename);
-        newTrackQuery.bindValue(":duration", duration);
-        if (!newTrackQuery.exec()) {
-            LOG_FAILED_QUERY(newTrackQuery);
-            DEBUG_ASSERT(!"Failed query");
-            continue;
-        }
-        const auto newTrackIdColumn = newTrackQuery.record().indexOf("track_id");
-        const auto newTrackLocationIdColumn = newTrackQuery.record().indexOf("location_id");
-        const auto newTrackLocationColumn = newTrackQuery.record().indexOf("location");
         int newTrackLocationSuffixMatch = 0;
-        TrackId newTrackId;
-        DbId newTrackLocationId;
-        QString newTrackLocation;
-        while (newTrackQuery.next()) {
-            const auto nextTrackLocation =
-                    newTrackQuery.value(newTrackLocationColumn).toString();
+        auto newTrack = successorsByFilename.end();
+        for (auto it = successorsByFilename.find(filename);
+                it != successorsByFilename.end() && it.key() == filename;
+                ++it) {
+            if (std::abs(it->duration - duration) >= 1) {
+                continue;
+            }
+            const auto& nextTrackLocation = it->location;
             VERIFY_OR_DEBUG_ASSERT(nextTrackLocation != oldTrackLocation) {
                 continue;
             }
@@ -1882,17 +2032,21 @@ bool TrackDAO::detectMovedTracks(
             DEBUG_ASSERT(nextSuffixMatch >= filename.length());
             if (newTrackLocationSuffixMatch < nextSuffixMatch) {
                 newTrackLocationSuffixMatch = nextSuffixMatch;
-                newTrackId = TrackId(newTrackQuery.value(newTrackIdColumn));
-                newTrackLocationId = DbId(newTrackQuery.value(newTrackLocationIdColumn));
-                newTrackLocation = nextTrackLocation;
+                newTrack = it;
             }
         }
-        if (newTrackLocation.isEmpty()) {
+        if (newTrack == successorsByFilename.end()) {
             kLogger.info()
                     << "Found no substitute for missing track location"
                     << oldTrackLocation;
             continue;
         }
+        TrackId newTrackId = newTrack->trackId;
+        const DbId newTrackLocationId = newTrack->locationId;
+        const QString newTrackLocation = newTrack->location;
+        // The library row of the successor is deleted below, i.e. it
+        // cannot replace another missing track
+        successorsByFilename.erase(newTrack);
         DEBUG_ASSERT(newTrackId.isValid());
         DEBUG_ASSERT(newTrackLocationId.isValid());
         kLogger.info()
@@ -8,14 +8,17 @@
 #include "library/dao/dao.h"
 #include "library/relocatedtrack.h"
 #include "preferences/usersettings.h"
+#include "sources/soundsourceproxy.h"
 #include "track/globaltrackcache.h"
 #include "util/class.h"
 #include "util/memory.h"
 
+class QSqlRecord;
 class SqlTransaction;
 class PlaylistDAO;
 class AnalysisDao;
 class CueDAO;
+struct CueRecord;
 class LibraryHashDAO;
 
 namespace mixxx {
@@ -71,6 +74,10 @@ class TrackDAO : public QObject, public virtual DAO, public virtual GlobalTrackC
 
     // Only used by friend class TrackCollection, but public for testing!
     bool saveTrack(Track* pTrack) const;
+    /// All tracks that are saved until saveTracksFinish() is invoked
+    /// are updated within a single transaction.
+    void saveTracksPrepare();
+    void saveTracksFinish();
 
     /// Update the play counter properties according to the corresponding
     /// aggregated properties obtained from the played history.
@@ -133,6 +140,18 @@ class TrackDAO : public QObject, public virtual DAO, public virtual GlobalTrackC
             const QString& location) const;
     TrackPointer getTrackById(
             TrackId trackId) const;
+    // Loads multiple tracks with a constant number of queries instead of
+    // multiple queries per track. Tracks that are not found are omitted,
+    // otherwise the ordering of the ids is preserved.
+    QList<TrackPointer> getTracksByIds(
+            const QList<TrackId>& trackIds) const;
+    // Populates the track with the given columns, starting at firstColumn,
+    // and the given cues. The cues are loaded if pCueRecords is nullptr.
+    TrackPointer loadTrackFromRecord(
+            TrackId trackId,
+            const QSqlRecord& queryRecord,
+            int firstColumn,
+            const QList<CueRecord>* pCueRecords) const;
 
     // Loads a track from the database (by id if available, otherwise by location)
     // or adds it if not found in case the location is known. The (optional) out
@@ -147,15 +166,20 @@ class TrackDAO : public QObject, public virtual DAO, public virtual GlobalTrackC
     TrackId addTracksAddTrack(
             const TrackPointer& pTrack,
             bool unremove);
+    // The metadata of new tracks is imported from the file unless it
+    // has already been prefetched.
     TrackPointer addTracksAddFile(
             const mixxx::FileAccess& fileAccess,
-            bool unremove);
+            bool unremove,
+            const SoundSourceProxy::PrefetchedTrackMetadata* pPrefetchedMetadata = nullptr);
     TrackPointer addTracksAddFile(
             const QString& filePath,
-            bool unremove) {
+            bool unremove,
+            const SoundSourceProxy::PrefetchedTrackMetadata* pPrefetchedMetadata = nullptr) {
         return addTracksAddFile(
                 mixxx::FileAccess(mixxx::FileInfo(filePath)),
-                unremove);
+                unremove,
+                pPrefetchedMetadata);
     }
     void addTracksFinish(bool rollback = false);
 
@@ -207,6 +231,7 @@ class TrackDAO : public QObject, public virtual DAO, public virtual GlobalTrackC
     std::unique_ptr<QSqlQuery> m_pQueryLibraryUpdate;
     std::unique_ptr<QSqlQuery> m_pQueryLibrarySelect;
     std::unique_ptr<SqlTransaction> m_pTransaction;
+    std::unique_ptr<SqlTransaction> m_pSaveTracksTransaction;
     int m_trackLocationIdColumn;
     int m_queryLibraryIdColumn;
     int m_queryLibraryMixxxDeletedColumn;
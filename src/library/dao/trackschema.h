@@ -4,6 +4,8 @@
 
 #define LIBRARY_TABLE "library"
 #define TRACKLOCATIONS_TABLE "track_locations"
+// Full-text index of the text columns of LIBRARY_TABLE
+#define LIBRARY_FTS_TABLE "library_fts"
 
 const QString LIBRARYTABLE_ID = QStringLiteral("id");
 const QString LIBRARYTABLE_ARTIST = QStringLiteral("artist");
@@ -1,18 +1,25 @@
 #include "library/export/engineprimeexportjob.h"
 
+#include <QCryptographicHash>
+#include <QDataStream>
 #include <QHash>
 #include <QStringList>
 #include <array>
 #include <cstdint>
+#include <deque>
 #include <memory>
 #include <stdexcept>
 
+#include "library/dao/analysisdao.h"
 #include "library/export/engineprimeexportrequest.h"
 #include "library/trackcollection.h"
 #include "library/trackcollectionmanager.h"
 #include "library/trackset/crate/crate.h"
 #include "moc_engineprimeexportjob.cpp"
 #include "track/track.h"
+#include "util/backgroundtask.h"
+#include "util/db/dbconnectionpooled.h"
+#include "util/db/dbconnectionpooler.h"
 #include "util/optional.h"
 #include "util/thread_affinity.h"
 #include "waveform/waveformfactory.h"
@@ -29,6 +36,15 @@ constexpr int kMaxHotCues = 8;
 
 constexpr uint8_t kDefaultWaveformOpacity = 127;
 
+const QString kSignaturesFileName = QStringLiteral("mixxx-export-signatures");
+
+struct PendingTrack {
+    TrackPointer pTrack;
+    QString relativePath;
+    QByteArray signature;
+    QFuture<std::optional<std::vector<djinterop::waveform_entry>>> waveform;
+};
+
 const QStringList kSupportedFileTypes = {
         "aac",
         "m4a",
@@ -166,12 +182,110 @@ bool tryGetBeatgrid(BeatsPointer pBeats,
     return true;
 }
 
+int64_t frameCountOf(const TrackPointer& pTrack) {
+    // Frames used interchangeably with "samples" here.
+    return static_cast<int64_t>(pTrack->getDuration() * pTrack->getSampleRate());
+}
+
+/// Reads and downsamples the high-resolution waveform, the most expensive
+/// part of the export of a track.  Runs as a background task.
+std::optional<std::vector<djinterop::waveform_entry>> encodeWaveform(
+        const QList<AnalysisDao::AnalysisInfo>& waveformAnalyses,
+        bool isV2Schema,
+        int64_t frameCount,
+        mixxx::audio::SampleRate sampleRate) {
+    if (waveformAnalyses.isEmpty()) {
+        return std::nullopt;
+    }
+    const std::unique_ptr<Waveform> pWaveform(
+            WaveformFactory::loadWaveformFromAnalysis(waveformAnalyses.first()));
+    djinterop::waveform_extents extents = isV2Schema
+            ? e::calculate_overview_waveform_extents(frameCount, sampleRate)
+            : e::calculate_high_resolution_waveform_extents(frameCount, sampleRate);
+    std::vector<djinterop::waveform_entry> externalWaveform;
+    externalWaveform.reserve(extents.size);
+    for (uint64_t i = 0; i < extents.size; ++i) {
+        uint64_t j = pWaveform->getDataSize() * i / extents.size;
+        externalWaveform.push_back({{pWaveform->getLow(j), kDefaultWaveformOpacity},
+                {pWaveform->getMid(j), kDefaultWaveformOpacity},
+                {pWaveform->getHigh(j), kDefaultWaveformOpacity}});
+    }
+    return externalWaveform;
+}
+
+/// Identifies everything that is exported for a track.  A track with an
+/// unchanged signature is not written again by an incremental export.
+QByteArray exportSignature(const TrackPointer& pTrack,
+        const QList<int>& waveformAnalysisIds,
+        bool isV2Schema) {
+    QByteArray data;
+    QDataStream stream(&data, QIODevice::WriteOnly);
+    const mixxx::FileInfo fileInfo = pTrack->getFileInfo();
+    stream << fileInfo.sizeInBytes() << fileInfo.lastModified()
+           << pTrack->getTitle() << pTrack->getArtist() << pTrack->getAlbum()
+           << pTrack->getGenre() << pTrack->getComment() << pTrack->getComposer()
+           << pTrack->getYear() << pTrack->getTrackNumber()
+           << pTrack->getDuration() << pTrack->getBpm()
+           << static_cast<int>(pTrack->getKey()) << pTrack->getBitrate()
+           << pTrack->getRating()
+           << static_cast<quint32>(pTrack->getSampleRate());
+    const mixxx::audio::FramePos cuePlayPos = pTrack->getMainCuePosition();
+    stream << (cuePlayPos.isValid() ? cuePlayPos.value() : -1.0);
+    const BeatsPointer pBeats = pTrack->getBeats();
+    if (pBeats) {
+        stream << pBeats->getVersion() << pBeats->toByteArray();
+    }
+    for (const CuePointer& pCue : pTrack->getCuePoints()) {
+        if (pCue->getType() != CueType::HotCue) {
+            continue;
+        }
+        const mixxx::audio::FramePos position = pCue->getPosition();
+        stream << pCue->getHotCue()
+               << (position.isValid() ? position.value() : -1.0)
+               << pCue->getLabel()
+               << mixxx::RgbColor::toQColor(pCue->getColor()).rgba();
+    }
+    stream << waveformAnalysisIds << isV2Schema;
+    return QCryptographicHash::hash(data, QCryptographicHash::Sha1).toHex();
+}
+
+/// The signatures of the exported tracks by their relative path are kept
+/// next to the Engine library database.
+QString signaturesFilePath(const QSharedPointer<EnginePrimeExportRequest>& pRequest) {
+    return pRequest->engineLibraryDbDir.filePath(kSignaturesFileName);
+}
+
+QHash<QString, QByteArray> loadSignatures(const QString& filePath) {
+    QHash<QString, QByteArray> signatures;
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return signatures;
+    }
+    QDataStream stream(&file);
+    stream >> signatures;
+    if (stream.status() != QDataStream::Ok) {
+        qWarning() << "Ignoring corrupt export signatures" << filePath;
+        signatures.clear();
+    }
+    return signatures;
+}
+
+void saveSignatures(const QString& filePath, const QHash<QString, QByteArray>& signatures) {
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning() << "Failed to save export signatures" << filePath
+                   << file.errorString();
+        return;
+    }
+    QDataStream stream(&file);
+    stream << signatures;
+}
+
 void exportMetadata(
         djinterop::database* pDatabase,
-        const e::engine_version& dbVersion,
         QHash<TrackId, int64_t>* pMixxxToEnginePrimeTrackIdMap,
         TrackPointer pTrack,
-        const Waveform* pWaveform,
+        std::optional<std::vector<djinterop::waveform_entry>> waveform,
         const QString& relativePath) {
     // Attempt to load the track in the database, using the relative path to
     // the music file.  If it exists already, take a snapshot of the track and
@@ -202,8 +316,7 @@ void exportMetadata(
     snapshot.rating = pTrack->getRating() * 20; // note rating is in range 0-100
     snapshot.file_bytes = pTrack->getFileInfo().sizeInBytes();
 
-    // Frames used interchangeably with "samples" here.
-    const auto frameCount = static_cast<int64_t>(pTrack->getDuration() * pTrack->getSampleRate());
+    const auto frameCount = frameCountOf(pTrack);
     snapshot.sample_count = frameCount;
     snapshot.sample_rate = pTrack->getSampleRate();
 
@@ -280,21 +393,8 @@ void exportMetadata(
     // TODO (mr-smidge): Export saved loops.
 
     // Write waveform.
-    if (pWaveform) {
-        djinterop::waveform_extents extents = dbVersion.is_v2_schema()
-                ? e::calculate_overview_waveform_extents(
-                          frameCount, pTrack->getSampleRate())
-                : e::calculate_high_resolution_waveform_extents(
-                          frameCount, pTrack->getSampleRate());
-        std::vector<djinterop::waveform_entry> externalWaveform;
-        externalWaveform.reserve(extents.size);
-        for (uint64_t i = 0; i < extents.size; ++i) {
-            uint64_t j = pWaveform->getDataSize() * i / extents.size;
-            externalWaveform.push_back({{pWaveform->getLow(j), kDefaultWaveformOpacity},
-                    {pWaveform->getMid(j), kDefaultWaveformOpacity},
-                    {pWaveform->getHigh(j), kDefaultWaveformOpacity}});
-        }
-        snapshot.waveform = std::move(externalWaveform);
+    if (waveform) {
+        snapshot.waveform = std::move(*waveform);
     } else {
         qInfo() << "No waveform data found for track" << pTrack->getId()
                 << "(" << pTrack->getFileInfo().fileName() << ")";
@@ -313,31 +413,14 @@ void exportMetadata(
     pMixxxToEnginePrimeTrackIdMap->insert(pTrack->getId(), externalTrackId);
 }
 
-void exportTrack(
-        const QSharedPointer<EnginePrimeExportRequest> pRequest,
-        djinterop::database* pDatabase,
-        const e::engine_version& dbVersion,
-        QHash<TrackId, int64_t>* pMixxxToEnginePrimeTrackIdMap,
-        const TrackPointer pTrack,
-        const Waveform* pWaveform) {
-    // Only export supported file types.
+bool isSupportedFileType(const TrackPointer& pTrack) {
     if (!kSupportedFileTypes.contains(pTrack->getType())) {
         qInfo() << "Skipping file" << pTrack->getFileInfo().fileName()
                 << "(id" << pTrack->getId() << ") as its file type"
                 << pTrack->getType() << "is not supported";
-        return;
+        return false;
     }
-
-    // Copy the file, if required.
-    const auto musicFileRelativePath = exportFile(pRequest, pTrack);
-
-    // Export meta-data.
-    exportMetadata(pDatabase,
-            dbVersion,
-            pMixxxToEnginePrimeTrackIdMap,
-            pTrack,
-            pWaveform,
-            musicFileRelativePath);
+    return true;
 }
 
 void exportCrate(
@@ -364,9 +447,13 @@ void exportCrate(
 
 EnginePrimeExportJob::EnginePrimeExportJob(
         QObject* parent,
+        UserSettingsPointer pConfig,
+        DbConnectionPoolPtr pDbConnectionPool,
         TrackCollectionManager* pTrackCollectionManager,
         QSharedPointer<EnginePrimeExportRequest> pRequest)
         : QThread{parent},
+          m_pConfig{std::move(pConfig)},
+          m_pDbConnectionPool{std::move(pDbConnectionPool)},
           m_pTrackCollectionManager(pTrackCollectionManager),
           m_pRequest{pRequest} {
     // Must be collocated with the TrackCollectionManager.
@@ -451,18 +538,6 @@ void EnginePrimeExportJob::loadTrack(const TrackRef& trackRef) {
 
     // Load the track.
     m_pLastLoadedTrack = m_pTrackCollectionManager->getOrAddTrack(trackRef);
-
-    // Load high-resolution waveform from analysis info.
-    auto& analysisDao = m_pTrackCollectionManager->internalCollection()->getAnalysisDAO();
-    const auto waveformAnalyses = analysisDao.getAnalysesForTrackByType(
-            m_pLastLoadedTrack->getId(), AnalysisDao::TYPE_WAVEFORM);
-    if (!waveformAnalyses.isEmpty()) {
-        const auto& waveformAnalysis = waveformAnalyses.first();
-        m_pLastLoadedWaveform.reset(
-                WaveformFactory::loadWaveformFromAnalysis(waveformAnalysis));
-    } else {
-        m_pLastLoadedWaveform.reset();
-    }
 }
 
 void EnginePrimeExportJob::loadCrate(const CrateId& crateId) {
@@ -502,11 +577,18 @@ void EnginePrimeExportJob::run() {
     emit jobMaximum(maxProgress);
     emit jobProgress(currProgress);
 
+    // Reading the waveforms is the most expensive database access and
+    // doesn't need to block the main thread.
+    const DbConnectionPooler dbConnectionPooler(
+            m_pDbConnectionPool, DbConnectionPool::AccessMode::ReadOnly);
+    AnalysisDao analysisDao(m_pConfig);
+    analysisDao.initialize(DbConnectionPooled(m_pDbConnectionPool));
+
     // Ensure that the database exists, creating an empty one if not.
     std::unique_ptr<djinterop::database> pDb;
     e::engine_version dbVersion;
+    bool created = false;
     try {
-        bool created;
         pDb = std::make_unique<djinterop::database>(e::create_or_load_database(
                 m_pRequest->engineLibraryDbDir.path().toStdString(),
                 m_pRequest->exportVersion,
@@ -529,6 +611,42 @@ void EnginePrimeExportJob::run() {
     // We will build up a map from Mixxx track id to EL track id during export.
     QHash<TrackId, int64_t> mixxxToEnginePrimeTrackIdMap;
 
+    // Tracks that are unchanged since the last export into an existing
+    // database are not written again.
+    const QString signaturesPath = signaturesFilePath(m_pRequest);
+    const QHash<QString, QByteArray> previousSignatures = created
+            ? QHash<QString, QByteArray>{}
+            : loadSignatures(signaturesPath);
+    QHash<QString, QByteArray> signatures = previousSignatures;
+
+    // The waveforms are encoded in parallel while the tracks are written to
+    // the database in order, on this thread.
+    const int maxPendingTracks = 2 * backgroundtask::maxConcurrency();
+    std::deque<PendingTrack> pendingTracks;
+    const auto writeOldestTrack = [&]() {
+        PendingTrack track = std::move(pendingTracks.front());
+        pendingTracks.pop_front();
+        qInfo() << "Exporting track" << track.pTrack->getId().toString()
+                << "at" << track.pTrack->getFileInfo().location() << "...";
+        try {
+            exportMetadata(pDb.get(),
+                    &mixxxToEnginePrimeTrackIdMap,
+                    track.pTrack,
+                    track.waveform.result(),
+                    track.relativePath);
+        } catch (std::exception& e) {
+            qWarning() << "Failed to export track"
+                       << track.pTrack->getId().toString() << ":"
+                       << e.what();
+            m_lastErrorMessage = e.what();
+            return false;
+        }
+        signatures.insert(track.relativePath, track.signature);
+        ++currProgress;
+        emit jobProgress(currProgress);
+        return true;
+    };
+
     for (const auto& trackRef : std::as_const(m_trackRefs)) {
         // Load each track.
         // Note that loading must happen on the same thread as the track collection
@@ -545,30 +663,78 @@ void EnginePrimeExportJob::run() {
         }
 
         DEBUG_ASSERT(m_pLastLoadedTrack != nullptr);
+        const TrackPointer pTrack = std::move(m_pLastLoadedTrack);
+
+        // Only export supported file types.
+        if (!isSupportedFileType(pTrack)) {
+            ++currProgress;
+            emit jobProgress(currProgress);
+            continue;
+        }
 
-        qInfo() << "Exporting track" << m_pLastLoadedTrack->getId().toString()
-                << "at" << m_pLastLoadedTrack->getFileInfo().location() << "...";
+        QString relativePath;
+        std::optional<djinterop::track> externalTrack;
         try {
-            exportTrack(m_pRequest,
-                    pDb.get(),
-                    dbVersion,
-                    &mixxxToEnginePrimeTrackIdMap,
-                    m_pLastLoadedTrack,
-                    m_pLastLoadedWaveform.get());
+            // Copy the file, if required.
+            relativePath = exportFile(m_pRequest, pTrack);
+            if (previousSignatures.contains(relativePath)) {
+                externalTrack = getTrackByRelativePath(pDb.get(), relativePath);
+            }
         } catch (std::exception& e) {
             qWarning() << "Failed to export track"
-                       << m_pLastLoadedTrack->getId().toString() << ":"
+                       << pTrack->getId().toString() << ":"
                        << e.what();
             m_lastErrorMessage = e.what();
             emit failed(m_lastErrorMessage);
             return;
         }
 
-        m_pLastLoadedTrack.reset();
+        const QByteArray signature = exportSignature(pTrack,
+                analysisDao.getAnalysisIdsForTrackByType(
+                        pTrack->getId(), AnalysisDao::TYPE_WAVEFORM),
+                dbVersion.is_v2_schema());
+        if (externalTrack && previousSignatures.value(relativePath) == signature) {
+            qDebug() << "Track" << pTrack->getId().toString()
+                     << "is unchanged since the last export";
+            mixxxToEnginePrimeTrackIdMap.insert(pTrack->getId(), externalTrack->id());
+            ++currProgress;
+            emit jobProgress(currProgress);
+            continue;
+        }
 
-        ++currProgress;
-        emit jobProgress(currProgress);
+        // Load high-resolution waveform from analysis info.
+        const auto waveformAnalyses = analysisDao.getAnalysesForTrackByType(
+                pTrack->getId(), AnalysisDao::TYPE_WAVEFORM);
+        pendingTracks.push_back(PendingTrack{
+                pTrack,
+                relativePath,
+                signature,
+                backgroundtask::run(BackgroundTaskPriority::Batch,
+                        [waveformAnalyses,
+                                isV2Schema = dbVersion.is_v2_schema(),
+                                frameCount = frameCountOf(pTrack),
+                                sampleRate = pTrack->getSampleRate()] {
+                            return encodeWaveform(waveformAnalyses,
+                                    isV2Schema,
+                                    frameCount,
+                                    sampleRate);
+                        }),
+        });
+
+        while (static_cast<int>(pendingTracks.size()) >= maxPendingTracks) {
+            if (!writeOldestTrack()) {
+                emit failed(m_lastErrorMessage);
+                return;
+            }
+        }
+    }
+    while (!pendingTracks.empty()) {
+        if (!writeOldestTrack()) {
+            emit failed(m_lastErrorMessage);
+            return;
+        }
     }
+    saveSignatures(signaturesPath, signatures);
 
     // We will ensure that there is a special top-level crate representing the
     // root of all Mixxx-exported items.  Mixxx tracks and crates will exist
@@ -8,13 +8,14 @@
 #include <memory>
 
 #include "library/trackset/crate/crate.h"
+#include "preferences/usersettings.h"
 #include "library/trackset/crate/crateid.h"
 #include "track/track_decl.h"
 #include "track/trackid.h"
 #include "track/trackref.h"
+#include "util/db/dbconnectionpool.h"
 
 class TrackCollectionManager;
-class Waveform;
 
 namespace mixxx {
 
@@ -29,6 +30,8 @@ class EnginePrimeExportJob : public QThread {
   public:
     EnginePrimeExportJob(
             QObject* parent,
+            UserSettingsPointer pConfig,
+            DbConnectionPoolPtr pDbConnectionPool,
             TrackCollectionManager* pTrackCollectionManager,
             QSharedPointer<EnginePrimeExportRequest> pRequest);
 
@@ -55,7 +58,8 @@ class EnginePrimeExportJob : public QThread {
   private slots:
     // These slots are used to load data from the Mixxx database on the main
     // thread of the application, which will be different to the worker thread
-    // used by an instance of this class.
+    // used by an instance of this class. Analysis data like waveforms is
+    // read directly on the worker thread through a read-only connection.
     void loadIds(const QSet<CrateId>& crateIdsToExport);
     void loadTrack(const TrackRef& trackRef);
     void loadCrate(const CrateId& crateId);
@@ -64,12 +68,13 @@ class EnginePrimeExportJob : public QThread {
     QList<TrackRef> m_trackRefs;
     QList<CrateId> m_crateIds;
     TrackPointer m_pLastLoadedTrack;
-    std::unique_ptr<Waveform> m_pLastLoadedWaveform;
     Crate m_lastLoadedCrate;
     QList<TrackId> m_lastLoadedCrateTrackIds;
 
     QAtomicInteger<int> m_cancellationRequested;
 
+    const UserSettingsPointer m_pConfig;
+    const DbConnectionPoolPtr m_pDbConnectionPool;
     TrackCollectionManager* m_pTrackCollectionManager;
     QSharedPointer<EnginePrimeExportRequest> m_pRequest;
 
@@ -11,9 +11,11 @@ namespace mixxx {
 
 LibraryExporter::LibraryExporter(QWidget* parent,
         UserSettingsPointer pConfig,
+        DbConnectionPoolPtr pDbConnectionPool,
         TrackCollectionManager* pTrackCollectionManager)
         : QWidget{parent},
           m_pConfig{std::move(pConfig)},
+          m_pDbConnectionPool{std::move(pDbConnectionPool)},
           m_pTrackCollectionManager{pTrackCollectionManager} {
 }
 
@@ -43,6 +45,8 @@ void LibraryExporter::beginEnginePrimeExport(
     // Note that the job will run in a background thread.
     auto pJobThread = make_parented<EnginePrimeExportJob>(
             this,
+            m_pConfig,
+            m_pDbConnectionPool,
             m_pTrackCollectionManager,
             pRequest);
     connect(pJobThread, &EnginePrimeExportJob::finished, pJobThread, &QObject::deleteLater);
@@ -6,6 +6,7 @@
 #include "library/export/dlglibraryexport.h"
 #include "library/trackset/crate/crateid.h"
 #include "preferences/usersettings.h"
+#include "util/db/dbconnectionpool.h"
 #include "util/optional.h"
 #include "util/parented_ptr.h"
 
@@ -24,6 +25,7 @@ class LibraryExporter : public QWidget {
   public:
     LibraryExporter(QWidget* parent,
             UserSettingsPointer pConfig,
+            DbConnectionPoolPtr pDbConnectionPool,
             TrackCollectionManager* pTrackCollectionManager);
 
   public slots:
@@ -46,6 +48,7 @@ class LibraryExporter : public QWidget {
             std::optional<CrateId> initialSelectedCrate);
 
     UserSettingsPointer m_pConfig;
+    DbConnectionPoolPtr m_pDbConnectionPool;
     TrackCollectionManager* m_pTrackCollectionManager;
     parented_ptr<DlgLibraryExport> m_pDialog;
 };
@@ -26,7 +26,12 @@ bool TrackExportWizard::selectDestinationDirectory() {
     m_pConfig->set(ConfigKey("[Library]", "LastTrackCopyDirectory"),
                    ConfigValue(destDir));
 
-    m_worker.reset(new TrackExportWorker(destDir, m_tracks));
+    // A single lane is faster on USB sticks and hard disks, SSDs benefit
+    // from more
+    const int ioLanes = m_pConfig->getValue(
+            ConfigKey("[Library]", "TrackCopyIoLanes"),
+            TrackExportWorker::kDefaultIoLanes);
+    m_worker.reset(new TrackExportWorker(destDir, m_tracks, ioLanes));
     m_dialog.reset(new TrackExportDlg(m_parent, m_pConfig, m_worker.data()));
     return true;
 }
@@ -2,12 +2,121 @@
 
 #include <QDebug>
 #include <QFileInfo>
+#include <QStorageInfo>
+#include <QTextStream>
+#include <deque>
+
+#ifdef __LINUX__
+#include <fcntl.h>
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 #include "moc_trackexportworker.cpp"
 #include "track/track.h"
+#include "util/backgroundtask.h"
 
 namespace {
 
+struct PendingCopy {
+    QString fileName;
+    QString destFileName;
+    QString manifestEntry;
+    // An empty error message on success
+    QFuture<QString> result;
+};
+
+// Identifies the version of a source file in the manifest
+QString manifestEntry(const mixxx::FileInfo& fileinfo) {
+    return QString::number(fileinfo.sizeInBytes()) + QChar('\t') +
+            QString::number(fileinfo.lastModified().toMSecsSinceEpoch());
+}
+
+// Maps the destination file names to the manifest entries of their sources
+QHash<QString, QString> readManifest(const QString& manifestPath) {
+    QHash<QString, QString> manifest;
+    QFile manifestFile(manifestPath);
+    if (!manifestFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        return manifest;
+    }
+    QTextStream stream(&manifestFile);
+    QString line;
+    while (stream.readLineInto(&line)) {
+        // The file name may contain tabs, the entry does not
+        const QString fileName = line.section(QChar('\t'), 0, -3);
+        if (!fileName.isEmpty()) {
+            manifest.insert(fileName, line.section(QChar('\t'), -2));
+        }
+    }
+    return manifest;
+}
+
+#ifdef __LINUX__
+// Clones the file on file systems with reflinks like Btrfs and XFS, otherwise
+// copies it within the kernel.  Returns false if neither is possible, the
+// destination does not exist then.
+bool copyFileInKernel(const QString& sourcePath, const QString& destPath) {
+    const QByteArray source = QFile::encodeName(sourcePath);
+    const QByteArray dest = QFile::encodeName(destPath);
+    const int sourceFd = ::open(source.constData(), O_RDONLY | O_CLOEXEC);
+    if (sourceFd < 0) {
+        return false;
+    }
+    struct stat sourceStat;
+    if (::fstat(sourceFd, &sourceStat) != 0) {
+        ::close(sourceFd);
+        return false;
+    }
+    const int destFd = ::open(dest.constData(),
+            O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC,
+            sourceStat.st_mode & 0777);
+    if (destFd < 0) {
+        ::close(sourceFd);
+        return false;
+    }
+    bool copied = ::ioctl(destFd, FICLONE, sourceFd) == 0;
+    if (!copied) {
+        // Fails with EXDEV between most file systems
+        off_t remaining = sourceStat.st_size;
+        copied = true;
+        while (remaining > 0) {
+            const ssize_t written = ::copy_file_range(
+                    sourceFd, nullptr, destFd, nullptr, remaining, 0);
+            if (written <= 0) {
+                copied = false;
+                break;
+            }
+            remaining -= written;
+        }
+    }
+    ::close(destFd);
+    ::close(sourceFd);
+    if (!copied) {
+        ::unlink(dest.constData());
+    }
+    return copied;
+}
+#endif
+
+// Runs in the I/O thread pool.  Returns an error message on failure.
+QString copyFileContents(const QString& sourcePath, const QString& destPath) {
+    qDebug() << "Copying" << sourcePath << "to" << destPath;
+#ifdef __LINUX__
+    if (copyFileInKernel(sourcePath, destPath)) {
+        return QString();
+    }
+#endif
+    QFile sourceFile(sourcePath);
+    if (!sourceFile.copy(destPath)) {
+        return TrackExportWorker::tr(
+                "Error exporting track %1 to %2: %3. Stopping.")
+                .arg(sourcePath, destPath, sourceFile.errorString());
+    }
+    return QString();
+}
+
 QString rewriteFilename(const mixxx::FileInfo& fileinfo, int index) {
     // We don't have total control over the inputs, so definitely
     // don't use .arg().arg().arg().
@@ -69,24 +178,130 @@ QMap<QString, mixxx::FileInfo> createCopylist(const TrackPointerList& tracks) {
 
 void TrackExportWorker::run() {
     int i = 0;
-    QMap<QString, mixxx::FileInfo> copy_list = createCopylist(m_tracks);
+    const QMap<QString, mixxx::FileInfo> copy_list = createCopylist(m_tracks);
+    const QString manifestPath = QDir(m_destDir).filePath(kManifestFileName);
+    const QHash<QString, QString> manifest = readManifest(manifestPath);
+    if (!checkFreeSpace(copy_list, manifest)) {
+        emit canceled();
+        return;
+    }
+
+    QFile manifestFile(manifestPath);
+    if (!manifestFile.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text)) {
+        qWarning() << "Failed to open the export manifest" << manifestPath
+                   << manifestFile.errorString();
+    }
+
+    std::deque<PendingCopy> pendingCopies;
+    const auto finishOldestCopy = [&]() {
+        PendingCopy& copy = pendingCopies.front();
+        const QString error_message = copy.result.result();
+        if (error_message.isEmpty()) {
+            if (manifestFile.isOpen()) {
+                manifestFile.write(
+                        (copy.destFileName + QChar('\t') + copy.manifestEntry + QChar('\n'))
+                                .toUtf8());
+                manifestFile.flush();
+            }
+            ++i;
+            emit progress(copy.fileName, i, copy_list.size());
+        } else if (m_errorMessage.isEmpty()) {
+            qWarning() << error_message;
+            m_errorMessage = error_message;
+            stop();
+        }
+        pendingCopies.pop_front();
+    };
+
     for (auto it = copy_list.constBegin(); it != copy_list.constEnd(); ++it) {
-        // We emit progress twice per loop, which may seem excessive, but it
+        if (m_bStop.loadAcquire()) {
+            break;
+        }
+        // We emit progress twice per file, which may seem excessive, but it
         // guarantees that we emit a sane progress before we start and after
         // we end.  In between, each filename will get its own visible tick
         // on the bar, which looks really nice.
         emit progress(it->fileName(), i, copy_list.size());
-        copyFile(*it, it.key());
-        if (m_bStop.loadAcquire()) {
-            emit canceled();
-            return;
+
+        const QString entry = manifestEntry(*it);
+        const QFileInfo dest_fileinfo(QDir(m_destDir).filePath(it.key()));
+        if (manifest.value(it.key()) == entry && dest_fileinfo.exists() &&
+                dest_fileinfo.size() == it->sizeInBytes()) {
+            // Already exported by an interrupted export
+            ++i;
+            emit progress(it->fileName(), i, copy_list.size());
+            continue;
         }
-        ++i;
-        emit progress(it->fileName(), i, copy_list.size());
+        if (!prepareDestination(*it, it.key())) {
+            if (m_bStop.loadAcquire()) {
+                break;
+            }
+            ++i;
+            emit progress(it->fileName(), i, copy_list.size());
+            continue;
+        }
+
+        pendingCopies.push_back(PendingCopy{
+                it->fileName(),
+                it.key(),
+                entry,
+                mixxx::backgroundtask::run(mixxx::BackgroundTaskPriority::Batch,
+                        [sourcePath = it->canonicalLocation(),
+                                destPath = dest_fileinfo.filePath()] {
+                            return copyFileContents(sourcePath, destPath);
+                        }),
+        });
+        // Bounds the queue, the next question waits for a free lane
+        while (static_cast<int>(pendingCopies.size()) >= m_ioLanes) {
+            finishOldestCopy();
+        }
+    }
+    // Copies in progress are completed even if canceled
+    while (!pendingCopies.empty()) {
+        finishOldestCopy();
     }
+    manifestFile.close();
+
+    if (m_bStop.loadAcquire()) {
+        emit canceled();
+        return;
+    }
+    // The export is complete, nothing to resume
+    manifestFile.remove();
 }
 
-void TrackExportWorker::copyFile(
+bool TrackExportWorker::checkFreeSpace(
+        const QMap<QString, mixxx::FileInfo>& copylist,
+        const QHash<QString, QString>& manifest) {
+    const QStorageInfo storage(m_destDir);
+    if (!storage.isValid() || storage.bytesAvailable() < 0) {
+        // Unknown, the copy will fail if the space runs out
+        return true;
+    }
+    qint64 bytesNeeded = 0;
+    for (auto it = copylist.constBegin(); it != copylist.constEnd(); ++it) {
+        if (manifest.value(it.key()) == manifestEntry(*it)) {
+            continue;
+        }
+        // An overwritten file frees its space
+        const QFileInfo dest_fileinfo(QDir(m_destDir).filePath(it.key()));
+        const qint64 existingSize = dest_fileinfo.exists() ? dest_fileinfo.size() : 0;
+        bytesNeeded += qMax(it->sizeInBytes() - existingSize, qint64(0));
+    }
+    if (bytesNeeded <= storage.bytesAvailable()) {
+        return true;
+    }
+    m_errorMessage = tr(
+            "Not enough free space in %1: %2 MB are needed, %3 MB are available.")
+                             .arg(m_destDir,
+                                     QString::number(bytesNeeded / (1024 * 1024)),
+                                     QString::number(storage.bytesAvailable() /
+                                             (1024 * 1024)));
+    qWarning() << m_errorMessage;
+    return false;
+}
+
+bool TrackExportWorker::prepareDestination(
         const mixxx::FileInfo& source_fileinfo,
         const QString& dest_filename) {
     QString sourceFilename = source_fileinfo.canonicalLocation();
@@ -101,19 +316,19 @@ void TrackExportWorker::copyFile(
             case OverwriteAnswer::SKIP:
             case OverwriteAnswer::SKIP_ALL:
                 qDebug() << "skipping" << sourceFilename;
-                return;
+                return false;
             case OverwriteAnswer::OVERWRITE:
             case OverwriteAnswer::OVERWRITE_ALL:
                 break;
             case OverwriteAnswer::CANCEL:
                 m_errorMessage = tr("Export process was canceled");
                 stop();
-                return;
+                return false;
             }
             break;
         case OverwriteMode::SKIP_ALL:
             qDebug() << "skipping" << sourceFilename;
-            return;
+            return false;
         case OverwriteMode::OVERWRITE_ALL:;
         }
 
@@ -127,21 +342,10 @@ void TrackExportWorker::copyFile(
             qWarning() << error_message;
             m_errorMessage = error_message;
             stop();
-            return;
+            return false;
         }
     }
-
-    qDebug() << "Copying" << sourceFilename << "to" << dest_path;
-    QFile source_file(sourceFilename);
-    if (!source_file.copy(dest_path)) {
-        const QString error_message = tr(
-                "Error exporting track %1 to %2: %3. Stopping.").arg(
-                sourceFilename, dest_path, source_file.errorString());
-        qWarning() << error_message;
-        m_errorMessage = error_message;
-        stop();
-        return;
-    }
+    return true;
 }
 
 TrackExportWorker::OverwriteAnswer TrackExportWorker::makeOverwriteRequest(
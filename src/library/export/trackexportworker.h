@@ -1,5 +1,7 @@
 #pragma once
 
+#include <QHash>
+#include <QMap>
 #include <QString>
 #include <QThread>
 #include <future>
@@ -11,9 +13,14 @@ class FileInfo;
 } // namespace mixxx
 
 // A QThread class for copying a list of files to a single destination directory.
-// Currently does not preserve subdirectory relationships.  This class performs
-// all copies in a blocking style within its own thread.  May be canceled from
-// another thread.
+// Currently does not preserve subdirectory relationships.  This class asks
+// the overwrite questions within its own thread and runs up to ioLanes copies
+// at the same time, a single lane suits slow USB sticks best.  May be
+// canceled from another thread.
+//
+// The exported files are listed in a manifest in the destination directory
+// until the export is complete.  An interrupted export skips these files
+// when it is started again.
 class TrackExportWorker : public QThread {
     Q_OBJECT
   public:
@@ -33,10 +40,17 @@ class TrackExportWorker : public QThread {
         CANCEL = -1,
     };
 
+    static constexpr int kDefaultIoLanes = 2;
+    static constexpr char kManifestFileName[] = ".mixxx-export-manifest";
+
     // Constructor does not validate the destination directory.  Calling classes
     // should do that.
-    TrackExportWorker(const QString& destDir, const TrackPointerList& tracks)
-            : m_destDir(destDir), m_tracks(tracks) {
+    TrackExportWorker(const QString& destDir,
+            const TrackPointerList& tracks,
+            int ioLanes = kDefaultIoLanes)
+            : m_destDir(destDir),
+              m_tracks(tracks),
+              m_ioLanes(qMax(ioLanes, 1)) {
     }
     virtual ~TrackExportWorker() { };
 
@@ -66,14 +80,19 @@ class TrackExportWorker : public QThread {
     void canceled();
 
   private:
-    // Copies the file at source_fileinfo to the destination directory with the
-    // name given by dest_filename (not a full path).  If the destination file
-    // exists, will emit an overwrite request signal to ask how to proceed.
+    // Prepares the copy of the file at source_fileinfo to the destination
+    // directory with the name given by dest_filename (not a full path).  If
+    // the destination file exists, will emit an overwrite request signal to
+    // ask how to proceed and remove it.  Returns false if the file is skipped.
     // On unrecoverable error, sets the error message and stops the export
     // process entirely.
-    void copyFile(const mixxx::FileInfo& source_fileinfo,
+    bool prepareDestination(const mixxx::FileInfo& source_fileinfo,
             const QString& dest_filename);
 
+    // Sets the error message if the files do not fit on the destination
+    bool checkFreeSpace(const QMap<QString, mixxx::FileInfo>& copylist,
+            const QHash<QString, QString>& manifest);
+
     // Emit a signal requesting overwrite mode, and block until we get an
     // answer.  Updates m_overwriteMode appropriately.
     OverwriteAnswer makeOverwriteRequest(const QString& filename);
@@ -84,4 +103,5 @@ class TrackExportWorker : public QThread {
     OverwriteMode m_overwriteMode = OverwriteMode::ASK;
     const QString m_destDir;
     const TrackPointerList m_tracks;
+    const int m_ioLanes;
 };
@@ -2,6 +2,7 @@
 
 #include <QObject>
 #include <QSqlQuery>
+#include <QStringList>
 #include <gsl/pointers>
 
 #include "library/itunes/ituneslocalhosttoken.h"
@@ -40,63 +41,115 @@ std::ostream& operator<<(std::ostream& os, const ITunesPlaylist& playlist) {
     return os;
 }
 
+namespace {
+
+const QString kInsertTrackPrefix = QStringLiteral(
+        "INSERT INTO itunes_library (id, artist, title, album, "
+        "album_artist, genre, grouping, year, duration, "
+        "location, rating, comment, tracknumber, bpm, bitrate) VALUES ");
+constexpr int kTrackColumnCount = 15;
+
+const QString kInsertPlaylistTrackPrefix = QStringLiteral(
+        "INSERT INTO itunes_playlist_tracks (playlist_id, track_id, "
+        "position) VALUES ");
+constexpr int kPlaylistTrackColumnCount = 3;
+
+/// Returns an INSERT statement with positional placeholders for rowCount rows
+QString multiRowInsert(const QString& prefix, int columnCount, int rowCount) {
+    const QString row = QStringLiteral("(?") +
+            QStringLiteral(", ?").repeated(columnCount - 1) + QChar(')');
+    QStringList rows;
+    rows.reserve(rowCount);
+    for (int i = 0; i < rowCount; ++i) {
+        rows.append(row);
+    }
+    return prefix + rows.join(QStringLiteral(", "));
+}
+
+} // anonymous namespace
+
 void ITunesDAO::initialize(const QSqlDatabase& database) {
-    m_insertTrackQuery = QSqlQuery(database);
+    m_database = database;
+    m_insertTrackBatchQuery = QSqlQuery(database);
     m_insertPlaylistQuery = QSqlQuery(database);
-    m_insertPlaylistTrackQuery = QSqlQuery(database);
+    m_insertPlaylistTrackBatchQuery = QSqlQuery(database);
     m_applyPathMappingQuery = QSqlQuery(database);
 
-    m_insertTrackQuery.prepare(
-            "INSERT INTO itunes_library (id, artist, title, album, "
-            "album_artist, genre, grouping, year, duration, "
-            "location, rating, comment, tracknumber, bpm, bitrate) "
-            "VALUES (:id, :artist, :title, :album, :album_artist, "
-            ":genre, :grouping, :year, :duration, :location, "
-            ":rating, :comment, :tracknumber, :bpm, :bitrate)");
+    m_insertTrackBatchQuery.prepare(multiRowInsert(
+            kInsertTrackPrefix, kTrackColumnCount, kTrackBatchSize));
 
     m_insertPlaylistQuery.prepare("INSERT INTO itunes_playlists (id, name) VALUES (:id, :name)");
 
-    m_insertPlaylistTrackQuery.prepare(
-            "INSERT INTO itunes_playlist_tracks (playlist_id, track_id, "
-            "position) VALUES (:playlist_id, :track_id, :position)");
+    m_insertPlaylistTrackBatchQuery.prepare(multiRowInsert(
+            kInsertPlaylistTrackPrefix,
+            kPlaylistTrackColumnCount,
+            kPlaylistTrackBatchSize));
 
     m_applyPathMappingQuery.prepare(
             "UPDATE itunes_library SET location = replace( location, "
             ":itunes_path, :mixxx_path )");
 
+    m_pendingTracks.reserve(kTrackBatchSize);
+    m_pendingPlaylistTracks.reserve(kPlaylistTrackBatchSize);
+
     m_isDatabaseInitialized = true;
 }
 
 bool ITunesDAO::importTrack(const ITunesTrack& track) {
     if (m_isDatabaseInitialized) {
-        QSqlQuery& query = m_insertTrackQuery;
-
-        query.bindValue(":id", track.id);
-        query.bindValue(":artist", track.artist);
-        query.bindValue(":title", track.title);
-        query.bindValue(":album", track.album);
-        query.bindValue(":album_artist", track.albumArtist);
-        query.bindValue(":genre", track.genre);
-        query.bindValue(":grouping", track.grouping);
-        query.bindValue(":year", track.year > 0 ? QVariant(track.year) : QVariant());
-        query.bindValue(":duration", track.duration);
-        query.bindValue(":location", track.location);
-        query.bindValue(":rating", track.rating);
-        query.bindValue(":comment", track.comment);
-        query.bindValue(":tracknumber",
-                track.trackNumber > 0 ? QVariant(track.trackNumber) : QVariant());
-        query.bindValue(":bpm", track.bpm);
-        query.bindValue(":bitrate", track.bitrate);
-
-        if (!query.exec()) {
-            LOG_FAILED_QUERY(query);
-            return false;
+        m_pendingTracks.push_back(track);
+        if (static_cast<int>(m_pendingTracks.size()) >= kTrackBatchSize) {
+            return flushTracks();
         }
     }
 
     return true;
 }
 
+bool ITunesDAO::flushTracks() {
+    if (m_pendingTracks.empty()) {
+        return true;
+    }
+
+    // Only the last batch of an import is smaller than a full one
+    QSqlQuery remainderQuery;
+    QSqlQuery* pQuery = &m_insertTrackBatchQuery;
+    if (static_cast<int>(m_pendingTracks.size()) < kTrackBatchSize) {
+        remainderQuery = QSqlQuery(m_database);
+        remainderQuery.prepare(multiRowInsert(kInsertTrackPrefix,
+                kTrackColumnCount,
+                static_cast<int>(m_pendingTracks.size())));
+        pQuery = &remainderQuery;
+    }
+
+    int index = 0;
+    for (const ITunesTrack& track : m_pendingTracks) {
+        pQuery->bindValue(index++, track.id);
+        pQuery->bindValue(index++, track.artist);
+        pQuery->bindValue(index++, track.title);
+        pQuery->bindValue(index++, track.album);
+        pQuery->bindValue(index++, track.albumArtist);
+        pQuery->bindValue(index++, track.genre);
+        pQuery->bindValue(index++, track.grouping);
+        pQuery->bindValue(index++, track.year > 0 ? QVariant(track.year) : QVariant());
+        pQuery->bindValue(index++, track.duration);
+        pQuery->bindValue(index++, track.location);
+        pQuery->bindValue(index++, track.rating);
+        pQuery->bindValue(index++, track.comment);
+        pQuery->bindValue(index++,
+                track.trackNumber > 0 ? QVariant(track.trackNumber) : QVariant());
+        pQuery->bindValue(index++, track.bpm);
+        pQuery->bindValue(index++, track.bitrate);
+    }
+    m_pendingTracks.clear();
+
+    if (!pQuery->exec()) {
+        LOG_FAILED_QUERY(*pQuery);
+        return false;
+    }
+    return true;
+}
+
 bool ITunesDAO::importPlaylist(const ITunesPlaylist& playlist) {
     QString uniqueName = uniquifyPlaylistName(playlist.name);
 
@@ -124,24 +177,60 @@ bool ITunesDAO::importPlaylistRelation(int parentId, int childId) {
 
 bool ITunesDAO::importPlaylistTrack(int playlistId, int trackId, int position) {
     if (m_isDatabaseInitialized) {
-        QSqlQuery& query = m_insertPlaylistTrackQuery;
+        m_pendingPlaylistTracks.push_back(PlaylistTrack{playlistId, trackId, position});
+        if (static_cast<int>(m_pendingPlaylistTracks.size()) >= kPlaylistTrackBatchSize) {
+            return flushPlaylistTracks();
+        }
+    }
 
-        query.bindValue(":playlist_id", playlistId);
-        query.bindValue(":track_id", trackId);
-        query.bindValue(":position", position);
+    return true;
+}
 
-        if (!query.exec()) {
-            LOG_FAILED_QUERY(query);
-            return false;
-        }
+bool ITunesDAO::flushPlaylistTracks() {
+    if (m_pendingPlaylistTracks.empty()) {
+        return true;
     }
 
+    QSqlQuery remainderQuery;
+    QSqlQuery* pQuery = &m_insertPlaylistTrackBatchQuery;
+    if (static_cast<int>(m_pendingPlaylistTracks.size()) < kPlaylistTrackBatchSize) {
+        remainderQuery = QSqlQuery(m_database);
+        remainderQuery.prepare(multiRowInsert(kInsertPlaylistTrackPrefix,
+                kPlaylistTrackColumnCount,
+                static_cast<int>(m_pendingPlaylistTracks.size())));
+        pQuery = &remainderQuery;
+    }
+
+    int index = 0;
+    for (const PlaylistTrack& playlistTrack : m_pendingPlaylistTracks) {
+        pQuery->bindValue(index++, playlistTrack.playlistId);
+        pQuery->bindValue(index++, playlistTrack.trackId);
+        pQuery->bindValue(index++, playlistTrack.position);
+    }
+    m_pendingPlaylistTracks.clear();
+
+    if (!pQuery->exec()) {
+        LOG_FAILED_QUERY(*pQuery);
+        return false;
+    }
     return true;
 }
 
+bool ITunesDAO::flush() {
+    // Both are attempted even if the first one fails
+    const bool tracksFlushed = flushTracks();
+    const bool playlistTracksFlushed = flushPlaylistTracks();
+    return tracksFlushed && playlistTracksFlushed;
+}
+
 bool ITunesDAO::applyPathMapping(const ITunesPathMapping& pathMapping) {
     if (m_isDatabaseInitialized) {
-        QSqlQuery& query = m_insertPlaylistTrackQuery;
+        // The mapping must also apply to the tracks still pending
+        if (!flushTracks()) {
+            return false;
+        }
+
+        QSqlQuery& query = m_applyPathMappingQuery;
 
         query.bindValue(":itunes_path",
                 QString(pathMapping.dbITunesRoot).replace(kiTunesLocalhostToken, ""));
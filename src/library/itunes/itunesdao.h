@@ -2,15 +2,16 @@
 
 #include <QDateTime>
 #include <QHash>
+#include <QSqlDatabase>
 #include <QSqlQuery>
 #include <QString>
 #include <gsl/pointers>
 #include <map>
 #include <ostream>
+#include <vector>
 
 #include "library/dao/dao.h"
 
-class QSqlDatabase;
 struct ITunesPathMapping;
 class TreeItem;
 
@@ -86,8 +87,16 @@ std::ostream& operator<<(std::ostream& os, const ITunesPlaylist& playlist);
 /// A wrapper around the iTunes database tables. Keeps track of the
 /// playlist tree, deals with duplicate disambiguation and can export
 /// the tree afterwards.
+///
+/// Tracks and playlist entries are buffered and inserted in batches with
+/// one multi-row statement each, flush() inserts the rest of the last batch.
+/// The caller is expected to wrap the whole import in a transaction.
 class ITunesDAO : public DAO {
   public:
+    // SQLite versions before 3.32 limit a statement to 999 parameters
+    static constexpr int kTrackBatchSize = 50;
+    static constexpr int kPlaylistTrackBatchSize = 300;
+
     ~ITunesDAO() override = default;
 
     void initialize(const QSqlDatabase& database) override;
@@ -97,11 +106,18 @@ class ITunesDAO : public DAO {
     virtual bool importPlaylistRelation(int parentId, int childId);
     virtual bool importPlaylistTrack(int playlistId, int trackId, int position);
     virtual bool applyPathMapping(const ITunesPathMapping& pathMapping);
+    virtual bool flush();
 
     virtual void appendPlaylistTree(gsl::not_null<TreeItem*> item,
             int playlistId = kRootITunesPlaylistId);
 
   private:
+    struct PlaylistTrack {
+        int playlistId;
+        int trackId;
+        int position;
+    };
+
     QHash<QString, int> m_playlistDuplicatesByName;
     QHash<int, QString> m_playlistNameById;
     std::multimap<int, int> m_playlistIdsByParentId;
@@ -113,10 +129,16 @@ class ITunesDAO : public DAO {
 
     // Note that these queries reference the database, which is expected
     // to outlive the DAO.
-    QSqlQuery m_insertTrackQuery;
+    QSqlDatabase m_database;
+    QSqlQuery m_insertTrackBatchQuery;
     QSqlQuery m_insertPlaylistQuery;
-    QSqlQuery m_insertPlaylistTrackQuery;
+    QSqlQuery m_insertPlaylistTrackBatchQuery;
     QSqlQuery m_applyPathMappingQuery;
 
+    std::vector<ITunesTrack> m_pendingTracks;
+    std::vector<PlaylistTrack> m_pendingPlaylistTracks;
+
+    bool flushTracks();
+    bool flushPlaylistTracks();
     QString uniquifyPlaylistName(QString name);
 };
@@ -166,6 +166,14 @@ void ITunesFeature::activate() {
 void ITunesFeature::activate(bool forceReload) {
     //qDebug("ITunesFeature::activate()");
     if (!m_isActivated || forceReload) {
+        // A reload cancels a running import before its tables are cleared
+        if (m_future.isRunning()) {
+            m_cancelImport = true;
+            m_future.waitForFinished();
+            m_cancelImport = false;
+            // The partial tree of the canceled import is discarded
+            delete m_future.result();
+        }
 
         //Delete all table entries of iTunes feature
         ScopedTransaction transaction(m_database);
@@ -354,6 +362,15 @@ void ITunesFeature::clearTable(const QString& table_name) {
     }
 }
 
+void ITunesFeature::onImportProgress(int percent) {
+    if (!m_future.isRunning()) {
+        // A late notification of a finished import
+        return;
+    }
+    m_title = tr("(loading) iTunes %1%").arg(percent);
+    emit featureIsLoading(this, false);
+}
+
 void ITunesFeature::onTrackCollectionLoaded() {
     std::unique_ptr<TreeItem> root(m_future.result());
     if (root) {
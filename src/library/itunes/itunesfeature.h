@@ -37,6 +37,7 @@ class ITunesFeature : public BaseExternalLibraryFeature {
     void activateChild(const QModelIndex& index) override;
     void onRightClick(const QPoint& globalPos) override;
     void onTrackCollectionLoaded();
+    void onImportProgress(int percent);
 
   private:
     std::unique_ptr<BaseSqlTableModel> createPlaylistModelForPlaylist(
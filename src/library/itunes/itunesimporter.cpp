@@ -1,5 +1,8 @@
+#include "library/itunes/itunesimporter.h"
+
+#include <QMetaObject>
+
 #include "library/itunes/itunesfeature.h"
-#include "library/itunes/itunesxmlimporter.h"
 
 ITunesImporter::ITunesImporter(ITunesFeature* pParentFeature)
         : m_pParentFeature(pParentFeature) {
@@ -12,3 +15,17 @@ bool ITunesImporter::canceled() const {
     }
     return false;
 }
+
+void ITunesImporter::reportProgress(int percent) const {
+    // The parent feature may be null during testing
+    if (!m_pParentFeature) {
+        return;
+    }
+    ITunesFeature* pFeature = m_pParentFeature;
+    QMetaObject::invokeMethod(
+            pFeature,
+            [pFeature, percent] {
+                pFeature->onImportProgress(percent);
+            },
+            Qt::QueuedConnection);
+}
@@ -20,6 +20,10 @@ class ITunesImporter {
     bool canceled() const;
 
   protected:
+    /// Shows the progress in the title of the parent feature, can be called
+    /// from the import thread.
+    void reportProgress(int percent) const;
+
     // This is a borrowed pointer. The ITunesFeature owns the ITunesImporter.
     ITunesFeature* m_pParentFeature;
 };
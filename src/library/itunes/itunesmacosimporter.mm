@@ -224,6 +224,7 @@ ITunesImport ITunesMacOSImporter::importLibrary() {
 
         impl.importPlaylists(library.allPlaylists);
         impl.importMediaItems(library.allMediaItems);
+        m_dao->flush();
         impl.appendPlaylistTree(rootItem.get());
 
         iTunesImport.playlistRoot = std::move(rootItem);
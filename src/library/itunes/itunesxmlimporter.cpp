@@ -49,7 +49,8 @@ ITunesXMLImporter::ITunesXMLImporter(
           m_xmlFilePath(xmlFilePath),
           m_xmlFile(xmlFilePath),
           m_xml(&m_xmlFile),
-          m_dao(std::move(dao)) {
+          m_dao(std::move(dao)),
+          m_reportedProgress(-1) {
     // By default set m_mixxxItunesRoot and m_dbItunesRoot to strip out
     // file://localhost/ from the URL. When we load the user's iTunes XML
     // configuration we may replace this with something based on the detected
@@ -100,6 +101,9 @@ ITunesImport ITunesXMLImporter::importLibrary() {
         }
     }
 
+    // Insert the rest of the last batch, also if canceled or failed
+    m_dao->flush();
+
     if (m_xml.hasError()) {
         // do error handling
         qDebug() << "Abort processing iTunes music collection";
@@ -203,6 +207,18 @@ void ITunesXMLImporter::guessMusicLibraryMountpoint() {
              << m_pathMapping.dbITunesRoot << "->" << m_pathMapping.mixxxITunesRoot;
 }
 
+void ITunesXMLImporter::updateProgress() {
+    const qint64 size = m_xmlFile.size();
+    if (size <= 0) {
+        return;
+    }
+    const int progress = static_cast<int>(m_xmlFile.pos() * 100 / size);
+    if (progress != m_reportedProgress) {
+        m_reportedProgress = progress;
+        reportProgress(progress);
+    }
+}
+
 void ITunesXMLImporter::parseTracks() {
     bool inContainerDictionary = false;
     bool inTrackDictionary = false;
@@ -223,6 +239,7 @@ void ITunesXMLImporter::parseTracks() {
                     inTrackDictionary = true;
                     // Parse track here
                     parseTrack();
+                    updateProgress();
                 }
             }
         }
@@ -424,6 +441,7 @@ void ITunesXMLImporter::parsePlaylists() {
         // We process and iterate the <dict> tags holding playlist summary information here
         if (m_xml.isStartElement() && m_xml.name() == kDict) {
             parsePlaylist();
+            updateProgress();
             continue;
         }
         if (m_xml.isEndElement()) {
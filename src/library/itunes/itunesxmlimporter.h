@@ -12,7 +12,8 @@
 class ITunesFeature;
 class TrackRef;
 
-/// An importer that parses an iTunes XML library.
+/// An importer that parses an iTunes XML library. The file is read as a
+/// stream, only the playlist hierarchy is kept in memory.
 class ITunesXMLImporter : public ITunesImporter {
   public:
     ITunesXMLImporter(
@@ -30,7 +31,9 @@ class ITunesXMLImporter : public ITunesImporter {
 
     ITunesPathMapping m_pathMapping;
     QHash<QString, int> m_playlistIdByPersistentId;
+    int m_reportedProgress;
 
+    void updateProgress();
     void parseTracks();
     void guessMusicLibraryMountpoint();
     void parseTrack();
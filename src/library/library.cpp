@@ -36,6 +36,7 @@
 #include "util/assert.h"
 #include "util/logger.h"
 #include "util/sandbox.h"
+#include "util/timer.h"
 #include "widget/wlibrary.h"
 #include "widget/wlibrarysidebar.h"
 #include "widget/wsearchlineedit.h"
@@ -69,7 +70,9 @@ Library::Library(
           m_pTrackCollectionManager(pTrackCollectionManager),
           m_pSidebarModel(make_parented<SidebarModel>(this)),
           m_pLibraryControl(make_parented<LibraryControl>(this)),
+          m_externalFeaturesAdded(false),
           m_pLibraryWidget(nullptr),
+          m_pKeyboard(nullptr),
           m_pMixxxLibraryFeature(nullptr),
           m_pPlaylistFeature(nullptr),
           m_pCrateFeature(nullptr),
@@ -152,69 +155,6 @@ Library::Library(
             m_pAnalysisFeature,
             &AnalysisFeature::analyzeTracks);
     addFeature(m_pAnalysisFeature);
-    // Suspend a batch analysis while an ad-hoc analysis of
-    // loaded tracks is in progress and resume it afterwards.
-    connect(pPlayerManager,
-            &PlayerManager::trackAnalyzerProgress,
-            this,
-            &Library::onPlayerManagerTrackAnalyzerProgress);
-    connect(pPlayerManager,
-            &PlayerManager::trackAnalyzerIdle,
-            this,
-            &Library::onPlayerManagerTrackAnalyzerIdle);
-
-    // iTunes and Rhythmbox should be last until we no longer have an obnoxious
-    // messagebox popup when you select them. (This forces you to reach for your
-    // mouse or keyboard if you're using MIDI control and you scroll through them...)
-    if (RhythmboxFeature::isSupported() &&
-            m_pConfig->getValue(
-                    ConfigKey(kConfigGroup, "ShowRhythmboxLibrary"), true)) {
-        addFeature(new RhythmboxFeature(this, m_pConfig));
-    }
-    if (m_pConfig->getValue(
-                ConfigKey(kConfigGroup, "ShowBansheeLibrary"), true)) {
-        BansheeFeature::prepareDbPath(m_pConfig);
-        if (BansheeFeature::isSupported()) {
-            addFeature(new BansheeFeature(this, m_pConfig));
-        }
-    }
-    if (ITunesFeature::isSupported() &&
-            m_pConfig->getValue(
-                    ConfigKey(kConfigGroup, "ShowITunesLibrary"), true)) {
-        addFeature(new ITunesFeature(this, m_pConfig));
-    }
-    if (TraktorFeature::isSupported() &&
-            m_pConfig->getValue(
-                    ConfigKey(kConfigGroup, "ShowTraktorLibrary"), true)) {
-        addFeature(new TraktorFeature(this, m_pConfig));
-    }
-
-    // TODO(XXX) Rekordbox feature added persistently as the only way to enable it to
-    // dynamically appear/disappear when correctly prepared removable devices
-    // are mounted/unmounted would be to have some form of timed thread to check
-    // periodically. Not ideal performance wise.
-    if (m_pConfig->getValue(
-                ConfigKey(kConfigGroup, "ShowRekordboxLibrary"), true)) {
-        addFeature(new RekordboxFeature(this, m_pConfig));
-    }
-
-    if (m_pConfig->getValue(
-                ConfigKey(kConfigGroup, "ShowSeratoLibrary"), true)) {
-        addFeature(new SeratoFeature(this, m_pConfig));
-    }
-
-    for (const auto& externalTrackCollection : m_pTrackCollectionManager->externalCollections()) {
-        auto* feature = externalTrackCollection->newLibraryFeature(this, m_pConfig);
-        if (feature) {
-            kLogger.info() << "Adding library feature for"
-                           << externalTrackCollection->name();
-            addFeature(feature);
-        } else {
-            kLogger.info() << "Library feature for"
-                           << externalTrackCollection->name()
-                           << "is not available";
-        }
-    }
 
     // On startup we need to check if all of the user's library folders are
     // accessible to us. If the user is using a database from <1.12.0 with
@@ -292,6 +232,10 @@ TrackAnalysisScheduler::Pointer Library::createTrackAnalysisScheduler(
             modeFlags);
 }
 
+int Library::analysisQueueSize() const {
+    return m_pAnalysisFeature ? m_pAnalysisFeature->queuedTrackCount() : 0;
+}
+
 void Library::stopPendingTasks() {
     if (m_pAnalysisFeature) {
         m_pAnalysisFeature->stopAnalysis();
@@ -325,6 +269,7 @@ void Library::bindSearchboxWidget(WSearchLineEdit* pSearchboxWidget) {
 }
 
 void Library::bindSidebarWidget(WLibrarySidebar* pSidebarWidget) {
+    m_pSidebarWidget = pSidebarWidget;
     m_pLibraryControl->bindSidebarWidget(pSidebarWidget);
 
     // Setup the sources view
@@ -379,6 +324,7 @@ void Library::bindSidebarWidget(WLibrarySidebar* pSidebarWidget) {
 void Library::bindLibraryWidget(
         WLibrary* pLibraryWidget, KeyboardEventFilter* pKeyboard) {
     m_pLibraryWidget = pLibraryWidget;
+    m_pKeyboard = pKeyboard;
     WTrackTableView* pTrackTableView = new WTrackTableView(m_pLibraryWidget,
             m_pConfig,
             this,
@@ -501,18 +447,73 @@ void Library::addFeature(LibraryFeature* feature) {
             &LibraryFeature::restoreModelState,
             this,
             &Library::restoreModelState);
-}
 
-void Library::onPlayerManagerTrackAnalyzerProgress(
-        TrackId /*trackId*/, AnalyzerProgress /*analyzerProgress*/) {
-    if (m_pAnalysisFeature) {
-        m_pAnalysisFeature->suspendAnalysis();
+    if (m_pSidebarWidget) {
+        feature->bindSidebarWidget(m_pSidebarWidget);
+    }
+    if (m_pLibraryWidget) {
+        feature->bindLibraryWidget(m_pLibraryWidget, m_pKeyboard);
     }
 }
 
-void Library::onPlayerManagerTrackAnalyzerIdle() {
-    if (m_pAnalysisFeature) {
-        m_pAnalysisFeature->resumeAnalysis();
+void Library::addExternalFeatures() {
+    if (m_externalFeaturesAdded) {
+        return;
+    }
+    m_externalFeaturesAdded = true;
+    ScopedTimer t("Library::addExternalFeatures");
+
+    // iTunes and Rhythmbox should be last until we no longer have an obnoxious
+    // messagebox popup when you select them. (This forces you to reach for your
+    // mouse or keyboard if you're using MIDI control and you scroll through them...)
+    if (RhythmboxFeature::isSupported() &&
+            m_pConfig->getValue(
+                    ConfigKey(kConfigGroup, "ShowRhythmboxLibrary"), true)) {
+        addFeature(new RhythmboxFeature(this, m_pConfig));
+    }
+    if (m_pConfig->getValue(
+                ConfigKey(kConfigGroup, "ShowBansheeLibrary"), true)) {
+        BansheeFeature::prepareDbPath(m_pConfig);
+        if (BansheeFeature::isSupported()) {
+            addFeature(new BansheeFeature(this, m_pConfig));
+        }
+    }
+    if (ITunesFeature::isSupported() &&
+            m_pConfig->getValue(
+                    ConfigKey(kConfigGroup, "ShowITunesLibrary"), true)) {
+        addFeature(new ITunesFeature(this, m_pConfig));
+    }
+    if (TraktorFeature::isSupported() &&
+            m_pConfig->getValue(
+                    ConfigKey(kConfigGroup, "ShowTraktorLibrary"), true)) {
+        addFeature(new TraktorFeature(this, m_pConfig));
+    }
+
+    // TODO(XXX) Rekordbox feature added persistently as the only way to enable it to
+    // dynamically appear/disappear when correctly prepared removable devices
+    // are mounted/unmounted would be to have some form of timed thread to check
+    // periodically. Not ideal performance wise.
+    if (m_pConfig->getValue(
+                ConfigKey(kConfigGroup, "ShowRekordboxLibrary"), true)) {
+        addFeature(new RekordboxFeature(this, m_pConfig));
+    }
+
+    if (m_pConfig->getValue(
+                ConfigKey(kConfigGroup, "ShowSeratoLibrary"), true)) {
+        addFeature(new SeratoFeature(this, m_pConfig));
+    }
+
+    for (const auto& externalTrackCollection : m_pTrackCollectionManager->externalCollections()) {
+        auto* feature = externalTrackCollection->newLibraryFeature(this, m_pConfig);
+        if (feature) {
+            kLogger.info() << "Adding library feature for"
+                           << externalTrackCollection->name();
+            addFeature(feature);
+        } else {
+            kLogger.info() << "Library feature for"
+                           << externalTrackCollection->name()
+                           << "is not available";
+        }
     }
 }
 
@@ -679,7 +680,7 @@ void Library::searchTracksInCollection(const QString& query) {
 std::unique_ptr<mixxx::LibraryExporter> Library::makeLibraryExporter(
         QWidget* parent) {
     return std::make_unique<mixxx::LibraryExporter>(
-            parent, m_pConfig, m_pTrackCollectionManager);
+            parent, m_pConfig, m_pDbConnectionPool, m_pTrackCollectionManager);
 }
 #endif
 
@@ -693,11 +694,3 @@ bool Library::isTrackIdInCurrentLibraryView(const TrackId& trackId) {
         return false;
     }
 }
-
-LibraryTableModel* Library::trackTableModel() const {
-    VERIFY_OR_DEBUG_ASSERT(m_pMixxxLibraryFeature) {
-        return nullptr;
-    }
-
-    return m_pMixxxLibraryFeature->trackTableModel();
-}
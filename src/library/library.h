@@ -21,7 +21,6 @@ class ControlObject;
 class CrateFeature;
 class LibraryControl;
 class LibraryFeature;
-class LibraryTableModel;
 class KeyboardEventFilter;
 class MixxxLibraryFeature;
 class PlayerManager;
@@ -65,6 +64,8 @@ class Library: public QObject {
     TrackAnalysisScheduler::Pointer createTrackAnalysisScheduler(
             int numWorkerThreads,
             AnalyzerModeFlags modeFlags) const;
+    /// The number of tracks that wait for the batch analysis
+    int analysisQueueSize() const;
 
     void bindSearchboxWidget(WSearchLineEdit* pSearchboxWidget);
     void bindSidebarWidget(WLibrarySidebar* sidebarWidget);
@@ -72,9 +73,12 @@ class Library: public QObject {
                     KeyboardEventFilter* pKeyboard);
 
     void addFeature(LibraryFeature* feature);
-
-    /// Needed for exposing models to QML
-    LibraryTableModel* trackTableModel() const;
+    /// Adds the features of the libraries of other DJ applications and media
+    /// players. They are not needed to start Mixxx and some of them create
+    /// temporary database tables, so this is deferred until the main window
+    /// is shown. Features added after the widgets have been bound are bound
+    /// immediately.
+    void addExternalFeatures();
 
     bool isTrackIdInCurrentLibraryView(const TrackId& trackId);
 
@@ -140,10 +144,6 @@ class Library: public QObject {
     void setTrackTableRowHeight(int rowHeight);
     void setSelectedClick(bool enable);
 
-  private slots:
-      void onPlayerManagerTrackAnalyzerProgress(TrackId trackId, AnalyzerProgress analyzerProgress);
-      void onPlayerManagerTrackAnalyzerIdle();
-
   private:
     const UserSettingsPointer m_pConfig;
 
@@ -156,9 +156,12 @@ class Library: public QObject {
     parented_ptr<LibraryControl> m_pLibraryControl;
 
     QList<LibraryFeature*> m_features;
+    bool m_externalFeaturesAdded;
     const static QString m_sTrackViewName;
     const static QString m_sAutoDJViewName;
     WLibrary* m_pLibraryWidget;
+    QPointer<WLibrarySidebar> m_pSidebarWidget;
+    KeyboardEventFilter* m_pKeyboard;
     MixxxLibraryFeature* m_pMixxxLibraryFeature;
     PlaylistFeature* m_pPlaylistFeature;
     CrateFeature* m_pCrateFeature;
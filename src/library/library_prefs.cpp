@@ -58,6 +58,16 @@ const ConfigKey mixxx::library::prefs::kEnableSearchHistoryShortcutsConfigKey =
                 mixxx::library::prefs::kConfigGroup,
                 QStringLiteral("EnableSearchHistoryShortcuts")};
 
+const ConfigKey mixxx::library::prefs::kEnableFullTextSearchConfigKey =
+        ConfigKey{
+                mixxx::library::prefs::kConfigGroup,
+                QStringLiteral("EnableFullTextSearch")};
+
+const ConfigKey mixxx::library::prefs::kDatabaseStorageProfileConfigKey =
+        ConfigKey{
+                mixxx::library::prefs::kConfigGroup,
+                QStringLiteral("DatabaseStorageProfile")};
+
 const ConfigKey mixxx::library::prefs::kBpmColumnPrecisionConfigKey =
         ConfigKey{
                 mixxx::library::prefs::kConfigGroup,
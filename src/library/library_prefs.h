@@ -24,6 +24,10 @@ extern const ConfigKey kEnableSearchCompletionsConfigKey;
 
 extern const ConfigKey kEnableSearchHistoryShortcutsConfigKey;
 
+extern const ConfigKey kEnableFullTextSearchConfigKey;
+
+extern const ConfigKey kDatabaseStorageProfileConfigKey;
+
 extern const ConfigKey kBpmColumnPrecisionConfigKey;
 
 extern const ConfigKey kEditMetadataSelectedClickConfigKey;
@@ -21,9 +21,20 @@ void LocationDelegate::paintItem(
         // }
         painter->setPen(QPen(option.palette.highlightedText().color()));
     }
-    QString elidedText = option.fontMetrics.elidedText(
-            index.data().toString(),
-            Qt::ElideLeft,
-            columnWidth(index));
-    painter->drawText(option.rect, Qt::AlignVCenter, elidedText);
+    const QString location = index.data().toString();
+    const int width = columnWidth(index);
+    paintCached(painter,
+            option.rect,
+            QStringLiteral("location|%1|%2|%3|%4")
+                    .arg(painter->pen().color().name(QColor::HexArgb),
+                            option.font.key(),
+                            QString::number(width),
+                            location),
+            [&option, &location, width](QPainter* pPainter, const QRect& rect) {
+                const QString elidedText = option.fontMetrics.elidedText(
+                        location,
+                        Qt::ElideLeft,
+                        width);
+                pPainter->drawText(rect, Qt::AlignVCenter, elidedText);
+            });
 }
@@ -90,11 +90,13 @@ MixxxLibraryFeature::MixxxLibraryFeature(Library* pLibrary,
 
     QSqlQuery query(m_pTrackCollection->database());
     QString tableName = "library_cache_view";
-    QString queryString = QString(
-            "CREATE TEMPORARY VIEW IF NOT EXISTS %1 AS "
-            "SELECT %2 FROM library "
+    QString tableQuery = QString(
+            "SELECT %1 FROM library "
             "INNER JOIN track_locations ON library.location = track_locations.id")
-                                  .arg(tableName, qualifiedTableColumns.join(","));
+                                 .arg(qualifiedTableColumns.join(","));
+    QString queryString = QString(
+            "CREATE TEMPORARY VIEW IF NOT EXISTS %1 AS %2")
+                                  .arg(tableName, tableQuery);
     query.prepare(queryString);
     if (!query.exec()) {
         LOG_FAILED_QUERY(query);
@@ -106,6 +108,9 @@ MixxxLibraryFeature::MixxxLibraryFeature(Library* pLibrary,
             std::move(columns),
             std::move(searchColumns),
             true);
+    pBaseTrackCache->enableAsyncFilterAndSort(
+            pLibrary->dbConnectionPool(),
+            std::move(tableQuery));
     m_pBaseTrackCache = QSharedPointer<BaseTrackCache>(pBaseTrackCache);
     m_pTrackCollection->connectTrackSource(m_pBaseTrackCache);
 
@@ -14,6 +14,10 @@ namespace {
 
 constexpr int kPreviewDeckIndex = 0;
 
+// Moving the mouse across the preview column must not load every
+// track on the way
+constexpr int kPrefetchDelayMillis = 400;
+
 const QString kPreviewDeckGroup = PlayerManager::groupForPreviewDeck(kPreviewDeckIndex);
 
 inline TrackModel* trackModel(QTableView* pTableView) {
@@ -51,9 +55,17 @@ PreviewButtonDelegate::PreviewButtonDelegate(
                   kPreviewDeckGroup, QStringLiteral("play"), this)),
           m_pCueGotoAndPlay(make_parented<ControlProxy>(
                   kPreviewDeckGroup, QStringLiteral("cue_gotoandplay"), this)),
-          m_pButton(make_parented<LibraryPreviewButton>(parent)) {
+          m_pButton(make_parented<LibraryPreviewButton>(parent)),
+          m_prefetchTimer(this) {
     DEBUG_ASSERT(m_column >= 0);
 
+    m_prefetchTimer.setSingleShot(true);
+    m_prefetchTimer.setInterval(kPrefetchDelayMillis);
+    connect(&m_prefetchTimer,
+            &QTimer::timeout,
+            this,
+            &PreviewButtonDelegate::prefetchTrack);
+
     m_pPreviewDeckPlay->connectValueChanged(
             this,
             &PreviewButtonDelegate::previewDeckPlayChanged);
@@ -153,15 +165,19 @@ void PreviewButtonDelegate::paintItem(QPainter* painter,
         m_pButton->setFixedSize(option.rect.size());
     }
 
-    // Update check state
-    m_pButton->setChecked(isTrackLoadedInPreviewDeckAndPlaying(index));
-
-    // Render button at the desired position.
-    painter->translate(option.rect.topLeft());
-
-    // Avoid QWidget::render and call the equivalent of QPushButton::paintEvent
-    // directly.
-    m_pButton->paint(painter);
+    // The button only has two states
+    const bool checked = isTrackLoadedInPreviewDeckAndPlaying(index);
+    paintCached(painter,
+            option.rect,
+            checked ? QStringLiteral("preview|checked")
+                    : QStringLiteral("preview|unchecked"),
+            [this, checked](QPainter* pPainter, const QRect& rect) {
+                Q_UNUSED(rect);
+                m_pButton->setChecked(checked);
+                // Avoid QWidget::render and call the equivalent of
+                // QPushButton::paintEvent directly.
+                m_pButton->paint(pPainter);
+            });
 }
 
 void PreviewButtonDelegate::updateEditorGeometry(QWidget* editor,
@@ -197,6 +213,7 @@ void PreviewButtonDelegate::cellEntered(const QModelIndex& index) {
         m_pTableView->closePersistentEditor(m_currentEditedCellIndex);
         m_currentEditedCellIndex = QModelIndex();
     }
+    m_prefetchTimer.stop();
     // Only open a new editor for preview column cells, but not any
     // other cells
     if (index.column() != m_column) {
@@ -204,6 +221,25 @@ void PreviewButtonDelegate::cellEntered(const QModelIndex& index) {
     }
     m_pTableView->openPersistentEditor(index);
     m_currentEditedCellIndex = index;
+    m_prefetchTimer.start();
+}
+
+void PreviewButtonDelegate::prefetchTrack() {
+    // Never interrupt a running preview
+    if (!m_currentEditedCellIndex.isValid() || isPreviewDeckPlaying()) {
+        return;
+    }
+    TrackModel* const pTrackModel = trackModel(m_pTableView);
+    VERIFY_OR_DEBUG_ASSERT(pTrackModel) {
+        return;
+    }
+    TrackPointer pTrack = pTrackModel->getTrack(m_currentEditedCellIndex);
+    if (!pTrack || pTrack == PlayerInfo::instance().getTrackInfo(kPreviewDeckGroup)) {
+        return;
+    }
+    // The engine reads the chunks around the position and the cue points
+    // of the paused deck, buttonClicked() then only needs to start playing.
+    emit loadTrackToPlayer(pTrack, kPreviewDeckGroup, false);
 }
 
 void PreviewButtonDelegate::buttonClicked() {
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <QPushButton>
+#include <QTimer>
 
 #include "library/tableitemdelegate.h"
 #include "track/track_decl.h"
@@ -58,6 +59,9 @@ class PreviewButtonDelegate : public TableItemDelegate {
     void buttonClicked();
     void previewDeckPlayChanged(double v);
 
+  private slots:
+    void prefetchTrack();
+
   private:
     bool isPreviewDeckPlaying() const;
     bool isTrackLoadedInPreviewDeck(
@@ -79,4 +83,8 @@ class PreviewButtonDelegate : public TableItemDelegate {
     const parented_ptr<LibraryPreviewButton> m_pButton;
 
     QPersistentModelIndex m_currentEditedCellIndex;
+
+    // Loads the track of a hovered preview button into the paused
+    // preview deck, so that the preview starts instantly on click
+    QTimer m_prefetchTimer;
 };
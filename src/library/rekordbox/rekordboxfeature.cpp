@@ -4,9 +4,11 @@
 
 #include <QMap>
 #include <QMessageBox>
+#include <QMetaObject>
 #include <QSettings>
 #include <QTextCodec>
 #include <QtDebug>
+#include <istream>
 
 #include "engine/engine.h"
 #include "library/dao/trackschema.h"
@@ -285,30 +287,180 @@ QString getText(rekordbox_pdb_t::device_sql_string_t* deviceString) {
     return text.remove(QChar('\x0'));
 }
 
-int createDevicePlaylist(QSqlDatabase& database, const QString& devicePath) {
+void clearDeviceTables(QSqlDatabase& database, const QString& device) {
+    ScopedTransaction transaction(database);
+
+    int trackID = -1;
     int playlistID = kInvalidPlaylistId;
+    QSqlQuery tracksQuery(database);
+    tracksQuery.prepare("select id from " + kRekordboxLibraryTable + " where device=:device");
+    tracksQuery.bindValue(":device", device);
+
+    QSqlQuery deletePlaylistsQuery(database);
+    deletePlaylistsQuery.prepare("delete from " + kRekordboxPlaylistsTable + " where id=:id");
+
+    QSqlQuery deletePlaylistTracksQuery(database);
+    deletePlaylistTracksQuery.prepare("delete from " +
+            kRekordboxPlaylistTracksTable + " where playlist_id=:playlist_id");
+
+    if (!tracksQuery.exec()) {
+        LOG_FAILED_QUERY(tracksQuery)
+                << "device:" << device;
+    }
+
+    while (tracksQuery.next()) {
+        trackID = tracksQuery.value(tracksQuery.record().indexOf("id")).toInt();
+
+        QSqlQuery playlistTracksQuery(database);
+        playlistTracksQuery.prepare("select playlist_id from " +
+                kRekordboxPlaylistTracksTable + " where track_id=:track_id");
+        playlistTracksQuery.bindValue(":track_id", trackID);
+
+        if (!playlistTracksQuery.exec()) {
+            LOG_FAILED_QUERY(playlistTracksQuery)
+                    << "trackID:" << trackID;
+        }
+
+        while (playlistTracksQuery.next()) {
+            playlistID = playlistTracksQuery
+                                 .value(playlistTracksQuery.record().indexOf(
+                                         "playlist_id"))
+                                 .toInt();
+
+            deletePlaylistsQuery.bindValue(":id", playlistID);
+
+            if (!deletePlaylistsQuery.exec()) {
+                LOG_FAILED_QUERY(deletePlaylistsQuery)
+                        << "playlistID:" << playlistID;
+            }
+
+            deletePlaylistTracksQuery.bindValue(":playlist_id", playlistID);
+
+            if (!deletePlaylistTracksQuery.exec()) {
+                LOG_FAILED_QUERY(deletePlaylistTracksQuery)
+                        << "playlistID:" << playlistID;
+            }
+        }
+    }
+
+    QSqlQuery deleteTracksQuery(database);
+    deleteTracksQuery.prepare("delete from " + kRekordboxLibraryTable + " where device=:device");
+    deleteTracksQuery.bindValue(":device", device);
+
+    if (!deleteTracksQuery.exec()) {
+        LOG_FAILED_QUERY(deleteTracksQuery)
+                << "device:" << device;
+    }
+
+    transaction.commit();
+
+// Removes the playlists that are named after the device path, also those
+// without tracks that are not found by clearDeviceTables()
+void clearDevicePlaylists(QSqlDatabase& database, const QString& devicePath) {
+    ScopedTransaction transaction(database);
+
+    const QString playlistsFilter = QStringLiteral(
+            "name=:path OR substr(name, 1, length(:prefix))=:prefix");
+    const QString prefix = devicePath + kPLaylistPathDelimiter;
+
+    QSqlQuery deletePlaylistTracksQuery(database);
+    deletePlaylistTracksQuery.prepare("delete from " +
+            kRekordboxPlaylistTracksTable + " where playlist_id in (select id from " +
+            kRekordboxPlaylistsTable + " where " + playlistsFilter + ")");
+    deletePlaylistTracksQuery.bindValue(":path", devicePath);
+    deletePlaylistTracksQuery.bindValue(":prefix", prefix);
+
+    if (!deletePlaylistTracksQuery.exec()) {
+        LOG_FAILED_QUERY(deletePlaylistTracksQuery)
+                << "devicePath:" << devicePath;
+    }
+
+    QSqlQuery deletePlaylistsQuery(database);
+    deletePlaylistsQuery.prepare("delete from " + kRekordboxPlaylistsTable +
+            " where " + playlistsFilter);
+    deletePlaylistsQuery.bindValue(":path", devicePath);
+    deletePlaylistsQuery.bindValue(":prefix", prefix);
+
+    if (!deletePlaylistsQuery.exec()) {
+        LOG_FAILED_QUERY(deletePlaylistsQuery)
+                << "devicePath:" << devicePath;
+    }
+
+    transaction.commit();
+}
+
+// Reads a memory-mapped file through a std::istream without copying it. The
+// Kaitai structs seek to each page of the export.pdb when it is accessed, so
+// only the pages of the parsed tables are read from the device.
+class MemoryStreamBuf : public std::streambuf {
+  public:
+    MemoryStreamBuf(const uchar* pData, qint64 size) {
+        char* pBegin = reinterpret_cast<char*>(const_cast<uchar*>(pData));
+        setg(pBegin, pBegin, pBegin + size);
+    }
 
-    QSqlQuery queryInsertIntoDevicePlaylist(database);
-    queryInsertIntoDevicePlaylist.prepare(
+  protected:
+    pos_type seekoff(off_type offset,
+            std::ios_base::seekdir dir,
+            std::ios_base::openmode which) override {
+        if (!(which & std::ios_base::in)) {
+            return pos_type(off_type(-1));
+        }
+        off_type position = offset;
+        if (dir == std::ios_base::cur) {
+            position += gptr() - eback();
+        } else if (dir == std::ios_base::end) {
+            position += egptr() - eback();
+        }
+        if (position < 0 || position > egptr() - eback()) {
+            return pos_type(off_type(-1));
+        }
+        setg(eback(), eback() + position, egptr());
+        return pos_type(position);
+    }
+
+    pos_type seekpos(pos_type position, std::ios_base::openmode which) override {
+        return seekoff(off_type(position), std::ios_base::beg, which);
+    }
+};
+
+// The tracks are committed and passed to the feature in batches, such that
+// they can be browsed while a large export is still being indexed
+constexpr int kTracksPerTransaction = 1000;
+
+struct PlaylistEntry {
+    int playlistID;
+    int position;
+};
+
+int insertPlaylist(QSqlDatabase& database, const QString& name) {
+    QSqlQuery queryInsertIntoPlaylist(database);
+    queryInsertIntoPlaylist.prepare(
             "INSERT INTO " + kRekordboxPlaylistsTable +
             " (name) "
             "VALUES (:name)");
 
-    queryInsertIntoDevicePlaylist.bindValue(":name", devicePath);
+    queryInsertIntoPlaylist.bindValue(":name", name);
 
-    if (!queryInsertIntoDevicePlaylist.exec()) {
-        LOG_FAILED_QUERY(queryInsertIntoDevicePlaylist)
-                << "devicePath: " << devicePath;
-        return playlistID;
+    if (!queryInsertIntoPlaylist.exec()) {
+        LOG_FAILED_QUERY(queryInsertIntoPlaylist)
+                << "name: " << name;
+        return kInvalidPlaylistId;
     }
 
+    return queryInsertIntoPlaylist.lastInsertId().toInt();
+}
+
+int findPlaylist(QSqlDatabase& database, const QString& name) {
+    int playlistID = kInvalidPlaylistId;
+
     QSqlQuery idQuery(database);
     idQuery.prepare("select id from " + kRekordboxPlaylistsTable + " where name=:path");
-    idQuery.bindValue(":path", devicePath);
+    idQuery.bindValue(":path", name);
 
     if (!idQuery.exec()) {
         LOG_FAILED_QUERY(idQuery)
-                << "devicePath: " << devicePath;
+                << "name: " << name;
         return playlistID;
     }
 
@@ -341,28 +493,25 @@ mixxx::RgbColor colorFromID(int colorID) {
     return kColorForIDNoColor;
 }
 
-void insertTrack(
-        QSqlDatabase& database,
+TrackId insertTrack(
         rekordbox_pdb_t::track_row_t* track,
         QSqlQuery& query,
-        QSqlQuery& queryInsertIntoDevicePlaylistTracks,
-        QMap<uint32_t, QString>& artistsMap,
-        QMap<uint32_t, QString>& albumsMap,
-        QMap<uint32_t, QString>& genresMap,
-        QMap<uint32_t, QString>& keysMap,
+        const QMap<uint32_t, QString>& artistsMap,
+        const QMap<uint32_t, QString>& albumsMap,
+        const QMap<uint32_t, QString>& genresMap,
+        const QMap<uint32_t, QString>& keysMap,
         const QString& devicePath,
-        const QString& device,
-        int audioFilesCount) {
+        const QString& device) {
     int rbID = static_cast<int>(track->id());
     QString title = getText(track->title());
-    QString artist = artistsMap[track->artist_id()];
-    QString album = albumsMap[track->album_id()];
+    QString artist = artistsMap.value(track->artist_id());
+    QString album = albumsMap.value(track->album_id());
     QString year = QString::number(track->year());
-    QString genre = genresMap[track->genre_id()];
+    QString genre = genresMap.value(track->genre_id());
     QString location = devicePath + getText(track->file_path());
     float bpm = static_cast<float>(track->tempo() / 100.0);
     int bitrate = static_cast<int>(track->bitrate());
-    QString key = keysMap[track->key_id()];
+    QString key = keysMap.value(track->key_id());
     int playtime = static_cast<int>(track->duration());
     int rating = static_cast<int>(track->rating());
     QString comment = getText(track->comment());
@@ -390,57 +539,105 @@ void insertTrack(
                     colorFromID(static_cast<int>(track->color_id()))));
 
     if (!query.exec()) {
-        LOG_FAILED_QUERY(query);
-    }
-
-    int trackID = -1;
-    QSqlQuery finderQuery(database);
-    finderQuery.prepare("select id from " + kRekordboxLibraryTable +
-            " where rb_id=:rb_id and device=:device");
-    finderQuery.bindValue(":rb_id", rbID);
-    finderQuery.bindValue(":device", device);
-
-    if (!finderQuery.exec()) {
-        LOG_FAILED_QUERY(finderQuery)
+        LOG_FAILED_QUERY(query)
                 << "rbID:" << rbID;
+        return TrackId();
     }
 
-    if (finderQuery.next()) {
-        trackID = finderQuery.value(finderQuery.record().indexOf("id")).toInt();
+    return TrackId(query.lastInsertId());
+}
+
+void insertPlaylistTrack(
+        QSqlQuery& queryInsertIntoPlaylistTracks,
+        int playlistID,
+        TrackId trackID,
+        int position) {
+    queryInsertIntoPlaylistTracks.bindValue(":playlist_id", playlistID);
+    queryInsertIntoPlaylistTracks.bindValue(":track_id", trackID.toVariant());
+    queryInsertIntoPlaylistTracks.bindValue(":position", position);
+
+    if (!queryInsertIntoPlaylistTracks.exec()) {
+        LOG_FAILED_QUERY(queryInsertIntoPlaylistTracks)
+                << "playlistID:" << playlistID
+                << "trackID:" << trackID
+                << "position:" << position;
     }
+}
+
+// Visits the present rows of all tables of the given type
+template<typename Row, typename Function>
+void forEachRow(rekordbox_pdb_t& rekordboxDB,
+        rekordbox_pdb_t::page_type_t type,
+        Function function) {
+    for (rekordbox_pdb_t::table_t* table : *rekordboxDB.tables()) {
+        if (table->type() != type) {
+            continue;
+        }
+        uint16_t lastIndex = table->last_page()->index();
+        rekordbox_pdb_t::page_ref_t* currentRef = table->first_page();
 
-    // Insert into device all tracks playlist
-    queryInsertIntoDevicePlaylistTracks.bindValue(":track_id", trackID);
-    queryInsertIntoDevicePlaylistTracks.bindValue(":position", audioFilesCount);
+        while (true) {
+            rekordbox_pdb_t::page_t* page = currentRef->body();
 
-    if (!queryInsertIntoDevicePlaylistTracks.exec()) {
-        LOG_FAILED_QUERY(queryInsertIntoDevicePlaylistTracks)
-                << "trackID:" << trackID
-                << "position:" << audioFilesCount;
+            if (page->is_data_page()) {
+                for (rekordbox_pdb_t::row_group_t* rowGroup : *page->row_groups()) {
+                    for (rekordbox_pdb_t::row_ref_t* rowRef : *rowGroup->rows()) {
+                        if (rowRef->present()) {
+                            function(static_cast<Row*>(rowRef->body()));
+                        }
+                    }
+                }
+            }
+
+            if (currentRef->index() == lastIndex) {
+                break;
+            } else {
+                currentRef = page->next_page();
+            }
+        }
     }
 }
 
 void buildPlaylistTree(
         QSqlDatabase& database,
         TreeItem* parent,
+        QList<TreeItem*>* pTopLevelItems,
         uint32_t parentID,
-        QMap<uint32_t, QString>& playlistNameMap,
-        QMap<uint32_t, bool>& playlistIsFolderMap,
-        QMap<uint32_t, QMap<uint32_t, uint32_t>>& playlistTreeMap,
-        QMap<uint32_t, QMap<uint32_t, uint32_t>>& playlistTrackMap,
+        const QMap<uint32_t, QString>& playlistNameMap,
+        const QMap<uint32_t, bool>& playlistIsFolderMap,
+        const QMap<uint32_t, QMap<uint32_t, uint32_t>>& playlistTreeMap,
+        const QMap<uint32_t, QMap<uint32_t, uint32_t>>& playlistTrackMap,
         const QString& playlistPath,
-        const QString& device);
-
-QString parseDeviceDB(mixxx::DbConnectionPoolPtr dbConnectionPool, TreeItem* deviceItem) {
-    QString device = deviceItem->getLabel();
-    QString devicePath = deviceItem->getData().toList()[0].toString();
+        bool tracksIndexed,
+        QHash<uint32_t, QList<PlaylistEntry>>* pTrackPlaylistEntries);
+
+void notifyTracksIndexed(RekordboxFeature* pFeature, const QSet<TrackId>& trackIds) {
+    QMetaObject::invokeMethod(
+            pFeature,
+            [pFeature, trackIds] {
+                pFeature->onDeviceTracksIndexed(trackIds);
+            },
+            Qt::QueuedConnection);
+}
 
+// This function is executed in a separate thread other than the main thread.
+// The playlist tree of the device is passed to the feature as soon as it has
+// been parsed, the tracks follow in batches. If the tracks and playlists of
+// the device are still in the tables from an earlier index of the same
+// export.pdb, only the playlist tree is rebuilt.
+RekordboxFeature::IndexedDevice parseDeviceDB(
+        mixxx::DbConnectionPoolPtr dbConnectionPool,
+        RekordboxFeature* pFeature,
+        const QString& device,
+        const QString& devicePath,
+        const RekordboxFeature::IndexedDevice& indexedDevice) {
     qDebug() << "parseDeviceDB device: " << device << " devicePath: " << devicePath;
 
     QString dbPath = devicePath + QStringLiteral("/") + kPdbPath;
 
+    RekordboxFeature::IndexedDevice result;
     if (!QFile(dbPath).exists()) {
-        return devicePath;
+        return result;
     }
 
     // The pooler limits the lifetime all thread-local connections,
@@ -452,46 +649,50 @@ QString parseDeviceDB(mixxx::DbConnectionPoolPtr dbConnectionPool, TreeItem* dev
     VERIFY_OR_DEBUG_ASSERT(database.isOpen()) {
         qDebug() << "Failed to open database for Rekordbox parser."
                  << database.lastError();
-        return QString();
+        return result;
     }
 
     //Give thread a low priority
     QThread* thisThread = QThread::currentThread();
     thisThread->setPriority(QThread::LowPriority);
 
-    ScopedTransaction transaction(database);
-
-    QSqlQuery query(database);
-    query.prepare("INSERT INTO " + kRekordboxLibraryTable +
-            " (rb_id, artist, title, album, year,"
-            "genre,comment,tracknumber,bpm, bitrate,duration, location,"
-            "rating,key,analyze_path,device,color) VALUES (:rb_id, :artist, "
-            ":title, :album, :year,:genre,"
-            ":comment, :tracknumber,:bpm, :bitrate,:duration, :location,"
-            ":rating,:key,:analyze_path,:device,:color)");
-
-    int audioFilesCount = 0;
-
-    // Create a playlist for all the tracks on a device
-    int playlistID = createDevicePlaylist(database, devicePath);
-
-    QSqlQuery queryInsertIntoDevicePlaylistTracks(database);
-    queryInsertIntoDevicePlaylistTracks.prepare(
-            "INSERT INTO " + kRekordboxPlaylistTracksTable +
-            " (playlist_id, track_id, position) "
-            "VALUES (:playlist_id, :track_id, :position)");
-
-    queryInsertIntoDevicePlaylistTracks.bindValue(":playlist_id", playlistID);
-
     mixxx::FileInfo fileInfo(dbPath);
     if (!Sandbox::askForAccess(&fileInfo)) {
-        return QString();
+        return result;
     }
-    std::ifstream ifs(dbPath.toStdString(), std::ifstream::binary);
-    kaitai::kstream ks(&ifs);
+
+    QFile pdbFile(dbPath);
+    if (!pdbFile.open(QIODevice::ReadOnly)) {
+        qWarning() << "Failed to open Rekordbox database" << dbPath
+                   << pdbFile.errorString();
+        return result;
+    }
+    const qint64 pdbSize = pdbFile.size();
+    const uchar* pPdbData = pdbFile.map(0, pdbSize);
+    if (!pPdbData) {
+        qWarning() << "Failed to map Rekordbox database" << dbPath
+                   << pdbFile.errorString();
+        return result;
+    }
+    MemoryStreamBuf pdbBuffer(pPdbData, pdbSize);
+    std::istream pdbStream(&pdbBuffer);
+    kaitai::kstream ks(&pdbStream);
 
     rekordbox_pdb_t reckordboxDB = rekordbox_pdb_t(&ks);
 
+    result.label = device;
+    result.path = devicePath;
+    result.pdbSize = pdbSize;
+    result.pdbLastModified = fileInfo.lastModified();
+    const bool tracksIndexed = result == indexedDevice;
+
+    if (!tracksIndexed) {
+        // Remove an outdated index of this device and the playlists of any
+        // other device that was mounted at the same path before
+        clearDeviceTables(database, device);
+        clearDevicePlaylists(database, devicePath);
+    }
+
     // There are other types of tables (eg. COLOR), these are the only ones we are
     // interested at the moment. Perhaps when/if
     // https://github.com/mixxxdj/mixxx/issues/6852
@@ -499,18 +700,6 @@ QString parseDeviceDB(mixxx::DbConnectionPoolPtr dbConnectionPool, TreeItem* dev
     // Attempt was made to also recover HISTORY
     // playlists (which are found on removable Rekordbox devices), however
     // they didn't appear to contain valid row_ref_t structures.
-    constexpr int totalTables = 8;
-
-    rekordbox_pdb_t::page_type_t tableOrder[totalTables] = {
-            rekordbox_pdb_t::PAGE_TYPE_KEYS,
-            rekordbox_pdb_t::PAGE_TYPE_GENRES,
-            rekordbox_pdb_t::PAGE_TYPE_ARTISTS,
-            rekordbox_pdb_t::PAGE_TYPE_ALBUMS,
-            rekordbox_pdb_t::PAGE_TYPE_PLAYLIST_ENTRIES,
-            rekordbox_pdb_t::PAGE_TYPE_TRACKS,
-            rekordbox_pdb_t::PAGE_TYPE_PLAYLIST_TREE,
-            rekordbox_pdb_t::PAGE_TYPE_HISTORY};
-
     QMap<uint32_t, QString> keysMap;
     QMap<uint32_t, QString> genresMap;
     QMap<uint32_t, QString> artistsMap;
@@ -520,339 +709,216 @@ QString parseDeviceDB(mixxx::DbConnectionPoolPtr dbConnectionPool, TreeItem* dev
     QMap<uint32_t, QMap<uint32_t, uint32_t>> playlistTreeMap;
     QMap<uint32_t, QMap<uint32_t, uint32_t>> playlistTrackMap;
 
-    bool folderOrPlaylistFound = false;
-
-    for (int tableOrderIndex = 0; tableOrderIndex < totalTables; tableOrderIndex++) {
-        for (std::vector<rekordbox_pdb_t::table_t*>::iterator table =
-                        reckordboxDB.tables()->begin();
-                table != reckordboxDB.tables()->end();
-                ++table) {
-            if ((*table)->type() == tableOrder[tableOrderIndex]) {
-                uint16_t lastIndex = (*table)->last_page()->index();
-                rekordbox_pdb_t::page_ref_t* currentRef = (*table)->first_page();
-
-                while (true) {
-                    rekordbox_pdb_t::page_t* page = currentRef->body();
-
-                    if (page->is_data_page()) {
-                        for (std::vector<rekordbox_pdb_t::row_group_t*>::
-                                        iterator rowGroup =
-                                                page->row_groups()->begin();
-                                rowGroup != page->row_groups()->end();
-                                ++rowGroup) {
-                            for (std::vector<rekordbox_pdb_t::row_ref_t*>::
-                                            iterator rowRef = (*rowGroup)
-                                                                      ->rows()
-                                                                      ->begin();
-                                    rowRef != (*rowGroup)->rows()->end();
-                                    ++rowRef) {
-                                if ((*rowRef)->present()) {
-                                    switch (tableOrder[tableOrderIndex]) {
-                                    case rekordbox_pdb_t::PAGE_TYPE_KEYS: {
-                                        // Key found, update map
-                                        rekordbox_pdb_t::key_row_t* key =
-                                                static_cast<rekordbox_pdb_t::
-                                                                key_row_t*>(
-                                                        (*rowRef)->body());
-                                        keysMap[key->id()] = getText(key->name());
-                                    } break;
-                                    case rekordbox_pdb_t::PAGE_TYPE_GENRES: {
-                                        // Genre found, update map
-                                        rekordbox_pdb_t::genre_row_t* genre =
-                                                static_cast<rekordbox_pdb_t::
-                                                                genre_row_t*>(
-                                                        (*rowRef)->body());
-                                        genresMap[genre->id()] = getText(genre->name());
-                                    } break;
-                                    case rekordbox_pdb_t::PAGE_TYPE_ARTISTS: {
-                                        // Artist found, update map
-                                        rekordbox_pdb_t::artist_row_t* artist =
-                                                static_cast<rekordbox_pdb_t::
-                                                                artist_row_t*>(
-                                                        (*rowRef)->body());
-                                        artistsMap[artist->id()] = getText(artist->name());
-                                    } break;
-                                    case rekordbox_pdb_t::PAGE_TYPE_ALBUMS: {
-                                        // Album found, update map
-                                        rekordbox_pdb_t::album_row_t* album =
-                                                static_cast<rekordbox_pdb_t::
-                                                                album_row_t*>(
-                                                        (*rowRef)->body());
-                                        albumsMap[album->id()] = getText(album->name());
-                                    } break;
-                                    case rekordbox_pdb_t::PAGE_TYPE_PLAYLIST_ENTRIES: {
-                                        // Playlist to track mapping found, update map
-                                        rekordbox_pdb_t::playlist_entry_row_t*
-                                                playlistEntry = static_cast<
-                                                        rekordbox_pdb_t::
-                                                                playlist_entry_row_t*>(
-                                                        (*rowRef)->body());
-                                        playlistTrackMap
-                                                [playlistEntry->playlist_id()]
-                                                [playlistEntry->entry_index()] =
-                                                        playlistEntry
-                                                                ->track_id();
-                                    } break;
-                                    case rekordbox_pdb_t::PAGE_TYPE_TRACKS: {
-                                        // Track found, insert into database
-                                        insertTrack(database,
-                                                static_cast<rekordbox_pdb_t::
-                                                                track_row_t*>(
-                                                        (*rowRef)->body()),
-                                                query,
-                                                queryInsertIntoDevicePlaylistTracks,
-                                                artistsMap,
-                                                albumsMap,
-                                                genresMap,
-                                                keysMap,
-                                                devicePath,
-                                                device,
-                                                audioFilesCount);
-
-                                        audioFilesCount++;
-                                    } break;
-                                    case rekordbox_pdb_t::PAGE_TYPE_PLAYLIST_TREE: {
-                                        // Playlist tree node found, update map
-                                        rekordbox_pdb_t::playlist_tree_row_t*
-                                                playlistTree = static_cast<
-                                                        rekordbox_pdb_t::
-                                                                playlist_tree_row_t*>(
-                                                        (*rowRef)->body());
-
-                                        playlistNameMap[playlistTree->id()] =
-                                                getText(playlistTree->name());
-                                        playlistIsFolderMap[playlistTree
-                                                                    ->id()] =
-                                                playlistTree->is_folder();
-                                        playlistTreeMap
-                                                [playlistTree->parent_id()]
-                                                [playlistTree->sort_order()] =
-                                                        playlistTree->id();
-
-                                        folderOrPlaylistFound = true;
-                                    } break;
-                                    default:
-                                        break;
-                                    }
-                                }
-                            }
-                        }
-                    }
-
-                    if (currentRef->index() == lastIndex) {
-                        break;
-                    } else {
-                        currentRef = page->next_page();
-                    }
-                }
-            }
-        }
+    // The playlist tree is parsed first, it only spans a few pages
+    forEachRow<rekordbox_pdb_t::playlist_tree_row_t>(reckordboxDB,
+            rekordbox_pdb_t::PAGE_TYPE_PLAYLIST_TREE,
+            [&](rekordbox_pdb_t::playlist_tree_row_t* playlistTree) {
+                playlistNameMap[playlistTree->id()] = getText(playlistTree->name());
+                playlistIsFolderMap[playlistTree->id()] = playlistTree->is_folder();
+                playlistTreeMap[playlistTree->parent_id()]
+                               [playlistTree->sort_order()] = playlistTree->id();
+            });
+
+    if (!tracksIndexed) {
+        forEachRow<rekordbox_pdb_t::playlist_entry_row_t>(reckordboxDB,
+                rekordbox_pdb_t::PAGE_TYPE_PLAYLIST_ENTRIES,
+                [&](rekordbox_pdb_t::playlist_entry_row_t* playlistEntry) {
+                    playlistTrackMap[playlistEntry->playlist_id()]
+                                    [playlistEntry->entry_index()] =
+                                            playlistEntry->track_id();
+                });
     }
 
-    if (audioFilesCount > 0 || folderOrPlaylistFound) {
-        // If we have found anything, recursively build playlist/folder TreeItem children
-        // for the original device TreeItem
-        buildPlaylistTree(database,
-                deviceItem,
-                0,
-                playlistNameMap,
-                playlistIsFolderMap,
-                playlistTreeMap,
-                playlistTrackMap,
-                devicePath,
-                device);
+    ScopedTransaction transaction(database);
+
+    // Create a playlist for all the tracks on a device
+    int devicePlaylistID = tracksIndexed
+            ? findPlaylist(database, devicePath)
+            : insertPlaylist(database, devicePath);
+
+    // Recursively build playlist/folder TreeItem children for the
+    // device TreeItem
+    QList<TreeItem*> playlists;
+    QHash<uint32_t, QList<PlaylistEntry>> trackPlaylistEntries;
+    buildPlaylistTree(database,
+            nullptr,
+            &playlists,
+            0,
+            playlistNameMap,
+            playlistIsFolderMap,
+            playlistTreeMap,
+            playlistTrackMap,
+            devicePath,
+            tracksIndexed,
+            &trackPlaylistEntries);
+
+    transaction.commit();
+
+    QMetaObject::invokeMethod(
+            pFeature,
+            [pFeature, device, devicePath, playlists] {
+                pFeature->onDevicePlaylistsFound(device, devicePath, playlists);
+            },
+            Qt::QueuedConnection);
+
+    if (tracksIndexed) {
+        qDebug() << "Rekordbox device" << device << "has already been indexed";
+        return result;
     }
 
-    qDebug() << "Found: " << audioFilesCount << " audio files in Rekordbox device " << device;
+    forEachRow<rekordbox_pdb_t::key_row_t>(reckordboxDB,
+            rekordbox_pdb_t::PAGE_TYPE_KEYS,
+            [&](rekordbox_pdb_t::key_row_t* key) {
+                keysMap[key->id()] = getText(key->name());
+            });
+    forEachRow<rekordbox_pdb_t::genre_row_t>(reckordboxDB,
+            rekordbox_pdb_t::PAGE_TYPE_GENRES,
+            [&](rekordbox_pdb_t::genre_row_t* genre) {
+                genresMap[genre->id()] = getText(genre->name());
+            });
+    forEachRow<rekordbox_pdb_t::artist_row_t>(reckordboxDB,
+            rekordbox_pdb_t::PAGE_TYPE_ARTISTS,
+            [&](rekordbox_pdb_t::artist_row_t* artist) {
+                artistsMap[artist->id()] = getText(artist->name());
+            });
+    forEachRow<rekordbox_pdb_t::album_row_t>(reckordboxDB,
+            rekordbox_pdb_t::PAGE_TYPE_ALBUMS,
+            [&](rekordbox_pdb_t::album_row_t* album) {
+                albumsMap[album->id()] = getText(album->name());
+            });
+
+    QSqlQuery query(database);
+    query.prepare("INSERT INTO " + kRekordboxLibraryTable +
+            " (rb_id, artist, title, album, year,"
+            "genre,comment,tracknumber,bpm, bitrate,duration, location,"
+            "rating,key,analyze_path,device,color) VALUES (:rb_id, :artist, "
+            ":title, :album, :year,:genre,"
+            ":comment, :tracknumber,:bpm, :bitrate,:duration, :location,"
+            ":rating,:key,:analyze_path,:device,:color)");
+
+    QSqlQuery queryInsertIntoPlaylistTracks(database);
+    queryInsertIntoPlaylistTracks.prepare(
+            "INSERT INTO " + kRekordboxPlaylistTracksTable +
+            " (playlist_id, track_id, position) "
+            "VALUES (:playlist_id, :track_id, :position)");
 
+    int audioFilesCount = 0;
+    QSet<TrackId> trackIds;
+
+    transaction.transaction();
+    forEachRow<rekordbox_pdb_t::track_row_t>(reckordboxDB,
+            rekordbox_pdb_t::PAGE_TYPE_TRACKS,
+            [&](rekordbox_pdb_t::track_row_t* track) {
+                const TrackId trackID = insertTrack(track,
+                        query,
+                        artistsMap,
+                        albumsMap,
+                        genresMap,
+                        keysMap,
+                        devicePath,
+                        device);
+                if (!trackID.isValid()) {
+                    return;
+                }
+
+                // Insert into device all tracks playlist and the playlists
+                // that contain the track
+                insertPlaylistTrack(queryInsertIntoPlaylistTracks,
+                        devicePlaylistID,
+                        trackID,
+                        audioFilesCount);
+                const auto entries = trackPlaylistEntries.value(track->id());
+                for (const auto& entry : entries) {
+                    insertPlaylistTrack(queryInsertIntoPlaylistTracks,
+                            entry.playlistID,
+                            trackID,
+                            entry.position);
+                }
+                audioFilesCount++;
+
+                trackIds.insert(trackID);
+                if (trackIds.size() >= kTracksPerTransaction) {
+                    transaction.commit();
+                    notifyTracksIndexed(pFeature, trackIds);
+                    trackIds.clear();
+                    transaction.transaction();
+                }
+            });
     transaction.commit();
+    notifyTracksIndexed(pFeature, trackIds);
+
+    qDebug() << "Found: " << audioFilesCount << " audio files in Rekordbox device " << device;
 
-    return devicePath;
+    return result;
 }
 
 void buildPlaylistTree(
         QSqlDatabase& database,
         TreeItem* parent,
+        QList<TreeItem*>* pTopLevelItems,
         uint32_t parentID,
-        QMap<uint32_t, QString>& playlistNameMap,
-        QMap<uint32_t, bool>& playlistIsFolderMap,
-        QMap<uint32_t, QMap<uint32_t, uint32_t>>& playlistTreeMap,
-        QMap<uint32_t, QMap<uint32_t, uint32_t>>& playlistTrackMap,
+        const QMap<uint32_t, QString>& playlistNameMap,
+        const QMap<uint32_t, bool>& playlistIsFolderMap,
+        const QMap<uint32_t, QMap<uint32_t, uint32_t>>& playlistTreeMap,
+        const QMap<uint32_t, QMap<uint32_t, uint32_t>>& playlistTrackMap,
         const QString& playlistPath,
-        const QString& device) {
-    for (uint32_t childIndex = 0;
-            childIndex < (uint32_t)playlistTreeMap[parentID].size();
-            childIndex++) {
-        uint32_t childID = playlistTreeMap[parentID][childIndex];
+        bool tracksIndexed,
+        QHash<uint32_t, QList<PlaylistEntry>>* pTrackPlaylistEntries) {
+    // The children are sorted by their sort order
+    const QMap<uint32_t, uint32_t> children = playlistTreeMap.value(parentID);
+    for (const uint32_t childID : children) {
         if (childID == 0) {
             continue;
         }
-        QString playlistItemName = playlistNameMap[childID];
+        QString playlistItemName = playlistNameMap.value(childID);
 
         QString currentPath = playlistPath + kPLaylistPathDelimiter + playlistItemName;
 
-        TreeItem* child = parent->appendChild(playlistItemName,
-                QVariant(QList<QString>{currentPath, IS_NOT_RECORDBOX_DEVICE}));
-
-        // Create a playlist for this child
-        QSqlQuery queryInsertIntoPlaylist(database);
-        queryInsertIntoPlaylist.prepare(
-                "INSERT INTO " + kRekordboxPlaylistsTable +
-                " (name) "
-                "VALUES (:name)");
-
-        queryInsertIntoPlaylist.bindValue(":name", currentPath);
-
-        if (!queryInsertIntoPlaylist.exec()) {
-            LOG_FAILED_QUERY(queryInsertIntoPlaylist)
-                    << "currentPath" << currentPath;
-            return;
+        // The top level items are not attached to the device TreeItem yet,
+        // that is owned by the sidebar model in the main thread
+        QVariant data = QVariant(QList<QString>{currentPath, IS_NOT_RECORDBOX_DEVICE});
+        TreeItem* child;
+        if (parent) {
+            child = parent->appendChild(playlistItemName, data);
+        } else {
+            child = new TreeItem(playlistItemName, data);
+            pTopLevelItems->append(child);
         }
 
-        QSqlQuery idQuery(database);
-        idQuery.prepare("select id from " + kRekordboxPlaylistsTable + " where name=:path");
-        idQuery.bindValue(":path", currentPath);
-
-        if (!idQuery.exec()) {
-            LOG_FAILED_QUERY(idQuery)
-                    << "currentPath" << currentPath;
+        // Create a playlist for this child
+        int playlistID = tracksIndexed
+                ? findPlaylist(database, currentPath)
+                : insertPlaylist(database, currentPath);
+        if (playlistID == kInvalidPlaylistId) {
             return;
         }
 
-        int playlistID = kInvalidPlaylistId;
-        while (idQuery.next()) {
-            playlistID = idQuery.value(idQuery.record().indexOf("id")).toInt();
-        }
-
-        QSqlQuery queryInsertIntoPlaylistTracks(database);
-        queryInsertIntoPlaylistTracks.prepare(
-                "INSERT INTO " + kRekordboxPlaylistTracksTable +
-                " (playlist_id, track_id, position) "
-                "VALUES (:playlist_id, :track_id, :position)");
-
-        if (playlistTrackMap.contains(childID)) {
-            // Add playlist tracks for children
-            for (uint32_t trackIndex = 1; trackIndex <=
-                    static_cast<uint32_t>(playlistTrackMap[childID].size());
-                    trackIndex++) {
-                uint32_t rbTrackID = playlistTrackMap[childID][trackIndex];
-
-                int trackID = -1;
-                QSqlQuery finderQuery(database);
-                finderQuery.prepare("select id from " + kRekordboxLibraryTable +
-                        " where rb_id=:rb_id and device=:device");
-                finderQuery.bindValue(":rb_id", rbTrackID);
-                finderQuery.bindValue(":device", device);
-
-                if (!finderQuery.exec()) {
-                    LOG_FAILED_QUERY(finderQuery)
-                            << "rbTrackID:" << rbTrackID
-                            << "device:" << device;
-                    return;
-                }
-
-                if (finderQuery.next()) {
-                    trackID = finderQuery.value(finderQuery.record().indexOf("id")).toInt();
-                }
-
-                queryInsertIntoPlaylistTracks.bindValue(":playlist_id", playlistID);
-                queryInsertIntoPlaylistTracks.bindValue(":track_id", trackID);
-                queryInsertIntoPlaylistTracks.bindValue(":position", static_cast<int>(trackIndex));
-
-                if (!queryInsertIntoPlaylistTracks.exec()) {
-                    LOG_FAILED_QUERY(queryInsertIntoPlaylistTracks)
-                            << "playlistID:" << playlistID
-                            << "trackID:" << trackID
-                            << "trackIndex:" << trackIndex;
-
-                    return;
-                }
+        if (!tracksIndexed) {
+            // The playlist tracks are inserted together with the tracks
+            const QMap<uint32_t, uint32_t> entries = playlistTrackMap.value(childID);
+            for (auto it = entries.constBegin(); it != entries.constEnd(); ++it) {
+                (*pTrackPlaylistEntries)[it.value()].append(
+                        PlaylistEntry{playlistID, static_cast<int>(it.key())});
             }
         }
 
-        if (playlistIsFolderMap[childID]) {
+        if (playlistIsFolderMap.value(childID)) {
             // If this child is a folder (playlists are only leaf nodes), build playlist tree for it
             buildPlaylistTree(database,
                     child,
+                    pTopLevelItems,
                     childID,
                     playlistNameMap,
                     playlistIsFolderMap,
                     playlistTreeMap,
                     playlistTrackMap,
                     currentPath,
-                    device);
+                    tracksIndexed,
+                    pTrackPlaylistEntries);
         }
     }
 }
 
-void clearDeviceTables(QSqlDatabase& database, TreeItem* child) {
-    ScopedTransaction transaction(database);
-
-    int trackID = -1;
-    int playlistID = kInvalidPlaylistId;
-    QSqlQuery tracksQuery(database);
-    tracksQuery.prepare("select id from " + kRekordboxLibraryTable + " where device=:device");
-    tracksQuery.bindValue(":device", child->getLabel());
-
-    QSqlQuery deletePlaylistsQuery(database);
-    deletePlaylistsQuery.prepare("delete from " + kRekordboxPlaylistsTable + " where id=:id");
-
-    QSqlQuery deletePlaylistTracksQuery(database);
-    deletePlaylistTracksQuery.prepare("delete from " +
-            kRekordboxPlaylistTracksTable + " where playlist_id=:playlist_id");
-
-    if (!tracksQuery.exec()) {
-        LOG_FAILED_QUERY(tracksQuery)
-                << "device:" << child->getLabel();
-    }
-
-    while (tracksQuery.next()) {
-        trackID = tracksQuery.value(tracksQuery.record().indexOf("id")).toInt();
-
-        QSqlQuery playlistTracksQuery(database);
-        playlistTracksQuery.prepare("select playlist_id from " +
-                kRekordboxPlaylistTracksTable + " where track_id=:track_id");
-        playlistTracksQuery.bindValue(":track_id", trackID);
-
-        if (!playlistTracksQuery.exec()) {
-            LOG_FAILED_QUERY(playlistTracksQuery)
-                    << "trackID:" << trackID;
-        }
-
-        while (playlistTracksQuery.next()) {
-            playlistID = playlistTracksQuery
-                                 .value(playlistTracksQuery.record().indexOf(
-                                         "playlist_id"))
-                                 .toInt();
-
-            deletePlaylistsQuery.bindValue(":id", playlistID);
-
-            if (!deletePlaylistsQuery.exec()) {
-                LOG_FAILED_QUERY(deletePlaylistsQuery)
-                        << "playlistID:" << playlistID;
-            }
-
-            deletePlaylistTracksQuery.bindValue(":playlist_id", playlistID);
-
-            if (!deletePlaylistTracksQuery.exec()) {
-                LOG_FAILED_QUERY(deletePlaylistTracksQuery)
-                        << "playlistID:" << playlistID;
-            }
-        }
-    }
-
-    QSqlQuery deleteTracksQuery(database);
-    deleteTracksQuery.prepare("delete from " + kRekordboxLibraryTable + " where device=:device");
-    deleteTracksQuery.bindValue(":device", child->getLabel());
-
-    if (!deleteTracksQuery.exec()) {
-        LOG_FAILED_QUERY(deleteTracksQuery)
-                << "device:" << child->getLabel();
-    }
-
-    transaction.commit();
-}
-
 void setHotCue(TrackPointer track,
         mixxx::audio::FramePos startPosition,
         mixxx::audio::FramePos endPosition,
@@ -1398,7 +1464,7 @@ RekordboxFeature::RekordboxFeature(
             this,
             &RekordboxFeature::onRekordboxDevicesFound);
     connect(&m_tracksFutureWatcher,
-            &QFutureWatcher<QString>::finished,
+            &QFutureWatcher<IndexedDevice>::finished,
             this,
             &RekordboxFeature::onTracksFound);
     // initialize the model
@@ -1544,8 +1610,13 @@ void RekordboxFeature::activateChild(const QModelIndex& index) {
     if (doParseDeviceDB) {
         qDebug() << "Parse Rekordbox Device DB: " << playlist;
 
-        // Let a worker thread do the XML parsing
-        m_tracksFuture = QtConcurrent::run(parseDeviceDB, static_cast<Library*>(parent())->dbConnectionPool(), item);
+        // Let a worker thread parse the export.pdb
+        m_tracksFuture = QtConcurrent::run(parseDeviceDB,
+                static_cast<Library*>(parent())->dbConnectionPool(),
+                this,
+                item->getLabel(),
+                playlist,
+                m_indexedDevices.value(item->getLabel()));
         m_tracksFutureWatcher.setFuture(m_tracksFuture);
 
         // This device is now a playlist element, future activations should treat is
@@ -1568,7 +1639,7 @@ void RekordboxFeature::onRekordboxDevicesFound() {
     TreeItem* root = m_pSidebarModel->getRootItem();
     QSqlDatabase database = m_pTrackCollection->database();
 
-    if (foundDevices.size() == 0) {
+    if (foundDevices.size() == 0 && m_indexedDevices.isEmpty()) {
         // No Rekordbox devices found
         ScopedTransaction transaction(database);
 
@@ -1600,8 +1671,11 @@ void RekordboxFeature::onRekordboxDevicesFound() {
             }
 
             if (removeChild) {
-                // Device has since been unmounted, cleanup DB
-                clearDeviceTables(database, child);
+                // Device has since been unmounted, cleanup DB unless it has
+                // been indexed completely and may be mounted again
+                if (!m_indexedDevices.contains(child->getLabel())) {
+                    clearDeviceTables(database, child->getLabel());
+                }
 
                 m_pSidebarModel->removeRows(deviceIndex, 1);
             }
@@ -1637,18 +1711,55 @@ void RekordboxFeature::onRekordboxDevicesFound() {
 
 void RekordboxFeature::onTracksFound() {
     qDebug() << "onTracksFound";
-    m_pSidebarModel->triggerRepaint();
 
-    QString devicePlaylist;
+    IndexedDevice indexedDevice;
     try {
-        devicePlaylist = m_tracksFuture.result();
+        indexedDevice = m_tracksFuture.result();
     } catch (const std::exception& e) {
         qWarning() << "Failed to load Rekordbox database:" << e.what();
         return;
     }
+    if (!indexedDevice.isValid()) {
+        return;
+    }
+
+    // The playlists of another device that was mounted at the same path
+    // have been replaced
+    for (auto it = m_indexedDevices.begin(); it != m_indexedDevices.end();) {
+        if (it->path == indexedDevice.path) {
+            it = m_indexedDevices.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    m_indexedDevices.insert(indexedDevice.label, indexedDevice);
+}
+
+void RekordboxFeature::onDevicePlaylistsFound(const QString& device,
+        const QString& devicePath,
+        const QList<TreeItem*>& playlists) {
+    auto children = std::vector<std::unique_ptr<TreeItem>>(
+            playlists.cbegin(), playlists.cend());
+
+    TreeItem* root = m_pSidebarModel->getRootItem();
+    for (int deviceIndex = 0; deviceIndex < root->childRows(); deviceIndex++) {
+        if (root->child(deviceIndex)->getLabel() != device) {
+            continue;
+        }
+        m_pSidebarModel->insertTreeItemRows(std::move(children),
+                0,
+                m_pSidebarModel->index(deviceIndex, 0));
+
+        qDebug() << "Show Rekordbox Device Playlist: " << devicePath;
 
-    qDebug() << "Show Rekordbox Device Playlist: " << devicePlaylist;
+        m_pRekordboxPlaylistModel->setPlaylist(devicePath);
+        emit showTrackModel(m_pRekordboxPlaylistModel);
+        return;
+    }
+    // The device has been unmounted in the meantime
+}
 
-    m_pRekordboxPlaylistModel->setPlaylist(devicePlaylist);
-    emit showTrackModel(m_pRekordboxPlaylistModel);
+void RekordboxFeature::onDeviceTracksIndexed(const QSet<TrackId>& trackIds) {
+    m_trackSource->slotTracksAddedOrChanged(trackIds);
+    m_pRekordboxPlaylistModel->selectAsync();
 }
@@ -24,8 +24,11 @@
 
 #pragma once
 
+#include <QDateTime>
 #include <QFuture>
 #include <QFutureWatcher>
+#include <QHash>
+#include <QSet>
 #include <QStringListModel>
 #include <QtConcurrentRun>
 #include <fstream>
@@ -34,6 +37,7 @@
 #include "library/baseexternalplaylistmodel.h"
 #include "library/baseexternaltrackmodel.h"
 #include "library/treeitemmodel.h"
+#include "track/trackid.h"
 #include "util/parented_ptr.h"
 
 class TrackCollectionManager;
@@ -56,6 +60,25 @@ class RekordboxPlaylistModel : public BaseExternalPlaylistModel {
 class RekordboxFeature : public BaseExternalLibraryFeature {
     Q_OBJECT
   public:
+    /// The export.pdb of a device whose tracks and playlists have been
+    /// inserted into the Rekordbox tables
+    struct IndexedDevice {
+        QString label;
+        QString path;
+        qint64 pdbSize = -1;
+        QDateTime pdbLastModified;
+
+        bool isValid() const {
+            return !label.isEmpty();
+        }
+        bool operator==(const IndexedDevice& other) const {
+            return label == other.label &&
+                    path == other.path &&
+                    pdbSize == other.pdbSize &&
+                    pdbLastModified == other.pdbLastModified;
+        }
+    };
+
     RekordboxFeature(Library* pLibrary, UserSettingsPointer pConfig);
     ~RekordboxFeature() override;
 
@@ -72,6 +95,11 @@ class RekordboxFeature : public BaseExternalLibraryFeature {
     void refreshLibraryModels();
     void onRekordboxDevicesFound();
     void onTracksFound();
+    /// Takes the ownership of the playlists
+    void onDevicePlaylistsFound(const QString& device,
+            const QString& devicePath,
+            const QList<TreeItem*>& playlists);
+    void onDeviceTracksIndexed(const QSet<TrackId>& trackIds);
 
   private slots:
     void htmlLinkClicked(const QUrl& link);
@@ -86,8 +114,12 @@ class RekordboxFeature : public BaseExternalLibraryFeature {
 
     QFutureWatcher<QList<TreeItem*>> m_devicesFutureWatcher;
     QFuture<QList<TreeItem*>> m_devicesFuture;
-    QFutureWatcher<QString> m_tracksFutureWatcher;
-    QFuture<QString> m_tracksFuture;
+    QFutureWatcher<IndexedDevice> m_tracksFutureWatcher;
+    QFuture<IndexedDevice> m_tracksFuture;
+    // The tracks and playlists of these devices are kept in the tables after
+    // they have been unmounted, they are not indexed again when they are
+    // mounted with an unchanged export.pdb.
+    QHash<QString, IndexedDevice> m_indexedDevices;
     QString m_title;
 
     QSharedPointer<BaseTrackCache> m_trackSource;
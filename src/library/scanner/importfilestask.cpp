@@ -1,8 +1,17 @@
 #include "library/scanner/importfilestask.h"
 
 #include "moc_importfilestask.cpp"
+#include "sources/soundsourceproxy.h"
 #include "util/timer.h"
 
+namespace {
+
+// New tracks are passed to the scanner thread in batches to reduce
+// the overhead of queued signals.
+constexpr int kNewTracksBatchSize = 32;
+
+} // anonymous namespace
+
 ImportFilesTask::ImportFilesTask(LibraryScanner* pScanner,
         const ScannerGlobalPointer scannerGlobal,
         const QString& dirPath,
@@ -22,6 +31,7 @@ ImportFilesTask::ImportFilesTask(LibraryScanner* pScanner,
 
 void ImportFilesTask::run() {
     ScopedTimer timer("ImportFilesTask::run");
+    QStringList newTrackLocations;
     for (const QFileInfo& fileInfo: m_filesToImport) {
         // If a flag was raised telling us to cancel the library scan then stop.
         if (m_scannerGlobal->shouldCancel()) {
@@ -49,10 +59,51 @@ void ImportFilesTask::run() {
             }
             qDebug() << "Importing track" << trackLocation;
 
-            emit addNewTrack(trackLocation);
+            if (!prefetchTrackMetadata(fileInfo, trackLocation, &newTrackLocations)) {
+                setSuccess(false);
+                return;
+            }
+            if (newTrackLocations.size() >= kNewTracksBatchSize) {
+                emitNewTracks(&newTrackLocations);
+            }
         }
     }
+    emitNewTracks(&newTrackLocations);
     // Insert or update the hash in the database.
     emit directoryHashedAndScanned(m_dirPath, !m_prevHashExists, m_newHash);
     setSuccess(true);
 }
+
+bool ImportFilesTask::prefetchTrackMetadata(const QFileInfo& fileInfo,
+        const QString& trackLocation,
+        QStringList* pNewTrackLocations) {
+    if (!m_scannerGlobal->tryReservePrefetchedTrack()) {
+        // Hand over all pending tracks before waiting for the
+        // scanner thread to add them to the database.
+        emitNewTracks(pNewTrackLocations);
+        if (!m_scannerGlobal->reservePrefetchedTrack()) {
+            return false; // cancelled
+        }
+    }
+    // Parsing the file tags is the most expensive part of adding a track.
+    // It is done here in parallel to the scanner thread that adds the
+    // tracks to the database.
+    auto prefetchedMetadata = SoundSourceProxy::prefetchTrackMetadataFromFile(
+            mixxx::FileAccess(mixxx::FileInfo(fileInfo), m_pToken));
+    if (prefetchedMetadata) {
+        m_scannerGlobal->addPrefetchedTrack(trackLocation, std::move(*prefetchedMetadata));
+    } else {
+        // The metadata will be imported when adding the track
+        m_scannerGlobal->releasePrefetchedTrack();
+    }
+    pNewTrackLocations->append(trackLocation);
+    return true;
+}
+
+void ImportFilesTask::emitNewTracks(QStringList* pNewTrackLocations) {
+    if (pNewTrackLocations->isEmpty()) {
+        return;
+    }
+    emit addNewTracks(*pNewTrackLocations);
+    pNewTrackLocations->clear();
+}
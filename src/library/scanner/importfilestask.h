@@ -23,6 +23,11 @@ class ImportFilesTask : public ScannerTask {
     virtual void run();
 
   private:
+    bool prefetchTrackMetadata(const QFileInfo& fileInfo,
+            const QString& trackLocation,
+            QStringList* pNewTrackLocations);
+    void emitNewTracks(QStringList* pNewTrackLocations);
+
     const QString m_dirPath;
     const bool m_prevHashExists;
     const mixxx::cache_key_t m_newHash;
@@ -13,17 +13,44 @@
 #include "util/db/dbconnectionpooler.h"
 #include "util/db/fwdsqlquery.h"
 #include "util/logger.h"
+#include "util/math.h"
 #include "util/performancetimer.h"
+#include "util/powerprofile.h"
 #include "util/timer.h"
 #include "util/trace.h"
 
 namespace {
 
-// TODO(rryan) make configurable
-constexpr int kScannerThreadPoolSize = 1;
-
 mixxx::Logger kLogger("LibraryScanner");
 
+// The number of threads that list directories and parse the tags of
+// new files in parallel. Reading multiple files at once only pays off
+// on SSDs, rotating disks and network shares are read sequentially
+// by default.
+const ConfigKey kScannerThreadCountConfigKey =
+        ConfigKey(QStringLiteral("[Library]"), QStringLiteral("ScannerThreadCount"));
+constexpr int kScannerThreadCountDefault = 1;
+
+// The number of threads that list directories in parallel. Listing a
+// directory hardly needs any bandwidth, but takes many round trips on
+// network shares, so it benefits from more concurrent requests than
+// importing files.
+const ConfigKey kScannerDirectoryThreadCountConfigKey =
+        ConfigKey(QStringLiteral("[Library]"), QStringLiteral("ScannerDirectoryThreadCount"));
+constexpr int kScannerDirectoryThreadCountDefault = 4;
+
+// Skip listing directories that have not been modified since the last
+// scan. Only works reliably if the file system updates the modification
+// time of the parent directory when adding, removing, or renaming files.
+const ConfigKey kIncrementalRescanConfigKey =
+        ConfigKey(QStringLiteral("[Library]"), QStringLiteral("IncrementalRescan"));
+
+// The pattern of supported file names during the last scan. Skipping
+// directories would miss files that have become supported since then,
+// e.g. after installing an additional decoder.
+const ConfigKey kScannedFileNamesConfigKey =
+        ConfigKey(QStringLiteral("[Library]"), QStringLiteral("ScannedFileNames"));
+
 QAtomicInt s_instanceCounter(0);
 
 // Returns the number of affected rows or -1 on error
@@ -98,6 +125,9 @@ LibraryScanner::LibraryScanner(
         mixxx::DbConnectionPoolPtr pDbConnectionPool,
         const UserSettingsPointer& pConfig)
         : m_pDbConnectionPool(std::move(pDbConnectionPool)),
+          m_pConfig(pConfig),
+          m_powerSaving(mixxx::PowerProfile::kPowerSavingConfigKey,
+                  ControlFlag::NoAssertIfMissing),
           m_analysisDao(pConfig),
           m_trackDao(m_cueDao, m_playlistDao,
                   m_analysisDao, m_libraryHashDao,
@@ -108,12 +138,11 @@ LibraryScanner::LibraryScanner(
     // queue to our event loop.
     moveToThread(this);
     m_pool.moveToThread(this);
+    m_directoryPool.moveToThread(this);
 
     const int instanceId = s_instanceCounter.fetchAndAddAcquire(1) + 1;
     setObjectName(QString("LibraryScanner %1").arg(instanceId));
 
-    m_pool.setMaxThreadCount(kScannerThreadPoolSize);
-
     // Listen to signals from our public methods (invoked by other threads) and
     // connect them to our slots to run the command on the scanner thread.
     connect(this, &LibraryScanner::startScan, this, &LibraryScanner::slotStartScan);
@@ -187,6 +216,7 @@ void LibraryScanner::slotStartScan() {
     DEBUG_ASSERT(m_state == STARTING);
 
     cleanUpDatabase(m_libraryHashDao.database());
+    m_analysisDao.collectGarbage(m_analysisDao.database());
 
     // Recursively scan each directory in the directories table.
     m_libraryRootDirs = m_directoryDao.loadAllDirectories();
@@ -205,10 +235,35 @@ void LibraryScanner::slotStartScan() {
             QRegularExpression(CoverArtUtils::supportedCoverArtExtensionsRegex(),
                     QRegularExpression::CaseInsensitiveOption);
     QStringList directoryBlacklist = ScannerUtil::getDirectoryBlacklist();
+    QHash<QString, LibraryHashDAO::DirectoryMTime> directoryMTimes =
+            m_libraryHashDao.getDirectoryMTimes();
+    const bool skipUnmodifiedDirectories =
+            m_pConfig->getValue<bool>(kIncrementalRescanConfigKey, false) &&
+            m_pConfig->getValueString(kScannedFileNamesConfigKey) ==
+                    extensionFilter.pattern();
+    if (skipUnmodifiedDirectories) {
+        kLogger.info() << "Skipping unmodified directories";
+    }
 
     m_scannerGlobal = ScannerGlobalPointer(
-            new ScannerGlobal(trackLocations, directoryHashes, extensionFilter,
-                              coverExtensionFilter, directoryBlacklist));
+            new ScannerGlobal(trackLocations,
+                    directoryHashes,
+                    extensionFilter,
+                    coverExtensionFilter,
+                    directoryBlacklist,
+                    directoryMTimes,
+                    skipUnmodifiedDirectories));
+
+    m_pool.setMaxThreadCount(m_powerSaving.toBool()
+                    ? 1
+                    : math_max(1,
+                              m_pConfig->getValue(kScannerThreadCountConfigKey,
+                                      kScannerThreadCountDefault)));
+    m_directoryPool.setMaxThreadCount(m_powerSaving.toBool()
+                    ? 1
+                    : math_max(1,
+                              m_pConfig->getValue(kScannerDirectoryThreadCountConfigKey,
+                                      kScannerDirectoryThreadCountDefault)));
 
     m_scannerGlobal->startTimer();
 
@@ -372,8 +427,18 @@ void LibraryScanner::cleanUpScan() {
     // A.
     m_libraryHashDao.removeDeletedDirectoryHashes();
 
+    // Only a scan that has been finished completely may be used for
+    // skipping unmodified directories during the next scan
+    kLogger.debug() << "Updating directory modification times";
+    m_libraryHashDao.updateDirectoryMTimes(
+            m_scannerGlobal->changedDirectoryMTimes(),
+            m_scannerGlobal->unvisitedDirectories());
+
     transaction.commit();
 
+    m_pConfig->setValue(kScannedFileNamesConfigKey,
+            m_scannerGlobal->supportedExtensionsRegex().pattern());
+
     kLogger.debug() << "Detecting cover art for unscanned files";
     QSet<TrackId> coverArtTracksChanged;
     m_trackDao.detectCoverArtForTracksWithoutCover(
@@ -424,12 +489,13 @@ void LibraryScanner::slotFinishUnhashedScan() {
 
     // TODO(XXX) doesn't take into account verifyRemainingTracks.
     qDebug("Scan took: %s. "
-           "%d unchanged directories. "
+           "%d unchanged directories (%d not listed). "
            "%d changed/added directories. "
            "%d tracks verified from changed/added directories. "
            "%d new tracks.",
             m_scannerGlobal->timerElapsed().formatNanosWithUnit().toLocal8Bit().constData(),
             static_cast<int>(m_scannerGlobal->verifiedDirectories().size()),
+            m_scannerGlobal->numUnmodifiedDirectories(),
             m_scannerGlobal->numScannedDirectories(),
             static_cast<int>(m_scannerGlobal->verifiedTracks().size()),
             static_cast<int>(m_scannerGlobal->addedTracks().size()));
@@ -481,9 +547,11 @@ void LibraryScanner::cancel() {
         scanner->cancel();
     }
 
-    // Wait for the thread pool to empty. This is important because ScannerTasks
+    // Wait for the thread pools to empty. This is important because ScannerTasks
     // have pointers to the LibraryScanner and can cause a segfault if they run
-    // after the LibraryScanner has been destroyed.
+    // after the LibraryScanner has been destroyed. Directory tasks queue
+    // import tasks, so they have to finish first.
+    m_directoryPool.waitForDone();
     m_pool.waitForDone();
 }
 
@@ -511,9 +579,9 @@ void LibraryScanner::queueTask(ScannerTask* pTask) {
             this,
             &LibraryScanner::slotTrackExists);
     connect(pTask,
-            &ScannerTask::addNewTrack,
+            &ScannerTask::addNewTracks,
             this,
-            &LibraryScanner::slotAddNewTrack);
+            &LibraryScanner::slotAddNewTracks);
 
     // Progress signals.
     // Pass directly to the main thread
@@ -526,7 +594,11 @@ void LibraryScanner::queueTask(ScannerTask* pTask) {
             this,
             &LibraryScanner::progressHashing);
 
-    m_pool.start(pTask);
+    if (qobject_cast<RecursiveScanDirectoryTask*>(pTask)) {
+        m_directoryPool.start(pTask);
+    } else {
+        m_pool.start(pTask);
+    }
 }
 
 void LibraryScanner::slotDirectoryHashedAndScanned(const QString& directoryPath,
@@ -566,36 +638,43 @@ void LibraryScanner::slotTrackExists(const QString& trackPath) {
     }
 }
 
-void LibraryScanner::slotAddNewTrack(const QString& trackPath) {
-    //kLogger.debug() << "slotAddNewTrack" << trackPath;
-    ScopedTimer timer("LibraryScanner::addNewTrack");
-    // For statistics tracking and to detect moved tracks
-    TrackPointer pTrack = m_trackDao.addTracksAddFile(
-            trackPath,
-            false);
-    if (pTrack) {
-        DEBUG_ASSERT(!pTrack->isDirty());
-        // The track's actual location might differ from the
-        // given trackPath
-        const QString trackLocation(pTrack->getLocation());
-        // Acknowledge successful track addition
+void LibraryScanner::slotAddNewTracks(const QStringList& trackPaths) {
+    //kLogger.debug() << "slotAddNewTracks" << trackPaths;
+    ScopedTimer timer("LibraryScanner::addNewTracks");
+    for (const auto& trackPath : trackPaths) {
+        std::optional<SoundSourceProxy::PrefetchedTrackMetadata> prefetchedMetadata;
         if (m_scannerGlobal) {
-            m_scannerGlobal->trackAdded(trackLocation);
+            prefetchedMetadata = m_scannerGlobal->takePrefetchedTrack(trackPath);
         }
-        // Signal the main instance of TrackDAO, that there is
-        // a new track in the database.
-        emit trackAdded(pTrack);
-        emit progressLoading(trackLocation);
-    } else {
-        // Acknowledge failed track addition
-        // TODO(XXX): Is it really intended to acknowledge a failed
-        // track addition with a trackAdded() signal??
-        if (m_scannerGlobal) {
-            m_scannerGlobal->trackAdded(trackPath);
+        // For statistics tracking and to detect moved tracks
+        TrackPointer pTrack = m_trackDao.addTracksAddFile(
+                trackPath,
+                false,
+                prefetchedMetadata ? &*prefetchedMetadata : nullptr);
+        if (pTrack) {
+            DEBUG_ASSERT(!pTrack->isDirty());
+            // The track's actual location might differ from the
+            // given trackPath
+            const QString trackLocation(pTrack->getLocation());
+            // Acknowledge successful track addition
+            if (m_scannerGlobal) {
+                m_scannerGlobal->trackAdded(trackLocation);
+            }
+            // Signal the main instance of TrackDAO, that there is
+            // a new track in the database.
+            emit trackAdded(pTrack);
+            emit progressLoading(trackLocation);
+        } else {
+            // Acknowledge failed track addition
+            // TODO(XXX): Is it really intended to acknowledge a failed
+            // track addition with a trackAdded() signal??
+            if (m_scannerGlobal) {
+                m_scannerGlobal->trackAdded(trackPath);
+            }
+            kLogger.warning()
+                    << "Failed to add track to library:"
+                    << trackPath;
         }
-        kLogger.warning()
-                << "Failed to add track to library:"
-                << trackPath;
     }
 }
 
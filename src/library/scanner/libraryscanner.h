@@ -8,6 +8,7 @@
 #include <QThread>
 #include <QThreadPool>
 
+#include "control/pollingcontrolproxy.h"
 #include "library/dao/analysisdao.h"
 #include "library/dao/cuedao.h"
 #include "library/dao/directorydao.h"
@@ -69,7 +70,7 @@ class LibraryScanner : public QThread {
                                    bool newDirectory, mixxx::cache_key_t hash);
     void slotDirectoryUnchanged(const QString& directoryPath);
     void slotTrackExists(const QString& trackPath);
-    void slotAddNewTrack(const QString& trackPath);
+    void slotAddNewTracks(const QStringList& trackPaths);
 
   private:
     enum ScannerState {
@@ -96,9 +97,15 @@ class LibraryScanner : public QThread {
     void cleanUpScan();
 
     mixxx::DbConnectionPoolPtr m_pDbConnectionPool;
+    const UserSettingsPointer m_pConfig;
 
     // The pool of threads used for worker tasks.
     QThreadPool m_pool;
+    // The pool of threads used for listing directories, which is mostly
+    // waiting for I/O.
+    QThreadPool m_directoryPool;
+    // New scans use a single thread per pool while running on battery
+    PollingControlProxy m_powerSaving;
 
     // The library scanner thread's DAOs.
     LibraryHashDAO m_libraryHashDao;
@@ -1,6 +1,7 @@
 #include "library/scanner/recursivescandirectorytask.h"
 
 #include <QCryptographicHash>
+#include <QDateTime>
 #include <QDir>
 #include <QFileInfo>
 
@@ -30,6 +31,26 @@ void RecursiveScanDirectoryTask::run() {
     //qDebug() << "Burn CPU";
     //for (int i = 0;i < 1000000000; i++) asm("nop");
 
+    const QString dirLocation = m_dirAccess.info().location();
+
+    // Read the modification time before listing the directory. Concurrent
+    // modifications while listing will be detected by the next scan.
+    const QDateTime lastModified = m_dirAccess.info().asQFileInfo().lastModified();
+    const qint64 mtimeMillis = lastModified.isValid() ? lastModified.toMSecsSinceEpoch() : 0;
+    if (m_scannerGlobal->directoryUnmodified(dirLocation, mtimeMillis)) {
+        // Neither the files nor the subdirectories have changed since the
+        // last scan and the directory listing could be skipped. This still
+        // requires to check all subdirectories recursively.
+        m_scannerGlobal->addUnmodifiedDirectory(dirLocation);
+        emit directoryUnchanged(dirLocation);
+        const QStringList subdirPaths = m_scannerGlobal->knownSubdirectories(dirLocation);
+        for (const auto& subdirPath : subdirPaths) {
+            queueSubdirectoryTask(mixxx::FileInfo(subdirPath));
+        }
+        setSuccess(true);
+        return;
+    }
+
     // Note, we save on filesystem operations (and random work) by initializing
     // a QDirIterator with a QDir instead of a QString -- but it inherits its
     // Filter from the QDir so we have to set it first. If the QDir has not done
@@ -84,8 +105,6 @@ void RecursiveScanDirectoryTask::run() {
     // Calculate a hash of the directory's file list.
     const mixxx::cache_key_t newHash = mixxx::cacheKeyFromMessageDigest(hasher.result());
 
-    QString dirLocation = m_dirAccess.info().location();
-
     // Try to retrieve a hash from the last time that directory was scanned.
     const mixxx::cache_key_t prevHash = m_scannerGlobal->directoryHashInDatabase(dirLocation);
     const bool prevHashExists = mixxx::isValidCacheKey(prevHash);
@@ -115,19 +134,29 @@ void RecursiveScanDirectoryTask::run() {
         m_scannerGlobal->addUnhashedDir(m_dirAccess);
     }
 
+    // Unhashed directories are listed again in the second stage
+    if (prevHashExists || m_scanUnhashed) {
+        m_scannerGlobal->addListedDirectory(
+                dirLocation, m_dirAccess.info().locationPath(), mtimeMillis);
+    }
+
     // Process all of the sub-directories.
     for (const mixxx::FileInfo& dirInfo : dirsToScan) {
-        // Atomically test and mark the directory as scanned to avoid
-        // that the same directory is scanned multiple times by different
-        // tasks.
-        if (!m_scannerGlobal->testAndMarkDirectoryScanned(dirInfo.toQDir())) {
-            m_pScanner->queueTask(
-                    new RecursiveScanDirectoryTask(
-                            m_pScanner,
-                            m_scannerGlobal,
-                            mixxx::FileAccess(dirInfo, m_dirAccess.token()),
-                            m_scanUnhashed));
-        }
+        queueSubdirectoryTask(dirInfo);
     }
     setSuccess(true);
 }
+
+void RecursiveScanDirectoryTask::queueSubdirectoryTask(const mixxx::FileInfo& dirInfo) {
+    // Atomically test and mark the directory as scanned to avoid
+    // that the same directory is scanned multiple times by different
+    // tasks.
+    if (!m_scannerGlobal->testAndMarkDirectoryScanned(dirInfo.toQDir())) {
+        m_pScanner->queueTask(
+                new RecursiveScanDirectoryTask(
+                        m_pScanner,
+                        m_scannerGlobal,
+                        mixxx::FileAccess(dirInfo, m_dirAccess.token()),
+                        m_scanUnhashed));
+    }
+}
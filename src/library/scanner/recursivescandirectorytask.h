@@ -6,8 +6,10 @@
 /// Recursively scan a music library. Doesn't import tracks for any directories
 /// that have already been scanned and have not changed. Changes are tracked by
 /// performing a hash of the directory's file list, and those hashes are stored
-/// in the database. Successful if the scan completed without being
-/// cancelled. False if the scan was cancelled part-way through.
+/// in the database. During an incremental scan even listing the files is
+/// skipped for directories that have not been modified since the last scan.
+/// Successful if the scan completed without being cancelled. False if the scan
+/// was cancelled part-way through.
 class RecursiveScanDirectoryTask : public ScannerTask {
     Q_OBJECT
   public:
@@ -20,6 +22,8 @@ class RecursiveScanDirectoryTask : public ScannerTask {
     void run() override;
 
   private:
+    void queueSubdirectoryTask(const mixxx::FileInfo& dirInfo);
+
     const mixxx::FileAccess m_dirAccess;
     const bool m_scanUnhashed;
 };
@@ -1,13 +1,19 @@
 #pragma once
 
+#include <QDateTime>
 #include <QDir>
 #include <QHash>
+#include <QMultiHash>
 #include <QMutex>
 #include <QRegularExpression>
+#include <QSemaphore>
 #include <QSet>
 #include <QSharedPointer>
 #include <QStringList>
 
+#include "library/dao/libraryhashdao.h"
+#include "sources/soundsourceproxy.h"
+#include "util/assert.h"
 #include "util/cache.h"
 #include "util/compatibility/qmutex.h"
 #include "util/fileaccess.h"
@@ -16,20 +22,41 @@
 
 class ScannerGlobal {
   public:
+    typedef LibraryHashDAO::DirectoryMTime DirectoryMTime;
+
+    // Modification times that are closer to the time when a directory
+    // is listed are not trusted, because a subsequent modification
+    // might not change them on file systems with a coarse resolution.
+    static constexpr qint64 kMinTrustedMTimeAgeMillis = 2000;
+
+    // Limits the memory occupied by metadata and cover images that
+    // have been prefetched, but not yet added to the database.
+    static constexpr int kMaxPrefetchedTracks = 256;
+
     ScannerGlobal(const QSet<QString>& trackLocations,
             const QHash<QString, mixxx::cache_key_t>& directoryHashes,
             const QRegularExpression& supportedExtensionsMatcher,
             const QRegularExpression& supportedCoverExtensionsMatcher,
-            const QStringList& directoriesBlacklist)
+            const QStringList& directoriesBlacklist,
+            const QHash<QString, DirectoryMTime>& directoryMTimes = {},
+            bool skipUnmodifiedDirectories = false)
             : m_trackLocations(trackLocations),
               m_directoryHashes(directoryHashes),
+              m_directoryMTimes(directoryMTimes),
+              m_skipUnmodifiedDirectories(skipUnmodifiedDirectories),
               m_supportedExtensionsMatcher(supportedExtensionsMatcher),
               m_supportedCoverExtensionsMatcher(supportedCoverExtensionsMatcher),
               m_directoriesBlacklist(directoriesBlacklist),
               // Unless marked un-clean, we assume it will finish cleanly.
               m_scanFinishedCleanly(true),
               m_shouldCancel(false),
+              m_prefetchedTracksSemaphore(kMaxPrefetchedTracks),
               m_numScannedDirectories(0) {
+        for (auto it = m_directoryMTimes.constBegin();
+                it != m_directoryMTimes.constEnd();
+                ++it) {
+            m_knownSubdirectories.insert(it.value().parentPath, it.key());
+        }
     }
 
     TaskWatcher& getTaskWatcher() {
@@ -46,6 +73,81 @@ class ScannerGlobal {
         return m_directoryHashes.value(directoryPath, mixxx::invalidCacheKey());
     }
 
+    // Returns true if an incremental scan may skip listing the directory,
+    // because it has not been modified since it has been listed by the
+    // last scan. Only adding, removing, or renaming of files or
+    // subdirectories modifies a directory, which also covers all changes
+    // that affect the directory hash.
+    bool directoryUnmodified(const QString& directoryPath, qint64 mtimeMillis) const {
+        if (!m_skipUnmodifiedDirectories || mtimeMillis <= 0) {
+            return false;
+        }
+        const auto it = m_directoryMTimes.constFind(directoryPath);
+        return it != m_directoryMTimes.constEnd() && it.value().mtimeMillis == mtimeMillis;
+    }
+
+    // The subdirectories of an unmodified directory as listed by the last scan
+    QStringList knownSubdirectories(const QString& directoryPath) const {
+        return m_knownSubdirectories.values(directoryPath);
+    }
+
+    void addListedDirectory(const QString& directoryPath,
+            const QString& parentPath,
+            qint64 mtimeMillis) {
+        if (mtimeMillis >
+                QDateTime::currentMSecsSinceEpoch() - kMinTrustedMTimeAgeMillis) {
+            mtimeMillis = 0;
+        }
+        const auto locker = lockMutex(&m_visitedDirectoriesMutex);
+        m_listedDirectoryMTimes.insert(directoryPath, DirectoryMTime{parentPath, mtimeMillis});
+    }
+
+    void addUnmodifiedDirectory(const QString& directoryPath) {
+        const auto locker = lockMutex(&m_visitedDirectoriesMutex);
+        m_unmodifiedDirectories.insert(directoryPath);
+    }
+
+    int numUnmodifiedDirectories() const {
+        const auto locker = lockMutex(&m_visitedDirectoriesMutex);
+        return static_cast<int>(m_unmodifiedDirectories.size());
+    }
+
+    // The modification times of all directories that have been listed
+    // by this scan and differ from the last scan.
+    QHash<QString, DirectoryMTime> changedDirectoryMTimes() const {
+        // no need for locking here, because it is only used
+        // when only one using thread is around.
+        QHash<QString, DirectoryMTime> changedMTimes;
+        for (auto it = m_listedDirectoryMTimes.constBegin();
+                it != m_listedDirectoryMTimes.constEnd();
+                ++it) {
+            const auto previous = m_directoryMTimes.constFind(it.key());
+            if (previous == m_directoryMTimes.constEnd() ||
+                    previous.value().mtimeMillis != it.value().mtimeMillis ||
+                    previous.value().parentPath != it.value().parentPath) {
+                changedMTimes.insert(it.key(), it.value());
+            }
+        }
+        return changedMTimes;
+    }
+
+    // The directories of the last scan that have not been visited by
+    // this scan, i.e. that have been deleted or are no longer reachable.
+    QStringList unvisitedDirectories() const {
+        // no need for locking here, because it is only used
+        // when only one using thread is around.
+        QStringList dirPaths;
+        for (auto it = m_directoryMTimes.constBegin();
+                it != m_directoryMTimes.constEnd();
+                ++it) {
+            if (!m_listedDirectoryMTimes.contains(it.key()) &&
+                    !m_unmodifiedDirectories.contains(it.key())) {
+                dirPaths.append(it.key());
+            }
+        }
+        return dirPaths;
+    }
+
     bool directoryBlacklisted(const QString& directoryPath) const {
         return m_directoriesBlacklist.contains(directoryPath);
     }
@@ -94,6 +196,49 @@ class ScannerGlobal {
         return match.hasMatch();
     }
 
+    // Reserves the memory for prefetching the metadata of a track.
+    // Returns false if the limit has been reached.
+    bool tryReservePrefetchedTrack() {
+        return m_prefetchedTracksSemaphore.tryAcquire();
+    }
+
+    // Waits until the database writer has caught up. Returns false
+    // if the scan has been cancelled while waiting.
+    bool reservePrefetchedTrack() {
+        while (!m_prefetchedTracksSemaphore.tryAcquire(1, kPrefetchWaitMillis)) {
+            if (shouldCancel()) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void releasePrefetchedTrack() {
+        m_prefetchedTracksSemaphore.release();
+    }
+
+    // Requires a reservation that is released when taking the
+    // prefetched metadata.
+    void addPrefetchedTrack(const QString& trackLocation,
+            SoundSourceProxy::PrefetchedTrackMetadata prefetchedMetadata) {
+        const auto locker = lockMutex(&m_prefetchedTracksMutex);
+        DEBUG_ASSERT(!m_prefetchedTracks.contains(trackLocation));
+        m_prefetchedTracks.insert(trackLocation, std::move(prefetchedMetadata));
+    }
+
+    std::optional<SoundSourceProxy::PrefetchedTrackMetadata> takePrefetchedTrack(
+            const QString& trackLocation) {
+        const auto locker = lockMutex(&m_prefetchedTracksMutex);
+        const auto it = m_prefetchedTracks.find(trackLocation);
+        if (it == m_prefetchedTracks.end()) {
+            return std::nullopt;
+        }
+        auto prefetchedMetadata = std::move(it.value());
+        m_prefetchedTracks.erase(it);
+        m_prefetchedTracksSemaphore.release();
+        return prefetchedMetadata;
+    }
+
     bool shouldCancel() const {
         return m_shouldCancel;
     }
@@ -154,11 +299,23 @@ class ScannerGlobal {
     }
 
   private:
+    static constexpr int kPrefetchWaitMillis = 100;
+
     TaskWatcher m_watcher;
 
     QSet<QString> m_trackLocations;
     QHash<QString, mixxx::cache_key_t> m_directoryHashes;
 
+    // The directories listed by the last scan, read-only during the scan
+    const QHash<QString, DirectoryMTime> m_directoryMTimes;
+    QMultiHash<QString, QString> m_knownSubdirectories;
+    const bool m_skipUnmodifiedDirectories;
+
+    // The directories visited by this scan
+    mutable QMutex m_visitedDirectoriesMutex;
+    QHash<QString, DirectoryMTime> m_listedDirectoryMTimes;
+    QSet<QString> m_unmodifiedDirectories;
+
     mutable QMutex m_supportedExtensionsMatcherMutex;
     QRegularExpression m_supportedExtensionsMatcher;
 
@@ -194,6 +351,12 @@ class ScannerGlobal {
     volatile bool m_scanFinishedCleanly;
     volatile bool m_shouldCancel;
 
+    // Metadata that has been imported by the worker threads in parallel
+    // and is consumed when adding the tracks on the scanner thread.
+    QSemaphore m_prefetchedTracksSemaphore;
+    QMutex m_prefetchedTracksMutex;
+    QHash<QString, SoundSourceProxy::PrefetchedTrackMetadata> m_prefetchedTracks;
+
     // Stats tracking.
     PerformanceTimer m_timer;
     int m_numScannedDirectories;
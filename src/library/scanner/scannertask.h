@@ -23,7 +23,7 @@ class ScannerTask : public QObject, public QRunnable {
                                    bool newDirectory, mixxx::cache_key_t hash);
     void directoryUnchanged(const QString& directoryPath);
     void trackExists(const QString& filePath);
-    void addNewTrack(const QString& filePath);
+    void addNewTracks(const QStringList& filePaths);
 
     // Feedback to GUI
     void progressLoading(const QString& fileName);
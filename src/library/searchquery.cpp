@@ -1,6 +1,8 @@
 #include "library/searchquery.h"
 
 #include <QRegularExpression>
+#include <QSet>
+#include <algorithm>
 
 #include "library/dao/trackschema.h"
 #include "library/queryutil.h"
@@ -96,6 +98,33 @@ QString concatSqlClauses(
     }
 }
 
+const QStringList kFullTextSearchColumns = {
+        LIBRARYTABLE_ARTIST,
+        LIBRARYTABLE_ALBUMARTIST,
+        LIBRARYTABLE_ALBUM,
+        LIBRARYTABLE_TITLE,
+        LIBRARYTABLE_GENRE,
+        LIBRARYTABLE_COMPOSER,
+        LIBRARYTABLE_GROUPING,
+        LIBRARYTABLE_COMMENT,
+};
+
+bool containsWordPrefix(const QString& string, const QString& prefix) {
+    int index = string.indexOf(prefix);
+    while (index >= 0) {
+        if (index == 0 || !string[index - 1].isLetterOrNumber()) {
+            return true;
+        }
+        index = string.indexOf(prefix, index + 1);
+    }
+    return false;
+}
+
+// Same precision as in the generated SQL
+double sqlNumber(double value) {
+    return QString::number(value).toDouble();
+}
+
 } // namespace
 
 bool AndNode::match(const TrackPointer& pTrack) const {
@@ -109,6 +138,24 @@ bool AndNode::match(const TrackPointer& pTrack) const {
     return true;
 }
 
+bool AndNode::evaluate(const TrackSearchIndex& index,
+        TrackSearchIndex::Matches* pMatches) const {
+    // An empty AND node matches all tracks
+    pMatches->assign(index.rowCount(), TrackSearchIndex::Match::True);
+    TrackSearchIndex::Matches nodeMatches;
+    for (const auto& pNode : m_nodes) {
+        // Consistent with toSql() that omits empty expressions
+        if (pNode->toSql().isEmpty()) {
+            continue;
+        }
+        if (!pNode->evaluate(index, &nodeMatches)) {
+            return false;
+        }
+        TrackSearchIndex::matchAnd(nodeMatches, pMatches);
+    }
+    return true;
+}
+
 QString AndNode::toSql() const {
     QStringList queryFragments;
     queryFragments.reserve(static_cast<int>(m_nodes.size()));
@@ -138,6 +185,23 @@ bool OrNode::match(const TrackPointer& pTrack) const {
     return false;
 }
 
+bool OrNode::evaluate(const TrackSearchIndex& index,
+        TrackSearchIndex::Matches* pMatches) const {
+    pMatches->assign(index.rowCount(), TrackSearchIndex::Match::False);
+    TrackSearchIndex::Matches nodeMatches;
+    for (const auto& pNode : m_nodes) {
+        // Consistent with toSql() that omits empty expressions
+        if (pNode->toSql().isEmpty()) {
+            continue;
+        }
+        if (!pNode->evaluate(index, &nodeMatches)) {
+            return false;
+        }
+        TrackSearchIndex::matchOr(nodeMatches, pMatches);
+    }
+    return true;
+}
+
 QString OrNode::toSql() const {
     QStringList queryFragments;
     queryFragments.reserve(static_cast<int>(m_nodes.size()));
@@ -154,6 +218,15 @@ bool NotNode::match(const TrackPointer& pTrack) const {
     return !m_pNode->match(pTrack);
 }
 
+bool NotNode::evaluate(const TrackSearchIndex& index,
+        TrackSearchIndex::Matches* pMatches) const {
+    if (!m_pNode->evaluate(index, pMatches)) {
+        return false;
+    }
+    TrackSearchIndex::matchNot(pMatches);
+    return true;
+}
+
 QString NotNode::toSql() const {
     QString sql(m_pNode->toSql());
     if (sql.isEmpty()) {
@@ -186,21 +259,32 @@ bool TextFilterNode::match(const TrackPointer& pTrack) const {
 
         QString strValue = value.toString();
         mixxx::DbConnection::makeStringLatinLow(&strValue);
-        if (m_matchMode == StringMatch::Equals) {
+        // Using a switch-case without default case to get a compile-time -Wswitch warning
+        switch (m_matchMode) {
+        case StringMatch::Contains:
+            if (strValue.contains(m_argument)) {
+                return true;
+            }
+            break;
+        case StringMatch::Equals:
             if (strValue == m_argument) {
                 return true;
             }
-        } else {
-            if (strValue.contains(m_argument)) {
+            break;
+        case StringMatch::WordPrefix:
+            // Approximates the tokenizer of the full-text index
+            if (kFullTextSearchColumns.contains(sqlColumn)
+                            ? containsWordPrefix(strValue, m_argument.trimmed())
+                            : strValue.contains(m_argument)) {
                 return true;
             }
+            break;
         }
     }
     return false;
 }
 
-QString TextFilterNode::toSql() const {
-    FieldEscaper escaper(m_database);
+QString TextFilterNode::likePattern() const {
     QString argument = m_argument;
     if (argument.size() > 0) {
         if (argument[argument.size() - 1].isSpace()) {
@@ -209,24 +293,84 @@ QString TextFilterNode::toSql() const {
             argument.append('_');
         }
     }
-    QString escapedArgument;
     // Using a switch-case without default case to get a compile-time -Wswitch warning
     switch (m_matchMode) {
     case StringMatch::Contains:
-        escapedArgument = escaper.escapeString(
-                kSqlLikeMatchAll + argument + kSqlLikeMatchAll);
-        break;
+    case StringMatch::WordPrefix:
+        return kSqlLikeMatchAll + argument + kSqlLikeMatchAll;
     case StringMatch::Equals:
-        escapedArgument = escaper.escapeString(argument);
-        break;
+        return argument;
     }
-    QStringList searchClauses;
+    DEBUG_ASSERT(!"unreachable");
+    return argument;
+}
+
+QString TextFilterNode::fullTextSql(const QStringList& sqlColumns) const {
+    // Consecutive tokens are matched as a phrase and the last token as
+    // a prefix. Double quotes are escaped by doubling them.
+    QString phrase = m_argument.trimmed();
+    phrase.replace(QChar('"'), QStringLiteral("\"\""));
+    const QString matchExpression = QStringLiteral("{%1} : \"%2\"*")
+                                            .arg(sqlColumns.join(' '), phrase);
+    FieldEscaper escaper(m_database);
+    return QStringLiteral("%1 IN (SELECT rowid FROM %2 WHERE %2 MATCH %3)")
+            .arg(LIBRARYTABLE_ID,
+                    QStringLiteral(LIBRARY_FTS_TABLE),
+                    escaper.escapeString(matchExpression));
+}
+
+QString TextFilterNode::toSql() const {
+    QStringList likeColumns;
+    QStringList fullTextColumns;
+    // Without any letters or numbers the full-text query would be empty
+    const bool hasTokens = std::any_of(m_argument.begin(),
+            m_argument.end(),
+            [](QChar c) { return c.isLetterOrNumber(); });
     for (const auto& sqlColumn : m_sqlColumns) {
-        searchClauses << QString("%1 LIKE %2").arg(sqlColumn, escapedArgument);
+        if (m_matchMode == StringMatch::WordPrefix && hasTokens &&
+                kFullTextSearchColumns.contains(sqlColumn)) {
+            fullTextColumns << sqlColumn;
+        } else {
+            likeColumns << sqlColumn;
+        }
+    }
+
+    QStringList searchClauses;
+    if (!fullTextColumns.isEmpty()) {
+        searchClauses << fullTextSql(fullTextColumns);
+    }
+    if (!likeColumns.isEmpty()) {
+        FieldEscaper escaper(m_database);
+        const QString escapedArgument = escaper.escapeString(likePattern());
+        for (const auto& sqlColumn : std::as_const(likeColumns)) {
+            searchClauses << QString("%1 LIKE %2").arg(sqlColumn, escapedArgument);
+        }
     }
     return concatSqlClauses(searchClauses, "OR");
 }
 
+bool TextFilterNode::evaluate(const TrackSearchIndex& index,
+        TrackSearchIndex::Matches* pMatches) const {
+    if (m_matchMode == StringMatch::WordPrefix) {
+        // Only the database knows the tokens of the full-text index
+        return false;
+    }
+    for (const auto& sqlColumn : m_sqlColumns) {
+        if (!index.hasTextColumn(sqlColumn)) {
+            return false;
+        }
+    }
+    QString pattern = likePattern();
+    mixxx::DbConnection::makeStringLatinLow(&pattern);
+    pMatches->assign(index.rowCount(), TrackSearchIndex::Match::False);
+    TrackSearchIndex::Matches columnMatches;
+    for (const auto& sqlColumn : m_sqlColumns) {
+        index.matchLike(sqlColumn, pattern, &columnMatches);
+        TrackSearchIndex::matchOr(columnMatches, pMatches);
+    }
+    return true;
+}
+
 bool NullOrEmptyTextFilterNode::match(const TrackPointer& pTrack) const {
     if (!m_sqlColumns.isEmpty()) {
         // only use the major column
@@ -247,6 +391,16 @@ QString NullOrEmptyTextFilterNode::toSql() const {
     return QString();
 }
 
+bool NullOrEmptyTextFilterNode::evaluate(const TrackSearchIndex& index,
+        TrackSearchIndex::Matches* pMatches) const {
+    // only use the major column
+    if (m_sqlColumns.isEmpty() || !index.hasTextColumn(m_sqlColumns.first())) {
+        return false;
+    }
+    index.matchNullOrEmptyText(m_sqlColumns.first(), pMatches);
+    return true;
+}
+
 CrateFilterNode::CrateFilterNode(const CrateStorage* pCrateStorage,
         const QString& crateNameLike)
         : m_pCrateStorage(pCrateStorage),
@@ -254,18 +408,22 @@ CrateFilterNode::CrateFilterNode(const CrateStorage* pCrateStorage,
           m_matchInitialized(false) {
 }
 
-bool CrateFilterNode::match(const TrackPointer& pTrack) const {
-    if (!m_matchInitialized) {
-        CrateTrackSelectResult crateTracks(
-                m_pCrateStorage->selectTracksSortedByCrateNameLike(m_crateNameLike));
-
-        while (crateTracks.next()) {
-            m_matchingTrackIds.push_back(crateTracks.trackId());
-        }
+void CrateFilterNode::initMatchingTrackIds() const {
+    if (m_matchInitialized) {
+        return;
+    }
+    CrateTrackSelectResult crateTracks(
+            m_pCrateStorage->selectTracksSortedByCrateNameLike(m_crateNameLike));
 
-        m_matchInitialized = true;
+    while (crateTracks.next()) {
+        m_matchingTrackIds.push_back(crateTracks.trackId());
     }
 
+    m_matchInitialized = true;
+}
+
+bool CrateFilterNode::match(const TrackPointer& pTrack) const {
+    initMatchingTrackIds();
     return std::binary_search(m_matchingTrackIds.begin(), m_matchingTrackIds.end(), pTrack->getId());
 }
 
@@ -275,23 +433,41 @@ QString CrateFilterNode::toSql() const {
                     m_crateNameLike));
 }
 
+bool CrateFilterNode::evaluate(const TrackSearchIndex& index,
+        TrackSearchIndex::Matches* pMatches) const {
+    initMatchingTrackIds();
+    pMatches->resize(index.rowCount());
+    for (int row = 0; row < index.rowCount(); ++row) {
+        (*pMatches)[row] = std::binary_search(m_matchingTrackIds.begin(),
+                                   m_matchingTrackIds.end(),
+                                   index.trackId(row))
+                ? TrackSearchIndex::Match::True
+                : TrackSearchIndex::Match::False;
+    }
+    return true;
+}
+
 NoCrateFilterNode::NoCrateFilterNode(const CrateStorage* pCrateStorage)
         : m_pCrateStorage(pCrateStorage),
           m_matchInitialized(false) {
 }
 
-bool NoCrateFilterNode::match(const TrackPointer& pTrack) const {
-    if (!m_matchInitialized) {
-        TrackSelectResult tracks(
-                m_pCrateStorage->selectAllTracksSorted());
-
-        while (tracks.next()) {
-            m_matchingTrackIds.push_back(tracks.trackId());
-        }
+void NoCrateFilterNode::initMatchingTrackIds() const {
+    if (m_matchInitialized) {
+        return;
+    }
+    TrackSelectResult tracks(
+            m_pCrateStorage->selectAllTracksSorted());
 
-        m_matchInitialized = true;
+    while (tracks.next()) {
+        m_matchingTrackIds.push_back(tracks.trackId());
     }
 
+    m_matchInitialized = true;
+}
+
+bool NoCrateFilterNode::match(const TrackPointer& pTrack) const {
+    initMatchingTrackIds();
     return !std::binary_search(m_matchingTrackIds.begin(), m_matchingTrackIds.end(), pTrack->getId());
 }
 
@@ -301,6 +477,20 @@ QString NoCrateFilterNode::toSql() const {
                     CrateStorage::formatQueryForTrackIdsWithCrate());
 }
 
+bool NoCrateFilterNode::evaluate(const TrackSearchIndex& index,
+        TrackSearchIndex::Matches* pMatches) const {
+    initMatchingTrackIds();
+    pMatches->resize(index.rowCount());
+    for (int row = 0; row < index.rowCount(); ++row) {
+        (*pMatches)[row] = std::binary_search(m_matchingTrackIds.begin(),
+                                   m_matchingTrackIds.end(),
+                                   index.trackId(row))
+                ? TrackSearchIndex::Match::False
+                : TrackSearchIndex::Match::True;
+    }
+    return true;
+}
+
 NumericFilterNode::NumericFilterNode(const QStringList& sqlColumns)
         : m_sqlColumns(sqlColumns),
           m_bOperatorQuery(false),
@@ -416,6 +606,62 @@ QString NumericFilterNode::toSql() const {
     return QString();
 }
 
+bool NumericFilterNode::evaluate(const TrackSearchIndex& index,
+        TrackSearchIndex::Matches* pMatches) const {
+    for (const auto& sqlColumn : m_sqlColumns) {
+        if (!index.hasNumericColumn(sqlColumn)) {
+            return false;
+        }
+    }
+    if (m_bNullQuery) {
+        if (m_sqlColumns.isEmpty()) {
+            return false;
+        }
+        // only use the major column
+        index.matchNullNumeric(m_sqlColumns.first(), pMatches);
+        return true;
+    }
+
+    pMatches->assign(index.rowCount(), TrackSearchIndex::Match::False);
+    TrackSearchIndex::Matches columnMatches;
+    if (m_bOperatorQuery) {
+        const double argument = sqlNumber(m_dOperatorArgument);
+        const QString op = m_operator;
+        for (const auto& sqlColumn : m_sqlColumns) {
+            index.matchNumeric(
+                    sqlColumn,
+                    [argument, &op](double value) {
+                        return (op == "=" && value == argument) ||
+                                (op == "<" && value < argument) ||
+                                (op == ">" && value > argument) ||
+                                (op == "<=" && value <= argument) ||
+                                (op == ">=" && value >= argument);
+                    },
+                    &columnMatches);
+            TrackSearchIndex::matchOr(columnMatches, pMatches);
+        }
+        return true;
+    }
+
+    if (m_bRangeQuery) {
+        const double low = sqlNumber(m_dRangeLow);
+        const double high = sqlNumber(m_dRangeHigh);
+        for (const auto& sqlColumn : m_sqlColumns) {
+            index.matchNumeric(
+                    sqlColumn,
+                    [low, high](double value) {
+                        return value >= low && value <= high;
+                    },
+                    &columnMatches);
+            TrackSearchIndex::matchOr(columnMatches, pMatches);
+        }
+        return true;
+    }
+
+    // Nothing to evaluate, see toSql()
+    return false;
+}
+
 NullNumericFilterNode::NullNumericFilterNode(const QStringList& sqlColumns)
         : m_sqlColumns(sqlColumns) {
 }
@@ -439,6 +685,16 @@ QString NullNumericFilterNode::toSql() const {
     return QString();
 }
 
+bool NullNumericFilterNode::evaluate(const TrackSearchIndex& index,
+        TrackSearchIndex::Matches* pMatches) const {
+    // only use the major column
+    if (m_sqlColumns.isEmpty() || !index.hasNumericColumn(m_sqlColumns.first())) {
+        return false;
+    }
+    index.matchNullNumeric(m_sqlColumns.first(), pMatches);
+    return true;
+}
+
 DurationFilterNode::DurationFilterNode(
         const QStringList& sqlColumns, const QString& argument)
         : NumericFilterNode(sqlColumns) {
@@ -483,10 +739,35 @@ KeyFilterNode::KeyFilterNode(mixxx::track::io::key::ChromaticKey key,
     } else {
         m_matchKeys.push_back(key);
     }
+    for (const auto matchKey : std::as_const(m_matchKeys)) {
+        if (matchKey >= 0 && matchKey < static_cast<int>(m_keyMatches.size())) {
+            m_keyMatches[matchKey] = true;
+        }
+    }
 }
 
 bool KeyFilterNode::match(const TrackPointer& pTrack) const {
-    return m_matchKeys.contains(pTrack->getKey());
+    return matchesKey(pTrack->getKey());
+}
+
+bool KeyFilterNode::evaluate(const TrackSearchIndex& index,
+        TrackSearchIndex::Matches* pMatches) const {
+    if (!index.hasNumericColumn(LIBRARYTABLE_KEY_ID)) {
+        return false;
+    }
+    index.matchNumeric(
+            LIBRARYTABLE_KEY_ID,
+            [this](double value) {
+                return matchesKey(static_cast<int>(value));
+            },
+            pMatches);
+    // Comparing with IS never results in NULL
+    for (auto& match : *pMatches) {
+        if (match == TrackSearchIndex::Match::Null) {
+            match = TrackSearchIndex::Match::False;
+        }
+    }
+    return true;
 }
 
 QString KeyFilterNode::toSql() const {
@@ -5,9 +5,11 @@
 #include <QSqlDatabase>
 #include <QString>
 #include <QStringList>
+#include <array>
 #include <utility>
 #include <vector>
 
+#include "library/tracksearchindex.h"
 #include "proto/keys.pb.h"
 #include "track/track_decl.h"
 #include "util/assert.h"
@@ -21,6 +23,8 @@ const QString kMissingFieldSearchTerm = "\"\""; // "" searches for an empty stri
 enum class StringMatch {
     Contains = 0,
     Equals,
+    // Matches the beginning of words using the full-text index
+    WordPrefix,
 };
 
 class QueryNode {
@@ -31,6 +35,16 @@ class QueryNode {
     virtual bool match(const TrackPointer& pTrack) const = 0;
     virtual QString toSql() const = 0;
 
+    /// Evaluates the node for all tracks in the index with the same
+    /// results as the SQL expression returned by toSql(). Returns false
+    /// if the node can only be evaluated by the database.
+    virtual bool evaluate(const TrackSearchIndex& index,
+            TrackSearchIndex::Matches* pMatches) const {
+        Q_UNUSED(index);
+        Q_UNUSED(pMatches);
+        return false;
+    }
+
   protected:
     QueryNode() = default;
 };
@@ -53,12 +67,16 @@ class OrNode : public GroupNode {
   public:
     bool match(const TrackPointer& pTrack) const override;
     QString toSql() const override;
+    bool evaluate(const TrackSearchIndex& index,
+            TrackSearchIndex::Matches* pMatches) const override;
 };
 
 class AndNode : public GroupNode {
   public:
     bool match(const TrackPointer& pTrack) const override;
     QString toSql() const override;
+    bool evaluate(const TrackSearchIndex& index,
+            TrackSearchIndex::Matches* pMatches) const override;
 };
 
 class NotNode : public QueryNode {
@@ -70,6 +88,8 @@ class NotNode : public QueryNode {
 
     bool match(const TrackPointer& pTrack) const override;
     QString toSql() const override;
+    bool evaluate(const TrackSearchIndex& index,
+            TrackSearchIndex::Matches* pMatches) const override;
 
   private:
     std::unique_ptr<QueryNode> m_pNode;
@@ -84,8 +104,13 @@ class TextFilterNode : public QueryNode {
 
     bool match(const TrackPointer& pTrack) const override;
     QString toSql() const override;
+    bool evaluate(const TrackSearchIndex& index,
+            TrackSearchIndex::Matches* pMatches) const override;
 
   private:
+    QString likePattern() const;
+    QString fullTextSql(const QStringList& sqlColumns) const;
+
     QSqlDatabase m_database;
     QStringList m_sqlColumns;
     QString m_argument;
@@ -102,6 +127,8 @@ class NullOrEmptyTextFilterNode : public QueryNode {
 
     bool match(const TrackPointer& pTrack) const override;
     QString toSql() const override;
+    bool evaluate(const TrackSearchIndex& index,
+            TrackSearchIndex::Matches* pMatches) const override;
 
   private:
     QSqlDatabase m_database;
@@ -115,8 +142,12 @@ class CrateFilterNode : public QueryNode {
 
     bool match(const TrackPointer& pTrack) const override;
     QString toSql() const override;
+    bool evaluate(const TrackSearchIndex& index,
+            TrackSearchIndex::Matches* pMatches) const override;
 
   private:
+    void initMatchingTrackIds() const;
+
     const CrateStorage* m_pCrateStorage;
     QString m_crateNameLike;
     mutable bool m_matchInitialized;
@@ -129,8 +160,12 @@ class NoCrateFilterNode : public QueryNode {
 
     bool match(const TrackPointer& pTrack) const override;
     QString toSql() const override;
+    bool evaluate(const TrackSearchIndex& index,
+            TrackSearchIndex::Matches* pMatches) const override;
 
   private:
+    void initMatchingTrackIds() const;
+
     const CrateStorage* m_pCrateStorage;
     QString m_crateNameLike;
     mutable bool m_matchInitialized;
@@ -143,6 +178,8 @@ class NumericFilterNode : public QueryNode {
 
     bool match(const TrackPointer& pTrack) const override;
     QString toSql() const override;
+    bool evaluate(const TrackSearchIndex& index,
+            TrackSearchIndex::Matches* pMatches) const override;
 
   protected:
     // Single argument constructor for that does not call init()
@@ -172,6 +209,8 @@ class NullNumericFilterNode : public QueryNode {
 
     bool match(const TrackPointer& pTrack) const override;
     QString toSql() const override;
+    bool evaluate(const TrackSearchIndex& index,
+            TrackSearchIndex::Matches* pMatches) const override;
 
     QStringList m_sqlColumns;
 };
@@ -190,9 +229,18 @@ class KeyFilterNode : public QueryNode {
 
     bool match(const TrackPointer& pTrack) const override;
     QString toSql() const override;
+    bool evaluate(const TrackSearchIndex& index,
+            TrackSearchIndex::Matches* pMatches) const override;
 
   private:
+    bool matchesKey(int key) const {
+        return key >= 0 && key < static_cast<int>(m_keyMatches.size()) &&
+                m_keyMatches[key];
+    }
+
     QList<mixxx::track::io::key::ChromaticKey> m_matchKeys;
+    // Indexed by ChromaticKey for a constant time lookup per track
+    std::array<bool, mixxx::track::io::key::ChromaticKey_ARRAYSIZE> m_keyMatches{};
 };
 
 class SqlNode : public QueryNode {
@@ -223,6 +271,15 @@ class YearFilterNode : public NumericFilterNode {
   public:
     YearFilterNode(const QStringList& sqlColumns, const QString& argument);
     QString toSql() const override;
+
+    // The year is stored as text and is only partially compared as
+    // a number by the database
+    bool evaluate(const TrackSearchIndex& index,
+            TrackSearchIndex::Matches* pMatches) const override {
+        Q_UNUSED(index);
+        Q_UNUSED(pMatches);
+        return false;
+    }
 };
 
 #endif /* SEARCHQUERY_H */
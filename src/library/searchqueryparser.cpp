@@ -60,6 +60,14 @@ constexpr char kFuzzyPrefix[] = "~";
 const QRegularExpression kSplitIntoWordsRegexp = QRegularExpression(
         QStringLiteral(" (?=[^\"]*(\"[^\"]*\"[^\"]*)*$)"));
 
+//static
+bool SearchQueryParser::s_fullTextSearchEnabled = kFullTextSearchEnabledDefault;
+
+//static
+void SearchQueryParser::setFullTextSearchEnabled(bool fullTextSearchEnabled) {
+    s_fullTextSearchEnabled = fullTextSearchEnabled;
+}
+
 SearchQueryParser::SearchQueryParser(TrackCollection* pTrackCollection, QStringList searchColumns)
         : m_pTrackCollection(pTrackCollection),
           m_searchCrates(false) {
@@ -158,6 +166,9 @@ SearchQueryParser::TextArgumentResult SearchQueryParser::getTextArgument(QString
                 ? StringMatch::Equals
                 : StringMatch::Contains;
     }
+    if (mode == StringMatch::Contains && s_fullTextSearchEnabled) {
+        mode = StringMatch::WordPrefix;
+    }
     return {argument, mode};
 }
 
@@ -261,7 +272,7 @@ void SearchQueryParser::parseTokens(QStringList tokens,
             }
             // Don't trigger on a lone minus sign.
             if (!token.isEmpty()) {
-                QString argument = getTextArgument(token, &tokens).argument;
+                auto [argument, matchMode] = getTextArgument(token, &tokens);
                 // For untagged strings we search the track fields as well
                 // as the crate names the track is in. This allows the user
                 // to use crates like tags
@@ -270,11 +281,17 @@ void SearchQueryParser::parseTokens(QStringList tokens,
                     gNode->addNode(std::make_unique<CrateFilterNode>(
                                     &m_pTrackCollection->crates(), argument));
                     gNode->addNode(std::make_unique<TextFilterNode>(
-                            m_pTrackCollection->database(), m_queryColumns, argument));
+                            m_pTrackCollection->database(),
+                            m_queryColumns,
+                            argument,
+                            matchMode));
                     pNode = std::move(gNode);
                 } else {
                     pNode = std::make_unique<TextFilterNode>(
-                            m_pTrackCollection->database(), m_queryColumns, argument);
+                            m_pTrackCollection->database(),
+                            m_queryColumns,
+                            argument,
+                            matchMode);
                 }
             }
         }
@@ -15,6 +15,14 @@ class SearchQueryParser {
   public:
     explicit SearchQueryParser(TrackCollection* pTrackCollection, QStringList searchColumns);
 
+    static constexpr bool kFullTextSearchEnabledDefault = false;
+    /// Match text with the full-text index of the library instead of
+    /// searching for substrings. Only the beginnings of words are matched.
+    static void setFullTextSearchEnabled(bool fullTextSearchEnabled);
+    static bool isFullTextSearchEnabled() {
+        return s_fullTextSearchEnabled;
+    }
+
     void setSearchColumns(QStringList searchColumns);
 
     std::unique_ptr<QueryNode> parseQuery(
@@ -27,6 +35,8 @@ class SearchQueryParser {
     static bool queryIsLessSpecific(const QString& original, const QString& changed);
 
   private:
+    static bool s_fullTextSearchEnabled;
+
     void parseTokens(QStringList tokens,
                      AndNode* pQuery) const;
 
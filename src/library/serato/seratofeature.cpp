@@ -1,6 +1,7 @@
 #include "library/serato/seratofeature.h"
 
 #include <QMap>
+#include <QMetaObject>
 #include <QTextCodec>
 #include <QtConcurrent>
 #include <QtDebug>
@@ -88,9 +89,13 @@ const QString kSmartCrateFilter = QStringLiteral("*.scrate");
 const QString kSeratoLibraryTable = QStringLiteral("serato_library");
 const QString kSeratoPlaylistsTable = QStringLiteral("serato_playlists");
 const QString kSeratoPlaylistTracksTable = QStringLiteral("serato_playlist_tracks");
+const QString kSeratoImportedFilesTable = QStringLiteral("serato_imported_files");
 
 constexpr int kHeaderSize = 2 * sizeof(quint32);
 
+// The progress is reported after this many tracks
+constexpr int kProgressTrackInterval = 500;
+
 int createPlaylist(const QSqlDatabase& database, const QString& name, const QString& databasePath) {
     QSqlQuery query(database);
     query.prepare(
@@ -107,6 +112,103 @@ int createPlaylist(const QSqlDatabase& database, const QString& name, const QStr
     return query.lastInsertId().toInt();
 }
 
+// Removes the playlist and its tracks
+void deletePlaylist(const QSqlDatabase& database, int playlistId) {
+    QSqlQuery deleteTracksQuery(database);
+    deleteTracksQuery.prepare("DELETE FROM " + kSeratoPlaylistTracksTable +
+            " WHERE playlist_id=:playlist_id");
+    deleteTracksQuery.bindValue(":playlist_id", playlistId);
+    if (!deleteTracksQuery.exec()) {
+        LOG_FAILED_QUERY(deleteTracksQuery) << "playlistId: " << playlistId;
+    }
+
+    QSqlQuery deletePlaylistQuery(database);
+    deletePlaylistQuery.prepare("DELETE FROM " + kSeratoPlaylistsTable + " WHERE id=:id");
+    deletePlaylistQuery.bindValue(":id", playlistId);
+    if (!deletePlaylistQuery.exec()) {
+        LOG_FAILED_QUERY(deletePlaylistQuery) << "playlistId: " << playlistId;
+    }
+}
+
+// Returns the ids of the playlists of a Serato database by their name
+QHash<QString, int> findPlaylists(const QSqlDatabase& database, const QString& databasePath) {
+    QHash<QString, int> playlistIds;
+    QSqlQuery query(database);
+    query.prepare("SELECT id, name FROM " + kSeratoPlaylistsTable +
+            " WHERE serato_db=:serato_db");
+    query.bindValue(":serato_db", databasePath);
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query) << "databasePath: " << databasePath;
+        return playlistIds;
+    }
+    while (query.next()) {
+        playlistIds.insert(query.value(1).toString(), query.value(0).toInt());
+    }
+    return playlistIds;
+}
+
+// The rows that have been imported from a file are reused as long as its
+// size and modification time do not change
+bool isFileImported(const QSqlDatabase& database, const QString& filePath) {
+    const QFileInfo fileInfo(filePath);
+    QSqlQuery query(database);
+    query.prepare("SELECT size, last_modified FROM " + kSeratoImportedFilesTable +
+            " WHERE path=:path");
+    query.bindValue(":path", filePath);
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query) << "filePath: " << filePath;
+        return false;
+    }
+    return query.next() &&
+            query.value(0).toLongLong() == fileInfo.size() &&
+            query.value(1).toLongLong() == fileInfo.lastModified().toMSecsSinceEpoch();
+}
+
+void setFileImported(const QSqlDatabase& database, const QString& filePath) {
+    const QFileInfo fileInfo(filePath);
+    QSqlQuery query(database);
+    query.prepare("INSERT OR REPLACE INTO " + kSeratoImportedFilesTable +
+            " (path, size, last_modified) VALUES (:path, :size, :last_modified)");
+    query.bindValue(":path", filePath);
+    query.bindValue(":size", fileInfo.size());
+    query.bindValue(":last_modified", fileInfo.lastModified().toMSecsSinceEpoch());
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query) << "filePath: " << filePath;
+    }
+}
+
+void bindTrack(QSqlQuery& query,
+        const serato_track_t& track,
+        const QString& location,
+        const QString& databasePath) {
+    query.bindValue(":title", track.title);
+    query.bindValue(":artist", track.artist);
+    query.bindValue(":album", track.album);
+    query.bindValue(":genre", track.genre);
+    query.bindValue(":comment", track.comment);
+    query.bindValue(":grouping", track.grouping);
+    query.bindValue(":year", track.year);
+    query.bindValue(":duration", track.duration);
+    query.bindValue(":bitrate", track.bitrate);
+    query.bindValue(":samplerate", track.samplerate);
+    query.bindValue(":bpm", track.bpm);
+    query.bindValue(":key", track.key);
+    query.bindValue(":location", location);
+    query.bindValue(":bpm_lock", track.beatgridlocked);
+    query.bindValue(":datetime_added", track.datetimeadded);
+    query.bindValue(":label", track.label);
+    query.bindValue(":serato_db", databasePath);
+}
+
+void reportImportProgress(SeratoFeature* pFeature, int percent) {
+    QMetaObject::invokeMethod(
+            pFeature,
+            [pFeature, percent] {
+                pFeature->onDatabaseImportProgress(percent);
+            },
+            Qt::QueuedConnection);
+}
+
 int insertTrackIntoPlaylist(const QSqlDatabase& database, int playlistId, int trackId, int position) {
     QSqlQuery query(database);
     query.prepare(
@@ -330,7 +432,8 @@ QString parseCrate(
         const QSqlDatabase& database,
         const QString& databasePath,
         const QString& crateFilePath,
-        const QMap<QString, int>& trackIdMap) {
+        const QDir& databaseRootDir,
+        const QHash<QString, int>& trackIdMap) {
     QString crateName = QFileInfo(crateFilePath).baseName();
     qDebug() << "Parsing crate"
              << crateName
@@ -392,7 +495,8 @@ QString parseCrate(
             buffer.open(QIODevice::ReadOnly);
             QString location = parseCrateTrackPath(&buffer);
             if (!location.isEmpty()) {
-                int trackId = trackIdMap.value(location, -1);
+                int trackId = trackIdMap.value(
+                        databaseRootDir.absoluteFilePath(location), -1);
                 insertTrackIntoPlaylist(database, playlistId, trackId, trackCount);
                 trackCount++;
                 break;
@@ -425,7 +529,9 @@ QString parseCrate(
     return crateName;
 }
 
-QString parseDatabase(mixxx::DbConnectionPoolPtr dbConnectionPool, TreeItem* databaseItem) {
+QString parseDatabase(mixxx::DbConnectionPoolPtr dbConnectionPool,
+        SeratoFeature* pFeature,
+        TreeItem* databaseItem) {
     QString databaseName = databaseItem->getLabel();
     QString databaseFilePath = databaseItem->getData().toList()[0].toString();
     QDir databaseDir = QFileInfo(databaseFilePath).dir();
@@ -525,6 +631,29 @@ QString parseDatabase(mixxx::DbConnectionPoolPtr dbConnectionPool, TreeItem* dat
             ":serato_db"
             ")");
 
+    QSqlQuery updateQuery(database);
+    updateQuery.prepare(
+            "UPDATE " +
+            kSeratoLibraryTable + " SET " +
+            LIBRARYTABLE_TITLE + "=:title, " +
+            LIBRARYTABLE_ARTIST + "=:artist, " +
+            LIBRARYTABLE_ALBUM + "=:album, " +
+            LIBRARYTABLE_GENRE + "=:genre, " +
+            LIBRARYTABLE_COMMENT + "=:comment, " +
+            LIBRARYTABLE_GROUPING + "=:grouping, " +
+            LIBRARYTABLE_YEAR + "=:year, " +
+            LIBRARYTABLE_DURATION + "=:duration, " +
+            LIBRARYTABLE_BITRATE + "=:bitrate, " +
+            LIBRARYTABLE_SAMPLERATE + "=:samplerate, " +
+            LIBRARYTABLE_BPM + "=:bpm, " +
+            LIBRARYTABLE_KEY + "=:key, " +
+            TRACKLOCATIONSTABLE_LOCATION + "=:location, " +
+            LIBRARYTABLE_BPM_LOCK + "=:bpm_lock, " +
+            LIBRARYTABLE_DATETIMEADDED + "=:datetime_added, "
+            "label=:label, "
+            "serato_db=:serato_db "
+            "WHERE id=:id");
+
     mixxx::FileInfo fileInfo(databaseFilePath);
     QFile databaseFile(databaseFilePath);
     if (!Sandbox::askForAccess(&fileInfo) || !databaseFile.open(QIODevice::ReadOnly)) {
@@ -534,99 +663,161 @@ QString parseDatabase(mixxx::DbConnectionPoolPtr dbConnectionPool, TreeItem* dat
         return QString();
     }
 
-    int playlistId = createPlaylist(database, databaseFilePath, databaseDir.path());
-    if (playlistId < 0) {
-        qWarning() << "Failed to create library playlist for "
-                   << databaseFilePath;
-        return QString();
+    const QString databasePath = databaseDir.path();
+
+    // The tracks and crates of a previous import are only updated with the
+    // differences of the files that have been modified since then
+    QHash<QString, int> playlistIds = findPlaylists(database, databasePath);
+    int playlistId = playlistIds.value(databaseFilePath, -1);
+    playlistIds.remove(databaseFilePath);
+    const bool databaseUnchanged = playlistId >= 0 &&
+            isFileImported(database, databaseFilePath);
+
+    // The ids of the imported tracks by their absolute location
+    QHash<QString, int> trackIdMap;
+    QSet<int> staleTrackIds;
+    QSqlQuery trackIdsQuery(database);
+    trackIdsQuery.prepare("SELECT id, " + TRACKLOCATIONSTABLE_LOCATION +
+            " FROM " + kSeratoLibraryTable + " WHERE serato_db=:serato_db");
+    trackIdsQuery.bindValue(":serato_db", databasePath);
+    if (!trackIdsQuery.exec()) {
+        LOG_FAILED_QUERY(trackIdsQuery) << "databasePath: " << databasePath;
+    }
+    while (trackIdsQuery.next()) {
+        const int trackId = trackIdsQuery.value(0).toInt();
+        trackIdMap.insert(trackIdsQuery.value(1).toString(), trackId);
+        staleTrackIds.insert(trackId);
     }
 
-    int trackCount = 0;
-    QMap<QString, int> trackIdMap;
-    QByteArray headerData = databaseFile.read(kHeaderSize);
-    while (headerData.length() == kHeaderSize) {
-        quint32 fieldId = bytesToUInt32(headerData.mid(0, sizeof(quint32)));
-        quint32 fieldSize = bytesToUInt32(headerData.mid(sizeof(quint32), kHeaderSize));
-
-        // Read field data
-        QByteArray data = databaseFile.read(fieldSize);
-        if (static_cast<quint32>(data.length()) != fieldSize) {
-            QString fieldName = QString(headerData.mid(0, sizeof(quint32)));
-            qWarning() << "Failed to read "
-                       << fieldSize
-                       << " bytes for "
-                       << fieldName
-                       << " field from "
-                       << databaseFilePath
-                       << ".";
+    if (databaseUnchanged) {
+        qDebug() << "Serato database" << databaseFilePath
+                 << "is unchanged, reusing the imported tracks";
+    } else {
+        if (playlistId >= 0) {
+            // Recreate the library playlist in the current order
+            deletePlaylist(database, playlistId);
+        }
+        playlistId = createPlaylist(database, databaseFilePath, databasePath);
+        if (playlistId < 0) {
+            qWarning() << "Failed to create library playlist for "
+                       << databaseFilePath;
             return QString();
         }
 
-        // Parse field data
-        switch (static_cast<FieldId>(fieldId)) {
-        case FieldId::Version: {
-            QString version = utf16beToQString(data, fieldSize);
-            qDebug() << "Serato Database Version: "
-                     << version;
-            break;
-        }
-        case FieldId::Track: {
-            serato_track_t track;
-            QBuffer buffer(&data);
-            buffer.open(QIODevice::ReadOnly);
-            if (parseTrack(&track, &buffer)) {
-                QString location = databaseRootDir.absoluteFilePath(track.location);
-                query.bindValue(":title", track.title);
-                query.bindValue(":artist", track.artist);
-                query.bindValue(":album", track.album);
-                query.bindValue(":genre", track.genre);
-                query.bindValue(":comment", track.comment);
-                query.bindValue(":grouping", track.grouping);
-                query.bindValue(":year", track.year);
-                query.bindValue(":duration", track.duration);
-                query.bindValue(":bitrate", track.bitrate);
-                query.bindValue(":samplerate", track.samplerate);
-                query.bindValue(":bpm", track.bpm);
-                query.bindValue(":key", track.key);
-                query.bindValue(":location", location);
-                query.bindValue(":bpm_lock", track.beatgridlocked);
-                query.bindValue(":datetime_added", track.datetimeadded);
-                query.bindValue(":label", track.label);
-                query.bindValue(":serato_db", databaseDir.path());
-
-                if (!query.exec()) {
-                    LOG_FAILED_QUERY(query);
-                } else {
-                    int trackId = query.lastInsertId().toInt();
-                    insertTrackIntoPlaylist(database, playlistId, trackId, trackCount);
-                    trackIdMap.insert(track.location, trackId);
-                    trackCount++;
+        const qint64 databaseFileSize = databaseFile.size();
+        int trackCount = 0;
+        QByteArray headerData = databaseFile.read(kHeaderSize);
+        while (headerData.length() == kHeaderSize) {
+            quint32 fieldId = bytesToUInt32(headerData.mid(0, sizeof(quint32)));
+            quint32 fieldSize = bytesToUInt32(headerData.mid(sizeof(quint32), kHeaderSize));
+
+            // Read field data
+            QByteArray data = databaseFile.read(fieldSize);
+            if (static_cast<quint32>(data.length()) != fieldSize) {
+                QString fieldName = QString(headerData.mid(0, sizeof(quint32)));
+                qWarning() << "Failed to read "
+                           << fieldSize
+                           << " bytes for "
+                           << fieldName
+                           << " field from "
+                           << databaseFilePath
+                           << ".";
+                return QString();
+            }
+
+            // Parse field data
+            switch (static_cast<FieldId>(fieldId)) {
+            case FieldId::Version: {
+                QString version = utf16beToQString(data, fieldSize);
+                qDebug() << "Serato Database Version: "
+                         << version;
+                break;
+            }
+            case FieldId::Track: {
+                serato_track_t track;
+                QBuffer buffer(&data);
+                buffer.open(QIODevice::ReadOnly);
+                if (parseTrack(&track, &buffer)) {
+                    QString location = databaseRootDir.absoluteFilePath(track.location);
+                    // Tracks that have been imported before are updated in place,
+                    // such that their ids remain valid
+                    int trackId = trackIdMap.value(location, -1);
+                    QSqlQuery& trackQuery = trackId >= 0 ? updateQuery : query;
+                    bindTrack(trackQuery, track, location, databasePath);
+                    if (trackId >= 0) {
+                        trackQuery.bindValue(":id", trackId);
+                    }
+
+                    if (!trackQuery.exec()) {
+                        LOG_FAILED_QUERY(trackQuery);
+                    } else {
+                        if (trackId < 0) {
+                            trackId = trackQuery.lastInsertId().toInt();
+                            trackIdMap.insert(location, trackId);
+                        }
+                        staleTrackIds.remove(trackId);
+                        insertTrackIntoPlaylist(database, playlistId, trackId, trackCount);
+                        trackCount++;
+                        if (trackCount % kProgressTrackInterval == 0 && databaseFileSize > 0) {
+                            reportImportProgress(pFeature,
+                                    static_cast<int>(databaseFile.pos() * 100 /
+                                            databaseFileSize));
+                        }
+                    }
+                    break;
                 }
                 break;
             }
-            break;
-        }
-        default: {
-            QString fieldName = QString(headerData.mid(0, sizeof(quint32)));
-            qDebug() << "Ignoring unknown field "
-                     << fieldName
-                     << " ("
-                     << fieldSize
-                     << " bytes) in database "
-                     << databaseFilePath
-                     << ".";
+            default: {
+                QString fieldName = QString(headerData.mid(0, sizeof(quint32)));
+                qDebug() << "Ignoring unknown field "
+                         << fieldName
+                         << " ("
+                         << fieldSize
+                         << " bytes) in database "
+                         << databaseFilePath
+                         << ".";
+            }
+            }
+
+            headerData = databaseFile.read(kHeaderSize);
         }
+
+        if (headerData.length() != 0) {
+            qWarning() << "Found "
+                       << headerData.length()
+                       << " extra bytes at end of Serato database file "
+                       << databaseFilePath
+                       << ".";
         }
 
-        headerData = databaseFile.read(kHeaderSize);
-    }
+        // Remove the tracks that are no longer in the database
+        QSqlQuery deletePlaylistTracksQuery(database);
+        deletePlaylistTracksQuery.prepare("DELETE FROM " + kSeratoPlaylistTracksTable +
+                " WHERE track_id=:track_id");
+        QSqlQuery deleteTrackQuery(database);
+        deleteTrackQuery.prepare("DELETE FROM " + kSeratoLibraryTable + " WHERE id=:id");
+        for (const int trackId : std::as_const(staleTrackIds)) {
+            deletePlaylistTracksQuery.bindValue(":track_id", trackId);
+            if (!deletePlaylistTracksQuery.exec()) {
+                LOG_FAILED_QUERY(deletePlaylistTracksQuery);
+            }
+            deleteTrackQuery.bindValue(":id", trackId);
+            if (!deleteTrackQuery.exec()) {
+                LOG_FAILED_QUERY(deleteTrackQuery);
+            }
+        }
+        for (auto it = trackIdMap.begin(); it != trackIdMap.end();) {
+            if (staleTrackIds.contains(it.value())) {
+                it = trackIdMap.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        qDebug() << "Imported" << trackCount << "tracks from Serato database"
+                 << databaseFilePath << "," << staleTrackIds.size() << "removed";
 
-    if (headerData.length() != 0) {
-        qWarning() << "Found "
-                   << headerData.length()
-                   << " extra bytes at end of Serato database file "
-                   << databaseFilePath
-                   << ".";
+        setFileImported(database, databaseFilePath);
     }
 
     // Parse Crates
@@ -637,11 +828,29 @@ QString parseDatabase(mixxx::DbConnectionPoolPtr dbConnectionPool, TreeItem* dat
         const auto entryList = crateDir.entryList(filters);
         for (const QString& entry : entryList) {
             QString crateFilePath = crateDir.filePath(entry);
-            QString crateName = parseCrate(
-                    database,
-                    databaseDir.path(),
-                    crateFilePath,
-                    trackIdMap);
+            const int cratePlaylistId = playlistIds.value(crateFilePath, -1);
+            playlistIds.remove(crateFilePath);
+
+            // A crate refers to the tracks of the database by their location,
+            // it is parsed again if either of them has been modified
+            QString crateName;
+            if (databaseUnchanged && cratePlaylistId >= 0 &&
+                    isFileImported(database, crateFilePath)) {
+                crateName = QFileInfo(crateFilePath).baseName();
+            } else {
+                if (cratePlaylistId >= 0) {
+                    deletePlaylist(database, cratePlaylistId);
+                }
+                crateName = parseCrate(
+                        database,
+                        databasePath,
+                        crateFilePath,
+                        databaseRootDir,
+                        trackIdMap);
+                if (!crateName.isEmpty()) {
+                    setFileImported(database, crateFilePath);
+                }
+            }
             if (!crateName.isEmpty()) {
                 TreeItem* crateItem = databaseItem->appendChild(crateName,
                         QList<QVariant>{
@@ -654,6 +863,11 @@ QString parseDatabase(mixxx::DbConnectionPoolPtr dbConnectionPool, TreeItem* dat
                    << databaseDir.filePath(kCrateDirectory);
     }
 
+    // The remaining playlists belong to crates that have been deleted
+    for (const int cratePlaylistId : std::as_const(playlistIds)) {
+        deletePlaylist(database, cratePlaylistId);
+    }
+
     // TODO: Parse Smart Crates
 
     transaction.commit();
@@ -822,11 +1036,17 @@ bool createPlaylistTracksTable(QSqlDatabase& database, const QString& tableName)
     return true;
 }
 
-bool dropTable(QSqlDatabase& database, const QString& tableName) {
-    qDebug() << "Dropping Serato table: " << tableName;
+bool createImportedFilesTable(QSqlDatabase& database, const QString& tableName) {
+    qDebug() << "Creating Serato imported files table: " << tableName;
 
     QSqlQuery query(database);
-    query.prepare("DROP TABLE IF EXISTS " + tableName);
+    query.prepare(
+            "CREATE TABLE IF NOT EXISTS " + tableName +
+            " ("
+            "    path TEXT PRIMARY KEY,"
+            "    size INTEGER,"
+            "    last_modified INTEGER"
+            ");");
 
     if (!query.exec()) {
         LOG_FAILED_QUERY(query);
@@ -884,15 +1104,12 @@ SeratoFeature::SeratoFeature(
 
     QSqlDatabase database = m_pTrackCollection->database();
     ScopedTransaction transaction(database);
-    // Drop any leftover temporary Serato database tables if they exist
-    dropTable(database, kSeratoPlaylistTracksTable);
-    dropTable(database, kSeratoPlaylistsTable);
-    dropTable(database, kSeratoLibraryTable);
-
-    // Create new temporary Serato database tables
+    // The imported Serato databases are kept between sessions and only
+    // updated when their files have been modified
     createLibraryTable(database, kSeratoLibraryTable);
     createPlaylistsTable(database, kSeratoPlaylistsTable);
     createPlaylistTracksTable(database, kSeratoPlaylistTracksTable);
+    createImportedFilesTable(database, kSeratoImportedFilesTable);
     transaction.commit();
 
     connect(&m_databasesFutureWatcher,
@@ -912,14 +1129,6 @@ SeratoFeature::~SeratoFeature() {
     m_databasesFuture.waitForFinished();
     m_tracksFuture.waitForFinished();
 
-    // Drop temporary Serato database tables on shutdown
-    QSqlDatabase database = m_pTrackCollection->database();
-    ScopedTransaction transaction(database);
-    dropTable(database, kSeratoPlaylistTracksTable);
-    dropTable(database, kSeratoPlaylistsTable);
-    dropTable(database, kSeratoLibraryTable);
-    transaction.commit();
-
     delete m_pSeratoPlaylistModel;
 }
 
@@ -1034,8 +1243,13 @@ void SeratoFeature::activateChild(const QModelIndex& index) {
 
     if (!isPlaylist) {
         // Let a worker thread do the parsing
-        m_tracksFuture = QtConcurrent::run(parseDatabase, static_cast<Library*>(parent())->dbConnectionPool(), item);
+        m_tracksFuture = QtConcurrent::run(parseDatabase,
+                static_cast<Library*>(parent())->dbConnectionPool(),
+                this,
+                item);
         m_tracksFutureWatcher.setFuture(m_tracksFuture);
+        m_title = tr("(loading) Serato");
+        emit featureIsLoading(this, false);
 
         // This device is now a playlist element, future activations should
         // treat is as such
@@ -1109,9 +1323,16 @@ void SeratoFeature::onSeratoDatabasesFound() {
     emit featureLoadingFinished(this);
 }
 
+void SeratoFeature::onDatabaseImportProgress(int percent) {
+    m_title = tr("(loading) Serato %1%").arg(percent);
+    emit featureIsLoading(this, false);
+}
+
 void SeratoFeature::onTracksFound() {
     qDebug() << "onTracksFound";
     m_pSidebarModel->triggerRepaint();
+    m_title = tr("Serato");
+    emit featureIsLoading(this, false);
 
     QString databasePlaylist = m_tracksFuture.result();
 
@@ -39,6 +39,8 @@ class SeratoFeature : public BaseExternalLibraryFeature {
     void refreshLibraryModels();
     void onSeratoDatabasesFound();
     void onTracksFound();
+    /// Called from the worker thread with a queued connection
+    void onDatabaseImportProgress(int percent);
 
   private slots:
     void htmlLinkClicked(const QUrl& link);
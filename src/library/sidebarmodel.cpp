@@ -32,7 +32,11 @@ SidebarModel::SidebarModel(
 }
 
 void SidebarModel::addLibraryFeature(LibraryFeature* pFeature) {
+    // Features may be added while the model is already shown
+    const int row = static_cast<int>(m_sFeatures.size());
+    beginInsertRows(QModelIndex(), row, row);
     m_sFeatures.push_back(pFeature);
+    endInsertRows();
     connect(pFeature,
             &LibraryFeature::featureIsLoading,
             this,
@@ -25,8 +25,16 @@ void StarDelegate::paintItem(
 
     paintItemBackground(painter, option, index);
 
-    StarRating starRating = index.data().value<StarRating>();
-    starRating.paint(painter, option.rect);
+    const StarRating starRating = index.data().value<StarRating>();
+    paintCached(painter,
+            option.rect,
+            QStringLiteral("star|%1|%2|%3")
+                    .arg(QString::number(starRating.starCount()),
+                            QString::number(starRating.maxStarCount()),
+                            painter->brush().color().name(QColor::HexArgb)),
+            [&starRating](QPainter* pPainter, const QRect& rect) {
+                starRating.paint(pPainter, rect);
+            });
 }
 
 QSize StarDelegate::sizeHint(const QStyleOptionViewItem& option,
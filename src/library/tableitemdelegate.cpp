@@ -1,14 +1,23 @@
 #include "library/tableitemdelegate.h"
 
 #include <QPainter>
+#include <algorithm>
 
 #include "moc_tableitemdelegate.cpp"
 #include "util/painterscope.h"
 #include "widget/wtracktableview.h"
 
+namespace {
+
+// The cost of a cached pixmap is its size in KiB
+constexpr int kMaxPaintCacheKiB = 8 * 1024;
+
+} // namespace
+
 TableItemDelegate::TableItemDelegate(QTableView* pTableView)
         : QStyledItemDelegate(pTableView),
-          m_pTableView(pTableView) {
+          m_pTableView(pTableView),
+          m_paintCache(kMaxPaintCacheKiB) {
     DEBUG_ASSERT(m_pTableView);
     auto* pTrackTableView = qobject_cast<WTrackTableView*>(m_pTableView);
     if (pTrackTableView) {
@@ -54,6 +63,47 @@ void TableItemDelegate::paint(
     paintItem(painter, option, index);
 }
 
+void TableItemDelegate::paintCached(
+        QPainter* painter,
+        const QRect& rect,
+        const QString& key,
+        const std::function<void(QPainter*, const QRect&)>& paintContent) const {
+    if (rect.isEmpty()) {
+        return;
+    }
+    const qreal devicePixelRatio = m_pTableView->devicePixelRatioF();
+    const QString cacheKey = QStringLiteral("%1|%2x%3@%4")
+                                     .arg(key,
+                                             QString::number(rect.width()),
+                                             QString::number(rect.height()),
+                                             QString::number(devicePixelRatio));
+    const QPixmap* pPixmap = m_paintCache.object(cacheKey);
+    if (!pPixmap) {
+        const QSize pixmapSize = rect.size() * devicePixelRatio;
+        // 32 bits per pixel
+        const int cost = std::max(1, pixmapSize.width() * pixmapSize.height() / 256);
+        if (cost > m_paintCache.maxCost()) {
+            PainterScope painterScope(painter);
+            painter->translate(rect.topLeft());
+            paintContent(painter, QRect(QPoint(0, 0), rect.size()));
+            return;
+        }
+        auto* pNewPixmap = new QPixmap(pixmapSize);
+        pNewPixmap->setDevicePixelRatio(devicePixelRatio);
+        pNewPixmap->fill(Qt::transparent);
+        {
+            QPainter pixmapPainter(pNewPixmap);
+            pixmapPainter.setFont(painter->font());
+            pixmapPainter.setPen(painter->pen());
+            pixmapPainter.setBrush(painter->brush());
+            paintContent(&pixmapPainter, QRect(QPoint(0, 0), rect.size()));
+        }
+        m_paintCache.insert(cacheKey, pNewPixmap, cost);
+        pPixmap = pNewPixmap;
+    }
+    painter->drawPixmap(rect.topLeft(), *pPixmap);
+}
+
 int TableItemDelegate::columnWidth(const QModelIndex &index) const {
     return m_pTableView->columnWidth(index.column());
 }
@@ -1,6 +1,9 @@
 #pragma once
 
+#include <QCache>
+#include <QPixmap>
 #include <QStyledItemDelegate>
+#include <functional>
 
 class QTableView;
 
@@ -36,6 +39,22 @@ class TableItemDelegate : public QStyledItemDelegate {
     // Having this here avoids including QTableView there.
     int columnWidth(const QModelIndex &index) const;
 
+    /// Draws the cell content that has been painted for the same key and
+    /// cell size before. On a cache miss, paintContent paints into a
+    /// transparent pixmap with the size of rect, i.e. relative to the top
+    /// left corner of the cell.
+    /// The key must contain everything the content depends on, e.g. the
+    /// data and the state of the cell, so a changed cell gets a new key.
+    void paintCached(
+            QPainter* painter,
+            const QRect& rect,
+            const QString& key,
+            const std::function<void(QPainter*, const QRect&)>& paintContent) const;
+
     QColor m_pFocusBorderColor;
     QTableView* m_pTableView;
+
+  private:
+    // Scrolling repaints the same few distinct contents over and over
+    mutable QCache<QString, QPixmap> m_paintCache;
 };
@@ -537,6 +537,18 @@ bool TrackCollection::saveTrack(Track* pTrack) const {
     return m_trackDao.saveTrack(pTrack);
 }
 
+void TrackCollection::saveTracksPrepare() {
+    DEBUG_ASSERT_QOBJECT_THREAD_AFFINITY(this);
+
+    m_trackDao.saveTracksPrepare();
+}
+
+void TrackCollection::saveTracksFinish() {
+    DEBUG_ASSERT_QOBJECT_THREAD_AFFINITY(this);
+
+    m_trackDao.saveTracksFinish();
+}
+
 TrackPointer TrackCollection::getTrackById(
         TrackId trackId) const {
     DEBUG_ASSERT_QOBJECT_THREAD_AFFINITY(this);
@@ -544,6 +556,13 @@ TrackPointer TrackCollection::getTrackById(
     return m_trackDao.getTrackById(trackId);
 }
 
+QList<TrackPointer> TrackCollection::getTracksByIds(
+        const QList<TrackId>& trackIds) const {
+    DEBUG_ASSERT_QOBJECT_THREAD_AFFINITY(this);
+
+    return m_trackDao.getTracksByIds(trackIds);
+}
+
 TrackPointer TrackCollection::getTrackByRef(
         const TrackRef& trackRef) const {
     DEBUG_ASSERT_QOBJECT_THREAD_AFFINITY(this);
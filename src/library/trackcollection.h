@@ -139,6 +139,8 @@ class TrackCollection : public QObject,
 
     TrackPointer getTrackById(
             TrackId trackId) const;
+    QList<TrackPointer> getTracksByIds(
+            const QList<TrackId>& trackIds) const;
     TrackPointer getTrackByRef(
             const TrackRef& trackRef) const;
 
@@ -164,6 +166,8 @@ class TrackCollection : public QObject,
     void relocateDirectory(const QString& oldDir, const QString& newDir);
 
     bool saveTrack(Track* pTrack) const;
+    void saveTracksPrepare();
+    void saveTracksFinish();
 
     QSqlDatabase m_database;
 
@@ -4,18 +4,31 @@
 
 namespace mixxx {
 
+namespace {
+
+// Limits the number of tracks that are kept in memory at once
+constexpr int kPrefetchBatchSize = 100;
+
+} // anonymous namespace
+
 std::optional<TrackPointer> TrackByIdCollectionIterator::nextItem() {
-    const auto nextTrackId =
-            m_trackIdListIter.nextItem();
-    if (!nextTrackId) {
-        return std::nullopt;
-    }
-    const auto trackPtr =
-            m_pTrackCollectionManager->getTrackById(*nextTrackId);
-    if (!trackPtr) {
-        return std::nullopt;
+    while (m_prefetchedTracks.isEmpty()) {
+        QList<TrackId> trackIds;
+        trackIds.reserve(kPrefetchBatchSize);
+        while (trackIds.size() < kPrefetchBatchSize) {
+            const auto nextTrackId = m_trackIdListIter.nextItem();
+            if (!nextTrackId) {
+                break;
+            }
+            trackIds.append(*nextTrackId);
+        }
+        if (trackIds.isEmpty()) {
+            return std::nullopt;
+        }
+        m_prefetchedTracks =
+                m_pTrackCollectionManager->getTracksByIds(trackIds);
     }
-    return std::make_optional(trackPtr);
+    return std::make_optional(m_prefetchedTracks.takeFirst());
 }
 
 } // namespace mixxx
@@ -3,6 +3,8 @@
 
 #pragma once
 
+#include <QList>
+
 #include "track/trackiterator.h"
 
 class TrackCollectionManager;
@@ -11,6 +13,10 @@ namespace mixxx {
 
 /// Iterate over selected and valid(!) track pointers in a TrackModel.
 /// Invalid (= nullptr) track pointers are skipped silently.
+///
+/// The tracks are loaded in batches, which needs fewer database queries
+/// than loading them one by one. The tracks of the current batch stay in
+/// the GlobalTrackCache until they have been iterated over.
 class TrackByIdCollectionIterator final
         : public virtual TrackPointerIterator {
   public:
@@ -25,10 +31,15 @@ class TrackByIdCollectionIterator final
 
     void reset() override {
         m_trackIdListIter.reset();
+        m_prefetchedTracks.clear();
     }
 
     std::optional<int> estimateItemsRemaining() override {
-        return m_trackIdListIter.estimateItemsRemaining();
+        const auto trackIdsRemaining = m_trackIdListIter.estimateItemsRemaining();
+        if (!trackIdsRemaining) {
+            return std::nullopt;
+        }
+        return std::make_optional(*trackIdsRemaining + m_prefetchedTracks.size());
     }
 
     std::optional<TrackPointer> nextItem() override;
@@ -36,6 +47,7 @@ class TrackByIdCollectionIterator final
   private:
     const TrackCollectionManager* const m_pTrackCollectionManager;
     TrackIdListIterator m_trackIdListIter;
+    QList<TrackPointer> m_prefetchedTracks;
 };
 
 } // namespace mixxx
@@ -6,6 +6,7 @@
 #include "library/library_prefs.h"
 #include "library/scanner/libraryscanner.h"
 #include "library/trackcollection.h"
+#include "library/trackmetadatawritebackqueue.h"
 #include "moc_trackcollectionmanager.cpp"
 #include "sources/soundsourceproxy.h"
 #include "track/track.h"
@@ -41,6 +42,7 @@ TrackCollectionManager::TrackCollectionManager(
         deleteTrackFn_t /*only-needed-for-testing*/ deleteTrackForTestingFn)
     : QObject(parent),
       m_pConfig(pConfig),
+      m_pDbConnectionPool(pDbConnectionPool),
       m_pInternalCollection(createInternalTrackCollection(this, pConfig, deleteTrackForTestingFn)) {
     const QSqlDatabase dbConnection = mixxx::DbConnectionPooled(pDbConnectionPool);
 
@@ -151,6 +153,13 @@ TrackCollectionManager::~TrackCollectionManager() {
     // components are accessing those files at this point.
     GlobalTrackCacheLocker().deactivateCache();
 
+    if (m_pMetadataWriteBackQueue) {
+        // Write the metadata of all evicted tracks while the cache
+        // still exists
+        kLogger.info() << "Writing pending track metadata";
+        m_pMetadataWriteBackQueue.reset();
+    }
+
     for (const auto& externalCollection : std::as_const(m_externalCollections)) {
         kLogger.info()
                 << "Disconnecting from"
@@ -189,12 +198,52 @@ TrackCollectionManager::SaveTrackResult TrackCollectionManager::saveTrack(
     return res;
 }
 
+void TrackCollectionManager::enableMetadataWriteBack(
+        const QString& journalFilePath,
+        std::function<bool()> isBusy) {
+    DEBUG_ASSERT_QOBJECT_THREAD_AFFINITY(this);
+    VERIFY_OR_DEBUG_ASSERT(!m_pMetadataWriteBackQueue) {
+        return;
+    }
+    m_pMetadataWriteBackQueue = std::make_unique<TrackMetadataWriteBackQueue>(
+            m_pDbConnectionPool,
+            journalFilePath,
+            std::move(isBusy));
+
+    const auto recoveredTrackIds = m_pMetadataWriteBackQueue->takeRecoveredTrackIds();
+    if (recoveredTrackIds.isEmpty()) {
+        return;
+    }
+    kLogger.info()
+            << "Exporting metadata of"
+            << recoveredTrackIds.size()
+            << "track(s) that have not been written by the previous session";
+    for (const auto& trackId : recoveredTrackIds) {
+        const auto pTrack = getTrackById(trackId);
+        if (pTrack) {
+            // The metadata is exported again when the track is evicted
+            pTrack->markForMetadataExport();
+        }
+    }
+}
+
 // Export metadata and save the track in both the internal database
 // and external libraries.
 void TrackCollectionManager::saveEvictedTrack(Track* pTrack) noexcept {
     saveTrack(pTrack, TrackMetadataExportMode::Immediate);
 }
 
+void TrackCollectionManager::beginSavingEvictedTracks() noexcept {
+    DEBUG_ASSERT_QOBJECT_THREAD_AFFINITY(this);
+    // Avoid a separate transaction and sync to disk for each track
+    m_pInternalCollection->saveTracksPrepare();
+}
+
+void TrackCollectionManager::endSavingEvictedTracks() noexcept {
+    DEBUG_ASSERT_QOBJECT_THREAD_AFFINITY(this);
+    m_pInternalCollection->saveTracksFinish();
+}
+
 TrackCollectionManager::SaveTrackResult TrackCollectionManager::saveTrack(
         Track* pTrack,
         TrackMetadataExportMode mode) const {
@@ -208,8 +257,9 @@ TrackCollectionManager::SaveTrackResult TrackCollectionManager::saveTrack(
     // status. An unmodified track might have been marked for metadata
     // export by the user or export of metadata was deferred during a
     // previous invocation.
+    std::optional<mixxx::TrackMetadata> writeBackMetadata;
     const auto exportTrackMetadataResult =
-            exportTrackMetadataBeforeSaving(pTrack, mode);
+            exportTrackMetadataBeforeSaving(pTrack, mode, &writeBackMetadata);
     DEBUG_ASSERT(
             exportTrackMetadataResult != ExportTrackMetadataResult::Succeeded ||
             pTrack->getSourceSynchronizedAt().isValid());
@@ -219,6 +269,20 @@ TrackCollectionManager::SaveTrackResult TrackCollectionManager::saveTrack(
         pTrack->resetSourceSynchronizedAt();
     }
 
+    const auto saveTrackResult = saveTrackInCollections(pTrack);
+    if (writeBackMetadata) {
+        // The queue stores the time stamp of the export in the database,
+        // which must not be overwritten by saving the track afterwards.
+        m_pMetadataWriteBackQueue->enqueue(
+                pTrack->getId(),
+                pTrack->getFileInfo(),
+                std::move(*writeBackMetadata));
+    }
+    return saveTrackResult;
+}
+
+TrackCollectionManager::SaveTrackResult TrackCollectionManager::saveTrackInCollections(
+        Track* pTrack) const {
     if (!pTrack->getId().isValid()) {
         // Track has been purged from the internal collection/database
         // while it was cached in-memory.
@@ -283,7 +347,8 @@ TrackCollectionManager::SaveTrackResult TrackCollectionManager::saveTrack(
 
 ExportTrackMetadataResult TrackCollectionManager::exportTrackMetadataBeforeSaving(
         Track* pTrack,
-        TrackMetadataExportMode mode) const {
+        TrackMetadataExportMode mode,
+        std::optional<mixxx::TrackMetadata>* pWriteBackMetadata) const {
     VERIFY_OR_DEBUG_ASSERT(pTrack) {
         return ExportTrackMetadataResult::Skipped;
     }
@@ -304,10 +369,27 @@ ExportTrackMetadataResult TrackCollectionManager::exportTrackMetadataBeforeSavin
                                     .toInt() == 1)) {
         switch (mode) {
         case TrackMetadataExportMode::Immediate: {
-            // Export track metadata now by saving as file tags.
-            const auto result = SoundSourceProxy::exportTrackMetadataBeforeSaving(
-                    pTrack,
-                    SyncTrackMetadataParams::readFromUserSettings(*m_pConfig));
+            const auto syncParams = SyncTrackMetadataParams::readFromUserSettings(*m_pConfig);
+            ExportTrackMetadataResult result;
+            if (m_pMetadataWriteBackQueue) {
+                // Only decide what needs to be exported now, the file
+                // tags are written by the queue.
+                mixxx::TrackMetadata exportMetadata;
+                result = SoundSourceProxy::prepareTrackMetadataExportBeforeSaving(
+                        pTrack,
+                        syncParams,
+                        &exportMetadata);
+                if (result == ExportTrackMetadataResult::Succeeded) {
+                    *pWriteBackMetadata = std::move(exportMetadata);
+                    // The time stamp of the export is not available yet
+                    return ExportTrackMetadataResult::Skipped;
+                }
+            } else {
+                // Export track metadata now by saving as file tags.
+                result = SoundSourceProxy::exportTrackMetadataBeforeSaving(
+                        pTrack,
+                        syncParams);
+            }
             if (result == ExportTrackMetadataResult::Failed) {
                 const auto fileInfo = pTrack->getFileInfo();
                 if (fileInfo.checkFileExists()) {
@@ -569,6 +651,12 @@ TrackPointer TrackCollectionManager::getTrackById(
             trackId);
 }
 
+QList<TrackPointer> TrackCollectionManager::getTracksByIds(
+        const QList<TrackId>& trackIds) const {
+    return internalCollection()->getTracksByIds(
+            trackIds);
+}
+
 TrackPointer TrackCollectionManager::getTrackByRef(
         const TrackRef& trackRef) const {
     return internalCollection()->getTrackByRef(
@@ -3,16 +3,20 @@
 #include <QDir>
 #include <QList>
 #include <QSet>
+#include <functional>
 #include <memory>
+#include <optional>
 
 #include "preferences/usersettings.h"
 #include "track/globaltrackcache.h"
+#include "track/trackmetadata.h"
 #include "util/db/dbconnectionpool.h"
 #include "util/parented_ptr.h"
 #include "util/thread_affinity.h"
 
 class LibraryScanner;
 class TrackCollection;
+class TrackMetadataWriteBackQueue;
 class ExternalTrackCollection;
 class RelocatedTrack;
 
@@ -48,6 +52,11 @@ class TrackCollectionManager: public QObject,
 
     TrackPointer getTrackById(
             TrackId trackId) const;
+    /// Loads multiple tracks at once, e.g. for keeping them in the
+    /// GlobalTrackCache while iterating over them. Tracks that are not
+    /// found are omitted.
+    QList<TrackPointer> getTracksByIds(
+            const QList<TrackId>& trackIds) const;
     TrackPointer getTrackByRef(
             const TrackRef& trackRef) const;
     QList<TrackId> resolveTrackIdsFromUrls(
@@ -90,6 +99,14 @@ class TrackCollectionManager: public QObject,
     };
     SaveTrackResult saveTrack(const TrackPointer& pTrack) const;
 
+    /// Writes the exported metadata of evicted tracks into the file tags
+    /// on a worker thread instead of while saving them. Writing is
+    /// throttled while isBusy() returns true. Tracks that have not been
+    /// written when the previous session ended are exported again.
+    void enableMetadataWriteBack(
+            const QString& journalFilePath,
+            std::function<bool()> isBusy);
+
   signals:
     void libraryScanStarted();
     void libraryScanFinished();
@@ -103,8 +120,10 @@ class TrackCollectionManager: public QObject,
     void afterTracksUpdated(const QSet<TrackId>& updatedTrackIds) const;
     void afterTracksRelocated(const QList<RelocatedTrack>& relocatedTracks) const;
 
-    // Callback for GlobalTrackCache
+    // Callbacks for GlobalTrackCache
     void saveEvictedTrack(Track* pTrack) noexcept override;
+    void beginSavingEvictedTracks() noexcept override;
+    void endSavingEvictedTracks() noexcept override;
 
     // Might be called from any thread
     enum class TrackMetadataExportMode {
@@ -114,16 +133,23 @@ class TrackCollectionManager: public QObject,
     SaveTrackResult saveTrack(
             Track* pTrack,
             TrackMetadataExportMode mode) const;
+    SaveTrackResult saveTrackInCollections(
+            Track* pTrack) const;
     ExportTrackMetadataResult exportTrackMetadataBeforeSaving(
             Track* pTrack,
-            TrackMetadataExportMode mode) const;
+            TrackMetadataExportMode mode,
+            std::optional<mixxx::TrackMetadata>* pWriteBackMetadata) const;
 
     const UserSettingsPointer m_pConfig;
 
+    const mixxx::DbConnectionPoolPtr m_pDbConnectionPool;
+
     const parented_ptr<TrackCollection> m_pInternalCollection;
 
     QList<ExternalTrackCollection*> m_externalCollections;
 
     // TODO: Extract and decouple LibraryScanner from TrackCollectionManager
     std::unique_ptr<LibraryScanner> m_pScanner;
+
+    std::unique_ptr<TrackMetadataWriteBackQueue> m_pMetadataWriteBackQueue;
 };
@@ -0,0 +1,286 @@
+#include "library/trackmetadatawritebackqueue.h"
+
+#include <QDeadlineTimer>
+#include <QSqlError>
+#include <QSqlQuery>
+
+#include "moc_trackmetadatawritebackqueue.cpp"
+#include "sources/soundsourceproxy.h"
+#include "track/globaltrackcache.h"
+#include "track/track.h"
+#include "util/assert.h"
+#include "util/compatibility/qmutex.h"
+#include "util/db/dbconnectionpooled.h"
+#include "util/db/dbconnectionpooler.h"
+#include "util/logger.h"
+
+namespace {
+
+const mixxx::Logger kLogger("TrackMetadataWriteBackQueue");
+
+// Set while the thread writes a job, SoundSourceProxy then opens the file
+// for writing and must not wait for the job itself.
+thread_local bool t_writingJob = false;
+
+} // anonymous namespace
+
+// static
+std::atomic<TrackMetadataWriteBackQueue*> TrackMetadataWriteBackQueue::s_pInstance(nullptr);
+
+TrackMetadataWriteBackQueue::TrackMetadataWriteBackQueue(
+        mixxx::DbConnectionPoolPtr pDbConnectionPool,
+        QString journalFilePath,
+        std::function<bool()> isBusy)
+        : m_pDbConnectionPool(std::move(pDbConnectionPool)),
+          m_isBusy(std::move(isBusy)),
+          m_journal(std::move(journalFilePath)),
+          m_stop(false) {
+    DEBUG_ASSERT(m_pDbConnectionPool);
+    setObjectName(QStringLiteral("TrackMetadataWriteBackQueue"));
+    recoverJournal();
+    // The recovered tracks stay in the journal until they have been
+    // enqueued and written again.
+    if (!m_journal.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        kLogger.warning()
+                << "Failed to open journal"
+                << m_journal.fileName()
+                << m_journal.errorString();
+    }
+
+    DEBUG_ASSERT(!s_pInstance.load());
+    s_pInstance.store(this);
+    start(QThread::LowPriority);
+}
+
+TrackMetadataWriteBackQueue::~TrackMetadataWriteBackQueue() {
+    {
+        const auto locked = lockMutex(&m_mutex);
+        m_stop = true;
+        m_jobsChanged.wakeAll();
+    }
+    wait();
+    s_pInstance.store(nullptr);
+    DEBUG_ASSERT(m_pendingJobs.isEmpty());
+}
+
+void TrackMetadataWriteBackQueue::recoverJournal() {
+    if (!m_journal.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        return;
+    }
+    while (!m_journal.atEnd()) {
+        // Each line contains the id and the location of a track
+        const QString line = QString::fromUtf8(m_journal.readLine()).trimmed();
+        const TrackId trackId(QVariant(line.section(QChar(' '), 0, 0)));
+        if (trackId.isValid() && !m_recoveredTrackIds.contains(trackId)) {
+            m_recoveredTrackIds.append(trackId);
+        }
+    }
+    m_journal.close();
+    if (!m_recoveredTrackIds.isEmpty()) {
+        kLogger.info()
+                << "Recovered"
+                << m_recoveredTrackIds.size()
+                << "pending track(s) from"
+                << m_journal.fileName();
+    }
+}
+
+QList<TrackId> TrackMetadataWriteBackQueue::takeRecoveredTrackIds() {
+    QList<TrackId> trackIds;
+    trackIds.swap(m_recoveredTrackIds);
+    return trackIds;
+}
+
+void TrackMetadataWriteBackQueue::enqueue(
+        TrackId trackId,
+        mixxx::FileInfo fileInfo,
+        mixxx::TrackMetadata trackMetadata) {
+    const QString location = fileInfo.location();
+    const auto locked = lockMutex(&m_mutex);
+    VERIFY_OR_DEBUG_ASSERT(!m_stop) {
+        kLogger.warning()
+                << "Discarding track metadata after stopping"
+                << location;
+        return;
+    }
+    const auto it = m_pendingJobs.find(location);
+    if (it != m_pendingJobs.end()) {
+        // Only the latest metadata needs to be written
+        it.value() = Job{trackId, std::move(fileInfo), std::move(trackMetadata)};
+        return;
+    }
+    if (trackId.isValid() && m_journal.isOpen()) {
+        const QByteArray line =
+                (trackId.toString() + QChar(' ') + location + QChar('\n')).toUtf8();
+        if (m_journal.write(line) != line.size() || !m_journal.flush()) {
+            kLogger.warning()
+                    << "Failed to append to journal"
+                    << m_journal.fileName()
+                    << m_journal.errorString();
+        }
+    }
+    m_pendingJobs.insert(location, Job{trackId, std::move(fileInfo), std::move(trackMetadata)});
+    m_pendingLocations.append(location);
+    m_jobsChanged.wakeAll();
+}
+
+int TrackMetadataWriteBackQueue::pendingCount() const {
+    const auto locked = lockMutex(&m_mutex);
+    return m_pendingJobs.size() + m_writingLocations.size();
+}
+
+void TrackMetadataWriteBackQueue::run() {
+    kLogger.debug() << "Starting thread";
+    Job job;
+    while (takeNextJob(&job)) {
+        writeJob(job);
+        throttle();
+    }
+    kLogger.debug() << "Stopped thread";
+}
+
+bool TrackMetadataWriteBackQueue::takeNextJob(Job* pJob) {
+    auto locked = lockMutex(&m_mutex);
+    while (m_pendingLocations.isEmpty()) {
+        if (m_stop) {
+            return false;
+        }
+        m_jobsChanged.wait(&m_mutex);
+    }
+    const QString location = m_pendingLocations.takeFirst();
+    *pJob = m_pendingJobs.take(location);
+    m_writingLocations.insert(location);
+    return true;
+}
+
+void TrackMetadataWriteBackQueue::throttle() {
+    // Leave the disk to the decks by pausing between two files. The
+    // remaining jobs are written without a pause when stopping.
+    auto locked = lockMutex(&m_mutex);
+    const QDeadlineTimer deadline(kThrottledIntervalMillis);
+    while (!m_stop && !deadline.hasExpired() && m_isBusy && m_isBusy()) {
+        m_jobsChanged.wait(&m_mutex, deadline);
+    }
+}
+
+void TrackMetadataWriteBackQueue::writeJob(const Job& job) {
+    const QString location = job.fileInfo.location();
+    t_writingJob = true;
+    const auto exported = SoundSourceProxy::exportTrackMetadata(
+            job.fileInfo,
+            job.trackMetadata);
+    t_writingJob = false;
+    finishJob(location);
+
+    switch (exported.first) {
+    case mixxx::MetadataSource::ExportResult::Succeeded:
+        if (kLogger.debugEnabled()) {
+            kLogger.debug()
+                    << "Exported track metadata:"
+                    << location;
+        }
+        // Now the file tags and the track's metadata are in sync
+        storeSourceSynchronizedAt(job.trackId, exported.second);
+        return;
+    case mixxx::MetadataSource::ExportResult::Unsupported:
+        return;
+    case mixxx::MetadataSource::ExportResult::Failed:
+        kLogger.warning()
+                << "Failed to export track metadata:"
+                << location;
+        // The metadata in the library could no longer be considered
+        // as synchronized with the file tags.
+        storeSourceSynchronizedAt(job.trackId, QDateTime());
+        return;
+    }
+    DEBUG_ASSERT(!"unhandled case in switch statement");
+}
+
+void TrackMetadataWriteBackQueue::finishJob(const QString& location) {
+    const auto locked = lockMutex(&m_mutex);
+    m_writingLocations.remove(location);
+    if (m_pendingLocations.isEmpty() &&
+            m_writingLocations.isEmpty() &&
+            m_journal.isOpen() &&
+            !m_journal.resize(0)) {
+        kLogger.warning()
+                << "Failed to clear journal"
+                << m_journal.fileName()
+                << m_journal.errorString();
+    }
+    m_jobsChanged.wakeAll();
+}
+
+void TrackMetadataWriteBackQueue::storeSourceSynchronizedAt(
+        TrackId trackId,
+        const QDateTime& sourceSynchronizedAt) {
+    if (!trackId.isValid()) {
+        // The track has been purged from the library
+        return;
+    }
+    // Prevents that the track is loaded from the database until the
+    // time stamp has been updated. A newer time stamp that has been
+    // stored in the meantime is never replaced.
+    const GlobalTrackCacheLocker cacheLocker;
+    const TrackPointer pTrack = cacheLocker.lookupTrackById(trackId);
+    if (pTrack) {
+        if (!sourceSynchronizedAt.isValid()) {
+            pTrack->resetSourceSynchronizedAt();
+        } else if (pTrack->getSourceSynchronizedAt() < sourceSynchronizedAt) {
+            pTrack->setSourceSynchronizedAt(sourceSynchronizedAt);
+        }
+        return;
+    }
+
+    const mixxx::DbConnectionPooler dbConnectionPooler(m_pDbConnectionPool);
+    QSqlQuery query(mixxx::DbConnectionPooled(m_pDbConnectionPool));
+    if (sourceSynchronizedAt.isValid()) {
+        DEBUG_ASSERT(sourceSynchronizedAt.timeSpec() == Qt::UTC);
+        query.prepare(QStringLiteral(
+                "UPDATE library SET source_synchronized_ms=:source_synchronized_ms "
+                "WHERE id=:id AND (source_synchronized_ms IS NULL OR "
+                "source_synchronized_ms<:newer_than_ms)"));
+        query.bindValue(":source_synchronized_ms", sourceSynchronizedAt.toMSecsSinceEpoch());
+        query.bindValue(":newer_than_ms", sourceSynchronizedAt.toMSecsSinceEpoch());
+    } else {
+        query.prepare(QStringLiteral(
+                "UPDATE library SET source_synchronized_ms=NULL WHERE id=:id"));
+    }
+    query.bindValue(":id", trackId.toVariant());
+    if (!query.exec()) {
+        kLogger.warning()
+                << "Failed to store the synchronization time stamp of track"
+                << trackId
+                << query.lastError();
+    }
+}
+
+// static
+void TrackMetadataWriteBackQueue::waitForFile(const QString& location) {
+    if (t_writingJob) {
+        return;
+    }
+    TrackMetadataWriteBackQueue* pInstance = s_pInstance.load();
+    if (pInstance) {
+        pInstance->waitForLocation(location);
+    }
+}
+
+void TrackMetadataWriteBackQueue::waitForLocation(const QString& location) {
+    auto locked = lockMutex(&m_mutex);
+    while (m_writingLocations.contains(location)) {
+        m_jobsChanged.wait(&m_mutex);
+    }
+    const auto it = m_pendingJobs.find(location);
+    if (it == m_pendingJobs.end()) {
+        return;
+    }
+    // Write the job right away instead of waiting for all jobs that
+    // have been enqueued before
+    const Job job = it.value();
+    m_pendingJobs.erase(it);
+    m_pendingLocations.removeOne(location);
+    m_writingLocations.insert(location);
+    locked.unlock();
+    writeJob(job);
+}
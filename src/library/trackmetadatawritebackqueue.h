@@ -0,0 +1,103 @@
+#pragma once
+
+#include <QDateTime>
+#include <QFile>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QSet>
+#include <QString>
+#include <QThread>
+#include <QWaitCondition>
+#include <atomic>
+#include <functional>
+
+#include "track/trackid.h"
+#include "track/trackmetadata.h"
+#include "util/db/dbconnectionpool.h"
+#include "util/fileinfo.h"
+
+/// Writes the exported metadata of evicted tracks into the file tags on
+/// a worker thread.
+///
+/// Writing file tags might rewrite the whole file. Doing this while
+/// saving evicted tracks stalls the GUI when many tracks have been
+/// edited at once and competes with the decks for disk I/O.
+///
+/// - Only the latest metadata of each file is written, a pending job for
+///   the same file is replaced.
+/// - While isBusy() returns true, e.g. while decks are playing, the
+///   writes are throttled.
+/// - The pending tracks are appended to a journal, which is cleared
+///   when the queue is drained. Tracks that have not been written when
+///   Mixxx crashes are recovered from the journal on the next start.
+///
+/// After writing the file the time stamp of the synchronization is
+/// stored in the cached track or in the database. SoundSourceProxy waits
+/// for the pending job of a file before opening it.
+class TrackMetadataWriteBackQueue final : public QThread {
+    Q_OBJECT
+  public:
+    static constexpr int kThrottledIntervalMillis = 1000;
+
+    TrackMetadataWriteBackQueue(
+            mixxx::DbConnectionPoolPtr pDbConnectionPool,
+            QString journalFilePath,
+            std::function<bool()> isBusy);
+    /// Writes all pending jobs before returning
+    ~TrackMetadataWriteBackQueue() override;
+
+    /// The tracks that were pending when the previous session ended
+    QList<TrackId> takeRecoveredTrackIds();
+
+    void enqueue(
+            TrackId trackId,
+            mixxx::FileInfo fileInfo,
+            mixxx::TrackMetadata trackMetadata);
+
+    /// The number of jobs that have not been written yet
+    int pendingCount() const;
+
+    /// Blocks until the pending job of the file has been written, if
+    /// any. The job is written by the calling thread unless the worker
+    /// thread is already writing it.
+    static void waitForFile(const QString& location);
+
+  protected:
+    void run() override;
+
+  private:
+    struct Job {
+        TrackId trackId;
+        mixxx::FileInfo fileInfo;
+        mixxx::TrackMetadata trackMetadata;
+    };
+
+    void recoverJournal();
+    /// Returns false if the queue has been stopped and drained
+    bool takeNextJob(Job* pJob);
+    /// Pauses between two jobs while busy
+    void throttle();
+    void writeJob(const Job& job);
+    void finishJob(const QString& location);
+    void storeSourceSynchronizedAt(
+            TrackId trackId,
+            const QDateTime& sourceSynchronizedAt);
+    void waitForLocation(const QString& location);
+
+    static std::atomic<TrackMetadataWriteBackQueue*> s_pInstance;
+
+    const mixxx::DbConnectionPoolPtr m_pDbConnectionPool;
+    const std::function<bool()> m_isBusy;
+
+    mutable QMutex m_mutex;
+    QWaitCondition m_jobsChanged;
+    /// Pending jobs by location in the order they have been enqueued
+    QHash<QString, Job> m_pendingJobs;
+    QList<QString> m_pendingLocations;
+    /// Locations that are written right now
+    QSet<QString> m_writingLocations;
+    QFile m_journal;
+    QList<TrackId> m_recoveredTrackIds;
+    bool m_stop;
+};
@@ -4,6 +4,7 @@
 
 #include "library/trackcollectionmanager.h"
 #include "moc_trackprocessing.cpp"
+#include "track/globaltrackcache.h"
 #include "util/logger.h"
 
 namespace mixxx {
@@ -35,6 +36,8 @@ int ModalTrackBatchProcessor::processTracks(
             m_minimumProgressDuration,
             this);
     taskMonitor.registerTask(this);
+    // Modified tracks are saved in batches after they have been released
+    const GlobalTrackCacheSaveBatch saveBatch;
     while (auto nextTrackPointer = pTrackPointerIterator->nextItem()) {
         const auto pTrack = *nextTrackPointer;
         VERIFY_OR_DEBUG_ASSERT(pTrack) {
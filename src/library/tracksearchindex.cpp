@@ -0,0 +1,248 @@
+#include "library/tracksearchindex.h"
+
+#include <QDir>
+
+#include "library/dao/trackschema.h"
+#include "util/assert.h"
+#include "util/db/dbconnection.h"
+#include "util/db/sqllikewildcards.h"
+
+namespace {
+
+// Only columns with the corresponding affinity in the database are
+// indexed, because SQLite compares the values of TEXT columns with
+// numbers as strings.
+const QStringList kTextColumns = {
+        LIBRARYTABLE_ARTIST,
+        LIBRARYTABLE_TITLE,
+        LIBRARYTABLE_ALBUM,
+        LIBRARYTABLE_ALBUMARTIST,
+        LIBRARYTABLE_GENRE,
+        LIBRARYTABLE_COMPOSER,
+        LIBRARYTABLE_GROUPING,
+        LIBRARYTABLE_COMMENT,
+        LIBRARYTABLE_KEY,
+        TRACKLOCATIONSTABLE_LOCATION,
+};
+
+const QStringList kNumericColumns = {
+        LIBRARYTABLE_BPM,
+        LIBRARYTABLE_DURATION,
+        LIBRARYTABLE_RATING,
+        LIBRARYTABLE_TIMESPLAYED,
+        LIBRARYTABLE_BITRATE,
+        LIBRARYTABLE_KEY_ID,
+};
+
+enum class CachedMatch : quint8 {
+    Unknown,
+    False,
+    True,
+};
+
+bool containsWildcards(const QString& pattern) {
+    return pattern.contains(kSqlLikeMatchAll) || pattern.contains(kSqlLikeMatchOne);
+}
+
+} // anonymous namespace
+
+TrackSearchIndex::TrackSearchIndex(const QStringList& columns) {
+    for (int i = 0; i < columns.size(); ++i) {
+        if (kTextColumns.contains(columns[i])) {
+            m_textColumns[columns[i]].fieldIndex = i;
+        } else if (kNumericColumns.contains(columns[i])) {
+            m_numericColumns[columns[i]].fieldIndex = i;
+        }
+    }
+}
+
+void TrackSearchIndex::clear() {
+    for (auto& column : m_textColumns) {
+        column.stringIds.clear();
+    }
+    for (auto& column : m_numericColumns) {
+        column.values.clear();
+    }
+    m_trackIds.clear();
+    m_rowsByTrackId.clear();
+    m_strings.clear();
+    m_stringIds.clear();
+}
+
+int TrackSearchIndex::internString(const QVariant& value) {
+    QString string = value.toString();
+    if (value.isNull() || string.isNull()) {
+        // Null strings are stored as NULL in the database
+        return kNullString;
+    }
+    mixxx::DbConnection::makeStringLatinLow(&string);
+    const auto it = m_stringIds.constFind(string);
+    if (it != m_stringIds.constEnd()) {
+        return it.value();
+    }
+    const int stringId = m_strings.size();
+    m_strings.append(string);
+    m_stringIds.insert(string, stringId);
+    return stringId;
+}
+
+void TrackSearchIndex::updateTrack(TrackId trackId, const QVector<QVariant>& record) {
+    int row = m_rowsByTrackId.value(trackId, -1);
+    if (row < 0) {
+        row = rowCount();
+        m_rowsByTrackId.insert(trackId, row);
+        m_trackIds.push_back(trackId);
+        for (auto& column : m_textColumns) {
+            column.stringIds.push_back(kNullString);
+        }
+        for (auto& column : m_numericColumns) {
+            column.values.push_back(kNullValue);
+        }
+    }
+    for (auto it = m_textColumns.begin(); it != m_textColumns.end(); ++it) {
+        QVariant value = record.value(it.value().fieldIndex);
+        if (it.key() == TRACKLOCATIONSTABLE_LOCATION && !value.isNull()) {
+            // The cache contains the location with native separators
+            value = QDir::fromNativeSeparators(value.toString());
+        }
+        it.value().stringIds[row] = internString(value);
+    }
+    for (auto& column : m_numericColumns) {
+        const QVariant value = record.value(column.fieldIndex);
+        bool ok = false;
+        const double number = value.isNull() ? kNullValue : value.toDouble(&ok);
+        column.values[row] = ok ? number : kNullValue;
+    }
+}
+
+void TrackSearchIndex::removeTrack(TrackId trackId) {
+    const auto it = m_rowsByTrackId.find(trackId);
+    if (it == m_rowsByTrackId.end()) {
+        return;
+    }
+    const int row = it.value();
+    m_rowsByTrackId.erase(it);
+    // The row remains unused until the index is rebuilt
+    m_trackIds[row] = TrackId();
+    for (auto& column : m_textColumns) {
+        column.stringIds[row] = kNullString;
+    }
+    for (auto& column : m_numericColumns) {
+        column.values[row] = kNullValue;
+    }
+}
+
+void TrackSearchIndex::matchLike(const QString& column,
+        const QString& pattern,
+        Matches* pMatches) const {
+    const auto it = m_textColumns.constFind(column);
+    VERIFY_OR_DEBUG_ASSERT(it != m_textColumns.constEnd()) {
+        pMatches->assign(m_trackIds.size(), Match::Null);
+        return;
+    }
+    // Avoid the expensive generic LIKE comparison for the common cases
+    const QString substring = pattern.mid(1, pattern.size() - 2);
+    const bool isSubstringSearch = pattern.size() >= 2 &&
+            pattern.startsWith(kSqlLikeMatchAll) &&
+            pattern.endsWith(kSqlLikeMatchAll) &&
+            !containsWildcards(substring);
+    const bool isEqualsSearch = !containsWildcards(pattern);
+    const auto matchString = [&](const QString& string) {
+        if (isSubstringSearch) {
+            return string.contains(substring);
+        }
+        if (isEqualsSearch) {
+            return string == pattern;
+        }
+        // The strings are modified in place, but have already been normalized
+        QString patternCopy = pattern;
+        QString stringCopy = string;
+        // No escape character like the default of the SQL function
+        return mixxx::DbConnection::likeCompareLatinLow(
+                       &patternCopy, &stringCopy, QChar()) != 0;
+    };
+
+    std::vector<CachedMatch> stringMatches(m_strings.size(), CachedMatch::Unknown);
+    const auto& stringIds = it.value().stringIds;
+    pMatches->resize(stringIds.size());
+    for (std::size_t i = 0; i < stringIds.size(); ++i) {
+        const int stringId = stringIds[i];
+        if (stringId == kNullString) {
+            (*pMatches)[i] = Match::Null;
+            continue;
+        }
+        CachedMatch& stringMatch = stringMatches[stringId];
+        if (stringMatch == CachedMatch::Unknown) {
+            stringMatch = matchString(m_strings[stringId])
+                    ? CachedMatch::True
+                    : CachedMatch::False;
+        }
+        (*pMatches)[i] = stringMatch == CachedMatch::True ? Match::True : Match::False;
+    }
+}
+
+void TrackSearchIndex::matchNullOrEmptyText(const QString& column, Matches* pMatches) const {
+    const auto it = m_textColumns.constFind(column);
+    VERIFY_OR_DEBUG_ASSERT(it != m_textColumns.constEnd()) {
+        pMatches->assign(m_trackIds.size(), Match::Null);
+        return;
+    }
+    const auto& stringIds = it.value().stringIds;
+    pMatches->resize(stringIds.size());
+    for (std::size_t i = 0; i < stringIds.size(); ++i) {
+        const int stringId = stringIds[i];
+        (*pMatches)[i] = (stringId == kNullString || m_strings[stringId].isEmpty())
+                ? Match::True
+                : Match::False;
+    }
+}
+
+void TrackSearchIndex::matchNullNumeric(const QString& column, Matches* pMatches) const {
+    const auto it = m_numericColumns.constFind(column);
+    VERIFY_OR_DEBUG_ASSERT(it != m_numericColumns.constEnd()) {
+        pMatches->assign(m_trackIds.size(), Match::Null);
+        return;
+    }
+    const auto& values = it.value().values;
+    pMatches->resize(values.size());
+    for (std::size_t i = 0; i < values.size(); ++i) {
+        (*pMatches)[i] = std::isnan(values[i]) ? Match::True : Match::False;
+    }
+}
+
+//static
+void TrackSearchIndex::matchAnd(const Matches& other, Matches* pMatches) {
+    DEBUG_ASSERT(other.size() == pMatches->size());
+    for (std::size_t i = 0; i < pMatches->size(); ++i) {
+        Match& match = (*pMatches)[i];
+        if (match == Match::False || other[i] == Match::False) {
+            match = Match::False;
+        } else if (match == Match::Null || other[i] == Match::Null) {
+            match = Match::Null;
+        }
+    }
+}
+
+//static
+void TrackSearchIndex::matchOr(const Matches& other, Matches* pMatches) {
+    DEBUG_ASSERT(other.size() == pMatches->size());
+    for (std::size_t i = 0; i < pMatches->size(); ++i) {
+        Match& match = (*pMatches)[i];
+        if (match == Match::True || other[i] == Match::True) {
+            match = Match::True;
+        } else if (match == Match::Null || other[i] == Match::Null) {
+            match = Match::Null;
+        }
+    }
+}
+
+//static
+void TrackSearchIndex::matchNot(Matches* pMatches) {
+    for (auto& match : *pMatches) {
+        if (match == Match::True) {
+            match = Match::False;
+        } else if (match == Match::False) {
+            match = Match::True;
+        }
+    }
+}
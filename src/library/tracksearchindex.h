@@ -0,0 +1,129 @@
+#pragma once
+
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QVariant>
+#include <QVector>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "track/trackid.h"
+
+/// A columnar in-memory copy of the searchable columns of a BaseTrackCache.
+///
+/// Each text column stores an index into a table of interned strings per
+/// track and each numeric column a plain array of values. This allows to
+/// evaluate search queries by scanning these arrays instead of querying
+/// the database. The strings are normalized with
+/// mixxx::DbConnection::makeStringLatinLow() like in LIKE comparisons.
+///
+/// The results follow the three-valued logic of SQL, i.e. any comparison
+/// with NULL is neither true nor false. This is required to get exactly
+/// the same results as the SQL query that is generated by QueryNode::toSql(),
+/// e.g. when negating a filter.
+class TrackSearchIndex {
+  public:
+    enum class Match : quint8 {
+        False,
+        True,
+        Null,
+    };
+    typedef std::vector<Match> Matches;
+
+    /// Only columns with a known type are indexed. The order of the
+    /// values passed to updateTrack() must match the order of columns.
+    explicit TrackSearchIndex(const QStringList& columns);
+
+    void clear();
+    void updateTrack(TrackId trackId, const QVector<QVariant>& record);
+    void removeTrack(TrackId trackId);
+
+    /// The number of rows including those of removed tracks, i.e. the
+    /// size of each column.
+    int rowCount() const {
+        return static_cast<int>(m_trackIds.size());
+    }
+    /// Returns -1 if the track is not indexed.
+    int row(TrackId trackId) const {
+        return m_rowsByTrackId.value(trackId, -1);
+    }
+
+    /// Returns an invalid id for rows of removed tracks.
+    TrackId trackId(int row) const {
+        return m_trackIds[row];
+    }
+
+    bool hasTextColumn(const QString& column) const {
+        return m_textColumns.contains(column);
+    }
+    bool hasNumericColumn(const QString& column) const {
+        return m_numericColumns.contains(column);
+    }
+
+    /// Evaluates `column LIKE pattern` with a pattern that has already
+    /// been normalized. Plain substring searches without any wildcards
+    /// except the enclosing ones are optimized. The predicate is only
+    /// evaluated once for each distinct string.
+    void matchLike(const QString& column,
+            const QString& pattern,
+            Matches* pMatches) const;
+
+    /// `column IS NULL OR column IS ''`
+    void matchNullOrEmptyText(const QString& column, Matches* pMatches) const;
+
+    /// Evaluates a comparison with a numeric column. The predicate is
+    /// not invoked for NULL values.
+    template<typename Predicate>
+    void matchNumeric(const QString& column,
+            Predicate predicate,
+            Matches* pMatches) const {
+        const auto it = m_numericColumns.constFind(column);
+        if (it == m_numericColumns.constEnd()) {
+            pMatches->assign(m_trackIds.size(), Match::Null);
+            return;
+        }
+        const auto& values = it.value().values;
+        pMatches->resize(values.size());
+        for (std::size_t i = 0; i < values.size(); ++i) {
+            const double value = values[i];
+            (*pMatches)[i] = std::isnan(value)
+                    ? Match::Null
+                    : (predicate(value) ? Match::True : Match::False);
+        }
+    }
+
+    /// `column IS NULL`
+    void matchNullNumeric(const QString& column, Matches* pMatches) const;
+
+    /// Combines the results of two terms into pMatches
+    static void matchAnd(const Matches& other, Matches* pMatches);
+    static void matchOr(const Matches& other, Matches* pMatches);
+    static void matchNot(Matches* pMatches);
+
+  private:
+    static constexpr double kNullValue = std::numeric_limits<double>::quiet_NaN();
+    static constexpr int kNullString = -1;
+
+    struct TextColumn {
+        int fieldIndex = -1;
+        std::vector<int> stringIds;
+    };
+    struct NumericColumn {
+        int fieldIndex = -1;
+        std::vector<double> values;
+    };
+
+    int internString(const QVariant& value);
+
+    QHash<QString, TextColumn> m_textColumns;
+    QHash<QString, NumericColumn> m_numericColumns;
+
+    std::vector<TrackId> m_trackIds;
+    QHash<TrackId, int> m_rowsByTrackId;
+
+    // Interned strings are not removed before the index is cleared
+    QStringList m_strings;
+    QHash<QString, int> m_stringIds;
+};
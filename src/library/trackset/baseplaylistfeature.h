@@ -76,6 +76,7 @@ class BasePlaylistFeature : public BaseTrackSetFeature {
     struct IdAndLabel {
         int id;
         QString label;
+        bool locked;
     };
 
     virtual void updateChildModel(const QSet<int>& playlistIds);
@@ -29,6 +29,17 @@ QString createPlaylistLabel(
                             duration, mixxx::Duration::Precision::SECONDS));
 }
 
+void decorateLockedChild(TreeItem* pItem, bool locked) {
+    if (locked) {
+        // Shared by all items instead of loading the icon for each one
+        static const QIcon lockedIcon(
+                QStringLiteral(":/images/library/ic_library_locked_tracklist.svg"));
+        pItem->setIcon(lockedIcon);
+    } else {
+        pItem->setIcon(QIcon());
+    }
+}
+
 } // anonymous namespace
 
 PlaylistFeature::PlaylistFeature(Library* pLibrary, UserSettingsPointer pConfig)
@@ -134,7 +145,8 @@ QList<BasePlaylistFeature::IdAndLabel> PlaylistFeature::createPlaylistLabels() {
             "  COUNT(case library.mixxx_deleted when 0 then 1 else null end) "
             "    AS count, "
             "  SUM(case library.mixxx_deleted "
-            "    when 0 then library.duration else 0 end) AS durationSeconds "
+            "    when 0 then library.duration else 0 end) AS durationSeconds, "
+            "  Playlists.locked AS locked "
             "FROM Playlists "
             "LEFT JOIN PlaylistTracks "
             "  ON PlaylistTracks.playlist_id = Playlists.id "
@@ -150,39 +162,23 @@ QList<BasePlaylistFeature::IdAndLabel> PlaylistFeature::createPlaylistLabels() {
         LOG_FAILED_QUERY(query);
     }
 
-    // Setup the sidebar playlist model
-    QSqlTableModel playlistTableModel(this, database);
-    playlistTableModel.setTable("PlaylistsCountsDurations");
-    playlistTableModel.select();
-    while (playlistTableModel.canFetchMore()) {
-        playlistTableModel.fetchMore();
+    // The labels and the lock state of all playlists with a single query
+    QSqlQuery selectQuery(database);
+    selectQuery.setForwardOnly(true);
+    if (!selectQuery.exec(QStringLiteral(
+                "SELECT id, name, count, durationSeconds, locked "
+                "FROM PlaylistsCountsDurations"))) {
+        LOG_FAILED_QUERY(selectQuery);
+        return playlistLabels;
     }
-    QSqlRecord record = playlistTableModel.record();
-    int nameColumn = record.indexOf("name");
-    int idColumn = record.indexOf("id");
-    int countColumn = record.indexOf("count");
-    int durationColumn = record.indexOf("durationSeconds");
-
-    for (int row = 0; row < playlistTableModel.rowCount(); ++row) {
-        int id =
-                playlistTableModel
-                        .data(playlistTableModel.index(row, idColumn))
-                        .toInt();
-        QString name =
-                playlistTableModel
-                        .data(playlistTableModel.index(row, nameColumn))
-                        .toString();
-        int count =
-                playlistTableModel
-                        .data(playlistTableModel.index(row, countColumn))
-                        .toInt();
-        int duration =
-                playlistTableModel
-                        .data(playlistTableModel.index(row, durationColumn))
-                        .toInt();
+    while (selectQuery.next()) {
         BasePlaylistFeature::IdAndLabel idAndLabel;
-        idAndLabel.id = id;
-        idAndLabel.label = createPlaylistLabel(name, count, duration);
+        idAndLabel.id = selectQuery.value(0).toInt();
+        idAndLabel.label = createPlaylistLabel(
+                selectQuery.value(1).toString(),
+                selectQuery.value(2).toInt(),
+                selectQuery.value(3).toInt());
+        idAndLabel.locked = selectQuery.value(4).toBool();
         playlistLabels.append(idAndLabel);
     }
     return playlistLabels;
@@ -245,7 +241,7 @@ QModelIndex PlaylistFeature::constructChildModel(int selectedId) {
         auto pItem = std::make_unique<TreeItem>(playlistLabel, playlistId);
         pItem->setBold(m_playlistIdsOfSelectedTrack.contains(playlistId));
 
-        decorateChild(pItem.get(), playlistId);
+        decorateLockedChild(pItem.get(), idAndLabel.locked);
         childrenToAdd.push_back(std::move(pItem));
 
         ++row;
@@ -260,12 +256,7 @@ QModelIndex PlaylistFeature::constructChildModel(int selectedId) {
 }
 
 void PlaylistFeature::decorateChild(TreeItem* item, int playlistId) {
-    if (m_playlistDao.isPlaylistLocked(playlistId)) {
-        item->setIcon(
-                QIcon(":/images/library/ic_library_locked_tracklist.svg"));
-    } else {
-        item->setIcon(QIcon());
-    }
+    decorateLockedChild(item, m_playlistDao.isPlaylistLocked(playlistId));
 }
 
 void PlaylistFeature::slotPlaylistTableChanged(int playlistId) {
@@ -19,6 +19,9 @@
 
 namespace {
 constexpr int kNumToplevelHistoryEntries = 5;
+// Played tracks are appended to the history in batches after this delay,
+// to keep database writes away from the moment when a track starts
+constexpr int kFlushHistoryDelayMillis = 5000;
 } // namespace
 
 using namespace mixxx::library::prefs;
@@ -91,11 +94,19 @@ SetlogFeature::SetlogFeature(
             this,
             &SetlogFeature::slotDeleteAllUnlockedChildPlaylists);
 
+    m_flushHistoryTimer.setSingleShot(true);
+    m_flushHistoryTimer.setInterval(kFlushHistoryDelayMillis);
+    connect(&m_flushHistoryTimer,
+            &QTimer::timeout,
+            this,
+            &SetlogFeature::slotFlushPendingHistoryTracks);
+
     // initialized in a new generic slot(get new history playlist purpose)
     slotGetNewPlaylist();
 }
 
 SetlogFeature::~SetlogFeature() {
+    slotFlushPendingHistoryTracks();
     // Clean up history when shutting down in case the track threshold changed,
     // incl. the empty placeholder playlist and potentially empty current playlist
     deleteAllUnlockedPlaylistsWithFewerTracks();
@@ -197,6 +208,7 @@ void SetlogFeature::onRightClickChild(const QPoint& globalPos, const QModelIndex
         if (playlistId == m_currentPlaylistId) {
             // Todays playlists can change !
             m_pStartNewPlaylist->setEnabled(
+                    !m_pendingHistoryTrackIds.isEmpty() ||
                     m_playlistDao.tracksInPlaylist(m_currentPlaylistId) > 0);
             menu.addAction(m_pStartNewPlaylist);
         }
@@ -214,21 +226,18 @@ void SetlogFeature::onRightClickChild(const QPoint& globalPos, const QModelIndex
 /// @param selectedId row which should be selected
 QModelIndex SetlogFeature::constructChildModel(int selectedId) {
     // qDebug() << "SetlogFeature::constructChildModel() id:" << selectedId;
-    // Setup the sidebar playlist model
-    QSqlTableModel playlistTableModel(this,
+    // The names and the lock state of all history playlists with a single
+    // query, newest first
+    QSqlQuery query(
             m_pLibrary->trackCollectionManager()->internalCollection()->database());
-    playlistTableModel.setTable("Playlists");
-    playlistTableModel.setFilter("hidden=" + QString::number(PlaylistDAO::PLHT_SET_LOG));
-    playlistTableModel.setSort(
-            playlistTableModel.fieldIndex("id"), Qt::DescendingOrder);
-    playlistTableModel.select();
-    while (playlistTableModel.canFetchMore()) {
-        playlistTableModel.fetchMore();
+    query.setForwardOnly(true);
+    query.prepare(QStringLiteral(
+            "SELECT id, name, date_created, locked FROM Playlists "
+            "WHERE hidden=:hidden ORDER BY id DESC"));
+    query.bindValue(":hidden", PlaylistDAO::PLHT_SET_LOG);
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query);
     }
-    QSqlRecord record = playlistTableModel.record();
-    int nameColumn = record.indexOf("name");
-    int idColumn = record.indexOf("id");
-    int createdColumn = record.indexOf("date_created");
 
     // Nice to have: restore previous expanded/collapsed state of YEAR items
     clearChildModel();
@@ -237,19 +246,11 @@ QModelIndex SetlogFeature::constructChildModel(int selectedId) {
     // Generous estimate (number of years the db is used ;))
     itemList.reserve(kNumToplevelHistoryEntries + 15);
 
-    for (int row = 0; row < playlistTableModel.rowCount(); ++row) {
-        int id =
-                playlistTableModel
-                        .data(playlistTableModel.index(row, idColumn))
-                        .toInt();
-        QString name =
-                playlistTableModel
-                        .data(playlistTableModel.index(row, nameColumn))
-                        .toString();
-        QDateTime dateCreated =
-                playlistTableModel
-                        .data(playlistTableModel.index(row, createdColumn))
-                        .toDateTime();
+    for (int row = 0; query.next(); ++row) {
+        const int id = query.value(0).toInt();
+        const QString name = query.value(1).toString();
+        const QDateTime dateCreated = query.value(2).toDateTime();
+        const bool locked = query.value(3).toBool();
 
         // Create the TreeItem whose parent is the invisible root item
         // Show only [kNumToplevelHistoryEntries] recent playlists at the top level
@@ -275,12 +276,12 @@ QModelIndex SetlogFeature::constructChildModel(int selectedId) {
 
             TreeItem* pItem = pGroupItem->appendChild(name, id);
             pItem->setBold(m_playlistIdsOfSelectedTrack.contains(id));
-            decorateChild(pItem, id);
+            decorateChild(pItem, id, locked);
         } else {
             // add most recent top-level playlist
             auto pItem = std::make_unique<TreeItem>(name, id);
             pItem->setBold(m_playlistIdsOfSelectedTrack.contains(id));
-            decorateChild(pItem.get(), id);
+            decorateChild(pItem.get(), id, locked);
 
             itemList.push_back(std::move(pItem));
         }
@@ -316,10 +317,19 @@ QString SetlogFeature::fetchPlaylistLabel(int playlistId) {
 }
 
 void SetlogFeature::decorateChild(TreeItem* item, int playlistId) {
+    decorateChild(item, playlistId, m_playlistDao.isPlaylistLocked(playlistId));
+}
+
+void SetlogFeature::decorateChild(TreeItem* item, int playlistId, bool locked) {
+    // Shared by all items instead of loading the icons for each one
+    static const QIcon currentIcon(
+            QStringLiteral(":/images/library/ic_library_history_current.svg"));
+    static const QIcon lockedIcon(
+            QStringLiteral(":/images/library/ic_library_locked.svg"));
     if (playlistId == m_currentPlaylistId) {
-        item->setIcon(QIcon(":/images/library/ic_library_history_current.svg"));
-    } else if (m_playlistDao.isPlaylistLocked(playlistId)) {
-        item->setIcon(QIcon(":/images/library/ic_library_locked.svg"));
+        item->setIcon(currentIcon);
+    } else if (locked) {
+        item->setIcon(lockedIcon);
     } else {
         item->setIcon(QIcon());
     }
@@ -328,6 +338,8 @@ void SetlogFeature::decorateChild(TreeItem* item, int playlistId) {
 /// Invoked on startup to create new current playlist and by "Finish current and start new"
 void SetlogFeature::slotGetNewPlaylist() {
     //qDebug() << "slotGetNewPlaylist() successfully triggered !";
+    // Tracks that have been played before belong to the previous playlist
+    slotFlushPendingHistoryTracks();
 
     // create a new playlist for today
     QString set_log_name_format;
@@ -371,6 +383,8 @@ void SetlogFeature::slotJoinWithPrevious() {
         return;
     }
 
+    slotFlushPendingHistoryTracks();
+
     bool locked = m_playlistDao.isPlaylistLocked(clickedPlaylistId);
     if (locked) {
         qDebug() << "Aborting playlist join because playlist"
@@ -594,6 +608,20 @@ void SetlogFeature::slotPlayingTrackChanged(TrackPointer currentPlayingTrack) {
         return;
     }
 
+    m_pendingHistoryTrackIds.append(currentPlayingTrackId);
+    if (!m_flushHistoryTimer.isActive()) {
+        m_flushHistoryTimer.start();
+    }
+}
+
+void SetlogFeature::slotFlushPendingHistoryTracks() {
+    m_flushHistoryTimer.stop();
+    if (m_pendingHistoryTrackIds.isEmpty()) {
+        return;
+    }
+    const QList<TrackId> trackIds = std::move(m_pendingHistoryTrackIds);
+    m_pendingHistoryTrackIds.clear();
+
     if (m_pPlaylistTableModel->getPlaylist() == m_currentPlaylistId) {
         // View needs a refresh
 
@@ -607,19 +635,18 @@ void SetlogFeature::slotPlayingTrackChanged(TrackPointer currentPlayingTrack) {
                 // while the song changes through autodj. The selection is then lost
                 // and dataloss occurs
                 hasActiveView = true;
-                const QList<TrackId> trackIds = view->getSelectedTrackIds();
-                m_pPlaylistTableModel->appendTrack(currentPlayingTrackId);
-                view->setSelectedTracks(trackIds);
+                const QList<TrackId> selectedTrackIds = view->getSelectedTrackIds();
+                m_playlistDao.appendTracksToPlaylist(trackIds, m_currentPlaylistId);
+                view->setSelectedTracks(selectedTrackIds);
             }
         }
 
         if (!hasActiveView) {
-            m_pPlaylistTableModel->appendTrack(currentPlayingTrackId);
+            m_playlistDao.appendTracksToPlaylist(trackIds, m_currentPlaylistId);
         }
     } else {
         // TODO(XXX): Care whether the append succeeded.
-        m_playlistDao.appendTrackToPlaylist(
-                currentPlayingTrackId, m_currentPlaylistId);
+        m_playlistDao.appendTracksToPlaylist(trackIds, m_currentPlaylistId);
     }
 }
 
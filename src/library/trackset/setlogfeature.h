@@ -1,6 +1,7 @@
 #pragma once
 
 #include <QPointer>
+#include <QTimer>
 
 #include "library/trackset/baseplaylistfeature.h"
 #include "preferences/usersettings.h"
@@ -38,6 +39,7 @@ class SetlogFeature : public BasePlaylistFeature {
     QModelIndex constructChildModel(int selectedId);
     QString fetchPlaylistLabel(int playlistId) override;
     void decorateChild(TreeItem* pChild, int playlistId) override;
+    void decorateChild(TreeItem* pChild, int playlistId, bool locked);
 
   private slots:
     void slotPlayingTrackChanged(TrackPointer currentPlayingTrack);
@@ -45,6 +47,7 @@ class SetlogFeature : public BasePlaylistFeature {
     void slotPlaylistContentOrLockChanged(const QSet<int>& playlistIds) override;
     void slotPlaylistTableRenamed(int playlistId, const QString& newName) override;
     void slotDeleteAllUnlockedChildPlaylists();
+    void slotFlushPendingHistoryTracks();
 
   private:
     void deleteAllUnlockedPlaylistsWithFewerTracks();
@@ -52,6 +55,10 @@ class SetlogFeature : public BasePlaylistFeature {
     QString getRootViewHtml() const override;
 
     std::list<TrackId> m_recentTracks;
+    // Played tracks that have not been appended to the current
+    // playlist yet
+    QList<TrackId> m_pendingHistoryTrackIds;
+    QTimer m_flushHistoryTimer;
     QAction* m_pJoinWithPreviousAction;
     QAction* m_pMarkTracksPlayedAction;
     QAction* m_pStartNewPlaylist;
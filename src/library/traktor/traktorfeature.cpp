@@ -1,7 +1,9 @@
 #include "library/traktor/traktorfeature.h"
 
+#include <QFileInfo>
 #include <QMap>
 #include <QMessageBox>
+#include <QMetaObject>
 #include <QRegularExpression>
 #include <QRegularExpressionMatch>
 #include <QSettings>
@@ -22,11 +24,151 @@
 
 namespace {
 
+const ConfigKey kCollectionSignatureConfigKey =
+        ConfigKey(QStringLiteral("[Traktor]"), QStringLiteral("collection_signature"));
+
+const QString kPlaylistPathDelimiter = QStringLiteral("-->");
+
+// The progress is reported after this many tracks
+constexpr int kProgressTrackInterval = 500;
+
+struct TraktorTrack {
+    QString title;
+    QString artist;
+    QString album;
+    QString year;
+    QString genre;
+    QString location;
+    float bpm = 0.0;
+    int bitrate = 0;
+    QString key;
+    //duration of a track
+    int playtime = 0;
+    int rating = 0;
+    QString comment;
+    QString tracknumber;
+};
+
 QString fromTraktorSeparators(QString path) {
     // Traktor uses /: instead of just / as delimiting character for some reasons
     return path.replace("/:", "/");
 }
 
+// The imported tracks and playlists are reused as long as the collection.nml
+// has not been modified
+QString collectionSignature(const QString& file) {
+    const QFileInfo fileInfo(file);
+    if (!fileInfo.exists()) {
+        return QString();
+    }
+    return QStringLiteral("%1|%2|%3")
+            .arg(fileInfo.absoluteFilePath(),
+                    QString::number(fileInfo.size()),
+                    QString::number(fileInfo.lastModified().toMSecsSinceEpoch()));
+}
+
+// Parses a track in the music collection
+TraktorTrack parseTrack(QXmlStreamReader& xml) {
+    TraktorTrack track;
+    //drive letter
+    QString volume;
+    QString path;
+    QString filename;
+
+    //get XML attributes of starting ENTRY tag
+    QXmlStreamAttributes attr = xml.attributes ();
+    track.title = attr.value("TITLE").toString();
+    track.artist = attr.value("ARTIST").toString();
+
+    //read all sub tags of ENTRY until we reach the closing ENTRY tag
+    while (!xml.atEnd()) {
+        xml.readNext();
+        if (xml.isStartElement()) {
+            if (xml.name() == QLatin1String("ALBUM")) {
+                QXmlStreamAttributes attr = xml.attributes ();
+                track.album = attr.value("TITLE").toString();
+                track.tracknumber = attr.value("TRACK").toString();
+                continue;
+            }
+            if (xml.name() == QLatin1String("LOCATION")) {
+                QXmlStreamAttributes attr = xml.attributes ();
+                volume = attr.value("VOLUME").toString();
+                path = attr.value("DIR").toString();
+                filename = attr.value("FILE").toString();
+                // compute the location, i.e, combining all the values
+                // On Windows the volume holds the drive letter e.g., d:
+                // On OS X, the volume is supposed to be "Macintosh HD" or "Macintosh SSD",
+                // which is a folder in /Volumes/ symlinked to root folder /
+                #if defined(__APPLE__)
+                track.location = "/Volumes/" + volume;
+                #else
+                track.location = volume;
+                #endif
+                track.location += fromTraktorSeparators(path);
+                track.location += filename;
+                continue;
+            }
+            if (xml.name() == QLatin1String("INFO")) {
+                QXmlStreamAttributes attr = xml.attributes();
+                track.key = attr.value("KEY").toString();
+                track.bitrate = attr.value("BITRATE").toString().toInt() / 1000;
+                track.playtime = attr.value("PLAYTIME").toString().toInt();
+                track.genre = attr.value("GENRE").toString();
+                track.year = attr.value("RELEASE_DATE").toString();
+                track.comment = attr.value("COMMENT").toString();
+                QString ranking_str = attr.value("RANKING").toString();
+                // A ranking in Traktor has ranges between 0 and 255 internally.
+                // This is same as the POPULARIMETER tag in IDv2,
+                // see http://help.mp3tag.de/main_tags.html
+                //
+                // Our rating values range from 1 to 5. The mapping is defined as follow
+                // ourRatingValue = TraktorRating / 51
+                bool ok = false;
+                int parsed_rating = ranking_str.toInt(&ok) / 51;
+                if (ok) {
+                    track.rating = parsed_rating;
+                }
+                continue;
+            }
+            if (xml.name() == QLatin1String("TEMPO")) {
+                QXmlStreamAttributes attr = xml.attributes ();
+                track.bpm = attr.value("BPM").toString().toFloat();
+                continue;
+            }
+            if (xml.name() == QLatin1String("MUSICAL_KEY")) {
+                QXmlStreamAttributes attr = xml.attributes();
+                // Traktor happens to use the same key numbering
+                track.key = KeyUtils::keyToString(
+                        KeyUtils::keyFromNumericValue(
+                                attr.value("VALUE").toInt()),
+                        KeyUtils::KeyNotation::Custom);
+                continue;
+            }
+        }
+        //We leave the infinite loop, if twe have the closing tag "ENTRY"
+        if (xml.name() == QLatin1String("ENTRY") && xml.isEndElement()) {
+            break;
+        }
+    }
+    return track;
+}
+
+void bindTrack(QSqlQuery& query, const TraktorTrack& track) {
+    query.bindValue(":artist", track.artist);
+    query.bindValue(":title", track.title);
+    query.bindValue(":album", track.album);
+    query.bindValue(":genre", track.genre);
+    query.bindValue(":year", track.year);
+    query.bindValue(":duration", track.playtime);
+    query.bindValue(":location", track.location);
+    query.bindValue(":rating", track.rating);
+    query.bindValue(":comment", track.comment);
+    query.bindValue(":tracknumber", track.tracknumber);
+    query.bindValue(":key", track.key);
+    query.bindValue(":bpm", track.bpm);
+    query.bindValue(":bitrate", track.bitrate);
+}
+
 } // anonymous namespace
 
 
@@ -163,14 +305,20 @@ void TraktorFeature::activate() {
 
     if (!m_isActivated) {
         m_isActivated =  true;
+        const QString file = getTraktorMusicDatabase();
+        m_collectionSignature = collectionSignature(file);
+        const bool collectionUnchanged = !m_collectionSignature.isEmpty() &&
+                m_pConfig->getValueString(kCollectionSignatureConfigKey) ==
+                        m_collectionSignature;
         // Let a worker thread do the XML parsing
 #if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
         m_future = QtConcurrent::run(&TraktorFeature::importLibrary,
                 this,
-                getTraktorMusicDatabase());
+                file,
+                collectionUnchanged);
 #else
         m_future = QtConcurrent::run(this, &TraktorFeature::importLibrary,
-                                     getTraktorMusicDatabase());
+                                     file, collectionUnchanged);
 #endif
         m_future_watcher.setFuture(m_future);
         m_title = tr("(loading) Traktor");
@@ -199,19 +347,41 @@ void TraktorFeature::activateChild(const QModelIndex& index) {
     }
 }
 
-TreeItem* TraktorFeature::importLibrary(const QString& file) {
+TreeItem* TraktorFeature::importLibrary(const QString& file, bool collectionUnchanged) {
     //Give thread a low priority
     QThread* thisThread = QThread::currentThread();
     thisThread->setPriority(QThread::LowPriority);
+
+    if (collectionUnchanged) {
+        TreeItem* root = loadPlaylistTree();
+        if (root) {
+            qDebug() << "Traktor collection is unchanged, reusing the imported tracks";
+            return root;
+        }
+    }
+
     //Invisible root item of Traktor's child model
     TreeItem* root = nullptr;
-    //Delete all table entries of Traktor feature
+    // The playlists are imported again. The tracks are updated in place, such
+    // that only the differences to the previous import are written.
     ScopedTransaction transaction(m_database);
     clearTable("traktor_playlist_tracks");
-    clearTable("traktor_library");
     clearTable("traktor_playlists");
     transaction.commit();
 
+    QHash<QString, int> trackIds;
+    QSet<int> staleTrackIds;
+    QSqlQuery trackIdsQuery(m_database);
+    trackIdsQuery.prepare("SELECT id, location FROM traktor_library");
+    if (!trackIdsQuery.exec()) {
+        LOG_FAILED_QUERY(trackIdsQuery);
+    }
+    while (trackIdsQuery.next()) {
+        const int trackId = trackIdsQuery.value(0).toInt();
+        trackIds.insert(trackIdsQuery.value(1).toString(), trackId);
+        staleTrackIds.insert(trackId);
+    }
+
     transaction.transaction();
     QSqlQuery query(m_database);
     query.prepare("INSERT INTO traktor_library (artist, title, album, year,"
@@ -219,6 +389,12 @@ TreeItem* TraktorFeature::importLibrary(const QString& file) {
                   "rating,key) VALUES (:artist, :title, :album, :year,:genre,"
                   ":comment, :tracknumber,:bpm, :bitrate,:duration, :location,"
                   ":rating,:key)");
+    QSqlQuery updateQuery(m_database);
+    updateQuery.prepare("UPDATE traktor_library SET artist=:artist, title=:title,"
+                  "album=:album, year=:year, genre=:genre, comment=:comment,"
+                  "tracknumber=:tracknumber, bpm=:bpm, bitrate=:bitrate,"
+                  "duration=:duration, location=:location, rating=:rating,"
+                  "key=:key WHERE id=:id");
 
     //Parse Trakor XML file using SAX (for performance)
     mixxx::FileInfo fileInfo(file);
@@ -227,6 +403,7 @@ TreeItem* TraktorFeature::importLibrary(const QString& file) {
         qDebug() << "Cannot open Traktor music collection";
         return nullptr;
     }
+    const qint64 fileSize = traktor_file.size();
     QXmlStreamReader xml(&traktor_file);
     bool inCollectionTag = false;
     bool inPlaylistsTag = false;
@@ -242,8 +419,28 @@ TreeItem* TraktorFeature::importLibrary(const QString& file) {
             // Each "ENTRY" tag in <COLLECTION> represents a track
             if (inCollectionTag && xml.name() == QLatin1String("ENTRY")) {
                 //parse track
-                parseTrack(xml, query);
+                const TraktorTrack track = parseTrack(xml);
+                const int trackId = trackIds.value(track.location, -1);
+                if (trackId >= 0) {
+                    bindTrack(updateQuery, track);
+                    updateQuery.bindValue(":id", trackId);
+                    if (!updateQuery.exec()) {
+                        LOG_FAILED_QUERY(updateQuery);
+                    }
+                    staleTrackIds.remove(trackId);
+                } else {
+                    bindTrack(query, track);
+                    if (!query.exec()) {
+                        LOG_FAILED_QUERY(query);
+                    } else {
+                        trackIds.insert(track.location, query.lastInsertId().toInt());
+                    }
+                }
                 ++nAudioFiles; //increment number of files in the music collection
+                if (nAudioFiles % kProgressTrackInterval == 0 && fileSize > 0) {
+                    reportImportProgress(
+                            static_cast<int>(traktor_file.pos() * 100 / fileSize));
+                }
             }
             if (xml.name() == QLatin1String("PLAYLISTS")) {
                 inPlaylistsTag = true;
@@ -255,7 +452,7 @@ TreeItem* TraktorFeature::importLibrary(const QString& file) {
 
                 if (nodetype == "FOLDER" && name == "$ROOT") {
                     //process all playlists
-                    root = parsePlaylists(xml);
+                    root = parsePlaylists(xml, trackIds);
                     isRootFolderParsed = true;
                 }
             }
@@ -263,13 +460,14 @@ TreeItem* TraktorFeature::importLibrary(const QString& file) {
         if (xml.isEndElement()) {
             if (xml.name() == QLatin1String("COLLECTION")) {
                 inCollectionTag = false;
+                removeStaleTracks(&trackIds, staleTrackIds);
             }
             if (xml.name() == QLatin1String("PLAYLISTS") && inPlaylistsTag) {
                 inPlaylistsTag = false;
             }
         }
     }
-    if (xml.hasError()) {
+    if (xml.hasError() || m_cancelImport) {
          // do error handling
          qDebug() << "Cannot process Traktor music collection";
          if (root) {
@@ -278,131 +476,88 @@ TreeItem* TraktorFeature::importLibrary(const QString& file) {
          return nullptr;
     }
 
-    qDebug() << "Found: " << nAudioFiles << " audio files in Traktor";
+    qDebug() << "Found: " << nAudioFiles << " audio files in Traktor,"
+             << staleTrackIds.size() << "have been removed since the last import";
     //initialize TraktorTableModel
     transaction.commit();
 
     return root;
 }
 
-void TraktorFeature::parseTrack(QXmlStreamReader &xml, QSqlQuery &query) {
-    QString title;
-    QString artist;
-    QString album;
-    QString year;
-    QString genre;
-    //drive letter
-    QString volume;
-    QString path;
-    QString filename;
-    QString location;
-    float bpm = 0.0;
-    int bitrate = 0;
-    QString key;
-    //duration of a track
-    int playtime = 0;
-    int rating = 0;
-    QString comment;
-    QString tracknumber;
+void TraktorFeature::removeStaleTracks(
+        QHash<QString, int>* pTrackIds, const QSet<int>& staleTrackIds) {
+    QSqlQuery deleteQuery(m_database);
+    deleteQuery.prepare("DELETE FROM traktor_library WHERE id=:id");
+    for (const int trackId : staleTrackIds) {
+        deleteQuery.bindValue(":id", trackId);
+        if (!deleteQuery.exec()) {
+            LOG_FAILED_QUERY(deleteQuery);
+        }
+    }
+    for (auto it = pTrackIds->begin(); it != pTrackIds->end();) {
+        if (staleTrackIds.contains(it.value())) {
+            it = pTrackIds->erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
 
-    //get XML attributes of starting ENTRY tag
-    QXmlStreamAttributes attr = xml.attributes ();
-    title = attr.value("TITLE").toString();
-    artist = attr.value("ARTIST").toString();
+TreeItem* TraktorFeature::loadPlaylistTree() {
+    QSqlQuery countQuery(m_database);
+    countQuery.prepare("SELECT COUNT(*) FROM traktor_library");
+    if (!countQuery.exec()) {
+        LOG_FAILED_QUERY(countQuery);
+        return nullptr;
+    }
+    if (!countQuery.next() || countQuery.value(0).toInt() == 0) {
+        // Nothing has been imported yet
+        return nullptr;
+    }
 
-    //read all sub tags of ENTRY until we reach the closing ENTRY tag
-    while (!xml.atEnd()) {
-        xml.readNext();
-        if (xml.isStartElement()) {
-            if (xml.name() == QLatin1String("ALBUM")) {
-                QXmlStreamAttributes attr = xml.attributes ();
-                album = attr.value("TITLE").toString();
-                tracknumber = attr.value("TRACK").toString();
-                continue;
-            }
-            if (xml.name() == QLatin1String("LOCATION")) {
-                QXmlStreamAttributes attr = xml.attributes ();
-                volume = attr.value("VOLUME").toString();
-                path = attr.value("DIR").toString();
-                filename = attr.value("FILE").toString();
-                // compute the location, i.e, combining all the values
-                // On Windows the volume holds the drive letter e.g., d:
-                // On OS X, the volume is supposed to be "Macintosh HD" or "Macintosh SSD",
-                // which is a folder in /Volumes/ symlinked to root folder /
-                #if defined(__APPLE__)
-                location = "/Volumes/" + volume;
-                #else
-                location = volume;
-                #endif
-                location += fromTraktorSeparators(path);
-                location += filename;
-                continue;
-            }
-            if (xml.name() == QLatin1String("INFO")) {
-                QXmlStreamAttributes attr = xml.attributes();
-                key = attr.value("KEY").toString();
-                bitrate = attr.value("BITRATE").toString().toInt() / 1000;
-                playtime = attr.value("PLAYTIME").toString().toInt();
-                genre = attr.value("GENRE").toString();
-                year = attr.value("RELEASE_DATE").toString();
-                comment = attr.value("COMMENT").toString();
-                QString ranking_str = attr.value("RANKING").toString();
-                // A ranking in Traktor has ranges between 0 and 255 internally.
-                // This is same as the POPULARIMETER tag in IDv2,
-                // see http://help.mp3tag.de/main_tags.html
-                //
-                // Our rating values range from 1 to 5. The mapping is defined as follow
-                // ourRatingValue = TraktorRating / 51
-                bool ok = false;
-                int parsed_rating = ranking_str.toInt(&ok) / 51;
-                if (ok) {
-                    rating = parsed_rating;
-                }
-                continue;
-            }
-            if (xml.name() == QLatin1String("TEMPO")) {
-                QXmlStreamAttributes attr = xml.attributes ();
-                bpm = attr.value("BPM").toString().toFloat();
-                continue;
-            }
-            if (xml.name() == QLatin1String("MUSICAL_KEY")) {
-                QXmlStreamAttributes attr = xml.attributes();
-                // Traktor happens to use the same key numbering
-                key = KeyUtils::keyToString(
-                        KeyUtils::keyFromNumericValue(
-                                attr.value("VALUE").toInt()),
-                        KeyUtils::KeyNotation::Custom);
-                continue;
-            }
+    QSqlQuery query(m_database);
+    query.prepare("SELECT name FROM traktor_playlists ORDER BY id");
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query);
+        return nullptr;
+    }
+
+    // The playlists have been inserted in the order of the tree. Folders are
+    // not stored and are created from the paths of their playlists, empty
+    // folders are missing.
+    std::unique_ptr<TreeItem> rootItem = TreeItem::newRoot(this);
+    QHash<QString, TreeItem*> folders;
+    while (query.next()) {
+        const QString playlistPath = query.value(0).toString();
+        const QStringList names = playlistPath.split(kPlaylistPathDelimiter);
+        // The paths start with the delimiter
+        if (names.size() < 2) {
+            continue;
         }
-        //We leave the infinite loop, if twe have the closing tag "ENTRY"
-        if (xml.name() == QLatin1String("ENTRY") && xml.isEndElement()) {
-            break;
+        TreeItem* parent = rootItem.get();
+        QString folderPath;
+        for (int i = 1; i < names.size() - 1; ++i) {
+            folderPath += kPlaylistPathDelimiter + names[i];
+            TreeItem*& pFolder = folders[folderPath];
+            if (!pFolder) {
+                pFolder = parent->appendChild(names[i], folderPath);
+            }
+            parent = pFolder;
         }
+        parent->appendChild(names.last(), playlistPath);
     }
+    return rootItem.release();
+}
 
-    // If we reach the end of ENTRY within the COLLECTION tag
-    // Save parsed track to database
-    query.bindValue(":artist", artist);
-    query.bindValue(":title", title);
-    query.bindValue(":album", album);
-    query.bindValue(":genre", genre);
-    query.bindValue(":year", year);
-    query.bindValue(":duration", playtime);
-    query.bindValue(":location", location);
-    query.bindValue(":rating", rating);
-    query.bindValue(":comment", comment);
-    query.bindValue(":tracknumber", tracknumber);
-    query.bindValue(":key", key);
-    query.bindValue(":bpm", bpm);
-    query.bindValue(":bitrate", bitrate);
-
-    bool success = query.exec();
-    if (!success) {
-        qDebug() << "SQL Error in TraktorTableModel.cpp: line"
-                 << __LINE__ << " " << query.lastError();
-        return;
-    }
+void TraktorFeature::reportImportProgress(int percent) {
+    // Called from the worker thread
+    QMetaObject::invokeMethod(
+            this,
+            [this, percent] {
+                m_title = tr("(loading) Traktor %1%").arg(percent);
+                emit featureIsLoading(this, false);
+            },
+            Qt::QueuedConnection);
 }
 
 // Purpose: Parsing all the folder and playlists of Traktor
@@ -410,14 +565,15 @@ void TraktorFeature::parseTrack(QXmlStreamReader &xml, QSqlQuery &query) {
 // A folder can contain folders and playlists. A playlist contains entries but no folders.
 // In other words, Traktor uses a tree structure to organize music.
 // Inner nodes represent folders while leaves are playlists.
-TreeItem* TraktorFeature::parsePlaylists(QXmlStreamReader &xml) {
+TreeItem* TraktorFeature::parsePlaylists(QXmlStreamReader& xml,
+        const QHash<QString, int>& trackIds) {
 
     qDebug() << "Process RootFolder";
     //Each playlist is unique and can be identified by a path in the tree structure.
     QString current_path = "";
     QMap<QString,QString> map;
 
-    QString delimiter = "-->";
+    const QString& delimiter = kPlaylistPathDelimiter;
 
     std::unique_ptr<TreeItem> rootItem = TreeItem::newRoot(this);
     TreeItem* parent = rootItem.get();
@@ -459,7 +615,8 @@ TreeItem* TraktorFeature::parsePlaylists(QXmlStreamReader &xml) {
                     parsePlaylistEntries(xml,
                             current_path,
                             std::move(query_insert_to_playlists),
-                            std::move(query_insert_to_playlist_tracks));
+                            std::move(query_insert_to_playlist_tracks),
+                            trackIds);
                 }
             }
         }
@@ -489,7 +646,8 @@ void TraktorFeature::parsePlaylistEntries(
         QXmlStreamReader& xml,
         const QString& playlist_path,
         QSqlQuery query_insert_into_playlist,
-        QSqlQuery query_insert_into_playlisttracks) {
+        QSqlQuery query_insert_into_playlisttracks,
+        const QHash<QString, int>& trackIds) {
     // In the database, the name of a playlist is specified by the unique path,
     // e.g., /someFolderA/someFolderB/playlistA"
     query_insert_into_playlist.bindValue(":name", playlist_path);
@@ -535,19 +693,7 @@ void TraktorFeature::parsePlaylistEntries(
                     #endif
 
                     //insert to database
-                    int track_id = -1;
-                    QSqlQuery finder_query(m_database);
-                    finder_query.prepare("select id from traktor_library where location=:path");
-                    finder_query.bindValue(":path", key);
-
-                    if (!finder_query.exec()) {
-                        LOG_FAILED_QUERY(finder_query) << "Could not get track id:" << key;
-                        continue;
-                    }
-
-                    if (finder_query.next()) {
-                        track_id = finder_query.value(finder_query.record().indexOf("id")).toInt();
-                    }
+                    int track_id = trackIds.value(key, -1);
 
                     query_insert_into_playlisttracks.bindValue(":playlist_id", playlist_id);
                     query_insert_into_playlisttracks.bindValue(":track_id", track_id);
@@ -637,6 +783,7 @@ QString TraktorFeature::getTraktorMusicDatabase() {
 void TraktorFeature::onTrackCollectionLoaded() {
     std::unique_ptr<TreeItem> root(m_future.result());
     if (root) {
+        m_pConfig->setValue(kCollectionSignatureConfigKey, m_collectionSignature);
         m_pSidebarModel->setRootItem(std::move(root));
         // Tell the traktor track source that it should re-build its index.
         m_trackSource->buildIndex();
@@ -646,6 +793,7 @@ void TraktorFeature::onTrackCollectionLoaded() {
         emit showTrackModel(m_pTraktorTableModel);
         qDebug() << "Traktor library loaded successfully";
     } else {
+        m_pConfig->setValue(kCollectionSignatureConfigKey, QString());
         QMessageBox::warning(
                 nullptr,
                 tr("Error Loading Traktor Library"),
@@ -50,16 +50,24 @@ class TraktorFeature : public BaseExternalLibraryFeature {
   private:
     std::unique_ptr<BaseSqlTableModel> createPlaylistModelForPlaylist(
             const QString& playlist) override;
-    TreeItem* importLibrary(const QString& file);
-    // parses a track in the music collection
-    void parseTrack(QXmlStreamReader &xml, QSqlQuery &query);
+    TreeItem* importLibrary(const QString& file, bool collectionUnchanged);
+    // Removes the tracks of the previous import that are no longer in the
+    // collection
+    void removeStaleTracks(QHash<QString, int>* pTrackIds,
+            const QSet<int>& staleTrackIds);
+    // Rebuilds the childmodel from the playlists of the previous import
+    TreeItem* loadPlaylistTree();
+    // Updates the title of the feature from the worker thread
+    void reportImportProgress(int percent);
     // Iterates over all playliost and folders and constructs the childmodel
-    TreeItem* parsePlaylists(QXmlStreamReader &xml);
+    TreeItem* parsePlaylists(QXmlStreamReader& xml,
+            const QHash<QString, int>& trackIds);
     // processes a particular playlist
     void parsePlaylistEntries(QXmlStreamReader& xml,
             const QString& playlist_path,
             QSqlQuery query_insert_into_playlist,
-            QSqlQuery query_insert_into_playlisttracks);
+            QSqlQuery query_insert_into_playlisttracks,
+            const QHash<QString, int>& trackIds);
     void clearTable(const QString& table_name);
     static QString getTraktorMusicDatabase();
     // private fields
@@ -74,6 +82,8 @@ class TraktorFeature : public BaseExternalLibraryFeature {
     bool m_cancelImport;
     QFutureWatcher<TreeItem*> m_future_watcher;
     QFuture<TreeItem*> m_future;
+    // The collection.nml that is imported by m_future
+    QString m_collectionSignature;
     QString m_title;
 
     QSharedPointer<BaseTrackCache> m_trackSource;
@@ -51,7 +51,8 @@ BaseTrackPlayerImpl::BaseTrackPlayerImpl(
           m_pLoadedTrack(),
           m_pPrevFailedTrackId(),
           m_replaygainPending(false),
-          m_pChannelToCloneFrom(nullptr) {
+          m_pChannelToCloneFrom(nullptr),
+          m_loadSequence(0) {
     m_pChannel = new EngineDeck(handleGroup,
             pConfig,
             pMixingEngine,
@@ -476,6 +477,8 @@ void BaseTrackPlayerImpl::slotLoadTrack(TrackPointer pNewTrack, bool bPlay) {
 
     auto pOldTrack = unloadTrack();
 
+    ++m_loadSequence;
+    m_loadTimer.start();
     loadTrack(pNewTrack);
 
     // await slotTrackLoaded()/slotLoadFailed()
@@ -614,7 +617,13 @@ void BaseTrackPlayerImpl::slotTrackLoaded(TrackPointer pNewTrack,
             }
         }
 
-        emit newTrackLoaded(m_pLoadedTrack);
+        // The engine has already seeked to the cue point and the deck is
+        // playable. Updating the waveforms, the overview and the cover art
+        // and scheduling the analysis must not hold up the event loop
+        // before the next control or load request.
+        qDebug() << getGroup() << "track playable after"
+                 << m_loadTimer.elapsed().formatMillisWithUnit();
+        emitNewTrackLoadedDeferred();
         emit trackRatingChanged(m_pLoadedTrack->getRating());
     } else {
         // this is the result from an outdated load or unload signal
@@ -630,6 +639,21 @@ void BaseTrackPlayerImpl::slotTrackLoaded(TrackPointer pNewTrack,
     PlayerInfo::instance().setTrackInfo(getGroup(), m_pLoadedTrack);
 }
 
+void BaseTrackPlayerImpl::emitNewTrackLoadedDeferred() {
+    const int loadSequence = m_loadSequence;
+    const TrackPointer pTrack = m_pLoadedTrack;
+    QMetaObject::invokeMethod(
+            this,
+            [this, loadSequence, pTrack] {
+                if (loadSequence != m_loadSequence || pTrack != m_pLoadedTrack) {
+                    // Replaced or ejected before the signal was delivered
+                    return;
+                }
+                emit newTrackLoaded(pTrack);
+            },
+            Qt::QueuedConnection);
+}
+
 TrackPointer BaseTrackPlayerImpl::getLoadedTrack() const {
     return m_pLoadedTrack;
 }
@@ -127,6 +127,11 @@ class BaseTrackPlayerImpl : public BaseTrackPlayer {
     void connectLoadedTrack();
     void disconnectLoadedTrack();
 
+    /// Notifies the waveform, overview, cover art and analysis consumers
+    /// after the track has become playable, unless another track has been
+    /// loaded in the meantime.
+    void emitNewTrackLoadedDeferred();
+
     UserSettingsPointer m_pConfig;
     EngineMixer* m_pEngineMixer;
     TrackPointer m_pLoadedTrack;
@@ -136,6 +141,10 @@ class BaseTrackPlayerImpl : public BaseTrackPlayer {
     EngineChannel* m_pChannelToCloneFrom;
 
     PerformanceTimer m_ejectTimer;
+    // Measures the time from the load request until the track is playable
+    PerformanceTimer m_loadTimer;
+    // Identifies the pending load for the deferred newTrackLoaded signal
+    int m_loadSequence;
 
     std::unique_ptr<ControlPushButton> m_pEject;
 
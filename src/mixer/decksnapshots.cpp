@@ -0,0 +1,306 @@
+#include "mixer/decksnapshots.h"
+
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+
+#include "control/controlobject.h"
+#include "control/controlproxy.h"
+#include "effects/chains/quickeffectchain.h"
+#include "mixer/basetrackplayer.h"
+#include "mixer/playermanager.h"
+#include "moc_decksnapshots.cpp"
+#include "track/track.h"
+#include "util/assert.h"
+#include "util/backgroundtask.h"
+#include "util/logger.h"
+
+namespace {
+
+const mixxx::Logger kLogger("DeckSnapshots");
+
+const ConfigKey kResumeAfterCrashConfigKey(
+        QStringLiteral("[Controls]"), QStringLiteral("ResumeDecksAfterCrash"));
+
+constexpr int kFormatVersion = 1;
+
+void writeSnapshots(const QString& filePath, const QByteArray& data) {
+    // Replaces the file atomically, a crash never leaves a truncated one
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly) ||
+            file.write(data) != data.size() ||
+            !file.commit()) {
+        kLogger.warning() << "Failed to write" << filePath << file.errorString();
+    }
+}
+
+} // anonymous namespace
+
+bool DeckSnapshot::operator==(const DeckSnapshot& other) const {
+    return group == other.group &&
+            location == other.location &&
+            position == other.position &&
+            playing == other.playing &&
+            rateRatio == other.rateRatio &&
+            pitchAdjust == other.pitchAdjust &&
+            loopStartPosition == other.loopStartPosition &&
+            loopEndPosition == other.loopEndPosition &&
+            loopEnabled == other.loopEnabled &&
+            quickEffectEnabled == other.quickEffectEnabled &&
+            quickEffectSuper == other.quickEffectSuper;
+}
+
+struct DeckSnapshots::DeckControls {
+    explicit DeckControls(const QString& group)
+            : playPosition(ConfigKey(group, QStringLiteral("playposition"))),
+              play(ConfigKey(group, QStringLiteral("play"))),
+              rateRatio(ConfigKey(group, QStringLiteral("rate_ratio"))),
+              pitchAdjust(ConfigKey(group, QStringLiteral("pitch_adjust"))),
+              loopStartPosition(ConfigKey(group, QStringLiteral("loop_start_position"))),
+              loopEndPosition(ConfigKey(group, QStringLiteral("loop_end_position"))),
+              loopEnabled(ConfigKey(group, QStringLiteral("loop_enabled"))),
+              quickEffectEnabled(ConfigKey(
+                      QuickEffectChain::formatEffectChainGroup(group),
+                      QStringLiteral("enabled"))),
+              quickEffectSuper(ConfigKey(
+                      QuickEffectChain::formatEffectChainGroup(group),
+                      QStringLiteral("super1"))) {
+    }
+
+    ControlProxy playPosition;
+    ControlProxy play;
+    ControlProxy rateRatio;
+    ControlProxy pitchAdjust;
+    ControlProxy loopStartPosition;
+    ControlProxy loopEndPosition;
+    ControlProxy loopEnabled;
+    ControlProxy quickEffectEnabled;
+    ControlProxy quickEffectSuper;
+};
+
+DeckSnapshots::DeckSnapshots(UserSettingsPointer pConfig, PlayerManager* pPlayerManager)
+        : QObject(pPlayerManager),
+          m_pConfig(std::move(pConfig)),
+          m_pPlayerManager(pPlayerManager),
+          m_filePath(m_pConfig->getSettingsPath() + QStringLiteral("/decks.snapshot")) {
+    DEBUG_ASSERT(m_pPlayerManager);
+    m_timer.setInterval(kSnapshotIntervalMillis);
+    connect(&m_timer, &QTimer::timeout, this, &DeckSnapshots::slotTimeout);
+}
+
+DeckSnapshots::~DeckSnapshots() {
+    m_timer.stop();
+    m_pendingWrite.waitForFinished();
+}
+
+// static
+QByteArray DeckSnapshots::serialize(const QList<DeckSnapshot>& snapshots) {
+    QJsonArray decks;
+    for (const auto& snapshot : snapshots) {
+        QJsonObject deck;
+        deck.insert(QStringLiteral("group"), snapshot.group);
+        deck.insert(QStringLiteral("location"), snapshot.location);
+        deck.insert(QStringLiteral("position"), snapshot.position);
+        deck.insert(QStringLiteral("playing"), snapshot.playing);
+        deck.insert(QStringLiteral("rate_ratio"), snapshot.rateRatio);
+        deck.insert(QStringLiteral("pitch_adjust"), snapshot.pitchAdjust);
+        deck.insert(QStringLiteral("loop_start_position"), snapshot.loopStartPosition);
+        deck.insert(QStringLiteral("loop_end_position"), snapshot.loopEndPosition);
+        deck.insert(QStringLiteral("loop_enabled"), snapshot.loopEnabled);
+        deck.insert(QStringLiteral("quick_effect_enabled"), snapshot.quickEffectEnabled);
+        deck.insert(QStringLiteral("quick_effect_super1"), snapshot.quickEffectSuper);
+        decks.append(deck);
+    }
+    QJsonObject root;
+    root.insert(QStringLiteral("version"), kFormatVersion);
+    root.insert(QStringLiteral("decks"), decks);
+    return QJsonDocument(root).toJson(QJsonDocument::Compact);
+}
+
+// static
+std::optional<QList<DeckSnapshot>> DeckSnapshots::parse(const QByteArray& data) {
+    const QJsonDocument document = QJsonDocument::fromJson(data);
+    const QJsonObject root = document.object();
+    if (root.value(QStringLiteral("version")).toInt() != kFormatVersion) {
+        return std::nullopt;
+    }
+    QList<DeckSnapshot> snapshots;
+    const QJsonArray decks = root.value(QStringLiteral("decks")).toArray();
+    for (const auto& value : decks) {
+        const QJsonObject deck = value.toObject();
+        DeckSnapshot snapshot;
+        snapshot.group = deck.value(QStringLiteral("group")).toString();
+        if (snapshot.group.isEmpty()) {
+            return std::nullopt;
+        }
+        snapshot.location = deck.value(QStringLiteral("location")).toString();
+        snapshot.position = deck.value(QStringLiteral("position")).toDouble();
+        snapshot.playing = deck.value(QStringLiteral("playing")).toBool();
+        snapshot.rateRatio = deck.value(QStringLiteral("rate_ratio")).toDouble(1.0);
+        snapshot.pitchAdjust = deck.value(QStringLiteral("pitch_adjust")).toDouble();
+        snapshot.loopStartPosition =
+                deck.value(QStringLiteral("loop_start_position")).toDouble(-1.0);
+        snapshot.loopEndPosition =
+                deck.value(QStringLiteral("loop_end_position")).toDouble(-1.0);
+        snapshot.loopEnabled = deck.value(QStringLiteral("loop_enabled")).toBool();
+        snapshot.quickEffectEnabled =
+                deck.value(QStringLiteral("quick_effect_enabled")).toBool(true);
+        snapshot.quickEffectSuper =
+                deck.value(QStringLiteral("quick_effect_super1")).toDouble();
+        snapshots.append(snapshot);
+    }
+    return snapshots;
+}
+
+bool DeckSnapshots::resume() {
+    QFile file(m_filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        // Mixxx has been shut down properly
+        return false;
+    }
+    const auto snapshots = parse(file.readAll());
+    file.close();
+    if (!snapshots) {
+        kLogger.warning() << "Ignoring invalid snapshot" << m_filePath;
+        return false;
+    }
+    if (!m_pConfig->getValue(kResumeAfterCrashConfigKey, true)) {
+        return false;
+    }
+
+    int count = 0;
+    for (const auto& snapshot : *snapshots) {
+        if (snapshot.location.isEmpty()) {
+            continue;
+        }
+        BaseTrackPlayer* pPlayer = m_pPlayerManager->getPlayer(snapshot.group);
+        if (!pPlayer || !PlayerManager::isDeckGroup(snapshot.group)) {
+            continue;
+        }
+        m_pendingRestores.insert(snapshot.group, snapshot);
+        connect(pPlayer,
+                &BaseTrackPlayer::newTrackLoaded,
+                this,
+                [this, group = snapshot.group](TrackPointer pTrack) {
+                    const auto it = m_pendingRestores.constFind(group);
+                    if (it == m_pendingRestores.constEnd()) {
+                        return;
+                    }
+                    const DeckSnapshot snapshot = it.value();
+                    m_pendingRestores.erase(it);
+                    restore(snapshot, pTrack);
+                });
+        // The decks open and decode their tracks in parallel, each on the
+        // worker thread of its reader.
+        m_pPlayerManager->slotLoadLocationToPlayer(
+                snapshot.location, snapshot.group, false);
+        ++count;
+    }
+    kLogger.info() << "Resuming" << count << "decks after a crash";
+    return count > 0;
+}
+
+void DeckSnapshots::restore(const DeckSnapshot& snapshot, const TrackPointer& pTrack) {
+    if (!pTrack || pTrack->getLocation() != snapshot.location) {
+        // Another track has been loaded in the meantime
+        return;
+    }
+    const QString& group = snapshot.group;
+    ControlObject::set(ConfigKey(group, QStringLiteral("rate_ratio")), snapshot.rateRatio);
+    ControlObject::set(ConfigKey(group, QStringLiteral("pitch_adjust")), snapshot.pitchAdjust);
+    if (snapshot.loopStartPosition >= 0 && snapshot.loopEndPosition > snapshot.loopStartPosition) {
+        ControlObject::set(ConfigKey(group, QStringLiteral("loop_start_position")),
+                snapshot.loopStartPosition);
+        ControlObject::set(ConfigKey(group, QStringLiteral("loop_end_position")),
+                snapshot.loopEndPosition);
+    }
+    // Seeking right after the load makes the reader fetch the chunks around
+    // the saved position instead of those around the cue point, while the
+    // deck is still paused.
+    ControlObject::set(ConfigKey(group, QStringLiteral("playposition")), snapshot.position);
+    if (snapshot.loopEnabled &&
+            !ControlObject::toBool(ConfigKey(group, QStringLiteral("loop_enabled")))) {
+        ControlObject::set(ConfigKey(group, QStringLiteral("reloop_toggle")), 1.0);
+    }
+    const QString quickEffectGroup = QuickEffectChain::formatEffectChainGroup(group);
+    ControlObject::set(ConfigKey(quickEffectGroup, QStringLiteral("enabled")),
+            snapshot.quickEffectEnabled ? 1.0 : 0.0);
+    ControlObject::set(ConfigKey(quickEffectGroup, QStringLiteral("super1")),
+            snapshot.quickEffectSuper);
+    if (snapshot.playing) {
+        ControlObject::set(ConfigKey(group, QStringLiteral("play")), 1.0);
+    }
+    kLogger.info() << "Resumed" << group << "at" << snapshot.position;
+}
+
+void DeckSnapshots::start() {
+    m_timer.start();
+}
+
+void DeckSnapshots::discard() {
+    m_timer.stop();
+    m_pendingWrite.waitForFinished();
+    if (QFile::exists(m_filePath) && !QFile::remove(m_filePath)) {
+        kLogger.warning() << "Failed to remove" << m_filePath;
+    }
+}
+
+QList<DeckSnapshot> DeckSnapshots::takeSnapshots() {
+    const auto numDecks = static_cast<int>(PlayerManager::numDecks());
+    while (static_cast<int>(m_deckControls.size()) < numDecks) {
+        m_deckControls.push_back(std::make_unique<DeckControls>(
+                PlayerManager::groupForDeck(static_cast<int>(m_deckControls.size()))));
+    }
+
+    QList<DeckSnapshot> snapshots;
+    snapshots.reserve(numDecks);
+    for (int i = 0; i < numDecks; ++i) {
+        const QString group = PlayerManager::groupForDeck(i);
+        const auto it = m_pendingRestores.constFind(group);
+        if (it != m_pendingRestores.constEnd()) {
+            // Keep the snapshot of a deck that is still loading, in case
+            // Mixxx crashes again before it has been restored.
+            snapshots.append(it.value());
+            continue;
+        }
+        DeckSnapshot snapshot;
+        snapshot.group = group;
+        const BaseTrackPlayer* pPlayer = m_pPlayerManager->getPlayer(group);
+        const TrackPointer pTrack = pPlayer ? pPlayer->getLoadedTrack() : TrackPointer();
+        if (pTrack) {
+            const DeckControls& controls = *m_deckControls[i];
+            snapshot.location = pTrack->getLocation();
+            snapshot.position = controls.playPosition.get();
+            snapshot.playing = controls.play.toBool();
+            snapshot.rateRatio = controls.rateRatio.get();
+            snapshot.pitchAdjust = controls.pitchAdjust.get();
+            snapshot.loopStartPosition = controls.loopStartPosition.get();
+            snapshot.loopEndPosition = controls.loopEndPosition.get();
+            snapshot.loopEnabled = controls.loopEnabled.toBool();
+            snapshot.quickEffectEnabled = controls.quickEffectEnabled.toBool();
+            snapshot.quickEffectSuper = controls.quickEffectSuper.get();
+        }
+        snapshots.append(snapshot);
+    }
+    return snapshots;
+}
+
+void DeckSnapshots::slotTimeout() {
+    if (m_pendingWrite.isRunning()) {
+        // The state is picked up on the next invocation
+        return;
+    }
+    const QByteArray data = serialize(takeSnapshots());
+    if (data == m_lastWritten) {
+        // Nothing has changed, e.g. while no deck is playing
+        return;
+    }
+    m_lastWritten = data;
+    m_pendingWrite = mixxx::backgroundtask::run(
+            mixxx::BackgroundTaskPriority::Interactive,
+            [filePath = m_filePath, data] {
+                writeSnapshots(filePath, data);
+            });
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <QByteArray>
+#include <QFuture>
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QTimer>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "preferences/usersettings.h"
+#include "track/track_decl.h"
+
+class ControlProxy;
+class PlayerManager;
+
+/// The state of a deck that is needed to continue playing after a crash
+struct DeckSnapshot {
+    QString group;
+    QString location;
+    double position = 0.0;
+    bool playing = false;
+    double rateRatio = 1.0;
+    double pitchAdjust = 0.0;
+    double loopStartPosition = -1.0;
+    double loopEndPosition = -1.0;
+    bool loopEnabled = false;
+    bool quickEffectEnabled = true;
+    double quickEffectSuper = 0.0;
+
+    bool operator==(const DeckSnapshot& other) const;
+    bool operator!=(const DeckSnapshot& other) const {
+        return !(*this == other);
+    }
+};
+
+/// Periodically saves the state of all decks, so Mixxx can resume playing
+/// within seconds when it is restarted after a crash.
+///
+/// The values are read from the controls, which are lock-free for the
+/// engine, and the snapshot is written atomically by a background task
+/// only if it has changed. The file is removed on a clean shutdown, so it
+/// only exists after a crash. Persistent controls like the effect unit
+/// assignments are already restored by ControlPersistence.
+class DeckSnapshots : public QObject {
+    Q_OBJECT
+  public:
+    static constexpr int kSnapshotIntervalMillis = 1000;
+
+    DeckSnapshots(UserSettingsPointer pConfig, PlayerManager* pPlayerManager);
+    ~DeckSnapshots() override;
+
+    static QByteArray serialize(const QList<DeckSnapshot>& snapshots);
+    /// Returns std::nullopt if the data is not a valid snapshot
+    static std::optional<QList<DeckSnapshot>> parse(const QByteArray& data);
+
+    /// Loads the tracks of a snapshot that has been left by a crash into
+    /// the decks and restores their state once they are loaded. Returns
+    /// false if there is nothing to resume.
+    bool resume();
+
+    /// Starts taking snapshots
+    void start();
+    /// Stops taking snapshots and removes the file on a clean shutdown
+    void discard();
+
+  private slots:
+    void slotTimeout();
+
+  private:
+    struct DeckControls;
+
+    QList<DeckSnapshot> takeSnapshots();
+    void restore(const DeckSnapshot& snapshot, const TrackPointer& pTrack);
+
+    const UserSettingsPointer m_pConfig;
+    PlayerManager* const m_pPlayerManager;
+    const QString m_filePath;
+    QTimer m_timer;
+
+    std::vector<std::unique_ptr<DeckControls>> m_deckControls;
+    QByteArray m_lastWritten;
+    QFuture<void> m_pendingWrite;
+
+    /// The snapshots of the decks that are still loading their track
+    QHash<QString, DeckSnapshot> m_pendingRestores;
+};
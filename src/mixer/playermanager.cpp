@@ -10,6 +10,7 @@
 #include "library/trackcollectionmanager.h"
 #include "mixer/auxiliary.h"
 #include "mixer/deck.h"
+#include "mixer/decksnapshots.h"
 #include "mixer/microphone.h"
 #include "mixer/previewdeck.h"
 #include "mixer/sampler.h"
@@ -139,6 +140,7 @@ PlayerManager::PlayerManager(UserSettingsPointer pConfig,
 
     // This is parented to the PlayerManager so does not need to be deleted
     m_pSamplerBank = new SamplerBank(m_pConfig, this);
+    m_pDeckSnapshots = new DeckSnapshots(m_pConfig, this);
 
     m_cloneTimer.start();
 }
@@ -149,6 +151,8 @@ PlayerManager::~PlayerManager() {
     const auto locker = lockMutex(&m_mutex);
 
     m_pSamplerBank->saveSamplerBankToPath(getDefaultSamplerPath(m_pConfig));
+    // The snapshot is only needed after a crash
+    m_pDeckSnapshots->discard();
     // No need to delete anything because they are all parented to us and will
     // be destroyed when we are destroyed.
     m_players.clear();
@@ -187,8 +191,6 @@ void PlayerManager::bindToLibrary(Library* pLibrary) {
 
     connect(m_pTrackAnalysisScheduler.get(), &TrackAnalysisScheduler::trackProgress,
             this, &PlayerManager::onTrackAnalysisProgress);
-    connect(m_pTrackAnalysisScheduler.get(), &TrackAnalysisScheduler::finished,
-            this, &PlayerManager::onTrackAnalysisFinished);
 
     // Connect the player to the analyzer queue so that loaded tracks are
     // analyzed.
@@ -453,6 +455,12 @@ void PlayerManager::loadSamplers() {
     m_pSamplerBank->loadSamplerBankFromPath(getDefaultSamplerPath(m_pConfig));
 }
 
+bool PlayerManager::startDeckSnapshots(bool resume) {
+    const bool resumed = resume && m_pDeckSnapshots->resume();
+    m_pDeckSnapshots->start();
+    return resumed;
+}
+
 void PlayerManager::addSampler() {
     const auto locker = lockMutex(&m_mutex);
     double count = m_pCONumSamplers->get() + 1;
@@ -778,12 +786,20 @@ void PlayerManager::slotAnalyzeTrack(TrackPointer track) {
         return;
     }
     if (m_pTrackAnalysisScheduler) {
-        if (m_pTrackAnalysisScheduler->scheduleTrack(track->getId())) {
+        // Show a coarse waveform while the track is analyzed
+        AnalyzerTrack::Options options;
+        options.withWaveformPreview = true;
+        // The analysis of tracks in decks and samplers pauses a running
+        // batch analysis, previews only yield to them
+        const auto priority = qobject_cast<PreviewDeck*>(sender())
+                ? AnalyzerScheduledTrack::Priority::Preview
+                : AnalyzerScheduledTrack::Priority::Deck;
+        if (m_pTrackAnalysisScheduler->scheduleTrack(
+                    AnalyzerScheduledTrack(track->getId(), options, priority))) {
             m_pTrackAnalysisScheduler->resume();
         }
-        // The first progress signal will suspend a running batch analysis
-        // until all loaded tracks have been analyzed. Emit it once just now
-        // before any signals from the analyzer queue arrive.
+        // Emit the first progress signal just now before any signals from
+        // the analyzer queue arrive.
         emit trackAnalyzerProgress(track->getId(), kAnalyzerProgressUnknown);
     }
 }
@@ -803,7 +819,3 @@ void PlayerManager::slotSaveEjectedTrack(TrackPointer track) {
 void PlayerManager::onTrackAnalysisProgress(TrackId trackId, AnalyzerProgress analyzerProgress) {
     emit trackAnalyzerProgress(trackId, analyzerProgress);
 }
-
-void PlayerManager::onTrackAnalysisFinished() {
-    emit trackAnalyzerIdle();
-}
@@ -18,6 +18,7 @@ class Auxiliary;
 class BaseTrackPlayer;
 class ControlObject;
 class Deck;
+class DeckSnapshots;
 class EffectsManager;
 class EngineMixer;
 class Library;
@@ -75,6 +76,11 @@ class PlayerManager : public QObject, public PlayerManagerInterface {
     // Load samplers from samplers.xml file in config directory
     void loadSamplers();
 
+    // Starts saving the state of the decks periodically. If resume is true
+    // and Mixxx has crashed, the decks are restored from the last snapshot
+    // first. Returns true if any deck is resumed.
+    bool startDeckSnapshots(bool resume);
+
     // Add a PreviewDeck to the PlayerManager
     void addPreviewDeck();
 
@@ -218,7 +224,6 @@ class PlayerManager : public QObject, public PlayerManagerInterface {
     void slotAnalyzeTrack(TrackPointer track);
 
     void onTrackAnalysisProgress(TrackId trackId, AnalyzerProgress analyzerProgress);
-    void onTrackAnalysisFinished();
 
   signals:
     void loadLocationToPlayer(const QString& location, const QString& group, bool play);
@@ -244,7 +249,6 @@ class PlayerManager : public QObject, public PlayerManagerInterface {
     void numberOfSamplersChanged(int samplers);
 
     void trackAnalyzerProgress(TrackId trackId, AnalyzerProgress analyzerProgress);
-    void trackAnalyzerIdle();
 
   private:
     TrackPointer lookupTrack(QString location);
@@ -276,6 +280,7 @@ class PlayerManager : public QObject, public PlayerManagerInterface {
     EffectsManager* m_pEffectsManager;
     EngineMixer* m_pEngine;
     SamplerBank* m_pSamplerBank;
+    DeckSnapshots* m_pDeckSnapshots;
     std::unique_ptr<ControlObject> m_pCONumDecks;
     std::unique_ptr<ControlObject> m_pCONumSamplers;
     std::unique_ptr<ControlObject> m_pCONumPreviewDecks;
@@ -0,0 +1,222 @@
+// mixxx-analyze: Headless batch analysis of library tracks
+//
+// Analyzes tracks from files, directories, crates, or the whole library
+// without starting the GUI. The results are stored in the database of
+// the given settings directory, e.g. for pre-analyzing a collection on
+// a build server and copying the resulting mixxxdb.sqlite afterwards.
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDir>
+#include <QTextStream>
+#include <QThread>
+#include <QtDebug>
+#include <cstdio>
+
+#include "config.h"
+#include "database/mixxxdb.h"
+#include "library/batchanalyzer.h"
+#include "library/trackcollectionmanager.h"
+#include "preferences/usersettings.h"
+#include "sources/soundsourceproxy.h"
+#include "util/cmdlineargs.h"
+#include "util/db/dbconnectionpooled.h"
+#include "util/db/dbconnectionpooler.h"
+#include "util/logging.h"
+#include "util/time.h"
+#include "util/versionstore.h"
+
+namespace {
+
+// Exit codes
+constexpr int kFatalErrorOnStartupExitCode = 1;
+constexpr int kParseCmdlineArgsErrorExitCode = 2;
+
+const ConfigKey kWaveformGenerationConfigKey =
+        ConfigKey(QStringLiteral("[Library]"),
+                QStringLiteral("EnableWaveformGenerationWithAnalysis"));
+
+int analyzeTracks(
+        QCoreApplication* pApp,
+        const QCommandLineParser& parser,
+        const UserSettingsPointer& pConfig,
+        const mixxx::DbConnectionPoolPtr& pDbConnectionPool,
+        TrackCollectionManager* pTrackCollectionManager,
+        QTextStream* pOutput) {
+    BatchAnalyzer batchAnalyzer(
+            pConfig,
+            pDbConnectionPool,
+            pTrackCollectionManager,
+            pOutput);
+
+    const QStringList crateNames = parser.values(QStringLiteral("crate"));
+    for (const auto& crateName : crateNames) {
+        if (batchAnalyzer.addCrate(crateName) < 0) {
+            qCritical() << "Crate not found:" << crateName;
+            return kParseCmdlineArgsErrorExitCode;
+        }
+    }
+    const QStringList paths = parser.positionalArguments();
+    for (const auto& path : paths) {
+        *pOutput << "Adding " << path << '\n';
+        pOutput->flush();
+        batchAnalyzer.addPath(path);
+    }
+    if (crateNames.isEmpty() && paths.isEmpty()) {
+        batchAnalyzer.addAllLibraryTracks();
+    }
+
+    const bool pipelined = parser.isSet(QStringLiteral("pipelined"));
+    int numWorkerThreads = TrackAnalysisScheduler::defaultWorkerThreadCount(pipelined);
+    if (parser.isSet(QStringLiteral("threads"))) {
+        bool ok = false;
+        numWorkerThreads = parser.value(QStringLiteral("threads")).toInt(&ok);
+        if (!ok || numWorkerThreads <= 0) {
+            qCritical() << "Invalid number of threads:"
+                        << parser.value(QStringLiteral("threads"));
+            return kParseCmdlineArgsErrorExitCode;
+        }
+    }
+    int modeFlags = AnalyzerModeFlags::WithBeats;
+    if (!parser.isSet(QStringLiteral("no-waveforms")) &&
+            pConfig->getValue<bool>(kWaveformGenerationConfigKey, true)) {
+        modeFlags |= AnalyzerModeFlags::WithWaveform;
+    }
+    if (pipelined) {
+        modeFlags |= AnalyzerModeFlags::Pipelined;
+    }
+
+    *pOutput << "Analyzing " << batchAnalyzer.trackIds().size()
+             << " tracks with " << numWorkerThreads
+             << (pipelined ? " pipelined" : "") << " worker threads\n";
+    pOutput->flush();
+    QObject::connect(&batchAnalyzer,
+            &BatchAnalyzer::finished,
+            pApp,
+            &QCoreApplication::quit);
+    if (!batchAnalyzer.start(
+                numWorkerThreads, static_cast<AnalyzerModeFlags>(modeFlags))) {
+        return 0; // nothing to do
+    }
+    return pApp->exec();
+}
+
+int runAnalysis(
+        QCoreApplication* pApp,
+        const QCommandLineParser& parser,
+        const UserSettingsPointer& pConfig,
+        QTextStream* pOutput) {
+    const MixxxDb mixxxDb(pConfig);
+    const mixxx::DbConnectionPooler dbConnectionPooler(mixxxDb.connectionPool());
+    {
+        const QSqlDatabase dbConnection = mixxx::DbConnectionPooled(mixxxDb.connectionPool());
+        if (!dbConnection.isOpen()) {
+            qCritical() << "Unable to establish a database connection";
+            return kFatalErrorOnStartupExitCode;
+        }
+        if (!MixxxDb::initDatabaseSchema(dbConnection)) {
+            qCritical() << "Failed to initialize or upgrade the database schema";
+            return kFatalErrorOnStartupExitCode;
+        }
+    }
+
+    TrackCollectionManager trackCollectionManager(
+            nullptr,
+            pConfig,
+            mixxxDb.connectionPool());
+    const int exitCode = analyzeTracks(
+            pApp,
+            parser,
+            pConfig,
+            mixxxDb.connectionPool(),
+            &trackCollectionManager,
+            pOutput);
+    // Delete the scheduler and the tracks that have been released
+    // outside of or after leaving the event loop.
+    QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+    return exitCode;
+}
+
+} // anonymous namespace
+
+int main(int argc, char* argv[]) {
+    QCoreApplication::setOrganizationDomain("mixxx.org");
+    QCoreApplication::setApplicationName(VersionStore::applicationName());
+    QCoreApplication::setApplicationVersion(VersionStore::version());
+
+    QCoreApplication app(argc, argv);
+    QThread::currentThread()->setObjectName("Main");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QCoreApplication::translate("main",
+            "Analyzes tracks without starting the Mixxx GUI. Without any "
+            "files, directories, or crates all tracks of the library are "
+            "analyzed. Files and directories are added to the library."));
+    parser.addHelpOption();
+    parser.addVersionOption();
+    parser.addPositionalArgument(QStringLiteral("path"),
+            QCoreApplication::translate("main",
+                    "Audio file or directory that is scanned recursively."),
+            QStringLiteral("[path...]"));
+    parser.addOption(QCommandLineOption(QStringLiteral("settings-path"),
+            QCoreApplication::translate("main",
+                    "Directory with the settings and the library database."),
+            QStringLiteral("path")));
+    parser.addOption(QCommandLineOption(QStringLiteral("crate"),
+            QCoreApplication::translate("main",
+                    "Analyze the tracks of a crate. Can be repeated."),
+            QStringLiteral("name")));
+    parser.addOption(QCommandLineOption(QStringLiteral("threads"),
+            QCoreApplication::translate("main",
+                    "Number of worker threads. Defaults to the number of "
+                    "cores, limited by the available memory."),
+            QStringLiteral("count")));
+    parser.addOption(QCommandLineOption(QStringLiteral("pipelined"),
+            QCoreApplication::translate("main",
+                    "Run the analyzers of each track in parallel.")));
+    parser.addOption(QCommandLineOption(QStringLiteral("no-waveforms"),
+            QCoreApplication::translate("main",
+                    "Skip the generation of waveforms.")));
+    parser.addOption(QCommandLineOption(QStringLiteral("verbose"),
+            QCoreApplication::translate("main",
+                    "Print informational log messages.")));
+    parser.process(app);
+
+    QString settingsPath = parser.isSet(QStringLiteral("settings-path"))
+            ? parser.value(QStringLiteral("settings-path"))
+            : CmdlineArgs::Instance().getSettingsPath();
+    if (!settingsPath.endsWith(QChar('/'))) {
+        settingsPath.append(QChar('/'));
+    }
+    if (!QDir(settingsPath).exists() && !QDir().mkpath(settingsPath)) {
+        qCritical() << "Failed to create settings directory" << settingsPath;
+        return kParseCmdlineArgsErrorExitCode;
+    }
+
+    mixxx::Time::start();
+    // Don't clobber the log file of the GUI, that might be running
+    // with the same settings at the same time
+    mixxx::Logging::initialize(
+            settingsPath,
+            parser.isSet(QStringLiteral("verbose")) ? mixxx::LogLevel::Info
+                                                    : mixxx::kLogLevelDefault,
+            mixxx::kLogFlushLevelDefault,
+            mixxx::LogFlag::None);
+
+    int exitCode;
+    if (SoundSourceProxy::registerProviders()) {
+        const UserSettingsPointer pConfig(new UserSettings(
+                QDir(settingsPath).filePath(MIXXX_SETTINGS_FILE),
+                QString(),
+                settingsPath));
+        QTextStream output(stdout);
+        exitCode = runAnalysis(&app, parser, pConfig, &output);
+    } else {
+        qCritical() << "Failed to register any SoundSource providers";
+        exitCode = kFatalErrorOnStartupExitCode;
+    }
+
+    mixxx::Logging::shutdown();
+
+    return exitCode;
+}
@@ -5,6 +5,7 @@
 #include <QDesktopServices>
 #include <QFileDialog>
 #include <QOpenGLContext>
+#include <QTimer>
 #include <QUrl>
 
 #if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
@@ -49,6 +50,7 @@
 #include "track/track.h"
 #include "util/debug.h"
 #include "util/sandbox.h"
+#include "util/startupprofiler.h"
 #include "util/timer.h"
 #include "util/versionstore.h"
 #include "waveform/guitick.h"
@@ -119,6 +121,7 @@ MixxxMainWindow::MixxxMainWindow(std::shared_ptr<mixxx::CoreServices> pCoreServi
     // Show launch image immediately so the user knows Mixxx is starting
     m_pSkinLoader = std::make_unique<mixxx::skin::SkinLoader>(m_pCoreServices->getSettings());
     m_pLaunchImage = m_pSkinLoader->loadLaunchImage(this);
+    m_pSkinLoader->prefetchConfiguredSkin();
     m_pCentralWidget = (QWidget*)m_pLaunchImage;
     setCentralWidget(m_pCentralWidget);
 
@@ -197,6 +200,7 @@ void MixxxMainWindow::initialize() {
         showFullScreen();
     }
 
+    mixxx::StartupProfiler::beginPhase(QStringLiteral("skin"));
     initializationProgressUpdate(65, tr("skin"));
 
     // Install an event filter to catch certain QT events, such as tooltips.
@@ -317,6 +321,8 @@ void MixxxMainWindow::initialize() {
         checkDirectRendering();
     }
 
+    mixxx::StartupProfiler::beginPhase(QStringLiteral("sound devices"));
+
     // Sound hardware setup
     // Try to open configured devices. If that fails, display dialogs
     // that allow to either retry, reconfigure devices or exit.
@@ -391,6 +397,14 @@ void MixxxMainWindow::initialize() {
             &PlayerInfo::currentPlayingTrackChanged,
             this,
             &MixxxMainWindow::slotUpdateWindowTitle);
+
+    // The libraries of other applications are not needed to start. They are
+    // added as soon as the event loop is running.
+    QTimer::singleShot(0,
+            m_pCoreServices->getLibrary().get(),
+            &Library::addExternalFeatures);
+
+    mixxx::StartupProfiler::finish();
 }
 
 MixxxMainWindow::~MixxxMainWindow() {
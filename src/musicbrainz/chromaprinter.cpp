@@ -31,50 +31,60 @@ namespace
 // --kain88 July 2012
     constexpr SINT kFingerprintDuration = 120; // in seconds
 
+// Number of frames that are decoded and fed into Chromaprint at once.
+// Streaming the audio in chunks avoids to allocate buffers for the
+// whole fingerprint duration.
+constexpr SINT kFingerprintChunkFrames = 16384;
+
 QString calcFingerprint(
         mixxx::AudioSourceStereoProxy& audioSourceProxy,
         mixxx::IndexRange fingerprintRange) {
-    PerformanceTimer timerReadingFile;
-    timerReadingFile.start();
-
-    mixxx::SampleBuffer sampleBuffer(math_max(
-            fingerprintRange.length(),
-            audioSourceProxy.getSignalInfo().frames2samples(fingerprintRange.length())));
-    const auto readableSampleFrames =
-            audioSourceProxy.readSampleFrames(
-                    mixxx::WritableSampleFrames(
-                            fingerprintRange,
-                            mixxx::SampleBuffer::WritableSlice(sampleBuffer)));
-    if (fingerprintRange != readableSampleFrames.frameIndexRange()) {
-        qWarning() << "Failed to read sample data for fingerprint";
-        return QString();
-    }
-
-    std::vector<SAMPLE> fingerprintSamples(
-            audioSourceProxy.getSignalInfo().frames2samples(
-                    readableSampleFrames.frameLength()));
-    // Convert floating-point to integer
-    SampleUtil::convertFloat32ToS16(
-            &fingerprintSamples[0],
-            sampleBuffer.data(),
-            static_cast<SINT>(fingerprintSamples.size()));
+    PerformanceTimer timerGeneratingFingerprint;
+    timerGeneratingFingerprint.start();
 
-    qDebug() << "reading file took" << timerReadingFile.elapsed().debugMillisWithUnit();
+    const auto signalInfo = audioSourceProxy.getSignalInfo();
+    const SINT chunkFrames = math_min(kFingerprintChunkFrames, fingerprintRange.length());
+    mixxx::SampleBuffer sampleBuffer(signalInfo.frames2samples(chunkFrames));
+    std::vector<SAMPLE> fingerprintSamples(sampleBuffer.size());
 
     ChromaprintContext* ctx = chromaprint_new(CHROMAPRINT_ALGORITHM_DEFAULT);
     chromaprint_start(
             ctx,
-            audioSourceProxy.getSignalInfo().getSampleRate(),
-            audioSourceProxy.getSignalInfo().getChannelCount());
-
-    PerformanceTimer timerGeneratingFingerprint;
-    timerGeneratingFingerprint.start();
-    const int success = chromaprint_feed(
-            ctx,
-            &fingerprintSamples[0],
-            static_cast<int>(fingerprintSamples.size()));
-    chromaprint_finish(ctx);
-    if (!success) {
+            signalInfo.getSampleRate(),
+            signalInfo.getChannelCount());
+
+    SINT frameIndex = fingerprintRange.start();
+    while (frameIndex < fingerprintRange.end()) {
+        const auto chunkRange = mixxx::IndexRange::between(
+                frameIndex,
+                math_min(frameIndex + chunkFrames, fingerprintRange.end()));
+        const auto readableSampleFrames =
+                audioSourceProxy.readSampleFrames(
+                        mixxx::WritableSampleFrames(
+                                chunkRange,
+                                mixxx::SampleBuffer::WritableSlice(sampleBuffer)));
+        if (chunkRange != readableSampleFrames.frameIndexRange()) {
+            qWarning() << "Failed to read sample data for fingerprint";
+            chromaprint_free(ctx);
+            return QString();
+        }
+        const SINT numSamples = readableSampleFrames.readableLength();
+        // Convert floating-point to integer
+        SampleUtil::convertFloat32ToS16(
+                fingerprintSamples.data(),
+                readableSampleFrames.readableData(),
+                numSamples);
+        if (!chromaprint_feed(
+                    ctx,
+                    fingerprintSamples.data(),
+                    static_cast<int>(numSamples))) {
+            qWarning() << "Failed to generate fingerprint from sample data";
+            chromaprint_free(ctx);
+            return QString();
+        }
+        frameIndex = chunkRange.end();
+    }
+    if (!chromaprint_finish(ctx)) {
         qWarning() << "Failed to generate fingerprint from sample data";
         chromaprint_free(ctx);
         return QString();
@@ -130,7 +140,7 @@ QString ChromaPrinter::getFingerprint(TrackPointer pTrack) {
                     kFingerprintDuration * pAudioSource->getSignalInfo().getSampleRate()));
     mixxx::AudioSourceStereoProxy audioSourceProxy(
             pAudioSource,
-            fingerprintRange.length());
+            math_min(kFingerprintChunkFrames, fingerprintRange.length()));
 
     return calcFingerprint(audioSourceProxy, fingerprintRange);
 }
@@ -22,11 +22,16 @@ constexpr int kCoverArtArchiveLinksTimeoutMilis = 60000; // msec
 // Long timeout to cope with occasional server-side unresponsiveness
 constexpr int kCoverArtArchiveImageTimeoutMilis = 60000; // msec
 
+// Number of tracks for which fingerprints and lookup results are kept
+constexpr int kMaxCachedTracks = 1000;
+
 } // anonymous namespace
 
 TagFetcher::TagFetcher(QObject* parent)
         : QObject(parent),
-          m_fingerprintWatcher(this) {
+          m_fingerprintWatcher(this),
+          m_fingerprintCache(kMaxCachedTracks),
+          m_trackReleasesCache(kMaxCachedTracks) {
 }
 
 void TagFetcher::startFetch(
@@ -36,6 +41,22 @@ void TagFetcher::startFetch(
 
     m_pTrack = pTrack;
 
+    const QString trackLocation = pTrack->getLocation();
+    const auto* pTrackReleases = m_trackReleasesCache.object(trackLocation);
+    if (pTrackReleases) {
+        const auto trackReleases = *pTrackReleases;
+        terminate();
+        emit resultAvailable(
+                std::move(pTrack),
+                trackReleases);
+        return;
+    }
+    const auto* pFingerprint = m_fingerprintCache.object(trackLocation);
+    if (pFingerprint) {
+        startAcoustIdTask(*pFingerprint);
+        return;
+    }
+
     emit fetchProgress(tr("Fingerprinting track"));
     const auto fingerprintTask = QtConcurrent::run([pTrack] {
         return ChromaPrinter().getFingerprint(pTrack);
@@ -119,7 +140,15 @@ void TagFetcher::slotFingerprintReady() {
                 QList<mixxx::musicbrainz::TrackRelease>());
         return;
     }
+    m_fingerprintCache.insert(
+            m_pTrack->getLocation(),
+            new QString(fingerprint));
 
+    startAcoustIdTask(fingerprint);
+}
+
+void TagFetcher::startAcoustIdTask(const QString& fingerprint) {
+    DEBUG_ASSERT(m_pTrack);
     emit fetchProgress(tr("Identifying track through Acoustid"));
     DEBUG_ASSERT(!m_pAcoustIdTask);
     m_pAcoustIdTask = make_parented<mixxx::AcoustIdLookupTask>(
@@ -299,6 +328,11 @@ void TagFetcher::slotMusicBrainzTaskSucceeded(
     auto pTrack = m_pTrack;
     terminate();
 
+    if (!guessedTrackReleases.isEmpty()) {
+        m_trackReleasesCache.insert(
+                pTrack->getLocation(),
+                new QList<mixxx::musicbrainz::TrackRelease>(guessedTrackReleases));
+    }
     emit resultAvailable(
             std::move(pTrack),
             std::move(guessedTrackReleases));
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <QCache>
 #include <QFutureWatcher>
 #include <QObject>
 
@@ -110,10 +111,18 @@ class TagFetcher : public QObject {
   private:
     void terminate();
 
+    void startAcoustIdTask(const QString& fingerprint);
+
     QNetworkAccessManager m_network;
 
     QFutureWatcher<QString> m_fingerprintWatcher;
 
+    // Fingerprints and track releases by track location, so that
+    // navigating back to a track or retrying after a network error
+    // neither decodes the audio again nor repeats successful lookups
+    QCache<QString, QString> m_fingerprintCache;
+    QCache<QString, QList<mixxx::musicbrainz::TrackRelease>> m_trackReleasesCache;
+
     parented_ptr<mixxx::AcoustIdLookupTask> m_pAcoustIdTask;
 
     parented_ptr<mixxx::MusicBrainzRecordingsTask> m_pMusicBrainzTask;
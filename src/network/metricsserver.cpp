@@ -0,0 +1,225 @@
+#include "network/metricsserver.h"
+
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <cmath>
+
+#include "control/control.h"
+#include "moc_metricsserver.cpp"
+#include "util/logger.h"
+
+namespace mixxx {
+
+namespace network {
+
+namespace {
+
+const Logger kLogger("mixxx::network::MetricsServer");
+
+const QString kMetricsGroup = QStringLiteral("[Metrics]");
+
+// Scrapers only send a request line and a few headers
+constexpr qint64 kMaxRequestBytes = 8192;
+
+const QByteArray kContentType = QByteArrayLiteral(
+        "application/openmetrics-text; version=1.0.0; charset=utf-8");
+
+QString formatValue(double value) {
+    if (std::isnan(value)) {
+        return QStringLiteral("NaN");
+    }
+    if (std::isinf(value)) {
+        return value > 0 ? QStringLiteral("+Inf") : QStringLiteral("-Inf");
+    }
+    return QString::number(value, 'g', 15);
+}
+
+QString escapeHelp(QString help) {
+    return help.replace(QChar('\\'), QStringLiteral("\\\\"))
+            .replace(QChar('\n'), QStringLiteral("\\n"));
+}
+
+void writeResponse(QTcpSocket* pSocket,
+        const QByteArray& status,
+        const QByteArray& contentType,
+        const QByteArray& body) {
+    QByteArray response = QByteArrayLiteral("HTTP/1.1 ") + status + "\r\n";
+    response += "Content-Type: " + contentType + "\r\n";
+    response += "Content-Length: " + QByteArray::number(body.size()) + "\r\n";
+    response += "Connection: close\r\n\r\n";
+    response += body;
+    pSocket->write(response);
+    pSocket->disconnectFromHost();
+}
+
+} // anonymous namespace
+
+const ConfigKey MetricsServer::kEnabledConfigKey =
+        ConfigKey(kMetricsGroup, QStringLiteral("Enabled"));
+const ConfigKey MetricsServer::kAddressConfigKey =
+        ConfigKey(kMetricsGroup, QStringLiteral("Address"));
+const ConfigKey MetricsServer::kPortConfigKey =
+        ConfigKey(kMetricsGroup, QStringLiteral("Port"));
+
+MetricsServer::MetricsServer(QObject* pParent)
+        : QObject(pParent),
+          m_pServer(new QTcpServer(this)) {
+    connect(m_pServer,
+            &QTcpServer::newConnection,
+            this,
+            &MetricsServer::slotNewConnection);
+}
+
+MetricsServer::~MetricsServer() = default;
+
+// static
+bool MetricsServer::isEnabled(const UserSettingsPointer& pConfig) {
+    return pConfig->getValue(kEnabledConfigKey, false);
+}
+
+void MetricsServer::addMetric(
+        const QString& name,
+        Type type,
+        const QString& help,
+        Sampler sampler) {
+    DEBUG_ASSERT(type != Type::Counter || !name.endsWith(QStringLiteral("_total")));
+    m_metrics.append(Metric{name, type, help, std::move(sampler)});
+}
+
+void MetricsServer::addControlMetric(
+        const QString& name,
+        Type type,
+        const QString& help,
+        const ConfigKey& key) {
+    addMetric(name, type, help, [key]() {
+        QVector<Sample> samples;
+        const auto value = controlValue(key);
+        if (value) {
+            samples.append(Sample{QString(), *value});
+        }
+        return samples;
+    });
+}
+
+bool MetricsServer::listen(const QHostAddress& address, quint16 port) {
+    if (!m_pServer->listen(address, port)) {
+        kLogger.warning()
+                << "Failed to listen on"
+                << address
+                << port
+                << m_pServer->errorString();
+        return false;
+    }
+    kLogger.info()
+            << "Serving metrics on"
+            << QStringLiteral("http://%1:%2/metrics")
+                       .arg(m_pServer->serverAddress().toString())
+                       .arg(m_pServer->serverPort());
+    return true;
+}
+
+bool MetricsServer::listen(const UserSettingsPointer& pConfig) {
+    QHostAddress address(pConfig->getValue(
+            kAddressConfigKey, QStringLiteral("127.0.0.1")));
+    if (address.isNull()) {
+        kLogger.warning() << "Invalid address, using the loopback interface";
+        address = QHostAddress::LocalHost;
+    }
+    const int port = pConfig->getValue(kPortConfigKey, static_cast<int>(kDefaultPort));
+    return listen(address, static_cast<quint16>(port));
+}
+
+QByteArray MetricsServer::exposition() const {
+    QString text;
+    for (const auto& metric : m_metrics) {
+        const bool counter = metric.type == Type::Counter;
+        text += QStringLiteral("# TYPE %1 %2\n")
+                        .arg(metric.name,
+                                counter ? QStringLiteral("counter")
+                                        : QStringLiteral("gauge"));
+        text += QStringLiteral("# HELP %1 %2\n").arg(metric.name, escapeHelp(metric.help));
+        const QString sampleName = counter
+                ? metric.name + QStringLiteral("_total")
+                : metric.name;
+        const auto samples = metric.sampler();
+        for (const auto& sample : samples) {
+            text += sampleName;
+            if (!sample.labels.isEmpty()) {
+                text += QChar('{') + sample.labels + QChar('}');
+            }
+            text += QChar(' ') + formatValue(sample.value) + QChar('\n');
+        }
+    }
+    text += QStringLiteral("# EOF\n");
+    return text.toUtf8();
+}
+
+// static
+QString MetricsServer::label(const QString& name, const QString& value) {
+    QString escaped = value;
+    escaped.replace(QChar('\\'), QStringLiteral("\\\\"))
+            .replace(QChar('"'), QStringLiteral("\\\""))
+            .replace(QChar('\n'), QStringLiteral("\\n"));
+    return QStringLiteral("%1=\"%2\"").arg(name, escaped);
+}
+
+// static
+std::optional<double> MetricsServer::controlValue(const ConfigKey& key) {
+    const auto pControl = ControlDoublePrivate::getControl(
+            key, ControlFlag::NoAssertIfMissing);
+    if (!pControl) {
+        return std::nullopt;
+    }
+    return pControl->get();
+}
+
+void MetricsServer::slotNewConnection() {
+    while (QTcpSocket* pSocket = m_pServer->nextPendingConnection()) {
+        connect(pSocket,
+                &QTcpSocket::disconnected,
+                pSocket,
+                &QObject::deleteLater);
+        connect(pSocket,
+                &QTcpSocket::readyRead,
+                this,
+                [this, pSocket]() {
+                    handleRequest(pSocket);
+                });
+    }
+}
+
+void MetricsServer::handleRequest(QTcpSocket* pSocket) {
+    if (pSocket->state() != QAbstractSocket::ConnectedState) {
+        return;
+    }
+    // Wait until the complete header has been received
+    const QByteArray request = pSocket->peek(kMaxRequestBytes);
+    if (!request.contains("\r\n\r\n")) {
+        if (request.size() >= kMaxRequestBytes) {
+            writeResponse(pSocket, "431 Request Header Fields Too Large", "text/plain", "");
+        }
+        return;
+    }
+    pSocket->readAll();
+
+    const QList<QByteArray> requestLine =
+            request.left(request.indexOf("\r\n")).split(' ');
+    if (requestLine.size() != 3) {
+        writeResponse(pSocket, "400 Bad Request", "text/plain", "");
+        return;
+    }
+    if (requestLine[0] != "GET") {
+        writeResponse(pSocket, "405 Method Not Allowed", "text/plain", "");
+        return;
+    }
+    const QByteArray path = requestLine[1].left(requestLine[1].indexOf('?'));
+    if (path != "/metrics") {
+        writeResponse(pSocket, "404 Not Found", "text/plain", "");
+        return;
+    }
+    writeResponse(pSocket, "200 OK", kContentType, exposition());
+}
+
+} // namespace network
+
+} // namespace mixxx
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <QHostAddress>
+#include <QObject>
+#include <QString>
+#include <QVector>
+#include <functional>
+#include <optional>
+
+#include "preferences/usersettings.h"
+
+class QTcpServer;
+class QTcpSocket;
+
+namespace mixxx {
+
+namespace network {
+
+/// Serves the health of the engine and the library in the OpenMetrics
+/// text format on http://<address>:<port>/metrics, so that unattended
+/// installations can be monitored centrally, e.g. with Prometheus.
+///
+/// The server is disabled by default and only listens on the loopback
+/// interface unless configured otherwise. All metrics are sampled on the
+/// main thread when they are scraped, nothing is recorded in between.
+class MetricsServer : public QObject {
+    Q_OBJECT
+  public:
+    enum class Type {
+        Counter,
+        Gauge,
+    };
+
+    /// A single value of a metric. The labels are formatted as
+    /// `name="value"` pairs separated by commas, see label().
+    struct Sample {
+        QString labels;
+        double value;
+    };
+    using Sampler = std::function<QVector<Sample>()>;
+
+    static const ConfigKey kEnabledConfigKey;
+    static const ConfigKey kAddressConfigKey;
+    static const ConfigKey kPortConfigKey;
+    static constexpr quint16 kDefaultPort = 9464;
+
+    explicit MetricsServer(QObject* pParent = nullptr);
+    ~MetricsServer() override;
+
+    static bool isEnabled(const UserSettingsPointer& pConfig);
+
+    /// Adds a metric family. The name of counters must not end with
+    /// `_total`, it is appended to the samples.
+    void addMetric(
+            const QString& name,
+            Type type,
+            const QString& help,
+            Sampler sampler);
+    /// Adds a metric with the value of a control. Nothing is reported while
+    /// the control does not exist.
+    void addControlMetric(
+            const QString& name,
+            Type type,
+            const QString& help,
+            const ConfigKey& key);
+
+    bool listen(const QHostAddress& address, quint16 port);
+    bool listen(const UserSettingsPointer& pConfig);
+
+    /// Returns the current values of all metrics in the OpenMetrics
+    /// text format
+    QByteArray exposition() const;
+
+    /// Formats a label with an escaped value
+    static QString label(const QString& name, const QString& value);
+    /// Returns the value of a control if it exists
+    static std::optional<double> controlValue(const ConfigKey& key);
+
+  private slots:
+    void slotNewConnection();
+
+  private:
+    void handleRequest(QTcpSocket* pSocket);
+
+    struct Metric {
+        QString name;
+        Type type;
+        QString help;
+        Sampler sampler;
+    };
+    QVector<Metric> m_metrics;
+
+    QTcpServer* m_pServer;
+};
+
+} // namespace network
+
+} // namespace mixxx
@@ -384,6 +384,8 @@ void DlgPrefInterface::slotSetSkin(int) {
     slotUpdateSchemes();
     slotSetSkinDescription();
     slotSetSkinPreview();
+    // Parse the templates while the user looks at the preview
+    m_pSkin->prefetch(m_pConfig);
 }
 
 void DlgPrefInterface::slotApply() {
@@ -10,11 +10,13 @@
 #include <QStandardPaths>
 #include <QUrl>
 
+#include "database/mixxxdb.h"
 #include "defs_urls.h"
 #include "library/basetracktablemodel.h"
 #include "library/dlgtrackmetadataexport.h"
 #include "library/library.h"
 #include "library/library_prefs.h"
+#include "library/searchqueryparser.h"
 #include "library/trackcollection.h"
 #include "library/trackcollectionmanager.h"
 #include "moc_dlgpreflibrary.cpp"
@@ -92,6 +94,7 @@ DlgPrefLibrary::DlgPrefLibrary(
             &DlgPrefLibrary::slotSearchDebouncingTimeoutMillisChanged);
 
     updateSearchLineEditHistoryOptions();
+    updateSearchQueryParserOptions();
 
     connect(libraryFontButton, &QAbstractButton::clicked, this, &DlgPrefLibrary::slotSelectFont);
 
@@ -221,6 +224,10 @@ void DlgPrefLibrary::slotResetToDefaults() {
     checkBoxEnableSearchCompletions->setChecked(WSearchLineEdit::kCompletionsEnabledDefault);
     checkBoxEnableSearchHistoryShortcuts->setChecked(
             WSearchLineEdit::kHistoryShortcutsEnabledDefault);
+    checkBoxEnableFullTextSearch->setChecked(
+            SearchQueryParser::kFullTextSearchEnabledDefault);
+    checkBoxConcurrentDatabase->setChecked(
+            MixxxDb::kStorageProfileDefault == MixxxDb::StorageProfile::Concurrent);
 
     checkBox_show_rhythmbox->setChecked(true);
     checkBox_show_banshee->setChecked(true);
@@ -308,6 +315,11 @@ void DlgPrefLibrary::slotUpdate() {
     checkBoxEnableSearchHistoryShortcuts->setChecked(m_pConfig->getValue(
             kEnableSearchHistoryShortcutsConfigKey,
             WSearchLineEdit::kHistoryShortcutsEnabledDefault));
+    checkBoxEnableFullTextSearch->setChecked(m_pConfig->getValue(
+            kEnableFullTextSearchConfigKey,
+            SearchQueryParser::kFullTextSearchEnabledDefault));
+    checkBoxConcurrentDatabase->setChecked(
+            MixxxDb::storageProfile(m_pConfig) == MixxxDb::StorageProfile::Concurrent);
 
     m_originalTrackTableFont = m_pLibrary->getTrackTableFont();
     m_iOriginalTrackTableRowHeight = m_pLibrary->getTrackTableRowHeight();
@@ -467,6 +479,13 @@ void DlgPrefLibrary::slotApply() {
     m_pConfig->set(kEnableSearchHistoryShortcutsConfigKey,
             ConfigValue(checkBoxEnableSearchHistoryShortcuts->isChecked()));
     updateSearchLineEditHistoryOptions();
+    m_pConfig->set(kEnableFullTextSearchConfigKey,
+            ConfigValue(checkBoxEnableFullTextSearch->isChecked()));
+    updateSearchQueryParserOptions();
+    m_pConfig->set(kDatabaseStorageProfileConfigKey,
+            ConfigValue(static_cast<int>(checkBoxConcurrentDatabase->isChecked()
+                            ? MixxxDb::StorageProfile::Concurrent
+                            : MixxxDb::StorageProfile::Compatible)));
 
     m_pConfig->set(ConfigKey("[Library]","ShowRhythmboxLibrary"),
                 ConfigValue((int)checkBox_show_rhythmbox->isChecked()));
@@ -571,6 +590,12 @@ void DlgPrefLibrary::updateSearchLineEditHistoryOptions() {
             WSearchLineEdit::kHistoryShortcutsEnabledDefault));
 }
 
+void DlgPrefLibrary::updateSearchQueryParserOptions() {
+    SearchQueryParser::setFullTextSearchEnabled(m_pConfig->getValue<bool>(
+            kEnableFullTextSearchConfigKey,
+            SearchQueryParser::kFullTextSearchEnabledDefault));
+}
+
 void DlgPrefLibrary::slotBpmColumnPrecisionChanged(int bpmPrecision) {
     m_pConfig->setValue(
             kBpmColumnPrecisionConfigKey,
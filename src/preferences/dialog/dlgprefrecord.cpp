@@ -12,6 +12,8 @@
 
 namespace {
 constexpr bool kDefaultCueEnabled = true;
+constexpr bool kDefaultMultitrackEnabled = false;
+constexpr bool kDefaultMultitrackPostFader = false;
 } // anonymous namespace
 
 DlgPrefRecord::DlgPrefRecord(QWidget* parent, UserSettingsPointer pConfig)
@@ -75,6 +77,11 @@ DlgPrefRecord::DlgPrefRecord(QWidget* parent, UserSettingsPointer pConfig)
     // Setting miscellaneous
     CheckBoxRecordCueFile->setChecked(m_pConfig->getValue<bool>(
             ConfigKey(RECORDING_PREF_KEY, "CueEnabled"), kDefaultCueEnabled));
+    CheckBoxRecordStems->setChecked(m_pConfig->getValue<bool>(
+            ConfigKey(RECORDING_PREF_KEY, "Multitrack"), kDefaultMultitrackEnabled));
+    CheckBoxStemsPostFader->setChecked(m_pConfig->getValue<bool>(
+            ConfigKey(RECORDING_PREF_KEY, "MultitrackPostFader"),
+            kDefaultMultitrackPostFader));
 
     // Setting split
     comboBoxSplitting->addItem(SPLIT_650MB);
@@ -146,6 +153,7 @@ void DlgPrefRecord::slotApply()
     saveMetaData();
     saveEncoding();
     saveUseCueFile();
+    saveMultitrack();
     saveSplitSize();
 }
 
@@ -181,6 +189,11 @@ void DlgPrefRecord::slotUpdate()
      // Setting miscellaneous
     CheckBoxRecordCueFile->setChecked(m_pConfig->getValue<bool>(
             ConfigKey(RECORDING_PREF_KEY, "CueEnabled"), kDefaultCueEnabled));
+    CheckBoxRecordStems->setChecked(m_pConfig->getValue<bool>(
+            ConfigKey(RECORDING_PREF_KEY, "Multitrack"), kDefaultMultitrackEnabled));
+    CheckBoxStemsPostFader->setChecked(m_pConfig->getValue<bool>(
+            ConfigKey(RECORDING_PREF_KEY, "MultitrackPostFader"),
+            kDefaultMultitrackPostFader));
 
     QString fileSizeStr = m_pConfig->getValueString(ConfigKey(RECORDING_PREF_KEY, "FileSize"));
     int index = comboBoxSplitting->findText(fileSizeStr);
@@ -206,6 +219,8 @@ void DlgPrefRecord::slotResetToDefaults()
     // 4GB splitting is the default
     comboBoxSplitting->setCurrentIndex(4);
     CheckBoxRecordCueFile->setChecked(kDefaultCueEnabled);
+    CheckBoxRecordStems->setChecked(kDefaultMultitrackEnabled);
+    CheckBoxStemsPostFader->setChecked(kDefaultMultitrackPostFader);
 }
 
 
@@ -445,6 +460,13 @@ void DlgPrefRecord::saveUseCueFile() {
                    ConfigValue(CheckBoxRecordCueFile->isChecked()));
 }
 
+void DlgPrefRecord::saveMultitrack() {
+    m_pConfig->set(ConfigKey(RECORDING_PREF_KEY, "Multitrack"),
+            ConfigValue(CheckBoxRecordStems->isChecked()));
+    m_pConfig->set(ConfigKey(RECORDING_PREF_KEY, "MultitrackPostFader"),
+            ConfigValue(CheckBoxStemsPostFader->isChecked()));
+}
+
 void DlgPrefRecord::saveSplitSize() {
     m_pConfig->set(ConfigKey(RECORDING_PREF_KEY, "FileSize"),
                    ConfigValue(comboBoxSplitting->currentText()));
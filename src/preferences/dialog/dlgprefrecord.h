@@ -44,6 +44,7 @@ class DlgPrefRecord : public DlgPreferencePage, public Ui::DlgPrefRecordDlg  {
     void saveMetaData();
     void saveEncoding();
     void saveUseCueFile();
+    void saveMultitrack();
     void saveSplitSize();
 
     // Pointer to config object
@@ -32,6 +32,49 @@ bool soundItemAlreadyExists(const AudioPath& output, const QWidget& widget) {
     return false;
 }
 
+enum class TimingColumn {
+    Device,
+    Interval,
+    Jitter,
+    Processing,
+    Headroom,
+    ClockDrift,
+};
+
+constexpr int kHistogramBarWidth = 20;
+
+QString millisText(double seconds) {
+    return QStringLiteral("%1 ms").arg(seconds * 1000, 0, 'f', 2);
+}
+
+/// One line per non-empty bucket with a bar of its share
+QString histogramToolTip(const CallbackTimingHistogram& histogram, double bufferSeconds) {
+    quint32 maxCount = 0;
+    for (int bucket = 0; bucket < CallbackTimingHistogram::kBuckets; ++bucket) {
+        maxCount = std::max(maxCount, histogram.bucketCount(bucket));
+    }
+    if (maxCount == 0) {
+        return QString();
+    }
+    const double bucketMillis =
+            CallbackTimingHistogram::kBucketWidth * bufferSeconds * 1000;
+    QStringList lines;
+    for (int bucket = 0; bucket < CallbackTimingHistogram::kBuckets; ++bucket) {
+        const quint32 count = histogram.bucketCount(bucket);
+        if (count == 0) {
+            continue;
+        }
+        const int barWidth = std::max(1,
+                static_cast<int>(kHistogramBarWidth * count / maxCount));
+        lines.append(QStringLiteral("%1 - %2 ms\t%3 %4")
+                             .arg(bucket * bucketMillis, 0, 'f', 2)
+                             .arg((bucket + 1) * bucketMillis, 0, 'f', 2)
+                             .arg(QString(barWidth, QChar(0x2588)))
+                             .arg(count));
+    }
+    return lines.join(QChar('\n'));
+}
+
 } // namespace
 
 /// Construct a new sound preferences pane. Initializes and populates
@@ -205,6 +248,11 @@ DlgPrefSound::DlgPrefSound(QWidget* pParent,
             new ControlProxy(kAppGroup, QStringLiteral("audio_latency_overload_count"), this);
     m_pAudioLatencyOverloadCount->connectValueChanged(this, &DlgPrefSound::bufferUnderflow);
 
+    connect(m_pSoundManager.get(),
+            &SoundManager::callbackTimingsUpdated,
+            this,
+            &DlgPrefSound::callbackTimingsUpdated);
+
     m_pOutputLatencyMs = new ControlProxy(kAppGroup, QStringLiteral("output_latency_ms"), this);
     m_pOutputLatencyMs->connectValueChanged(this, &DlgPrefSound::outputLatencyChanged);
 
@@ -532,7 +580,7 @@ void DlgPrefSound::apiChanged(int index) {
     // For bigger buffers the user has to manually match the value with Jack.
     // TODO(Be): Get the buffer size from JACK and update audioBufferComboBox.
     // PortAudio as off v19.7.0 does not have a way to get the buffer size from JACK.
-    bool enable = m_config.getAPI() == MIXXX_PORTAUDIO_JACK_STRING ? false : true;
+    bool enable = isJackApi(m_config.getAPI()) ? false : true;
     sampleRateComboBox->setEnabled(enable);
     deviceSyncComboBox->setEnabled(enable);
     engineClockComboBox->setEnabled(enable);
@@ -607,7 +655,7 @@ void DlgPrefSound::engineClockChanged(int index) {
 void DlgPrefSound::updateAudioBufferSizes(int sampleRateIndex) {
     QVariant oldSizeIndex = audioBufferComboBox->currentData();
     audioBufferComboBox->clear();
-    if (m_config.getAPI() == MIXXX_PORTAUDIO_JACK_STRING) {
+    if (isJackApi(m_config.getAPI())) {
         // in case of jack we configure the frames/period
         // we cannot calc the resulting buffer size in ms because the
         // Sample rate is not known yet. We assume 48000 KHz here
@@ -790,6 +838,57 @@ void DlgPrefSound::bufferUnderflow(double count) {
     update();
 }
 
+void DlgPrefSound::callbackTimingsUpdated() {
+    if (!callbackTimingTree->isVisible()) {
+        return;
+    }
+    const QList<SoundDeviceCallbackTiming>& timings =
+            m_pSoundManager->getCallbackTimings();
+    while (callbackTimingTree->topLevelItemCount() > timings.size()) {
+        delete callbackTimingTree->takeTopLevelItem(
+                callbackTimingTree->topLevelItemCount() - 1);
+    }
+    for (int i = 0; i < timings.size(); ++i) {
+        QTreeWidgetItem* pItem = callbackTimingTree->topLevelItem(i);
+        if (!pItem) {
+            pItem = new QTreeWidgetItem(callbackTimingTree);
+        }
+        const SoundDeviceCallbackTiming& timing = timings.at(i);
+        const CallbackTimingStats& stats = timing.stats;
+        const double bufferSeconds = stats.bufferSeconds();
+
+        pItem->setText(static_cast<int>(TimingColumn::Device), timing.displayName);
+        pItem->setText(static_cast<int>(TimingColumn::Interval),
+                tr("%1 (99%: %2)")
+                        .arg(millisText(stats.intervals().quantile(0.5) * bufferSeconds),
+                                millisText(stats.intervals().quantile(0.99) *
+                                        bufferSeconds)));
+        pItem->setToolTip(static_cast<int>(TimingColumn::Interval),
+                histogramToolTip(stats.intervals(), bufferSeconds));
+        pItem->setText(static_cast<int>(TimingColumn::Jitter),
+                millisText(stats.intervalJitterSeconds()));
+        pItem->setText(static_cast<int>(TimingColumn::Processing),
+                tr("99%: %1").arg(millisText(
+                        stats.processing().quantile(0.99) * bufferSeconds)));
+        pItem->setToolTip(static_cast<int>(TimingColumn::Processing),
+                histogramToolTip(stats.processing(), bufferSeconds));
+        pItem->setText(static_cast<int>(TimingColumn::Headroom),
+                tr("min: %1").arg(millisText(stats.minHeadroomSeconds())));
+        pItem->setToolTip(static_cast<int>(TimingColumn::Headroom),
+                histogramToolTip(stats.headroom(), bufferSeconds));
+        if (timing.isClockReference) {
+            pItem->setText(static_cast<int>(TimingColumn::ClockDrift),
+                    tr("Clock reference"));
+        } else if (stats.measuredSampleRate() <= 0) {
+            pItem->setText(static_cast<int>(TimingColumn::ClockDrift),
+                    tr("Measuring..."));
+        } else {
+            pItem->setText(static_cast<int>(TimingColumn::ClockDrift),
+                    tr("%1 ppm").arg(timing.driftPpm, 0, 'f', 1));
+        }
+    }
+}
+
 void DlgPrefSound::outputLatencyChanged(double latency) {
     currentLatency->setText(QString("%1 ms").arg(latency));
     update();
@@ -3,6 +3,7 @@
 #include <QDir>
 
 #include "control/control.h"
+#include "control/controlpersistence.h"
 #include "preferences/upgrade.h"
 #include "util/assert.h"
 
@@ -24,6 +25,9 @@ SettingsManager::SettingsManager(const QString& settingsPath)
     m_bShouldRescanLibrary = upgrader.rescanLibrary();
 
     ControlDoublePrivate::setUserConfig(m_pSettings);
+    // Before any persistent control loads its value
+    m_pControlPersistence = std::make_unique<ControlPersistence>(
+            m_pSettings, QDir(settingsPath).filePath(QStringLiteral("controls.log")));
 
 #ifdef __BROADCAST__
     m_pBroadcastSettings = BroadcastSettingsPointer(
@@ -32,5 +36,13 @@ SettingsManager::SettingsManager(const QString& settingsPath)
 }
 
 SettingsManager::~SettingsManager() {
+    m_pControlPersistence.reset();
     ControlDoublePrivate::setUserConfig(UserSettingsPointer());
 }
+
+void SettingsManager::save() {
+    m_pControlPersistence->storeInConfig();
+    if (m_pSettings->save()) {
+        m_pControlPersistence->discardLog();
+    }
+}
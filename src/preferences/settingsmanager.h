@@ -1,10 +1,14 @@
 #pragma once
 
+#include <memory>
+
 #ifdef __BROADCAST__
 #include "preferences/broadcastsettings.h"
 #endif
 #include "preferences/usersettings.h"
 
+class ControlPersistence;
+
 class SettingsManager {
   public:
     explicit SettingsManager(const QString& settingsPath);
@@ -20,9 +24,8 @@ class SettingsManager {
     }
 #endif
 
-    void save() {
-        m_pSettings->save();
-    }
+    /// Also stores the current values of the persistent controls
+    void save();
 
     bool shouldRescanLibrary() {
         return m_bShouldRescanLibrary;
@@ -30,6 +33,7 @@ class SettingsManager {
 
   private:
     UserSettingsPointer m_pSettings;
+    std::unique_ptr<ControlPersistence> m_pControlPersistence;
     bool m_bShouldRescanLibrary;
 #ifdef __BROADCAST__
     BroadcastSettingsPointer m_pBroadcastSettings;
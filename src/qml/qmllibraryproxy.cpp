@@ -1,7 +1,5 @@
 #include "qml/qmllibraryproxy.h"
 
-#include <QAbstractItemModel>
-
 #include "library/library.h"
 #include "moc_qmllibraryproxy.cpp"
 
@@ -11,7 +9,7 @@ namespace qml {
 QmlLibraryProxy::QmlLibraryProxy(std::shared_ptr<Library> pLibrary, QObject* parent)
         : QObject(parent),
           m_pLibrary(pLibrary),
-          m_pModelProperty(new QmlLibraryTrackListModel(m_pLibrary->trackTableModel(), this)) {
+          m_pModelProperty(new QmlLibraryTrackListModel(m_pLibrary.get(), this)) {
 }
 
 // static
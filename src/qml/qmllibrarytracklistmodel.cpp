@@ -1,7 +1,19 @@
 #include "qml/qmllibrarytracklistmodel.h"
 
-#include "library/librarytablemodel.h"
+#include <QSqlQuery>
+#include <QStringList>
+#include <algorithm>
+
+#include "library/dao/trackschema.h"
+#include "library/library.h"
+#include "library/queryutil.h"
+#include "library/trackcollection.h"
+#include "library/trackcollectionmanager.h"
 #include "moc_qmllibrarytracklistmodel.cpp"
+#include "qml/asyncimageprovider.h"
+#include "util/assert.h"
+#include "util/db/dbconnectionpooled.h"
+#include "util/timer.h"
 
 namespace mixxx {
 namespace qml {
@@ -12,76 +24,204 @@ const QHash<int, QByteArray> kRoleNames = {
         {QmlLibraryTrackListModel::AlbumRole, "album"},
         {QmlLibraryTrackListModel::AlbumArtistRole, "albumArtist"},
         {QmlLibraryTrackListModel::FileUrlRole, "fileUrl"},
+        {QmlLibraryTrackListModel::CoverArtUrlRole, "coverArtUrl"},
+        {QmlLibraryTrackListModel::DurationRole, "duration"},
+        {QmlLibraryTrackListModel::BpmRole, "bpm"},
 };
+
+// A page is fetched with a single query by primary key, which takes about
+// a millisecond
+constexpr int kPageSize = 256;
+// Several screens in each direction of the visible rows
+constexpr int kMaxCachedPages = 32;
+
+constexpr int kSelectDelayMillis = 500;
+
+const QString kTrackIdsQuery = QStringLiteral(
+        "SELECT " LIBRARY_TABLE ".id FROM " LIBRARY_TABLE
+        " INNER JOIN " TRACKLOCATIONS_TABLE
+        " ON " LIBRARY_TABLE ".location=" TRACKLOCATIONS_TABLE ".id"
+        " WHERE " LIBRARY_TABLE ".mixxx_deleted=0"
+        " AND " TRACKLOCATIONS_TABLE ".fs_deleted=0"
+        " ORDER BY " LIBRARY_TABLE ".artist COLLATE NOCASE,"
+        " " LIBRARY_TABLE ".title COLLATE NOCASE");
+
+const QString kPageQuery = QStringLiteral(
+        "SELECT " LIBRARY_TABLE ".id," LIBRARY_TABLE ".title," LIBRARY_TABLE
+        ".artist," LIBRARY_TABLE ".album," LIBRARY_TABLE
+        ".album_artist," LIBRARY_TABLE ".duration," LIBRARY_TABLE
+        ".bpm," TRACKLOCATIONS_TABLE ".location FROM " LIBRARY_TABLE
+        " INNER JOIN " TRACKLOCATIONS_TABLE
+        " ON " LIBRARY_TABLE ".location=" TRACKLOCATIONS_TABLE ".id"
+        " WHERE " LIBRARY_TABLE ".id IN (%1)");
+} // namespace
+
+QmlLibraryTrackListModel::QmlLibraryTrackListModel(Library* pLibrary, QObject* pParent)
+        : QAbstractListModel(pParent),
+          m_pDbConnectionPool(pLibrary->dbConnectionPool()) {
+    m_selectTimer.setSingleShot(true);
+    m_selectTimer.setInterval(kSelectDelayMillis);
+    connect(&m_selectTimer,
+            &QTimer::timeout,
+            this,
+            &QmlLibraryTrackListModel::select);
+
+    const TrackCollection* pTrackCollection =
+            pLibrary->trackCollectionManager()->internalCollection();
+    connect(pTrackCollection,
+            &TrackCollection::tracksAdded,
+            &m_selectTimer,
+            qOverload<>(&QTimer::start));
+    connect(pTrackCollection,
+            &TrackCollection::tracksRemoved,
+            &m_selectTimer,
+            qOverload<>(&QTimer::start));
+    connect(pTrackCollection,
+            &TrackCollection::multipleTracksChanged,
+            &m_selectTimer,
+            qOverload<>(&QTimer::start));
+    connect(pTrackCollection,
+            &TrackCollection::tracksChanged,
+            this,
+            &QmlLibraryTrackListModel::slotTracksChanged);
+
+    select();
 }
 
-QmlLibraryTrackListModel::QmlLibraryTrackListModel(LibraryTableModel* pModel, QObject* pParent)
-        : QIdentityProxyModel(pParent) {
-    pModel->select();
-    setSourceModel(pModel);
+void QmlLibraryTrackListModel::select() {
+    ScopedTimer t("QmlLibraryTrackListModel::select");
+    QSqlQuery query(DbConnectionPooled(m_pDbConnectionPool));
+    query.setForwardOnly(true);
+    QVector<TrackId> trackIds;
+    if (query.exec(kTrackIdsQuery)) {
+        while (query.next()) {
+            trackIds.append(TrackId(query.value(0)));
+        }
+    } else {
+        LOG_FAILED_QUERY(query);
+    }
+
+    beginResetModel();
+    m_trackIds = std::move(trackIds);
+    m_pages.clear();
+    m_pageUsage.clear();
+    endResetModel();
 }
 
-QVariant QmlLibraryTrackListModel::data(const QModelIndex& proxyIndex, int role) const {
-    if (!proxyIndex.isValid()) {
-        return {};
+void QmlLibraryTrackListModel::slotTracksChanged(const QSet<TrackId>& trackIds) {
+    // Only the fetched pages can contain outdated data
+    const QList<int> pageIndexes = m_pages.keys();
+    for (int pageIndex : pageIndexes) {
+        const int firstRow = pageIndex * kPageSize;
+        const int lastRow = std::min(firstRow + kPageSize, rowCount()) - 1;
+        for (int row = firstRow; row <= lastRow; ++row) {
+            if (trackIds.contains(m_trackIds[row])) {
+                m_pages.remove(pageIndex);
+                m_pageUsage.removeOne(pageIndex);
+                emit dataChanged(index(firstRow), index(lastRow));
+                break;
+            }
+        }
     }
+}
 
-    VERIFY_OR_DEBUG_ASSERT(checkIndex(proxyIndex)) {
-        return {};
+int QmlLibraryTrackListModel::rowCount(const QModelIndex& parent) const {
+    // This is a list model, i.e. no entries have a parent.
+    if (parent.isValid()) {
+        return 0;
     }
+    return m_trackIds.size();
+}
 
-    const auto pSourceModel = static_cast<LibraryTableModel*>(sourceModel());
-    VERIFY_OR_DEBUG_ASSERT(pSourceModel) {
+QmlLibraryTrackListModel::Page QmlLibraryTrackListModel::fetchPage(int pageIndex) const {
+    const int firstRow = pageIndex * kPageSize;
+    const int rowCount = std::min(kPageSize, m_trackIds.size() - firstRow);
+    QStringList trackIds;
+    trackIds.reserve(rowCount);
+    QHash<TrackId, int> rowsById;
+    rowsById.reserve(rowCount);
+    for (int i = 0; i < rowCount; ++i) {
+        const TrackId& trackId = m_trackIds[firstRow + i];
+        trackIds.append(trackId.toString());
+        rowsById.insert(trackId, i);
+    }
+
+    Page page(rowCount);
+    QSqlQuery query(DbConnectionPooled(m_pDbConnectionPool));
+    query.setForwardOnly(true);
+    if (!query.exec(kPageQuery.arg(trackIds.join(QChar(','))))) {
+        LOG_FAILED_QUERY(query);
+        return page;
+    }
+    while (query.next()) {
+        const auto it = rowsById.constFind(TrackId(query.value(0)));
+        if (it == rowsById.constEnd()) {
+            continue;
+        }
+        TrackRow& trackRow = page[it.value()];
+        trackRow.title = query.value(1).toString();
+        trackRow.artist = query.value(2).toString();
+        trackRow.album = query.value(3).toString();
+        trackRow.albumArtist = query.value(4).toString();
+        trackRow.duration = query.value(5).toDouble();
+        trackRow.bpm = query.value(6).toDouble();
+        trackRow.location = query.value(7).toString();
+    }
+    return page;
+}
+
+const QmlLibraryTrackListModel::TrackRow& QmlLibraryTrackListModel::trackRow(int row) const {
+    const int pageIndex = row / kPageSize;
+    auto it = m_pages.find(pageIndex);
+    if (it == m_pages.end()) {
+        if (m_pages.size() >= kMaxCachedPages) {
+            m_pages.remove(m_pageUsage.takeFirst());
+        }
+        it = m_pages.insert(pageIndex, fetchPage(pageIndex));
+        m_pageUsage.append(pageIndex);
+    } else if (m_pageUsage.last() != pageIndex) {
+        m_pageUsage.removeOne(pageIndex);
+        m_pageUsage.append(pageIndex);
+    }
+    return it.value()[row % kPageSize];
+}
+
+QVariant QmlLibraryTrackListModel::data(const QModelIndex& index, int role) const {
+    if (!index.isValid()) {
         return {};
     }
 
-    if (proxyIndex.column() > 0) {
+    VERIFY_OR_DEBUG_ASSERT(checkIndex(index)) {
         return {};
     }
 
-    int column = -1;
+    const TrackRow& track = trackRow(index.row());
     switch (role) {
     case TitleRole:
-        column = pSourceModel->fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_TITLE);
-        break;
+        return track.title;
     case ArtistRole:
-        column = pSourceModel->fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_ARTIST);
-        break;
+        return track.artist;
     case AlbumRole:
-        column = pSourceModel->fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_ALBUM);
-        break;
+        return track.album;
     case AlbumArtistRole:
-        column = pSourceModel->fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_ALBUMARTIST);
-        break;
-    case FileUrlRole: {
-        column = pSourceModel->fieldIndex(ColumnCache::COLUMN_TRACKLOCATIONSTABLE_LOCATION);
-        const QString location = QIdentityProxyModel::data(
-                proxyIndex.siblingAtColumn(column), Qt::DisplayRole)
-                                         .toString();
-        if (location.isEmpty()) {
+        return track.albumArtist;
+    case FileUrlRole:
+        if (track.location.isEmpty()) {
             return {};
         }
-        return QUrl::fromLocalFile(location);
-    }
+        return QUrl::fromLocalFile(track.location);
+    case CoverArtUrlRole:
+        if (track.location.isEmpty()) {
+            return {};
+        }
+        return AsyncImageProvider::trackLocationToCoverArtUrl(track.location);
+    case DurationRole:
+        return track.duration;
+    case BpmRole:
+        return track.bpm;
     default:
-        break;
-    }
-
-    if (column < 0) {
         return {};
     }
-
-    return QIdentityProxyModel::data(proxyIndex.siblingAtColumn(column), Qt::DisplayRole);
-}
-
-int QmlLibraryTrackListModel::columnCount(const QModelIndex& parent) const {
-    // This is a list model, i.e. no entries have a parent.
-    VERIFY_OR_DEBUG_ASSERT(!parent.isValid()) {
-        return 0;
-    }
-
-    // There is exactly one column. All data is exposed as roles.
-    return 1;
 }
 
 QHash<int, QByteArray> QmlLibraryTrackListModel::roleNames() const {
@@ -1,13 +1,28 @@
 #pragma once
-#include <QIdentityProxyModel>
+#include <QAbstractListModel>
+#include <QHash>
+#include <QList>
+#include <QSet>
+#include <QTimer>
+#include <QVector>
 #include <QtQml>
 
-class LibraryTableModel;
+#include "track/trackid.h"
+#include "util/db/dbconnectionpool.h"
+
+class Library;
 
 namespace mixxx {
 namespace qml {
 
-class QmlLibraryTrackListModel : public QIdentityProxyModel {
+/// The tracks of the internal collection as a flat list for QML.
+///
+/// Only the ids of the tracks are queried when the model is selected. The
+/// columns shown by the delegates are fetched in pages of consecutive rows
+/// when a row of a page is accessed for the first time, and only the most
+/// recently used pages are kept. This keeps scrolling smooth with libraries
+/// of several 100k tracks.
+class QmlLibraryTrackListModel : public QAbstractListModel {
     Q_OBJECT
     QML_NAMED_ELEMENT(LibraryTrackListModel)
     QML_UNCREATABLE("Only accessible via Mixxx.Library.model")
@@ -19,16 +34,51 @@ class QmlLibraryTrackListModel : public QIdentityProxyModel {
         AlbumRole,
         AlbumArtistRole,
         FileUrlRole,
+        CoverArtUrlRole,
+        DurationRole,
+        BpmRole,
     };
     Q_ENUM(Roles);
 
-    QmlLibraryTrackListModel(LibraryTableModel* pModel, QObject* pParent = nullptr);
-    ~QmlLibraryTrackListModel() = default;
+    QmlLibraryTrackListModel(Library* pLibrary, QObject* pParent = nullptr);
+    ~QmlLibraryTrackListModel() override = default;
 
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
     QVariant data(const QModelIndex& index, int role) const override;
-    int columnCount(const QModelIndex& index = QModelIndex()) const override;
     QHash<int, QByteArray> roleNames() const override;
     Q_INVOKABLE QVariant get(int row) const;
+
+  public slots:
+    /// Queries the ids of all tracks and drops the fetched pages
+    void select();
+
+  private slots:
+    void slotTracksChanged(const QSet<TrackId>& trackIds);
+
+  private:
+    struct TrackRow {
+        QString title;
+        QString artist;
+        QString album;
+        QString albumArtist;
+        QString location;
+        double duration = 0.0;
+        double bpm = 0.0;
+    };
+    typedef QVector<TrackRow> Page;
+
+    const TrackRow& trackRow(int row) const;
+    Page fetchPage(int pageIndex) const;
+
+    const DbConnectionPoolPtr m_pDbConnectionPool;
+    QVector<TrackId> m_trackIds;
+
+    mutable QHash<int, Page> m_pages;
+    // Least recently used first
+    mutable QList<int> m_pageUsage;
+
+    // Scanning adds or removes tracks in many small batches
+    QTimer m_selectTimer;
 };
 
 } // namespace qml
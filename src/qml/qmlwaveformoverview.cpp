@@ -1,23 +1,53 @@
 #include "qml/qmlwaveformoverview.h"
 
+#include <QQuickWindow>
+#include <QSGGeometryNode>
+#include <QSGTransformNode>
+#include <QSGVertexColorMaterial>
+#include <algorithm>
+#include <cmath>
+
 #include "mixer/basetrackplayer.h"
 #include "moc_qmlwaveformoverview.cpp"
+#include "util/math.h"
 
 namespace {
 constexpr double kDesiredChannelHeight = 255;
+// Two triangles per bar
+constexpr int kVerticesPerBar = 6;
 } // namespace
 
 namespace mixxx {
 namespace qml {
 
 QmlWaveformOverview::QmlWaveformOverview(QQuickItem* parent)
-        : QQuickPaintedItem(parent),
+        : QQuickItem(parent),
           m_pPlayer(nullptr),
           m_channels(ChannelFlag::BothChannels),
           m_renderer(Renderer::RGB),
           m_colorHigh(0xFF0000),
           m_colorMid(0x00FF00),
-          m_colorLow(0x0000FF) {
+          m_colorLow(0x0000FF),
+          m_geometryDirty(true),
+          m_columns(0) {
+    setFlag(QQuickItem::ItemHasContents, true);
+
+    connect(this,
+            &QmlWaveformOverview::rendererChanged,
+            this,
+            &QmlWaveformOverview::slotGeometryDirty);
+    connect(this,
+            &QmlWaveformOverview::colorHighChanged,
+            this,
+            &QmlWaveformOverview::slotGeometryDirty);
+    connect(this,
+            &QmlWaveformOverview::colorMidChanged,
+            this,
+            &QmlWaveformOverview::slotGeometryDirty);
+    connect(this,
+            &QmlWaveformOverview::colorLowChanged,
+            this,
+            &QmlWaveformOverview::slotGeometryDirty);
 }
 
 QmlPlayerProxy* QmlWaveformOverview::getPlayer() const {
@@ -65,6 +95,7 @@ void QmlWaveformOverview::setChannels(QmlWaveformOverview::Channels channels) {
 
     m_channels = channels;
     emit channelsChanged(channels);
+    slotGeometryDirty();
 }
 
 void QmlWaveformOverview::slotTrackLoaded(TrackPointer pTrack) {
@@ -105,146 +136,174 @@ void QmlWaveformOverview::setCurrentTrack(TrackPointer pTrack) {
 }
 
 void QmlWaveformOverview::slotWaveformUpdated() {
+    slotGeometryDirty();
+}
+
+void QmlWaveformOverview::slotGeometryDirty() {
+    m_geometryDirty = true;
     update();
 }
 
-void QmlWaveformOverview::paint(QPainter* pPainter) {
-    TrackPointer pTrack = m_pCurrentTrack;
-    if (!pTrack) {
-        return;
+void QmlWaveformOverview::geometryChange(
+        const QRectF& newGeometry, const QRectF& oldGeometry) {
+    QQuickItem::geometryChange(newGeometry, oldGeometry);
+    if (newGeometry.size() != oldGeometry.size()) {
+        // Only the transform changes, unless a different resolution is needed
+        update();
     }
+}
 
-    ConstWaveformPointer pWaveform = pTrack->getWaveformSummary();
-    if (!pWaveform) {
-        return;
+int QmlWaveformOverview::columnCount(int visualSize) const {
+    const qreal devicePixelRatio = window() ? window()->effectiveDevicePixelRatio() : 1.0;
+    const int devicePixels = static_cast<int>(std::ceil(width() * devicePixelRatio));
+    if (devicePixels <= 0) {
+        return 0;
     }
+    // Rounded up to a power of two, so that resizing does not rebuild the
+    // geometry for every pixel
+    return std::min(visualSize,
+            static_cast<int>(roundUpToPowerOf2(static_cast<unsigned int>(devicePixels))));
+}
 
-    const int dataSize = pWaveform->getDataSize();
-    if (dataSize == 0) {
-        return;
+QSGNode* QmlWaveformOverview::updatePaintNode(QSGNode* pOldNode, UpdatePaintNodeData* pData) {
+    Q_UNUSED(pData);
+    ConstWaveformPointer pWaveform =
+            m_pCurrentTrack ? m_pCurrentTrack->getWaveformSummary() : nullptr;
+    const int visualSize = pWaveform ? pWaveform->getDataSize() / 2 : 0;
+    const int columns = columnCount(visualSize);
+    if (columns <= 0 || height() <= 0) {
+        delete pOldNode;
+        m_columns = 0;
+        return nullptr;
     }
 
-    constexpr int actualCompletion = 0;
-    // Always multiple of 2
-    const int waveformCompletion = pWaveform->getCompletion();
-    // Test if there is some new to draw (at least of pixel width)
-    const int completionIncrement = waveformCompletion - actualCompletion;
-
-    const qreal desiredWidth = static_cast<qreal>(dataSize) / 2;
-    const double visiblePixelIncrement = completionIncrement * desiredWidth / dataSize;
-    if (waveformCompletion < (dataSize - 2) &&
-            (completionIncrement < 2 || visiblePixelIncrement == 0)) {
-        return;
+    auto* pTransformNode = static_cast<QSGTransformNode*>(pOldNode);
+    QSGGeometryNode* pGeometryNode;
+    if (pTransformNode) {
+        pGeometryNode = static_cast<QSGGeometryNode*>(pTransformNode->firstChild());
+    } else {
+        pTransformNode = new QSGTransformNode;
+        pGeometryNode = new QSGGeometryNode;
+        auto* pGeometry = new QSGGeometry(QSGGeometry::defaultAttributes_ColoredPoint2D(), 0);
+        pGeometry->setDrawingMode(QSGGeometry::DrawTriangles);
+        pGeometryNode->setGeometry(pGeometry);
+        pGeometryNode->setFlag(QSGNode::OwnsGeometry);
+        pGeometryNode->setMaterial(new QSGVertexColorMaterial);
+        pGeometryNode->setFlag(QSGNode::OwnsMaterial);
+        pTransformNode->appendChildNode(pGeometryNode);
+        m_geometryDirty = true;
     }
 
-    const int nextCompletion = actualCompletion + completionIncrement;
-
-    const Channels channels = m_channels;
-    pPainter->save();
+    if (m_geometryDirty || columns != m_columns) {
+        m_geometryDirty = false;
+        m_columns = columns;
+        updateGeometry(pGeometryNode->geometry(), pWaveform, columns);
+        pGeometryNode->markDirty(QSGNode::DirtyGeometry);
+    }
 
-    switch (channels) {
+    // The geometry is built with one unit per column horizontally and one
+    // unit per waveform value vertically, from the baseline of the channels
+    QMatrix4x4 matrix;
+    switch (m_channels) {
     case static_cast<int>(ChannelFlag::LeftChannel):
-        // Draw both channels.
-        // Set the y axis to half the height of the item
-        pPainter->translate(0.0, height());
-        // Set the x axis to half the height of the item
-        pPainter->scale(width() / desiredWidth, height() / kDesiredChannelHeight);
+        matrix.translate(0.0f, static_cast<float>(height()));
+        matrix.scale(static_cast<float>(width() / columns),
+                static_cast<float>(height() / kDesiredChannelHeight));
         break;
     case static_cast<int>(ChannelFlag::RightChannel):
-        // Set the x axis to half the height of the item
-        pPainter->scale(width() / desiredWidth, height() / kDesiredChannelHeight);
+        matrix.scale(static_cast<float>(width() / columns),
+                static_cast<float>(height() / kDesiredChannelHeight));
         break;
     default:
-        // Draw both channels.
-        // Set the y axis to half the height of the item
-        pPainter->translate(0.0, height() / 2);
-        // Set the x axis to half the height of the item
-        pPainter->scale(width() / desiredWidth, height() / (2 * kDesiredChannelHeight));
+        matrix.translate(0.0f, static_cast<float>(height() / 2));
+        matrix.scale(static_cast<float>(width() / columns),
+                static_cast<float>(height() / (2 * kDesiredChannelHeight)));
     }
-
-    Renderer renderer = m_renderer;
-    for (int currentCompletion = actualCompletion;
-            currentCompletion < nextCompletion;
-            currentCompletion += 2) {
-        switch (renderer) {
-        case Renderer::Filtered:
-            drawFiltered(pPainter, channels, pWaveform, currentCompletion);
-            break;
-        default:
-            drawRgb(pPainter, channels, pWaveform, currentCompletion);
-        }
+    if (pTransformNode->matrix() != matrix) {
+        pTransformNode->setMatrix(matrix);
     }
-    pPainter->restore();
+    return pTransformNode;
 }
 
-void QmlWaveformOverview::drawRgb(QPainter* pPainter,
-        Channels channels,
-        ConstWaveformPointer pWaveform,
-        int completion) const {
-    const double offsetX = completion / 2.0;
-
-    if (channels.testFlag(ChannelFlag::LeftChannel)) {
-        // Draw left channel
-        const QColor leftColor = getRgbPenColor(pWaveform, completion);
-        if (leftColor.isValid()) {
-            const uint8_t leftValue = pWaveform->getAll(completion);
-            pPainter->setPen(leftColor);
-            pPainter->drawLine(QPointF(offsetX, -leftValue), QPointF(offsetX, 0.0));
-        }
-    }
+void QmlWaveformOverview::updateGeometry(QSGGeometry* pGeometry,
+        const ConstWaveformPointer& pWaveform,
+        int columns) const {
+    const int visualSize = pWaveform->getDataSize() / 2;
+    // Always multiple of 2
+    const int completedSize = std::min(pWaveform->getCompletion() / 2, visualSize);
+    const int completedColumns = static_cast<int>(
+            static_cast<qint64>(completedSize) * columns / visualSize);
 
-    if (channels.testFlag(ChannelFlag::RightChannel)) {
-        // Draw right channel
-        QColor rightColor = getRgbPenColor(pWaveform, completion + 1);
-        if (rightColor.isValid()) {
-            const uint8_t rightValue = pWaveform->getAll(completion + 1);
-            pPainter->setPen(rightColor);
-            pPainter->drawLine(QPointF(offsetX, 0.0), QPointF(offsetX, rightValue));
-        }
+    QList<int> channels;
+    if (m_channels.testFlag(ChannelFlag::LeftChannel)) {
+        channels.append(0);
     }
-}
-
-void QmlWaveformOverview::drawFiltered(QPainter* pPainter,
-        Channels channels,
-        ConstWaveformPointer pWaveform,
-        int completion) const {
-    const double offsetX = completion / 2.0;
-
-    if (channels.testFlag(ChannelFlag::LeftChannel)) {
-        const uint8_t leftHigh = pWaveform->getHigh(completion);
-        pPainter->setPen(m_colorHigh);
-        pPainter->drawLine(QPointF(offsetX, 2 * -leftHigh), QPointF(offsetX, 0.0));
-
-        const uint8_t leftMid = pWaveform->getMid(completion);
-        pPainter->setPen(m_colorMid);
-        pPainter->drawLine(QPointF(offsetX, 1.5 * -leftMid), QPointF(offsetX, 0.0));
-
-        const uint8_t leftLow = pWaveform->getLow(completion);
-        pPainter->setPen(m_colorLow);
-        pPainter->drawLine(QPointF(offsetX, -leftLow), QPointF(offsetX, 0.0));
+    if (m_channels.testFlag(ChannelFlag::RightChannel)) {
+        channels.append(1);
     }
-
-    if (channels.testFlag(ChannelFlag::RightChannel)) {
-        const uint8_t rightHigh = pWaveform->getHigh(completion + 1);
-        pPainter->setPen(m_colorHigh);
-        pPainter->drawLine(QPointF(offsetX, 0), QPointF(offsetX, 2 * rightHigh));
-
-        const uint8_t rightMid = pWaveform->getMid(completion + 1) * 2;
-        pPainter->setPen(m_colorMid);
-        pPainter->drawLine(QPointF(offsetX, 0), QPointF(offsetX, 1.5 * rightMid));
-
-        const uint8_t rightLow = pWaveform->getLow(completion + 1);
-        pPainter->setPen(m_colorLow);
-        pPainter->drawLine(QPointF(offsetX, 0), QPointF(offsetX, rightLow));
+    const int barsPerColumn = static_cast<int>(channels.size()) *
+            (m_renderer == Renderer::Filtered ? 3 : 1);
+    QVector<QSGGeometry::ColoredPoint2D> vertices(
+            completedColumns * barsPerColumn * kVerticesPerBar);
+    int vertexCount = 0;
+    const auto addBar = [&](int column, float value, int channel, const QColor& color) {
+        if (value <= 0 || !color.isValid()) {
+            return;
+        }
+        const float x0 = static_cast<float>(column);
+        const float x1 = x0 + 1.0f;
+        // The left channel grows upwards, the right channel downwards
+        const float y = channel == 0
+                ? -std::min(value, static_cast<float>(kDesiredChannelHeight))
+                : std::min(value, static_cast<float>(kDesiredChannelHeight));
+        const uchar r = static_cast<uchar>(color.red());
+        const uchar g = static_cast<uchar>(color.green());
+        const uchar b = static_cast<uchar>(color.blue());
+        const uchar a = static_cast<uchar>(color.alpha());
+        vertices[vertexCount++].set(x0, 0.0f, r, g, b, a);
+        vertices[vertexCount++].set(x1, 0.0f, r, g, b, a);
+        vertices[vertexCount++].set(x0, y, r, g, b, a);
+        vertices[vertexCount++].set(x0, y, r, g, b, a);
+        vertices[vertexCount++].set(x1, 0.0f, r, g, b, a);
+        vertices[vertexCount++].set(x1, y, r, g, b, a);
+    };
+
+    for (int column = 0; column < completedColumns; ++column) {
+        // The maximum of all summary entries that fall into this column
+        const int first = static_cast<int>(static_cast<qint64>(column) * visualSize / columns);
+        const int last = std::max(first + 1,
+                static_cast<int>(static_cast<qint64>(column + 1) * visualSize / columns));
+        for (int channel : channels) {
+            uchar low = 0;
+            uchar mid = 0;
+            uchar high = 0;
+            uchar all = 0;
+            for (int i = first; i < last; ++i) {
+                const int index = 2 * i + channel;
+                low = std::max(low, pWaveform->getLow(index));
+                mid = std::max(mid, pWaveform->getMid(index));
+                high = std::max(high, pWaveform->getHigh(index));
+                all = std::max(all, pWaveform->getAll(index));
+            }
+            switch (m_renderer) {
+            case Renderer::Filtered:
+                addBar(column, 2.0f * high, channel, m_colorHigh);
+                addBar(column, 1.5f * mid, channel, m_colorMid);
+                addBar(column, low, channel, m_colorLow);
+                break;
+            default:
+                addBar(column, all, channel, getRgbPenColor(low, mid, high));
+            }
+        }
     }
+    // Empty bars have been skipped
+    pGeometry->allocate(vertexCount);
+    std::copy(vertices.cbegin(),
+            vertices.cbegin() + vertexCount,
+            pGeometry->vertexDataAsColoredPoint2D());
 }
 
-QColor QmlWaveformOverview::getRgbPenColor(ConstWaveformPointer pWaveform, int completion) const {
-    // Retrieve "raw" LMH values from waveform
-    qreal low = static_cast<qreal>(pWaveform->getLow(completion));
-    qreal mid = static_cast<qreal>(pWaveform->getMid(completion));
-    qreal high = static_cast<qreal>(pWaveform->getHigh(completion));
-
+QColor QmlWaveformOverview::getRgbPenColor(qreal low, qreal mid, qreal high) const {
     // Do matrix multiplication
     qreal red = low * m_colorLow.redF() + mid * m_colorMid.redF() + high * m_colorHigh.redF();
     qreal green = low * m_colorLow.greenF() + mid * m_colorMid.greenF() +
@@ -1,9 +1,7 @@
 #pragma once
 
-#include <QPainter>
 #include <QPointer>
 #include <QQuickItem>
-#include <QQuickPaintedItem>
 #include <QtQml>
 
 #include "qml/qmlplayerproxy.h"
@@ -12,8 +10,13 @@
 namespace mixxx {
 namespace qml {
 
-
-class QmlWaveformOverview : public QQuickPaintedItem {
+/// The overview of the waveform summary, rendered as scene graph geometry.
+///
+/// The summary is decimated to at most one bar per device pixel and the bars
+/// are uploaded as vertex colored triangles. The geometry is only rebuilt
+/// when the waveform, the colors or the resolution changes. Resizing within
+/// the same resolution only updates the transform of the node.
+class QmlWaveformOverview : public QQuickItem {
     Q_OBJECT
     Q_FLAGS(Channels)
     Q_PROPERTY(mixxx::qml::QmlPlayerProxy* player READ getPlayer WRITE setPlayer
@@ -42,7 +45,7 @@ class QmlWaveformOverview : public QQuickPaintedItem {
     QmlWaveformOverview(QQuickItem* parent = nullptr);
     ~QmlWaveformOverview() override = default;
 
-    void paint(QPainter* painter);
+    QSGNode* updatePaintNode(QSGNode* pOldNode, UpdatePaintNodeData* pData) override;
 
     void setPlayer(QmlPlayerProxy* player);
     QmlPlayerProxy* getPlayer() const;
@@ -54,6 +57,7 @@ class QmlWaveformOverview : public QQuickPaintedItem {
     void slotTrackLoading(TrackPointer pNewTrack, TrackPointer pOldTrack);
     void slotTrackUnloaded();
     void slotWaveformUpdated();
+    void slotGeometryDirty();
 
   signals:
     void playerChanged();
@@ -63,17 +67,16 @@ class QmlWaveformOverview : public QQuickPaintedItem {
     void colorMidChanged(const QColor& color);
     void colorLowChanged(const QColor& color);
 
+  protected:
+    void geometryChange(const QRectF& newGeometry, const QRectF& oldGeometry) override;
+
   private:
     void setCurrentTrack(TrackPointer pTrack);
-    void drawFiltered(QPainter* pPainter,
-            Channels channels,
-            ConstWaveformPointer pWaveform,
-            int completion) const;
-    void drawRgb(QPainter* pPainter,
-            Channels channels,
-            ConstWaveformPointer pWaveform,
-            int completion) const;
-    QColor getRgbPenColor(ConstWaveformPointer pWaveform, int completion) const;
+    int columnCount(int visualSize) const;
+    void updateGeometry(QSGGeometry* pGeometry,
+            const ConstWaveformPointer& pWaveform,
+            int columns) const;
+    QColor getRgbPenColor(qreal low, qreal mid, qreal high) const;
 
     QPointer<QmlPlayerProxy> m_pPlayer;
     TrackPointer m_pCurrentTrack;
@@ -82,6 +85,10 @@ class QmlWaveformOverview : public QQuickPaintedItem {
     QColor m_colorHigh;
     QColor m_colorMid;
     QColor m_colorLow;
+
+    // Read by updatePaintNode(), while the GUI thread is blocked
+    bool m_geometryDirty;
+    int m_columns;
 };
 
 } // namespace qml
@@ -8,16 +8,20 @@
 
 #include "control/controlpushbutton.h"
 #include "engine/enginemixer.h"
+#include "engine/sidechain/enginemultitrackrecord.h"
 #include "engine/sidechain/enginerecord.h"
 #include "engine/sidechain/enginesidechain.h"
 #include "errordialoghandler.h"
+#include "mixer/playermanager.h"
 #include "moc_recordingmanager.cpp"
 #include "recording/defs_recording.h"
+#include "util/math.h"
 
 #define MIN_DISK_FREE 1024 * 1024 * 1024ll // one gibibyte
 
 RecordingManager::RecordingManager(UserSettingsPointer pConfig, EngineMixer* pEngine)
         : m_pConfig(pConfig),
+          m_pMultitrackRecord(pEngine->getMultitrackRecord()),
           m_recordingDir(""),
           m_recording_base_file(""),
           m_recordingFile(""),
@@ -135,6 +139,27 @@ void RecordingManager::startRecording() {
     m_pConfig->set(ConfigKey(RECORDING_PREF_KEY, "CuePath"), ConfigValue(m_recording_base_file + QStringLiteral(".cue")));
 
     m_pCoRecStatus->set(RECORD_READY);
+    startMultitrackRecording();
+}
+
+void RecordingManager::startMultitrackRecording() {
+    if (!m_pMultitrackRecord ||
+            !m_pConfig->getValue(ConfigKey(RECORDING_PREF_KEY, "Multitrack"), false)) {
+        return;
+    }
+    const auto sampleRate = mixxx::audio::SampleRate::fromDouble(
+            ControlObject::get(ConfigKey(QStringLiteral("[App]"), QStringLiteral("samplerate"))));
+    const int numTracks = math_min(static_cast<int>(PlayerManager::numDecks()),
+            EngineMultitrackRecord::kMaxTracks);
+    const bool postFader = m_pConfig->getValue(
+            ConfigKey(RECORDING_PREF_KEY, "MultitrackPostFader"), false);
+    if (!m_pMultitrackRecord->startRecording(
+                m_recording_base_file + QStringLiteral(".stems.caf"),
+                sampleRate,
+                numTracks,
+                postFader)) {
+        qWarning() << "Could not start recording the stems";
+    }
 }
 
 void RecordingManager::splitContinueRecording()
@@ -163,6 +188,9 @@ void RecordingManager::splitContinueRecording()
 void RecordingManager::stopRecording() {
     qDebug() << "Recording stopped";
     m_pCoRecStatus->set(RECORD_OFF);
+    if (m_pMultitrackRecord) {
+        m_pMultitrackRecord->stopRecording();
+    }
     m_recordingFile = "";
     m_recordingLocation = "";
     m_iNumberOfBytesRecorded = 0;
@@ -281,6 +309,9 @@ void RecordingManager::slotIsRecording(bool isRecordingActive, bool error) {
     emit isRecording(isRecordingActive);
 
     if (error) {
+        if (m_pMultitrackRecord) {
+            m_pMultitrackRecord->stopRecording();
+        }
         ErrorDialogProperties* props = ErrorDialogHandler::instance()->newDialogProperties();
         props->setType(DLG_WARNING);
         props->setTitle(tr("Recording"));
@@ -8,6 +8,7 @@
 #include "preferences/usersettings.h"
 
 class EngineMixer;
+class EngineMultitrackRecord;
 class ControlPushButton;
 class ControlProxy;
 class QDateTime;
@@ -58,6 +59,9 @@ class RecordingManager : public QObject {
     // name of the first split but with a suffix.
     void splitContinueRecording();
     void warnFreespace();
+    // Records each deck to a stems file next to the mix if enabled in the
+    // preferences. The stems are not split.
+    void startMultitrackRecording();
     std::unique_ptr<ControlObject> m_pCoRecStatus;
     std::unique_ptr<ControlPushButton> m_pToggleRecording;
 
@@ -66,6 +70,7 @@ class RecordingManager : public QObject {
     qint64 getFreeSpace();
 
     UserSettingsPointer m_pConfig;
+    EngineMultitrackRecord* m_pMultitrackRecord;
     QString m_recordingDir;
     // the base file
     QString m_recording_base_file;
@@ -0,0 +1,118 @@
+#include "shaders/rgbwaveformshader.h"
+
+using namespace mixxx;
+
+void RGBWaveformShader::init() {
+    QString vertexShaderCode = QStringLiteral(R"--(
+uniform highp mat4 matrix;
+attribute highp vec4 position; // use vec4 here (will be padded) for matrix multiplication
+varying highp vec2 vPosition;
+void main()
+{
+    vPosition = position.xy;
+    gl_Position = matrix * position;
+}
+)--");
+
+    // The number of texture lookups per channel and fragment is limited.
+    // When zoomed out very far the covered visual frames are subsampled.
+    QString fragmentShaderCode = QStringLiteral(R"--(
+uniform sampler2D waveformTexture;
+uniform highp float textureStride;
+uniform highp float dataSize;
+uniform highp float firstVisualFrame;
+uniform highp float visualIncrementPerPixel;
+uniform highp float halfBreadth;
+uniform highp float heightFactor;
+uniform highp float axisHalfWidth;
+uniform highp vec3 gains;
+uniform highp vec3 lowColor;
+uniform highp vec3 midColor;
+uniform highp vec3 highColor;
+uniform highp vec3 axesColor;
+varying highp vec2 vPosition;
+
+const int kMaxFramesPerPixel = 64;
+
+highp vec4 waveformData(highp float index)
+{
+    highp float row = floor(index / textureStride);
+    highp float column = index - row * textureStride;
+    return texture2D(waveformTexture, (vec2(column, row) + 0.5) / textureStride);
+}
+
+void main()
+{
+    // The lines of WaveformRendererRGB are centered on integer positions
+    highp float pos = floor(vPosition.x + 0.5);
+    highp float xVisualFrame = firstVisualFrame + pos * visualIncrementPerPixel;
+    highp float maxSamplingRange = visualIncrementPerPixel / 2.0;
+    highp float frameStart = floor(xVisualFrame - maxSamplingRange + 0.5);
+    highp float frameStop = max(floor(xVisualFrame + maxSamplingRange + 0.5), frameStart + 1.0);
+    highp float frameBegin = max(frameStart, 0.0);
+    highp float frameEnd = min(frameStop, dataSize / 2.0);
+    highp float frameStep = max(1.0, ceil((frameEnd - frameBegin) / float(kMaxFramesPerPixel)));
+
+    // Low, mid and high of both channels and all per channel
+    highp vec3 maxBands = vec3(0.0);
+    highp vec2 maxAll = vec2(0.0);
+    for (int i = 0; i < kMaxFramesPerPixel; ++i) {
+        highp float frame = frameBegin + float(i) * frameStep;
+        if (frame >= frameEnd) {
+            break;
+        }
+        // data is interleaved left / right
+        highp vec4 left = waveformData(frame * 2.0);
+        highp vec4 right = waveformData(frame * 2.0 + 1.0);
+        maxBands = max(maxBands, max(left.rgb, right.rgb));
+        maxAll = max(maxAll, vec2(left.a, right.a));
+    }
+
+    // Scale the amplitude according to the magnitude of the gained bands
+    highp vec3 gainedBands = maxBands * gains;
+    highp float sum = dot(maxBands, maxBands);
+    if (sum != 0.0) {
+        maxAll *= sqrt(dot(gainedBands, gainedBands) / sum);
+    }
+
+    highp vec3 color = lowColor * gainedBands.x +
+            midColor * gainedBands.y +
+            highColor * gainedBands.z;
+    highp float maxComponent = max(color.r, max(color.g, color.b));
+    if (maxComponent == 0.0) {
+        color = vec3(0.0);
+    } else {
+        color /= maxComponent;
+    }
+
+    highp float y = vPosition.y;
+    if (maxAll.x + maxAll.y > 0.0 &&
+            y >= halfBreadth - heightFactor * maxAll.x &&
+            y <= halfBreadth + heightFactor * maxAll.y) {
+        gl_FragColor = vec4(color, 1.0);
+    } else if (abs(y - halfBreadth) <= axisHalfWidth) {
+        gl_FragColor = vec4(axesColor, 1.0);
+    } else {
+        discard;
+    }
+}
+)--");
+
+    load(vertexShaderCode, fragmentShaderCode);
+
+    m_matrixLocation = uniformLocation("matrix");
+    m_positionLocation = attributeLocation("position");
+    m_waveformTextureLocation = uniformLocation("waveformTexture");
+    m_textureStrideLocation = uniformLocation("textureStride");
+    m_dataSizeLocation = uniformLocation("dataSize");
+    m_firstVisualFrameLocation = uniformLocation("firstVisualFrame");
+    m_visualIncrementPerPixelLocation = uniformLocation("visualIncrementPerPixel");
+    m_halfBreadthLocation = uniformLocation("halfBreadth");
+    m_heightFactorLocation = uniformLocation("heightFactor");
+    m_axisHalfWidthLocation = uniformLocation("axisHalfWidth");
+    m_gainsLocation = uniformLocation("gains");
+    m_lowColorLocation = uniformLocation("lowColor");
+    m_midColorLocation = uniformLocation("midColor");
+    m_highColorLocation = uniformLocation("highColor");
+    m_axesColorLocation = uniformLocation("axesColor");
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "shaders/shader.h"
+
+namespace mixxx {
+class RGBWaveformShader;
+}
+
+/// Draws the RGB waveform entirely on the GPU from the waveform data
+/// that has been uploaded into a texture, see allshader::WaveformDataTexture.
+///
+/// Each fragment determines the maximum of the visual frames that are
+/// covered by its pixel column, like allshader::WaveformRendererRGB does
+/// on the CPU for each column.
+class mixxx::RGBWaveformShader final : public mixxx::Shader {
+  public:
+    RGBWaveformShader() = default;
+    ~RGBWaveformShader() = default;
+    void init();
+
+    int matrixLocation() const {
+        return m_matrixLocation;
+    }
+    int positionLocation() const {
+        return m_positionLocation;
+    }
+    int waveformTextureLocation() const {
+        return m_waveformTextureLocation;
+    }
+    int textureStrideLocation() const {
+        return m_textureStrideLocation;
+    }
+    int dataSizeLocation() const {
+        return m_dataSizeLocation;
+    }
+    int firstVisualFrameLocation() const {
+        return m_firstVisualFrameLocation;
+    }
+    int visualIncrementPerPixelLocation() const {
+        return m_visualIncrementPerPixelLocation;
+    }
+    int halfBreadthLocation() const {
+        return m_halfBreadthLocation;
+    }
+    int heightFactorLocation() const {
+        return m_heightFactorLocation;
+    }
+    int axisHalfWidthLocation() const {
+        return m_axisHalfWidthLocation;
+    }
+    int gainsLocation() const {
+        return m_gainsLocation;
+    }
+    int lowColorLocation() const {
+        return m_lowColorLocation;
+    }
+    int midColorLocation() const {
+        return m_midColorLocation;
+    }
+    int highColorLocation() const {
+        return m_highColorLocation;
+    }
+    int axesColorLocation() const {
+        return m_axesColorLocation;
+    }
+
+  private:
+    int m_matrixLocation;
+    int m_positionLocation;
+    int m_waveformTextureLocation;
+    int m_textureStrideLocation;
+    int m_dataSizeLocation;
+    int m_firstVisualFrameLocation;
+    int m_visualIncrementPerPixelLocation;
+    int m_halfBreadthLocation;
+    int m_heightFactorLocation;
+    int m_axisHalfWidthLocation;
+    int m_gainsLocation;
+    int m_lowColorLocation;
+    int m_midColorLocation;
+    int m_highColorLocation;
+    int m_axesColorLocation;
+
+    DISALLOW_COPY_AND_ASSIGN(RGBWaveformShader)
+};
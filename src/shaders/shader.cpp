@@ -15,6 +15,21 @@ Shader::Shader() = default;
 Shader::~Shader() = default;
 
 void Shader::load(const QString& vertexShaderCode, const QString& fragmentShaderCode) {
+#ifdef MIXXX_USE_QOPENGL
+    // The linked program binary is stored in Qt's shader disk cache. The
+    // cache key covers the sources as well as the GL vendor, renderer and
+    // version, i.e. after a driver or GPU change the shaders are compiled
+    // again.
+    VERIFY_OR_DEBUG_ASSERT(addCacheableShaderFromSourceCode(
+            GLShader::Vertex, vertexShaderCode)) {
+        return;
+    }
+
+    VERIFY_OR_DEBUG_ASSERT(addCacheableShaderFromSourceCode(
+            GLShader::Fragment, fragmentShaderCode)) {
+        return;
+    }
+#else
     VERIFY_OR_DEBUG_ASSERT(addShaderFromSourceCode(
             GLShader::Vertex, vertexShaderCode)) {
         return;
@@ -24,6 +39,7 @@ void Shader::load(const QString& vertexShaderCode, const QString& fragmentShader
             GLShader::Fragment, fragmentShaderCode)) {
         return;
     }
+#endif
 
     VERIFY_OR_DEBUG_ASSERT(link()) {
         return;
@@ -4,6 +4,7 @@
 
 #include "coreservices.h"
 #include "skin/legacy/legacyskinparser.h"
+#include "skin/legacy/skindocumentcache.h"
 
 namespace {
 
@@ -116,6 +117,14 @@ bool LegacySkin::fitsScreenSize(const QScreen& screen) const {
             skinHeight.toInt() <= screenSize.height();
 }
 
+void LegacySkin::prefetch(UserSettingsPointer pConfig) const {
+    VERIFY_OR_DEBUG_ASSERT(isValid()) {
+        return;
+    }
+    SkinDocumentCache::prefetch(m_path.absoluteFilePath(),
+            pConfig->getResourcePath() + QStringLiteral("skins/"));
+}
+
 LaunchImage* LegacySkin::loadLaunchImage(QWidget* pParent, UserSettingsPointer pConfig) const {
     VERIFY_OR_DEBUG_ASSERT(isValid()) {
         return nullptr;
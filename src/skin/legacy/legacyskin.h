@@ -33,6 +33,7 @@ class LegacySkin : public mixxx::skin::Skin {
     QList<QString> colorschemes() const override;
 
     bool fitsScreenSize(const QScreen& screen) const override;
+    void prefetch(UserSettingsPointer pConfig) const override;
     LaunchImage* loadLaunchImage(QWidget* pParent, UserSettingsPointer pConfig) const override;
     QWidget* loadSkin(QWidget* pParent,
             UserSettingsPointer pConfig,
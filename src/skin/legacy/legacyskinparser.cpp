@@ -22,6 +22,7 @@
 #include "skin/legacy/colorschemeparser.h"
 #include "skin/legacy/launchimage.h"
 #include "skin/legacy/skincontext.h"
+#include "skin/legacy/skindocumentcache.h"
 #include "track/track.h"
 #include "util/cmdlineargs.h"
 #include "util/timer.h"
@@ -232,13 +233,16 @@ QDomElement LegacySkinParser::openSkin(const QString& skinPath) {
         return QDomElement();
     }
 
-    QDomDocument skin("skin");
-
     QString errorMessage;
     int errorLine;
     int errorColumn;
 
-    if (!skin.setContent(&skinXmlFile,&errorMessage,&errorLine,&errorColumn)) {
+    const QDomDocument skin = SkinDocumentCache::parse(skinXmlPath,
+            skinXmlFile.readAll(),
+            &errorMessage,
+            &errorLine,
+            &errorColumn);
+    if (skin.isNull()) {
         qDebug() << "LegacySkinParser::openSkin - setContent failed see"
                  << "line:" << errorLine << "column:" << errorColumn;
         qDebug() << "LegacySkinParser::openSkin - message:" << errorMessage;
@@ -1715,13 +1719,16 @@ QDomElement LegacySkinParser::loadTemplate(const QString& path) {
         qWarning() << "Could not open template file:" << absolutePath;
     }
 
-    QDomDocument tmpl("template");
     QString errorMessage;
     int errorLine;
     int errorColumn;
 
-    if (!tmpl.setContent(&templateFile, &errorMessage,
-                         &errorLine, &errorColumn)) {
+    const QDomDocument tmpl = SkinDocumentCache::parse(absolutePath,
+            templateFile.readAll(),
+            &errorMessage,
+            &errorLine,
+            &errorColumn);
+    if (tmpl.isNull()) {
         qWarning() << "LegacySkinParser::loadTemplate - setContent failed see"
                    << absolutePath << "line:" << errorLine << "column:" << errorColumn;
         qWarning() << "LegacySkinParser::loadTemplate - message:" << errorMessage;
@@ -0,0 +1,122 @@
+#include "skin/legacy/skindocumentcache.h"
+
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QFuture>
+#include <QHash>
+#include <QList>
+#include <QStringList>
+#include <QtConcurrentRun>
+#include <QtDebug>
+
+#include "util/timer.h"
+
+namespace {
+
+const QString kSkinManifestFileName = QStringLiteral("skin.xml");
+const QString kTemplateTagName = QStringLiteral("Template");
+const QString kTemplateSrcAttribute = QStringLiteral("src");
+// The search path prefixes of the templates, see SkinContext
+const QString kSkinPrefix = QStringLiteral("skin:");
+const QString kSkinsPrefix = QStringLiteral("skins:");
+
+struct CachedDocument {
+    QByteArray contentHash;
+    QDomDocument document;
+};
+
+typedef QHash<QString, CachedDocument> CachedDocuments;
+
+CachedDocuments s_documents;
+QList<QFuture<CachedDocuments>> s_prefetches;
+
+QByteArray hashContent(const QByteArray& content) {
+    return QCryptographicHash::hash(content, QCryptographicHash::Sha1);
+}
+
+// Runs on a worker thread. The search paths of QDir are set up by the
+// parser on the main thread, so the prefixes are resolved here.
+CachedDocuments parseSkinDocuments(const QString& skinPath, const QString& skinsPath) {
+    CachedDocuments documents;
+    QStringList pendingFilePaths{QDir(skinPath).filePath(kSkinManifestFileName)};
+    while (!pendingFilePaths.isEmpty()) {
+        const QString filePath = QFileInfo(pendingFilePaths.takeLast()).canonicalFilePath();
+        if (filePath.isEmpty() || documents.contains(filePath)) {
+            continue;
+        }
+        QFile file(filePath);
+        if (!file.open(QIODevice::ReadOnly)) {
+            continue;
+        }
+        const QByteArray content = file.readAll();
+        QDomDocument document;
+        if (!document.setContent(content)) {
+            // Reported when the skin is loaded
+            continue;
+        }
+
+        const QDomNodeList templates = document.elementsByTagName(kTemplateTagName);
+        for (int i = 0; i < templates.count(); ++i) {
+            const QString src = templates.at(i).toElement().attribute(kTemplateSrcAttribute);
+            if (src.startsWith(kSkinPrefix)) {
+                pendingFilePaths.append(
+                        QDir(skinPath).filePath(src.mid(kSkinPrefix.size())));
+            } else if (src.startsWith(kSkinsPrefix)) {
+                pendingFilePaths.append(
+                        QDir(skinsPath).filePath(src.mid(kSkinsPrefix.size())));
+            }
+        }
+        documents.insert(filePath, CachedDocument{hashContent(content), document});
+    }
+    return documents;
+}
+
+void takePrefetchedDocuments() {
+    if (s_prefetches.isEmpty()) {
+        return;
+    }
+    ScopedTimer t("SkinDocumentCache::takePrefetchedDocuments");
+    for (auto& prefetch : s_prefetches) {
+        const CachedDocuments documents = prefetch.result();
+        for (auto it = documents.constBegin(); it != documents.constEnd(); ++it) {
+            s_documents.insert(it.key(), it.value());
+        }
+    }
+    s_prefetches.clear();
+}
+
+} // anonymous namespace
+
+// static
+QDomDocument SkinDocumentCache::parse(const QString& filePath,
+        const QByteArray& content,
+        QString* pErrorMessage,
+        int* pErrorLine,
+        int* pErrorColumn) {
+    takePrefetchedDocuments();
+
+    const QString key = QFileInfo(filePath).canonicalFilePath();
+    const QByteArray contentHash = hashContent(content);
+    const auto it = s_documents.constFind(key);
+    if (it != s_documents.constEnd() && it.value().contentHash == contentHash) {
+        return it.value().document;
+    }
+
+    QDomDocument document;
+    if (!document.setContent(content, pErrorMessage, pErrorLine, pErrorColumn)) {
+        s_documents.remove(key);
+        return QDomDocument();
+    }
+    if (!key.isEmpty()) {
+        s_documents.insert(key, CachedDocument{contentHash, document});
+    }
+    return document;
+}
+
+// static
+void SkinDocumentCache::prefetch(const QString& skinPath, const QString& skinsPath) {
+    qDebug() << "SkinDocumentCache: prefetching" << skinPath;
+    s_prefetches.append(QtConcurrent::run(parseSkinDocuments, skinPath, skinsPath));
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <QByteArray>
+#include <QDomDocument>
+#include <QString>
+
+/// Keeps the parsed XML documents of legacy skins in memory, so the skin and
+/// its templates are not parsed again when the skin is reloaded or another
+/// skin is loaded that shares templates with it. Each entry is validated with
+/// a hash of the file contents, so changes made while developing a skin are
+/// picked up.
+///
+/// prefetch() parses the skin.xml of a skin and all templates it references
+/// on a worker thread, while the rest of Mixxx is starting or the user looks
+/// at the preview of the skin.
+///
+/// Everything but the worker is accessed from the main thread only.
+class SkinDocumentCache {
+  public:
+    /// Returns the document of the file with the given content. A null
+    /// document is returned if the content is not valid XML.
+    static QDomDocument parse(const QString& filePath,
+            const QByteArray& content,
+            QString* pErrorMessage = nullptr,
+            int* pErrorLine = nullptr,
+            int* pErrorColumn = nullptr);
+
+    /// Starts parsing the documents of the skin in the given directory in
+    /// the background. The next call of parse() waits until it has finished.
+    static void prefetch(const QString& skinPath, const QString& skinsPath);
+};
@@ -41,6 +41,9 @@ class Skin {
 
     virtual bool fitsScreenSize(const QScreen& screen) const = 0;
 
+    /// Starts preparing the skin in the background, so a following
+    /// loadSkin() has less to do
+    virtual void prefetch(UserSettingsPointer pConfig) const = 0;
     virtual LaunchImage* loadLaunchImage(QWidget* pParent, UserSettingsPointer pConfig) const = 0;
     virtual QWidget* loadSkin(QWidget* pParent,
             UserSettingsPointer pConfig,
@@ -199,6 +199,13 @@ LaunchImage* SkinLoader::loadLaunchImage(QWidget* pParent) const {
     return pLaunchImage;
 }
 
+void SkinLoader::prefetchConfiguredSkin() const {
+    SkinPointer pSkin = getConfiguredSkin();
+    if (pSkin) {
+        pSkin->prefetch(m_pConfig);
+    }
+}
+
 QString SkinLoader::pickResizableSkin(const QString& oldSkin) const {
     if (oldSkin.contains("latenight", Qt::CaseInsensitive)) {
         return "LateNight";
@@ -27,6 +27,9 @@ class SkinLoader : public QObject {
             mixxx::CoreServices* pCoreServices);
 
     LaunchImage* loadLaunchImage(QWidget* pParent) const;
+    /// Parses the configured skin in the background while the rest of
+    /// Mixxx is initialized
+    void prefetchConfiguredSkin() const;
 
     SkinPointer getSkin(const QString& skinName) const;
     SkinPointer getConfiguredSkin() const;
@@ -0,0 +1,63 @@
+#include "soundio/adaptivebuffersize.h"
+
+#include <algorithm>
+#include <iterator>
+
+AdaptiveBufferSize::AdaptiveBufferSize(
+        unsigned int configuredIndex, unsigned int maxIndex)
+        : m_configuredIndex(configuredIndex),
+          m_maxIndex(maxIndex),
+          m_currentIndex(configuredIndex),
+          m_targetIndex(configuredIndex) {
+    restartObservation();
+}
+
+void AdaptiveBufferSize::setConfiguredIndex(unsigned int configuredIndex) {
+    m_configuredIndex = configuredIndex;
+    setCurrentIndex(configuredIndex);
+}
+
+void AdaptiveBufferSize::setCurrentIndex(unsigned int currentIndex) {
+    m_currentIndex = currentIndex;
+    m_targetIndex = currentIndex;
+    restartObservation();
+}
+
+void AdaptiveBufferSize::restartObservation() {
+    std::fill(std::begin(m_xruns), std::end(m_xruns), 0);
+    m_second = 0;
+    m_secondsWithoutXrun = 0;
+    m_maxLoad = 0.0;
+}
+
+unsigned int AdaptiveBufferSize::update(int xruns, double callbackLoad) {
+    m_xruns[m_second] = xruns;
+    m_second = (m_second + 1) % kXrunWindowSeconds;
+    if (xruns > 0) {
+        m_secondsWithoutXrun = 0;
+        m_maxLoad = 0.0;
+    } else {
+        ++m_secondsWithoutXrun;
+        m_maxLoad = std::max(m_maxLoad, callbackLoad);
+    }
+
+    if (m_targetIndex != m_currentIndex) {
+        // Waiting until the previous decision has been applied
+        return m_targetIndex;
+    }
+
+    int recentXruns = 0;
+    for (int count : m_xruns) {
+        recentXruns += count;
+    }
+    if (recentXruns >= kXrunThreshold) {
+        if (m_currentIndex < m_maxIndex) {
+            m_targetIndex = m_currentIndex + 1;
+        }
+    } else if (m_currentIndex > m_configuredIndex &&
+            m_secondsWithoutXrun >= kHeadroomSeconds &&
+            m_maxLoad < kHeadroomLoad) {
+        m_targetIndex = m_currentIndex - 1;
+    }
+    return m_targetIndex;
+}
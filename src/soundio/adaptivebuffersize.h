@@ -0,0 +1,55 @@
+#pragma once
+
+/// Decides when the audio buffer size should be changed to recover from
+/// xruns, in units of SoundManagerConfig::AudioBufferSizeIndex.
+///
+/// The buffer size is increased by one step when kXrunThreshold xruns have
+/// happened within kXrunWindowSeconds. Once there have been no xruns for
+/// kHeadroomSeconds and the engine uses less than kHeadroomLoad of the
+/// buffer time, it is decreased by one step again, but never below the size
+/// configured by the user.
+///
+/// This class only decides. The caller applies the target size, e.g. when
+/// a device restart is not audible, and reports it with setCurrentIndex().
+class AdaptiveBufferSize {
+  public:
+    static constexpr int kXrunThreshold = 3;
+    static constexpr int kXrunWindowSeconds = 30;
+    static constexpr int kHeadroomSeconds = 300;
+    // The load roughly doubles when the buffer size is halved
+    static constexpr double kHeadroomLoad = 0.35;
+
+    AdaptiveBufferSize(unsigned int configuredIndex, unsigned int maxIndex);
+
+    void setConfiguredIndex(unsigned int configuredIndex);
+    void setCurrentIndex(unsigned int currentIndex);
+
+    /// Called once per second with the number of xruns since the last call
+    /// and the current callback load, the fraction of the buffer time spent
+    /// in the engine. Returns the buffer size index that should be used.
+    unsigned int update(int xruns, double callbackLoad);
+
+    unsigned int configuredIndex() const {
+        return m_configuredIndex;
+    }
+    unsigned int currentIndex() const {
+        return m_currentIndex;
+    }
+    unsigned int targetIndex() const {
+        return m_targetIndex;
+    }
+
+  private:
+    void restartObservation();
+
+    unsigned int m_configuredIndex;
+    const unsigned int m_maxIndex;
+    unsigned int m_currentIndex;
+    unsigned int m_targetIndex;
+
+    // Xruns per second of the current window, a ring buffer
+    int m_xruns[kXrunWindowSeconds];
+    int m_second;
+    int m_secondsWithoutXrun;
+    double m_maxLoad;
+};
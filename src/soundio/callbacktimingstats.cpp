@@ -0,0 +1,102 @@
+#include "soundio/callbacktimingstats.h"
+
+#include <algorithm>
+#include <cmath>
+
+void CallbackTimingHistogram::add(double bufferFraction) {
+    const int bucket = std::clamp(
+            static_cast<int>(bufferFraction / kBucketWidth), 0, kBuckets - 1);
+    ++m_buckets[bucket];
+    ++m_count;
+}
+
+void CallbackTimingHistogram::clear() {
+    m_buckets.fill(0);
+    m_count = 0;
+}
+
+double CallbackTimingHistogram::quantile(double fraction) const {
+    if (m_count == 0) {
+        return 0.0;
+    }
+    const double target = fraction * m_count;
+    quint32 sum = 0;
+    for (int bucket = 0; bucket < kBuckets; ++bucket) {
+        sum += m_buckets[bucket];
+        if (sum >= target && sum > 0) {
+            return (bucket + 1) * kBucketWidth;
+        }
+    }
+    return kBuckets * kBucketWidth;
+}
+
+void CallbackTimingStats::reset(double bufferSeconds) {
+    *this = CallbackTimingStats();
+    m_bufferSeconds = bufferSeconds;
+}
+
+void CallbackTimingStats::record(qint64 entryNanos,
+        qint64 processingNanos,
+        double deadlineSeconds,
+        int frames) {
+    if (m_bufferSeconds <= 0) {
+        return;
+    }
+    const double processingSeconds = processingNanos * 1e-9;
+    const double headroomSeconds =
+            (deadlineSeconds > 0 ? deadlineSeconds : m_bufferSeconds) -
+            processingSeconds;
+    m_processing.add(processingSeconds / m_bufferSeconds);
+    m_headroom.add(headroomSeconds / m_bufferSeconds);
+    if (m_callbacks == 0) {
+        m_firstEntryNanos = entryNanos;
+        m_minHeadroomSeconds = headroomSeconds;
+    } else {
+        m_minHeadroomSeconds = std::min(m_minHeadroomSeconds, headroomSeconds);
+
+        const double intervalSeconds = (entryNanos - m_lastEntryNanos) * 1e-9;
+        m_intervals.add(intervalSeconds / m_bufferSeconds);
+        // Welford's algorithm, the first callback has no interval
+        const double delta = intervalSeconds - m_intervalMean;
+        m_intervalMean += delta / m_callbacks;
+        m_intervalM2 += delta * (intervalSeconds - m_intervalMean);
+    }
+    m_lastEntryNanos = entryNanos;
+    ++m_callbacks;
+
+    // The frames played before this callback over the time of its entry.
+    // The slope is the sample rate of the device in CPU time.
+    const double seconds = (entryNanos - m_firstEntryNanos) * 1e-9;
+    const double deltaSeconds = seconds - m_meanSeconds;
+    m_meanSeconds += deltaSeconds / m_callbacks;
+    m_meanFrames += (m_frames - m_meanFrames) / m_callbacks;
+    m_varianceSeconds += deltaSeconds * (seconds - m_meanSeconds);
+    m_covariance += deltaSeconds * (m_frames - m_meanFrames);
+    m_frames += frames;
+}
+
+double CallbackTimingStats::intervalJitterSeconds() const {
+    if (m_callbacks < 3) {
+        return 0.0;
+    }
+    return std::sqrt(m_intervalM2 / (m_callbacks - 2));
+}
+
+double CallbackTimingStats::measuredSampleRate() const {
+    if (m_callbacks < 2 ||
+            (m_lastEntryNanos - m_firstEntryNanos) * 1e-9 <
+                    kMinDriftMeasurementSeconds ||
+            m_varianceSeconds <= 0) {
+        return 0.0;
+    }
+    return m_covariance / m_varianceSeconds;
+}
+
+double CallbackTimingStats::driftPpm(const CallbackTimingStats& reference) const {
+    const double sampleRate = measuredSampleRate();
+    const double referenceSampleRate = reference.measuredSampleRate();
+    if (sampleRate <= 0 || referenceSampleRate <= 0) {
+        return 0.0;
+    }
+    return (sampleRate / referenceSampleRate - 1.0) * 1e6;
+}
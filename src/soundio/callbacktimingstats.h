@@ -0,0 +1,106 @@
+#pragma once
+
+#include <QtGlobal>
+#include <array>
+
+/// Histogram of durations in units of the buffer time of a sound device,
+/// in buckets of kBucketWidth. The last bucket also counts all longer
+/// durations, the first one all negative values.
+class CallbackTimingHistogram {
+  public:
+    static constexpr int kBuckets = 40;
+    static constexpr double kBucketWidth = 0.05;
+
+    void add(double bufferFraction);
+    void clear();
+
+    quint32 count() const {
+        return m_count;
+    }
+    quint32 bucketCount(int bucket) const {
+        return m_buckets[bucket];
+    }
+
+    /// Returns the upper bound of the bucket that holds the given quantile
+    /// (0..1) of all values, in units of the buffer time
+    double quantile(double fraction) const;
+
+  private:
+    std::array<quint32, kBuckets> m_buckets{};
+    quint32 m_count = 0;
+};
+
+/// Collects the timing of the audio callbacks of one sound device: the
+/// interval between the callbacks, the time spent processing and the
+/// headroom left until the buffer is played. It also measures the sample
+/// rate of the device clock against the CPU clock, which allows to estimate
+/// the clock drift between multiple devices.
+///
+/// Not thread safe, the callback records and publishes copies.
+class CallbackTimingStats {
+  public:
+    // Enough for an estimate of the sample rate within a few ppm
+    static constexpr double kMinDriftMeasurementSeconds = 10.0;
+
+    void reset(double bufferSeconds);
+
+    /// Records a callback that has been entered at entryNanos and took
+    /// processingNanos. deadlineSeconds is the time from the entry until the
+    /// first frame of the buffer is played, or <= 0 if it is not known.
+    void record(qint64 entryNanos,
+            qint64 processingNanos,
+            double deadlineSeconds,
+            int frames);
+
+    const CallbackTimingHistogram& intervals() const {
+        return m_intervals;
+    }
+    const CallbackTimingHistogram& processing() const {
+        return m_processing;
+    }
+    const CallbackTimingHistogram& headroom() const {
+        return m_headroom;
+    }
+
+    double bufferSeconds() const {
+        return m_bufferSeconds;
+    }
+    quint64 callbacks() const {
+        return m_callbacks;
+    }
+
+    /// Standard deviation of the interval between the callbacks
+    double intervalJitterSeconds() const;
+    double minHeadroomSeconds() const {
+        return m_minHeadroomSeconds;
+    }
+
+    /// The sample rate of the device clock measured with the CPU clock, or
+    /// 0 if the callbacks have not been recorded long enough
+    double measuredSampleRate() const;
+    /// The drift of the device clock compared to the one of the reference
+    /// device in parts per million, or 0 if it can't be measured yet
+    double driftPpm(const CallbackTimingStats& reference) const;
+
+  private:
+    CallbackTimingHistogram m_intervals;
+    CallbackTimingHistogram m_processing;
+    CallbackTimingHistogram m_headroom;
+
+    double m_bufferSeconds = 0.0;
+    quint64 m_callbacks = 0;
+    qint64 m_firstEntryNanos = 0;
+    qint64 m_lastEntryNanos = 0;
+    double m_minHeadroomSeconds = 0.0;
+
+    // Running mean and variance of the interval
+    double m_intervalMean = 0.0;
+    double m_intervalM2 = 0.0;
+
+    // Running linear regression of the frames played over the CPU time
+    double m_frames = 0.0;
+    double m_meanSeconds = 0.0;
+    double m_meanFrames = 0.0;
+    double m_varianceSeconds = 0.0;
+    double m_covariance = 0.0;
+};
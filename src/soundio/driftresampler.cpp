@@ -0,0 +1,192 @@
+#include "soundio/driftresampler.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace {
+
+// Kaiser window shape, a stop band attenuation of about 70 dB
+constexpr double kKaiserBeta = 7.0;
+
+// Smooths the fill level that jumps by a whole chunk when one callback
+// overtakes the other
+constexpr double kFillTimeConstantSeconds = 0.5;
+// A critically damped loop with a natural frequency of 0.2 rad/s. It settles
+// within about 30 s, slow enough that the ratio changes are inaudible.
+constexpr double kProportionalGain = 0.4;
+constexpr double kIntegralGain = 0.04;
+
+// Zeroth order modified Bessel function of the first kind
+double besselI0(double x) {
+    double sum = 1.0;
+    double term = 1.0;
+    for (int k = 1; k < 30; ++k) {
+        term *= (x / (2 * k)) * (x / (2 * k));
+        sum += term;
+    }
+    return sum;
+}
+
+using Coefficients =
+        std::array<std::array<CSAMPLE, DriftResampler::kTaps>,
+                DriftResampler::kPhases + 1>;
+
+// Phase p delays by p / kPhases frames. The extra last phase equals the
+// first one shifted by one tap, for the interpolation between phases.
+Coefficients makeCoefficients() {
+    constexpr int kTaps = DriftResampler::kTaps;
+    constexpr double kHalfWidth = kTaps / 2;
+    Coefficients coefficients;
+    for (int phase = 0; phase <= DriftResampler::kPhases; ++phase) {
+        const double fraction =
+                static_cast<double>(phase) / DriftResampler::kPhases;
+        double sum = 0.0;
+        std::array<double, kTaps> taps;
+        for (int tap = 0; tap < kTaps; ++tap) {
+            const double x = tap - (kHalfWidth - 1) - fraction;
+            const double sinc = x == 0 ? 1.0 : std::sin(M_PI * x) / (M_PI * x);
+            const double window = std::abs(x) >= kHalfWidth
+                    ? 0.0
+                    : besselI0(kKaiserBeta *
+                              std::sqrt(1 - (x / kHalfWidth) * (x / kHalfWidth))) /
+                            besselI0(kKaiserBeta);
+            taps[tap] = sinc * window;
+            sum += taps[tap];
+        }
+        // Unity gain at DC for all phases
+        for (int tap = 0; tap < kTaps; ++tap) {
+            coefficients[phase][tap] = static_cast<CSAMPLE>(taps[tap] / sum);
+        }
+    }
+    return coefficients;
+}
+
+const Coefficients& coefficients() {
+    static const Coefficients s_coefficients = makeCoefficients();
+    return s_coefficients;
+}
+
+} // namespace
+
+void DriftResampler::init(int channels, int maxInputFrames) {
+    m_channels = channels;
+    // The history, a new input chunk and the remainder of the previous one
+    m_capacity = kTaps + 2 * maxInputFrames;
+    m_buffer.assign(static_cast<size_t>(m_channels) * m_capacity, 0);
+    // Compute the table now and not in the callback
+    coefficients();
+    reset();
+}
+
+void DriftResampler::reset() {
+    std::fill(m_buffer.begin(), m_buffer.end(), CSAMPLE());
+    m_bufferedFrames = kTaps - 1;
+    m_position = 0.0;
+    m_ratio = 1.0;
+}
+
+void DriftResampler::setRatio(double ratio) {
+    m_ratio = std::clamp(ratio, 1.0 - kMaxCorrection, 1.0 + kMaxCorrection);
+}
+
+int DriftResampler::inputFramesNeeded(int outputFrames) const {
+    if (outputFrames <= 0) {
+        return 0;
+    }
+    // Accumulated like in resample() to get exactly the same rounding
+    double position = m_position;
+    for (int i = 1; i < outputFrames; ++i) {
+        position += m_ratio;
+    }
+    const int needed = static_cast<int>(position) + kTaps - m_bufferedFrames;
+    return std::max(needed, 0);
+}
+
+void DriftResampler::appendInput(const CSAMPLE* pInput, int frames) {
+    frames = std::min(frames, inputFramesWritable());
+    for (int channel = 0; channel < m_channels; ++channel) {
+        CSAMPLE* pPlane = plane(channel) + m_bufferedFrames;
+        for (int frame = 0; frame < frames; ++frame) {
+            pPlane[frame] = pInput[frame * m_channels + channel];
+        }
+    }
+    m_bufferedFrames += frames;
+}
+
+void DriftResampler::appendSilence(int frames) {
+    frames = std::min(frames, inputFramesWritable());
+    for (int channel = 0; channel < m_channels; ++channel) {
+        CSAMPLE* pPlane = plane(channel) + m_bufferedFrames;
+        std::fill(pPlane, pPlane + frames, CSAMPLE());
+    }
+    m_bufferedFrames += frames;
+}
+
+int DriftResampler::resample(CSAMPLE* pOutput, int maxOutputFrames) {
+    const Coefficients& table = coefficients();
+    int produced = 0;
+    while (produced < maxOutputFrames) {
+        const int first = static_cast<int>(m_position);
+        if (first + kTaps > m_bufferedFrames) {
+            break;
+        }
+        const double phasePosition = (m_position - first) * kPhases;
+        const int phase = static_cast<int>(phasePosition);
+        const CSAMPLE weight = static_cast<CSAMPLE>(phasePosition - phase);
+        const auto& lower = table[phase];
+        const auto& upper = table[phase + 1];
+        CSAMPLE taps[kTaps];
+        for (int tap = 0; tap < kTaps; ++tap) {
+            taps[tap] = lower[tap] + weight * (upper[tap] - lower[tap]);
+        }
+        for (int channel = 0; channel < m_channels; ++channel) {
+            const CSAMPLE* pInput = plane(channel) + first;
+            CSAMPLE sum = 0;
+            for (int tap = 0; tap < kTaps; ++tap) {
+                sum += taps[tap] * pInput[tap];
+            }
+            pOutput[produced * m_channels + channel] = sum;
+        }
+        m_position += m_ratio;
+        ++produced;
+    }
+
+    // Drop the frames no longer needed for the history
+    const int consumed = std::min(static_cast<int>(m_position), m_bufferedFrames);
+    if (consumed > 0) {
+        for (int channel = 0; channel < m_channels; ++channel) {
+            CSAMPLE* pPlane = plane(channel);
+            std::copy(pPlane + consumed, pPlane + m_bufferedFrames, pPlane);
+        }
+        m_bufferedFrames -= consumed;
+        m_position -= consumed;
+    }
+    return produced;
+}
+
+void ClockDriftController::reset(double sampleRate, double targetFillFrames) {
+    m_sampleRate = sampleRate;
+    m_targetFillFrames = targetFillFrames;
+    m_filteredFillFrames = targetFillFrames;
+    m_integral = 0.0;
+}
+
+double ClockDriftController::update(double fillFrames, int callbackFrames) {
+    if (m_sampleRate <= 0) {
+        return 1.0;
+    }
+    const double seconds = callbackFrames / m_sampleRate;
+    m_filteredFillFrames += (fillFrames - m_filteredFillFrames) * seconds /
+            (kFillTimeConstantSeconds + seconds);
+    const double errorSeconds =
+            (m_filteredFillFrames - m_targetFillFrames) / m_sampleRate;
+    m_integral = std::clamp(m_integral + kIntegralGain * errorSeconds * seconds,
+            -DriftResampler::kMaxCorrection,
+            DriftResampler::kMaxCorrection);
+    const double correction = std::clamp(
+            kProportionalGain * errorSeconds + m_integral,
+            -DriftResampler::kMaxCorrection,
+            DriftResampler::kMaxCorrection);
+    return 1.0 + correction;
+}
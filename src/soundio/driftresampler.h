@@ -0,0 +1,88 @@
+#pragma once
+
+#include <vector>
+
+#include "util/types.h"
+
+/// Asynchronous sample rate converter for a device that is not driven by the
+/// clock of the clock reference device. It resamples by a ratio close to 1
+/// with a polyphase windowed sinc filter, so the slowly drifting clocks of two
+/// sound cards can be bridged without skipping or duplicating frames.
+///
+/// The input is stored planar, which allows the compiler to vectorize the
+/// filter loops. All buffers are allocated in init(), everything else is real
+/// time safe.
+class DriftResampler {
+  public:
+    static constexpr int kTaps = 32;
+    static constexpr int kPhases = 256;
+    /// Limits the ratio to 1 +/- kMaxCorrection, far more than the drift of
+    /// any crystal, to keep glitches after a jitter burst inaudible
+    static constexpr double kMaxCorrection = 0.002;
+
+    void init(int channels, int maxInputFrames);
+    /// Drops all input and refills the history with silence. This adds a
+    /// delay of kTaps / 2 frames.
+    void reset();
+
+    /// Input frames consumed per output frame
+    void setRatio(double ratio);
+    double ratio() const {
+        return m_ratio;
+    }
+
+    /// The number of input frames that need to be appended before
+    /// outputFrames can be produced with the current ratio
+    int inputFramesNeeded(int outputFrames) const;
+    int inputFramesWritable() const {
+        return m_capacity - m_bufferedFrames;
+    }
+
+    /// Appends interleaved frames
+    void appendInput(const CSAMPLE* pInput, int frames);
+    void appendSilence(int frames);
+
+    /// Writes up to maxOutputFrames interleaved frames and returns how many
+    /// could be produced from the buffered input
+    int resample(CSAMPLE* pOutput, int maxOutputFrames);
+
+  private:
+    CSAMPLE* plane(int channel) {
+        return &m_buffer[channel * m_capacity];
+    }
+
+    int m_channels = 0;
+    int m_capacity = 0;
+    int m_bufferedFrames = 0;
+    // The input position of the first tap for the next output frame
+    double m_position = 0.0;
+    double m_ratio = 1.0;
+    std::vector<CSAMPLE> m_buffer;
+};
+
+/// Estimates the drift between the clock reference device and another device
+/// from the fill level of the FIFO between them. It returns the resampling
+/// ratio that keeps the fill level at its target with a PI controller. The
+/// integral part converges to the clock drift.
+class ClockDriftController {
+  public:
+    void reset(double sampleRate, double targetFillFrames);
+
+    /// Called once per callback with the fill level seen by the non clock
+    /// reference device. Returns the ratio for the DriftResampler: > 1 if
+    /// the FIFO fills up.
+    double update(double fillFrames, int callbackFrames);
+
+    /// The estimated clock drift of the device. It is positive if the FIFO
+    /// tends to fill up, that is if an output device runs slower or an input
+    /// device faster than the clock reference device.
+    double driftPpm() const {
+        return m_integral * 1e6;
+    }
+
+  private:
+    double m_sampleRate = 0.0;
+    double m_targetFillFrames = 0.0;
+    double m_filteredFillFrames = 0.0;
+    double m_integral = 0.0;
+};
@@ -0,0 +1,155 @@
+#include "soundio/networkmonitormanager.h"
+
+#include <QHostInfo>
+#include <QMessageBox>
+
+#include "control/controlobject.h"
+#include "control/controlpushbutton.h"
+#include "engine/sidechain/enginenetworkstream.h"
+#include "engine/sidechain/networkmonitorpacket.h"
+#include "moc_networkmonitormanager.cpp"
+#include "soundio/soundmanager.h"
+#include "util/logger.h"
+
+namespace {
+
+const mixxx::Logger kLogger("NetworkMonitorManager");
+
+const QString kConfigGroup = QStringLiteral("[NetworkMonitor]");
+constexpr int kDefaultPort = 9950;
+constexpr int kDefaultJitterBufferMillis = 20;
+constexpr int kDefaultBitrateKbps = 128;
+constexpr int kStatsUpdateIntervalMillis = 250;
+
+} // namespace
+
+NetworkMonitorManager::NetworkMonitorManager(
+        UserSettingsPointer pConfig, SoundManager* pSoundManager)
+        : m_pConfig(pConfig),
+          m_pNetworkStream(pSoundManager->getNetworkStream()) {
+    m_pEnabled = new ControlPushButton(ConfigKey(kConfigGroup, "enabled"));
+    m_pEnabled->setButtonMode(ControlPushButton::TOGGLE);
+    connect(m_pEnabled,
+            &ControlPushButton::valueChanged,
+            this,
+            &NetworkMonitorManager::slotControlEnabled);
+
+    m_pPacketLoss = new ControlObject(ConfigKey(kConfigGroup, "packet_loss"));
+    m_pPacketLoss->setReadOnly();
+    m_pBufferMs = new ControlObject(ConfigKey(kConfigGroup, "buffer_ms"));
+    m_pBufferMs->setReadOnly();
+
+    m_statsTimer.setInterval(kStatsUpdateIntervalMillis);
+    connect(&m_statsTimer,
+            &QTimer::timeout,
+            this,
+            &NetworkMonitorManager::slotUpdateStats);
+}
+
+NetworkMonitorManager::~NetworkMonitorManager() {
+    stop();
+    delete m_pBufferMs;
+    delete m_pPacketLoss;
+    delete m_pEnabled;
+}
+
+void NetworkMonitorManager::slotControlEnabled(double v) {
+    if (v > 0.0) {
+        if (!start()) {
+            stop();
+            m_pEnabled->set(0.0);
+        }
+    } else {
+        stop();
+    }
+}
+
+bool NetworkMonitorManager::start() {
+    if (m_pOutput || m_pInput) {
+        return true;
+    }
+
+    const auto sampleRate = mixxx::audio::SampleRate::fromDouble(
+            ControlObject::get(ConfigKey(QStringLiteral("[App]"), QStringLiteral("samplerate"))));
+    if (sampleRate != mixxx::audio::SampleRate(NetworkMonitorPacket::kSampleRate)) {
+        QMessageBox::warning(nullptr,
+                tr("Action failed"),
+                tr("Network monitoring uses Opus, which requires a sample rate "
+                   "of 48000 Hz. Please change it in the Sound Hardware "
+                   "preferences."));
+        return false;
+    }
+
+    const QString remoteHost = m_pConfig->getValue(
+            ConfigKey(kConfigGroup, "RemoteHost"), QString());
+    const int remotePort = m_pConfig->getValue(
+            ConfigKey(kConfigGroup, "RemotePort"), kDefaultPort);
+    const int listenPort = m_pConfig->getValue(
+            ConfigKey(kConfigGroup, "ListenPort"), kDefaultPort);
+    const int jitterBufferMillis = m_pConfig->getValue(
+            ConfigKey(kConfigGroup, "JitterBufferMs"), kDefaultJitterBufferMillis);
+    const int bitrateKbps = m_pConfig->getValue(
+            ConfigKey(kConfigGroup, "Bitrate"), kDefaultBitrateKbps);
+
+    if (!remoteHost.isEmpty()) {
+        QHostAddress address(remoteHost);
+        if (address.isNull()) {
+            const QHostInfo hostInfo = QHostInfo::fromName(remoteHost);
+            if (hostInfo.addresses().isEmpty()) {
+                QMessageBox::warning(nullptr,
+                        tr("Action failed"),
+                        tr("Can't find the network monitoring partner %1: %2")
+                                .arg(remoteHost, hostInfo.errorString()));
+                return false;
+            }
+            address = hostInfo.addresses().first();
+        }
+        m_pOutput = NetworkMonitorOutputPtr(new NetworkMonitorOutput(
+                address, static_cast<quint16>(remotePort), bitrateKbps));
+        m_pNetworkStream->addOutputWorker(m_pOutput);
+        m_pOutput->start(QThread::HighPriority);
+        kLogger.info() << "Sending the main mix to" << address << remotePort;
+    }
+
+    if (listenPort > 0) {
+        m_pInput = std::make_unique<NetworkMonitorInput>(
+                static_cast<quint16>(listenPort), jitterBufferMillis);
+        m_pNetworkStream->setInputWorker(m_pInput.get());
+        m_pInput->start(QThread::HighPriority);
+        kLogger.info() << "Receiving on port" << listenPort;
+    }
+
+    if (!m_pOutput && !m_pInput) {
+        QMessageBox::warning(nullptr,
+                tr("Action failed"),
+                tr("Please configure a remote host or a listening port for "
+                   "network monitoring."));
+        return false;
+    }
+
+    m_statsTimer.start();
+    return true;
+}
+
+void NetworkMonitorManager::stop() {
+    m_statsTimer.stop();
+    if (m_pOutput) {
+        m_pNetworkStream->removeOutputWorker(m_pOutput);
+        m_pOutput->shutdown();
+        m_pOutput.clear();
+    }
+    if (m_pInput) {
+        m_pInput->shutdown();
+        m_pInput.reset();
+    }
+    m_pPacketLoss->forceSet(0.0);
+    m_pBufferMs->forceSet(0.0);
+}
+
+void NetworkMonitorManager::slotUpdateStats() {
+    if (!m_pInput) {
+        return;
+    }
+    m_pPacketLoss->forceSet(m_pInput->packetLossPercent());
+    m_pBufferMs->forceSet(m_pInput->bufferMillis());
+}
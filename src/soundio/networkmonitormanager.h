@@ -0,0 +1,50 @@
+#pragma once
+
+#include <QObject>
+#include <QTimer>
+#include <memory>
+
+#include "engine/sidechain/networkmonitorinput.h"
+#include "engine/sidechain/networkmonitoroutput.h"
+#include "preferences/usersettings.h"
+
+class ControlObject;
+class ControlPushButton;
+class EngineNetworkStream;
+class SoundManager;
+
+/// Streams the main mix to a remote partner with low latency and plays the
+/// partner's stream on the network sound device input, for back-to-back
+/// sessions over the Internet.
+///
+/// Both directions use Opus over UDP and are configured in the
+/// [NetworkMonitor] group of the settings:
+///   RemoteHost, RemotePort  where to send the main mix, no sending if empty
+///   ListenPort              where to receive the partner, 0 to disable
+///   JitterBufferMs          receive buffer time, 20 ms by default
+///   Bitrate                 in kbit/s, 128 by default
+class NetworkMonitorManager : public QObject {
+    Q_OBJECT
+  public:
+    NetworkMonitorManager(UserSettingsPointer pConfig, SoundManager* pSoundManager);
+    ~NetworkMonitorManager() override;
+
+  private slots:
+    void slotControlEnabled(double v);
+    void slotUpdateStats();
+
+  private:
+    bool start();
+    void stop();
+
+    UserSettingsPointer m_pConfig;
+    QSharedPointer<EngineNetworkStream> m_pNetworkStream;
+
+    NetworkMonitorOutputPtr m_pOutput;
+    std::unique_ptr<NetworkMonitorInput> m_pInput;
+
+    ControlPushButton* m_pEnabled;
+    ControlObject* m_pPacketLoss;
+    ControlObject* m_pBufferMs;
+    QTimer m_statsTimer;
+};
@@ -4,6 +4,7 @@
 #include <QString>
 
 #include "preferences/usersettings.h"
+#include "soundio/callbacktimingstats.h"
 #include "soundio/sounddevicestatus.h"
 #include "soundio/soundmanagerutil.h"
 #include "util/types.h"
@@ -37,6 +38,15 @@ class SoundDevice {
     virtual void writeProcess(SINT framesPerBuffer) = 0;
     virtual QString getError() const = 0;
     virtual unsigned int getDefaultSampleRate() const = 0;
+    // Whether the device measures the timing of its audio callbacks
+    virtual bool hasCallbackTiming() const {
+        return false;
+    }
+    // Returns the latest published callback timing. Must only be called by
+    // the SoundManager from the main thread.
+    virtual CallbackTimingStats getCallbackTiming() const {
+        return CallbackTimingStats();
+    }
     int getNumOutputChannels() const;
     int getNumInputChannels() const;
     SoundDeviceStatus addOutput(const AudioOutputBuffer& out);
@@ -0,0 +1,456 @@
+#include "soundio/sounddevicejack.h"
+
+#include <QtDebug>
+
+#include "soundio/soundmanager.h"
+#include "soundio/soundmanagerutil.h"
+#include "util/denormalsarezero.h"
+#include "util/math.h"
+#include "util/sample.h"
+#include "util/timer.h"
+#include "util/trace.h"
+#include "waveform/visualplayposition.h"
+
+namespace {
+
+const QString kAppGroup = QStringLiteral("[App]");
+
+constexpr int kCpuUsageUpdateRate = 30; // in 1/s, fits to display frame rate
+
+// xrun reported by the JACK server
+constexpr int kJackXrunCode = 26;
+
+int jackProcess(jack_nframes_t nframes, void* arg) {
+    return static_cast<SoundDeviceJack*>(arg)->callbackProcess(nframes);
+}
+
+int jackXrun(void* arg) {
+    static_cast<SoundDeviceJack*>(arg)->callbackXrun();
+    return 0;
+}
+
+void jackShutdown(void* arg) {
+    static_cast<SoundDeviceJack*>(arg)->callbackShutdown();
+}
+
+void jackPortRegistration(jack_port_id_t port, int registered, void* arg) {
+    Q_UNUSED(port);
+    if (registered) {
+        static_cast<SoundDeviceJack*>(arg)->callbackPortRegistration();
+    }
+}
+
+// The client name of a port, e.g. "system" of "system:playback_1"
+QString clientOfPort(const QString& portName) {
+    return portName.section(QChar(':'), 0, 0);
+}
+
+} // anonymous namespace
+
+// static
+jack_client_t* SoundDeviceJack::openClient(const QString& clientName) {
+    jack_status_t status;
+    jack_client_t* pClient = jack_client_open(
+            clientName.toLocal8Bit().constData(), JackNoStartServer, &status);
+    if (!pClient) {
+        qDebug() << "No JACK server running, status" << status;
+    }
+    return pClient;
+}
+
+SoundDeviceJack::SoundDeviceJack(UserSettingsPointer config,
+        SoundManager* sm,
+        jack_client_t* pClient)
+        : SoundDevice(config, sm),
+          m_pClient(pClient),
+          m_serverSampleRate(jack_get_sample_rate(pClient)),
+          m_open(false),
+          m_serverShutdown(false),
+          m_playbackLatencyFrames(0),
+          m_bSetDenormalsMode(false),
+          m_audioLatencyUsage(kAppGroup, QStringLiteral("audio_latency_usage")),
+          m_framesSinceAudioLatencyUsageUpdate(0) {
+    const QStringList playbackPorts = physicalPorts(JackPortIsInput);
+    const QStringList capturePorts = physicalPorts(JackPortIsOutput);
+    m_iNumOutputChannels = playbackPorts.size();
+    m_iNumInputChannels = capturePorts.size();
+    m_dSampleRate = m_serverSampleRate;
+    m_hostAPI = MIXXX_JACK_NATIVE_STRING;
+
+    QString serverClient = QStringLiteral("system");
+    if (!playbackPorts.isEmpty()) {
+        serverClient = clientOfPort(playbackPorts.first());
+    } else if (!capturePorts.isEmpty()) {
+        serverClient = clientOfPort(capturePorts.first());
+    }
+    m_deviceId.name = serverClient;
+    m_strDisplayName = QStringLiteral("JACK: ") + serverClient;
+
+    // The callbacks must be set before the client is activated and are only
+    // called while it is active
+    jack_set_process_callback(m_pClient, jackProcess, this);
+    jack_set_xrun_callback(m_pClient, jackXrun, this);
+    jack_on_shutdown(m_pClient, jackShutdown, this);
+    jack_set_port_registration_callback(m_pClient, jackPortRegistration, this);
+}
+
+SoundDeviceJack::~SoundDeviceJack() {
+    close();
+    if (!m_serverShutdown.load()) {
+        jack_client_close(m_pClient);
+    }
+}
+
+QStringList SoundDeviceJack::physicalPorts(unsigned long flags) const {
+    QStringList portNames;
+    const char** ppPorts = jack_get_ports(m_pClient,
+            nullptr,
+            JACK_DEFAULT_AUDIO_TYPE,
+            JackPortIsPhysical | flags);
+    if (ppPorts) {
+        for (const char** ppPort = ppPorts; *ppPort; ++ppPort) {
+            portNames.append(QString::fromLocal8Bit(*ppPort));
+        }
+        jack_free(ppPorts);
+    }
+    return portNames;
+}
+
+SoundDeviceStatus SoundDeviceJack::open(bool isClkRefDevice, int syncBuffers) {
+    Q_UNUSED(syncBuffers);
+    qDebug() << "SoundDeviceJack::open()" << m_deviceId;
+
+    if (m_serverShutdown.load()) {
+        m_lastError = QStringLiteral("The JACK server has been shut down");
+        return SoundDeviceStatus::Error;
+    }
+    if (!isClkRefDevice) {
+        // There is no FIFO to bridge to another clock
+        m_lastError = QStringLiteral(
+                "The JACK device must be the clock reference device");
+        return SoundDeviceStatus::Error;
+    }
+    if (m_dSampleRate != m_serverSampleRate) {
+        m_lastError = QStringLiteral("The JACK server runs at %1 Hz")
+                              .arg(m_serverSampleRate);
+        return SoundDeviceStatus::Error;
+    }
+
+    int outputChannels = 0;
+    for (const auto& out : std::as_const(m_audioOutputs)) {
+        const ChannelGroup channelGroup = out.getChannelGroup();
+        outputChannels = math_max(outputChannels,
+                channelGroup.getChannelBase() + channelGroup.getChannelCount());
+    }
+    int inputChannels = 0;
+    for (const auto& in : std::as_const(m_audioInputs)) {
+        const ChannelGroup channelGroup = in.getChannelGroup();
+        inputChannels = math_max(inputChannels,
+                channelGroup.getChannelBase() + channelGroup.getChannelCount());
+    }
+
+    m_outputPortUsed.fill(false, outputChannels);
+    for (const auto& out : std::as_const(m_audioOutputs)) {
+        const ChannelGroup channelGroup = out.getChannelGroup();
+        for (int channel = 0; channel < channelGroup.getChannelCount(); ++channel) {
+            m_outputPortUsed[channelGroup.getChannelBase() + channel] = true;
+        }
+    }
+
+    for (int channel = 0; channel < outputChannels; ++channel) {
+        jack_port_t* pPort = jack_port_register(m_pClient,
+                QStringLiteral("out_%1").arg(channel + 1).toLatin1().constData(),
+                JACK_DEFAULT_AUDIO_TYPE,
+                JackPortIsOutput,
+                0);
+        if (!pPort) {
+            m_lastError = QStringLiteral("Unable to register the JACK port out_%1")
+                                  .arg(channel + 1);
+            close();
+            return SoundDeviceStatus::Error;
+        }
+        m_outputPorts.append(pPort);
+    }
+    for (int channel = 0; channel < inputChannels; ++channel) {
+        jack_port_t* pPort = jack_port_register(m_pClient,
+                QStringLiteral("in_%1").arg(channel + 1).toLatin1().constData(),
+                JACK_DEFAULT_AUDIO_TYPE,
+                JackPortIsInput,
+                0);
+        if (!pPort) {
+            m_lastError = QStringLiteral("Unable to register the JACK port in_%1")
+                                  .arg(channel + 1);
+            close();
+            return SoundDeviceStatus::Error;
+        }
+        m_inputPorts.append(pPort);
+    }
+
+    m_clkRefTimer.start();
+    m_open = true;
+    if (jack_activate(m_pClient) != 0) {
+        m_lastError = QStringLiteral("Unable to activate the JACK client");
+        close();
+        return SoundDeviceStatus::Error;
+    }
+    // Ports can only be connected when the client is active
+    reconnectPorts();
+    qDebug() << "JACK buffer size" << jack_get_buffer_size(m_pClient)
+             << "frames, playback latency" << m_playbackLatencyFrames.load()
+             << "frames";
+    return SoundDeviceStatus::Ok;
+}
+
+bool SoundDeviceJack::isOpen() const {
+    return m_open && !m_serverShutdown.load();
+}
+
+SoundDeviceStatus SoundDeviceJack::close() {
+    if (m_serverShutdown.load()) {
+        // The client is gone together with the server
+        m_open = false;
+        m_outputPorts.clear();
+        m_inputPorts.clear();
+        return SoundDeviceStatus::Ok;
+    }
+    if (m_open) {
+        // Blocks until the process callback has returned
+        jack_deactivate(m_pClient);
+        m_open = false;
+    }
+    for (jack_port_t* pPort : std::as_const(m_outputPorts)) {
+        jack_port_unregister(m_pClient, pPort);
+    }
+    m_outputPorts.clear();
+    for (jack_port_t* pPort : std::as_const(m_inputPorts)) {
+        jack_port_unregister(m_pClient, pPort);
+    }
+    m_inputPorts.clear();
+    return SoundDeviceStatus::Ok;
+}
+
+void SoundDeviceJack::reconnectPorts() {
+    if (!isOpen()) {
+        return;
+    }
+    const QStringList playbackPorts = physicalPorts(JackPortIsInput);
+    for (int channel = 0;
+            channel < m_outputPorts.size() && channel < playbackPorts.size();
+            ++channel) {
+        jack_port_t* pPort = m_outputPorts[channel];
+        if (jack_port_connected(pPort) == 0) {
+            jack_connect(m_pClient,
+                    jack_port_name(pPort),
+                    playbackPorts[channel].toLocal8Bit().constData());
+        }
+    }
+    const QStringList capturePorts = physicalPorts(JackPortIsOutput);
+    for (int channel = 0;
+            channel < m_inputPorts.size() && channel < capturePorts.size();
+            ++channel) {
+        jack_port_t* pPort = m_inputPorts[channel];
+        if (jack_port_connected(pPort) == 0) {
+            jack_connect(m_pClient,
+                    capturePorts[channel].toLocal8Bit().constData(),
+                    jack_port_name(pPort));
+        }
+    }
+
+    if (!m_outputPorts.isEmpty()) {
+        jack_latency_range_t range;
+        jack_port_get_latency_range(m_outputPorts.first(), JackPlaybackLatency, &range);
+        m_playbackLatencyFrames.store(range.max);
+    }
+}
+
+void SoundDeviceJack::readProcess(SINT framesPerBuffer) {
+    // Inputs are read in the process callback
+    Q_UNUSED(framesPerBuffer);
+}
+
+void SoundDeviceJack::writeProcess(SINT framesPerBuffer) {
+    // Outputs are written in the process callback
+    Q_UNUSED(framesPerBuffer);
+}
+
+QString SoundDeviceJack::getError() const {
+    return m_lastError;
+}
+
+void SoundDeviceJack::callbackXrun() {
+    m_pSoundManager->underflowHappened(kJackXrunCode);
+}
+
+void SoundDeviceJack::callbackShutdown() {
+    m_serverShutdown.store(true);
+    QMetaObject::invokeMethod(
+            &m_mainThreadContext,
+            [this] {
+                qWarning() << "The JACK server has been shut down" << m_deviceId;
+            },
+            Qt::QueuedConnection);
+}
+
+void SoundDeviceJack::callbackPortRegistration() {
+    // Called when a port appears, e.g. when a USB interface is plugged in
+    // again or PipeWire switches the profile of a card. JACK does not allow
+    // to connect ports from its notification thread.
+    QMetaObject::invokeMethod(
+            &m_mainThreadContext,
+            [this] {
+                reconnectPorts();
+            },
+            Qt::QueuedConnection);
+}
+
+int SoundDeviceJack::callbackProcess(jack_nframes_t nframes) {
+    const SINT framesPerBuffer = static_cast<SINT>(nframes);
+    updateCallbackEntryToDacTime();
+
+    Trace trace("SoundDeviceJack::callbackProcess %1", m_deviceId.debugName());
+
+    if (!m_bSetDenormalsMode) {
+#ifdef __SSE__
+        // JACK threads are already real-time, but the denormals mode has to
+        // be set like for the PortAudio callback thread
+        _MM_SET_DENORMALS_ZERO_MODE(_MM_DENORMALS_ZERO_ON);
+        _MM_SET_FLUSH_ZERO_MODE(_MM_FLUSH_ZERO_ON);
+#endif
+        m_bSetDenormalsMode = true;
+    }
+
+    if (framesPerBuffer * 2 > MAX_BUFFER_LEN) {
+        // The engine buffers are too small for this JACK period
+        for (jack_port_t* pPort : std::as_const(m_outputPorts)) {
+            SampleUtil::clear(static_cast<CSAMPLE*>(
+                                      jack_port_get_buffer(pPort, nframes)),
+                    framesPerBuffer);
+        }
+        m_pSoundManager->underflowHappened(kJackXrunCode);
+        return 0;
+    }
+
+    m_pSoundManager->processUnderflowHappened(framesPerBuffer);
+
+    // Input is processed first so that any ControlObject changes made in
+    // response to input are processed as soon as possible
+    if (!m_inputPorts.isEmpty()) {
+        ScopedTimer t("SoundDeviceJack::callbackProcess input %1",
+                m_deviceId.debugName());
+        composeInputPorts(framesPerBuffer);
+        m_pSoundManager->pushInputBuffers(m_audioInputs, framesPerBuffer);
+    }
+
+    m_pSoundManager->readProcess(framesPerBuffer);
+
+    {
+        ScopedTimer t("SoundDeviceJack::callbackProcess prepare %1",
+                m_deviceId.debugName());
+        m_pSoundManager->onDeviceOutputCallback(framesPerBuffer);
+    }
+
+    if (!m_outputPorts.isEmpty()) {
+        ScopedTimer t("SoundDeviceJack::callbackProcess output %1",
+                m_deviceId.debugName());
+        composeOutputPorts(framesPerBuffer);
+    }
+
+    m_pSoundManager->writeProcess(framesPerBuffer);
+
+    updateAudioLatencyUsage(framesPerBuffer);
+    return 0;
+}
+
+void SoundDeviceJack::composeOutputPorts(SINT framesPerBuffer) {
+    const auto nframes = static_cast<jack_nframes_t>(framesPerBuffer);
+    for (int channel = 0; channel < m_outputPorts.size(); ++channel) {
+        if (!m_outputPortUsed[channel]) {
+            SampleUtil::clear(static_cast<CSAMPLE*>(jack_port_get_buffer(
+                                      m_outputPorts[channel], nframes)),
+                    framesPerBuffer);
+        }
+    }
+
+    // Deinterleave the stereo engine buffers into the port buffers
+    for (const auto& out : std::as_const(m_audioOutputs)) {
+        const ChannelGroup outChans = out.getChannelGroup();
+        const int iChannelBase = outChans.getChannelBase();
+        const CSAMPLE* pAudioOutputBuffer = out.getBuffer(); // Always stereo
+        if (outChans.getChannelCount() == 1) {
+            // All AudioOutputs are stereo, downmix for a mono output
+            auto* pPort = static_cast<CSAMPLE*>(
+                    jack_port_get_buffer(m_outputPorts[iChannelBase], nframes));
+            for (SINT iFrameNo = 0; iFrameNo < framesPerBuffer; ++iFrameNo) {
+                pPort[iFrameNo] = SampleUtil::clampSample(
+                        (pAudioOutputBuffer[iFrameNo * 2] +
+                                pAudioOutputBuffer[iFrameNo * 2 + 1]) /
+                        2.0f);
+            }
+        } else {
+            for (int iChannel = 0; iChannel < outChans.getChannelCount(); ++iChannel) {
+                auto* pPort = static_cast<CSAMPLE*>(jack_port_get_buffer(
+                        m_outputPorts[iChannelBase + iChannel], nframes));
+                for (SINT iFrameNo = 0; iFrameNo < framesPerBuffer; ++iFrameNo) {
+                    pPort[iFrameNo] = SampleUtil::clampSample(
+                            pAudioOutputBuffer[iFrameNo * 2 + iChannel]);
+                }
+            }
+        }
+    }
+}
+
+void SoundDeviceJack::composeInputPorts(SINT framesPerBuffer) {
+    const auto nframes = static_cast<jack_nframes_t>(framesPerBuffer);
+    // Interleave the port buffers into the stereo input buffers
+    for (const auto& in : std::as_const(m_audioInputs)) {
+        const ChannelGroup chanGroup = in.getChannelGroup();
+        const int iChannelBase = chanGroup.getChannelBase();
+        CSAMPLE* pInputBuffer = in.getBuffer(); // Always stereo
+        const auto* pLeft = static_cast<const CSAMPLE*>(
+                jack_port_get_buffer(m_inputPorts[iChannelBase], nframes));
+        const auto* pRight = chanGroup.getChannelCount() > 1
+                ? static_cast<const CSAMPLE*>(jack_port_get_buffer(
+                          m_inputPorts[iChannelBase + 1], nframes))
+                : pLeft;
+        for (SINT iFrameNo = 0; iFrameNo < framesPerBuffer; ++iFrameNo) {
+            pInputBuffer[iFrameNo * 2] = pLeft[iFrameNo];
+            pInputBuffer[iFrameNo * 2 + 1] = pRight[iFrameNo];
+        }
+    }
+}
+
+void SoundDeviceJack::updateCallbackEntryToDacTime() {
+    m_clkRefTimer.restart();
+    // The buffer of this cycle is played at the start of the next cycle plus
+    // the playback latency of the physical ports. JACK knows both exactly.
+    jack_nframes_t currentFrames;
+    jack_time_t currentUsecs;
+    jack_time_t nextUsecs;
+    float periodUsecs;
+    if (jack_get_cycle_times(m_pClient,
+                &currentFrames,
+                &currentUsecs,
+                &nextUsecs,
+                &periodUsecs) != 0) {
+        return;
+    }
+    const jack_time_t now = jack_get_time();
+    const double untilNextCycleSecs =
+            nextUsecs > now ? (nextUsecs - now) / 1000000.0 : 0.0;
+    const double callbackEntrytoDacSecs = untilNextCycleSecs +
+            m_playbackLatencyFrames.load(std::memory_order_relaxed) / m_dSampleRate;
+    VisualPlayPosition::setCallbackEntryToDacSecs(callbackEntrytoDacSecs, m_clkRefTimer);
+}
+
+void SoundDeviceJack::updateAudioLatencyUsage(SINT framesPerBuffer) {
+    m_framesSinceAudioLatencyUsageUpdate += framesPerBuffer;
+    if (m_framesSinceAudioLatencyUsageUpdate > (m_dSampleRate / kCpuUsageUpdateRate)) {
+        double secInAudioCb = m_timeInAudioCallback.toDoubleSeconds();
+        m_audioLatencyUsage.set(
+                secInAudioCb / (m_framesSinceAudioLatencyUsageUpdate / m_dSampleRate));
+        m_timeInAudioCallback = mixxx::Duration::fromSeconds(0);
+        m_framesSinceAudioLatencyUsageUpdate = 0;
+    }
+    // measure time in Audio callback at the very last
+    m_timeInAudioCallback += m_clkRefTimer.elapsed();
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <jack/jack.h>
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <atomic>
+
+#include "control/pollingcontrolproxy.h"
+#include "soundio/sounddevice.h"
+#include "util/duration.h"
+#include "util/performancetimer.h"
+
+class SoundManager;
+
+/// A sound device that is a client of a JACK server, including the JACK
+/// implementation of PipeWire, without PortAudio in between. The physical
+/// ports of the server are the channels of the device.
+///
+/// The engine buffers are deinterleaved straight into the port buffers in
+/// the JACK process callback, there is no FIFO and no additional period of
+/// latency. JACK drives all ports with one clock, so this device is always
+/// the clock reference.
+class SoundDeviceJack : public SoundDevice {
+  public:
+    /// Connects to a running JACK server without starting one. Returns
+    /// nullptr if no server is running.
+    static jack_client_t* openClient(const QString& clientName);
+
+    /// Takes the ownership of the client
+    SoundDeviceJack(UserSettingsPointer config,
+            SoundManager* sm,
+            jack_client_t* pClient);
+    ~SoundDeviceJack() override;
+
+    SoundDeviceStatus open(bool isClkRefDevice, int syncBuffers) override;
+    bool isOpen() const override;
+    SoundDeviceStatus close() override;
+    void readProcess(SINT framesPerBuffer) override;
+    void writeProcess(SINT framesPerBuffer) override;
+    QString getError() const override;
+    unsigned int getDefaultSampleRate() const override {
+        return m_serverSampleRate;
+    }
+
+    int callbackProcess(jack_nframes_t framesPerBuffer);
+    void callbackXrun();
+    void callbackShutdown();
+    void callbackPortRegistration();
+
+  private:
+    void updateCallbackEntryToDacTime();
+    void updateAudioLatencyUsage(SINT framesPerBuffer);
+    void composeOutputPorts(SINT framesPerBuffer);
+    void composeInputPorts(SINT framesPerBuffer);
+    // Connects the ports that are not connected to the physical port of the
+    // same channel. Connections made by the user in a patchbay are kept.
+    void reconnectPorts();
+    QStringList physicalPorts(unsigned long flags) const;
+
+    jack_client_t* m_pClient;
+    unsigned int m_serverSampleRate;
+    QVector<jack_port_t*> m_outputPorts;
+    QVector<jack_port_t*> m_inputPorts;
+    // Outputs not written by any AudioOutput are cleared
+    QVector<bool> m_outputPortUsed;
+    bool m_open;
+    std::atomic<bool> m_serverShutdown;
+    // The playback latency of the physical ports
+    std::atomic<jack_nframes_t> m_playbackLatencyFrames;
+    QString m_lastError;
+
+    // Notifications from JACK threads are handled in the main thread with
+    // queued calls to this object. They are discarded when the device is
+    // destroyed.
+    QObject m_mainThreadContext;
+
+    bool m_bSetDenormalsMode;
+    PollingControlProxy m_audioLatencyUsage;
+    mixxx::Duration m_timeInAudioCallback;
+    int m_framesSinceAudioLatencyUsageUpdate;
+    PerformanceTimer m_clkRefTimer;
+};
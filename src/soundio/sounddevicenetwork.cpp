@@ -194,7 +194,11 @@ void SoundDeviceNetwork::readProcess(SINT framesPerBuffer) {
     int readCount = inChunkSize;
     if (inChunkSize > readAvailable) {
         readCount = readAvailable;
-        m_pSoundManager->underflowHappened(21);
+        // Without a remote sender, the network input is usually empty. This
+        // is only an underflow if the input is routed to a channel.
+        if (!m_audioInputs.isEmpty()) {
+            m_pSoundManager->underflowHappened(21);
+        }
         //qDebug() << "readProcess()" << (float)readAvailable / inChunkSize << "underflow";
     }
     if (readCount) {
@@ -11,6 +11,7 @@
 #include "control/pollingcontrolproxy.h"
 #include "engine/sidechain/networkoutputstreamworker.h"
 #include "soundio/sounddevice.h"
+#include "util/cpuaffinity.h"
 #include "util/fifo.h"
 #include "util/memory.h"
 #include "util/performancetimer.h"
@@ -97,6 +98,7 @@ class SoundDeviceNetworkThread : public QThread {
             qWarning() << "SoundDeviceNetworkThread: Failed bumping priority";
         }
 #endif
+        mixxx::CpuAffinity::applyToCurrentThread(mixxx::CpuAffinity::ThreadRole::Engine);
 
         while(!m_stop) {
             m_pParent->callbackProcessClkRef();
@@ -10,11 +10,13 @@
 #include "soundio/sounddevice.h"
 #include "soundio/soundmanager.h"
 #include "soundio/soundmanagerutil.h"
+#include "util/cpuaffinity.h"
 #include "util/defs.h"
 #include "util/denormalsarezero.h"
 #include "util/fifo.h"
 #include "util/math.h"
 #include "util/sample.h"
+#include "util/time.h"
 #include "util/timer.h"
 #include "util/trace.h"
 #include "waveform/visualplayposition.h"
@@ -34,7 +36,12 @@ constexpr int kDriftReserve = 1;
 // Buffer for drift correction 1 full, 1 for r/w, 1 empty
 constexpr int kFifoSize = 2 * kDriftReserve + 1;
 
+// Room on both sides of the target fill level for the few frames the
+// drift resampler consumes or produces more or less than a chunk
+constexpr int kDriftMarginFrames = DriftResampler::kTaps;
+
 constexpr int kCpuUsageUpdateRate = 30; // in 1/s, fits to display frame rate
+constexpr int kCallbackTimingUpdateRate = 4; // in 1/s
 
 // We warn only at invalid timing 3, since the first two
 // callbacks can be always wrong due to a setup/open jitter
@@ -45,9 +52,13 @@ int paV19Callback(const void *inputBuffer, void *outputBuffer,
                   const PaStreamCallbackTimeInfo *timeInfo,
                   PaStreamCallbackFlags statusFlags,
                   void *soundDevice) {
-    return ((SoundDevicePortAudio*) soundDevice)->callbackProcess(
+    const mixxx::Duration entry = mixxx::Time::elapsed();
+    SoundDevicePortAudio* pDevice = static_cast<SoundDevicePortAudio*>(soundDevice);
+    const int result = pDevice->callbackProcess(
             (SINT) framesPerBuffer, (CSAMPLE*) outputBuffer,
             (const CSAMPLE*) inputBuffer, timeInfo, statusFlags);
+    pDevice->recordCallbackTiming((SINT) framesPerBuffer, timeInfo, entry);
+    return result;
 }
 
 int paV19CallbackDrift(const void *inputBuffer, void *outputBuffer,
@@ -55,9 +66,13 @@ int paV19CallbackDrift(const void *inputBuffer, void *outputBuffer,
                        const PaStreamCallbackTimeInfo *timeInfo,
                        PaStreamCallbackFlags statusFlags,
                        void *soundDevice) {
-    return ((SoundDevicePortAudio*) soundDevice)->callbackProcessDrift(
+    const mixxx::Duration entry = mixxx::Time::elapsed();
+    SoundDevicePortAudio* pDevice = static_cast<SoundDevicePortAudio*>(soundDevice);
+    const int result = pDevice->callbackProcessDrift(
             (SINT) framesPerBuffer, (CSAMPLE*) outputBuffer,
             (const CSAMPLE*) inputBuffer, timeInfo, statusFlags);
+    pDevice->recordCallbackTiming((SINT) framesPerBuffer, timeInfo, entry);
+    return result;
 }
 
 int paV19CallbackClkRef(const void *inputBuffer, void *outputBuffer,
@@ -65,9 +80,13 @@ int paV19CallbackClkRef(const void *inputBuffer, void *outputBuffer,
                         const PaStreamCallbackTimeInfo *timeInfo,
                         PaStreamCallbackFlags statusFlags,
                         void *soundDevice) {
-    return ((SoundDevicePortAudio*) soundDevice)->callbackProcessClkRef(
+    const mixxx::Duration entry = mixxx::Time::elapsed();
+    SoundDevicePortAudio* pDevice = static_cast<SoundDevicePortAudio*>(soundDevice);
+    const int result = pDevice->callbackProcessClkRef(
             (SINT) framesPerBuffer, (CSAMPLE*) outputBuffer,
             (const CSAMPLE*) inputBuffer, timeInfo, statusFlags);
+    pDevice->recordCallbackTiming((SINT) framesPerBuffer, timeInfo, entry);
+    return result;
 }
 
 const QRegularExpression kAlsaHwDeviceRegex("(.*) \\((plug)?(hw:(\\d)+(,(\\d)+))?\\)");
@@ -93,7 +112,8 @@ SoundDevicePortAudio::SoundDevicePortAudio(UserSettingsPointer config,
           m_framesSinceAudioLatencyUsageUpdate(0),
           m_syncBuffers(2),
           m_invalidTimeInfoCount(0),
-          m_lastCallbackEntrytoDacSecs(0) {
+          m_lastCallbackEntrytoDacSecs(0),
+          m_framesSinceCallbackTimingUpdate(0) {
     // Setting parent class members:
     m_hostAPI = Pa_GetHostApiInfo(deviceInfo->hostApi)->name;
     m_dSampleRate = deviceInfo->defaultSampleRate;
@@ -277,12 +297,13 @@ SoundDeviceStatus SoundDevicePortAudio::open(bool isClkRefDevice, int syncBuffer
         if (m_outputParams.channelCount > 0) {
             // On chunk for reading one for writing and on for drift correction
             m_outputFifo = std::make_unique<FIFO<CSAMPLE>>(
-                    m_outputParams.channelCount * framesPerBuffer * kFifoSize);
+                    m_outputParams.channelCount *
+                    (framesPerBuffer * kFifoSize + 2 * kDriftMarginFrames));
             // Clear first 1.5 chunks on for the required artificial delaly to
             // a allow jitter and a half, because we can't predict which
             // callback fires first.
-            int writeCount = m_outputParams.channelCount * framesPerBuffer *
-                    kFifoSize / 2;
+            int writeCount = m_outputParams.channelCount *
+                    (framesPerBuffer * kFifoSize / 2 + kDriftMarginFrames);
             CSAMPLE* dataPtr1;
             ring_buffer_size_t size1;
             CSAMPLE* dataPtr2;
@@ -292,13 +313,20 @@ SoundDeviceStatus SoundDevicePortAudio::open(bool isClkRefDevice, int syncBuffer
             SampleUtil::clear(dataPtr1, size1);
             SampleUtil::clear(dataPtr2, size2);
             m_outputFifo->releaseWriteRegions(writeCount);
+            // The callback finds the FIFO filled with the reserve and the
+            // chunk written before, like it was with the old chunk wise
+            // drift correction
+            m_outputResampler.init(m_outputParams.channelCount, framesPerBuffer * 2);
+            m_outputDriftController.reset(m_dSampleRate,
+                    framesPerBuffer * (kDriftReserve + 1) + kDriftMarginFrames);
         }
         if (m_inputParams.channelCount > 0) {
             m_inputFifo = std::make_unique<FIFO<CSAMPLE>>(
-                    m_inputParams.channelCount * framesPerBuffer * kFifoSize);
+                    m_inputParams.channelCount *
+                    (framesPerBuffer * kFifoSize + 2 * kDriftMarginFrames));
             // Clear first 1.5 chunks (see above)
-            int writeCount = m_inputParams.channelCount * framesPerBuffer *
-                    kFifoSize / 2;
+            int writeCount = m_inputParams.channelCount *
+                    (framesPerBuffer * kFifoSize / 2 + kDriftMarginFrames);
             CSAMPLE* dataPtr1;
             ring_buffer_size_t size1;
             CSAMPLE* dataPtr2;
@@ -308,6 +336,9 @@ SoundDeviceStatus SoundDevicePortAudio::open(bool isClkRefDevice, int syncBuffer
             SampleUtil::clear(dataPtr1, size1);
             SampleUtil::clear(dataPtr2, size2);
             m_inputFifo->releaseWriteRegions(writeCount);
+            m_inputResampler.init(m_inputParams.channelCount, framesPerBuffer * 2);
+            m_inputDriftController.reset(m_dSampleRate,
+                    framesPerBuffer * kDriftReserve + kDriftMarginFrames);
         }
     } else if (m_syncBuffers == 1) { // "Disabled (short delay)"
         // this can be used on a second device when it is driven by the Clock
@@ -332,6 +363,11 @@ SoundDeviceStatus SoundDevicePortAudio::open(bool isClkRefDevice, int syncBuffer
         }
     }
 
+    // The buffer time is set with the first callback, see recordCallbackTiming()
+    m_callbackTiming.reset(0);
+    m_publishedCallbackTiming.setValue(m_callbackTiming);
+    m_framesSinceCallbackTimingUpdate = 0;
+
     PaStream *pStream;
     // Try open device using iChannelMax
     err = Pa_OpenStream(&pStream,
@@ -709,115 +745,68 @@ int SoundDevicePortAudio::callbackProcessDrift(
     // Unfortunately this delay is somehow random, an WILL produce a delay slow
     // shift without we can avoid it. (That's the price for using a cheap USB soundcard).
     //
-    // Additional we need an filled chunk and an empty chunk. These are used when on
-    // sound card overtakes the other. This always happens, if they are driven form
-    // two crystals. In a test case every 30 s @ 23 ms. After they are consumed,
-    // the drift correction takes place and fills or clears the reserve buffers.
-    // If this is finished before another overtake happens, we do not face any
-    // dropouts or clicks.
+    // Additional we need an filled chunk and an empty chunk. These are used when
+    // one callback is delayed, in this case the second one fires two times and
+    // then the first one fires two time as well to catch up.
     // So that's why we need a Fifo of 3 chunks.
     //
-    // In addition there is a jitter effect. It happens that one callback is delayed,
-    // in this case the second one fires two times and then the first one fires two
-    // time as well to catch up. This is also fixed by the additional buffers. If this
-    // happens just after an regular overtake, we will have clicks again.
-    //
-    // I the tests it turns out that it only happens in the opposite direction, so
-    // 3 chunks are just fine.
+    // The clock drift itself is compensated continuously: The fill level of the
+    // FIFO, seen at this callback, is kept at its target by resampling the
+    // audio with a ratio slightly off 1. Skipping or duplicating frames
+    // instead causes periodic clicks in long sessions.
 
     if (m_inputParams.channelCount) {
-        int inChunkSize = framesPerBuffer * m_inputParams.channelCount;
-        int readAvailable = m_inputFifo->readAvailable();
-        int writeAvailable = m_inputFifo->writeAvailable();
-        if (readAvailable < inChunkSize * kDriftReserve) {
-            // risk of an underflow, duplicate one frame
-            m_inputFifo->write(in, inChunkSize);
-            if (m_inputDrift) {
-                // Do not compensate the first delay, because it is likely a jitter
-                // corrected in the next cycle
-                // Duplicate one frame
-                m_inputFifo->write(
-                        &in[inChunkSize - m_inputParams.channelCount],
-                        m_inputParams.channelCount);
-                //qDebug() << "callbackProcessDrift write:" << (float)readAvailable / inChunkSize << "Skip";
-            } else {
-                m_inputDrift = true;
-                //qDebug() << "callbackProcessDrift write:" << (float)readAvailable / inChunkSize << "Jitter Skip";
-            }
-        } else if (readAvailable == inChunkSize * kDriftReserve) {
-            // Everything Ok
-            m_inputFifo->write(in, inChunkSize);
-            m_inputDrift = false;
-            //qDebug() << "callbackProcess write:" << (float) readAvailable / inChunkSize << "Normal";
-        } else if (writeAvailable >= inChunkSize) {
-            // Risk of overflow, skip one frame
-            if (m_inputDrift) {
-                m_inputFifo->write(in, inChunkSize - m_inputParams.channelCount);
-                //qDebug() << "callbackProcessDrift write:" << (float)readAvailable / inChunkSize << "Skip";
-            } else {
-                m_inputFifo->write(in, inChunkSize);
-                m_inputDrift = true;
-                //qDebug() << "callbackProcessDrift write:" << (float)readAvailable / inChunkSize << "Jitter Skip";
-            }
-        } else if (writeAvailable) {
-            // Fifo Overflow
-            m_inputFifo->write(in, writeAvailable);
-            m_pSoundManager->underflowHappened(8);
-            //qDebug() << "callbackProcessDrift write:" << (float) readAvailable / inChunkSize << "Overflow";
-        } else {
-            // Buffer full
+        const int channels = m_inputParams.channelCount;
+        const int fillFrames = m_inputFifo->readAvailable() / channels;
+        m_inputResampler.setRatio(
+                m_inputDriftController.update(fillFrames, framesPerBuffer));
+        m_inputResampler.appendInput(in, framesPerBuffer);
+        CSAMPLE* dataPtr1;
+        ring_buffer_size_t size1;
+        CSAMPLE* dataPtr2;
+        ring_buffer_size_t size2;
+        (void)m_inputFifo->aquireWriteRegions(m_inputFifo->writeAvailable(),
+                &dataPtr1, &size1, &dataPtr2, &size2);
+        int written = m_inputResampler.resample(dataPtr1, size1 / channels);
+        if (written == size1 / channels && size2 > 0) {
+            written += m_inputResampler.resample(dataPtr2, size2 / channels);
+        }
+        m_inputFifo->releaseWriteRegions(written * channels);
+        if (m_inputResampler.inputFramesNeeded(1) == 0) {
+            // Buffer full, drop the remaining input
+            m_inputResampler.reset();
             m_pSoundManager->underflowHappened(9);
-            //qDebug() << "callbackProcessDrift write:" << (float) readAvailable / inChunkSize << "Buffer full";
+            //qDebug() << "callbackProcessDrift write:" << fillFrames << "Buffer full";
         }
     }
 
     if (m_outputParams.channelCount > 0) {
-        int outChunkSize = framesPerBuffer * m_outputParams.channelCount;
-        int readAvailable = m_outputFifo->readAvailable();
-
-        if (readAvailable > outChunkSize * (kDriftReserve + 1)) {
-            m_outputFifo->read(out, outChunkSize);
-            if (m_outputDrift) {
-                // Risk of overflow, skip one frame
-                m_outputFifo->releaseReadRegions(m_outputParams.channelCount);
-                //qDebug() << "callbackProcessDrift read:" << (float)readAvailable / outChunkSize << "Skip";
-            } else {
-                m_outputDrift = true;
-                //qDebug() << "callbackProcessDrift read:" << (float)readAvailable / outChunkSize << "Jitter Skip";
-            }
-        } else if (readAvailable == outChunkSize * (kDriftReserve + 1)) {
-            m_outputFifo->read(out, outChunkSize);
-            m_outputDrift = false;
-            //qDebug() << "callbackProcessDrift read:" << (float)readAvailable / outChunkSize << "Normal";
-        } else if (readAvailable >= outChunkSize) {
-            if (m_outputDrift) {
-                // Risk of underflow, duplicate one frame
-                m_outputFifo->read(out,
-                        outChunkSize - m_outputParams.channelCount);
-                SampleUtil::copy(
-                        &out[outChunkSize - m_outputParams.channelCount],
-                        &out[outChunkSize - (2 * m_outputParams.channelCount)],
-                        m_outputParams.channelCount);
-                //qDebug() << "callbackProcessDrift read:" << (float)readAvailable / outChunkSize << "Save";
-            } else {
-                m_outputFifo->read(out, outChunkSize);
-                m_outputDrift = true;
-                //qDebug() << "callbackProcessDrift read:" << (float)readAvailable / outChunkSize << "Jitter Save";
+        const int channels = m_outputParams.channelCount;
+        const int fillFrames = m_outputFifo->readAvailable() / channels;
+        m_outputResampler.setRatio(
+                m_outputDriftController.update(fillFrames, framesPerBuffer));
+        const int neededFrames = m_outputResampler.inputFramesNeeded(framesPerBuffer);
+        const int readFrames = qMin(neededFrames, fillFrames);
+        if (readFrames > 0) {
+            CSAMPLE* dataPtr1;
+            ring_buffer_size_t size1;
+            CSAMPLE* dataPtr2;
+            ring_buffer_size_t size2;
+            (void)m_outputFifo->aquireReadRegions(readFrames * channels,
+                    &dataPtr1, &size1, &dataPtr2, &size2);
+            m_outputResampler.appendInput(dataPtr1, size1 / channels);
+            if (size2 > 0) {
+                m_outputResampler.appendInput(dataPtr2, size2 / channels);
             }
-        } else if (readAvailable) {
-            m_outputFifo->read(out,
-                    readAvailable);
-            // underflow
-            SampleUtil::clear(&out[readAvailable],
-                    outChunkSize - readAvailable);
-            m_pSoundManager->underflowHappened(10);
-            //qDebug() << "callbackProcessDrift read:" << (float)readAvailable / outChunkSize << "Underflow";
-        } else {
+            m_outputFifo->releaseReadRegions(readFrames * channels);
+        }
+        if (readFrames < neededFrames) {
             // underflow
-            SampleUtil::clear(out, outChunkSize);
-            m_pSoundManager->underflowHappened(11);
-            //qDebug() << "callbackProcess read:" << (float)readAvailable / outChunkSize << "Buffer empty";
+            m_outputResampler.appendSilence(neededFrames - readFrames);
+            m_pSoundManager->underflowHappened(readFrames > 0 ? 10 : 11);
+            //qDebug() << "callbackProcessDrift read:" << fillFrames << "Underflow";
         }
+        m_outputResampler.resample(out, framesPerBuffer);
     }
     return paContinue;
 }
@@ -904,6 +893,7 @@ int SoundDevicePortAudio::callbackProcessClkRef(
         QThread::currentThread()->setPriority(QThread::TimeCriticalPriority);
 #endif
         m_bSetThreadPriority = true;
+        mixxx::CpuAffinity::applyToCurrentThread(mixxx::CpuAffinity::ThreadRole::Engine);
 
 #ifdef __SSE__
         // This disables the denormals calculations, to avoid a
@@ -1083,6 +1073,39 @@ void SoundDevicePortAudio::updateCallbackEntryToDacTime(
     //qDebug() << callbackEntrytoDacSecs << timeSinceLastCbSecs;
 }
 
+void SoundDevicePortAudio::recordCallbackTiming(SINT framesPerBuffer,
+        const PaStreamCallbackTimeInfo* timeInfo,
+        mixxx::Duration entry) {
+    const mixxx::Duration processing = mixxx::Time::elapsed() - entry;
+    const double bufferSeconds = framesPerBuffer / m_dSampleRate;
+    if (m_callbackTiming.bufferSeconds() != bufferSeconds) {
+        // First callback or JACK has changed the buffer size
+        m_callbackTiming.reset(bufferSeconds);
+    }
+    // The time until the buffer is played, if the API provides a plausible one
+    double deadlineSeconds = 0;
+    if (m_outputParams.channelCount > 0) {
+        deadlineSeconds = timeInfo->outputBufferDacTime - timeInfo->currentTime;
+        if (deadlineSeconds > bufferSeconds * 4) {
+            deadlineSeconds = 0;
+        }
+    }
+    m_callbackTiming.record(entry.toIntegerNanos(),
+            processing.toIntegerNanos(),
+            deadlineSeconds,
+            static_cast<int>(framesPerBuffer));
+
+    m_framesSinceCallbackTimingUpdate += framesPerBuffer;
+    if (m_framesSinceCallbackTimingUpdate > (m_dSampleRate / kCallbackTimingUpdateRate)) {
+        m_publishedCallbackTiming.setValue(m_callbackTiming);
+        m_framesSinceCallbackTimingUpdate = 0;
+    }
+}
+
+CallbackTimingStats SoundDevicePortAudio::getCallbackTiming() const {
+    return m_publishedCallbackTiming.getValue();
+}
+
 void SoundDevicePortAudio::updateAudioLatencyUsage(
         const SINT framesPerBuffer) {
     m_framesSinceAudioLatencyUsageUpdate += framesPerBuffer;
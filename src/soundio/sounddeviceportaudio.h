@@ -5,7 +5,10 @@
 #include <QString>
 #include <memory>
 
+#include "control/controlvalue.h"
 #include "control/pollingcontrolproxy.h"
+#include "soundio/callbacktimingstats.h"
+#include "soundio/driftresampler.h"
 #include "soundio/sounddevice.h"
 #include "util/duration.h"
 #include "util/fifo.h"
@@ -46,6 +49,15 @@ class SoundDevicePortAudio : public SoundDevice {
                         const PaStreamCallbackTimeInfo *timeInfo,
                         PaStreamCallbackFlags statusFlags);
 
+    // Called at the end of every callback
+    void recordCallbackTiming(SINT framesPerBuffer,
+            const PaStreamCallbackTimeInfo* timeInfo,
+            mixxx::Duration entry);
+    bool hasCallbackTiming() const override {
+        return true;
+    }
+    CallbackTimingStats getCallbackTiming() const override;
+
     unsigned int getDefaultSampleRate() const override {
         return m_deviceInfo ? static_cast<unsigned int>(
             m_deviceInfo->defaultSampleRate) : 44100;
@@ -70,6 +82,12 @@ class SoundDevicePortAudio : public SoundDevice {
     std::unique_ptr<FIFO<CSAMPLE>> m_inputFifo;
     bool m_outputDrift;
     bool m_inputDrift;
+    // Drift compensation of the non clock reference device in the
+    // "Default (long delay)" mode, only accessed by the callback
+    DriftResampler m_outputResampler;
+    DriftResampler m_inputResampler;
+    ClockDriftController m_outputDriftController;
+    ClockDriftController m_inputDriftController;
 
     // A string describing the last PortAudio error to occur.
     QString m_lastError;
@@ -82,4 +100,9 @@ class SoundDevicePortAudio : public SoundDevice {
     int m_invalidTimeInfoCount;
     PerformanceTimer m_clkRefTimer;
     PaTime m_lastCallbackEntrytoDacSecs;
+    // Only accessed by the callback
+    CallbackTimingStats m_callbackTiming;
+    int m_framesSinceCallbackTimingUpdate;
+    // A copy for the SoundManager, updated a few times per second
+    ControlValueTripleBuffer<CallbackTimingStats> m_publishedCallbackTiming;
 };
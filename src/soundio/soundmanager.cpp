@@ -2,23 +2,35 @@
 
 #include <portaudio.h>
 
+#include <QFuture>
 #include <QLibrary>
 #include <QThread>
+#include <QtConcurrentRun>
+#include <cmath>
 #include <cstring> // for memcpy and strcmp
 
 #include "control/controlobject.h"
+#include "control/controlpushbutton.h"
 #include "engine/enginemixer.h"
 #include "engine/sidechain/enginenetworkstream.h"
 #include "moc_soundmanager.cpp"
+#include "soundio/adaptivebuffersize.h"
 #include "soundio/sounddevice.h"
+#ifdef __JACK__
+#include "soundio/sounddevicejack.h"
+#endif
 #include "soundio/sounddevicenetwork.h"
 #include "soundio/sounddevicenotfound.h"
 #include "soundio/sounddeviceportaudio.h"
 #include "soundio/soundmanagerutil.h"
+#include "soundio/xrunlog.h"
 #include "util/cmdlineargs.h"
 #include "util/compatibility/qatomic.h"
 #include "util/defs.h"
+#include "util/performancetimer.h"
+#include "util/realtimelog.h"
 #include "util/sample.h"
+#include "util/time.h"
 #include "util/versionstore.h"
 #include "vinylcontrol/defs_vinylcontrol.h"
 
@@ -30,6 +42,21 @@ const QString kAppGroup = QStringLiteral("[App]");
 
 #define CPU_OVERLOAD_DURATION 500 // in ms
 
+constexpr int kAdaptiveBufferSizeIntervalMillis = 1000;
+// Restarting the devices interrupts the audio for a moment. A new buffer
+// size is only applied after the main output has been silent for this
+// long, e.g. between two tracks.
+constexpr int kQuietSecondsBeforeRestart = 2;
+constexpr double kSilentVuMeter = 0.01;
+
+constexpr int kCallbackTimingIntervalMillis = 500;
+// The headroom shown is the one of the worst 1 % of the callbacks
+constexpr double kHeadroomQuantile = 0.01;
+
+// The PortAudio initialization started by startProbingDevices()
+QFuture<PaError> s_paInitializeFuture;
+bool s_paInitializeStarted = false;
+
 struct DeviceMode {
     SoundDevicePointer pDevice;
     bool isInput;
@@ -50,6 +77,14 @@ SoundManager::SoundManager(UserSettingsPointer pConfig,
           m_pErrorDevice(nullptr),
           m_underflowHappened(0),
           m_underflowUpdateCount(0),
+          m_xrunCodes(0),
+          m_pXrunLog(std::make_unique<XrunLog>(pConfig->getSettingsPath())),
+          m_pRealtimeLogWriter(std::make_unique<mixxx::RealtimeLogWriter>()),
+          m_xrunCount(0),
+          m_lastXrunCount(0),
+          m_quietSeconds(0),
+          m_audioLatencyUsage(kAppGroup, QStringLiteral("audio_latency_usage")),
+          m_mainVuMeter(QStringLiteral("[Main]"), QStringLiteral("vu_meter")),
           m_audioLatencyOverloadCount(kAppGroup, QStringLiteral("audio_latency_overload_count")),
           m_audioLatencyOverload(kAppGroup, QStringLiteral("audio_latency_overload")) {
     // TODO(xxx) some of these ControlObject are not needed by soundmanager, or are unused here.
@@ -67,7 +102,7 @@ SoundManager::SoundManager(UserSettingsPointer pConfig,
     m_samplerates.push_back(96000);
 
     m_pNetworkStream = QSharedPointer<EngineNetworkStream>(
-            new EngineNetworkStream(2, 0));
+            new EngineNetworkStream(2, 2));
 
     queryDevices();
 
@@ -79,6 +114,45 @@ SoundManager::SoundManager(UserSettingsPointer pConfig,
     // previously configured devices were not found.
     // Write new config after MixxxMainWindow::noOutputDlg where the user has
     // a chance to keep the previous sound config (exit).
+
+    m_pAdaptiveBufferSize = std::make_unique<AdaptiveBufferSize>(
+            m_config.getAudioBufferSizeIndex(),
+            SoundManagerConfig::kMaxAudioBufferSizeIndex);
+    m_pAdaptiveBufferSizeCO = new ControlPushButton(
+            ConfigKey(kAppGroup, QStringLiteral("audio_buffer_adaptive")), true);
+    m_pAdaptiveBufferSizeCO->setButtonMode(ControlPushButton::TOGGLE);
+    // The buffer time the adaptive mode aims for, the current one is
+    // output_latency_ms
+    m_pAdaptiveBufferTargetMsCO = new ControlObject(
+            ConfigKey(kAppGroup, QStringLiteral("audio_buffer_adaptive_target_ms")));
+    m_pAdaptiveBufferTargetMsCO->setReadOnly();
+    // 1 while a new buffer size waits for a pause in the main output
+    m_pAdaptiveBufferPendingCO = new ControlObject(
+            ConfigKey(kAppGroup, QStringLiteral("audio_buffer_adaptive_pending")));
+    m_pAdaptiveBufferPendingCO->setReadOnly();
+    m_adaptiveBufferSizeTimer.setInterval(kAdaptiveBufferSizeIntervalMillis);
+    connect(&m_adaptiveBufferSizeTimer,
+            &QTimer::timeout,
+            this,
+            &SoundManager::slotUpdateAdaptiveBufferSize);
+    m_adaptiveBufferSizeTimer.start();
+
+    // Timing of the clock reference device and the worst case of all devices
+    m_pCallbackJitterMsCO = new ControlObject(
+            ConfigKey(kAppGroup, QStringLiteral("callback_jitter_ms")));
+    m_pCallbackJitterMsCO->setReadOnly();
+    m_pCallbackHeadroomMsCO = new ControlObject(
+            ConfigKey(kAppGroup, QStringLiteral("callback_headroom_ms")));
+    m_pCallbackHeadroomMsCO->setReadOnly();
+    m_pClockDriftPpmCO = new ControlObject(
+            ConfigKey(kAppGroup, QStringLiteral("clock_drift_ppm")));
+    m_pClockDriftPpmCO->setReadOnly();
+    m_callbackTimingTimer.setInterval(kCallbackTimingIntervalMillis);
+    connect(&m_callbackTimingTimer,
+            &QTimer::timeout,
+            this,
+            &SoundManager::slotUpdateCallbackTimings);
+    m_callbackTimingTimer.start();
 }
 
 SoundManager::~SoundManager() {
@@ -93,6 +167,14 @@ SoundManager::~SoundManager() {
     // vinyl control proxies and input buffers are freed in closeDevices, called
     // by clearDeviceList -- bkgood
 
+    m_callbackTimingTimer.stop();
+    delete m_pClockDriftPpmCO;
+    delete m_pCallbackHeadroomMsCO;
+    delete m_pCallbackJitterMsCO;
+    m_adaptiveBufferSizeTimer.stop();
+    delete m_pAdaptiveBufferPendingCO;
+    delete m_pAdaptiveBufferTargetMsCO;
+    delete m_pAdaptiveBufferSizeCO;
     delete m_pControlObjectSoundStatusCO;
     delete m_pControlObjectVinylControlGainCO;
 }
@@ -136,6 +218,14 @@ QList<QString> SoundManager::getHostAPIList() const {
             apiList.push_back(api->name);
         }
     }
+#ifdef __JACK__
+    for (const auto& pDevice : m_devices) {
+        if (pDevice->getHostAPI() == MIXXX_JACK_NATIVE_STRING) {
+            apiList.push_back(MIXXX_JACK_NATIVE_STRING);
+            break;
+        }
+    }
+#endif
 
     return apiList;
 }
@@ -213,7 +303,7 @@ void SoundManager::clearDeviceList(bool sleepAfterClosing) {
 }
 
 QList<unsigned int> SoundManager::getSampleRates(const QString& api) const {
-    if (api == MIXXX_PORTAUDIO_JACK_STRING) {
+    if (isJackApi(api)) {
         // queryDevices must have been called for this to work, but the
         // ctor calls it -bkgood
         QList<unsigned int> samplerates;
@@ -232,12 +322,27 @@ QList<unsigned int> SoundManager::getSampleRates() const {
 void SoundManager::queryDevices() {
     //qDebug() << "SoundManager::queryDevices()";
     queryDevicesPortaudio();
+    queryDevicesJack();
     queryDevicesMixxx();
 
     // now tell the prefs that we updated the device list -- bkgood
     emit devicesUpdated();
 }
 
+// static
+void SoundManager::startProbingDevices() {
+    VERIFY_OR_DEBUG_ASSERT(!s_paInitializeStarted) {
+        return;
+    }
+    s_paInitializeStarted = true;
+    s_paInitializeFuture = QtConcurrent::run([] {
+#ifdef Q_OS_LINUX
+        setJACKName();
+#endif
+        return Pa_Initialize();
+    });
+}
+
 void SoundManager::clearAndQueryDevices() {
     const bool sleepAfterClosing = true;
     clearDeviceList(sleepAfterClosing);
@@ -247,10 +352,20 @@ void SoundManager::clearAndQueryDevices() {
 void SoundManager::queryDevicesPortaudio() {
     PaError err = paNoError;
     if (!m_paInitialized) {
+        if (s_paInitializeStarted) {
+            // Only the first query after the start of Mixxx
+            s_paInitializeStarted = false;
+            PerformanceTimer timer;
+            timer.start();
+            err = s_paInitializeFuture.result();
+            qDebug() << "Waited" << timer.elapsed().debugMillisWithUnit()
+                     << "for PortAudio probing the devices";
+        } else {
 #ifdef Q_OS_LINUX
-        setJACKName();
+            setJACKName();
 #endif
-        err = Pa_Initialize();
+            err = Pa_Initialize();
+        }
         m_paInitialized = true;
     }
     if (err != paNoError) {
@@ -307,6 +422,22 @@ void SoundManager::queryDevicesPortaudio() {
     }
 }
 
+void SoundManager::queryDevicesJack() {
+#ifdef __JACK__
+    jack_client_t* pClient = SoundDeviceJack::openClient(
+            VersionStore::applicationName());
+    if (!pClient) {
+        return;
+    }
+    auto currentDevice = SoundDevicePointer(new SoundDeviceJack(
+            m_pConfig, this, pClient));
+    m_devices.push_back(currentDevice);
+    // Both JACK backends talk to the same server
+    m_jackSampleRate = static_cast<mixxx::audio::SampleRate::value_t>(
+            currentDevice->getDefaultSampleRate());
+#endif
+}
+
 void SoundManager::queryDevicesMixxx() {
     auto currentDevice = SoundDevicePointer(new SoundDeviceNetwork(
             m_pConfig, this, m_pNetworkStream));
@@ -475,6 +606,7 @@ SoundDeviceStatus SoundManager::setupDevices() {
     }
 
     if (pNewMainClockRef) {
+        m_clockReferenceDeviceId = pNewMainClockRef->getDeviceId();
         qDebug() << "Using" << pNewMainClockRef->getDisplayName()
                  << "as output sound device clock reference";
     } else {
@@ -539,13 +671,16 @@ QString SoundManager::getLastErrorMessage(SoundDeviceStatus status) const {
 }
 
 SoundManagerConfig SoundManager::getConfig() const {
-    return m_config;
+    SoundManagerConfig config = m_config;
+    config.setAudioBufferSizeIndex(m_pAdaptiveBufferSize->configuredIndex());
+    return config;
 }
 
 SoundDeviceStatus SoundManager::setConfig(const SoundManagerConfig& config) {
     SoundDeviceStatus status = SoundDeviceStatus::Ok;
     m_config = config;
     checkConfig();
+    m_pAdaptiveBufferSize->setConfiguredIndex(m_config.getAudioBufferSizeIndex());
 
     // Close open devices. After this call we will not get any more
     // onDeviceOutputCallback() or pushBuffer() calls because all the
@@ -561,7 +696,7 @@ SoundDeviceStatus SoundManager::setConfig(const SoundManagerConfig& config) {
 
     status = setupDevices();
     if (status == SoundDeviceStatus::Ok) {
-        m_config.writeToDisk();
+        writeConfigToDisk();
     }
     return status;
 }
@@ -585,7 +720,9 @@ void SoundManager::checkConfig() {
 void SoundManager::onDeviceOutputCallback(const SINT iFramesPerBuffer) {
     // Produce a block of samples for output. EngineMixer expects stereo
     // samples so multiply iFramesPerBuffer by 2.
+    const qint64 startNanos = mixxx::Time::elapsed().toIntegerNanos();
     m_pEngineMixer->process(iFramesPerBuffer * 2);
+    m_pXrunLog->recordCallback(mixxx::Time::elapsed().toIntegerNanos() - startNanos);
 }
 
 void SoundManager::pushInputBuffers(const QList<AudioInputBuffer>& inputs,
@@ -642,7 +779,8 @@ QList<AudioInput> SoundManager::registeredInputs() const {
     return m_registeredDestinations.keys();
 }
 
-void SoundManager::setJACKName() const {
+// static
+void SoundManager::setJACKName() {
 #ifdef Q_OS_LINUX
     typedef PaError (*SetJackClientName)(const char *name);
     QLibrary portaudio("libportaudio.so.2");
@@ -674,7 +812,7 @@ void SoundManager::setConfiguredDeckCount(int count) {
     }
     m_config.setDeckCount(count);
     checkConfig();
-    m_config.writeToDisk();
+    writeConfigToDisk();
 }
 
 int SoundManager::getConfiguredDeckCount() const {
@@ -682,11 +820,16 @@ int SoundManager::getConfiguredDeckCount() const {
 }
 
 void SoundManager::processUnderflowHappened(SINT framesPerBuffer) {
+    // Reset the codes in each callback to only report the codes of the
+    // counted underflow
+    const auto xrunCodes = static_cast<quint32>(m_xrunCodes.fetchAndStoreRelaxed(0));
     if (m_underflowUpdateCount == 0) {
         if (atomicLoadRelaxed(m_underflowHappened)) {
+            captureXrunSnapshot(xrunCodes, framesPerBuffer);
             m_audioLatencyOverload.set(1.0);
             m_audioLatencyOverloadCount.set(
                     m_audioLatencyOverloadCount.get() + 1);
+            m_xrunCount.fetchAndAddRelaxed(1);
             m_underflowUpdateCount = CPU_OVERLOAD_DURATION *
                     m_config.getSampleRate() / framesPerBuffer / 1000;
 
@@ -700,3 +843,130 @@ void SoundManager::processUnderflowHappened(SINT framesPerBuffer) {
         --m_underflowUpdateCount;
     }
 }
+
+void SoundManager::captureXrunSnapshot(quint32 codes, SINT framesPerBuffer) {
+    XrunSnapshot* pSnapshot = m_pXrunLog->prepareSnapshot(
+            codes, framesPerBuffer, m_config.getSampleRate());
+    m_pEngineMixer->collectXrunState(pSnapshot);
+    m_pXrunLog->commitSnapshot();
+}
+
+void SoundManager::writeConfigToDisk() const {
+    getConfig().writeToDisk();
+}
+
+double SoundManager::audioBufferMillis(unsigned int audioBufferSizeIndex) const {
+    SoundManagerConfig config = m_config;
+    config.setAudioBufferSizeIndex(audioBufferSizeIndex);
+    return config.getFramesPerBuffer() * 1000.0 / m_config.getSampleRate();
+}
+
+void SoundManager::slotUpdateAdaptiveBufferSize() {
+    const int xrunCount = atomicLoadRelaxed(m_xrunCount);
+    const int xruns = xrunCount - m_lastXrunCount;
+    m_lastXrunCount = xrunCount;
+
+    const unsigned int currentIndex = m_config.getAudioBufferSizeIndex();
+    unsigned int targetIndex;
+    if (jackApiUsed()) {
+        // JACK decides the buffer size
+        targetIndex = currentIndex;
+    } else if (m_pAdaptiveBufferSizeCO->toBool()) {
+        targetIndex = m_pAdaptiveBufferSize->update(xruns, m_audioLatencyUsage.get());
+    } else {
+        // Return to the configured size after the adaptive mode is disabled
+        targetIndex = m_pAdaptiveBufferSize->configuredIndex();
+    }
+    m_pAdaptiveBufferTargetMsCO->forceSet(audioBufferMillis(targetIndex));
+
+    if (targetIndex == currentIndex) {
+        m_pAdaptiveBufferPendingCO->forceSet(0.0);
+        m_quietSeconds = 0;
+        return;
+    }
+    m_pAdaptiveBufferPendingCO->forceSet(1.0);
+    if (m_mainVuMeter.get() > kSilentVuMeter) {
+        m_quietSeconds = 0;
+        return;
+    }
+    if (++m_quietSeconds < kQuietSecondsBeforeRestart) {
+        return;
+    }
+    m_quietSeconds = 0;
+    applyAudioBufferSizeIndex(targetIndex);
+}
+
+void SoundManager::slotUpdateCallbackTimings() {
+    m_callbackTimings.clear();
+    CallbackTimingStats reference;
+    for (const auto& pDevice : std::as_const(m_devices)) {
+        if (!pDevice->isOpen() || !pDevice->hasCallbackTiming()) {
+            continue;
+        }
+        SoundDeviceCallbackTiming timing;
+        timing.displayName = pDevice->getDisplayName();
+        timing.isClockReference = pDevice->getDeviceId() == m_clockReferenceDeviceId;
+        timing.stats = pDevice->getCallbackTiming();
+        timing.driftPpm = 0.0;
+        if (timing.isClockReference) {
+            reference = timing.stats;
+        }
+        m_callbackTimings.append(timing);
+    }
+
+    double jitterMs = 0.0;
+    double headroomMs = 0.0;
+    bool haveHeadroom = false;
+    double driftPpm = 0.0;
+    for (auto& timing : m_callbackTimings) {
+        const CallbackTimingStats& stats = timing.stats;
+        if (timing.isClockReference) {
+            jitterMs = stats.intervalJitterSeconds() * 1000;
+        } else {
+            timing.driftPpm = stats.driftPpm(reference);
+            if (std::abs(timing.driftPpm) > std::abs(driftPpm)) {
+                driftPpm = timing.driftPpm;
+            }
+        }
+        if (stats.headroom().count() > 0) {
+            // The lower bound of the bucket
+            const double deviceHeadroomMs =
+                    (stats.headroom().quantile(kHeadroomQuantile) -
+                            CallbackTimingHistogram::kBucketWidth) *
+                    stats.bufferSeconds() * 1000;
+            if (!haveHeadroom || deviceHeadroomMs < headroomMs) {
+                headroomMs = deviceHeadroomMs;
+                haveHeadroom = true;
+            }
+        }
+    }
+    m_pCallbackJitterMsCO->forceSet(jitterMs);
+    m_pCallbackHeadroomMsCO->forceSet(headroomMs);
+    m_pClockDriftPpmCO->forceSet(driftPpm);
+    emit callbackTimingsUpdated();
+}
+
+void SoundManager::applyAudioBufferSizeIndex(unsigned int audioBufferSizeIndex) {
+    const unsigned int previousIndex = m_config.getAudioBufferSizeIndex();
+    qInfo() << "SoundManager: Changing the audio buffer from"
+            << audioBufferMillis(previousIndex) << "ms to"
+            << audioBufferMillis(audioBufferSizeIndex) << "ms";
+
+    m_config.setAudioBufferSizeIndex(audioBufferSizeIndex);
+    const bool sleepAfterClosing = false;
+    closeDevices(sleepAfterClosing);
+    if (setupDevices() == SoundDeviceStatus::Ok) {
+        m_pAdaptiveBufferSize->setCurrentIndex(audioBufferSizeIndex);
+        m_pAdaptiveBufferPendingCO->forceSet(0.0);
+        return;
+    }
+
+    qWarning() << "SoundManager: The devices don't support the new audio "
+                  "buffer size, keeping the previous one";
+    m_config.setAudioBufferSizeIndex(previousIndex);
+    closeDevices(sleepAfterClosing);
+    setupDevices();
+    // Don't try again, until the user reconfigures the devices
+    m_pAdaptiveBufferSizeCO->set(0.0);
+    m_pAdaptiveBufferSize->setCurrentIndex(previousIndex);
+}
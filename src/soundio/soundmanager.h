@@ -5,6 +5,8 @@
 #include <QObject>
 #include <QSharedPointer>
 #include <QString>
+#include <QTimer>
+#include <memory>
 
 #include "audio/types.h"
 #include "control/pollingcontrolproxy.h"
@@ -15,8 +17,15 @@
 #include "util/cmdlineargs.h"
 #include "util/types.h"
 
+class AdaptiveBufferSize;
 class EngineMixer;
 class ControlObject;
+class ControlPushButton;
+class XrunLog;
+
+namespace mixxx {
+class RealtimeLogWriter;
+} // namespace mixxx
 
 #define MIXXX_PORTAUDIO_JACK_STRING "JACK Audio Connection Kit"
 #define MIXXX_PORTAUDIO_ALSA_STRING "ALSA"
@@ -24,12 +33,28 @@ class ControlObject;
 #define MIXXX_PORTAUDIO_ASIO_STRING "ASIO"
 #define MIXXX_PORTAUDIO_DIRECTSOUND_STRING "Windows DirectSound"
 #define MIXXX_PORTAUDIO_COREAUDIO_STRING "Core Audio"
+// The native JACK backend without PortAudio, see SoundDeviceJack
+#define MIXXX_JACK_NATIVE_STRING "JACK (native)"
+
+/// JACK decides about the sample rate and buffer size with both backends
+inline bool isJackApi(const QString& api) {
+    return api == MIXXX_PORTAUDIO_JACK_STRING || api == MIXXX_JACK_NATIVE_STRING;
+}
 
 #define SOUNDMANAGER_DISCONNECTED 0
 #define SOUNDMANAGER_CONNECTING 1
 #define SOUNDMANAGER_CONNECTED 2
 
 
+/// The callback timing of an open sound device, see CallbackTimingStats
+struct SoundDeviceCallbackTiming {
+    QString displayName;
+    bool isClockReference;
+    CallbackTimingStats stats;
+    // Compared to the clock reference device
+    double driftPpm;
+};
+
 class SoundManager : public QObject {
     Q_OBJECT
   public:
@@ -42,10 +67,18 @@ class SoundManager : public QObject {
     QList<SoundDevicePointer> getDeviceList(
             const QString& filterAPI, bool bOutputDevices, bool bInputDevices) const;
 
+    /// Starts initializing PortAudio in a background thread. PortAudio probes
+    /// all host APIs and devices on initialization, which takes seconds with
+    /// some Windows drivers. Called early during the startup, the probing
+    /// overlaps with loading fonts and the database. The constructor waits
+    /// for the result.
+    static void startProbingDevices();
+
     // Creates a list of sound devices
     void clearAndQueryDevices();
     void queryDevices();
     void queryDevicesPortaudio();
+    void queryDevicesJack();
     void queryDevicesMixxx();
 
     // Opens all the devices chosen by the user in the preferences dialog, and
@@ -93,6 +126,7 @@ class SoundManager : public QObject {
 
     void underflowHappened(int code) {
         m_underflowHappened = 1;
+        m_xrunCodes.fetchAndOrRelaxed(1 << code);
         // Disable the engine warnings by default, because printing a warning is a
         // locking function that will make the problem worse
         if (CmdlineArgs::Instance().getDeveloper()) {
@@ -102,13 +136,31 @@ class SoundManager : public QObject {
 
     void processUnderflowHappened(SINT framesPerBuffer);
 
+    // The callback timing of all open devices as of the last update
+    const QList<SoundDeviceCallbackTiming>& getCallbackTimings() const {
+        return m_callbackTimings;
+    }
+
   signals:
     void devicesUpdated(); // emitted when pointers to SoundDevices go stale
     void devicesSetup(); // emitted when the sound devices have been set up
     void outputRegistered(const AudioOutput& output, AudioSource* src);
     void inputRegistered(const AudioInput& input, AudioDestination* dest);
+    void callbackTimingsUpdated();
+
+  private slots:
+    // Called once per second to adapt the audio buffer size to the xruns
+    void slotUpdateAdaptiveBufferSize();
+    // Collects the callback timing of the open devices
+    void slotUpdateCallbackTimings();
 
   private:
+    // Restarts the devices with another buffer size, keeping the configured
+    // size of the user
+    void applyAudioBufferSizeIndex(unsigned int audioBufferSizeIndex);
+    double audioBufferMillis(unsigned int audioBufferSizeIndex) const;
+    void writeConfigToDisk() const;
+
     // Closes all the devices and empties the list of devices we have.
     void clearDeviceList(bool sleepAfterClosing);
 
@@ -118,9 +170,13 @@ class SoundManager : public QObject {
     // isn't open is safe.
     void closeDevices(bool sleepAfterClosing);
 
-    void setJACKName() const;
+    // Captures the engine state into the xrun log, called from the
+    // callback thread
+    void captureXrunSnapshot(quint32 codes, SINT framesPerBuffer);
+
+    static void setJACKName();
     bool jackApiUsed() const {
-        return m_config.getAPI() == MIXXX_PORTAUDIO_JACK_STRING;
+        return isJackApi(m_config.getAPI());
     }
 
     EngineMixer* m_pEngineMixer;
@@ -142,6 +198,35 @@ class SoundManager : public QObject {
 
     QAtomicInt m_underflowHappened;
     int m_underflowUpdateCount;
+    // The codes of all underflowHappened() calls since the last callback,
+    // one bit per code
+    QAtomicInt m_xrunCodes;
+    std::unique_ptr<XrunLog> m_pXrunLog;
+    // Flushes the messages that the engine threads log with RealtimeLog
+    std::unique_ptr<mixxx::RealtimeLogWriter> m_pRealtimeLogWriter;
+    // Counted like audio_latency_overload_count, but not reset by
+    // setupDevices()
+    QAtomicInt m_xrunCount;
+    int m_lastXrunCount;
+
+    // While the adaptive mode has increased the buffer size, m_config holds
+    // the size in use, the configured one is kept here.
+    std::unique_ptr<AdaptiveBufferSize> m_pAdaptiveBufferSize;
+    ControlPushButton* m_pAdaptiveBufferSizeCO;
+    ControlObject* m_pAdaptiveBufferTargetMsCO;
+    ControlObject* m_pAdaptiveBufferPendingCO;
+    QTimer m_adaptiveBufferSizeTimer;
+    int m_quietSeconds;
+
+    SoundDeviceId m_clockReferenceDeviceId;
+    QList<SoundDeviceCallbackTiming> m_callbackTimings;
+    QTimer m_callbackTimingTimer;
+    ControlObject* m_pCallbackJitterMsCO;
+    ControlObject* m_pCallbackHeadroomMsCO;
+    ControlObject* m_pClockDriftPpmCO;
+
+    PollingControlProxy m_audioLatencyUsage;
+    PollingControlProxy m_mainVuMeter;
     PollingControlProxy m_audioLatencyOverloadCount;
     PollingControlProxy m_audioLatencyOverload;
 };
@@ -384,7 +384,7 @@ unsigned int SoundManagerConfig::getAudioBufferSizeIndex() const {
 // This reflects the configured value only. In case of JACK the
 // setting of the JACK server is used.
 unsigned int SoundManagerConfig::getFramesPerBuffer() const {
-    if (m_api == MIXXX_PORTAUDIO_JACK_STRING) {
+    if (isJackApi(m_api)) {
         // in case of jack we configure the frames/period
         if (m_audioBufferSizeIndex ==
                 static_cast<unsigned int>(
@@ -484,7 +484,9 @@ void SoundManagerConfig::loadDefaults(SoundManager* soundManager, unsigned int f
         if (!apiList.isEmpty()) {
 #ifdef __LINUX__
             //Check for JACK and use that if it's available, otherwise use ALSA
-            if (apiList.contains(MIXXX_PORTAUDIO_JACK_STRING)) {
+            if (apiList.contains(MIXXX_JACK_NATIVE_STRING)) {
+                m_api = MIXXX_JACK_NATIVE_STRING;
+            } else if (apiList.contains(MIXXX_PORTAUDIO_JACK_STRING)) {
                 m_api = MIXXX_PORTAUDIO_JACK_STRING;
             } else {
                 m_api = MIXXX_PORTAUDIO_ALSA_STRING;
@@ -0,0 +1,317 @@
+#include "soundio/xrunlog.h"
+
+#include <QDataStream>
+#include <QDir>
+#include <QFileInfo>
+#include <QTextStream>
+#include <algorithm>
+#include <cstring>
+
+#include "moc_xrunlog.cpp"
+#include "util/compatibility/qatomic.h"
+#include "util/time.h"
+
+namespace {
+
+const QString kFileName = QStringLiteral("xrun.log");
+
+constexpr quint32 kFileMagic = 0x4D585852; // "MXXR"
+constexpr quint32 kFileVersion = 1;
+constexpr QDataStream::Version kStreamVersion = QDataStream::Qt_5_0;
+
+// The capacity of the FIFO between the callback thread and the writer
+constexpr int kMaxPendingSnapshots = 64;
+constexpr int kWriteIntervalMillis = 1000;
+
+// Only the most recent callbacks are considered as the cause of an xrun,
+// older overloads might have been compensated by the device buffer.
+constexpr int kOverloadCallbackCount = 4;
+// Leave some headroom for the device I/O around the engine processing
+constexpr double kOverloadBudgetFactor = 0.9;
+
+QString fileName(int index) {
+    return index == 0 ? kFileName : QStringLiteral("%1.%2").arg(kFileName).arg(index);
+}
+
+QString codesToString(quint32 codes) {
+    QStringList codeList;
+    for (int code = 0; code < 32; ++code) {
+        if (codes & (1u << code)) {
+            codeList.append(QString::number(code));
+        }
+    }
+    return codeList.join(QChar(' '));
+}
+
+QString formatMillis(qint64 nanos) {
+    return QString::number(nanos / 1e6, 'f', 3);
+}
+
+} // anonymous namespace
+
+// static
+void XrunSnapshot::copyName(char* pName, const char* pSource) {
+    std::strncpy(pName, pSource, kMaxNameLength);
+    pName[kMaxNameLength] = '\0';
+}
+
+qint64 XrunLog::Event::budgetNanos() const {
+    if (sampleRate <= 0) {
+        return 0;
+    }
+    return static_cast<qint64>(framesPerBuffer) * 1000000000 / sampleRate;
+}
+
+bool XrunLog::Event::isEngineOverload() const {
+    const qint64 budget = budgetNanos();
+    if (budget <= 0) {
+        return false;
+    }
+    const int first = std::max(static_cast<int>(callbackNanos.size()) - kOverloadCallbackCount, 0);
+    for (int i = first; i < callbackNanos.size(); ++i) {
+        if (callbackNanos[i] > budget * kOverloadBudgetFactor) {
+            return true;
+        }
+    }
+    return false;
+}
+
+XrunLog::XrunLog(const QString& directory, QObject* pParent)
+        : QObject(pParent),
+          m_directory(directory),
+          m_snapshots(kMaxPendingSnapshots),
+          m_pendingSnapshot(),
+          m_droppedSnapshotCount(0),
+          m_callbackNanos(),
+          m_callbackCount(0),
+          m_nextCallback(0) {
+    m_writeTimer.setInterval(kWriteIntervalMillis);
+    connect(&m_writeTimer,
+            &QTimer::timeout,
+            this,
+            &XrunLog::writePendingSnapshots);
+    m_writeTimer.start();
+}
+
+XrunLog::~XrunLog() {
+    writePendingSnapshots();
+}
+
+// static
+QStringList XrunLog::filePaths(const QString& directory) {
+    const QDir dir(directory);
+    QStringList paths;
+    for (int i = kMaxFileCount - 1; i >= 0; --i) {
+        const QString path = dir.absoluteFilePath(fileName(i));
+        if (QFileInfo::exists(path)) {
+            paths.append(path);
+        }
+    }
+    return paths;
+}
+
+// static
+QList<XrunLog::Event> XrunLog::readEvents(const QString& directory) {
+    QList<Event> events;
+    const QStringList paths = filePaths(directory);
+    for (const auto& path : paths) {
+        QFile file(path);
+        if (!file.open(QIODevice::ReadOnly)) {
+            qWarning() << "Failed to open xrun log" << path;
+            continue;
+        }
+        QDataStream stream(&file);
+        stream.setVersion(kStreamVersion);
+        quint32 magic = 0;
+        quint32 version = 0;
+        stream >> magic >> version;
+        if (magic != kFileMagic || version != kFileVersion) {
+            qWarning() << "Ignoring xrun log with unknown format" << path;
+            continue;
+        }
+        while (!stream.atEnd()) {
+            Event event;
+            qint64 timeMillis;
+            qint32 callbackCount;
+            qint32 deckCount;
+            stream >> timeMillis >> event.codes >> event.framesPerBuffer >>
+                    event.sampleRate >> callbackCount;
+            for (int i = 0; i < callbackCount && stream.status() == QDataStream::Ok; ++i) {
+                qint64 callbackNanos;
+                stream >> callbackNanos;
+                event.callbackNanos.append(callbackNanos);
+            }
+            stream >> deckCount;
+            for (int i = 0; i < deckCount && stream.status() == QDataStream::Ok; ++i) {
+                Event::Deck deck;
+                stream >> deck.group >> deck.scaler >> deck.playing >> deck.cacheMissCount;
+                event.decks.append(deck);
+            }
+            stream >> event.enabledEffectChainCount >> event.busyAnalyzerCount;
+            if (stream.status() != QDataStream::Ok) {
+                // The last record might be truncated if Mixxx has crashed
+                qWarning() << "Truncated xrun log" << path;
+                break;
+            }
+            event.time = QDateTime::fromMSecsSinceEpoch(timeMillis);
+            events.append(event);
+        }
+    }
+    return events;
+}
+
+// static
+bool XrunLog::exportCsv(const QString& directory, const QString& csvFilePath) {
+    QFile csvFile(csvFilePath);
+    if (!csvFile.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        qWarning() << "open" << csvFilePath << "failed";
+        return false;
+    }
+    QTextStream stream(&csvFile);
+    stream << "time,cause,codes,frames_per_buffer,sample_rate,budget_ms,"
+              "max_callback_ms,callbacks_ms,decks,enabled_effect_chains,"
+              "busy_analyzers\n";
+    const QList<Event> events = readEvents(directory);
+    for (const auto& event : events) {
+        qint64 maxCallbackNanos = 0;
+        QStringList callbacks;
+        for (const auto callbackNanos : event.callbackNanos) {
+            maxCallbackNanos = std::max(maxCallbackNanos, callbackNanos);
+            callbacks.append(formatMillis(callbackNanos));
+        }
+        QStringList decks;
+        for (const auto& deck : event.decks) {
+            decks.append(QStringLiteral("%1:%2:%3:%4")
+                                 .arg(deck.group,
+                                         deck.scaler,
+                                         deck.playing ? QStringLiteral("playing")
+                                                      : QStringLiteral("stopped"),
+                                         QString::number(deck.cacheMissCount)));
+        }
+        stream << event.time.toString(Qt::ISODateWithMs) << ','
+               << (event.isEngineOverload() ? "engine overload" : "device or driver") << ','
+               << codesToString(event.codes) << ','
+               << event.framesPerBuffer << ','
+               << event.sampleRate << ','
+               << formatMillis(event.budgetNanos()) << ','
+               << formatMillis(maxCallbackNanos) << ','
+               << callbacks.join(QChar(' ')) << ','
+               << decks.join(QChar(' ')) << ','
+               << event.enabledEffectChainCount << ','
+               << event.busyAnalyzerCount << '\n';
+    }
+    return stream.status() == QTextStream::Ok;
+}
+
+int XrunLog::droppedSnapshotCount() const {
+    return atomicLoadRelaxed(m_droppedSnapshotCount);
+}
+
+void XrunLog::recordCallback(qint64 durationNanos) {
+    m_callbackNanos[m_nextCallback] = durationNanos;
+    m_nextCallback = (m_nextCallback + 1) % XrunSnapshot::kMaxCallbacks;
+    m_callbackCount = std::min(m_callbackCount + 1, XrunSnapshot::kMaxCallbacks);
+}
+
+XrunSnapshot* XrunLog::prepareSnapshot(
+        quint32 codes, SINT framesPerBuffer, int sampleRate) {
+    XrunSnapshot* pSnapshot = &m_pendingSnapshot;
+    pSnapshot->elapsedNanos = mixxx::Time::elapsed().toIntegerNanos();
+    pSnapshot->codes = codes;
+    pSnapshot->framesPerBuffer = static_cast<qint32>(framesPerBuffer);
+    pSnapshot->sampleRate = sampleRate;
+    pSnapshot->callbackCount = m_callbackCount;
+    const int oldest = (m_nextCallback - m_callbackCount + XrunSnapshot::kMaxCallbacks) %
+            XrunSnapshot::kMaxCallbacks;
+    for (int i = 0; i < m_callbackCount; ++i) {
+        pSnapshot->callbackNanos[i] =
+                m_callbackNanos[(oldest + i) % XrunSnapshot::kMaxCallbacks];
+    }
+    pSnapshot->deckCount = 0;
+    pSnapshot->enabledEffectChainCount = 0;
+    pSnapshot->busyAnalyzerCount = 0;
+    return pSnapshot;
+}
+
+void XrunLog::commitSnapshot() {
+    if (m_snapshots.write(&m_pendingSnapshot, 1) != 1) {
+        m_droppedSnapshotCount.fetchAndAddRelaxed(1);
+    }
+}
+
+void XrunLog::writePendingSnapshots() {
+    XrunSnapshot snapshot;
+    while (m_snapshots.read(&snapshot, 1) == 1) {
+        writeSnapshot(snapshot);
+    }
+    if (m_file.isOpen()) {
+        m_file.flush();
+    }
+}
+
+bool XrunLog::openFile() {
+    if (m_file.isOpen()) {
+        if (m_file.size() < kMaxFileSize) {
+            return true;
+        }
+        m_file.close();
+        rotateFiles();
+    }
+    if (!QDir(m_directory).exists()) {
+        return false;
+    }
+    m_file.setFileName(QDir(m_directory).absoluteFilePath(kFileName));
+    if (m_file.exists() && m_file.size() >= kMaxFileSize) {
+        rotateFiles();
+    }
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        qWarning() << "Failed to open xrun log" << m_file.fileName();
+        return false;
+    }
+    if (m_file.size() == 0) {
+        QDataStream stream(&m_file);
+        stream.setVersion(kStreamVersion);
+        stream << kFileMagic << kFileVersion;
+    }
+    return true;
+}
+
+void XrunLog::rotateFiles() {
+    const QDir dir(m_directory);
+    for (int i = kMaxFileCount - 1; i >= 0; --i) {
+        const QString path = dir.absoluteFilePath(fileName(i));
+        if (!QFileInfo::exists(path)) {
+            continue;
+        }
+        if (i == kMaxFileCount - 1) {
+            QFile::remove(path);
+        } else if (!QFile::rename(path, dir.absoluteFilePath(fileName(i + 1)))) {
+            qWarning() << "Error rolling over xrun log" << path;
+        }
+    }
+}
+
+void XrunLog::writeSnapshot(const XrunSnapshot& snapshot) {
+    if (!openFile()) {
+        return;
+    }
+    // The snapshots are stored with the wall clock time
+    const qint64 ageMillis =
+            (mixxx::Time::elapsed().toIntegerNanos() - snapshot.elapsedNanos) / 1000000;
+    const qint64 timeMillis = QDateTime::currentMSecsSinceEpoch() - ageMillis;
+
+    QDataStream stream(&m_file);
+    stream.setVersion(kStreamVersion);
+    stream << timeMillis << snapshot.codes << snapshot.framesPerBuffer
+           << snapshot.sampleRate << snapshot.callbackCount;
+    for (int i = 0; i < snapshot.callbackCount; ++i) {
+        stream << snapshot.callbackNanos[i];
+    }
+    stream << snapshot.deckCount;
+    for (int i = 0; i < snapshot.deckCount; ++i) {
+        const XrunSnapshot::Deck& deck = snapshot.decks[i];
+        stream << QString::fromUtf8(deck.group) << QString::fromUtf8(deck.scaler)
+               << deck.playing << deck.cacheMissCount;
+    }
+    stream << snapshot.enabledEffectChainCount << snapshot.busyAnalyzerCount;
+}
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <QDateTime>
+#include <QFile>
+#include <QList>
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QTimer>
+
+#include "util/fifo.h"
+#include "util/types.h"
+
+// The engine state at the time of an xrun, i.e. an underflow or an
+// overflow of the audio buffers. It is captured by the callback thread
+// and must not contain any types that allocate.
+struct XrunSnapshot {
+    static constexpr int kMaxCallbacks = 32;
+    static constexpr int kMaxDecks = 16;
+    static constexpr int kMaxNameLength = 23;
+
+    struct Deck {
+        char group[kMaxNameLength + 1];
+        char scaler[kMaxNameLength + 1];
+        bool playing;
+        qint32 cacheMissCount;
+    };
+
+    // Real-time safe, truncates names that are too long
+    static void copyName(char* pName, const char* pSource);
+
+    // Relative to the start of Mixxx, see mixxx::Time
+    qint64 elapsedNanos;
+    // Bit n is set if SoundManager::underflowHappened(n) has been called
+    quint32 codes;
+    qint32 framesPerBuffer;
+    qint32 sampleRate;
+    // The durations of the preceding engine callbacks, oldest first
+    qint32 callbackCount;
+    qint64 callbackNanos[kMaxCallbacks];
+    qint32 deckCount;
+    Deck decks[kMaxDecks];
+    qint32 enabledEffectChainCount;
+    qint32 busyAnalyzerCount;
+};
+
+// Records an XrunSnapshot for each xrun into a rotating binary log in the
+// settings directory. The log allows to tell apart glitches of the audio
+// device or its driver from overloads of the engine after the fact, e.g.
+// from a log that has been attached to a bug report.
+//
+// The callback thread captures the snapshots into a preallocated FIFO. They
+// are written to the log file by the thread of the XrunLog with a delay.
+class XrunLog : public QObject {
+    Q_OBJECT
+  public:
+    static constexpr int kMaxFileCount = 3;
+    static constexpr qint64 kMaxFileSize = 1024 * 1024;
+
+    // An xrun as read back from the log
+    struct Event {
+        struct Deck {
+            QString group;
+            QString scaler;
+            bool playing;
+            int cacheMissCount;
+        };
+
+        QDateTime time;
+        quint32 codes;
+        int framesPerBuffer;
+        int sampleRate;
+        QList<qint64> callbackNanos;
+        QList<Deck> decks;
+        int enabledEffectChainCount;
+        int busyAnalyzerCount;
+
+        // The duration of the audio buffer
+        qint64 budgetNanos() const;
+        // True if one of the callbacks right before the xrun has taken
+        // (almost) longer than the duration of the audio buffer. Otherwise
+        // the audio device or its driver is the likely cause.
+        bool isEngineOverload() const;
+    };
+
+    explicit XrunLog(const QString& directory, QObject* pParent = nullptr);
+    ~XrunLog() override;
+
+    // The files of the log in the directory, oldest first
+    static QStringList filePaths(const QString& directory);
+    static QList<Event> readEvents(const QString& directory);
+    static bool exportCsv(const QString& directory, const QString& csvFilePath);
+
+    // Called from the callback thread after each callback of the engine.
+    void recordCallback(qint64 durationNanos);
+
+    // Called from the callback thread to capture a snapshot. The returned
+    // snapshot contains the callback durations and must be completed by the
+    // caller before calling commitSnapshot().
+    XrunSnapshot* prepareSnapshot(quint32 codes, SINT framesPerBuffer, int sampleRate);
+    void commitSnapshot();
+
+    // The number of snapshots that have been dropped because the FIFO was
+    // full.
+    int droppedSnapshotCount() const;
+
+  public slots:
+    // Writes all captured snapshots to the log file
+    void writePendingSnapshots();
+
+  private:
+    bool openFile();
+    void rotateFiles();
+    void writeSnapshot(const XrunSnapshot& snapshot);
+
+    const QString m_directory;
+
+    FIFO<XrunSnapshot> m_snapshots;
+    XrunSnapshot m_pendingSnapshot;
+    QAtomicInt m_droppedSnapshotCount;
+
+    // Ring of the recent callback durations, only accessed by the callback
+    // thread
+    qint64 m_callbackNanos[XrunSnapshot::kMaxCallbacks];
+    int m_callbackCount;
+    int m_nextCallback;
+
+    QFile m_file;
+    QTimer m_writeTimer;
+};
@@ -1,5 +1,7 @@
 #include "sources/audiosourcestereoproxy.h"
 
+#include <cstring>
+
 #include "util/logger.h"
 #include "util/sample.h"
 
@@ -28,7 +30,7 @@ AudioSourceStereoProxy::AudioSourceStereoProxy(
                 std::move(pAudioSource),
                 proxySignalInfo(pAudioSource->getSignalInfo())),
           m_tempSampleBuffer(
-                  (m_pAudioSource->getSignalInfo().getChannelCount() != kChannelCount) ?
+                  (m_pAudioSource->getSignalInfo().getChannelCount() > kChannelCount) ?
                   m_pAudioSource->getSignalInfo().frames2samples(maxReadableFrames) :
                   0),
           m_tempWritableSlice(m_tempSampleBuffer) {
@@ -65,10 +67,20 @@ inline bool isDisjunct(
 
 ReadableSampleFrames AudioSourceStereoProxy::readSampleFramesClamped(
         const WritableSampleFrames& sampleFrames) {
-    if (m_pAudioSource->getSignalInfo().getChannelCount() == kChannelCount) {
+    const auto sourceChannelCount = m_pAudioSource->getSignalInfo().getChannelCount();
+    if (sourceChannelCount == kChannelCount) {
         return readSampleFramesClampedOn(*m_pAudioSource, sampleFrames);
     }
 
+    // Mono samples always fit into the output buffer. Multi-channel
+    // samples only if the caller provided some extra capacity.
+    const SINT numberOfSamplesToRead =
+            m_pAudioSource->getSignalInfo().frames2samples(
+                    sampleFrames.frameLength());
+    if (sampleFrames.writableLength() >= numberOfSamplesToRead) {
+        return readSampleFramesClampedInPlace(sampleFrames);
+    }
+
     // Check location and capacity of temporary buffer
     VERIFY_OR_DEBUG_ASSERT(isDisjunct(
             m_tempWritableSlice,
@@ -77,20 +89,15 @@ ReadableSampleFrames AudioSourceStereoProxy::readSampleFramesClamped(
                 << "Overlap between output and temporary sample buffer detected";
         return ReadableSampleFrames();
     }
-    {
-        const SINT numberOfSamplesToRead =
-                m_pAudioSource->getSignalInfo().frames2samples(
-                        sampleFrames.frameLength());
-        VERIFY_OR_DEBUG_ASSERT(m_tempWritableSlice.length() >= numberOfSamplesToRead) {
-            kLogger.warning()
-                    << "Insufficient temporary sample buffer capacity"
-                    << m_tempWritableSlice.length()
-                    << "<"
-                    << numberOfSamplesToRead
-                    << "for reading frames"
-                    << sampleFrames.frameIndexRange();
-            return ReadableSampleFrames();
-        }
+    VERIFY_OR_DEBUG_ASSERT(m_tempWritableSlice.length() >= numberOfSamplesToRead) {
+        kLogger.warning()
+                << "Insufficient temporary sample buffer capacity"
+                << m_tempWritableSlice.length()
+                << "<"
+                << numberOfSamplesToRead
+                << "for reading frames"
+                << sampleFrames.frameIndexRange();
+        return ReadableSampleFrames();
     }
 
     const auto readableSampleFrames =
@@ -113,23 +120,54 @@ ReadableSampleFrames AudioSourceStereoProxy::readSampleFramesClamped(
     SampleBuffer::WritableSlice writableSlice(
             sampleFrames.writableData(getSignalInfo().frames2samples(frameOffset)),
             getSignalInfo().frames2samples(readableSampleFrames.frameLength()));
-    if (m_pAudioSource->getSignalInfo().getChannelCount() == 1) {
-        SampleUtil::copyMonoToDualMono(
-                writableSlice.data(),
+    DEBUG_ASSERT(sourceChannelCount > kChannelCount);
+    SampleUtil::copyMultiToStereo(
+            writableSlice.data(),
+            readableSampleFrames.readableData(),
+            readableSampleFrames.frameLength(),
+            sourceChannelCount);
+    return ReadableSampleFrames(
+            readableSampleFrames.frameIndexRange(),
+            SampleBuffer::ReadableSlice(
+                    writableSlice.data(),
+                    writableSlice.length()));
+}
+
+ReadableSampleFrames AudioSourceStereoProxy::readSampleFramesClampedInPlace(
+        const WritableSampleFrames& sampleFrames) {
+    // The decoder writes directly into the output buffer
+    const auto readableSampleFrames =
+            readSampleFramesClampedOn(*m_pAudioSource, sampleFrames);
+    if (readableSampleFrames.frameIndexRange().empty()) {
+        return readableSampleFrames;
+    }
+    DEBUG_ASSERT(
+            readableSampleFrames.frameIndexRange().isSubrangeOf(sampleFrames.frameIndexRange()));
+    const SINT frameOffset =
+            readableSampleFrames.frameIndexRange().start() -
+            sampleFrames.frameIndexRange().start();
+    CSAMPLE* const pStereoSamples =
+            sampleFrames.writableData(getSignalInfo().frames2samples(frameOffset));
+    const auto sourceChannelCount = m_pAudioSource->getSignalInfo().getChannelCount();
+    const SINT frameLength = readableSampleFrames.frameLength();
+    if (pStereoSamples != readableSampleFrames.readableData()) {
+        // Only if the decoded frames do not start at the beginning.
+        // The stereo frames always start before the decoded frames.
+        std::memmove(pStereoSamples,
                 readableSampleFrames.readableData(),
-                readableSampleFrames.frameLength());
+                m_pAudioSource->getSignalInfo().frames2samples(frameLength) *
+                        sizeof(CSAMPLE));
+    }
+    if (sourceChannelCount == 1) {
+        SampleUtil::doubleMonoToDualMono(pStereoSamples, frameLength);
     } else {
-        SampleUtil::copyMultiToStereo(
-                writableSlice.data(),
-                readableSampleFrames.readableData(),
-                readableSampleFrames.frameLength(),
-                m_pAudioSource->getSignalInfo().getChannelCount());
+        SampleUtil::stripMultiToStereo(pStereoSamples, frameLength, sourceChannelCount);
     }
     return ReadableSampleFrames(
             readableSampleFrames.frameIndexRange(),
             SampleBuffer::ReadableSlice(
-                    writableSlice.data(),
-                    writableSlice.length()));
+                    pStereoSamples,
+                    getSignalInfo().frames2samples(frameLength)));
 }
 
 } // namespace mixxx
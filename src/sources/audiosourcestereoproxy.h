@@ -14,7 +14,10 @@ class AudioSourceStereoProxy : public AudioSourceProxy {
                 maxReadableFrames);
     }
 
-    // Create an instance with its own temporary buffer
+    // Create an instance with its own temporary buffer. Mono sources
+    // and multi-channel sources that are read into an output buffer
+    // with enough capacity for all channels are converted in place
+    // without using the temporary buffer.
     AudioSourceStereoProxy(
             AudioSourcePointer pAudioSource,
             SINT maxReadableFrames);
@@ -30,6 +33,9 @@ class AudioSourceStereoProxy : public AudioSourceProxy {
             const WritableSampleFrames& writableSampleFrames) override;
 
   private:
+    ReadableSampleFrames readSampleFramesClampedInPlace(
+            const WritableSampleFrames& writableSampleFrames);
+
     SampleBuffer m_tempSampleBuffer;
     SampleBuffer::WritableSlice m_tempWritableSlice;
 };
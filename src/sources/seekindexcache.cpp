@@ -0,0 +1,208 @@
+#include "sources/seekindexcache.h"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutex>
+#include <QSaveFile>
+#include <cstring>
+#include <limits>
+
+#include "util/assert.h"
+#include "util/fileinfo.h"
+#include "util/logger.h"
+
+namespace mixxx {
+
+namespace {
+
+const Logger kLogger("SeekIndexCache");
+
+const QString kFileSuffix = QStringLiteral(".seek");
+
+constexpr char kMagic[8] = {'M', 'X', 'X', 'S', 'E', 'E', 'K', '\0'};
+constexpr quint32 kVersion = 1;
+
+// Fixed-size file header, followed by the entries. Each entry is stored
+// as the differences of frame index and byte offset to the preceding
+// entry. Both fit into 32 bits for any real audio file.
+struct Header {
+    char magic[8];
+    quint32 version;
+    quint32 channelCount;
+    quint32 sampleRate;
+    quint32 bitrateKbps;
+    quint32 entryCount;
+    quint32 reserved;
+    qint64 fileSize;
+    qint64 lastModified;
+    qint64 frameCount;
+};
+
+struct EntryDelta {
+    quint32 frameIndex;
+    quint32 byteOffset;
+};
+
+QMutex s_mutex;
+QString s_dirPath;
+
+QString cacheFilePath(const FileInfo& fileInfo, const QString& decoder) {
+    QString dirPath;
+    {
+        QMutexLocker locker(&s_mutex);
+        dirPath = s_dirPath;
+    }
+    if (dirPath.isEmpty()) {
+        return QString();
+    }
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(decoder.toUtf8());
+    hash.addData(fileInfo.canonicalLocation().toUtf8());
+    hash.addData(QByteArray::number(fileInfo.sizeInBytes()));
+    hash.addData(QByteArray::number(fileInfo.lastModified().toMSecsSinceEpoch()));
+    return QDir(dirPath).filePath(
+            QString::fromLatin1(hash.result().toHex()) + kFileSuffix);
+}
+
+} // anonymous namespace
+
+// static
+void SeekIndexCache::setDirectory(const QString& dirPath) {
+    QMutexLocker locker(&s_mutex);
+    s_dirPath = dirPath;
+}
+
+// static
+bool SeekIndexCache::load(
+        const FileInfo& fileInfo,
+        const QString& decoder,
+        Index* pIndex) {
+    DEBUG_ASSERT(pIndex);
+    const QString filePath = cacheFilePath(fileInfo, decoder);
+    if (filePath.isEmpty()) {
+        return false;
+    }
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        // Not cached yet
+        return false;
+    }
+    const qint64 size = file.size();
+    if (size < static_cast<qint64>(sizeof(Header))) {
+        return false;
+    }
+    const uchar* pData = file.map(0, size);
+    if (!pData) {
+        kLogger.warning()
+                << "Failed to map cache file"
+                << filePath;
+        return false;
+    }
+
+    Header header;
+    std::memcpy(&header, pData, sizeof(Header));
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 ||
+            header.version != kVersion ||
+            header.fileSize != fileInfo.sizeInBytes() ||
+            header.lastModified != fileInfo.lastModified().toMSecsSinceEpoch() ||
+            size != static_cast<qint64>(sizeof(Header)) +
+                            static_cast<qint64>(header.entryCount) *
+                                    static_cast<qint64>(sizeof(EntryDelta))) {
+        kLogger.info()
+                << "Discarding outdated cache file"
+                << filePath;
+        file.unmap(const_cast<uchar*>(pData));
+        file.close();
+        file.remove();
+        return false;
+    }
+
+    pIndex->channelCount = header.channelCount;
+    pIndex->sampleRate = header.sampleRate;
+    pIndex->bitrateKbps = header.bitrateKbps;
+    pIndex->frameCount = static_cast<SINT>(header.frameCount);
+    pIndex->entries.clear();
+    pIndex->entries.reserve(header.entryCount);
+    const uchar* pEntryData = pData + sizeof(Header);
+    Entry entry = {0, 0};
+    for (quint32 i = 0; i < header.entryCount; ++i) {
+        EntryDelta delta;
+        std::memcpy(&delta, pEntryData + i * sizeof(EntryDelta), sizeof(EntryDelta));
+        entry.frameIndex += delta.frameIndex;
+        entry.byteOffset += delta.byteOffset;
+        pIndex->entries.push_back(entry);
+    }
+    file.unmap(const_cast<uchar*>(pData));
+    return true;
+}
+
+// static
+bool SeekIndexCache::save(
+        const FileInfo& fileInfo,
+        const QString& decoder,
+        const Index& index) {
+    const QString filePath = cacheFilePath(fileInfo, decoder);
+    if (filePath.isEmpty() || index.entries.empty()) {
+        return false;
+    }
+    const QDir dir = QFileInfo(filePath).dir();
+    if (!dir.exists() && !QDir().mkpath(dir.absolutePath())) {
+        kLogger.warning()
+                << "Failed to create cache directory"
+                << dir.absolutePath();
+        return false;
+    }
+
+    Header header;
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.channelCount = index.channelCount;
+    header.sampleRate = index.sampleRate;
+    header.bitrateKbps = index.bitrateKbps;
+    header.entryCount = static_cast<quint32>(index.entries.size());
+    header.reserved = 0;
+    header.fileSize = fileInfo.sizeInBytes();
+    header.lastModified = fileInfo.lastModified().toMSecsSinceEpoch();
+    header.frameCount = index.frameCount;
+
+    QByteArray data(static_cast<int>(sizeof(Header) +
+                            index.entries.size() * sizeof(EntryDelta)),
+            Qt::Uninitialized);
+    std::memcpy(data.data(), &header, sizeof(Header));
+    char* pEntryData = data.data() + sizeof(Header);
+    Entry previous = {0, 0};
+    for (const auto& entry : index.entries) {
+        const qint64 frameDelta = entry.frameIndex - previous.frameIndex;
+        const qint64 byteDelta = entry.byteOffset - previous.byteOffset;
+        if (frameDelta < 0 || byteDelta < 0 ||
+                frameDelta > std::numeric_limits<quint32>::max() ||
+                byteDelta > std::numeric_limits<quint32>::max()) {
+            kLogger.warning()
+                    << "Unable to store seek index of"
+                    << fileInfo.location();
+            return false;
+        }
+        const EntryDelta delta = {
+                static_cast<quint32>(frameDelta),
+                static_cast<quint32>(byteDelta)};
+        std::memcpy(pEntryData, &delta, sizeof(EntryDelta));
+        pEntryData += sizeof(EntryDelta);
+        previous = entry;
+    }
+
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly) ||
+            file.write(data) != data.size() ||
+            !file.commit()) {
+        kLogger.warning()
+                << "Failed to write cache file"
+                << filePath;
+        return false;
+    }
+    return true;
+}
+
+} // namespace mixxx
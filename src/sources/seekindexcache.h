@@ -0,0 +1,58 @@
+#pragma once
+
+#include <QString>
+#include <vector>
+
+#include "util/types.h"
+
+namespace mixxx {
+
+class FileInfo;
+
+// An on-disk cache for the seek index of audio files, i.e. the byte
+// offsets of the frames or packets in the file.
+//
+// Opening an MP3 file requires to parse the headers of all MP3 frames
+// in the file, which takes seconds for long mixes or files on network
+// shares. Containers without an index like Ogg need to be bisected for
+// each seek. The collected index is stored in a compact sidecar file
+// that is keyed by a hash over the decoder, the canonical location, the
+// size, and the modification time of the audio file. Subsequent opens
+// memory-map the sidecar file instead of scanning the stream.
+//
+// The functions are thread-safe.
+class SeekIndexCache final {
+  public:
+    struct Entry {
+        // The position in the stream in the time base of the decoder,
+        // usually sample frames
+        SINT frameIndex;
+        qint64 byteOffset;
+    };
+
+    struct Index {
+        int channelCount = 0;
+        int sampleRate = 0;
+        int bitrateKbps = 0;
+        // The number of sample frames in the stream, i.e. the
+        // frame index that terminates the list of entries
+        SINT frameCount = 0;
+        // Ordered by both frame index and byte offset
+        std::vector<Entry> entries;
+    };
+
+    // The cache is disabled until a directory has been set
+    static void setDirectory(const QString& dirPath);
+
+    // Each decoder stores its own index for the same file
+    static bool load(
+            const FileInfo& fileInfo,
+            const QString& decoder,
+            Index* pIndex);
+    static bool save(
+            const FileInfo& fileInfo,
+            const QString& decoder,
+            const Index& index);
+};
+
+} // namespace mixxx
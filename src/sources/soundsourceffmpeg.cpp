@@ -9,6 +9,9 @@ extern "C" {
 
 } // extern "C"
 
+#include <algorithm>
+
+#include "util/fileinfo.h"
 #include "util/logger.h"
 #include "util/sample.h"
 
@@ -68,6 +71,12 @@ constexpr int64_t kavStreamDecoderFrameDelayAAC = 2112;
 
 constexpr SINT kMaxSamplesPerMP3Frame = 1152;
 
+// The packet index only needs to be fine grained enough to keep the
+// number of packets that are decoded after a seek low
+constexpr SINT kPacketIndexMinIntervalFrames = 4096;
+
+const QString kSeekIndexCacheDecoder = QStringLiteral("ffmpeg");
+
 const Logger kLogger("SoundSourceFFmpeg");
 
 // FFmpeg API Changes:
@@ -481,6 +490,9 @@ SoundSourceFFmpeg::SoundSourceFFmpeg(const QUrl& url)
           m_pavDecodedFrame(nullptr),
           m_pavResampledFrame(nullptr),
           m_seekPrerollFrameCount(0),
+          m_packetIndexMinInterval(0),
+          m_packetIndexEnabled(false),
+          m_packetIndexModified(false),
           m_avutilVersion(avutil_version()) {
     DEBUG_ASSERT(m_pavPacket);
 #if LIBAVUTIL_VERSION_INT >= AV_VERSION_INT(57, 28, 100) // FFmpeg 5.1
@@ -731,9 +743,104 @@ SoundSource::OpenResult SoundSourceFFmpeg::tryOpen(
     kLogger.debug() << "Frame buffer capacity:" << m_frameBuffer.capacity();
 #endif
 
+    restorePacketIndex();
+
     return OpenResult::Succeeded;
 }
 
+void SoundSourceFFmpeg::restorePacketIndex() {
+    m_packetIndex.clear();
+    m_packetIndexModified = false;
+    // Only demuxers that build a generic index while reading the stream
+    // lack a container index, e.g. Ogg, ADTS AAC, or MP3.
+    m_packetIndexEnabled =
+            (m_pavInputFormatContext->iformat->flags & AVFMT_GENERIC_INDEX) &&
+            m_pavInputFormatContext->pb &&
+            (m_pavInputFormatContext->pb->seekable & AVIO_SEEKABLE_NORMAL);
+    if (!m_packetIndexEnabled) {
+        return;
+    }
+    m_packetIndexMinInterval = av_rescale_q(
+            kPacketIndexMinIntervalFrames,
+            av_make_q(1, m_pavStream->codecpar->sample_rate),
+            m_pavStream->time_base);
+
+    SeekIndexCache::Index index;
+    if (!SeekIndexCache::load(
+                FileInfo(getLocalFileName()), kSeekIndexCacheDecoder, &index)) {
+        return;
+    }
+    if (index.channelCount != getSignalInfo().getChannelCount() ||
+            index.sampleRate != m_pavStream->codecpar->sample_rate ||
+            index.frameCount != frameLength()) {
+        kLogger.warning()
+                << "Ignoring packet index with different stream properties"
+                << getLocalFileName();
+        return;
+    }
+    // Seeking with AVSEEK_FLAG_BACKWARD now jumps straight to the nearest
+    // packet before the target position. The seek preroll still accounts
+    // for the decoder delay.
+    const int64_t startTime = getStreamStartTime(*m_pavStream);
+    for (const auto& entry : index.entries) {
+        av_add_index_entry(m_pavStream,
+                entry.byteOffset,
+                startTime + entry.frameIndex,
+                /*size*/ 0,
+                /*distance*/ 0,
+                AVINDEX_KEYFRAME);
+    }
+    m_packetIndex = std::move(index.entries);
+}
+
+void SoundSourceFFmpeg::addPacketIndexEntry(const AVPacket& avPacket) {
+    if (!m_packetIndexEnabled ||
+            avPacket.pos < 0 ||
+            avPacket.pts == AV_NOPTS_VALUE ||
+            !(avPacket.flags & AV_PKT_FLAG_KEY)) {
+        return;
+    }
+    const int64_t streamTime = avPacket.pts - getStreamStartTime(*m_pavStream);
+    if (streamTime < 0) {
+        // Packets before the first audible frame are never a seek target
+        return;
+    }
+    const auto next = std::lower_bound(
+            m_packetIndex.begin(),
+            m_packetIndex.end(),
+            streamTime,
+            [](const SeekIndexCache::Entry& entry, int64_t streamTime) {
+                return entry.frameIndex < streamTime;
+            });
+    if (next != m_packetIndex.end() &&
+            (next->frameIndex - streamTime < m_packetIndexMinInterval ||
+                    next->byteOffset <= avPacket.pos)) {
+        return;
+    }
+    if (next != m_packetIndex.begin() &&
+            (streamTime - (next - 1)->frameIndex < m_packetIndexMinInterval ||
+                    (next - 1)->byteOffset >= avPacket.pos)) {
+        return;
+    }
+    m_packetIndex.insert(next,
+            SeekIndexCache::Entry{static_cast<SINT>(streamTime), avPacket.pos});
+    m_packetIndexModified = true;
+}
+
+void SoundSourceFFmpeg::storePacketIndex() {
+    if (!m_packetIndexModified) {
+        return;
+    }
+    m_packetIndexModified = false;
+    SeekIndexCache::Index index;
+    index.channelCount = getSignalInfo().getChannelCount();
+    index.sampleRate = m_pavStream->codecpar->sample_rate;
+    index.bitrateKbps = getBitrate().isValid() ? static_cast<int>(getBitrate()) : 0;
+    index.frameCount = frameLength();
+    index.entries = m_packetIndex;
+    SeekIndexCache::save(FileInfo(getLocalFileName()), kSeekIndexCacheDecoder, index);
+}
+
 bool SoundSourceFFmpeg::initResampling(
         audio::ChannelCount* pResampledChannelCount,
         audio::SampleRate* pResampledSampleRate) {
@@ -866,6 +973,8 @@ bool SoundSourceFFmpeg::initResampling(
 }
 
 void SoundSourceFFmpeg::close() {
+    storePacketIndex();
+    m_packetIndex.clear();
     av_frame_free(&m_pavResampledFrame);
     DEBUG_ASSERT(!m_pavResampledFrame);
     av_frame_free(&m_pavDecodedFrame);
@@ -995,6 +1104,9 @@ bool SoundSourceFFmpeg::consumeNextAVPacket(
             m_frameBuffer.invalidate();
             return false;
         }
+        if (m_pavPacket->data) {
+            addPacketIndexEntry(*m_pavPacket);
+        }
         *ppavNextPacket = m_pavPacket;
     }
     auto* pavNextPacket = *ppavNextPacket;
@@ -8,7 +8,10 @@ extern "C" {
 
 } // extern "C"
 
+#include <vector>
+
 #include "sources/readaheadframebuffer.h"
+#include "sources/seekindexcache.h"
 #include "sources/soundsourceprovider.h"
 
 namespace mixxx {
@@ -42,6 +45,14 @@ class SoundSourceFFmpeg : public SoundSource {
     bool consumeNextAVPacket(
             AVPacket** ppavNextPacket);
 
+    // Demuxers without a container index need to bisect the stream or
+    // read it from the start for each seek. The positions of the packets
+    // that have been read are stored in the SeekIndexCache and restored
+    // into the AVStream when opening the file again.
+    void restorePacketIndex();
+    void addPacketIndexEntry(const AVPacket& avPacket);
+    void storePacketIndex();
+
     // Takes ownership of an input format context and ensures that
     // the corresponding AVFormatContext is closed, either explicitly
     // or implicitly by the destructor. The wrapper can only be
@@ -189,6 +200,13 @@ class SoundSourceFFmpeg : public SoundSource {
 
     FrameCount m_seekPrerollFrameCount;
 
+    // Ordered by both stream time and byte position. The stream time
+    // of the entries is relative to the start time of the stream.
+    std::vector<SeekIndexCache::Entry> m_packetIndex;
+    int64_t m_packetIndexMinInterval;
+    bool m_packetIndexEnabled;
+    bool m_packetIndexModified;
+
     ReadAheadFrameBuffer m_frameBuffer;
 
     const unsigned int m_avutilVersion;
@@ -1,8 +1,11 @@
 #include "sources/soundsourcemp3.h"
 #include "sources/mp3decoding.h"
+#include "sources/seekindexcache.h"
 
+#include "util/fileinfo.h"
 #include "util/logger.h"
 #include "util/math.h"
+#include "util/performancetimer.h"
 
 #include <id3tag.h>
 
@@ -90,6 +93,12 @@ constexpr SINT kMaxMp3FramesPerSecond = 39; // fixed: 1 MP3 frame = 26 ms -> ~ 1
 constexpr SINT kSeekFrameListCapacity =
         kMinutesPerFile * kSecondsPerMinute * kMaxMp3FramesPerSecond;
 
+// Only store the seek frame list of files that took noticeably long
+// to scan, e.g. long mixes or files on network shares
+constexpr Duration kMinScanDurationForSeekIndexCache = Duration::fromMillis(100);
+
+const QString kSeekIndexCacheDecoder = QStringLiteral("mad");
+
 inline QString formatHeaderFlags(int headerFlags) {
     return QString("0x%1").arg(headerFlags, 4, 16, QLatin1Char('0'));
 }
@@ -197,7 +206,8 @@ SoundSourceMp3::SoundSourceMp3(const QUrl& url)
           m_avgSeekFrameCount(0),
           m_curFrameIndex(0),
           m_madSynthCount(0),
-          m_leftoverBuffer(kMaxBytesPerMp3Frame + MAD_BUFFER_GUARD) {
+          m_leftoverBuffer(kMaxBytesPerMp3Frame + MAD_BUFFER_GUARD),
+          m_leftoverFileOffset(0) {
     m_seekFrameList.reserve(kSeekFrameListCapacity);
     initDecoding();
 }
@@ -247,6 +257,13 @@ SoundSource::OpenResult SoundSourceMp3::tryOpen(
     DEBUG_ASSERT(m_seekFrameList.empty());
     m_avgSeekFrameCount = 0;
     m_curFrameIndex = 0;
+
+    if (tryRestoreSeekFrameList()) {
+        return OpenResult::Succeeded;
+    }
+    PerformanceTimer scanTimer;
+    scanTimer.start();
+
     int headerPerSampleRate[kSampleRateCount];
     for (int i = 0; i < kSampleRateCount; ++i) {
         headerPerSampleRate[i] = 0;
@@ -485,9 +502,86 @@ SoundSource::OpenResult SoundSourceMp3::tryOpen(
         return OpenResult::Failed;
     }
 
+    if (scanTimer.elapsed() >= kMinScanDurationForSeekIndexCache) {
+        storeSeekFrameList();
+    }
+
     return OpenResult::Succeeded;
 }
 
+bool SoundSourceMp3::tryRestoreSeekFrameList() {
+    SeekIndexCache::Index index;
+    if (!SeekIndexCache::load(FileInfo(m_file), kSeekIndexCacheDecoder, &index)) {
+        return false;
+    }
+    // The index is only used if it is consistent with the mapped file
+    const audio::ChannelCount channelCount(index.channelCount);
+    const audio::SampleRate sampleRate(index.sampleRate);
+    if (index.entries.empty() ||
+            index.entries.front().frameIndex != 0 ||
+            index.entries.back().frameIndex >= index.frameCount ||
+            index.entries.back().byteOffset >= static_cast<qint64>(m_fileSize) ||
+            !channelCount.isValid() ||
+            channelCount > kChannelCountMax ||
+            getIndexBySampleRate(sampleRate) >= kSampleRateCount) {
+        kLogger.warning()
+                << "Ignoring invalid seek index of"
+                << m_file.fileName();
+        return false;
+    }
+    for (const auto& entry : index.entries) {
+        if (!m_seekFrameList.empty() &&
+                (entry.frameIndex <= m_seekFrameList.back().frameIndex ||
+                        m_pFileData + entry.byteOffset <=
+                                m_seekFrameList.back().pInputData)) {
+            kLogger.warning()
+                    << "Ignoring unordered seek index of"
+                    << m_file.fileName();
+            m_seekFrameList.clear();
+            return false;
+        }
+        addSeekFrame(entry.frameIndex, m_pFileData + entry.byteOffset);
+    }
+
+    initChannelCountOnce(channelCount);
+    initSampleRateOnce(sampleRate);
+    initFrameIndexRangeOnce(IndexRange::forward(0, index.frameCount));
+    m_avgSeekFrameCount = frameLength() / static_cast<SINT>(m_seekFrameList.size());
+    if (index.bitrateKbps > 0) {
+        initBitrateOnce(index.bitrateKbps);
+    }
+
+    // Terminate m_seekFrameList
+    addSeekFrame(index.frameCount, nullptr);
+    DEBUG_ASSERT(m_seekFrameList.back().frameIndex == frameIndexMax());
+
+    restartDecoding(m_seekFrameList.front());
+    return true;
+}
+
+void SoundSourceMp3::storeSeekFrameList() const {
+    DEBUG_ASSERT(m_seekFrameList.size() > 1);
+    const unsigned char* pLeftoverBuffer = &*m_leftoverBuffer.begin();
+    SeekIndexCache::Index index;
+    index.channelCount = getSignalInfo().getChannelCount();
+    index.sampleRate = getSignalInfo().getSampleRate();
+    index.bitrateKbps = getBitrate().isValid() ? static_cast<int>(getBitrate()) : 0;
+    index.frameCount = frameIndexMax();
+    // Without the terminating seek frame
+    index.entries.reserve(m_seekFrameList.size() - 1);
+    for (auto i = m_seekFrameList.begin(); i + 1 != m_seekFrameList.end(); ++i) {
+        // The last MP3 frame might have been decoded from the leftover
+        // buffer while scanning
+        const qint64 byteOffset =
+                (i->pInputData >= pLeftoverBuffer &&
+                        i->pInputData < pLeftoverBuffer + m_leftoverBuffer.size())
+                ? m_leftoverFileOffset + (i->pInputData - pLeftoverBuffer)
+                : i->pInputData - m_pFileData;
+        index.entries.push_back({i->frameIndex, byteOffset});
+    }
+    SeekIndexCache::save(FileInfo(m_file), kSeekIndexCacheDecoder, index);
+}
+
 void SoundSourceMp3::close() {
     finishDecoding();
 
@@ -863,6 +957,7 @@ bool SoundSourceMp3::copyLeftoverFrame() {
         const SINT leftoverBytes = remainingBytes + MAD_BUFFER_GUARD;
         if ((remainingBytes > 0) && (leftoverBytes <= SINT(m_leftoverBuffer.size()))) {
             // Copy the data of the last MP3 frame into the leftover buffer...
+            m_leftoverFileOffset = m_madStream.next_frame - m_pFileData;
             std::copy(m_madStream.next_frame,
                     m_madStream.next_frame + remainingBytes,
                     pLeftoverBuffer);
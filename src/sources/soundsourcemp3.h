@@ -58,6 +58,11 @@ class SoundSourceMp3 final : public SoundSource {
 
     bool copyLeftoverFrame();
 
+    // Restores the seek frame list and the stream properties from the
+    // SeekIndexCache instead of parsing all MP3 frame headers.
+    bool tryRestoreSeekFrameList();
+    void storeSeekFrameList() const;
+
     SINT m_curFrameIndex;
 
     // NOTE(uklotzde): Each invocation of initDecoding() must be
@@ -74,6 +79,8 @@ class SoundSourceMp3 final : public SoundSource {
     SINT m_madSynthCount; // left overs from the previous read
 
     std::vector<unsigned char> m_leftoverBuffer;
+    // The file offset of the data that has been copied into m_leftoverBuffer
+    qint64 m_leftoverFileOffset;
 };
 
 class SoundSourceProviderMp3 : public SoundSourceProvider {
@@ -0,0 +1,400 @@
+#include "sources/soundsourcepcm.h"
+
+#include <QtEndian>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "util/logger.h"
+
+namespace mixxx {
+
+namespace {
+
+const Logger kLogger("SoundSourcePcm");
+
+const QStringList kSupportedFileTypes = {
+        QStringLiteral("aiff"),
+        QStringLiteral("wav"),
+};
+
+constexpr quint16 kWavFormatPcm = 0x0001;
+constexpr quint16 kWavFormatFloat = 0x0003;
+constexpr quint16 kWavFormatExtensible = 0xFFFE;
+
+// The same normalization as libsndfile
+constexpr CSAMPLE kInt8Scale = 1.0f / 0x80;
+constexpr CSAMPLE kInt16Scale = 1.0f / 0x8000;
+constexpr CSAMPLE kInt24Scale = 1.0f / 0x800000;
+constexpr CSAMPLE kInt32Scale = 1.0f / 0x80000000u;
+
+struct PcmFormat {
+    SoundSourcePcm::Encoding encoding = SoundSourcePcm::Encoding::Int16;
+    bool bigEndian = false;
+    int channelCount = 0;
+    SINT sampleRate = 0;
+    // Only for AIFF, WAV files derive it from the size of the data
+    SINT frameCount = -1;
+    const uchar* pData = nullptr;
+    qint64 dataSize = 0;
+};
+
+bool hasId(const uchar* pChunk, const char* id) {
+    return std::memcmp(pChunk, id, 4) == 0;
+}
+
+bool encodingForBytes(int bytesPerSample, bool isSigned, SoundSourcePcm::Encoding* pEncoding) {
+    switch (bytesPerSample) {
+    case 1:
+        *pEncoding = isSigned ? SoundSourcePcm::Encoding::Int8
+                              : SoundSourcePcm::Encoding::UInt8;
+        return true;
+    case 2:
+        *pEncoding = SoundSourcePcm::Encoding::Int16;
+        return true;
+    case 3:
+        *pEncoding = SoundSourcePcm::Encoding::Int24;
+        return true;
+    case 4:
+        *pEncoding = SoundSourcePcm::Encoding::Int32;
+        return true;
+    default:
+        return false;
+    }
+}
+
+int bytesPerSample(SoundSourcePcm::Encoding encoding) {
+    switch (encoding) {
+    case SoundSourcePcm::Encoding::Int8:
+    case SoundSourcePcm::Encoding::UInt8:
+        return 1;
+    case SoundSourcePcm::Encoding::Int16:
+        return 2;
+    case SoundSourcePcm::Encoding::Int24:
+        return 3;
+    case SoundSourcePcm::Encoding::Int32:
+    case SoundSourcePcm::Encoding::Float32:
+        return 4;
+    }
+    DEBUG_ASSERT(!"unreachable");
+    return 0;
+}
+
+// RIFF/WAVE with PCM or IEEE float samples in little-endian byte order
+bool parseWav(const uchar* pFile, qint64 fileSize, PcmFormat* pFormat) {
+    if (fileSize < 12 || !hasId(pFile, "RIFF") || !hasId(pFile + 8, "WAVE")) {
+        return false;
+    }
+    bool hasFmt = false;
+    qint64 offset = 12;
+    while (offset + 8 <= fileSize) {
+        const uchar* pChunk = pFile + offset;
+        const qint64 chunkSize = qFromLittleEndian<quint32>(pChunk + 4);
+        const qint64 chunkDataOffset = offset + 8;
+        if (hasId(pChunk, "fmt ")) {
+            if (chunkSize < 16 || chunkDataOffset + chunkSize > fileSize) {
+                return false;
+            }
+            const uchar* pFmt = pChunk + 8;
+            quint16 formatTag = qFromLittleEndian<quint16>(pFmt);
+            pFormat->channelCount = qFromLittleEndian<quint16>(pFmt + 2);
+            pFormat->sampleRate = qFromLittleEndian<quint32>(pFmt + 4);
+            const int blockAlign = qFromLittleEndian<quint16>(pFmt + 12);
+            const int bitsPerSample = qFromLittleEndian<quint16>(pFmt + 14);
+            if (formatTag == kWavFormatExtensible) {
+                if (chunkSize < 40) {
+                    return false;
+                }
+                // The first two bytes of the sub format GUID
+                formatTag = qFromLittleEndian<quint16>(pFmt + 24);
+            }
+            const int bytes = (bitsPerSample + 7) / 8;
+            if (formatTag == kWavFormatPcm) {
+                // 8-bit samples are unsigned in WAV files
+                if (!encodingForBytes(bytes, bytes > 1, &pFormat->encoding)) {
+                    return false;
+                }
+            } else if (formatTag == kWavFormatFloat && bitsPerSample == 32) {
+                pFormat->encoding = SoundSourcePcm::Encoding::Float32;
+            } else {
+                return false;
+            }
+            if (pFormat->channelCount <= 0 ||
+                    blockAlign != pFormat->channelCount * bytes) {
+                return false;
+            }
+            hasFmt = true;
+        } else if (hasId(pChunk, "data")) {
+            if (!hasFmt) {
+                return false;
+            }
+            pFormat->pData = pChunk + 8;
+            // The size is not updated by some streaming encoders
+            pFormat->dataSize = std::min(chunkSize, fileSize - chunkDataOffset);
+            pFormat->bigEndian = false;
+            return true;
+        }
+        // Chunks are aligned to 2 bytes
+        offset = chunkDataOffset + chunkSize + (chunkSize & 1);
+    }
+    return false;
+}
+
+// The sample rate of AIFF files is stored as an 80-bit extended float
+double decodeExtended(const uchar* pBytes) {
+    const int exponent = ((pBytes[0] & 0x7F) << 8) | pBytes[1];
+    const quint64 mantissa = qFromBigEndian<quint64>(pBytes + 2);
+    if (exponent == 0 && mantissa == 0) {
+        return 0;
+    }
+    const double value = std::ldexp(static_cast<double>(mantissa), exponent - 16383 - 63);
+    return (pBytes[0] & 0x80) ? -value : value;
+}
+
+// AIFF and uncompressed AIFF-C with big-endian or little-endian ("sowt")
+// integer or 32-bit float samples
+bool parseAiff(const uchar* pFile, qint64 fileSize, PcmFormat* pFormat) {
+    if (fileSize < 12 || !hasId(pFile, "FORM")) {
+        return false;
+    }
+    const bool aifc = hasId(pFile + 8, "AIFC");
+    if (!aifc && !hasId(pFile + 8, "AIFF")) {
+        return false;
+    }
+    bool hasComm = false;
+    int bitsPerSample = 0;
+    qint64 offset = 12;
+    const uchar* pSoundData = nullptr;
+    qint64 soundDataSize = 0;
+    while (offset + 8 <= fileSize) {
+        const uchar* pChunk = pFile + offset;
+        const qint64 chunkSize = qFromBigEndian<quint32>(pChunk + 4);
+        const qint64 chunkDataOffset = offset + 8;
+        if (hasId(pChunk, "COMM")) {
+            if (chunkSize < 18 || chunkDataOffset + chunkSize > fileSize) {
+                return false;
+            }
+            const uchar* pComm = pChunk + 8;
+            pFormat->channelCount = qFromBigEndian<quint16>(pComm);
+            pFormat->frameCount = qFromBigEndian<quint32>(pComm + 2);
+            bitsPerSample = qFromBigEndian<quint16>(pComm + 6);
+            pFormat->sampleRate = static_cast<SINT>(std::lround(decodeExtended(pComm + 8)));
+            pFormat->bigEndian = true;
+            if (!encodingForBytes((bitsPerSample + 7) / 8, true, &pFormat->encoding)) {
+                return false;
+            }
+            if (aifc) {
+                if (chunkSize < 22) {
+                    return false;
+                }
+                const uchar* pCompressionType = pComm + 18;
+                if (hasId(pCompressionType, "sowt")) {
+                    pFormat->bigEndian = false;
+                } else if (hasId(pCompressionType, "fl32") ||
+                        hasId(pCompressionType, "FL32")) {
+                    pFormat->encoding = SoundSourcePcm::Encoding::Float32;
+                } else if (!hasId(pCompressionType, "NONE")) {
+                    return false;
+                }
+            }
+            hasComm = true;
+        } else if (hasId(pChunk, "SSND")) {
+            if (chunkSize < 8 || chunkDataOffset + 8 > fileSize) {
+                return false;
+            }
+            const qint64 dataOffset = qFromBigEndian<quint32>(pChunk + 8);
+            const qint64 dataStart = chunkDataOffset + 8 + dataOffset;
+            if (dataStart > fileSize) {
+                return false;
+            }
+            pSoundData = pFile + dataStart;
+            soundDataSize = std::min(chunkSize - 8 - dataOffset, fileSize - dataStart);
+        }
+        offset = chunkDataOffset + chunkSize + (chunkSize & 1);
+    }
+    if (!hasComm || !pSoundData || pFormat->channelCount <= 0) {
+        return false;
+    }
+    pFormat->pData = pSoundData;
+    pFormat->dataSize = soundDataSize;
+    return true;
+}
+
+template<typename T>
+inline T fromByteOrder(const uchar* pBytes, bool bigEndian) {
+    return bigEndian ? qFromBigEndian<T>(pBytes) : qFromLittleEndian<T>(pBytes);
+}
+
+// The loops are kept simple to allow the compiler to vectorize them
+void convertSamples(
+        CSAMPLE* pOut,
+        const uchar* pIn,
+        SINT sampleCount,
+        SoundSourcePcm::Encoding encoding,
+        bool bigEndian) {
+    switch (encoding) {
+    case SoundSourcePcm::Encoding::Int8:
+        for (SINT i = 0; i < sampleCount; ++i) {
+            pOut[i] = static_cast<qint8>(pIn[i]) * kInt8Scale;
+        }
+        return;
+    case SoundSourcePcm::Encoding::UInt8:
+        for (SINT i = 0; i < sampleCount; ++i) {
+            pOut[i] = (static_cast<int>(pIn[i]) - 0x80) * kInt8Scale;
+        }
+        return;
+    case SoundSourcePcm::Encoding::Int16:
+        if (bigEndian) {
+            for (SINT i = 0; i < sampleCount; ++i) {
+                pOut[i] = qFromBigEndian<qint16>(pIn + 2 * i) * kInt16Scale;
+            }
+        } else {
+            for (SINT i = 0; i < sampleCount; ++i) {
+                pOut[i] = qFromLittleEndian<qint16>(pIn + 2 * i) * kInt16Scale;
+            }
+        }
+        return;
+    case SoundSourcePcm::Encoding::Int24:
+        for (SINT i = 0; i < sampleCount; ++i) {
+            const uchar* pSample = pIn + 3 * i;
+            const uchar msb = bigEndian ? pSample[0] : pSample[2];
+            const uchar lsb = bigEndian ? pSample[2] : pSample[0];
+            // Place the sign bit in the most significant bit
+            const auto value = static_cast<qint32>(
+                    (static_cast<quint32>(msb) << 24) |
+                    (static_cast<quint32>(pSample[1]) << 16) |
+                    (static_cast<quint32>(lsb) << 8));
+            pOut[i] = (value / 256) * kInt24Scale;
+        }
+        return;
+    case SoundSourcePcm::Encoding::Int32:
+        for (SINT i = 0; i < sampleCount; ++i) {
+            pOut[i] = fromByteOrder<qint32>(pIn + 4 * i, bigEndian) * kInt32Scale;
+        }
+        return;
+    case SoundSourcePcm::Encoding::Float32:
+        if (bigEndian == (Q_BYTE_ORDER == Q_BIG_ENDIAN)) {
+            std::memcpy(pOut, pIn, sampleCount * sizeof(CSAMPLE));
+        } else {
+            for (SINT i = 0; i < sampleCount; ++i) {
+                const quint32 bits = fromByteOrder<quint32>(pIn + 4 * i, bigEndian);
+                std::memcpy(pOut + i, &bits, sizeof(CSAMPLE));
+            }
+        }
+        return;
+    }
+    DEBUG_ASSERT(!"unreachable");
+}
+
+} // anonymous namespace
+
+//static
+const QString SoundSourceProviderPcm::kDisplayName = QStringLiteral("Memory-mapped PCM");
+
+QStringList SoundSourceProviderPcm::getSupportedFileTypes() const {
+    return kSupportedFileTypes;
+}
+
+SoundSourceProviderPriority SoundSourceProviderPcm::getPriorityHint(
+        const QString& supportedFileType) const {
+    Q_UNUSED(supportedFileType)
+    // Preferred over libsndfile, which remains the fallback for
+    // all other encodings
+    return SoundSourceProviderPriority::Higher;
+}
+
+SoundSourcePcm::SoundSourcePcm(const QUrl& url)
+        : SoundSource(url),
+          m_pData(nullptr),
+          m_encoding(Encoding::Int16),
+          m_bigEndian(false),
+          m_bytesPerFrame(0) {
+}
+
+SoundSourcePcm::~SoundSourcePcm() {
+    close();
+}
+
+SoundSource::OpenResult SoundSourcePcm::tryOpen(
+        OpenMode /*mode*/,
+        const OpenParams& /*params*/) {
+    DEBUG_ASSERT(!m_pData);
+    m_file.setFileName(getLocalFileName());
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        kLogger.warning()
+                << "Failed to open file"
+                << getUrlString()
+                << m_file.errorString();
+        return OpenResult::Failed;
+    }
+    const qint64 fileSize = m_file.size();
+    const uchar* pFile = m_file.map(0, fileSize);
+    if (!pFile) {
+        // e.g. exceeds the address space, libsndfile might still read it
+        kLogger.info()
+                << "Failed to map file"
+                << getUrlString()
+                << m_file.errorString();
+        m_file.close();
+        return OpenResult::Aborted;
+    }
+
+    PcmFormat format;
+    if (!parseWav(pFile, fileSize, &format) &&
+            !parseAiff(pFile, fileSize, &format)) {
+        // Compressed or unknown encoding
+        m_file.unmap(const_cast<uchar*>(pFile));
+        m_file.close();
+        return OpenResult::Aborted;
+    }
+
+    m_pData = format.pData;
+    m_encoding = format.encoding;
+    m_bigEndian = format.bigEndian;
+    m_bytesPerFrame = format.channelCount * bytesPerSample(format.encoding);
+    SINT frameCount = static_cast<SINT>(format.dataSize / m_bytesPerFrame);
+    if (format.frameCount >= 0) {
+        frameCount = std::min(frameCount, format.frameCount);
+    }
+
+    initChannelCountOnce(format.channelCount);
+    initSampleRateOnce(format.sampleRate);
+    initFrameIndexRangeOnce(IndexRange::forward(0, frameCount));
+    if (!getSignalInfo().isValid()) {
+        kLogger.warning()
+                << "Invalid signal"
+                << getSignalInfo()
+                << getUrlString();
+        return OpenResult::Failed;
+    }
+
+    return OpenResult::Succeeded;
+}
+
+void SoundSourcePcm::close() {
+    if (m_file.isOpen()) {
+        // Unmaps the file
+        m_file.close();
+    }
+    m_pData = nullptr;
+}
+
+ReadableSampleFrames SoundSourcePcm::readSampleFramesClamped(
+        const WritableSampleFrames& writableSampleFrames) {
+    DEBUG_ASSERT(m_pData);
+    const auto frameIndexRange = writableSampleFrames.frameIndexRange();
+    const SINT sampleCount = getSignalInfo().frames2samples(frameIndexRange.length());
+    // Seeking is just an offset into the mapped file
+    convertSamples(writableSampleFrames.writableData(),
+            m_pData + frameIndexRange.start() * m_bytesPerFrame,
+            sampleCount,
+            m_encoding,
+            m_bigEndian);
+    return ReadableSampleFrames(
+            frameIndexRange,
+            SampleBuffer::ReadableSlice(
+                    writableSampleFrames.writableData(),
+                    sampleCount));
+}
+
+} // namespace mixxx
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <QFile>
+
+#include "sources/soundsourceprovider.h"
+
+namespace mixxx {
+
+/// Reads uncompressed PCM samples from WAV and AIFF files without a
+/// decoder. The whole file is mapped into memory, i.e. seeking is free
+/// and reading only converts the samples into floating point values.
+///
+/// Files with a compressed or otherwise unsupported encoding are rejected
+/// and left to the other providers for the same file types.
+class SoundSourcePcm final : public SoundSource {
+  public:
+    /// The encodings of the samples in the file
+    enum class Encoding {
+        Int8,
+        UInt8,
+        Int16,
+        Int24,
+        Int32,
+        Float32,
+    };
+
+    explicit SoundSourcePcm(const QUrl& url);
+    ~SoundSourcePcm() override;
+
+    void close() override;
+
+  protected:
+    ReadableSampleFrames readSampleFramesClamped(
+            const WritableSampleFrames& sampleFrames) override;
+
+  private:
+    OpenResult tryOpen(
+            OpenMode mode,
+            const OpenParams& params) override;
+
+    QFile m_file;
+    const uchar* m_pData;
+    Encoding m_encoding;
+    bool m_bigEndian;
+    SINT m_bytesPerFrame;
+};
+
+class SoundSourceProviderPcm : public SoundSourceProvider {
+  public:
+    static const QString kDisplayName;
+
+    QString getDisplayName() const override {
+        return kDisplayName;
+    }
+
+    QStringList getSupportedFileTypes() const override;
+
+    SoundSourceProviderPriority getPriorityHint(
+            const QString& supportedFileType) const override;
+
+    SoundSourcePointer newSoundSource(const QUrl& url) override {
+        return newSoundSourceFromUrl<SoundSourcePcm>(url);
+    }
+};
+
+} // namespace mixxx
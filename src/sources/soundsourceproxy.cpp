@@ -17,6 +17,7 @@
 #ifdef __COREAUDIO__
 #include "sources/soundsourcecoreaudio.h"
 #endif
+#include "sources/soundsourcepcm.h"
 #ifdef __SNDFILE__
 #include "sources/soundsourcesndfile.h"
 #endif
@@ -38,6 +39,7 @@
 #endif
 
 #include "library/coverartutils.h"
+#include "library/trackmetadatawritebackqueue.h"
 #include "track/globaltrackcache.h"
 #include "track/track.h"
 #include "util/logger.h"
@@ -224,6 +226,10 @@ bool SoundSourceProxy::registerProviders() {
             &s_soundSourceProviders,
             std::make_shared<mixxx::SoundSourceProviderSndFile>());
 #endif
+    // Uncompressed WAV/AIFF files don't need a decoder
+    registerSoundSourceProvider(
+            &s_soundSourceProviders,
+            std::make_shared<mixxx::SoundSourceProviderPcm>());
     // Register the high-priority reference providers AFTER all other
     // providers to verify that their priorities are correct.
     registerReferenceSoundSourceProviders(&s_soundSourceProviders);
@@ -365,10 +371,8 @@ SoundSourceProxy::allProviderRegistrationsForUrl(
 }
 
 //static
-ExportTrackMetadataResult
-SoundSourceProxy::exportTrackMetadataBeforeSaving(
-        Track* pTrack,
-        const SyncTrackMetadataParams& syncParams) {
+mixxx::SoundSourcePointer SoundSourceProxy::openMetadataSourceBeforeSaving(
+        Track* pTrack) {
     DEBUG_ASSERT(pTrack);
     const auto fileInfo = pTrack->getFileInfo();
     mixxx::SoundSourcePointer pSoundSource;
@@ -392,7 +396,7 @@ SoundSourceProxy::exportTrackMetadataBeforeSaving(
                 kLogger.warning()
                         << "Failed to update stream info from audio "
                            "source before exporting metadata";
-                return ExportTrackMetadataResult::Failed;
+                return nullptr;
             }
         }
         pSoundSource = proxy.m_pSoundSource;
@@ -401,11 +405,50 @@ SoundSourceProxy::exportTrackMetadataBeforeSaving(
         kLogger.warning()
                 << "Unable to export track metadata into file"
                 << fileInfo;
+    }
+    return pSoundSource;
+}
+
+//static
+ExportTrackMetadataResult
+SoundSourceProxy::exportTrackMetadataBeforeSaving(
+        Track* pTrack,
+        const SyncTrackMetadataParams& syncParams) {
+    const auto pSoundSource = openMetadataSourceBeforeSaving(pTrack);
+    if (!pSoundSource) {
         return ExportTrackMetadataResult::Failed;
     }
     return pTrack->exportMetadata(*pSoundSource, syncParams);
 }
 
+//static
+ExportTrackMetadataResult
+SoundSourceProxy::prepareTrackMetadataExportBeforeSaving(
+        Track* pTrack,
+        const SyncTrackMetadataParams& syncParams,
+        mixxx::TrackMetadata* pExportMetadata) {
+    const auto pSoundSource = openMetadataSourceBeforeSaving(pTrack);
+    if (!pSoundSource) {
+        return ExportTrackMetadataResult::Failed;
+    }
+    return pTrack->prepareMetadataExport(*pSoundSource, syncParams, pExportMetadata);
+}
+
+//static
+std::pair<mixxx::MetadataSource::ExportResult, QDateTime>
+SoundSourceProxy::exportTrackMetadata(
+        const mixxx::FileInfo& fileInfo,
+        const mixxx::TrackMetadata& trackMetadata) {
+    const auto proxy = SoundSourceProxy(fileInfo.toQUrl());
+    if (!proxy.m_pSoundSource) {
+        kLogger.warning()
+                << "Unable to export track metadata into file"
+                << fileInfo;
+        return std::make_pair(mixxx::MetadataSource::ExportResult::Failed, QDateTime());
+    }
+    return proxy.m_pSoundSource->exportTrackMetadata(trackMetadata);
+}
+
 // Used during tests only
 SoundSourceProxy::SoundSourceProxy(
         TrackPointer pTrack,
@@ -484,6 +527,10 @@ SoundSourceProxy::nextProviderWithOpenMode(
 void SoundSourceProxy::findProviderAndInitSoundSource() {
     DEBUG_ASSERT(!m_pProvider);
     DEBUG_ASSERT(!m_pSoundSource);
+    if (m_url.isLocalFile()) {
+        // Never read a file while its tags are pending to be written
+        TrackMetadataWriteBackQueue::waitForFile(m_url.toLocalFile());
+    }
     for (m_providerRegistrationIndex = 0;
             m_providerRegistrationIndex < m_providerRegistrations.size();
             ++m_providerRegistrationIndex) {
@@ -570,6 +617,39 @@ SoundSourceProxy::importTrackMetadataAndCoverImageFromFile(
             resetMissingTagMetadata);
 }
 
+//static
+std::optional<SoundSourceProxy::PrefetchedTrackMetadata>
+SoundSourceProxy::prefetchTrackMetadataFromFile(
+        mixxx::FileAccess trackFileAccess) {
+    PrefetchedTrackMetadata prefetched;
+    if (!trackFileAccess.info().checkFileExists()) {
+        return prefetched;
+    }
+    {
+        TrackPointer pCachedTrack;
+        GlobalTrackCacheLocker locker;
+        pCachedTrack = locker.lookupTrackByRef(TrackRef::fromFileInfo(trackFileAccess.info()));
+        locker.unlockCache();
+        if (pCachedTrack) {
+            // Metadata of cached tracks might be exported at any time
+            return std::nullopt;
+        }
+    }
+    // Only metadata of cached tracks is exported into files. In the
+    // unlikely case that a track object for this file is created and
+    // modified after unlocking the cache the prefetched metadata is
+    // discarded, because the track object is no longer new.
+    std::tie(prefetched.importResult, prefetched.sourceSynchronizedAt) =
+            SoundSourceProxy(Track::newTemporary(std::move(trackFileAccess)))
+                    .importTrackMetadataAndCoverImage(
+                            &prefetched.trackMetadata,
+                            &prefetched.coverImage,
+                            // The imported metadata replaces the empty
+                            // metadata of a new track object
+                            false);
+    return prefetched;
+}
+
 std::pair<mixxx::MetadataSource::ImportResult, QDateTime>
 SoundSourceProxy::importTrackMetadataAndCoverImage(
         mixxx::TrackMetadata* pTrackMetadata,
@@ -615,7 +695,8 @@ inline bool shouldImportSeratoTagsFromSource(
 
 SoundSourceProxy::UpdateTrackFromSourceResult SoundSourceProxy::updateTrackFromSource(
         UpdateTrackFromSourceMode mode,
-        const SyncTrackMetadataParams& syncParams) {
+        const SyncTrackMetadataParams& syncParams,
+        const PrefetchedTrackMetadata* pPrefetchedMetadata) {
     DEBUG_ASSERT(m_pTrack);
 
     if (getUrl().isEmpty()) {
@@ -687,11 +768,24 @@ SoundSourceProxy::UpdateTrackFromSourceResult SoundSourceProxy::updateTrackFromS
 
     // Parse the tags stored in the audio file and the date and time when the
     // file has been last modified to detect future changes of the tags.
-    auto [metadataImportResult, sourceSynchronizedAt] =
-            importTrackMetadataAndCoverImage(
-                    &trackMetadata,
-                    pCoverImg,
-                    syncParams.resetMissingTagMetadataOnImport);
+    std::pair<mixxx::MetadataSource::ImportResult, QDateTime> importResult;
+    if (pPrefetchedMetadata &&
+            sourceSyncStatus == mixxx::TrackRecord::SourceSyncStatus::Void &&
+            pCoverImg) {
+        // The prefetched metadata has been imported into empty metadata
+        // that is equal to the metadata of a new track object
+        trackMetadata = pPrefetchedMetadata->trackMetadata;
+        *pCoverImg = pPrefetchedMetadata->coverImage;
+        importResult = std::make_pair(
+                pPrefetchedMetadata->importResult,
+                pPrefetchedMetadata->sourceSynchronizedAt);
+    } else {
+        importResult = importTrackMetadataAndCoverImage(
+                &trackMetadata,
+                pCoverImg,
+                syncParams.resetMissingTagMetadataOnImport);
+    }
+    auto [metadataImportResult, sourceSynchronizedAt] = importResult;
     VERIFY_OR_DEBUG_ASSERT(!sourceSynchronizedAt.isValid() ||
             sourceSynchronizedAt.timeSpec() == Qt::UTC) {
         qWarning() << "Converting source synchronization time to UTC:" << sourceSynchronizedAt;
@@ -840,9 +934,13 @@ SoundSourceProxy::UpdateTrackFromSourceResult SoundSourceProxy::updateTrackFromS
     }
 
     if (pCoverImg) {
-        // If the pointer is not null then the cover art should be guessed
+        // If the pointer is not null then the cover art should be guessed.
+        // The guesser is reused by all tracks that are imported on the same
+        // thread, e.g. the tracks of an album during a library scan, so the
+        // folder is only listed and the folder image only loaded once.
+        thread_local CoverInfoGuesser t_coverInfoGuesser;
         auto coverInfo =
-                CoverInfoGuesser().guessCoverInfo(
+                t_coverInfoGuesser.guessCoverInfo(
                         m_pTrack->getFileInfo(),
                         m_pTrack->getAlbum(),
                         *pCoverImg);
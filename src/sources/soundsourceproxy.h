@@ -1,9 +1,12 @@
 #pragma once
 
+#include <QImage>
 #include <QMimeType>
+#include <optional>
 
 #include "sources/soundsourceproviderregistry.h"
 #include "track/track_decl.h"
+#include "track/trackmetadata.h"
 
 namespace mixxx {
 
@@ -121,6 +124,28 @@ class SoundSourceProxy {
             QImage* pCoverImage,
             bool resetMissingTagMetadata) const;
 
+    /// Track metadata and embedded cover art that have been imported
+    /// from a file in advance, i.e. before a track object is created.
+    struct PrefetchedTrackMetadata {
+        mixxx::MetadataSource::ImportResult importResult =
+                mixxx::MetadataSource::ImportResult::Unavailable;
+        QDateTime sourceSynchronizedAt;
+        mixxx::TrackMetadata trackMetadata;
+        QImage coverImage;
+    };
+
+    /// Import track metadata and embedded cover art of a new file that
+    /// is not yet referenced by any track object, e.g. by multiple worker
+    /// threads of the library scanner in parallel.
+    ///
+    /// Unlike importTrackMetadataAndCoverImageFromFile() the GlobalTrackCache
+    /// is not kept locked while reading. Returns std::nullopt if the file
+    /// is currently cached and might be written concurrently. The result
+    /// must only be passed to updateTrackFromSource() for a newly created
+    /// track object, that has been created after this function returned.
+    static std::optional<PrefetchedTrackMetadata> prefetchTrackMetadataFromFile(
+            mixxx::FileAccess trackFileAccess);
+
     /// Controls which (metadata/coverart) and how tags are (re-)imported from
     /// audio files when creating a SoundSourceProxy.
     ///
@@ -172,10 +197,15 @@ class SoundSourceProxy {
     /// properly. The application log will contain warning messages for a detailed
     /// analysis in case unexpected behavior has been reported.
     ///
+    /// Metadata that has been prefetched from the file is used instead of
+    /// reading the file again, but only for the initial import of a new
+    /// track object. Otherwise it is ignored.
+    ///
     /// Returns true if the track has been modified and false otherwise.
     UpdateTrackFromSourceResult updateTrackFromSource(
             UpdateTrackFromSourceMode mode,
-            const SyncTrackMetadataParams& syncParams);
+            const SyncTrackMetadataParams& syncParams,
+            const PrefetchedTrackMetadata* pPrefetchedMetadata = nullptr);
 
     /// Opening the audio source through the proxy will update the
     /// audio properties of the corresponding track object. Returns
@@ -201,9 +231,22 @@ class SoundSourceProxy {
     static QHash<QMimeType, QString> s_fileTypeByMimeType;
 
     friend class TrackCollectionManager;
+    friend class TrackMetadataWriteBackQueue;
+    static mixxx::SoundSourcePointer openMetadataSourceBeforeSaving(
+            Track* pTrack);
     static ExportTrackMetadataResult exportTrackMetadataBeforeSaving(
             Track* pTrack,
             const SyncTrackMetadataParams& syncParams);
+    /// Like exportTrackMetadataBeforeSaving() but only prepares the
+    /// metadata that needs to be written with exportTrackMetadata().
+    static ExportTrackMetadataResult prepareTrackMetadataExportBeforeSaving(
+            Track* pTrack,
+            const SyncTrackMetadataParams& syncParams,
+            mixxx::TrackMetadata* pExportMetadata);
+    /// Writes the metadata into the file tags without a Track object
+    static std::pair<mixxx::MetadataSource::ExportResult, QDateTime> exportTrackMetadata(
+            const mixxx::FileInfo& fileInfo,
+            const mixxx::TrackMetadata& trackMetadata);
 
     // Special case: Construction from a url is needed
     // for writing metadata immediately before the TIO is destroyed.
@@ -0,0 +1,86 @@
+#include <gtest/gtest.h>
+
+#include "soundio/adaptivebuffersize.h"
+
+namespace {
+
+constexpr unsigned int kConfiguredIndex = 3;
+constexpr unsigned int kMaxIndex = 7;
+
+class AdaptiveBufferSizeTest : public ::testing::Test {
+  protected:
+    AdaptiveBufferSizeTest()
+            : m_adaptive(kConfiguredIndex, kMaxIndex) {
+    }
+
+    // Simulates seconds without xruns
+    unsigned int runQuiet(int seconds, double load) {
+        unsigned int target = m_adaptive.currentIndex();
+        for (int i = 0; i < seconds; ++i) {
+            target = m_adaptive.update(0, load);
+        }
+        return target;
+    }
+
+    AdaptiveBufferSize m_adaptive;
+};
+
+TEST_F(AdaptiveBufferSizeTest, singleXrunKeepsSize) {
+    EXPECT_EQ(kConfiguredIndex, m_adaptive.update(1, 0.5));
+    EXPECT_EQ(kConfiguredIndex, runQuiet(10, 0.5));
+}
+
+TEST_F(AdaptiveBufferSizeTest, stepsUpAfterRepeatedXruns) {
+    m_adaptive.update(1, 0.9);
+    runQuiet(5, 0.9);
+    m_adaptive.update(1, 0.9);
+    EXPECT_EQ(kConfiguredIndex + 1, m_adaptive.update(1, 0.9));
+
+    // Stays pending until it has been applied
+    EXPECT_EQ(kConfiguredIndex + 1, m_adaptive.update(5, 0.9));
+    EXPECT_EQ(kConfiguredIndex, m_adaptive.currentIndex());
+    m_adaptive.setCurrentIndex(kConfiguredIndex + 1);
+    EXPECT_EQ(kConfiguredIndex + 1, m_adaptive.update(0, 0.5));
+}
+
+TEST_F(AdaptiveBufferSizeTest, xrunsOutsideWindowAreForgotten) {
+    m_adaptive.update(1, 0.9);
+    m_adaptive.update(1, 0.9);
+    runQuiet(AdaptiveBufferSize::kXrunWindowSeconds, 0.9);
+    EXPECT_EQ(kConfiguredIndex, m_adaptive.update(1, 0.9));
+}
+
+TEST_F(AdaptiveBufferSizeTest, neverExceedsMaximum) {
+    m_adaptive.setCurrentIndex(kMaxIndex);
+    for (int i = 0; i < 10; ++i) {
+        EXPECT_EQ(kMaxIndex, m_adaptive.update(2, 1.0));
+    }
+}
+
+TEST_F(AdaptiveBufferSizeTest, stepsDownWithHeadroom) {
+    m_adaptive.setCurrentIndex(kConfiguredIndex + 1);
+    EXPECT_EQ(kConfiguredIndex + 1,
+            runQuiet(AdaptiveBufferSize::kHeadroomSeconds - 1, 0.2));
+    EXPECT_EQ(kConfiguredIndex, m_adaptive.update(0, 0.2));
+
+    // Never below the configured size
+    m_adaptive.setCurrentIndex(kConfiguredIndex);
+    EXPECT_EQ(kConfiguredIndex,
+            runQuiet(AdaptiveBufferSize::kHeadroomSeconds * 2, 0.1));
+}
+
+TEST_F(AdaptiveBufferSizeTest, highLoadPreventsStepDown) {
+    m_adaptive.setCurrentIndex(kConfiguredIndex + 1);
+    runQuiet(10, 0.6);
+    EXPECT_EQ(kConfiguredIndex + 1,
+            runQuiet(AdaptiveBufferSize::kHeadroomSeconds, 0.2));
+}
+
+TEST_F(AdaptiveBufferSizeTest, reconfigurationResets) {
+    m_adaptive.setCurrentIndex(kConfiguredIndex + 2);
+    m_adaptive.setConfiguredIndex(2);
+    EXPECT_EQ(2u, m_adaptive.configuredIndex());
+    EXPECT_EQ(2u, m_adaptive.currentIndex());
+}
+
+} // namespace
@@ -2,12 +2,18 @@
 
 #include <QDir>
 #include <QtDebug>
+#include <algorithm>
+#include <cmath>
 #include <vector>
 
 #include "analyzer/analyzertrack.h"
 #include "analyzer/analyzerwaveform.h"
+#include "analyzer/waveformbandfilters.h"
+#include "engine/filters/enginefilterbessel4.h"
 #include "library/dao/analysisdao.h"
+#include "sources/soundsourceproxy.h"
 #include "test/mixxxtest.h"
+#include "test/soundsourceproviderregistration.h"
 #include "track/track.h"
 
 namespace {
@@ -129,4 +135,130 @@ TEST_F(AnalyzerWaveformTest, canary) {
     EXPECT_DOUBLE_EQ(pWaveformSummary->getAudioVisualRatio(), 1.0);
 }
 
+// The band filters must produce exactly the same output as the filters
+// that are applied sample by sample. Otherwise the reference waveforms
+// would change.
+TEST_F(AnalyzerWaveformTest, bandFiltersMatchEngineFilters) {
+    constexpr int kSampleRate = 44100;
+    constexpr SINT kNumSamples = 2 * 4096;
+    std::vector<CSAMPLE> input(kNumSamples);
+    for (SINT i = 0; i < kNumSamples; ++i) {
+        // A mix of a low and a high frequency with different
+        // amplitudes for both channels
+        input[i] = static_cast<CSAMPLE>((i % 2 == 0 ? 0.8 : 0.5) *
+                        std::sin(i * 0.01) +
+                0.2 * std::sin(i * 1.3));
+    }
+
+    EngineFilterBessel4Low low(kSampleRate, WaveformBandFilters::kLowMidCornerHz);
+    EngineFilterBessel4Band mid(kSampleRate,
+            WaveformBandFilters::kLowMidCornerHz,
+            WaveformBandFilters::kMidHighCornerHz);
+    EngineFilterBessel4High high(kSampleRate, WaveformBandFilters::kMidHighCornerHz);
+    low.assumeSettled();
+    mid.assumeSettled();
+    high.assumeSettled();
+    std::vector<CSAMPLE> expected[FilterCount];
+    for (auto& buffer : expected) {
+        buffer.resize(kNumSamples);
+    }
+    low.process(input.data(), expected[Low].data(), kNumSamples);
+    mid.process(input.data(), expected[Mid].data(), kNumSamples);
+    high.process(input.data(), expected[High].data(), kNumSamples);
+
+    WaveformBandFilters filters(mixxx::audio::SampleRate(kSampleRate));
+    std::vector<CSAMPLE> actual[FilterCount];
+    for (auto& buffer : actual) {
+        buffer.resize(kNumSamples);
+    }
+    // The state is kept between the chunks
+    constexpr SINT kChunkSize = 2 * 1000;
+    for (SINT i = 0; i < kNumSamples; i += kChunkSize) {
+        filters.process(&input[i],
+                &actual[Low][i],
+                &actual[Mid][i],
+                &actual[High][i],
+                std::min(kChunkSize, kNumSamples - i));
+    }
+
+    for (int f = 0; f < FilterCount; ++f) {
+        SCOPED_TRACE(f);
+        for (SINT i = 0; i < kNumSamples; ++i) {
+            ASSERT_EQ(expected[f][i], actual[f][i]) << "i = " << i;
+        }
+    }
+}
+
+// Strides that span multiple buffers must give the same result
+// as processing everything at once.
+TEST_F(AnalyzerWaveformTest, chunkedProcessing) {
+    for (std::size_t i = kCanarySize; i < kCanarySize + kBigBufSize; i++) {
+        m_canaryBigBuf[i] = static_cast<CSAMPLE>(std::sin(i * 0.05) * (i % 7) / 7.0);
+    }
+
+    m_aw.initialize(AnalyzerTrack(m_pTrack),
+            m_pTrack->getSampleRate(),
+            kBigBufSize / kChannelCount);
+    m_aw.processSamples(&m_canaryBigBuf[kCanarySize], kBigBufSize);
+    m_aw.storeResults(m_pTrack);
+    m_aw.cleanup();
+    const QByteArray expected = m_pTrack->getWaveform()->toByteArray();
+
+    TrackPointer pTrack = Track::newTemporary();
+    pTrack->setAudioProperties(
+            mixxx::audio::ChannelCount(kChannelCount),
+            mixxx::audio::SampleRate(44100),
+            mixxx::audio::Bitrate(),
+            mixxx::Duration::fromMillis(1000));
+    m_aw.initialize(AnalyzerTrack(pTrack),
+            pTrack->getSampleRate(),
+            kBigBufSize / kChannelCount);
+    // An odd number of frames that is not a multiple of the stride
+    constexpr std::size_t kChunkSize = 2 * 37;
+    for (std::size_t i = 0; i < kBigBufSize; i += kChunkSize) {
+        m_aw.processSamples(&m_canaryBigBuf[kCanarySize + i],
+                std::min(kChunkSize, kBigBufSize - i));
+    }
+    m_aw.storeResults(pTrack);
+    m_aw.cleanup();
+
+    EXPECT_EQ(expected, pTrack->getWaveform()->toByteArray());
+}
+
+class AnalyzerWaveformPreviewTest : public MixxxTest, SoundSourceProviderRegistration {
+  protected:
+    AnalyzerWaveformPreviewTest()
+            : m_aw(config(), QSqlDatabase()) {
+    }
+
+    AnalyzerWaveform m_aw;
+};
+
+TEST_F(AnalyzerWaveformPreviewTest, previewIsReplaced) {
+    const TrackPointer pTrack = Track::newTemporary(
+            getTestDir().filePath(QStringLiteral("id3-test-data/cover-test.wav")));
+    mixxx::AudioSource::OpenParams openParams;
+    openParams.setChannelCount(mixxx::audio::ChannelCount(kChannelCount));
+    const auto pAudioSource = SoundSourceProxy(pTrack).openAudioSource(openParams);
+    ASSERT_NE(nullptr, pAudioSource);
+    const auto sampleRate = pAudioSource->getSignalInfo().getSampleRate();
+    const SINT frameLength = pAudioSource->frameLength();
+
+    AnalyzerTrack::Options options;
+    options.withWaveformPreview = true;
+    ASSERT_TRUE(m_aw.initialize(AnalyzerTrack(pTrack, options), sampleRate, frameLength));
+    const ConstWaveformPointer pPreview = pTrack->getWaveform();
+    ASSERT_NE(nullptr, pPreview);
+    ASSERT_NE(nullptr, pTrack->getWaveformSummary());
+    // The preview is shown completely right away
+    EXPECT_EQ(pPreview->getDataSize(), pPreview->getCompletion());
+    EXPECT_EQ(Waveform::SaveState::NotSaved, pPreview->saveState());
+    m_aw.cleanup();
+
+    // The preview of a cancelled analysis doesn't count as a waveform
+    ASSERT_TRUE(m_aw.initialize(AnalyzerTrack(pTrack), sampleRate, frameLength));
+    EXPECT_NE(pPreview, pTrack->getWaveform());
+    m_aw.cleanup();
+}
+
 } // namespace
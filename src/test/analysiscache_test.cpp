@@ -0,0 +1,90 @@
+#include "analyzer/analysiscache.h"
+
+#include <gtest/gtest.h>
+
+#include "analyzer/analyzertrack.h"
+#include "sources/soundsourceproxy.h"
+#include "test/mixxxdbtest.h"
+#include "track/beats.h"
+#include "track/keyfactory.h"
+#include "track/track.h"
+
+namespace {
+
+constexpr mixxx::audio::SampleRate kSampleRate = mixxx::audio::SampleRate(44100);
+
+class AnalysisCacheTest : public MixxxDbTest {
+  protected:
+    AnalysisCacheTest()
+            : MixxxDbTest(true),
+              m_analysisCache(config(), dbConnection()) {
+    }
+
+    QByteArray fingerprint(const QString& fileName) const {
+        const auto pTrack = Track::newTemporary(
+                getTestDir().filePath(QStringLiteral("id3-test-data/") + fileName));
+        const auto pAudioSource = SoundSourceProxy(pTrack).openAudioSource();
+        EXPECT_TRUE(pAudioSource);
+        return pAudioSource ? AnalysisCache::fingerprint(pAudioSource) : QByteArray();
+    }
+
+    static TrackPointer newTrack(TrackId trackId) {
+        TrackPointer pTrack = Track::newDummy(QStringLiteral("dummy.mp3"), trackId);
+        pTrack->setAudioProperties(
+                mixxx::audio::ChannelCount(2),
+                kSampleRate,
+                mixxx::audio::Bitrate(),
+                mixxx::Duration::fromSeconds(180));
+        return pTrack;
+    }
+
+    AnalysisCache m_analysisCache;
+};
+
+TEST_F(AnalysisCacheTest, fingerprintIgnoresTags) {
+    // Same audio data, different cover art
+    const QByteArray fingerprint = this->fingerprint(QStringLiteral("cover-test-jpg.mp3"));
+    EXPECT_FALSE(fingerprint.isEmpty());
+    EXPECT_EQ(fingerprint, this->fingerprint(QStringLiteral("cover-test-png.mp3")));
+    EXPECT_NE(fingerprint, this->fingerprint(QStringLiteral("cover-test-vbr.mp3")));
+}
+
+TEST_F(AnalysisCacheTest, restoreMissingResults) {
+    const QByteArray fingerprint = QByteArrayLiteral("fingerprint");
+
+    TrackPointer pAnalyzedTrack = newTrack(TrackId(1));
+    pAnalyzedTrack->trySetBeats(mixxx::Beats::fromConstTempo(
+            kSampleRate, mixxx::audio::kStartFramePos, mixxx::Bpm(128)));
+    pAnalyzedTrack->setKeys(KeyFactory::makeBasicKeys(
+            mixxx::track::io::key::A_MINOR,
+            mixxx::track::io::key::ANALYZER));
+    pAnalyzedTrack->setReplayGain(mixxx::ReplayGain(0.5, 0.9f));
+    pAnalyzedTrack->createAndAddCue(mixxx::CueType::N60dBSound,
+            Cue::kNoHotCue,
+            mixxx::audio::FramePos(1000),
+            mixxx::audio::FramePos(100000));
+    m_analysisCache.store(AnalyzerTrack(pAnalyzedTrack), fingerprint);
+
+    // Nothing is known about other audio
+    TrackPointer pOtherTrack = newTrack(TrackId(2));
+    EXPECT_FALSE(m_analysisCache.restore(
+            AnalyzerTrack(pOtherTrack), QByteArrayLiteral("other")));
+    EXPECT_FALSE(pOtherTrack->getBeats());
+
+    TrackPointer pDuplicateTrack = newTrack(TrackId(3));
+    pDuplicateTrack->setReplayGain(mixxx::ReplayGain(0.25, 0.5f));
+    EXPECT_TRUE(m_analysisCache.restore(AnalyzerTrack(pDuplicateTrack), fingerprint));
+    ASSERT_TRUE(pDuplicateTrack->getBeats());
+    EXPECT_EQ(mixxx::Bpm(128), pDuplicateTrack->getBeats()->getBpmInRange(
+                                       mixxx::audio::kStartFramePos,
+                                       mixxx::audio::FramePos(44100 * 60)));
+    EXPECT_EQ(mixxx::track::io::key::A_MINOR,
+            pDuplicateTrack->getKeys().getGlobalKey());
+    // Existing results are kept
+    EXPECT_EQ(mixxx::ReplayGain(0.25, 0.5f), pDuplicateTrack->getReplayGain());
+    const CuePointer pOutroCue = pDuplicateTrack->findCueByType(mixxx::CueType::Outro);
+    ASSERT_TRUE(pOutroCue);
+    EXPECT_EQ(mixxx::audio::FramePos(100000), pOutroCue->getEndPosition());
+}
+
+} // namespace
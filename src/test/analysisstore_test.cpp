@@ -0,0 +1,117 @@
+#include "library/dao/analysisstore.h"
+
+#include <gtest/gtest.h>
+
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+#include <memory>
+
+namespace {
+
+// Small segments for sealing and compacting them after a few entries
+constexpr qint64 kSegmentSize = 1024;
+
+QByteArray dataOf(int analysisId) {
+    return QByteArray(200, static_cast<char>('a' + analysisId % 26));
+}
+
+class AnalysisStoreTest : public testing::Test {
+  protected:
+    std::unique_ptr<AnalysisStore> openStore() const {
+        return std::make_unique<AnalysisStore>(m_tempDir.path(), kSegmentSize);
+    }
+
+    const QTemporaryDir m_tempDir;
+};
+
+TEST_F(AnalysisStoreTest, WriteReadRemove) {
+    const auto pStore = openStore();
+    EXPECT_TRUE(pStore->read(1).isNull());
+
+    ASSERT_TRUE(pStore->write(1, dataOf(1), AnalysisStore::Format::Raw));
+    ASSERT_TRUE(pStore->write(2, dataOf(2), AnalysisStore::Format::Zlib));
+    AnalysisStore::Format format = AnalysisStore::Format::Tombstone;
+    EXPECT_EQ(dataOf(1), pStore->read(1, &format));
+    EXPECT_EQ(AnalysisStore::Format::Raw, format);
+    EXPECT_EQ(dataOf(2), pStore->read(2, &format));
+    EXPECT_EQ(AnalysisStore::Format::Zlib, format);
+    EXPECT_EQ(dataOf(2).size(), pStore->storedSize(2));
+
+    // Replace
+    ASSERT_TRUE(pStore->write(1, dataOf(3), AnalysisStore::Format::Raw));
+    EXPECT_EQ(dataOf(3), pStore->read(1));
+
+    ASSERT_TRUE(pStore->remove(1));
+    EXPECT_FALSE(pStore->contains(1));
+    EXPECT_TRUE(pStore->read(1).isNull());
+    EXPECT_EQ(-1, pStore->storedSize(1));
+    EXPECT_EQ(QList<int>{2}, pStore->analysisIds());
+}
+
+TEST_F(AnalysisStoreTest, Reopen) {
+    {
+        const auto pStore = openStore();
+        // Spans multiple segments
+        for (int analysisId = 1; analysisId <= 10; ++analysisId) {
+            ASSERT_TRUE(pStore->write(analysisId, dataOf(analysisId), AnalysisStore::Format::Raw));
+        }
+        ASSERT_TRUE(pStore->remove(5));
+        ASSERT_TRUE(pStore->write(7, dataOf(0), AnalysisStore::Format::Raw));
+    }
+    const auto pStore = openStore();
+    EXPECT_EQ(9, pStore->analysisIds().size());
+    EXPECT_FALSE(pStore->contains(5));
+    EXPECT_EQ(dataOf(0), pStore->read(7));
+    EXPECT_EQ(dataOf(10), pStore->read(10));
+}
+
+TEST_F(AnalysisStoreTest, DiscardTornEntry) {
+    {
+        const auto pStore = openStore();
+        ASSERT_TRUE(pStore->write(1, dataOf(1), AnalysisStore::Format::Raw));
+        ASSERT_TRUE(pStore->write(2, dataOf(2), AnalysisStore::Format::Raw));
+    }
+    const auto segmentFiles = QDir(m_tempDir.path()).entryInfoList(QDir::Files);
+    ASSERT_EQ(1, segmentFiles.size());
+    QFile segmentFile(segmentFiles.first().filePath());
+    ASSERT_TRUE(segmentFile.resize(segmentFile.size() - 100));
+
+    {
+        const auto pStore = openStore();
+        EXPECT_EQ(dataOf(1), pStore->read(1));
+        EXPECT_FALSE(pStore->contains(2));
+        // Appends after the last complete entry
+        ASSERT_TRUE(pStore->write(3, dataOf(3), AnalysisStore::Format::Raw));
+    }
+    const auto pStore = openStore();
+    EXPECT_EQ(dataOf(1), pStore->read(1));
+    EXPECT_EQ(dataOf(3), pStore->read(3));
+}
+
+TEST_F(AnalysisStoreTest, Compact) {
+    const auto pStore = openStore();
+    for (int analysisId = 1; analysisId <= 20; ++analysisId) {
+        ASSERT_TRUE(pStore->write(analysisId, dataOf(analysisId), AnalysisStore::Format::Raw));
+    }
+    // Data of sealed segments remains valid after compacting them
+    const QByteArray mappedData = pStore->read(2);
+    const qint64 totalBytes = pStore->totalBytes();
+
+    const QSet<int> liveAnalysisIds = {2, 19};
+    EXPECT_LT(0, pStore->compact(liveAnalysisIds));
+    EXPECT_GT(totalBytes, pStore->totalBytes());
+    EXPECT_EQ(dataOf(2), mappedData);
+
+    EXPECT_EQ(2, pStore->analysisIds().size());
+    EXPECT_EQ(dataOf(2), pStore->read(2));
+    EXPECT_EQ(dataOf(19), pStore->read(19));
+
+    // The removed analyses are not restored from earlier segments
+    const auto pReopenedStore = openStore();
+    EXPECT_EQ(dataOf(2), pReopenedStore->read(2));
+    EXPECT_EQ(dataOf(19), pReopenedStore->read(19));
+    EXPECT_EQ(2, pReopenedStore->analysisIds().size());
+}
+
+} // namespace
@@ -0,0 +1,60 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "analyzer/constants.h"
+#include "analyzer/plugins/analyzerqueenmarybeats.h"
+#include "util/math.h"
+
+namespace {
+
+constexpr mixxx::audio::SampleRate kSampleRate = mixxx::audio::SampleRate(44100);
+constexpr int kDurationSeconds = 30;
+
+// Short clicks at 120 BPM on both channels
+std::vector<CSAMPLE> makeClicks() {
+    const SINT frames = kSampleRate * kDurationSeconds;
+    const SINT framesPerBeat = kSampleRate / 2;
+    constexpr SINT kClickFrames = 100;
+    std::vector<CSAMPLE> samples(frames * mixxx::kAnalysisChannels);
+    for (SINT frame = 0; frame < frames; ++frame) {
+        if (frame % framesPerBeat < kClickFrames) {
+            for (int channel = 0; channel < mixxx::kAnalysisChannels; ++channel) {
+                samples[frame * mixxx::kAnalysisChannels + channel] =
+                        (frame % 2 == 0) ? 0.8f : -0.8f;
+            }
+        }
+    }
+    return samples;
+}
+
+QVector<mixxx::audio::FramePos> analyze(mixxx::AnalyzerQueenMaryBeats* pPlugin,
+        const std::vector<CSAMPLE>& samples) {
+    EXPECT_TRUE(pPlugin->initialize(kSampleRate));
+    const SINT samplesPerChunk = mixxx::kAnalysisSamplesPerChunk;
+    for (size_t offset = 0; offset < samples.size(); offset += samplesPerChunk) {
+        const SINT length = math_min(samplesPerChunk,
+                static_cast<SINT>(samples.size() - offset));
+        EXPECT_TRUE(pPlugin->processSamples(&samples[offset], length));
+    }
+    EXPECT_TRUE(pPlugin->finalize());
+    return pPlugin->getBeats();
+}
+
+TEST(AnalyzerBeatsTest, queenMaryReusedForNextTrack) {
+    const std::vector<CSAMPLE> clicks = makeClicks();
+    const std::vector<CSAMPLE> silence(clicks.size() / 2);
+
+    mixxx::AnalyzerQueenMaryBeats plugin;
+    const QVector<mixxx::audio::FramePos> beats = analyze(&plugin, clicks);
+    EXPECT_FALSE(beats.isEmpty());
+
+    // No state of the previous tracks must leak into the results
+    analyze(&plugin, silence);
+    EXPECT_EQ(beats, analyze(&plugin, clicks));
+
+    mixxx::AnalyzerQueenMaryBeats otherPlugin;
+    EXPECT_EQ(beats, analyze(&otherPlugin, clicks));
+}
+
+} // namespace
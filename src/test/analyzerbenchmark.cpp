@@ -0,0 +1,405 @@
+// Benchmarks for the track analysis: decoding -> analyzers.
+//
+// Run with `mixxx-test --benchmark --benchmark_filter=BM_Analyzer` or
+// `--benchmark_filter=BM_SoundSource` from the source root. The reference
+// corpus is generated on the fly, so the results only depend on the code
+// and the hardware. All benchmarks report the throughput in seconds of
+// audio per second (items_per_second) and, on Linux, the peak of the
+// additionally allocated memory for a single track (peak_memory). Multiply
+// the latter with the number of analyzer threads to size the memory for
+// batch analysis.
+#include <benchmark/benchmark.h>
+
+#include <QFile>
+#include <QTemporaryDir>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "analyzer/analyzer.h"
+#include "analyzer/analyzerbeats.h"
+#include "analyzer/analyzerebur128.h"
+#include "analyzer/analyzergain.h"
+#include "analyzer/analyzerkey.h"
+#include "analyzer/analyzertrack.h"
+#include "analyzer/analyzerwaveform.h"
+#include "analyzer/constants.h"
+#include "analyzer/plugins/analyzerqueenmarybeats.h"
+#include "analyzer/plugins/analyzerqueenmarykey.h"
+#include "analyzer/plugins/analyzersoundtouchbeats.h"
+#include "encoder/encoder.h"
+#include "encoder/encodercallback.h"
+#include "preferences/beatdetectionsettings.h"
+#include "preferences/keydetectionsettings.h"
+#include "preferences/replaygainsettings.h"
+#include "recording/defs_recording.h"
+#include "sources/soundsourceproxy.h"
+#include "test/mixxxtest.h"
+#include "test/soundsourceproviderregistration.h"
+#include "track/track.h"
+#include "util/math.h"
+#include "util/samplebuffer.h"
+#if defined __KEYFINDER__
+#include "analyzer/plugins/analyzerkeyfinder.h"
+#endif
+
+/// Provides the config and the registered sound sources.
+class AnalyzerBenchmark : public MixxxTest, SoundSourceProviderRegistration {
+  public:
+    using MixxxTest::config;
+
+  private:
+    void TestBody() override {
+    }
+};
+
+namespace {
+
+constexpr mixxx::audio::SampleRate kSampleRate = mixxx::audio::SampleRate(44100);
+// Opus only supports a few sample rates
+constexpr mixxx::audio::SampleRate kOpusSampleRate = mixxx::audio::SampleRate(48000);
+constexpr int kDurationSeconds = 60;
+
+/// The reference corpus covers the typical material: steady beats with
+/// tonal content at a common and at a fast tempo, and a beatless pad.
+struct CorpusTrack {
+    const char* name;
+    double bpm; // 0 for no beats
+};
+
+constexpr CorpusTrack kCorpus[] = {
+        {"Techno128", 128.0},
+        {"DrumAndBass174", 174.0},
+        {"AmbientPad", 0.0},
+};
+constexpr int kCorpusSize = sizeof(kCorpus) / sizeof(kCorpus[0]);
+
+/// Renders the interleaved stereo samples of a corpus track: an A minor
+/// chord, a kick on every beat and a noise hi-hat on every offbeat.
+/// The noise is seeded, so the corpus is the same for every run.
+std::vector<CSAMPLE> renderCorpusTrack(
+        const CorpusTrack& corpusTrack,
+        mixxx::audio::SampleRate sampleRate) {
+    constexpr double kChordFrequencies[] = {220.0, 261.63, 329.63};
+    const double rate = sampleRate.toDouble();
+    const SINT frames = sampleRate * kDurationSeconds;
+    std::vector<CSAMPLE> samples(frames * mixxx::kAnalysisChannels);
+    std::minstd_rand random(1);
+    std::uniform_real_distribution<double> noise(-1.0, 1.0);
+    const double framesPerBeat =
+            corpusTrack.bpm > 0 ? rate * 60.0 / corpusTrack.bpm : 0.0;
+    for (SINT frame = 0; frame < frames; ++frame) {
+        const double time = frame / rate;
+        double chord = 0;
+        for (const double frequency : kChordFrequencies) {
+            chord += std::sin(2 * M_PI * frequency * time);
+        }
+        double sample;
+        if (framesPerBeat > 0) {
+            sample = 0.1 * chord;
+            const double beatPhase = std::fmod(frame, framesPerBeat) / rate;
+            sample += 0.6 * std::exp(-beatPhase * 30.0) *
+                    std::sin(2 * M_PI * 55.0 * beatPhase);
+            const double offbeatPhase =
+                    std::fmod(frame + framesPerBeat / 2, framesPerBeat) / rate;
+            sample += 0.2 * std::exp(-offbeatPhase * 200.0) * noise(random);
+        } else {
+            // Slowly swelling pad
+            sample = 0.15 * chord * (0.6 + 0.4 * std::sin(2 * M_PI * 0.1 * time));
+        }
+        for (int channel = 0; channel < mixxx::kAnalysisChannels; ++channel) {
+            samples[frame * mixxx::kAnalysisChannels + channel] =
+                    static_cast<CSAMPLE>(sample);
+        }
+    }
+    return samples;
+}
+
+const std::vector<CSAMPLE>& corpusSamples(int index) {
+    static std::vector<CSAMPLE> s_samples[kCorpusSize];
+    if (s_samples[index].empty()) {
+        s_samples[index] = renderCorpusTrack(kCorpus[index], kSampleRate);
+    }
+    return s_samples[index];
+}
+
+#if defined(__LINUX__)
+/// Reads a memory size from /proc/self/status.
+qint64 readProcStatusBytes(const QByteArray& key) {
+    QFile file(QStringLiteral("/proc/self/status"));
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        return -1;
+    }
+    // The size of proc files is unknown, read until no more lines arrive
+    for (QByteArray line = file.readLine(); !line.isEmpty(); line = file.readLine()) {
+        if (line.startsWith(key)) {
+            return line.mid(key.size()).simplified().split(' ').first().toLongLong() * 1024;
+        }
+    }
+    return -1;
+}
+#endif
+
+/// Measures the peak of the memory that is allocated in addition to the
+/// memory at construction.
+///
+/// Only supported on Linux, where the peak resident set size can be reset.
+class PeakMemory {
+  public:
+    PeakMemory()
+            : m_baseline(-1) {
+#if defined(__LINUX__)
+        QFile clearRefs(QStringLiteral("/proc/self/clear_refs"));
+        if (clearRefs.open(QIODevice::WriteOnly) && clearRefs.write("5") == 1) {
+            m_baseline = readProcStatusBytes(QByteArrayLiteral("VmRSS:"));
+        }
+#endif
+    }
+
+    void report(benchmark::State& state) const {
+        if (m_baseline < 0) {
+            return;
+        }
+#if defined(__LINUX__)
+        const qint64 peak = readProcStatusBytes(QByteArrayLiteral("VmHWM:"));
+        if (peak >= m_baseline) {
+            state.counters["peak_memory"] = benchmark::Counter(
+                    static_cast<double>(peak - m_baseline),
+                    benchmark::Counter::kDefaults,
+                    benchmark::Counter::OneK::kIs1024);
+        }
+#else
+        Q_UNUSED(state);
+#endif
+    }
+
+  private:
+    qint64 m_baseline;
+};
+
+TrackPointer newCorpusTrack() {
+    TrackPointer pTrack = Track::newTemporary();
+    pTrack->setAudioProperties(
+            mixxx::audio::ChannelCount(mixxx::kAnalysisChannels),
+            kSampleRate,
+            mixxx::audio::Bitrate(),
+            mixxx::Duration::fromSeconds(kDurationSeconds));
+    return pTrack;
+}
+
+/// Analyzes a corpus track per iteration with a new analyzer, in chunks
+/// like the AnalyzerThread.
+template<typename CreateAnalyzer>
+void benchmarkAnalyzer(benchmark::State& state, CreateAnalyzer createAnalyzer) {
+    const int corpusIndex = static_cast<int>(state.range(0));
+    const std::vector<CSAMPLE>& samples = corpusSamples(corpusIndex);
+    state.SetLabel(kCorpus[corpusIndex].name);
+
+    const PeakMemory peakMemory;
+    for (auto _ : state) {
+        const AnalyzerTrack track(newCorpusTrack());
+        AnalyzerWithState analyzer(createAnalyzer());
+        if (!analyzer.initialize(track,
+                    kSampleRate,
+                    static_cast<SINT>(samples.size()) / mixxx::kAnalysisChannels)) {
+            state.SkipWithError("Failed to initialize the analyzer");
+            return;
+        }
+        for (std::size_t offset = 0; offset < samples.size();
+                offset += mixxx::kAnalysisSamplesPerChunk) {
+            analyzer.processSamples(&samples[offset],
+                    static_cast<int>(math_min<std::size_t>(
+                            mixxx::kAnalysisSamplesPerChunk,
+                            samples.size() - offset)));
+        }
+        analyzer.finish(track);
+    }
+
+    state.SetItemsProcessed(state.iterations() * kDurationSeconds);
+    peakMemory.report(state);
+}
+
+void BM_AnalyzerBeats(benchmark::State& state,
+        mixxx::AnalyzerPluginInfo (*pluginInfo)()) {
+    AnalyzerBenchmark environment;
+    BeatDetectionSettings(environment.config()).setBeatPluginId(pluginInfo().id());
+    benchmarkAnalyzer(state, [&environment] {
+        return std::make_unique<AnalyzerBeats>(environment.config());
+    });
+}
+
+void BM_AnalyzerKey(benchmark::State& state,
+        mixxx::AnalyzerPluginInfo (*pluginInfo)()) {
+    AnalyzerBenchmark environment;
+    KeyDetectionSettings keySettings(environment.config());
+    keySettings.setKeyPluginId(pluginInfo().id());
+    benchmarkAnalyzer(state, [&keySettings] {
+        return std::make_unique<AnalyzerKey>(keySettings);
+    });
+}
+
+void BM_AnalyzerEbur128(benchmark::State& state) {
+    AnalyzerBenchmark environment;
+    ReplayGainSettings(environment.config()).setReplayGainAnalyzerVersion(2);
+    benchmarkAnalyzer(state, [&environment] {
+        return std::make_unique<AnalyzerEbur128>(environment.config());
+    });
+}
+
+void BM_AnalyzerGain(benchmark::State& state) {
+    AnalyzerBenchmark environment;
+    ReplayGainSettings(environment.config()).setReplayGainAnalyzerVersion(1);
+    benchmarkAnalyzer(state, [&environment] {
+        return std::make_unique<AnalyzerGain>(environment.config());
+    });
+}
+
+void BM_AnalyzerWaveform(benchmark::State& state) {
+    AnalyzerBenchmark environment;
+    benchmarkAnalyzer(state, [&environment] {
+        // Without a database the waveforms are not stored
+        return std::make_unique<AnalyzerWaveform>(environment.config(), QSqlDatabase());
+    });
+}
+
+class FileEncoderCallback : public EncoderCallback {
+  public:
+    explicit FileEncoderCallback(QFile* pFile)
+            : m_pFile(pFile) {
+    }
+
+    void write(const unsigned char* header,
+            const unsigned char* body,
+            int headerLen,
+            int bodyLen) override {
+        if (headerLen > 0) {
+            m_pFile->write(reinterpret_cast<const char*>(header), headerLen);
+        }
+        if (bodyLen > 0) {
+            m_pFile->write(reinterpret_cast<const char*>(body), bodyLen);
+        }
+    }
+    qint64 tell() override {
+        return m_pFile->pos();
+    }
+    void seek(qint64 pos) override {
+        m_pFile->seek(pos);
+    }
+    qint64 filelen() override {
+        return m_pFile->size();
+    }
+
+  private:
+    QFile* const m_pFile;
+};
+
+/// Encodes the first corpus track with the recording encoder of the
+/// format. Returns an empty string if the encoder is not available.
+QString encodeCorpusTrack(
+        const QDir& dir,
+        const UserSettingsPointer& pConfig,
+        const QString& formatName) {
+    const Encoder::Format format = EncoderFactory::getFactory().getFormatFor(formatName);
+    const mixxx::audio::SampleRate sampleRate =
+            formatName == ENCODING_OPUS ? kOpusSampleRate : kSampleRate;
+    const QString filePath = dir.filePath(
+            QStringLiteral("%1.%2").arg(kCorpus[0].name, format.fileExtension));
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return QString();
+    }
+    FileEncoderCallback callback(&file);
+    EncoderPointer pEncoder =
+            EncoderFactory::getFactory().createRecordingEncoder(format, pConfig, &callback);
+    if (pEncoder->initEncoder(sampleRate, nullptr) != 0) {
+        return QString();
+    }
+    const std::vector<CSAMPLE> samples = renderCorpusTrack(kCorpus[0], sampleRate);
+    for (std::size_t offset = 0; offset < samples.size();
+            offset += mixxx::kAnalysisSamplesPerChunk) {
+        pEncoder->encodeBuffer(&samples[offset],
+                static_cast<int>(math_min<std::size_t>(
+                        mixxx::kAnalysisSamplesPerChunk,
+                        samples.size() - offset)));
+    }
+    pEncoder->flush();
+    pEncoder.reset();
+    return filePath;
+}
+
+/// Decodes the corpus track like the AnalyzerThread, i.e. opening the
+/// file is included.
+void BM_SoundSource(benchmark::State& state, const char* formatName) {
+    AnalyzerBenchmark environment;
+    QTemporaryDir tempDir;
+    const QString filePath = encodeCorpusTrack(
+            QDir(tempDir.path()), environment.config(), QString::fromUtf8(formatName));
+    if (filePath.isEmpty()) {
+        state.SkipWithError("The encoder is not available");
+        return;
+    }
+
+    mixxx::AudioSource::OpenParams openParams;
+    openParams.setChannelCount(mixxx::kAnalysisChannels);
+    mixxx::SampleBuffer sampleBuffer(mixxx::kAnalysisSamplesPerChunk);
+    double decodedSeconds = 0;
+    const PeakMemory peakMemory;
+    for (auto _ : state) {
+        const auto pAudioSource =
+                SoundSourceProxy(Track::newTemporary(filePath)).openAudioSource(openParams);
+        if (!pAudioSource) {
+            state.SkipWithError("Failed to open the file");
+            return;
+        }
+        const mixxx::IndexRange frameRange = pAudioSource->frameIndexRange();
+        const double sampleRate = pAudioSource->getSignalInfo().getSampleRate().toDouble();
+        for (SINT frame = frameRange.start(); frame < frameRange.end();
+                frame += mixxx::kAnalysisFramesPerChunk) {
+            const auto readableSampleFrames = pAudioSource->readSampleFrames(
+                    mixxx::WritableSampleFrames(
+                            mixxx::IndexRange::forward(frame,
+                                    math_min(mixxx::kAnalysisFramesPerChunk,
+                                            frameRange.end() - frame)),
+                            mixxx::SampleBuffer::WritableSlice(sampleBuffer)));
+            decodedSeconds += readableSampleFrames.frameIndexRange().length() / sampleRate;
+        }
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(decodedSeconds));
+    peakMemory.report(state);
+}
+
+} // namespace
+
+BENCHMARK_CAPTURE(BM_AnalyzerBeats, QueenMary, &mixxx::AnalyzerQueenMaryBeats::pluginInfo)
+        ->DenseRange(0, kCorpusSize - 1)
+        ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_AnalyzerBeats, SoundTouch, &mixxx::AnalyzerSoundTouchBeats::pluginInfo)
+        ->DenseRange(0, kCorpusSize - 1)
+        ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_AnalyzerKey, QueenMary, &mixxx::AnalyzerQueenMaryKey::pluginInfo)
+        ->DenseRange(0, kCorpusSize - 1)
+        ->Unit(benchmark::kMillisecond);
+#if defined __KEYFINDER__
+BENCHMARK_CAPTURE(BM_AnalyzerKey, KeyFinder, &mixxx::AnalyzerKeyFinder::pluginInfo)
+        ->DenseRange(0, kCorpusSize - 1)
+        ->Unit(benchmark::kMillisecond);
+#endif
+BENCHMARK(BM_AnalyzerEbur128)
+        ->DenseRange(0, kCorpusSize - 1)
+        ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_AnalyzerGain)
+        ->DenseRange(0, kCorpusSize - 1)
+        ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_AnalyzerWaveform)
+        ->DenseRange(0, kCorpusSize - 1)
+        ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_CAPTURE(BM_SoundSource, Wave, ENCODING_WAVE)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_SoundSource, Aiff, ENCODING_AIFF)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_SoundSource, Flac, ENCODING_FLAC)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_SoundSource, Mp3, ENCODING_MP3)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_SoundSource, OggVorbis, ENCODING_OGG)->Unit(benchmark::kMillisecond);
+#ifdef __OPUS__
+BENCHMARK_CAPTURE(BM_SoundSource, Opus, ENCODING_OPUS)->Unit(benchmark::kMillisecond);
+#endif
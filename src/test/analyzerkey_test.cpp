@@ -0,0 +1,97 @@
+#include <benchmark/benchmark.h>
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+#include "analyzer/constants.h"
+#include "analyzer/plugins/analyzerqueenmarykey.h"
+#include "util/math.h"
+#if defined __KEYFINDER__
+#include "analyzer/plugins/analyzerkeyfinder.h"
+#endif
+
+namespace {
+
+constexpr mixxx::audio::SampleRate kSampleRate = mixxx::audio::SampleRate(44100);
+constexpr int kDurationSeconds = 30;
+
+// An A major triad (A3, C#4, E4) on both channels
+std::vector<CSAMPLE> makeChord() {
+    constexpr double kFrequencies[] = {220.0, 277.18, 329.63};
+    const SINT frames = kSampleRate * kDurationSeconds;
+    std::vector<CSAMPLE> samples(frames * mixxx::kAnalysisChannels);
+    for (SINT frame = 0; frame < frames; ++frame) {
+        double sample = 0;
+        for (const double frequency : kFrequencies) {
+            sample += 0.3 *
+                    std::sin(2 * M_PI * frequency * frame / kSampleRate.toDouble());
+        }
+        for (int channel = 0; channel < mixxx::kAnalysisChannels; ++channel) {
+            samples[frame * mixxx::kAnalysisChannels + channel] =
+                    static_cast<CSAMPLE>(sample);
+        }
+    }
+    return samples;
+}
+
+KeyChangeList analyze(mixxx::AnalyzerKeyPlugin* pPlugin,
+        const std::vector<CSAMPLE>& samples,
+        SINT framesPerChunk) {
+    EXPECT_TRUE(pPlugin->initialize(kSampleRate));
+    const SINT samplesPerChunk = framesPerChunk * mixxx::kAnalysisChannels;
+    for (size_t offset = 0; offset < samples.size(); offset += samplesPerChunk) {
+        const SINT length = math_min(samplesPerChunk,
+                static_cast<SINT>(samples.size() - offset));
+        EXPECT_TRUE(pPlugin->processSamples(&samples[offset], length));
+    }
+    EXPECT_TRUE(pPlugin->finalize());
+    return pPlugin->getKeyChanges();
+}
+
+TEST(AnalyzerKeyTest, queenMaryChunkSizeDoesNotMatter) {
+    const std::vector<CSAMPLE> chord = makeChord();
+    mixxx::AnalyzerQueenMaryKey plugin;
+    const KeyChangeList keys = analyze(&plugin, chord, mixxx::kAnalysisFramesPerChunk);
+    ASSERT_FALSE(keys.isEmpty());
+    EXPECT_NE(mixxx::track::io::key::INVALID, keys.last().first);
+    mixxx::AnalyzerQueenMaryKey otherPlugin;
+    const KeyChangeList otherKeys = analyze(&otherPlugin, chord, 1000);
+    ASSERT_FALSE(otherKeys.isEmpty());
+    EXPECT_EQ(keys.last().first, otherKeys.last().first);
+}
+
+#if defined __KEYFINDER__
+TEST(AnalyzerKeyTest, keyFinderChunkSizeDoesNotMatter) {
+    const std::vector<CSAMPLE> chord = makeChord();
+    mixxx::AnalyzerKeyFinder plugin;
+    const KeyChangeList keys = analyze(&plugin, chord, mixxx::kAnalysisFramesPerChunk);
+    ASSERT_EQ(1, keys.size());
+    EXPECT_NE(mixxx::track::io::key::INVALID, keys.first().first);
+    // The last chunk is shorter than the others
+    mixxx::AnalyzerKeyFinder otherPlugin;
+    const KeyChangeList otherKeys = analyze(&otherPlugin, chord, 3000);
+    ASSERT_EQ(1, otherKeys.size());
+    EXPECT_EQ(keys.first().first, otherKeys.first().first);
+}
+#endif
+
+template<typename Plugin>
+void BM_AnalyzerKey(benchmark::State& state) {
+    const std::vector<CSAMPLE> chord = makeChord();
+    for (auto _ : state) {
+        Plugin plugin;
+        benchmark::DoNotOptimize(
+                analyze(&plugin, chord, mixxx::kAnalysisFramesPerChunk));
+    }
+    // Seconds of audio per second
+    state.SetItemsProcessed(state.iterations() * kDurationSeconds);
+}
+BENCHMARK_TEMPLATE(BM_AnalyzerKey, mixxx::AnalyzerQueenMaryKey)
+        ->Unit(benchmark::kMillisecond);
+#if defined __KEYFINDER__
+BENCHMARK_TEMPLATE(BM_AnalyzerKey, mixxx::AnalyzerKeyFinder)
+        ->Unit(benchmark::kMillisecond);
+#endif
+
+} // namespace
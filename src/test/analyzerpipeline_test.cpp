@@ -0,0 +1,170 @@
+#include "analyzer/analyzerpipeline.h"
+
+#include <gtest/gtest.h>
+
+#include <QThread>
+#include <atomic>
+#include <vector>
+
+#include "analyzer/analyzertrack.h"
+#include "test/mixxxtest.h"
+#include "track/track.h"
+
+namespace {
+
+constexpr SINT kChunkSampleCount = 16;
+constexpr int kChunkCount = 100;
+
+class FakeAnalyzer : public Analyzer {
+  public:
+    FakeAnalyzer(std::atomic<int>* pCleanupCount, int maxChunkCount)
+            : m_pCleanupCount(pCleanupCount),
+              m_maxChunkCount(maxChunkCount),
+              m_chunkCount(0),
+              m_sum(0),
+              m_pThread(nullptr),
+              m_multipleThreads(false) {
+    }
+
+    bool initialize(const AnalyzerTrack& track,
+            mixxx::audio::SampleRate sampleRate,
+            SINT frameLength) override {
+        Q_UNUSED(track);
+        Q_UNUSED(sampleRate);
+        Q_UNUSED(frameLength);
+        return true;
+    }
+
+    bool processSamples(const CSAMPLE* pIn, SINT count) override {
+        if (m_pThread && m_pThread != QThread::currentThread()) {
+            m_multipleThreads = true;
+        }
+        m_pThread = QThread::currentThread();
+        for (SINT i = 0; i < count; ++i) {
+            m_sum += pIn[i];
+        }
+        return ++m_chunkCount < m_maxChunkCount;
+    }
+
+    void storeResults(TrackPointer pTrack) override {
+        Q_UNUSED(pTrack);
+    }
+
+    void cleanup() override {
+        m_pCleanupCount->fetch_add(1);
+    }
+
+    int chunkCount() const {
+        return m_chunkCount;
+    }
+    double sum() const {
+        return m_sum;
+    }
+    QThread* thread() const {
+        return m_pThread;
+    }
+    bool multipleThreads() const {
+        return m_multipleThreads;
+    }
+
+  private:
+    std::atomic<int>* const m_pCleanupCount;
+    const int m_maxChunkCount;
+    int m_chunkCount;
+    double m_sum;
+    QThread* m_pThread;
+    bool m_multipleThreads;
+};
+
+class AnalyzerPipelineTest : public MixxxTest {
+  protected:
+    void SetUp() override {
+        m_cleanupCount = 0;
+        addAnalyzer(kChunkCount + 1);
+        addAnalyzer(kChunkCount + 1);
+        // Fails in the middle of the track
+        addAnalyzer(kChunkCount / 2);
+
+        const AnalyzerTrack track(Track::newTemporary());
+        for (auto&& analyzer : m_analyzers) {
+            ASSERT_TRUE(analyzer.initialize(track, mixxx::audio::SampleRate(44100), 0));
+        }
+    }
+
+    void TearDown() override {
+        const AnalyzerTrack track(Track::newTemporary());
+        for (auto&& analyzer : m_analyzers) {
+            analyzer.finish(track);
+        }
+    }
+
+    // The analyzer fails when processing the chunk with the given number
+    void addAnalyzer(int maxChunkCount) {
+        auto pAnalyzer = std::make_unique<FakeAnalyzer>(&m_cleanupCount, maxChunkCount);
+        m_fakeAnalyzers.push_back(pAnalyzer.get());
+        m_analyzers.push_back(AnalyzerWithState(std::move(pAnalyzer)));
+    }
+
+    std::atomic<int> m_cleanupCount;
+    std::vector<FakeAnalyzer*> m_fakeAnalyzers;
+    std::vector<AnalyzerWithState> m_analyzers;
+};
+
+TEST_F(AnalyzerPipelineTest, ProcessChunksInOrderOnSeparateThreads) {
+    // Double buffering like in AnalyzerThread
+    std::vector<CSAMPLE> buffers[2] = {
+            std::vector<CSAMPLE>(kChunkSampleCount),
+            std::vector<CSAMPLE>(kChunkSampleCount)};
+    double expectedSum = 0;
+    double expectedHalfSum = 0;
+    {
+        AnalyzerPipeline pipeline(&m_analyzers, QThread::InheritPriority);
+        for (int chunk = 0; chunk < kChunkCount; ++chunk) {
+            std::vector<CSAMPLE>& buffer = buffers[chunk % 2];
+            for (SINT i = 0; i < kChunkSampleCount; ++i) {
+                buffer[i] = static_cast<CSAMPLE>(chunk);
+            }
+            expectedSum += chunk * kChunkSampleCount;
+            if (chunk < kChunkCount / 2) {
+                expectedHalfSum += chunk * kChunkSampleCount;
+            }
+            pipeline.waitForChunk();
+            pipeline.processChunk(buffer.data(), kChunkSampleCount);
+        }
+        pipeline.waitForChunk();
+    }
+
+    EXPECT_EQ(kChunkCount, m_fakeAnalyzers[0]->chunkCount());
+    EXPECT_EQ(kChunkCount, m_fakeAnalyzers[1]->chunkCount());
+    EXPECT_DOUBLE_EQ(expectedSum, m_fakeAnalyzers[0]->sum());
+    EXPECT_DOUBLE_EQ(expectedSum, m_fakeAnalyzers[1]->sum());
+    EXPECT_TRUE(m_analyzers[0].isActive());
+    EXPECT_TRUE(m_analyzers[1].isActive());
+
+    // The failed analyzer is not fed with any more chunks
+    EXPECT_EQ(kChunkCount / 2, m_fakeAnalyzers[2]->chunkCount());
+    EXPECT_DOUBLE_EQ(expectedHalfSum, m_fakeAnalyzers[2]->sum());
+    EXPECT_FALSE(m_analyzers[2].isActive());
+    EXPECT_EQ(1, m_cleanupCount.load());
+
+    // Each analyzer has its own thread
+    for (const auto* pAnalyzer : m_fakeAnalyzers) {
+        EXPECT_FALSE(pAnalyzer->multipleThreads());
+        EXPECT_NE(QThread::currentThread(), pAnalyzer->thread());
+    }
+    EXPECT_NE(m_fakeAnalyzers[0]->thread(), m_fakeAnalyzers[1]->thread());
+    EXPECT_NE(m_fakeAnalyzers[1]->thread(), m_fakeAnalyzers[2]->thread());
+}
+
+TEST_F(AnalyzerPipelineTest, DestroyWithPendingChunk) {
+    std::vector<CSAMPLE> buffer(kChunkSampleCount, 1.0f);
+    {
+        AnalyzerPipeline pipeline(&m_analyzers, QThread::InheritPriority);
+        pipeline.processChunk(buffer.data(), kChunkSampleCount);
+    }
+    for (const auto* pAnalyzer : m_fakeAnalyzers) {
+        EXPECT_EQ(1, pAnalyzer->chunkCount());
+    }
+}
+
+} // anonymous namespace
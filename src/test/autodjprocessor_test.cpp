@@ -1697,3 +1697,35 @@ TEST_F(AutoDJProcessorTest, TrackZeroLength) {
     // Signal that the request to load pTrack succeeded.
     deck1.fakeTrackLoadedEvent(pTrack);
 }
+
+TEST_F(AutoDJProcessorTest, PrepareNextTracks) {
+    config()->setValue(ConfigKey("[Auto DJ]", "AnalysisLookahead"), 1);
+    TrackId testId = addTrackToCollection(kTrackLocationTest);
+    ASSERT_TRUE(testId.isValid());
+
+    QList<AnalyzerScheduledTrack> scheduledTracks;
+    QObject::connect(pProcessor.data(),
+            &AutoDJProcessor::analyzeTracks,
+            [&scheduledTracks](const QList<AnalyzerScheduledTrack>& tracks) {
+                scheduledTracks += tracks;
+            });
+
+    PlaylistTableModel* pAutoDJTableModel = pProcessor->getTableModel();
+    pAutoDJTableModel->appendTrack(testId);
+    // Nothing is prepared while Auto DJ is disabled
+    EXPECT_TRUE(scheduledTracks.isEmpty());
+
+    EXPECT_CALL(*pProcessor, emitAutoDJStateChanged(AutoDJProcessor::ADJ_ENABLE_P1LOADED));
+    EXPECT_CALL(*pProcessor, emitLoadTrackToPlayer(_, QString("[Channel1]"), true));
+    EXPECT_EQ(AutoDJProcessor::ADJ_OK, pProcessor->toggleAutoDJ(true));
+
+    // The track at the top of the queue is analyzed before any other track
+    ASSERT_EQ(1, scheduledTracks.size());
+    EXPECT_EQ(testId, scheduledTracks.first().getTrackId());
+    EXPECT_EQ(AnalyzerScheduledTrack::Priority::AutoDJ,
+            scheduledTracks.first().getPriority());
+
+    // A track is only prepared once
+    pAutoDJTableModel->select();
+    EXPECT_EQ(1, scheduledTracks.size());
+}
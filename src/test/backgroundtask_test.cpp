@@ -0,0 +1,36 @@
+#include "util/backgroundtask.h"
+
+#include <gtest/gtest.h>
+
+#include <QAtomicInt>
+
+#include "util/compatibility/qatomic.h"
+
+namespace {
+
+using mixxx::BackgroundTaskPriority;
+namespace backgroundtask = mixxx::backgroundtask;
+
+TEST(BackgroundTaskTest, ReturnResult) {
+    QFuture<int> future = backgroundtask::run(
+            BackgroundTaskPriority::Interactive, [] { return 42; });
+    EXPECT_EQ(42, future.result());
+    EXPECT_TRUE(future.isFinished());
+}
+
+TEST(BackgroundTaskTest, RunWithoutResult) {
+    QAtomicInt counter(0);
+    QList<QFuture<void>> futures;
+    for (int i = 0; i < 16; ++i) {
+        futures.append(backgroundtask::run(
+                BackgroundTaskPriority::Batch, [&counter] {
+                    counter.fetchAndAddRelaxed(1);
+                }));
+    }
+    for (auto& future : futures) {
+        future.waitForFinished();
+    }
+    EXPECT_EQ(16, atomicLoadRelaxed(counter));
+}
+
+} // namespace
@@ -0,0 +1,73 @@
+#include "library/batchanalyzer.h"
+
+#include <gtest/gtest.h>
+
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+
+#include "test/librarytest.h"
+
+namespace {
+
+class BatchAnalyzerTest : public LibraryTest {
+  protected:
+    BatchAnalyzerTest()
+            : m_output(&m_outputText),
+              m_batchAnalyzer(config(),
+                      dbConnectionPooler(),
+                      trackCollectionManager(),
+                      &m_output) {
+    }
+
+    void SetUp() override {
+        ASSERT_TRUE(m_dir.isValid());
+        const QDir dir(m_dir.path());
+        ASSERT_TRUE(dir.mkpath(QStringLiteral("crate/subdir")));
+        copyTestFile(QStringLiteral("cover-test.flac"), QStringLiteral("crate/a.flac"));
+        copyTestFile(QStringLiteral("cover-test.ogg"), QStringLiteral("crate/subdir/b.ogg"));
+        copyTestFile(QStringLiteral("README"), QStringLiteral("crate/readme.txt"));
+    }
+
+    void copyTestFile(const QString& fileName, const QString& targetPath) {
+        ASSERT_TRUE(QFile::copy(
+                getTestDir().filePath(QStringLiteral("id3-test-data/") + fileName),
+                m_dir.filePath(targetPath)));
+    }
+
+    QTemporaryDir m_dir;
+    QString m_outputText;
+    QTextStream m_output;
+    BatchAnalyzer m_batchAnalyzer;
+};
+
+TEST_F(BatchAnalyzerTest, AddDirectoryRecursively) {
+    EXPECT_EQ(2, m_batchAnalyzer.addPath(m_dir.filePath(QStringLiteral("crate"))));
+    EXPECT_EQ(2, m_batchAnalyzer.trackIds().size());
+    EXPECT_FALSE(trackCollectionManager()
+                         ->resolveTrackIdsFromLocations({m_dir.filePath(
+                                 QStringLiteral("crate/subdir/b.ogg"))})
+                         .isEmpty());
+
+    // Tracks are only added once to the batch
+    EXPECT_EQ(0, m_batchAnalyzer.addPath(m_dir.filePath(QStringLiteral("crate/a.flac"))));
+    EXPECT_EQ(0, m_batchAnalyzer.addAllLibraryTracks());
+    EXPECT_EQ(2, m_batchAnalyzer.trackIds().size());
+}
+
+TEST_F(BatchAnalyzerTest, AddFile) {
+    EXPECT_EQ(1, m_batchAnalyzer.addPath(m_dir.filePath(QStringLiteral("crate/a.flac"))));
+    // Unsupported or missing files are ignored
+    EXPECT_EQ(0, m_batchAnalyzer.addPath(m_dir.filePath(QStringLiteral("crate/readme.txt"))));
+    EXPECT_EQ(0, m_batchAnalyzer.addPath(m_dir.filePath(QStringLiteral("missing.mp3"))));
+    EXPECT_EQ(1, m_batchAnalyzer.trackIds().size());
+}
+
+TEST_F(BatchAnalyzerTest, AddMissingCrate) {
+    EXPECT_EQ(-1, m_batchAnalyzer.addCrate(QStringLiteral("Missing")));
+    EXPECT_TRUE(m_batchAnalyzer.trackIds().isEmpty());
+    // Nothing to analyze
+    EXPECT_FALSE(m_batchAnalyzer.start(1, AnalyzerModeFlags::WithBeats));
+}
+
+} // anonymous namespace
@@ -251,4 +251,25 @@ TEST_F(BeatMapTest, HasBeatInRangeWithFractionalPos) {
             mixxx::audio::kStartFramePos + 0.2));
 }
 
+TEST_F(BeatMapTest, IteratorFromWithVariableTempo) {
+    // Increase the beat length with every beat, so each beat gets its own
+    // marker.
+    constexpr int numBeats = 200;
+    QVector<mixxx::audio::FramePos> beats;
+    mixxx::audio::FramePos beatPos = mixxx::audio::FramePos(100);
+    for (int i = 0; i < numBeats; ++i) {
+        beats.append(beatPos);
+        beatPos += 5000 + i * 10;
+    }
+    const auto pMap = Beats::fromBeatPositions(m_pTrack->getSampleRate(), beats);
+
+    for (int i = 1; i < numBeats - 1; ++i) {
+        EXPECT_EQ(beats[i], *pMap->iteratorFrom(beats[i]));
+        EXPECT_EQ(beats[i], *pMap->iteratorFrom(beats[i] - 0.5));
+        EXPECT_EQ(beats[i + 1], *pMap->iteratorFrom(beats[i] + 0.5));
+        EXPECT_EQ(beats[i - 1], pMap->findNthBeat(beats[i] - 0.5, -1));
+        EXPECT_EQ(beats[i + 1], pMap->findNthBeat(beats[i] + 0.5, 1));
+    }
+}
+
 }  // namespace
@@ -403,6 +403,8 @@ TEST(BeatsTest, ConstTempoSerialization) {
 TEST(BeatsTest, NonConstTempoSerialization) {
     const QByteArray byteArray = kNonConstTempoBeats.toByteArray();
     ASSERT_EQ(BEAT_MAP_VERSION, kNonConstTempoBeats.getVersion());
+    // Serialized only once
+    EXPECT_EQ(byteArray.constData(), kNonConstTempoBeats.toByteArray().constData());
 
     auto pBeats = Beats::fromByteArray(kSampleRate, BEAT_MAP_VERSION, QString(), byteArray);
     ASSERT_NE(nullptr, pBeats);
@@ -0,0 +1,81 @@
+#include <gtest/gtest.h>
+
+#include <QHash>
+#include <random>
+
+#include "engine/cachingreader/cachingreaderchunk.h"
+#include "engine/cachingreader/cachingreaderchunkindex.h"
+
+namespace {
+
+constexpr SINT kMaxSize = 80;
+
+class CachingReaderChunkIndexTest : public testing::Test {
+  protected:
+    CachingReaderChunkIndexTest() {
+        for (SINT i = 0; i < kMaxSize; ++i) {
+            m_chunks.push_back(std::make_unique<CachingReaderChunkForOwner>());
+        }
+    }
+
+    CachingReaderChunkForOwner* chunk(SINT i) const {
+        return m_chunks[i].get();
+    }
+
+    std::vector<std::unique_ptr<CachingReaderChunkForOwner>> m_chunks;
+};
+
+TEST_F(CachingReaderChunkIndexTest, insertLookupRemove) {
+    CachingReaderChunkIndex index(kMaxSize);
+    EXPECT_TRUE(index.isEmpty());
+    EXPECT_EQ(nullptr, index.value(0));
+
+    for (SINT i = 0; i < kMaxSize; ++i) {
+        EXPECT_TRUE(index.insert(i, chunk(i)));
+    }
+    EXPECT_EQ(kMaxSize, index.size());
+    for (SINT i = 0; i < kMaxSize; ++i) {
+        EXPECT_EQ(chunk(i), index.value(i));
+    }
+    EXPECT_EQ(nullptr, index.value(kMaxSize));
+
+    // Replacing an existing entry doesn't change the size
+    EXPECT_TRUE(index.insert(3, chunk(5)));
+    EXPECT_EQ(kMaxSize, index.size());
+    EXPECT_EQ(chunk(5), index.value(3));
+
+    EXPECT_EQ(1, index.remove(3));
+    EXPECT_EQ(0, index.remove(3));
+    EXPECT_EQ(nullptr, index.value(3));
+    EXPECT_EQ(kMaxSize - 1, index.size());
+
+    index.clear();
+    EXPECT_TRUE(index.isEmpty());
+    for (SINT i = 0; i < kMaxSize; ++i) {
+        EXPECT_EQ(nullptr, index.value(i));
+    }
+}
+
+TEST_F(CachingReaderChunkIndexTest, randomOperationsMatchReference) {
+    CachingReaderChunkIndex index(kMaxSize);
+    QHash<SINT, CachingReaderChunkForOwner*> reference;
+    std::mt19937 generator(42);
+    for (int i = 0; i < 100000; ++i) {
+        // Cluster the keys like chunk indices around a play position
+        const SINT chunkIndex = generator() % (4 * kMaxSize);
+        if (generator() % 2) {
+            if (reference.size() < kMaxSize || reference.contains(chunkIndex)) {
+                auto* const pChunk = chunk(generator() % kMaxSize);
+                ASSERT_TRUE(index.insert(chunkIndex, pChunk));
+                reference.insert(chunkIndex, pChunk);
+            }
+        } else {
+            ASSERT_EQ(reference.remove(chunkIndex) ? 1 : 0, index.remove(chunkIndex));
+        }
+        ASSERT_EQ(reference.size(), index.size());
+        const SINT lookupIndex = generator() % (4 * kMaxSize);
+        ASSERT_EQ(reference.value(lookupIndex, nullptr), index.value(lookupIndex));
+    }
+}
+
+} // namespace
@@ -0,0 +1,131 @@
+#include "engine/cachingreader/cachingreaderchunkpool.h"
+
+#include <gtest/gtest.h>
+
+#include "engine/cachingreader/cachingreaderchunk.h"
+#include "util/samplebuffer.h"
+
+namespace {
+
+const QString kTrackKey = QStringLiteral("/music/track.flac|1234|5678");
+
+mixxx::IndexRange chunkFrameIndexRange(SINT chunkIndex) {
+    return mixxx::IndexRange::forward(
+            chunkIndex * CachingReaderChunk::kFrames,
+            CachingReaderChunk::kFrames);
+}
+
+class CachingReaderChunkPoolTest : public testing::Test {
+  protected:
+    CachingReaderChunkPoolTest()
+            : m_samples(CachingReaderChunk::kSamples) {
+        for (SINT i = 0; i < m_samples.size(); ++i) {
+            m_samples[i] = static_cast<CSAMPLE>(i % 100) / 100;
+        }
+    }
+
+    // Decodes a chunk of the track and shares it
+    void decode(CachingReaderChunkForOwner* pChunk, SINT chunkIndex) {
+        pChunk->init(chunkIndex);
+        ASSERT_TRUE(m_pool.attachExclusive(pChunk));
+        ASSERT_EQ(chunkFrameIndexRange(chunkIndex),
+                pChunk->bufferSampleFramesFromMemory(
+                        m_samples.data(), chunkFrameIndexRange(chunkIndex)));
+        m_pool.publish(*pChunk, kTrackKey);
+    }
+
+    mixxx::SampleBuffer m_samples;
+    CachingReaderChunkPool m_pool;
+};
+
+TEST_F(CachingReaderChunkPoolTest, ShareDecodedChunk) {
+    auto* pBlock = m_pool.addBlock(2);
+    CachingReaderChunkForOwner decodedChunk;
+    CachingReaderChunkForOwner sharedChunk;
+    decode(&decodedChunk, 3);
+
+    sharedChunk.init(3);
+    EXPECT_EQ(mixxx::IndexRange(),
+            m_pool.attachShared(&sharedChunk, QStringLiteral("other"), chunkFrameIndexRange(3)));
+    EXPECT_EQ(chunkFrameIndexRange(3),
+            m_pool.attachShared(&sharedChunk, kTrackKey, chunkFrameIndexRange(3)));
+    EXPECT_EQ(1, m_pool.sharedBufferCount());
+
+    mixxx::SampleBuffer samples(CachingReaderChunk::kSamples);
+    EXPECT_EQ(chunkFrameIndexRange(3),
+            sharedChunk.readBufferedSampleFrames(samples.data(), chunkFrameIndexRange(3)));
+    for (SINT i = 0; i < samples.size(); ++i) {
+        ASSERT_EQ(m_samples[i], samples[i]);
+    }
+
+    m_pool.release(&decodedChunk);
+    m_pool.release(&sharedChunk);
+    EXPECT_EQ(0, m_pool.sharedBufferCount());
+    m_pool.removeBlock(pBlock);
+}
+
+TEST_F(CachingReaderChunkPoolTest, KeepUnreferencedSamples) {
+    auto* pBlock = m_pool.addBlock(2);
+    CachingReaderChunkForOwner chunk;
+    decode(&chunk, 0);
+    m_pool.release(&chunk);
+
+    mixxx::SampleBuffer samples(CachingReaderChunk::kSamples);
+    EXPECT_TRUE(m_pool.readShared(kTrackKey, 0, chunkFrameIndexRange(0), samples.data()));
+    EXPECT_EQ(m_samples[1], samples[1]);
+    // The frame index range must match, e.g. for the last chunk
+    EXPECT_FALSE(m_pool.readShared(kTrackKey,
+            0,
+            mixxx::IndexRange::forward(0, 100),
+            samples.data()));
+
+    EXPECT_EQ(chunkFrameIndexRange(0),
+            m_pool.attachShared(&chunk, kTrackKey, chunkFrameIndexRange(0)));
+    m_pool.release(&chunk);
+    m_pool.removeBlock(pBlock);
+}
+
+TEST_F(CachingReaderChunkPoolTest, ReuseLeastRecentlyReleased) {
+    auto* pBlock = m_pool.addBlock(1);
+    CachingReaderChunkForOwner chunk;
+    decode(&chunk, 0);
+    m_pool.release(&chunk);
+    chunk.free();
+
+    // Evicts the samples of the first chunk
+    decode(&chunk, 1);
+    mixxx::SampleBuffer samples(CachingReaderChunk::kSamples);
+    EXPECT_FALSE(m_pool.readShared(kTrackKey, 0, chunkFrameIndexRange(0), samples.data()));
+    EXPECT_TRUE(m_pool.readShared(kTrackKey, 1, chunkFrameIndexRange(1), samples.data()));
+
+    m_pool.release(&chunk);
+    m_pool.removeBlock(pBlock);
+}
+
+TEST_F(CachingReaderChunkPoolTest, RemoveSharedBlock) {
+    auto* pFirstBlock = m_pool.addBlock(1);
+    auto* pSecondBlock = m_pool.addBlock(1);
+    CachingReaderChunkForOwner decodedChunk;
+    CachingReaderChunkForOwner sharedChunk;
+    // Uses the buffer of the first block
+    decode(&decodedChunk, 0);
+    sharedChunk.init(0);
+    EXPECT_EQ(chunkFrameIndexRange(0),
+            m_pool.attachShared(&sharedChunk, kTrackKey, chunkFrameIndexRange(0)));
+
+    // The memory remains valid until no chunk refers to it
+    m_pool.removeBlock(pFirstBlock);
+    EXPECT_EQ(2, m_pool.blockCount());
+    m_pool.release(&decodedChunk);
+    EXPECT_EQ(2, m_pool.blockCount());
+    m_pool.release(&sharedChunk);
+    EXPECT_EQ(1, m_pool.blockCount());
+
+    mixxx::SampleBuffer samples(CachingReaderChunk::kSamples);
+    EXPECT_FALSE(m_pool.readShared(kTrackKey, 0, chunkFrameIndexRange(0), samples.data()));
+
+    m_pool.removeBlock(pSecondBlock);
+    EXPECT_EQ(0, m_pool.blockCount());
+}
+
+} // namespace
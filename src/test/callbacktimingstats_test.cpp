@@ -0,0 +1,103 @@
+#include <gtest/gtest.h>
+
+#include "soundio/callbacktimingstats.h"
+
+namespace {
+
+constexpr int kFrames = 512;
+constexpr double kSampleRate = 48000.0;
+constexpr double kBufferSeconds = kFrames / kSampleRate;
+
+class CallbackTimingStatsTest : public ::testing::Test {
+  protected:
+    // Records callbacks of a device whose clock runs at the given rate
+    void runDevice(CallbackTimingStats* pStats,
+            double sampleRate,
+            double seconds,
+            double processingFraction,
+            qint64 jitterNanos = 0) {
+        const double intervalNanos = kFrames / sampleRate * 1e9;
+        const int callbacks = static_cast<int>(seconds * sampleRate / kFrames);
+        for (int i = 0; i < callbacks; ++i) {
+            const qint64 jitter = (i % 2) ? jitterNanos : -jitterNanos;
+            const qint64 entry = static_cast<qint64>(i * intervalNanos) + jitter;
+            pStats->record(entry,
+                    static_cast<qint64>(processingFraction * kBufferSeconds * 1e9),
+                    0,
+                    kFrames);
+        }
+    }
+};
+
+TEST_F(CallbackTimingStatsTest, histogramQuantiles) {
+    CallbackTimingHistogram histogram;
+    EXPECT_EQ(0.0, histogram.quantile(0.5));
+    for (int i = 0; i < 99; ++i) {
+        histogram.add(0.42);
+    }
+    histogram.add(5.0);
+    histogram.add(-1.0);
+    EXPECT_EQ(101u, histogram.count());
+    EXPECT_EQ(1u, histogram.bucketCount(0));
+    EXPECT_EQ(1u, histogram.bucketCount(CallbackTimingHistogram::kBuckets - 1));
+    EXPECT_DOUBLE_EQ(0.45, histogram.quantile(0.5));
+    EXPECT_DOUBLE_EQ(CallbackTimingHistogram::kBuckets * CallbackTimingHistogram::kBucketWidth,
+            histogram.quantile(1.0));
+}
+
+TEST_F(CallbackTimingStatsTest, regularCallbacks) {
+    CallbackTimingStats stats;
+    stats.reset(kBufferSeconds);
+    runDevice(&stats, kSampleRate, 1.0, 0.32);
+
+    EXPECT_EQ(93u, stats.callbacks());
+    EXPECT_EQ(92u, stats.intervals().count());
+    EXPECT_NEAR(1.0, stats.intervals().quantile(0.5), 0.051);
+    EXPECT_NEAR(0.0, stats.intervalJitterSeconds(), 1e-6);
+    EXPECT_DOUBLE_EQ(0.35, stats.processing().quantile(0.99));
+    EXPECT_NEAR(0.68 * kBufferSeconds, stats.minHeadroomSeconds(), 1e-6);
+    // Not measured long enough for the sample rate
+    EXPECT_EQ(0.0, stats.measuredSampleRate());
+}
+
+TEST_F(CallbackTimingStatsTest, jitter) {
+    CallbackTimingStats stats;
+    stats.reset(kBufferSeconds);
+    // Every interval is 1 ms shorter or longer
+    runDevice(&stats, kSampleRate, 1.0, 0.3, 500000);
+    EXPECT_NEAR(0.001, stats.intervalJitterSeconds(), 1e-4);
+}
+
+TEST_F(CallbackTimingStatsTest, deadlineDefinesHeadroom) {
+    CallbackTimingStats stats;
+    stats.reset(kBufferSeconds);
+    stats.record(0, static_cast<qint64>(0.52 * kBufferSeconds * 1e9), 2 * kBufferSeconds, kFrames);
+    EXPECT_NEAR(1.48 * kBufferSeconds, stats.minHeadroomSeconds(), 1e-6);
+    EXPECT_EQ(1u, stats.headroom().bucketCount(CallbackTimingHistogram::kBuckets - 11));
+}
+
+TEST_F(CallbackTimingStatsTest, clockDrift) {
+    CallbackTimingStats reference;
+    reference.reset(kBufferSeconds);
+    runDevice(&reference, kSampleRate, 20.0, 0.3, 200000);
+
+    CallbackTimingStats device;
+    device.reset(kBufferSeconds);
+    runDevice(&device, kSampleRate * (1.0 + 50e-6), 20.0, 0.1, 300000);
+
+    EXPECT_NEAR(kSampleRate, reference.measuredSampleRate(), 0.1);
+    EXPECT_NEAR(50.0, device.driftPpm(reference), 2.0);
+    EXPECT_NEAR(-50.0, reference.driftPpm(device), 2.0);
+}
+
+TEST_F(CallbackTimingStatsTest, resetClearsEverything) {
+    CallbackTimingStats stats;
+    stats.reset(kBufferSeconds);
+    runDevice(&stats, kSampleRate, 1.0, 0.3);
+    stats.reset(2 * kBufferSeconds);
+    EXPECT_EQ(0u, stats.callbacks());
+    EXPECT_EQ(0u, stats.processing().count());
+    EXPECT_DOUBLE_EQ(2 * kBufferSeconds, stats.bufferSeconds());
+}
+
+} // namespace
@@ -87,6 +87,18 @@ void FakeBulkControllerJSProxy::send(const QList<int>& data, unsigned int length
     Q_UNUSED(length);
 }
 
+void FakeBulkControllerJSProxy::sendBytes(const QByteArray& data) {
+    Q_UNUSED(data);
+}
+
+QList<int> FakeBulkControllerJSProxy::changedRows(
+        int screenId, const QByteArray& frame, int bytesPerRow) {
+    Q_UNUSED(screenId);
+    Q_UNUSED(frame);
+    Q_UNUSED(bytesPerRow);
+    return {};
+}
+
 FakeController::FakeController()
         : Controller("Test Controller"),
           m_bMidiMapping(false),
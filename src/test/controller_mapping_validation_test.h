@@ -50,6 +50,9 @@ class FakeBulkControllerJSProxy : public ControllerJSProxy {
     FakeBulkControllerJSProxy();
 
     Q_INVOKABLE void send(const QList<int>& data, unsigned int length = 0) override;
+    Q_INVOKABLE void sendBytes(const QByteArray& data);
+    Q_INVOKABLE QList<int> changedRows(
+            int screenId, const QByteArray& frame, int bytesPerRow);
 };
 
 class FakeController : public Controller {
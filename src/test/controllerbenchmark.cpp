@@ -0,0 +1,343 @@
+// Benchmarks for the controller input path:
+// MIDI/HID message -> mapping/script -> control -> output.
+//
+// Run with `mixxx-test --benchmark --benchmark_filter=BM_Controller` from the
+// source root, so the mappings in res/controllers can be found. To compare
+// in-house mappings, copy them to res/controllers and add a BENCHMARK_CAPTURE
+// line below.
+#include <benchmark/benchmark.h>
+
+#include <QDir>
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "controllers/defs_controllers.h"
+#include "controllers/legacycontrollermappingfilehandler.h"
+#include "controllers/midi/legacymidicontrollermapping.h"
+#include "controllers/midi/midicontroller.h"
+#include "controllers/midi/midiutils.h"
+#include "controllers/scripting/legacy/controllerscriptenginelegacy.h"
+#include "test/controller_mapping_validation_test.h"
+#include "test/signalpathtest.h"
+#include "util/performancetimer.h"
+#include "util/time.h"
+
+/// Provides decks, mixer and effects, so the controls that mappings use
+/// exist and have their real side effects.
+class ControllerBenchmark : public BaseSignalPathTest {
+  public:
+    ControllerBenchmark() {
+        m_mappingPath = QDir::current();
+        m_mappingPath.cd("res/controllers");
+    }
+
+    std::shared_ptr<LegacyControllerMapping> loadMapping(const QString& fileName) const {
+        return LegacyControllerMappingFileHandler::loadMapping(
+                QFileInfo(m_mappingPath.filePath(fileName)), m_mappingPath);
+    }
+
+    bool applyMapping(Controller* pController) const {
+        return pController->applyMapping();
+    }
+
+    void receive(Controller* pController, const QByteArray& data) const {
+        pController->receive(data, mixxx::Time::elapsed());
+    }
+
+  private:
+    void TestBody() override {
+    }
+
+    QDir m_mappingPath;
+};
+
+namespace {
+
+class BenchmarkMidiController : public MidiController {
+  public:
+    BenchmarkMidiController()
+            : MidiController("Benchmark MIDI Controller"),
+              m_sentMessages(0) {
+        setInputDevice(true);
+        setOutputDevice(true);
+        startEngine();
+        getScriptEngine()->setTesting(true);
+    }
+    ~BenchmarkMidiController() override {
+        close();
+        stopEngine();
+    }
+
+    void receiveShortMessage(unsigned char status,
+            unsigned char control,
+            unsigned char value) {
+        MidiController::receivedShortMessage(status, control, value, mixxx::Time::elapsed());
+    }
+
+    int sentMessages() const {
+        return m_sentMessages;
+    }
+
+  private:
+    void sendShortMsg(unsigned char status,
+            unsigned char byte1,
+            unsigned char byte2) override {
+        Q_UNUSED(status);
+        Q_UNUSED(byte1);
+        Q_UNUSED(byte2);
+        ++m_sentMessages;
+    }
+
+    void sendBytes(const QByteArray& data) override {
+        Q_UNUSED(data);
+        ++m_sentMessages;
+    }
+
+    int open() override {
+        return 0;
+    }
+
+    int m_sentMessages;
+};
+
+/// Stands in for HidController, which can not be created without a device.
+/// Input reports go through Controller::receive() like in HidController.
+class BenchmarkHidController : public Controller {
+  public:
+    BenchmarkHidController()
+            : Controller("Benchmark HID Controller") {
+        setInputDevice(true);
+        startEngine();
+        getScriptEngine()->setTesting(true);
+    }
+    ~BenchmarkHidController() override {
+        stopEngine();
+    }
+
+    ControllerJSProxy* jsProxy() override {
+        return new FakeHidControllerJSProxy();
+    }
+
+    QString mappingExtension() override {
+        return HID_MAPPING_EXTENSION;
+    }
+
+    std::shared_ptr<LegacyControllerMapping> cloneMapping() override {
+        if (!m_pMapping) {
+            return nullptr;
+        }
+        return m_pMapping->clone();
+    }
+
+    void setMapping(std::shared_ptr<LegacyControllerMapping> pMapping) override {
+        m_pMapping = downcastAndTakeOwnership<LegacyHidControllerMapping>(std::move(pMapping));
+    }
+
+    bool isMappable() const override {
+        return m_pMapping && m_pMapping->isMappable();
+    }
+
+    bool matchMapping(const MappingInfo& mapping) override {
+        Q_UNUSED(mapping);
+        return false;
+    }
+
+  private:
+    void sendBytes(const QByteArray& data) override {
+        Q_UNUSED(data);
+    }
+
+    int open() override {
+        return 0;
+    }
+
+    int close() override {
+        return 0;
+    }
+
+    std::shared_ptr<LegacyHidControllerMapping> m_pMapping;
+};
+
+struct MidiStreamMessage {
+    unsigned char status;
+    unsigned char control;
+    unsigned char value;
+    bool script;
+};
+
+/// Builds an input stream that touches every input of the mapping, the way
+/// a user moves each control: buttons are pressed and released, knobs and
+/// faders are swept.
+std::vector<MidiStreamMessage> midiInputStream(const LegacyMidiControllerMapping& mapping) {
+    QList<uint16_t> keys = mapping.getInputMappings().uniqueKeys();
+    std::sort(keys.begin(), keys.end());
+
+    std::vector<MidiStreamMessage> stream;
+    for (const uint16_t key : std::as_const(keys)) {
+        const MidiInputMapping inputMapping = mapping.getInputMappings().value(key);
+        const unsigned char status = inputMapping.key.status;
+        const unsigned char control = inputMapping.key.control;
+        const bool script = inputMapping.options.testFlag(MidiOption::Script);
+        switch (MidiUtils::opCodeFromStatus(status)) {
+        case MidiOpCode::NoteOn:
+        case MidiOpCode::NoteOff:
+            stream.push_back({status, control, 0x7F, script});
+            stream.push_back({status, control, 0x00, script});
+            break;
+        case MidiOpCode::ControlChange:
+        case MidiOpCode::PitchBendChange:
+            for (unsigned char value = 0x00; value < 0x80; value += 0x10) {
+                stream.push_back({status, control, value, script});
+            }
+            stream.push_back({status, control, 0x7F, script});
+            break;
+        default:
+            // System messages are not mapped to single controls.
+            break;
+        }
+    }
+    return stream;
+}
+
+/// Builds a stream of input reports 0x01 and 0x02 that changes a few bytes
+/// per report, like buttons and faders do. The content is deterministic so
+/// results of different builds can be compared.
+std::vector<QByteArray> hidInputStream() {
+    constexpr int kReportSize = 64;
+    constexpr int kReportCount = 256;
+
+    std::vector<QByteArray> stream;
+    stream.reserve(kReportCount);
+    QByteArray reports[] = {QByteArray(kReportSize, 0), QByteArray(kReportSize, 0)};
+    reports[0][0] = 0x01;
+    reports[1][0] = 0x02;
+    quint32 random = 0x12345678;
+    for (int i = 0; i < kReportCount; ++i) {
+        QByteArray& report = reports[i % 2];
+        for (int change = 0; change < 3; ++change) {
+            // xorshift32
+            random ^= random << 13;
+            random ^= random >> 17;
+            random ^= random << 5;
+            report[1 + random % (kReportSize - 1)] = static_cast<char>(random >> 24);
+        }
+        stream.push_back(report);
+    }
+    return stream;
+}
+
+/// Reports the latency distribution of the individual messages in
+/// microseconds. The mean is already reported by the benchmark itself.
+void setLatencyCounters(benchmark::State& state,
+        std::vector<double>* pLatencies,
+        const char* prefix) {
+    if (pLatencies->empty()) {
+        return;
+    }
+    std::sort(pLatencies->begin(), pLatencies->end());
+    const auto percentile = [pLatencies](double p) {
+        const auto index = static_cast<std::size_t>(p * (pLatencies->size() - 1));
+        return (*pLatencies)[index];
+    };
+    const std::string name(prefix);
+    state.counters[name + "p50_us"] = percentile(0.5);
+    state.counters[name + "p99_us"] = percentile(0.99);
+    state.counters[name + "max_us"] = pLatencies->back();
+}
+
+void BM_ControllerMidiInput(benchmark::State& state, const char* mappingFileName) {
+    ControllerBenchmark environment;
+    auto pMapping = std::dynamic_pointer_cast<LegacyMidiControllerMapping>(
+            environment.loadMapping(QString::fromUtf8(mappingFileName)));
+    if (!pMapping) {
+        state.SkipWithError("Failed to load the MIDI mapping");
+        return;
+    }
+    const std::vector<MidiStreamMessage> stream = midiInputStream(*pMapping);
+    if (stream.empty()) {
+        state.SkipWithError("The MIDI mapping has no input mappings");
+        return;
+    }
+
+    BenchmarkMidiController controller;
+    controller.setMapping(pMapping->clone());
+    if (!environment.applyMapping(&controller)) {
+        state.SkipWithError("Failed to initialize the mapping scripts");
+        return;
+    }
+
+    // Script bindings and direct control bindings are reported separately,
+    // so that script engine regressions are not hidden by the control system.
+    std::vector<double> scriptLatencies;
+    std::vector<double> controlLatencies;
+    std::size_t index = 0;
+    PerformanceTimer timer;
+    while (state.KeepRunning()) {
+        const MidiStreamMessage& message = stream[index];
+        timer.start();
+        controller.receiveShortMessage(message.status, message.control, message.value);
+        const double latency = timer.elapsed().toDoubleMicros();
+        if (message.script) {
+            scriptLatencies.push_back(latency);
+        } else {
+            controlLatencies.push_back(latency);
+        }
+        index = (index + 1) % stream.size();
+    }
+
+    state.SetItemsProcessed(state.iterations());
+    setLatencyCounters(state, &scriptLatencies, "script_");
+    setLatencyCounters(state, &controlLatencies, "control_");
+    state.counters["outputs_per_msg"] = benchmark::Counter(
+            controller.sentMessages(), benchmark::Counter::kAvgIterations);
+}
+
+void BM_ControllerHidInput(benchmark::State& state, const char* mappingFileName) {
+    ControllerBenchmark environment;
+    auto pMapping = environment.loadMapping(QString::fromUtf8(mappingFileName));
+    if (!pMapping) {
+        state.SkipWithError("Failed to load the HID mapping");
+        return;
+    }
+    const std::vector<QByteArray> stream = hidInputStream();
+
+    BenchmarkHidController controller;
+    controller.setMapping(std::move(pMapping));
+    if (!environment.applyMapping(&controller)) {
+        state.SkipWithError("Failed to initialize the mapping scripts");
+        return;
+    }
+
+    // All HID input is handled by the mapping's incomingData() script function.
+    std::vector<double> scriptLatencies;
+    std::size_t index = 0;
+    PerformanceTimer timer;
+    while (state.KeepRunning()) {
+        timer.start();
+        environment.receive(&controller, stream[index]);
+        scriptLatencies.push_back(timer.elapsed().toDoubleMicros());
+        index = (index + 1) % stream.size();
+    }
+
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(state.iterations() * stream.front().size());
+    setLatencyCounters(state, &scriptLatencies, "script_");
+}
+
+} // namespace
+
+// Mostly direct control bindings
+BENCHMARK_CAPTURE(BM_ControllerMidiInput,
+        KorgNanoKontrol2,
+        "Korg nanoKONTROL 2.midi.xml");
+// Mostly script bindings
+BENCHMARK_CAPTURE(BM_ControllerMidiInput,
+        HerculesInpulse200,
+        "Hercules_DJControl_Inpulse_200.midi.xml");
+BENCHMARK_CAPTURE(BM_ControllerMidiInput,
+        NumarkMixtrackPlatinumFX,
+        "Numark Mixtrack Platinum FX.midi.xml");
+BENCHMARK_CAPTURE(BM_ControllerHidInput,
+        TraktorKontrolS2MK3,
+        "Traktor Kontrol S2 MK3.hid.xml");
@@ -0,0 +1,83 @@
+#include "controllers/controllermappinginfoenumerator.h"
+
+#include <gtest/gtest.h>
+
+#include <QFile>
+#include <QTemporaryDir>
+
+#include "controllers/defs_controllers.h"
+
+namespace {
+
+QByteArray mappingXml(const QString& name) {
+    return QStringLiteral(
+            "<?xml version=\"1.0\" encoding=\"utf-8\"?>\n"
+            "<MixxxControllerPreset schemaVersion=\"1\" mixxxVersion=\"2.4.0\">\n"
+            "  <info><name>%1</name><author>Author</author></info>\n"
+            "  <controller id=\"Test\"/>\n"
+            "</MixxxControllerPreset>\n")
+            .arg(name)
+            .toUtf8();
+}
+
+class ControllerMappingInfoEnumeratorTest : public testing::Test {
+  protected:
+    ControllerMappingInfoEnumeratorTest()
+            : m_mappingPath(m_mappingDir.filePath(QStringLiteral("Test.midi.xml"))),
+              m_catalogPath(m_catalogDir.filePath(QStringLiteral("mappings.cache"))) {
+    }
+
+    void writeMapping(const QString& name) {
+        QFile file(m_mappingPath);
+        ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+        file.write(mappingXml(name));
+    }
+
+    void setLastModified(const QDateTime& lastModified) {
+        QFile file(m_mappingPath);
+        ASSERT_TRUE(file.open(QIODevice::ReadWrite));
+        ASSERT_TRUE(file.setFileTime(lastModified, QFileDevice::FileModificationTime));
+    }
+
+    QString enumerateMappingName() {
+        MappingInfoEnumerator enumerator(m_mappingDir.path(), m_catalogPath);
+        const QList<MappingInfo> mappings =
+                enumerator.getMappingsByExtension(MIDI_MAPPING_EXTENSION);
+        if (mappings.size() != 1) {
+            return QString();
+        }
+        return mappings.first().getName();
+    }
+
+    const QTemporaryDir m_mappingDir;
+    const QTemporaryDir m_catalogDir;
+    const QString m_mappingPath;
+    const QString m_catalogPath;
+};
+
+TEST_F(ControllerMappingInfoEnumeratorTest, ReuseUnmodifiedMappings) {
+    const QDateTime lastModified = QDateTime::currentDateTimeUtc().addSecs(-60);
+    writeMapping(QStringLiteral("Alpha"));
+    setLastModified(lastModified);
+    EXPECT_EQ(QStringLiteral("Alpha"), enumerateMappingName());
+    EXPECT_TRUE(QFile::exists(m_catalogPath));
+
+    // Same size and modification time, i.e. the header is not parsed again
+    writeMapping(QStringLiteral("Bravo"));
+    setLastModified(lastModified);
+    EXPECT_EQ(QStringLiteral("Alpha"), enumerateMappingName());
+
+    setLastModified(lastModified.addSecs(10));
+    EXPECT_EQ(QStringLiteral("Bravo"), enumerateMappingName());
+}
+
+TEST_F(ControllerMappingInfoEnumeratorTest, DropRemovedMappings) {
+    writeMapping(QStringLiteral("Alpha"));
+    EXPECT_EQ(QStringLiteral("Alpha"), enumerateMappingName());
+
+    ASSERT_TRUE(QFile::remove(m_mappingPath));
+    MappingInfoEnumerator enumerator(m_mappingDir.path(), m_catalogPath);
+    EXPECT_TRUE(enumerator.getMappingsByExtension(MIDI_MAPPING_EXTENSION).isEmpty());
+}
+
+} // namespace
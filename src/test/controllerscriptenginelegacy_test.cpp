@@ -74,6 +74,23 @@ TEST_F(ControllerScriptEngineLegacyTest, commonScriptHasNoErrors) {
     EXPECT_TRUE(evaluateScriptFile(commonScript));
 }
 
+TEST_F(ControllerScriptEngineLegacyTest, evaluateModifiedScriptFile) {
+    auto co = std::make_unique<ControlObject>(ConfigKey("[Test]", "co"));
+    ScopedTemporaryFile pScriptFile(makeTemporaryFile(
+            "engine.setValue('[Test]', 'co', 1.0);"));
+    const QFileInfo scriptFile(pScriptFile->fileName());
+    EXPECT_TRUE(evaluateScriptFile(scriptFile));
+    EXPECT_DOUBLE_EQ(1.0, co->get());
+
+    // The cached code of the first evaluation must not be used anymore
+    pScriptFile->open();
+    pScriptFile->resize(0);
+    pScriptFile->write("engine.setValue('[Test]', 'co', 2.0); // modified");
+    pScriptFile->close();
+    EXPECT_TRUE(evaluateScriptFile(scriptFile));
+    EXPECT_DOUBLE_EQ(2.0, co->get());
+}
+
 TEST_F(ControllerScriptEngineLegacyTest, setValue) {
     auto co = std::make_unique<ControlObject>(ConfigKey("[Test]", "co"));
     EXPECT_TRUE(evaluateAndAssert("engine.setValue('[Test]', 'co', 1.0);"));
@@ -150,6 +167,34 @@ TEST_F(ControllerScriptEngineLegacyTest, getSetParameter) {
     EXPECT_DOUBLE_EQ(2.0, co->get());
 }
 
+TEST_F(ControllerScriptEngineLegacyTest, getControl) {
+    auto co = std::make_unique<ControlPotmeter>(ConfigKey("[Test]", "co"),
+            -10.0,
+            10.0);
+    EXPECT_TRUE(evaluateAndAssert(
+            "var control = engine.getControl('[Test]', 'co');"
+            "control.value = 5.0;"));
+    EXPECT_DOUBLE_EQ(5.0, co->get());
+    EXPECT_TRUE(evaluateAndAssert("control.parameter = 0.0;"));
+    EXPECT_DOUBLE_EQ(-10.0, co->get());
+    co->set(2.0);
+    EXPECT_DOUBLE_EQ(2.0, evaluate("control.value").toNumber());
+    EXPECT_DOUBLE_EQ(0.6, evaluate("control.parameter").toNumber());
+    EXPECT_TRUE(evaluate("engine.getControl('[Test]', 'co') === control").toBool());
+    EXPECT_EQ(QStringLiteral("[Test]"), evaluate("control.group").toString());
+
+    // NaN is ignored like by setValue()
+    EXPECT_TRUE(evaluateAndAssert("control.value = NaN;"));
+    EXPECT_DOUBLE_EQ(2.0, co->get());
+
+    EXPECT_TRUE(evaluateAndAssert("control.reset();"));
+    EXPECT_DOUBLE_EQ(0.0, co->get());
+}
+
+TEST_F(ControllerScriptEngineLegacyTest, getControl_InvalidControl) {
+    EXPECT_TRUE(evaluate("engine.getControl('[Nothing]', 'nothing')").isUndefined());
+}
+
 TEST_F(ControllerScriptEngineLegacyTest, softTakeover_setValue) {
     auto co = std::make_unique<ControlPotmeter>(ConfigKey("[Test]", "co"),
             -10.0,
@@ -1,7 +1,12 @@
 #include <gtest/gtest.h>
+
+#include <QElapsedTimer>
+#include <QThread>
 #include <QtDebug>
+#include <thread>
 
 #include "control/controlobject.h"
+#include "control/controlproxy.h"
 #include "util/memory.h"
 #include "test/mixxxtest.h"
 
@@ -85,4 +90,32 @@ TEST_F(ControlObjectTest, Persistence_ValidValue) {
     EXPECT_DOUBLE_EQ(5.0, co.get());
 }
 
+TEST_F(ControlObjectTest, CoalescedValueChanges) {
+    ControlProxy proxy(ck1);
+    QList<double> values;
+    proxy.connectValueChangedCoalesced(&proxy, [&values](double value) {
+        values.append(value);
+    });
+
+    // Changes in the main thread are delivered immediately
+    co1->set(1.0);
+    EXPECT_EQ(QList<double>{1.0}, values);
+    values.clear();
+
+    // Changes from other threads are coalesced
+    std::thread([this] {
+        for (int i = 2; i <= 100; ++i) {
+            co1->set(i);
+        }
+    }).join();
+    EXPECT_TRUE(values.isEmpty());
+    QElapsedTimer timer;
+    timer.start();
+    while (values.isEmpty() && timer.elapsed() < 1000) {
+        application()->processEvents();
+        QThread::msleep(1);
+    }
+    EXPECT_EQ(QList<double>{100.0}, values);
+}
+
 } // namespace
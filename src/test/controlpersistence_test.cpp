@@ -0,0 +1,98 @@
+#include "control/controlpersistence.h"
+
+#include <gtest/gtest.h>
+
+#include <QFile>
+
+#include "control/controlobject.h"
+#include "test/mixxxtest.h"
+
+namespace {
+
+class ControlPersistenceTest : public MixxxTest {
+  protected:
+    ControlPersistenceTest()
+            : m_key(QStringLiteral("[Test]"), QStringLiteral("persistent")),
+              m_logFilePath(getTestDataDir().filePath(QStringLiteral("controls.log"))) {
+    }
+
+    std::unique_ptr<ControlObject> createPersistentControl() const {
+        return std::make_unique<ControlObject>(m_key, true, false, true, 0.0);
+    }
+
+    /// Simulates a crash, i.e. the config is not saved
+    UserSettingsPointer restartWithoutSave() const {
+        return UserSettingsPointer(new UserSettings(QString()));
+    }
+
+    const ConfigKey m_key;
+    const QString m_logFilePath;
+};
+
+TEST_F(ControlPersistenceTest, RestoreChangedValuesAfterCrash) {
+    {
+        ControlPersistence persistence(config(), m_logFilePath);
+        auto pControl = createPersistentControl();
+        persistence.persistChanges();
+        pControl->set(0.5);
+        persistence.persistChanges();
+        persistence.waitForPendingWrite();
+        pControl->set(0.75);
+        persistence.persistChanges();
+        persistence.waitForPendingWrite();
+    }
+    ASSERT_TRUE(QFile::exists(m_logFilePath));
+
+    UserSettingsPointer pConfig = restartWithoutSave();
+    ControlPersistence persistence(pConfig, m_logFilePath);
+    EXPECT_DOUBLE_EQ(0.75, pConfig->getValue(m_key, 0.0));
+}
+
+TEST_F(ControlPersistenceTest, UnchangedValuesAreNotWritten) {
+    config()->set(m_key, ConfigValue(0.25));
+    ControlPersistence persistence(config(), m_logFilePath);
+    auto pControl = createPersistentControl();
+    EXPECT_DOUBLE_EQ(0.25, pControl->get());
+    persistence.persistChanges();
+    persistence.waitForPendingWrite();
+    EXPECT_FALSE(QFile::exists(m_logFilePath));
+}
+
+TEST_F(ControlPersistenceTest, DiscardLogAfterSave) {
+    ControlPersistence persistence(config(), m_logFilePath);
+    auto pControl = createPersistentControl();
+    pControl->set(0.5);
+    persistence.persistChanges();
+    persistence.waitForPendingWrite();
+    ASSERT_TRUE(QFile::exists(m_logFilePath));
+
+    persistence.storeInConfig();
+    EXPECT_DOUBLE_EQ(0.5, config()->getValue(m_key, 0.0));
+    persistence.discardLog();
+    EXPECT_FALSE(QFile::exists(m_logFilePath));
+
+    // Values that are stored in the config are not logged again
+    persistence.persistChanges();
+    persistence.waitForPendingWrite();
+    EXPECT_FALSE(QFile::exists(m_logFilePath));
+}
+
+TEST_F(ControlPersistenceTest, CompactLog) {
+    {
+        ControlPersistence persistence(config(), m_logFilePath);
+        auto pControl = createPersistentControl();
+        // Each change appends a line of about 25 bytes
+        for (int i = 1; i <= 4000; ++i) {
+            pControl->set(i);
+            persistence.persistChanges();
+            persistence.waitForPendingWrite();
+        }
+    }
+    EXPECT_LE(QFile(m_logFilePath).size(), ControlPersistence::kMaxLogSize);
+
+    UserSettingsPointer pConfig = restartWithoutSave();
+    ControlPersistence persistence(pConfig, m_logFilePath);
+    EXPECT_DOUBLE_EQ(4000.0, pConfig->getValue(m_key, 0.0));
+}
+
+} // namespace
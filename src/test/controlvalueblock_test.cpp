@@ -0,0 +1,72 @@
+#include "control/controlvalueblock.h"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <vector>
+
+#include "control/controlobject.h"
+#include "control/controlproxy.h"
+#include "test/mixxxtest.h"
+
+namespace {
+
+const QString kGroup = QStringLiteral("[ValueBlockTest]");
+
+class ControlValueBlockTest : public MixxxTest {
+  protected:
+    void SetUp() override {
+        m_pBlock = ControlValueBlock::create(kGroup);
+    }
+
+    std::shared_ptr<ControlValueBlock> m_pBlock;
+};
+
+TEST_F(ControlValueBlockTest, ControlsOfGroupUseBlock) {
+    EXPECT_EQ(m_pBlock, ControlValueBlock::get(kGroup));
+    EXPECT_EQ(nullptr, ControlValueBlock::get(QStringLiteral("[OtherGroup]")));
+
+    auto pControl = std::make_unique<ControlObject>(
+            ConfigKey(kGroup, QStringLiteral("co1")), true, false, false, 0.5);
+    ControlObject other(ConfigKey(QStringLiteral("[OtherGroup]"), QStringLiteral("co1")));
+    EXPECT_EQ(1, m_pBlock->allocatedCount());
+    EXPECT_DOUBLE_EQ(0.5, pControl->get());
+
+    ControlProxy proxy(kGroup, QStringLiteral("co1"));
+    proxy.set(1.0);
+    EXPECT_DOUBLE_EQ(1.0, pControl->get());
+    pControl->set(2.0);
+    EXPECT_DOUBLE_EQ(2.0, proxy.get());
+
+    pControl.reset();
+    EXPECT_EQ(1, m_pBlock->allocatedCount()) << "The proxy still uses the value";
+}
+
+TEST_F(ControlValueBlockTest, ValuesAreReleased) {
+    {
+        ControlObject control(ConfigKey(kGroup, QStringLiteral("co1")));
+        EXPECT_EQ(1, m_pBlock->allocatedCount());
+    }
+    EXPECT_EQ(0, m_pBlock->allocatedCount());
+}
+
+TEST_F(ControlValueBlockTest, FullBlock) {
+    std::vector<std::unique_ptr<ControlObject>> controls;
+    for (int i = 0; i <= ControlValueBlock::kCapacity; ++i) {
+        controls.push_back(std::make_unique<ControlObject>(
+                ConfigKey(kGroup, QString::number(i))));
+        controls.back()->set(i);
+    }
+    EXPECT_EQ(ControlValueBlock::kCapacity, m_pBlock->allocatedCount());
+    // The last control stores its value itself
+    for (int i = 0; i <= ControlValueBlock::kCapacity; ++i) {
+        EXPECT_DOUBLE_EQ(i, controls[i]->get());
+    }
+}
+
+TEST_F(ControlValueBlockTest, BlockIsRemoved) {
+    m_pBlock.reset();
+    EXPECT_EQ(nullptr, ControlValueBlock::get(kGroup));
+}
+
+} // namespace
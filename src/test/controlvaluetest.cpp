@@ -0,0 +1,52 @@
+#include <gtest/gtest.h>
+
+#include <thread>
+
+#include "control/controlvalue.h"
+
+namespace {
+
+struct Snapshot {
+    int sequence = 0;
+    // Always equal to -sequence in every complete value
+    int check = 0;
+    double padding[6] = {};
+};
+
+TEST(ControlValueTripleBufferTest, LatestValueWins) {
+    ControlValueTripleBuffer<Snapshot> buffer;
+    EXPECT_EQ(0, buffer.getValue().sequence);
+
+    for (int i = 1; i <= 3; ++i) {
+        buffer.setValue({i, -i});
+    }
+    EXPECT_EQ(3, buffer.getValue().sequence);
+    // Reading again without a new value returns the same value
+    EXPECT_EQ(3, buffer.getValue().sequence);
+
+    buffer.setValue({4, -4});
+    EXPECT_EQ(4, buffer.getValue().sequence);
+}
+
+TEST(ControlValueTripleBufferTest, ConcurrentReaderGetsCompleteValues) {
+    constexpr int kNumValues = 100000;
+    ControlValueTripleBuffer<Snapshot> buffer;
+
+    std::thread writer([&buffer] {
+        for (int i = 1; i <= kNumValues; ++i) {
+            buffer.setValue({i, -i});
+        }
+    });
+
+    int lastSequence = 0;
+    while (lastSequence < kNumValues) {
+        const Snapshot value = buffer.getValue();
+        ASSERT_EQ(-value.sequence, value.check);
+        // Values are never received out of order
+        ASSERT_GE(value.sequence, lastSequence);
+        lastSequence = value.sequence;
+    }
+    writer.join();
+}
+
+} // namespace
@@ -0,0 +1,92 @@
+#include "widget/controlwidgethub.h"
+
+#include <gtest/gtest.h>
+
+#include <QList>
+#include <QWidget>
+#include <memory>
+
+#include "control/controlobject.h"
+#include "test/mixxxtest.h"
+#include "widget/controlwidgetconnection.h"
+#include "widget/wbasewidget.h"
+
+namespace {
+
+class TestWidget : public QWidget, public WBaseWidget {
+  public:
+    TestWidget()
+            : WBaseWidget(this) {
+    }
+
+    void connectControl(const ConfigKey& key) {
+        addConnection(new ControlParameterWidgetConnection(this,
+                key,
+                nullptr,
+                ControlParameterWidgetConnection::DIR_FROM_AND_TO_WIDGET,
+                ControlParameterWidgetConnection::EMIT_ON_PRESS_AND_RELEASE));
+    }
+
+    using WBaseWidget::setControlParameter;
+
+    QList<double> m_values;
+
+  protected:
+    void onConnectedControlChanged(double dParameter, double dValue) override {
+        Q_UNUSED(dParameter);
+        m_values.append(dValue);
+    }
+};
+
+class ControlWidgetHubTest : public MixxxTest {
+  protected:
+    void SetUp() override {
+        m_pControl = std::make_unique<ControlObject>(m_key);
+        m_widget1.connectControl(m_key);
+        m_widget2.connectControl(m_key);
+        m_widget1.show();
+        m_widget2.show();
+    }
+
+    const ConfigKey m_key = ConfigKey(QStringLiteral("[Test]"), QStringLiteral("hub"));
+    std::unique_ptr<ControlObject> m_pControl;
+    TestWidget m_widget1;
+    TestWidget m_widget2;
+};
+
+TEST_F(ControlWidgetHubTest, ConnectionsShareHub) {
+    EXPECT_EQ(ControlWidgetHub::getHub(m_key), ControlWidgetHub::getHub(m_key));
+}
+
+TEST_F(ControlWidgetHubTest, ChangesAreDelivered) {
+    m_pControl->set(0.5);
+    EXPECT_EQ(QList<double>{0.5}, m_widget1.m_values);
+    EXPECT_EQ(QList<double>{0.5}, m_widget2.m_values);
+}
+
+TEST_F(ControlWidgetHubTest, SenderIsNotNotified) {
+    m_widget1.setControlParameter(1.0);
+    EXPECT_DOUBLE_EQ(1.0, m_pControl->get());
+    EXPECT_TRUE(m_widget1.m_values.isEmpty());
+    EXPECT_EQ(QList<double>{1.0}, m_widget2.m_values);
+}
+
+TEST_F(ControlWidgetHubTest, HiddenWidgetCatchesUpWhenShown) {
+    m_widget2.hide();
+    m_pControl->set(0.25);
+    m_pControl->set(0.75);
+    EXPECT_EQ((QList<double>{0.25, 0.75}), m_widget1.m_values);
+    EXPECT_TRUE(m_widget2.m_values.isEmpty());
+
+    m_widget2.show();
+    EXPECT_EQ(QList<double>{0.75}, m_widget2.m_values);
+}
+
+TEST_F(ControlWidgetHubTest, MissingControl) {
+    TestWidget widget;
+    widget.connectControl(ConfigKey(QStringLiteral("[Test]"), QStringLiteral("missing")));
+    widget.setControlParameter(1.0);
+    EXPECT_TRUE(widget.m_values.isEmpty());
+}
+
+} // namespace
@@ -1,5 +1,6 @@
 #include <gtest/gtest.h>
 #include <QFileInfo>
+#include <QTemporaryDir>
 
 #include "library/coverartcache.h"
 #include "library/coverartutils.h"
@@ -88,3 +89,46 @@ TEST_F(CoverArtCacheTest, loadCoverFromFileAbsolute) {
             getTestDir().filePath(kCoverLocationTest),
             getTestDir().filePath(kCoverLocationTest));
 }
+
+TEST_F(CoverArtCacheTest, thumbnailWidth) {
+    EXPECT_EQ(0, CoverArtThumbnailCache::thumbnailWidth(0));
+    EXPECT_EQ(64, CoverArtThumbnailCache::thumbnailWidth(1));
+    EXPECT_EQ(128, CoverArtThumbnailCache::thumbnailWidth(100));
+    EXPECT_EQ(128, CoverArtThumbnailCache::thumbnailWidth(128));
+    EXPECT_EQ(0, CoverArtThumbnailCache::thumbnailWidth(4096));
+}
+
+TEST_F(CoverArtCacheTest, loadCoverFromThumbnailCache) {
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    const CoverArtThumbnailCache thumbnailCache(dir.path());
+
+    const QString coverLocation = getTestDir().filePath(kCoverLocationTest);
+    CoverInfo info;
+    info.type = CoverInfo::FILE;
+    info.source = CoverInfo::GUESSED;
+    info.coverLocation = coverLocation;
+    info.setImageDigest(QImage(coverLocation));
+    ASSERT_TRUE(CoverArtThumbnailCache::isCacheable(info));
+
+    const CoverArtCache::FutureResult loaded =
+            CoverArtCache::loadCover(TrackPointer(), info, 100, thumbnailCache);
+    EXPECT_EQ(coverLocation, loaded.coverArt.loadedImage.location);
+    EXPECT_EQ(100, loaded.coverArt.loadedImage.image.width());
+    const QString thumbnailFilePath = thumbnailCache.thumbnailFilePath(info, 128);
+    EXPECT_TRUE(QFileInfo::exists(thumbnailFilePath));
+
+    // The original image is not loaded again
+    const CoverArtCache::FutureResult cached =
+            CoverArtCache::loadCover(TrackPointer(), info, 100, thumbnailCache);
+    EXPECT_EQ(thumbnailFilePath, cached.coverArt.loadedImage.location);
+    EXPECT_EQ(loaded.coverArt.loadedImage.image.size(),
+            cached.coverArt.loadedImage.image.size());
+
+    // Unrelated covers are not affected
+    QImage otherImage(16, 16, QImage::Format_RGB32);
+    otherImage.fill(Qt::red);
+    CoverInfo otherInfo = info;
+    otherInfo.setImageDigest(otherImage);
+    EXPECT_TRUE(thumbnailCache.loadThumbnail(otherInfo, 128).isNull());
+}
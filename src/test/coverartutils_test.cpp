@@ -310,3 +310,43 @@ TEST_F(CoverArtUtilTest, searchImage) {
         QFile::remove(loc);
     }
 }
+
+TEST_F(CoverArtUtilTest, guessCoverInfoReloadsReplacedImage) {
+    QTemporaryDir tempDir;
+    ASSERT_TRUE(tempDir.isValid());
+    const QString trackLocation = tempDir.filePath(QStringLiteral("track.mp3"));
+    const QString coverLocation = tempDir.filePath(QStringLiteral("cover.png"));
+    const QImage image(getTestDir().filePath(kReferencePNGLocationTest));
+    ASSERT_FALSE(image.isNull());
+    ASSERT_TRUE(image.save(coverLocation));
+
+    CoverInfoGuesser guesser;
+    const auto coverInfo = guesser.guessCoverInfo(
+            mixxx::FileInfo(trackLocation), QString(), QImage());
+    EXPECT_EQ(CoverInfo::FILE, coverInfo.type);
+    EXPECT_EQ(QStringLiteral("cover.png"), coverInfo.coverLocation);
+    // Another track in the same folder reuses the loaded image
+    EXPECT_EQ(coverInfo,
+            guesser.guessCoverInfo(
+                    mixxx::FileInfo(tempDir.filePath(QStringLiteral("other.mp3"))),
+                    QString(),
+                    QImage()));
+
+    // Replace the image in place without modifying the folder
+    const QImage otherImage = image.scaled(10, 10);
+    ASSERT_TRUE(otherImage.save(coverLocation));
+    QFile coverFile(coverLocation);
+    ASSERT_TRUE(coverFile.open(QIODevice::ReadWrite));
+    ASSERT_TRUE(coverFile.setFileTime(QDateTime::currentDateTime().addSecs(60),
+            QFileDevice::FileModificationTime));
+    coverFile.close();
+
+    CoverInfoRelative expected;
+    expected.source = CoverInfo::GUESSED;
+    expected.type = CoverInfo::FILE;
+    expected.coverLocation = QStringLiteral("cover.png");
+    expected.setImageDigest(QImage(coverLocation));
+    EXPECT_EQ(expected,
+            guesser.guessCoverInfo(
+                    mixxx::FileInfo(trackLocation), QString(), QImage()));
+}
@@ -0,0 +1,32 @@
+#include "util/cpuaffinity.h"
+
+#include <gtest/gtest.h>
+
+namespace {
+
+using mixxx::CpuAffinity;
+
+TEST(CpuAffinityTest, ParseCoreList) {
+    EXPECT_EQ(QList<int>({3}), CpuAffinity::parseCoreList(QStringLiteral("3")));
+    EXPECT_EQ(QList<int>({2, 3, 6}),
+            CpuAffinity::parseCoreList(QStringLiteral("2-3,6")));
+    EXPECT_EQ(QList<int>({1, 2, 5}),
+            CpuAffinity::parseCoreList(QStringLiteral(" 5, 1-2 ,2")));
+}
+
+TEST(CpuAffinityTest, ParseInvalidCoreList) {
+    EXPECT_TRUE(CpuAffinity::parseCoreList(QString()).isEmpty());
+    EXPECT_TRUE(CpuAffinity::parseCoreList(QStringLiteral("a")).isEmpty());
+    EXPECT_TRUE(CpuAffinity::parseCoreList(QStringLiteral("3-1")).isEmpty());
+    EXPECT_TRUE(CpuAffinity::parseCoreList(QStringLiteral("1-2-3")).isEmpty());
+    EXPECT_TRUE(CpuAffinity::parseCoreList(QStringLiteral("-1")).isEmpty());
+}
+
+TEST(CpuAffinityTest, NotConfigured) {
+    CpuAffinity::configure(QString());
+    EXPECT_TRUE(CpuAffinity::engineCores().isEmpty());
+    EXPECT_FALSE(CpuAffinity::applyToCurrentThread(
+            CpuAffinity::ThreadRole::Background));
+}
+
+} // namespace
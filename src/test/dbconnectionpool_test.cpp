@@ -1,7 +1,10 @@
 #include <gtest/gtest.h>
 
+#include <QSqlQuery>
+
 #include "library/dao/settingsdao.h"
 #include "test/mixxxdbtest.h"
+#include "util/db/dbconnectionpooled.h"
 #include "util/db/dbconnectionpooler.h"
 
 class DbConnectionPoolTest : public MixxxTest {};
@@ -20,3 +23,14 @@ TEST_F(DbConnectionPoolTest, MoveSemantics) {
     EXPECT_TRUE(p1.isPooling());
     EXPECT_FALSE(p2.isPooling());
 }
+
+TEST_F(DbConnectionPoolTest, ReadOnly) {
+    const auto pDbConnectionPool = MixxxDb(config(), true).connectionPool();
+    const mixxx::DbConnectionPooler pooler(
+            pDbConnectionPool, mixxx::DbConnectionPool::AccessMode::ReadOnly);
+    ASSERT_TRUE(pooler.isPooling());
+
+    QSqlQuery query(mixxx::DbConnectionPooled(pDbConnectionPool));
+    EXPECT_TRUE(query.exec(QStringLiteral("SELECT 1")));
+    EXPECT_FALSE(query.exec(QStringLiteral("CREATE TABLE test (id INTEGER)")));
+}
@@ -0,0 +1,42 @@
+#include "mixer/decksnapshots.h"
+
+#include <gtest/gtest.h>
+
+namespace {
+
+TEST(DeckSnapshotsTest, RoundTrip) {
+    DeckSnapshot playing;
+    playing.group = QStringLiteral("[Channel1]");
+    playing.location = QStringLiteral("/music/Ünïcode track.flac");
+    playing.position = 0.4375;
+    playing.playing = true;
+    playing.rateRatio = 1.02;
+    playing.pitchAdjust = -1.5;
+    playing.loopStartPosition = 44100;
+    playing.loopEndPosition = 88200;
+    playing.loopEnabled = true;
+    playing.quickEffectEnabled = false;
+    playing.quickEffectSuper = 0.75;
+
+    DeckSnapshot empty;
+    empty.group = QStringLiteral("[Channel2]");
+
+    const QList<DeckSnapshot> snapshots{playing, empty};
+    const auto parsed = DeckSnapshots::parse(DeckSnapshots::serialize(snapshots));
+    ASSERT_TRUE(parsed);
+    EXPECT_EQ(snapshots, *parsed);
+}
+
+TEST(DeckSnapshotsTest, RejectsInvalidData) {
+    EXPECT_FALSE(DeckSnapshots::parse(QByteArray()));
+    // Truncated
+    const QByteArray data = DeckSnapshots::serialize(
+            {DeckSnapshot{QStringLiteral("[Channel1]")}});
+    EXPECT_FALSE(DeckSnapshots::parse(data.left(data.size() / 2)));
+    // Unknown version
+    EXPECT_FALSE(DeckSnapshots::parse(QByteArray(R"({"version":2,"decks":[]})")));
+    // Missing group
+    EXPECT_FALSE(DeckSnapshots::parse(QByteArray(R"({"version":1,"decks":[{}]})")));
+}
+
+} // namespace
@@ -0,0 +1,106 @@
+// Tests and benchmarks for the denormals are zero mode.
+//
+// The benchmarks measure the CPU load of the decaying tails of the DSP
+// kernels of the builtin effects, i.e. silence after an impulse, with the
+// mode disabled (argument 0) and enabled (argument 1). A large difference
+// means that the kernel relies on the mode. Run them with
+// `mixxx-test --benchmark --benchmark_filter=BM_DecayingTail`.
+#include <Reverb.h>
+#include <benchmark/benchmark.h>
+#include <gtest/gtest.h>
+
+#include <thread>
+
+#include "engine/filters/enginefilterbessel4.h"
+#include "engine/filters/enginefiltermoogladder4.h"
+#include "util/denormalsarezero.h"
+#include "util/samplebuffer.h"
+
+namespace {
+
+constexpr int kSampleRate = 44100;
+constexpr SINT kFramesPerBuffer = 1024;
+constexpr SINT kSamplesPerBuffer = 2 * kFramesPerBuffer;
+// Long enough for the tails to reach the denormal range
+constexpr int kDecayBuffers = 60 * kSampleRate / kFramesPerBuffer;
+
+TEST(DenormalsTest, EnableOnNewThread) {
+    bool enabled = false;
+    std::thread thread([&enabled] {
+        mixxx::enableDenormalsAreZero();
+        enabled = mixxx::denormalsAreZero();
+    });
+    thread.join();
+    EXPECT_TRUE(enabled);
+}
+
+#ifdef __SSE__
+class ScopedDenormalsMode {
+  public:
+    explicit ScopedDenormalsMode(bool denormalsAreZero)
+            : m_savedCsr(_mm_getcsr()) {
+        if (denormalsAreZero) {
+            mixxx::enableDenormalsAreZero();
+        } else {
+            _MM_SET_DENORMALS_ZERO_MODE(_MM_DENORMALS_ZERO_OFF);
+            _MM_SET_FLUSH_ZERO_MODE(_MM_FLUSH_ZERO_OFF);
+        }
+    }
+    ~ScopedDenormalsMode() {
+        _mm_setcsr(m_savedCsr);
+    }
+
+  private:
+    const unsigned int m_savedCsr;
+};
+
+/// Feeds an impulse and lets the tail decay before measuring the
+/// processing of silence.
+template<typename Process>
+void benchmarkDecayingTail(benchmark::State& state, Process process) {
+    const ScopedDenormalsMode mode(state.range(0) != 0);
+    mixxx::SampleBuffer input(kSamplesPerBuffer);
+    mixxx::SampleBuffer output(kSamplesPerBuffer);
+    input.clear();
+    input[0] = CSAMPLE_ONE;
+    input[1] = CSAMPLE_ONE;
+    process(input.data(), output.data());
+    input.clear();
+    for (int i = 0; i < kDecayBuffers; ++i) {
+        process(input.data(), output.data());
+    }
+    for (auto _ : state) {
+        process(input.data(), output.data());
+        benchmark::DoNotOptimize(output.data());
+    }
+    state.SetItemsProcessed(state.iterations() * kFramesPerBuffer);
+}
+
+void BM_DecayingTailMoogLadder4(benchmark::State& state) {
+    EngineFilterMoogLadder4Low filter(kSampleRate, 1000, 2);
+    benchmarkDecayingTail(state, [&filter](const CSAMPLE* pIn, CSAMPLE* pOut) {
+        filter.process(pIn, pOut, kSamplesPerBuffer);
+    });
+}
+
+void BM_DecayingTailBessel4(benchmark::State& state) {
+    EngineFilterBessel4Low filter(kSampleRate, 1000);
+    benchmarkDecayingTail(state, [&filter](const CSAMPLE* pIn, CSAMPLE* pOut) {
+        filter.process(pIn, pOut, kSamplesPerBuffer);
+    });
+}
+
+void BM_DecayingTailReverb(benchmark::State& state) {
+    MixxxPlateX2 reverb;
+    reverb.init(kSampleRate);
+    benchmarkDecayingTail(state, [&reverb](const CSAMPLE* pIn, CSAMPLE* pOut) {
+        reverb.processBuffer(pIn, pOut, kSamplesPerBuffer, 0.5f, 0.5f, 0.5f, 1.0f, 1.0f);
+    });
+}
+
+BENCHMARK(BM_DecayingTailMoogLadder4)->Arg(0)->Arg(1);
+BENCHMARK(BM_DecayingTailBessel4)->Arg(0)->Arg(1);
+BENCHMARK(BM_DecayingTailReverb)->Arg(0)->Arg(1);
+#endif
+
+} // namespace
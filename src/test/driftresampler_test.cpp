@@ -0,0 +1,152 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "soundio/driftresampler.h"
+
+namespace {
+
+constexpr int kChannels = 2;
+constexpr int kFrames = 256;
+constexpr double kSampleRate = 48000.0;
+
+class DriftResamplerTest : public ::testing::Test {
+  protected:
+    DriftResamplerTest() {
+        m_resampler.init(kChannels, kFrames + 8);
+    }
+
+    // A sine on the left channel, its inverse on the right one
+    void appendSine(int frames, double frequency) {
+        std::vector<CSAMPLE> input(frames * kChannels);
+        for (int i = 0; i < frames; ++i) {
+            const CSAMPLE sample = static_cast<CSAMPLE>(
+                    std::sin(2 * M_PI * frequency * m_inputFrames / kSampleRate));
+            input[i * kChannels] = sample;
+            input[i * kChannels + 1] = -sample;
+            ++m_inputFrames;
+        }
+        m_resampler.appendInput(input.data(), frames);
+    }
+
+    DriftResampler m_resampler;
+    int m_inputFrames = 0;
+};
+
+TEST_F(DriftResamplerTest, unityRatioDelaysByHalfTheTaps) {
+    EXPECT_EQ(kFrames, m_resampler.inputFramesNeeded(kFrames));
+    std::vector<CSAMPLE> input(kFrames * kChannels);
+    for (int i = 0; i < kFrames; ++i) {
+        input[i * kChannels] = static_cast<CSAMPLE>(i);
+        input[i * kChannels + 1] = static_cast<CSAMPLE>(-i);
+    }
+    m_resampler.appendInput(input.data(), kFrames);
+
+    std::vector<CSAMPLE> output(kFrames * kChannels);
+    EXPECT_EQ(kFrames, m_resampler.resample(output.data(), kFrames));
+    constexpr int kDelay = DriftResampler::kTaps / 2;
+    for (int i = 0; i < kDelay; ++i) {
+        EXPECT_NEAR(0, output[i * kChannels], 1e-6);
+    }
+    for (int i = kDelay; i < kFrames; ++i) {
+        EXPECT_NEAR(i - kDelay, output[i * kChannels], 1e-3);
+        EXPECT_NEAR(kDelay - i, output[i * kChannels + 1], 1e-3);
+    }
+}
+
+TEST_F(DriftResamplerTest, consumesExactlyTheNeededInput) {
+    std::vector<CSAMPLE> output(kFrames * kChannels);
+    int consumed = 0;
+    int produced = 0;
+    m_resampler.setRatio(1.001);
+    for (int i = 0; i < 200; ++i) {
+        const int needed = m_resampler.inputFramesNeeded(kFrames);
+        EXPECT_LE(needed, kFrames + 1);
+        appendSine(needed, 1000);
+        consumed += needed;
+        ASSERT_EQ(kFrames, m_resampler.resample(output.data(), kFrames));
+        produced += kFrames;
+        EXPECT_EQ(0, m_resampler.inputFramesNeeded(0));
+    }
+    EXPECT_NEAR(1.001, static_cast<double>(consumed) / produced, 1e-4);
+}
+
+TEST_F(DriftResamplerTest, sineStaysClean) {
+    // The output of a drifting stream is compared with the ideal sine at the
+    // resampled positions
+    constexpr double kRatio = 0.9995;
+    constexpr double kFrequency = 10000;
+    m_resampler.setRatio(kRatio);
+    std::vector<CSAMPLE> output(kFrames * kChannels);
+    double outputPosition = -DriftResampler::kTaps / 2;
+    double maxError = 0;
+    for (int i = 0; i < 50; ++i) {
+        appendSine(m_resampler.inputFramesNeeded(kFrames), kFrequency);
+        m_resampler.resample(output.data(), kFrames);
+        for (int frame = 0; frame < kFrames; ++frame) {
+            if (outputPosition > DriftResampler::kTaps) {
+                const double expected =
+                        std::sin(2 * M_PI * kFrequency * outputPosition / kSampleRate);
+                maxError = std::max(maxError,
+                        std::abs(expected - output[frame * kChannels]));
+                EXPECT_FLOAT_EQ(-output[frame * kChannels],
+                        output[frame * kChannels + 1]);
+            }
+            outputPosition += kRatio;
+        }
+    }
+    // Better than -60 dB
+    EXPECT_LT(maxError, 1e-3);
+}
+
+TEST_F(DriftResamplerTest, ratioIsLimited) {
+    m_resampler.setRatio(2.0);
+    EXPECT_DOUBLE_EQ(1.0 + DriftResampler::kMaxCorrection, m_resampler.ratio());
+    m_resampler.setRatio(0.5);
+    EXPECT_DOUBLE_EQ(1.0 - DriftResampler::kMaxCorrection, m_resampler.ratio());
+}
+
+TEST_F(DriftResamplerTest, resampleStopsWithoutInput) {
+    std::vector<CSAMPLE> output(kFrames * kChannels);
+    appendSine(10, 1000);
+    EXPECT_EQ(10, m_resampler.resample(output.data(), kFrames));
+    EXPECT_EQ(kFrames - 10, m_resampler.inputFramesNeeded(kFrames - 10));
+}
+
+TEST(ClockDriftControllerTest, followsTheDrift) {
+    // An output device that plays 100 ppm slower than the clock reference
+    // device fills its FIFO
+    constexpr double kDrift = 100e-6;
+    constexpr double kTarget = 2 * kFrames;
+    ClockDriftController controller;
+    controller.reset(kSampleRate, kTarget);
+    double fill = kTarget;
+    double ratio = 1.0;
+    double maxDeviation = 0;
+    for (int i = 0; i < 120 * kSampleRate / kFrames; ++i) {
+        fill += kFrames * (1.0 + kDrift) - kFrames * ratio;
+        ratio = controller.update(fill, kFrames);
+        maxDeviation = std::max(maxDeviation, std::abs(fill - kTarget));
+    }
+    EXPECT_NEAR(100.0, controller.driftPpm(), 1.0);
+    EXPECT_NEAR(kTarget, fill, 1.0);
+    // Never more than a few frames away from the target
+    EXPECT_LT(maxDeviation, 16);
+}
+
+TEST(ClockDriftControllerTest, jitterDoesNotMoveTheRatio) {
+    // One callback overtaking the other every second
+    constexpr double kTarget = 2 * kFrames;
+    ClockDriftController controller;
+    controller.reset(kSampleRate, kTarget);
+    double maxRatio = 1.0;
+    for (int i = 0; i < 1000; ++i) {
+        const double fill = i % 190 == 0 ? kTarget + kFrames : kTarget;
+        maxRatio = std::max(maxRatio, controller.update(fill, kFrames));
+    }
+    EXPECT_LT(maxRatio - 1.0, 50e-6);
+}
+
+} // namespace
@@ -0,0 +1,87 @@
+#include "encoder/encoderwave.h"
+
+#include <gtest/gtest.h>
+
+#include <QByteArray>
+#include <QtEndian>
+#include <cstring>
+#include <vector>
+
+#include "encoder/encodercallback.h"
+#include "encoder/encoderwavesettings.h"
+#include "recording/defs_recording.h"
+#include "test/mixxxtest.h"
+
+namespace {
+
+constexpr mixxx::audio::SampleRate kSampleRate(44100);
+
+// A file in memory
+class BufferCallback : public EncoderCallback {
+  public:
+    void write(const unsigned char* header,
+            const unsigned char* body,
+            int headerLen,
+            int bodyLen) override {
+        writeAtPos(header, headerLen);
+        writeAtPos(body, bodyLen);
+    }
+    qint64 tell() override {
+        return m_pos;
+    }
+    void seek(qint64 pos) override {
+        m_pos = pos;
+    }
+    qint64 filelen() override {
+        return m_data.size();
+    }
+
+    const QByteArray& data() const {
+        return m_data;
+    }
+
+  private:
+    void writeAtPos(const unsigned char* pData, int len) {
+        if (len <= 0) {
+            return;
+        }
+        if (m_pos + len > m_data.size()) {
+            m_data.resize(static_cast<int>(m_pos + len));
+        }
+        std::memcpy(m_data.data() + m_pos, pData, len);
+        m_pos += len;
+    }
+
+    QByteArray m_data;
+    qint64 m_pos = 0;
+};
+
+class EncoderWaveTest : public MixxxTest {
+};
+
+TEST_F(EncoderWaveTest, HeaderIsUpdatedWhileRecording) {
+    BufferCallback callback;
+    EncoderWave encoder(&callback);
+    encoder.setEncoderSettings(EncoderWaveSettings(config(), ENCODING_WAVE));
+    ASSERT_EQ(0, encoder.initEncoder(kSampleRate, nullptr));
+
+    // 11 seconds, the encoder is never closed like after a crash
+    const std::vector<CSAMPLE> buffer(2 * kSampleRate.value());
+    for (int i = 0; i < 11; ++i) {
+        encoder.encodeBuffer(buffer.data(), static_cast<int>(buffer.size()));
+    }
+
+    const QByteArray& data = callback.data();
+    ASSERT_GT(data.size(), 44);
+    EXPECT_EQ(QByteArray("RIFF"), data.left(4));
+    const int dataChunk = data.indexOf("data");
+    ASSERT_GT(dataChunk, 0);
+    // The header covers at least the first 10 seconds of 16 bit samples
+    const quint32 dataSize = qFromLittleEndian<quint32>(data.constData() + dataChunk + 4);
+    EXPECT_GE(dataSize, 10u * kSampleRate.value() * 2 * sizeof(qint16));
+    EXPECT_LE(dataSize, static_cast<quint32>(data.size() - dataChunk - 8));
+    // The samples are still appended to the end
+    EXPECT_EQ(data.size(), callback.tell());
+}
+
+} // namespace
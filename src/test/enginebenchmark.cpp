@@ -0,0 +1,233 @@
+// Benchmarks for the audio callback: EngineMixer::process() with playing
+// decks and samplers, keylock, EQs, QuickEffects and sync.
+//
+// Run with `mixxx-test --benchmark --benchmark_filter=BM_Engine` from the
+// source root, so the test tracks can be found. The arguments are the
+// buffer size in frames, the number of playing decks, the number of playing
+// samplers and whether keylock is enabled. The duration of the individual
+// callbacks is reported as percentiles in microseconds, the budget is the
+// duration of the buffer at 44.1 kHz.
+//
+// In builds with REALTIME_ALLOCATION_TRACKER=ON the benchmarks fail if the
+// engine allocates or locks a mutex, the stack traces are logged.
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+#include "effects/chains/equalizereffectchain.h"
+#include "effects/chains/quickeffectchain.h"
+#include "mixer/sampler.h"
+#include "test/signalpathtest.h"
+#include "util/performancetimer.h"
+#include "util/realtimeallocationtracker.h"
+
+// Allocations can not be counted if a sanitizer replaces operator new
+#if defined(__SANITIZE_ADDRESS__)
+#define MIXXX_ENGINE_BENCHMARK_NO_ALLOCATION_COUNT
+#elif defined(__has_feature)
+#if __has_feature(address_sanitizer) || __has_feature(memory_sanitizer)
+#define MIXXX_ENGINE_BENCHMARK_NO_ALLOCATION_COUNT
+#endif
+#endif
+
+namespace {
+
+// Only allocations of the callback thread while a callback is measured are
+// counted. The EngineMixer of the tests processes all channels on this
+// thread.
+thread_local bool t_countAllocations = false;
+thread_local std::size_t t_allocationCount = 0;
+
+class ScopedAllocationCount {
+  public:
+    ScopedAllocationCount() {
+        t_countAllocations = true;
+    }
+    ~ScopedAllocationCount() {
+        t_countAllocations = false;
+    }
+};
+
+} // namespace
+
+#ifndef MIXXX_ENGINE_BENCHMARK_NO_ALLOCATION_COUNT
+// Replaces the global operator new of mixxx-test. The array and nothrow
+// variants of the standard library forward to this one.
+void* operator new(std::size_t size) {
+    if (t_countAllocations) {
+        ++t_allocationCount;
+    }
+    void* pMemory = std::malloc(size > 0 ? size : 1);
+    if (!pMemory) {
+        throw std::bad_alloc();
+    }
+    return pMemory;
+}
+
+void operator delete(void* pMemory) noexcept {
+    std::free(pMemory);
+}
+
+void operator delete(void* pMemory, std::size_t) noexcept {
+    std::free(pMemory);
+}
+#endif
+
+/// Provides three decks with EQs and QuickEffects like PlayerManager creates
+/// them, plus samplers that are created on demand.
+class EngineBenchmark : public BaseSignalPathTest {
+  public:
+    static constexpr int kMaxSamplers = 4;
+
+    explicit EngineBenchmark(int numSamplers) {
+        const QList<Deck*> decks = {m_pMixerDeck1, m_pMixerDeck2, m_pMixerDeck3};
+        for (Deck* pDeck : decks) {
+            m_pEffectsManager->addDeck(
+                    m_pEngineMixer->registerChannelGroup(pDeck->getGroup()));
+        }
+        m_pEffectsManager->loadDefaultEqsAndQuickEffects();
+
+        for (int i = 0; i < numSamplers; ++i) {
+            const QString group = QStringLiteral("[Sampler%1]").arg(i + 1);
+            m_samplers.push_back(new Sampler(nullptr,
+                    m_pConfig,
+                    m_pEngineMixer,
+                    m_pEffectsManager,
+                    EngineChannel::CENTER,
+                    m_pEngineMixer->registerChannelGroup(group)));
+        }
+
+        m_pTrack = Track::newTemporary(
+                getTestDir().filePath(QStringLiteral("sine-30.wav")));
+        m_pTrack->trySetBpm(124.0);
+    }
+    ~EngineBenchmark() override {
+        for (Sampler* pSampler : m_samplers) {
+            delete pSampler;
+        }
+    }
+
+    /// Starts the given number of decks with sync, moved EQ and QuickEffect
+    /// knobs and a pitch fader that is off center, so the scalers have to
+    /// time stretch.
+    void playDecks(int numDecks, bool keylock) {
+        const QList<Deck*> decks = {m_pMixerDeck1, m_pMixerDeck2, m_pMixerDeck3};
+        for (int i = 0; i < numDecks && i < decks.size(); ++i) {
+            Deck* pDeck = decks[i];
+            const QString group = pDeck->getGroup();
+            loadTrack(pDeck, m_pTrack);
+            ControlObject::set(ConfigKey(group, "keylock"), keylock ? 1.0 : 0.0);
+            ControlObject::set(ConfigKey(group, "rate"), 0.05 * (i + 1));
+            ControlObject::set(ConfigKey(group, "sync_enabled"), 1.0);
+            ControlObject::set(ConfigKey(EqualizerEffectChain::formatEffectSlotGroup(group),
+                                       "parameter1"),
+                    0.5);
+            ControlObject::set(ConfigKey(QuickEffectChain::formatEffectChainGroup(group),
+                                       "super1"),
+                    0.3);
+            ControlObject::set(ConfigKey(group, "play"), 1.0);
+        }
+        for (Sampler* pSampler : m_samplers) {
+            loadTrack(pSampler, m_pTrack);
+            ControlObject::set(ConfigKey(pSampler->getGroup(), "play"), 1.0);
+        }
+    }
+
+    void process(int bufferSize) {
+        m_pEngineMixer->process(bufferSize);
+    }
+
+  private:
+    void TestBody() override {
+    }
+
+    std::vector<Sampler*> m_samplers;
+    TrackPointer m_pTrack;
+};
+
+namespace {
+
+void setDurationCounters(benchmark::State& state, std::vector<double>* pDurations) {
+    if (pDurations->empty()) {
+        return;
+    }
+    std::sort(pDurations->begin(), pDurations->end());
+    const auto percentile = [pDurations](double p) {
+        const auto index = static_cast<std::size_t>(p * (pDurations->size() - 1));
+        return (*pDurations)[index];
+    };
+    state.counters["p50_us"] = percentile(0.5);
+    state.counters["p99_us"] = percentile(0.99);
+    state.counters["p999_us"] = percentile(0.999);
+    state.counters["max_us"] = pDurations->back();
+}
+
+void BM_EngineProcess(benchmark::State& state) {
+    const auto bufferFrames = static_cast<int>(state.range(0));
+    const auto numDecks = static_cast<int>(state.range(1));
+    const auto numSamplers = static_cast<int>(state.range(2));
+    const bool keylock = state.range(3) != 0;
+    // The engine processes interleaved stereo samples
+    const int bufferSize = bufferFrames * 2;
+
+    EngineBenchmark environment(numSamplers);
+    environment.playDecks(numDecks, keylock);
+    // Settle sync, the effect messages and the read ahead of the decks
+    for (int i = 0; i < 50; ++i) {
+        environment.process(bufferSize);
+    }
+
+    std::vector<double> durations;
+    std::size_t allocationCount = 0;
+    const quint64 violationCountBefore =
+            mixxx::RealtimeAllocationTracker::violationCount();
+    PerformanceTimer timer;
+    for (auto _ : state) {
+        t_allocationCount = 0;
+        timer.start();
+        {
+            ScopedAllocationCount scopedCount;
+            environment.process(bufferSize);
+        }
+        durations.push_back(timer.elapsed().toDoubleMicros());
+        allocationCount += t_allocationCount;
+    }
+
+    const quint64 violationCount =
+            mixxx::RealtimeAllocationTracker::violationCount() - violationCountBefore;
+    if (violationCount > 0) {
+        mixxx::RealtimeAllocationTracker::logViolations();
+        state.SkipWithError("Heap allocations or mutex locks in the engine callback");
+        return;
+    }
+
+    state.SetItemsProcessed(state.iterations() * bufferFrames);
+    state.counters["budget_us"] = bufferFrames * 1000000.0 / 44100;
+    setDurationCounters(state, &durations);
+#ifndef MIXXX_ENGINE_BENCHMARK_NO_ALLOCATION_COUNT
+    state.counters["allocs_per_callback"] = benchmark::Counter(
+            static_cast<double>(allocationCount), benchmark::Counter::kAvgIterations);
+#else
+    Q_UNUSED(allocationCount);
+#endif
+}
+
+} // namespace
+
+BENCHMARK(BM_EngineProcess)
+        ->ArgNames({"frames", "decks", "samplers", "keylock"})
+        // Idle engine
+        ->Args({256, 0, 0, 0})
+        // A single deck without time stretching
+        ->Args({256, 1, 0, 0})
+        // Typical club setup at small, medium and large buffers
+        ->Args({64, 2, 0, 1})
+        ->Args({256, 2, 0, 1})
+        ->Args({1024, 2, 0, 1})
+        // Worst case
+        ->Args({64, 3, EngineBenchmark::kMaxSamplers, 1})
+        ->Args({256, 3, EngineBenchmark::kMaxSamplers, 1})
+        ->Unit(benchmark::kMicrosecond);
@@ -153,6 +153,30 @@ TEST_F(EngineBufferScaleLinearTest, ScaleConstant) {
     SampleUtil::free(pOutput);
 }
 
+TEST_F(EngineBufferScaleLinearTest, SampleRateConversionKeepsConstant) {
+    // Play a 44.1 kHz track at its original tempo on a 48 kHz engine
+    m_pScaler->setSampleRate(mixxx::audio::SampleRate(48000));
+    for (int i = 0; i < 2; ++i) {
+        double tempoRatio = 1.0;
+        double pitchRatio = 1.0;
+        m_pScaler->setScaleParameters(44100.0 / 48000.0, &tempoRatio, &pitchRatio);
+    }
+
+    CSAMPLE readBuffer[1] = {0.5f};
+    m_pReadAheadMock->setReadBuffer(readBuffer, 1);
+
+    // Tell the RAMAN mock to invoke getNextSamplesFake
+    EXPECT_CALL(*m_pReadAheadMock, getNextSamples(_, _, _))
+            .WillRepeatedly(Invoke(m_pReadAheadMock, &ReadAheadManagerMock::getNextSamplesFake));
+
+    CSAMPLE* pOutput = SampleUtil::alloc(kiLinearScaleReadAheadLength);
+    m_pScaler->scaleBuffer(pOutput, kiLinearScaleReadAheadLength);
+    // The interpolation with the previous buffer affects the first frame
+    AssertWholeBufferEquals(pOutput + 2, 0.5f, kiLinearScaleReadAheadLength - 2);
+
+    SampleUtil::free(pOutput);
+}
+
 TEST_F(EngineBufferScaleLinearTest, UnityRateIsSamplePerfect) {
     SetRateNoLerp(1.0);
 
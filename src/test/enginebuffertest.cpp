@@ -195,6 +195,22 @@ TEST_F(EngineBufferTest, VinylScalerRampZero) {
     EXPECT_EQ(m_pMockScaleVinyl1->getProcessedTempo(), 0.0);
 }
 
+TEST_F(EngineBufferTest, VinylScalerAveragesScratch2) {
+    // The values of scratch2 between two callbacks are averaged
+    ControlObject::set(ConfigKey(m_sGroup1, "scratch2_enable"), 1.0);
+    ControlObject::set(ConfigKey(m_sGroup1, "scratch2"), 0.5);
+    ControlObject::set(ConfigKey(m_sGroup1, "scratch2"), 1.5);
+    ControlObject::set(ConfigKey(m_sGroup1, "scratch2"), 1.5);
+
+    ProcessBuffer();
+    EXPECT_EQ(m_pMockScaleVinyl1, m_pChannel1->getEngineBuffer()->m_pScale);
+    EXPECT_DOUBLE_EQ(m_pMockScaleVinyl1->getProcessedTempo(), 7.0 / 6.0);
+
+    // Without new values the current value is used
+    ProcessBuffer();
+    EXPECT_DOUBLE_EQ(m_pMockScaleVinyl1->getProcessedTempo(), 1.5);
+}
+
 TEST_F(EngineBufferTest, ReadFadeOut) {
     // Start playing
     ControlObject::set(ConfigKey(m_sGroup1, "play"), 1.0);
@@ -0,0 +1,122 @@
+#include <gtest/gtest.h>
+
+#include <QHash>
+#include <QThread>
+#include <atomic>
+#include <vector>
+
+#include "engine/enginechannelworkerpool.h"
+#include "engine/enginescratchbuffers.h"
+
+namespace {
+
+constexpr int kMaxJobs = 64;
+
+class EngineChannelWorkerPoolTest : public testing::Test {
+  protected:
+    EngineChannelWorkerPoolTest()
+            : m_jobCounts(kMaxJobs),
+              m_jobThreads(kMaxJobs) {
+        for (auto& count : m_jobCounts) {
+            count = 0;
+        }
+    }
+
+    static void processJob(void* pContext, int jobIndex) {
+        auto* pTest = static_cast<EngineChannelWorkerPoolTest*>(pContext);
+        pTest->m_jobCounts[jobIndex].fetch_add(1);
+        pTest->m_jobThreads[jobIndex] = QThread::currentThread();
+    }
+
+    void resetJobs() {
+        for (int i = 0; i < kMaxJobs; ++i) {
+            m_jobCounts[i] = 0;
+            m_jobThreads[i] = nullptr;
+        }
+    }
+
+    std::vector<std::atomic<int>> m_jobCounts;
+    std::vector<QThread*> m_jobThreads;
+};
+
+TEST_F(EngineChannelWorkerPoolTest, ProcessesEachJobExactlyOnce) {
+    EngineChannelWorkerPool pool(3, false, &processJob, this);
+    ASSERT_EQ(3, pool.numWorkers());
+    for (int numJobs = 0; numJobs <= kMaxJobs; ++numJobs) {
+        resetJobs();
+        pool.start(numJobs);
+        pool.finish();
+        for (int i = 0; i < kMaxJobs; ++i) {
+            EXPECT_EQ(i < numJobs ? 1 : 0, m_jobCounts[i].load())
+                    << "numJobs = " << numJobs << ", i = " << i;
+        }
+    }
+}
+
+TEST_F(EngineChannelWorkerPoolTest, CallerMayDoOtherWorkBeforeFinish) {
+    EngineChannelWorkerPool pool(2, false, &processJob, this);
+    for (int batch = 0; batch < 1000; ++batch) {
+        resetJobs();
+        pool.start(4);
+        // Work on the callback thread in the meantime, e.g. the sync lock
+        // channel
+        QThread::yieldCurrentThread();
+        pool.finish();
+        for (int i = 0; i < 4; ++i) {
+            ASSERT_EQ(1, m_jobCounts[i].load()) << "batch = " << batch;
+            ASSERT_NE(nullptr, m_jobThreads[i]);
+        }
+    }
+}
+
+TEST_F(EngineChannelWorkerPoolTest, NumWorkersIsClamped) {
+    EngineChannelWorkerPool pool(
+            EngineChannelWorkerPool::kMaxWorkers + 1, false, &processJob, this);
+    EXPECT_EQ(EngineChannelWorkerPool::kMaxWorkers, pool.numWorkers());
+}
+
+struct ScratchBuffersContext {
+    EngineScratchBuffers scratchBuffers;
+    std::vector<QThread*> jobThreads = std::vector<QThread*>(kMaxJobs);
+    std::vector<CSAMPLE*> jobBuffers = std::vector<CSAMPLE*>(kMaxJobs);
+};
+
+void processScratchBuffersJob(void* pContext, int jobIndex) {
+    auto* pScratchContext = static_cast<ScratchBuffersContext*>(pContext);
+    pScratchContext->jobThreads[jobIndex] = QThread::currentThread();
+    CSAMPLE* pBuffer = pScratchContext->scratchBuffers.buffer(
+            EngineScratchBuffers::Role::EffectChainIntermediate1);
+    pScratchContext->jobBuffers[jobIndex] = pBuffer;
+    // Other threads must not touch the buffer concurrently
+    pBuffer[0] = static_cast<CSAMPLE>(jobIndex);
+    QThread::yieldCurrentThread();
+    EXPECT_EQ(static_cast<CSAMPLE>(jobIndex), pBuffer[0]);
+}
+
+TEST_F(EngineChannelWorkerPoolTest, WorkersUseTheirOwnScratchBuffers) {
+    ScratchBuffersContext context;
+    EngineChannelWorkerPool pool(3, false, &processScratchBuffersJob, &context);
+    context.scratchBuffers.reserveThreads(pool.numWorkers() + 1);
+    EXPECT_NE(context.scratchBuffers.buffer(
+                      EngineScratchBuffers::Role::EffectChainIntermediate1),
+            context.scratchBuffers.buffer(
+                    EngineScratchBuffers::Role::EffectChainIntermediate2));
+    for (int batch = 0; batch < 100; ++batch) {
+        pool.start(kMaxJobs);
+        pool.finish();
+        QHash<QThread*, CSAMPLE*> bufferOfThread;
+        for (int i = 0; i < kMaxJobs; ++i) {
+            QThread* pThread = context.jobThreads[i];
+            ASSERT_NE(nullptr, pThread);
+            const auto it = bufferOfThread.constFind(pThread);
+            if (it == bufferOfThread.constEnd()) {
+                EXPECT_FALSE(bufferOfThread.values().contains(context.jobBuffers[i]));
+                bufferOfThread.insert(pThread, context.jobBuffers[i]);
+            } else {
+                EXPECT_EQ(it.value(), context.jobBuffers[i]);
+            }
+        }
+    }
+}
+
+} // namespace
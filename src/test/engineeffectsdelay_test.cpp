@@ -350,6 +350,57 @@ TEST_F(EngineEffectsDelayTest, CopyWholeBufferForZeroDelay) {
     AssertIdenticalBufferEquals(pInOut.span(), secondExpectedResult);
 }
 
+// Test's purpose is to test wrapping around the end of the delay buffer
+// with the longest possible delay, where a buffer is copied from and to
+// the delay buffer in several segments.
+TEST_F(EngineEffectsDelayTest, MaximumDelayWrapsAroundDelayBuffer) {
+    const SINT numSamples = 1026;
+    const SINT numDelaySamples = kMaxDelayFrames * mixxx::kEngineChannelCount;
+    // Long enough to reach the delayed signal after wrapping around twice
+    const SINT numBuffers = 2 * kDelayBufferSize / numSamples + 2;
+
+    mixxx::SampleBuffer pInOut(numSamples);
+    const auto inputSample = [](SINT position) {
+        return static_cast<CSAMPLE>(position % 997) / 997.0f;
+    };
+
+    // Fills the delay buffer without delay first.
+    SINT position = 0;
+    for (; position < numDelaySamples; position += numSamples) {
+        for (SINT i = 0; i < numSamples; ++i) {
+            pInOut[i] = inputSample(position + i);
+        }
+        m_effectsDelay.process(pInOut.data(), numSamples);
+    }
+
+    m_effectsDelay.setDelayFrames(kMaxDelayFrames);
+    // Crossfades from no delay to the maximum delay.
+    for (SINT i = 0; i < numSamples; ++i) {
+        pInOut[i] = inputSample(position + i);
+    }
+    m_effectsDelay.process(pInOut.data(), numSamples);
+    for (SINT i = 0; i < numSamples; ++i) {
+        const CSAMPLE_GAIN crossMix = static_cast<CSAMPLE_GAIN>(i) / numSamples;
+        EXPECT_NEAR(inputSample(position + i) * (1.0f - crossMix) +
+                        inputSample(position + i - numDelaySamples) * crossMix,
+                pInOut[i],
+                1e-6f);
+    }
+    position += numSamples;
+
+    for (SINT buffer = 0; buffer < numBuffers; ++buffer) {
+        for (SINT i = 0; i < numSamples; ++i) {
+            pInOut[i] = inputSample(position + i);
+        }
+        m_effectsDelay.process(pInOut.data(), numSamples);
+        for (SINT i = 0; i < numSamples; ++i) {
+            ASSERT_EQ(inputSample(position + i - numDelaySamples), pInOut[i])
+                    << "position = " << position + i;
+        }
+        position += numSamples;
+    }
+}
+
 static void BM_ZeroDelay(benchmark::State& state) {
     const SINT bufferSizeInSamples = static_cast<SINT>(state.range(0));
 
@@ -450,3 +501,19 @@ static void BM_DelayNoCrossfading(benchmark::State& state) {
 BENCHMARK(BM_DelayNoCrossfading)->Range(64, 4 << 10);
 
 } // namespace
+
+static void BM_MaximumDelay(benchmark::State& state) {
+    const SINT bufferSizeInSamples = static_cast<SINT>(state.range(0));
+
+    EngineEffectsDelay effectsDelay;
+
+    mixxx::SampleBuffer pInOut(bufferSizeInSamples);
+    SampleUtil::fill(pInOut.data(), 0.0f, bufferSizeInSamples);
+
+    effectsDelay.setDelayFrames(kMaxDelayFrames);
+
+    for (auto _ : state) {
+        effectsDelay.process(pInOut.data(), bufferSizeInSamples);
+    }
+}
+BENCHMARK(BM_MaximumDelay)->Range(64, 4 << 10);
@@ -0,0 +1,100 @@
+#include <benchmark/benchmark.h>
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+#include "engine/filters/enginefilterbessel4.h"
+#include "engine/filters/enginefilterbessel8.h"
+#include "engine/filters/enginefilterbiquad1.h"
+#include "engine/filters/enginefilterlinkwitzriley8.h"
+#include "util/samplebuffer.h"
+
+namespace {
+
+constexpr int kSampleRate = 44100;
+constexpr int kBufferSize = 1024;
+
+// Exposes the scalar implementation that is used as a reference
+template<class Filter>
+class ReferenceFilter : public Filter {
+  public:
+    using Filter::Filter;
+    using Filter::processSample;
+};
+
+void fillTestSignal(CSAMPLE* pBuffer, int bufferSize) {
+    for (int i = 0; i < bufferSize; i += 2) {
+        pBuffer[i] = static_cast<CSAMPLE>(std::sin(i * 0.01));
+        pBuffer[i + 1] = static_cast<CSAMPLE>(0.5 * std::cos(i * 0.037));
+    }
+}
+
+template<class Filter, unsigned int SIZE, typename... Args>
+void assertStereoMatchesScalar(Args... args) {
+    ReferenceFilter<Filter> filter(kSampleRate, args...);
+    filter.assumeSettled();
+    double leftBuf[SIZE] = {};
+    double rightBuf[SIZE] = {};
+
+    mixxx::SampleBuffer input(kBufferSize);
+    mixxx::SampleBuffer output(kBufferSize);
+    fillTestSignal(input.data(), kBufferSize);
+    for (int buffer = 0; buffer < 4; ++buffer) {
+        filter.process(input.data(), output.data(), kBufferSize);
+        for (int i = 0; i < kBufferSize; i += 2) {
+            const double left = filter.processSample(
+                    filter.coefficients(), leftBuf, static_cast<double>(input[i]));
+            const double right = filter.processSample(
+                    filter.coefficients(), rightBuf, static_cast<double>(input[i + 1]));
+            ASSERT_FLOAT_EQ(static_cast<CSAMPLE>(left), output[i]);
+            ASSERT_FLOAT_EQ(static_cast<CSAMPLE>(right), output[i + 1]);
+        }
+    }
+}
+
+TEST(EngineFilterIIRTest, StereoMatchesScalar) {
+    assertStereoMatchesScalar<EngineFilterBessel4Low, 4>(600.0);
+    assertStereoMatchesScalar<EngineFilterBessel4Band, 8>(600.0, 2500.0);
+    assertStereoMatchesScalar<EngineFilterBessel8High, 8>(2500.0);
+    assertStereoMatchesScalar<EngineFilterBessel8Band, 16>(600.0, 2500.0);
+    assertStereoMatchesScalar<EngineFilterLinkwitzRiley8Low, 8>(600.0);
+    assertStereoMatchesScalar<EngineFilterBiquad1Peaking, 5>(1000.0, 1.75);
+}
+
+template<class Filter, typename... Args>
+void benchmarkFilter(benchmark::State& state, Args... args) {
+    const int bufferSize = static_cast<int>(state.range(0));
+    Filter filter(kSampleRate, args...);
+    filter.assumeSettled();
+
+    mixxx::SampleBuffer input(bufferSize);
+    mixxx::SampleBuffer output(bufferSize);
+    fillTestSignal(input.data(), bufferSize);
+
+    for (auto _ : state) {
+        filter.process(input.data(), output.data(), bufferSize);
+        benchmark::DoNotOptimize(output.data());
+    }
+}
+
+static void BM_Bessel4Low(benchmark::State& state) {
+    benchmarkFilter<EngineFilterBessel4Low>(state, 600.0);
+}
+BENCHMARK(BM_Bessel4Low)->Range(64, 4 << 10);
+
+static void BM_Bessel8Band(benchmark::State& state) {
+    benchmarkFilter<EngineFilterBessel8Band>(state, 600.0, 2500.0);
+}
+BENCHMARK(BM_Bessel8Band)->Range(64, 4 << 10);
+
+static void BM_LinkwitzRiley8High(benchmark::State& state) {
+    benchmarkFilter<EngineFilterLinkwitzRiley8High>(state, 2500.0);
+}
+BENCHMARK(BM_LinkwitzRiley8High)->Range(64, 4 << 10);
+
+static void BM_Biquad1Peaking(benchmark::State& state) {
+    benchmarkFilter<EngineFilterBiquad1Peaking>(state, 1000.0, 1.75);
+}
+BENCHMARK(BM_Biquad1Peaking)->Range(64, 4 << 10);
+
+} // namespace
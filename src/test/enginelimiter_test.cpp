@@ -0,0 +1,90 @@
+#include "engine/enginelimiter.h"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+#include "engine/engine.h"
+#include "test/mixxxtest.h"
+#include "util/math.h"
+#include "util/samplebuffer.h"
+
+namespace {
+
+constexpr int kBufferSize = 1024;
+
+class EngineLimiterTest : public MixxxTest {
+  protected:
+    EngineLimiterTest()
+            : m_buffer(kBufferSize) {
+        m_limiter.setSampleRate(mixxx::audio::SampleRate(44100));
+    }
+
+    void fillSine(CSAMPLE amplitude, int firstFrame) {
+        for (int i = 0; i < kBufferSize / mixxx::kEngineChannelCount; ++i) {
+            const auto value = static_cast<CSAMPLE>(
+                    amplitude * std::sin(2 * M_PI * 1000 * (firstFrame + i) / 44100));
+            m_buffer.data()[i * 2] = value;
+            m_buffer.data()[i * 2 + 1] = value;
+        }
+    }
+
+    EngineLimiter m_limiter;
+    mixxx::SampleBuffer m_buffer;
+};
+
+TEST_F(EngineLimiterTest, DelaysWithUnityGainBelowCeiling) {
+    m_limiter.setCeiling(CSAMPLE_GAIN_ONE);
+    const int latency = static_cast<int>(m_limiter.latencyFrames());
+    ASSERT_LT(latency, kBufferSize / mixxx::kEngineChannelCount);
+
+    m_buffer.clear();
+    m_buffer.data()[0] = 0.5f;
+    m_buffer.data()[1] = -0.25f;
+    m_limiter.process(m_buffer.data(), kBufferSize);
+
+    for (int i = 0; i < kBufferSize; ++i) {
+        if (i == latency * 2) {
+            EXPECT_FLOAT_EQ(0.5f, m_buffer.data()[i]);
+        } else if (i == latency * 2 + 1) {
+            EXPECT_FLOAT_EQ(-0.25f, m_buffer.data()[i]);
+        } else {
+            EXPECT_EQ(0.0f, m_buffer.data()[i]) << "at sample " << i;
+        }
+    }
+    EXPECT_EQ(CSAMPLE_GAIN_ONE, m_limiter.gainReduction());
+}
+
+TEST_F(EngineLimiterTest, StaysBelowCeiling) {
+    const CSAMPLE_GAIN ceiling = db2ratio(-1.0f);
+    m_limiter.setCeiling(ceiling);
+
+    CSAMPLE lastPeak = 0;
+    for (int block = 0; block < 20; ++block) {
+        fillSine(2.0f, block * kBufferSize / mixxx::kEngineChannelCount);
+        m_limiter.process(m_buffer.data(), kBufferSize);
+        lastPeak = 0;
+        for (int i = 0; i < kBufferSize; ++i) {
+            ASSERT_LE(std::fabs(m_buffer.data()[i]), ceiling);
+            lastPeak = math_max(lastPeak, std::fabs(m_buffer.data()[i]));
+        }
+    }
+    // The steady signal is limited to the ceiling instead of being silenced
+    EXPECT_GT(lastPeak, 0.9f * ceiling);
+    EXPECT_LT(m_limiter.gainReduction(), 0.5f);
+}
+
+TEST_F(EngineLimiterTest, ResetClearsDelayedSamples) {
+    m_limiter.setCeiling(CSAMPLE_GAIN_ONE);
+    fillSine(0.5f, 0);
+    m_limiter.process(m_buffer.data(), kBufferSize);
+
+    m_limiter.reset();
+    m_buffer.clear();
+    m_limiter.process(m_buffer.data(), kBufferSize);
+    for (int i = 0; i < kBufferSize; ++i) {
+        EXPECT_EQ(0.0f, m_buffer.data()[i]) << "at sample " << i;
+    }
+}
+
+} // namespace
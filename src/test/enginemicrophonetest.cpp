@@ -111,4 +111,24 @@ TEST_F(EngineMicrophoneTest, TestRepeatedInputMatchesOutput) {
     }
 }
 
+TEST_F(EngineMicrophoneTest, TestSubBlocksTakeTheirPartOfTheInput) {
+    AudioInput micInput = AudioInput(AudioPathType::Microphone, 0, 1, 0);
+    m_pTalkover->set(1.0);
+
+    const int subBlockLength = outputLength / 4;
+    FillSequentialWithStride<CSAMPLE>(input, 0, 0.001f, 1.0f, 2, inputLength);
+    m_pMicrophone->receiveBuffer(micInput, input, inputLength / 2);
+
+    for (int i = 0; i < 4; i++) {
+        ClearBuffer(output, outputLength);
+        m_pMicrophone->process(output, subBlockLength);
+        AssertBuffersEqual<CSAMPLE>(output, input + i * subBlockLength, subBlockLength);
+    }
+
+    // The input buffer has been used up
+    FillBuffer(output, 0.1f, outputLength);
+    m_pMicrophone->process(output, subBlockLength);
+    AssertWholeBufferEquals(output, 0.0f, subBlockLength);
+}
+
 }  // namespace
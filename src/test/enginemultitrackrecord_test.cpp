@@ -0,0 +1,87 @@
+#include "engine/sidechain/enginemultitrackrecord.h"
+
+#include <gtest/gtest.h>
+
+#include <QFile>
+#include <QTemporaryDir>
+#include <QtEndian>
+#include <vector>
+
+namespace {
+
+constexpr int kFrames = 64;
+constexpr int kTracks = 2;
+constexpr qint64 kDataOffset = 4096;
+
+std::vector<CSAMPLE> makeTrack(CSAMPLE left, CSAMPLE right) {
+    std::vector<CSAMPLE> buffer(2 * kFrames);
+    for (int frame = 0; frame < kFrames; ++frame) {
+        buffer[2 * frame] = left;
+        buffer[2 * frame + 1] = right;
+    }
+    return buffer;
+}
+
+TEST(EngineMultitrackRecordTest, InterleavesTracks) {
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    const QString fileName = dir.filePath(QStringLiteral("test.stems.caf"));
+    const std::vector<CSAMPLE> deck1 = makeTrack(0.1f, 0.2f);
+    const std::vector<CSAMPLE> deck2 = makeTrack(0.3f, 0.4f);
+
+    EngineMultitrackRecord record;
+    ASSERT_TRUE(record.startRecording(
+            fileName, mixxx::audio::SampleRate(44100), kTracks, false));
+    EXPECT_TRUE(record.isRecording(false));
+    EXPECT_FALSE(record.isRecording(true));
+
+    record.beginBlock(kFrames);
+    record.addTrack(1, deck2.data());
+    record.addTrack(0, deck1.data());
+    record.endBlock();
+    // The second deck is not playing
+    record.beginBlock(kFrames);
+    record.addTrack(0, deck1.data());
+    record.endBlock();
+    record.stopRecording();
+    EXPECT_FALSE(record.isRecording(false));
+
+    QFile file(fileName);
+    ASSERT_TRUE(file.open(QIODevice::ReadOnly));
+    const QByteArray data = file.readAll();
+    const qint64 audioBytes = 2 * kFrames * kTracks * 2 * sizeof(CSAMPLE);
+    ASSERT_EQ(kDataOffset + audioBytes, data.size());
+    EXPECT_EQ(QByteArray("caff"), data.left(4));
+    EXPECT_EQ(QByteArray("data"), data.mid(kDataOffset - 16, 4));
+    EXPECT_EQ(4 + audioBytes,
+            qFromBigEndian<qint64>(data.constData() + kDataOffset - 12));
+
+    const auto* pSamples = reinterpret_cast<const CSAMPLE*>(
+            data.constData() + kDataOffset);
+    EXPECT_EQ(0.1f, pSamples[0]);
+    EXPECT_EQ(0.2f, pSamples[1]);
+    EXPECT_EQ(0.3f, pSamples[2]);
+    EXPECT_EQ(0.4f, pSamples[3]);
+    const int secondBlock = kFrames * kTracks * 2;
+    EXPECT_EQ(0.1f, pSamples[secondBlock]);
+    EXPECT_EQ(0.0f, pSamples[secondBlock + 2]);
+    EXPECT_EQ(0.0f, pSamples[secondBlock + 3]);
+}
+
+TEST(EngineMultitrackRecordTest, WritesCueFile) {
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    const QString fileName = dir.filePath(QStringLiteral("test.stems.caf"));
+
+    EngineMultitrackRecord record;
+    ASSERT_TRUE(record.startRecording(
+            fileName, mixxx::audio::SampleRate(48000), kTracks, true));
+    EXPECT_TRUE(record.isRecording(true));
+    record.stopRecording();
+
+    QFile cueFile(EngineMultitrackRecord::cueFileName(fileName));
+    ASSERT_TRUE(cueFile.open(QIODevice::ReadOnly));
+    EXPECT_TRUE(cueFile.readAll().contains("FILE \"test.stems.caf\" WAVE"));
+}
+
+} // namespace
@@ -0,0 +1,141 @@
+#include "engine/engineprofiler.h"
+
+#include <gtest/gtest.h>
+
+#include <QThread>
+#include <memory>
+#include <vector>
+
+namespace {
+
+class EngineProfilerTest : public testing::Test {
+  protected:
+    void TearDown() override {
+        EngineProfiler& profiler = EngineProfiler::instance();
+        profiler.setEnabled(false);
+        // Drain the records of the test
+        std::vector<EngineProfiler::Record> records(EngineProfiler::kRingSize);
+        profiler.read(records.data(), EngineProfiler::kRingSize);
+    }
+};
+
+TEST_F(EngineProfilerTest, RegisterStage) {
+    EngineProfiler profiler;
+    EXPECT_EQ(QStringLiteral("Callback"),
+            profiler.stageName(EngineProfiler::kCallbackStage));
+    const auto stage = profiler.registerStage(QStringLiteral("[Channel1]"));
+    EXPECT_NE(EngineProfiler::kCallbackStage, stage);
+    EXPECT_EQ(stage, profiler.registerStage(QStringLiteral("[Channel1]")));
+    EXPECT_NE(stage, profiler.registerStage(QStringLiteral("[Channel2]")));
+    EXPECT_EQ(QStringLiteral("[Channel1]"), profiler.stageName(stage));
+}
+
+TEST_F(EngineProfilerTest, ReadRecordsInOrder) {
+    EngineProfiler profiler;
+    const auto stage = profiler.registerStage(QStringLiteral("Stage"));
+    for (int i = 0; i < 10; ++i) {
+        profiler.record(stage, i * 100, i, 1);
+    }
+    EngineProfiler::Record records[20];
+    ASSERT_EQ(10, profiler.read(records, 20));
+    for (int i = 0; i < 10; ++i) {
+        EXPECT_EQ(stage, records[i].stage);
+        EXPECT_EQ(i * 100, records[i].startNanos);
+        EXPECT_EQ(i, records[i].durationNanos);
+        EXPECT_EQ(1, records[i].depth);
+    }
+    EXPECT_EQ(0, profiler.read(records, 20));
+}
+
+TEST_F(EngineProfilerTest, DropRecordsIfFull) {
+    EngineProfiler profiler;
+    for (int i = 0; i < EngineProfiler::kRingSize + 5; ++i) {
+        profiler.record(EngineProfiler::kCallbackStage, i, 1, 0);
+    }
+    EXPECT_EQ(5u, profiler.droppedCount());
+
+    std::vector<EngineProfiler::Record> records(EngineProfiler::kRingSize + 5);
+    ASSERT_EQ(EngineProfiler::kRingSize,
+            profiler.read(records.data(), static_cast<int>(records.size())));
+    // The oldest records are kept
+    EXPECT_EQ(0, records.front().startNanos);
+    EXPECT_EQ(EngineProfiler::kRingSize - 1, records[EngineProfiler::kRingSize - 1].startNanos);
+
+    // Space is available again after reading
+    profiler.record(EngineProfiler::kCallbackStage, 42, 1, 0);
+    ASSERT_EQ(1, profiler.read(records.data(), 1));
+    EXPECT_EQ(42, records.front().startNanos);
+}
+
+TEST_F(EngineProfilerTest, ConcurrentWriters) {
+    constexpr int kNumThreads = 4;
+    constexpr int kRecordsPerThread = 1000;
+    static_assert(kNumThreads * kRecordsPerThread <= EngineProfiler::kRingSize);
+
+    EngineProfiler profiler;
+    std::vector<std::unique_ptr<QThread>> threads;
+    for (int i = 0; i < kNumThreads; ++i) {
+        threads.emplace_back(QThread::create([&profiler, i] {
+            for (int j = 0; j < kRecordsPerThread; ++j) {
+                profiler.record(static_cast<EngineProfiler::StageId>(i), j, 1, 0);
+            }
+        }));
+        threads.back()->start();
+    }
+    for (const auto& pThread : threads) {
+        pThread->wait();
+    }
+
+    std::vector<EngineProfiler::Record> records(EngineProfiler::kRingSize);
+    ASSERT_EQ(kNumThreads * kRecordsPerThread,
+            profiler.read(records.data(), EngineProfiler::kRingSize));
+    EXPECT_EQ(0u, profiler.droppedCount());
+    // The records of each thread are in order
+    std::vector<int> nextStart(kNumThreads, 0);
+    for (int i = 0; i < kNumThreads * kRecordsPerThread; ++i) {
+        const auto& record = records[i];
+        EXPECT_EQ(nextStart[record.stage]++, record.startNanos);
+    }
+}
+
+TEST_F(EngineProfilerTest, ScopedEngineProfileIsIgnoredWhileDisabled) {
+    EngineProfiler& profiler = EngineProfiler::instance();
+    profiler.setEnabled(false);
+    const auto stage = profiler.registerStage(QStringLiteral("Disabled"));
+    {
+        ScopedEngineProfile profile(stage);
+    }
+    EngineProfiler::Record record;
+    EXPECT_EQ(0, profiler.read(&record, 1));
+}
+
+TEST_F(EngineProfilerTest, ScopedEngineProfileNesting) {
+    EngineProfiler& profiler = EngineProfiler::instance();
+    const auto outerStage = profiler.registerStage(QStringLiteral("Outer"));
+    const auto innerStage = profiler.registerStage(QStringLiteral("Inner"));
+    profiler.setEnabled(true);
+    profiler.beginCallback();
+    {
+        ScopedEngineProfile outer(outerStage);
+        ScopedEngineProfile inner(innerStage);
+    }
+    profiler.endCallback(1000000);
+
+    EngineProfiler::Record records[4];
+    ASSERT_EQ(3, profiler.read(records, 4));
+    // Records are written when the stage ends
+    EXPECT_EQ(innerStage, records[0].stage);
+    EXPECT_EQ(2, records[0].depth);
+    EXPECT_EQ(outerStage, records[1].stage);
+    EXPECT_EQ(1, records[1].depth);
+    EXPECT_EQ(EngineProfiler::kCallbackStage, records[2].stage);
+    EXPECT_EQ(0, records[2].depth);
+    EXPECT_EQ(1000000, records[2].budgetNanos);
+    // All records belong to the same callback
+    EXPECT_EQ(records[2].callback, records[0].callback);
+    EXPECT_EQ(records[2].callback, records[1].callback);
+    EXPECT_LE(records[2].startNanos, records[1].startNanos);
+    EXPECT_LE(records[1].startNanos, records[0].startNanos);
+}
+
+} // namespace
@@ -0,0 +1,119 @@
+#include "engine/sidechain/enginesidechain.h"
+
+#include <gtest/gtest.h>
+
+#include <QElapsedTimer>
+#include <QSemaphore>
+#include <QThread>
+#include <atomic>
+#include <vector>
+
+#include "engine/sidechain/sidechainworker.h"
+#include "util/sample.h"
+
+namespace {
+
+constexpr int kFrames = 30000;
+constexpr int kSamples = 2 * kFrames;
+
+class CountingWorker : public SideChainWorker {
+  public:
+    explicit CountingWorker(QSemaphore* pBlock = nullptr)
+            : m_pBlock(pBlock),
+              m_samples(0) {
+    }
+
+    void process(const CSAMPLE* pBuffer, const int iBufferSize) override {
+        Q_UNUSED(pBuffer);
+        if (m_pBlock) {
+            m_pBlock->acquire();
+            m_pBlock->release();
+        }
+        m_samples += iBufferSize;
+    }
+
+    void shutdown() override {
+    }
+
+    bool isActive() const override {
+        return m_active.load();
+    }
+
+    void setActive(bool active) {
+        m_active = active;
+    }
+
+    int samples() const {
+        return m_samples.load();
+    }
+
+  private:
+    QSemaphore* const m_pBlock;
+    std::atomic<int> m_samples;
+    std::atomic<bool> m_active{true};
+};
+
+bool waitForSamples(const CountingWorker* pWorker, int samples) {
+    QElapsedTimer timer;
+    timer.start();
+    while (pWorker->samples() < samples) {
+        if (timer.elapsed() > 5000) {
+            return false;
+        }
+        QThread::msleep(1);
+    }
+    return true;
+}
+
+TEST(EngineSideChainTest, SlowWorkerDoesNotDelayOthers) {
+    std::vector<CSAMPLE> buffer(kSamples);
+    SampleUtil::fill(buffer.data(), 0.5f, kSamples);
+    std::vector<CSAMPLE> sidechainMix(kSamples);
+
+    QSemaphore block;
+    // Owned by the sidechain
+    auto* pSlowWorker = new CountingWorker(&block);
+    auto* pWorker = new CountingWorker();
+    {
+        EngineSideChain sidechain(UserSettingsPointer(), sidechainMix.data());
+        sidechain.addSideChainWorker(pSlowWorker);
+        sidechain.addSideChainWorker(pWorker);
+
+        // The slow worker is stuck in process() and the other worker
+        // continues to receive samples.
+        for (int i = 1; i <= 2; ++i) {
+            sidechain.writeSamples(buffer.data(), kFrames);
+            EXPECT_TRUE(waitForSamples(pWorker, i * kSamples));
+        }
+        EXPECT_EQ(0, pSlowWorker->samples());
+
+        // The samples are kept in the FIFO of the slow worker until it
+        // catches up.
+        block.release();
+        EXPECT_TRUE(waitForSamples(pSlowWorker, 2 * kSamples));
+        EXPECT_EQ(2 * kSamples, pWorker->samples());
+    }
+}
+
+TEST(EngineSideChainTest, ActiveIfAnyWorkerIsActive) {
+    std::vector<CSAMPLE> sidechainMix(kSamples);
+    EngineSideChain sidechain(UserSettingsPointer(), sidechainMix.data());
+    // Without workers the engine doesn't need to provide any samples
+    EXPECT_FALSE(sidechain.isActive());
+
+    // Owned by the sidechain
+    auto* pFirstWorker = new CountingWorker();
+    auto* pSecondWorker = new CountingWorker();
+    pFirstWorker->setActive(false);
+    pSecondWorker->setActive(false);
+    sidechain.addSideChainWorker(pFirstWorker);
+    sidechain.addSideChainWorker(pSecondWorker);
+    EXPECT_FALSE(sidechain.isActive());
+
+    pSecondWorker->setActive(true);
+    EXPECT_TRUE(sidechain.isActive());
+    pSecondWorker->setActive(false);
+    EXPECT_FALSE(sidechain.isActive());
+}
+
+} // namespace
@@ -0,0 +1,89 @@
+#include "util/fifo.h"
+
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+namespace {
+
+TEST(FifoTest, SizeIsRoundedUpToPowerOf2) {
+    FIFO<int> fifo(100);
+    EXPECT_EQ(0, fifo.readAvailable());
+    EXPECT_EQ(128, fifo.writeAvailable());
+}
+
+TEST(FifoTest, WriteAndReadUntilFull) {
+    FIFO<int> fifo(8);
+    std::vector<int> input(10);
+    for (int i = 0; i < 10; ++i) {
+        input[i] = i;
+    }
+    EXPECT_EQ(8, fifo.write(input.data(), 10));
+    EXPECT_EQ(0, fifo.writeAvailable());
+    EXPECT_EQ(0, fifo.write(input.data(), 1));
+
+    std::vector<int> output(10);
+    EXPECT_EQ(8, fifo.read(output.data(), 10));
+    for (int i = 0; i < 8; ++i) {
+        EXPECT_EQ(i, output[i]);
+    }
+    EXPECT_EQ(0, fifo.readAvailable());
+    EXPECT_EQ(0, fifo.read(output.data(), 1));
+}
+
+TEST(FifoTest, RegionsWrapAround) {
+    FIFO<int> fifo(8);
+    const int input[6] = {1, 2, 3, 4, 5, 6};
+    int output[6];
+    ASSERT_EQ(6, fifo.write(input, 6));
+    ASSERT_EQ(6, fifo.read(output, 6));
+
+    int* pData1;
+    ring_buffer_size_t size1;
+    int* pData2;
+    ring_buffer_size_t size2;
+    EXPECT_EQ(5, fifo.aquireWriteRegions(5, &pData1, &size1, &pData2, &size2));
+    EXPECT_EQ(2, size1);
+    EXPECT_EQ(3, size2);
+    std::copy_n(input, size1, pData1);
+    std::copy_n(input + size1, size2, pData2);
+    fifo.releaseWriteRegions(5);
+
+    EXPECT_EQ(5, fifo.read(output, 6));
+    for (int i = 0; i < 5; ++i) {
+        EXPECT_EQ(input[i], output[i]);
+    }
+}
+
+TEST(FifoTest, FlushReadData) {
+    FIFO<int> fifo(8);
+    const int input[4] = {1, 2, 3, 4};
+    ASSERT_EQ(4, fifo.write(input, 4));
+    fifo.flushReadData(10);
+    EXPECT_EQ(0, fifo.readAvailable());
+    EXPECT_EQ(8, fifo.writeAvailable());
+}
+
+TEST(FifoTest, ConcurrentReaderAndWriter) {
+    constexpr int kCount = 100000;
+    FIFO<int> fifo(64);
+    std::thread writer([&fifo] {
+        for (int i = 0; i < kCount; ++i) {
+            fifo.writeBlocking(&i, 1);
+        }
+    });
+    int expected = 0;
+    int buffer[16];
+    while (expected < kCount) {
+        const int count = fifo.read(buffer, 16);
+        for (int i = 0; i < count; ++i) {
+            EXPECT_EQ(expected, buffer[i]);
+            ++expected;
+        }
+    }
+    writer.join();
+    EXPECT_EQ(0, fifo.readAvailable());
+}
+
+} // namespace
@@ -0,0 +1,43 @@
+#include "waveform/framepacer.h"
+
+#include <gtest/gtest.h>
+
+namespace {
+
+const mixxx::Duration kOneSecond = mixxx::Duration::fromSeconds(1);
+
+TEST(FramePacerTest, LowersFrameRateAboveBudget) {
+    FramePacer pacer(60, 0.2);
+    // Half of the time is spent rendering
+    EXPECT_EQ(24, pacer.update(mixxx::Duration::fromMillis(500), kOneSecond, 0.0));
+    // Never below the minimum
+    EXPECT_EQ(FramePacer::kMinFrameRate,
+            pacer.update(mixxx::Duration::fromMillis(1000), kOneSecond, 0.0));
+}
+
+TEST(FramePacerTest, LowersFrameRateForAudio) {
+    FramePacer pacer(60, 0.2);
+    EXPECT_EQ(55, pacer.update(mixxx::Duration::fromMillis(10), kOneSecond, 0.9));
+}
+
+TEST(FramePacerTest, RaisesFrameRateUpToMaximum) {
+    FramePacer pacer(60, 0.2);
+    pacer.update(mixxx::Duration::fromMillis(500), kOneSecond, 0.0);
+    ASSERT_EQ(24, pacer.frameRate());
+    // Just below the budget there is not enough headroom
+    EXPECT_EQ(24, pacer.update(mixxx::Duration::fromMillis(190), kOneSecond, 0.0));
+    EXPECT_EQ(29, pacer.update(mixxx::Duration::fromMillis(10), kOneSecond, 0.0));
+    for (int i = 0; i < 10; ++i) {
+        pacer.update(mixxx::Duration::fromMillis(10), kOneSecond, 0.0);
+    }
+    EXPECT_EQ(60, pacer.frameRate());
+}
+
+TEST(FramePacerTest, MaxFrameRate) {
+    FramePacer pacer(60, 0.2);
+    pacer.setMaxFrameRate(30);
+    EXPECT_EQ(30, pacer.frameRate());
+    EXPECT_EQ(30, pacer.update(mixxx::Duration::fromMillis(10), kOneSecond, 0.0));
+}
+
+} // namespace
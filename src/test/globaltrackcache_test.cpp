@@ -75,10 +75,16 @@ class GlobalTrackCacheTest: public MixxxTest, public virtual GlobalTrackCacheSav
   public:
     void saveEvictedTrack(Track* pTrack) noexcept override {
         ASSERT_FALSE(pTrack == nullptr);
+        ++m_savedTrackCount;
+    }
+    void beginSavingEvictedTracks() noexcept override {
+        ++m_savedBatchCount;
     }
 
   protected:
-    GlobalTrackCacheTest() {
+    GlobalTrackCacheTest()
+            : m_savedTrackCount(0),
+              m_savedBatchCount(0) {
         GlobalTrackCache::createInstance(this, deleteTrack);
     }
     ~GlobalTrackCacheTest() {
@@ -86,6 +92,8 @@ class GlobalTrackCacheTest: public MixxxTest, public virtual GlobalTrackCacheSav
     }
 
     TrackPointer m_recentTrackPtr;
+    int m_savedTrackCount;
+    int m_savedBatchCount;
 };
 
 TEST_F(GlobalTrackCacheTest, resolveByFileInfo) {
@@ -221,3 +229,31 @@ TEST_F(GlobalTrackCacheTest, evictWhileMoving) {
 
     EXPECT_TRUE(GlobalTrackCacheLocker().isEmpty());
 }
+
+TEST_F(GlobalTrackCacheTest, saveBatch) {
+    ASSERT_TRUE(GlobalTrackCacheLocker().isEmpty());
+
+    {
+        const GlobalTrackCacheSaveBatch saveBatch;
+
+        TrackPointer track1 = GlobalTrackCacheResolver(
+                mixxx::FileAccess(mixxx::FileInfo(getTestDir().filePath(kTestFile))))
+                                      .getTrack();
+        EXPECT_TRUE(static_cast<bool>(track1));
+        TrackPointer track2 = GlobalTrackCacheResolver(
+                mixxx::FileAccess(mixxx::FileInfo(getTestDir().filePath(kTestFile2))))
+                                      .getTrack();
+        EXPECT_TRUE(static_cast<bool>(track2));
+
+        track1.reset();
+        track2.reset();
+
+        // Saving is deferred until leaving the scope
+        EXPECT_EQ(0, m_savedTrackCount);
+        EXPECT_FALSE(GlobalTrackCacheLocker().isEmpty());
+    }
+
+    EXPECT_EQ(2, m_savedTrackCount);
+    EXPECT_EQ(1, m_savedBatchCount);
+    EXPECT_TRUE(GlobalTrackCacheLocker().isEmpty());
+}
@@ -3,6 +3,7 @@
 
 #include <QDateTime>
 #include <QDir>
+#include <QSqlQuery>
 #include <QString>
 #include <atomic>
 #include <memory>
@@ -12,6 +13,7 @@
 #include "library/itunes/itunespathmapping.h"
 #include "library/itunes/itunesxmlimporter.h"
 #include "library/treeitem.h"
+#include "test/mixxxdbtest.h"
 #include "test/mixxxtest.h"
 
 class ITunesXMLImporterTest : public MixxxTest {
@@ -29,6 +31,22 @@ class ITunesXMLImporterTest : public MixxxTest {
     }
 };
 
+class ITunesXMLImporterDbTest : public MixxxDbTest {
+  protected:
+    ITunesXMLImporterDbTest()
+            : MixxxDbTest(true) {
+    }
+
+    int countRows(const QString& tableName) {
+        QSqlQuery query(dbConnection());
+        query.exec(QStringLiteral("SELECT COUNT(*) FROM ") + tableName);
+        if (!query.next()) {
+            return -1;
+        }
+        return query.value(0).toInt();
+    }
+};
+
 class MockITunesDAO : public ITunesDAO {
   public:
     MOCK_METHOD(bool, importTrack, (const ITunesTrack&));
@@ -488,3 +506,44 @@ TEST_F(ITunesXMLImporterTest, ParseITunesMusicXML) {
     EXPECT_EQ(folderB->child(0)->getLabel().toStdString(), "Playlist A");
     EXPECT_EQ(folderB->child(1)->getLabel().toStdString(), "Playlist B");
 }
+
+TEST_F(ITunesXMLImporterDbTest, ImportMacOSMusicXML) {
+    auto dao = std::make_unique<ITunesDAO>();
+    dao->initialize(dbConnection());
+
+    QString xmlFilePath = MixxxTest::getOrInitTestDir().filePath(
+            "itunes/macOS Music Library.xml");
+    ITunesXMLImporter importer(nullptr, xmlFilePath, std::move(dao));
+    ITunesImport import = importer.importLibrary();
+
+    // All rows of the last, incomplete batches are inserted
+    EXPECT_EQ(6, countRows("itunes_library"));
+    EXPECT_EQ(7, countRows("itunes_playlists"));
+    EXPECT_EQ(18, countRows("itunes_playlist_tracks"));
+    ASSERT_NE(nullptr, import.playlistRoot);
+    EXPECT_EQ(3, import.playlistRoot->children().size());
+}
+
+TEST_F(ITunesXMLImporterDbTest, InsertInBatches) {
+    ITunesDAO dao;
+    dao.initialize(dbConnection());
+
+    const int trackCount = 2 * ITunesDAO::kTrackBatchSize + 3;
+    for (int id = 1; id <= trackCount; ++id) {
+        ITunesTrack track{};
+        track.id = id;
+        track.title = QString::number(id);
+        EXPECT_TRUE(dao.importTrack(track));
+        EXPECT_TRUE(dao.importPlaylistTrack(1, id, id));
+    }
+    EXPECT_EQ(2 * ITunesDAO::kTrackBatchSize, countRows("itunes_library"));
+    EXPECT_EQ(0, countRows("itunes_playlist_tracks"));
+
+    EXPECT_TRUE(dao.flush());
+    EXPECT_EQ(trackCount, countRows("itunes_library"));
+    EXPECT_EQ(trackCount, countRows("itunes_playlist_tracks"));
+
+    // Nothing is inserted twice
+    EXPECT_TRUE(dao.flush());
+    EXPECT_EQ(trackCount, countRows("itunes_library"));
+}
@@ -0,0 +1,504 @@
+// Benchmarks for searching, sorting and loading the track tables of large
+// libraries.
+//
+// Run with `mixxx-test --benchmark --benchmark_filter=BM_Library`. The
+// libraries are generated on the fly with a fixed seed, so the results only
+// depend on the code and the hardware. Generating the library with a million
+// tracks takes a while, it is shared by all benchmarks of the same size.
+#include <benchmark/benchmark.h>
+
+#include <QCoreApplication>
+#include <QSqlQuery>
+#include <QStringList>
+#include <memory>
+
+#include "library/basetrackcache.h"
+#include "library/dao/playlistdao.h"
+#include "library/dao/trackschema.h"
+#include "library/librarytablemodel.h"
+#include "library/playlisttablemodel.h"
+#include "library/queryutil.h"
+#include "library/searchquery.h"
+#include "library/searchqueryparser.h"
+#include "library/trackset/crate/crate.h"
+#include "library/trackset/crate/cratetablemodel.h"
+#include "test/librarytest.h"
+#include "util/db/sqltransaction.h"
+
+namespace {
+
+constexpr int kSmallLibrary = 100000;
+constexpr int kLargeLibrary = 1000000;
+
+constexpr int kCrateCount = 50;
+constexpr int kPlaylistCount = 20;
+constexpr int kPlaylistLength = 1000;
+
+const QStringList kSearchColumns = {
+        LIBRARYTABLE_ARTIST,
+        LIBRARYTABLE_ALBUM,
+        LIBRARYTABLE_ALBUMARTIST,
+        TRACKLOCATIONSTABLE_LOCATION,
+        LIBRARYTABLE_GROUPING,
+        LIBRARYTABLE_COMMENT,
+        LIBRARYTABLE_TITLE,
+        LIBRARYTABLE_GENRE,
+        LIBRARYTABLE_CRATE};
+
+const QStringList kGenres = {
+        QStringLiteral("House"),
+        QStringLiteral("Deep House"),
+        QStringLiteral("Tech House"),
+        QStringLiteral("Techno"),
+        QStringLiteral("Minimal"),
+        QStringLiteral("Trance"),
+        QStringLiteral("Drum & Bass"),
+        QStringLiteral("Dubstep"),
+        QStringLiteral("Hip Hop"),
+        QStringLiteral("Funk"),
+        QStringLiteral("Disco"),
+        QStringLiteral("Soul"),
+        QStringLiteral("Jazz"),
+        QStringLiteral("Rock"),
+        QStringLiteral("Pop"),
+        QStringLiteral("Reggae"),
+        QStringLiteral("Latin"),
+        QStringLiteral("Ambient")};
+
+const char* const kSyllables[] = {
+        "ka", "lo", "mi", "ra", "tu", "ne", "so", "vi", "da", "ze",
+        "po", "an", "el", "or", "us", "qui", "ber", "lin", "mar", "tok"};
+constexpr int kSyllableCount = sizeof(kSyllables) / sizeof(kSyllables[0]);
+
+/// Deterministic xorshift32 generator, the libraries of different builds
+/// must be identical.
+class Random {
+  public:
+    int next(int bound) {
+        m_state ^= m_state << 13;
+        m_state ^= m_state >> 17;
+        m_state ^= m_state << 5;
+        return static_cast<int>(m_state % static_cast<quint32>(bound));
+    }
+
+    QString word(int minSyllables, int maxSyllables) {
+        const int count = minSyllables + next(maxSyllables - minSyllables + 1);
+        QString word;
+        for (int i = 0; i < count; ++i) {
+            word += QLatin1String(kSyllables[next(kSyllableCount)]);
+        }
+        word[0] = word[0].toUpper();
+        return word;
+    }
+
+    QString words(int count) {
+        QStringList words;
+        for (int i = 0; i < count; ++i) {
+            words << word(1, 3);
+        }
+        return words.join(QChar(' '));
+    }
+
+  private:
+    quint32 m_state = 0x12345678;
+};
+
+} // namespace
+
+/// Provides the internal track collection with a generated library. The
+/// track source is set up like MixxxLibraryFeature does, but without the
+/// asynchronous selects.
+class LibraryBenchmark : public LibraryTest {
+  public:
+    explicit LibraryBenchmark(int trackCount)
+            : m_trackCount(trackCount) {
+        addTracks();
+        addCrates();
+        addPlaylists();
+        connectTrackSource();
+    }
+
+    using LibraryTest::internalCollection;
+    using LibraryTest::trackCollectionManager;
+
+    int trackCount() const {
+        return m_trackCount;
+    }
+
+    const QSet<TrackId>& trackIds() const {
+        return m_trackIds;
+    }
+
+    const QList<CrateId>& crateIds() const {
+        return m_crateIds;
+    }
+
+    const QList<int>& playlistIds() const {
+        return m_playlistIds;
+    }
+
+    BaseTrackCache* trackSource() const {
+        return internalCollection()->getTrackSource().data();
+    }
+
+    /// Returns the generated library with the given number of tracks. Only
+    /// one library is kept at a time, so the benchmarks are registered by
+    /// size.
+    static LibraryBenchmark& library(int trackCount) {
+        if (!s_pLibrary || s_pLibrary->trackCount() != trackCount) {
+            if (!s_pLibrary) {
+                // The library must be deleted before the application
+                qAddPostRoutine(releaseLibrary);
+            }
+            // The controls of the previous library must be deleted first
+            s_pLibrary.reset();
+            s_pLibrary = std::make_unique<LibraryBenchmark>(trackCount);
+        }
+        return *s_pLibrary;
+    }
+
+  private:
+    void TestBody() override {
+    }
+
+    void addTracks() {
+        // Adding a million Track objects through the TrackDAO would take
+        // far too long, the rows are inserted directly.
+        const QSqlDatabase database = internalCollection()->database();
+        SqlTransaction transaction(database);
+        QSqlQuery locationQuery(database);
+        locationQuery.prepare(
+                "INSERT INTO track_locations "
+                "(location,directory,filename,filesize,fs_deleted,needs_verification) "
+                "VALUES "
+                "(:location,:directory,:filename,:filesize,0,0)");
+        QSqlQuery libraryQuery(database);
+        libraryQuery.prepare(
+                "INSERT INTO library "
+                "(artist,title,album,album_artist,year,genre,tracknumber,"
+                "comment,filetype,duration,bitrate,samplerate,channels,"
+                "bpm,key_id,rating,timesplayed,played,mixxx_deleted,"
+                "header_parsed,location) "
+                "VALUES "
+                "(:artist,:title,:album,:album_artist,:year,:genre,:tracknumber,"
+                ":comment,'mp3',:duration,320,44100,2,"
+                ":bpm,:key_id,:rating,:timesplayed,0,0,"
+                "1,:location)");
+
+        Random random;
+        // Roughly ten tracks per artist and album
+        QStringList artists;
+        for (int i = 0; i < m_trackCount / 10; ++i) {
+            artists << random.words(1 + random.next(2));
+        }
+        QString album;
+        QString artist;
+        for (int i = 0; i < m_trackCount; ++i) {
+            const int trackNumber = i % 10 + 1;
+            if (trackNumber == 1) {
+                artist = artists[random.next(artists.size())];
+                album = random.words(1 + random.next(3));
+            }
+            const QString title = random.words(1 + random.next(4));
+            const QString directory = QStringLiteral("/music/%1/%2").arg(artist, album);
+            const QString fileName = QStringLiteral("%1 - %2.mp3")
+                                             .arg(trackNumber, 2, 10, QChar('0'))
+                                             .arg(title);
+            const QString location = directory + QChar('/') + fileName;
+
+            locationQuery.bindValue(":location", location);
+            locationQuery.bindValue(":directory", directory);
+            locationQuery.bindValue(":filename", fileName);
+            locationQuery.bindValue(":filesize", 5000000 + random.next(10000000));
+            if (!locationQuery.exec()) {
+                LOG_FAILED_QUERY(locationQuery);
+                return;
+            }
+
+            libraryQuery.bindValue(":artist", artist);
+            libraryQuery.bindValue(":title", title);
+            libraryQuery.bindValue(":album", album);
+            libraryQuery.bindValue(":album_artist", artist);
+            libraryQuery.bindValue(":year", QString::number(1970 + random.next(55)));
+            libraryQuery.bindValue(":genre", kGenres[random.next(kGenres.size())]);
+            libraryQuery.bindValue(":tracknumber", QString::number(trackNumber));
+            libraryQuery.bindValue(":comment",
+                    random.next(4) == 0 ? random.words(2) : QString());
+            libraryQuery.bindValue(":duration", 120 + random.next(480));
+            libraryQuery.bindValue(":bpm", 70 + random.next(11000) / 100.0);
+            libraryQuery.bindValue(":key_id", 1 + random.next(24));
+            libraryQuery.bindValue(":rating", random.next(6));
+            libraryQuery.bindValue(":timesplayed", random.next(20));
+            libraryQuery.bindValue(":location", locationQuery.lastInsertId());
+            if (!libraryQuery.exec()) {
+                LOG_FAILED_QUERY(libraryQuery);
+                return;
+            }
+            m_trackIds.insert(TrackId(libraryQuery.lastInsertId()));
+        }
+        transaction.commit();
+    }
+
+    void addCrates() {
+        const QList<TrackId> trackIds = m_trackIds.values();
+        const int crateSize = m_trackCount / kCrateCount;
+        for (int i = 0; i < kCrateCount; ++i) {
+            Crate crate;
+            crate.setName(QStringLiteral("Crate %1").arg(i, 2, 10, QChar('0')));
+            CrateId crateId;
+            if (!internalCollection()->insertCrate(crate, &crateId)) {
+                return;
+            }
+            internalCollection()->addCrateTracks(crateId,
+                    trackIds.mid(i * crateSize, crateSize));
+            m_crateIds.append(crateId);
+        }
+    }
+
+    void addPlaylists() {
+        const QList<TrackId> trackIds = m_trackIds.values();
+        PlaylistDAO& playlistDao = internalCollection()->getPlaylistDAO();
+        const int stride = m_trackCount / kPlaylistLength;
+        for (int i = 0; i < kPlaylistCount; ++i) {
+            const int playlistId = playlistDao.createPlaylist(
+                    QStringLiteral("Playlist %1").arg(i, 2, 10, QChar('0')));
+            QList<TrackId> playlistTrackIds;
+            for (int j = 0; j < kPlaylistLength; ++j) {
+                playlistTrackIds.append(trackIds[(j * stride + i) % m_trackCount]);
+            }
+            playlistDao.appendTracksToPlaylist(playlistTrackIds, playlistId);
+            m_playlistIds.append(playlistId);
+        }
+    }
+
+    void connectTrackSource() {
+        const QStringList columns = {
+                LIBRARYTABLE_ID,
+                LIBRARYTABLE_PLAYED,
+                LIBRARYTABLE_TIMESPLAYED,
+                LIBRARYTABLE_LAST_PLAYED_AT,
+                LIBRARYTABLE_ALBUMARTIST,
+                LIBRARYTABLE_ALBUM,
+                LIBRARYTABLE_ARTIST,
+                LIBRARYTABLE_TITLE,
+                LIBRARYTABLE_YEAR,
+                LIBRARYTABLE_RATING,
+                LIBRARYTABLE_GENRE,
+                LIBRARYTABLE_COMPOSER,
+                LIBRARYTABLE_GROUPING,
+                LIBRARYTABLE_TRACKNUMBER,
+                LIBRARYTABLE_KEY,
+                LIBRARYTABLE_KEY_ID,
+                LIBRARYTABLE_BPM,
+                LIBRARYTABLE_BPM_LOCK,
+                LIBRARYTABLE_DURATION,
+                LIBRARYTABLE_BITRATE,
+                LIBRARYTABLE_REPLAYGAIN,
+                LIBRARYTABLE_FILETYPE,
+                LIBRARYTABLE_DATETIMEADDED,
+                TRACKLOCATIONSTABLE_LOCATION,
+                TRACKLOCATIONSTABLE_FSDELETED,
+                LIBRARYTABLE_COMMENT,
+                LIBRARYTABLE_MIXXXDELETED,
+                LIBRARYTABLE_COLOR,
+                LIBRARYTABLE_COVERART_SOURCE,
+                LIBRARYTABLE_COVERART_TYPE,
+                LIBRARYTABLE_COVERART_LOCATION,
+                LIBRARYTABLE_COVERART_COLOR,
+                LIBRARYTABLE_COVERART_DIGEST,
+                LIBRARYTABLE_COVERART_HASH};
+        QStringList qualifiedTableColumns;
+        for (const auto& column : columns) {
+            qualifiedTableColumns.append(mixxx::trackschema::tableForColumn(column) +
+                    QLatin1Char('.') + column);
+        }
+
+        const QString tableName = QStringLiteral("library_cache_view");
+        QSqlQuery query(internalCollection()->database());
+        query.prepare(QString(
+                "CREATE TEMPORARY VIEW IF NOT EXISTS %1 AS SELECT %2 FROM library "
+                "INNER JOIN track_locations ON library.location = track_locations.id")
+                              .arg(tableName, qualifiedTableColumns.join(",")));
+        if (!query.exec()) {
+            LOG_FAILED_QUERY(query);
+        }
+
+        auto pTrackSource = QSharedPointer<BaseTrackCache>::create(
+                internalCollection(),
+                tableName,
+                LIBRARYTABLE_ID,
+                columns,
+                kSearchColumns,
+                true);
+        pTrackSource->buildIndex();
+        internalCollection()->connectTrackSource(pTrackSource);
+    }
+
+    const int m_trackCount;
+    QSet<TrackId> m_trackIds;
+    QList<CrateId> m_crateIds;
+    QList<int> m_playlistIds;
+
+    static void releaseLibrary() {
+        s_pLibrary.reset();
+    }
+
+    static std::unique_ptr<LibraryBenchmark> s_pLibrary;
+};
+
+std::unique_ptr<LibraryBenchmark> LibraryBenchmark::s_pLibrary;
+
+namespace {
+
+const char* const kSearchQueries[] = {
+        "",
+        "ka",
+        "lomi rak",
+        "artist:tu genre:house",
+        "bpm:120-128 key:8A",
+        "rating:>=4 -genre:pop",
+        "crate:\"Crate 07\"",
+        "\"Tech House\" | Disco"};
+
+void BM_LibrarySearchQueryParser(benchmark::State& state) {
+    LibraryBenchmark& library = LibraryBenchmark::library(state.range(0));
+    const SearchQueryParser parser(library.internalCollection(), kSearchColumns);
+    const QString query = QString::fromUtf8(kSearchQueries[state.range(1)]);
+
+    for (auto _ : state) {
+        const auto pQueryNode = parser.parseQuery(query, QString());
+        benchmark::DoNotOptimize(pQueryNode->toSql());
+    }
+    state.SetLabel(kSearchQueries[state.range(1)]);
+}
+
+void BM_LibraryFilterAndSort(benchmark::State& state) {
+    LibraryBenchmark& library = LibraryBenchmark::library(state.range(0));
+    BaseTrackCache* pTrackSource = library.trackSource();
+    const char* const query = kSearchQueries[state.range(1)];
+
+    QHash<TrackId, int> trackToIndex;
+    for (auto _ : state) {
+        pTrackSource->filterAndSort(library.trackIds(),
+                QString::fromUtf8(query),
+                QString(),
+                QStringLiteral("ORDER BY artist"),
+                QList<SortColumn>(),
+                0,
+                &trackToIndex);
+    }
+    state.SetLabel(query);
+    state.counters["tracks"] = trackToIndex.size();
+}
+
+void BM_LibraryTableModelSelect(benchmark::State& state) {
+    LibraryBenchmark& library = LibraryBenchmark::library(state.range(0));
+    const char* const query = kSearchQueries[state.range(1)];
+    LibraryTableModel model(nullptr,
+            library.trackCollectionManager(),
+            "mixxx.db.model.library.benchmark");
+    model.setSearch(QString::fromUtf8(query));
+
+    for (auto _ : state) {
+        model.select();
+    }
+    state.SetLabel(query);
+    state.counters["rows"] = model.rowCount();
+}
+
+void BM_LibraryTableModelSort(benchmark::State& state, const char* columnName) {
+    LibraryBenchmark& library = LibraryBenchmark::library(state.range(0));
+    LibraryTableModel model(nullptr,
+            library.trackCollectionManager(),
+            "mixxx.db.model.library.benchmark");
+    const int column = model.fieldIndex(QString::fromUtf8(columnName));
+    if (column < 0) {
+        state.SkipWithError("Unknown sort column");
+        return;
+    }
+
+    Qt::SortOrder order = Qt::AscendingOrder;
+    for (auto _ : state) {
+        model.setSort(column, order);
+        model.select();
+        order = order == Qt::AscendingOrder ? Qt::DescendingOrder : Qt::AscendingOrder;
+    }
+    state.counters["rows"] = model.rowCount();
+}
+
+void BM_LibraryCrateTableModelSelect(benchmark::State& state) {
+    LibraryBenchmark& library = LibraryBenchmark::library(state.range(0));
+    CrateTableModel model(nullptr, library.trackCollectionManager());
+
+    int crate = 0;
+    for (auto _ : state) {
+        model.selectCrate(library.crateIds()[crate]);
+        crate = (crate + 1) % library.crateIds().size();
+    }
+    state.counters["rows"] = model.rowCount();
+}
+
+void BM_LibraryPlaylistTableModelSelect(benchmark::State& state) {
+    LibraryBenchmark& library = LibraryBenchmark::library(state.range(0));
+    PlaylistTableModel model(nullptr,
+            library.trackCollectionManager(),
+            "mixxx.db.model.playlist.benchmark");
+
+    int playlist = 0;
+    for (auto _ : state) {
+        model.selectPlaylist(library.playlistIds()[playlist]);
+        playlist = (playlist + 1) % library.playlistIds().size();
+    }
+    state.counters["rows"] = model.rowCount();
+}
+
+void searchQueryArguments(benchmark::internal::Benchmark* pBenchmark, int trackCount) {
+    constexpr int kQueryCount = sizeof(kSearchQueries) / sizeof(kSearchQueries[0]);
+    for (int query = 0; query < kQueryCount; ++query) {
+        pBenchmark->Args({trackCount, query});
+    }
+}
+
+void smallLibraryQueries(benchmark::internal::Benchmark* pBenchmark) {
+    searchQueryArguments(pBenchmark, kSmallLibrary);
+}
+
+void largeLibraryQueries(benchmark::internal::Benchmark* pBenchmark) {
+    searchQueryArguments(pBenchmark, kLargeLibrary);
+}
+
+} // namespace
+
+// All benchmarks of a library size are registered together, so the library
+// is only generated once per size.
+BENCHMARK(BM_LibrarySearchQueryParser)->Apply(smallLibraryQueries);
+BENCHMARK(BM_LibraryFilterAndSort)->Apply(smallLibraryQueries)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_LibraryTableModelSelect)
+        ->Apply(smallLibraryQueries)
+        ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_LibraryTableModelSort, artist, "artist")
+        ->Arg(kSmallLibrary)
+        ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_LibraryTableModelSort, bpm, "bpm")
+        ->Arg(kSmallLibrary)
+        ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_LibraryCrateTableModelSelect)->Arg(kSmallLibrary)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_LibraryPlaylistTableModelSelect)
+        ->Arg(kSmallLibrary)
+        ->Unit(benchmark::kMillisecond);
+
+BENCHMARK(BM_LibrarySearchQueryParser)->Apply(largeLibraryQueries);
+BENCHMARK(BM_LibraryFilterAndSort)->Apply(largeLibraryQueries)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_LibraryTableModelSelect)
+        ->Apply(largeLibraryQueries)
+        ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_LibraryTableModelSort, artist, "artist")
+        ->Arg(kLargeLibrary)
+        ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_LibraryTableModelSort, bpm, "bpm")
+        ->Arg(kLargeLibrary)
+        ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_LibraryCrateTableModelSelect)->Arg(kLargeLibrary)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_LibraryPlaylistTableModelSelect)
+        ->Arg(kLargeLibrary)
+        ->Unit(benchmark::kMillisecond);
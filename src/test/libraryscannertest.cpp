@@ -4,6 +4,7 @@
 #include "test/librarytest.h"
 
 #include "library/scanner/libraryscanner.h"
+#include "track/track.h"
 
 class LibraryScannerTest : public LibraryTest {
   protected:
@@ -52,3 +53,119 @@ TEST_F(LibraryScannerTest, ScannerRoundtrip) {
     m_libraryScanner.changeScannerState(LibraryScanner::IDLE);
     EXPECT_EQ(m_libraryScanner.m_state, LibraryScanner::IDLE);
 }
+
+TEST_F(LibraryScannerTest, DirectoryMTimesRoundtrip) {
+    LibraryHashDAO libraryHashDao;
+    libraryHashDao.initialize(dbConnection());
+    EXPECT_TRUE(libraryHashDao.getDirectoryMTimes().isEmpty());
+
+    QHash<QString, LibraryHashDAO::DirectoryMTime> mtimes;
+    mtimes.insert(QStringLiteral("/music"), {QStringLiteral("/"), 1000});
+    mtimes.insert(QStringLiteral("/music/album"), {QStringLiteral("/music"), 2000});
+    libraryHashDao.updateDirectoryMTimes(mtimes, {});
+    mtimes = libraryHashDao.getDirectoryMTimes();
+    ASSERT_EQ(2, mtimes.size());
+    EXPECT_EQ(QStringLiteral("/music"), mtimes.value(QStringLiteral("/music/album")).parentPath);
+    EXPECT_EQ(2000, mtimes.value(QStringLiteral("/music/album")).mtimeMillis);
+
+    QHash<QString, LibraryHashDAO::DirectoryMTime> changedMTimes;
+    changedMTimes.insert(QStringLiteral("/music/album"), {QStringLiteral("/music"), 3000});
+    libraryHashDao.updateDirectoryMTimes(changedMTimes, {QStringLiteral("/music")});
+    mtimes = libraryHashDao.getDirectoryMTimes();
+    ASSERT_EQ(1, mtimes.size());
+    EXPECT_EQ(3000, mtimes.value(QStringLiteral("/music/album")).mtimeMillis);
+}
+
+TEST_F(LibraryScannerTest, SkipUnmodifiedDirectories) {
+    QHash<QString, ScannerGlobal::DirectoryMTime> mtimes;
+    mtimes.insert(QStringLiteral("/music"), {QStringLiteral("/"), 1000});
+    mtimes.insert(QStringLiteral("/music/album"), {QStringLiteral("/music"), 2000});
+    mtimes.insert(QStringLiteral("/music/deleted"), {QStringLiteral("/music"), 3000});
+    const auto newScannerGlobal = [&mtimes](bool skipUnmodifiedDirectories) {
+        return ScannerGlobal({}, {}, QRegularExpression(), QRegularExpression(), {}, mtimes, skipUnmodifiedDirectories);
+    };
+
+    EXPECT_FALSE(newScannerGlobal(false).directoryUnmodified(QStringLiteral("/music"), 1000));
+
+    ScannerGlobal scannerGlobal = newScannerGlobal(true);
+    EXPECT_TRUE(scannerGlobal.directoryUnmodified(QStringLiteral("/music"), 1000));
+    EXPECT_FALSE(scannerGlobal.directoryUnmodified(QStringLiteral("/music"), 1001));
+    EXPECT_FALSE(scannerGlobal.directoryUnmodified(QStringLiteral("/unknown"), 1000));
+    EXPECT_FALSE(scannerGlobal.directoryUnmodified(QStringLiteral("/unknown"), 0));
+    EXPECT_THAT(scannerGlobal.knownSubdirectories(QStringLiteral("/music")),
+            testing::UnorderedElementsAre(
+                    QStringLiteral("/music/album"), QStringLiteral("/music/deleted")));
+
+    scannerGlobal.addUnmodifiedDirectory(QStringLiteral("/music"));
+    scannerGlobal.addListedDirectory(QStringLiteral("/music/album"), QStringLiteral("/music"), 2500);
+    // Too recent to be trusted
+    scannerGlobal.addListedDirectory(QStringLiteral("/music/new"),
+            QStringLiteral("/music"),
+            QDateTime::currentMSecsSinceEpoch());
+
+    const auto changedMTimes = scannerGlobal.changedDirectoryMTimes();
+    ASSERT_EQ(2, changedMTimes.size());
+    EXPECT_EQ(2500, changedMTimes.value(QStringLiteral("/music/album")).mtimeMillis);
+    EXPECT_EQ(0, changedMTimes.value(QStringLiteral("/music/new")).mtimeMillis);
+    EXPECT_EQ(QStringList{QStringLiteral("/music/deleted")},
+            scannerGlobal.unvisitedDirectories());
+    EXPECT_EQ(1, scannerGlobal.numUnmodifiedDirectories());
+}
+
+TEST_F(LibraryScannerTest, PrefetchedTracks) {
+    ScannerGlobal scannerGlobal({}, {}, QRegularExpression(), QRegularExpression(), {});
+    for (int i = 0; i < ScannerGlobal::kMaxPrefetchedTracks; ++i) {
+        ASSERT_TRUE(scannerGlobal.tryReservePrefetchedTrack());
+    }
+    EXPECT_FALSE(scannerGlobal.tryReservePrefetchedTrack());
+
+    SoundSourceProxy::PrefetchedTrackMetadata prefetchedMetadata;
+    prefetchedMetadata.trackMetadata.refTrackInfo().setTitle(QStringLiteral("Title"));
+    scannerGlobal.addPrefetchedTrack(QStringLiteral("/music/a.mp3"), prefetchedMetadata);
+    EXPECT_FALSE(scannerGlobal.takePrefetchedTrack(QStringLiteral("/music/b.mp3")));
+    const auto taken = scannerGlobal.takePrefetchedTrack(QStringLiteral("/music/a.mp3"));
+    ASSERT_TRUE(taken);
+    EXPECT_EQ(QStringLiteral("Title"), taken->trackMetadata.getTrackInfo().getTitle());
+    EXPECT_FALSE(scannerGlobal.takePrefetchedTrack(QStringLiteral("/music/a.mp3")));
+
+    // Taking the metadata releases the reservation
+    EXPECT_TRUE(scannerGlobal.tryReservePrefetchedTrack());
+    EXPECT_FALSE(scannerGlobal.tryReservePrefetchedTrack());
+    scannerGlobal.cancel();
+    EXPECT_FALSE(scannerGlobal.reservePrefetchedTrack());
+}
+
+TEST_F(LibraryScannerTest, UpdateTrackFromPrefetchedMetadata) {
+    const QString filePath =
+            getTestDir().filePath(QStringLiteral("id3-test-data/artist.mp3"));
+    auto prefetchedMetadata = SoundSourceProxy::prefetchTrackMetadataFromFile(
+            mixxx::FileAccess(mixxx::FileInfo(filePath)));
+    ASSERT_TRUE(prefetchedMetadata);
+    EXPECT_EQ(mixxx::MetadataSource::ImportResult::Succeeded,
+            prefetchedMetadata->importResult);
+    EXPECT_TRUE(prefetchedMetadata->sourceSynchronizedAt.isValid());
+    EXPECT_EQ(QStringLiteral("Test Artist"),
+            prefetchedMetadata->trackMetadata.getTrackInfo().getArtist());
+    // Verify that the prefetched metadata is used instead of the file
+    prefetchedMetadata->trackMetadata.refTrackInfo().setArtist(
+            QStringLiteral("Prefetched Artist"));
+
+    auto pTrack = Track::newTemporary(filePath);
+    EXPECT_EQ(
+            SoundSourceProxy::UpdateTrackFromSourceResult::MetadataImportedAndUpdated,
+            SoundSourceProxy(pTrack).updateTrackFromSource(
+                    SoundSourceProxy::UpdateTrackFromSourceMode::Once,
+                    SyncTrackMetadataParams{},
+                    &*prefetchedMetadata));
+    EXPECT_EQ(QStringLiteral("Prefetched Artist"), pTrack->getArtist());
+    EXPECT_TRUE(pTrack->checkSourceSynchronized());
+
+    // Ignored when re-importing the metadata of an existing track
+    EXPECT_EQ(
+            SoundSourceProxy::UpdateTrackFromSourceResult::MetadataImportedAndUpdated,
+            SoundSourceProxy(pTrack).updateTrackFromSource(
+                    SoundSourceProxy::UpdateTrackFromSourceMode::Always,
+                    SyncTrackMetadataParams{},
+                    &*prefetchedMetadata));
+    EXPECT_EQ(QStringLiteral("Test Artist"), pTrack->getArtist());
+}
@@ -0,0 +1,49 @@
+#include "util/lockedmemory.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+
+#include "util/samplebuffer.h"
+
+namespace {
+
+using mixxx::LockedMemory;
+
+class LockedMemoryTest : public testing::Test {
+  protected:
+    void TearDown() override {
+        LockedMemory::setEnabled(false);
+    }
+};
+
+TEST_F(LockedMemoryTest, DisabledByDefault) {
+    EXPECT_FALSE(LockedMemory::isEnabled());
+    EXPECT_EQ(nullptr, LockedMemory::allocate(4096));
+
+    // Falls back to a regular allocation
+    mixxx::SampleBuffer buffer = mixxx::SampleBuffer::allocateLocked(1000);
+    EXPECT_EQ(1000, buffer.size());
+    buffer.fill(1.0f);
+    EXPECT_EQ(1.0f, buffer[999]);
+}
+
+#ifdef __LINUX__
+TEST_F(LockedMemoryTest, AllocateSampleBuffer) {
+    LockedMemory::setEnabled(true);
+    const std::size_t lockedBytesBefore = LockedMemory::lockedBytes();
+    {
+        mixxx::SampleBuffer buffer = mixxx::SampleBuffer::allocateLocked(1000);
+        EXPECT_EQ(1000, buffer.size());
+        // Page aligned
+        EXPECT_EQ(0u, reinterpret_cast<std::uintptr_t>(buffer.data()) % 4096);
+        buffer.fill(1.0f);
+        EXPECT_EQ(1.0f, buffer[999]);
+        // Locking might fail with a low RLIMIT_MEMLOCK
+        EXPECT_GE(LockedMemory::lockedBytes(), lockedBytesBefore);
+    }
+    EXPECT_EQ(lockedBytesBefore, LockedMemory::lockedBytes());
+}
+#endif
+
+} // namespace
@@ -0,0 +1,70 @@
+#include "network/metricsserver.h"
+
+#include <gtest/gtest.h>
+
+#include <limits>
+
+#include "control/controlobject.h"
+#include "test/mixxxtest.h"
+
+using mixxx::network::MetricsServer;
+
+namespace {
+
+class MetricsServerTest : public MixxxTest {
+  protected:
+    MetricsServer m_server;
+};
+
+TEST_F(MetricsServerTest, EmptyExposition) {
+    EXPECT_EQ(QByteArray("# EOF\n"), m_server.exposition());
+}
+
+TEST_F(MetricsServerTest, CounterAndGauge) {
+    m_server.addMetric(QStringLiteral("mixxx_test_events"),
+            MetricsServer::Type::Counter,
+            QStringLiteral("Events\nof the test"),
+            []() {
+                return QVector<MetricsServer::Sample>{{QString(), 3}};
+            });
+    m_server.addMetric(QStringLiteral("mixxx_test_level"),
+            MetricsServer::Type::Gauge,
+            QStringLiteral("Level"),
+            []() {
+                return QVector<MetricsServer::Sample>{
+                        {MetricsServer::label(QStringLiteral("group"),
+                                 QStringLiteral("[Channel1]")),
+                                0.25},
+                        {MetricsServer::label(QStringLiteral("group"),
+                                 QStringLiteral("\"quoted\"")),
+                                std::numeric_limits<double>::infinity()}};
+            });
+
+    EXPECT_EQ(QByteArray(
+                      "# TYPE mixxx_test_events counter\n"
+                      "# HELP mixxx_test_events Events\\nof the test\n"
+                      "mixxx_test_events_total 3\n"
+                      "# TYPE mixxx_test_level gauge\n"
+                      "# HELP mixxx_test_level Level\n"
+                      "mixxx_test_level{group=\"[Channel1]\"} 0.25\n"
+                      "mixxx_test_level{group=\"\\\"quoted\\\"\"} +Inf\n"
+                      "# EOF\n"),
+            m_server.exposition());
+}
+
+TEST_F(MetricsServerTest, ControlMetric) {
+    const ConfigKey key(QStringLiteral("[Test]"), QStringLiteral("metric"));
+    m_server.addControlMetric(QStringLiteral("mixxx_test_control"),
+            MetricsServer::Type::Gauge,
+            QStringLiteral("Control"),
+            key);
+
+    // No sample while the control does not exist
+    EXPECT_FALSE(m_server.exposition().contains("mixxx_test_control "));
+
+    ControlObject control(key);
+    control.set(42);
+    EXPECT_TRUE(m_server.exposition().contains("\nmixxx_test_control 42\n"));
+}
+
+} // namespace
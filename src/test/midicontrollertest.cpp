@@ -118,6 +118,35 @@ TEST_F(MidiControllerTest, ReceiveMessage_PushButtonCO_PushOnOn) {
     EXPECT_DOUBLE_EQ(0.0, cpb.get());
 }
 
+TEST_F(MidiControllerTest, ReceiveMessage_PushButtonCO_CreatedAfterMapping) {
+    // Controls may be created or re-created after the mapping has been applied,
+    // for example when the number of decks is increased.
+    ConfigKey key("[Channel1]", "hotcue_1_activate");
+
+    unsigned char channel = 0x01;
+    unsigned char control = 0x10;
+
+    addMapping(MidiInputMapping(MidiKey(MidiUtils::statusFromOpCodeAndChannel(
+                                                MidiOpCode::NoteOn, channel),
+                                        control),
+            MidiOptions(),
+            key));
+    m_pController->setMapping(m_pMapping->clone());
+
+    {
+        ControlPushButton cpb(key);
+        receivedShortMessage(MidiOpCode::NoteOn, channel, control, 0x7F);
+        EXPECT_LT(0.0, cpb.get());
+    }
+
+    ControlPushButton cpb(key);
+    EXPECT_DOUBLE_EQ(0.0, cpb.get());
+    receivedShortMessage(MidiOpCode::NoteOn, channel, control, 0x7F);
+    EXPECT_LT(0.0, cpb.get());
+    receivedShortMessage(MidiOpCode::NoteOn, channel, control, 0x00);
+    EXPECT_DOUBLE_EQ(0.0, cpb.get());
+}
+
 TEST_F(MidiControllerTest, ReceiveMessage_PushButtonCO_ToggleOnOff_ButtonMidiOption) {
     // Using the button MIDI option allows you to use a MIDI toggle button as a
     // push button.
@@ -596,3 +625,35 @@ TEST_F(MidiControllerTest, ReceiveMessage_PotMeterCO_14BitPitchBend) {
     receivedShortMessage(MidiOpCode::PitchBendChange, channel, 0x01, 0x40);
     EXPECT_LT(kMiddleValue, potmeter.get());
 }
+
+TEST_F(MidiControllerTest, CoalesceOutputPerTick) {
+    ConfigKey key("[Channel1]", "play_indicator");
+    ControlObject co(key);
+    const unsigned char status =
+            MidiUtils::statusFromOpCodeAndChannel(MidiOpCode::NoteOn, 0x01);
+
+    MidiOutputMapping mapping;
+    mapping.controlKey = key;
+    mapping.output.status = status;
+    mapping.output.control = 0x10;
+    mapping.output.on = 0x7F;
+    mapping.output.off = 0x00;
+    mapping.output.min = 0.5;
+    mapping.output.max = 1.0;
+    m_pMapping->addOutputMapping(key, mapping);
+    m_pController->setMapping(m_pMapping->clone());
+    m_pController->setOpen(true);
+    m_pController->createOutputHandlers();
+
+    // Only the latest value is sent with the next output tick
+    EXPECT_CALL(*m_pController, sendShortMsg(status, 0x10, 0x7F))
+            .Times(1);
+    co.set(1.0);
+    co.set(0.0);
+    co.set(1.0);
+    m_pController->flushPendingOutputs();
+
+    // Unchanged values are not sent again
+    co.set(0.75);
+    m_pController->flushPendingOutputs();
+}
@@ -0,0 +1,116 @@
+#include <gtest/gtest.h>
+
+#include "engine/sidechain/networkmonitorjitterbuffer.h"
+#include "engine/sidechain/networkmonitorpacket.h"
+
+namespace {
+
+using Status = NetworkMonitorJitterBuffer::Status;
+
+QByteArray payloadFor(quint16 sequence) {
+    return QByteArray::number(sequence);
+}
+
+class NetworkMonitorJitterBufferTest : public ::testing::Test {};
+
+TEST_F(NetworkMonitorJitterBufferTest, buffersUntilTargetDepth) {
+    NetworkMonitorJitterBuffer buffer(2, 6);
+    QByteArray payload;
+    EXPECT_EQ(Status::Buffering, buffer.pop(&payload));
+    buffer.push(100, payloadFor(100));
+    EXPECT_EQ(Status::Buffering, buffer.pop(&payload));
+    buffer.push(101, payloadFor(101));
+    EXPECT_EQ(Status::Packet, buffer.pop(&payload));
+    EXPECT_EQ(payloadFor(100), payload);
+    EXPECT_EQ(Status::Packet, buffer.pop(&payload));
+    EXPECT_EQ(payloadFor(101), payload);
+    // Underrun, refill to the target before playing again
+    EXPECT_EQ(Status::Buffering, buffer.pop(&payload));
+    EXPECT_EQ(1u, buffer.underruns());
+    buffer.push(102, payloadFor(102));
+    EXPECT_EQ(Status::Buffering, buffer.pop(&payload));
+}
+
+TEST_F(NetworkMonitorJitterBufferTest, reordersAndReportsLoss) {
+    NetworkMonitorJitterBuffer buffer(3, 8);
+    QByteArray payload;
+    buffer.push(0, payloadFor(0));
+    buffer.push(2, payloadFor(2));
+    buffer.push(3, payloadFor(3));
+    buffer.push(2, payloadFor(2)); // duplicate
+    EXPECT_EQ(4, buffer.depth());
+
+    EXPECT_EQ(Status::Packet, buffer.pop(&payload));
+    EXPECT_EQ(payloadFor(0), payload);
+    EXPECT_EQ(Status::Lost, buffer.pop(&payload));
+    EXPECT_EQ(Status::Packet, buffer.pop(&payload));
+    EXPECT_EQ(payloadFor(2), payload);
+
+    // Arrives after it has been concealed
+    buffer.push(1, payloadFor(1));
+    EXPECT_EQ(Status::Packet, buffer.pop(&payload));
+    EXPECT_EQ(payloadFor(3), payload);
+
+    EXPECT_EQ(5u, buffer.receivedPackets());
+    EXPECT_EQ(3u, buffer.playedPackets());
+    EXPECT_EQ(1u, buffer.lostPackets());
+    EXPECT_EQ(1u, buffer.latePackets());
+}
+
+TEST_F(NetworkMonitorJitterBufferTest, sequenceWrapsAround) {
+    NetworkMonitorJitterBuffer buffer(2, 6);
+    QByteArray payload;
+    buffer.push(65534, payloadFor(65534));
+    buffer.push(65535, payloadFor(65535));
+    buffer.push(0, payloadFor(0));
+    buffer.push(1, payloadFor(1));
+    EXPECT_EQ(4, buffer.depth());
+    for (quint16 sequence : {65534, 65535, 0, 1}) {
+        EXPECT_EQ(Status::Packet, buffer.pop(&payload));
+        EXPECT_EQ(payloadFor(sequence), payload);
+    }
+    EXPECT_EQ(0u, buffer.lostPackets());
+}
+
+TEST_F(NetworkMonitorJitterBufferTest, dropsOldPacketsWhenTooDeep) {
+    NetworkMonitorJitterBuffer buffer(2, 4);
+    QByteArray payload;
+    for (quint16 sequence = 10; sequence < 16; ++sequence) {
+        buffer.push(sequence, payloadFor(sequence));
+    }
+    // The sender is ahead, skip to the target latency
+    EXPECT_EQ(Status::Packet, buffer.pop(&payload));
+    EXPECT_EQ(payloadFor(14), payload);
+    EXPECT_EQ(4u, buffer.droppedPackets());
+    EXPECT_EQ(1, buffer.depth());
+}
+
+TEST_F(NetworkMonitorJitterBufferTest, restartsWhenSenderRestarts) {
+    NetworkMonitorJitterBuffer buffer(1, 4);
+    QByteArray payload;
+    buffer.push(5000, payloadFor(5000));
+    EXPECT_EQ(Status::Packet, buffer.pop(&payload));
+    buffer.push(0, payloadFor(0));
+    EXPECT_EQ(Status::Packet, buffer.pop(&payload));
+    EXPECT_EQ(payloadFor(0), payload);
+    EXPECT_EQ(0u, buffer.latePackets());
+}
+
+TEST_F(NetworkMonitorJitterBufferTest, packetRoundTrip) {
+    const unsigned char opus[] = {1, 2, 3, 4, 5};
+    const QByteArray datagram = NetworkMonitorPacket::encode(
+            4711, 123456, opus, sizeof(opus));
+    EXPECT_EQ(NetworkMonitorPacket::kHeaderSize + static_cast<int>(sizeof(opus)),
+            datagram.size());
+
+    quint16 sequence = 0;
+    QByteArray payload;
+    ASSERT_TRUE(NetworkMonitorPacket::decode(datagram, &sequence, &payload));
+    EXPECT_EQ(4711, sequence);
+    EXPECT_EQ(QByteArray(reinterpret_cast<const char*>(opus), sizeof(opus)), payload);
+
+    EXPECT_FALSE(NetworkMonitorPacket::decode(
+            QByteArray("not a monitoring packet"), &sequence, &payload));
+}
+
+} // namespace
@@ -0,0 +1,158 @@
+#include "util/oversampler.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "util/math.h"
+
+namespace {
+
+constexpr SINT kFramesPerBuffer = 256;
+constexpr int kNumBuffers = 20;
+// The filters are settled after these buffers
+constexpr int kNumSettlingBuffers = 2;
+
+// Returns the ratio of the power of the stereo signals
+double powerRatio(const std::vector<CSAMPLE>& signal,
+        const std::vector<CSAMPLE>& reference) {
+    double signalPower = 0;
+    double referencePower = 0;
+    for (std::size_t i = 0; i < signal.size(); ++i) {
+        signalPower += static_cast<double>(signal[i]) * signal[i];
+        referencePower += static_cast<double>(reference[i]) * reference[i];
+    }
+    return signalPower / referencePower;
+}
+
+void checkLatencyOfImpulse(int factor) {
+    SCOPED_TRACE(factor);
+    mixxx::Oversampler oversampler(kFramesPerBuffer);
+    oversampler.setFactor(factor);
+    ASSERT_EQ(factor, oversampler.factor());
+
+    std::vector<CSAMPLE> input(kFramesPerBuffer * 2);
+    std::vector<CSAMPLE> oversampled(kFramesPerBuffer * 2 * factor);
+    std::vector<CSAMPLE> output(kFramesPerBuffer * 2);
+    input[0] = 1.0f;
+    input[1] = -1.0f;
+    oversampler.upsample(input.data(), oversampled.data(), kFramesPerBuffer);
+    oversampler.downsample(oversampled.data(), output.data(), kFramesPerBuffer);
+
+    SINT peakFrame = 0;
+    for (SINT frame = 0; frame < kFramesPerBuffer; ++frame) {
+        if (std::fabs(output[frame * 2]) > std::fabs(output[peakFrame * 2])) {
+            peakFrame = frame;
+        }
+        EXPECT_FLOAT_EQ(output[frame * 2], -output[frame * 2 + 1]);
+    }
+    EXPECT_EQ(oversampler.latencyFrames(), peakFrame);
+    EXPECT_GT(output[peakFrame * 2], 0.9f);
+}
+
+void checkPassesLowFrequencies(int factor) {
+    SCOPED_TRACE(factor);
+    mixxx::Oversampler oversampler(kFramesPerBuffer);
+    oversampler.setFactor(factor);
+    const SINT latency = oversampler.latencyFrames();
+
+    std::vector<CSAMPLE> input(kFramesPerBuffer * 2 * kNumBuffers);
+    for (SINT frame = 0; frame < kFramesPerBuffer * kNumBuffers; ++frame) {
+        // 0.2 and 0.35 times the sample rate
+        input[frame * 2] = static_cast<CSAMPLE>(std::sin(2 * M_PI * 0.2 * frame));
+        input[frame * 2 + 1] = static_cast<CSAMPLE>(std::sin(2 * M_PI * 0.35 * frame));
+    }
+    std::vector<CSAMPLE> oversampled(kFramesPerBuffer * 2 * factor);
+    std::vector<CSAMPLE> output(input.size());
+    for (int buffer = 0; buffer < kNumBuffers; ++buffer) {
+        const SINT offset = buffer * kFramesPerBuffer * 2;
+        oversampler.upsample(&input[offset], oversampled.data(), kFramesPerBuffer);
+        oversampler.downsample(oversampled.data(), &output[offset], kFramesPerBuffer);
+    }
+
+    for (SINT frame = kNumSettlingBuffers * kFramesPerBuffer;
+            frame < kFramesPerBuffer * kNumBuffers;
+            ++frame) {
+        EXPECT_NEAR(input[(frame - latency) * 2], output[frame * 2], 1e-3f);
+        EXPECT_NEAR(input[(frame - latency) * 2 + 1], output[frame * 2 + 1], 1e-3f);
+    }
+}
+
+void checkRemovesFrequenciesAboveNyquist(int factor) {
+    SCOPED_TRACE(factor);
+    mixxx::Oversampler oversampler(kFramesPerBuffer);
+    oversampler.setFactor(factor);
+
+    // 0.6 and 0.9 times the original sample rate, which would alias down
+    // to 0.4 and 0.1 times the sample rate without filtering
+    std::vector<CSAMPLE> oversampled(kFramesPerBuffer * 2 * factor);
+    std::vector<CSAMPLE> reference;
+    std::vector<CSAMPLE> output;
+    std::vector<CSAMPLE> buffer(kFramesPerBuffer * 2);
+    SINT oversampledFrame = 0;
+    for (int bufferIndex = 0; bufferIndex < kNumBuffers; ++bufferIndex) {
+        for (SINT frame = 0; frame < kFramesPerBuffer * factor; ++frame) {
+            const double time = static_cast<double>(oversampledFrame++) / factor;
+            oversampled[frame * 2] = static_cast<CSAMPLE>(std::sin(2 * M_PI * 0.6 * time));
+            oversampled[frame * 2 + 1] = static_cast<CSAMPLE>(std::sin(2 * M_PI * 0.9 * time));
+            if (frame % factor == 0) {
+                reference.push_back(oversampled[frame * 2]);
+                reference.push_back(oversampled[frame * 2 + 1]);
+            }
+        }
+        oversampler.downsample(oversampled.data(), buffer.data(), kFramesPerBuffer);
+        if (bufferIndex >= kNumSettlingBuffers) {
+            output.insert(output.end(), buffer.begin(), buffer.end());
+        } else {
+            reference.clear();
+        }
+    }
+
+    // At least 70 dB attenuation
+    EXPECT_LT(powerRatio(output, reference), 1e-7);
+}
+
+void checkChangingFactorResets(int factor) {
+    SCOPED_TRACE(factor);
+    mixxx::Oversampler oversampler(kFramesPerBuffer);
+    oversampler.setFactor(factor);
+
+    std::vector<CSAMPLE> input(kFramesPerBuffer * 2, 0.5f);
+    std::vector<CSAMPLE> oversampled(kFramesPerBuffer * 2 * mixxx::Oversampler::kMaxFactor);
+    std::vector<CSAMPLE> output(kFramesPerBuffer * 2);
+    oversampler.upsample(input.data(), oversampled.data(), kFramesPerBuffer);
+    oversampler.downsample(oversampled.data(), output.data(), kFramesPerBuffer);
+
+    oversampler.setFactor(1);
+    oversampler.setFactor(factor);
+    std::fill(input.begin(), input.end(), 0.0f);
+    oversampler.upsample(input.data(), oversampled.data(), kFramesPerBuffer);
+    oversampler.downsample(oversampled.data(), output.data(), kFramesPerBuffer);
+    for (CSAMPLE sample : output) {
+        EXPECT_EQ(0.0f, sample);
+    }
+}
+
+TEST(OversamplerTest, latencyOfImpulse) {
+    checkLatencyOfImpulse(2);
+    checkLatencyOfImpulse(4);
+}
+
+TEST(OversamplerTest, passesLowFrequencies) {
+    checkPassesLowFrequencies(2);
+    checkPassesLowFrequencies(4);
+}
+
+TEST(OversamplerTest, removesFrequenciesAboveNyquist) {
+    checkRemovesFrequenciesAboveNyquist(2);
+    checkRemovesFrequenciesAboveNyquist(4);
+}
+
+TEST(OversamplerTest, changingFactorResets) {
+    checkChangingFactorResets(2);
+    checkChangingFactorResets(4);
+}
+
+} // namespace
@@ -0,0 +1,98 @@
+#include "util/partitionedconvolver.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+namespace {
+
+constexpr SINT kLatency = mixxx::PartitionedConvolver::kHeadBlockSize;
+constexpr SINT kMaxKernelLength = 12000;
+constexpr SINT kInputLength = 40000;
+
+std::vector<CSAMPLE> randomSignal(std::minstd_rand* pGenerator, SINT length, float amplitude) {
+    std::uniform_real_distribution<float> distribution(-amplitude, amplitude);
+    std::vector<CSAMPLE> signal(length);
+    for (CSAMPLE& sample : signal) {
+        sample = distribution(*pGenerator);
+    }
+    return signal;
+}
+
+// Processes the input in chunks of arbitrary sizes
+std::vector<CSAMPLE> convolve(mixxx::PartitionedConvolver* pConvolver,
+        const std::vector<CSAMPLE>& input,
+        std::minstd_rand* pGenerator) {
+    std::uniform_int_distribution<SINT> chunkSize(1, 700);
+    std::vector<CSAMPLE> output(input.size());
+    const auto length = static_cast<SINT>(input.size());
+    SINT offset = 0;
+    while (offset < length) {
+        const SINT count = std::min(length - offset, chunkSize(*pGenerator));
+        pConvolver->process(&input[offset], &output[offset], count);
+        offset += count;
+    }
+    return output;
+}
+
+void assertMatchesDirectConvolution(SINT kernelLength) {
+    std::minstd_rand generator(static_cast<unsigned int>(kernelLength));
+    const std::vector<CSAMPLE> impulseResponse =
+            randomSignal(&generator, kernelLength, 0.05f);
+    const std::vector<CSAMPLE> input = randomSignal(&generator, kInputLength, 1.0f);
+
+    mixxx::ConvolutionKernel kernel(impulseResponse.data(), kernelLength);
+    mixxx::PartitionedConvolver convolver(kMaxKernelLength);
+    convolver.setKernel(&kernel);
+    const std::vector<CSAMPLE> output = convolve(&convolver, input, &generator);
+
+    for (SINT i = 0; i < kInputLength; ++i) {
+        double expected = 0.0;
+        for (SINT j = 0; j < kernelLength && j <= i - kLatency; ++j) {
+            expected += static_cast<double>(impulseResponse[j]) * input[i - kLatency - j];
+        }
+        ASSERT_NEAR(expected, output[i], 1e-5) << "kernel length " << kernelLength
+                                               << ", sample " << i;
+    }
+}
+
+TEST(PartitionedConvolverTest, MatchesDirectConvolution) {
+    // Only the head, exactly the head, and both head and tail
+    assertMatchesDirectConvolution(1);
+    assertMatchesDirectConvolution(100);
+    assertMatchesDirectConvolution(2 * mixxx::PartitionedConvolver::kTailBlockSize);
+    assertMatchesDirectConvolution(2 * mixxx::PartitionedConvolver::kTailBlockSize + 1);
+    assertMatchesDirectConvolution(10277);
+}
+
+TEST(PartitionedConvolverTest, SilentWithoutKernel) {
+    std::minstd_rand generator;
+    const std::vector<CSAMPLE> input = randomSignal(&generator, kInputLength, 1.0f);
+    mixxx::PartitionedConvolver convolver(kMaxKernelLength);
+    const std::vector<CSAMPLE> output = convolve(&convolver, input, &generator);
+    for (const CSAMPLE sample : output) {
+        ASSERT_EQ(0.0f, sample);
+    }
+}
+
+TEST(PartitionedConvolverTest, ResetDiscardsInput) {
+    std::minstd_rand generator;
+    const std::vector<CSAMPLE> impulseResponse = randomSignal(&generator, 10000, 0.05f);
+    mixxx::ConvolutionKernel kernel(impulseResponse.data(), 10000);
+    mixxx::PartitionedConvolver convolver(kMaxKernelLength);
+    convolver.setKernel(&kernel);
+
+    const std::vector<CSAMPLE> input = randomSignal(&generator, kInputLength, 1.0f);
+    convolve(&convolver, input, &generator);
+    convolver.reset();
+
+    const std::vector<CSAMPLE> silence(kInputLength);
+    const std::vector<CSAMPLE> output = convolve(&convolver, silence, &generator);
+    for (const CSAMPLE sample : output) {
+        ASSERT_EQ(0.0f, sample);
+    }
+}
+
+} // namespace
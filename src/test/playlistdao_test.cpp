@@ -0,0 +1,77 @@
+#include <gtest/gtest.h>
+
+#include <QSqlQuery>
+
+#include "library/dao/playlistdao.h"
+#include "test/librarytest.h"
+
+namespace {
+
+class PlaylistDAOTest : public LibraryTest {
+  protected:
+    PlaylistDAOTest()
+            : m_playlistDao(internalCollection()->getPlaylistDAO()),
+              m_playlistId(m_playlistDao.createPlaylist(QStringLiteral("playlist"))) {
+    }
+
+    /// Returns the track ids ordered by position and verifies that the
+    /// positions are consecutive.
+    QList<TrackId> trackIdsByPosition() const {
+        QSqlQuery query(dbConnection());
+        query.prepare(QStringLiteral(
+                "SELECT track_id, position FROM PlaylistTracks "
+                "WHERE playlist_id=:id ORDER BY position"));
+        query.bindValue(":id", m_playlistId);
+        EXPECT_TRUE(query.exec());
+        QList<TrackId> trackIds;
+        while (query.next()) {
+            trackIds.append(TrackId(query.value(0)));
+            EXPECT_EQ(trackIds.size(), query.value(1).toInt());
+        }
+        return trackIds;
+    }
+
+    PlaylistDAO& m_playlistDao;
+    const int m_playlistId;
+};
+
+TEST_F(PlaylistDAOTest, insertTracks) {
+    ASSERT_TRUE(m_playlistDao.appendTracksToPlaylist(
+            {TrackId(1), TrackId(2), TrackId(3)}, m_playlistId));
+
+    EXPECT_EQ(2,
+            m_playlistDao.insertTracksIntoPlaylist(
+                    {TrackId(4), TrackId(), TrackId(5)}, m_playlistId, 2));
+
+    const QList<TrackId> expected{TrackId(1), TrackId(4), TrackId(5), TrackId(2), TrackId(3)};
+    EXPECT_EQ(expected, trackIdsByPosition());
+}
+
+TEST_F(PlaylistDAOTest, removeTracks) {
+    ASSERT_TRUE(m_playlistDao.appendTracksToPlaylist(
+            {TrackId(1), TrackId(2), TrackId(3), TrackId(4), TrackId(5), TrackId(6)},
+            m_playlistId));
+
+    m_playlistDao.removeTracksFromPlaylist(m_playlistId, {5, 2, 3, 2});
+
+    const QList<TrackId> expected{TrackId(1), TrackId(4), TrackId(6)};
+    EXPECT_EQ(expected, trackIdsByPosition());
+    EXPECT_FALSE(m_playlistDao.isTrackInPlaylist(TrackId(2), m_playlistId));
+    EXPECT_TRUE(m_playlistDao.isTrackInPlaylist(TrackId(4), m_playlistId));
+}
+
+TEST_F(PlaylistDAOTest, removeTracksFromPlaylists) {
+    const int otherPlaylistId = m_playlistDao.createPlaylist(QStringLiteral("other"));
+    ASSERT_TRUE(m_playlistDao.appendTracksToPlaylist(
+            {TrackId(1), TrackId(2), TrackId(1), TrackId(3)}, m_playlistId));
+    ASSERT_TRUE(m_playlistDao.appendTracksToPlaylist(
+            {TrackId(2), TrackId(3)}, otherPlaylistId));
+
+    m_playlistDao.removeTracksFromPlaylists({TrackId(1), TrackId(2)});
+
+    const QList<TrackId> expected{TrackId(3)};
+    EXPECT_EQ(expected, trackIdsByPosition());
+    EXPECT_EQ(expected, m_playlistDao.getTrackIds(otherPlaylistId));
+}
+
+} // namespace
@@ -0,0 +1,113 @@
+#include "util/polyphaseresampler.h"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+#include "util/math.h"
+
+namespace {
+
+constexpr SINT kFramesPerBuffer = 1000;
+constexpr int kNumBuffers = 100;
+// The filter is settled after these buffers
+constexpr int kNumSettlingBuffers = 2;
+constexpr double kAmplitude = 0.5;
+
+struct Result {
+    SINT outputFrames;
+    // The RMS of the left channel after the filter has settled
+    double rms;
+};
+
+Result resampleSine(mixxx::audio::SampleRate inputSampleRate,
+        mixxx::audio::SampleRate outputSampleRate,
+        double frequency) {
+    mixxx::PolyphaseResampler resampler(inputSampleRate, outputSampleRate);
+    std::vector<CSAMPLE> input(kFramesPerBuffer * 2);
+    std::vector<CSAMPLE> output(resampler.maxOutputFrames(kFramesPerBuffer) * 2);
+    Result result{0, 0};
+    double power = 0;
+    SINT settledFrames = 0;
+    for (int buffer = 0; buffer < kNumBuffers; ++buffer) {
+        for (SINT i = 0; i < kFramesPerBuffer; ++i) {
+            const auto value = static_cast<CSAMPLE>(kAmplitude *
+                    std::sin(2 * M_PI * frequency * (buffer * kFramesPerBuffer + i) /
+                            inputSampleRate.value()));
+            input[i * 2] = value;
+            input[i * 2 + 1] = -value;
+        }
+        const SINT frames = resampler.process(input.data(), kFramesPerBuffer, output.data());
+        EXPECT_LE(frames, resampler.maxOutputFrames(kFramesPerBuffer));
+        result.outputFrames += frames;
+        if (buffer < kNumSettlingBuffers) {
+            continue;
+        }
+        for (SINT i = 0; i < frames; ++i) {
+            EXPECT_EQ(output[i * 2], -output[i * 2 + 1]);
+            power += static_cast<double>(output[i * 2]) * output[i * 2];
+        }
+        settledFrames += frames;
+    }
+    result.rms = std::sqrt(power / settledFrames);
+    return result;
+}
+
+void checkRatio(mixxx::audio::SampleRate inputSampleRate,
+        mixxx::audio::SampleRate outputSampleRate) {
+    SCOPED_TRACE(QStringLiteral("%1 -> %2")
+                    .arg(inputSampleRate.value())
+                    .arg(outputSampleRate.value())
+                    .toStdString());
+    const double sineRms = kAmplitude / std::sqrt(2.0);
+
+    // The number of frames follows the ratio of the sample rates exactly
+    const Result passband = resampleSine(inputSampleRate, outputSampleRate, 1000);
+    const double expectedFrames = static_cast<double>(kNumBuffers) *
+            kFramesPerBuffer * outputSampleRate.value() / inputSampleRate.value();
+    EXPECT_NEAR(expectedFrames, passband.outputFrames, 1.0);
+    EXPECT_NEAR(sineRms, passband.rms, sineRms * 0.001);
+
+    // Flat up to the edge of the audible range
+    const Result edge = resampleSine(inputSampleRate, outputSampleRate, 18000);
+    EXPECT_NEAR(sineRms, edge.rms, sineRms * 0.05);
+
+    if (outputSampleRate < inputSampleRate) {
+        // Frequencies above the new Nyquist frequency are removed instead of
+        // being aliased
+        const Result stopband = resampleSine(
+                inputSampleRate, outputSampleRate, outputSampleRate.value() * 0.6);
+        EXPECT_LT(stopband.rms, sineRms * 1e-3);
+    }
+}
+
+TEST(PolyphaseResamplerTest, Upsample) {
+    checkRatio(mixxx::audio::SampleRate(44100), mixxx::audio::SampleRate(48000));
+}
+
+TEST(PolyphaseResamplerTest, DownsampleByInteger) {
+    checkRatio(mixxx::audio::SampleRate(96000), mixxx::audio::SampleRate(48000));
+    checkRatio(mixxx::audio::SampleRate(192000), mixxx::audio::SampleRate(48000));
+}
+
+TEST(PolyphaseResamplerTest, DownsampleByFraction) {
+    checkRatio(mixxx::audio::SampleRate(88200), mixxx::audio::SampleRate(48000));
+}
+
+TEST(PolyphaseResamplerTest, Reset) {
+    mixxx::PolyphaseResampler resampler(
+            mixxx::audio::SampleRate(44100), mixxx::audio::SampleRate(48000));
+    std::vector<CSAMPLE> input(kFramesPerBuffer * 2, 0.5f);
+    std::vector<CSAMPLE> output(resampler.maxOutputFrames(kFramesPerBuffer) * 2);
+    resampler.process(input.data(), kFramesPerBuffer, output.data());
+
+    resampler.reset();
+    std::fill(input.begin(), input.end(), 0.0f);
+    const SINT frames = resampler.process(input.data(), kFramesPerBuffer, output.data());
+    for (SINT i = 0; i < frames * 2; ++i) {
+        EXPECT_EQ(0.0f, output[i]);
+    }
+}
+
+} // namespace
@@ -2,6 +2,7 @@
 
 #include <QtDebug>
 #include <QScopedPointer>
+#include <cmath>
 
 #include "engine/cachingreader/cachingreader.h"
 #include "control/controlobject.h"
@@ -31,6 +32,27 @@ class StubReader : public CachingReader {
     }
 };
 
+// Returns 1.0 for all samples before the boundary and 0.0 after it
+class BoundaryReader : public CachingReader {
+  public:
+    explicit BoundaryReader(SINT boundary)
+            : CachingReader(kGroup, UserSettingsPointer()),
+              m_boundary(boundary) {
+    }
+
+    CachingReader::ReadResult read(SINT startSample, SINT numSamples, bool reverse,
+             CSAMPLE* buffer) override {
+        RELEASE_ASSERT(!reverse);
+        for (SINT i = 0; i < numSamples; ++i) {
+            buffer[i] = startSample + i < m_boundary ? 1.0f : 0.0f;
+        }
+        return CachingReader::ReadResult::AVAILABLE;
+    }
+
+  private:
+    const SINT m_boundary;
+};
+
 class StubLoopControl : public LoopingControl {
   public:
     StubLoopControl()
@@ -140,3 +162,32 @@ TEST_F(ReadAheadManagerTest, FractionalFrameLoop) {
     // The rounding error must not exceed a half frame (one samples in stereo)
     EXPECT_NEAR(16, m_pReadAheadManager->getPlaypos(), 1);
 }
+
+TEST_F(ReadAheadManagerTest, LoopCrossFade) {
+    // The loop from 0 to 200 samples is read as 1.0, the samples after it as 0.0
+    BoundaryReader reader(200);
+    ReadAheadManager readAheadManager(&reader, m_pLoopControl.data());
+    readAheadManager.notifySeek(0.0);
+    for (int i = 0; i < 3; ++i) {
+        m_pLoopControl->pushTriggerReturnValue(200);
+        m_pLoopControl->pushTargetReturnValue(0);
+    }
+
+    // Read up to the loop end without fading
+    EXPECT_EQ(200, readAheadManager.getNextSamples(1.0, m_pBuffer, 400));
+    EXPECT_FLOAT_EQ(1.0f, m_pBuffer[198]);
+
+    // The crossfade lasts half of the loop, 50 frames, and continues across
+    // reads. The fade-in gain is the square root of the progress.
+    EXPECT_EQ(60, readAheadManager.getNextSamples(1.0, m_pBuffer, 60));
+    EXPECT_FLOAT_EQ(0.0f, m_pBuffer[0]);
+    EXPECT_FLOAT_EQ(0.0f, m_pBuffer[1]);
+    EXPECT_NEAR(std::sqrt(10.0f / 50), m_pBuffer[20], 1e-5);
+    EXPECT_NEAR(std::sqrt(29.0f / 50), m_pBuffer[59], 1e-5);
+
+    EXPECT_EQ(100, readAheadManager.getNextSamples(1.0, m_pBuffer, 100));
+    EXPECT_NEAR(std::sqrt(30.0f / 50), m_pBuffer[0], 1e-5);
+    EXPECT_NEAR(std::sqrt(49.0f / 50), m_pBuffer[39], 1e-5);
+    EXPECT_FLOAT_EQ(1.0f, m_pBuffer[40]);
+    EXPECT_FLOAT_EQ(1.0f, m_pBuffer[99]);
+}
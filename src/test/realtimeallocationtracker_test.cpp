@@ -0,0 +1,44 @@
+#include "util/realtimeallocationtracker.h"
+
+#include <gtest/gtest.h>
+
+#include <QByteArray>
+#include <QMutex>
+
+#include "util/compatibility/qmutex.h"
+
+namespace {
+
+using mixxx::RealtimeAllocationTracker;
+
+TEST(RealtimeAllocationTrackerTest, IgnoreCallsOutsideOfSections) {
+    const quint64 violationCountBefore = RealtimeAllocationTracker::violationCount();
+    QByteArray buffer(1024, 'x');
+    QMutex mutex;
+    {
+        const auto locker = lockMutex(&mutex);
+        buffer.append(buffer);
+    }
+    EXPECT_EQ(violationCountBefore, RealtimeAllocationTracker::violationCount());
+}
+
+TEST(RealtimeAllocationTrackerTest, DetectCallsInSections) {
+    if (!RealtimeAllocationTracker::isAvailable()) {
+        return;
+    }
+    const quint64 violationCountBefore = RealtimeAllocationTracker::violationCount();
+    QMutex mutex;
+    {
+        RealtimeAllocationTracker::RealtimeSection outerSection;
+        {
+            RealtimeAllocationTracker::RealtimeSection innerSection;
+            // Allocation and deallocation
+            QByteArray buffer(1024, 'x');
+        }
+        const auto locker = lockMutex(&mutex);
+    }
+    EXPECT_LE(violationCountBefore + 3, RealtimeAllocationTracker::violationCount());
+    EXPECT_FALSE(RealtimeAllocationTracker::recordedViolations().isEmpty());
+}
+
+} // namespace
@@ -0,0 +1,57 @@
+#include "util/realtimelog.h"
+
+#include <gtest/gtest.h>
+
+#include <thread>
+
+namespace {
+
+using mixxx::RealtimeLog;
+
+TEST(RealtimeLogTest, Format) {
+    const RealtimeLog::Record record{mixxx::LogLevel::Debug,
+            "Test",
+            "Frame %1 of %2, rate %3",
+            {1024, 44100, 1.5, 0},
+            3};
+    EXPECT_EQ(QStringLiteral("Frame 1024 of 44100, rate 1.5"),
+            RealtimeLog::format(record));
+}
+
+TEST(RealtimeLogTest, FormatWithoutArgs) {
+    const RealtimeLog::Record record{mixxx::LogLevel::Debug,
+            "Test",
+            "No arguments",
+            {},
+            0};
+    EXPECT_EQ(QStringLiteral("No arguments"), RealtimeLog::format(record));
+}
+
+TEST(RealtimeLogTest, DropMessagesOfFullPipe) {
+    // Warnings are logged with the default log level of the tests
+    RealtimeLog::flush();
+    const quint64 droppedBefore = RealtimeLog::droppedMessageCount();
+    for (size_t i = 0; i < RealtimeLog::kMaxPendingRecords + 5; ++i) {
+        RealtimeLog::warning("RealtimeLogTest", "Message %1", i);
+    }
+    EXPECT_EQ(droppedBefore + 5, RealtimeLog::droppedMessageCount());
+
+    // After a flush the pipe accepts messages again
+    RealtimeLog::flush();
+    RealtimeLog::warning("RealtimeLogTest", "Message after flush");
+    EXPECT_EQ(droppedBefore + 5, RealtimeLog::droppedMessageCount());
+    RealtimeLog::flush();
+}
+
+TEST(RealtimeLogTest, FlushMessagesOfFinishedThread) {
+    const quint64 droppedBefore = RealtimeLog::droppedMessageCount();
+    std::thread thread([] {
+        RealtimeLog::prepareThread();
+        RealtimeLog::warning("RealtimeLogTest", "Message from %1", 2);
+    });
+    thread.join();
+    RealtimeLog::flush();
+    EXPECT_EQ(droppedBefore, RealtimeLog::droppedMessageCount());
+}
+
+} // namespace
@@ -4,9 +4,15 @@
 #include <QList>
 #include <QPair>
 #include <QtDebug>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <utility>
 #include <vector>
 
 #include "util/sample.h"
+#include "util/sample_kernels.h"
 #include "util/timer.h"
 
 namespace {
@@ -122,6 +128,37 @@ TEST_F(SampleUtilTest, addWithGain) {
     }
 }
 
+TEST_F(SampleUtilTest, applyRampingGainAndAdd) {
+    for (int i = 0; i < evenBuffers.size(); ++i) {
+        const int size = sizes[evenBuffers[i]];
+        std::vector<CSAMPLE> src(size);
+        for (int s = 0; s < size; ++s) {
+            src[s] = static_cast<CSAMPLE>((s * 37) % 101 - 50) / 40.0f;
+        }
+        for (const auto& gains : {
+                     std::make_pair(0.2f, 0.9f),
+                     std::make_pair(0.5f, 0.5f),
+                     std::make_pair(1.0f, 1.0f),
+                     std::make_pair(0.0f, 0.0f)}) {
+            // Same results as applying the gain and adding in two passes
+            std::vector<CSAMPLE> expectedBuffer(src);
+            std::vector<CSAMPLE> expectedDest(size, 0.25f);
+            SampleUtil::applyRampingGain(
+                    expectedBuffer.data(), gains.first, gains.second, size);
+            SampleUtil::add(expectedDest.data(), expectedBuffer.data(), size);
+
+            std::vector<CSAMPLE> buffer(src);
+            std::vector<CSAMPLE> dest(size, 0.25f);
+            SampleUtil::applyRampingGainAndAdd(
+                    buffer.data(), dest.data(), gains.first, gains.second, size);
+            EXPECT_EQ(expectedBuffer, buffer);
+            for (int s = 0; s < size; ++s) {
+                EXPECT_FLOAT_EQ(expectedDest[s], dest[s]);
+            }
+        }
+    }
+}
+
 
 TEST_F(SampleUtilTest, add2WithGain) {
     for (int i = 0; i < buffers.size(); ++i) {
@@ -350,6 +387,55 @@ TEST_F(SampleUtilTest, deinterleaveBuffer) {
     }
 }
 
+TEST_F(SampleUtilTest, deinterleaveBufferWithGain) {
+    for (int i = 0; i < buffers.size(); ++i) {
+        CSAMPLE* buffer = buffers[i];
+        int size = sizes[i];
+        FillBuffer(buffer, 0.0f, size);
+        CSAMPLE* buffer2 = SampleUtil::alloc(size);
+        FillBuffer(buffer2, 0.0f, size);
+        CSAMPLE* buffer3 = SampleUtil::alloc(size*2);
+        for (int j = 0; j < size; j++) {
+            buffer3[j*2] = j;
+            buffer3[j*2+1] = -j;
+        }
+        SampleUtil::deinterleaveBufferWithGain(buffer, buffer2, buffer3, 2.0f, size);
+
+        for (int j = 0; j < size; j++) {
+            EXPECT_FLOAT_EQ(buffer[j], 2.0f * j);
+            EXPECT_FLOAT_EQ(buffer2[j], -2.0f * j);
+        }
+
+        SampleUtil::free(buffer2);
+        SampleUtil::free(buffer3);
+    }
+}
+
+TEST_F(SampleUtilTest, equalPowerCrossfadeBuffersIn) {
+    CSAMPLE fadeIn[8];
+    CSAMPLE fadeOut[8];
+    SampleUtil::fill(fadeIn, 1.0f, 8);
+    SampleUtil::fill(fadeOut, 0.5f, 8);
+
+    // The second half of a crossfade over 8 frames
+    SampleUtil::equalPowerCrossfadeBuffersIn(fadeIn, fadeOut, 8, 0.5f, 1.0f);
+    for (int i = 0; i < 4; ++i) {
+        const float x = 0.5f + 0.125f * i;
+        EXPECT_FLOAT_EQ(std::sqrt(x) + 0.5f * std::sqrt(1.0f - x), fadeIn[i * 2]);
+        EXPECT_FLOAT_EQ(fadeIn[i * 2], fadeIn[i * 2 + 1]);
+    }
+
+    // Uncorrelated signals keep their power
+    SampleUtil::fill(fadeIn, 1.0f, 8);
+    SampleUtil::fill(fadeOut, 0.0f, 8);
+    SampleUtil::equalPowerCrossfadeBuffersIn(fadeIn, fadeOut, 8, 0.0f, 1.0f);
+    CSAMPLE fadeInPower = fadeIn[4] * fadeIn[4];
+    SampleUtil::fill(fadeIn, 0.0f, 8);
+    SampleUtil::fill(fadeOut, 1.0f, 8);
+    SampleUtil::equalPowerCrossfadeBuffersIn(fadeIn, fadeOut, 8, 0.0f, 1.0f);
+    EXPECT_FLOAT_EQ(1.0f, fadeInPower + fadeIn[4] * fadeIn[4]);
+}
+
 TEST_F(SampleUtilTest, reverse) {
     if (buffers.size() > 0 && sizes[0] > 10) {
         CSAMPLE* buffer = buffers[1];
@@ -397,6 +483,273 @@ TEST_F(SampleUtilTest, copyReverse) {
     }
 }
 
+// All variants of the kernels that are supported by the CPU must produce
+// the same results as the generic kernels, including the scalar tails.
+TEST_F(SampleUtilTest, kernelVariantsMatchGeneric) {
+    using mixxx::sampleutil::InstructionSet;
+    const auto* pGeneric = mixxx::sampleutil::genericKernels();
+    ASSERT_NE(nullptr, pGeneric);
+    ASSERT_NE(nullptr,
+            mixxx::sampleutil::kernelsFor(
+                    mixxx::sampleutil::kernels().instructionSet));
+
+    constexpr SINT kMaxFrames = 67;
+    constexpr SINT kMaxSamples = kMaxFrames * 2;
+    std::vector<CSAMPLE> src1(kMaxSamples);
+    std::vector<CSAMPLE> src2(kMaxSamples);
+    std::vector<CSAMPLE> src3(kMaxSamples);
+    for (SINT i = 0; i < kMaxSamples; ++i) {
+        // Deterministic values with both signs and some > 1.0
+        src1[i] = static_cast<CSAMPLE>((i * 37) % 101 - 50) / 40.0f;
+        src2[i] = static_cast<CSAMPLE>((i * 53) % 89 - 44) / 50.0f;
+        src3[i] = static_cast<CSAMPLE>((i * 71) % 97 - 48) / 60.0f;
+    }
+
+    for (const auto instructionSet : {
+                 InstructionSet::SSE2,
+                 InstructionSet::AVX2,
+                 InstructionSet::AVX512,
+                 InstructionSet::NEON}) {
+        const auto* pKernels = mixxx::sampleutil::kernelsFor(instructionSet);
+        if (!pKernels) {
+            continue;
+        }
+        SCOPED_TRACE(mixxx::sampleutil::instructionSetName(instructionSet));
+        EXPECT_EQ(instructionSet, pKernels->instructionSet);
+        for (SINT numFrames = 0; numFrames <= kMaxFrames; ++numFrames) {
+            SCOPED_TRACE(numFrames);
+            const SINT numSamples = numFrames * 2;
+            std::vector<CSAMPLE> expected(src3.begin(), src3.end());
+            std::vector<CSAMPLE> actual(src3.begin(), src3.end());
+            // Multiplications and additions might be fused into FMA
+            // instructions with a different rounding.
+            const auto expectBuffersEqual = [&]() {
+                for (SINT i = 0; i < kMaxSamples; ++i) {
+                    EXPECT_NEAR(expected[i], actual[i], 1e-5f) << "i = " << i;
+                }
+            };
+
+            pGeneric->applyGain(expected.data(), 0.7f, numSamples);
+            pKernels->applyGain(actual.data(), 0.7f, numSamples);
+            expectBuffersEqual();
+
+            pGeneric->applyRampingGain(expected.data(), 0.2f, 0.01f, numFrames);
+            pKernels->applyRampingGain(actual.data(), 0.2f, 0.01f, numFrames);
+            expectBuffersEqual();
+
+            pGeneric->copyWithGain(expected.data(), src1.data(), 1.3f, numSamples);
+            pKernels->copyWithGain(actual.data(), src1.data(), 1.3f, numSamples);
+            expectBuffersEqual();
+
+            pGeneric->copyWithRampingGain(
+                    expected.data(), src2.data(), 1.0f, -0.02f, numFrames);
+            pKernels->copyWithRampingGain(
+                    actual.data(), src2.data(), 1.0f, -0.02f, numFrames);
+            expectBuffersEqual();
+
+            pGeneric->addWithGain(expected.data(), src1.data(), 0.5f, numSamples);
+            pKernels->addWithGain(actual.data(), src1.data(), 0.5f, numSamples);
+            expectBuffersEqual();
+
+            pGeneric->addWithRampingGain(
+                    expected.data(), src2.data(), 0.1f, 0.03f, numFrames);
+            pKernels->addWithRampingGain(
+                    actual.data(), src2.data(), 0.1f, 0.03f, numFrames);
+            expectBuffersEqual();
+
+            std::vector<CSAMPLE> expectedBuffer(src1.begin(), src1.end());
+            std::vector<CSAMPLE> actualBuffer(src1.begin(), src1.end());
+            pGeneric->applyGainAndAdd(
+                    expectedBuffer.data(), expected.data(), 0.6f, numSamples);
+            pKernels->applyGainAndAdd(
+                    actualBuffer.data(), actual.data(), 0.6f, numSamples);
+            EXPECT_EQ(expectedBuffer, actualBuffer);
+            expectBuffersEqual();
+
+            pGeneric->applyRampingGainAndAdd(
+                    expectedBuffer.data(), expected.data(), 0.4f, -0.01f, numFrames);
+            pKernels->applyRampingGainAndAdd(
+                    actualBuffer.data(), actual.data(), 0.4f, -0.01f, numFrames);
+            EXPECT_EQ(expectedBuffer, actualBuffer);
+            expectBuffersEqual();
+
+            pGeneric->add2WithGain(expected.data(),
+                    src1.data(),
+                    0.25f,
+                    src2.data(),
+                    0.75f,
+                    numSamples);
+            pKernels->add2WithGain(actual.data(),
+                    src1.data(),
+                    0.25f,
+                    src2.data(),
+                    0.75f,
+                    numSamples);
+            expectBuffersEqual();
+
+            pGeneric->add3WithGain(expected.data(),
+                    src1.data(),
+                    0.25f,
+                    src2.data(),
+                    0.5f,
+                    src3.data(),
+                    0.125f,
+                    numSamples);
+            pKernels->add3WithGain(actual.data(),
+                    src1.data(),
+                    0.25f,
+                    src2.data(),
+                    0.5f,
+                    src3.data(),
+                    0.125f,
+                    numSamples);
+            expectBuffersEqual();
+
+            pGeneric->interleaveBuffer(
+                    expected.data(), src1.data(), src2.data(), numFrames);
+            pKernels->interleaveBuffer(
+                    actual.data(), src1.data(), src2.data(), numFrames);
+            expectBuffersEqual();
+
+            pGeneric->crossfade(expected.data(),
+                    src1.data(),
+                    src2.data(),
+                    1.0f / kMaxSamples,
+                    3,
+                    numSamples);
+            pKernels->crossfade(actual.data(),
+                    src1.data(),
+                    src2.data(),
+                    1.0f / kMaxSamples,
+                    3,
+                    numSamples);
+            expectBuffersEqual();
+
+            EXPECT_FLOAT_EQ(pGeneric->maxAbsAmplitude(src1.data(), numSamples),
+                    pKernels->maxAbsAmplitude(src1.data(), numSamples));
+
+            CSAMPLE expectedSumL, expectedSumR, expectedMaxL, expectedMaxR;
+            CSAMPLE actualSumL, actualSumR, actualMaxL, actualMaxR;
+            pGeneric->sumAbsPerChannel(&expectedSumL,
+                    &expectedSumR,
+                    &expectedMaxL,
+                    &expectedMaxR,
+                    src2.data(),
+                    numFrames);
+            pKernels->sumAbsPerChannel(&actualSumL,
+                    &actualSumR,
+                    &actualMaxL,
+                    &actualMaxR,
+                    src2.data(),
+                    numFrames);
+            // The order of the additions differs
+            EXPECT_NEAR(expectedSumL, actualSumL, 1e-4f);
+            EXPECT_NEAR(expectedSumR, actualSumR, 1e-4f);
+            EXPECT_FLOAT_EQ(expectedMaxL, actualMaxL);
+            EXPECT_FLOAT_EQ(expectedMaxR, actualMaxR);
+
+            pGeneric->maxAbsPerChannel(
+                    &expectedMaxL, &expectedMaxR, src3.data(), numFrames);
+            pKernels->maxAbsPerChannel(
+                    &actualMaxL, &actualMaxR, src3.data(), numFrames);
+            EXPECT_FLOAT_EQ(expectedMaxL, actualMaxL);
+            EXPECT_FLOAT_EQ(expectedMaxR, actualMaxR);
+
+            // src3 serves as dither, the results must match exactly
+            std::vector<std::int16_t> expectedS16(kMaxSamples);
+            std::vector<std::int16_t> actualS16(kMaxSamples);
+            pGeneric->convertToInt16(expectedS16.data(),
+                    src1.data(),
+                    src3.data(),
+                    32768.0f,
+                    -32768.0f,
+                    32767.0f,
+                    numSamples);
+            pKernels->convertToInt16(actualS16.data(),
+                    src1.data(),
+                    src3.data(),
+                    32768.0f,
+                    -32768.0f,
+                    32767.0f,
+                    numSamples);
+            EXPECT_EQ(expectedS16, actualS16);
+
+            std::vector<std::int32_t> expectedS32(kMaxSamples);
+            std::vector<std::int32_t> actualS32(kMaxSamples);
+            pGeneric->convertToInt32(expectedS32.data(),
+                    src2.data(),
+                    nullptr,
+                    8388608.0f,
+                    -8388608.0f,
+                    8388607.0f,
+                    8,
+                    numSamples);
+            pKernels->convertToInt32(actualS32.data(),
+                    src2.data(),
+                    nullptr,
+                    8388608.0f,
+                    -8388608.0f,
+                    8388607.0f,
+                    8,
+                    numSamples);
+            EXPECT_EQ(expectedS32, actualS32);
+        }
+    }
+}
+
+TEST_F(SampleUtilTest, convertFloat32ToS32) {
+    const CSAMPLE buffer[] = {1.5f, 1.0f, 0.5f, 0.0f, -0.5f, -1.0f, -1.5f};
+    std::int32_t s32[7];
+    SampleUtil::convertFloat32ToS32(s32, buffer, 7, 24);
+    // Clamped and aligned to the left
+    EXPECT_EQ(8388607 * 256, s32[0]);
+    EXPECT_EQ(8388607 * 256, s32[1]);
+    EXPECT_EQ(4194304 * 256, s32[2]);
+    EXPECT_EQ(0, s32[3]);
+    EXPECT_EQ(-4194304 * 256, s32[4]);
+    EXPECT_EQ(std::numeric_limits<std::int32_t>::min(), s32[5]);
+    EXPECT_EQ(std::numeric_limits<std::int32_t>::min(), s32[6]);
+
+    SampleUtil::convertFloat32ToS32(s32, buffer, 7, 16);
+    EXPECT_EQ(32767 * 65536, s32[0]);
+    EXPECT_EQ(16384 * 65536, s32[2]);
+    EXPECT_EQ(std::numeric_limits<std::int32_t>::min(), s32[5]);
+}
+
+TEST_F(SampleUtilTest, tpdfDither) {
+    constexpr SINT kSamples = 100 * SampleUtil::TpdfDither::kMaxSamples;
+    std::vector<CSAMPLE> silence(kSamples);
+    std::vector<SAMPLE> s16(kSamples);
+    SampleUtil::TpdfDither dither;
+    SampleUtil::convertFloat32ToS16(s16.data(), silence.data(), kSamples, &dither);
+    // Silence is dithered to -1, 0 and 1 with a mean of about 0
+    int sum = 0;
+    int zeros = 0;
+    for (const SAMPLE sample : s16) {
+        ASSERT_LE(std::abs(sample), 1);
+        sum += sample;
+        zeros += sample == 0 ? 1 : 0;
+    }
+    EXPECT_LT(std::abs(sum), kSamples / 100);
+    // Rounding the triangular distribution gives 0 with a probability
+    // of 3/4
+    EXPECT_NEAR(0.75, static_cast<double>(zeros) / kSamples, 0.02);
+
+    // Without dither silence stays silent
+    SampleUtil::convertFloat32ToS16(s16.data(), silence.data(), kSamples);
+    for (const SAMPLE sample : s16) {
+        ASSERT_EQ(0, sample);
+    }
+}
+
+TEST_F(SampleUtilTest, maxAbsAmplitude) {
+    CSAMPLE buffer[] = {-0.5f, 0.25f, -0.75f, 0.1f};
+    EXPECT_FLOAT_EQ(0.75f, SampleUtil::maxAbsAmplitude(buffer, 4));
+    // The first sample must not be taken as is
+    buffer[0] = -0.9f;
+    EXPECT_FLOAT_EQ(0.9f, SampleUtil::maxAbsAmplitude(buffer, 4));
+}
+
 static void BM_MemCpy(benchmark::State& state) {
     SINT size = static_cast<SINT>(state.range(0));
     CSAMPLE* buffer = SampleUtil::alloc(size);
@@ -583,4 +936,165 @@ static void BM_Copy2WithRampingGain(benchmark::State& state) {
 }
 BENCHMARK(BM_Copy2WithRampingGain)->Range(64, 4096);
 
+// Each kernel is measured for all variants. Variants that are not
+// supported are reported as errors.
+#define BENCHMARK_KERNEL_VARIANTS(func)                                       \
+    BENCHMARK_CAPTURE(func, Generic, mixxx::sampleutil::InstructionSet::Generic) \
+            ->Range(64, 4096);                                                \
+    BENCHMARK_CAPTURE(func, SSE2, mixxx::sampleutil::InstructionSet::SSE2)    \
+            ->Range(64, 4096);                                                \
+    BENCHMARK_CAPTURE(func, AVX2, mixxx::sampleutil::InstructionSet::AVX2)    \
+            ->Range(64, 4096);                                                \
+    BENCHMARK_CAPTURE(func, AVX512, mixxx::sampleutil::InstructionSet::AVX512) \
+            ->Range(64, 4096);                                                \
+    BENCHMARK_CAPTURE(func, NEON, mixxx::sampleutil::InstructionSet::NEON)    \
+            ->Range(64, 4096)
+
+static const mixxx::sampleutil::Kernels* kernelsForBenchmark(
+        benchmark::State& state,
+        mixxx::sampleutil::InstructionSet instructionSet) {
+    const auto* pKernels = mixxx::sampleutil::kernelsFor(instructionSet);
+    if (!pKernels) {
+        state.SkipWithError("Not supported");
+    }
+    return pKernels;
+}
+
+static void BM_KernelApplyGain(benchmark::State& state,
+        mixxx::sampleutil::InstructionSet instructionSet) {
+    const auto* pKernels = kernelsForBenchmark(state, instructionSet);
+    if (!pKernels) {
+        return;
+    }
+    SINT size = static_cast<SINT>(state.range(0));
+    CSAMPLE* buffer = SampleUtil::alloc(size);
+    SampleUtil::fill(buffer, 0.5f, size);
+
+    while (state.KeepRunning()) {
+        pKernels->applyGain(buffer, 1.0001f, size);
+    }
+
+    SampleUtil::free(buffer);
+}
+BENCHMARK_KERNEL_VARIANTS(BM_KernelApplyGain);
+
+static void BM_KernelAddWithRampingGain(benchmark::State& state,
+        mixxx::sampleutil::InstructionSet instructionSet) {
+    const auto* pKernels = kernelsForBenchmark(state, instructionSet);
+    if (!pKernels) {
+        return;
+    }
+    SINT size = static_cast<SINT>(state.range(0));
+    CSAMPLE* buffer = SampleUtil::alloc(size);
+    SampleUtil::fill(buffer, 0.0f, size);
+    CSAMPLE* buffer2 = SampleUtil::alloc(size);
+    SampleUtil::fill(buffer2, 0.5f, size);
+
+    while (state.KeepRunning()) {
+        pKernels->addWithRampingGain(buffer, buffer2, 1.1f, 0.001f, size / 2);
+    }
+
+    SampleUtil::free(buffer);
+    SampleUtil::free(buffer2);
+}
+BENCHMARK_KERNEL_VARIANTS(BM_KernelAddWithRampingGain);
+
+static void BM_KernelAdd3WithGain(benchmark::State& state,
+        mixxx::sampleutil::InstructionSet instructionSet) {
+    const auto* pKernels = kernelsForBenchmark(state, instructionSet);
+    if (!pKernels) {
+        return;
+    }
+    SINT size = static_cast<SINT>(state.range(0));
+    CSAMPLE* buffer = SampleUtil::alloc(size);
+    SampleUtil::fill(buffer, 0.0f, size);
+    CSAMPLE* buffer2 = SampleUtil::alloc(size);
+    SampleUtil::fill(buffer2, 0.5f, size);
+    CSAMPLE* buffer3 = SampleUtil::alloc(size);
+    SampleUtil::fill(buffer3, 0.25f, size);
+    CSAMPLE* buffer4 = SampleUtil::alloc(size);
+    SampleUtil::fill(buffer4, 0.125f, size);
+
+    while (state.KeepRunning()) {
+        pKernels->add3WithGain(
+                buffer, buffer2, 1.1f, buffer3, 1.2f, buffer4, 1.3f, size);
+    }
+
+    SampleUtil::free(buffer);
+    SampleUtil::free(buffer2);
+    SampleUtil::free(buffer3);
+    SampleUtil::free(buffer4);
+}
+BENCHMARK_KERNEL_VARIANTS(BM_KernelAdd3WithGain);
+
+static void BM_KernelSumAbsPerChannel(benchmark::State& state,
+        mixxx::sampleutil::InstructionSet instructionSet) {
+    const auto* pKernels = kernelsForBenchmark(state, instructionSet);
+    if (!pKernels) {
+        return;
+    }
+    SINT size = static_cast<SINT>(state.range(0));
+    CSAMPLE* buffer = SampleUtil::alloc(size);
+    SampleUtil::fill(buffer, -0.5f, size);
+    CSAMPLE sumAbsL, sumAbsR, maxAbsL, maxAbsR;
+
+    while (state.KeepRunning()) {
+        pKernels->sumAbsPerChannel(
+                &sumAbsL, &sumAbsR, &maxAbsL, &maxAbsR, buffer, size / 2);
+        benchmark::DoNotOptimize(sumAbsL);
+        benchmark::DoNotOptimize(sumAbsR);
+    }
+
+    SampleUtil::free(buffer);
+}
+BENCHMARK_KERNEL_VARIANTS(BM_KernelSumAbsPerChannel);
+
+static void BM_KernelInterleaveBuffer(benchmark::State& state,
+        mixxx::sampleutil::InstructionSet instructionSet) {
+    const auto* pKernels = kernelsForBenchmark(state, instructionSet);
+    if (!pKernels) {
+        return;
+    }
+    SINT size = static_cast<SINT>(state.range(0));
+    CSAMPLE* buffer = SampleUtil::alloc(size);
+    SampleUtil::fill(buffer, 0.0f, size);
+    CSAMPLE* buffer2 = SampleUtil::alloc(size / 2);
+    SampleUtil::fill(buffer2, 0.5f, size / 2);
+    CSAMPLE* buffer3 = SampleUtil::alloc(size / 2);
+    SampleUtil::fill(buffer3, -0.5f, size / 2);
+
+    while (state.KeepRunning()) {
+        pKernels->interleaveBuffer(buffer, buffer2, buffer3, size / 2);
+    }
+
+    SampleUtil::free(buffer);
+    SampleUtil::free(buffer2);
+    SampleUtil::free(buffer3);
+}
+BENCHMARK_KERNEL_VARIANTS(BM_KernelInterleaveBuffer);
+
+static void BM_KernelCrossfade(benchmark::State& state,
+        mixxx::sampleutil::InstructionSet instructionSet) {
+    const auto* pKernels = kernelsForBenchmark(state, instructionSet);
+    if (!pKernels) {
+        return;
+    }
+    SINT size = static_cast<SINT>(state.range(0));
+    CSAMPLE* buffer = SampleUtil::alloc(size);
+    SampleUtil::fill(buffer, 0.0f, size);
+    CSAMPLE* buffer2 = SampleUtil::alloc(size);
+    SampleUtil::fill(buffer2, 0.5f, size);
+    CSAMPLE* buffer3 = SampleUtil::alloc(size);
+    SampleUtil::fill(buffer3, -0.5f, size);
+
+    while (state.KeepRunning()) {
+        pKernels->crossfade(buffer, buffer2, buffer3, 1.0f / size, 0, size);
+    }
+
+    SampleUtil::free(buffer);
+    SampleUtil::free(buffer2);
+    SampleUtil::free(buffer3);
+}
+BENCHMARK_KERNEL_VARIANTS(BM_KernelCrossfade);
+
 }  // namespace
@@ -1,6 +1,7 @@
 #include <gtest/gtest.h>
 
 #include <QDir>
+#include <QSqlQuery>
 #include <QtDebug>
 
 #include "library/searchquery.h"
@@ -103,6 +104,59 @@ TEST_F(SearchQueryParserTest, OneTermMultipleColumnsNegation) {
         qPrintable(pQuery->toSql()));
 }
 
+TEST_F(SearchQueryParserTest, FullTextSearch) {
+    SearchQueryParser::setFullTextSearchEnabled(true);
+    m_parser.setSearchColumns({"artist", "location"});
+    auto pQuery(
+            m_parser.parseQuery("bea", QString()));
+    auto pTitleQuery(
+            m_parser.parseQuery("title:\"yellow sub\"", QString()));
+    SearchQueryParser::setFullTextSearchEnabled(
+            SearchQueryParser::kFullTextSearchEnabledDefault);
+
+    TrackPointer pTrack(Track::newTemporary());
+    pTrack->setArtist("The Beatles");
+    EXPECT_TRUE(pQuery->match(pTrack));
+    pTrack->setArtist("Abeatles");
+    EXPECT_FALSE(pQuery->match(pTrack));
+
+    // Columns that are not indexed are still matched as substrings
+    EXPECT_STREQ(
+            qPrintable(QString("(id IN (SELECT rowid FROM library_fts WHERE "
+                               "library_fts MATCH '{artist} : \"bea\"*')) "
+                               "OR (location LIKE '%bea%')")),
+            qPrintable(pQuery->toSql()));
+
+    // The triggers keep the full-text index in sync with the library
+    const QString kTrackLocationTest(getTestDir().filePath(
+            QStringLiteral("id3-test-data/cover-test-jpg.mp3")));
+    const TrackId trackId = addTrackToCollection(kTrackLocationTest);
+    ASSERT_TRUE(trackId.isValid());
+    QSqlQuery query(dbConnection());
+    query.prepare(QStringLiteral(
+            "UPDATE library SET artist='The Beatles', "
+            "title='Yellow Submarine' WHERE id=:id"));
+    query.bindValue(":id", trackId.toVariant());
+    ASSERT_TRUE(query.exec());
+
+    const auto countMatches = [this](const QueryNode& node) {
+        QSqlQuery query(dbConnection());
+        EXPECT_TRUE(query.exec(
+                QStringLiteral("SELECT COUNT(*) FROM library WHERE ") +
+                node.toSql()));
+        EXPECT_TRUE(query.next());
+        return query.value(0).toInt();
+    };
+    EXPECT_EQ(1, countMatches(*pQuery));
+    EXPECT_EQ(1, countMatches(*pTitleQuery));
+
+    query.prepare(QStringLiteral("UPDATE library SET artist='Abeatles' WHERE id=:id"));
+    query.bindValue(":id", trackId.toVariant());
+    ASSERT_TRUE(query.exec());
+    EXPECT_EQ(0, countMatches(*pQuery));
+    EXPECT_EQ(1, countMatches(*pTitleQuery));
+}
+
 TEST_F(SearchQueryParserTest, MultipleTermsOneColumn) {
     m_parser.setSearchColumns({"artist"});
     auto pQuery(
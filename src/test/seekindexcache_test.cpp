@@ -0,0 +1,100 @@
+#include "sources/seekindexcache.h"
+
+#include <gtest/gtest.h>
+
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+
+#include "util/fileinfo.h"
+
+namespace {
+
+const QString kDecoder = QStringLiteral("test");
+
+class SeekIndexCacheTest : public testing::Test {
+  protected:
+    void SetUp() override {
+        mixxx::SeekIndexCache::setDirectory(m_cacheDir.path());
+    }
+
+    void TearDown() override {
+        mixxx::SeekIndexCache::setDirectory(QString());
+    }
+
+    QString writeFile(const QByteArray& content) {
+        const QString filePath = m_trackDir.filePath(QStringLiteral("track.mp3"));
+        QFile file(filePath);
+        EXPECT_TRUE(file.open(QIODevice::WriteOnly));
+        file.write(content);
+        return filePath;
+    }
+
+    static mixxx::SeekIndexCache::Index makeIndex() {
+        mixxx::SeekIndexCache::Index index;
+        index.channelCount = 2;
+        index.sampleRate = 44100;
+        index.bitrateKbps = 192;
+        for (int i = 0; i < 100; ++i) {
+            index.entries.push_back({i * 1152, 417 + i * 626});
+        }
+        index.frameCount = 100 * 1152;
+        return index;
+    }
+
+    QTemporaryDir m_cacheDir;
+    QTemporaryDir m_trackDir;
+};
+
+TEST_F(SeekIndexCacheTest, restoresStoredIndex) {
+    const mixxx::FileInfo fileInfo(writeFile(QByteArray(1024, 'x')));
+    const auto index = makeIndex();
+    ASSERT_TRUE(mixxx::SeekIndexCache::save(fileInfo, kDecoder, index));
+
+    mixxx::SeekIndexCache::Index restored;
+    ASSERT_TRUE(mixxx::SeekIndexCache::load(fileInfo, kDecoder, &restored));
+    EXPECT_EQ(index.channelCount, restored.channelCount);
+    EXPECT_EQ(index.sampleRate, restored.sampleRate);
+    EXPECT_EQ(index.bitrateKbps, restored.bitrateKbps);
+    EXPECT_EQ(index.frameCount, restored.frameCount);
+    ASSERT_EQ(index.entries.size(), restored.entries.size());
+    for (size_t i = 0; i < index.entries.size(); ++i) {
+        EXPECT_EQ(index.entries[i].frameIndex, restored.entries[i].frameIndex);
+        EXPECT_EQ(index.entries[i].byteOffset, restored.entries[i].byteOffset);
+    }
+}
+
+TEST_F(SeekIndexCacheTest, modifiedFileIsNotRestored) {
+    const QString filePath = writeFile(QByteArray(1024, 'x'));
+    ASSERT_TRUE(mixxx::SeekIndexCache::save(mixxx::FileInfo(filePath), kDecoder, makeIndex()));
+
+    QFile file(filePath);
+    ASSERT_TRUE(file.open(QIODevice::ReadWrite));
+    ASSERT_TRUE(file.setFileTime(
+            QDateTime::currentDateTime().addSecs(60),
+            QFileDevice::FileModificationTime));
+    file.close();
+
+    mixxx::SeekIndexCache::Index restored;
+    EXPECT_FALSE(mixxx::SeekIndexCache::load(mixxx::FileInfo(filePath), kDecoder, &restored));
+}
+
+TEST_F(SeekIndexCacheTest, decodersAreSeparated) {
+    const mixxx::FileInfo fileInfo(writeFile(QByteArray(1024, 'x')));
+    ASSERT_TRUE(mixxx::SeekIndexCache::save(fileInfo, kDecoder, makeIndex()));
+
+    mixxx::SeekIndexCache::Index restored;
+    EXPECT_FALSE(mixxx::SeekIndexCache::load(
+            fileInfo, QStringLiteral("other"), &restored));
+}
+
+TEST_F(SeekIndexCacheTest, disabledWithoutDirectory) {
+    mixxx::SeekIndexCache::setDirectory(QString());
+    const mixxx::FileInfo fileInfo(writeFile(QByteArray(1024, 'x')));
+    EXPECT_FALSE(mixxx::SeekIndexCache::save(fileInfo, kDecoder, makeIndex()));
+    mixxx::SeekIndexCache::Index restored;
+    EXPECT_FALSE(mixxx::SeekIndexCache::load(fileInfo, kDecoder, &restored));
+}
+
+} // namespace
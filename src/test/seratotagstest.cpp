@@ -341,3 +341,42 @@ TEST_F(SeratoTagsTest, Markers2RoundTrip) {
         }
     }
 }
+
+TEST_F(SeratoTagsTest, ReparseUnchangedMarkers2) {
+    const auto filetype = mixxx::taglib::FileType::MP3;
+    QDir dir(MixxxTest::getOrInitTestDir().filePath(QStringLiteral("serato/data/mp3/markers2/")));
+    dir.setFilter(QDir::Files);
+    dir.setNameFilters(QStringList() << "*.octet-stream");
+    const QFileInfoList fileList = dir.entryInfoList();
+    for (const QFileInfo& fileInfo : fileList) {
+        auto file = QFile(fileInfo.filePath());
+        ASSERT_TRUE(file.open(QIODevice::ReadOnly));
+        const QByteArray inputData = file.readAll();
+
+        mixxx::SeratoTags modifiedTags;
+        ASSERT_TRUE(modifiedTags.parseMarkers2(inputData, filetype));
+        const auto cueInfos = modifiedTags.getCueInfos();
+        const bool bpmLocked = modifiedTags.isBpmLocked();
+        // Modifying the tags must not affect the tags that are parsed from
+        // the same data later
+        modifiedTags.setBpmLocked(!bpmLocked);
+        modifiedTags.setTrackColor(mixxx::RgbColor(0x123456));
+        modifiedTags.setCueInfos({});
+
+        mixxx::SeratoTags seratoTags;
+        ASSERT_TRUE(seratoTags.parseMarkers2(inputData, filetype));
+        EXPECT_EQ(bpmLocked, seratoTags.isBpmLocked());
+        EXPECT_EQ(cueInfos, seratoTags.getCueInfos());
+        EXPECT_EQ(inputData, seratoTags.dumpMarkers2(filetype));
+    }
+}
+
+TEST_F(SeratoTagsTest, ReparseInvalidMarkers2) {
+    const auto filetype = mixxx::taglib::FileType::MP3;
+    const QByteArray invalidData("\x01\x01invalid", 9);
+    for (int i = 0; i < 2; ++i) {
+        mixxx::SeratoTags seratoTags;
+        EXPECT_FALSE(seratoTags.parseMarkers2(invalidData, filetype));
+        EXPECT_EQ(mixxx::SeratoTags::ParserStatus::Failed, seratoTags.status());
+    }
+}
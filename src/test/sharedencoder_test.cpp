@@ -0,0 +1,112 @@
+#ifdef __BROADCAST__
+
+#include "engine/sidechain/sharedencoder.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "recording/defs_recording.h"
+#include "test/mixxxtest.h"
+
+namespace {
+
+constexpr mixxx::audio::SampleRate kSampleRate(44100);
+
+class SharedEncoderTest : public MixxxTest {
+  protected:
+    BroadcastProfilePtr createProfile(const QString& format, int bitrate) {
+        BroadcastProfilePtr pProfile(new BroadcastProfile(
+                QStringLiteral("%1 %2").arg(format, QString::number(bitrate))));
+        pProfile->setFormat(format);
+        pProfile->setBitrate(bitrate);
+        pProfile->setChannels(2);
+        return pProfile;
+    }
+
+    SharedEncoderPool m_pool;
+};
+
+TEST_F(SharedEncoderTest, SameSettingsShareEncoder) {
+    auto pEncoder1 = m_pool.acquire(createProfile(ENCODING_MP3, 320), kSampleRate, nullptr);
+    auto pEncoder2 = m_pool.acquire(createProfile(ENCODING_MP3, 320), kSampleRate, nullptr);
+    auto pEncoder3 = m_pool.acquire(createProfile(ENCODING_MP3, 128), kSampleRate, nullptr);
+    ASSERT_TRUE(pEncoder1);
+    ASSERT_TRUE(pEncoder3);
+    EXPECT_EQ(pEncoder1, pEncoder2);
+    EXPECT_NE(pEncoder1, pEncoder3);
+
+    // A new encoder is created after all connections have released it
+    pEncoder3.reset();
+    auto pEncoder4 = m_pool.acquire(createProfile(ENCODING_MP3, 128), kSampleRate, nullptr);
+    ASSERT_TRUE(pEncoder4);
+    EXPECT_EQ(1, pEncoder4.use_count());
+}
+
+TEST_F(SharedEncoderTest, OggIsNotShared) {
+    EXPECT_TRUE(SharedEncoderPool::isShareable(ENCODING_MP3));
+    EXPECT_TRUE(SharedEncoderPool::isShareable(ENCODING_HEAAC));
+    EXPECT_FALSE(SharedEncoderPool::isShareable(ENCODING_OGG));
+    EXPECT_FALSE(SharedEncoderPool::isShareable(ENCODING_OPUS));
+}
+
+TEST_F(SharedEncoderTest, EncodedDataFansOut) {
+    auto pEncoder = m_pool.acquire(createProfile(ENCODING_MP3, 128), kSampleRate, nullptr);
+    ASSERT_TRUE(pEncoder);
+    auto pOutput1 = pEncoder->addOutput();
+    auto pOutput2 = pEncoder->addOutput();
+    EXPECT_EQ(2, pEncoder->outputCount());
+
+    // Two seconds of a stereo ramp
+    std::vector<CSAMPLE> samples(2 * 2 * kSampleRate.value());
+    for (std::size_t i = 0; i < samples.size(); ++i) {
+        samples[i] = static_cast<CSAMPLE>(i % 200) / 100.0f - 1.0f;
+    }
+
+    // Only the first output encodes, the samples pushed by the others have
+    // already been encoded.
+    bool overflow = true;
+    pEncoder->encodeBuffer(pOutput2.get(), samples.data(), static_cast<int>(samples.size()));
+    EXPECT_TRUE(pOutput2->takePending(&overflow).isEmpty());
+    EXPECT_FALSE(overflow);
+
+    pEncoder->encodeBuffer(pOutput1.get(), samples.data(), static_cast<int>(samples.size()));
+    const QByteArray encoded1 = pOutput1->takePending(&overflow);
+    const QByteArray encoded2 = pOutput2->takePending(&overflow);
+    EXPECT_FALSE(encoded1.isEmpty());
+    EXPECT_EQ(encoded1, encoded2);
+    EXPECT_TRUE(pOutput1->takePending(&overflow).isEmpty());
+
+    // The next output takes over when the encoding output is removed
+    pEncoder->removeOutput(pOutput1);
+    EXPECT_EQ(1, pEncoder->outputCount());
+    pEncoder->encodeBuffer(pOutput2.get(), samples.data(), static_cast<int>(samples.size()));
+    EXPECT_FALSE(pOutput2->takePending(&overflow).isEmpty());
+    EXPECT_TRUE(pOutput1->takePending(&overflow).isEmpty());
+}
+
+TEST_F(SharedEncoderTest, PendingDataIsBounded) {
+    auto pEncoder = m_pool.acquire(createProfile(ENCODING_MP3, 320), kSampleRate, nullptr);
+    ASSERT_TRUE(pEncoder);
+    auto pOutput = pEncoder->addOutput();
+    EXPECT_FALSE(pOutput->waitForPending(0));
+
+    // One minute of audio at 320 kbit/s exceeds the queue of a stalled
+    // connection
+    std::vector<CSAMPLE> samples(2 * kSampleRate.value(), 0.5f);
+    for (int i = 0; i < 60; ++i) {
+        pEncoder->encodeBuffer(pOutput.get(), samples.data(), static_cast<int>(samples.size()));
+    }
+    EXPECT_TRUE(pOutput->waitForPending(0));
+    EXPECT_LE(pOutput->pendingBytes(), SharedEncoder::kMaxPendingBytes);
+
+    bool overflow = false;
+    EXPECT_FALSE(pOutput->takePending(&overflow).isEmpty());
+    EXPECT_TRUE(overflow);
+    EXPECT_EQ(0, pOutput->pendingBytes());
+    EXPECT_FALSE(pOutput->waitForPending(0));
+}
+
+} // namespace
+
+#endif // __BROADCAST__
@@ -149,12 +149,12 @@ class BaseSignalPathTest : public MixxxTest, SoundSourceProviderRegistration {
         m_pNumDecks->set(m_pNumDecks->get() + 1);
     }
 
-    void loadTrack(Deck* pDeck, TrackPointer pTrack) {
-        EngineDeck* pEngineDeck = pDeck->getEngineDeck();
+    void loadTrack(BaseTrackPlayerImpl* pPlayer, TrackPointer pTrack) {
+        EngineDeck* pEngineDeck = pPlayer->getEngineDeck();
         if (pEngineDeck->getEngineBuffer()->isTrackLoaded()) {
             pEngineDeck->getEngineBuffer()->ejectTrack();
         }
-        pDeck->slotLoadTrack(pTrack, false);
+        pPlayer->slotLoadTrack(pTrack, false);
 
         // Wait for the track to load.
         ProcessBuffer();
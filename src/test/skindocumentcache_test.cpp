@@ -0,0 +1,77 @@
+#include "skin/legacy/skindocumentcache.h"
+
+#include <gtest/gtest.h>
+
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+
+namespace {
+
+class SkinDocumentCacheTest : public testing::Test {
+  protected:
+    QString writeFile(const QString& fileName, const QByteArray& content) {
+        const QString filePath = m_skinDir.filePath(fileName);
+        QFile file(filePath);
+        EXPECT_TRUE(file.open(QIODevice::WriteOnly));
+        file.write(content);
+        return filePath;
+    }
+
+    QTemporaryDir m_skinDir;
+};
+
+TEST_F(SkinDocumentCacheTest, reusesUnchangedDocument) {
+    const QByteArray content("<Template><WidgetGroup/></Template>");
+    const QString filePath = writeFile(QStringLiteral("template.xml"), content);
+
+    const QDomDocument first = SkinDocumentCache::parse(filePath, content);
+    ASSERT_FALSE(first.isNull());
+    const QDomDocument second = SkinDocumentCache::parse(filePath, content);
+    EXPECT_TRUE(first == second);
+}
+
+TEST_F(SkinDocumentCacheTest, changedContentIsParsedAgain) {
+    const QByteArray content("<Template><WidgetGroup/></Template>");
+    const QString filePath = writeFile(QStringLiteral("template.xml"), content);
+    const QDomDocument first = SkinDocumentCache::parse(filePath, content);
+
+    const QByteArray changedContent("<Template><WidgetStack/></Template>");
+    writeFile(QStringLiteral("template.xml"), changedContent);
+    const QDomDocument second = SkinDocumentCache::parse(filePath, changedContent);
+    EXPECT_FALSE(first == second);
+    EXPECT_EQ(QStringLiteral("WidgetStack"),
+            second.documentElement().firstChildElement().tagName());
+}
+
+TEST_F(SkinDocumentCacheTest, invalidContentReportsError) {
+    const QByteArray content("<Template><WidgetGroup></Template>");
+    const QString filePath = writeFile(QStringLiteral("template.xml"), content);
+
+    QString errorMessage;
+    int errorLine = 0;
+    int errorColumn = 0;
+    EXPECT_TRUE(SkinDocumentCache::parse(
+            filePath, content, &errorMessage, &errorLine, &errorColumn)
+                        .isNull());
+    EXPECT_FALSE(errorMessage.isEmpty());
+    EXPECT_EQ(1, errorLine);
+}
+
+TEST_F(SkinDocumentCacheTest, prefetchFollowsTemplates) {
+    const QByteArray skinContent(
+            "<skin><Template src=\"skin:deck.xml\"/></skin>");
+    const QString skinFilePath = writeFile(QStringLiteral("skin.xml"), skinContent);
+    const QByteArray deckContent("<Template><WidgetGroup/></Template>");
+    const QString deckFilePath = writeFile(QStringLiteral("deck.xml"), deckContent);
+
+    SkinDocumentCache::prefetch(m_skinDir.path(), m_skinDir.path());
+    const QDomDocument skin = SkinDocumentCache::parse(skinFilePath, skinContent);
+    const QDomDocument deck = SkinDocumentCache::parse(deckFilePath, deckContent);
+    ASSERT_FALSE(deck.isNull());
+    // The prefetched documents are shared by all later calls
+    EXPECT_TRUE(skin == SkinDocumentCache::parse(skinFilePath, skinContent));
+    EXPECT_TRUE(deck == SkinDocumentCache::parse(deckFilePath, deckContent));
+}
+
+} // namespace
@@ -64,6 +64,20 @@ TEST_F(SoftTakeoverTest, DoesntIgnoreSameValue) {
     EXPECT_FALSE(st_control.ignore(co.get(), co->getParameterForValue(0.6)));
 }
 
+TEST_F(SoftTakeoverTest, EnableAndIgnore) {
+    // Range -1.0 to 1.0
+    auto co = std::make_unique<ControlPotmeter>(ConfigKey("[Channel1]", "test_pot"), -1.0, 1.0);
+    auto button = std::make_unique<ControlPushButton>(ConfigKey("[Channel1]", "test_button"));
+
+    co->set(0.6);
+    SoftTakeoverCtrl st_control;
+    // First is always ignored.
+    EXPECT_TRUE(st_control.enableAndIgnore(co.get(), co->getParameterForValue(0.6)));
+    EXPECT_FALSE(st_control.enableAndIgnore(co.get(), co->getParameterForValue(0.6)));
+    EXPECT_FALSE(st_control.enableAndIgnore(button.get(), 0));
+    EXPECT_FALSE(st_control.ignore(button.get(), 0));
+}
+
 // These are corner cases that allow for quickly flicking/whipping controls
 //  from a standstill when the previous knob value matches the current CO value
 TEST_F(SoftTakeoverTest, SuperFastPrevEqCurrent) {
@@ -0,0 +1,197 @@
+#include "sources/soundsourcepcm.h"
+
+#include <gtest/gtest.h>
+
+#include <QFile>
+#include <QTemporaryDir>
+#include <QUrl>
+#include <QtEndian>
+#include <cstring>
+
+#include "util/samplebuffer.h"
+
+namespace {
+
+constexpr int kChannelCount = 2;
+constexpr int kFrameCount = 100;
+constexpr int kSampleRate = 44100;
+
+template<typename T>
+void appendLittleEndian(QByteArray* pBytes, T value) {
+    char bytes[sizeof(T)];
+    qToLittleEndian(value, bytes);
+    pBytes->append(bytes, sizeof(T));
+}
+
+template<typename T>
+void appendBigEndian(QByteArray* pBytes, T value) {
+    char bytes[sizeof(T)];
+    qToBigEndian(value, bytes);
+    pBytes->append(bytes, sizeof(T));
+}
+
+qint16 int16Sample(int index) {
+    return static_cast<qint16>((index * 331) % 65536 - 32768);
+}
+
+QByteArray wavFile(quint16 formatTag, quint16 bitsPerSample, const QByteArray& data) {
+    const quint16 blockAlign = kChannelCount * bitsPerSample / 8;
+    QByteArray bytes("RIFF");
+    appendLittleEndian<quint32>(&bytes, 4 + 8 + 16 + 8 + data.size());
+    bytes.append("WAVE");
+    // An unknown chunk that must be skipped
+    bytes.append("LIST");
+    appendLittleEndian<quint32>(&bytes, 3);
+    bytes.append("abc\0", 4);
+    bytes.append("fmt ");
+    appendLittleEndian<quint32>(&bytes, 16);
+    appendLittleEndian<quint16>(&bytes, formatTag);
+    appendLittleEndian<quint16>(&bytes, kChannelCount);
+    appendLittleEndian<quint32>(&bytes, kSampleRate);
+    appendLittleEndian<quint32>(&bytes, kSampleRate * blockAlign);
+    appendLittleEndian<quint16>(&bytes, blockAlign);
+    appendLittleEndian<quint16>(&bytes, bitsPerSample);
+    bytes.append("data");
+    appendLittleEndian<quint32>(&bytes, data.size());
+    bytes.append(data);
+    return bytes;
+}
+
+QByteArray aiffFile(const QByteArray& data) {
+    QByteArray bytes("FORM");
+    appendBigEndian<quint32>(&bytes, 4 + 8 + 18 + 8 + 8 + data.size());
+    bytes.append("AIFF");
+    bytes.append("COMM");
+    appendBigEndian<quint32>(&bytes, 18);
+    appendBigEndian<quint16>(&bytes, kChannelCount);
+    appendBigEndian<quint32>(&bytes, kFrameCount);
+    appendBigEndian<quint16>(&bytes, 16);
+    // 44100 as 80-bit extended float
+    const char sampleRate[] = {0x40, 0x0E, static_cast<char>(0xAC), 0x44, 0, 0, 0, 0, 0, 0};
+    bytes.append(sampleRate, sizeof(sampleRate));
+    bytes.append("SSND");
+    appendBigEndian<quint32>(&bytes, 8 + data.size());
+    appendBigEndian<quint32>(&bytes, 0);
+    appendBigEndian<quint32>(&bytes, 0);
+    bytes.append(data);
+    return bytes;
+}
+
+class SoundSourcePcmTest : public testing::Test {
+  protected:
+    mixxx::SoundSourcePointer openFile(const QString& fileName, const QByteArray& bytes) {
+        const QString filePath = m_tempDir.filePath(fileName);
+        QFile file(filePath);
+        EXPECT_TRUE(file.open(QIODevice::WriteOnly));
+        file.write(bytes);
+        file.close();
+        auto pSoundSource = std::make_shared<mixxx::SoundSourcePcm>(
+                QUrl::fromLocalFile(filePath));
+        if (pSoundSource->open(mixxx::AudioSource::OpenMode::Strict) !=
+                mixxx::AudioSource::OpenResult::Succeeded) {
+            return nullptr;
+        }
+        return pSoundSource;
+    }
+
+    // Reads the frames starting at an arbitrary position
+    static mixxx::SampleBuffer readFrames(
+            const mixxx::SoundSourcePointer& pSoundSource,
+            SINT firstFrame,
+            SINT frameCount) {
+        mixxx::SampleBuffer samples(frameCount * kChannelCount);
+        const auto range = mixxx::IndexRange::forward(firstFrame, frameCount);
+        const auto readable = pSoundSource->readSampleFrames(
+                mixxx::WritableSampleFrames(
+                        range,
+                        mixxx::SampleBuffer::WritableSlice(samples)));
+        EXPECT_EQ(range, readable.frameIndexRange());
+        return samples;
+    }
+
+    const QTemporaryDir m_tempDir;
+};
+
+TEST_F(SoundSourcePcmTest, WavInt16) {
+    QByteArray data;
+    for (int i = 0; i < kFrameCount * kChannelCount; ++i) {
+        appendLittleEndian<qint16>(&data, int16Sample(i));
+    }
+    const auto pSoundSource = openFile(QStringLiteral("int16.wav"),
+            wavFile(1, 16, data));
+    ASSERT_TRUE(pSoundSource);
+    EXPECT_EQ(mixxx::audio::ChannelCount(kChannelCount),
+            pSoundSource->getSignalInfo().getChannelCount());
+    EXPECT_EQ(mixxx::audio::SampleRate(kSampleRate),
+            pSoundSource->getSignalInfo().getSampleRate());
+    EXPECT_EQ(mixxx::IndexRange::forward(0, kFrameCount),
+            pSoundSource->frameIndexRange());
+
+    const auto samples = readFrames(pSoundSource, 37, 20);
+    for (int i = 0; i < samples.size(); ++i) {
+        EXPECT_EQ(int16Sample(37 * kChannelCount + i) / 32768.0f, samples[i]);
+    }
+}
+
+TEST_F(SoundSourcePcmTest, WavInt24) {
+    QByteArray data;
+    for (int i = 0; i < kFrameCount * kChannelCount; ++i) {
+        const qint32 value = int16Sample(i) * 256 + (i & 0xFF);
+        data.append(static_cast<char>(value & 0xFF));
+        data.append(static_cast<char>((value >> 8) & 0xFF));
+        data.append(static_cast<char>((value >> 16) & 0xFF));
+    }
+    const auto pSoundSource = openFile(QStringLiteral("int24.wav"),
+            wavFile(1, 24, data));
+    ASSERT_TRUE(pSoundSource);
+
+    const auto samples = readFrames(pSoundSource, 0, kFrameCount);
+    for (int i = 0; i < samples.size(); ++i) {
+        const qint32 value = int16Sample(i) * 256 + (i & 0xFF);
+        EXPECT_EQ(value / 8388608.0f, samples[i]);
+    }
+}
+
+TEST_F(SoundSourcePcmTest, WavFloat32) {
+    QByteArray data;
+    for (int i = 0; i < kFrameCount * kChannelCount; ++i) {
+        const float value = int16Sample(i) / 40000.0f;
+        quint32 bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        appendLittleEndian<quint32>(&data, bits);
+    }
+    const auto pSoundSource = openFile(QStringLiteral("float.wav"),
+            wavFile(3, 32, data));
+    ASSERT_TRUE(pSoundSource);
+
+    const auto samples = readFrames(pSoundSource, 99, 1);
+    EXPECT_EQ(int16Sample(198) / 40000.0f, samples[0]);
+    EXPECT_EQ(int16Sample(199) / 40000.0f, samples[1]);
+}
+
+TEST_F(SoundSourcePcmTest, AiffInt16) {
+    QByteArray data;
+    for (int i = 0; i < kFrameCount * kChannelCount; ++i) {
+        appendBigEndian<qint16>(&data, int16Sample(i));
+    }
+    const auto pSoundSource = openFile(QStringLiteral("int16.aiff"), aiffFile(data));
+    ASSERT_TRUE(pSoundSource);
+    EXPECT_EQ(mixxx::audio::SampleRate(kSampleRate),
+            pSoundSource->getSignalInfo().getSampleRate());
+    EXPECT_EQ(mixxx::IndexRange::forward(0, kFrameCount),
+            pSoundSource->frameIndexRange());
+
+    const auto samples = readFrames(pSoundSource, 50, 50);
+    for (int i = 0; i < samples.size(); ++i) {
+        EXPECT_EQ(int16Sample(50 * kChannelCount + i) / 32768.0f, samples[i]);
+    }
+}
+
+TEST_F(SoundSourcePcmTest, RejectCompressedWav) {
+    // IMA ADPCM is left to the decoders
+    const auto pSoundSource = openFile(QStringLiteral("adpcm.wav"),
+            wavFile(0x11, 4, QByteArray(kFrameCount, '\0')));
+    EXPECT_FALSE(pSoundSource);
+}
+
+} // namespace
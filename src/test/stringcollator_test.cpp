@@ -0,0 +1,50 @@
+#include <gtest/gtest.h>
+
+#include "util/string.h"
+
+namespace {
+
+int sign(int value) {
+    return (value > 0) - (value < 0);
+}
+
+TEST(StringCollatorTest, sortKeysMatchCollator) {
+    const QLocale locale(QLocale::English);
+    const mixxx::StringCollator collator(locale);
+    QCollator reference(locale);
+    reference.setCaseSensitivity(Qt::CaseInsensitive);
+
+    const QStringList strings = {
+            QString(),
+            QStringLiteral("abba"),
+            QStringLiteral("ABBA"),
+            QStringLiteral("Ärzte"),
+            QStringLiteral("Zappa"),
+            QStringLiteral("zz top"),
+            QStringLiteral("10cc"),
+    };
+    // Compare each string twice to use the cached sort keys
+    for (int pass = 0; pass < 2; ++pass) {
+        for (const auto& s1 : strings) {
+            for (const auto& s2 : strings) {
+                EXPECT_EQ(sign(reference.compare(s1, s2)), sign(collator.compare(s1, s2)))
+                        << s1.toStdString() << " <> " << s2.toStdString();
+            }
+        }
+    }
+}
+
+TEST(StringCollatorTest, rawDataIsNotReferenced) {
+    const mixxx::StringCollator collator;
+    QString buffer = QStringLiteral("abc");
+    {
+        const QString rawString = QString::fromRawData(buffer.constData(), buffer.size());
+        EXPECT_GT(0, collator.compare(rawString, QStringLiteral("abd")));
+    }
+    // Overwrite the buffer that was wrapped by the raw string
+    buffer.replace(0, 3, QStringLiteral("xyz"));
+    EXPECT_GT(0, collator.compare(QStringLiteral("abc"), QStringLiteral("abd")));
+    EXPECT_LT(0, collator.compare(QStringLiteral("xyz"), QStringLiteral("abd")));
+}
+
+} // namespace
@@ -56,3 +56,31 @@ TEST_F(TrackDAOTest, detectMovedTracks) {
     QSet<QString> trackLocations = trackDAO.getAllTrackLocations();
     EXPECT_THAT(trackLocations, UnorderedElementsAre(newFile.location(), otherFile.location()));
 }
+
+TEST_F(TrackDAOTest, getTracksByIds) {
+    QList<TrackId> trackIds;
+    for (int i = 0; i < 3; ++i) {
+        TrackPointer pTrack = Track::newTemporary(mixxx::FileAccess(mixxx::FileInfo(
+                QDir(QDir::tempPath()), QStringLiteral("file%1.mp3").arg(i))));
+        if (i == 1) {
+            pTrack->createAndAddCue(mixxx::CueType::HotCue,
+                    2,
+                    mixxx::audio::FramePos(1000),
+                    mixxx::audio::kInvalidFramePos);
+        }
+        trackIds.append(internalCollection()->addTrack(pTrack, false));
+    }
+
+    const QList<TrackPointer> tracks = trackCollectionManager()->getTracksByIds(
+            {trackIds[2], TrackId(), trackIds[0], trackIds[1]});
+    ASSERT_EQ(3, tracks.size());
+    EXPECT_EQ(trackIds[2], tracks[0]->getId());
+    EXPECT_EQ(trackIds[0], tracks[1]->getId());
+    EXPECT_EQ(trackIds[1], tracks[2]->getId());
+    EXPECT_TRUE(tracks[1]->getCuePoints().isEmpty());
+    ASSERT_EQ(1, tracks[2]->getCuePoints().size());
+    EXPECT_EQ(2, tracks[2]->getCuePoints().first()->getHotCue());
+
+    // The loaded tracks are cached
+    EXPECT_EQ(tracks[0], trackCollectionManager()->getTrackById(trackIds[2]));
+}
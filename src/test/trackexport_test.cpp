@@ -67,6 +67,64 @@ TEST_F(TrackExporterTest, SimpleListExport) {
     EXPECT_TRUE(QFileInfo::exists(m_exportDir.filePath("cover-test-itunes-12.3.0-aac.m4a")));
 }
 
+TEST_F(TrackExporterTest, SingleLaneExport) {
+    mixxx::FileInfo fileinfo1(m_testDataDir.filePath("cover-test.ogg"));
+    TrackPointer track1(Track::newTemporary(mixxx::FileAccess(fileinfo1)));
+    mixxx::FileInfo fileinfo2(m_testDataDir.filePath("cover-test.flac"));
+    TrackPointer track2(Track::newTemporary(mixxx::FileAccess(fileinfo2)));
+
+    TrackPointerList tracks;
+    tracks.append(track1);
+    tracks.append(track2);
+    TrackExportWorker worker(m_exportDir.canonicalPath(), tracks, 1);
+    m_answerer.reset(new FakeOverwriteAnswerer(&worker));
+
+    worker.run();
+    EXPECT_TRUE(worker.wait(10000));
+
+    EXPECT_EQ(2, m_answerer->currentProgress());
+    EXPECT_EQ(2, m_answerer->currentProgressCount());
+    EXPECT_EQ(fileinfo1.sizeInBytes(),
+            QFileInfo(m_exportDir.filePath("cover-test.ogg")).size());
+    EXPECT_EQ(fileinfo2.sizeInBytes(),
+            QFileInfo(m_exportDir.filePath("cover-test.flac")).size());
+    // The manifest is removed when the export is complete
+    EXPECT_FALSE(QFileInfo::exists(
+            m_exportDir.filePath(TrackExportWorker::kManifestFileName)));
+}
+
+TEST_F(TrackExporterTest, ResumeFromManifest) {
+    // An interrupted export has copied the .ogg file
+    mixxx::FileInfo fileinfo1(m_testDataDir.filePath("cover-test.ogg"));
+    TrackPointer track1(Track::newTemporary(mixxx::FileAccess(fileinfo1)));
+    mixxx::FileInfo fileinfo2(m_testDataDir.filePath("cover-test.flac"));
+    TrackPointer track2(Track::newTemporary(mixxx::FileAccess(fileinfo2)));
+    ASSERT_TRUE(QFile::copy(fileinfo1.location(), m_exportDir.filePath("cover-test.ogg")));
+    QFile manifest(m_exportDir.filePath(TrackExportWorker::kManifestFileName));
+    ASSERT_TRUE(manifest.open(QIODevice::WriteOnly | QIODevice::Text));
+    manifest.write(QStringLiteral("cover-test.ogg\t%1\t%2\n")
+                           .arg(QString::number(fileinfo1.sizeInBytes()),
+                                   QString::number(fileinfo1.lastModified()
+                                                           .toMSecsSinceEpoch()))
+                           .toUtf8());
+    manifest.close();
+
+    // No overwrite question is expected for the .ogg file
+    TrackPointerList tracks;
+    tracks.append(track1);
+    tracks.append(track2);
+    TrackExportWorker worker(m_exportDir.canonicalPath(), tracks);
+    m_answerer.reset(new FakeOverwriteAnswerer(&worker));
+
+    worker.run();
+    EXPECT_TRUE(worker.wait(10000));
+
+    EXPECT_EQ(2, m_answerer->currentProgress());
+    EXPECT_EQ(2, m_answerer->currentProgressCount());
+    EXPECT_TRUE(QFileInfo::exists(m_exportDir.filePath("cover-test.flac")));
+    EXPECT_FALSE(manifest.exists());
+}
+
 TEST_F(TrackExporterTest, OverwriteSkip) {
     // Export a tracklist with two existing tracks -- overwrite one and skip
     // the other.
@@ -0,0 +1,87 @@
+#include <gtest/gtest.h>
+
+#include <QFile>
+#include <QFileInfo>
+#include <QTemporaryDir>
+
+#include "library/library_prefs.h"
+#include "library/trackmetadatawritebackqueue.h"
+#include "sources/soundsourceproxy.h"
+#include "test/librarytest.h"
+#include "track/track.h"
+#include "util/fileinfo.h"
+
+namespace {
+
+const QString kTestFile = QStringLiteral("id3-test-data/cover-test-jpg.mp3");
+
+} // namespace
+
+class TrackMetadataWriteBackQueueTest : public LibraryTest {
+  protected:
+    TrackMetadataWriteBackQueueTest()
+            : m_fileInfo(m_tempDir.filePath(QStringLiteral("track.mp3"))),
+              m_journalFilePath(m_tempDir.filePath(QStringLiteral("journal"))) {
+        mixxxtest::copyFile(getTestDir().filePath(kTestFile), m_fileInfo.location());
+        m_pConfig->setValue(mixxx::library::prefs::kSyncTrackMetadataConfigKey, true);
+    }
+
+    const QTemporaryDir m_tempDir;
+    const mixxx::FileInfo m_fileInfo;
+    const QString m_journalFilePath;
+};
+
+TEST_F(TrackMetadataWriteBackQueueTest, WriteEvictedTrack) {
+    trackCollectionManager()->enableMetadataWriteBack(
+            m_journalFilePath, [] { return false; });
+
+    auto pTrack = getOrAddTrackByLocation(m_fileInfo.location());
+    ASSERT_NE(nullptr, pTrack);
+    const TrackId trackId = pTrack->getId();
+    const QString newTitle = pTrack->getTitle() + QStringLiteral("modified");
+    pTrack->setTitle(newTitle);
+    // Evicts the track and enqueues the metadata
+    pTrack.reset();
+
+    pTrack = trackCollectionManager()->getTrackById(trackId);
+    ASSERT_NE(nullptr, pTrack);
+    EXPECT_EQ(newTitle, pTrack->getTitle());
+
+    // Opening the file waits until the metadata has been written
+    mixxx::TrackMetadata importedTrackMetadata;
+    const auto importResult =
+            SoundSourceProxy(pTrack).importTrackMetadataAndCoverImage(
+                    &importedTrackMetadata, nullptr, false);
+    EXPECT_EQ(mixxx::MetadataSource::ImportResult::Succeeded, importResult.first);
+    EXPECT_EQ(newTitle, importedTrackMetadata.getTrackInfo().getTitle());
+}
+
+TEST_F(TrackMetadataWriteBackQueueTest, RecoverJournal) {
+    QFile journal(m_journalFilePath);
+    ASSERT_TRUE(journal.open(QIODevice::WriteOnly));
+    journal.write("42 /music/a.mp3\n7 /music/b.mp3\n42 /music/a.mp3\n7 /music/b");
+    journal.close();
+
+    TrackMetadataWriteBackQueue queue(
+            dbConnectionPooler(), m_journalFilePath, [] { return false; });
+    const QList<TrackId> expectedTrackIds = {
+            TrackId(QVariant(42)),
+            TrackId(QVariant(7)),
+    };
+    EXPECT_EQ(expectedTrackIds, queue.takeRecoveredTrackIds());
+    EXPECT_TRUE(queue.takeRecoveredTrackIds().isEmpty());
+    EXPECT_EQ(0, queue.pendingCount());
+}
+
+TEST_F(TrackMetadataWriteBackQueueTest, ClearJournalWhenDrained) {
+    const mixxx::TrackMetadata trackMetadata;
+    {
+        TrackMetadataWriteBackQueue queue(
+                dbConnectionPooler(), m_journalFilePath, [] { return false; });
+        queue.enqueue(TrackId(QVariant(1)), m_fileInfo, trackMetadata);
+        queue.enqueue(TrackId(QVariant(1)), m_fileInfo, trackMetadata);
+        TrackMetadataWriteBackQueue::waitForFile(m_fileInfo.location());
+        EXPECT_EQ(0, queue.pendingCount());
+        EXPECT_EQ(0, QFileInfo(m_journalFilePath).size());
+    }
+}
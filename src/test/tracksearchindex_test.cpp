@@ -0,0 +1,116 @@
+#include "library/tracksearchindex.h"
+
+#include <gtest/gtest.h>
+
+#include "library/dao/trackschema.h"
+#include "library/searchquery.h"
+#include "library/searchqueryparser.h"
+#include "proto/keys.pb.h"
+#include "test/librarytest.h"
+
+namespace {
+
+const QStringList kColumns = {
+        LIBRARYTABLE_ID,
+        LIBRARYTABLE_ARTIST,
+        LIBRARYTABLE_TITLE,
+        LIBRARYTABLE_BPM,
+        LIBRARYTABLE_KEY_ID,
+        LIBRARYTABLE_YEAR,
+};
+
+class TrackSearchIndexTest : public LibraryTest {
+  protected:
+    TrackSearchIndexTest()
+            : m_parser(internalCollection(), {LIBRARYTABLE_ARTIST, LIBRARYTABLE_TITLE}),
+              m_index(kColumns) {
+        addTrack(1, "Björk", "Army of Me", 120.0, mixxx::track::io::key::A_MINOR);
+        addTrack(2, QVariant(), "Hello World !", 128.5, QVariant());
+        addTrack(3, "Various", "100% Pure", QVariant(), mixxx::track::io::key::C_MAJOR);
+    }
+
+    void addTrack(int id,
+            const QVariant& artist,
+            const QVariant& title,
+            const QVariant& bpm,
+            const QVariant& keyId) {
+        m_index.updateTrack(TrackId(id),
+                {id,
+                        artist.isNull() ? QVariant() : QVariant(artist.toString()),
+                        title,
+                        bpm,
+                        keyId.isNull() ? QVariant() : QVariant(keyId.toInt()),
+                        QStringLiteral("1995")});
+    }
+
+    // Returns the ids of all tracks that match or an empty string
+    // if the query could not be evaluated
+    QString search(const QString& query) const {
+        const auto pQuery = m_parser.parseQuery(query, QString());
+        TrackSearchIndex::Matches matches;
+        if (!pQuery->evaluate(m_index, &matches)) {
+            return QString();
+        }
+        EXPECT_EQ(m_index.rowCount(), static_cast<int>(matches.size()));
+        QStringList ids;
+        for (int row = 0; row < m_index.rowCount(); ++row) {
+            if (m_index.trackId(row).isValid() &&
+                    matches[row] == TrackSearchIndex::Match::True) {
+                ids << m_index.trackId(row).toString();
+            }
+        }
+        return QStringLiteral("[%1]").arg(ids.join(','));
+    }
+
+    SearchQueryParser m_parser;
+    TrackSearchIndex m_index;
+};
+
+TEST_F(TrackSearchIndexTest, Text) {
+    EXPECT_EQ("[1,2,3]", search(""));
+    EXPECT_EQ("[1]", search("bjork"));
+    EXPECT_EQ("[1]", search("ARMY me"));
+    EXPECT_EQ("[2]", search("artist:\"\""));
+    EXPECT_EQ("[3]", search("title:\"100% pure\""));
+    EXPECT_EQ("[1,3]", search("artist:r"));
+    // The trailing space must not be ignored
+    EXPECT_EQ("[2]", search("title:\"world \""));
+    EXPECT_EQ("[]", search("title:\"me \""));
+}
+
+TEST_F(TrackSearchIndexTest, NegationWithNull) {
+    // NOT (NULL LIKE '%bjork%') is NULL like in the database
+    EXPECT_EQ("[3]", search("-artist:bjork"));
+    // NOT (NULL OR FALSE) is NULL
+    EXPECT_EQ("[3]", search("-bjork"));
+}
+
+TEST_F(TrackSearchIndexTest, Numeric) {
+    EXPECT_EQ("[2]", search("bpm:>125"));
+    EXPECT_EQ("[1,2]", search("bpm:100-130"));
+    EXPECT_EQ("[1]", search("bpm:120"));
+    EXPECT_EQ("[3]", search("bpm:\"\""));
+    EXPECT_EQ("[1]", search("-bpm:>125"));
+}
+
+TEST_F(TrackSearchIndexTest, Key) {
+    EXPECT_EQ("[1]", search("key:Am"));
+    // Comparing with IS never results in NULL
+    EXPECT_EQ("[2,3]", search("-key:Am"));
+}
+
+TEST_F(TrackSearchIndexTest, Unsupported) {
+    EXPECT_EQ(QString(), search("year:1995"));
+    EXPECT_EQ(QString(), search("bjork year:1995"));
+}
+
+TEST_F(TrackSearchIndexTest, UpdateAndRemove) {
+    addTrack(2, "Björk", "Hello World !", 128.5, QVariant());
+    EXPECT_EQ("[1,2]", search("bjork"));
+    m_index.removeTrack(TrackId(1));
+    EXPECT_EQ(-1, m_index.row(TrackId(1)));
+    EXPECT_EQ("[2]", search("bjork"));
+    EXPECT_EQ("[2,3]", search(""));
+}
+
+} // anonymous namespace
@@ -0,0 +1,74 @@
+#include "waveform/waveform.h"
+
+#include <gtest/gtest.h>
+
+#include <limits>
+
+namespace {
+
+class WaveformTest : public testing::Test {
+  protected:
+    WaveformTest()
+            // 1001 visual frames, including the one at the end
+            : m_waveform(48000, 48000, 1000, -1) {
+    }
+
+    void setFrame(int frame, unsigned char left, unsigned char right) {
+        WaveformData* pData = m_waveform.data();
+        pData[2 * frame].filtered.all = left;
+        pData[2 * frame].filtered.low = left;
+        pData[2 * frame + 1].filtered.all = right;
+        pData[2 * frame + 1].filtered.high = right;
+    }
+
+    Waveform m_waveform;
+};
+
+TEST_F(WaveformTest, Mipmaps) {
+    ASSERT_EQ(2002, m_waveform.getDataSize());
+    // 1001 -> 501 -> 251 -> 126 -> 63 -> 32 -> 16 -> 8 -> 4 -> 2 -> 1
+    ASSERT_EQ(11, m_waveform.getMipmapLevelCount());
+    EXPECT_EQ(1002, m_waveform.getMipmapDataSize(1));
+    EXPECT_EQ(126, m_waveform.getMipmapDataSize(4));
+    EXPECT_EQ(2, m_waveform.getMipmapDataSize(10));
+
+    setFrame(5, 10, 20);
+    setFrame(6, 30, 5);
+    setFrame(999, 40, 50);
+    m_waveform.updateMipmaps(10, 14);
+    m_waveform.updateMipmaps(1998, 2000);
+
+    // Frames 4-5 and 6-7
+    const WaveformData* pLevel1 = m_waveform.mipmapData(1);
+    EXPECT_EQ(10, pLevel1[4].filtered.all);
+    EXPECT_EQ(20, pLevel1[5].filtered.all);
+    EXPECT_EQ(30, pLevel1[6].filtered.low);
+    EXPECT_EQ(5, pLevel1[7].filtered.high);
+    // Frames 0-7, the maximum of each band and channel
+    const WaveformData* pLevel3 = m_waveform.mipmapData(3);
+    EXPECT_EQ(30, pLevel3[0].filtered.all);
+    EXPECT_EQ(30, pLevel3[0].filtered.low);
+    EXPECT_EQ(20, pLevel3[1].filtered.all);
+    EXPECT_EQ(20, pLevel3[1].filtered.high);
+    // Frames 992-1000
+    const WaveformData* pLevel4 = m_waveform.mipmapData(4);
+    EXPECT_EQ(40, pLevel4[124].filtered.all);
+    EXPECT_EQ(50, pLevel4[125].filtered.all);
+    // All frames
+    const WaveformData* pLevel10 = m_waveform.mipmapData(10);
+    EXPECT_EQ(40, pLevel10[0].filtered.all);
+    EXPECT_EQ(50, pLevel10[1].filtered.all);
+}
+
+TEST_F(WaveformTest, SelectMipmapLevel) {
+    // Less than 8 frames per pixel
+    EXPECT_EQ(0, m_waveform.selectMipmapLevel(0.007));
+    // 8 frames per pixel
+    EXPECT_EQ(1, m_waveform.selectMipmapLevel(0.008));
+    // 100 frames per pixel
+    EXPECT_EQ(4, m_waveform.selectMipmapLevel(0.1));
+    EXPECT_EQ(10, m_waveform.selectMipmapLevel(1000.0));
+    EXPECT_EQ(0, m_waveform.selectMipmapLevel(std::numeric_limits<double>::infinity()));
+}
+
+} // anonymous namespace
@@ -0,0 +1,130 @@
+#include "soundio/xrunlog.h"
+
+#include <gtest/gtest.h>
+
+#include <QFile>
+#include <QFileInfo>
+#include <QTemporaryDir>
+
+namespace {
+
+constexpr int kFramesPerBuffer = 256;
+constexpr int kSampleRate = 48000;
+// The duration of kFramesPerBuffer at kSampleRate
+constexpr qint64 kBudgetNanos = 5333333;
+
+class XrunLogTest : public testing::Test {
+  protected:
+    void SetUp() override {
+        ASSERT_TRUE(m_dir.isValid());
+    }
+
+    void captureSnapshot(XrunLog* pLog, quint32 codes) {
+        XrunSnapshot* pSnapshot = pLog->prepareSnapshot(codes, kFramesPerBuffer, kSampleRate);
+        XrunSnapshot::Deck& deck = pSnapshot->decks[pSnapshot->deckCount++];
+        XrunSnapshot::copyName(deck.group, "[Channel1]");
+        XrunSnapshot::copyName(deck.scaler, "RubberBand");
+        deck.playing = true;
+        deck.cacheMissCount = 3;
+        pSnapshot->enabledEffectChainCount = 2;
+        pSnapshot->busyAnalyzerCount = 1;
+        pLog->commitSnapshot();
+    }
+
+    QTemporaryDir m_dir;
+};
+
+TEST_F(XrunLogTest, WriteAndReadSnapshot) {
+    XrunLog log(m_dir.path());
+    for (int i = 0; i < XrunSnapshot::kMaxCallbacks + 8; ++i) {
+        log.recordCallback(i);
+    }
+    captureSnapshot(&log, (1 << 6) | (1 << 12));
+    log.writePendingSnapshots();
+
+    const QList<XrunLog::Event> events = XrunLog::readEvents(m_dir.path());
+    ASSERT_EQ(1, events.size());
+    const XrunLog::Event& event = events.first();
+    EXPECT_EQ(static_cast<quint32>((1 << 6) | (1 << 12)), event.codes);
+    EXPECT_EQ(kFramesPerBuffer, event.framesPerBuffer);
+    EXPECT_EQ(kSampleRate, event.sampleRate);
+    EXPECT_EQ(kBudgetNanos, event.budgetNanos());
+    // Only the most recent callbacks are kept, oldest first
+    ASSERT_EQ(XrunSnapshot::kMaxCallbacks, event.callbackNanos.size());
+    EXPECT_EQ(8, event.callbackNanos.first());
+    EXPECT_EQ(XrunSnapshot::kMaxCallbacks + 7, event.callbackNanos.last());
+    ASSERT_EQ(1, event.decks.size());
+    EXPECT_EQ(QStringLiteral("[Channel1]"), event.decks.first().group);
+    EXPECT_EQ(QStringLiteral("RubberBand"), event.decks.first().scaler);
+    EXPECT_TRUE(event.decks.first().playing);
+    EXPECT_EQ(3, event.decks.first().cacheMissCount);
+    EXPECT_EQ(2, event.enabledEffectChainCount);
+    EXPECT_EQ(1, event.busyAnalyzerCount);
+    EXPECT_FALSE(event.isEngineOverload());
+}
+
+TEST_F(XrunLogTest, CopyNameTruncates) {
+    XrunSnapshot::Deck deck;
+    XrunSnapshot::copyName(deck.group, "[ThisGroupNameIsTooLongForTheSnapshot]");
+    EXPECT_EQ(XrunSnapshot::kMaxNameLength, static_cast<int>(qstrlen(deck.group)));
+}
+
+TEST_F(XrunLogTest, EngineOverload) {
+    XrunLog::Event event;
+    event.framesPerBuffer = kFramesPerBuffer;
+    event.sampleRate = kSampleRate;
+    event.callbackNanos = {kBudgetNanos * 2, 1000, 1000, 1000, 1000};
+    // Overloads before the most recent callbacks are not considered
+    EXPECT_FALSE(event.isEngineOverload());
+    event.callbackNanos.append(kBudgetNanos);
+    EXPECT_TRUE(event.isEngineOverload());
+}
+
+TEST_F(XrunLogTest, RotateFiles) {
+    XrunLog log(m_dir.path());
+    log.recordCallback(1000);
+    int snapshotCount = 0;
+    while (XrunLog::filePaths(m_dir.path()).size() < XrunLog::kMaxFileCount) {
+        captureSnapshot(&log, 1 << 1);
+        log.writePendingSnapshots();
+        ++snapshotCount;
+    }
+    const int eventsPerFile = snapshotCount / (XrunLog::kMaxFileCount - 1);
+    for (int i = 0; i < 2 * eventsPerFile; ++i) {
+        captureSnapshot(&log, 1 << 1);
+        log.writePendingSnapshots();
+    }
+    EXPECT_EQ(0, log.droppedSnapshotCount());
+
+    const QStringList paths = XrunLog::filePaths(m_dir.path());
+    ASSERT_EQ(XrunLog::kMaxFileCount, paths.size());
+    for (const auto& path : paths) {
+        EXPECT_LE(QFileInfo(path).size(), XrunLog::kMaxFileSize + 1024);
+    }
+    // The oldest events have been discarded
+    const QList<XrunLog::Event> events = XrunLog::readEvents(m_dir.path());
+    EXPECT_LT(events.size(), snapshotCount + 2 * eventsPerFile);
+    EXPECT_GE(events.size(), 2 * eventsPerFile);
+}
+
+TEST_F(XrunLogTest, ExportCsv) {
+    {
+        XrunLog log(m_dir.path());
+        log.recordCallback(kBudgetNanos * 2);
+        captureSnapshot(&log, 1 << 1);
+        // The pending snapshots are written on destruction
+    }
+    const QString csvFilePath = m_dir.filePath(QStringLiteral("xruns.csv"));
+    ASSERT_TRUE(XrunLog::exportCsv(m_dir.path(), csvFilePath));
+
+    QFile csvFile(csvFilePath);
+    ASSERT_TRUE(csvFile.open(QIODevice::ReadOnly | QIODevice::Text));
+    const QStringList lines =
+            QString::fromUtf8(csvFile.readAll()).trimmed().split(QChar('\n'));
+    ASSERT_EQ(2, lines.size());
+    EXPECT_TRUE(lines[0].startsWith(QStringLiteral("time,cause,")));
+    EXPECT_TRUE(lines[1].contains(QStringLiteral(",engine overload,1,256,48000,")));
+    EXPECT_TRUE(lines[1].contains(QStringLiteral("[Channel1]:RubberBand:playing:3")));
+}
+
+} // anonymous namespace
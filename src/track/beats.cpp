@@ -1,5 +1,6 @@
 #include "track/beats.h"
 
+#include <algorithm>
 #include <cmath>
 #include <iterator>
 #include <unordered_map>
@@ -343,11 +344,14 @@ BeatsPointer Beats::fromBeatMapByteArray(
 }
 
 QByteArray Beats::toByteArray() const {
-    if (hasConstantTempo()) {
-        return toBeatGridByteArray();
-    }
-
-    return toBeatMapByteArray();
+    std::call_once(m_serializedOnce, [this] {
+        if (hasConstantTempo()) {
+            m_serialized = toBeatGridByteArray();
+        } else {
+            m_serialized = toBeatMapByteArray();
+        }
+    });
+    return m_serialized;
 };
 
 QByteArray Beats::toBeatGridByteArray() const {
@@ -458,8 +462,38 @@ Beats::ConstIterator Beats::iteratorFrom(audio::FramePos position) const {
             return cbegin();
         }
         it -= static_cast<int>(n);
+    } else if (position == m_lastMarkerPosition) {
+        it = clastmarker();
     } else {
-        it = std::lower_bound(cfirstmarker(), clastmarker() + 1, position);
+        // Lookup position is between the first and the last marker. Advancing
+        // a ConstIterator walks the markers one by one, so a binary search
+        // over the beats would be O(n log n) for beatmaps with a marker per
+        // beat. Search the markers instead and compute the beat inside the
+        // tempo section.
+        const auto nextMarker = std::upper_bound(m_markers.cbegin(),
+                m_markers.cend(),
+                position,
+                [](audio::FramePos position, const BeatMarker& marker) {
+                    return position < marker.position();
+                });
+        DEBUG_ASSERT(nextMarker != m_markers.cbegin());
+        const auto marker = std::prev(nextMarker);
+        it = ConstIterator(this, marker, 0);
+        const double n = std::ceil((position - marker->position()) / it.beatLengthFrames());
+        if (n > 0) {
+            it += static_cast<int>(n);
+        }
+
+        // Compensate floating point errors of the division, so the result is
+        // the first beat at or after the position like with std::lower_bound.
+        if (*it < position) {
+            it++;
+        } else if (it != cfirstmarker()) {
+            auto previousBeatIt = it - 1;
+            if (*previousBeatIt >= position) {
+                it = previousBeatIt;
+            }
+        }
     }
     DEBUG_ASSERT(it == cbegin() || it == cend() || *it >= position);
     DEBUG_ASSERT(it == cbegin() || it == cend() || *it > *std::prev(it));
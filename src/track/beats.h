@@ -5,6 +5,7 @@
 #include <QString>
 #include <QVector>
 #include <memory>
+#include <mutex>
 #include <optional>
 
 #include "audio/frame.h"
@@ -283,6 +284,10 @@ class Beats : private std::enable_shared_from_this<Beats> {
     }
 
     /// Serialize beats to QByteArray.
+    ///
+    /// The result is computed only once, because each instance is
+    /// immutable and the beats of a track are saved again on every
+    /// update of the track.
     QByteArray toByteArray() const;
 
     /// A string representing the version of the beat-processing code that
@@ -437,6 +442,9 @@ class Beats : private std::enable_shared_from_this<Beats> {
 
     // The sub-version of this beatgrid.
     const QString m_subVersion;
+
+    mutable std::once_flag m_serializedOnce;
+    mutable QByteArray m_serialized;
 };
 
 } // namespace mixxx
@@ -126,3 +126,18 @@ class CuePointer : public std::shared_ptr<Cue> {
   private:
     static void deleteLater(Cue* pCue);
 };
+
+/// The properties of a cue as stored in the database.
+///
+/// Much smaller than a Cue object. Tracks that are loaded from the
+/// database keep their cues in this form until they are accessed for
+/// the first time.
+struct CueRecord {
+    DbId id;
+    mixxx::CueType type;
+    mixxx::audio::FramePos position;
+    mixxx::audio::FrameDiff_t length;
+    int hotCue;
+    QString label;
+    mixxx::RgbColor color;
+};
@@ -1,6 +1,7 @@
 #include "track/globaltrackcache.h"
 
 #include <QCoreApplication>
+#include <QThread>
 
 #include "moc_globaltrackcache.cpp"
 #include "track/track.h"
@@ -12,6 +13,10 @@ namespace {
 
 constexpr std::size_t kUnorderedCollectionMinCapacity = 1024;
 
+// Limits the number of evicted tracks that are kept in memory and
+// the duration of a single transaction while saving them
+constexpr std::size_t kMaxSaveBatchSize = 256;
+
 const mixxx::Logger kLogger("GlobalTrackCache");
 
 //static
@@ -224,6 +229,26 @@ void GlobalTrackCacheResolver::initTrackIdAndUnlockCache(TrackId trackId) {
     DEBUG_ASSERT(m_trackRef == createTrackRef(*m_strongPtr));
 }
 
+GlobalTrackCacheSaveBatch::GlobalTrackCacheSaveBatch()
+        : m_pInstance(s_pInstance) {
+    if (!m_pInstance) {
+        return;
+    }
+    DEBUG_ASSERT_QOBJECT_THREAD_AFFINITY(m_pInstance);
+    ++m_pInstance->m_saveBatchDepth;
+}
+
+GlobalTrackCacheSaveBatch::~GlobalTrackCacheSaveBatch() {
+    if (!m_pInstance) {
+        return;
+    }
+    DEBUG_ASSERT_QOBJECT_THREAD_AFFINITY(m_pInstance);
+    DEBUG_ASSERT(m_pInstance->m_saveBatchDepth > 0);
+    if (--m_pInstance->m_saveBatchDepth == 0) {
+        m_pInstance->slotEvictAndSavePending();
+    }
+}
+
 //static
 void GlobalTrackCache::createInstance(
         GlobalTrackCacheSaver* pSaver,
@@ -284,15 +309,7 @@ void GlobalTrackCache::evictAndSaveCachedTrack(GlobalTrackCacheEntryPointer cach
     // already have been either deleted or reused by a second
     // shared_ptr.
     if (s_pInstance) {
-        QMetaObject::invokeMethod(
-                s_pInstance,
-                [cacheEntryPtr = std::move(cacheEntryPtr)] {
-                    s_pInstance->slotEvictAndSave(cacheEntryPtr);
-                },
-                // Qt will choose either a direct or a queued connection
-                // depending on the thread from which this method has
-                // been invoked!
-                Qt::AutoConnection);
+        s_pInstance->enqueueEvictAndSave(std::move(cacheEntryPtr));
     } else {
         // After the singular instance has been destroyed we are
         // not able to save pending changes. The track is deleted
@@ -314,7 +331,8 @@ GlobalTrackCache::GlobalTrackCache(
 #endif
           m_pSaver(pSaver),
           m_deleteTrackFn(deleteTrackFn),
-          m_tracksById(kUnorderedCollectionMinCapacity, DbId::hash_fun) {
+          m_tracksById(kUnorderedCollectionMinCapacity, DbId::hash_fun),
+          m_saveBatchDepth(0) {
     DEBUG_ASSERT(m_pSaver);
     qRegisterMetaType<GlobalTrackCacheEntryPointer>("GlobalTrackCacheEntryPointer");
 }
@@ -390,6 +408,8 @@ void GlobalTrackCache::saveEvictedTrack(Track* pEvictedTrack) const {
 void GlobalTrackCache::deactivate() {
     DEBUG_ASSERT_QOBJECT_THREAD_AFFINITY(this);
 
+    slotEvictAndSavePending();
+
     if (isEmpty()) {
         return;
     }
@@ -583,7 +603,30 @@ void GlobalTrackCache::resolve(
     // Secondary lookup by canonical location
     // The TrackRef is constructed now after the lookup by ID failed to
     // avoid calculating the canonical file path if it is not needed.
+    // This accesses the file system, which might take a while, e.g. for
+    // files on network drives. Meanwhile the cache is unlocked to not
+    // block other threads.
+    m_mutex.unlock();
     TrackRef trackRef = TrackRef::fromFileInfo(fileAccess.info(), trackId);
+    m_mutex.lock();
+    if (trackId.isValid()) {
+        // The track might have been added in the meantime
+        auto strongPtr = lookupById(trackId);
+        if (strongPtr) {
+            if (debugLogEnabled()) {
+                kLogger.debug()
+                        << "Cache hit - found track by id after unlocking"
+                        << trackId
+                        << strongPtr.get();
+            }
+            TrackRef cachedTrackRef = createTrackRef(*strongPtr);
+            pCacheResolver->initLookupResult(
+                    GlobalTrackCacheLookupResult::Hit,
+                    std::move(strongPtr),
+                    std::move(cachedTrackRef));
+            return;
+        }
+    }
     if (trackRef.hasCanonicalLocation()) {
         if (debugLogEnabled()) {
             kLogger.debug()
@@ -763,6 +806,66 @@ void GlobalTrackCache::slotEvictAndSave(
     // when exiting the scope of this method.
 }
 
+void GlobalTrackCache::enqueueEvictAndSave(
+        GlobalTrackCacheEntryPointer cacheEntryPtr) {
+    const bool onCacheThread = QThread::currentThread() == thread();
+    if (onCacheThread && m_saveBatchDepth == 0) {
+        // Evict and save the track immediately
+        slotEvictAndSave(std::move(cacheEntryPtr));
+        return;
+    }
+    std::size_t pendingCount;
+    {
+        const auto locked = lockMutex(&m_pendingEvictionsMutex);
+        m_pendingEvictions.push_back(std::move(cacheEntryPtr));
+        pendingCount = m_pendingEvictions.size();
+    }
+    if (onCacheThread) {
+        // The pending tracks are saved when leaving the batch scope
+        if (pendingCount >= kMaxSaveBatchSize) {
+            slotEvictAndSavePending();
+        }
+        return;
+    }
+    if (pendingCount == 1) {
+        // All tracks that are evicted until the event loop of the
+        // cache thread gets to process them are saved together.
+        QMetaObject::invokeMethod(
+                this,
+                &GlobalTrackCache::slotEvictAndSavePending,
+                Qt::QueuedConnection);
+    }
+}
+
+void GlobalTrackCache::slotEvictAndSavePending() {
+    DEBUG_ASSERT_QOBJECT_THREAD_AFFINITY(this);
+
+    std::vector<GlobalTrackCacheEntryPointer> cacheEntryPtrs;
+    {
+        const auto locked = lockMutex(&m_pendingEvictionsMutex);
+        cacheEntryPtrs.swap(m_pendingEvictions);
+    }
+    if (cacheEntryPtrs.empty()) {
+        return;
+    }
+    if (debugLogEnabled()) {
+        kLogger.debug()
+                << "Evicting and saving"
+                << cacheEntryPtrs.size()
+                << "tracks";
+    }
+
+    // The cache is only locked while saving each single track and other
+    // threads may access it in between. Holding the lock for the whole
+    // batch would block all lookups until all tracks have been saved,
+    // including the export of their file tags.
+    m_pSaver->beginSavingEvictedTracks();
+    for (auto& cacheEntryPtr : cacheEntryPtrs) {
+        slotEvictAndSave(std::move(cacheEntryPtr));
+    }
+    m_pSaver->endSavingEvictedTracks();
+}
+
 bool GlobalTrackCache::tryEvict(Track* plainPtr) {
     DEBUG_ASSERT(plainPtr);
     // Make the cached track object invisible to avoid reusing
@@ -2,6 +2,7 @@
 
 #include <map>
 #include <unordered_map>
+#include <vector>
 
 #include "track/track_decl.h"
 #include "track/trackref.h"
@@ -197,10 +198,39 @@ private:
     virtual void saveEvictedTrack(
             Track* pEvictedTrack) noexcept = 0;
 
+    /// Invoked before and after saving multiple evicted tracks in a
+    /// row, e.g. for combining all database updates into a single
+    /// transaction. Both callbacks are invoked on the thread of the
+    /// cache and never nested. The cache is not locked in between,
+    /// only while saving each track.
+    virtual void beginSavingEvictedTracks() noexcept {
+    }
+    virtual void endSavingEvictedTracks() noexcept {
+    }
+
   protected:
     virtual ~GlobalTrackCacheSaver() = default;
 };
 
+/// Defers saving of tracks that are evicted on the thread of the
+/// cache while in scope, e.g. when modifying many tracks one after
+/// another. The deferred tracks are saved in batches and at the
+/// latest when leaving the scope.
+///
+/// Tracks that are evicted on other threads are always saved in
+/// batches by the event loop of the cache.
+class GlobalTrackCacheSaveBatch final {
+  public:
+    GlobalTrackCacheSaveBatch();
+    ~GlobalTrackCacheSaveBatch();
+
+    GlobalTrackCacheSaveBatch(const GlobalTrackCacheSaveBatch&) = delete;
+    GlobalTrackCacheSaveBatch& operator=(const GlobalTrackCacheSaveBatch&) = delete;
+
+  private:
+    GlobalTrackCache* const m_pInstance;
+};
+
 class GlobalTrackCache : public QObject {
     Q_OBJECT
 
@@ -222,10 +252,14 @@ class GlobalTrackCache : public QObject {
 
   private slots:
     void slotEvictAndSave(GlobalTrackCacheEntryPointer cacheEntryPtr);
+    void slotEvictAndSavePending();
 
   private:
     friend class GlobalTrackCacheLocker;
     friend class GlobalTrackCacheResolver;
+    friend class GlobalTrackCacheSaveBatch;
+
+    void enqueueEvictAndSave(GlobalTrackCacheEntryPointer cacheEntryPtr);
 
     GlobalTrackCache(
             GlobalTrackCacheSaver* pSaver,
@@ -286,4 +320,11 @@ class GlobalTrackCache : public QObject {
     // This caches the unsaved Tracks by location
     typedef std::map<QString, GlobalTrackCacheEntryPointer> TracksByCanonicalLocation;
     TracksByCanonicalLocation m_tracksByCanonicalLocation;
+
+    // Evicted tracks that are waiting to be saved in a batch
+    QMutex m_pendingEvictionsMutex;
+    std::vector<GlobalTrackCacheEntryPointer> m_pendingEvictions;
+
+    // Managed by GlobalTrackCacheSaveBatch on the thread of the cache
+    int m_saveBatchDepth;
 };
@@ -2,6 +2,7 @@
 
 #include <mp3guessenc.h>
 
+#include <QCache>
 #include <optional>
 
 #include "sources/soundsourceproxy.h"
@@ -18,6 +19,7 @@
 #include "track/serato/cueinfoimporter.h"
 #include "track/taglib/trackmetadata_file.h"
 #include "util/color/predefinedcolorpalettes.h"
+#include "util/compatibility/qmutex.h"
 
 namespace {
 
@@ -67,10 +69,99 @@ bool isCueInfoValid(const mixxx::CueInfo& cueInfo) {
     return true;
 }
 
+/// The maximum size of the raw tags whose parsing results are kept, for
+/// each kind of tag
+constexpr int kParsedTagCacheMaxBytes = 4 * 1024 * 1024;
+
+struct ParsedTagKey {
+    QByteArray data;
+    mixxx::taglib::FileType fileType;
+};
+
+bool operator==(const ParsedTagKey& lhs, const ParsedTagKey& rhs) {
+    return lhs.fileType == rhs.fileType && lhs.data == rhs.data;
+}
+
+uint qHash(const ParsedTagKey& key, uint seed = 0) {
+    return qHash(key.data, seed) ^ static_cast<uint>(key.fileType);
+}
+
+/// The results of parsing the most recently used tags of one kind. Tags are
+/// keyed by their raw content, so looking up a tag only hashes it instead
+/// of decoding the base64 encoded content and parsing all entries.
+///
+/// The parsed entries are shared between copies of the tags and replaced
+/// instead of modified, so the cached results can be handed out as copies.
+template<typename T>
+class ParsedTagCache {
+  public:
+    using ParseFunc = bool (*)(T*, const QByteArray&, mixxx::taglib::FileType);
+
+    ParsedTagCache()
+            : m_results(kParsedTagCacheMaxBytes) {
+    }
+
+    bool parse(T* pParsed,
+            const QByteArray& data,
+            mixxx::taglib::FileType fileType,
+            ParseFunc parseFunc) {
+        ParsedTagKey key{data, fileType};
+        {
+            const auto locker = lockMutex(&m_mutex);
+            const Result* pResult = m_results.object(key);
+            if (pResult) {
+                *pParsed = pResult->parsed;
+                return pResult->success;
+            }
+        }
+        // Parse without holding the lock, other threads may parse other tags
+        T parsed;
+        const bool success = parseFunc(&parsed, data, fileType);
+        *pParsed = parsed;
+        // Never evict everything for a huge tag
+        const int cost = static_cast<int>(data.size());
+        if (cost <= kParsedTagCacheMaxBytes / 16) {
+            const auto locker = lockMutex(&m_mutex);
+            m_results.insert(std::move(key), new Result{std::move(parsed), success}, cost);
+        }
+        return success;
+    }
+
+  private:
+    struct Result {
+        T parsed;
+        bool success;
+    };
+
+    QMutex m_mutex;
+    QCache<ParsedTagKey, Result> m_results;
+};
+
 } // namespace
 
 namespace mixxx {
 
+bool SeratoTags::parseBeatGrid(const QByteArray& data, taglib::FileType fileType) {
+    static ParsedTagCache<SeratoBeatGrid> s_cache;
+    bool success = s_cache.parse(&m_seratoBeatGrid, data, fileType, &SeratoBeatGrid::parse);
+    m_seratoBeatGridParserStatus = success ? ParserStatus::Parsed : ParserStatus::Failed;
+    return success;
+}
+
+bool SeratoTags::parseMarkers(const QByteArray& data, taglib::FileType fileType) {
+    static ParsedTagCache<SeratoMarkers> s_cache;
+    bool success = s_cache.parse(&m_seratoMarkers, data, fileType, &SeratoMarkers::parse);
+    m_seratoMarkersParserStatus = success ? ParserStatus::Parsed : ParserStatus::Failed;
+    return success;
+}
+
+bool SeratoTags::parseMarkers2(const QByteArray& data, taglib::FileType fileType) {
+    static ParsedTagCache<SeratoMarkers2> s_cache;
+    bool success = s_cache.parse(&m_seratoMarkers2, data, fileType, &SeratoMarkers2::parse);
+    m_seratoMarkers2ParserStatus = success ? ParserStatus::Parsed : ParserStatus::Failed;
+    return success;
+}
+
 double SeratoTags::guessTimingOffsetMillis(
         const QString& filePath,
         const audio::SignalInfo& signalInfo) {
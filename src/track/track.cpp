@@ -8,6 +8,7 @@
 #include "sources/metadatasource.h"
 #include "util/assert.h"
 #include "util/logger.h"
+#include "util/qt.h"
 
 namespace {
 
@@ -887,21 +888,29 @@ QString Track::getURL() const {
     return m_record.getUrl();
 }
 
-const ConstWaveformPointer& Track::getWaveform() const {
+ConstWaveformPointer Track::getWaveform() const {
+    const auto locked = lockMutex(&m_qMutex);
     return m_waveform;
 }
 
 void Track::setWaveform(ConstWaveformPointer pWaveform) {
-    m_waveform = pWaveform;
+    {
+        const auto locked = lockMutex(&m_qMutex);
+        m_waveform = std::move(pWaveform);
+    }
     emit waveformUpdated();
 }
 
 ConstWaveformPointer Track::getWaveformSummary() const {
+    const auto locked = lockMutex(&m_qMutex);
     return m_waveformSummary;
 }
 
 void Track::setWaveformSummary(ConstWaveformPointer pWaveform) {
-    m_waveformSummary = pWaveform;
+    {
+        const auto locked = lockMutex(&m_qMutex);
+        m_waveformSummary = std::move(pWaveform);
+    }
     emit waveformSummaryUpdated();
 }
 
@@ -951,6 +960,7 @@ void Track::shiftCuePositionsMillis(double milliseconds) {
         return;
     }
     double frames = m_record.getStreamInfoFromSource()->getSignalInfo().millis2frames(milliseconds);
+    createPendingCuePointsWhileLocked();
     for (const CuePointer& pCue : std::as_const(m_cuePoints)) {
         pCue->shiftPositionFrames(frames);
     }
@@ -1000,6 +1010,7 @@ CuePointer Track::createAndAddCue(
             this,
             &Track::slotCueUpdated);
     auto locked = lockMutex(&m_qMutex);
+    createPendingCuePointsWhileLocked();
     m_cuePoints.push_back(pCue);
     markDirtyAndUnlock(&locked);
     emit cuesUpdated();
@@ -1013,6 +1024,7 @@ CuePointer Track::findCueByType(mixxx::CueType type) const {
         return CuePointer();
     }
     auto locked = lockMutex(&m_qMutex);
+    createPendingCuePointsWhileLocked();
     for (const CuePointer& pCue: m_cuePoints) {
         if (pCue->getType() == type) {
             return pCue;
@@ -1023,6 +1035,7 @@ CuePointer Track::findCueByType(mixxx::CueType type) const {
 
 CuePointer Track::findCueById(DbId id) const {
     auto locked = lockMutex(&m_qMutex);
+    createPendingCuePointsWhileLocked();
     for (const CuePointer& pCue : m_cuePoints) {
         if (pCue->getId() == id) {
             return pCue;
@@ -1049,6 +1062,7 @@ void Track::removeCue(const CuePointer& pCue) {
 void Track::removeCuesOfType(mixxx::CueType type) {
     auto locked = lockMutex(&m_qMutex);
     bool dirty = false;
+    createPendingCuePointsWhileLocked();
     QMutableListIterator<CuePointer> it(m_cuePoints);
     while (it.hasNext()) {
         CuePointer pCue = it.next();
@@ -1205,11 +1219,39 @@ Track::ImportStatus Track::getCueImportStatus() const {
             : ImportStatus::Pending;
 }
 
+void Track::createPendingCuePointsWhileLocked() const {
+    if (m_pendingCueRecords.isEmpty()) {
+        return;
+    }
+    m_cuePoints.reserve(m_cuePoints.size() + m_pendingCueRecords.size());
+    for (const auto& cueRecord : std::as_const(m_pendingCueRecords)) {
+        CuePointer pCue(new Cue(cueRecord.id,
+                cueRecord.type,
+                cueRecord.position,
+                cueRecord.length,
+                cueRecord.hotCue,
+                cueRecord.label,
+                cueRecord.color));
+        // While this method could be called from any thread,
+        // associated Cue objects should always live on the
+        // same thread as their host, namely this->thread().
+        pCue->moveToThread(thread());
+        connect(pCue.get(),
+                &Cue::updated,
+                mixxx::thisAsNonConst(this),
+                &Track::slotCueUpdated);
+        m_cuePoints.push_back(std::move(pCue));
+    }
+    m_pendingCueRecords.clear();
+}
+
 bool Track::setCuePointsWhileLocked(const QList<CuePointer>& cuePoints) {
-    if (m_cuePoints.isEmpty() && cuePoints.isEmpty()) {
+    if (m_cuePoints.isEmpty() && m_pendingCueRecords.isEmpty() && cuePoints.isEmpty()) {
         // Nothing to do
         return false;
     }
+    // the pending cue points are replaced without ever being accessed
+    m_pendingCueRecords.clear();
     // disconnect existing cue points
     for (const auto& pCue : std::as_const(m_cuePoints)) {
         disconnect(pCue.get(), nullptr, this, nullptr);
@@ -1267,6 +1309,7 @@ bool Track::importPendingCueInfosWhileLocked() {
     // The sample rate is supposed to be consistent
     DEBUG_ASSERT(sampleRate ==
             m_record.getMetadata().getStreamInfo().getSignalInfo().getSampleRate());
+    createPendingCuePointsWhileLocked();
     QList<CuePointer> cuePoints;
     cuePoints.reserve(m_pCueInfoImporterPending->size() + m_cuePoints.size());
 
@@ -1485,6 +1528,7 @@ bool Track::exportSeratoMetadata() {
 
     const mixxx::audio::SampleRate sampleRate =
             streamInfo->getSignalInfo().getSampleRate();
+    createPendingCuePointsWhileLocked();
     QList<mixxx::CueInfo> cueInfos;
     cueInfos.reserve(m_cuePoints.size());
     for (const CuePointer& pCue : std::as_const(m_cuePoints)) {
@@ -1501,9 +1545,11 @@ bool Track::exportSeratoMetadata() {
     return true;
 }
 
-ExportTrackMetadataResult Track::exportMetadata(
+ExportTrackMetadataResult Track::prepareMetadataExport(
         const mixxx::MetadataSource& metadataSource,
-        const SyncTrackMetadataParams& syncParams) {
+        const SyncTrackMetadataParams& syncParams,
+        mixxx::TrackMetadata* pExportMetadata) {
+    DEBUG_ASSERT(pExportMetadata);
     // Locking shouldn't be necessary here, because this function will
     // be called after all references to the object have been dropped.
     // But it doesn't hurt much, so let's play it safe ;)
@@ -1655,15 +1701,29 @@ ExportTrackMetadataResult Track::exportMetadata(
     kLogger.debug()
             << "New metadata (modified)"
             << normalizedFromRecord;
+    *pExportMetadata = std::move(normalizedFromRecord);
+    return ExportTrackMetadataResult::Succeeded;
+}
+
+ExportTrackMetadataResult Track::exportMetadata(
+        const mixxx::MetadataSource& metadataSource,
+        const SyncTrackMetadataParams& syncParams) {
+    mixxx::TrackMetadata exportMetadata;
+    const auto prepareResult = prepareMetadataExport(
+            metadataSource, syncParams, &exportMetadata);
+    if (prepareResult != ExportTrackMetadataResult::Succeeded) {
+        return prepareResult;
+    }
     const auto trackMetadataExported =
-            metadataSource.exportTrackMetadata(normalizedFromRecord);
+            metadataSource.exportTrackMetadata(exportMetadata);
     switch (trackMetadataExported.first) {
-    case mixxx::MetadataSource::ExportResult::Succeeded:
+    case mixxx::MetadataSource::ExportResult::Succeeded: {
         // After successfully exporting the metadata we record the fact
         // that now the file tags and the track's metadata are in sync.
         // This information (flag or time stamp) is stored in the database.
         // The database update will follow immediately after returning from
         // this operation!
+        const auto locked = lockMutex(&m_qMutex);
         m_record.updateSourceSynchronizedAt(trackMetadataExported.second);
         if (kLogger.debugEnabled()) {
             kLogger.debug()
@@ -1671,6 +1731,7 @@ ExportTrackMetadataResult Track::exportMetadata(
                     << getLocation();
         }
         return ExportTrackMetadataResult::Succeeded;
+    }
     case mixxx::MetadataSource::ExportResult::Unsupported:
         return ExportTrackMetadataResult::Skipped;
     case mixxx::MetadataSource::ExportResult::Failed:
@@ -1777,6 +1838,18 @@ void Track::setGenreFromTrackDAO(
     }
 }
 
+void Track::setCueRecordsFromTrackDAO(
+        QList<CueRecord> cueRecords) {
+    const auto locked = lockMutex(&m_qMutex);
+    DEBUG_ASSERT(m_cuePoints.isEmpty());
+    for (const auto& cueRecord : std::as_const(cueRecords)) {
+        if (cueRecord.type == mixxx::CueType::MainCue) {
+            m_record.setMainCuePosition(cueRecord.position);
+        }
+    }
+    m_pendingCueRecords = std::move(cueRecords);
+}
+
 bool Track::updateGenre(
         const QString& genre) {
     auto locked = lockMutex(&m_qMutex);
@@ -278,7 +278,9 @@ class Track : public QObject {
     /// any metadata in file tags. Otherwise just the title (even if it is empty).
     QString getTitleInfo() const;
 
-    const ConstWaveformPointer& getWaveform() const;
+    /// The waveforms are replaced by the analyzer and read by the
+    /// waveform renderers, possibly on different threads.
+    ConstWaveformPointer getWaveform() const;
     void setWaveform(ConstWaveformPointer pWaveform);
 
     ConstWaveformPointer getWaveformSummary() const;
@@ -320,6 +322,7 @@ class Track : public QObject {
     void removeCuesOfType(mixxx::CueType);
     QList<CuePointer> getCuePoints() const {
         const QMutexLocker lock(&m_qMutex);
+        createPendingCuePointsWhileLocked();
         // lock thread-unsafe copy constructors of QList
         return m_cuePoints;
     }
@@ -486,6 +489,11 @@ class Track : public QObject {
     /// the caller guards this a lock.
     bool importPendingBeatsWhileLocked();
 
+    /// Creates the cue points that have been loaded from the database
+    /// but not accessed yet. Only supposed to be called while the caller
+    /// guards this a lock.
+    void createPendingCuePointsWhileLocked() const;
+
     /// Sets cue points and returns a boolean to indicate if cues were updated.
     /// Only supposed to be called while the caller guards this a lock.
     bool setCuePointsWhileLocked(const QList<CuePointer>& cuePoints);
@@ -524,6 +532,13 @@ class Track : public QObject {
 
     bool exportSeratoMetadata();
 
+    /// Decides if the file tags need to be updated and fills in the
+    /// metadata to be written. Returns Succeeded if the metadata must be
+    /// written, the time stamp of the export has to be stored afterwards.
+    ExportTrackMetadataResult prepareMetadataExport(
+            const mixxx::MetadataSource& metadataSource,
+            const SyncTrackMetadataParams& syncParams,
+            mixxx::TrackMetadata* pExportMetadata);
     ExportTrackMetadataResult exportMetadata(
             const mixxx::MetadataSource& metadataSource,
             const SyncTrackMetadataParams& syncParams);
@@ -557,7 +572,11 @@ class Track : public QObject {
     bool m_bMarkedForMetadataExport;
 
     // The list of cue points for the track
-    QList<CuePointer> m_cuePoints;
+    mutable QList<CuePointer> m_cuePoints;
+
+    // The cue points that have been loaded from the database and
+    // are appended to m_cuePoints when accessed for the first time
+    mutable QList<CueRecord> m_pendingCueRecords;
 
     // Storage for the track's beats
     mixxx::BeatsPointer m_pBeats;
@@ -581,6 +600,16 @@ class Track : public QObject {
     /// TODO: Remove and populate TrackRecord from the database instead.
     void setGenreFromTrackDAO(
             const QString& genre);
+    /// Set the cue points from the database WITHOUT marking the track
+    /// as dirty. The Cue objects are only created on first access.
+    void setCueRecordsFromTrackDAO(
+            QList<CueRecord> cueRecords);
+    /// Returns true if none of the cue points that have been loaded
+    /// from the database has been accessed, i.e. they are unmodified.
+    bool hasPendingCueRecordsFromTrackDAO() const {
+        const auto locked = lockMutex(&m_qMutex);
+        return !m_pendingCueRecords.isEmpty();
+    }
 
     friend class GlobalTrackCache;
     friend class GlobalTrackCacheResolver;
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <QFuture>
+#include <QFutureInterface>
+#include <QRunnable>
+#include <QThreadPool>
+#include <type_traits>
+#include <utility>
+
+namespace mixxx {
+
+/// The order in which queued background tasks are started. Tasks of a
+/// higher priority are started before all queued tasks of a lower
+/// priority, running tasks are never preempted.
+enum class BackgroundTaskPriority : int {
+    /// Long-running jobs like exports, whose progress is only monitored
+    Batch = 0,
+    /// Tasks the user is waiting for, e.g. the covers of visible rows
+    Interactive = 1,
+};
+
+namespace backgroundtask {
+
+namespace detail {
+
+template<typename Function, typename Result>
+class Task final : public QRunnable {
+  public:
+    Task(Function function, QFutureInterface<Result> promise)
+            : m_function(std::move(function)),
+              m_promise(std::move(promise)) {
+    }
+
+    void run() override {
+        if constexpr (std::is_void_v<Result>) {
+            m_function();
+        } else {
+            m_promise.reportResult(m_function());
+        }
+        m_promise.reportFinished();
+    }
+
+  private:
+    Function m_function;
+    QFutureInterface<Result> m_promise;
+};
+
+} // namespace detail
+
+/// The number of background tasks that may run concurrently
+inline int maxConcurrency() {
+    return QThreadPool::globalInstance()->maxThreadCount();
+}
+
+/// Runs a function on the global thread pool, which is shared by all
+/// background tasks and QtConcurrent::run(). Jobs that used to create a
+/// thread pool of their own would start threads for all cores each,
+/// oversubscribing the CPU when they run at the same time.
+///
+/// Unlike QtConcurrent::run() the priority of the task can be chosen.
+template<typename Function>
+QFuture<std::invoke_result_t<Function>> run(
+        BackgroundTaskPriority priority, Function function) {
+    using Result = std::invoke_result_t<Function>;
+    QFutureInterface<Result> promise;
+    promise.reportStarted();
+    QFuture<Result> future = promise.future();
+    // The task is deleted by the pool
+    QThreadPool::globalInstance()->start(
+            new detail::Task<Function, Result>(
+                    std::move(function), std::move(promise)),
+            static_cast<int>(priority));
+    return future;
+}
+
+} // namespace backgroundtask
+
+} // namespace mixxx
@@ -22,6 +22,7 @@ CmdlineArgs::CmdlineArgs()
           m_controllerDebug(false),
           m_controllerAbortOnWarning(false),
           m_developer(false),
+          m_startupProfile(false),
           m_safeMode(false),
           m_useLegacyVuMeter(false),
           m_useLegacySpinny(false),
@@ -215,6 +216,13 @@ bool CmdlineArgs::parse(const QStringList& arguments, CmdlineArgs::ParseMode mod
                             : QString());
     parser.addOption(developer);
 
+    const QCommandLineOption startupProfile(QStringLiteral("startup-profile"),
+            forUserFeedback ? QCoreApplication::translate("CmdlineArgs",
+                                      "Logs the time spent in each phase of the "
+                                      "startup and reports it to the performance stats.")
+                            : QString());
+    parser.addOption(startupProfile);
+
     const QCommandLineOption safeMode(QStringLiteral("safe-mode"),
             forUserFeedback ? QCoreApplication::translate("CmdlineArgs",
                                       "Enables safe-mode. Disables OpenGL waveforms, and "
@@ -350,6 +358,7 @@ bool CmdlineArgs::parse(const QStringList& arguments, CmdlineArgs::ParseMode mod
     m_controllerDebug = parser.isSet(controllerDebug) || parser.isSet(controllerDebugDeprecated);
     m_controllerAbortOnWarning = parser.isSet(controllerAbortOnWarning);
     m_developer = parser.isSet(developer);
+    m_startupProfile = parser.isSet(startupProfile);
     m_safeMode = parser.isSet(safeMode) || parser.isSet(safeModeDeprecated);
     m_debugAssertBreak = parser.isSet(debugAssertBreak) || parser.isSet(debugAssertBreakDeprecated);
 
@@ -38,6 +38,9 @@ class CmdlineArgs final {
         return m_controllerAbortOnWarning;
     }
     bool getDeveloper() const { return m_developer; }
+    bool getStartupProfile() const {
+        return m_startupProfile;
+    }
     bool getSafeMode() const { return m_safeMode; }
     bool useColors() const {
         return m_useColors;
@@ -81,6 +84,7 @@ class CmdlineArgs final {
     bool m_controllerDebug;
     bool m_controllerAbortOnWarning; // Controller Engine will be stricter
     bool m_developer; // Developer Mode
+    bool m_startupProfile;
     bool m_safeMode;
     bool m_useLegacyVuMeter;
     bool m_useLegacySpinny;
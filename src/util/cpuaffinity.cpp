@@ -0,0 +1,145 @@
+#include "util/cpuaffinity.h"
+
+#include <QFile>
+#include <QStringList>
+#include <QThread>
+#include <algorithm>
+
+#ifdef __LINUX__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "util/logger.h"
+
+namespace mixxx {
+
+namespace {
+
+const Logger kLogger("CpuAffinity");
+
+QList<int> s_engineCores;
+QList<int> s_backgroundCores;
+
+#ifdef __LINUX__
+/// The hardware threads that share a physical core with the given one,
+/// including itself.
+QList<int> smtSiblingsOf(int core) {
+    QFile file(QStringLiteral("/sys/devices/system/cpu/cpu%1/topology/thread_siblings_list")
+                       .arg(core));
+    if (!file.open(QIODevice::ReadOnly)) {
+        return {core};
+    }
+    const QList<int> siblings = CpuAffinity::parseCoreList(
+            QString::fromLatin1(file.readAll()).trimmed());
+    if (siblings.isEmpty()) {
+        return {core};
+    }
+    return siblings;
+}
+
+bool setCurrentThreadCores(const QList<int>& cores) {
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    for (const int core : cores) {
+        CPU_SET(core, &cpuSet);
+    }
+    return pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet) == 0;
+}
+#endif
+
+} // anonymous namespace
+
+// static
+QList<int> CpuAffinity::parseCoreList(const QString& coreList) {
+    QList<int> cores;
+    const QStringList items = coreList.split(QChar(','));
+    for (const QString& item : items) {
+        if (item.trimmed().isEmpty()) {
+            continue;
+        }
+        const QStringList range = item.trimmed().split(QChar('-'));
+        bool okFirst = false;
+        bool okLast = range.size() == 1;
+        const int first = range.first().toInt(&okFirst);
+        const int last = range.size() == 2 ? range.last().toInt(&okLast) : first;
+        if (!okFirst || !okLast || range.size() > 2 || first < 0 || last < first) {
+            return {};
+        }
+        for (int core = first; core <= last; ++core) {
+            if (!cores.contains(core)) {
+                cores.append(core);
+            }
+        }
+    }
+    std::sort(cores.begin(), cores.end());
+    return cores;
+}
+
+// static
+void CpuAffinity::configure(const QString& engineCoreList) {
+    s_engineCores.clear();
+    s_backgroundCores.clear();
+    if (engineCoreList.trimmed().isEmpty()) {
+        return;
+    }
+#ifdef __LINUX__
+    const int numCores = QThread::idealThreadCount();
+    QList<int> engineCores = parseCoreList(engineCoreList);
+    engineCores.erase(std::remove_if(engineCores.begin(),
+                              engineCores.end(),
+                              [numCores](int core) { return core >= numCores; }),
+            engineCores.end());
+    if (engineCores.isEmpty()) {
+        kLogger.warning() << "Ignoring invalid engine CPU cores" << engineCoreList;
+        return;
+    }
+    QList<int> reservedCores;
+    for (const int core : std::as_const(engineCores)) {
+        reservedCores.append(smtSiblingsOf(core));
+    }
+    for (int core = 0; core < numCores; ++core) {
+        if (!reservedCores.contains(core)) {
+            s_backgroundCores.append(core);
+        }
+    }
+    if (s_backgroundCores.isEmpty()) {
+        kLogger.warning() << "No CPU cores left for background threads,"
+                          << "ignoring engine CPU cores" << engineCoreList;
+        return;
+    }
+    s_engineCores = engineCores;
+    kLogger.info() << "Engine threads use CPU cores" << s_engineCores
+                   << "and background threads" << s_backgroundCores;
+#else
+    kLogger.warning() << "CPU affinity is not supported on this platform";
+#endif
+}
+
+// static
+const QList<int>& CpuAffinity::engineCores() {
+    return s_engineCores;
+}
+
+// static
+bool CpuAffinity::applyToCurrentThread(ThreadRole role) {
+#ifdef __LINUX__
+    const QList<int>& cores = role == ThreadRole::Engine
+            ? s_engineCores
+            : s_backgroundCores;
+    if (cores.isEmpty()) {
+        return false;
+    }
+    if (!setCurrentThreadCores(cores)) {
+        kLogger.warning() << "Failed to set the CPU affinity of thread"
+                          << QThread::currentThread()->objectName();
+        return false;
+    }
+    return true;
+#else
+    Q_UNUSED(role);
+    return false;
+#endif
+}
+
+} // namespace mixxx
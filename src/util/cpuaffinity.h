@@ -0,0 +1,47 @@
+#pragma once
+
+#include <QList>
+#include <QString>
+
+namespace mixxx {
+
+/// Keeps the engine threads and the background threads on separate CPU
+/// cores. Analysis and decoding threads that share a core with the audio
+/// callback, or its SMT sibling, delay the callback and cause xruns.
+///
+/// The engine cores are configured by [App],engine_cpu_cores as a list
+/// like "3" or "2-3,6", ideally cores that are isolated from the
+/// scheduler. The background threads use all other cores except the SMT
+/// siblings of the engine cores. Without configured engine cores all
+/// threads may run on all cores.
+///
+/// Only implemented on Linux.
+class CpuAffinity final {
+  public:
+    enum class ThreadRole {
+        /// The audio callback and the engine workers
+        Engine,
+        /// Threads that feed the engine or run batch jobs
+        Background,
+    };
+
+    /// Must be invoked once during startup before the affected threads
+    /// are started.
+    static void configure(const QString& engineCoreList);
+
+    /// Parses a list of core numbers and ranges. Returns an empty list if
+    /// the list is empty or invalid.
+    static QList<int> parseCoreList(const QString& coreList);
+
+    /// The configured engine cores, empty if not configured.
+    static const QList<int>& engineCores();
+
+    /// Restricts the calling thread to the cores of its role. Returns false
+    /// if no cores are configured or the affinity could not be set.
+    static bool applyToCurrentThread(ThreadRole role);
+
+  private:
+    CpuAffinity() = delete;
+};
+
+} // namespace mixxx
@@ -1,5 +1,6 @@
 #include <QSqlDriver>
 #include <QSqlError>
+#include <QSqlQuery>
 
 #ifdef __SQLITE3__
 #include <sqlite3.h>
@@ -190,6 +191,10 @@ int sqliteStringCompareUTF16(void* pArg,
 
 const char kLexicographicalCollationFunc[] = "mixxxLexicographicalCollationFunc";
 
+void deleteCachedPattern(void* pPattern) {
+    delete static_cast<QString*>(pPattern);
+}
+
 // This implements the like() SQL function. This is used by the LIKE operator.
 // The SQL statement 'A LIKE B' is implemented as 'like(B, A)', and if there is
 // an escape character, say E, it is implemented as 'like(B, A, E)'
@@ -210,8 +215,21 @@ void sqliteLikeUtf8(sqlite3_context* context,
         return;
     }
 
-    QString stringB = QString::fromUtf8(b); // Like String
-    QString stringA = QString::fromUtf8(a);
+    // The pattern is normalized only once per statement, because it is
+    // usually a constant. SQLite keeps the auxiliary data of a constant
+    // argument between the invocations.
+    QString pattern; // Like String
+    const auto* pCachedPattern = static_cast<const QString*>(
+            sqlite3_get_auxdata(context, 0));
+    if (pCachedPattern) {
+        pattern = *pCachedPattern;
+    } else {
+        pattern = QString::fromUtf8(b);
+        DbConnection::makeStringLatinLow(&pattern);
+        sqlite3_set_auxdata(context, 0, new QString(pattern), deleteCachedPattern);
+    }
+    QString string = QString::fromUtf8(a);
+    DbConnection::makeStringLatinLow(&string);
 
     QChar esc = kSqlLikeEscapeDefault;
     if (aArgc == 3) {
@@ -225,11 +243,25 @@ void sqliteLikeUtf8(sqlite3_context* context,
         }
     }
 
-    int ret = DbConnection::likeCompareLatinLow(&stringB, &stringA, esc);
+    int ret = likeCompareInner(
+            pattern.constData(), pattern.length(),
+            string.constData(), string.length(),
+            esc);
     sqlite3_result_int64(context, ret);
     return;
 }
 
+// Aborts the current statement if the flag is set
+int sqliteProgressInterrupt(void* pContext) {
+    const auto* pInterrupt = static_cast<const std::atomic<bool>*>(pContext);
+    return pInterrupt->load(std::memory_order_relaxed) ? 1 : 0;
+}
+
+// The progress handler is invoked after this number of virtual machine
+// instructions. It needs to be small enough to abort long running queries
+// quickly, but should not affect their performance.
+constexpr int kProgressInterruptInstructions = 10000;
+
 #endif // __SQLITE3__
 
 bool initDatabase(const QSqlDatabase& database, mixxx::StringCollator* pCollator) {
@@ -316,13 +348,15 @@ bool initDatabase(const QSqlDatabase& database, mixxx::StringCollator* pCollator
 DbConnection::DbConnection(
         const Params& params,
         const QString& connectionName)
-    : m_sqlDatabase(createDatabase(params, connectionName)) {
+    : m_sqlDatabase(createDatabase(params, connectionName)),
+      m_pragmas(params.pragmas) {
 }
 
 DbConnection::DbConnection(
         const DbConnection& prototype,
         const QString& connectionName)
-    : m_sqlDatabase(cloneDatabase(prototype.m_sqlDatabase, connectionName)) {
+    : m_sqlDatabase(cloneDatabase(prototype.m_sqlDatabase, connectionName)),
+      m_pragmas(prototype.m_pragmas) {
 }
 
 DbConnection::~DbConnection() {
@@ -350,6 +384,18 @@ bool DbConnection::open() {
         m_sqlDatabase.close();
         return false; // abort
     }
+    for (const auto& pragma : std::as_const(m_pragmas)) {
+        QSqlQuery query(m_sqlDatabase);
+        if (!query.exec(QStringLiteral("PRAGMA ") + pragma)) {
+            // Not fatal, the connection is still usable
+            kLogger.warning()
+                    << "Failed to apply"
+                    << pragma
+                    << "to database connection"
+                    << *this
+                    << query.lastError();
+        }
+    }
     return true;
 }
 
@@ -381,6 +427,34 @@ QString DbConnection::collateLexicographically(const QString& orderByQuery) {
 #endif //  __SQLITE3__
 }
 
+//static
+void DbConnection::setInterruptFlag(
+        const QSqlDatabase& database,
+        const std::atomic<bool>* pInterrupt) {
+#ifdef __SQLITE3__
+    QVariant v = database.driver()->handle();
+    VERIFY_OR_DEBUG_ASSERT(v.isValid() && strcmp(v.typeName(), "sqlite3*") == 0) {
+        return;
+    }
+    sqlite3* handle = *static_cast<sqlite3**>(v.data());
+    VERIFY_OR_DEBUG_ASSERT(handle != nullptr) {
+        return;
+    }
+    if (pInterrupt) {
+        sqlite3_progress_handler(
+                handle,
+                kProgressInterruptInstructions,
+                sqliteProgressInterrupt,
+                const_cast<std::atomic<bool>*>(pInterrupt));
+    } else {
+        sqlite3_progress_handler(handle, 0, nullptr, nullptr);
+    }
+#else
+    Q_UNUSED(database);
+    Q_UNUSED(pInterrupt);
+#endif // __SQLITE3__
+}
+
 //static
 int DbConnection::likeCompareLatinLow(
         QString* pattern,
@@ -1,7 +1,9 @@
 #pragma once
 
 #include <QSqlDatabase>
+#include <QStringList>
 #include <QtDebug>
+#include <atomic>
 
 #include "util/string.h"
 
@@ -22,6 +24,13 @@ class DbConnection final {
 
     static void makeStringLatinLow(QString* string);
 
+    // Aborts all statements of the connection that are executing while
+    // the flag is set, e.g. from another thread. The flag must outlive
+    // the statements or until it is reset by passing nullptr.
+    static void setInterruptFlag(
+            const QSqlDatabase& database,
+            const std::atomic<bool>* pInterrupt);
+
     struct Params {
         QString type;
         QString connectOptions;
@@ -29,6 +38,9 @@ class DbConnection final {
         QString filePath;
         QString userName;
         QString password;
+        // Settings that are applied to each connection after opening
+        // it, e.g. "journal_mode=WAL" for "PRAGMA journal_mode=WAL"
+        QStringList pragmas;
     };
 
     // All constructors are reserved for DbConnectionPool!!
@@ -62,6 +74,7 @@ class DbConnection final {
     DbConnection(const DbConnection&&) = delete;
 
     QSqlDatabase m_sqlDatabase;
+    QStringList m_pragmas;
     mixxx::StringCollator m_collator;
 };
 
@@ -1,5 +1,8 @@
 #include "util/db/dbconnectionpool.h"
 
+#include <QSqlError>
+#include <QSqlQuery>
+
 #include "util/logger.h"
 
 
@@ -11,7 +14,7 @@ const Logger kLogger("DbConnectionPool");
 
 } // anonymous namespace
 
-bool DbConnectionPool::createThreadLocalConnection() {
+bool DbConnectionPool::createThreadLocalConnection(AccessMode accessMode) {
     VERIFY_OR_DEBUG_ASSERT(!m_threadLocalConnections.hasLocalData()) {
         DEBUG_ASSERT(m_threadLocalConnections.localData());
         kLogger.critical()
@@ -32,12 +35,24 @@ bool DbConnectionPool::createThreadLocalConnection() {
                 << *pConnection;
         return false; // abort
     }
+    if (accessMode == AccessMode::ReadOnly) {
+        QSqlQuery query(*pConnection);
+        if (!query.exec(QStringLiteral("PRAGMA query_only=ON"))) {
+            kLogger.critical()
+                    << "Failed to make thread-local database connection read-only"
+                    << *pConnection
+                    << query.lastError();
+            return false; // abort
+        }
+    }
     m_threadLocalConnections.setLocalData(pConnection.get()); // transfer ownership
     pConnection.release(); // release ownership
     DEBUG_ASSERT(m_threadLocalConnections.hasLocalData());
     DEBUG_ASSERT(m_threadLocalConnections.localData());
     kLogger.info()
-            << "Cloned thread-local database connection"
+            << "Cloned thread-local"
+            << (accessMode == AccessMode::ReadOnly ? "read-only" : "read-write")
+            << "database connection"
             << *m_threadLocalConnections.localData();
     return true;
 }
@@ -15,6 +15,15 @@ typedef std::shared_ptr<DbConnectionPool> DbConnectionPoolPtr;
 
 class DbConnectionPool final {
   public:
+    enum class AccessMode {
+        ReadWrite,
+        // The connection is opened with "PRAGMA query_only" and any
+        // statement that modifies the database fails. Intended for worker
+        // threads that only read from the database, e.g. while another
+        // thread is writing.
+        ReadOnly,
+    };
+
     // Creates a new pool of database connections (one per thread) that
     // all use the same connection parameters. Unique connection names
     // will be generated based on the given connection name that serves
@@ -34,7 +43,8 @@ class DbConnectionPool final {
     // Prefer to use DbConnectionPooler instead of the
     // following functions. Only if there is no appropriate
     // scoping possible then use these functions directly.
-    bool createThreadLocalConnection();
+    bool createThreadLocalConnection(
+            AccessMode accessMode = AccessMode::ReadWrite);
     void destroyThreadLocalConnection();
 
   private:
@@ -9,6 +9,9 @@ namespace mixxx {
 // upon construction and will be closed and removed from the pool upon
 // destruction.
 //
+// Threads that only read from the database should request a read-only
+// connection, which is guaranteed to never modify the database.
+//
 // Ultimately upon termination of a thread the corresponding connection
 // would also be closed and removed implicitly by the pool, but that
 // should never happen! Therefore this class should always be allocated
@@ -17,7 +20,9 @@ namespace mixxx {
 class DbConnectionPooler final {
   public:
     explicit DbConnectionPooler(
-            DbConnectionPoolPtr pDbConnectionPool = DbConnectionPoolPtr());
+            DbConnectionPoolPtr pDbConnectionPool = DbConnectionPoolPtr(),
+            DbConnectionPool::AccessMode accessMode =
+                    DbConnectionPool::AccessMode::ReadWrite);
     DbConnectionPooler(const DbConnectionPooler&) = delete;
     DbConnectionPooler(DbConnectionPooler&&) = default;
     ~DbConnectionPooler();
@@ -44,3 +44,36 @@
 #define _MM_GET_DENORMALS_ZERO_MODE()
 
 #endif
+
+#include <cfloat>
+#include <cstdint>
+
+namespace mixxx {
+
+// Enables the flush to zero and the denormals are zero mode for the calling
+// thread. The decaying tails of filters, echoes and reverbs otherwise end up
+// in the denormal range, where each operation is many times slower. The
+// mode is per thread and must be enabled by every thread that runs DSP code.
+inline void enableDenormalsAreZero() {
+#ifdef __SSE__
+    _MM_SET_DENORMALS_ZERO_MODE(_MM_DENORMALS_ZERO_ON);
+    _MM_SET_FLUSH_ZERO_MODE(_MM_FLUSH_ZERO_ON);
+#endif
+#if defined(__aarch64__)
+    // Bit 24 of the Floating-point Control Register enables flush to zero
+    int64_t fpcr;
+    asm volatile("mrs %[fpcr], FPCR"
+                 : [ fpcr ] "=r"(fpcr));
+    asm volatile("msr FPCR, %[src]"
+                 :
+                 : [ src ] "r"(fpcr | (1 << 24)));
+#endif
+}
+
+// Returns true if denormals are flushed to zero on the calling thread
+inline bool denormalsAreZero() {
+    volatile double doubleMin = DBL_MIN; // the smallest normalized double
+    return doubleMin / 2 == 0.0;
+}
+
+} // namespace mixxx
@@ -1,69 +1,178 @@
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
 #include "pa_ringbuffer.h"
 
 #include "util/class.h"
 #include "util/math.h"
 
+/// A lock-free ring buffer for a single reader and a single writer thread.
+///
+/// The read and the write index live on cache lines of their own, and each
+/// side caches the index of the other side, which is only reloaded when the
+/// cached value suggests that the buffer is empty or full. The reader and
+/// the writer don't invalidate each others cache lines with every access.
+///
+/// Like PortAudio's PaUtilRingBuffer the indexes run modulo twice the
+/// size, so that a full buffer can be told from an empty one.
 template <class DataType>
 class FIFO {
   public:
     explicit FIFO(int size)
-            : m_data(roundUpToPowerOf2(size)) {
-        // If we can't represent the next higher power of 2 then bail.
-        if (m_data.size() == 0) {
-            return;
-        }
-        PaUtil_InitializeRingBuffer(&m_ringBuffer,
-                static_cast<ring_buffer_size_t>(sizeof(DataType)),
-                static_cast<ring_buffer_size_t>(m_data.size()),
-                m_data.data());
+            : m_data(roundUpToPowerOf2(size)),
+              m_size(static_cast<ring_buffer_size_t>(m_data.size())),
+              m_smallMask(m_size - 1),
+              m_bigMask(2 * m_size - 1),
+              m_writeIndex(0),
+              m_cachedReadIndex(0),
+              m_readIndex(0),
+              m_cachedWriteIndex(0) {
+        static_assert(std::is_trivially_copyable_v<DataType>,
+                "FIFO elements are copied bytewise");
+        // If we can't represent the next higher power of 2 the FIFO stays
+        // empty and refuses all writes.
     }
     virtual ~FIFO() {
     }
     int readAvailable() const {
-        return PaUtil_GetRingBufferReadAvailable(&m_ringBuffer);
+        return (m_writeIndex.load(std::memory_order_acquire) -
+                       m_readIndex.load(std::memory_order_relaxed)) &
+                m_bigMask;
     }
     int writeAvailable() const {
-        return PaUtil_GetRingBufferWriteAvailable(&m_ringBuffer);
+        return m_size -
+                ((m_writeIndex.load(std::memory_order_relaxed) -
+                         m_readIndex.load(std::memory_order_acquire)) &
+                        m_bigMask);
     }
     int read(DataType* pData, int count) {
-        return PaUtil_ReadRingBuffer(&m_ringBuffer, pData, count);
+        DataType* pData1;
+        ring_buffer_size_t size1;
+        DataType* pData2;
+        ring_buffer_size_t size2;
+        const int available = aquireReadRegions(count, &pData1, &size1, &pData2, &size2);
+        std::copy_n(pData1, size1, pData);
+        std::copy_n(pData2, size2, pData + size1);
+        releaseReadRegions(available);
+        return available;
     }
     int write(const DataType* pData, int count) {
-        return PaUtil_WriteRingBuffer(&m_ringBuffer, pData, count);
+        DataType* pData1;
+        ring_buffer_size_t size1;
+        DataType* pData2;
+        ring_buffer_size_t size2;
+        const int available = aquireWriteRegions(count, &pData1, &size1, &pData2, &size2);
+        std::copy_n(pData, size1, pData1);
+        std::copy_n(pData + size1, size2, pData2);
+        releaseWriteRegions(available);
+        return available;
     }
+    /// Waits for the reader while the buffer is full. Must not be used by
+    /// real-time threads.
     void writeBlocking(const DataType* pData, int count) {
         int written = 0;
         while (written < count) {
-            written += write(pData + written, count - written);
+            const int chunk = write(pData + written, count - written);
+            if (chunk == 0) {
+                // Give the reader a chance to run instead of spinning
+                std::this_thread::yield();
+            }
+            written += chunk;
         }
     }
+    /// Returns the contiguous regions that can be written, which are
+    /// published by releaseWriteRegions().
     int aquireWriteRegions(int count,
             DataType** dataPtr1, ring_buffer_size_t* sizePtr1,
             DataType** dataPtr2, ring_buffer_size_t* sizePtr2) {
-        return PaUtil_GetRingBufferWriteRegions(&m_ringBuffer, count,
-                (void**)dataPtr1, sizePtr1, (void**)dataPtr2, sizePtr2);
+        const ring_buffer_size_t writeIndex =
+                m_writeIndex.load(std::memory_order_relaxed);
+        ring_buffer_size_t available =
+                m_size - ((writeIndex - m_cachedReadIndex) & m_bigMask);
+        if (available < count) {
+            m_cachedReadIndex = m_readIndex.load(std::memory_order_acquire);
+            available = m_size - ((writeIndex - m_cachedReadIndex) & m_bigMask);
+        }
+        return regions(writeIndex, std::min<ring_buffer_size_t>(count, available),
+                dataPtr1, sizePtr1, dataPtr2, sizePtr2);
     }
     int releaseWriteRegions(int count) {
-        return PaUtil_AdvanceRingBufferWriteIndex(&m_ringBuffer, count);
+        const ring_buffer_size_t writeIndex =
+                (m_writeIndex.load(std::memory_order_relaxed) + count) & m_bigMask;
+        m_writeIndex.store(writeIndex, std::memory_order_release);
+        return writeIndex;
     }
+    /// Returns the contiguous regions that can be read, which are released
+    /// for writing by releaseReadRegions().
     int aquireReadRegions(int count,
             DataType** dataPtr1, ring_buffer_size_t* sizePtr1,
             DataType** dataPtr2, ring_buffer_size_t* sizePtr2) {
-        return PaUtil_GetRingBufferReadRegions(&m_ringBuffer, count,
-                (void**)dataPtr1, sizePtr1, (void**)dataPtr2, sizePtr2);
+        const ring_buffer_size_t readIndex =
+                m_readIndex.load(std::memory_order_relaxed);
+        ring_buffer_size_t available = (m_cachedWriteIndex - readIndex) & m_bigMask;
+        if (available < count) {
+            m_cachedWriteIndex = m_writeIndex.load(std::memory_order_acquire);
+            available = (m_cachedWriteIndex - readIndex) & m_bigMask;
+        }
+        return regions(readIndex, std::min<ring_buffer_size_t>(count, available),
+                dataPtr1, sizePtr1, dataPtr2, sizePtr2);
     }
     int releaseReadRegions(int count) {
-        return PaUtil_AdvanceRingBufferReadIndex(&m_ringBuffer, count);
+        const ring_buffer_size_t readIndex =
+                (m_readIndex.load(std::memory_order_relaxed) + count) & m_bigMask;
+        m_readIndex.store(readIndex, std::memory_order_release);
+        return readIndex;
     }
     int flushReadData(int count) {
         int flush = math_min(readAvailable(), count);
-        return PaUtil_AdvanceRingBufferReadIndex(&m_ringBuffer, flush);
+        return releaseReadRegions(flush);
     }
 
   private:
+    // Cache line size of all common desktop CPUs
+    static constexpr std::size_t kCacheLineSize = 64;
+
+    int regions(ring_buffer_size_t index,
+            ring_buffer_size_t count,
+            DataType** dataPtr1,
+            ring_buffer_size_t* sizePtr1,
+            DataType** dataPtr2,
+            ring_buffer_size_t* sizePtr2) {
+        const ring_buffer_size_t offset = index & m_smallMask;
+        if (offset + count > m_size) {
+            // The regions wrap around the end of the buffer
+            const ring_buffer_size_t firstHalf = m_size - offset;
+            *dataPtr1 = m_data.data() + offset;
+            *sizePtr1 = firstHalf;
+            *dataPtr2 = m_data.data();
+            *sizePtr2 = count - firstHalf;
+        } else {
+            *dataPtr1 = m_data.data() + offset;
+            *sizePtr1 = count;
+            *dataPtr2 = nullptr;
+            *sizePtr2 = 0;
+        }
+        return count;
+    }
+
     std::vector<DataType> m_data;
-    PaUtilRingBuffer m_ringBuffer;
+    const ring_buffer_size_t m_size;
+    const ring_buffer_size_t m_smallMask;
+    const ring_buffer_size_t m_bigMask;
+
+    // Written by the writer
+    alignas(kCacheLineSize) std::atomic<ring_buffer_size_t> m_writeIndex;
+    ring_buffer_size_t m_cachedReadIndex;
+
+    // Written by the reader
+    alignas(kCacheLineSize) std::atomic<ring_buffer_size_t> m_readIndex;
+    ring_buffer_size_t m_cachedWriteIndex;
+
     DISALLOW_COPY_AND_ASSIGN(FIFO);
 };
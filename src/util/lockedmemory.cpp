@@ -0,0 +1,176 @@
+#include "util/lockedmemory.h"
+
+#include <QHash>
+#include <QMutex>
+#include <atomic>
+#include <cstring>
+
+#ifdef __LINUX__
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+#include "util/assert.h"
+#include "util/compatibility/qmutex.h"
+#include "util/logger.h"
+
+namespace mixxx {
+
+namespace {
+
+const Logger kLogger("LockedMemory");
+
+#ifdef __LINUX__
+// The size of huge pages on x86-64 and most ARM64 kernels
+constexpr std::size_t kHugePageSize = 2 * 1024 * 1024;
+
+struct Mapping {
+    std::size_t bytes;
+    bool locked;
+    bool hugePages;
+};
+
+QMutex s_mappingsMutex;
+QHash<void*, Mapping> s_mappings;
+
+std::atomic<std::size_t> s_hugePageBytes(0);
+
+constexpr std::size_t roundUp(std::size_t bytes, std::size_t alignment) {
+    return (bytes + alignment - 1) / alignment * alignment;
+}
+#endif
+
+std::atomic<bool> s_enabled(false);
+std::atomic<std::size_t> s_lockedBytes(0);
+
+} // anonymous namespace
+
+// static
+void LockedMemory::setEnabled(bool enabled) {
+#ifdef __LINUX__
+    s_enabled.store(enabled, std::memory_order_relaxed);
+#else
+    if (enabled) {
+        kLogger.warning() << "Locking memory is not supported on this platform";
+    }
+#endif
+}
+
+// static
+bool LockedMemory::isEnabled() {
+    return s_enabled.load(std::memory_order_relaxed);
+}
+
+// static
+void* LockedMemory::allocate(std::size_t bytes) {
+#ifdef __LINUX__
+    if (!isEnabled() || bytes == 0) {
+        return nullptr;
+    }
+    std::size_t mappedBytes = 0;
+    void* pMemory = MAP_FAILED;
+    bool hugePages = false;
+    if (bytes >= kHugePageSize) {
+        // Explicit huge pages are only available if they have been reserved
+        mappedBytes = roundUp(bytes, kHugePageSize);
+        pMemory = mmap(nullptr,
+                mappedBytes,
+                PROT_READ | PROT_WRITE,
+                MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB,
+                -1,
+                0);
+        hugePages = pMemory != MAP_FAILED;
+    }
+    if (pMemory == MAP_FAILED) {
+        mappedBytes = roundUp(bytes, static_cast<std::size_t>(sysconf(_SC_PAGESIZE)));
+        pMemory = mmap(nullptr,
+                mappedBytes,
+                PROT_READ | PROT_WRITE,
+                MAP_PRIVATE | MAP_ANONYMOUS,
+                -1,
+                0);
+        if (pMemory == MAP_FAILED) {
+            kLogger.warning() << "Failed to map" << bytes << "bytes";
+            return nullptr;
+        }
+        if (bytes >= kHugePageSize) {
+            // Transparent huge pages, if enabled for madvise()
+            hugePages = madvise(pMemory, mappedBytes, MADV_HUGEPAGE) == 0;
+        }
+    }
+    // Locking faults in all pages
+    const bool locked = mlock(pMemory, mappedBytes) == 0;
+    if (locked) {
+        s_lockedBytes.fetch_add(mappedBytes, std::memory_order_relaxed);
+    } else {
+        kLogger.warning() << "Failed to lock" << mappedBytes / 1024
+                          << "KiB, the limit RLIMIT_MEMLOCK might be too low";
+        // At least avoid the page faults of the first access
+        std::memset(pMemory, 0, mappedBytes);
+    }
+    if (hugePages) {
+        s_hugePageBytes.fetch_add(mappedBytes, std::memory_order_relaxed);
+    }
+    const auto locker = lockMutex(&s_mappingsMutex);
+    s_mappings.insert(pMemory, Mapping{mappedBytes, locked, hugePages});
+    return pMemory;
+#else
+    Q_UNUSED(bytes);
+    return nullptr;
+#endif
+}
+
+// static
+void LockedMemory::free(void* pMemory) {
+#ifdef __LINUX__
+    if (!pMemory) {
+        return;
+    }
+    Mapping mapping;
+    {
+        const auto locker = lockMutex(&s_mappingsMutex);
+        const auto it = s_mappings.constFind(pMemory);
+        VERIFY_OR_DEBUG_ASSERT(it != s_mappings.constEnd()) {
+            return;
+        }
+        mapping = it.value();
+        s_mappings.erase(it);
+    }
+    if (mapping.locked) {
+        s_lockedBytes.fetch_sub(mapping.bytes, std::memory_order_relaxed);
+    }
+    if (mapping.hugePages) {
+        s_hugePageBytes.fetch_sub(mapping.bytes, std::memory_order_relaxed);
+    }
+    munmap(pMemory, mapping.bytes);
+#else
+    Q_UNUSED(pMemory);
+#endif
+}
+
+// static
+std::size_t LockedMemory::lockedBytes() {
+    return s_lockedBytes.load(std::memory_order_relaxed);
+}
+
+// static
+void LockedMemory::logStatistics() {
+    if (!isEnabled()) {
+        return;
+    }
+#ifdef __LINUX__
+    struct rlimit limits;
+    const bool hasLimit = getrlimit(RLIMIT_MEMLOCK, &limits) == 0 &&
+            limits.rlim_cur != RLIM_INFINITY;
+    auto log = kLogger.info();
+    log << "Locked" << lockedBytes() / 1024 << "KiB of engine memory,"
+        << s_hugePageBytes.load(std::memory_order_relaxed) / 1024
+        << "KiB allocated with huge pages";
+    if (hasLimit) {
+        log << "- limit" << limits.rlim_cur / 1024 << "KiB";
+    }
+#endif
+}
+
+} // namespace mixxx
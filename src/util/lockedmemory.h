@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+
+namespace mixxx {
+
+/// Memory that is locked into RAM and backed by huge pages if available,
+/// for large buffers that are accessed by the engine like the chunks of
+/// the CachingReader. Page faults of swapped out or not yet touched pages
+/// and the TLB misses of large buffers cause latency spikes in the
+/// callback thread.
+///
+/// Disabled by default, because the amount of locked memory is limited
+/// by RLIMIT_MEMLOCK. Enabled by [App],lock_engine_memory. Only
+/// implemented on Linux.
+class LockedMemory final {
+  public:
+    /// Must be invoked once during startup before any memory is allocated.
+    static void setEnabled(bool enabled);
+    static bool isEnabled();
+
+    /// Allocates page aligned memory, all pages are touched before
+    /// returning. Returns nullptr if disabled or if the allocation fails,
+    /// the caller must then fall back to a regular allocation.
+    static void* allocate(std::size_t bytes);
+    /// Frees memory allocated by allocate()
+    static void free(void* pMemory);
+
+    /// The number of bytes that are currently locked
+    static std::size_t lockedBytes();
+
+    /// Logs the locked memory and the limit of the process
+    static void logStatistics();
+
+  private:
+    LockedMemory() = delete;
+};
+
+} // namespace mixxx
@@ -0,0 +1,264 @@
+#include "util/oversampler.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "util/assert.h"
+#include "util/math.h"
+#include "util/sample.h"
+
+namespace mixxx {
+
+namespace {
+
+// The first stage has a steep filter with a transition band from about
+// 0.41 to 0.59 times the original sample rate.
+constexpr int kFirstStageHalfLength = 16;
+// The signal that is upsampled by the second stage has almost no content
+// above half of the original sample rate, so the transition band can be
+// wider.
+constexpr int kSecondStageHalfLength = 6;
+
+} // anonymous namespace
+
+HalfbandResampler::HalfbandResampler(int halfLength, SINT maxSamples)
+        : m_halfLength(halfLength),
+          m_maxSamples(maxSamples),
+          m_coefficients(2 * halfLength),
+          m_filterHistory(2 * halfLength - 1 + maxSamples),
+          m_delayHistory(halfLength + maxSamples),
+          m_filterOutput(maxSamples) {
+    DEBUG_ASSERT(halfLength > 0);
+    // Windowed sinc with the cutoff at a quarter of the higher sample rate.
+    // The taps at the odd offsets from the center are non-zero and the
+    // center is 0.5.
+    const int numTaps = 4 * halfLength - 1;
+    double sum = 0;
+    std::vector<double> taps(halfLength);
+    for (int k = 0; k < halfLength; ++k) {
+        const double offset = 2 * k + 1;
+        const double sinc = (k % 2 == 0 ? 1.0 : -1.0) / (M_PI * offset);
+        // Blackman window that reaches zero next to the outermost taps
+        const double phase = 2 * M_PI * offset / (numTaps + 1);
+        const double window = 0.42 + 0.5 * std::cos(phase) + 0.08 * std::cos(2 * phase);
+        taps[k] = sinc * window;
+        sum += 2 * taps[k];
+    }
+    // Normalize to unity gain at DC and scale the taps by 2 to compensate
+    // the zeros that are inserted by upsampling
+    for (int k = 0; k < halfLength; ++k) {
+        const auto coefficient = static_cast<CSAMPLE_GAIN>(taps[k] / sum);
+        m_coefficients[halfLength + k] = coefficient;
+        m_coefficients[halfLength - 1 - k] = coefficient;
+    }
+}
+
+void HalfbandResampler::reset() {
+    std::fill(m_filterHistory.begin(), m_filterHistory.end(), CSAMPLE_ZERO);
+    std::fill(m_delayHistory.begin(), m_delayHistory.end(), CSAMPLE_ZERO);
+}
+
+void HalfbandResampler::filter(CSAMPLE* pOutput,
+        const CSAMPLE* pHistory,
+        CSAMPLE_GAIN gain,
+        SINT numSamples) const {
+    // The loop over the samples is the inner one, so that it is vectorized
+    // without reordering the additions.
+    for (int i = 0; i < 2 * m_halfLength; ++i) {
+        const CSAMPLE_GAIN coefficient = gain * m_coefficients[i];
+        const CSAMPLE* pTapHistory = pHistory + i;
+        // note: LOOP VECTORIZED.
+        for (SINT n = 0; n < numSamples; ++n) {
+            pOutput[n] += coefficient * pTapHistory[n];
+        }
+    }
+}
+
+void HalfbandResampler::upsample(
+        const CSAMPLE* pInput, CSAMPLE* pOutput, SINT numSamples) {
+    VERIFY_OR_DEBUG_ASSERT(numSamples <= m_maxSamples) {
+        numSamples = m_maxSamples;
+    }
+    if (numSamples <= 0) {
+        return;
+    }
+    const SINT historySize = 2 * m_halfLength - 1;
+    CSAMPLE* pHistory = m_filterHistory.data();
+    SampleUtil::copy(pHistory + historySize, pInput, numSamples);
+
+    SampleUtil::clear(m_filterOutput.data(), numSamples);
+    filter(m_filterOutput.data(), pHistory, 1.0f, numSamples);
+    // The other branch is the input delayed by halfLength - 1 samples
+    SampleUtil::interleaveBuffer(pOutput,
+            m_filterOutput.data(),
+            pHistory + m_halfLength,
+            numSamples);
+
+    std::copy(pHistory + numSamples,
+            pHistory + numSamples + historySize,
+            pHistory);
+}
+
+void HalfbandResampler::downsample(
+        const CSAMPLE* pInput, CSAMPLE* pOutput, SINT numSamples) {
+    VERIFY_OR_DEBUG_ASSERT(numSamples <= m_maxSamples) {
+        numSamples = m_maxSamples;
+    }
+    if (numSamples <= 0) {
+        return;
+    }
+    const SINT filterHistorySize = 2 * m_halfLength - 1;
+    const SINT delayHistorySize = m_halfLength;
+    CSAMPLE* pFilterHistory = m_filterHistory.data();
+    CSAMPLE* pDelayHistory = m_delayHistory.data();
+    SampleUtil::deinterleaveBuffer(pFilterHistory + filterHistorySize,
+            pDelayHistory + delayHistorySize,
+            pInput,
+            numSamples);
+
+    SampleUtil::copyWithGain(pOutput, pDelayHistory, 0.5f, numSamples);
+    filter(pOutput, pFilterHistory, 0.5f, numSamples);
+
+    std::copy(pFilterHistory + numSamples,
+            pFilterHistory + numSamples + filterHistorySize,
+            pFilterHistory);
+    std::copy(pDelayHistory + numSamples,
+            pDelayHistory + numSamples + delayHistorySize,
+            pDelayHistory);
+}
+
+Oversampler::Channel::Channel(SINT maxFrames)
+        : firstUpsampler(kFirstStageHalfLength, maxFrames),
+          secondUpsampler(kSecondStageHalfLength, 2 * maxFrames),
+          secondDownsampler(kSecondStageHalfLength, 2 * maxFrames),
+          firstDownsampler(kFirstStageHalfLength, maxFrames),
+          delayedSample(CSAMPLE_ZERO),
+          buffer1(maxFrames * kMaxFactor),
+          buffer2(maxFrames * kMaxFactor) {
+}
+
+void Oversampler::Channel::reset() {
+    firstUpsampler.reset();
+    secondUpsampler.reset();
+    secondDownsampler.reset();
+    firstDownsampler.reset();
+    delayedSample = CSAMPLE_ZERO;
+}
+
+Oversampler::Oversampler(SINT maxFrames)
+        : m_maxFrames(maxFrames),
+          m_factor(1),
+          m_left(maxFrames),
+          m_right(maxFrames) {
+}
+
+// static
+SINT Oversampler::latencyFrames(int factor) {
+    switch (factor) {
+    case 2:
+        return 2 * kFirstStageHalfLength - 1;
+    case 4:
+        // The second stage has a latency of 2 * kSecondStageHalfLength - 1
+        // samples at twice the original sample rate, which is rounded up to
+        // whole frames by delaying the output of the second stage by one
+        // sample.
+        return 2 * kFirstStageHalfLength - 1 + kSecondStageHalfLength;
+    default:
+        return 0;
+    }
+}
+
+void Oversampler::setFactor(int factor) {
+    VERIFY_OR_DEBUG_ASSERT(factor == 1 || factor == 2 || factor == 4) {
+        factor = 1;
+    }
+    if (factor != m_factor) {
+        m_factor = factor;
+        reset();
+    }
+}
+
+void Oversampler::reset() {
+    m_left.reset();
+    m_right.reset();
+}
+
+void Oversampler::upsample(const CSAMPLE* pInput, CSAMPLE* pOutput, SINT numFrames) {
+    VERIFY_OR_DEBUG_ASSERT(numFrames <= m_maxFrames) {
+        numFrames = m_maxFrames;
+    }
+    if (m_factor == 1) {
+        SampleUtil::copy(pOutput, pInput, numFrames * 2);
+        return;
+    }
+
+    SampleUtil::deinterleaveBuffer(
+            m_left.buffer1.data(), m_right.buffer1.data(), pInput, numFrames);
+    for (Channel* pChannel : {&m_left, &m_right}) {
+        pChannel->firstUpsampler.upsample(
+                pChannel->buffer1.data(), pChannel->buffer2.data(), numFrames);
+        if (m_factor == 4) {
+            pChannel->secondUpsampler.upsample(pChannel->buffer2.data(),
+                    pChannel->buffer1.data(),
+                    2 * numFrames);
+        }
+    }
+    if (m_factor == 4) {
+        SampleUtil::interleaveBuffer(pOutput,
+                m_left.buffer1.data(),
+                m_right.buffer1.data(),
+                4 * numFrames);
+    } else {
+        SampleUtil::interleaveBuffer(pOutput,
+                m_left.buffer2.data(),
+                m_right.buffer2.data(),
+                2 * numFrames);
+    }
+}
+
+void Oversampler::downsample(const CSAMPLE* pInput, CSAMPLE* pOutput, SINT numFrames) {
+    VERIFY_OR_DEBUG_ASSERT(numFrames <= m_maxFrames) {
+        numFrames = m_maxFrames;
+    }
+    if (m_factor == 1) {
+        SampleUtil::copy(pOutput, pInput, numFrames * 2);
+        return;
+    }
+    if (numFrames <= 0) {
+        return;
+    }
+
+    SampleUtil::deinterleaveBuffer(m_left.buffer1.data(),
+            m_right.buffer1.data(),
+            pInput,
+            numFrames * m_factor);
+    for (Channel* pChannel : {&m_left, &m_right}) {
+        if (m_factor == 4) {
+            CSAMPLE* pBuffer = pChannel->buffer2.data();
+            pChannel->secondDownsampler.downsample(
+                    pChannel->buffer1.data(), pBuffer, 2 * numFrames);
+            const CSAMPLE lastSample = pBuffer[2 * numFrames - 1];
+            std::copy_backward(pBuffer, pBuffer + 2 * numFrames - 1, pBuffer + 2 * numFrames);
+            pBuffer[0] = pChannel->delayedSample;
+            pChannel->delayedSample = lastSample;
+            pChannel->firstDownsampler.downsample(
+                    pBuffer, pChannel->buffer1.data(), numFrames);
+        } else {
+            pChannel->firstDownsampler.downsample(
+                    pChannel->buffer1.data(), pChannel->buffer2.data(), numFrames);
+        }
+    }
+    if (m_factor == 4) {
+        SampleUtil::interleaveBuffer(pOutput,
+                m_left.buffer1.data(),
+                m_right.buffer1.data(),
+                numFrames);
+    } else {
+        SampleUtil::interleaveBuffer(pOutput,
+                m_left.buffer2.data(),
+                m_right.buffer2.data(),
+                numFrames);
+    }
+}
+
+} // namespace mixxx
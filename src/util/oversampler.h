@@ -0,0 +1,124 @@
+#pragma once
+
+#include <vector>
+
+#include "util/class.h"
+#include "util/types.h"
+
+namespace mixxx {
+
+/// Changes the sample rate of a mono signal by a factor of 2 with a linear
+/// phase halfband FIR filter. Every other tap of a halfband filter is zero,
+/// so the filter is split into two polyphase branches of which one is a
+/// plain delay.
+///
+/// The state of the filter is kept between the calls, so an instance must
+/// be used either for upsampling or for downsampling only. All buffers are
+/// allocated on construction, the other functions are real-time safe.
+class HalfbandResampler final {
+  public:
+    /// The filter has 4 * halfLength - 1 taps of which 2 * halfLength + 1 are
+    /// non-zero. maxSamples is the maximum number of samples at the lower
+    /// sample rate per call.
+    HalfbandResampler(int halfLength, SINT maxSamples);
+
+    /// The group delay in samples at the higher sample rate
+    SINT latency() const {
+        return 2 * m_halfLength - 1;
+    }
+
+    void reset();
+
+    /// Writes 2 * numSamples samples to pOutput
+    void upsample(const CSAMPLE* pInput, CSAMPLE* pOutput, SINT numSamples);
+
+    /// Reads 2 * numSamples samples from pInput
+    void downsample(const CSAMPLE* pInput, CSAMPLE* pOutput, SINT numSamples);
+
+  private:
+    /// Accumulates the filtered samples of the polyphase branch that is not
+    /// a delay, starting at pHistory, into pOutput
+    void filter(CSAMPLE* pOutput,
+            const CSAMPLE* pHistory,
+            CSAMPLE_GAIN gain,
+            SINT numSamples) const;
+
+    const int m_halfLength;
+    const SINT m_maxSamples;
+    // The 2 * halfLength taps of the filtering branch, scaled by 2
+    std::vector<CSAMPLE_GAIN> m_coefficients;
+    // The previous samples of each branch, followed by the current ones
+    std::vector<CSAMPLE> m_filterHistory;
+    std::vector<CSAMPLE> m_delayHistory;
+    std::vector<CSAMPLE> m_filterOutput;
+
+    DISALLOW_COPY_AND_ASSIGN(HalfbandResampler);
+};
+
+/// Upsamples an interleaved stereo signal by a factor of 2 or 4 for
+/// processing that generates harmonics above the Nyquist frequency, like
+/// waveshaping or quantization. Downsampling the processed signal removes
+/// these harmonics instead of aliasing them down into the audible range.
+///
+/// The factor 4 cascades two stages of HalfbandResampler, where the second
+/// stage may have fewer taps because the upsampled signal of the first
+/// stage does not need a steep filter.
+///
+/// All buffers are allocated on construction for buffers with up to
+/// maxFrames frames at the original sample rate, the other functions are
+/// real-time safe.
+class Oversampler final {
+  public:
+    static constexpr int kMaxFactor = 4;
+
+    explicit Oversampler(SINT maxFrames);
+
+    int factor() const {
+        return m_factor;
+    }
+
+    /// The factor must be 1, 2 or 4. Changing the factor discards the state
+    /// of the filters.
+    void setFactor(int factor);
+
+    /// The delay of downsample() after upsample() in frames at the original
+    /// sample rate
+    static SINT latencyFrames(int factor);
+    SINT latencyFrames() const {
+        return latencyFrames(m_factor);
+    }
+
+    void reset();
+
+    /// Writes numFrames * factor() frames to pOutput
+    void upsample(const CSAMPLE* pInput, CSAMPLE* pOutput, SINT numFrames);
+
+    /// Reads numFrames * factor() frames from pInput
+    void downsample(const CSAMPLE* pInput, CSAMPLE* pOutput, SINT numFrames);
+
+  private:
+    struct Channel {
+        Channel(SINT maxFrames);
+
+        void reset();
+
+        HalfbandResampler firstUpsampler;
+        HalfbandResampler secondUpsampler;
+        HalfbandResampler secondDownsampler;
+        HalfbandResampler firstDownsampler;
+        // The last sample of the second downsampler from the previous call
+        CSAMPLE delayedSample;
+        // Scratch buffers of maxFrames * kMaxFactor samples
+        std::vector<CSAMPLE> buffer1;
+        std::vector<CSAMPLE> buffer2;
+    };
+
+    const SINT m_maxFrames;
+    int m_factor;
+    Channel m_left;
+    Channel m_right;
+
+    DISALLOW_COPY_AND_ASSIGN(Oversampler);
+};
+
+} // namespace mixxx
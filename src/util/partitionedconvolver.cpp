@@ -0,0 +1,266 @@
+#include "util/partitionedconvolver.h"
+
+#include <dsp/transforms/FFT.h>
+
+#include <algorithm>
+
+#include "util/assert.h"
+
+namespace mixxx {
+
+namespace {
+
+constexpr SINT kHeadBlockSize = PartitionedConvolver::kHeadBlockSize;
+constexpr SINT kTailBlockSize = PartitionedConvolver::kTailBlockSize;
+
+// The output of a tail block is available one tail block after it has
+// been received, because its computation is split into the head blocks
+// of the next tail block. The head covers the impulse response until
+// then.
+constexpr SINT kHeadLength = 2 * kTailBlockSize;
+
+void transformPartitions(ConvolutionKernel::Partitions* pPartitions,
+        const CSAMPLE* pImpulseResponse,
+        SINT length,
+        SINT blockSize) {
+    pPartitions->count = static_cast<int>((length + blockSize - 1) / blockSize);
+    pPartitions->binCount = static_cast<int>(blockSize + 1);
+    pPartitions->real.resize(pPartitions->count * pPartitions->binCount);
+    pPartitions->imag.resize(pPartitions->count * pPartitions->binCount);
+    if (pPartitions->count == 0) {
+        return;
+    }
+
+    FFTReal fft(static_cast<int>(2 * blockSize));
+    std::vector<double> input(2 * blockSize);
+    std::vector<double> real(2 * blockSize);
+    std::vector<double> imag(2 * blockSize);
+    for (int partition = 0; partition < pPartitions->count; ++partition) {
+        // Zero-padded to the size of the transform
+        std::fill(input.begin(), input.end(), 0.0);
+        const SINT offset = partition * blockSize;
+        const SINT count = std::min(blockSize, length - offset);
+        std::copy(pImpulseResponse + offset,
+                pImpulseResponse + offset + count,
+                input.begin());
+        fft.forward(input.data(), real.data(), imag.data());
+        const int first = partition * pPartitions->binCount;
+        for (int bin = 0; bin < pPartitions->binCount; ++bin) {
+            pPartitions->real[first + bin] = static_cast<float>(real[bin]);
+            pPartitions->imag[first + bin] = static_cast<float>(imag[bin]);
+        }
+    }
+}
+
+} // anonymous namespace
+
+ConvolutionKernel::ConvolutionKernel(const CSAMPLE* pImpulseResponse, SINT length)
+        : m_length(length) {
+    transformPartitions(&m_head,
+            pImpulseResponse,
+            std::min(length, kHeadLength),
+            kHeadBlockSize);
+    transformPartitions(&m_tail,
+            pImpulseResponse + kHeadLength,
+            std::max(length - kHeadLength, static_cast<SINT>(0)),
+            kTailBlockSize);
+}
+
+PartitionedConvolver::Stage::Stage(SINT blockSize, int maxPartitionCount)
+        : m_blockSize(blockSize),
+          m_binCount(static_cast<int>(blockSize + 1)),
+          m_maxPartitionCount(maxPartitionCount),
+          m_delayLinePosition(0),
+          m_pFft(std::make_unique<FFTReal>(static_cast<int>(2 * blockSize))),
+          m_fftReal(2 * blockSize),
+          m_fftImag(2 * blockSize),
+          m_fftOutput(2 * blockSize),
+          m_delayLineReal(maxPartitionCount * m_binCount),
+          m_delayLineImag(maxPartitionCount * m_binCount),
+          m_accumulatorReal(m_binCount),
+          m_accumulatorImag(m_binCount) {
+    DEBUG_ASSERT(maxPartitionCount > 0);
+}
+
+PartitionedConvolver::Stage::~Stage() = default;
+
+void PartitionedConvolver::Stage::reset() {
+    std::fill(m_delayLineReal.begin(), m_delayLineReal.end(), 0.0f);
+    std::fill(m_delayLineImag.begin(), m_delayLineImag.end(), 0.0f);
+    clearAccumulator();
+    m_delayLinePosition = 0;
+}
+
+void PartitionedConvolver::Stage::transformInput(const double* pInput) {
+    m_pFft->forward(pInput, m_fftReal.data(), m_fftImag.data());
+    m_delayLinePosition = (m_delayLinePosition + 1) % m_maxPartitionCount;
+    float* pReal = &m_delayLineReal[m_delayLinePosition * m_binCount];
+    float* pImag = &m_delayLineImag[m_delayLinePosition * m_binCount];
+    for (int bin = 0; bin < m_binCount; ++bin) {
+        pReal[bin] = static_cast<float>(m_fftReal[bin]);
+        pImag[bin] = static_cast<float>(m_fftImag[bin]);
+    }
+}
+
+void PartitionedConvolver::Stage::clearAccumulator() {
+    std::fill(m_accumulatorReal.begin(), m_accumulatorReal.end(), 0.0f);
+    std::fill(m_accumulatorImag.begin(), m_accumulatorImag.end(), 0.0f);
+}
+
+void PartitionedConvolver::Stage::multiplyAccumulate(
+        const ConvolutionKernel::Partitions& partitions,
+        int first,
+        int end) {
+    VERIFY_OR_DEBUG_ASSERT(partitions.binCount == m_binCount) {
+        return;
+    }
+    end = std::min({end, partitions.count, m_maxPartitionCount});
+    float* pAccumulatorReal = m_accumulatorReal.data();
+    float* pAccumulatorImag = m_accumulatorImag.data();
+    for (int partition = first; partition < end; ++partition) {
+        // The input spectrum that has been received partition blocks ago
+        int position = m_delayLinePosition - partition;
+        if (position < 0) {
+            position += m_maxPartitionCount;
+        }
+        const float* pInputReal = &m_delayLineReal[position * m_binCount];
+        const float* pInputImag = &m_delayLineImag[position * m_binCount];
+        const float* pKernelReal = &partitions.real[partition * m_binCount];
+        const float* pKernelImag = &partitions.imag[partition * m_binCount];
+        for (int bin = 0; bin < m_binCount; ++bin) {
+            pAccumulatorReal[bin] += pKernelReal[bin] * pInputReal[bin] -
+                    pKernelImag[bin] * pInputImag[bin];
+            pAccumulatorImag[bin] += pKernelReal[bin] * pInputImag[bin] +
+                    pKernelImag[bin] * pInputReal[bin];
+        }
+    }
+}
+
+void PartitionedConvolver::Stage::transformOutput(double* pOutput) {
+    std::copy(m_accumulatorReal.begin(), m_accumulatorReal.end(), m_fftReal.begin());
+    std::copy(m_accumulatorImag.begin(), m_accumulatorImag.end(), m_fftImag.begin());
+    m_pFft->inverse(m_fftReal.data(), m_fftImag.data(), m_fftOutput.data());
+    // Overlap-save: The first half is aliased
+    std::copy(m_fftOutput.begin() + m_blockSize, m_fftOutput.end(), pOutput);
+}
+
+PartitionedConvolver::PartitionedConvolver(SINT maxKernelLength)
+        : m_maxKernelLength(maxKernelLength),
+          m_pKernel(nullptr),
+          m_head(kHeadBlockSize, static_cast<int>(kHeadLength / kHeadBlockSize)),
+          m_tail(kTailBlockSize,
+                  std::max(1,
+                          static_cast<int>((maxKernelLength - kHeadLength +
+                                                   kTailBlockSize - 1) /
+                                  kTailBlockSize))),
+          m_headInput(2 * kHeadBlockSize),
+          m_headOutput(kHeadBlockSize),
+          m_headPosition(0),
+          m_tailInput(2 * kTailBlockSize),
+          m_tailStepInput(2 * kTailBlockSize),
+          m_tailStepOutput(kTailBlockSize),
+          m_tailOutput(kTailBlockSize),
+          m_step(0) {
+    static_assert(kTailBlockSize % kHeadBlockSize == 0);
+    static_assert(kStepsPerTailBlock >= 3);
+}
+
+PartitionedConvolver::~PartitionedConvolver() = default;
+
+void PartitionedConvolver::setKernel(const ConvolutionKernel* pKernel) {
+    VERIFY_OR_DEBUG_ASSERT(!pKernel || pKernel->length() <= m_maxKernelLength) {
+        return;
+    }
+    m_pKernel = pKernel;
+}
+
+void PartitionedConvolver::reset() {
+    m_head.reset();
+    m_tail.reset();
+    std::fill(m_headInput.begin(), m_headInput.end(), 0.0);
+    std::fill(m_headOutput.begin(), m_headOutput.end(), 0.0);
+    std::fill(m_tailInput.begin(), m_tailInput.end(), 0.0);
+    std::fill(m_tailStepInput.begin(), m_tailStepInput.end(), 0.0);
+    std::fill(m_tailStepOutput.begin(), m_tailStepOutput.end(), 0.0);
+    std::fill(m_tailOutput.begin(), m_tailOutput.end(), 0.0);
+    m_headPosition = 0;
+    m_step = 0;
+}
+
+void PartitionedConvolver::process(
+        const CSAMPLE* pInput, CSAMPLE* pOutput, SINT numSamples) {
+    SINT offset = 0;
+    while (offset < numSamples) {
+        const SINT count = std::min(numSamples - offset, kHeadBlockSize - m_headPosition);
+        double* pHeadInput = &m_headInput[kHeadBlockSize + m_headPosition];
+        const double* pHeadOutput = &m_headOutput[m_headPosition];
+        for (SINT i = 0; i < count; ++i) {
+            pHeadInput[i] = pInput[offset + i];
+            pOutput[offset + i] = static_cast<CSAMPLE>(pHeadOutput[i]);
+        }
+        offset += count;
+        m_headPosition += count;
+        if (m_headPosition == kHeadBlockSize) {
+            processBlock();
+            m_headPosition = 0;
+        }
+    }
+}
+
+void PartitionedConvolver::processBlock() {
+    m_head.transformInput(m_headInput.data());
+    m_head.clearAccumulator();
+    if (m_pKernel) {
+        m_head.multiplyAccumulate(m_pKernel->head(), 0, m_pKernel->head().count);
+    }
+    m_head.transformOutput(m_headOutput.data());
+
+    // The tail of the impulse response starts two tail blocks after the
+    // head, so the output of the tail block before the previous one is
+    // added to the current head block.
+    const double* pTailOutput = &m_tailOutput[m_step * kHeadBlockSize];
+    for (SINT i = 0; i < kHeadBlockSize; ++i) {
+        m_headOutput[i] += pTailOutput[i];
+    }
+
+    const auto headBlock = m_headInput.cbegin() + kHeadBlockSize;
+    std::copy(headBlock,
+            m_headInput.cend(),
+            m_tailInput.begin() + kTailBlockSize + m_step * kHeadBlockSize);
+    std::copy(headBlock, m_headInput.cend(), m_headInput.begin());
+
+    processTailStep(m_step);
+
+    if (++m_step == kStepsPerTailBlock) {
+        m_step = 0;
+        std::swap(m_tailStepOutput, m_tailOutput);
+        // The tail block is complete and gets processed with the next
+        // tail block
+        std::copy(m_tailInput.cbegin(), m_tailInput.cend(), m_tailStepInput.begin());
+        std::copy(m_tailInput.cbegin() + kTailBlockSize,
+                m_tailInput.cend(),
+                m_tailInput.begin());
+    }
+}
+
+void PartitionedConvolver::processTailStep(int step) {
+    // The first and the last step transform the input and the output, the
+    // multiplications are distributed evenly among the steps in between.
+    constexpr int kMultiplySteps = kStepsPerTailBlock - 2;
+    if (step == 0) {
+        m_tail.transformInput(m_tailStepInput.data());
+        m_tail.clearAccumulator();
+    } else if (step < kStepsPerTailBlock - 1) {
+        if (m_pKernel) {
+            const int partitionCount = m_pKernel->tail().count;
+            const int partitionsPerStep =
+                    (partitionCount + kMultiplySteps - 1) / kMultiplySteps;
+            const int first = (step - 1) * partitionsPerStep;
+            m_tail.multiplyAccumulate(m_pKernel->tail(), first, first + partitionsPerStep);
+        }
+    } else {
+        m_tail.transformOutput(m_tailStepOutput.data());
+    }
+}
+
+} // namespace mixxx
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "util/class.h"
+#include "util/types.h"
+
+class FFTReal;
+
+namespace mixxx {
+
+/// The spectra of the partitions of an impulse response as required by
+/// PartitionedConvolver.
+///
+/// Creating a kernel transforms every partition of the impulse response
+/// and must not be done in the audio thread. Kernels are immutable and
+/// may be shared by any number of convolvers.
+class ConvolutionKernel final {
+  public:
+    /// The spectra of equally sized partitions
+    struct Partitions {
+        int count = 0;
+        int binCount = 0;
+        // count * binCount values each
+        std::vector<float> real;
+        std::vector<float> imag;
+    };
+
+    ConvolutionKernel(const CSAMPLE* pImpulseResponse, SINT length);
+
+    SINT length() const {
+        return m_length;
+    }
+
+    const Partitions& head() const {
+        return m_head;
+    }
+    const Partitions& tail() const {
+        return m_tail;
+    }
+
+  private:
+    SINT m_length;
+    Partitions m_head;
+    Partitions m_tail;
+};
+
+/// Convolves a mono signal with an impulse response in the frequency domain.
+///
+/// The beginning of the impulse response is processed with uniformly
+/// partitioned overlap-save convolution of small blocks. All of the output
+/// is delayed by the size of these blocks. The remaining tail is processed
+/// in much larger blocks, which require fewer transforms and multiplications
+/// per sample. The work for each large block is split into steps that are
+/// performed along with the small blocks, so that long impulse responses do
+/// not cause peaks of the processing time in some callbacks.
+///
+/// All buffers are allocated on construction, the other functions are
+/// real-time safe.
+class PartitionedConvolver final {
+  public:
+    /// The latency in samples
+    static constexpr SINT kHeadBlockSize = 128;
+    static constexpr SINT kTailBlockSize = 2048;
+
+    /// Kernels must not be longer than maxKernelLength.
+    explicit PartitionedConvolver(SINT maxKernelLength);
+    ~PartitionedConvolver();
+
+    /// The input that has already been processed is kept and reverberates
+    /// with the new kernel. The kernel must not be destroyed before it is
+    /// replaced. Without a kernel the output is silent.
+    void setKernel(const ConvolutionKernel* pKernel);
+
+    /// Discards all buffered input and output
+    void reset();
+
+    void process(const CSAMPLE* pInput, CSAMPLE* pOutput, SINT numSamples);
+
+  private:
+    /// A uniformly partitioned convolution with a frequency-domain delay
+    /// line of the spectra of previous input blocks
+    class Stage {
+      public:
+        Stage(SINT blockSize, int maxPartitionCount);
+        ~Stage();
+
+        void reset();
+
+        /// Transforms two blocks of input, the previous and the current
+        /// one, and stores the spectrum in the delay line
+        void transformInput(const double* pInput);
+        void clearAccumulator();
+        /// Accumulates the products of the partitions [first, end) with
+        /// the corresponding input spectra
+        void multiplyAccumulate(const ConvolutionKernel::Partitions& partitions,
+                int first,
+                int end);
+        /// Writes the block of output samples for the current input block
+        void transformOutput(double* pOutput);
+
+      private:
+        const SINT m_blockSize;
+        const int m_binCount;
+        const int m_maxPartitionCount;
+        int m_delayLinePosition;
+        std::unique_ptr<FFTReal> m_pFft;
+        std::vector<double> m_fftReal;
+        std::vector<double> m_fftImag;
+        std::vector<double> m_fftOutput;
+        std::vector<float> m_delayLineReal;
+        std::vector<float> m_delayLineImag;
+        std::vector<float> m_accumulatorReal;
+        std::vector<float> m_accumulatorImag;
+    };
+
+    void processBlock();
+    void processTailStep(int step);
+
+    static constexpr int kStepsPerTailBlock = kTailBlockSize / kHeadBlockSize;
+
+    const SINT m_maxKernelLength;
+    const ConvolutionKernel* m_pKernel;
+
+    Stage m_head;
+    Stage m_tail;
+
+    // The previous and the current head block
+    std::vector<double> m_headInput;
+    // The output of the previous head block, written by process()
+    std::vector<double> m_headOutput;
+    SINT m_headPosition;
+
+    // The previous and the current tail block, filled by each head block
+    std::vector<double> m_tailInput;
+    // The input of the tail block that is currently transformed
+    std::vector<double> m_tailStepInput;
+    // The output of the tail block that is currently computed and
+    // of the one that is added to the head blocks
+    std::vector<double> m_tailStepOutput;
+    std::vector<double> m_tailOutput;
+    // The index of the head block within the tail block
+    int m_step;
+
+    DISALLOW_COPY_AND_ASSIGN(PartitionedConvolver);
+};
+
+} // namespace mixxx
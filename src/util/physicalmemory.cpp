@@ -0,0 +1,37 @@
+#include "util/physicalmemory.h"
+
+#if defined(__WINDOWS__)
+#include <windows.h>
+#elif defined(__APPLE__)
+#include <sys/sysctl.h>
+#include <sys/types.h>
+#elif defined(__LINUX__)
+#include <unistd.h>
+#endif
+
+namespace mixxx {
+
+qint64 availablePhysicalMemoryBytes() {
+#if defined(__WINDOWS__)
+    MEMORYSTATUSEX status;
+    status.dwLength = sizeof(status);
+    if (GlobalMemoryStatusEx(&status)) {
+        return static_cast<qint64>(status.ullAvailPhys);
+    }
+#elif defined(__APPLE__)
+    quint64 memorySize = 0;
+    size_t length = sizeof(memorySize);
+    if (sysctlbyname("hw.memsize", &memorySize, &length, nullptr, 0) == 0) {
+        return static_cast<qint64>(memorySize);
+    }
+#elif defined(__LINUX__)
+    const long pageCount = sysconf(_SC_AVPHYS_PAGES);
+    const long pageSize = sysconf(_SC_PAGESIZE);
+    if (pageCount > 0 && pageSize > 0) {
+        return static_cast<qint64>(pageCount) * pageSize;
+    }
+#endif
+    return -1;
+}
+
+} // namespace mixxx
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <QtGlobal>
+
+namespace mixxx {
+
+/// Returns the amount of physical memory that is currently available for
+/// new allocations in bytes, or -1 if it cannot be determined. On macOS the
+/// total amount of physical memory is returned instead, because memory that
+/// is only cached is not reported as available.
+qint64 availablePhysicalMemoryBytes();
+
+} // namespace mixxx
@@ -0,0 +1,136 @@
+#include "util/polyphaseresampler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+#include "util/assert.h"
+#include "util/math.h"
+
+namespace mixxx {
+
+namespace {
+
+// The number of taps per branch when upsampling. When downsampling, the
+// filter gets longer by the factor, so the transition band keeps its width
+// relative to the output sample rate.
+constexpr int kMinTapsPerPhase = 64;
+
+// The transition band of a Blackman window in cycles per sample, times the
+// length of the filter
+constexpr double kBlackmanTransitionWidth = 5.5;
+
+} // anonymous namespace
+
+PolyphaseResampler::PolyphaseResampler(audio::SampleRate inputSampleRate,
+        audio::SampleRate outputSampleRate,
+        int channelCount)
+        : m_inputSampleRate(inputSampleRate),
+          m_outputSampleRate(outputSampleRate),
+          m_channelCount(channelCount),
+          m_upFactor(1),
+          m_downFactor(1),
+          m_tapsPerPhase(1),
+          m_history(channelCount),
+          m_phase(0),
+          m_inputIndex(0) {
+    VERIFY_OR_DEBUG_ASSERT(inputSampleRate.isValid() &&
+            outputSampleRate.isValid() && channelCount > 0) {
+        return;
+    }
+    const auto divisor = std::gcd(inputSampleRate.value(), outputSampleRate.value());
+    m_upFactor = static_cast<int>(outputSampleRate.value() / divisor);
+    m_downFactor = static_cast<int>(inputSampleRate.value() / divisor);
+    m_tapsPerPhase = kMinTapsPerPhase *
+            std::max(1, (m_downFactor + m_upFactor - 1) / m_upFactor);
+
+    // The prototype filter at the upsampled rate, a windowed sinc with the
+    // end of the transition band at the lower Nyquist frequency
+    const int numTaps = m_tapsPerPhase * m_upFactor;
+    const double transitionWidth = kBlackmanTransitionWidth / m_tapsPerPhase;
+    const double cutoff =
+            (0.5 * std::min(1.0, static_cast<double>(m_upFactor) / m_downFactor) -
+                    transitionWidth / 2) /
+            m_upFactor;
+    const double center = (numTaps - 1) / 2.0;
+    std::vector<double> taps(numTaps);
+    for (int n = 0; n < numTaps; ++n) {
+        const double x = 2 * cutoff * (n - center);
+        const double sinc = x == 0 ? 1.0 : std::sin(M_PI * x) / (M_PI * x);
+        const double phase = 2 * M_PI * (n + 1) / (numTaps + 1);
+        const double window = 0.42 - 0.5 * std::cos(phase) + 0.08 * std::cos(2 * phase);
+        taps[n] = sinc * window;
+    }
+
+    // Split into the reversed branches, each normalized to unity gain at DC
+    m_coefficients.resize(numTaps);
+    for (int phase = 0; phase < m_upFactor; ++phase) {
+        double sum = 0;
+        for (int k = 0; k < m_tapsPerPhase; ++k) {
+            sum += taps[phase + k * m_upFactor];
+        }
+        CSAMPLE_GAIN* pBranch = &m_coefficients[phase * m_tapsPerPhase];
+        for (int k = 0; k < m_tapsPerPhase; ++k) {
+            pBranch[m_tapsPerPhase - 1 - k] =
+                    static_cast<CSAMPLE_GAIN>(taps[phase + k * m_upFactor] / sum);
+        }
+    }
+    reset();
+}
+
+SINT PolyphaseResampler::maxOutputFrames(SINT inputFrames) const {
+    return inputFrames * m_upFactor / m_downFactor + 2;
+}
+
+void PolyphaseResampler::reset() {
+    for (auto& history : m_history) {
+        history.assign(m_tapsPerPhase - 1, CSAMPLE_ZERO);
+    }
+    m_phase = 0;
+    m_inputIndex = 0;
+}
+
+SINT PolyphaseResampler::process(
+        const CSAMPLE* pInput, SINT inputFrames, CSAMPLE* pOutput) {
+    if (inputFrames <= 0) {
+        return 0;
+    }
+    const SINT historySize = m_tapsPerPhase - 1;
+    for (int channel = 0; channel < m_channelCount; ++channel) {
+        auto& history = m_history[channel];
+        history.resize(historySize + inputFrames);
+        CSAMPLE* pHistory = history.data() + historySize;
+        for (SINT i = 0; i < inputFrames; ++i) {
+            pHistory[i] = pInput[i * m_channelCount + channel];
+        }
+    }
+
+    SINT outputFrames = 0;
+    while (m_inputIndex < inputFrames) {
+        const CSAMPLE_GAIN* pBranch = &m_coefficients[m_phase * m_tapsPerPhase];
+        for (int channel = 0; channel < m_channelCount; ++channel) {
+            const CSAMPLE* pSamples = m_history[channel].data() + m_inputIndex;
+            CSAMPLE sum = 0;
+            // note: LOOP VECTORIZED only with "int i" (not SINT i)
+            for (int i = 0; i < m_tapsPerPhase; ++i) {
+                sum += pBranch[i] * pSamples[i];
+            }
+            pOutput[outputFrames * m_channelCount + channel] = sum;
+        }
+        ++outputFrames;
+        m_phase += m_downFactor;
+        m_inputIndex += m_phase / m_upFactor;
+        m_phase %= m_upFactor;
+    }
+    DEBUG_ASSERT(outputFrames <= maxOutputFrames(inputFrames));
+    m_inputIndex -= inputFrames;
+
+    // Keep the samples that the next outputs still depend on
+    for (auto& history : m_history) {
+        std::copy(history.end() - historySize, history.end(), history.begin());
+        history.resize(historySize);
+    }
+    return outputFrames;
+}
+
+} // namespace mixxx
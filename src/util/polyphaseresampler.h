@@ -0,0 +1,72 @@
+#pragma once
+
+#include <vector>
+
+#include "audio/types.h"
+#include "util/class.h"
+#include "util/types.h"
+
+namespace mixxx {
+
+/// Converts an interleaved signal between two fixed sample rates with a
+/// windowed sinc FIR filter that is split into one polyphase branch per
+/// output phase. The ratio of the sample rates is reduced to L/M, so each
+/// output sample is the dot product of the L-th branch with the input
+/// samples before it. The dot products run over contiguous samples of a
+/// single channel and are vectorized.
+///
+/// The filter cuts off below the lower of both Nyquist frequencies, so
+/// downsampling does not alias. The buffers grow with the largest number
+/// of frames that is passed, so it is not real-time safe.
+class PolyphaseResampler final {
+  public:
+    PolyphaseResampler(audio::SampleRate inputSampleRate,
+            audio::SampleRate outputSampleRate,
+            int channelCount = 2);
+
+    audio::SampleRate inputSampleRate() const {
+        return m_inputSampleRate;
+    }
+    audio::SampleRate outputSampleRate() const {
+        return m_outputSampleRate;
+    }
+
+    /// The number of taps of each polyphase branch
+    int tapsPerPhase() const {
+        return m_tapsPerPhase;
+    }
+
+    /// The maximum number of frames that process() writes for the given
+    /// number of input frames
+    SINT maxOutputFrames(SINT inputFrames) const;
+
+    /// Returns the number of frames written to pOutput, which must have
+    /// room for maxOutputFrames(inputFrames) frames.
+    SINT process(const CSAMPLE* pInput, SINT inputFrames, CSAMPLE* pOutput);
+
+    void reset();
+
+  private:
+    const audio::SampleRate m_inputSampleRate;
+    const audio::SampleRate m_outputSampleRate;
+    const int m_channelCount;
+    // The ratio of the sample rates is m_upFactor / m_downFactor
+    int m_upFactor;
+    int m_downFactor;
+    int m_tapsPerPhase;
+    // The taps of all branches, each reversed, so that they line up with the
+    // input samples in chronological order
+    std::vector<CSAMPLE_GAIN> m_coefficients;
+
+    // The last m_tapsPerPhase - 1 samples of each channel followed by the
+    // current input, deinterleaved
+    std::vector<std::vector<CSAMPLE>> m_history;
+    // The branch and the index of the current input sample that the next
+    // output sample is computed from
+    int m_phase;
+    SINT m_inputIndex;
+
+    DISALLOW_COPY_AND_ASSIGN(PolyphaseResampler);
+};
+
+} // namespace mixxx
@@ -0,0 +1,54 @@
+#include "util/powerprofile.h"
+
+#include "moc_powerprofile.cpp"
+#include "util/battery/battery.h"
+#include "util/logger.h"
+
+namespace {
+
+const mixxx::Logger kLogger("PowerProfile");
+
+// Enables the automatic power saving profile on battery
+const ConfigKey kBatterySaverConfigKey(
+        QStringLiteral("[Config]"), QStringLiteral("BatterySaver"));
+
+} // namespace
+
+namespace mixxx {
+
+// static
+const ConfigKey PowerProfile::kPowerSavingConfigKey(
+        QStringLiteral("[App]"), QStringLiteral("power_saving"));
+
+PowerProfile::PowerProfile(UserSettingsPointer pConfig, QObject* pParent)
+        : QObject(pParent),
+          m_pConfig(pConfig),
+          m_powerSaving(kPowerSavingConfigKey),
+          m_pBattery(Battery::getBattery(this)) {
+    m_powerSaving.setReadOnly();
+    if (m_pBattery) {
+        connect(m_pBattery,
+                &Battery::stateChanged,
+                this,
+                &PowerProfile::slotBatteryStateChanged);
+        m_pBattery->update();
+    }
+}
+
+PowerProfile::~PowerProfile() = default;
+
+void PowerProfile::slotBatteryStateChanged() {
+    DEBUG_ASSERT(m_pBattery);
+    const bool powerSaving =
+            m_pConfig->getValue(kBatterySaverConfigKey, true) &&
+            m_pBattery->getChargingState() == Battery::DISCHARGING;
+    if (powerSaving == isPowerSaving()) {
+        return;
+    }
+    kLogger.info()
+            << (powerSaving ? "Running on battery, saving power"
+                            : "Running on external power");
+    m_powerSaving.forceSet(powerSaving ? 1.0 : 0.0);
+}
+
+} // namespace mixxx
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <QObject>
+
+#include "control/controlobject.h"
+#include "preferences/usersettings.h"
+
+class Battery;
+
+namespace mixxx {
+
+/// Switches to a power saving profile while running on battery.
+///
+/// The profile is published as the read-only control [App],power_saving.
+/// Components with background load listen to it and scale down: the batch
+/// analysis only keeps a single worker thread busy, the library scanner
+/// uses a single thread and the waveforms are rendered at a reduced frame
+/// rate. Everything is restored when the power supply is reconnected.
+class PowerProfile : public QObject {
+    Q_OBJECT
+  public:
+    static const ConfigKey kPowerSavingConfigKey;
+
+    explicit PowerProfile(UserSettingsPointer pConfig, QObject* pParent = nullptr);
+    ~PowerProfile() override;
+
+    bool isPowerSaving() const {
+        return m_powerSaving.toBool();
+    }
+
+  private slots:
+    void slotBatteryStateChanged();
+
+  private:
+    const UserSettingsPointer m_pConfig;
+    ControlObject m_powerSaving;
+    // nullptr if built without battery support
+    Battery* m_pBattery;
+};
+
+} // namespace mixxx
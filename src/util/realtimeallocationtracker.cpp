@@ -0,0 +1,228 @@
+#include "util/realtimeallocationtracker.h"
+
+#ifdef MIXXX_REALTIME_ALLOCATION_TRACKER
+
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <pthread.h>
+
+#include <QMutex>
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+
+#include "util/compatibility/qmutex.h"
+#include "util/logger.h"
+#include "util/stat.h"
+
+// The allocator functions of glibc that the hooks forward to
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* pMemory, size_t size);
+void* __libc_memalign(size_t alignment, size_t size);
+void __libc_free(void* pMemory);
+}
+
+namespace mixxx {
+
+namespace {
+
+const Logger kLogger("RealtimeAllocationTracker");
+
+struct Violation {
+    std::atomic<bool> recorded;
+    RealtimeAllocationTracker::Call call;
+    int frameCount;
+    void* frames[RealtimeAllocationTracker::kMaxFrames];
+};
+
+Violation s_violations[RealtimeAllocationTracker::kMaxViolations];
+std::atomic<quint64> s_violationCount(0);
+
+QMutex s_loggedMutex;
+int s_loggedCount = 0;
+
+// Trivial types only, so the hooks can access them without running any
+// thread_local initializer.
+thread_local int t_sectionDepth = 0;
+thread_local bool t_inHook = false;
+
+typedef int (*MutexLockFunction)(pthread_mutex_t*);
+
+MutexLockFunction resolveMutexLock() {
+    return reinterpret_cast<MutexLockFunction>(dlsym(RTLD_NEXT, "pthread_mutex_lock"));
+}
+
+// Resolved during static initialization, before any real-time thread runs.
+// Mutexes that are locked earlier resolve it on their own.
+std::atomic<MutexLockFunction> s_pMutexLock(resolveMutexLock());
+
+int lockPthreadMutex(pthread_mutex_t* pMutex) {
+    MutexLockFunction pMutexLock = s_pMutexLock.load(std::memory_order_relaxed);
+    if (!pMutexLock) {
+        pMutexLock = resolveMutexLock();
+        s_pMutexLock.store(pMutexLock, std::memory_order_relaxed);
+    }
+    return pMutexLock(pMutex);
+}
+
+// backtrace() allocates when it is called for the first time
+const bool s_backtraceInitialized = [] {
+    void* frames[1];
+    return backtrace(frames, 1) >= 0;
+}();
+
+const char* callName(RealtimeAllocationTracker::Call call) {
+    switch (call) {
+    case RealtimeAllocationTracker::Call::Allocation:
+        return "Allocation";
+    case RealtimeAllocationTracker::Call::Deallocation:
+        return "Deallocation";
+    case RealtimeAllocationTracker::Call::MutexLock:
+        return "Mutex lock";
+    }
+    return "Unknown call";
+}
+
+QString symbolize(const Violation& violation) {
+    QString trace = QString::fromLatin1(callName(violation.call)) +
+            QStringLiteral(" on a real-time thread:");
+    char** pSymbols = backtrace_symbols(violation.frames, violation.frameCount);
+    if (!pSymbols) {
+        return trace;
+    }
+    // Skip the frames of the tracker and the hook
+    for (int i = 2; i < violation.frameCount; ++i) {
+        trace += QStringLiteral("\n    ") + QString::fromLocal8Bit(pSymbols[i]);
+    }
+    std::free(pSymbols);
+    return trace;
+}
+
+} // anonymous namespace
+
+RealtimeAllocationTracker::RealtimeSection::RealtimeSection()
+        : m_violationCountBefore(s_violationCount.load(std::memory_order_relaxed)) {
+    ++t_sectionDepth;
+}
+
+RealtimeAllocationTracker::RealtimeSection::~RealtimeSection() {
+    if (--t_sectionDepth > 0) {
+        return;
+    }
+    const quint64 violations =
+            s_violationCount.load(std::memory_order_relaxed) - m_violationCountBefore;
+    if (violations > 0) {
+        // Outside of the section, so the report itself is not tracked
+        static const QString tag = QStringLiteral("RealtimeAllocationTracker violations");
+        Stat::track(tag,
+                Stat::COUNTER,
+                Stat::COUNT | Stat::SUM | Stat::MAX,
+                static_cast<double>(violations));
+    }
+}
+
+// static
+void RealtimeAllocationTracker::reportCall(Call call) {
+    if (t_sectionDepth == 0 || t_inHook) {
+        return;
+    }
+    t_inHook = true;
+    const quint64 index = s_violationCount.fetch_add(1, std::memory_order_relaxed);
+    if (index < kMaxViolations) {
+        Violation& violation = s_violations[index];
+        violation.call = call;
+        violation.frameCount = backtrace(violation.frames, kMaxFrames);
+        violation.recorded.store(true, std::memory_order_release);
+    }
+    t_inHook = false;
+}
+
+// static
+quint64 RealtimeAllocationTracker::violationCount() {
+    return s_violationCount.load(std::memory_order_relaxed);
+}
+
+// static
+void RealtimeAllocationTracker::logViolations() {
+    const auto locker = lockMutex(&s_loggedMutex);
+    while (s_loggedCount < kMaxViolations &&
+            s_violations[s_loggedCount].recorded.load(std::memory_order_acquire)) {
+        kLogger.warning().noquote() << symbolize(s_violations[s_loggedCount]);
+        ++s_loggedCount;
+    }
+}
+
+// static
+QStringList RealtimeAllocationTracker::recordedViolations() {
+    QStringList violations;
+    for (const auto& violation : s_violations) {
+        if (!violation.recorded.load(std::memory_order_acquire)) {
+            break;
+        }
+        violations.append(symbolize(violation));
+    }
+    return violations;
+}
+
+} // namespace mixxx
+
+// Replacements of the glibc functions. The definitions in the executable
+// take precedence over those of the shared libraries.
+extern "C" {
+
+void* malloc(size_t size) {
+    mixxx::RealtimeAllocationTracker::reportCall(
+            mixxx::RealtimeAllocationTracker::Call::Allocation);
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size) {
+    mixxx::RealtimeAllocationTracker::reportCall(
+            mixxx::RealtimeAllocationTracker::Call::Allocation);
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* pMemory, size_t size) {
+    mixxx::RealtimeAllocationTracker::reportCall(
+            mixxx::RealtimeAllocationTracker::Call::Allocation);
+    return __libc_realloc(pMemory, size);
+}
+
+void* memalign(size_t alignment, size_t size) {
+    mixxx::RealtimeAllocationTracker::reportCall(
+            mixxx::RealtimeAllocationTracker::Call::Allocation);
+    return __libc_memalign(alignment, size);
+}
+
+void* aligned_alloc(size_t alignment, size_t size) {
+    return memalign(alignment, size);
+}
+
+int posix_memalign(void** ppMemory, size_t alignment, size_t size) {
+    void* pMemory = memalign(alignment, size);
+    if (!pMemory) {
+        return ENOMEM;
+    }
+    *ppMemory = pMemory;
+    return 0;
+}
+
+void free(void* pMemory) {
+    if (pMemory) {
+        mixxx::RealtimeAllocationTracker::reportCall(
+                mixxx::RealtimeAllocationTracker::Call::Deallocation);
+    }
+    __libc_free(pMemory);
+}
+
+int pthread_mutex_lock(pthread_mutex_t* pMutex) {
+    mixxx::RealtimeAllocationTracker::reportCall(
+            mixxx::RealtimeAllocationTracker::Call::MutexLock);
+    return mixxx::lockPthreadMutex(pMutex);
+}
+
+} // extern "C"
+
+#endif // MIXXX_REALTIME_ALLOCATION_TRACKER
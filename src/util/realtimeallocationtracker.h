@@ -0,0 +1,85 @@
+#pragma once
+
+#include <QStringList>
+#include <QtGlobal>
+
+namespace mixxx {
+
+/// Detects heap allocations and mutex locks on real-time threads, like a
+/// QString that is formatted or a QList that grows in the engine callback.
+///
+/// Only available if Mixxx is built with REALTIME_ALLOCATION_TRACKER=ON on
+/// Linux with glibc. The tracker then replaces malloc() and friends and
+/// pthread_mutex_lock() of the whole process. lockMutex() reports QMutex
+/// locks, which bypass pthreads. Calls within a RealtimeSection are
+/// counted, the first kMaxViolations of them with their stack trace.
+///
+/// The number of violations of each callback is reported to the stats
+/// system and the stack traces are logged by the RealtimeLogWriter.
+class RealtimeAllocationTracker final {
+  public:
+    enum class Call {
+        Allocation,
+        Deallocation,
+        MutexLock,
+    };
+
+    static constexpr int kMaxViolations = 64;
+    static constexpr int kMaxFrames = 24;
+
+    /// Marks the calling thread as real-time for the lifetime of the
+    /// object, may be nested.
+    class RealtimeSection final {
+      public:
+#ifdef MIXXX_REALTIME_ALLOCATION_TRACKER
+        RealtimeSection();
+        ~RealtimeSection();
+#else
+        RealtimeSection() = default;
+#endif
+        RealtimeSection(const RealtimeSection&) = delete;
+        RealtimeSection& operator=(const RealtimeSection&) = delete;
+
+#ifdef MIXXX_REALTIME_ALLOCATION_TRACKER
+      private:
+        quint64 m_violationCountBefore;
+#endif
+    };
+
+    static constexpr bool isAvailable() {
+#ifdef MIXXX_REALTIME_ALLOCATION_TRACKER
+        return true;
+#else
+        return false;
+#endif
+    }
+
+#ifdef MIXXX_REALTIME_ALLOCATION_TRACKER
+    /// Called by the hooks, real-time safe and reentrant.
+    static void reportCall(Call call);
+    /// The number of violations since the start of Mixxx
+    static quint64 violationCount();
+    /// Symbolizes and logs the recorded violations that have not been
+    /// logged yet. Not real-time safe.
+    static void logViolations();
+    /// The symbolized stack traces of the recorded violations, for tests
+    static QStringList recordedViolations();
+#else
+    static void reportCall(Call call) {
+        Q_UNUSED(call);
+    }
+    static quint64 violationCount() {
+        return 0;
+    }
+    static void logViolations() {
+    }
+    static QStringList recordedViolations() {
+        return {};
+    }
+#endif
+
+  private:
+    RealtimeAllocationTracker() = delete;
+};
+
+} // namespace mixxx
@@ -0,0 +1,161 @@
+#include "util/realtimelog.h"
+
+#include <QMutex>
+#include <QtDebug>
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "moc_realtimelog.cpp"
+#include "rigtorp/SPSCQueue.h"
+#include "util/compatibility/qmutex.h"
+#include "util/realtimeallocationtracker.h"
+
+namespace mixxx {
+
+namespace {
+
+constexpr unsigned long kFlushIntervalMillis = 100;
+
+struct Pipe {
+    Pipe()
+            : records(RealtimeLog::kMaxPendingRecords),
+              droppedCount(0),
+              reportedDroppedCount(0) {
+    }
+
+    rigtorp::SPSCQueue<RealtimeLog::Record> records;
+    std::atomic<quint64> droppedCount;
+    // Only accessed by flush()
+    quint64 reportedDroppedCount;
+};
+
+// The pipes of all threads that have logged. A pipe is kept after its
+// thread has finished until its messages have been flushed.
+QMutex& pipesMutex() {
+    static QMutex s_mutex;
+    return s_mutex;
+}
+
+std::vector<std::shared_ptr<Pipe>>& pipes() {
+    static std::vector<std::shared_ptr<Pipe>> s_pipes;
+    return s_pipes;
+}
+
+std::atomic<quint64> s_droppedMessageCount(0);
+
+thread_local std::shared_ptr<Pipe> t_pPipe;
+
+Pipe* pipeForThread() {
+    if (!t_pPipe) {
+        t_pPipe = std::make_shared<Pipe>();
+        const auto locker = lockMutex(&pipesMutex());
+        pipes().push_back(t_pPipe);
+    }
+    return t_pPipe.get();
+}
+
+void logRecord(const RealtimeLog::Record& record) {
+    const QString message = RealtimeLog::format(record);
+    switch (record.level) {
+    case LogLevel::Critical:
+        qCritical().noquote() << record.pContext << "-" << message;
+        break;
+    case LogLevel::Warning:
+        qWarning().noquote() << record.pContext << "-" << message;
+        break;
+    case LogLevel::Info:
+        qInfo().noquote() << record.pContext << "-" << message;
+        break;
+    case LogLevel::Debug:
+    case LogLevel::Trace:
+        qDebug().noquote() << record.pContext << "-" << message;
+        break;
+    }
+}
+
+} // anonymous namespace
+
+// static
+void RealtimeLog::prepareThread() {
+    pipeForThread();
+}
+
+// static
+void RealtimeLog::push(const Record& record) {
+    Pipe* pPipe = pipeForThread();
+    if (!pPipe->records.try_push(record)) {
+        pPipe->droppedCount.fetch_add(1, std::memory_order_relaxed);
+        s_droppedMessageCount.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+// static
+void RealtimeLog::flush() {
+    std::vector<std::shared_ptr<Pipe>> currentPipes;
+    {
+        const auto locker = lockMutex(&pipesMutex());
+        currentPipes = pipes();
+    }
+    for (const auto& pPipe : currentPipes) {
+        while (const Record* pRecord = pPipe->records.front()) {
+            logRecord(*pRecord);
+            pPipe->records.pop();
+        }
+        const quint64 droppedCount = pPipe->droppedCount.load(std::memory_order_relaxed);
+        if (droppedCount > pPipe->reportedDroppedCount) {
+            qWarning() << "RealtimeLog -"
+                       << droppedCount - pPipe->reportedDroppedCount
+                       << "messages have been dropped";
+            pPipe->reportedDroppedCount = droppedCount;
+        }
+    }
+    currentPipes.clear();
+
+    // Remove the pipes of finished threads
+    const auto locker = lockMutex(&pipesMutex());
+    auto& allPipes = pipes();
+    allPipes.erase(std::remove_if(allPipes.begin(),
+                           allPipes.end(),
+                           [](const std::shared_ptr<Pipe>& pPipe) {
+                               return pPipe.use_count() == 1 &&
+                                       pPipe->records.empty();
+                           }),
+            allPipes.end());
+}
+
+// static
+quint64 RealtimeLog::droppedMessageCount() {
+    return s_droppedMessageCount.load(std::memory_order_relaxed);
+}
+
+// static
+QString RealtimeLog::format(const Record& record) {
+    QString message = QString::fromLatin1(record.pFormat);
+    for (int i = 0; i < record.argCount; ++i) {
+        message = message.arg(record.args[i], 0, 'g', 12);
+    }
+    return message;
+}
+
+RealtimeLogWriter::RealtimeLogWriter() {
+    setObjectName(QStringLiteral("RealtimeLogWriter"));
+    start(QThread::LowPriority);
+}
+
+RealtimeLogWriter::~RealtimeLogWriter() {
+    requestInterruption();
+    wait();
+    RealtimeLog::flush();
+}
+
+void RealtimeLogWriter::run() {
+    while (!isInterruptionRequested()) {
+        RealtimeLog::flush();
+        RealtimeAllocationTracker::logViolations();
+        msleep(kFlushIntervalMillis);
+    }
+}
+
+} // namespace mixxx
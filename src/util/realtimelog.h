@@ -0,0 +1,103 @@
+#pragma once
+
+#include <QString>
+#include <QThread>
+#include <array>
+#include <cstddef>
+
+#include "util/logging.h"
+
+namespace mixxx {
+
+/// Logging from real-time threads like the engine callback and its worker
+/// threads, where qDebug() and Logger must not be used, because they lock a
+/// mutex and allocate the formatted message.
+///
+/// A message is a fixed-size record with a static context and format string
+/// and up to four numeric arguments. It is pushed into a lock-free ring of
+/// the calling thread and formatted and passed to the regular logging by
+/// the RealtimeLogWriter thread. Messages that don't fit into a full ring
+/// are dropped and counted.
+///
+/// Example:
+///   RealtimeLog::debug("EngineBuffer", "Seeking to frame %1", position);
+class RealtimeLog final {
+  public:
+    static constexpr int kMaxArgs = 4;
+    // The number of messages a thread may log between two flushes
+    static constexpr size_t kMaxPendingRecords = 1024;
+
+    struct Record {
+        LogLevel level;
+        // Both must be static strings, e.g. literals
+        const char* pContext;
+        // The arguments replace the placeholders %1 to %4
+        const char* pFormat;
+        std::array<double, kMaxArgs> args;
+        int argCount;
+    };
+
+    /// Allocates the ring of the calling thread, which otherwise is
+    /// allocated with the first message of the thread.
+    static void prepareThread();
+
+    template<typename... Args>
+    static void log(LogLevel level,
+            const char* pContext,
+            const char* pFormat,
+            Args... args) {
+        static_assert(sizeof...(Args) <= kMaxArgs,
+                "Too many arguments for a real-time log message");
+        if (!Logging::enabled(level)) {
+            return;
+        }
+        push(Record{level,
+                pContext,
+                pFormat,
+                {static_cast<double>(args)...},
+                static_cast<int>(sizeof...(Args))});
+    }
+
+    template<typename... Args>
+    static void debug(const char* pContext, const char* pFormat, Args... args) {
+        log(LogLevel::Debug, pContext, pFormat, args...);
+    }
+
+    template<typename... Args>
+    static void info(const char* pContext, const char* pFormat, Args... args) {
+        log(LogLevel::Info, pContext, pFormat, args...);
+    }
+
+    template<typename... Args>
+    static void warning(const char* pContext, const char* pFormat, Args... args) {
+        log(LogLevel::Warning, pContext, pFormat, args...);
+    }
+
+    /// Logs the pending messages of all threads. Must only be called by a
+    /// single thread at a time, usually the RealtimeLogWriter.
+    static void flush();
+
+    /// The number of messages that have been dropped because the ring of
+    /// their thread was full.
+    static quint64 droppedMessageCount();
+
+    static QString format(const Record& record);
+
+  private:
+    static void push(const Record& record);
+
+    RealtimeLog() = delete;
+};
+
+/// The thread that periodically flushes the RealtimeLog
+class RealtimeLogWriter final : public QThread {
+    Q_OBJECT
+  public:
+    RealtimeLogWriter();
+    ~RealtimeLogWriter() override;
+
+  protected:
+    void run() override;
+};
+
+} // namespace mixxx
@@ -1,10 +1,19 @@
 #include "util/sample.h"
 
+#include <cmath>
 #include <cstddef>
+#include <cstdint>
 #include <cstdlib>
+#include <initializer_list>
 
 #include "engine/engine.h"
 #include "util/math.h"
+#include "util/sample_kernels.h"
+
+#if defined(_MSC_VER) && !defined(__clang__) && (defined(_M_X64) || defined(_M_IX86))
+#include <immintrin.h>
+#include <intrin.h>
+#endif
 
 #ifdef __WINDOWS__
 #include <QtGlobal>
@@ -20,6 +29,10 @@ typedef qint32 int32_t;
 // using scons optimize=native.
 // "SINT i" is the preferred loop index type that should allow vectorization in
 // general. Unfortunately there are exceptions where "int i" is required for some reasons.
+//
+// The hottest loops are implemented as kernels that are dispatched at runtime
+// to explicitly vectorized variants for the instruction sets supported by the
+// CPU, see util/sample_kernels.h. The generic kernels below are the fallback.
 
 namespace {
 
@@ -38,8 +51,367 @@ constexpr bool useAlignedAlloc() {
             sizeof(CSAMPLE*) == sizeof(size_t);
 }
 
+// Generic kernels that rely on auto-vectorization for the baseline
+// instruction set of the build.
+
+void applyGainGeneric(float* pBuffer,
+        float gain,
+        std::ptrdiff_t numSamples) {
+    // note: LOOP VECTORIZED.
+    for (std::ptrdiff_t i = 0; i < numSamples; ++i) {
+        pBuffer[i] *= gain;
+    }
+}
+
+void applyRampingGainGeneric(float* pBuffer,
+        float startGain,
+        float gainDelta,
+        std::ptrdiff_t numFrames) {
+    // note: LOOP VECTORIZED.
+    for (int i = 0; i < numFrames; ++i) {
+        const float gain = startGain + gainDelta * i;
+        // a loop counter i += 2 prevents vectorizing.
+        pBuffer[i * 2] *= gain;
+        pBuffer[i * 2 + 1] *= gain;
+    }
+}
+
+void copyWithGainGeneric(float* M_RESTRICT pDest,
+        const float* M_RESTRICT pSrc,
+        float gain,
+        std::ptrdiff_t numSamples) {
+    // note: LOOP VECTORIZED.
+    for (std::ptrdiff_t i = 0; i < numSamples; ++i) {
+        pDest[i] = pSrc[i] * gain;
+    }
+}
+
+void copyWithRampingGainGeneric(float* M_RESTRICT pDest,
+        const float* M_RESTRICT pSrc,
+        float startGain,
+        float gainDelta,
+        std::ptrdiff_t numFrames) {
+    // note: LOOP VECTORIZED only with "int i" (not SINT i)
+    for (int i = 0; i < numFrames; ++i) {
+        const float gain = startGain + gainDelta * i;
+        pDest[i * 2] = pSrc[i * 2] * gain;
+        pDest[i * 2 + 1] = pSrc[i * 2 + 1] * gain;
+    }
+}
+
+void addWithGainGeneric(float* M_RESTRICT pDest,
+        const float* M_RESTRICT pSrc,
+        float gain,
+        std::ptrdiff_t numSamples) {
+    // note: LOOP VECTORIZED.
+    for (std::ptrdiff_t i = 0; i < numSamples; ++i) {
+        pDest[i] += pSrc[i] * gain;
+    }
+}
+
+void addWithRampingGainGeneric(float* M_RESTRICT pDest,
+        const float* M_RESTRICT pSrc,
+        float startGain,
+        float gainDelta,
+        std::ptrdiff_t numFrames) {
+    // note: LOOP VECTORIZED.
+    for (int i = 0; i < numFrames; ++i) {
+        const float gain = startGain + gainDelta * i;
+        pDest[i * 2] += pSrc[i * 2] * gain;
+        pDest[i * 2 + 1] += pSrc[i * 2 + 1] * gain;
+    }
+}
+
+void applyGainAndAddGeneric(float* M_RESTRICT pBuffer,
+        float* M_RESTRICT pDest,
+        float gain,
+        std::ptrdiff_t numSamples) {
+    // note: LOOP VECTORIZED.
+    for (std::ptrdiff_t i = 0; i < numSamples; ++i) {
+        pBuffer[i] *= gain;
+        pDest[i] += pBuffer[i];
+    }
+}
+
+void applyRampingGainAndAddGeneric(float* M_RESTRICT pBuffer,
+        float* M_RESTRICT pDest,
+        float startGain,
+        float gainDelta,
+        std::ptrdiff_t numFrames) {
+    // note: LOOP VECTORIZED.
+    for (int i = 0; i < numFrames; ++i) {
+        const float gain = startGain + gainDelta * i;
+        pBuffer[i * 2] *= gain;
+        pBuffer[i * 2 + 1] *= gain;
+        pDest[i * 2] += pBuffer[i * 2];
+        pDest[i * 2 + 1] += pBuffer[i * 2 + 1];
+    }
+}
+
+void add2WithGainGeneric(float* M_RESTRICT pDest,
+        const float* M_RESTRICT pSrc1,
+        float gain1,
+        const float* M_RESTRICT pSrc2,
+        float gain2,
+        std::ptrdiff_t numSamples) {
+    // note: LOOP VECTORIZED.
+    for (int i = 0; i < numSamples; ++i) {
+        pDest[i] += pSrc1[i] * gain1 + pSrc2[i] * gain2;
+    }
+}
+
+void add3WithGainGeneric(float* pDest,
+        const float* M_RESTRICT pSrc1,
+        float gain1,
+        const float* M_RESTRICT pSrc2,
+        float gain2,
+        const float* M_RESTRICT pSrc3,
+        float gain3,
+        std::ptrdiff_t numSamples) {
+    // note: LOOP VECTORIZED.
+    for (std::ptrdiff_t i = 0; i < numSamples; ++i) {
+        pDest[i] += pSrc1[i] * gain1 + pSrc2[i] * gain2 + pSrc3[i] * gain3;
+    }
+}
+
+void sumAbsPerChannelGeneric(float* pSumAbsL,
+        float* pSumAbsR,
+        float* pMaxAbsL,
+        float* pMaxAbsR,
+        const float* pBuffer,
+        std::ptrdiff_t numFrames) {
+    float sumAbsL = 0.0f;
+    float sumAbsR = 0.0f;
+    float maxAbsL = 0.0f;
+    float maxAbsR = 0.0f;
+    for (std::ptrdiff_t i = 0; i < numFrames; ++i) {
+        const float absL = std::fabs(pBuffer[i * 2]);
+        sumAbsL += absL;
+        maxAbsL = std::fmax(maxAbsL, absL);
+        const float absR = std::fabs(pBuffer[i * 2 + 1]);
+        sumAbsR += absR;
+        maxAbsR = std::fmax(maxAbsR, absR);
+    }
+    *pSumAbsL = sumAbsL;
+    *pSumAbsR = sumAbsR;
+    *pMaxAbsL = maxAbsL;
+    *pMaxAbsR = maxAbsR;
+}
+
+void maxAbsPerChannelGeneric(float* pMaxAbsL,
+        float* pMaxAbsR,
+        const float* pBuffer,
+        std::ptrdiff_t numFrames) {
+    float maxAbsL = 0.0f;
+    float maxAbsR = 0.0f;
+    for (std::ptrdiff_t i = 0; i < numFrames; ++i) {
+        maxAbsL = std::fmax(maxAbsL, std::fabs(pBuffer[i * 2]));
+        maxAbsR = std::fmax(maxAbsR, std::fabs(pBuffer[i * 2 + 1]));
+    }
+    *pMaxAbsL = maxAbsL;
+    *pMaxAbsR = maxAbsR;
+}
+
+float maxAbsAmplitudeGeneric(const float* pBuffer,
+        std::ptrdiff_t numSamples) {
+    float maxAbs = 0.0f;
+    for (std::ptrdiff_t i = 0; i < numSamples; ++i) {
+        maxAbs = std::fmax(maxAbs, std::fabs(pBuffer[i]));
+    }
+    return maxAbs;
+}
+
+void interleaveBufferGeneric(float* M_RESTRICT pDest,
+        const float* M_RESTRICT pSrc1,
+        const float* M_RESTRICT pSrc2,
+        std::ptrdiff_t numFrames) {
+    // note: LOOP VECTORIZED.
+    for (std::ptrdiff_t i = 0; i < numFrames; ++i) {
+        pDest[2 * i] = pSrc1[i];
+        pDest[2 * i + 1] = pSrc2[i];
+    }
+}
+
+void crossfadeGeneric(float* M_RESTRICT pDest,
+        const float* M_RESTRICT pFadeOut,
+        const float* M_RESTRICT pFadeIn,
+        float crossMixDelta,
+        std::ptrdiff_t firstStep,
+        std::ptrdiff_t numSamples) {
+    // note: LOOP VECTORIZED.
+    for (std::ptrdiff_t i = 0; i < numSamples; ++i) {
+        const float crossMix = crossMixDelta * static_cast<float>(firstStep + i);
+        pDest[i] = pFadeOut[i] * (1.0f - crossMix) + pFadeIn[i] * crossMix;
+    }
+}
+
+void convertToInt16Generic(std::int16_t* M_RESTRICT pDest,
+        const float* M_RESTRICT pSrc,
+        const float* M_RESTRICT pDither,
+        float scale,
+        float minValue,
+        float maxValue,
+        std::ptrdiff_t numSamples) {
+    for (std::ptrdiff_t i = 0; i < numSamples; ++i) {
+        float scaled = pSrc[i] * scale;
+        if (pDither) {
+            scaled += pDither[i];
+        }
+        pDest[i] = static_cast<std::int16_t>(std::lrint(
+                std::fmin(std::fmax(scaled, minValue), maxValue)));
+    }
+}
+
+void convertToInt32Generic(std::int32_t* M_RESTRICT pDest,
+        const float* M_RESTRICT pSrc,
+        const float* M_RESTRICT pDither,
+        float scale,
+        float minValue,
+        float maxValue,
+        int shift,
+        std::ptrdiff_t numSamples) {
+    for (std::ptrdiff_t i = 0; i < numSamples; ++i) {
+        float scaled = pSrc[i] * scale;
+        if (pDither) {
+            scaled += pDither[i];
+        }
+        const auto value = static_cast<std::int32_t>(std::lrint(
+                std::fmin(std::fmax(scaled, minValue), maxValue)));
+        pDest[i] = static_cast<std::int32_t>(static_cast<std::uint32_t>(value) << shift);
+    }
+}
+
+constexpr mixxx::sampleutil::Kernels kGenericKernels = {
+        mixxx::sampleutil::InstructionSet::Generic,
+        &applyGainGeneric,
+        &applyRampingGainGeneric,
+        &copyWithGainGeneric,
+        &copyWithRampingGainGeneric,
+        &addWithGainGeneric,
+        &addWithRampingGainGeneric,
+        &applyGainAndAddGeneric,
+        &applyRampingGainAndAddGeneric,
+        &add2WithGainGeneric,
+        &add3WithGainGeneric,
+        &sumAbsPerChannelGeneric,
+        &maxAbsPerChannelGeneric,
+        &maxAbsAmplitudeGeneric,
+        &interleaveBufferGeneric,
+        &crossfadeGeneric,
+        &convertToInt16Generic,
+        &convertToInt32Generic,
+};
+
+struct CpuFeatures {
+    bool sse2 = false;
+    bool avx2 = false;
+    bool avx512f = false;
+};
+
+CpuFeatures detectCpuFeatures() {
+    CpuFeatures features;
+#if defined(_MSC_VER) && !defined(__clang__) && (defined(_M_X64) || defined(_M_IX86))
+    int info[4];
+    __cpuid(info, 0);
+    const int maxLeaf = info[0];
+    __cpuid(info, 1);
+    features.sse2 = (info[3] & (1 << 26)) != 0;
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const bool avx = (info[2] & (1 << 28)) != 0;
+    // The OS must save the extended registers on context switches
+    const unsigned long long xcr0 = osxsave ? _xgetbv(0) : 0;
+    const bool ymmEnabled = (xcr0 & 0x06) == 0x06;
+    const bool zmmEnabled = (xcr0 & 0xe6) == 0xe6;
+    if (maxLeaf >= 7) {
+        __cpuidex(info, 7, 0);
+        features.avx2 = avx && ymmEnabled && (info[1] & (1 << 5)) != 0;
+        features.avx512f = avx && zmmEnabled && (info[1] & (1 << 16)) != 0;
+    }
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+    // Also checks if the OS supports the extended registers
+    __builtin_cpu_init();
+    features.sse2 = __builtin_cpu_supports("sse2");
+    features.avx2 = __builtin_cpu_supports("avx2");
+    features.avx512f = __builtin_cpu_supports("avx512f");
+#endif
+    return features;
+}
+
+const CpuFeatures& cpuFeatures() {
+    static const CpuFeatures features = detectCpuFeatures();
+    return features;
+}
+
+const mixxx::sampleutil::Kernels& selectKernels() {
+    using mixxx::sampleutil::InstructionSet;
+    // Ordered from best to worst
+    for (const auto instructionSet : {
+                 InstructionSet::AVX512,
+                 InstructionSet::AVX2,
+                 InstructionSet::SSE2,
+                 InstructionSet::NEON}) {
+        const auto* pKernels = mixxx::sampleutil::kernelsFor(instructionSet);
+        if (pKernels) {
+            return *pKernels;
+        }
+    }
+    return kGenericKernels;
+}
+
 } // anonymous namespace
 
+namespace mixxx {
+
+namespace sampleutil {
+
+const char* instructionSetName(InstructionSet instructionSet) {
+    switch (instructionSet) {
+    case InstructionSet::Generic:
+        return "Generic";
+    case InstructionSet::SSE2:
+        return "SSE2";
+    case InstructionSet::AVX2:
+        return "AVX2";
+    case InstructionSet::AVX512:
+        return "AVX-512";
+    case InstructionSet::NEON:
+        return "NEON";
+    }
+    DEBUG_ASSERT(!"unreachable");
+    return "Unknown";
+}
+
+const Kernels* genericKernels() {
+    return &kGenericKernels;
+}
+
+const Kernels* kernelsFor(InstructionSet instructionSet) {
+    switch (instructionSet) {
+    case InstructionSet::Generic:
+        return genericKernels();
+    case InstructionSet::SSE2:
+        return cpuFeatures().sse2 ? sse2Kernels() : nullptr;
+    case InstructionSet::AVX2:
+        return cpuFeatures().avx2 ? avx2Kernels() : nullptr;
+    case InstructionSet::AVX512:
+        return cpuFeatures().avx512f ? avx512Kernels() : nullptr;
+    case InstructionSet::NEON:
+        // NEON is mandatory if the build targets it
+        return neonKernels();
+    }
+    DEBUG_ASSERT(!"unreachable");
+    return nullptr;
+}
+
+const Kernels& kernels() {
+    static const Kernels& selected = selectKernels();
+    return selected;
+}
+
+} // namespace sampleutil
+
+} // namespace mixxx
+
 // static
 CSAMPLE* SampleUtil::alloc(SINT size) {
     // To speed up vectorization we align our sample buffers to 16-byte (128
@@ -121,10 +493,7 @@ void SampleUtil::applyGain(CSAMPLE* pBuffer, CSAMPLE_GAIN gain,
         return;
     }
 
-    // note: LOOP VECTORIZED.
-    for (SINT i = 0; i < numSamples; ++i) {
-        pBuffer[i] *= gain;
-    }
+    mixxx::sampleutil::kernels().applyGain(pBuffer, gain, numSamples);
 }
 
 // static
@@ -142,18 +511,10 @@ void SampleUtil::applyRampingGain(CSAMPLE* pBuffer, CSAMPLE_GAIN old_gain,
             / CSAMPLE_GAIN(numSamples / 2);
     if (gain_delta != 0) {
         const CSAMPLE_GAIN start_gain = old_gain + gain_delta;
-        // note: LOOP VECTORIZED.
-        for (int i = 0; i < numSamples / 2; ++i) {
-            const CSAMPLE_GAIN gain = start_gain + gain_delta * i;
-            // a loop counter i += 2 prevents vectorizing.
-            pBuffer[i * 2] *= gain;
-            pBuffer[i * 2 + 1] *= gain;
-        }
+        mixxx::sampleutil::kernels().applyRampingGain(
+                pBuffer, start_gain, gain_delta, numSamples / 2);
     } else {
-        // note: LOOP VECTORIZED.
-        for (int i = 0; i < numSamples; ++i) {
-            pBuffer[i] *= old_gain;
-        }
+        mixxx::sampleutil::kernels().applyGain(pBuffer, old_gain, numSamples);
     }
 }
 
@@ -250,10 +611,7 @@ void SampleUtil::addWithGain(CSAMPLE* M_RESTRICT pDest,
         return;
     }
 
-    // note: LOOP VECTORIZED.
-    for (SINT i = 0; i < numSamples; ++i) {
-        pDest[i] += pSrc[i] * gain;
-    }
+    mixxx::sampleutil::kernels().addWithGain(pDest, pSrc, gain, numSamples);
 }
 
 void SampleUtil::addWithRampingGain(CSAMPLE* M_RESTRICT pDest,
@@ -268,17 +626,37 @@ void SampleUtil::addWithRampingGain(CSAMPLE* M_RESTRICT pDest,
             / CSAMPLE_GAIN(numSamples / 2);
     if (gain_delta != 0) {
         const CSAMPLE_GAIN start_gain = old_gain + gain_delta;
-        // note: LOOP VECTORIZED.
-        for (int i = 0; i < numSamples / 2; ++i) {
-            const CSAMPLE_GAIN gain = start_gain + gain_delta * i;
-            pDest[i * 2] += pSrc[i * 2] * gain;
-            pDest[i * 2 + 1] += pSrc[i * 2 + 1] * gain;
-        }
+        mixxx::sampleutil::kernels().addWithRampingGain(
+                pDest, pSrc, start_gain, gain_delta, numSamples / 2);
     } else {
-        // note: LOOP VECTORIZED.
-        for (int i = 0; i < numSamples; ++i) {
-            pDest[i] += pSrc[i] * old_gain;
-        }
+        mixxx::sampleutil::kernels().addWithGain(pDest, pSrc, old_gain, numSamples);
+    }
+}
+
+// static
+void SampleUtil::applyRampingGainAndAdd(CSAMPLE* M_RESTRICT pBuffer,
+        CSAMPLE* M_RESTRICT pDest,
+        CSAMPLE_GAIN old_gain,
+        CSAMPLE_GAIN new_gain,
+        SINT numSamples) {
+    if (old_gain == CSAMPLE_GAIN_ONE && new_gain == CSAMPLE_GAIN_ONE) {
+        add(pDest, pBuffer, numSamples);
+        return;
+    }
+    if (old_gain == CSAMPLE_GAIN_ZERO && new_gain == CSAMPLE_GAIN_ZERO) {
+        clear(pBuffer, numSamples);
+        return;
+    }
+
+    const CSAMPLE_GAIN gain_delta = (new_gain - old_gain)
+            / CSAMPLE_GAIN(numSamples / 2);
+    if (gain_delta != 0) {
+        const CSAMPLE_GAIN start_gain = old_gain + gain_delta;
+        mixxx::sampleutil::kernels().applyRampingGainAndAdd(
+                pBuffer, pDest, start_gain, gain_delta, numSamples / 2);
+    } else {
+        mixxx::sampleutil::kernels().applyGainAndAdd(
+                pBuffer, pDest, old_gain, numSamples);
     }
 }
 
@@ -295,10 +673,8 @@ void SampleUtil::add2WithGain(CSAMPLE* M_RESTRICT pDest,
         return;
     }
 
-    // note: LOOP VECTORIZED.
-    for (int i = 0; i < numSamples; ++i) {
-        pDest[i] += pSrc1[i] * gain1 + pSrc2[i] * gain2;
-    }
+    mixxx::sampleutil::kernels().add2WithGain(
+            pDest, pSrc1, gain1, pSrc2, gain2, numSamples);
 }
 
 // static
@@ -318,10 +694,8 @@ void SampleUtil::add3WithGain(CSAMPLE* pDest,
         return;
     }
 
-    // note: LOOP VECTORIZED.
-    for (SINT i = 0; i < numSamples; ++i) {
-        pDest[i] += pSrc1[i] * gain1 + pSrc2[i] * gain2 + pSrc3[i] * gain3;
-    }
+    mixxx::sampleutil::kernels().add3WithGain(
+            pDest, pSrc1, gain1, pSrc2, gain2, pSrc3, gain3, numSamples);
 }
 
 // static
@@ -337,10 +711,7 @@ void SampleUtil::copyWithGain(CSAMPLE* M_RESTRICT pDest,
         return;
     }
 
-    // note: LOOP VECTORIZED.
-    for (SINT i = 0; i < numSamples; ++i) {
-        pDest[i] = pSrc[i] * gain;
-    }
+    mixxx::sampleutil::kernels().copyWithGain(pDest, pSrc, gain, numSamples);
 
     // OR! need to test which fares better
     // copy(pDest, pSrc, iNumSamples);
@@ -366,17 +737,10 @@ void SampleUtil::copyWithRampingGain(CSAMPLE* M_RESTRICT pDest,
             / CSAMPLE_GAIN(numSamples / 2);
     if (gain_delta != 0) {
         const CSAMPLE_GAIN start_gain = old_gain + gain_delta;
-        // note: LOOP VECTORIZED only with "int i" (not SINT i)
-        for (int i = 0; i < numSamples / 2; ++i) {
-            const CSAMPLE_GAIN gain = start_gain + gain_delta * i;
-            pDest[i * 2] = pSrc[i * 2] * gain;
-            pDest[i * 2 + 1] = pSrc[i * 2 + 1] * gain;
-        }
+        mixxx::sampleutil::kernels().copyWithRampingGain(
+                pDest, pSrc, start_gain, gain_delta, numSamples / 2);
     } else {
-        // note: LOOP VECTORIZED.
-        for (SINT i = 0; i < numSamples; ++i) {
-            pDest[i] = pSrc[i] * old_gain;
-        }
+        mixxx::sampleutil::kernels().copyWithGain(pDest, pSrc, old_gain, numSamples);
     }
 
     // OR! need to test which fares better
@@ -400,45 +764,98 @@ void SampleUtil::convertS16ToFloat32(CSAMPLE* M_RESTRICT pDest,
 
 //static
 void SampleUtil::convertFloat32ToS16(SAMPLE* pDest, const CSAMPLE* pSrc,
-        SINT numSamples) {
+        SINT numSamples, TpdfDither* pDither) {
     // We use here -SAMPLE_MINIMUM for a perfect round trip with convertS16ToFloat32
     // +1.0 is clamped to 32767 (0.99996942)
     DEBUG_ASSERT(-SAMPLE_MINIMUM >= SAMPLE_MAXIMUM);
+    static_assert(sizeof(SAMPLE) == sizeof(std::int16_t));
     const CSAMPLE kConversionFactor = SAMPLE_MINIMUM * -1.0f;
-    // note: LOOP VECTORIZED only with "int i" (not SINT i)
-    for (int i = 0; i < numSamples; ++i) {
-        pDest[i] = static_cast<SAMPLE>(math_clamp(pSrc[i] * kConversionFactor,
-                static_cast<CSAMPLE>(SAMPLE_MINIMUM),
-                static_cast<CSAMPLE>(SAMPLE_MAXIMUM)));
+    const auto& kernels = mixxx::sampleutil::kernels();
+    if (!pDither) {
+        kernels.convertToInt16(pDest,
+                pSrc,
+                nullptr,
+                kConversionFactor,
+                SAMPLE_MINIMUM,
+                SAMPLE_MAXIMUM,
+                numSamples);
+        return;
+    }
+    CSAMPLE noise[TpdfDither::kMaxSamples];
+    while (numSamples > 0) {
+        const SINT count = math_min(numSamples, TpdfDither::kMaxSamples);
+        pDither->generate(noise, count);
+        kernels.convertToInt16(pDest,
+                pSrc,
+                noise,
+                kConversionFactor,
+                SAMPLE_MINIMUM,
+                SAMPLE_MAXIMUM,
+                count);
+        pDest += count;
+        pSrc += count;
+        numSamples -= count;
     }
 }
 
+//static
+void SampleUtil::convertFloat32ToS32(std::int32_t* pDest, const CSAMPLE* pSrc,
+        SINT numSamples, int bits, TpdfDither* pDither) {
+    // Floats have 24 significant bits, more are not possible
+    VERIFY_OR_DEBUG_ASSERT(bits > 1 && bits <= 24) {
+        bits = 24;
+    }
+    const float scale = static_cast<float>(1 << (bits - 1));
+    const float minValue = -scale;
+    const float maxValue = scale - 1.0f;
+    const int shift = 32 - bits;
+    const auto& kernels = mixxx::sampleutil::kernels();
+    if (!pDither) {
+        kernels.convertToInt32(
+                pDest, pSrc, nullptr, scale, minValue, maxValue, shift, numSamples);
+        return;
+    }
+    CSAMPLE noise[TpdfDither::kMaxSamples];
+    while (numSamples > 0) {
+        const SINT count = math_min(numSamples, TpdfDither::kMaxSamples);
+        pDither->generate(noise, count);
+        kernels.convertToInt32(
+                pDest, pSrc, noise, scale, minValue, maxValue, shift, count);
+        pDest += count;
+        pSrc += count;
+        numSamples -= count;
+    }
+}
+
+void SampleUtil::TpdfDither::generate(CSAMPLE* pNoise, SINT numSamples) {
+    DEBUG_ASSERT(numSamples <= kMaxSamples);
+    // xorshift32, the two 16 bit halves of each number are independent
+    // uniformly distributed values, their sum is triangularly distributed.
+    constexpr float kScale = 1.0f / 65536.0f;
+    std::uint32_t state = m_state;
+    for (SINT i = 0; i < numSamples; ++i) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        const auto sum = static_cast<float>((state & 0xffff) + (state >> 16));
+        pNoise[i] = sum * kScale - 1.0f;
+    }
+    m_state = state;
+}
+
 // static
 SampleUtil::CLIP_STATUS SampleUtil::sumAbsPerChannel(CSAMPLE* pfAbsL,
         CSAMPLE* pfAbsR, const CSAMPLE* pBuffer, SINT numSamples) {
-    CSAMPLE fAbsL = CSAMPLE_ZERO;
-    CSAMPLE fAbsR = CSAMPLE_ZERO;
-    CSAMPLE clippedL = 0;
-    CSAMPLE clippedR = 0;
-
-    // note: LOOP VECTORIZED.
-    for (SINT i = 0; i < numSamples / 2; ++i) {
-        CSAMPLE absl = fabs(pBuffer[i * 2]);
-        fAbsL += absl;
-        clippedL += absl > CSAMPLE_PEAK ? 1 : 0;
-        CSAMPLE absr = fabs(pBuffer[i * 2 + 1]);
-        fAbsR += absr;
-        // Replacing the code with a bool clipped will prevent vetorizing
-        clippedR += absr > CSAMPLE_PEAK ? 1 : 0;
-    }
+    CSAMPLE maxAbsL = CSAMPLE_ZERO;
+    CSAMPLE maxAbsR = CSAMPLE_ZERO;
+    mixxx::sampleutil::kernels().sumAbsPerChannel(
+            pfAbsL, pfAbsR, &maxAbsL, &maxAbsR, pBuffer, numSamples / 2);
 
-    *pfAbsL = fAbsL;
-    *pfAbsR = fAbsR;
     SampleUtil::CLIP_STATUS clipping = SampleUtil::NO_CLIPPING;
-    if (clippedL > 0) {
+    if (maxAbsL > CSAMPLE_PEAK) {
         clipping |= SampleUtil::CLIPPING_LEFT;
     }
-    if (clippedR > 0) {
+    if (maxAbsR > CSAMPLE_PEAK) {
         clipping |= SampleUtil::CLIPPING_RIGHT;
     }
     return clipping;
@@ -460,15 +877,15 @@ CSAMPLE SampleUtil::rms(const CSAMPLE* pBuffer, SINT numSamples) {
     return sqrtf(sumSquared(pBuffer, numSamples) / numSamples);
 }
 
+// static
+void SampleUtil::maxAbsPerChannel(CSAMPLE* pfMaxAbsL,
+        CSAMPLE* pfMaxAbsR, const CSAMPLE* pBuffer, SINT numSamples) {
+    mixxx::sampleutil::kernels().maxAbsPerChannel(
+            pfMaxAbsL, pfMaxAbsR, pBuffer, numSamples / 2);
+}
+
 CSAMPLE SampleUtil::maxAbsAmplitude(const CSAMPLE* pBuffer, SINT numSamples) {
-    CSAMPLE max = pBuffer[0];
-    for (SINT i = 1; i < numSamples; ++i) {
-        CSAMPLE absValue = abs(pBuffer[i]);
-        if (absValue > max) {
-            max = absValue;
-        }
-    }
-    return max;
+    return mixxx::sampleutil::kernels().maxAbsAmplitude(pBuffer, numSamples);
 }
 
 // static
@@ -485,11 +902,7 @@ void SampleUtil::interleaveBuffer(CSAMPLE* M_RESTRICT pDest,
         const CSAMPLE* M_RESTRICT pSrc1,
         const CSAMPLE* M_RESTRICT pSrc2,
         SINT numFrames) {
-    // note: LOOP VECTORIZED.
-    for (SINT i = 0; i < numFrames; ++i) {
-        pDest[2 * i] = pSrc1[i];
-        pDest[2 * i + 1] = pSrc2[i];
-    }
+    mixxx::sampleutil::kernels().interleaveBuffer(pDest, pSrc1, pSrc2, numFrames);
 }
 
 // static
@@ -504,6 +917,19 @@ void SampleUtil::deinterleaveBuffer(CSAMPLE* M_RESTRICT pDest1,
     }
 }
 
+// static
+void SampleUtil::deinterleaveBufferWithGain(CSAMPLE* M_RESTRICT pDest1,
+        CSAMPLE* M_RESTRICT pDest2,
+        const CSAMPLE* M_RESTRICT pSrc,
+        CSAMPLE_GAIN gain,
+        SINT numFrames) {
+    // note: LOOP VECTORIZED.
+    for (SINT i = 0; i < numFrames; ++i) {
+        pDest1[i] = pSrc[i * 2] * gain;
+        pDest2[i] = pSrc[i * 2 + 1] * gain;
+    }
+}
+
 // static
 void SampleUtil::linearCrossfadeBuffersOut(
         CSAMPLE* M_RESTRICT pDestSrcFadeOut,
@@ -547,6 +973,32 @@ void SampleUtil::linearCrossfadeBuffersIn(
     }
 }
 
+// static
+void SampleUtil::equalPowerCrossfadeBuffersIn(
+        CSAMPLE* M_RESTRICT pDestSrcFadeIn,
+        const CSAMPLE* M_RESTRICT pSrcFadeOut,
+        SINT numSamples,
+        CSAMPLE_GAIN fadeInStart,
+        CSAMPLE_GAIN fadeInEnd) {
+    const int numFrames = static_cast<int>(numSamples / 2);
+    if (numFrames <= 0) {
+        return;
+    }
+    const CSAMPLE_GAIN cross_inc = (fadeInEnd - fadeInStart) / CSAMPLE_GAIN(numFrames);
+    // note: LOOP VECTORIZED only with "int i" (not SINT i)
+    for (int i = 0; i < numFrames; ++i) {
+        const CSAMPLE_GAIN cross_mix = fadeInStart + cross_inc * i;
+        pDestSrcFadeIn[i * 2] = pDestSrcFadeIn[i * 2] * std::sqrt(cross_mix) +
+                pSrcFadeOut[i * 2] * std::sqrt(CSAMPLE_GAIN_ONE - cross_mix);
+    }
+    // note: LOOP VECTORIZED only with "int i" (not SINT i)
+    for (int i = 0; i < numFrames; ++i) {
+        const CSAMPLE_GAIN cross_mix = fadeInStart + cross_inc * i;
+        pDestSrcFadeIn[i * 2 + 1] = pDestSrcFadeIn[i * 2 + 1] * std::sqrt(cross_mix) +
+                pSrcFadeOut[i * 2 + 1] * std::sqrt(CSAMPLE_GAIN_ONE - cross_mix);
+    }
+}
+
 // static
 void SampleUtil::mixStereoToMono(CSAMPLE* M_RESTRICT pDest,
         const CSAMPLE* M_RESTRICT pSrc,
@@ -669,3 +1121,65 @@ void SampleUtil::copyReverse(CSAMPLE* M_RESTRICT pDest,
         pDest[j * 2 + 1] = pSrc[endpos];
     }
 }
+
+// static
+SINT SampleUtil::copyToRingBuffer(CSAMPLE* M_RESTRICT pRing,
+        SINT ringSize,
+        SINT ringPos,
+        const CSAMPLE* M_RESTRICT pSrc,
+        SINT numSamples) {
+    DEBUG_ASSERT(numSamples <= ringSize);
+    DEBUG_ASSERT(ringPos >= 0 && ringPos < ringSize);
+    const SINT firstCount = math_min(numSamples, ringSize - ringPos);
+    copy(pRing + ringPos, pSrc, firstCount);
+    copy(pRing, pSrc + firstCount, numSamples - firstCount);
+    ringPos += numSamples;
+    return ringPos >= ringSize ? ringPos - ringSize : ringPos;
+}
+
+// static
+void SampleUtil::copyFromRingBuffer(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pRing,
+        SINT ringSize,
+        SINT ringPos,
+        SINT numSamples) {
+    DEBUG_ASSERT(numSamples <= ringSize);
+    DEBUG_ASSERT(ringPos >= 0 && ringPos < ringSize);
+    const SINT firstCount = math_min(numSamples, ringSize - ringPos);
+    copy(pDest, pRing + ringPos, firstCount);
+    copy(pDest + firstCount, pRing, numSamples - firstCount);
+}
+
+// static
+void SampleUtil::linearCrossfadeFromRingBuffer(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pRing,
+        SINT ringSize,
+        SINT fadeOutPos,
+        SINT fadeInPos,
+        CSAMPLE_GAIN crossMixDelta,
+        SINT firstStep,
+        SINT numSamples) {
+    DEBUG_ASSERT(fadeOutPos >= 0 && fadeOutPos < ringSize);
+    DEBUG_ASSERT(fadeInPos >= 0 && fadeInPos < ringSize);
+    // Split into segments where neither of the sources wraps around
+    SINT offset = 0;
+    while (offset < numSamples) {
+        const SINT count = math_min(numSamples - offset,
+                math_min(ringSize - fadeOutPos, ringSize - fadeInPos));
+        mixxx::sampleutil::kernels().crossfade(pDest + offset,
+                pRing + fadeOutPos,
+                pRing + fadeInPos,
+                crossMixDelta,
+                firstStep + offset,
+                count);
+        offset += count;
+        fadeOutPos += count;
+        if (fadeOutPos == ringSize) {
+            fadeOutPos = 0;
+        }
+        fadeInPos += count;
+        if (fadeInPos == ringSize) {
+            fadeInPos = 0;
+        }
+    }
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <algorithm>
+#include <cstdint>
 #include <cstring> // memset
 
 #include <QFlags>
@@ -189,6 +190,12 @@ class SampleUtil {
             CSAMPLE_GAIN old_gain, CSAMPLE_GAIN new_gain,
             SINT numSamples);
 
+    // Same as applyRampingGain() followed by add(pDest, pBuffer), but
+    // reads pBuffer only once
+    static void applyRampingGainAndAdd(CSAMPLE* pBuffer, CSAMPLE* pDest,
+            CSAMPLE_GAIN old_gain, CSAMPLE_GAIN new_gain,
+            SINT numSamples);
+
     // Add to each sample of pDest, pSrc1 multiplied by gain1 plus pSrc2
     // multiplied by gain2
     static void add2WithGain(CSAMPLE* pDest, const CSAMPLE* pSrc1,
@@ -206,10 +213,32 @@ class SampleUtil {
     static void convertS16ToFloat32(CSAMPLE* pDest, const SAMPLE* pSrc,
             SINT numSamples);
 
+    // Triangular (TPDF) dither noise of +/-1 LSB, added before quantizing
+    // to decorrelate the quantization error from the signal. Each output
+    // stream needs its own instance.
+    class TpdfDither {
+      public:
+        static constexpr SINT kMaxSamples = 256;
+
+        // Fills pNoise with numSamples <= kMaxSamples values in [-1.0, 1.0)
+        void generate(CSAMPLE* pNoise, SINT numSamples);
+
+      private:
+        std::uint32_t m_state = 0x9e3779b9;
+    };
+
     // Convert and normalize a buffer of CSAMPLEs in the range [-1.0, 1.0]
-    // to a buffer of SAMPLEs in the range [-SAMPLE_MAX, SAMPLE_MAX].
+    // to a buffer of SAMPLEs in the range [-SAMPLE_MAX, SAMPLE_MAX]. The
+    // samples are rounded to the nearest value, with dither if pDither is
+    // not nullptr.
     static void convertFloat32ToS16(SAMPLE* pDest, const CSAMPLE* pSrc,
-            SINT numSamples);
+            SINT numSamples, TpdfDither* pDither = nullptr);
+
+    // Convert a buffer of CSAMPLEs in the range [-1.0, 1.0] to samples
+    // with bits <= 24 significant bits, aligned to the left of 32 bit
+    // integers as expected by sf_write_int().
+    static void convertFloat32ToS32(std::int32_t* pDest, const CSAMPLE* pSrc,
+            SINT numSamples, int bits, TpdfDither* pDither = nullptr);
 
     // For each pair of samples in pBuffer (l,r) -- stores the sum of the
     // absolute values of l in pfAbsL, and the sum of the absolute values of r
@@ -218,6 +247,11 @@ class SampleUtil {
     static CLIP_STATUS sumAbsPerChannel(CSAMPLE* pfAbsL, CSAMPLE* pfAbsR,
             const CSAMPLE* pBuffer, SINT numSamples);
 
+    // For each pair of samples in pBuffer (l,r) -- stores the maximum of the
+    // absolute values of l in pfMaxAbsL and of r in pfMaxAbsR.
+    static void maxAbsPerChannel(CSAMPLE* pfMaxAbsL, CSAMPLE* pfMaxAbsR,
+            const CSAMPLE* pBuffer, SINT numSamples);
+
     // Returns the sum of the squared values of the buffer.
     static CSAMPLE sumSquared(const CSAMPLE* pBuffer, SINT numSamples);
 
@@ -245,6 +279,11 @@ class SampleUtil {
     static void deinterleaveBuffer(CSAMPLE* pDest1, CSAMPLE* pDest2,
             const CSAMPLE* pSrc, SINT numSamples);
 
+    // Same as deinterleaveBuffer, but multiplies each sample by gain in the
+    // same pass.
+    static void deinterleaveBufferWithGain(CSAMPLE* pDest1, CSAMPLE* pDest2,
+            const CSAMPLE* pSrc, CSAMPLE_GAIN gain, SINT numSamples);
+
     /// Crossfade two buffers together. All the buffers must be the same length.
     /// pDest is in one version the Out and in the other version the In buffer.
     static void linearCrossfadeBuffersOut(
@@ -252,6 +291,17 @@ class SampleUtil {
     static void linearCrossfadeBuffersIn(
             CSAMPLE* pDestSrcFadeIn, const CSAMPLE* pSrcFadeOut, SINT numSamples);
 
+    /// Crossfade two stereo buffers with constant power, i.e. the squared
+    /// gains sum up to one. The fade-in gain is sqrt(x) with x rising
+    /// linearly from fadeInStart towards fadeInEnd, both within [0, 1], so
+    /// one crossfade can be split across several buffers.
+    static void equalPowerCrossfadeBuffersIn(
+            CSAMPLE* pDestSrcFadeIn,
+            const CSAMPLE* pSrcFadeOut,
+            SINT numSamples,
+            CSAMPLE_GAIN fadeInStart,
+            CSAMPLE_GAIN fadeInEnd);
+
     // Mix a buffer down to mono, putting the result in both of the channels.
     // This uses a simple (L+R)/2 method, which assumes that the audio is
     // "mono-compatible", ie there are no major out-of-phase parts of the signal.
@@ -309,6 +359,35 @@ class SampleUtil {
     static void copyReverse(CSAMPLE* M_RESTRICT pDest,
             const CSAMPLE* M_RESTRICT pSrc, SINT numSamples);
 
+    // Copies numSamples from pSrc into the ring buffer pRing of ringSize
+    // samples starting at ringPos and returns the position after the last
+    // written sample. numSamples must not exceed ringSize.
+    static SINT copyToRingBuffer(CSAMPLE* M_RESTRICT pRing,
+            SINT ringSize,
+            SINT ringPos,
+            const CSAMPLE* M_RESTRICT pSrc,
+            SINT numSamples);
+
+    // Copies numSamples from the ring buffer pRing of ringSize samples
+    // starting at ringPos into pDest. numSamples must not exceed ringSize.
+    static void copyFromRingBuffer(CSAMPLE* M_RESTRICT pDest,
+            const CSAMPLE* M_RESTRICT pRing,
+            SINT ringSize,
+            SINT ringPos,
+            SINT numSamples);
+
+    // Crossfades linearly from the samples at fadeOutPos to the samples at
+    // fadeInPos of the ring buffer pRing into pDest. The weight of the
+    // sample i of the fade-in is crossMixDelta * (firstStep + i).
+    static void linearCrossfadeFromRingBuffer(CSAMPLE* M_RESTRICT pDest,
+            const CSAMPLE* M_RESTRICT pRing,
+            SINT ringSize,
+            SINT fadeOutPos,
+            SINT fadeInPos,
+            CSAMPLE_GAIN crossMixDelta,
+            SINT firstStep,
+            SINT numSamples);
+
 
     // Include auto-generated methods (e.g. copyXWithGain, copyXWithRampingGain,
     // etc.)
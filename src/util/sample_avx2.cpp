@@ -0,0 +1,98 @@
+#include "util/sample_kernels.h"
+
+// Compiled with the AVX2 compiler flags, see CMakeLists.txt
+#if defined(__AVX2__)
+
+#include <immintrin.h>
+
+namespace {
+
+struct Avx2 {
+    using type = __m256;
+    static constexpr std::ptrdiff_t kWidth = 8;
+
+    static type load(const float* p) {
+        return _mm256_loadu_ps(p);
+    }
+    static void store(float* p, type v) {
+        _mm256_storeu_ps(p, v);
+    }
+    static type set1(float x) {
+        return _mm256_set1_ps(x);
+    }
+    static type add(type a, type b) {
+        return _mm256_add_ps(a, b);
+    }
+    static type mul(type a, type b) {
+        return _mm256_mul_ps(a, b);
+    }
+    static type max(type a, type b) {
+        return _mm256_max_ps(a, b);
+    }
+    static type abs(type a) {
+        // Clear the sign bit
+        return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a);
+    }
+    static type frameOffsets() {
+        return _mm256_setr_ps(0.0f, 0.0f, 1.0f, 1.0f, 2.0f, 2.0f, 3.0f, 3.0f);
+    }
+    static type sampleOffsets() {
+        return _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f);
+    }
+    static void interleave(float* p, type a, type b) {
+        // The unpack instructions operate on each 128 bit lane separately:
+        // lo = a0 b0 a1 b1 | a4 b4 a5 b5
+        // hi = a2 b2 a3 b3 | a6 b6 a7 b7
+        const type lo = _mm256_unpacklo_ps(a, b);
+        const type hi = _mm256_unpackhi_ps(a, b);
+        _mm256_storeu_ps(p, _mm256_permute2f128_ps(lo, hi, 0x20));
+        _mm256_storeu_ps(p + kWidth, _mm256_permute2f128_ps(lo, hi, 0x31));
+    }
+    static type min(type a, type b) {
+        return _mm256_min_ps(a, b);
+    }
+    static void storeInt16(std::int16_t* p, type v) {
+        // Packing the two 128 bit halves keeps the order of the samples
+        const __m256i i = _mm256_cvtps_epi32(v);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(p),
+                _mm_packs_epi32(_mm256_castsi256_si128(i),
+                        _mm256_extracti128_si256(i, 1)));
+    }
+    static void storeInt32(std::int32_t* p, type v, int shift) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(p),
+                _mm256_sll_epi32(_mm256_cvtps_epi32(v), _mm_cvtsi32_si128(shift)));
+    }
+};
+
+} // anonymous namespace
+
+#include "util/sample_kernels_impl.h"
+
+namespace mixxx {
+
+namespace sampleutil {
+
+const Kernels* avx2Kernels() {
+    static const Kernels kKernels = makeKernels<Avx2>(InstructionSet::AVX2);
+    return &kKernels;
+}
+
+} // namespace sampleutil
+
+} // namespace mixxx
+
+#else
+
+namespace mixxx {
+
+namespace sampleutil {
+
+const Kernels* avx2Kernels() {
+    return nullptr;
+}
+
+} // namespace sampleutil
+
+} // namespace mixxx
+
+#endif
@@ -0,0 +1,96 @@
+#include "util/sample_kernels.h"
+
+// Compiled with the AVX-512 compiler flags, see CMakeLists.txt
+#if defined(__AVX512F__)
+
+#include <immintrin.h>
+
+namespace {
+
+struct Avx512 {
+    using type = __m512;
+    static constexpr std::ptrdiff_t kWidth = 16;
+
+    static type load(const float* p) {
+        return _mm512_loadu_ps(p);
+    }
+    static void store(float* p, type v) {
+        _mm512_storeu_ps(p, v);
+    }
+    static type set1(float x) {
+        return _mm512_set1_ps(x);
+    }
+    static type add(type a, type b) {
+        return _mm512_add_ps(a, b);
+    }
+    static type mul(type a, type b) {
+        return _mm512_mul_ps(a, b);
+    }
+    static type max(type a, type b) {
+        return _mm512_max_ps(a, b);
+    }
+    static type abs(type a) {
+        return _mm512_abs_ps(a);
+    }
+    static type frameOffsets() {
+        return _mm512_setr_ps(0.0f, 0.0f, 1.0f, 1.0f, 2.0f, 2.0f, 3.0f, 3.0f,
+                4.0f, 4.0f, 5.0f, 5.0f, 6.0f, 6.0f, 7.0f, 7.0f);
+    }
+    static type sampleOffsets() {
+        return _mm512_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f,
+                8.0f, 9.0f, 10.0f, 11.0f, 12.0f, 13.0f, 14.0f, 15.0f);
+    }
+    static void interleave(float* p, type a, type b) {
+        // Indices 0..15 select from a, 16..31 from b
+        const __m512i lo = _mm512_setr_epi32(
+                0, 16, 1, 17, 2, 18, 3, 19, 4, 20, 5, 21, 6, 22, 7, 23);
+        const __m512i hi = _mm512_setr_epi32(
+                8, 24, 9, 25, 10, 26, 11, 27, 12, 28, 13, 29, 14, 30, 15, 31);
+        _mm512_storeu_ps(p, _mm512_permutex2var_ps(a, lo, b));
+        _mm512_storeu_ps(p + kWidth, _mm512_permutex2var_ps(a, hi, b));
+    }
+    static type min(type a, type b) {
+        return _mm512_min_ps(a, b);
+    }
+    static void storeInt16(std::int16_t* p, type v) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(p),
+                _mm512_cvtsepi32_epi16(_mm512_cvtps_epi32(v)));
+    }
+    static void storeInt32(std::int32_t* p, type v, int shift) {
+        _mm512_storeu_si512(p,
+                _mm512_sll_epi32(_mm512_cvtps_epi32(v), _mm_cvtsi32_si128(shift)));
+    }
+};
+
+} // anonymous namespace
+
+#include "util/sample_kernels_impl.h"
+
+namespace mixxx {
+
+namespace sampleutil {
+
+const Kernels* avx512Kernels() {
+    static const Kernels kKernels = makeKernels<Avx512>(InstructionSet::AVX512);
+    return &kKernels;
+}
+
+} // namespace sampleutil
+
+} // namespace mixxx
+
+#else
+
+namespace mixxx {
+
+namespace sampleutil {
+
+const Kernels* avx512Kernels() {
+    return nullptr;
+}
+
+} // namespace sampleutil
+
+} // namespace mixxx
+
+#endif
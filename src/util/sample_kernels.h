@@ -0,0 +1,153 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Explicitly vectorized implementations of the hot SampleUtil functions.
+//
+// The generic implementations in sample.cpp rely on auto-vectorization
+// for the baseline instruction set of the build, e.g. only SSE2 for
+// portable x86-64 builds. Additional variants for wider instruction sets
+// are compiled in separate translation units with the corresponding
+// compiler flags. The best variant that is supported by the CPU is
+// selected once at runtime.
+//
+// NOTE: This header is included by the translation units that are compiled
+// with special instruction set flags. It must not define any inline
+// functions that might end up in other translation units! Only plain
+// types like float, std::int32_t and std::ptrdiff_t are used for the same
+// reason.
+namespace mixxx {
+
+namespace sampleutil {
+
+enum class InstructionSet {
+    Generic,
+    SSE2,
+    AVX2,
+    AVX512,
+    NEON,
+};
+
+const char* instructionSetName(InstructionSet instructionSet);
+
+// All ramping kernels operate on interleaved stereo frames and apply the
+// gain startGain + gainDelta * i to both samples of frame i.
+struct Kernels {
+    InstructionSet instructionSet;
+
+    void (*applyGain)(float* pBuffer,
+            float gain,
+            std::ptrdiff_t numSamples);
+    void (*applyRampingGain)(float* pBuffer,
+            float startGain,
+            float gainDelta,
+            std::ptrdiff_t numFrames);
+    void (*copyWithGain)(float* pDest,
+            const float* pSrc,
+            float gain,
+            std::ptrdiff_t numSamples);
+    void (*copyWithRampingGain)(float* pDest,
+            const float* pSrc,
+            float startGain,
+            float gainDelta,
+            std::ptrdiff_t numFrames);
+    void (*addWithGain)(float* pDest,
+            const float* pSrc,
+            float gain,
+            std::ptrdiff_t numSamples);
+    void (*addWithRampingGain)(float* pDest,
+            const float* pSrc,
+            float startGain,
+            float gainDelta,
+            std::ptrdiff_t numFrames);
+    // Applies the gain to pBuffer in place and adds the result to pDest
+    void (*applyGainAndAdd)(float* pBuffer,
+            float* pDest,
+            float gain,
+            std::ptrdiff_t numSamples);
+    void (*applyRampingGainAndAdd)(float* pBuffer,
+            float* pDest,
+            float startGain,
+            float gainDelta,
+            std::ptrdiff_t numFrames);
+    void (*add2WithGain)(float* pDest,
+            const float* pSrc1,
+            float gain1,
+            const float* pSrc2,
+            float gain2,
+            std::ptrdiff_t numSamples);
+    void (*add3WithGain)(float* pDest,
+            const float* pSrc1,
+            float gain1,
+            const float* pSrc2,
+            float gain2,
+            const float* pSrc3,
+            float gain3,
+            std::ptrdiff_t numSamples);
+    // Stores the sums and the maxima of the absolute values per channel.
+    void (*sumAbsPerChannel)(float* pSumAbsL,
+            float* pSumAbsR,
+            float* pMaxAbsL,
+            float* pMaxAbsR,
+            const float* pBuffer,
+            std::ptrdiff_t numFrames);
+    // Stores only the maxima of the absolute values per channel.
+    void (*maxAbsPerChannel)(float* pMaxAbsL,
+            float* pMaxAbsR,
+            const float* pBuffer,
+            std::ptrdiff_t numFrames);
+    float (*maxAbsAmplitude)(const float* pBuffer,
+            std::ptrdiff_t numSamples);
+    void (*interleaveBuffer)(float* pDest,
+            const float* pSrc1,
+            const float* pSrc2,
+            std::ptrdiff_t numFrames);
+    // Crossfades per sample with the weight crossMixDelta * (firstStep + i)
+    // of pFadeIn[i]. The buffers must not overlap.
+    void (*crossfade)(float* pDest,
+            const float* pFadeOut,
+            const float* pFadeIn,
+            float crossMixDelta,
+            std::ptrdiff_t firstStep,
+            std::ptrdiff_t numSamples);
+    // Converts pSrc * scale + pDither to integers, clamped to
+    // [minValue, maxValue] and rounded to the nearest integer. pDither may
+    // be nullptr.
+    void (*convertToInt16)(std::int16_t* pDest,
+            const float* pSrc,
+            const float* pDither,
+            float scale,
+            float minValue,
+            float maxValue,
+            std::ptrdiff_t numSamples);
+    // Same as convertToInt16, but the results are shifted left by shift
+    // bits, e.g. to align 24 bit samples to the left of 32 bit integers.
+    void (*convertToInt32)(std::int32_t* pDest,
+            const float* pSrc,
+            const float* pDither,
+            float scale,
+            float minValue,
+            float maxValue,
+            int shift,
+            std::ptrdiff_t numSamples);
+};
+
+// The variants, nullptr if not available for the target architecture.
+// The CPU support is not checked.
+const Kernels* genericKernels();
+const Kernels* sse2Kernels();
+const Kernels* avx2Kernels();
+const Kernels* avx512Kernels();
+const Kernels* neonKernels();
+
+// Returns nullptr if the variant is not available for the target
+// architecture or not supported by the CPU.
+const Kernels* kernelsFor(InstructionSet instructionSet);
+
+// The best variant that is supported by the CPU, selected once.
+const Kernels& kernels();
+
+} // namespace sampleutil
+
+} // namespace mixxx
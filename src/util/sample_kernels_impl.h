@@ -0,0 +1,496 @@
+#pragma once
+
+// Generic implementation of the SampleUtil kernels on top of a thin
+// wrapper for the SIMD registers of a particular instruction set.
+//
+// Only include this file from the translation units that provide the
+// variants for a particular instruction set, after the wrapper type has
+// been defined! Everything is defined in an anonymous namespace to get
+// internal linkage. Otherwise the linker might pick a variant that has
+// been compiled for a different instruction set than the caller.
+//
+// The wrapper type V is expected to provide:
+//   type                   - the register type
+//   kWidth                 - the number of floats per register
+//   load(p), store(p, v)   - unaligned memory access
+//   set1(x)                - broadcast
+//   add(a, b), mul(a, b), max(a, b), abs(a)
+//   frameOffsets()         - the frame index of each lane for interleaved
+//                            stereo samples, i.e. [0, 0, 1, 1, 2, 2, ...]
+//   sampleOffsets()        - the index of each lane, i.e. [0, 1, 2, 3, ...]
+//   interleave(p, a, b)    - store 2 * kWidth interleaved samples
+//   min(a, b)
+//   storeInt16(p, v)       - round to the nearest integer and store
+//   storeInt32(p, v, shift)  with the current rounding mode like lrint()
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#include "util/sample_kernels.h"
+
+namespace {
+
+using mixxx::sampleutil::InstructionSet;
+using mixxx::sampleutil::Kernels;
+
+template<typename V>
+inline typename V::type rampingGain(
+        typename V::type startGain,
+        typename V::type gainDelta,
+        std::ptrdiff_t frame) {
+    // Same order of operations as the scalar code to get the
+    // same results: startGain + gainDelta * i
+    const auto frames = V::add(
+            V::set1(static_cast<float>(frame)),
+            V::frameOffsets());
+    return V::add(startGain, V::mul(gainDelta, frames));
+}
+
+template<typename V>
+void applyGain(float* pBuffer,
+        float gain,
+        std::ptrdiff_t numSamples) {
+    const auto vGain = V::set1(gain);
+    std::ptrdiff_t i = 0;
+    for (; i + V::kWidth <= numSamples; i += V::kWidth) {
+        V::store(pBuffer + i, V::mul(V::load(pBuffer + i), vGain));
+    }
+    for (; i < numSamples; ++i) {
+        pBuffer[i] *= gain;
+    }
+}
+
+template<typename V>
+void applyRampingGain(float* pBuffer,
+        float startGain,
+        float gainDelta,
+        std::ptrdiff_t numFrames) {
+    constexpr std::ptrdiff_t kFramesPerVector = V::kWidth / 2;
+    const auto vStartGain = V::set1(startGain);
+    const auto vGainDelta = V::set1(gainDelta);
+    std::ptrdiff_t frame = 0;
+    for (; frame + kFramesPerVector <= numFrames; frame += kFramesPerVector) {
+        const auto vGain = rampingGain<V>(vStartGain, vGainDelta, frame);
+        float* const pFrame = pBuffer + frame * 2;
+        V::store(pFrame, V::mul(V::load(pFrame), vGain));
+    }
+    for (; frame < numFrames; ++frame) {
+        const float gain = startGain + gainDelta * frame;
+        pBuffer[frame * 2] *= gain;
+        pBuffer[frame * 2 + 1] *= gain;
+    }
+}
+
+template<typename V>
+void copyWithGain(float* pDest,
+        const float* pSrc,
+        float gain,
+        std::ptrdiff_t numSamples) {
+    const auto vGain = V::set1(gain);
+    std::ptrdiff_t i = 0;
+    for (; i + V::kWidth <= numSamples; i += V::kWidth) {
+        V::store(pDest + i, V::mul(V::load(pSrc + i), vGain));
+    }
+    for (; i < numSamples; ++i) {
+        pDest[i] = pSrc[i] * gain;
+    }
+}
+
+template<typename V>
+void copyWithRampingGain(float* pDest,
+        const float* pSrc,
+        float startGain,
+        float gainDelta,
+        std::ptrdiff_t numFrames) {
+    constexpr std::ptrdiff_t kFramesPerVector = V::kWidth / 2;
+    const auto vStartGain = V::set1(startGain);
+    const auto vGainDelta = V::set1(gainDelta);
+    std::ptrdiff_t frame = 0;
+    for (; frame + kFramesPerVector <= numFrames; frame += kFramesPerVector) {
+        const auto vGain = rampingGain<V>(vStartGain, vGainDelta, frame);
+        V::store(pDest + frame * 2, V::mul(V::load(pSrc + frame * 2), vGain));
+    }
+    for (; frame < numFrames; ++frame) {
+        const float gain = startGain + gainDelta * frame;
+        pDest[frame * 2] = pSrc[frame * 2] * gain;
+        pDest[frame * 2 + 1] = pSrc[frame * 2 + 1] * gain;
+    }
+}
+
+template<typename V>
+void addWithGain(float* pDest,
+        const float* pSrc,
+        float gain,
+        std::ptrdiff_t numSamples) {
+    const auto vGain = V::set1(gain);
+    std::ptrdiff_t i = 0;
+    for (; i + V::kWidth <= numSamples; i += V::kWidth) {
+        V::store(pDest + i,
+                V::add(V::load(pDest + i),
+                        V::mul(V::load(pSrc + i), vGain)));
+    }
+    for (; i < numSamples; ++i) {
+        pDest[i] += pSrc[i] * gain;
+    }
+}
+
+template<typename V>
+void addWithRampingGain(float* pDest,
+        const float* pSrc,
+        float startGain,
+        float gainDelta,
+        std::ptrdiff_t numFrames) {
+    constexpr std::ptrdiff_t kFramesPerVector = V::kWidth / 2;
+    const auto vStartGain = V::set1(startGain);
+    const auto vGainDelta = V::set1(gainDelta);
+    std::ptrdiff_t frame = 0;
+    for (; frame + kFramesPerVector <= numFrames; frame += kFramesPerVector) {
+        const auto vGain = rampingGain<V>(vStartGain, vGainDelta, frame);
+        float* const pDestFrame = pDest + frame * 2;
+        V::store(pDestFrame,
+                V::add(V::load(pDestFrame),
+                        V::mul(V::load(pSrc + frame * 2), vGain)));
+    }
+    for (; frame < numFrames; ++frame) {
+        const float gain = startGain + gainDelta * frame;
+        pDest[frame * 2] += pSrc[frame * 2] * gain;
+        pDest[frame * 2 + 1] += pSrc[frame * 2 + 1] * gain;
+    }
+}
+
+template<typename V>
+void applyGainAndAdd(float* pBuffer,
+        float* pDest,
+        float gain,
+        std::ptrdiff_t numSamples) {
+    const auto vGain = V::set1(gain);
+    std::ptrdiff_t i = 0;
+    for (; i + V::kWidth <= numSamples; i += V::kWidth) {
+        const auto product = V::mul(V::load(pBuffer + i), vGain);
+        V::store(pBuffer + i, product);
+        V::store(pDest + i, V::add(V::load(pDest + i), product));
+    }
+    for (; i < numSamples; ++i) {
+        pBuffer[i] *= gain;
+        pDest[i] += pBuffer[i];
+    }
+}
+
+template<typename V>
+void applyRampingGainAndAdd(float* pBuffer,
+        float* pDest,
+        float startGain,
+        float gainDelta,
+        std::ptrdiff_t numFrames) {
+    constexpr std::ptrdiff_t kFramesPerVector = V::kWidth / 2;
+    const auto vStartGain = V::set1(startGain);
+    const auto vGainDelta = V::set1(gainDelta);
+    std::ptrdiff_t frame = 0;
+    for (; frame + kFramesPerVector <= numFrames; frame += kFramesPerVector) {
+        const auto vGain = rampingGain<V>(vStartGain, vGainDelta, frame);
+        float* const pFrame = pBuffer + frame * 2;
+        float* const pDestFrame = pDest + frame * 2;
+        const auto product = V::mul(V::load(pFrame), vGain);
+        V::store(pFrame, product);
+        V::store(pDestFrame, V::add(V::load(pDestFrame), product));
+    }
+    for (; frame < numFrames; ++frame) {
+        const float gain = startGain + gainDelta * frame;
+        pBuffer[frame * 2] *= gain;
+        pBuffer[frame * 2 + 1] *= gain;
+        pDest[frame * 2] += pBuffer[frame * 2];
+        pDest[frame * 2 + 1] += pBuffer[frame * 2 + 1];
+    }
+}
+
+template<typename V>
+void add2WithGain(float* pDest,
+        const float* pSrc1,
+        float gain1,
+        const float* pSrc2,
+        float gain2,
+        std::ptrdiff_t numSamples) {
+    const auto vGain1 = V::set1(gain1);
+    const auto vGain2 = V::set1(gain2);
+    std::ptrdiff_t i = 0;
+    for (; i + V::kWidth <= numSamples; i += V::kWidth) {
+        const auto sum = V::add(
+                V::mul(V::load(pSrc1 + i), vGain1),
+                V::mul(V::load(pSrc2 + i), vGain2));
+        V::store(pDest + i, V::add(V::load(pDest + i), sum));
+    }
+    for (; i < numSamples; ++i) {
+        pDest[i] += pSrc1[i] * gain1 + pSrc2[i] * gain2;
+    }
+}
+
+template<typename V>
+void add3WithGain(float* pDest,
+        const float* pSrc1,
+        float gain1,
+        const float* pSrc2,
+        float gain2,
+        const float* pSrc3,
+        float gain3,
+        std::ptrdiff_t numSamples) {
+    const auto vGain1 = V::set1(gain1);
+    const auto vGain2 = V::set1(gain2);
+    const auto vGain3 = V::set1(gain3);
+    std::ptrdiff_t i = 0;
+    for (; i + V::kWidth <= numSamples; i += V::kWidth) {
+        const auto sum = V::add(
+                V::add(
+                        V::mul(V::load(pSrc1 + i), vGain1),
+                        V::mul(V::load(pSrc2 + i), vGain2)),
+                V::mul(V::load(pSrc3 + i), vGain3));
+        V::store(pDest + i, V::add(V::load(pDest + i), sum));
+    }
+    for (; i < numSamples; ++i) {
+        pDest[i] += pSrc1[i] * gain1 + pSrc2[i] * gain2 + pSrc3[i] * gain3;
+    }
+}
+
+template<typename V>
+void sumAbsPerChannel(float* pSumAbsL,
+        float* pSumAbsR,
+        float* pMaxAbsL,
+        float* pMaxAbsR,
+        const float* pBuffer,
+        std::ptrdiff_t numFrames) {
+    constexpr std::ptrdiff_t kFramesPerVector = V::kWidth / 2;
+    auto vSumAbs = V::set1(0.0f);
+    auto vMaxAbs = V::set1(0.0f);
+    std::ptrdiff_t frame = 0;
+    for (; frame + kFramesPerVector <= numFrames; frame += kFramesPerVector) {
+        const auto vAbs = V::abs(V::load(pBuffer + frame * 2));
+        vSumAbs = V::add(vSumAbs, vAbs);
+        vMaxAbs = V::max(vMaxAbs, vAbs);
+    }
+    // Lanes with even indices contain the left and lanes with odd
+    // indices the right channel.
+    float sumAbs[V::kWidth];
+    float maxAbs[V::kWidth];
+    V::store(sumAbs, vSumAbs);
+    V::store(maxAbs, vMaxAbs);
+    float sumAbsL = 0.0f;
+    float sumAbsR = 0.0f;
+    float maxAbsL = 0.0f;
+    float maxAbsR = 0.0f;
+    for (std::ptrdiff_t i = 0; i < kFramesPerVector; ++i) {
+        sumAbsL += sumAbs[i * 2];
+        sumAbsR += sumAbs[i * 2 + 1];
+        maxAbsL = std::fmax(maxAbsL, maxAbs[i * 2]);
+        maxAbsR = std::fmax(maxAbsR, maxAbs[i * 2 + 1]);
+    }
+    for (; frame < numFrames; ++frame) {
+        const float absL = std::fabs(pBuffer[frame * 2]);
+        const float absR = std::fabs(pBuffer[frame * 2 + 1]);
+        sumAbsL += absL;
+        sumAbsR += absR;
+        maxAbsL = std::fmax(maxAbsL, absL);
+        maxAbsR = std::fmax(maxAbsR, absR);
+    }
+    *pSumAbsL = sumAbsL;
+    *pSumAbsR = sumAbsR;
+    *pMaxAbsL = maxAbsL;
+    *pMaxAbsR = maxAbsR;
+}
+
+template<typename V>
+void maxAbsPerChannel(float* pMaxAbsL,
+        float* pMaxAbsR,
+        const float* pBuffer,
+        std::ptrdiff_t numFrames) {
+    constexpr std::ptrdiff_t kFramesPerVector = V::kWidth / 2;
+    auto vMaxAbs = V::set1(0.0f);
+    std::ptrdiff_t frame = 0;
+    for (; frame + kFramesPerVector <= numFrames; frame += kFramesPerVector) {
+        vMaxAbs = V::max(vMaxAbs, V::abs(V::load(pBuffer + frame * 2)));
+    }
+    // Lanes with even indices contain the left and lanes with odd
+    // indices the right channel.
+    float maxAbs[V::kWidth];
+    V::store(maxAbs, vMaxAbs);
+    float maxAbsL = 0.0f;
+    float maxAbsR = 0.0f;
+    for (std::ptrdiff_t i = 0; i < kFramesPerVector; ++i) {
+        maxAbsL = std::fmax(maxAbsL, maxAbs[i * 2]);
+        maxAbsR = std::fmax(maxAbsR, maxAbs[i * 2 + 1]);
+    }
+    for (; frame < numFrames; ++frame) {
+        maxAbsL = std::fmax(maxAbsL, std::fabs(pBuffer[frame * 2]));
+        maxAbsR = std::fmax(maxAbsR, std::fabs(pBuffer[frame * 2 + 1]));
+    }
+    *pMaxAbsL = maxAbsL;
+    *pMaxAbsR = maxAbsR;
+}
+
+template<typename V>
+float maxAbsAmplitude(const float* pBuffer,
+        std::ptrdiff_t numSamples) {
+    auto vMaxAbs = V::set1(0.0f);
+    std::ptrdiff_t i = 0;
+    for (; i + V::kWidth <= numSamples; i += V::kWidth) {
+        vMaxAbs = V::max(vMaxAbs, V::abs(V::load(pBuffer + i)));
+    }
+    float maxAbs[V::kWidth];
+    V::store(maxAbs, vMaxAbs);
+    float result = 0.0f;
+    for (std::ptrdiff_t lane = 0; lane < V::kWidth; ++lane) {
+        result = std::fmax(result, maxAbs[lane]);
+    }
+    for (; i < numSamples; ++i) {
+        result = std::fmax(result, std::fabs(pBuffer[i]));
+    }
+    return result;
+}
+
+template<typename V>
+void interleaveBuffer(float* pDest,
+        const float* pSrc1,
+        const float* pSrc2,
+        std::ptrdiff_t numFrames) {
+    std::ptrdiff_t i = 0;
+    for (; i + V::kWidth <= numFrames; i += V::kWidth) {
+        V::interleave(pDest + i * 2, V::load(pSrc1 + i), V::load(pSrc2 + i));
+    }
+    for (; i < numFrames; ++i) {
+        pDest[i * 2] = pSrc1[i];
+        pDest[i * 2 + 1] = pSrc2[i];
+    }
+}
+
+template<typename V>
+void crossfade(float* pDest,
+        const float* pFadeOut,
+        const float* pFadeIn,
+        float crossMixDelta,
+        std::ptrdiff_t firstStep,
+        std::ptrdiff_t numSamples) {
+    // 1 + (-crossMixDelta * step) is exactly 1 - crossMixDelta * step
+    const auto vOne = V::set1(1.0f);
+    const auto vDelta = V::set1(crossMixDelta);
+    const auto vNegativeDelta = V::set1(-crossMixDelta);
+    std::ptrdiff_t i = 0;
+    for (; i + V::kWidth <= numSamples; i += V::kWidth) {
+        const auto steps = V::add(
+                V::set1(static_cast<float>(firstStep + i)),
+                V::sampleOffsets());
+        const auto fadeInGain = V::mul(vDelta, steps);
+        const auto fadeOutGain = V::add(vOne, V::mul(vNegativeDelta, steps));
+        V::store(pDest + i,
+                V::add(V::mul(V::load(pFadeOut + i), fadeOutGain),
+                        V::mul(V::load(pFadeIn + i), fadeInGain)));
+    }
+    for (; i < numSamples; ++i) {
+        const float crossMix = crossMixDelta * static_cast<float>(firstStep + i);
+        pDest[i] = pFadeOut[i] * (1.0f - crossMix) + pFadeIn[i] * crossMix;
+    }
+}
+
+template<typename V>
+inline typename V::type scaleAndClamp(const float* pSrc,
+        const float* pDither,
+        typename V::type scale,
+        typename V::type minValue,
+        typename V::type maxValue) {
+    auto scaled = V::mul(V::load(pSrc), scale);
+    if (pDither) {
+        scaled = V::add(scaled, V::load(pDither));
+    }
+    return V::min(V::max(scaled, minValue), maxValue);
+}
+
+inline float scaleAndClampScalar(float sample,
+        const float* pDither,
+        float scale,
+        float minValue,
+        float maxValue) {
+    float scaled = sample * scale;
+    if (pDither) {
+        scaled += *pDither;
+    }
+    return std::fmin(std::fmax(scaled, minValue), maxValue);
+}
+
+template<typename V>
+void convertToInt16(std::int16_t* pDest,
+        const float* pSrc,
+        const float* pDither,
+        float scale,
+        float minValue,
+        float maxValue,
+        std::ptrdiff_t numSamples) {
+    const auto vScale = V::set1(scale);
+    const auto vMin = V::set1(minValue);
+    const auto vMax = V::set1(maxValue);
+    std::ptrdiff_t i = 0;
+    for (; i + V::kWidth <= numSamples; i += V::kWidth) {
+        V::storeInt16(pDest + i,
+                scaleAndClamp<V>(pSrc + i,
+                        pDither ? pDither + i : nullptr,
+                        vScale,
+                        vMin,
+                        vMax));
+    }
+    for (; i < numSamples; ++i) {
+        pDest[i] = static_cast<std::int16_t>(std::lrint(scaleAndClampScalar(
+                pSrc[i], pDither ? pDither + i : nullptr, scale, minValue, maxValue)));
+    }
+}
+
+template<typename V>
+void convertToInt32(std::int32_t* pDest,
+        const float* pSrc,
+        const float* pDither,
+        float scale,
+        float minValue,
+        float maxValue,
+        int shift,
+        std::ptrdiff_t numSamples) {
+    const auto vScale = V::set1(scale);
+    const auto vMin = V::set1(minValue);
+    const auto vMax = V::set1(maxValue);
+    std::ptrdiff_t i = 0;
+    for (; i + V::kWidth <= numSamples; i += V::kWidth) {
+        V::storeInt32(pDest + i,
+                scaleAndClamp<V>(pSrc + i,
+                        pDither ? pDither + i : nullptr,
+                        vScale,
+                        vMin,
+                        vMax),
+                shift);
+    }
+    for (; i < numSamples; ++i) {
+        const auto value = static_cast<std::int32_t>(std::lrint(scaleAndClampScalar(
+                pSrc[i], pDither ? pDither + i : nullptr, scale, minValue, maxValue)));
+        pDest[i] = static_cast<std::int32_t>(static_cast<std::uint32_t>(value) << shift);
+    }
+}
+
+template<typename V>
+constexpr Kernels makeKernels(InstructionSet instructionSet) {
+    return Kernels{
+            instructionSet,
+            &applyGain<V>,
+            &applyRampingGain<V>,
+            &copyWithGain<V>,
+            &copyWithRampingGain<V>,
+            &addWithGain<V>,
+            &addWithRampingGain<V>,
+            &applyGainAndAdd<V>,
+            &applyRampingGainAndAdd<V>,
+            &add2WithGain<V>,
+            &add3WithGain<V>,
+            &sumAbsPerChannel<V>,
+            &maxAbsPerChannel<V>,
+            &maxAbsAmplitude<V>,
+            &interleaveBuffer<V>,
+            &crossfade<V>,
+            &convertToInt16<V>,
+            &convertToInt32<V>,
+    };
+}
+
+} // anonymous namespace
@@ -0,0 +1,102 @@
+#include "util/sample_kernels.h"
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+
+#include <arm_neon.h>
+
+namespace {
+
+struct Neon {
+    using type = float32x4_t;
+    static constexpr std::ptrdiff_t kWidth = 4;
+
+    static type load(const float* p) {
+        return vld1q_f32(p);
+    }
+    static void store(float* p, type v) {
+        vst1q_f32(p, v);
+    }
+    static type set1(float x) {
+        return vdupq_n_f32(x);
+    }
+    static type add(type a, type b) {
+        return vaddq_f32(a, b);
+    }
+    static type mul(type a, type b) {
+        return vmulq_f32(a, b);
+    }
+    static type max(type a, type b) {
+        return vmaxq_f32(a, b);
+    }
+    static type abs(type a) {
+        return vabsq_f32(a);
+    }
+    static type frameOffsets() {
+        constexpr float kOffsets[kWidth] = {0.0f, 0.0f, 1.0f, 1.0f};
+        return vld1q_f32(kOffsets);
+    }
+    static type sampleOffsets() {
+        constexpr float kOffsets[kWidth] = {0.0f, 1.0f, 2.0f, 3.0f};
+        return vld1q_f32(kOffsets);
+    }
+    static void interleave(float* p, type a, type b) {
+        float32x4x2_t ab;
+        ab.val[0] = a;
+        ab.val[1] = b;
+        vst2q_f32(p, ab);
+    }
+    static type min(type a, type b) {
+        return vminq_f32(a, b);
+    }
+    static int32x4_t round(type v) {
+#if defined(__aarch64__)
+        return vcvtnq_s32_f32(v);
+#else
+        // ARMv7 only converts with truncation, round half away from zero
+        const uint32x4_t sign = vandq_u32(
+                vreinterpretq_u32_f32(v), vdupq_n_u32(0x80000000));
+        const type half = vreinterpretq_f32_u32(
+                vorrq_u32(sign, vreinterpretq_u32_f32(vdupq_n_f32(0.5f))));
+        return vcvtq_s32_f32(vaddq_f32(v, half));
+#endif
+    }
+    static void storeInt16(std::int16_t* p, type v) {
+        vst1_s16(p, vqmovn_s32(round(v)));
+    }
+    static void storeInt32(std::int32_t* p, type v, int shift) {
+        vst1q_s32(p, vshlq_s32(round(v), vdupq_n_s32(shift)));
+    }
+};
+
+} // anonymous namespace
+
+#include "util/sample_kernels_impl.h"
+
+namespace mixxx {
+
+namespace sampleutil {
+
+const Kernels* neonKernels() {
+    static const Kernels kKernels = makeKernels<Neon>(InstructionSet::NEON);
+    return &kKernels;
+}
+
+} // namespace sampleutil
+
+} // namespace mixxx
+
+#else
+
+namespace mixxx {
+
+namespace sampleutil {
+
+const Kernels* neonKernels() {
+    return nullptr;
+}
+
+} // namespace sampleutil
+
+} // namespace mixxx
+
+#endif
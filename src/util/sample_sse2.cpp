@@ -0,0 +1,90 @@
+#include "util/sample_kernels.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || \
+        (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+
+#include <emmintrin.h>
+
+namespace {
+
+struct Sse2 {
+    using type = __m128;
+    static constexpr std::ptrdiff_t kWidth = 4;
+
+    static type load(const float* p) {
+        return _mm_loadu_ps(p);
+    }
+    static void store(float* p, type v) {
+        _mm_storeu_ps(p, v);
+    }
+    static type set1(float x) {
+        return _mm_set1_ps(x);
+    }
+    static type add(type a, type b) {
+        return _mm_add_ps(a, b);
+    }
+    static type mul(type a, type b) {
+        return _mm_mul_ps(a, b);
+    }
+    static type max(type a, type b) {
+        return _mm_max_ps(a, b);
+    }
+    static type abs(type a) {
+        // Clear the sign bit
+        return _mm_andnot_ps(_mm_set1_ps(-0.0f), a);
+    }
+    static type frameOffsets() {
+        return _mm_setr_ps(0.0f, 0.0f, 1.0f, 1.0f);
+    }
+    static type sampleOffsets() {
+        return _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f);
+    }
+    static void interleave(float* p, type a, type b) {
+        _mm_storeu_ps(p, _mm_unpacklo_ps(a, b));
+        _mm_storeu_ps(p + kWidth, _mm_unpackhi_ps(a, b));
+    }
+    static type min(type a, type b) {
+        return _mm_min_ps(a, b);
+    }
+    static void storeInt16(std::int16_t* p, type v) {
+        const __m128i i = _mm_cvtps_epi32(v);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(p), _mm_packs_epi32(i, i));
+    }
+    static void storeInt32(std::int32_t* p, type v, int shift) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(p),
+                _mm_sll_epi32(_mm_cvtps_epi32(v), _mm_cvtsi32_si128(shift)));
+    }
+};
+
+} // anonymous namespace
+
+#include "util/sample_kernels_impl.h"
+
+namespace mixxx {
+
+namespace sampleutil {
+
+const Kernels* sse2Kernels() {
+    static const Kernels kKernels = makeKernels<Sse2>(InstructionSet::SSE2);
+    return &kKernels;
+}
+
+} // namespace sampleutil
+
+} // namespace mixxx
+
+#else
+
+namespace mixxx {
+
+namespace sampleutil {
+
+const Kernels* sse2Kernels() {
+    return nullptr;
+}
+
+} // namespace sampleutil
+
+} // namespace mixxx
+
+#endif
@@ -1,5 +1,6 @@
 #include "util/samplebuffer.h"
 
+#include "util/lockedmemory.h"
 #include "util/sample.h"
 
 
@@ -7,11 +8,32 @@ namespace mixxx {
 
 SampleBuffer::SampleBuffer(SINT size)
         : m_data((size > 0) ? SampleUtil::alloc(size) : nullptr),
-          m_size((m_data != nullptr) ? size : 0) {
+          m_size((m_data != nullptr) ? size : 0),
+          m_locked(false) {
+}
+
+// static
+SampleBuffer SampleBuffer::allocateLocked(SINT size) {
+    if (size > 0) {
+        // Page aligned, i.e. also aligned for SIMD instructions
+        void* pMemory = LockedMemory::allocate(sizeof(CSAMPLE) * size);
+        if (pMemory) {
+            SampleBuffer buffer;
+            buffer.m_data = static_cast<CSAMPLE*>(pMemory);
+            buffer.m_size = size;
+            buffer.m_locked = true;
+            return buffer;
+        }
+    }
+    return SampleBuffer(size);
 }
 
 SampleBuffer::~SampleBuffer() {
-    SampleUtil::free(m_data);
+    if (m_locked) {
+        LockedMemory::free(m_data);
+    } else {
+        SampleUtil::free(m_data);
+    }
 }
 
 void SampleBuffer::clear() {
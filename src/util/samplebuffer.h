@@ -36,18 +36,25 @@ class SampleBuffer final {
   public:
     SampleBuffer()
         : m_data(nullptr),
-          m_size(0) {
+          m_size(0),
+          m_locked(false) {
     }
     explicit SampleBuffer(SINT size);
     SampleBuffer(SampleBuffer&) = delete;
     SampleBuffer(SampleBuffer&& that)
         : m_data(that.m_data),
-          m_size(that.m_size) {
+          m_size(that.m_size),
+          m_locked(that.m_locked) {
         that.m_data = nullptr;
         that.m_size = 0;
+        that.m_locked = false;
     }
     virtual ~SampleBuffer() final;
 
+    // Allocates the buffer from LockedMemory if enabled, i.e. locked into
+    // RAM, otherwise like the regular constructor.
+    static SampleBuffer allocateLocked(SINT size);
+
     SampleBuffer& operator=(SampleBuffer& that) = delete;
     SampleBuffer& operator=(SampleBuffer&& that) {
         swap(that);
@@ -94,6 +101,7 @@ class SampleBuffer final {
     void swap(SampleBuffer& that) {
         std::swap(m_data, that.m_data);
         std::swap(m_size, that.m_size);
+        std::swap(m_locked, that.m_locked);
     }
 
     // Fills the whole buffer with zeroes
@@ -191,6 +199,7 @@ class SampleBuffer final {
   private:
     CSAMPLE* m_data;
     SINT m_size;
+    bool m_locked;
 };
 
 } // namespace mixxx
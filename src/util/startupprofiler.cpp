@@ -0,0 +1,75 @@
+#include "util/startupprofiler.h"
+
+#include <QList>
+
+#include "util/cmdlineargs.h"
+#include "util/logger.h"
+#include "util/stat.h"
+#include "util/time.h"
+
+namespace {
+
+const mixxx::Logger kLogger("StartupProfiler");
+
+struct Phase {
+    QString name;
+    mixxx::Duration begin;
+    mixxx::Duration duration;
+};
+
+// Only accessed from the main thread
+QList<Phase> s_phases;
+bool s_finished = false;
+
+void endCurrentPhase() {
+    if (s_phases.isEmpty()) {
+        return;
+    }
+    Phase& phase = s_phases.last();
+    phase.duration = mixxx::Time::elapsed() - phase.begin;
+    Stat::track(QStringLiteral("Startup: ") + phase.name,
+            Stat::DURATION_NANOSEC,
+            Stat::experimentFlags(Stat::COUNT | Stat::SUM),
+            phase.duration.toIntegerNanos());
+}
+
+} // anonymous namespace
+
+namespace mixxx {
+
+// static
+bool StartupProfiler::isEnabled() {
+    return CmdlineArgs::Instance().getStartupProfile() ||
+            CmdlineArgs::Instance().getDeveloper();
+}
+
+// static
+void StartupProfiler::beginPhase(const QString& name) {
+    if (s_finished || !isEnabled()) {
+        return;
+    }
+    endCurrentPhase();
+    s_phases.append(Phase{name, mixxx::Time::elapsed(), mixxx::Duration()});
+}
+
+// static
+void StartupProfiler::finish() {
+    if (s_finished || !isEnabled()) {
+        return;
+    }
+    endCurrentPhase();
+    s_finished = true;
+
+    kLogger.info() << "Startup finished after"
+                   << mixxx::Time::elapsed().formatMillisWithUnit();
+    for (const auto& phase : std::as_const(s_phases)) {
+        kLogger.info()
+                << QStringLiteral("%1 +%2")
+                           .arg(phase.begin.formatMillisWithUnit(),
+                                   phase.duration.formatMillisWithUnit())
+                << phase.name;
+    }
+    s_phases.clear();
+}
+
+} // namespace mixxx
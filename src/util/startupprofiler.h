@@ -0,0 +1,22 @@
+#pragma once
+
+#include <QString>
+
+namespace mixxx {
+
+/// Measures the phases of the startup when Mixxx is started with
+/// --startup-profile or --developer. A phase lasts until the next one begins.
+/// The durations are reported to the StatsManager as "Startup: <phase>" and
+/// logged as a summary when the startup has finished.
+class StartupProfiler {
+  public:
+    static bool isEnabled();
+
+    /// Ends the current phase and begins the next one
+    static void beginPhase(const QString& name);
+    /// Ends the last phase and logs the summary. Phases that begin after this
+    /// are ignored.
+    static void finish();
+};
+
+} // namespace mixxx
@@ -2,6 +2,7 @@
 
 #include <QCollator>
 #include <QColor>
+#include <QHash>
 #include <QLocale>
 #include <QString>
 #include <QStringRef>
@@ -14,6 +15,11 @@
 namespace mixxx {
 
 // The default comparison of strings for sorting.
+//
+// The sort keys of the compared strings are cached. Sorting compares each
+// string multiple times and many strings, e.g. artist names, occur in many
+// rows. Comparing sort keys is a plain comparison of bytes. The cache is
+// not synchronized, i.e. a collator must only be used by a single thread.
 class StringCollator {
   public:
     explicit StringCollator(QLocale locale = QLocale())
@@ -22,15 +28,40 @@ class StringCollator {
     }
 
     int compare(const QString& s1, const QString& s2) const {
-        return m_collator.compare(s1, s2);
+        if (s1 == s2) {
+            return 0;
+        }
+        return sortKey(s1).compare(sortKey(s2));
     }
 
     int compare(const QStringRef& s1, const QStringRef& s2) const {
+        if (s1 == s2) {
+            return 0;
+        }
         return m_collator.compare(s1, s2);
     }
 
   private:
+    static constexpr int kMaxCachedSortKeys = 100000;
+
+    QCollatorSortKey sortKey(const QString& string) const {
+        const auto it = m_sortKeys.constFind(string);
+        if (it != m_sortKeys.constEnd()) {
+            return it.value();
+        }
+        if (m_sortKeys.size() >= kMaxCachedSortKeys) {
+            m_sortKeys.clear();
+        }
+        // The string may only wrap raw data, e.g. of SQLite, that must
+        // not be referenced by the cache
+        const QString key(string.constData(), string.size());
+        QCollatorSortKey sortKey = m_collator.sortKey(key);
+        m_sortKeys.insert(key, sortKey);
+        return sortKey;
+    }
+
     QCollator m_collator;
+    mutable QHash<QString, QCollatorSortKey> m_sortKeys;
 };
 
 /// A nullptr-safe variant of the corresponding standard C function.
@@ -1,5 +1,6 @@
 #include "util/texture.h"
 
+#include <QHash>
 #include <QImage>
 #include <QOpenGLTexture>
 #include <QPixmap>
@@ -35,3 +36,23 @@ std::unique_ptr<QOpenGLTexture> createTexture(const std::shared_ptr<QImage>& pIm
     }
     return createTexture(*pImage);
 }
+
+std::shared_ptr<QOpenGLTexture> createSharedTexture(
+        const QSharedPointer<Paintable>& pPaintable) {
+    if (pPaintable.isNull()) {
+        return nullptr;
+    }
+    // The widgets keep their paintables alive while they use the textures,
+    // so a paintable cannot be replaced by another one at the same address
+    // while its texture exists.
+    static QHash<const Paintable*, std::weak_ptr<QOpenGLTexture>> s_textures;
+    std::shared_ptr<QOpenGLTexture> pTexture = s_textures.value(pPaintable.data()).lock();
+    if (pTexture) {
+        return pTexture;
+    }
+    pTexture = createTexture(pPaintable);
+    if (pTexture) {
+        s_textures.insert(pPaintable.data(), pTexture);
+    }
+    return pTexture;
+}
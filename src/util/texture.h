@@ -10,3 +10,11 @@ std::unique_ptr<QOpenGLTexture> createTexture(const QImage& image);
 std::unique_ptr<QOpenGLTexture> createTexture(const QPixmap& pixmap);
 std::unique_ptr<QOpenGLTexture> createTexture(const QSharedPointer<Paintable>& pPaintable);
 std::unique_ptr<QOpenGLTexture> createTexture(const std::shared_ptr<QImage>& pImage);
+
+/// Returns the texture of a paintable that is shared by all widgets that
+/// draw the same paintable, which is created when it is requested first.
+/// The resources of all OpenGL contexts are shared
+/// (Qt::AA_ShareOpenGLContexts), so the texture is valid in the contexts
+/// of all widgets. Must be called from the GUI thread.
+std::shared_ptr<QOpenGLTexture> createSharedTexture(
+        const QSharedPointer<Paintable>& pPaintable);
@@ -2,7 +2,9 @@
 
 #include "control/controlpushbutton.h"
 #include "moc_vinylcontrolprocessor.cpp"
+#include "util/cpuaffinity.h"
 #include "util/defs.h"
+#include "util/denormalsarezero.h"
 #include "util/sample.h"
 #include "util/timer.h"
 #include "vinylcontrol/defs_vinylcontrol.h"
@@ -78,6 +80,8 @@ void VinylControlProcessor::requestReloadConfig() {
 void VinylControlProcessor::run() {
     unsigned static id = 0; //the id of this thread, for debugging purposes //XXX copypasta (should factor this out somehow), -kousu 2/2009
     QThread::currentThread()->setObjectName(QString("VinylControlProcessor %1").arg(++id));
+    mixxx::CpuAffinity::applyToCurrentThread(mixxx::CpuAffinity::ThreadRole::Background);
+    mixxx::enableDenormalsAreZero();
 
     while (!m_bQuit) {
         if (m_bReloadConfig) {
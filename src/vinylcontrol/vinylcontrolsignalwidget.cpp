@@ -1,15 +1,42 @@
 #include "vinylcontrol/vinylcontrolsignalwidget.h"
 
 #include <QPainter>
+#include <QVector>
 #include <algorithm>
+#include <cstring>
 
 #include "moc_vinylcontrolsignalwidget.cpp"
 
+namespace {
+
+//color is related to signal quality
+//hsv:  s=1, v=1
+//h is the only variable.
+//h=0 is red, h=120 is green
+int qualityHue(float signalQuality) {
+    return static_cast<int>(120.0 * signalQuality);
+}
+
+// The colors of all alpha values of the signal quality color
+QVector<QRgb> makeColorTable(int hue) {
+    QColor qual_color = QColor();
+    qual_color.setHsv(hue, 255, 255);
+    const QRgb rgb = qual_color.rgb();
+    QVector<QRgb> colorTable(256);
+    for (int alpha = 0; alpha < colorTable.size(); ++alpha) {
+        colorTable[alpha] = qRgba(qRed(rgb), qGreen(rgb), qBlue(rgb), alpha);
+    }
+    return colorTable;
+}
+
+} // namespace
+
 VinylControlSignalWidget::VinylControlSignalWidget()
         : QWidget(),
           m_iVinylInput(-1),
           m_iSize(MIXXX_VINYL_SCOPE_SIZE),
           m_qImage(),
+          m_iQualityHue(-1),
           m_iAngle(0),
           m_fSignalQuality(0.0f),
           m_bVinylActive(false) {
@@ -20,8 +47,10 @@ void VinylControlSignalWidget::setSize(int size) {
     setSizePolicy(QSizePolicy(QSizePolicy::Fixed, QSizePolicy::Fixed));
     setMinimumSize(size, size);
     setMaximumSize(size, size);
-    m_imageData.resize(size * size * 4);
-    m_qImage = QImage(m_imageData.data(), size, size, 0, QImage::Format_ARGB32);
+    m_qImage = QImage(size, size, QImage::Format_Indexed8);
+    m_iQualityHue = qualityHue(m_fSignalQuality);
+    m_qImage.setColorTable(makeColorTable(m_iQualityHue));
+    resetWidget();
 }
 
 void VinylControlSignalWidget::setVinylInput(int input) {
@@ -49,35 +78,33 @@ void VinylControlSignalWidget::onVinylSignalQualityUpdate(const VinylSignalQuali
     m_iAngle = static_cast<int>(report.angle);
     m_fSignalQuality = report.timecode_quality;
 
-    int r,g,b;
-    QColor qual_color = QColor();
-    //color is related to signal quality
-    //hsv:  s=1, v=1
-    //h is the only variable.
-    //h=0 is red, h=120 is green
-    qual_color.setHsv((int)(120.0 * m_fSignalQuality), 255, 255);
-    qual_color.getRgb(&r, &g, &b);
-
-    if (m_imageData.empty()) {
+    if (m_qImage.isNull()) {
         return;
     }
 
-    for (int x = 0; x < m_iSize; ++x) {
-        for(int y = 0; y < m_iSize; ++y) {
-            //XXX: endianness means this is backwards....
-            //does this break on other platforms?
-            m_imageData[4*(x+m_iSize*y)+0] = (uchar)b;
-            m_imageData[4*(x+m_iSize*y)+1] = (uchar)g;
-            m_imageData[4*(x+m_iSize*y)+2] = (uchar)r;
-            m_imageData[4*(x+m_iSize*y)+3] = (uchar)report.scope[x+m_iSize*y];
-        }
+    const int hue = qualityHue(m_fSignalQuality);
+    if (hue != m_iQualityHue) {
+        m_qImage.setColorTable(makeColorTable(hue));
+        m_iQualityHue = hue;
+    }
+
+    // The xwax scope has one byte per pixel, which is used as the alpha
+    // value of the pixel.
+    const int size = std::min(m_iSize, MIXXX_VINYL_SCOPE_SIZE);
+    for (int y = 0; y < size; ++y) {
+        std::memcpy(m_qImage.scanLine(y),
+                report.scope + MIXXX_VINYL_SCOPE_SIZE * y,
+                size);
     }
     update();
 }
 
 void VinylControlSignalWidget::resetWidget()
 {
-    std::fill(std::begin(m_imageData), std::end(m_imageData), 0);
+    if (!m_qImage.isNull()) {
+        // Index 0 is fully transparent
+        m_qImage.fill(0);
+    }
 }
 
 void VinylControlSignalWidget::paintEvent(QPaintEvent* event) {
@@ -2,7 +2,6 @@
 
 #include <QImage>
 #include <QWidget>
-#include <vector>
 
 #include "vinylcontrol/vinylsignalquality.h"
 
@@ -28,8 +27,11 @@ class VinylControlSignalWidget : public QWidget, public VinylSignalQualityListen
     int m_iVinylInput;
     int m_iSize;
 
+    // The scope bytes are used as indices into a color table with the
+    // signal quality color at increasing alpha, so that updates only need
+    // to copy the scope and rebuild the table when the color changes.
     QImage m_qImage;
-    std::vector<uchar> m_imageData;
+    int m_iQualityHue;
     int m_iAngle;
     float m_fSignalQuality;
     bool m_bVinylActive;
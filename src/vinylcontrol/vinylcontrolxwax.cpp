@@ -7,6 +7,7 @@
 #include "moc_vinylcontrolxwax.cpp"
 #include "util/defs.h"
 #include "util/math.h"
+#include "util/sample.h"
 #include "util/timer.h"
 #include "vinylcontrol/defs_vinylcontrol.h"
 #include "vinylcontrol/steadypitch.h"
@@ -27,6 +28,11 @@ constexpr int kChannels = 2;
 // Sample threshold below which we consider there to be no signal.
 constexpr double kMinSignal = 75.0 / SAMPLE_MAXIMUM;
 
+// Pitch deviation from the smoothed pitch above which the pitch ring is
+// restarted, so that deliberate tempo changes are followed immediately
+// instead of being averaged over a quarter revolution.
+constexpr double kPitchRingResetDeviation = 0.02;
+
 bool VinylControlXwax::s_bLUTInitialized = false;
 QMutex VinylControlXwax::s_xwaxLUTMutex;
 
@@ -51,6 +57,7 @@ VinylControlXwax::VinylControlXwax(UserSettingsPointer pConfig, const QString& g
           m_iPitchRingSize(0),
           m_iPitchRingPos(0),
           m_iPitchRingFilled(0),
+          m_dPitchRingSum(0.0),
           m_dDisplayPitch(0.0),
           m_pSteadySubtle(nullptr),
           m_pSteadyGross(nullptr),
@@ -215,24 +222,19 @@ void VinylControlXwax::analyzeSamples(CSAMPLE* pSamples, size_t nFrames) {
         m_workBufferSize = samplesSize;
     }
 
-    // Convert CSAMPLE samples to shorts, preventing overflow.
-    for (int i = 0; i < static_cast<int>(samplesSize); ++i) {
-        CSAMPLE sample = pSamples[i] * gain * SAMPLE_MAXIMUM;
+    // Check the signal before the samples are amplified in place
+    bool bHaveSignal = fabs(pSamples[0]) + fabs(pSamples[1]) > kMinSignal;
 
-        if (sample > SAMPLE_MAXIMUM) {
-            m_pWorkBuffer[i] = SAMPLE_MAXIMUM;
-        } else if (sample < SAMPLE_MINIMUM) {
-            m_pWorkBuffer[i] = SAMPLE_MINIMUM;
-        } else {
-            m_pWorkBuffer[i] = static_cast<short>(sample);
-        }
+    // Convert CSAMPLE samples to shorts, preventing overflow.
+    if (gain != 1.0f) {
+        SampleUtil::applyGain(pSamples, gain, samplesSize);
     }
+    SampleUtil::convertFloat32ToS16(m_pWorkBuffer.data(), pSamples, samplesSize);
 
     // Submit the samples to the xwax timecode processor. The size argument is
     // in stereo frames.
     timecoder_submit(&timecoder, m_pWorkBuffer.data(), nFrames);
 
-    bool bHaveSignal = fabs(pSamples[0]) + fabs(pSamples[1]) > kMinSignal;
     //qDebug() << "signal?" << bHaveSignal;
 
     //TODO: Move all these config object get*() calls to an "updatePrefs()" function,
@@ -504,8 +506,7 @@ void VinylControlXwax::analyzeSamples(CSAMPLE* pSamples, size_t nFrames) {
                 togglePlayButton(false);
                 resetSteadyPitch(0.0, 0.0);
                 m_pVCRate->set(0.0);
-                m_iPitchRingPos = 0;
-                m_iPitchRingFilled = 0;
+                resetPitchRing();
                 return;
             } else {
                 togglePlayButton(checkSteadyPitch(dVinylPitch, filePosition) > 0.5);
@@ -531,8 +532,7 @@ void VinylControlXwax::analyzeSamples(CSAMPLE* pSamples, size_t nFrames) {
                 togglePlayButton(false);
                 resetSteadyPitch(0.0, 0.0);
                 m_pVCRate->set(0.0);
-                m_iPitchRingPos = 0;
-                m_iPitchRingFilled = 0;
+                resetPitchRing();
                 return;
             }
 
@@ -555,24 +555,16 @@ void VinylControlXwax::analyzeSamples(CSAMPLE* pSamples, size_t nFrames) {
 
         if (reportedPlayButton) {
             // Only add to the ring if pitch is stable
-            m_pPitchRing[m_iPitchRingPos] = dVinylPitch;
-            if (m_iPitchRingFilled < m_iPitchRingSize) {
-                m_iPitchRingFilled++;
-            }
-            m_iPitchRingPos = (m_iPitchRingPos + 1) % m_iPitchRingSize;
+            addToPitchRing(dVinylPitch);
         } else {
             // Reset ring if pitch isn't steady
-            m_iPitchRingPos = 0;
-            m_iPitchRingFilled = 0;
+            resetPitchRing();
         }
 
         //only smooth when we have good position (no smoothing for scratching)
         double averagePitch = 0.0;
         if (m_iPosition != -1 && reportedPlayButton) {
-            for (int i = 0; i < m_iPitchRingFilled; ++i) {
-                averagePitch += m_pPitchRing[i];
-            }
-            averagePitch /= m_iPitchRingFilled;
+            averagePitch = m_dPitchRingSum / m_iPitchRingFilled;
             // Round out some of the noise
             averagePitch = round(averagePitch * 10000.0);
             averagePitch /= 10000.0;
@@ -738,6 +730,35 @@ void VinylControlXwax::resetSteadyPitch(double pitch, double time) {
     m_pSteadyGross->reset(pitch, time);
 }
 
+void VinylControlXwax::resetPitchRing() {
+    m_iPitchRingPos = 0;
+    m_iPitchRingFilled = 0;
+    m_dPitchRingSum = 0.0;
+}
+
+void VinylControlXwax::addToPitchRing(double pitch) {
+    if (m_iPitchRingFilled > 0 &&
+            fabs(pitch - m_dPitchRingSum / m_iPitchRingFilled) >
+                    kPitchRingResetDeviation) {
+        resetPitchRing();
+    }
+    if (m_iPitchRingFilled < m_iPitchRingSize) {
+        m_iPitchRingFilled++;
+    } else {
+        m_dPitchRingSum -= m_pPitchRing[m_iPitchRingPos];
+    }
+    m_pPitchRing[m_iPitchRingPos] = pitch;
+    m_dPitchRingSum += pitch;
+    m_iPitchRingPos = (m_iPitchRingPos + 1) % m_iPitchRingSize;
+    if (m_iPitchRingPos == 0) {
+        // Recompute the sum once per lap to avoid accumulating rounding errors
+        m_dPitchRingSum = 0.0;
+        for (int i = 0; i < m_iPitchRingFilled; ++i) {
+            m_dPitchRingSum += m_pPitchRing[i];
+        }
+    }
+}
+
 double VinylControlXwax::checkSteadyPitch(double pitch, double time) {
     // If the track is in reverse we can't really know what's going on.
     if (m_bWasReversed) {
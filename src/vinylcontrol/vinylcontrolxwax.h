@@ -43,6 +43,8 @@ class VinylControlXwax : public VinylControl {
     void doTrackSelection(bool valid_pos, double pitch, double position);
     void resetSteadyPitch(double pitch, double time);
     double checkSteadyPitch(double pitch, double time);
+    void resetPitchRing();
+    void addToPitchRing(double pitch);
     void enableRecordEndMode();
     void disableRecordEndMode();
     void enableConstantMode();
@@ -108,6 +110,8 @@ class VinylControlXwax : public VinylControl {
     // How much of the pitch ring buffer is "filled" versus empty (used before
     // it fills up completely).
     int m_iPitchRingFilled;
+    // The sum of the filled part of the pitch ring buffer.
+    double m_dPitchRingSum;
     // A smoothed pitch value to show to the user.
     double m_dDisplayPitch;
 
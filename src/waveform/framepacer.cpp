@@ -0,0 +1,52 @@
+#include "waveform/framepacer.h"
+
+#include "util/math.h"
+
+namespace {
+
+// The audio callback needs some headroom for the scheduling jitter
+constexpr double kMaxAudioLatencyUsage = 0.8;
+
+// Only raise the frame rate if the load after raising it is expected
+// to stay within the budget
+constexpr double kRaiseLoadRatio = 0.75;
+
+constexpr int kFrameRateStep = 5;
+
+} // namespace
+
+FramePacer::FramePacer(int maxFrameRate, double budget)
+        : m_maxFrameRate(math_max(kMinFrameRate, maxFrameRate)),
+          m_budget(math_clamp(budget, 0.01, 1.0)),
+          m_frameRate(m_maxFrameRate) {
+}
+
+void FramePacer::setMaxFrameRate(int frameRate) {
+    m_maxFrameRate = math_max(kMinFrameRate, frameRate);
+    m_frameRate = math_min(m_frameRate, m_maxFrameRate);
+}
+
+void FramePacer::setBudget(double budget) {
+    m_budget = math_clamp(budget, 0.01, 1.0);
+}
+
+int FramePacer::update(mixxx::Duration renderTime,
+        mixxx::Duration elapsed,
+        double audioLatencyUsage) {
+    if (elapsed <= mixxx::Duration::empty()) {
+        return m_frameRate;
+    }
+    const double load = renderTime.toDoubleSeconds() / elapsed.toDoubleSeconds();
+    if (audioLatencyUsage > kMaxAudioLatencyUsage) {
+        // Give the audio thread more room, regardless of the budget
+        m_frameRate -= kFrameRateStep;
+    } else if (load > m_budget) {
+        // The render time is roughly proportional to the frame rate
+        const int frameRateWithinBudget = static_cast<int>(m_frameRate * m_budget / load);
+        m_frameRate = math_min(m_frameRate - kFrameRateStep, frameRateWithinBudget);
+    } else if (load * (m_frameRate + kFrameRateStep) < m_budget * kRaiseLoadRatio * m_frameRate) {
+        m_frameRate += kFrameRateStep;
+    }
+    m_frameRate = math_clamp(m_frameRate, kMinFrameRate, m_maxFrameRate);
+    return m_frameRate;
+}
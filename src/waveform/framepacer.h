@@ -0,0 +1,38 @@
+#pragma once
+
+#include "util/duration.h"
+
+/// Adapts the frame rate of the waveforms to a budget for the share of the
+/// time that may be spent on drawing them, e.g. to limit the CPU usage of the
+/// visuals on slow machines instead of guessing a fixed frame rate.
+///
+/// The frame rate is also lowered when the audio callback gets close to
+/// missing its deadline, so that the visuals back off before the audio is
+/// affected. It is raised again step by step up to the configured frame rate
+/// when there is enough headroom.
+class FramePacer {
+  public:
+    static constexpr int kMinFrameRate = 10;
+
+    FramePacer(int maxFrameRate, double budget);
+
+    void setMaxFrameRate(int frameRate);
+    /// The share of the time between 0 and 1
+    void setBudget(double budget);
+
+    /// Returns the frame rate for the next measuring period. renderTime is
+    /// the time that was spent rendering during elapsed, audioLatencyUsage
+    /// the share of the audio buffer period that was spent in the callback.
+    int update(mixxx::Duration renderTime,
+            mixxx::Duration elapsed,
+            double audioLatencyUsage);
+
+    int frameRate() const {
+        return m_frameRate;
+    }
+
+  private:
+    int m_maxFrameRate;
+    double m_budget;
+    int m_frameRate;
+};
@@ -19,6 +19,10 @@ class allshader::VertexData {
         addTriangle({x1, y1}, {x2, y1}, {x1, y2});
         addTriangle({x1, y2}, {x2, y2}, {x2, y1});
     }
+    void addLine(const QVector2D& a, const QVector2D& b) {
+        mData.push_back(a);
+        mData.push_back(b);
+    }
     void addTriangle(const QVector2D& a, const QVector2D& b, const QVector2D& c) {
         mData.push_back(a);
         mData.push_back(b);
@@ -0,0 +1,69 @@
+#include "waveform/renderers/allshader/waveformdatatexture.h"
+
+#include <QOpenGLTexture>
+#include <algorithm>
+
+#include "util/assert.h"
+
+namespace allshader {
+
+WaveformDataTexture::WaveformDataTexture()
+        : m_textureStride(0),
+          m_uploadedCompletion(0) {
+}
+
+WaveformDataTexture::~WaveformDataTexture() = default;
+
+bool WaveformDataTexture::update(const ConstWaveformPointer& pWaveform) {
+    if (!pWaveform || pWaveform->getDataSize() <= 1 || !pWaveform->data()) {
+        m_pTexture.reset();
+        m_pWaveform.reset();
+        return false;
+    }
+    if (pWaveform != m_pWaveform ||
+            pWaveform->getTextureStride() != m_textureStride) {
+        allocate(pWaveform);
+    }
+    // NOTE: The completion is updated concurrently by the analyzer
+    const int completion = std::min(pWaveform->getCompletion(), pWaveform->getDataSize());
+    if (completion > m_uploadedCompletion) {
+        upload(m_uploadedCompletion, completion);
+        m_uploadedCompletion = completion;
+    }
+    return true;
+}
+
+void WaveformDataTexture::allocate(const ConstWaveformPointer& pWaveform) {
+    m_pWaveform = pWaveform;
+    m_textureStride = pWaveform->getTextureStride();
+    m_uploadedCompletion = 0;
+
+    // Waveform ensures that getTextureSize() is the square of getTextureStride()
+    DEBUG_ASSERT(pWaveform->getTextureSize() == m_textureStride * m_textureStride);
+    m_pTexture = std::make_unique<QOpenGLTexture>(QOpenGLTexture::Target2D);
+    // The unsized format is also supported by OpenGL ES 2.0
+    m_pTexture->setFormat(QOpenGLTexture::RGBAFormat);
+    m_pTexture->setSize(m_textureStride, m_textureStride);
+    m_pTexture->setMinMagFilters(QOpenGLTexture::Nearest, QOpenGLTexture::Nearest);
+    m_pTexture->setWrapMode(QOpenGLTexture::ClampToEdge);
+    m_pTexture->allocateStorage(QOpenGLTexture::RGBA, QOpenGLTexture::UInt8);
+}
+
+void WaveformDataTexture::upload(int firstIndex, int lastIndex) {
+    DEBUG_ASSERT(firstIndex < lastIndex);
+    // The bytes of WaveformData (low, mid, high, all) are stored as RGBA
+    const int firstRow = firstIndex / m_textureStride;
+    const int lastRow = (lastIndex - 1) / m_textureStride;
+    const WaveformData* pData = m_pWaveform->data() + firstRow * m_textureStride;
+    m_pTexture->setData(0,
+            firstRow,
+            0,
+            m_textureStride,
+            lastRow - firstRow + 1,
+            1,
+            QOpenGLTexture::RGBA,
+            QOpenGLTexture::UInt8,
+            pData);
+}
+
+} // namespace allshader
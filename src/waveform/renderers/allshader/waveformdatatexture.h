@@ -0,0 +1,43 @@
+#pragma once
+
+#include <memory>
+
+#include "util/class.h"
+#include "waveform/waveform.h"
+
+class QOpenGLTexture;
+
+namespace allshader {
+class WaveformDataTexture;
+}
+
+/// Keeps a copy of the data of a Waveform in a texture on the GPU.
+///
+/// The complete texture is only uploaded once for each waveform. While
+/// the waveform is still being analyzed only the rows of the texture that
+/// have been completed since the last update are uploaded. Requires the
+/// OpenGL context to be current.
+class allshader::WaveformDataTexture final {
+  public:
+    WaveformDataTexture();
+    ~WaveformDataTexture();
+
+    /// Returns false if there is no data that could be displayed
+    bool update(const ConstWaveformPointer& pWaveform);
+
+    /// Only valid after update() returned true
+    QOpenGLTexture* texture() const {
+        return m_pTexture.get();
+    }
+
+  private:
+    void allocate(const ConstWaveformPointer& pWaveform);
+    void upload(int firstIndex, int lastIndex);
+
+    std::unique_ptr<QOpenGLTexture> m_pTexture;
+    ConstWaveformPointer m_pWaveform;
+    int m_textureStride;
+    int m_uploadedCompletion;
+
+    DISALLOW_COPY_AND_ASSIGN(WaveformDataTexture);
+};
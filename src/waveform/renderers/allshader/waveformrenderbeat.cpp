@@ -11,12 +11,16 @@
 namespace allshader {
 
 WaveformRenderBeat::WaveformRenderBeat(WaveformWidgetRenderer* waveformWidget)
-        : WaveformRenderer(waveformWidget) {
+        : WaveformRenderer(waveformWidget),
+          m_beatBuffer(QOpenGLBuffer::VertexBuffer),
+          m_bufferedTrackSamples(0) {
 }
 
 void WaveformRenderBeat::initializeGL() {
     WaveformRenderer::initializeGL();
     m_shader.init();
+    m_beatBuffer.create();
+    m_beatBuffer.setUsagePattern(QOpenGLBuffer::StaticDraw);
 }
 
 void WaveformRenderBeat::setup(const QDomNode& node, const SkinContext& context) {
@@ -41,87 +45,74 @@ void WaveformRenderBeat::paintGL() {
         return;
     }
 
-    const float devicePixelRatio = m_waveformRenderer->getDevicePixelRatio();
-
     glEnable(GL_BLEND);
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
     m_color.setAlphaF(alpha / 100.0);
 
     const double trackSamples = m_waveformRenderer->getTrackSamples();
-    if (trackSamples <= 0) {
+    const double audioSamplePerPixel = m_waveformRenderer->getAudioSamplePerPixel();
+    if (trackSamples <= 0 || audioSamplePerPixel <= 0) {
         return;
     }
 
-    const double firstDisplayedPosition =
-            m_waveformRenderer->getFirstDisplayedPosition();
-    const double lastDisplayedPosition =
-            m_waveformRenderer->getLastDisplayedPosition();
-
-    const auto startPosition = mixxx::audio::FramePos::fromEngineSamplePos(
-            firstDisplayedPosition * trackSamples);
-    const auto endPosition = mixxx::audio::FramePos::fromEngineSamplePos(
-            lastDisplayedPosition * trackSamples);
-
-    if (!startPosition.isValid() || !endPosition.isValid()) {
+    updateBeatBuffer(trackBeats, trackSamples);
+    if (m_vertices.size() == 0) {
         return;
     }
 
-    const float rendererBreadth = m_waveformRenderer->getBreadth();
-
-    const int numVerticesPerLine = 6; // 2 triangles
-
-    // Count the number of beats in the range to reserve space in the m_vertices vector.
-    // Note that we could also use
-    //   int numBearsInRange = trackBeats->numBeatsInRange(startPosition, endPosition);
-    // for this, but there have been reports of that method failing with a DEBUG_ASSERT.
-    int numBeatsInRange = 0;
-    for (auto it = trackBeats->iteratorFrom(startPosition);
-            it != trackBeats->cend() && *it <= endPosition;
-            ++it) {
-        numBeatsInRange++;
-    }
-
-    const int reserved = numBeatsInRange * numVerticesPerLine;
-    m_vertices.clear();
-    m_vertices.reserve(reserved);
-
-    for (auto it = trackBeats->iteratorFrom(startPosition);
-            it != trackBeats->cend() && *it <= endPosition;
-            ++it) {
-        double beatPosition = it->toEngineSamplePos();
-        double xBeatPoint =
-                m_waveformRenderer->transformSamplePositionInRendererWorld(beatPosition);
-
-        xBeatPoint = qRound(xBeatPoint * devicePixelRatio) / devicePixelRatio;
-
-        const float x1 = static_cast<float>(xBeatPoint);
-        const float x2 = x1 + 1.f;
-
-        m_vertices.addRectangle(x1, 0.f, x2, rendererBreadth);
-    }
-
-    DEBUG_ASSERT(reserved == m_vertices.size());
-
     const int positionLocation = m_shader.positionLocation();
     const int matrixLocation = m_shader.matrixLocation();
     const int colorLocation = m_shader.colorLocation();
 
+    // Maps the frame positions of the beats to the renderer world, see
+    // WaveformWidgetRenderer::transformSamplePositionInRendererWorld()
+    const double firstDisplayedFrame =
+            m_waveformRenderer->getFirstDisplayedPosition() * trackSamples / 2;
+    QMatrix4x4 matrix = matrixForWidgetGeometry(m_waveformRenderer, false);
+    matrix.translate(static_cast<float>(-firstDisplayedFrame / audioSamplePerPixel), 0.f);
+    matrix.scale(static_cast<float>(1 / audioSamplePerPixel),
+            static_cast<float>(m_waveformRenderer->getBreadth()));
+
     m_shader.bind();
     m_shader.enableAttributeArray(positionLocation);
 
-    const QMatrix4x4 matrix = matrixForWidgetGeometry(m_waveformRenderer, false);
-
-    m_shader.setAttributeArray(
-            positionLocation, GL_FLOAT, m_vertices.constData(), 2);
+    m_beatBuffer.bind();
+    m_shader.setAttributeBuffer(positionLocation, GL_FLOAT, 0, 2);
 
     m_shader.setUniformValue(matrixLocation, matrix);
     m_shader.setUniformValue(colorLocation, m_color);
 
-    glDrawArrays(GL_TRIANGLES, 0, m_vertices.size());
+    glDrawArrays(GL_LINES, 0, m_vertices.size());
 
+    m_beatBuffer.release();
     m_shader.disableAttributeArray(positionLocation);
     m_shader.release();
 }
 
+void WaveformRenderBeat::updateBeatBuffer(
+        const mixxx::BeatsPointer& pBeats, double trackSamples) {
+    if (pBeats == m_pBufferedBeats && trackSamples == m_bufferedTrackSamples) {
+        return;
+    }
+    m_pBufferedBeats = pBeats;
+    m_bufferedTrackSamples = trackSamples;
+
+    // Single precision frame positions are accurate enough for beat lines
+    // even in long tracks at the highest zoom level
+    const auto endPosition = mixxx::audio::FramePos::fromEngineSamplePos(trackSamples);
+    m_vertices.clear();
+    for (auto it = pBeats->iteratorFrom(mixxx::audio::kStartFramePos);
+            it != pBeats->cend() && *it <= endPosition;
+            ++it) {
+        const float x = static_cast<float>(it->value());
+        m_vertices.addLine({x, 0.f}, {x, 1.f});
+    }
+
+    m_beatBuffer.bind();
+    m_beatBuffer.allocate(m_vertices.constData(),
+            m_vertices.size() * static_cast<int>(sizeof(QVector2D)));
+    m_beatBuffer.release();
+}
+
 } // namespace allshader
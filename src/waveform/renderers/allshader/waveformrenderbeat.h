@@ -1,8 +1,10 @@
 #pragma once
 
 #include <QColor>
+#include <QOpenGLBuffer>
 
 #include "shaders/unicolorshader.h"
+#include "track/beats.h"
 #include "util/class.h"
 #include "waveform/renderers/allshader/vertexdata.h"
 #include "waveform/renderers/allshader/waveformrenderer.h"
@@ -23,9 +25,18 @@ class allshader::WaveformRenderBeat final : public allshader::WaveformRenderer {
     void initializeGL() override;
 
   private:
+    // Uploads the beat lines of the whole track in track coordinates, i.e.
+    // the frame position and the normalized breadth. They are only
+    // uploaded again when the beats or the track length change, scrolling
+    // and zooming only change the matrix.
+    void updateBeatBuffer(const mixxx::BeatsPointer& pBeats, double trackSamples);
+
     mixxx::UnicolorShader m_shader;
     QColor m_color;
     VertexData m_vertices;
+    QOpenGLBuffer m_beatBuffer;
+    mixxx::BeatsPointer m_pBufferedBeats;
+    double m_bufferedTrackSamples;
 
     DISALLOW_COPY_AND_ASSIGN(WaveformRenderBeat);
 };
@@ -39,19 +39,24 @@ void WaveformRendererLRRGB::paintGL() {
         return;
     }
 
-    const int dataSize = waveform->getDataSize();
-    if (dataSize <= 1) {
+    if (waveform->getDataSize() <= 1) {
         return;
     }
 
-    const WaveformData* data = waveform->data();
+    const float devicePixelRatio = m_waveformRenderer->getDevicePixelRatio();
+    const int length = static_cast<int>(m_waveformRenderer->getLength() * devicePixelRatio);
+
+    // Aggregate precomputed maxima instead of all visual frames when zoomed out
+    const int mipmapLevel = waveform->selectMipmapLevel(
+            (m_waveformRenderer->getLastDisplayedPosition() -
+                    m_waveformRenderer->getFirstDisplayedPosition()) /
+            length);
+    const int dataSize = waveform->getMipmapDataSize(mipmapLevel);
+    const WaveformData* data = waveform->mipmapData(mipmapLevel);
     if (data == nullptr) {
         return;
     }
 
-    const float devicePixelRatio = m_waveformRenderer->getDevicePixelRatio();
-    const int length = static_cast<int>(m_waveformRenderer->getLength() * devicePixelRatio);
-
     // See waveformrenderersimple.cpp for a detailed explanation of the frame and index calculation
     const int visualFramesSize = dataSize / 2;
     const double firstVisualFrame =
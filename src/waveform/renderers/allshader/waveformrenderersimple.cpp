@@ -33,19 +33,24 @@ void WaveformRendererSimple::paintGL() {
         return;
     }
 
-    const int dataSize = waveform->getDataSize();
-    if (dataSize <= 1) {
+    if (waveform->getDataSize() <= 1) {
         return;
     }
 
-    const WaveformData* data = waveform->data();
+    const float devicePixelRatio = m_waveformRenderer->getDevicePixelRatio();
+    const int length = static_cast<int>(m_waveformRenderer->getLength() * devicePixelRatio);
+
+    // Aggregate precomputed maxima instead of all visual frames when zoomed out
+    const int mipmapLevel = waveform->selectMipmapLevel(
+            (m_waveformRenderer->getLastDisplayedPosition() -
+                    m_waveformRenderer->getFirstDisplayedPosition()) /
+            length);
+    const int dataSize = waveform->getMipmapDataSize(mipmapLevel);
+    const WaveformData* data = waveform->mipmapData(mipmapLevel);
     if (data == nullptr) {
         return;
     }
 
-    const float devicePixelRatio = m_waveformRenderer->getDevicePixelRatio();
-    const int length = static_cast<int>(m_waveformRenderer->getLength() * devicePixelRatio);
-
     // Note that waveform refers to the visual waveform, not to audio samples.
     //
     // WaveformData* data contains the L and R waveform values interleaved. In the calculations
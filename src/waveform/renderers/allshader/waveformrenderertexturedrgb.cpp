@@ -0,0 +1,119 @@
+#include "waveform/renderers/allshader/waveformrenderertexturedrgb.h"
+
+#include <QOpenGLTexture>
+#include <QVector2D>
+#include <QVector3D>
+#include <array>
+
+#include "track/track.h"
+#include "waveform/renderers/allshader/matrixforwidgetgeometry.h"
+#include "waveform/renderers/waveformwidgetrenderer.h"
+#include "waveform/waveform.h"
+
+namespace allshader {
+
+WaveformRendererTexturedRGB::WaveformRendererTexturedRGB(
+        WaveformWidgetRenderer* waveformWidget)
+        : WaveformRendererSignalBase(waveformWidget) {
+}
+
+void WaveformRendererTexturedRGB::onSetup(const QDomNode& node) {
+    Q_UNUSED(node);
+}
+
+void WaveformRendererTexturedRGB::initializeGL() {
+    WaveformRendererSignalBase::initializeGL();
+    m_shader.init();
+}
+
+void WaveformRendererTexturedRGB::paintGL() {
+    TrackPointer pTrack = m_waveformRenderer->getTrackInfo();
+    if (!pTrack) {
+        return;
+    }
+
+    ConstWaveformPointer waveform = pTrack->getWaveform();
+    if (!m_texture.update(waveform)) {
+        return;
+    }
+
+    const int dataSize = waveform->getDataSize();
+    const float devicePixelRatio = m_waveformRenderer->getDevicePixelRatio();
+    const int length = static_cast<int>(m_waveformRenderer->getLength() * devicePixelRatio);
+    if (length <= 0) {
+        return;
+    }
+
+    // See WaveformRendererRGB::paintGL() for the calculation of the
+    // visual frames that are performed by the fragment shader
+    const int visualFramesSize = dataSize / 2;
+    const double firstVisualFrame =
+            m_waveformRenderer->getFirstDisplayedPosition() * visualFramesSize;
+    const double lastVisualFrame =
+            m_waveformRenderer->getLastDisplayedPosition() * visualFramesSize;
+    const double visualIncrementPerPixel =
+            (lastVisualFrame - firstVisualFrame) / static_cast<double>(length);
+    // Effective visual frame for x = 0
+    const double xVisualFrame = qRound(firstVisualFrame / visualIncrementPerPixel) *
+            visualIncrementPerPixel;
+
+    // Per-band gain from the EQ knobs.
+    float allGain(1.0), lowGain(1.0), midGain(1.0), highGain(1.0);
+    // applyCompensation = false, as we scale to match filtered.all
+    getGains(&allGain, false, &lowGain, &midGain, &highGain);
+
+    const float breadth = static_cast<float>(m_waveformRenderer->getBreadth()) * devicePixelRatio;
+    const float halfBreadth = breadth / 2.0f;
+    // The texture contains normalized values
+    const float heightFactor = allGain * halfBreadth;
+
+    const std::array<QVector2D, 4> vertices = {
+            QVector2D(0.f, 0.f),
+            QVector2D(static_cast<float>(length), 0.f),
+            QVector2D(0.f, breadth),
+            QVector2D(static_cast<float>(length), breadth),
+    };
+
+    const QMatrix4x4 matrix = matrixForWidgetGeometry(m_waveformRenderer, true);
+
+    const int positionLocation = m_shader.positionLocation();
+
+    m_shader.bind();
+    m_shader.enableAttributeArray(positionLocation);
+
+    m_shader.setUniformValue(m_shader.matrixLocation(), matrix);
+    m_shader.setUniformValue(m_shader.waveformTextureLocation(), 0);
+    m_shader.setUniformValue(m_shader.textureStrideLocation(),
+            static_cast<float>(waveform->getTextureStride()));
+    m_shader.setUniformValue(m_shader.dataSizeLocation(), static_cast<float>(dataSize));
+    m_shader.setUniformValue(m_shader.firstVisualFrameLocation(),
+            static_cast<float>(xVisualFrame));
+    m_shader.setUniformValue(m_shader.visualIncrementPerPixelLocation(),
+            static_cast<float>(visualIncrementPerPixel));
+    m_shader.setUniformValue(m_shader.halfBreadthLocation(), halfBreadth);
+    m_shader.setUniformValue(m_shader.heightFactorLocation(), heightFactor);
+    m_shader.setUniformValue(m_shader.axisHalfWidthLocation(), 0.5f * devicePixelRatio);
+    m_shader.setUniformValue(m_shader.gainsLocation(), QVector3D(lowGain, midGain, highGain));
+    m_shader.setUniformValue(m_shader.lowColorLocation(),
+            QVector3D(m_rgbLowColor_r, m_rgbLowColor_g, m_rgbLowColor_b));
+    m_shader.setUniformValue(m_shader.midColorLocation(),
+            QVector3D(m_rgbMidColor_r, m_rgbMidColor_g, m_rgbMidColor_b));
+    m_shader.setUniformValue(m_shader.highColorLocation(),
+            QVector3D(m_rgbHighColor_r, m_rgbHighColor_g, m_rgbHighColor_b));
+    m_shader.setUniformValue(m_shader.axesColorLocation(),
+            QVector3D(m_axesColor_r, m_axesColor_g, m_axesColor_b));
+
+    m_shader.setAttributeArray(
+            positionLocation, GL_FLOAT, vertices.data(), 2);
+
+    m_texture.texture()->bind();
+
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, static_cast<GLsizei>(vertices.size()));
+
+    m_texture.texture()->release();
+
+    m_shader.disableAttributeArray(positionLocation);
+    m_shader.release();
+}
+
+} // namespace allshader
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "shaders/rgbwaveformshader.h"
+#include "util/class.h"
+#include "waveform/renderers/allshader/waveformdatatexture.h"
+#include "waveform/renderers/allshader/waveformrenderersignalbase.h"
+
+namespace allshader {
+class WaveformRendererTexturedRGB;
+}
+
+/// Renders the same waveform as allshader::WaveformRendererRGB, but the
+/// waveform data is kept in a texture on the GPU. Instead of generating
+/// the vertices of each line on the CPU for every frame only a single
+/// rectangle is drawn and the lines are determined by the fragment shader.
+class allshader::WaveformRendererTexturedRGB final
+        : public allshader::WaveformRendererSignalBase {
+  public:
+    explicit WaveformRendererTexturedRGB(WaveformWidgetRenderer* waveformWidget);
+
+    // override ::WaveformRendererSignalBase
+    void onSetup(const QDomNode& node) override;
+
+    void initializeGL() override;
+    void paintGL() override;
+
+  private:
+    mixxx::RGBWaveformShader m_shader;
+    WaveformDataTexture m_texture;
+
+    DISALLOW_COPY_AND_ASSIGN(WaveformRendererTexturedRGB);
+};
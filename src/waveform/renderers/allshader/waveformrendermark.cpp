@@ -76,10 +76,10 @@ void allshader::WaveformRenderMark::drawTexture(float x, float y, QOpenGLTexture
 
     m_textureShader.bind();
 
-    const int matrixLocation = m_textureShader.uniformLocation("matrix");
-    const int textureLocation = m_textureShader.uniformLocation("texture");
-    const int positionLocation = m_textureShader.attributeLocation("position");
-    const int texcoordLocation = m_textureShader.attributeLocation("texcoord");
+    const int matrixLocation = m_textureShader.matrixLocation();
+    const int textureLocation = m_textureShader.textureLocation();
+    const int positionLocation = m_textureShader.positionLocation();
+    const int texcoordLocation = m_textureShader.texcoordLocation();
 
     m_textureShader.setUniformValue(matrixLocation, matrix);
 
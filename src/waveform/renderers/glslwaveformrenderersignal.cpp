@@ -52,17 +52,33 @@ bool GLSLWaveformRendererSignal::loadShaders() {
 
     m_frameShaderProgram->removeAllShaders();
 
-    if (!m_frameShaderProgram->addShaderFromSourceFile(
-                Shader::Vertex,
-                ":/shaders/passthrough.vert")) {
+#ifdef MIXXX_USE_QOPENGL
+    // Reuse the program binary from Qt's shader disk cache if the sources
+    // and the GL driver are unchanged
+    const bool vertexShaderAdded = m_frameShaderProgram->addCacheableShaderFromSourceFile(
+            Shader::Vertex,
+            ":/shaders/passthrough.vert");
+#else
+    const bool vertexShaderAdded = m_frameShaderProgram->addShaderFromSourceFile(
+            Shader::Vertex,
+            ":/shaders/passthrough.vert");
+#endif
+    if (!vertexShaderAdded) {
         qDebug() << "GLWaveformRendererSignalShader::loadShaders - "
                  << m_frameShaderProgram->log();
         return false;
     }
 
-    if (!m_frameShaderProgram->addShaderFromSourceFile(
-                Shader::Fragment,
-                m_pFragShader)) {
+#ifdef MIXXX_USE_QOPENGL
+    const bool fragmentShaderAdded = m_frameShaderProgram->addCacheableShaderFromSourceFile(
+            Shader::Fragment,
+            m_pFragShader);
+#else
+    const bool fragmentShaderAdded = m_frameShaderProgram->addShaderFromSourceFile(
+            Shader::Fragment,
+            m_pFragShader);
+#endif
+    if (!fragmentShaderAdded) {
         qDebug() << "GLWaveformRendererSignalShader::loadShaders - "
                  << m_frameShaderProgram->log();
         return false;
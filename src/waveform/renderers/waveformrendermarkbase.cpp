@@ -3,6 +3,7 @@
 #include "moc_waveformrendermarkbase.cpp"
 #include "track/track.h"
 #include "waveform/renderers/waveformwidgetrenderer.h"
+#include "waveform/waveformwidgetfactory.h"
 
 WaveformRenderMarkBase::WaveformRenderMarkBase(
         WaveformWidgetRenderer* pWaveformWidgetRenderer,
@@ -43,10 +44,12 @@ void WaveformRenderMarkBase::onResize() {
 void WaveformRenderMarkBase::onMarkChanged(double v) {
     Q_UNUSED(v);
 
+    const auto locker = WaveformWidgetFactory::instance()->lockRendering();
     updateMarks();
 }
 
 void WaveformRenderMarkBase::slotCuesUpdated() {
+    const auto locker = WaveformWidgetFactory::instance()->lockRendering();
     updateMarksFromCues();
 }
 
@@ -1,5 +1,7 @@
 #include "waveform/visualplayposition.h"
 
+#include <QThread>
+
 #include "moc_visualplayposition.cpp"
 #include "util/math.h"
 #if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
@@ -10,6 +12,7 @@
 QMap<QString, QWeakPointer<VisualPlayPosition>> VisualPlayPosition::m_listVisualPlayPosition;
 PerformanceTimer VisualPlayPosition::m_timeInfoTime;
 double VisualPlayPosition::m_dCallbackEntryToDacSecs = 0;
+double VisualPlayPosition::m_dSubBlockOffsetSecs = 0;
 
 VisualPlayPosition::VisualPlayPosition(const QString& key)
         : m_valid(false),
@@ -37,7 +40,8 @@ void VisualPlayPosition::set(
         double audioBufferMicroS) {
     VisualPlayPositionData data;
     data.m_referenceTime = m_timeInfoTime;
-    data.m_callbackEntrytoDac = static_cast<int>(m_dCallbackEntryToDacSecs * 1000000); // s to µs
+    data.m_callbackEntrytoDac = static_cast<int>(
+            (m_dCallbackEntryToDacSecs + m_dSubBlockOffsetSecs) * 1000000); // s to µs
     data.m_playPos = playPosition;
     data.m_playRate = playRate;
     data.m_slipRate = slipRate;
@@ -52,11 +56,22 @@ void VisualPlayPosition::set(
     data.m_tempoTrackSeconds = tempoTrackSeconds;
     data.m_audioBufferMicroS = audioBufferMicroS;
 
-    // Atomic write
-    m_data.setValue(data);
+    // Wait-free writes
+    m_engineData = data;
+    m_guiThreadData.setValue(data);
+    m_vsyncThreadData.setValue(data);
     m_valid = true;
 }
 
+VisualPlayPositionData VisualPlayPosition::getData(VSyncThread* pVSyncThread) const {
+    // The VSync thread draws the all-shader waveforms if the render thread
+    // of the WaveformWidgetFactory is enabled
+    if (pVSyncThread && QThread::currentThread() == pVSyncThread) {
+        return m_vsyncThreadData.getValue();
+    }
+    return m_guiThreadData.getValue();
+}
+
 double VisualPlayPosition::calcOffsetAtNextVSync(
         VSyncThread* pVSyncThread, const VisualPlayPositionData& data) {
     if (data.m_audioBufferMicroS != 0.0) {
@@ -160,7 +175,7 @@ double VisualPlayPosition::determinePlayPosInLoopBoundries(
 
 double VisualPlayPosition::getAtNextVSync(VSyncThread* pVSyncThread) {
     if (m_valid) {
-        const VisualPlayPositionData data = m_data.getValue();
+        const VisualPlayPositionData data = getData(pVSyncThread);
         const double offset = calcOffsetAtNextVSync(pVSyncThread, data);
 
         return determinePlayPosInLoopBoundries(data, offset);
@@ -172,7 +187,7 @@ void VisualPlayPosition::getPlaySlipAtNextVSync(VSyncThread* pVSyncThread,
         double* pPlayPosition,
         double* pSlipPosition) {
     if (m_valid) {
-        const VisualPlayPositionData data = m_data.getValue();
+        const VisualPlayPositionData data = getData(pVSyncThread);
         const double offset = calcOffsetAtNextVSync(pVSyncThread, data);
 
         double interpolatedPlayPos = determinePlayPosInLoopBoundries(data, offset);
@@ -188,8 +203,7 @@ void VisualPlayPosition::getPlaySlipAtNextVSync(VSyncThread* pVSyncThread,
 
 double VisualPlayPosition::getEnginePlayPos() {
     if (m_valid) {
-        VisualPlayPositionData data = m_data.getValue();
-        return data.m_playPos;
+        return m_engineData.m_playPos;
     } else {
         return -1;
     }
@@ -197,7 +211,7 @@ double VisualPlayPosition::getEnginePlayPos() {
 
 void VisualPlayPosition::getTrackTime(double* pPlayPosition, double* pTempoTrackSeconds) {
     if (m_valid) {
-        VisualPlayPositionData data = m_data.getValue();
+        const VisualPlayPositionData data = m_guiThreadData.getValue();
         *pPlayPosition = data.m_playPos;
         *pTempoTrackSeconds = data.m_tempoTrackSeconds;
     } else {
@@ -223,3 +237,8 @@ void VisualPlayPosition::setCallbackEntryToDacSecs(double secs, const Performanc
     m_timeInfoTime = time;
     m_dCallbackEntryToDacSecs = secs;
 }
+
+//static
+void VisualPlayPosition::setSubBlockOffsetSecs(double secs) {
+    m_dSubBlockOffsetSecs = secs;
+}
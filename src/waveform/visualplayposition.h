@@ -71,15 +71,20 @@ class VisualPlayPosition : public QObject {
             double tempoTrackSeconds,
             double audioBufferMicroS);
 
+    // The following functions must either be called from the GUI thread
+    // or from the VSync thread when it is drawing the waveforms.
     double getAtNextVSync(VSyncThread* pVSyncThread);
     void getPlaySlipAtNextVSync(VSyncThread* pVSyncThread,
             double* playPosition,
             double* slipPosition);
     double determinePlayPosInLoopBoundries(
             const VisualPlayPositionData& data, const double& offset);
-    double getEnginePlayPos();
     void getTrackTime(double* pPlayPosition, double* pTempoTrackSeconds);
 
+    // WARNING: Not thread safe. This function must be called only from the
+    // engine thread.
+    double getEnginePlayPos();
+
     // WARNING: Not thread safe. This function must only be called from the main
     // thread.
     static QSharedPointer<VisualPlayPosition> getVisualPlayPosition(const QString& group);
@@ -87,6 +92,10 @@ class VisualPlayPosition : public QObject {
     // This is called by SoundDevicePortAudio just after the callback starts.
     static void setCallbackEntryToDacSecs(double secs, const PerformanceTimer& time);
 
+    // This is called by EngineMixer before each sub-block of the callback
+    // with the time from the start of the callback buffer to the sub-block.
+    static void setSubBlockOffsetSecs(double secs);
+
     void setInvalid() { m_valid = false; };
     bool isValid() const {
         return m_valid;
@@ -94,7 +103,13 @@ class VisualPlayPosition : public QObject {
 
   private:
     double calcOffsetAtNextVSync(VSyncThread* pVSyncThread, const VisualPlayPositionData& data);
-    ControlValueAtomic<VisualPlayPositionData> m_data;
+    VisualPlayPositionData getData(VSyncThread* pVSyncThread) const;
+
+    // Each reading thread gets its own copy of the data, because a
+    // triple buffer only supports a single reader
+    VisualPlayPositionData m_engineData;
+    ControlValueTripleBuffer<VisualPlayPositionData> m_guiThreadData;
+    ControlValueTripleBuffer<VisualPlayPositionData> m_vsyncThreadData;
     bool m_valid;
     QString m_key;
     bool m_noTransport;
@@ -102,6 +117,8 @@ class VisualPlayPosition : public QObject {
     static QMap<QString, QWeakPointer<VisualPlayPosition>> m_listVisualPlayPosition;
     // Time info from the Sound device, updated just after audio callback is called
     static double m_dCallbackEntryToDacSecs;
+    // Offset of the sub-block that is currently processed by the engine
+    static double m_dSubBlockOffsetSecs;
     // Time stamp for m_timeInfo in main CPU time
     static PerformanceTimer m_timeInfoTime;
 };
@@ -1,6 +1,9 @@
 #include "waveform/waveform.h"
 
 #include <QtDebug>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 
 #include "analyzer/constants.h"
 #include "proto/waveform.pb.h"
@@ -9,6 +12,38 @@ using namespace mixxx::track;
 
 constexpr int kNumChannels = 2;
 
+namespace {
+
+// The minimum number of mipmap entries per channel that are aggregated
+// into each pixel. Using fewer and coarser entries would visibly shift
+// the peaks.
+constexpr double kMinMipmapFramesPerPixel = 4.0;
+
+constexpr quint32 kRawMagic = 0x46575852; // "RXWF"
+constexpr quint32 kRawVersion = 1;
+
+struct RawHeader {
+    quint32 magic;
+    quint32 version;
+    qint32 dataSize;
+    quint32 reserved;
+    double visualSampleRate;
+    double audioVisualRatio;
+};
+static_assert(sizeof(RawHeader) == 32);
+static_assert(sizeof(WaveformData) == 4);
+
+WaveformData maxOf(const WaveformData& lhs, const WaveformData& rhs) {
+    WaveformData result;
+    result.filtered.low = std::max(lhs.filtered.low, rhs.filtered.low);
+    result.filtered.mid = std::max(lhs.filtered.mid, rhs.filtered.mid);
+    result.filtered.high = std::max(lhs.filtered.high, rhs.filtered.high);
+    result.filtered.all = std::max(lhs.filtered.all, rhs.filtered.all);
+    return result;
+}
+
+} // anonymous namespace
+
 // Return the smallest power of 2 which is greater than the desired size when
 // squared.
 int computeTextureStride(int size) {
@@ -134,10 +169,63 @@ QByteArray Waveform::toByteArray() const {
     return QByteArray(output.data(), static_cast<int>(output.length()));
 }
 
+QByteArray Waveform::toRawByteArray() const {
+    const int dataSize = getDataSize();
+    const RawHeader header{kRawMagic,
+            kRawVersion,
+            dataSize,
+            0,
+            m_visualSampleRate,
+            m_audioVisualRatio};
+    QByteArray data(static_cast<int>(sizeof(header) + dataSize * sizeof(WaveformData)),
+            Qt::Uninitialized);
+    std::memcpy(data.data(), &header, sizeof(header));
+    std::memcpy(data.data() + sizeof(header),
+            m_data.data(),
+            dataSize * sizeof(WaveformData));
+    return data;
+}
+
+// static
+bool Waveform::isRawByteArray(const QByteArray& data) {
+    quint32 magic;
+    if (data.size() < static_cast<int>(sizeof(RawHeader))) {
+        return false;
+    }
+    std::memcpy(&magic, data.constData(), sizeof(magic));
+    return magic == kRawMagic;
+}
+
+void Waveform::readRawByteArray(const QByteArray& data) {
+    RawHeader header;
+    std::memcpy(&header, data.constData(), sizeof(header));
+    if (header.version != kRawVersion ||
+            header.dataSize < 0 ||
+            data.size() != static_cast<int>(sizeof(header) +
+                                   header.dataSize * sizeof(WaveformData))) {
+        qDebug() << "ERROR: Could not read raw Waveform from QByteArray of size"
+                 << data.size();
+        return;
+    }
+    resize(header.dataSize);
+    m_visualSampleRate = header.visualSampleRate;
+    m_audioVisualRatio = header.audioVisualRatio;
+    std::memcpy(m_data.data(),
+            data.constData() + sizeof(header),
+            header.dataSize * sizeof(WaveformData));
+    updateMipmaps(0, header.dataSize);
+    m_completion = header.dataSize;
+    m_saveState = SaveState::Saved;
+}
+
 void Waveform::readByteArray(const QByteArray& data) {
     if (data.isNull()) {
         return;
     }
+    if (isRawByteArray(data)) {
+        readRawByteArray(data);
+        return;
+    }
 
     io::Waveform waveform;
 
@@ -201,6 +289,7 @@ void Waveform::readByteArray(const QByteArray& data) {
         m_data[i].filtered.mid = use_mid ? static_cast<unsigned char>(mid.value(i)) : 0;
         m_data[i].filtered.high = use_high ? static_cast<unsigned char>(high.value(i)) : 0;
     }
+    updateMipmaps(0, dataSize);
     m_completion = dataSize;
     m_saveState = SaveState::Saved;
 }
@@ -209,15 +298,64 @@ void Waveform::resize(int size) {
     m_dataSize = size;
     m_textureStride = computeTextureStride(size);
     m_data.resize(m_textureStride * m_textureStride);
+    allocateMipmaps();
 }
 
 void Waveform::assign(int size, int value) {
     m_dataSize = size;
     m_textureStride = computeTextureStride(size);
     m_data.assign(m_textureStride * m_textureStride, value);
+    allocateMipmaps();
+    if (value != 0) {
+        updateMipmaps(0, size);
+    }
     m_saveState = SaveState::SavePending;
 }
 
+void Waveform::allocateMipmaps() {
+    m_mipmaps.clear();
+    int frames = m_dataSize / kNumChannels;
+    while (frames > 1) {
+        frames = (frames + 1) / 2;
+        m_mipmaps.emplace_back(frames * kNumChannels, WaveformData(0));
+    }
+}
+
+int Waveform::selectMipmapLevel(double fractionPerPixel) const {
+    const double framesPerPixel = fractionPerPixel * m_dataSize / kNumChannels;
+    if (!std::isfinite(framesPerPixel) ||
+            framesPerPixel < 2 * kMinMipmapFramesPerPixel) {
+        return 0;
+    }
+    const int level = static_cast<int>(std::floor(
+            std::log2(framesPerPixel / kMinMipmapFramesPerPixel)));
+    return std::min(level, getMipmapLevelCount() - 1);
+}
+
+void Waveform::updateMipmaps(int firstIndex, int lastIndex) {
+    // The range of frames in the finer level
+    int firstFrame = firstIndex / kNumChannels;
+    int lastFrame = (lastIndex + kNumChannels - 1) / kNumChannels;
+    const WaveformData* pFiner = m_data.data();
+    int finerFrames = m_dataSize / kNumChannels;
+    for (auto& mipmap : m_mipmaps) {
+        firstFrame /= 2;
+        lastFrame = (lastFrame + 1) / 2;
+        for (int frame = firstFrame; frame < lastFrame; ++frame) {
+            for (int chn = 0; chn < kNumChannels; ++chn) {
+                const int finerIndex = 2 * frame * kNumChannels + chn;
+                WaveformData value = pFiner[finerIndex];
+                if (2 * frame + 1 < finerFrames) {
+                    value = maxOf(value, pFiner[finerIndex + kNumChannels]);
+                }
+                mipmap[frame * kNumChannels + chn] = value;
+            }
+        }
+        pFiner = mipmap.data();
+        finerFrames = static_cast<int>(mipmap.size()) / kNumChannels;
+    }
+}
+
 void Waveform::dump() const {
     qDebug() << "Waveform" << this
              << "size("+QString::number(getDataSize())+")"
@@ -75,6 +75,10 @@ class Waveform {
     }
 
     QByteArray toByteArray() const;
+    // The data as it is laid out in memory, which can be restored without
+    // parsing or decompressing it. Only valid on the same platform.
+    QByteArray toRawByteArray() const;
+    static bool isRawByteArray(const QByteArray& data);
 
     SaveState saveState() const {
         return m_saveState;
@@ -128,12 +132,36 @@ class Waveform {
     // constructor runs.
     const WaveformData* data() const { return &m_data[0];}
 
+    // Mipmap level k > 0 contains the maximum of each band and channel over
+    // 2^k visual frames of the data. Level 0 is the data itself. The levels
+    // are not resized after the constructor runs.
+    int getMipmapLevelCount() const {
+        return static_cast<int>(m_mipmaps.size()) + 1;
+    }
+    int getMipmapDataSize(int level) const {
+        return level == 0 ? m_dataSize : static_cast<int>(m_mipmaps[level - 1].size());
+    }
+    const WaveformData* mipmapData(int level) const {
+        return level == 0 ? data() : m_mipmaps[level - 1].data();
+    }
+
+    // Selects the coarsest mipmap level that still provides multiple
+    // entries per pixel for displaying the given fraction of the waveform
+    // in each pixel.
+    int selectMipmapLevel(double fractionPerPixel) const;
+
+    // Updates the mipmap levels after the data elements in the range
+    // [firstIndex, lastIndex) have been modified.
+    void updateMipmaps(int firstIndex, int lastIndex);
+
     void dump() const;
 
   private:
     void readByteArray(const QByteArray& data);
+    void readRawByteArray(const QByteArray& data);
     void resize(int size);
     void assign(int size, int value = 0);
+    void allocateMipmaps();
 
     inline WaveformData& at(int i) { return m_data[i];}
     inline unsigned char& low(int i) { return m_data[i].filtered.low;}
@@ -160,6 +188,9 @@ class Waveform {
     // TODO(XXX): In the future we should switch to QVector and use the raw data
     // pointer when performance matters.
     std::vector<WaveformData> m_data;
+    // The coarser levels with the interleaved channels like m_data,
+    // starting at level 1. Not resized after the constructor runs.
+    std::vector<std::vector<WaveformData>> m_mipmaps;
     // Not allowed to change after the constructor runs.
     double m_visualSampleRate;
     // Not allowed to change after the constructor runs.
@@ -8,17 +8,22 @@
 #include <QGLShaderProgram>
 #endif
 
+#include <QOpenGLContext>
 #include <QOpenGLFunctions>
 #include <QRegularExpression>
 #include <QStringList>
 #include <QWidget>
 #include <QWindow>
 
+#include "control/controlobject.h"
+#include "control/controlproxy.h"
+#include "control/pollingcontrolproxy.h"
 #include "moc_waveformwidgetfactory.cpp"
 #include "util/cmdlineargs.h"
 #include "util/math.h"
 #include "util/performancetimer.h"
 #include "util/timer.h"
+#include "waveform/framepacer.h"
 #include "waveform/guitick.h"
 #include "waveform/sharedglcontext.h"
 #include "waveform/visualsmanager.h"
@@ -29,6 +34,8 @@
 #include "waveform/widgets/allshader/lrrgbwaveformwidget.h"
 #include "waveform/widgets/allshader/rgbwaveformwidget.h"
 #include "waveform/widgets/allshader/simplewaveformwidget.h"
+#include "waveform/widgets/allshader/texturedrgbwaveformwidget.h"
+#include "waveform/widgets/allshader/waveformwidget.h"
 #else
 #include "waveform/widgets/qthsvwaveformwidget.h"
 #include "waveform/widgets/qtrgbwaveformwidget.h"
@@ -70,6 +77,36 @@ bool shouldRenderWaveform(WaveformWidgetAbstract* pWaveformWidget) {
 }
 
 const QRegularExpression openGLVersionRegex(QStringLiteral("^(\\d+)\\.(\\d+).*$"));
+
+// Returns true if the widget is drawn on the render thread instead of the
+// GUI thread.
+bool isRenderedOnThread(WaveformWidgetAbstract* pWaveformWidget) {
+#ifdef MIXXX_USE_QOPENGL
+    if (pWaveformWidget == nullptr) {
+        return false;
+    }
+    auto* glw = pWaveformWidget->getGLWidget();
+    return glw != nullptr && glw->isRenderedOnThread();
+#else
+    Q_UNUSED(pWaveformWidget);
+    return false;
+#endif
+}
+
+#ifdef MIXXX_USE_QOPENGL
+const ConfigKey kRenderThreadConfigKey =
+        ConfigKey(QStringLiteral("[Waveform]"), QStringLiteral("RenderThread"));
+#endif
+
+const QString kAppGroup = QStringLiteral("[App]");
+
+const ConfigKey kAdaptiveFrameRateConfigKey =
+        ConfigKey(QStringLiteral("[Waveform]"), QStringLiteral("AdaptiveFrameRate"));
+const ConfigKey kRenderBudgetConfigKey =
+        ConfigKey(QStringLiteral("[Waveform]"), QStringLiteral("RenderBudgetPercent"));
+constexpr int kDefaultRenderBudgetPercent = 20;
+// The maximum frame rate while running on battery
+constexpr int kPowerSavingFrameRate = 30;
 }  // anonymous namespace
 
 ///////////////////////////////////////////
@@ -118,6 +155,10 @@ WaveformWidgetFactory::WaveformWidgetFactory()
           m_vsyncThread(nullptr),
           m_pGuiTick(nullptr),
           m_pVisualsManager(nullptr),
+          m_pRenderContext(nullptr),
+          m_renderMutex(QT_RECURSIVE_MUTEX_INIT),
+          m_guiThreadFramePending(false),
+          m_renderBudget(kDefaultRenderBudgetPercent / 100.0),
           m_frameCnt(0),
           m_actualFrameRate(0),
           m_playMarkerPosition(WaveformWidgetRenderer::s_defaultPlayMarkerPosition) {
@@ -337,6 +378,8 @@ WaveformWidgetFactory::~WaveformWidgetFactory() {
     if (m_vsyncThread) {
         delete m_vsyncThread;
     }
+    // The VSync thread has finished and no longer uses the context
+    delete m_pRenderContext;
 }
 
 bool WaveformWidgetFactory::setConfig(UserSettingsPointer config) {
@@ -350,6 +393,15 @@ bool WaveformWidgetFactory::setConfig(UserSettingsPointer config) {
     int frameRate = m_config->getValue(ConfigKey("[Waveform]","FrameRate"), m_frameRate);
     m_frameRate = math_clamp(frameRate, 1, 120);
 
+    const int renderBudgetPercent = m_config->getValue(
+            kRenderBudgetConfigKey, kDefaultRenderBudgetPercent);
+    m_renderBudget = math_clamp(renderBudgetPercent, 1, 100) / 100.0;
+    if (m_config->getValue(kAdaptiveFrameRateConfigKey, false)) {
+        m_pFramePacer = std::make_unique<FramePacer>(m_frameRate, m_renderBudget);
+    } else {
+        m_pFramePacer.reset();
+    }
+
 
     int endTime = m_config->getValueString(ConfigKey("[Waveform]","EndOfTrackWarningTime")).toInt(&ok);
     if (ok) {
@@ -407,6 +459,7 @@ bool WaveformWidgetFactory::setConfig(UserSettingsPointer config) {
 }
 
 void WaveformWidgetFactory::destroyWidgets() {
+    const auto locker = lockRendering();
     for (auto& holder : m_waveformWidgetHolders) {
         WaveformWidgetAbstract* pWidget = holder.m_waveformWidget;
         holder.m_waveformWidget = nullptr;
@@ -452,6 +505,7 @@ void WaveformWidgetFactory::slotSkinLoaded() {
 bool WaveformWidgetFactory::setWaveformWidget(WWaveformViewer* viewer,
                                               const QDomElement& node,
                                               const SkinContext& parentContext) {
+    const auto locker = lockRendering();
     int index = findIndexOf(viewer);
     if (index != -1) {
         qDebug() << "WaveformWidgetFactory::setWaveformWidget - "\
@@ -465,6 +519,17 @@ bool WaveformWidgetFactory::setWaveformWidget(WWaveformViewer* viewer,
     viewer->setWaveformWidget(waveformWidget);
     viewer->setup(node, parentContext);
 
+    {
+        const QMutexLocker statsLocker(&m_renderStatsMutex);
+        RenderStats& stats = m_renderStats[waveformWidget->getGroup()];
+        if (!stats.pRenderTimeMs) {
+            stats.pRenderTimeMs = std::make_unique<ControlObject>(
+                    ConfigKey(waveformWidget->getGroup(),
+                            QStringLiteral("waveform_render_time_ms")));
+            stats.pRenderTimeMs->setReadOnly();
+        }
+    }
+
     // create new holder
     WaveformWidgetHolder holder(waveformWidget, viewer, node, &parentContext);
     if (index == -1) {
@@ -494,11 +559,37 @@ void WaveformWidgetFactory::setFrameRate(int frameRate) {
     if (m_config) {
         m_config->set(ConfigKey("[Waveform]","FrameRate"), ConfigValue(m_frameRate));
     }
+    applyFrameRate();
+}
+
+int WaveformWidgetFactory::maxFrameRate() const {
+    if (m_pPowerSaving && m_pPowerSaving->toBool()) {
+        return math_min(m_frameRate, kPowerSavingFrameRate);
+    }
+    return m_frameRate;
+}
+
+void WaveformWidgetFactory::applyFrameRate() {
+    int currentFrameRate = maxFrameRate();
+    {
+        // The frame pacer is updated by the thread that counts the frames
+        const QMutexLocker statsLocker(&m_renderStatsMutex);
+        if (m_pFramePacer) {
+            m_pFramePacer->setMaxFrameRate(currentFrameRate);
+            currentFrameRate = m_pFramePacer->frameRate();
+        }
+    }
     if (m_vsyncThread) {
-        m_vsyncThread->setSyncIntervalTimeMicros(static_cast<int>(1e6 / m_frameRate));
+        m_vsyncThread->setSyncIntervalTimeMicros(static_cast<int>(1e6 / currentFrameRate));
     }
 }
 
+void WaveformWidgetFactory::slotPowerSavingChanged(double value) {
+    qDebug() << "WaveformWidgetFactory: Limiting the waveform frame rate to"
+             << maxFrameRate() << (value > 0 ? "while saving power" : "");
+    applyFrameRate();
+}
+
 void WaveformWidgetFactory::setEndOfTrackWarningTime(int endTime) {
     m_endOfTrackWarningTime = endTime;
     if (m_config) {
@@ -573,6 +664,7 @@ bool WaveformWidgetFactory::setWidgetTypeFromHandle(int handleIndex, bool force)
     // change the type
     setWidgetType(handle.m_type);
 
+    const auto locker = lockRendering();
     m_skipRender = true;
 
     //re-create/setup all waveform widgets
@@ -639,6 +731,7 @@ void WaveformWidgetFactory::setDisplayBeatGridAlpha(int alpha) {
         return;
     }
 
+    const auto locker = lockRendering();
     for (const auto& holder : std::as_const(m_waveformWidgetHolders)) {
         holder.m_waveformWidget->setDisplayBeatGridAlpha(m_beatGridAlpha);
     }
@@ -668,6 +761,7 @@ void WaveformWidgetFactory::setPlayMarkerPosition(double position) {
         m_config->setValue(ConfigKey("[Waveform]", "PlayMarkerPosition"), m_playMarkerPosition);
     }
 
+    const auto locker = lockRendering();
     for (const auto& holder : std::as_const(m_waveformWidgetHolders)) {
         holder.m_waveformWidget->setPlayMarkerPosition(m_playMarkerPosition);
     }
@@ -687,71 +781,169 @@ void WaveformWidgetFactory::notifyZoomChange(WWaveformViewer* viewer) {
     }
 }
 
-void WaveformWidgetFactory::renderSelf() {
-    ScopedTimer t("WaveformWidgetFactory::render() %1waveforms",
+void WaveformWidgetFactory::renderWaveforms(bool onRenderThread) {
+    // next rendered frame is displayed after next buffer swap and than after VSync
+    QVarLengthArray<bool, 10> shouldRenderWaveforms(
             static_cast<int>(m_waveformWidgetHolders.size()));
-
-    if (!m_skipRender) {
-        if (m_type) {   // no regular updates for an empty waveform
-            // next rendered frame is displayed after next buffer swap and than after VSync
-            QVarLengthArray<bool, 10> shouldRenderWaveforms(
-                    static_cast<int>(m_waveformWidgetHolders.size()));
-            for (decltype(m_waveformWidgetHolders)::size_type i = 0;
-                    i < m_waveformWidgetHolders.size();
-                    i++) {
-                WaveformWidgetAbstract* pWaveformWidget = m_waveformWidgetHolders[i].m_waveformWidget;
-                // Don't bother doing the pre-render work if we aren't going to
-                // render this widget.
-                bool shouldRender = shouldRenderWaveform(pWaveformWidget);
-                shouldRenderWaveforms[static_cast<int>(i)] = shouldRender;
-                if (!shouldRender) {
-                    continue;
-                }
-                // Calculate play position for the new Frame in following run
-                pWaveformWidget->preRender(m_vsyncThread);
-            }
-            //qDebug() << "prerender" << m_vsyncThread->elapsed();
-
-            // It may happen that there is an artificially delayed due to
-            // anti tearing driver settings
-            // all render commands are delayed until the swap from the previous run is executed
-            for (decltype(m_waveformWidgetHolders)::size_type i = 0;
-                    i < m_waveformWidgetHolders.size();
-                    i++) {
-                WaveformWidgetAbstract* pWaveformWidget = m_waveformWidgetHolders[i].m_waveformWidget;
-                if (!shouldRenderWaveforms[static_cast<int>(i)]) {
-                    continue;
-                }
-                pWaveformWidget->render();
-                //qDebug() << "render" << i << m_vsyncThread->elapsed();
+    for (decltype(m_waveformWidgetHolders)::size_type i = 0;
+            i < m_waveformWidgetHolders.size();
+            i++) {
+        WaveformWidgetAbstract* pWaveformWidget = m_waveformWidgetHolders[i].m_waveformWidget;
+        // Don't bother doing the pre-render work if we aren't going to
+        // render this widget.
+        bool shouldRender = isRenderedOnThread(pWaveformWidget) == onRenderThread &&
+                shouldRenderWaveform(pWaveformWidget);
+#ifdef MIXXX_USE_QOPENGL
+        if (shouldRender && onRenderThread) {
+            // The window is initialized by the GUI thread when it is exposed
+            // for the first time
+            shouldRender = pWaveformWidget->getGLWidget()->isInitialized();
+        }
+#endif
+        shouldRenderWaveforms[static_cast<int>(i)] = shouldRender;
+        if (!shouldRender) {
+            continue;
+        }
+        // Calculate play position for the new Frame in following run
+        pWaveformWidget->preRender(m_vsyncThread);
+    }
+    //qDebug() << "prerender" << m_vsyncThread->elapsed();
+
+    // It may happen that there is an artificially delayed due to
+    // anti tearing driver settings
+    // all render commands are delayed until the swap from the previous run is executed
+    for (decltype(m_waveformWidgetHolders)::size_type i = 0;
+            i < m_waveformWidgetHolders.size();
+            i++) {
+        WaveformWidgetAbstract* pWaveformWidget = m_waveformWidgetHolders[i].m_waveformWidget;
+        if (!shouldRenderWaveforms[static_cast<int>(i)]) {
+            continue;
+        }
+        ScopedTimer t("WaveformWidgetFactory::renderWaveforms() %1",
+                pWaveformWidget->getGroup(),
+                kDefaultComputeFlags | Stat::HISTOGRAM);
+        PerformanceTimer renderTimer;
+        renderTimer.start();
+#ifdef MIXXX_USE_QOPENGL
+        if (onRenderThread) {
+            WGLWidget* glw = pWaveformWidget->getGLWidget();
+            QOpenGLWindow* pWindow = glw->getOpenGLWindow();
+            if (!m_pRenderContext->makeCurrent(pWindow)) {
+                continue;
             }
+            // The viewport of the context has been set up for the first
+            // window it was made current with
+            const qreal devicePixelRatio = pWindow->devicePixelRatio();
+            m_pRenderContext->functions()->glViewport(0,
+                    0,
+                    static_cast<int>(pWindow->width() * devicePixelRatio),
+                    static_cast<int>(pWindow->height() * devicePixelRatio));
+            glw->paintGL();
+            addRenderTime(pWaveformWidget->getGroup(), renderTimer.elapsed());
+            continue;
         }
+#endif
+        pWaveformWidget->render();
+        addRenderTime(pWaveformWidget->getGroup(), renderTimer.elapsed());
+        //qDebug() << "render" << i << m_vsyncThread->elapsed();
+    }
+#ifdef MIXXX_USE_QOPENGL
+    if (onRenderThread) {
+        m_pRenderContext->doneCurrent();
+    }
+#endif
+}
 
+void WaveformWidgetFactory::renderOtherWidgets() {
+    if (!m_skipRender) {
         // WSpinnys are also double-buffered WGLWidgets, like all the waveform
         // renderers. Render all the WSpinny widgets now.
         emit renderSpinnies(m_vsyncThread);
         // Same for WVuMeterGL. Note that we are either using WVuMeter or WVuMeterGL.
         // If we are using WVuMeter, this does nothing
         emit renderVuMeters(m_vsyncThread);
+        // The widgets leave their contexts current, so that switching
+        // between them doesn't require releasing each one
+        doneCurrentAfterOtherWidgets();
 
         // Notify all other waveform-like widgets (e.g. WSpinny's) that they should
         // update.
         //int t1 = m_vsyncThread->elapsed();
         emit waveformUpdateTick();
         //qDebug() << "emit" << m_vsyncThread->elapsed() - t1;
-
-        m_frameCnt += 1.0f;
-        mixxx::Duration timeCnt = m_time.elapsed();
-        if (timeCnt > mixxx::Duration::fromSeconds(1)) {
-            m_time.start();
-            m_frameCnt = m_frameCnt * 1000 / timeCnt.toIntegerMillis(); // latency correction
-            emit waveformMeasured(m_frameCnt, m_vsyncThread->droppedFrames());
-            m_frameCnt = 0.0;
-        }
     }
 
     m_pVisualsManager->process(m_endOfTrackWarningTime);
     m_pGuiTick->process();
+}
+
+void WaveformWidgetFactory::countFrame() {
+    m_frameCnt += 1.0f;
+    mixxx::Duration timeCnt = m_time.elapsed();
+    if (timeCnt > mixxx::Duration::fromSeconds(1)) {
+        m_time.start();
+        m_frameCnt = m_frameCnt * 1000 / timeCnt.toIntegerMillis(); // latency correction
+        emit waveformMeasured(m_frameCnt, m_vsyncThread->droppedFrames());
+        updateRenderStats(timeCnt, m_frameCnt);
+        m_frameCnt = 0.0;
+    }
+}
+
+void WaveformWidgetFactory::addRenderTime(const QString& group, mixxx::Duration renderTime) {
+    const QMutexLocker statsLocker(&m_renderStatsMutex);
+    const auto it = m_renderStats.find(group);
+    if (it == m_renderStats.end()) {
+        return;
+    }
+    it->second.renderTime += renderTime;
+    it->second.frameCount++;
+}
+
+void WaveformWidgetFactory::updateRenderStats(mixxx::Duration elapsed, float frameRate) {
+    if (!m_pRenderLoadControl) {
+        return;
+    }
+    mixxx::Duration renderTime;
+    int previousFrameRate = 0;
+    int nextFrameRate = 0;
+    {
+        const QMutexLocker statsLocker(&m_renderStatsMutex);
+        for (auto& [group, stats] : m_renderStats) {
+            renderTime += stats.renderTime;
+            stats.pRenderTimeMs->forceSet(stats.frameCount > 0
+                            ? stats.renderTime.toDoubleMillis() / stats.frameCount
+                            : 0.0);
+            stats.renderTime = mixxx::Duration::empty();
+            stats.frameCount = 0;
+        }
+        if (m_pFramePacer) {
+            previousFrameRate = m_pFramePacer->frameRate();
+            nextFrameRate = m_pFramePacer->update(
+                    renderTime, elapsed, m_pAudioLatencyUsage->get());
+        }
+    }
+    m_pFrameRateControl->forceSet(frameRate);
+    m_pDroppedFramesControl->forceSet(m_vsyncThread->droppedFrames());
+    m_pRenderLoadControl->forceSet(renderTime.toDoubleSeconds() / elapsed.toDoubleSeconds());
+
+    if (nextFrameRate != previousFrameRate) {
+        qDebug() << "WaveformWidgetFactory: Adapting the waveform frame rate to"
+                 << nextFrameRate;
+        m_vsyncThread->setSyncIntervalTimeMicros(static_cast<int>(1e6 / nextFrameRate));
+    }
+}
+
+void WaveformWidgetFactory::renderSelf() {
+    ScopedTimer t("WaveformWidgetFactory::render() %1waveforms",
+            static_cast<int>(m_waveformWidgetHolders.size()));
+
+    if (!m_skipRender && m_type) { // no regular updates for an empty waveform
+        renderWaveforms(false);
+    }
+    renderOtherWidgets();
+    if (!m_skipRender) {
+        countFrame();
+    }
 
     //qDebug() << "refresh end" << m_vsyncThread->elapsed();
 }
@@ -761,6 +953,62 @@ void WaveformWidgetFactory::render() {
     m_vsyncThread->vsyncSlotFinished();
 }
 
+void WaveformWidgetFactory::swapWaveforms(bool onRenderThread) {
+    // Show rendered buffer from last render() run
+    //qDebug() << "swap() start" << m_vsyncThread->elapsed();
+    for (const auto& holder : std::as_const(m_waveformWidgetHolders)) {
+        WaveformWidgetAbstract* pWaveformWidget = holder.m_waveformWidget;
+
+        // Don't swap invalid / invisible widgets or widgets with an
+        // unexposed window. Prevents continuous log spew of
+        // "QOpenGLContext::swapBuffers() called with non-exposed
+        // window, behavior is undefined" on Qt5. See issue #9360.
+        if (isRenderedOnThread(pWaveformWidget) != onRenderThread ||
+                !shouldRenderWaveform(pWaveformWidget)) {
+            continue;
+        }
+        WGLWidget* glw = pWaveformWidget->getGLWidget();
+        if (glw == nullptr) {
+            continue;
+        }
+#ifdef MIXXX_USE_QOPENGL
+        if (onRenderThread) {
+            QOpenGLWindow* pWindow = glw->getOpenGLWindow();
+            if (glw->isInitialized() && m_pRenderContext->makeCurrent(pWindow)) {
+                m_pRenderContext->swapBuffers(pWindow);
+            }
+            continue;
+        }
+#endif
+        glw->makeCurrentIfNeeded();
+        glw->swapBuffers();
+        glw->doneCurrent();
+        //qDebug() << "swap x" << m_vsyncThread->elapsed();
+    }
+#ifdef MIXXX_USE_QOPENGL
+    if (onRenderThread) {
+        m_pRenderContext->doneCurrent();
+    }
+#endif
+}
+
+void WaveformWidgetFactory::swapOtherWidgets() {
+    // WSpinnys are also double-buffered QGLWidgets, like all the waveform
+    // renderers. Swap all the WSpinny widgets now.
+    emit swapSpinnies();
+    // Same for WVuMeterGL. Note that we are either using WVuMeter or WVuMeterGL
+    // If we are using WVuMeter, this does nothing
+    emit swapVuMeters();
+    doneCurrentAfterOtherWidgets();
+}
+
+void WaveformWidgetFactory::doneCurrentAfterOtherWidgets() {
+    QOpenGLContext* pContext = QOpenGLContext::currentContext();
+    if (pContext) {
+        pContext->doneCurrent();
+    }
+}
+
 void WaveformWidgetFactory::swapSelf() {
     ScopedTimer t("WaveformWidgetFactory::swap() %1waveforms",
             static_cast<int>(m_waveformWidgetHolders.size()));
@@ -768,33 +1016,9 @@ void WaveformWidgetFactory::swapSelf() {
     // Do this in an extra slot to be sure to hit the desired interval
     if (!m_skipRender) {
         if (m_type) {   // no regular updates for an empty waveform
-            // Show rendered buffer from last render() run
-            //qDebug() << "swap() start" << m_vsyncThread->elapsed();
-            for (const auto& holder : std::as_const(m_waveformWidgetHolders)) {
-                WaveformWidgetAbstract* pWaveformWidget = holder.m_waveformWidget;
-
-                // Don't swap invalid / invisible widgets or widgets with an
-                // unexposed window. Prevents continuous log spew of
-                // "QOpenGLContext::swapBuffers() called with non-exposed
-                // window, behavior is undefined" on Qt5. See issue #9360.
-                if (!shouldRenderWaveform(pWaveformWidget)) {
-                    continue;
-                }
-                WGLWidget* glw = pWaveformWidget->getGLWidget();
-                if (glw != nullptr) {
-                    glw->makeCurrentIfNeeded();
-                    glw->swapBuffers();
-                    glw->doneCurrent();
-                }
-                //qDebug() << "swap x" << m_vsyncThread->elapsed();
-            }
+            swapWaveforms(false);
         }
-        // WSpinnys are also double-buffered QGLWidgets, like all the waveform
-        // renderers. Swap all the WSpinny widgets now.
-        emit swapSpinnies();
-        // Same for WVuMeterGL. Note that we are either using WVuMeter or WVuMeterGL
-        // If we are using WVuMeter, this does nothing
-        emit swapVuMeters();
+        swapOtherWidgets();
     }
 }
 
@@ -814,6 +1038,74 @@ void WaveformWidgetFactory::swapAndRender() {
     m_vsyncThread->vsyncSlotFinished();
 }
 
+void WaveformWidgetFactory::renderOnThread() {
+    {
+        const auto locker = lockRendering();
+        if (!m_skipRender && m_type) {
+            ScopedTimer t("WaveformWidgetFactory::renderOnThread() %1waveforms",
+                    static_cast<int>(m_waveformWidgetHolders.size()));
+            renderWaveforms(true);
+            countFrame();
+        }
+    }
+    m_vsyncThread->vsyncSlotFinished();
+}
+
+void WaveformWidgetFactory::swapOnThread() {
+    {
+        const auto locker = lockRendering();
+        if (!m_skipRender && m_type) {
+            swapWaveforms(true);
+        }
+    }
+    postGuiThreadFrame();
+    m_vsyncThread->vsyncSlotFinished();
+}
+
+void WaveformWidgetFactory::swapAndRenderOnThread() {
+    {
+        const auto locker = lockRendering();
+        if (!m_skipRender && m_type) {
+            ScopedTimer t("WaveformWidgetFactory::swapAndRenderOnThread() %1waveforms",
+                    static_cast<int>(m_waveformWidgetHolders.size()));
+            swapWaveforms(true);
+            renderWaveforms(true);
+            countFrame();
+        }
+    }
+    postGuiThreadFrame();
+    m_vsyncThread->vsyncSlotFinished();
+}
+
+void WaveformWidgetFactory::postGuiThreadFrame() {
+    // The remaining widgets are still drawn on the GUI thread. Drop their
+    // frames while the GUI thread is busy instead of queuing them up.
+    if (m_guiThreadFramePending.exchange(true)) {
+        return;
+    }
+    QMetaObject::invokeMethod(
+            this,
+            [this] {
+                m_guiThreadFramePending = false;
+#ifdef MIXXX_USE_QOPENGL
+                if (m_vsyncThread->vsyncMode() == VSyncThread::ST_PLL) {
+                    // Keep the frameSwapped signals for the PLL coming
+                    SharedGLContext::getWidget()->getOpenGLWindow()->update();
+                }
+#endif
+                if (!m_skipRender) {
+                    if (m_type) {
+                        // Waveforms that can't be drawn on the render thread
+                        swapWaveforms(false);
+                        renderWaveforms(false);
+                    }
+                    swapOtherWidgets();
+                }
+                renderOtherWidgets();
+            },
+            Qt::QueuedConnection);
+}
+
 void WaveformWidgetFactory::slotFrameSwapped() {
 #ifdef MIXXX_USE_QOPENGL
     if (m_vsyncThread->pllInitializing()) {
@@ -980,6 +1272,13 @@ void WaveformWidgetFactory::evaluateWidgets() {
 #else
             setWaveformVarsByType.operator()<allshader::HSVWaveformWidget>();
             break;
+#endif
+        case WaveformWidgetType::AllShaderTexturedRGBWaveform:
+#ifndef MIXXX_USE_QOPENGL
+            continue;
+#else
+            setWaveformVarsByType.operator()<allshader::TexturedRGBWaveformWidget>();
+            break;
 #endif
         default:
             DEBUG_ASSERT(!"Unexpected WaveformWidgetType");
@@ -1077,6 +1376,9 @@ WaveformWidgetAbstract* WaveformWidgetFactory::createWaveformWidget(
         case WaveformWidgetType::AllShaderHSVWaveform:
             widget = new allshader::HSVWaveformWidget(viewer->getGroup(), viewer);
             break;
+        case WaveformWidgetType::AllShaderTexturedRGBWaveform:
+            widget = new allshader::TexturedRGBWaveformWidget(viewer->getGroup(), viewer);
+            break;
 #else
         case WaveformWidgetType::QtSimpleWaveform:
             widget = new QtSimpleWaveformWidget(viewer->getGroup(), viewer);
@@ -1112,6 +1414,15 @@ WaveformWidgetAbstract* WaveformWidgetFactory::createWaveformWidget(
                 widget = nullptr;
             }
         }
+#ifdef MIXXX_USE_QOPENGL
+        if (isRenderThreadEnabled()) {
+            // Only the all-shader waveforms don't use a QPainter
+            auto* pAllShaderWidget = dynamic_cast<allshader::WaveformWidget*>(widget);
+            if (pAllShaderWidget) {
+                pAllShaderWidget->setRenderedOnThread(true);
+            }
+        }
+#endif
     }
     return widget;
 }
@@ -1133,9 +1444,33 @@ void WaveformWidgetFactory::startVSync(GuiTick* pGuiTick, VisualsManager* pVisua
     m_pVisualsManager = pVisualsManager;
     m_vsyncThread = new VSyncThread(this, vSyncMode);
     m_vsyncThread->setObjectName(QStringLiteral("VSync"));
-    m_vsyncThread->setSyncIntervalTimeMicros(static_cast<int>(1e6 / m_frameRate));
+    // Waveforms are rendered at a lower frame rate while running on battery
+    m_pPowerSaving = std::make_unique<ControlProxy>(
+            kAppGroup, QStringLiteral("power_saving"), nullptr, ControlFlag::NoAssertIfMissing);
+    m_pPowerSaving->connectValueChanged(this, &WaveformWidgetFactory::slotPowerSavingChanged);
+    m_vsyncThread->setSyncIntervalTimeMicros(static_cast<int>(1e6 / maxFrameRate()));
+    if (m_pFramePacer) {
+        m_pFramePacer->setMaxFrameRate(maxFrameRate());
+    }
+
+    m_pFrameRateControl = std::make_unique<ControlObject>(
+            ConfigKey(kAppGroup, QStringLiteral("waveform_frame_rate")));
+    m_pFrameRateControl->setReadOnly();
+    m_pDroppedFramesControl = std::make_unique<ControlObject>(
+            ConfigKey(kAppGroup, QStringLiteral("waveform_dropped_frames")));
+    m_pDroppedFramesControl->setReadOnly();
+    // The share of the time spent drawing the waveforms
+    m_pRenderLoadControl = std::make_unique<ControlObject>(
+            ConfigKey(kAppGroup, QStringLiteral("waveform_render_load")));
+    m_pRenderLoadControl->setReadOnly();
+    m_pAudioLatencyUsage = std::make_unique<PollingControlProxy>(
+            kAppGroup, QStringLiteral("audio_latency_usage"), ControlFlag::NoAssertIfMissing);
 
 #ifdef MIXXX_USE_QOPENGL
+    if (m_config->getValue(kRenderThreadConfigKey, false)) {
+        createRenderContext();
+    }
+
     if (m_vsyncThread->vsyncMode() == VSyncThread::ST_PLL) {
         WGLWidget* widget = SharedGLContext::getWidget();
         connect(widget->getOpenGLWindow(),
@@ -1147,22 +1482,63 @@ void WaveformWidgetFactory::startVSync(GuiTick* pGuiTick, VisualsManager* pVisua
     }
 #endif
 
-    connect(m_vsyncThread,
-            &VSyncThread::vsyncRender,
-            this,
-            &WaveformWidgetFactory::render);
-    connect(m_vsyncThread,
-            &VSyncThread::vsyncSwap,
-            this,
-            &WaveformWidgetFactory::swap);
-    connect(m_vsyncThread,
-            &VSyncThread::vsyncSwapAndRender,
-            this,
-            &WaveformWidgetFactory::swapAndRender);
+    if (isRenderThreadEnabled()) {
+        // Draw the waveforms on the VSync thread without waiting for the
+        // GUI thread, see postGuiThreadFrame()
+        connect(m_vsyncThread,
+                &VSyncThread::vsyncRender,
+                this,
+                &WaveformWidgetFactory::renderOnThread,
+                Qt::DirectConnection);
+        connect(m_vsyncThread,
+                &VSyncThread::vsyncSwap,
+                this,
+                &WaveformWidgetFactory::swapOnThread,
+                Qt::DirectConnection);
+        connect(m_vsyncThread,
+                &VSyncThread::vsyncSwapAndRender,
+                this,
+                &WaveformWidgetFactory::swapAndRenderOnThread,
+                Qt::DirectConnection);
+    } else {
+        connect(m_vsyncThread,
+                &VSyncThread::vsyncRender,
+                this,
+                &WaveformWidgetFactory::render);
+        connect(m_vsyncThread,
+                &VSyncThread::vsyncSwap,
+                this,
+                &WaveformWidgetFactory::swap);
+        connect(m_vsyncThread,
+                &VSyncThread::vsyncSwapAndRender,
+                this,
+                &WaveformWidgetFactory::swapAndRender);
+    }
 
     m_vsyncThread->start(QThread::NormalPriority);
 }
 
+void WaveformWidgetFactory::createRenderContext() {
+#ifdef MIXXX_USE_QOPENGL
+    // The resources of all OpenGLWindows are shared with the global share
+    // context (Qt::AA_ShareOpenGLContexts). This context is made current
+    // with the windows of the waveforms on the VSync thread, while their
+    // own contexts remain in the GUI thread for initializing and resizing.
+    auto* pContext = new QOpenGLContext();
+    pContext->setFormat(getSurfaceFormat());
+    pContext->setShareContext(QOpenGLContext::globalShareContext());
+    if (!pContext->create()) {
+        qWarning() << "Failed to create the OpenGL context for the render "
+                      "thread, drawing the waveforms on the GUI thread";
+        delete pContext;
+        return;
+    }
+    pContext->moveToThread(m_vsyncThread);
+    m_pRenderContext = pContext;
+    qDebug() << "Drawing the all-shader waveforms on the VSync thread";
+#endif
+}
+
 void WaveformWidgetFactory::getAvailableVSyncTypes(QList<QPair<int, QString>>* pList) {
     m_vsyncThread->getAvailableVSyncTypes(pList);
 }
@@ -1,16 +1,27 @@
 #pragma once
 
+#include <QMutex>
 #include <QObject>
 #include <QSurfaceFormat>
 #include <QVector>
+#include <atomic>
+#include <map>
+#include <memory>
 #include <vector>
 
 #include "preferences/usersettings.h"
 #include "skin/legacy/skincontext.h"
+#include "util/compatibility/qmutex.h"
+#include "util/duration.h"
 #include "util/performancetimer.h"
 #include "util/singleton.h"
 #include "waveform/widgets/waveformwidgettype.h"
 
+class ControlObject;
+class ControlProxy;
+class FramePacer;
+class PollingControlProxy;
+class QOpenGLContext;
 class WVuMeterLegacy;
 class WVuMeterBase;
 class WWaveformViewer;
@@ -131,6 +142,19 @@ class WaveformWidgetFactory : public QObject, public Singleton<WaveformWidgetFac
 
     void startVSync(GuiTick* pGuiTick, VisualsManager* pVisualsManager);
 
+    /// Returns true if the all-shader waveforms are drawn on the VSync
+    /// thread with their own OpenGL context instead of on the GUI thread.
+    /// Enabled with [Waveform],RenderThread before starting the VSync thread.
+    bool isRenderThreadEnabled() const {
+        return m_pRenderContext != nullptr;
+    }
+    /// Must be held on the GUI thread while modifying the state of the
+    /// waveform widgets that is accessed while drawing them. The mutex is
+    /// recursive and only contended if the render thread is enabled.
+    [[nodiscard]] QT_RECURSIVE_MUTEX_LOCKER lockRendering() {
+        return lockMutex(&m_renderMutex);
+    }
+
     void setPlayMarkerPosition(double position);
     double getPlayMarkerPosition() const { return m_playMarkerPosition; }
 
@@ -160,11 +184,34 @@ class WaveformWidgetFactory : public QObject, public Singleton<WaveformWidgetFac
     void swap();
     void swapAndRender();
     void slotFrameSwapped();
+    void slotPowerSavingChanged(double value);
+
+    // Invoked directly on the VSync thread if the render thread is enabled
+    void renderOnThread();
+    void swapOnThread();
+    void swapAndRenderOnThread();
 
   private:
+    /// The configured frame rate, limited while saving power
+    int maxFrameRate() const;
+    void applyFrameRate();
+
     void renderSelf();
     void swapSelf();
 
+    /// Only processes the waveforms that are either drawn on the
+    /// render thread or the GUI thread
+    void renderWaveforms(bool onRenderThread);
+    void swapWaveforms(bool onRenderThread);
+    void renderOtherWidgets();
+    void swapOtherWidgets();
+    void doneCurrentAfterOtherWidgets();
+    void countFrame();
+    void addRenderTime(const QString& group, mixxx::Duration renderTime);
+    void updateRenderStats(mixxx::Duration elapsed, float frameRate);
+    void createRenderContext();
+    void postGuiThreadFrame();
+
     void evaluateWidgets();
     template<typename WaveformT>
     QString buildWidgetDisplayName() const;
@@ -204,6 +251,29 @@ class WaveformWidgetFactory : public QObject, public Singleton<WaveformWidgetFac
     GuiTick* m_pGuiTick;  // not owned
     VisualsManager* m_pVisualsManager;  // not owned
 
+    // Only used on the VSync thread, see isRenderThreadEnabled()
+    QOpenGLContext* m_pRenderContext;
+    QT_RECURSIVE_MUTEX m_renderMutex;
+    std::atomic<bool> m_guiThreadFramePending;
+
+    struct RenderStats {
+        mixxx::Duration renderTime;
+        int frameCount = 0;
+        std::unique_ptr<ControlObject> pRenderTimeMs;
+    };
+    // The entries are created on the GUI thread and never removed, the
+    // values are accumulated by the GUI and the VSync thread
+    std::map<QString, RenderStats> m_renderStats;
+    QMutex m_renderStatsMutex;
+    std::unique_ptr<ControlObject> m_pFrameRateControl;
+    std::unique_ptr<ControlObject> m_pDroppedFramesControl;
+    std::unique_ptr<ControlObject> m_pRenderLoadControl;
+    std::unique_ptr<PollingControlProxy> m_pAudioLatencyUsage;
+    std::unique_ptr<ControlProxy> m_pPowerSaving;
+    // Only set if the adaptive frame rate is enabled
+    std::unique_ptr<FramePacer> m_pFramePacer;
+    double m_renderBudget;
+
     //Debug
     PerformanceTimer m_time;
     float m_frameCnt;
@@ -0,0 +1,35 @@
+#include "waveform/widgets/allshader/texturedrgbwaveformwidget.h"
+
+#include "waveform/renderers/allshader/waveformrenderbackground.h"
+#include "waveform/renderers/allshader/waveformrenderbeat.h"
+#include "waveform/renderers/allshader/waveformrendererendoftrack.h"
+#include "waveform/renderers/allshader/waveformrendererpreroll.h"
+#include "waveform/renderers/allshader/waveformrenderertexturedrgb.h"
+#include "waveform/renderers/allshader/waveformrendermark.h"
+#include "waveform/renderers/allshader/waveformrendermarkrange.h"
+#include "waveform/widgets/allshader/moc_texturedrgbwaveformwidget.cpp"
+
+namespace allshader {
+
+TexturedRGBWaveformWidget::TexturedRGBWaveformWidget(const QString& group, QWidget* parent)
+        : WaveformWidget(group, parent) {
+    addRenderer<WaveformRenderBackground>();
+    addRenderer<WaveformRendererEndOfTrack>();
+    addRenderer<WaveformRendererPreroll>();
+    addRenderer<WaveformRenderMarkRange>();
+    addRenderer<WaveformRendererTexturedRGB>();
+    addRenderer<WaveformRenderBeat>();
+    addRenderer<WaveformRenderMark>();
+
+    m_initSuccess = init();
+}
+
+void TexturedRGBWaveformWidget::castToQWidget() {
+    m_widget = this;
+}
+
+void TexturedRGBWaveformWidget::paintEvent(QPaintEvent* event) {
+    Q_UNUSED(event);
+}
+
+} // namespace allshader
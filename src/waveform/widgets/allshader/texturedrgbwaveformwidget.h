@@ -0,0 +1,44 @@
+#pragma once
+
+#include "util/class.h"
+#include "waveform/widgets/allshader/waveformwidget.h"
+
+class WaveformWidgetFactory;
+
+namespace allshader {
+class TexturedRGBWaveformWidget;
+}
+
+class allshader::TexturedRGBWaveformWidget final : public allshader::WaveformWidget {
+    Q_OBJECT
+  public:
+    WaveformWidgetType::Type getType() const override {
+        return WaveformWidgetType::AllShaderTexturedRGBWaveform;
+    }
+
+    static inline QString getWaveformWidgetName() {
+        return tr("RGB (GPU resident)");
+    }
+    static constexpr bool useOpenGl() {
+        return true;
+    }
+    static constexpr bool useOpenGles() {
+        return true;
+    }
+    static constexpr bool useOpenGLShaders() {
+        return true;
+    }
+    static constexpr WaveformWidgetCategory category() {
+        return WaveformWidgetCategory::AllShader;
+    }
+
+  protected:
+    void castToQWidget() override;
+    void paintEvent(QPaintEvent* event) override;
+
+  private:
+    TexturedRGBWaveformWidget(const QString& group, QWidget* parent);
+    friend class ::WaveformWidgetFactory;
+
+    DISALLOW_COPY_AND_ASSIGN(TexturedRGBWaveformWidget);
+};
@@ -27,6 +27,7 @@ class WaveformWidgetType {
         AllShaderFilteredWaveform, // 19 Filtered (all-shaders)
         AllShaderSimpleWaveform,   // 20 Simple (all-shaders)
         AllShaderHSVWaveform,      // 21 HSV (all-shaders)
+        AllShaderTexturedRGBWaveform, // 22 RGB (all-shaders, GPU resident)
         Count_WaveformwidgetType   //    Also used as invalid value
     };
 };
@@ -1,8 +1,8 @@
 #include "widget/controlwidgetconnection.h"
 
+#include <QEvent>
 #include <QStyle>
 
-#include "control/controlproxy.h"
 #include "moc_controlwidgetconnection.cpp"
 #include "util/assert.h"
 #include "util/valuetransformer.h"
@@ -35,16 +35,42 @@ ControlWidgetConnection::ControlWidgetConnection(
         const ConfigKey& key,
         ValueTransformer* pTransformer)
         : m_pWidget(pBaseWidget),
-          m_pValueTransformer(pTransformer) {
-    m_pControl = new ControlProxy(key, this, ControlFlag::NoAssertIfMissing);
-    m_pControl->connectValueChanged(this, &ControlWidgetConnection::slotControlValueChanged);
+          m_pControl(ControlWidgetHub::getHub(key)),
+          m_pValueTransformer(pTransformer),
+          m_updatePending(false) {
+    m_pControl->addConnection(this);
+}
+
+ControlWidgetConnection::~ControlWidgetConnection() {
+    m_pControl->removeConnection(this);
+}
+
+void ControlWidgetConnection::notifyValueChanged(double value) {
+    if (updateWhileHidden() || m_pWidget->toQWidget()->isVisible()) {
+        slotControlValueChanged(value);
+        return;
+    }
+    if (!m_updatePending) {
+        // Catch up with the latest value when the widget is shown
+        m_updatePending = true;
+        m_pWidget->toQWidget()->installEventFilter(this);
+    }
+}
+
+bool ControlWidgetConnection::eventFilter(QObject* pObject, QEvent* pEvent) {
+    if (pEvent->type() == QEvent::Show && m_updatePending) {
+        m_updatePending = false;
+        pObject->removeEventFilter(this);
+        slotControlValueChanged(m_pControl->get());
+    }
+    return QObject::eventFilter(pObject, pEvent);
 }
 
 void ControlWidgetConnection::setControlParameter(double parameter) {
     if (m_pValueTransformer != nullptr) {
         parameter = m_pValueTransformer->transformInverse(parameter);
     }
-    m_pControl->setParameter(parameter);
+    m_pControl->setParameter(parameter, this);
 }
 
 double ControlWidgetConnection::getControlParameter() const {
@@ -3,10 +3,11 @@
 #include <QMetaProperty>
 #include <QObject>
 #include <QScopedPointer>
+#include <QSharedPointer>
 #include <QString>
 
-#include "control/controlproxy.h"
 #include "util/valuetransformer.h"
+#include "widget/controlwidgethub.h"
 
 class WBaseWidget;
 
@@ -17,6 +18,7 @@ class ControlWidgetConnection : public QObject {
     ControlWidgetConnection(WBaseWidget* pBaseWidget,
                             const ConfigKey& key,
                             ValueTransformer* pTransformer);
+    ~ControlWidgetConnection() override;
 
     double getControlParameter() const;
     double getControlParameterForValue(double value) const;
@@ -27,21 +29,32 @@ class ControlWidgetConnection : public QObject {
 
     virtual QString toDebugString() const = 0;
 
+    /// Invoked by the ControlWidgetHub when the control has changed
+    void notifyValueChanged(double value);
+
+    bool eventFilter(QObject* pObject, QEvent* pEvent) override;
+
   protected slots:
     virtual void slotControlValueChanged(double v) = 0;
 
   protected:
     void setControlParameter(double parameter);
 
+    /// Whether the widget must be updated even while it is hidden
+    virtual bool updateWhileHidden() const {
+        return true;
+    }
+
     WBaseWidget* m_pWidget;
 
-    // This ControlProxys is created as parent to this and deleted by
-    // the Qt object tree. This helps that they are deleted by the creating
-    // thread, which is required to avoid segfaults.
-    ControlProxy* m_pControl;
+    // Shared with all other connections of the control
+    const QSharedPointer<ControlWidgetHub> m_pControl;
 
   private:
     QScopedPointer<ValueTransformer> m_pValueTransformer;
+
+    // Set when a change has been skipped while the widget was hidden
+    bool m_updatePending;
 };
 
 class ControlParameterWidgetConnection final : public ControlWidgetConnection {
@@ -118,6 +131,10 @@ class ControlParameterWidgetConnection final : public ControlWidgetConnection {
     void slotControlValueChanged(double value) override;
 
   private:
+    bool updateWhileHidden() const override {
+        return false;
+    }
+
     DirectionOption m_directionOption;
     EmitOption m_emitOption;
 };
@@ -0,0 +1,119 @@
+#include "widget/controlwidgethub.h"
+
+#include <QHash>
+#include <QWeakPointer>
+
+#include "control/control.h"
+#include "control/controlchangedispatcher.h"
+#include "moc_controlwidgethub.cpp"
+#include "util/assert.h"
+#include "widget/controlwidgetconnection.h"
+
+namespace {
+
+/// The shared hubs of all controls that are bound to widgets
+QHash<ConfigKey, QWeakPointer<ControlWidgetHub>> s_hubs;
+
+} // namespace
+
+ControlWidgetHub::ControlWidgetHub(QSharedPointer<ControlDoublePrivate> pControl)
+        : m_pControl(std::move(pControl)),
+          m_subscribed(m_pControl->getKey().isValid()),
+          m_notifyIndex(-1) {
+    if (!m_subscribed) {
+        return;
+    }
+    connect(m_pControl.data(),
+            &ControlDoublePrivate::valueChangedCoalesced,
+            this,
+            &ControlWidgetHub::slotValueChanged,
+            Qt::DirectConnection);
+    ControlChangeDispatcher::instance()->subscribe(m_pControl);
+}
+
+ControlWidgetHub::~ControlWidgetHub() {
+    DEBUG_ASSERT(m_connections.isEmpty());
+    if (!m_subscribed) {
+        return;
+    }
+    ControlChangeDispatcher::instance()->unsubscribe(m_pControl);
+    const auto it = s_hubs.find(m_pControl->getKey());
+    if (it != s_hubs.end() && it.value().isNull()) {
+        s_hubs.erase(it);
+    }
+}
+
+// static
+QSharedPointer<ControlWidgetHub> ControlWidgetHub::getHub(const ConfigKey& key) {
+    QSharedPointer<ControlDoublePrivate> pControl =
+            ControlDoublePrivate::getControl(key, ControlFlag::NoAssertIfMissing);
+    if (!pControl) {
+        return QSharedPointer<ControlWidgetHub>(
+                new ControlWidgetHub(ControlDoublePrivate::getDefaultControl()));
+    }
+    // Aliases share the hub of the control
+    const ConfigKey& controlKey = pControl->getKey();
+    QSharedPointer<ControlWidgetHub> pHub = s_hubs.value(controlKey).toStrongRef();
+    if (!pHub) {
+        pHub = QSharedPointer<ControlWidgetHub>(new ControlWidgetHub(std::move(pControl)));
+        s_hubs.insert(controlKey, pHub);
+    }
+    return pHub;
+}
+
+const ConfigKey& ControlWidgetHub::getKey() const {
+    return m_pControl->getKey();
+}
+
+double ControlWidgetHub::get() const {
+    return m_pControl->get();
+}
+
+double ControlWidgetHub::getParameter() const {
+    return m_pControl->getParameter();
+}
+
+double ControlWidgetHub::getParameterForValue(double value) const {
+    return m_pControl->getParameterForValue(value);
+}
+
+void ControlWidgetHub::setParameter(double parameter, ControlWidgetConnection* pSender) {
+    m_pControl->setParameter(parameter, pSender);
+}
+
+void ControlWidgetHub::reset() {
+    m_pControl->reset();
+}
+
+void ControlWidgetHub::addConnection(ControlWidgetConnection* pConnection) {
+    DEBUG_ASSERT(!m_connections.contains(pConnection));
+    m_connections.append(pConnection);
+}
+
+void ControlWidgetHub::removeConnection(ControlWidgetConnection* pConnection) {
+    const int index = m_connections.indexOf(pConnection);
+    VERIFY_OR_DEBUG_ASSERT(index >= 0) {
+        return;
+    }
+    m_connections.removeAt(index);
+    if (index <= m_notifyIndex) {
+        --m_notifyIndex;
+    }
+}
+
+void ControlWidgetHub::slotValueChanged(double value, QObject* pSender) {
+    // The last connection might be deleted while being notified
+    const QSharedPointer<ControlWidgetHub> pKeepAlive = sharedFromThis();
+    // Widgets may add or remove connections while being notified. Added
+    // connections have been initialized with the new value already.
+    const int count = m_connections.size();
+    for (m_notifyIndex = 0;
+            m_notifyIndex < count && m_notifyIndex < m_connections.size();
+            ++m_notifyIndex) {
+        ControlWidgetConnection* pConnection = m_connections.at(m_notifyIndex);
+        if (pConnection != pSender) {
+            pConnection->notifyValueChanged(value);
+        }
+    }
+    m_notifyIndex = -1;
+}
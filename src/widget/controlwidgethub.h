@@ -0,0 +1,61 @@
+#pragma once
+
+#include <QList>
+#include <QObject>
+#include <QEnableSharedFromThis>
+#include <QSharedPointer>
+
+#include "preferences/configobject.h"
+
+class ControlDoublePrivate;
+class ControlWidgetConnection;
+
+/// Delivers the changes of one control to all widget connections that are
+/// bound to it.
+///
+/// Skins bind many widgets to the same control, often several per widget.
+/// Instead of a ControlProxy with its own coalesced subscription for every
+/// connection, all connections of a control share one hub, which forwards
+/// each coalesced change to them in a single pass. Connections of hidden
+/// widgets are skipped and catch up when their widget is shown.
+///
+/// Hubs must only be used in the main thread.
+class ControlWidgetHub : public QObject,
+                         public QEnableSharedFromThis<ControlWidgetHub> {
+    Q_OBJECT
+  public:
+    /// Returns the hub of the control, which is created on first use.
+    /// Missing controls get a hub of their own that never changes.
+    static QSharedPointer<ControlWidgetHub> getHub(const ConfigKey& key);
+
+    ~ControlWidgetHub() override;
+
+    const ConfigKey& getKey() const;
+    double get() const;
+    double getParameter() const;
+    double getParameterForValue(double value) const;
+
+    /// Sets the parameter of the control on behalf of a connection, which
+    /// is not notified about its own change.
+    void setParameter(double parameter, ControlWidgetConnection* pSender);
+    /// Resets the control to its default value. All connections are
+    /// notified, because the originator does not know the resulting value.
+    void reset();
+
+    void addConnection(ControlWidgetConnection* pConnection);
+    void removeConnection(ControlWidgetConnection* pConnection);
+
+  private slots:
+    void slotValueChanged(double value, QObject* pSender);
+
+  private:
+    explicit ControlWidgetHub(QSharedPointer<ControlDoublePrivate> pControl);
+
+    const QSharedPointer<ControlDoublePrivate> m_pControl;
+    const bool m_subscribed;
+
+    QList<ControlWidgetConnection*> m_connections;
+    // The connection that is being notified, adjusted when connections
+    // are removed while notifying
+    int m_notifyIndex;
+};
@@ -10,7 +10,8 @@
 #include "widget/wglwidget.h"
 
 OpenGLWindow::OpenGLWindow(WGLWidget* pWidget)
-        : m_pWidget(pWidget) {
+        : m_pWidget(pWidget),
+          m_initialized(false) {
     setFormat(WaveformWidgetFactory::getSurfaceFormat());
 }
 
@@ -21,6 +22,7 @@ void OpenGLWindow::initializeGL() {
     if (m_pWidget) {
         m_pWidget->initializeGL();
     }
+    m_initialized.store(true, std::memory_order_release);
 }
 
 void OpenGLWindow::paintGL() {
@@ -37,9 +39,11 @@ void OpenGLWindow::resizeGL(int w, int h) {
         // QGLWidget::resizeGL has devicePixelRatio applied, so we mimic the same behaviour
         m_pWidget->resizeGL(static_cast<int>(static_cast<float>(w) * devicePixelRatio()),
                 static_cast<int>(static_cast<float>(h) * devicePixelRatio()));
-        // additional paint and swap to avoid flickering
-        m_pWidget->paintGL();
-        m_pWidget->swapBuffers();
+        if (!m_pWidget->isRenderedOnThread()) {
+            // additional paint and swap to avoid flickering
+            m_pWidget->paintGL();
+            m_pWidget->swapBuffers();
+        }
 
         m_pWidget->doneCurrent();
     }
@@ -58,7 +62,19 @@ bool OpenGLWindow::event(QEvent* pEv) {
     // this recursion.
     const auto t = pEv->type();
 
-    bool result = QOpenGLWindow::event(pEv);
+    bool result;
+    if (m_pWidget && m_pWidget->isRenderedOnThread()) {
+        if (isInitialized() && (t == QEvent::UpdateRequest || t == QEvent::Expose)) {
+            // The next frame is drawn and swapped by the render thread
+            return true;
+        }
+        // The initialization and resizing access the same state as the
+        // render thread
+        const auto locker = WaveformWidgetFactory::instance()->lockRendering();
+        result = QOpenGLWindow::event(pEv);
+    } else {
+        result = QOpenGLWindow::event(pEv);
+    }
 
     if (m_pWidget) {
         // Tooltip don't work by forwarding the events. This mimics the
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <QOpenGLWindow>
+#include <atomic>
 
 class WGLWidget;
 
@@ -15,6 +16,11 @@ class OpenGLWindow : public QOpenGLWindow {
 
     void widgetDestroyed();
 
+    /// Might be queried from the render thread
+    bool isInitialized() const {
+        return m_initialized.load(std::memory_order_acquire);
+    }
+
   private:
     void initializeGL() override;
     void paintGL() override;
@@ -22,4 +28,5 @@ class OpenGLWindow : public QOpenGLWindow {
     bool event(QEvent* pEv) override;
 
     WGLWidget* m_pWidget;
+    std::atomic<bool> m_initialized;
 };
@@ -0,0 +1,215 @@
+#include "widget/sharedoverviewimage.h"
+
+#include <QFutureWatcher>
+#include <QHash>
+#include <QPainter>
+#include <QPair>
+#include <QTransform>
+#include <QWeakPointer>
+#include <algorithm>
+#include <cmath>
+
+#include "moc_sharedoverviewimage.cpp"
+#include "util/backgroundtask.h"
+#include "util/timer.h"
+
+namespace {
+
+/// The number of scaled variants that are kept per image. Skins rarely
+/// show more than two sizes of the same overview at once, the others are
+/// left over from resizing the window.
+constexpr int kMaxVariants = 4;
+
+typedef QPair<TrackId, QString> ImageKey;
+
+/// The shared images of all tracks that are shown in overviews
+QHash<ImageKey, QWeakPointer<SharedOverviewImage>> s_images;
+
+QImage scaleImage(const QImage& source,
+        QSize size,
+        int diffGain,
+        Qt::Orientation orientation) {
+    QImage croppedImage = source.copy(
+            QRect(0, diffGain, source.width(), source.height() - 2 * diffGain));
+    if (orientation == Qt::Vertical) {
+        // Rotate pixmap
+        croppedImage = croppedImage.transformed(QTransform(0, 1, 1, 0, 0, 0));
+    }
+    return croppedImage.scaled(size, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+}
+
+} // namespace
+
+SharedOverviewImage::SharedOverviewImage(TrackId trackId, QString style)
+        : m_trackId(trackId),
+          m_style(std::move(style)),
+          m_generation(0) {
+}
+
+SharedOverviewImage::~SharedOverviewImage() {
+    if (!m_trackId.isValid()) {
+        return;
+    }
+    const auto it = s_images.find(ImageKey(m_trackId, m_style));
+    if (it != s_images.end() && it.value().isNull()) {
+        s_images.erase(it);
+    }
+}
+
+// static
+QSharedPointer<SharedOverviewImage> SharedOverviewImage::getImage(
+        TrackId trackId, const QString& style) {
+    if (!trackId.isValid()) {
+        return QSharedPointer<SharedOverviewImage>(new SharedOverviewImage(trackId, style));
+    }
+    const ImageKey key(trackId, style);
+    QSharedPointer<SharedOverviewImage> pImage = s_images.value(key).toStrongRef();
+    if (!pImage) {
+        pImage = QSharedPointer<SharedOverviewImage>(new SharedOverviewImage(trackId, style));
+        s_images.insert(key, pImage);
+    }
+    return pImage;
+}
+
+void SharedOverviewImage::setWaveform(const ConstWaveformPointer& pWaveform) {
+    if (m_pWaveform == pWaveform) {
+        return;
+    }
+    m_pWaveform = pWaveform;
+    reset();
+}
+
+void SharedOverviewImage::reset() {
+    m_source = Source();
+    m_variants.clear();
+    ++m_generation;
+    emit changed();
+}
+
+void SharedOverviewImage::sourceUpdated() {
+    emit changed();
+}
+
+QImage SharedOverviewImage::scaledImage(
+        QSize size, int diffGain, Qt::Orientation orientation) {
+    if (m_source.image.isNull() || size.isEmpty()) {
+        return QImage();
+    }
+    const auto it = std::find_if(m_variants.begin(),
+            m_variants.end(),
+            [&](const Variant& variant) {
+                return variant.size == size && variant.diffGain == diffGain &&
+                        variant.orientation == orientation;
+            });
+    if (it != m_variants.end()) {
+        if (it->pending) {
+            // Show the most recently used variant, stretched by the painter
+            for (const auto& variant : std::as_const(m_variants)) {
+                if (!variant.pending) {
+                    return variant.image;
+                }
+            }
+            return QImage();
+        }
+        if (it != m_variants.begin()) {
+            m_variants.move(static_cast<int>(it - m_variants.begin()), 0);
+        }
+        Variant& variant = m_variants.first();
+        if (variant.completion < m_source.completion) {
+            rescaleVariantPart(&variant);
+        }
+        return variant.image;
+    }
+
+    // Scale the whole image in the background. The source image is
+    // implicitly shared, so drawing the next parts meanwhile detaches it.
+    QImage fallbackImage;
+    for (const auto& variant : std::as_const(m_variants)) {
+        if (!variant.pending) {
+            fallbackImage = variant.image;
+            break;
+        }
+    }
+    m_variants.prepend(Variant{size, diffGain, orientation, QImage(), m_source.completion, true});
+    while (m_variants.size() > kMaxVariants) {
+        m_variants.removeLast();
+    }
+    const int generation = m_generation;
+    auto* pWatcher = new QFutureWatcher<QImage>(this);
+    connect(pWatcher,
+            &QFutureWatcher<QImage>::finished,
+            this,
+            [this, pWatcher, generation, size, diffGain, orientation]() {
+                pWatcher->deleteLater();
+                if (generation != m_generation) {
+                    // Scaled from a discarded source image
+                    return;
+                }
+                for (auto& variant : m_variants) {
+                    if (variant.pending && variant.size == size &&
+                            variant.diffGain == diffGain &&
+                            variant.orientation == orientation) {
+                        variant.image = pWatcher->result();
+                        variant.pending = false;
+                        emit changed();
+                        return;
+                    }
+                }
+                // The variant has been evicted meanwhile
+            });
+    pWatcher->setFuture(mixxx::backgroundtask::run(
+            mixxx::BackgroundTaskPriority::Interactive,
+            [source = m_source.image, size, diffGain, orientation]() {
+                ScopedTimer t("SharedOverviewImage::scaleImage");
+                return scaleImage(source, size, diffGain, orientation);
+            }));
+    return fallbackImage;
+}
+
+void SharedOverviewImage::rescaleVariantPart(Variant* pVariant) {
+    ScopedTimer t("SharedOverviewImage::rescaleVariantPart");
+    const int sourceLength = m_source.image.width();
+    const bool horizontal = pVariant->orientation == Qt::Horizontal;
+    const int scaledLength = horizontal
+            ? pVariant->image.width()
+            : pVariant->image.height();
+    const int scaledBreadth = horizontal
+            ? pVariant->image.height()
+            : pVariant->image.width();
+    // One additional column on both sides for the smooth transformation
+    const int firstColumn = std::max(pVariant->completion / 2 - 1, 0);
+    const int endColumn = std::min(m_source.completion / 2 + 1, sourceLength);
+    pVariant->completion = m_source.completion;
+    if (endColumn <= firstColumn || sourceLength <= 0) {
+        return;
+    }
+
+    const int firstPosition = static_cast<int>(std::floor(
+            static_cast<double>(firstColumn) * scaledLength / sourceLength));
+    const int endPosition = std::max(firstPosition + 1,
+            std::min(static_cast<int>(std::ceil(static_cast<double>(endColumn) *
+                             scaledLength / sourceLength)),
+                    scaledLength));
+
+    QRect sourceRect(firstColumn,
+            pVariant->diffGain,
+            endColumn - firstColumn,
+            m_source.image.height() - 2 * pVariant->diffGain);
+    QImage croppedImage = m_source.image.copy(sourceRect);
+    QPainter painter(&pVariant->image);
+    painter.setCompositionMode(QPainter::CompositionMode_Source);
+    if (horizontal) {
+        painter.drawImage(QPoint(firstPosition, 0),
+                croppedImage.scaled(endPosition - firstPosition,
+                        scaledBreadth,
+                        Qt::IgnoreAspectRatio,
+                        Qt::SmoothTransformation));
+    } else {
+        croppedImage = croppedImage.transformed(QTransform(0, 1, 1, 0, 0, 0));
+        painter.drawImage(QPoint(0, firstPosition),
+                croppedImage.scaled(scaledBreadth,
+                        endPosition - firstPosition,
+                        Qt::IgnoreAspectRatio,
+                        Qt::SmoothTransformation));
+    }
+}
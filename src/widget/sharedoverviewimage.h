@@ -0,0 +1,93 @@
+#pragma once
+
+#include <QImage>
+#include <QList>
+#include <QObject>
+#include <QSharedPointer>
+#include <QSize>
+
+#include "track/trackid.h"
+#include "waveform/waveform.h"
+
+/// The overview image of a track's waveform summary, shared by all overview
+/// widgets that draw the same track in the same style, e.g. the sampler
+/// overviews of a skin that play the same sample or two decks with the same
+/// track.
+///
+/// The source image in full resolution is drawn once by whichever overview
+/// notices the progress of the analysis first. The variants that are scaled
+/// to the size of the overviews are computed once per size on a worker
+/// thread. Afterwards only the parts that have been drawn since are
+/// rescaled in place.
+///
+/// Images must only be used in the main thread.
+class SharedOverviewImage : public QObject {
+    Q_OBJECT
+  public:
+    /// The source image, which is drawn by the overviews
+    struct Source {
+        QImage image;
+        // The number of visual samples of the waveform that have been drawn
+        int completion = 0;
+        float peak = -1.0f;
+        bool done = false;
+    };
+
+    /// Returns the image of the track in the given style, which is created
+    /// on first use. Tracks without an id get an image of their own.
+    static QSharedPointer<SharedOverviewImage> getImage(
+            TrackId trackId, const QString& style);
+
+    ~SharedOverviewImage() override;
+
+    /// Discards the source image if it has been drawn from another
+    /// waveform, e.g. after the track has been reanalyzed.
+    void setWaveform(const ConstWaveformPointer& pWaveform);
+
+    Source& source() {
+        return m_source;
+    }
+    const Source& source() const {
+        return m_source;
+    }
+
+    /// Notifies all overviews of the image after a part of the source image
+    /// has been drawn.
+    void sourceUpdated();
+
+    /// Returns the source image, cropped by diffGain at the top and the
+    /// bottom and scaled to size. While a new size is scaled in the
+    /// background, the most recently used variant is returned instead.
+    QImage scaledImage(QSize size, int diffGain, Qt::Orientation orientation);
+
+  signals:
+    /// The source image or a scaled variant has changed
+    void changed();
+
+  private:
+    SharedOverviewImage(TrackId trackId, QString style);
+
+    struct Variant {
+        QSize size;
+        int diffGain;
+        Qt::Orientation orientation;
+        QImage image;
+        // The completion of the source image the variant has been scaled from
+        int completion;
+        bool pending;
+    };
+
+    void reset();
+    void rescaleVariantPart(Variant* pVariant);
+
+    const TrackId m_trackId;
+    const QString m_style;
+
+    ConstWaveformPointer m_pWaveform;
+    Source m_source;
+    // Incremented when the source image is discarded, so that pending
+    // variants that have been scaled from the old image are ignored
+    int m_generation;
+    // Ordered by their last use, the most recent first
+    QList<Variant> m_variants;
+};
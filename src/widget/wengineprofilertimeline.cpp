@@ -0,0 +1,321 @@
+#include "widget/wengineprofilertimeline.h"
+
+#include <QHelpEvent>
+#include <QPainter>
+#include <QStringList>
+#include <QToolTip>
+#include <QWheelEvent>
+#include <algorithm>
+#include <limits>
+
+#include "moc_wengineprofilertimeline.cpp"
+#include "util/math.h"
+
+namespace {
+
+constexpr int kUpdateIntervalMillis = 50;
+
+// The number of callbacks that are kept for display
+constexpr int kMaxCallbacks = 512;
+constexpr int kDefaultVisibleCallbacks = 16;
+
+constexpr int kRowHeight = 18;
+constexpr int kLabelWidth = 80;
+// Stages that are narrower are painted without a label
+constexpr int kMinLabeledWidth = 30;
+
+// The number of stages listed for an overloaded callback
+constexpr int kMaxDescribedStages = 3;
+
+bool isOverloaded(const EngineProfiler::Record& record) {
+    return record.stage == EngineProfiler::kCallbackStage &&
+            record.budgetNanos > 0 &&
+            record.durationNanos > record.budgetNanos;
+}
+
+QString formatMillis(qint64 nanos) {
+    return QStringLiteral("%1 ms").arg(nanos / 1e6, 0, 'f', 3);
+}
+
+} // anonymous namespace
+
+WEngineProfilerTimeline::WEngineProfilerTimeline(QWidget* pParent)
+        : QWidget(pParent),
+          m_paused(false),
+          m_visibleCallbacks(kDefaultVisibleCallbacks),
+          m_readBuffer(EngineProfiler::kRingSize),
+          m_newestCallback(0),
+          m_startNanos(0),
+          m_endNanos(0),
+          m_oldestVisibleCallback(0) {
+    m_updateTimer.setInterval(kUpdateIntervalMillis);
+    connect(&m_updateTimer,
+            &QTimer::timeout,
+            this,
+            &WEngineProfilerTimeline::slotUpdate);
+    setMouseTracking(true);
+}
+
+WEngineProfilerTimeline::~WEngineProfilerTimeline() {
+    EngineProfiler::instance().setEnabled(false);
+}
+
+QSize WEngineProfilerTimeline::sizeHint() const {
+    return QSize(800, 300);
+}
+
+void WEngineProfilerTimeline::setPaused(bool paused) {
+    m_paused = paused;
+}
+
+void WEngineProfilerTimeline::showEvent(QShowEvent* pEvent) {
+    QWidget::showEvent(pEvent);
+    EngineProfiler::instance().setEnabled(true);
+    m_updateTimer.start();
+}
+
+void WEngineProfilerTimeline::hideEvent(QHideEvent* pEvent) {
+    EngineProfiler::instance().setEnabled(false);
+    m_updateTimer.stop();
+    QWidget::hideEvent(pEvent);
+}
+
+void WEngineProfilerTimeline::slotUpdate() {
+    EngineProfiler& profiler = EngineProfiler::instance();
+    bool appended = false;
+    while (true) {
+        const int count = profiler.read(m_readBuffer.data(),
+                static_cast<int>(m_readBuffer.size()));
+        // The ring is drained while paused to get a consistent view
+        // after resuming.
+        if (!m_paused && count > 0) {
+            appendRecords(m_readBuffer.constData(), count);
+            appended = true;
+        }
+        if (count < m_readBuffer.size()) {
+            break;
+        }
+    }
+    if (!appended) {
+        return;
+    }
+
+    // Drop the records of old callbacks
+    const auto firstKept = std::find_if(m_records.begin(),
+            m_records.end(),
+            [this](const EngineProfiler::Record& record) {
+                return record.callback + kMaxCallbacks > m_newestCallback;
+            });
+    m_records.erase(m_records.begin(), firstKept);
+    update();
+}
+
+void WEngineProfilerTimeline::appendRecords(
+        const EngineProfiler::Record* pRecords, int count) {
+    for (int i = 0; i < count; ++i) {
+        const EngineProfiler::Record& record = pRecords[i];
+        m_records.append(record);
+        m_newestCallback = math_max(m_newestCallback, record.callback);
+        // The stages of a callback are always recorded before the callback
+        // itself has finished.
+        if (isOverloaded(record)) {
+            describeOverload(record);
+        }
+    }
+}
+
+void WEngineProfilerTimeline::describeOverload(
+        const EngineProfiler::Record& callbackRecord) {
+    QVector<const EngineProfiler::Record*> stages;
+    for (const auto& record : std::as_const(m_records)) {
+        if (record.callback == callbackRecord.callback &&
+                record.stage != EngineProfiler::kCallbackStage) {
+            stages.append(&record);
+        }
+    }
+    std::sort(stages.begin(),
+            stages.end(),
+            [](const EngineProfiler::Record* pLeft,
+                    const EngineProfiler::Record* pRight) {
+                return pLeft->durationNanos > pRight->durationNanos;
+            });
+
+    QStringList slowestStages;
+    for (const auto* pRecord : std::as_const(stages)) {
+        if (slowestStages.size() >= kMaxDescribedStages) {
+            break;
+        }
+        slowestStages.append(QStringLiteral("%1 %2").arg(
+                stageName(pRecord->stage), formatMillis(pRecord->durationNanos)));
+    }
+    emit overloadDetected(
+            tr("Callback %1 took %2 of %3. Slowest stages: %4")
+                    .arg(QString::number(callbackRecord.callback),
+                            formatMillis(callbackRecord.durationNanos),
+                            formatMillis(callbackRecord.budgetNanos),
+                            slowestStages.join(QStringLiteral(", "))));
+}
+
+const QString& WEngineProfilerTimeline::stageName(EngineProfiler::StageId stage) {
+    auto it = m_stageNames.find(stage);
+    if (it == m_stageNames.end()) {
+        it = m_stageNames.insert(stage, EngineProfiler::instance().stageName(stage));
+    }
+    return it.value();
+}
+
+void WEngineProfilerTimeline::updateLayout() {
+    m_oldestVisibleCallback = m_newestCallback >= static_cast<quint64>(m_visibleCallbacks)
+            ? m_newestCallback - m_visibleCallbacks + 1
+            : 0;
+    m_startNanos = std::numeric_limits<qint64>::max();
+    m_endNanos = std::numeric_limits<qint64>::min();
+    m_rows.clear();
+    for (const auto& record : std::as_const(m_records)) {
+        if (record.callback < m_oldestVisibleCallback) {
+            continue;
+        }
+        m_startNanos = math_min(m_startNanos, record.startNanos);
+        m_endNanos = math_max(m_endNanos,
+                record.startNanos +
+                        math_max(record.durationNanos, record.budgetNanos));
+        if (rowOf(record) < 0) {
+            m_rows.append(Row{record.thread, record.depth});
+        }
+    }
+    std::sort(m_rows.begin(), m_rows.end(), [](const Row& left, const Row& right) {
+        return left.thread < right.thread ||
+                (left.thread == right.thread && left.depth < right.depth);
+    });
+}
+
+int WEngineProfilerTimeline::rowOf(const EngineProfiler::Record& record) const {
+    for (int i = 0; i < m_rows.size(); ++i) {
+        if (m_rows[i].thread == record.thread && m_rows[i].depth == record.depth) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+double WEngineProfilerTimeline::xOf(qint64 nanos) const {
+    const double range = static_cast<double>(math_max<qint64>(m_endNanos - m_startNanos, 1));
+    return kLabelWidth + (nanos - m_startNanos) * (width() - kLabelWidth) / range;
+}
+
+const EngineProfiler::Record* WEngineProfilerTimeline::recordAt(const QPoint& pos) const {
+    const int row = pos.y() / kRowHeight;
+    if (pos.x() < kLabelWidth || row >= m_rows.size()) {
+        return nullptr;
+    }
+    // Iterate backwards to prefer the stages that are painted on top
+    for (auto it = m_records.crbegin(); it != m_records.crend(); ++it) {
+        const EngineProfiler::Record& record = *it;
+        if (record.callback < m_oldestVisibleCallback || rowOf(record) != row) {
+            continue;
+        }
+        const double left = xOf(record.startNanos);
+        const double right = xOf(record.startNanos + record.durationNanos);
+        // Make narrow stages hoverable
+        if (pos.x() >= left - 1 && pos.x() <= right + 1) {
+            return &record;
+        }
+    }
+    return nullptr;
+}
+
+void WEngineProfilerTimeline::paintEvent(QPaintEvent* pEvent) {
+    Q_UNUSED(pEvent);
+    QPainter painter(this);
+    painter.fillRect(rect(), palette().color(QPalette::Base));
+    updateLayout();
+    if (m_rows.isEmpty()) {
+        painter.setPen(palette().color(QPalette::Text));
+        painter.drawText(rect(),
+                Qt::AlignCenter,
+                tr("Waiting for the audio engine..."));
+        return;
+    }
+
+    // Row labels
+    painter.setPen(palette().color(QPalette::Text));
+    int lastThread = -1;
+    for (int i = 0; i < m_rows.size(); ++i) {
+        if (m_rows[i].thread == lastThread) {
+            continue;
+        }
+        lastThread = m_rows[i].thread;
+        painter.drawText(QRect(0, i * kRowHeight, kLabelWidth, kRowHeight),
+                Qt::AlignLeft | Qt::AlignVCenter,
+                tr("Thread %1").arg(lastThread));
+    }
+
+    const QFontMetrics fontMetrics = painter.fontMetrics();
+    for (const auto& record : std::as_const(m_records)) {
+        if (record.callback < m_oldestVisibleCallback) {
+            continue;
+        }
+        const int row = rowOf(record);
+        const double left = xOf(record.startNanos);
+        const double right = xOf(record.startNanos + record.durationNanos);
+        const QRectF stageRect(left,
+                row * kRowHeight,
+                math_max(right - left, 1.0),
+                kRowHeight - 1);
+        QColor color;
+        if (record.stage == EngineProfiler::kCallbackStage) {
+            // Mark the latest possible end of the callback
+            const double deadline = xOf(record.startNanos + record.budgetNanos);
+            painter.fillRect(QRectF(left, row * kRowHeight, deadline - left, kRowHeight - 1),
+                    palette().color(QPalette::AlternateBase));
+            color = isOverloaded(record) ? QColor(230, 60, 60) : QColor(150, 150, 150);
+        } else {
+            color = QColor::fromHsv((record.stage * 47) % 360, 110, 235);
+        }
+        painter.fillRect(stageRect, color);
+        if (stageRect.width() >= kMinLabeledWidth) {
+            painter.setPen(Qt::black);
+            painter.drawText(stageRect.adjusted(2, 0, -2, 0),
+                    Qt::AlignLeft | Qt::AlignVCenter,
+                    fontMetrics.elidedText(stageName(record.stage),
+                            Qt::ElideRight,
+                            static_cast<int>(stageRect.width()) - 4));
+        }
+    }
+}
+
+void WEngineProfilerTimeline::wheelEvent(QWheelEvent* pEvent) {
+    if (pEvent->angleDelta().y() > 0) {
+        m_visibleCallbacks = math_max(m_visibleCallbacks / 2, 1);
+    } else if (pEvent->angleDelta().y() < 0) {
+        m_visibleCallbacks = math_min(m_visibleCallbacks * 2, kMaxCallbacks);
+    }
+    update();
+    pEvent->accept();
+}
+
+bool WEngineProfilerTimeline::event(QEvent* pEvent) {
+    if (pEvent->type() != QEvent::ToolTip) {
+        return QWidget::event(pEvent);
+    }
+    auto* pHelpEvent = static_cast<QHelpEvent*>(pEvent);
+    const EngineProfiler::Record* pRecord = recordAt(pHelpEvent->pos());
+    if (!pRecord) {
+        QToolTip::hideText();
+        pEvent->ignore();
+        return true;
+    }
+    QString text = QStringLiteral("%1\n%2").arg(
+            stageName(pRecord->stage), formatMillis(pRecord->durationNanos));
+    if (pRecord->budgetNanos > 0) {
+        text += QChar('\n') +
+                tr("%1% of the audio buffer duration")
+                        .arg(100.0 * pRecord->durationNanos / pRecord->budgetNanos,
+                                0,
+                                'f',
+                                1);
+    }
+    text += QChar('\n') + tr("Callback %1").arg(QString::number(pRecord->callback));
+    QToolTip::showText(pHelpEvent->globalPos(), text, this);
+    return true;
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <QHash>
+#include <QString>
+#include <QTimer>
+#include <QVector>
+#include <QWidget>
+
+#include "engine/engineprofiler.h"
+
+// Live flame timeline of the EngineProfiler records for the developer tools.
+//
+// The horizontal axis is the time of the most recent callbacks. Each thread
+// that has recorded a stage gets its own group of rows with one row per
+// nesting level. Callbacks that have exceeded the duration of their audio
+// buffer are painted red. The profiler is only enabled while the timeline
+// is visible.
+class WEngineProfilerTimeline : public QWidget {
+    Q_OBJECT
+  public:
+    explicit WEngineProfilerTimeline(QWidget* pParent = nullptr);
+    ~WEngineProfilerTimeline() override;
+
+    QSize sizeHint() const override;
+
+  public slots:
+    void setPaused(bool paused);
+
+  signals:
+    // Describes the slowest stage of the most recent overloaded callback
+    void overloadDetected(const QString& description);
+
+  protected:
+    void showEvent(QShowEvent* pEvent) override;
+    void hideEvent(QHideEvent* pEvent) override;
+    void paintEvent(QPaintEvent* pEvent) override;
+    void wheelEvent(QWheelEvent* pEvent) override;
+    bool event(QEvent* pEvent) override;
+
+  private slots:
+    void slotUpdate();
+
+  private:
+    struct Row {
+        int thread;
+        int depth;
+    };
+
+    void appendRecords(const EngineProfiler::Record* pRecords, int count);
+    void describeOverload(const EngineProfiler::Record& callbackRecord);
+    const QString& stageName(EngineProfiler::StageId stage);
+
+    // The visible time range and the row layout of the visible records
+    void updateLayout();
+    int rowOf(const EngineProfiler::Record& record) const;
+    const EngineProfiler::Record* recordAt(const QPoint& pos) const;
+    double xOf(qint64 nanos) const;
+
+    QTimer m_updateTimer;
+    bool m_paused;
+    int m_visibleCallbacks;
+
+    QVector<EngineProfiler::Record> m_readBuffer;
+    QVector<EngineProfiler::Record> m_records;
+    quint64 m_newestCallback;
+
+    // Layout
+    qint64 m_startNanos;
+    qint64 m_endNanos;
+    quint64 m_oldestVisibleCallback;
+    QVector<Row> m_rows;
+
+    QHash<EngineProfiler::StageId, QString> m_stageNames;
+};
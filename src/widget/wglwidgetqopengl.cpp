@@ -8,7 +8,8 @@ WGLWidget::WGLWidget(QWidget* pParent)
         : QWidget(pParent),
           m_pOpenGLWindow(nullptr),
           m_pContainerWidget(nullptr),
-          m_pTrackDropTarget(nullptr) {
+          m_pTrackDropTarget(nullptr),
+          m_renderedOnThread(false) {
     // When the widget is resized or moved, the QOpenGLWindow visibly resizes
     // or moves before the widgets do. This can be solved by calling
     //   setAttribute(Qt::WA_PaintOnScreen);
@@ -97,3 +98,11 @@ bool WGLWidget::shouldRender() const {
 QOpenGLWindow* WGLWidget::getOpenGLWindow() const {
     return m_pOpenGLWindow;
 }
+
+void WGLWidget::setRenderedOnThread(bool renderedOnThread) {
+    m_renderedOnThread = renderedOnThread;
+}
+
+bool WGLWidget::isInitialized() const {
+    return m_pOpenGLWindow && m_pOpenGLWindow->isInitialized();
+}
@@ -40,6 +40,16 @@ class WGLWidget : public QWidget {
 
     QOpenGLWindow* getOpenGLWindow() const;
 
+    /// Widgets that are drawn on the render thread of the
+    /// WaveformWidgetFactory are not painted by the window on the GUI
+    /// thread after they have been initialized.
+    void setRenderedOnThread(bool renderedOnThread);
+    bool isRenderedOnThread() const {
+        return m_renderedOnThread;
+    }
+    /// Returns true after initializeGL() has been invoked by the window.
+    bool isInitialized() const;
+
   protected:
     void showEvent(QShowEvent* event) override;
     void resizeEvent(QResizeEvent* event) override;
@@ -50,4 +60,5 @@ class WGLWidget : public QWidget {
     OpenGLWindow* m_pOpenGLWindow;
     QWidget* m_pContainerWidget;
     TrackDropTarget* m_pTrackDropTarget;
+    bool m_renderedOnThread;
 };
@@ -2,6 +2,7 @@
 
 #include <QMouseEvent>
 
+#include "control/controlproxy.h"
 #include "mixer/playerinfo.h"
 #include "moc_whotcuebutton.cpp"
 #include "track/track.h"
@@ -5,6 +5,8 @@
 #include <QPaintEvent>
 #include <QPainter>
 #include <QVBoxLayout>
+#include <algorithm>
+#include <cmath>
 
 #include "analyzer/analyzerprogress.h"
 #include "control/controlproxy.h"
@@ -29,10 +31,6 @@ WOverview::WOverview(
         UserSettingsPointer pConfig,
         QWidget* parent)
         : WWidget(parent),
-          m_actualCompletion(0),
-          m_pixmapDone(false),
-          m_waveformPeak(-1.0),
-          m_diffGain(0),
           m_devicePixelRatio(1.0),
           m_group(group),
           m_pConfig(pConfig),
@@ -52,7 +50,8 @@ WOverview::WOverview(
           m_b(0.0),
           m_analyzerProgress(kAnalyzerProgressUnknown),
           m_trackLoaded(false),
-          m_scaleFactor(1.0) {
+          m_scaleFactor(1.0),
+          m_marksLayersDirty(true) {
     m_endOfTrackControl = new ControlProxy(
             m_group, "end_of_track", this, ControlFlag::NoAssertIfMissing);
     m_endOfTrackControl->connectValueChanged(this, &WOverview::onEndOfTrackChange);
@@ -94,6 +93,15 @@ void WOverview::setup(const QDomNode& node, const SkinContext& context) {
     m_playedOverlayColor = m_signalColors.getPlayedOverlayColor();
     m_lowColor = m_signalColors.getLowColor();
     m_dimBrightThreshold = m_signalColors.getDimBrightThreshold();
+    // The subclasses draw with either set of signal colors
+    m_overviewStyle = QStringLiteral("%1 %2 %3 %4 %5 %6 %7")
+                              .arg(metaObject()->className(),
+                                      m_signalColors.getLowColor().name(QColor::HexArgb),
+                                      m_signalColors.getMidColor().name(QColor::HexArgb),
+                                      m_signalColors.getHighColor().name(QColor::HexArgb),
+                                      m_signalColors.getRgbLowColor().name(QColor::HexArgb),
+                                      m_signalColors.getRgbMidColor().name(QColor::HexArgb),
+                                      m_signalColors.getRgbHighColor().name(QColor::HexArgb));
 
     m_labelBackgroundColor = context.selectColor(node, "LabelBackgroundColor");
     if (!m_labelBackgroundColor.isValid()) {
@@ -194,6 +202,7 @@ void WOverview::setup(const QDomNode& node, const SkinContext& context) {
     }
 
     m_bShowCueTimes = context.selectBool(node, "ShowCueTimes", true);
+    m_marksLayersDirty = true;
 
     // qDebug() << "WOverview : std::as_const(m_marks)" << m_marks.size();
     // qDebug() << "WOverview : m_markRanges" << m_markRanges.size();
@@ -230,12 +239,9 @@ void WOverview::onConnectedControlChanged(double dParameter, double dValue) {
     // all we represent with this widget.
     dParameter = math_clamp(dParameter, 0.0, 1.0);
 
-    bool redraw = false;
-    int oldPos = m_iPlayPos;
+    const int oldPos = m_iPlayPos;
+    const int oldPickupPos = m_iPickupPos;
     m_iPlayPos = valueToPosition(dParameter);
-    if (oldPos != m_iPlayPos) {
-        redraw = true;
-    }
 
     if (!m_bLeftClickDragging) {
         // if not dragged the pick-up moves with the play position
@@ -249,11 +255,25 @@ void WOverview::onConnectedControlChanged(double dParameter, double dValue) {
     int oldPositionSeconds = m_iPosSeconds;
     m_iPosSeconds = static_cast<int>(dParameter * getTrackSamples());
     if ((m_bTimeRulerActive || m_pHoveredMark != nullptr) && oldPositionSeconds != m_iPosSeconds) {
-        redraw = true;
+        update();
+    } else if (oldPos != m_iPlayPos || oldPickupPos != m_iPickupPos) {
+        // Only repaint around the old and the new position, everything else
+        // is unchanged
+        update(positionStripRect(
+                std::min({oldPos, oldPickupPos, m_iPlayPos, m_iPickupPos}),
+                std::max({oldPos, oldPickupPos, m_iPlayPos, m_iPickupPos})));
     }
+}
 
-    if (redraw) {
-        update();
+QRect WOverview::positionStripRect(int fromPosition, int toPosition) const {
+    // The pick-up triangles, the outlines and the pen width
+    const int margin = static_cast<int>(std::ceil(3 * m_scaleFactor)) + 1;
+    const int first = std::min(fromPosition, toPosition) - margin;
+    const int last = std::max(fromPosition, toPosition) + margin;
+    if (m_orientation == Qt::Horizontal) {
+        return QRect(first, 0, last - first + 1, height());
+    } else {
+        return QRect(0, first, width(), last - first + 1);
     }
 }
 
@@ -265,22 +285,20 @@ void WOverview::slotWaveformSummaryUpdated() {
         return;
     }
     m_pWaveform = pTrack->getWaveformSummary();
+    if (!m_pOverviewImage) {
+        setOverviewImage(SharedOverviewImage::getImage(pTrack->getId(), m_overviewStyle));
+    }
+    // A new waveform discards the image, which is then redrawn by the
+    // first overview of the track that gets here
+    m_pOverviewImage->setWaveform(m_pWaveform);
     if (m_pWaveform) {
         // If the waveform is already complete, just draw it.
         if (m_pWaveform->getCompletion() == m_pWaveform->getDataSize()) {
-            m_actualCompletion = 0;
-            if (drawNextPixmapPart()) {
-                update();
-            }
+            updateWaveformPixmap();
         }
     } else {
         // Null waveform pointer means waveform was cleared.
-        m_waveformSourceImage = QImage();
         m_analyzerProgress = kAnalyzerProgressUnknown;
-        m_actualCompletion = 0;
-        m_waveformPeak = -1.0;
-        m_pixmapDone = false;
-
         update();
     }
 }
@@ -290,13 +308,35 @@ void WOverview::onTrackAnalyzerProgress(TrackId trackId, AnalyzerProgress analyz
         return;
     }
 
-    bool updateNeeded = drawNextPixmapPart();
-    if (updateNeeded || (m_analyzerProgress != analyzerProgress)) {
+    // All overviews of the image are repainted when a part has been drawn
+    updateWaveformPixmap();
+    if (m_analyzerProgress != analyzerProgress) {
         m_analyzerProgress = analyzerProgress;
         update();
     }
 }
 
+void WOverview::updateWaveformPixmap() {
+    if (m_pOverviewImage && drawNextPixmapPart()) {
+        m_pOverviewImage->sourceUpdated();
+    }
+}
+
+void WOverview::setOverviewImage(QSharedPointer<SharedOverviewImage> pOverviewImage) {
+    if (m_pOverviewImage) {
+        disconnect(m_pOverviewImage.data(), nullptr, this, nullptr);
+    }
+    m_pOverviewImage = std::move(pOverviewImage);
+    if (m_pOverviewImage) {
+        connect(m_pOverviewImage.data(),
+                &SharedOverviewImage::changed,
+                this,
+                [this]() {
+                    update();
+                });
+    }
+}
+
 void WOverview::slotTrackLoaded(TrackPointer pTrack) {
     Q_UNUSED(pTrack); // only used in DEBUG_ASSERT
     //qDebug() << "WOverview::slotTrackLoaded()" << m_pCurrentTrack.get() << pTrack.get();
@@ -305,6 +345,7 @@ void WOverview::slotTrackLoaded(TrackPointer pTrack) {
     if (m_pCurrentTrack) {
         updateCues(m_pCurrentTrack->getCuePoints());
     }
+    m_marksLayersDirty = true;
     update();
 }
 
@@ -323,11 +364,9 @@ void WOverview::slotLoadingTrack(TrackPointer pNewTrack, TrackPointer pOldTrack)
                 &WOverview::receiveCuesUpdated);
     }
 
-    m_waveformSourceImage = QImage();
+    setOverviewImage(nullptr);
     m_analyzerProgress = kAnalyzerProgressUnknown;
-    m_actualCompletion = 0;
-    m_waveformPeak = -1.0;
-    m_pixmapDone = false;
+    m_marksLayersDirty = true;
     // Note: Here we already have the new track, but the engine and it's
     // Control Objects may still have the old one until the slotTrackLoaded()
     // signal has been received.
@@ -362,6 +401,7 @@ void WOverview::onMarkChanged(double v) {
     //qDebug() << "WOverview::onMarkChanged()" << v;
     if (m_pCurrentTrack) {
         updateCues(m_pCurrentTrack->getCuePoints());
+        m_marksLayersDirty = true;
         update();
     }
 }
@@ -369,11 +409,14 @@ void WOverview::onMarkChanged(double v) {
 void WOverview::onMarkRangeChange(double v) {
     Q_UNUSED(v);
     //qDebug() << "WOverview::onMarkRangeChange()" << v;
+    m_marksLayersDirty = true;
     update();
 }
 
 void WOverview::onRateRatioChange(double v) {
     Q_UNUSED(v);
+    // The durations of the mark ranges depend on the rate
+    m_marksLayersDirty = true;
     update();
 }
 
@@ -603,11 +646,25 @@ void WOverview::paintEvent(QPaintEvent* pEvent) {
             const auto gain = static_cast<CSAMPLE_GAIN>(length() - 2) /
                     static_cast<CSAMPLE_GAIN>(trackSamples);
 
-            drawRangeMarks(&painter, offset, gain);
-            drawMarks(&painter, offset, gain);
-            drawPickupPosition(&painter);
-            drawTimeRuler(&painter);
-            drawMarkLabels(&painter, offset, gain);
+            if (m_pHoveredMark != nullptr || m_bTimeRulerActive) {
+                drawRangeMarks(&painter, offset, gain);
+                drawMarks(&painter, offset, gain);
+                drawPickupPosition(&painter);
+                drawTimeRuler(&painter);
+                drawMarkLabels(&painter, offset, gain);
+                // The labels have been placed around the hovered mark
+                m_marksLayersDirty = true;
+            } else {
+                // Clears the time ruler labels before the mark labels are
+                // placed
+                drawTimeRuler(&painter);
+                if (m_marksLayersDirty) {
+                    updateMarksLayers(offset, gain);
+                }
+                painter.drawImage(QPoint(0, 0), m_marksLayer);
+                drawPickupPosition(&painter);
+                painter.drawImage(QPoint(0, 0), m_markLabelsLayer);
+            }
         }
     }
 
@@ -619,6 +676,29 @@ void WOverview::paintEvent(QPaintEvent* pEvent) {
     }
 }
 
+void WOverview::updateMarksLayers(const float offset, const float gain) {
+    ScopedTimer t("WOverview::updateMarksLayers");
+    const qreal devicePixelRatio = devicePixelRatioF();
+    m_marksLayer = QImage(size() * devicePixelRatio, QImage::Format_ARGB32_Premultiplied);
+    m_marksLayer.setDevicePixelRatio(devicePixelRatio);
+    m_marksLayer.fill(Qt::transparent);
+    m_markLabelsLayer = QImage(size() * devicePixelRatio, QImage::Format_ARGB32_Premultiplied);
+    m_markLabelsLayer.setDevicePixelRatio(devicePixelRatio);
+    m_markLabelsLayer.fill(Qt::transparent);
+    {
+        QPainter painter(&m_marksLayer);
+        painter.setFont(font());
+        drawRangeMarks(&painter, offset, gain);
+        drawMarks(&painter, offset, gain);
+    }
+    {
+        QPainter painter(&m_markLabelsLayer);
+        painter.setFont(font());
+        drawMarkLabels(&painter, offset, gain);
+    }
+    m_marksLayersDirty = false;
+}
+
 void WOverview::drawEndOfTrackBackground(QPainter* pPainter) {
     if (m_endOfTrack) {
         PainterScope painterScope(pPainter);
@@ -640,53 +720,44 @@ void WOverview::drawAxis(QPainter* pPainter) {
 
 void WOverview::drawWaveformPixmap(QPainter* pPainter) {
     WaveformWidgetFactory* widgetFactory = WaveformWidgetFactory::instance();
-    if (!m_waveformSourceImage.isNull()) {
+    if (hasWaveformImage()) {
         PainterScope painterScope(pPainter);
+        const SharedOverviewImage::Source& source = m_pOverviewImage->source();
         float diffGain;
         bool normalize = widgetFactory->isOverviewNormalized();
-        if (normalize && m_pixmapDone && m_waveformPeak > 1) {
-            diffGain = 255 - m_waveformPeak - 1;
+        if (normalize && source.done && source.peak > 1) {
+            diffGain = 255 - source.peak - 1;
         } else {
             const auto visualGain = static_cast<float>(
                     widgetFactory->getVisualGain(WaveformWidgetFactory::All));
             diffGain = 255.0f - (255.0f / visualGain);
         }
 
-        if (m_diffGain != diffGain || m_waveformImageScaled.isNull()) {
-            QRect sourceRect(0,
-                    static_cast<int>(diffGain),
-                    m_waveformSourceImage.width(),
-                    m_waveformSourceImage.height() -
-                            2 * static_cast<int>(diffGain));
-            QImage croppedImage = m_waveformSourceImage.copy(sourceRect);
-            if (m_orientation == Qt::Vertical) {
-                // Rotate pixmap
-                croppedImage = croppedImage.transformed(QTransform(0, 1, 1, 0, 0, 0));
-            }
-            m_waveformImageScaled = croppedImage.scaled(size() * m_devicePixelRatio,
-                    Qt::IgnoreAspectRatio,
-                    Qt::SmoothTransformation);
-            m_diffGain = diffGain;
+        // Scaled once per size for all overviews of the image
+        const QImage scaledImage = m_pOverviewImage->scaledImage(
+                size() * m_devicePixelRatio,
+                static_cast<int>(diffGain),
+                m_orientation);
+        if (!scaledImage.isNull()) {
+            pPainter->drawImage(rect(), scaledImage);
         }
-
-        pPainter->drawImage(rect(), m_waveformImageScaled);
     }
 }
 
 void WOverview::drawPlayedOverlay(QPainter* pPainter) {
     // Overlay the played part of the overview-waveform with a skin defined color
-    if (!m_waveformSourceImage.isNull() && m_playedOverlayColor.alpha() > 0) {
+    if (hasWaveformImage() && m_playedOverlayColor.alpha() > 0) {
         if (m_orientation == Qt::Vertical) {
             pPainter->fillRect(0,
                     0,
-                    m_waveformImageScaled.width(),
+                    width(),
                     m_iPlayPos,
                     m_playedOverlayColor);
         } else {
             pPainter->fillRect(0,
                     0,
                     m_iPlayPos,
-                    m_waveformImageScaled.height(),
+                    height(),
                     m_playedOverlayColor);
         }
     }
@@ -1201,7 +1272,7 @@ void WOverview::drawMarkLabels(QPainter* pPainter, const float offset, const flo
 }
 
 void WOverview::drawPassthroughOverlay(QPainter* pPainter) {
-    if (!m_waveformSourceImage.isNull() && m_passthroughOverlayColor.alpha() > 0) {
+    if (hasWaveformImage() && m_passthroughOverlayColor.alpha() > 0) {
         // Overlay the entire overview-waveform with a skin defined color
         pPainter->fillRect(rect(), m_passthroughOverlayColor);
     }
@@ -1258,8 +1329,7 @@ void WOverview::resizeEvent(QResizeEvent* pEvent) {
 
     m_devicePixelRatio = devicePixelRatioF();
 
-    m_waveformImageScaled = QImage();
-    m_diffGain = 0;
+    m_marksLayersDirty = true;
     Init();
 }
 
@@ -12,6 +12,7 @@
 #include "waveform/renderers/waveformmarkset.h"
 #include "waveform/renderers/waveformsignalcolors.h"
 #include "waveform/waveform.h"
+#include "widget/sharedoverviewimage.h"
 #include "widget/trackdroptarget.h"
 #include "widget/wcuemenupopup.h"
 #include "widget/wwidget.h"
@@ -76,18 +77,12 @@ class WOverview : public WWidget, public TrackDropTarget {
         }
     }
 
-    QImage m_waveformSourceImage;
-    QImage m_waveformImageScaled;
+    // The overview image of the current track, which is shared with the
+    // other overviews of the track in the same style
+    QSharedPointer<SharedOverviewImage> m_pOverviewImage;
 
     WaveformSignalColors m_signalColors;
 
-    // Hold the last visual sample processed to generate the pixmap
-    int m_actualCompletion;
-
-    bool m_pixmapDone;
-    float m_waveformPeak;
-
-    float m_diffGain;
     qreal m_devicePixelRatio;
 
   private slots:
@@ -106,6 +101,16 @@ class WOverview : public WWidget, public TrackDropTarget {
     // Append the waveform overview pixmap according to available data
     // in waveform
     virtual bool drawNextPixmapPart() = 0;
+    // Calls drawNextPixmapPart() and notifies all overviews of the image
+    void updateWaveformPixmap();
+    void setOverviewImage(QSharedPointer<SharedOverviewImage> pOverviewImage);
+    bool hasWaveformImage() const {
+        return m_pOverviewImage && !m_pOverviewImage->source().image.isNull();
+    }
+    void updateMarksLayers(const float offset, const float gain);
+    // The strip of the widget that contains the play position and pick-up
+    // lines at both positions and the played overlay between them
+    QRect positionStripRect(int fromPosition, int toPosition) const;
     void drawEndOfTrackBackground(QPainter* pPainter);
     void drawAxis(QPainter* pPainter);
     void drawWaveformPixmap(QPainter* pPainter);
@@ -163,6 +168,8 @@ class WOverview : public WWidget, public TrackDropTarget {
     WaveformMarkLabel m_timeRulerDistanceLabel;
 
     Qt::Orientation m_orientation;
+    // Identifies the colors of the overview image for sharing it
+    QString m_overviewStyle;
 
     QPixmap m_backgroundPixmap;
     QString m_backgroundPixmapPath;
@@ -191,4 +198,12 @@ class WOverview : public WWidget, public TrackDropTarget {
     AnalyzerProgress m_analyzerProgress;
     bool m_trackLoaded;
     double m_scaleFactor;
+
+    // The marks only change with the cues and controls, not with the play
+    // position. They are cached in two layers, because the pick-up position
+    // is drawn between the lines and the labels. While a mark is hovered or
+    // the time ruler is shown, they are drawn directly.
+    QImage m_marksLayer;
+    QImage m_markLabelsLayer;
+    bool m_marksLayersDirty;
 };
@@ -28,6 +28,7 @@ bool WOverviewLMH::drawNextPixmapPart() {
     if (!pWaveform) {
         return false;
     }
+    SharedOverviewImage::Source& source = m_pOverviewImage->source();
 
     const int dataSize = pWaveform->getDataSize();
     const double audioVisualRatio = pWaveform->getAudioVisualRatio();
@@ -36,26 +37,26 @@ bool WOverviewLMH::drawNextPixmapPart() {
         return false;
     }
 
-    if (m_waveformSourceImage.isNull()) {
+    if (source.image.isNull()) {
         // Waveform pixmap twice the height of the viewport to be scalable
         // by total_gain
         // We keep full range waveform data to scale it on paint
-        m_waveformSourceImage = QImage(
+        source.image = QImage(
                 static_cast<int>(trackSamples / audioVisualRatio / 2) + 1,
                 2 * 255,
                 QImage::Format_ARGB32_Premultiplied);
-        m_waveformSourceImage.fill(QColor(0, 0, 0, 0).value());
-        if (dataSize / 2 != m_waveformSourceImage.width()) {
+        source.image.fill(QColor(0, 0, 0, 0).value());
+        if (dataSize / 2 != source.image.width()) {
             qWarning() << "Track duration has changed since last analysis"
-                       << m_waveformSourceImage.width() << "!=" << dataSize / 2;
+                       << source.image.width() << "!=" << dataSize / 2;
         }
     }
-    DEBUG_ASSERT(!m_waveformSourceImage.isNull());
+    DEBUG_ASSERT(!source.image.isNull());
 
     // Always multiple of 2
     const int waveformCompletion = pWaveform->getCompletion();
     // Test if there is some new to draw (at least of pixel width)
-    const int completionIncrement = waveformCompletion - m_actualCompletion;
+    const int completionIncrement = waveformCompletion - source.completion;
 
     int visiblePixelIncrement = completionIncrement * length() / dataSize;
     if (waveformCompletion < (dataSize - 2) &&
@@ -63,17 +64,17 @@ bool WOverviewLMH::drawNextPixmapPart() {
         return false;
     }
 
-    const int nextCompletion = m_actualCompletion + completionIncrement;
+    const int nextCompletion = source.completion + completionIncrement;
 
     //qDebug() << "WOverview::drawNextPixmapPart() - nextCompletion:"
     //         << nextCompletion
-    //         << "m_actualCompletion:" << m_actualCompletion
+    //         << "source.completion:" << source.completion
     //         << "waveformCompletion:" << waveformCompletion
     //         << "completionIncrement:" << completionIncrement;
 
 
-    QPainter painter(&m_waveformSourceImage);
-    painter.translate(0.0, static_cast<double>(m_waveformSourceImage.height()) / 2.0);
+    QPainter painter(&source.image);
+    painter.translate(0.0, static_cast<double>(source.image.height()) / 2.0);
 
     QColor lowColor = m_signalColors.getLowColor();
     QPen lowColorPen(QBrush(lowColor), 1);
@@ -84,7 +85,7 @@ bool WOverviewLMH::drawNextPixmapPart() {
     QColor highColor = m_signalColors.getHighColor();
     QPen highColorPen(QBrush(highColor), 1);
 
-    for (currentCompletion = m_actualCompletion;
+    for (currentCompletion = source.completion;
             currentCompletion < nextCompletion; currentCompletion += 2) {
         unsigned char lowNeg = pWaveform->getLow(currentCompletion);
         unsigned char lowPos = pWaveform->getLow(currentCompletion+1);
@@ -95,7 +96,7 @@ bool WOverviewLMH::drawNextPixmapPart() {
         }
     }
 
-    for (currentCompletion = m_actualCompletion;
+    for (currentCompletion = source.completion;
             currentCompletion < nextCompletion; currentCompletion += 2) {
         painter.setPen(midColorPen);
         painter.drawLine(QPoint(currentCompletion / 2,
@@ -104,7 +105,7 @@ bool WOverviewLMH::drawNextPixmapPart() {
                 pWaveform->getMid(currentCompletion+1)));
     }
 
-    for (currentCompletion = m_actualCompletion;
+    for (currentCompletion = source.completion;
             currentCompletion < nextCompletion; currentCompletion += 2) {
         painter.setPen(highColorPen);
         painter.drawLine(QPoint(currentCompletion / 2,
@@ -115,22 +116,20 @@ bool WOverviewLMH::drawNextPixmapPart() {
 
     // Evaluate waveform ratio peak
 
-    for (currentCompletion = m_actualCompletion;
+    for (currentCompletion = source.completion;
             currentCompletion < nextCompletion; currentCompletion += 2) {
-        m_waveformPeak = math_max3(
-                m_waveformPeak,
+        source.peak = math_max3(
+                source.peak,
                 static_cast<float>(pWaveform->getAll(currentCompletion)),
                 static_cast<float>(pWaveform->getAll(currentCompletion + 1)));
     }
 
-    m_actualCompletion = nextCompletion;
-    m_waveformImageScaled = QImage();
-    m_diffGain = 0;
+    source.completion = nextCompletion;
 
     // Test if the complete waveform is done
-    if (m_actualCompletion >= dataSize - 2) {
-        m_pixmapDone = true;
-        //qDebug() << "m_waveformPeakRatio" << m_waveformPeak;
+    if (source.completion >= dataSize - 2) {
+        source.done = true;
+        //qDebug() << "waveform peak" << source.peak;
     }
 
     return true;
@@ -27,6 +27,7 @@ bool WOverviewRGB::drawNextPixmapPart() {
     if (!pWaveform) {
         return false;
     }
+    SharedOverviewImage::Source& source = m_pOverviewImage->source();
 
     const int dataSize = pWaveform->getDataSize();
     const double audioVisualRatio = pWaveform->getAudioVisualRatio();
@@ -35,26 +36,26 @@ bool WOverviewRGB::drawNextPixmapPart() {
         return false;
     }
 
-    if (m_waveformSourceImage.isNull()) {
+    if (source.image.isNull()) {
         // Waveform pixmap twice the height of the viewport to be scalable
         // by total_gain
         // We keep full range waveform data to scale it on paint
-        m_waveformSourceImage = QImage(
+        source.image = QImage(
                 static_cast<int>(trackSamples / audioVisualRatio / 2) + 1,
                 2 * 255,
                 QImage::Format_ARGB32_Premultiplied);
-        m_waveformSourceImage.fill(QColor(0, 0, 0, 0).value());
-        if (dataSize / 2 != m_waveformSourceImage.width()) {
+        source.image.fill(QColor(0, 0, 0, 0).value());
+        if (dataSize / 2 != source.image.width()) {
             qWarning() << "Track duration has changed since last analysis"
-                       << m_waveformSourceImage.width() << "!=" << dataSize / 2;
+                       << source.image.width() << "!=" << dataSize / 2;
         }
     }
-    DEBUG_ASSERT(!m_waveformSourceImage.isNull());
+    DEBUG_ASSERT(!source.image.isNull());
 
     // Always multiple of 2
     const int waveformCompletion = pWaveform->getCompletion();
     // Test if there is some new to draw (at least of pixel width)
-    const int completionIncrement = waveformCompletion - m_actualCompletion;
+    const int completionIncrement = waveformCompletion - source.completion;
 
     int visiblePixelIncrement = completionIncrement * length() / dataSize;
     if (waveformCompletion < (dataSize - 2) &&
@@ -62,16 +63,16 @@ bool WOverviewRGB::drawNextPixmapPart() {
         return false;
     }
 
-    const int nextCompletion = m_actualCompletion + completionIncrement;
+    const int nextCompletion = source.completion + completionIncrement;
 
     //qDebug() << "WOverview::drawNextPixmapPart() - nextCompletion:"
     //         << nextCompletion
-    //         << "m_actualCompletion:" << m_actualCompletion
+    //         << "source.completion:" << source.completion
     //         << "waveformCompletion:" << waveformCompletion
     //         << "completionIncrement:" << completionIncrement;
 
-    QPainter painter(&m_waveformSourceImage);
-    painter.translate(0.0, static_cast<double>(m_waveformSourceImage.height()) / 2.0);
+    QPainter painter(&source.image);
+    painter.translate(0.0, static_cast<double>(source.image.height()) / 2.0);
 
     QColor color;
 
@@ -84,7 +85,7 @@ bool WOverviewRGB::drawNextPixmapPart() {
     float highColor_r, highColor_g, highColor_b;
     getRgbF(m_signalColors.getRgbHighColor(), &highColor_r, &highColor_g, &highColor_b);
 
-    for (currentCompletion = m_actualCompletion;
+    for (currentCompletion = source.completion;
             currentCompletion < nextCompletion; currentCompletion += 2) {
 
         unsigned char left = pWaveform->getAll(currentCompletion);
@@ -130,22 +131,20 @@ bool WOverviewRGB::drawNextPixmapPart() {
     }
 
     // Evaluate waveform ratio peak
-    for (currentCompletion = m_actualCompletion;
+    for (currentCompletion = source.completion;
             currentCompletion < nextCompletion; currentCompletion += 2) {
-        m_waveformPeak = math_max3(
-                m_waveformPeak,
+        source.peak = math_max3(
+                source.peak,
                 static_cast<float>(pWaveform->getAll(currentCompletion)),
                 static_cast<float>(pWaveform->getAll(currentCompletion + 1)));
     }
 
-    m_actualCompletion = nextCompletion;
-    m_waveformImageScaled = QImage();
-    m_diffGain = 0;
+    source.completion = nextCompletion;
 
     // Test if the complete waveform is done
-    if (m_actualCompletion >= dataSize - 2) {
-        m_pixmapDone = true;
-        //qDebug() << "m_waveformPeakRatio" << m_waveformPeak;
+    if (source.completion >= dataSize - 2) {
+        source.done = true;
+        //qDebug() << "waveform peak" << source.peak;
     }
 
     return true;
@@ -343,9 +343,9 @@ void WSpinnyBase::swap() {
     if (!shouldRender()) {
         return;
     }
+    // Released by the WaveformWidgetFactory after swapping all widgets
     makeCurrentIfNeeded();
     swapBuffers();
-    doneCurrent();
 }
 
 QImage WSpinnyBase::scaleToSize(const QImage& image) const {
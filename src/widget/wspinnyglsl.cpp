@@ -41,9 +41,11 @@ void WSpinnyGLSL::coverChanged() {
 
 void WSpinnyGLSL::draw() {
     if (shouldRender()) {
+        // The context is released by the WaveformWidgetFactory after all
+        // spinnies and VU meters have been drawn, so that drawing the next
+        // widget directly switches to its context.
         makeCurrentIfNeeded();
         paintGL();
-        doneCurrent();
     }
 }
 
@@ -20,6 +20,7 @@
 #include "library/externaltrackcollection.h"
 #include "library/library.h"
 #include "library/trackcollection.h"
+#include "library/trackcollectioniterator.h"
 #include "library/trackcollectionmanager.h"
 #include "library/trackmodel.h"
 #include "library/trackmodeliterator.h"
@@ -1140,6 +1141,13 @@ std::unique_ptr<mixxx::TrackPointerIterator> WTrackMenu::newTrackPointerIterator
         if (m_trackIndexList.isEmpty()) {
             return nullptr;
         }
+        const TrackIdList trackIds = getTrackIds();
+        if (trackIds.size() == m_trackIndexList.size()) {
+            // All tracks are in the library and are loaded in batches
+            return std::make_unique<mixxx::TrackByIdCollectionIterator>(
+                    m_pLibrary->trackCollectionManager(),
+                    trackIds);
+        }
         // m_pTrackModel must not be modified during the iteration,
         // neither directly nor indirectly through signals!!!
         return std::make_unique<mixxx::TrackPointerModelIterator>(
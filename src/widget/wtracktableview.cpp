@@ -153,6 +153,11 @@ void WTrackTableView::loadTrackModel(QAbstractItemModel* model, bool restoreStat
         return;
     }
 
+    if (m_pendingSearchConnection) {
+        disconnect(m_pendingSearchConnection);
+        viewport()->unsetCursor();
+    }
+
     // If the model has not changed there's no need to exchange the headers
     // which would cause a small GUI freeze
     if (getTrackModel() == trackModel) {
@@ -518,6 +523,11 @@ void WTrackTableView::contextMenuEvent(QContextMenuEvent* event) {
 void WTrackTableView::onSearch(const QString& text) {
     TrackModel* trackModel = getTrackModel();
     if (trackModel) {
+        // Results of a previous search that is still pending are discarded
+        if (m_pendingSearchConnection) {
+            disconnect(m_pendingSearchConnection);
+            viewport()->unsetCursor();
+        }
         saveCurrentViewState();
         bool queryIsLessSpecific = SearchQueryParser::queryIsLessSpecific(
                 trackModel->currentSearch(), text);
@@ -525,24 +535,44 @@ void WTrackTableView::onSearch(const QString& text) {
         TrackId prevTrack = getCurrentTrackId();
         saveCurrentIndex();
         trackModel->search(text);
-        if (queryIsLessSpecific) {
-            // If the user removed query terms, we try to select the same
-            // tracks as before
-            setCurrentTrackId(prevTrack, m_prevColumn);
-            setSelectedTracks(selectedTracks);
+        auto* pSqlTableModel = qobject_cast<BaseSqlTableModel*>(model());
+        if (pSqlTableModel && pSqlTableModel->isSelectPending()) {
+            // Restore the selection when the results are available
+            viewport()->setCursor(Qt::BusyCursor);
+            m_pendingSearchConnection = connect(pSqlTableModel,
+                    &BaseSqlTableModel::selectFinished,
+                    this,
+                    [this, queryIsLessSpecific, selectedTracks, prevTrack]() {
+                        disconnect(m_pendingSearchConnection);
+                        viewport()->unsetCursor();
+                        restoreSearchState(queryIsLessSpecific, selectedTracks, prevTrack);
+                    });
         } else {
-            // The user created a more specific search query, try to restore a
-            // previous state
-            if (!restoreCurrentViewState()) {
-                // We found no saved state for this query, try to select the
-                // tracks last active, if they are part of the result set
-                if (!setCurrentTrackId(prevTrack, m_prevColumn)) {
-                    // if the last focused track is not present try to focus the
-                    // respective index and scroll there
-                    restoreCurrentIndex();
-                }
-                setSelectedTracks(selectedTracks);
+            restoreSearchState(queryIsLessSpecific, selectedTracks, prevTrack);
+        }
+    }
+}
+
+void WTrackTableView::restoreSearchState(bool queryIsLessSpecific,
+        const QList<TrackId>& selectedTracks,
+        TrackId prevTrack) {
+    if (queryIsLessSpecific) {
+        // If the user removed query terms, we try to select the same
+        // tracks as before
+        setCurrentTrackId(prevTrack, m_prevColumn);
+        setSelectedTracks(selectedTracks);
+    } else {
+        // The user created a more specific search query, try to restore a
+        // previous state
+        if (!restoreCurrentViewState()) {
+            // We found no saved state for this query, try to select the
+            // tracks last active, if they are part of the result set
+            if (!setCurrentTrackId(prevTrack, m_prevColumn)) {
+                // if the last focused track is not present try to focus the
+                // respective index and scroll there
+                restoreCurrentIndex();
             }
+            setSelectedTracks(selectedTracks);
         }
     }
 }
@@ -117,6 +117,10 @@ class WTrackTableView : public WLibraryTableView {
 
     void hideOrRemoveSelectedTracks();
 
+    void restoreSearchState(bool queryIsLessSpecific,
+            const QList<TrackId>& selectedTracks,
+            TrackId prevTrack);
+
     const UserSettingsPointer m_pConfig;
     Library* const m_pLibrary;
 
@@ -127,6 +131,9 @@ class WTrackTableView : public WLibraryTableView {
     QColor m_pFocusBorderColor;
     bool m_sorting;
 
+    // Restores the selection after an asynchronous search
+    QMetaObject::Connection m_pendingSearchConnection;
+
     // Control the delay to load a cover art.
     mixxx::Duration m_lastUserAction;
     bool m_selectionChangedSinceLastGuiTick;
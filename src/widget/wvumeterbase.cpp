@@ -205,8 +205,8 @@ void WVuMeterBase::swap() {
     if (!m_bSwapNeeded || !shouldRender()) {
         return;
     }
+    // Released by the WaveformWidgetFactory after swapping all widgets
     makeCurrentIfNeeded();
     swapBuffers();
-    doneCurrent();
     m_bSwapNeeded = false;
 }
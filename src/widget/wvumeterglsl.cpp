@@ -18,17 +18,19 @@ WVuMeterGLSL::~WVuMeterGLSL() {
 
 void WVuMeterGLSL::draw() {
     if (shouldRender()) {
+        // The context is released by the WaveformWidgetFactory after all
+        // spinnies and VU meters have been drawn, so that drawing the next
+        // widget directly switches to its context.
         makeCurrentIfNeeded();
         paintGL();
-        doneCurrent();
     }
 }
 
 void WVuMeterGLSL::initializeGL() {
     initializeOpenGLFunctions();
 
-    m_pTextureBack = createTexture(m_pPixmapBack);
-    m_pTextureVu = createTexture(m_pPixmapVu);
+    m_pTextureBack = createSharedTexture(m_pPixmapBack);
+    m_pTextureVu = createSharedTexture(m_pPixmapVu);
     m_textureShader.init();
 }
 
@@ -15,8 +15,9 @@ class WVuMeterGLSL : public WVuMeterBase, private QOpenGLFunctions {
     ~WVuMeterGLSL() override;
 
   private:
-    std::unique_ptr<QOpenGLTexture> m_pTextureBack;
-    std::unique_ptr<QOpenGLTexture> m_pTextureVu;
+    // Shared with the other VU meters that use the same pixmaps
+    std::shared_ptr<QOpenGLTexture> m_pTextureBack;
+    std::shared_ptr<QOpenGLTexture> m_pTextureVu;
     mixxx::TextureShader m_textureShader;
 
     void draw() override;
@@ -48,6 +48,7 @@ WWaveformViewer::~WWaveformViewer() {
 }
 
 void WWaveformViewer::setup(const QDomNode& node, const SkinContext& context) {
+    const auto locker = WaveformWidgetFactory::instance()->lockRendering();
     if (m_waveformWidget) {
         m_waveformWidget->setup(node, context);
         m_dimBrightThreshold = m_waveformWidget->getDimBrightThreshold();
@@ -56,6 +57,7 @@ void WWaveformViewer::setup(const QDomNode& node, const SkinContext& context) {
 
 void WWaveformViewer::resizeEvent(QResizeEvent* event) {
     Q_UNUSED(event);
+    const auto locker = WaveformWidgetFactory::instance()->lockRendering();
     if (m_waveformWidget) {
         // Note m_waveformWidget is a WaveformWidgetAbstract,
         // so this calls the method of WaveformWidgetAbstract,
@@ -67,6 +69,7 @@ void WWaveformViewer::resizeEvent(QResizeEvent* event) {
 
 void WWaveformViewer::showEvent(QShowEvent* event) {
     Q_UNUSED(event);
+    const auto locker = WaveformWidgetFactory::instance()->lockRendering();
     if (m_waveformWidget) {
         // We leave it up to Qt to set the size of the derived
         // waveform widget, but we still need to set the size
@@ -222,6 +225,7 @@ void WWaveformViewer::leaveEvent(QEvent*) {
 }
 
 void WWaveformViewer::slotTrackLoaded(TrackPointer track) {
+    const auto locker = WaveformWidgetFactory::instance()->lockRendering();
     if (m_waveformWidget) {
         m_waveformWidget->setTrack(track);
     }
@@ -230,6 +234,7 @@ void WWaveformViewer::slotTrackLoaded(TrackPointer track) {
 void WWaveformViewer::slotLoadingTrack(TrackPointer pNewTrack, TrackPointer pOldTrack) {
     Q_UNUSED(pNewTrack);
     Q_UNUSED(pOldTrack);
+    const auto locker = WaveformWidgetFactory::instance()->lockRendering();
     if (m_waveformWidget) {
         m_waveformWidget->setTrack(TrackPointer());
     }
@@ -244,6 +249,7 @@ void WWaveformViewer::onZoomChange(double zoom) {
 
 void WWaveformViewer::setZoom(double zoom) {
     //qDebug() << "WaveformWidgetRenderer::setZoom" << zoom;
+    const auto locker = WaveformWidgetFactory::instance()->lockRendering();
     if (m_waveformWidget) {
         m_waveformWidget->setZoom(zoom);
     }
@@ -261,18 +267,21 @@ void WWaveformViewer::setZoom(double zoom) {
 }
 
 void WWaveformViewer::setDisplayBeatGridAlpha(int alpha) {
+    const auto locker = WaveformWidgetFactory::instance()->lockRendering();
     if (m_waveformWidget) {
         m_waveformWidget->setDisplayBeatGridAlpha(alpha);
     }
 }
 
 void WWaveformViewer::setPlayMarkerPosition(double position) {
+    const auto locker = WaveformWidgetFactory::instance()->lockRendering();
     if (m_waveformWidget) {
         m_waveformWidget->setPlayMarkerPosition(position);
     }
 }
 
 void WWaveformViewer::setWaveformWidget(WaveformWidgetAbstract* waveformWidget) {
+    const auto locker = WaveformWidgetFactory::instance()->lockRendering();
     if (m_waveformWidget) {
         QWidget* pWidget = m_waveformWidget->getWidget();
         disconnect(pWidget);
@@ -310,6 +319,8 @@ void WWaveformViewer::setWaveformWidget(WaveformWidgetAbstract* waveformWidget)
                 &WWaveformViewer::passthroughChanged,
                 this,
                 [this](double value) {
+                    const auto locker =
+                            WaveformWidgetFactory::instance()->lockRendering();
                     m_waveformWidget->setPassThroughEnabled(value > 0);
                 });
         // Make sure the label is shown after the waveform type was changed
@@ -325,12 +336,14 @@ CuePointer WWaveformViewer::getCuePointerFromCueMark(WaveformMarkPointer pMark)
 }
 
 void WWaveformViewer::highlightMark(WaveformMarkPointer pMark) {
+    const auto locker = WaveformWidgetFactory::instance()->lockRendering();
     QColor highlightColor = Color::chooseContrastColor(pMark->fillColor(),
             m_dimBrightThreshold);
     pMark->setBaseColor(highlightColor, m_dimBrightThreshold);
 }
 
 void WWaveformViewer::unhighlightMark(WaveformMarkPointer pMark) {
+    const auto locker = WaveformWidgetFactory::instance()->lockRendering();
     auto pCue = getCuePointerFromCueMark(pMark);
     if (pCue) {
         QColor originalColor = mixxx::RgbColor::toQColor(pCue->getColor());